@@ -10,6 +10,8 @@
 #include <chrono>
 #include <cmath>
 #include <algorithm>
+#include <array>
+#include <climits>
 #include <deque>
 #include <mutex>
 
@@ -23,6 +25,7 @@ namespace rpcsx::drs {
 // Глобальні атомарні змінні для швидкого доступу
 std::atomic<float> g_current_scale{1.0f};
 std::atomic<bool> g_drs_active{false};
+std::atomic<uint32_t> g_shading_rate_level{0};
 
 // Внутрішній стан DRS
 struct DRSState {
@@ -49,9 +52,39 @@ struct DRSState {
     std::chrono::steady_clock::time_point last_update;
     uint64_t frame_count = 0;
     
+    // GPU feedback (ReportGPUTime)
+    float last_gpu_ms = 0.0f;
+    uint32_t gpu_sample_age = UINT32_MAX;   // UpdateDRS викликів з останнього звіту
+    
+    // Частка GPU бюджету за thermal прогнозом (SetThermalBudget), переживає InitializeDRS
+    float thermal_budget = 1.0f;
+    
+    // Контролер
+    float frame_ema = 0.0f;
+    float gpu_ema = 0.0f;
+    float gpu_trend = 0.0f;     // ms/кадр, згладжений (інакше шум кадр-до-кадру підсилюється)
+    float integral = 0.0f;
+    
+    // Масштаб, застосований на кожному з останніх present (для моделі scale^2)
+    std::array<float, 4> applied_scales{};
+    uint32_t applied_index = 0;
+    
+    // Межа present
+    bool present_driven = false;
+    float pending_scale = 1.0f;
+    
     bool initialized = false;
 };
 
+// Вибірку GPU часу, старішу за стільки кадрів, не використовуємо
+static constexpr uint32_t kMaxGpuSampleAge = 8;
+// Кадрів між рендерингом і готовністю timestamp результатів
+static constexpr uint32_t kGpuLatencyFrames = 2;
+static constexpr float kEmaAlpha = 0.2f;
+static constexpr float kIntegralGain = 0.02f;
+static constexpr float kIntegralLimit = 0.1f;
+static constexpr float kDeadband = 0.02f;
+
 static DRSState g_state;
 
 // Допоміжні функції
@@ -65,50 +98,56 @@ static float CalculateAverageFPS() {
     return sum / g_state.fps_history.size();
 }
 
-static float CalculateScaleForMode(DRSMode mode, float current_fps, float target_fps) {
-    float fps_ratio = current_fps / target_fps;
-    float scale_adjustment = 0.0f;
-    
+// Параметри контролера для режиму
+struct ModeTuning {
+    float gpu_utilization;  // Частка бюджету кадру, яку може займати GPU
+    float max_step_down;    // Максимальна зміна target_scale за кадр
+    float max_step_up;
+};
+
+static ModeTuning GetModeTuning(DRSMode mode) {
     switch (mode) {
-        case DRSMode::PERFORMANCE:
-            // Агресивне зниження - швидко знижуємо при падінні FPS
-            if (fps_ratio < 0.9f) {
-                scale_adjustment = -0.15f;  // Швидке зниження
-            } else if (fps_ratio < 0.95f) {
-                scale_adjustment = -0.08f;
-            } else if (fps_ratio > 1.0f) {
-                scale_adjustment = 0.02f;   // Повільне підвищення
-            }
-            break;
-            
+        case DRSMode::PERFORMANCE: return {0.80f, 0.15f, 0.02f};  // Швидке зниження, повільне підвищення
+        case DRSMode::QUALITY:     return {0.95f, 0.08f, 0.05f};  // Пріоритет якості
         case DRSMode::BALANCED:
-            // Збалансований підхід
-            if (fps_ratio < 0.85f) {
-                scale_adjustment = -0.10f;
-            } else if (fps_ratio < 0.92f) {
-                scale_adjustment = -0.05f;
-            } else if (fps_ratio > 0.98f) {
-                scale_adjustment = 0.03f;
-            }
-            break;
-            
-        case DRSMode::QUALITY:
-            // Пріоритет якості - мінімальне зниження
-            if (fps_ratio < 0.75f) {
-                scale_adjustment = -0.08f;
-            } else if (fps_ratio < 0.85f) {
-                scale_adjustment = -0.03f;
-            } else if (fps_ratio > 0.95f) {
-                scale_adjustment = 0.05f;
-            }
-            break;
-            
-        case DRSMode::DISABLED:
-        default:
-            return 1.0f;
+        default:                   return {0.88f, 0.10f, 0.03f};
+    }
+}
+
+// Частина діапазону масштабу, яку покриває VRS
+static float VrsBandLocked() {
+    return g_state.config.use_vrs ? g_state.config.vrs_scale_band : 0.0f;
+}
+
+// scale - ефективний масштаб контролера; з VRS він ділиться на рівень
+// shading rate і роздільність (на band вищу, але не вище max_scale)
+static float ApplyScaleLocked(float scale) {
+    g_state.current_scale = scale;
+    g_state.applied_index = (g_state.applied_index + 1) % g_state.applied_scales.size();
+    g_state.applied_scales[g_state.applied_index] = scale;
+    
+    const float band = VrsBandLocked();
+    const float deficit = g_state.config.max_scale - scale;
+    uint32_t level = 0;
+    if (band > 0.0f && deficit > kDeadband) {
+        level = deficit <= band * 0.5f ? 1 : 2;
     }
     
-    return scale_adjustment;
+    const float resolution = std::min(scale + band, std::max(scale, g_state.config.max_scale));
+    g_current_scale.store(resolution);
+    g_shading_rate_level.store(level);
+    
+    g_state.stats.current_scale = resolution;
+    g_state.stats.shading_rate_level = level;
+    g_state.stats.render_width = static_cast<uint32_t>(g_state.native_width * resolution);
+    g_state.stats.render_height = static_cast<uint32_t>(g_state.native_height * resolution);
+    return scale;
+}
+
+// Масштаб, з яким рендерився кадр, чий GPU час щойно надійшов
+static float MeasuredScaleLocked() {
+    const size_t n = g_state.applied_scales.size();
+    return g_state.applied_scales[(g_state.applied_index + n - kGpuLatencyFrames) % n];
 }
 
 bool InitializeDRS(uint32_t native_width, uint32_t native_height,
@@ -116,8 +155,9 @@ bool InitializeDRS(uint32_t native_width, uint32_t native_height,
     std::lock_guard<std::mutex> lock(g_state.mutex);
     
     if (g_state.initialized) {
+        // ShutdownDRS() бере той самий mutex
         LOGW("DRS already initialized, reinitializing...");
-        ShutdownDRS();
+        g_state.initialized = false;
     }
     
     LOGI("╔════════════════════════════════════════════════════════════╗");
@@ -143,6 +183,14 @@ bool InitializeDRS(uint32_t native_width, uint32_t native_height,
     g_state.was_scaling_down = false;
     g_state.frame_count = 0;
     g_state.last_update = std::chrono::steady_clock::now();
+    g_state.gpu_sample_age = UINT32_MAX;
+    g_state.frame_ema = 0.0f;
+    g_state.gpu_ema = 0.0f;
+    g_state.gpu_trend = 0.0f;
+    g_state.integral = 0.0f;
+    g_state.applied_scales.fill(config.max_scale);
+    g_state.present_driven = false;
+    g_state.pending_scale = config.max_scale;
     
     // Ініціалізація статистики
     g_state.stats = {};
@@ -154,6 +202,7 @@ bool InitializeDRS(uint32_t native_width, uint32_t native_height,
     
     // Оновлення глобальних атомарних змінних
     g_current_scale.store(config.max_scale);
+    g_shading_rate_level.store(0);
     g_drs_active.store(config.mode != DRSMode::DISABLED);
     
     g_state.initialized = true;
@@ -173,6 +222,7 @@ void ShutdownDRS() {
     g_state.initialized = false;
     g_drs_active.store(false);
     g_current_scale.store(1.0f);
+    g_shading_rate_level.store(0);
     
     LOGI("DRS Engine shutdown complete");
 }
@@ -193,9 +243,10 @@ void SetDRSMode(DRSMode mode) {
          mode == DRSMode::QUALITY ? "QUALITY" : "DISABLED");
     
     if (mode == DRSMode::DISABLED) {
-        g_state.current_scale = 1.0f;
         g_state.target_scale = 1.0f;
-        g_current_scale.store(1.0f);
+        g_state.pending_scale = 1.0f;
+        g_state.integral = 0.0f;
+        ApplyScaleLocked(1.0f);
     }
 }
 
@@ -227,6 +278,19 @@ void SetMaxScale(float scale) {
     LOGI("DRS max scale set to: %.0f%%", g_state.config.max_scale * 100);
 }
 
+void ReportGPUTime(float gpu_time_ms) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    
+    g_state.last_gpu_ms = std::max(0.0f, gpu_time_ms);
+    g_state.gpu_sample_age = 0;
+    g_state.stats.gpu_time_ms = g_state.last_gpu_ms;
+}
+
+void SetThermalBudget(float budget) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    g_state.thermal_budget = std::clamp(budget, 0.5f, 1.0f);
+}
+
 float UpdateDRS(float frame_time_ms) {
     if (!g_drs_active.load()) {
         return 1.0f;
@@ -238,26 +302,82 @@ float UpdateDRS(float frame_time_ms) {
         return 1.0f;
     }
     
+    const float target_fps = static_cast<float>(g_state.config.target_fps);
+    const float budget_ms = 1000.0f / target_fps;
+    const float frame_ms = frame_time_ms > 0.0f ? frame_time_ms : budget_ms;
+    const ModeTuning tuning = GetModeTuning(g_state.config.mode);
+    
     // Розрахунок поточного FPS
-    float current_fps = (frame_time_ms > 0.0f) ? (1000.0f / frame_time_ms) : 60.0f;
+    float current_fps = 1000.0f / frame_ms;
     
     // Додавання до історії
     g_state.fps_history.push_back(current_fps);
     if (g_state.fps_history.size() > DRSState::FPS_HISTORY_SIZE) {
         g_state.fps_history.pop_front();
     }
-    
     float average_fps = CalculateAverageFPS();
-    float target_fps = static_cast<float>(g_state.config.target_fps);
     
-    // Розрахунок необхідного масштабу
-    float scale_adjustment = CalculateScaleForMode(g_state.config.mode, average_fps, target_fps);
+    // Без GPU timestamps не відрізнити GPU-bound кадр від CPU-bound:
+    // вважаємо весь кадр GPU часом (попередня поведінка)
+    const bool has_gpu_feedback = g_state.gpu_sample_age < kMaxGpuSampleAge;
+    const float gpu_ms = has_gpu_feedback ? g_state.last_gpu_ms : frame_ms;
+    if (g_state.gpu_sample_age != UINT32_MAX) g_state.gpu_sample_age++;
+    
+    if (g_state.frame_count == 0) {
+        g_state.frame_ema = frame_ms;
+        g_state.gpu_ema = gpu_ms;
+    }
+    g_state.frame_ema += (frame_ms - g_state.frame_ema) * kEmaAlpha;
+    const float gpu_ema_prev = g_state.gpu_ema;
+    g_state.gpu_ema += (gpu_ms - g_state.gpu_ema) * kEmaAlpha;
+    g_state.gpu_trend += ((g_state.gpu_ema - gpu_ema_prev) - g_state.gpu_trend) * kEmaAlpha;
+    
+    // Прогноз: лінійний тренд на prediction_horizon кадрів
+    const float predicted_gpu_ms = std::max(0.0f, g_state.gpu_ema +
+        g_state.gpu_trend * g_state.config.prediction_horizon);
+    
+    // GPU-bound: GPU зайнятий майже весь кадр. Інакше кадр тримає CPU/SPU,
+    // і зниження роздільної здатності нічого не дасть
+    const bool gpu_bound = !has_gpu_feedback ||
+                           predicted_gpu_ms >= g_state.frame_ema * g_state.config.gpu_bound_threshold;
+    
+    // Не GPU-bound і кадр повільний: GPU може рости до фактичного frame time
+    const float gpu_budget_ms = tuning.gpu_utilization * g_state.thermal_budget *
+                                (gpu_bound ? budget_ms : std::max(budget_ms, g_state.frame_ema));
+    
+    // Feedforward: GPU час ~ пікселі ~ scale^2
+    const float measured_scale = std::max(MeasuredScaleLocked(), 0.01f);
+    const float cost = predicted_gpu_ms / (measured_scale * measured_scale);
+    float desired = cost > 0.0f ? std::sqrt(gpu_budget_ms / cost) : g_state.config.max_scale;
+    
+    // PI: інтеграл на залишковій похибці (постійна частина GPU часу не масштабується),
+    // anti-windup - не накопичуємо в насиченні
+    const float error = (gpu_budget_ms - predicted_gpu_ms) / budget_ms;
+    const float min_effective = g_state.config.min_scale - VrsBandLocked();
+    const bool saturated = (g_state.target_scale <= min_effective && error < 0) ||
+                           (g_state.target_scale >= g_state.config.max_scale && error > 0);
+    if (!saturated) {
+        g_state.integral = std::clamp(g_state.integral + error * kIntegralGain,
+                                      -kIntegralLimit, kIntegralLimit);
+    }
+    desired += g_state.integral;
+    
+    if (!gpu_bound && desired < g_state.target_scale) {
+        desired = g_state.target_scale;
+        g_state.stats.frames_held++;
+    }
+    
+    float scale_adjustment = desired - g_state.target_scale;
+    if (std::abs(scale_adjustment) < kDeadband) {
+        scale_adjustment = 0.0f;
+    }
+    scale_adjustment = std::clamp(scale_adjustment, -tuning.max_step_down, tuning.max_step_up);
     
     // Визначення напрямку масштабування
     bool should_scale_down = (scale_adjustment < 0);
     
     // Hysteresis - затримка перед зміною напрямку
-    if (should_scale_down != g_state.was_scaling_down) {
+    if (scale_adjustment != 0.0f && should_scale_down != g_state.was_scaling_down) {
         g_state.stable_frames++;
         if (g_state.stable_frames < g_state.config.hysteresis_frames) {
             // Ще не час змінювати напрямок
@@ -270,48 +390,65 @@ float UpdateDRS(float frame_time_ms) {
         g_state.stable_frames = 0;
     }
     
-    // Плавна інтерполяція масштабу
     g_state.target_scale += scale_adjustment;
     g_state.target_scale = std::clamp(g_state.target_scale, 
-                                       g_state.config.min_scale, 
+                                       min_effective, 
                                        g_state.config.max_scale);
     
     // Плавний перехід до цільового масштабу
     float adaptation = g_state.config.adaptation_speed;
-    g_state.current_scale = g_state.current_scale + 
-                           (g_state.target_scale - g_state.current_scale) * adaptation;
+    const float next_scale = g_state.current_scale +
+                             (g_state.target_scale - g_state.current_scale) * adaptation;
     
-    // Оновлення глобального масштабу
-    g_current_scale.store(g_state.current_scale);
+    // Зміна масштабу посеред кадру ламає кадр, що вже рендериться - чекаємо present
+    g_state.pending_scale = next_scale;
+    if (!g_state.present_driven) {
+        ApplyScaleLocked(next_scale);
+    }
     
     // Оновлення статистики
-    g_state.stats.current_scale = g_state.current_scale;
     g_state.stats.current_fps = current_fps;
     g_state.stats.average_fps = average_fps;
-    g_state.stats.render_width = static_cast<uint32_t>(g_state.native_width * g_state.current_scale);
-    g_state.stats.render_height = static_cast<uint32_t>(g_state.native_height * g_state.current_scale);
     g_state.stats.output_width = g_state.native_width;
     g_state.stats.output_height = g_state.native_height;
     g_state.stats.is_scaling_down = should_scale_down;
+    g_state.stats.predicted_gpu_time_ms = predicted_gpu_ms;
+    g_state.stats.gpu_bound = gpu_bound;
+    g_state.stats.has_gpu_feedback = has_gpu_feedback;
+    g_state.stats.gpu_utilization = std::min(1.0f, g_state.gpu_ema / std::max(g_state.frame_ema, 0.001f)) * 100.0f;
     
     // Лічильник змін масштабу
     static float last_logged_scale = 1.0f;
-    if (std::abs(g_state.current_scale - last_logged_scale) > 0.05f) {
+    if (std::abs(next_scale - last_logged_scale) > 0.05f) {
         g_state.stats.scale_changes++;
-        last_logged_scale = g_state.current_scale;
-        LOGI("DRS scale changed to %.0f%% (FPS: %.1f/%.0f)", 
-             g_state.current_scale * 100, average_fps, target_fps);
+        last_logged_scale = next_scale;
+        LOGI("DRS scale changed to %.0f%% (FPS: %.1f/%.0f, GPU %.1f ms%s)", 
+             next_scale * 100, average_fps, target_fps, predicted_gpu_ms,
+             gpu_bound ? "" : ", CPU-bound");
     }
     
     g_state.frame_count++;
     
-    return g_state.current_scale;
+    return next_scale;
+}
+
+void OnPresent() {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    
+    if (!g_state.initialized) return;
+    
+    g_state.present_driven = true;
+    ApplyScaleLocked(g_state.pending_scale);
 }
 
 float GetCurrentScale() {
     return g_current_scale.load();
 }
 
+uint32_t GetShadingRateLevel() {
+    return g_shading_rate_level.load();
+}
+
 void GetCurrentRenderResolution(uint32_t* width, uint32_t* height) {
     float scale = g_current_scale.load();
     
@@ -5,7 +5,10 @@
  * стабільного FPS на ARM64 пристроях.
  * 
  * Особливості:
- * - Моніторинг GPU/CPU навантаження в реальному часі
+ * - GPU час кадру з Vulkan timestamp запитів окремо від frame time:
+ *   масштаб змінюється лише коли bottleneck саме GPU (не CPU/SPU)
+ * - Предиктивний контролер: модель GPU час ~ scale^2 + PI корекція
+ * - Зміни масштабу застосовуються на межі present
  * - Адаптивне масштабування від 50% до 100% native resolution
  * - Інтеграція з FSR 3.1 для апскейлінгу
  * - Оптимізація для Snapdragon 8s Gen 3
@@ -56,8 +59,20 @@ struct DRSConfig {
     // Затримка перед зміною (кадри)
     uint32_t hysteresis_frames = 10;
     
+    // GPU busy / frame time, вище якого кадр вважається GPU-bound
+    float gpu_bound_threshold = 0.85f;
+    
+    // На скільки кадрів наперед екстраполювати GPU час
+    // (результати timestamp запитів запізнюються на 2-3 кадри)
+    float prediction_horizon = 2.0f;
+    
     // Увімкнути FSR апскейлінг
     bool use_fsr_upscale = true;
+    
+    // VRS (2x1, 2x2) як перший важіль: перші vrs_scale_band зниження
+    // масштабу знімаються coarse shading, роздільність падає лише далі
+    bool use_vrs = false;
+    float vrs_scale_band = 0.15f;
 };
 
 /**
@@ -75,6 +90,12 @@ struct DRSStats {
     float gpu_utilization;         // Завантаження GPU (%)
     float cpu_utilization;         // Завантаження CPU (%)
     bool is_scaling_down;          // Чи зараз знижується роздільна здатність
+    float gpu_time_ms;             // Останній GPU час кадру (timestamp queries)
+    float predicted_gpu_time_ms;   // Прогноз контролера
+    bool gpu_bound;                // Чи bottleneck - GPU
+    bool has_gpu_feedback;         // Чи надходять GPU timestamps
+    uint64_t frames_held;          // Кадрів, де масштаб не знижено (bottleneck CPU/SPU)
+    uint32_t shading_rate_level;   // VRS: 0 - вимкнено, 1 - 2x1, 2 - 2x2
 };
 
 /**
@@ -123,6 +144,18 @@ void SetMinScale(float scale);
  */
 void SetMaxScale(float scale);
 
+/**
+ * GPU час кадру (сума інтервалів між timestamp парами, без простоїв GPU).
+ * Подається окремо від frame time; без нього кожен кадр вважається GPU-bound.
+ */
+void ReportGPUTime(float gpu_time_ms);
+
+/**
+ * Частка GPU бюджету кадру (0.5-1.0): знижується заздалегідь за thermal
+ * прогнозом, щоб масштаб падав до троттлінгу, а не після нього
+ */
+void SetThermalBudget(float budget);
+
 /**
  * Оновлення стану DRS (викликається кожен кадр)
  * @param frame_time_ms Час останнього кадру в мілісекундах
@@ -130,11 +163,22 @@ void SetMaxScale(float scale);
  */
 float UpdateDRS(float frame_time_ms);
 
+/**
+ * Межа present: застосовує масштаб, розрахований UpdateDRS.
+ * Після першого виклику g_current_scale змінюється лише тут.
+ */
+void OnPresent();
+
 /**
  * Отримання поточного масштабу
  */
 float GetCurrentScale();
 
+/**
+ * Рівень VRS для RSX (0 - вимкнено, 1 - 2x1, 2 - 2x2)
+ */
+uint32_t GetShadingRateLevel();
+
 /**
  * Отримання поточної роздільної здатності рендерингу
  */
@@ -173,6 +217,7 @@ DRSConfig GetDRSConfig();
 // Глобальний стан для швидкого доступу
 extern std::atomic<float> g_current_scale;
 extern std::atomic<bool> g_drs_active;
+extern std::atomic<uint32_t> g_shading_rate_level;
 
 } // namespace rpcsx::drs
 
@@ -28,6 +28,10 @@ namespace rpcsx::memory {
 constexpr size_t PS4_RAM_SIZE = 8ULL * 1024 * 1024 * 1024;
 constexpr size_t VRAM_SIZE = 2ULL * 1024 * 1024 * 1024;  // 2GB для GPU
 
+// PS3 MMIO (0xF0000000, 16MB) - завжди через slow path
+constexpr uint64_t PS3_MMIO_BASE = 0xF0000000ULL;
+constexpr size_t PS3_MMIO_SIZE = 16 * 1024 * 1024;
+
 // ARMv9 page alignment - критично для NCE
 constexpr size_t ARMV9_PAGE_ALIGN = 65536;  // 64KB
 constexpr size_t CACHE_LINE_SIZE = 64;       // Cortex-X4 cache line
@@ -195,6 +199,9 @@ bool InitializeFastmem() {
     g_fastmem.access_count = 0;
     g_fastmem.fault_count = 0;
     
+    // MMIO не має backing пам'яті - JIT доступи мають фолтити
+    ProtectSlowRange(PS3_MMIO_BASE, PS3_MMIO_SIZE);
+    
     LOGI("Fastmem initialized:");
     LOGI("  - Size: %zu GB", g_fastmem.total_size / (1024*1024*1024));
     LOGI("  - Base: %p", g_fastmem.base_address);
@@ -265,6 +272,30 @@ void FastMemcpy(void* dest, const void* src, size_t size) {
 #endif
 }
 
+void* GetFastmemBase() {
+    if (!g_fastmem.initialized) return nullptr;
+    return g_fastmem.base_address;
+}
+
+bool ProtectSlowRange(uint64_t guest_address, size_t size) {
+    if (!g_fastmem.initialized || !g_fastmem.base_address) return false;
+    if (guest_address >= g_fastmem.total_size) return false;
+    
+    // mprotect працює посторінково
+    const uint64_t start = guest_address & ~(static_cast<uint64_t>(g_fastmem.page_size) - 1);
+    const uint64_t end = std::min<uint64_t>(RoundUp(guest_address + size, g_fastmem.page_size),
+                                            g_fastmem.total_size);
+    
+    void* addr = static_cast<uint8_t*>(g_fastmem.base_address) + start;
+    if (mprotect(addr, end - start, PROT_NONE) != 0) {
+        LOGW("ProtectSlowRange(0x%" PRIx64 ", %zu) failed: %s", guest_address, size, strerror(errno));
+        return false;
+    }
+    
+    LOGI("Fastmem slow range: 0x%" PRIx64 " - 0x%" PRIx64, start, end);
+    return true;
+}
+
 /**
  * Відображення гостьової адреси в хост адресу (zero overhead)
  */
@@ -43,6 +43,18 @@ void* GetDirectPointerSafe(uint64_t guest_address);
  */
 void FastMemcpy(void* dest, const void* src, size_t size);
 
+/**
+ * База fastmem вікна (guest адреса 0), nullptr якщо не ініціалізовано.
+ * JIT закріплює її в регістрі та генерує ldr/str напряму.
+ */
+void* GetFastmemBase();
+
+/**
+ * Позначити діапазон як slow path (PROT_NONE): JIT доступи до нього фолтять
+ * і backpatch'аться на MMIO handler. Використовується для MMIO/RSX регістрів.
+ */
+bool ProtectSlowRange(uint64_t guest_address, size_t size);
+
 /**
  * Трансляція гостьової адреси в хост адресу
  */
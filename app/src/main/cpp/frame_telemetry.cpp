@@ -0,0 +1,383 @@
+/**
+ * Per-frame Performance Telemetry Implementation
+ */
+
+#include "frame_telemetry.h"
+#include <android/log.h>
+#include <dlfcn.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
+
+#define LOG_TAG "RPCSX-Telemetry"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace rpcsx::telemetry {
+
+// =============================================================================
+// Thermal статус
+// =============================================================================
+
+// AThermal (API 30) шукаємо в libandroid під час виконання, щоб не піднімати minSdk
+struct AThermalManager;
+using AcquireManagerFn = AThermalManager* (*)();
+using GetStatusFn = int (*)(AThermalManager*);
+using StatusCallback = void (*)(void* data, int status);
+using RegisterListenerFn = int (*)(AThermalManager*, StatusCallback, void*);
+
+static std::atomic<uint8_t> g_thermal_status{kThermalUnknown};
+static std::once_flag g_thermal_once;
+
+static void OnThermalStatus(void*, int status) {
+    g_thermal_status.store(static_cast<uint8_t>(std::clamp(status, 0, 0xfe)),
+                           std::memory_order_relaxed);
+}
+
+static void InitializeThermalListener() {
+    void* libandroid = dlopen("libandroid.so", RTLD_NOW | RTLD_NOLOAD);
+    if (!libandroid) {
+        libandroid = dlopen("libandroid.so", RTLD_NOW);
+    }
+    if (!libandroid) {
+        return;
+    }
+
+    auto acquire = reinterpret_cast<AcquireManagerFn>(dlsym(libandroid, "AThermal_acquireManager"));
+    auto get_status = reinterpret_cast<GetStatusFn>(dlsym(libandroid, "AThermal_getCurrentThermalStatus"));
+    auto register_listener = reinterpret_cast<RegisterListenerFn>(
+        dlsym(libandroid, "AThermal_registerThermalStatusListener"));
+
+    if (!acquire || !get_status || !register_listener) {
+        LOGW("AThermal API unavailable, thermal status not recorded");
+        return;
+    }
+
+    // Менеджер живе до кінця процесу: listener викликається з binder потоку
+    AThermalManager* manager = acquire();
+    if (!manager) {
+        return;
+    }
+
+    OnThermalStatus(nullptr, get_status(manager));
+    if (register_listener(manager, &OnThermalStatus, nullptr) != 0) {
+        LOGW("AThermal listener registration failed");
+    }
+}
+
+// =============================================================================
+// Кільце кадрів
+// =============================================================================
+
+static uint64_t MonotonicMicros() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000 + static_cast<uint64_t>(ts.tv_nsec) / 1000;
+}
+
+static uint16_t Saturate16(uint64_t value) {
+    return static_cast<uint16_t>(std::min<uint64_t>(value, UINT16_MAX));
+}
+
+// Приріст наростаючого лічильника; потік, що завершився, зменшує суму
+static uint64_t CounterDelta(uint64_t current, uint64_t previous) {
+    return current > previous ? current - previous : 0;
+}
+
+class FrameTelemetryRing {
+public:
+    void Record(float frame_time_ms, float gpu_time_ms, float drs_scale,
+                const FrameCounters& totals, const HwCounterRates* hw) {
+        const uint64_t now_us = MonotonicMicros();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!has_baseline_) {
+            has_baseline_ = true;
+            last_totals_ = totals;
+            last_timestamp_us_ = now_us;
+            return;
+        }
+
+        // Зайнятість відносно реального інтервалу між записами: callback
+        // пропускає кадри без готових GPU timestamps
+        const uint64_t wall_ns = std::max<uint64_t>(1, (now_us - last_timestamp_us_) * 1000);
+        auto busy = [&](uint64_t current, uint64_t previous) {
+            return Saturate16(CounterDelta(current, previous) * 10000 / wall_ns);
+        };
+
+        FrameSample& sample = samples_[next_sequence_ % kFrameTelemetryCapacity];
+        sample.timestamp_us = now_us;
+        sample.frame_time_ms = frame_time_ms;
+        sample.gpu_time_ms = gpu_time_ms;
+        sample.ppu_busy = busy(totals.ppu_cpu_ns, last_totals_.ppu_cpu_ns);
+        sample.spu_busy = busy(totals.spu_cpu_ns, last_totals_.spu_cpu_ns);
+        sample.rsx_busy = busy(totals.rsx_cpu_ns, last_totals_.rsx_cpu_ns);
+        sample.drs_scale = Saturate16(static_cast<uint64_t>(std::clamp(drs_scale, 0.0f, 2.0f) * 10000.0f + 0.5f));
+        sample.pipeline_misses = Saturate16(CounterDelta(totals.pipeline_misses, last_totals_.pipeline_misses));
+        sample.texture_uploads = Saturate16(CounterDelta(totals.texture_uploads, last_totals_.texture_uploads));
+        sample.jit_compiles = Saturate16(CounterDelta(totals.jit_compiles, last_totals_.jit_compiles));
+        sample.thermal_status = g_thermal_status.load(std::memory_order_relaxed);
+        sample.reserved = 0;
+
+        auto fixed = [](float value, float scale) {
+            return Saturate16(static_cast<uint64_t>(std::max(value, 0.0f) * scale + 0.5f));
+        };
+        sample.ppu_ipc = hw ? fixed(hw->ppu_ipc, 1000.0f) : 0;
+        sample.spu_ipc = hw ? fixed(hw->spu_ipc, 1000.0f) : 0;
+        sample.spu_l1d_mpki = hw ? fixed(hw->spu_l1d_mpki, 10.0f) : 0;
+        sample.spu_l2_mpki = hw ? fixed(hw->spu_l2_mpki, 10.0f) : 0;
+
+        ++next_sequence_;
+        last_totals_ = totals;
+        last_timestamp_us_ = now_us;
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        oldest_sequence_ = next_sequence_;
+    }
+
+    // Наступний запис знову лише задає базу лічильників
+    void DropBaseline() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        has_baseline_ = false;
+    }
+
+    // Копія записів [first, first + count) під lock, щоб writer не перезаписав їх посеред читання
+    template <typename Visitor>
+    void Read(uint64_t since_sequence, Visitor&& visitor) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const uint64_t oldest = std::max(oldest_sequence_,
+            next_sequence_ > kFrameTelemetryCapacity ? next_sequence_ - kFrameTelemetryCapacity : 0);
+        const uint64_t first = std::clamp(since_sequence, oldest, next_sequence_);
+        const uint64_t dropped = since_sequence < oldest ? oldest - since_sequence : 0;
+
+        FrameTelemetryHeader header{};
+        header.magic = kFrameTelemetryMagic;
+        header.version = kFrameTelemetryVersion;
+        header.sample_size = sizeof(FrameSample);
+        header.first_sequence = first;
+        header.count = static_cast<uint32_t>(next_sequence_ - first);
+        header.dropped = static_cast<uint32_t>(std::min<uint64_t>(dropped, UINT32_MAX));
+
+        visitor(header, [&](uint32_t index) -> const FrameSample& {
+            return samples_[(first + index) % kFrameTelemetryCapacity];
+        });
+    }
+
+private:
+    std::mutex mutex_;
+    std::array<FrameSample, kFrameTelemetryCapacity> samples_{};
+    uint64_t next_sequence_ = 0;
+    uint64_t oldest_sequence_ = 0;
+    bool has_baseline_ = false;
+    FrameCounters last_totals_{};
+    uint64_t last_timestamp_us_ = 0;
+};
+
+static FrameTelemetryRing g_ring;
+static std::atomic<bool> g_enabled{false};
+
+// =============================================================================
+// Розбивка GPU часу
+// =============================================================================
+
+// Кількість різних проходів обмежена: RSX віддає лише найдорожчі за кадр
+class GpuCostAccumulator {
+public:
+    void Record(const GpuCostEntry* entries, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        ++frames_;
+        for (size_t i = 0; i < count; ++i) {
+            const GpuCostEntry& entry = entries[i];
+            Total& total = totals_[Key{entry.key, entry.width, entry.height, entry.kind}];
+            total.gpu_time_ms += entry.gpu_time_ms;
+            total.count += entry.count;
+            ++total.frames;
+        }
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        totals_.clear();
+        frames_ = 0;
+    }
+
+    std::string ExportJson() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<std::pair<Key, Total>> sorted(totals_.begin(), totals_.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.second.gpu_time_ms > b.second.gpu_time_ms;
+        });
+
+        std::string json;
+        json.reserve(48 + sorted.size() * 128);
+
+        char buffer[192];
+        snprintf(buffer, sizeof(buffer), "{\"frames\":%llu,\"costs\":[",
+                 static_cast<unsigned long long>(frames_));
+        json += buffer;
+
+        static constexpr const char* kKindNames[] = {"render_pass", "compute", "pipeline"};
+        const double frames = static_cast<double>(std::max<uint64_t>(frames_, 1));
+
+        bool first = true;
+        for (const auto& [key, total] : sorted) {
+            const auto kind = static_cast<size_t>(key.kind);
+            snprintf(buffer, sizeof(buffer),
+                     "%s{\"kind\":\"%s\",\"key\":\"%016llx\",\"width\":%u,\"height\":%u,"
+                     "\"ms_per_frame\":%.4f,\"count_per_frame\":%.2f,\"frames_seen\":%llu}",
+                     first ? "" : ",",
+                     kind < std::size(kKindNames) ? kKindNames[kind] : "unknown",
+                     static_cast<unsigned long long>(key.key), key.width, key.height,
+                     total.gpu_time_ms / frames, total.count / frames,
+                     static_cast<unsigned long long>(total.frames));
+            json += buffer;
+            first = false;
+        }
+
+        json += "]}";
+        return json;
+    }
+
+private:
+    struct Key {
+        uint64_t key;
+        uint16_t width;
+        uint16_t height;
+        GpuCostKind kind;
+
+        bool operator==(const Key& other) const {
+            return key == other.key && width == other.width && height == other.height &&
+                   kind == other.kind;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t h = k.key ^ (static_cast<uint64_t>(k.width) << 40) ^
+                         (static_cast<uint64_t>(k.height) << 20) ^ static_cast<uint64_t>(k.kind);
+            return static_cast<size_t>(h * 0x9e3779b97f4a7c15ull);
+        }
+    };
+
+    struct Total {
+        double gpu_time_ms = 0;
+        uint64_t count = 0;
+        uint64_t frames = 0;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<Key, Total, KeyHash> totals_;
+    uint64_t frames_ = 0;
+};
+
+static GpuCostAccumulator g_gpu_costs;
+
+// =============================================================================
+// API
+// =============================================================================
+
+void SetFrameTelemetryEnabled(bool enabled) {
+    if (enabled) {
+        std::call_once(g_thermal_once, InitializeThermalListener);
+    }
+
+    // Пауза в записі не повинна потрапити в зайнятість наступного кадру
+    g_ring.DropBaseline();
+    g_enabled.store(enabled, std::memory_order_release);
+    LOGI("Frame telemetry %s", enabled ? "enabled" : "disabled");
+}
+
+bool IsFrameTelemetryEnabled() {
+    return g_enabled.load(std::memory_order_acquire);
+}
+
+void RecordFrame(float frame_time_ms, float gpu_time_ms, float drs_scale,
+                 const FrameCounters& totals, const HwCounterRates* hw) {
+    if (!IsFrameTelemetryEnabled()) {
+        return;
+    }
+
+    g_ring.Record(frame_time_ms, gpu_time_ms, drs_scale, totals, hw);
+}
+
+void RecordGpuCosts(const GpuCostEntry* entries, size_t count) {
+    if (!IsFrameTelemetryEnabled()) {
+        return;
+    }
+
+    g_gpu_costs.Record(entries, count);
+}
+
+void ResetFrameTelemetry() {
+    g_ring.Clear();
+    g_gpu_costs.Clear();
+}
+
+void ExportFrameTelemetry(uint64_t since_sequence, std::vector<uint8_t>* out) {
+    g_ring.Read(since_sequence, [&](const FrameTelemetryHeader& header, auto&& sample_at) {
+        out->resize(sizeof(header) + static_cast<size_t>(header.count) * sizeof(FrameSample));
+        uint8_t* dst = out->data();
+        std::memcpy(dst, &header, sizeof(header));
+        dst += sizeof(header);
+
+        for (uint32_t i = 0; i < header.count; ++i) {
+            std::memcpy(dst, &sample_at(i), sizeof(FrameSample));
+            dst += sizeof(FrameSample);
+        }
+    });
+}
+
+std::string ExportFrameTelemetryJson(uint64_t since_sequence) {
+    std::string json;
+
+    g_ring.Read(since_sequence, [&](const FrameTelemetryHeader& header, auto&& sample_at) {
+        char buffer[400];
+        snprintf(buffer, sizeof(buffer),
+                 "{\"version\":%u,\"first_sequence\":%llu,\"dropped\":%u,\"frames\":[",
+                 header.version, static_cast<unsigned long long>(header.first_sequence),
+                 header.dropped);
+        json.reserve(64 + static_cast<size_t>(header.count) * 260);
+        json += buffer;
+
+        for (uint32_t i = 0; i < header.count; ++i) {
+            const FrameSample& sample = sample_at(i);
+            snprintf(buffer, sizeof(buffer),
+                     "%s{\"t_us\":%llu,\"frame_ms\":%.3f,\"gpu_ms\":%.3f,"
+                     "\"ppu_busy\":%.2f,\"spu_busy\":%.2f,\"rsx_busy\":%.2f,"
+                     "\"pipeline_misses\":%u,\"texture_uploads\":%u,\"jit_compiles\":%u,"
+                     "\"drs_scale\":%.4f,\"thermal\":%d,"
+                     "\"ppu_ipc\":%.3f,\"spu_ipc\":%.3f,\"spu_l1d_mpki\":%.1f,\"spu_l2_mpki\":%.1f}",
+                     i ? "," : "",
+                     static_cast<unsigned long long>(sample.timestamp_us),
+                     sample.frame_time_ms, sample.gpu_time_ms,
+                     sample.ppu_busy / 100.0, sample.spu_busy / 100.0, sample.rsx_busy / 100.0,
+                     sample.pipeline_misses, sample.texture_uploads, sample.jit_compiles,
+                     sample.drs_scale / 10000.0,
+                     sample.thermal_status == kThermalUnknown ? -1 : sample.thermal_status,
+                     sample.ppu_ipc / 1000.0, sample.spu_ipc / 1000.0,
+                     sample.spu_l1d_mpki / 10.0, sample.spu_l2_mpki / 10.0);
+            json += buffer;
+        }
+
+        json += "]}";
+    });
+
+    return json;
+}
+
+std::string ExportGpuCostsJson() {
+    return g_gpu_costs.ExportJson();
+}
+
+} // namespace rpcsx::telemetry
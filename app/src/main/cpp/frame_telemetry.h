@@ -0,0 +1,154 @@
+/**
+ * Per-frame Performance Telemetry
+ *
+ * Кільце фіксованого розміру з одним записом на кадр для оверлею і
+ * телеметрії флоту. Записує RSX потік на межі present (frame timing
+ * callback), читач забирає все нове одним JNI викликом.
+ *
+ * Особливості:
+ * - Компактний бінарний формат (little endian, 40 байт на кадр)
+ * - Інкрементальне читання за sequence без дублікатів
+ * - Зайнятість PPU/SPU/RSX потоків з їх CPU часу за кадр
+ * - Thermal статус через AThermal listener (без binder виклику на кадр)
+ * - IPC і промахи кешу PPU/SPU з perf_event_open (якщо ядро дозволяє)
+ * - Середній GPU час по render pass / compute / pipeline для game_profiles
+ */
+
+#ifndef RPCSX_FRAME_TELEMETRY_H
+#define RPCSX_FRAME_TELEMETRY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace rpcsx::telemetry {
+
+/**
+ * Наростаючі підсумки, з яких RecordFrame рахує приріст за кадр
+ */
+struct FrameCounters {
+    uint64_t ppu_cpu_ns;              // CPU час усіх PPU потоків
+    uint64_t spu_cpu_ns;              // CPU час усіх SPU потоків
+    uint64_t rsx_cpu_ns;              // CPU час RSX потоку
+    uint64_t pipeline_misses;         // Pipeline lookups, що вимагали компіляції
+    uint64_t texture_uploads;         // Завантажень у texture cache
+    uint64_t jit_compiles;            // Скомпільованих JIT блоків
+};
+
+/**
+ * Апаратні лічильники за останнє вікно perf_monitor (не наростаючі)
+ */
+struct HwCounterRates {
+    float ppu_ipc;
+    float spu_ipc;
+    float spu_l1d_mpki;               // Промахів L1D на тисячу інструкцій
+    float spu_l2_mpki;
+};
+
+/**
+ * Запис одного кадру (ABI бінарного експорту)
+ */
+struct FrameSample {
+    uint64_t timestamp_us;            // CLOCK_MONOTONIC
+    float frame_time_ms;
+    float gpu_time_ms;                // 0, якщо timestamps недоступні
+    uint16_t ppu_busy;                // Сотні відсотка від часу кадру, сума по потоках
+    uint16_t spu_busy;                //   (10000 = одне ядро зайняте весь кадр)
+    uint16_t rsx_busy;
+    uint16_t drs_scale;               // Масштаб DRS * 10000
+    uint16_t pipeline_misses;         // За кадр, з насиченням
+    uint16_t texture_uploads;
+    uint16_t jit_compiles;
+    uint8_t thermal_status;           // AThermalStatus, kThermalUnknown без API 30
+    uint8_t reserved;
+    // v2: 0, якщо апаратні лічильники недоступні
+    uint16_t ppu_ipc;                 // IPC * 1000
+    uint16_t spu_ipc;
+    uint16_t spu_l1d_mpki;            // MPKI * 10
+    uint16_t spu_l2_mpki;
+};
+
+static_assert(sizeof(FrameSample) == 40, "FrameSample is part of the export ABI");
+
+/**
+ * Заголовок бінарного експорту, за ним count записів FrameSample
+ */
+struct FrameTelemetryHeader {
+    uint32_t magic;                   // kFrameTelemetryMagic
+    uint16_t version;                 // kFrameTelemetryVersion
+    uint16_t sample_size;             // sizeof(FrameSample)
+    uint64_t first_sequence;          // Sequence першого запису; наступне читання з first_sequence + count
+    uint32_t count;
+    uint32_t dropped;                 // Записів, перезаписаних до читання
+};
+
+static_assert(sizeof(FrameTelemetryHeader) == 24, "FrameTelemetryHeader is part of the export ABI");
+
+/**
+ * Вартість одного проходу за кадр (дзеркало rsx::gpu_cost_entry з RSXDisplay.h)
+ */
+enum class GpuCostKind : uint8_t {
+    RenderPass = 0,
+    Compute = 1,
+    Pipeline = 2,                     // Оцінка: час проходу, поділений за кількістю draw
+};
+
+struct GpuCostEntry {
+    uint64_t key;                     // Ключ render pass, хеш compute шейдера або pipeline
+    float gpu_time_ms;
+    uint16_t count;                   // Проходів / dispatch / draw за кадр
+    uint16_t width;                   // Розмір render pass (0 для інших)
+    uint16_t height;
+    GpuCostKind kind;
+    uint8_t reserved;
+    uint32_t reserved2;
+};
+
+static_assert(sizeof(GpuCostEntry) == 24, "GpuCostEntry mirrors rsx::gpu_cost_entry");
+
+constexpr uint32_t kFrameTelemetryMagic = 0x4c544652; // "RFTL"
+constexpr uint16_t kFrameTelemetryVersion = 2;
+constexpr uint32_t kFrameTelemetryCapacity = 1024;
+constexpr uint8_t kThermalUnknown = 0xff;
+
+/**
+ * Увімкнення запису; після увімкнення перший кадр лише задає базу лічильників
+ */
+void SetFrameTelemetryEnabled(bool enabled);
+bool IsFrameTelemetryEnabled();
+
+/**
+ * Запис кадру (RSX потік, на межі present); hw - nullptr без апаратних лічильників
+ */
+void RecordFrame(float frame_time_ms, float gpu_time_ms, float drs_scale,
+                 const FrameCounters& totals, const HwCounterRates* hw = nullptr);
+
+/**
+ * Розбивка GPU часу одного кадру (RSX потік, коли готові timestamps)
+ */
+void RecordGpuCosts(const GpuCostEntry* entries, size_t count);
+
+/**
+ * Очистити кільце (sequence продовжує рости) і накопичену розбивку GPU часу
+ */
+void ResetFrameTelemetry();
+
+/**
+ * Бінарний експорт записів із sequence >= since_sequence
+ */
+void ExportFrameTelemetry(uint64_t since_sequence, std::vector<uint8_t>* out);
+
+/**
+ * Те ж у JSON (для логів і діагностики)
+ */
+std::string ExportFrameTelemetryJson(uint64_t since_sequence);
+
+/**
+ * Середній за кадр GPU час кожного проходу з моменту скидання, найдорожчі першими
+ */
+std::string ExportGpuCostsJson();
+
+} // namespace rpcsx::telemetry
+
+#endif // RPCSX_FRAME_TELEMETRY_H
@@ -9,6 +9,7 @@ namespace rpcsx::fsr {
 
 static FSRContext g_ctx{};
 static std::atomic<bool> g_initialized{false};
+static std::atomic<bool> g_frame_generation{false};
 
 bool InitializeFSR(uint32_t input_width, uint32_t input_height,
                    uint32_t output_width, uint32_t output_height,
@@ -63,4 +64,14 @@ void GetOptimalRenderResolution(uint32_t target_width, uint32_t target_height,
     }
 }
 
+void SetFrameGeneration(bool enabled) {
+    if (g_frame_generation.exchange(enabled, std::memory_order_acq_rel) != enabled) {
+        LOGI("Frame generation %s", enabled ? "requested" : "disabled");
+    }
+}
+
+bool IsFrameGenerationEnabled() {
+    return g_frame_generation.load(std::memory_order_acquire);
+}
+
 } // namespace rpcsx::fsr
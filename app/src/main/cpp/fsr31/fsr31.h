@@ -58,6 +58,17 @@ void GetOptimalRenderResolution(uint32_t target_width, uint32_t target_height,
                                 FSRQuality quality,
                                 uint32_t* out_render_width, uint32_t* out_render_height);
 
+/**
+ * Генерація проміжних кадрів для поточної гри (профіль або користувач).
+ * Сам пас виконується у Vulkan бекенді RSX і вимикається там при нестачі GPU
+ */
+void SetFrameGeneration(bool enabled);
+
+/**
+ * Чи запитана генерація кадрів
+ */
+bool IsFrameGenerationEnabled();
+
 } // namespace rpcsx::fsr
 
 #endif // RPCSX_FSR31_H
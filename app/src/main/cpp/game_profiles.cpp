@@ -130,6 +130,7 @@ static GameProfile CreateGodOfWarProfile() {
     p.gpu.drs_min_scale = 0.75f;
     p.gpu.anti_aliasing = AAMode::FXAA;
     p.gpu.async_shader_compile = true;
+    p.gpu.frame_generation = true;
     
     p.cpu.spu_mode = SPUMode::RECOMPILER_ASMJIT;
     p.cpu.ppu_mode = PPUMode::RECOMPILER_LLVM;
@@ -150,6 +151,7 @@ static GameProfile CreateUnchartedProfile() {
     p.gpu.resolution_scale = 1.0f;
     p.gpu.enable_drs = true;
     p.gpu.anisotropic = AnisotropicLevel::X8;
+    p.gpu.frame_generation = true;
     
     p.cpu.spu_mode = SPUMode::RECOMPILER_ASMJIT;
     
@@ -170,6 +172,7 @@ static GameProfile CreateTLOUProfile() {
     p.gpu.drs_min_scale = 0.8f;
     p.gpu.texture_cache_size_mb = 512;
     p.gpu.async_shader_compile = true;
+    p.gpu.frame_generation = true;
     
     p.cpu.spu_mode = SPUMode::RECOMPILER_LLVM;
     p.cpu.spu_accurate_dfma = true;
@@ -499,12 +502,17 @@ public:
         ss << "    \"mode\": " << static_cast<int>(profile->gpu.mode) << ",\n";
         ss << "    \"resolution_scale\": " << profile->gpu.resolution_scale << ",\n";
         ss << "    \"enable_drs\": " << (profile->gpu.enable_drs ? "true" : "false") << ",\n";
+        ss << "    \"drs_max_scale\": " << profile->gpu.drs_max_scale << ",\n";
+        ss << "    \"async_shader_compile\": " << (profile->gpu.async_shader_compile ? "true" : "false") << ",\n";
         ss << "    \"anisotropic\": " << static_cast<int>(profile->gpu.anisotropic) << ",\n";
-        ss << "    \"anti_aliasing\": " << static_cast<int>(profile->gpu.anti_aliasing) << "\n";
+        ss << "    \"anti_aliasing\": " << static_cast<int>(profile->gpu.anti_aliasing) << ",\n";
+        ss << "    \"frame_generation\": " << (profile->gpu.frame_generation ? "true" : "false") << "\n";
         ss << "  },\n";
         ss << "  \"cpu\": {\n";
         ss << "    \"ppu_mode\": " << static_cast<int>(profile->cpu.ppu_mode) << ",\n";
-        ss << "    \"spu_mode\": " << static_cast<int>(profile->cpu.spu_mode) << "\n";
+        ss << "    \"spu_mode\": " << static_cast<int>(profile->cpu.spu_mode) << ",\n";
+        ss << "    \"spu_block_size\": " << static_cast<int>(profile->cpu.spu_block_size) << ",\n";
+        ss << "    \"max_spu_threads\": " << (profile->hacks.limit_spu_threads ? profile->hacks.max_spu_threads : 0) << "\n";
         ss << "  },\n";
         ss << "  \"target_fps\": " << profile->target_fps << ",\n";
         ss << "  \"unlock_fps\": " << (profile->unlock_fps ? "true" : "false") << "\n";
@@ -675,6 +683,37 @@ const char* GetGameRegion(const char* title_id) {
     return "Unknown";
 }
 
+bool IsHLEFastPathAllowed(const char* title_id, const char* function) {
+    if (!title_id || !function || !IsProfileSystemActive()) return true;
+
+    static const struct {
+        const char* name;
+        uint32_t bit;
+    } FAST_PATHS[] = {
+        {"memcpy", HLE_FAST_PATH_MEMCPY},
+        {"memset", HLE_FAST_PATH_MEMSET},
+        {"memmove", HLE_FAST_PATH_MEMMOVE},
+        {"memcmp", HLE_FAST_PATH_MEMCMP},
+    };
+
+    const GameProfile* profile = GetProfileForGame(title_id);
+    if (!profile) return true;
+
+    for (const auto& fast_path : FAST_PATHS) {
+        if (strcmp(fast_path.name, function) == 0) {
+            return (profile->hacks.disabled_hle_fast_paths & fast_path.bit) == 0;
+        }
+    }
+    return true;
+}
+
+bool IsPPUHostFPCREnabled(const char* title_id) {
+    if (!title_id || !IsProfileSystemActive()) return false;
+
+    const GameProfile* profile = GetProfileForGame(title_id);
+    return profile && profile->cpu.ppu_host_fpcr_nj && !profile->cpu.ppu_accurate_nj;
+}
+
 void CopyProfile(GameProfile* dest, const GameProfile* src) {
     if (dest && src) {
         memcpy(dest, src, sizeof(GameProfile));
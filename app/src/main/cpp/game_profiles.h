@@ -63,6 +63,15 @@ enum class PPUMode : uint8_t {
     AUTO                    // Автовибір
 };
 
+/**
+ * Розмір блоків SPU LLVM рекомпілятора (tier JIT: більші блоки - довша компіляція, швидший код)
+ */
+enum class SPUBlockSize : uint8_t {
+    SAFE = 0,
+    MEGA,
+    GIGA
+};
+
 /**
  * Рівень анізотропної фільтрації
  */
@@ -141,6 +150,7 @@ struct GPUSettings {
     bool use_pipeline_cache = true;
     bool prefer_vsync = true;
     VSyncMode vsync_mode = VSyncMode::ADAPTIVE;
+    bool frame_generation = false;           // Проміжні кадри між флипами (ігри з 30 FPS)
     
     // Accuracy
     bool strict_rendering = false;
@@ -158,9 +168,11 @@ struct CPUSettings {
     bool ppu_accurate_nj = false;
     bool ppu_accurate_vnan = false;
     bool ppu_accurate_fpcc = false;
+    bool ppu_host_fpcr_nj = false;          // NJ через FPCR.FZ хоста замість маски на кожну VMX FP операцію
     
     // SPU
     SPUMode spu_mode = SPUMode::RECOMPILER_ASMJIT;
+    SPUBlockSize spu_block_size = SPUBlockSize::SAFE;
     uint32_t spu_threads = 0;               // 0 = auto
     bool spu_accurate_dfma = false;
     bool spu_accurate_getllar = false;
@@ -195,6 +207,16 @@ struct NetworkSettings {
     uint16_t bind_port = 0;                 // 0 = auto
 };
 
+/**
+ * Static HLE підміни бібліотечних функцій гри (біти для disabled_hle_fast_paths)
+ */
+enum HLEFastPath : uint32_t {
+    HLE_FAST_PATH_MEMCPY  = 1u << 0,
+    HLE_FAST_PATH_MEMSET  = 1u << 1,
+    HLE_FAST_PATH_MEMMOVE = 1u << 2,
+    HLE_FAST_PATH_MEMCMP  = 1u << 3,
+};
+
 /**
  * Хаки/патчі для сумісності
  */
@@ -203,6 +225,9 @@ struct CompatibilityHacks {
     bool skip_intro = false;
     bool disable_vertex_cache = false;
     bool force_gpu_flush = false;
+    bool disable_zcull_speculation = false;  // Гра потребує точних ZCULL звітів
+    uint32_t disabled_hle_fast_paths = 0;    // HLEFastPath біти, які не можна підміняти
+    bool vmx_fast_math = false;              // NCE VMX без VSCR[SAT] (гра не читає mfvscr)
     
     // Специфічні
     bool fix_god_of_war_shadows = false;
@@ -432,6 +457,19 @@ const char* GetGameName(const char* title_id);
  */
 const char* GetGameRegion(const char* title_id);
 
+/**
+ * Чи можна підмінити знайдену функцію гри її HLE реалізацією
+ * @param title_id Title ID гри
+ * @param function Ім'я функції (e.g., "memcpy")
+ */
+bool IsHLEFastPathAllowed(const char* title_id, const char* function);
+
+/**
+ * Чи компілювати PPU код гри з NJ режимом у FPCR хоста замість програмної маски
+ * @param title_id Title ID гри
+ */
+bool IsPPUHostFPCREnabled(const char* title_id);
+
 /**
  * Скопіювати профіль
  */
@@ -182,6 +182,10 @@ struct ShaderVariant {
     std::vector<uint32_t> spirv_fragment;
     std::vector<uint32_t> spirv_compute;
     bool is_loaded = false;
+    
+    // Один SPIR-V для всіх vendors, налаштування через specialization constants
+    // (shaders::BuildVariantSpecialization); зазвичай зареєстрований як UNKNOWN
+    bool uses_specialization = false;
 };
 
 /**
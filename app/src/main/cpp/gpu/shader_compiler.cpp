@@ -677,6 +677,19 @@ void ShaderVariantManager::RegisterVariant(const std::string& shader_name,
          shader_name.c_str(), gpu::GetVendorName(vendor));
 }
 
+void ShaderVariantManager::RegisterSpecializedShader(const std::string& shader_name,
+                                                      const std::string& shader_path) {
+    VariantInfo info;
+    info.shader_name = shader_name;
+    info.vendor = gpu::GPUVendor::UNKNOWN;
+    info.shader_path = shader_path;
+    info.specialized = true;
+    
+    m_variants[shader_name].push_back(info);
+    
+    LOGI("Registered specialized shader: %s", shader_name.c_str());
+}
+
 std::string ShaderVariantManager::GetBestVariant(const std::string& shader_name) {
     auto it = m_variants.find(shader_name);
     if (it == m_variants.end()) {
@@ -708,17 +721,31 @@ std::string ShaderVariantManager::GetBestVariant(const std::string& shader_name)
     return "";
 }
 
+const GPUCompiledShader& ShaderVariantManager::LoadCached(const VariantInfo& variant,
+                                                          const gpu::GPUInfo& gpu_info) {
+    const std::string key = GenerateVariantCacheKey(variant.shader_path, gpu_info.vendor,
+                                                    gpu_info.driver_version);
+    
+    auto it = m_compiled_variants.find(key);
+    if (it == m_compiled_variants.end()) {
+        ShaderStage stage = ShaderStageFromExtension(variant.shader_path);
+        it = m_compiled_variants.emplace(key, ShaderCompiler::Instance().LoadSPIRV(variant.shader_path, stage)).first;
+    }
+    
+    return it->second;
+}
+
 bool ShaderVariantManager::LoadVariantsForGPU(gpu::GPUVendor vendor) {
     LOGI("Loading shader variants for %s", gpu::GetVendorName(vendor));
     
-    auto& compiler = ShaderCompiler::Instance();
+    gpu::GPUInfo gpu_info = gpu::GetCachedGPUInfo();
+    gpu_info.vendor = vendor;
     
     for (auto& [name, variants] : m_variants) {
         for (auto& variant : variants) {
             if (variant.vendor == vendor || variant.vendor == gpu::GPUVendor::UNKNOWN) {
                 // Try to load the shader
-                ShaderStage stage = ShaderStageFromExtension(variant.shader_path);
-                variant.compiled = compiler.LoadSPIRV(variant.shader_path, stage);
+                variant.compiled = LoadCached(variant, gpu_info);
                 
                 if (variant.compiled.is_valid) {
                     m_active_shaders[name] = variant.compiled;
@@ -728,6 +755,33 @@ bool ShaderVariantManager::LoadVariantsForGPU(gpu::GPUVendor vendor) {
         }
     }
     
+    return PrecompileForTier(gpu_info.tier);
+}
+
+bool ShaderVariantManager::PrecompileForTier(gpu::GPUTier tier) {
+    const auto index = static_cast<size_t>(tier);
+    if (index >= m_tier_sets.size()) {
+        return false;
+    }
+    
+    const gpu::GPUInfo& gpu_info = gpu::GetCachedGPUInfo();
+    const ShaderOptimizationFlags& flags = ShaderCompiler::Instance().GetDefaultFlags();
+    auto& tier_set = m_tier_sets[index];
+    
+    for (const auto& [name, variants] : m_variants) {
+        for (const auto& variant : variants) {
+            if (!variant.specialized) {
+                continue;
+            }
+            
+            // One module per driver, only the constants differ between tiers
+            if (LoadCached(variant, gpu_info).is_valid) {
+                tier_set[name] = BuildVariantSpecialization(gpu_info.vendor, tier, flags);
+            }
+        }
+    }
+    
+    LOGI("Specialized shaders for %s: %zu", gpu::GetTierName(tier), tier_set.size());
     return true;
 }
 
@@ -739,6 +793,26 @@ const GPUCompiledShader* ShaderVariantManager::GetCompiledShader(const std::stri
     return nullptr;
 }
 
+const ShaderSpecialization* ShaderVariantManager::GetSpecialization(const std::string& shader_name,
+                                                                    gpu::GPUTier tier) const {
+    const auto index = static_cast<size_t>(tier);
+    if (index >= m_tier_sets.size()) {
+        return nullptr;
+    }
+    
+    auto it = m_tier_sets[index].find(shader_name);
+    return (it != m_tier_sets[index].end()) ? &it->second : nullptr;
+}
+
+VkSpecializationInfo ShaderSpecialization::GetInfo() const {
+    VkSpecializationInfo info{};
+    info.mapEntryCount = static_cast<uint32_t>(entries.size());
+    info.pMapEntries = entries.data();
+    info.dataSize = sizeof(data);
+    info.pData = data.data();
+    return info;
+}
+
 // =============================================================================
 // Helper Functions Implementation
 // =============================================================================
@@ -801,5 +875,41 @@ std::string GenerateShaderCacheKey(const std::string& source,
     return key.str();
 }
 
+ShaderSpecialization BuildVariantSpecialization(gpu::GPUVendor vendor,
+                                                gpu::GPUTier tier,
+                                                const ShaderOptimizationFlags& flags) {
+    ShaderSpecialization spec;
+    
+    auto set = [&spec](VariantConstant id, uint32_t value) {
+        const auto index = static_cast<size_t>(id);
+        spec.entries[index].constantID = static_cast<uint32_t>(id);
+        spec.entries[index].offset = static_cast<uint32_t>(index * sizeof(uint32_t));
+        spec.entries[index].size = sizeof(uint32_t);
+        spec.data[index] = value;
+    };
+    
+    set(VariantConstant::VENDOR, static_cast<uint32_t>(vendor));
+    set(VariantConstant::TIER, static_cast<uint32_t>(tier));
+    set(VariantConstant::HALF_PRECISION, flags.use_half_precision && !flags.force_full_precision);
+    set(VariantConstant::MALI_FMA, vendor == gpu::GPUVendor::ARM_MALI && flags.mali_use_fma);
+    set(VariantConstant::ADRENO_GMEM_HINTS, vendor == gpu::GPUVendor::QUALCOMM_ADRENO && flags.adreno_use_gmem_hints);
+    set(VariantConstant::POWERVR_TBDR, vendor == gpu::GPUVendor::IMAGINATION_POWERVR && flags.powervr_optimize_tbdr);
+    
+    return spec;
+}
+
+std::string GenerateVariantCacheKey(const std::string& shader_path,
+                                    gpu::GPUVendor vendor,
+                                    const std::string& driver_version) {
+    std::hash<std::string> hasher;
+    
+    std::stringstream ss;
+    ss << shader_path << '|' << static_cast<int>(vendor) << '|' << driver_version;
+    
+    std::stringstream key;
+    key << std::hex << hasher(ss.str());
+    return key.str();
+}
+
 } // namespace shaders
 } // namespace rpcsx
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 #include <memory>
@@ -118,6 +119,31 @@ struct GPUCompiledShader {
     std::string error_message;
 };
 
+// =============================================================================
+// Specialization Constants
+// =============================================================================
+
+// constant_id values a specialized shader declares, e.g.
+// layout(constant_id = 0) const uint VENDOR = 0;
+enum class VariantConstant : uint32_t {
+    VENDOR = 0,
+    TIER,
+    HALF_PRECISION,
+    MALI_FMA,
+    ADRENO_GMEM_HINTS,
+    POWERVR_TBDR,
+    
+    COUNT
+};
+
+struct ShaderSpecialization {
+    std::array<VkSpecializationMapEntry, static_cast<size_t>(VariantConstant::COUNT)> entries{};
+    std::array<uint32_t, static_cast<size_t>(VariantConstant::COUNT)> data{};
+    
+    // Points into this object, valid while it is alive and not moved
+    VkSpecializationInfo GetInfo() const;
+};
+
 // =============================================================================
 // Shader Source
 // =============================================================================
@@ -151,6 +177,9 @@ public:
     void SetTargetGPU(gpu::GPUVendor vendor, gpu::GPUTier tier);
     void SetTargetGPU(const gpu::GPUInfo& gpu_info);
     
+    // Vendor defaults chosen in Initialize
+    const ShaderOptimizationFlags& GetDefaultFlags() const { return m_default_flags; }
+    
     // Compilation
     GPUCompiledShader CompileGLSL(const ShaderSource& source, 
                                 const ShaderOptimizationFlags& flags = {});
@@ -244,14 +273,26 @@ public:
                          gpu::GPUVendor vendor,
                          const std::string& shader_path);
     
+    // Register one SPIR-V module for all vendors, tuned through VariantConstant
+    void RegisterSpecializedShader(const std::string& shader_name,
+                                   const std::string& shader_path);
+    
     // Get best shader for current GPU
     std::string GetBestVariant(const std::string& shader_name);
     
     // Load all registered variants for current GPU
     bool LoadVariantsForGPU(gpu::GPUVendor vendor);
     
+    // Build the specialization set of every specialized shader for a tier,
+    // pipelines for that tier are created from these before the game starts
+    bool PrecompileForTier(gpu::GPUTier tier);
+    
     // Get compiled shader
     const GPUCompiledShader* GetCompiledShader(const std::string& shader_name);
+    
+    // Specialization for pSpecializationInfo, nullptr for per-vendor variants
+    const ShaderSpecialization* GetSpecialization(const std::string& shader_name,
+                                                  gpu::GPUTier tier) const;
 
 private:
     ShaderVariantManager() = default;
@@ -261,10 +302,19 @@ private:
         gpu::GPUVendor vendor;
         std::string shader_path;
         GPUCompiledShader compiled;
+        bool specialized = false;
     };
     
+    const GPUCompiledShader& LoadCached(const VariantInfo& variant, const gpu::GPUInfo& gpu_info);
+    
     std::unordered_map<std::string, std::vector<VariantInfo>> m_variants;
     std::unordered_map<std::string, GPUCompiledShader> m_active_shaders;
+    
+    // Key from GenerateVariantCacheKey: same module, vendor and driver reuse the result
+    std::unordered_map<std::string, GPUCompiledShader> m_compiled_variants;
+    
+    std::array<std::unordered_map<std::string, ShaderSpecialization>,
+               static_cast<size_t>(gpu::GPUTier::COUNT)> m_tier_sets;
 };
 
 // =============================================================================
@@ -289,5 +339,19 @@ std::string GenerateShaderCacheKey(const std::string& source,
                                     const ShaderOptimizationFlags& flags,
                                     gpu::GPUVendor vendor);
 
+/**
+ * Specialization constants for a vendor and tier
+ */
+ShaderSpecialization BuildVariantSpecialization(gpu::GPUVendor vendor,
+                                                gpu::GPUTier tier,
+                                                const ShaderOptimizationFlags& flags);
+
+/**
+ * Cache key of a compiled variant: shader, vendor and driver version
+ */
+std::string GenerateVariantCacheKey(const std::string& shader_path,
+                                    gpu::GPUVendor vendor,
+                                    const std::string& driver_version);
+
 } // namespace shaders
 } // namespace rpcsx
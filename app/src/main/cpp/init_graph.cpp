@@ -0,0 +1,205 @@
+/**
+ * Subsystem Init Graph Implementation
+ */
+
+#include "init_graph.h"
+#include "nce_core/thread_pool.h"
+#include <android/log.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+
+#define LOG_TAG "RPCSX-Init"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace rpcsx::init {
+
+static constexpr size_t kMaxInitWorkers = 4;
+
+static uint64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct InitGraph::Execution {
+    std::vector<Node> nodes;
+    std::vector<std::vector<size_t>> successors;
+    std::unique_ptr<std::atomic<uint32_t>[]> remaining;   // Невиконані залежності
+    // Кожен елемент пише лише задача свого вузла, читає Wait() після pool->wait()
+    std::vector<uint8_t> ran;
+    std::vector<uint8_t> ok;
+    std::vector<uint64_t> duration_us;
+    std::unique_ptr<util::ThreadPool> pool;
+    size_t workers = 0;
+    uint64_t start_us = 0;
+};
+
+InitGraph::InitGraph(const char* name) : name_(name) {}
+
+InitGraph::~InitGraph() {
+    Wait();
+}
+
+void InitGraph::Add(std::string name, std::vector<std::string> deps, InitFn fn,
+                    bool critical) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& node : pending_) {
+        if (node.name == name) {
+            node.deps = std::move(deps);
+            node.fn = std::move(fn);
+            node.critical = critical;
+            return;
+        }
+    }
+
+    pending_.push_back({std::move(name), std::move(deps), std::move(fn), critical});
+}
+
+void InitGraph::Start(size_t max_parallel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (running_) {
+        LOGW("[%s] Start() while a previous run is not waited for", name_.c_str());
+        return;
+    }
+
+    auto exec = std::make_unique<Execution>();
+    exec->nodes = std::move(pending_);
+    pending_.clear();
+    exec->start_us = NowUs();
+
+    const size_t count = exec->nodes.size();
+    exec->successors.resize(count);
+    exec->remaining = std::make_unique<std::atomic<uint32_t>[]>(count);
+    exec->ran.assign(count, 0);
+    exec->ok.assign(count, 0);
+    exec->duration_us.assign(count, 0);
+
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < count; ++i) {
+        index.emplace(exec->nodes[i].name, i);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t deps = 0;
+        for (const auto& dep : exec->nodes[i].deps) {
+            auto it = index.find(dep);
+            if (it == index.end()) {
+                // Виконаний раніше або відсутній - не чекаємо
+                continue;
+            }
+            exec->successors[it->second].push_back(i);
+            ++deps;
+        }
+        exec->remaining[i].store(deps, std::memory_order_relaxed);
+    }
+
+    if (count == 0) {
+        running_ = std::move(exec);
+        return;
+    }
+
+    size_t workers = max_parallel;
+    if (workers == 0) {
+        workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, kMaxInitWorkers);
+    }
+    exec->workers = std::min(workers, count);
+    exec->pool = std::make_unique<util::ThreadPool>(exec->workers);
+
+    running_ = std::move(exec);
+    for (size_t i = 0; i < count; ++i) {
+        if (running_->remaining[i].load(std::memory_order_relaxed) == 0) {
+            Schedule(*running_, i);
+        }
+    }
+}
+
+void InitGraph::Schedule(Execution& exec, size_t index) {
+    Execution* e = &exec;
+    exec.pool->enqueue(util::TaskLane::Interactive, [this, e, index] {
+        const auto& node = e->nodes[index];
+        const uint64_t start = NowUs();
+        const bool ok = node.fn ? node.fn() : true;
+        e->duration_us[index] = NowUs() - start;
+        e->ok[index] = ok;
+        e->ran[index] = 1;
+
+        // Невдача не зупиняє залежних - вони самі вирішують, чи працювати без неї
+        for (size_t next : e->successors[index]) {
+            if (e->remaining[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Schedule(*e, next);
+            }
+        }
+    });
+}
+
+bool InitGraph::Wait() {
+    std::unique_ptr<Execution> exec;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        exec = std::move(running_);
+    }
+
+    if (!exec) {
+        return true;
+    }
+
+    if (exec->pool) {
+        exec->pool->wait();
+        exec->pool.reset();
+    }
+
+    bool success = true;
+    for (size_t i = 0; i < exec->nodes.size(); ++i) {
+        const auto& node = exec->nodes[i];
+        if (!exec->ran[i]) {
+            LOGE("[%s] %s: not started (dependency cycle)", name_.c_str(), node.name.c_str());
+            success = success && !node.critical;
+        } else if (!exec->ok[i]) {
+            LOGW("[%s] %s: failed after %.1f ms", name_.c_str(), node.name.c_str(),
+                 exec->duration_us[i] / 1000.0);
+            success = success && !node.critical;
+        } else {
+            LOGI("[%s] %s: %.1f ms", name_.c_str(), node.name.c_str(),
+                 exec->duration_us[i] / 1000.0);
+        }
+    }
+
+    if (!exec->nodes.empty()) {
+        LOGI("[%s] %zu subsystems in %.1f ms on %zu workers", name_.c_str(),
+             exec->nodes.size(), (NowUs() - exec->start_us) / 1000.0, exec->workers);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < exec->nodes.size(); ++i) {
+        if (exec->ran[i]) {
+            completed_.insert(exec->nodes[i].name);
+        }
+    }
+    return success;
+}
+
+bool InitGraph::HasPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !pending_.empty();
+}
+
+bool InitGraph::IsCompleted(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completed_.count(name) != 0;
+}
+
+void InitGraph::Clear() {
+    Wait();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+    completed_.clear();
+}
+
+} // namespace rpcsx::init
@@ -0,0 +1,96 @@
+/**
+ * Subsystem Init Graph
+ *
+ * Ініціалізація підсистем як граф залежностей замість послідовного ланцюжка:
+ * вузли без невиконаних залежностей стартують паралельно на тимчасовому
+ * util::ThreadPool, завершений вузол запускає наступників.
+ *
+ * Особливості:
+ * - Вузли додаються до Run()/Start() і можуть замінюватись (те саме ім'я)
+ * - Залежність від вузла, якого немає в графі, вважається виконаною
+ * - Виконані вузли запам'ятовуються: наступний Run() бачить їх як залежності
+ * - Невдача вузла не зупиняє залежних (як і колишній послідовний ланцюжок)
+ * - Цикли не зависають - такі вузли позначаються як невдалі
+ */
+
+#ifndef RPCSX_INIT_GRAPH_H
+#define RPCSX_INIT_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace rpcsx::util {
+class ThreadPool;
+}
+
+namespace rpcsx::init {
+
+using InitFn = std::function<bool()>;
+
+class InitGraph {
+public:
+    explicit InitGraph(const char* name);
+    ~InitGraph();
+
+    InitGraph(const InitGraph&) = delete;
+    InitGraph& operator=(const InitGraph&) = delete;
+
+    /**
+     * critical - невдача вузла робить результат Run()/Wait() false.
+     * Вузол з тим самим ім'ям, що ще не запускався, замінюється
+     */
+    void Add(std::string name, std::vector<std::string> deps, InitFn fn,
+             bool critical = true);
+
+    /**
+     * Запуск усіх доданих вузлів; max_parallel = 0 - за кількістю ядер (до 4).
+     * Викликаючий потік вільний до Wait()
+     */
+    void Start(size_t max_parallel = 0);
+
+    /**
+     * Чекає завершення Start(); true якщо всі critical вузли успішні
+     */
+    bool Wait();
+
+    bool Run(size_t max_parallel = 0) {
+        Start(max_parallel);
+        return Wait();
+    }
+
+    bool HasPending() const;
+    bool IsCompleted(const std::string& name) const;
+
+    /**
+     * Забуває і невиконані, і виконані вузли (після shutdown підсистем)
+     */
+    void Clear();
+
+private:
+    struct Node {
+        std::string name;
+        std::vector<std::string> deps;
+        InitFn fn;
+        bool critical;
+    };
+
+    struct Execution;
+
+    void Schedule(Execution& exec, size_t index);
+
+    std::string name_;
+    mutable std::mutex mutex_;
+    std::vector<Node> pending_;
+    std::unordered_set<std::string> completed_;
+    std::unique_ptr<Execution> running_;
+};
+
+} // namespace rpcsx::init
+
+#endif // RPCSX_INIT_GRAPH_H
@@ -8,6 +8,8 @@
 #include <sstream>
 #include <cstring>
 #include <algorithm>
+#include <array>
+#include <string_view>
 
 #define LOG_TAG "RPCSX-LibraryEmulation"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -100,7 +102,6 @@ static const BuiltinLibrary BUILTIN_LIBS[] = {
 // =============================================================================
 
 struct BuiltinFunction {
-    const char* library;
     uint32_t nid;
     const char* name;
     ImplStatus status;
@@ -108,64 +109,180 @@ struct BuiltinFunction {
     int32_t stub_return;
 };
 
-static const BuiltinFunction BUILTIN_FUNCS[] = {
-    // libsysutil
-    {libs::LIBSYSUTIL, nid::cellSysutilCheckCallback, "cellSysutilCheckCallback", ImplStatus::HLE, true, 0},
-    {libs::LIBSYSUTIL, nid::cellSysutilRegisterCallback, "cellSysutilRegisterCallback", ImplStatus::HLE, true, 0},
-    {libs::LIBSYSUTIL, nid::cellSysutilUnregisterCallback, "cellSysutilUnregisterCallback", ImplStatus::HLE, false, 0},
-    {libs::LIBSYSUTIL, nid::cellSysutilGetSystemParamInt, "cellSysutilGetSystemParamInt", ImplStatus::HLE, true, 0},
-    {libs::LIBSYSUTIL, nid::cellSysutilGetSystemParamString, "cellSysutilGetSystemParamString", ImplStatus::HLE, false, 0},
-    
-    // libsysutil_savedata
-    {libs::LIBSYSUTIL_SAVEDATA, nid::cellSaveDataListSave2, "cellSaveDataListSave2", ImplStatus::PARTIAL, true, 0},
-    {libs::LIBSYSUTIL_SAVEDATA, nid::cellSaveDataListLoad2, "cellSaveDataListLoad2", ImplStatus::PARTIAL, true, 0},
-    {libs::LIBSYSUTIL_SAVEDATA, nid::cellSaveDataAutoSave2, "cellSaveDataAutoSave2", ImplStatus::PARTIAL, false, 0},
-    {libs::LIBSYSUTIL_SAVEDATA, nid::cellSaveDataAutoLoad2, "cellSaveDataAutoLoad2", ImplStatus::PARTIAL, false, 0},
-    
-    // libgcm_sys
-    {libs::LIBGCM_SYS, nid::cellGcmInit, "cellGcmInit", ImplStatus::HLE, true, 0},
-    {libs::LIBGCM_SYS, nid::cellGcmSetFlipMode, "cellGcmSetFlipMode", ImplStatus::HLE, false, 0},
-    {libs::LIBGCM_SYS, nid::cellGcmGetConfiguration, "cellGcmGetConfiguration", ImplStatus::HLE, true, 0},
-    {libs::LIBGCM_SYS, nid::cellGcmAddressToOffset, "cellGcmAddressToOffset", ImplStatus::HLE, true, 0},
-    
-    // libaudio
-    {libs::LIBAUDIO, nid::cellAudioInit, "cellAudioInit", ImplStatus::HLE, true, 0},
-    {libs::LIBAUDIO, nid::cellAudioQuit, "cellAudioQuit", ImplStatus::HLE, false, 0},
-    {libs::LIBAUDIO, nid::cellAudioPortOpen, "cellAudioPortOpen", ImplStatus::HLE, true, 0},
-    {libs::LIBAUDIO, nid::cellAudioPortStart, "cellAudioPortStart", ImplStatus::HLE, false, 0},
-    
-    // libnet
-    {libs::LIBNETCTL, nid::cellNetCtlInit, "cellNetCtlInit", ImplStatus::HLE, false, 0},
-    {libs::LIBNETCTL, nid::cellNetCtlTerm, "cellNetCtlTerm", ImplStatus::HLE, false, 0},
-    {libs::LIBNETCTL, nid::cellNetCtlGetState, "cellNetCtlGetState", ImplStatus::HLE, false, 0},
-    {libs::LIBNETCTL, nid::cellNetCtlGetInfo, "cellNetCtlGetInfo", ImplStatus::STUB, false, 0},
-    
-    // libtrophy
-    {libs::LIBTROPHY, nid::cellTrophyInit, "cellTrophyInit", ImplStatus::HLE, false, 0},
-    {libs::LIBTROPHY, nid::cellTrophyTerm, "cellTrophyTerm", ImplStatus::HLE, false, 0},
-    {libs::LIBTROPHY, nid::cellTrophyRegisterContext, "cellTrophyRegisterContext", ImplStatus::HLE, false, 0},
-    {libs::LIBTROPHY, nid::cellTrophyUnlockTrophy, "cellTrophyUnlockTrophy", ImplStatus::HLE, false, 0},
-    
-    {nullptr, 0, nullptr, ImplStatus::NOT_IMPLEMENTED, false, 0}
+// Таблиці експортів сортуються за NID під час компіляції - пошук бінарний,
+// а при старті нічого не будується
+template <size_t N>
+constexpr std::array<BuiltinFunction, N> SortByNid(std::array<BuiltinFunction, N> funcs) {
+    for (size_t i = 1; i < N; ++i) {
+        for (size_t j = i; j > 0 && funcs[j].nid < funcs[j - 1].nid; --j) {
+            const BuiltinFunction tmp = funcs[j];
+            funcs[j] = funcs[j - 1];
+            funcs[j - 1] = tmp;
+        }
+    }
+    return funcs;
+}
+
+template <size_t... Ns>
+constexpr auto MergeByNid(const std::array<BuiltinFunction, Ns>&... tables) {
+    std::array<BuiltinFunction, (Ns + ...)> all{};
+    size_t i = 0;
+    ([&] {
+        for (const auto& func : tables) {
+            all[i++] = func;
+        }
+    }(), ...);
+    return SortByNid(all);
+}
+
+template <size_t N>
+constexpr bool HasUniqueNids(const std::array<BuiltinFunction, N>& funcs) {
+    for (size_t i = 1; i < N; ++i) {
+        if (funcs[i].nid == funcs[i - 1].nid) return false;
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr uint32_t CountImplemented(const std::array<BuiltinFunction, N>& funcs) {
+    uint32_t count = 0;
+    for (const auto& func : funcs) {
+        if (func.status != ImplStatus::NOT_IMPLEMENTED && func.status != ImplStatus::STUB) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// libsysutil
+static constexpr auto SYSUTIL_FUNCS = SortByNid(std::to_array<BuiltinFunction>({
+    {nid::cellSysutilCheckCallback, "cellSysutilCheckCallback", ImplStatus::HLE, true, 0},
+    {nid::cellSysutilRegisterCallback, "cellSysutilRegisterCallback", ImplStatus::HLE, true, 0},
+    {nid::cellSysutilUnregisterCallback, "cellSysutilUnregisterCallback", ImplStatus::HLE, false, 0},
+    {nid::cellSysutilGetSystemParamInt, "cellSysutilGetSystemParamInt", ImplStatus::HLE, true, 0},
+    {nid::cellSysutilGetSystemParamString, "cellSysutilGetSystemParamString", ImplStatus::HLE, false, 0},
+}));
+
+// libsysutil_savedata
+static constexpr auto SAVEDATA_FUNCS = SortByNid(std::to_array<BuiltinFunction>({
+    {nid::cellSaveDataListSave2, "cellSaveDataListSave2", ImplStatus::PARTIAL, true, 0},
+    {nid::cellSaveDataListLoad2, "cellSaveDataListLoad2", ImplStatus::PARTIAL, true, 0},
+    {nid::cellSaveDataAutoSave2, "cellSaveDataAutoSave2", ImplStatus::PARTIAL, false, 0},
+    {nid::cellSaveDataAutoLoad2, "cellSaveDataAutoLoad2", ImplStatus::PARTIAL, false, 0},
+}));
+
+// libgcm_sys
+static constexpr auto GCM_FUNCS = SortByNid(std::to_array<BuiltinFunction>({
+    {nid::cellGcmInit, "cellGcmInit", ImplStatus::HLE, true, 0},
+    {nid::cellGcmSetFlipMode, "cellGcmSetFlipMode", ImplStatus::HLE, false, 0},
+    {nid::cellGcmGetConfiguration, "cellGcmGetConfiguration", ImplStatus::HLE, true, 0},
+    {nid::cellGcmAddressToOffset, "cellGcmAddressToOffset", ImplStatus::HLE, true, 0},
+}));
+
+// libaudio
+static constexpr auto AUDIO_FUNCS = SortByNid(std::to_array<BuiltinFunction>({
+    {nid::cellAudioInit, "cellAudioInit", ImplStatus::HLE, true, 0},
+    {nid::cellAudioQuit, "cellAudioQuit", ImplStatus::HLE, false, 0},
+    {nid::cellAudioPortOpen, "cellAudioPortOpen", ImplStatus::HLE, true, 0},
+    {nid::cellAudioPortStart, "cellAudioPortStart", ImplStatus::HLE, false, 0},
+}));
+
+// libnetctl
+static constexpr auto NETCTL_FUNCS = SortByNid(std::to_array<BuiltinFunction>({
+    {nid::cellNetCtlInit, "cellNetCtlInit", ImplStatus::HLE, false, 0},
+    {nid::cellNetCtlTerm, "cellNetCtlTerm", ImplStatus::HLE, false, 0},
+    {nid::cellNetCtlGetState, "cellNetCtlGetState", ImplStatus::HLE, false, 0},
+    {nid::cellNetCtlGetInfo, "cellNetCtlGetInfo", ImplStatus::STUB, false, 0},
+}));
+
+// libtrophy
+static constexpr auto TROPHY_FUNCS = SortByNid(std::to_array<BuiltinFunction>({
+    {nid::cellTrophyInit, "cellTrophyInit", ImplStatus::HLE, false, 0},
+    {nid::cellTrophyTerm, "cellTrophyTerm", ImplStatus::HLE, false, 0},
+    {nid::cellTrophyRegisterContext, "cellTrophyRegisterContext", ImplStatus::HLE, false, 0},
+    {nid::cellTrophyUnlockTrophy, "cellTrophyUnlockTrophy", ImplStatus::HLE, false, 0},
+}));
+
+// Усі відомі NID для GetFunctionNameByNID
+static constexpr auto ALL_FUNCS = MergeByNid(SYSUTIL_FUNCS, SAVEDATA_FUNCS, GCM_FUNCS,
+                                             AUDIO_FUNCS, NETCTL_FUNCS, TROPHY_FUNCS);
+
+static_assert(HasUniqueNids(SYSUTIL_FUNCS) && HasUniqueNids(SAVEDATA_FUNCS) &&
+              HasUniqueNids(GCM_FUNCS) && HasUniqueNids(AUDIO_FUNCS) &&
+              HasUniqueNids(NETCTL_FUNCS) && HasUniqueNids(TROPHY_FUNCS),
+              "Duplicate NID in a library export table");
+
+struct BuiltinExportTable {
+    const char* library;
+    const BuiltinFunction* funcs;
+    uint32_t count;
+    uint32_t implemented;
+};
+
+template <size_t N>
+constexpr BuiltinExportTable MakeExportTable(const char* library,
+                                             const std::array<BuiltinFunction, N>& funcs) {
+    return {library, funcs.data(), static_cast<uint32_t>(N), CountImplemented(funcs)};
+}
+
+static constexpr BuiltinExportTable BUILTIN_EXPORTS[] = {
+    MakeExportTable(libs::LIBSYSUTIL, SYSUTIL_FUNCS),
+    MakeExportTable(libs::LIBSYSUTIL_SAVEDATA, SAVEDATA_FUNCS),
+    MakeExportTable(libs::LIBGCM_SYS, GCM_FUNCS),
+    MakeExportTable(libs::LIBAUDIO, AUDIO_FUNCS),
+    MakeExportTable(libs::LIBNETCTL, NETCTL_FUNCS),
+    MakeExportTable(libs::LIBTROPHY, TROPHY_FUNCS),
 };
 
+static const BuiltinExportTable* FindExportTable(std::string_view library) {
+    for (const auto& table : BUILTIN_EXPORTS) {
+        if (library == table.library) return &table;
+    }
+    return nullptr;
+}
+
+static const BuiltinFunction* FindByNid(const BuiltinFunction* funcs, size_t count, uint32_t nid) {
+    const BuiltinFunction* end = funcs + count;
+    const BuiltinFunction* it = std::lower_bound(funcs, end, nid,
+        [](const BuiltinFunction& func, uint32_t value) { return func.nid < value; });
+    return it != end && it->nid == nid ? it : nullptr;
+}
+
+static FunctionExport MakeFunctionExport(const BuiltinFunction& func, uint64_t call_count) {
+    FunctionExport exp;
+    exp.name = func.name;
+    exp.nid = func.nid;
+    exp.status = func.status;
+    exp.is_critical = func.critical;
+    exp.call_count = call_count;
+    exp.stub_behavior = "return " + std::to_string(func.stub_return);
+    return exp;
+}
+
 // =============================================================================
 // NID Name Database
 // =============================================================================
 
+// Лише імена, зареєстровані через RegisterNIDName; вбудовані - в ALL_FUNCS
 static std::unordered_map<uint32_t, std::string> g_nid_names;
 
 // =============================================================================
 // Internal System
 // =============================================================================
 
+// Бібліотека, прив'язана при першому імпорті
+struct BoundLibrary {
+    const BuiltinExportTable* exports;      // nullptr - вбудованих експортів немає
+    std::vector<uint64_t> call_counts;      // Паралельно exports->funcs
+};
+
 class LibraryEmulationSystem {
 public:
     LibraryEmulationConfig config;
     LibraryStats stats = {};
     
     std::unordered_map<std::string, LibraryInfo> library_db;
-    std::unordered_map<std::string, std::unordered_map<uint32_t, FunctionExport>> function_db;
+    std::unordered_map<std::string, BoundLibrary> bound_libraries;
     std::unordered_map<std::string, std::unordered_map<uint32_t, FunctionHandler>> hle_handlers;
     std::unordered_map<std::string, std::vector<GameLibraryOverride>> game_overrides;
     std::unordered_map<uint32_t, uint64_t> missing_function_counts;
@@ -178,14 +295,9 @@ public:
         config = cfg;
         stats = {};
         
-        // Завантажуємо базу бібліотек
+        // Завантажуємо базу бібліотек; експорти прив'язуються при першому імпорті
         LoadLibraryDatabase();
-        
-        // Завантажуємо базу функцій
-        LoadFunctionDatabase();
-        
-        // Реєструємо NID імена
-        RegisterNIDNames();
+        bound_libraries.clear();
         
         g_library_emulation_active.store(true);
         g_library_calls.store(0);
@@ -204,13 +316,14 @@ public:
     void Shutdown() {
         g_library_emulation_active.store(false);
         
-        LOGI("Library Emulation shutdown. Total calls: %llu",
-             (unsigned long long)g_library_calls.load());
+        LOGI("Library Emulation shutdown. Total calls: %llu, bound libraries: %zu",
+             (unsigned long long)g_library_calls.load(), bound_libraries.size());
     }
     
     void LoadLibraryDatabase() {
         for (int i = 0; BUILTIN_LIBS[i].name != nullptr; ++i) {
             const auto& lib = BUILTIN_LIBS[i];
+            const BuiltinExportTable* exports = FindExportTable(lib.name);
             
             LibraryInfo info;
             info.name = lib.name;
@@ -219,8 +332,8 @@ public:
             info.status = lib.status;
             info.description = lib.description;
             info.version = 0x00010000;  // 1.0
-            info.export_count = 0;
-            info.implemented_count = 0;
+            info.export_count = exports ? exports->count : 0;
+            info.implemented_count = exports ? exports->implemented : 0;
             
             library_db[lib.name] = info;
         }
@@ -228,94 +341,73 @@ public:
         stats.total_libraries = library_db.size();
     }
     
-    void LoadFunctionDatabase() {
-        for (int i = 0; BUILTIN_FUNCS[i].library != nullptr; ++i) {
-            const auto& func = BUILTIN_FUNCS[i];
-            
-            FunctionExport exp;
-            exp.name = func.name;
-            exp.nid = func.nid;
-            exp.status = func.status;
-            exp.is_critical = func.critical;
-            exp.call_count = 0;
-            exp.stub_behavior = "return " + std::to_string(func.stub_return);
-            
-            function_db[func.library][func.nid] = exp;
-            
-            // Оновлюємо лічильники бібліотеки
-            auto it = library_db.find(func.library);
-            if (it != library_db.end()) {
-                it->second.export_count++;
-                if (func.status != ImplStatus::NOT_IMPLEMENTED && func.status != ImplStatus::STUB) {
-                    it->second.implemented_count++;
-                }
+    // Викликати під mutex
+    BoundLibrary& BindLibraryLocked(const std::string& name) {
+        auto [it, inserted] = bound_libraries.try_emplace(name);
+        if (inserted) {
+            it->second.exports = FindExportTable(name);
+            if (it->second.exports) {
+                it->second.call_counts.resize(it->second.exports->count);
             }
         }
-    }
-    
-    void RegisterNIDNames() {
-        for (int i = 0; BUILTIN_FUNCS[i].name != nullptr; ++i) {
-            g_nid_names[BUILTIN_FUNCS[i].nid] = BUILTIN_FUNCS[i].name;
-        }
+        return it->second;
     }
     
     bool CallFunction(const char* library, uint32_t nid, uint64_t* args, uint64_t* result) {
         g_library_calls++;
-        stats.total_function_calls++;
         
         std::string lib_name = library ? library : "";
         
+        std::unique_lock<std::mutex> lock(mutex);
+        stats.total_function_calls++;
+        
         // Шукаємо HLE обробник
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            
-            auto lit = hle_handlers.find(lib_name);
-            if (lit != hle_handlers.end()) {
-                auto fit = lit->second.find(nid);
-                if (fit != lit->second.end()) {
-                    FunctionContext ctx;
-                    ctx.nid = nid;
-                    memcpy(ctx.args, args, sizeof(ctx.args));
-                    ctx.result = result;
-                    ctx.library_name = library;
-                    ctx.function_name = GetFunctionNameByNID(nid);
-                    
-                    *result = fit->second(ctx);
-                    return true;
-                }
+        auto hit = hle_handlers.find(lib_name);
+        if (hit != hle_handlers.end()) {
+            auto fit = hit->second.find(nid);
+            if (fit != hit->second.end()) {
+                FunctionContext ctx;
+                ctx.nid = nid;
+                memcpy(ctx.args, args, sizeof(ctx.args));
+                ctx.result = result;
+                ctx.library_name = library;
+                ctx.function_name = GetFunctionNameByNID(nid);
+                
+                *result = fit->second(ctx);
+                return true;
             }
         }
         
-        // Шукаємо в базі
-        auto lit = function_db.find(lib_name);
-        if (lit != function_db.end()) {
-            auto fit = lit->second.find(nid);
-            if (fit != lit->second.end()) {
-                fit->second.call_count++;
+        // Шукаємо в таблиці експортів бібліотеки
+        BoundLibrary& bound = BindLibraryLocked(lib_name);
+        const BuiltinFunction* func = bound.exports
+            ? FindByNid(bound.exports->funcs, bound.exports->count, nid) : nullptr;
+        
+        if (func) {
+            bound.call_counts[func - bound.exports->funcs]++;
+            
+            if (func->status == ImplStatus::NOT_IMPLEMENTED) {
+                stats.missing_function_calls++;
+                missing_function_counts[nid]++;
                 
-                if (fit->second.status == ImplStatus::NOT_IMPLEMENTED) {
-                    stats.missing_function_calls++;
-                    missing_function_counts[nid]++;
-                    
-                    if (config.log_missing_functions) {
-                        LOGW("Missing function: %s::%s (NID 0x%08X)",
-                             library, fit->second.name.c_str(), nid);
-                    }
-                    
-                    if (fit->second.is_critical && config.crash_on_critical_missing) {
-                        LOGE("CRITICAL: Missing critical function %s::%s",
-                             library, fit->second.name.c_str());
-                        abort();
-                    }
+                if (config.log_missing_functions) {
+                    LOGW("Missing function: %s::%s (NID 0x%08X)",
+                         library, func->name, nid);
                 }
                 
-                // Stub - повертаємо успіх
-                if (config.auto_stub_missing || fit->second.status == ImplStatus::STUB) {
-                    stats.stubbed_function_calls++;
-                    *result = 0;  // CELL_OK
-                    return true;
+                if (func->critical && config.crash_on_critical_missing) {
+                    LOGE("CRITICAL: Missing critical function %s::%s",
+                         library, func->name);
+                    abort();
                 }
             }
+            
+            // Stub - повертаємо успіх
+            if (config.auto_stub_missing || func->status == ImplStatus::STUB) {
+                stats.stubbed_function_calls++;
+                *result = 0;  // CELL_OK
+                return true;
+            }
         }
         
         // Невідома функція
@@ -362,7 +454,12 @@ uint32_t LoadLibrary(const char* name) {
         return 0;
     }
     
-    g_system.stats.loaded_libraries++;
+    {
+        // Перший імпорт модуля прив'язує його таблицю експортів
+        std::lock_guard<std::mutex> lock(g_system.mutex);
+        g_system.BindLibraryLocked(it->first);
+        g_system.stats.loaded_libraries++;
+    }
     LOGI("Loaded library: %s (%s)", name, it->second.description.c_str());
     
     return g_system.next_handle++;
@@ -437,30 +534,41 @@ bool CallLibraryFunction(const char* library_name, uint32_t nid,
 bool GetFunctionInfo(const char* library_name, uint32_t nid, FunctionExport* info) {
     if (!library_name || !info) return false;
     
-    auto lit = g_system.function_db.find(library_name);
-    if (lit == g_system.function_db.end()) return false;
+    const BuiltinExportTable* exports = FindExportTable(library_name);
+    if (!exports) return false;
     
-    auto fit = lit->second.find(nid);
-    if (fit == lit->second.end()) return false;
+    const BuiltinFunction* func = FindByNid(exports->funcs, exports->count, nid);
+    if (!func) return false;
     
-    *info = fit->second;
+    // Лічильник є лише у прив'язаної бібліотеки
+    uint64_t call_count = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_system.mutex);
+        auto it = g_system.bound_libraries.find(library_name);
+        if (it != g_system.bound_libraries.end()) {
+            call_count = it->second.call_counts[func - exports->funcs];
+        }
+    }
+    
+    *info = MakeFunctionExport(*func, call_count);
     return true;
 }
 
 size_t GetLibraryFunctions(const char* library_name, FunctionExport* buffer, size_t buffer_size) {
     if (!library_name) return 0;
     
-    auto it = g_system.function_db.find(library_name);
-    if (it == g_system.function_db.end()) return 0;
+    const BuiltinExportTable* exports = FindExportTable(library_name);
+    if (!exports) return 0;
     
-    size_t count = 0;
-    for (const auto& [nid, func] : it->second) {
-        if (count < buffer_size) {
-            buffer[count] = func;
-        }
-        count++;
+    std::lock_guard<std::mutex> lock(g_system.mutex);
+    auto it = g_system.bound_libraries.find(library_name);
+    const BoundLibrary* bound = it != g_system.bound_libraries.end() ? &it->second : nullptr;
+    
+    // Експорти віддаються в порядку NID
+    for (size_t i = 0; i < exports->count && i < buffer_size; ++i) {
+        buffer[i] = MakeFunctionExport(exports->funcs[i], bound ? bound->call_counts[i] : 0);
     }
-    return count;
+    return exports->count;
 }
 
 bool SetGameLibraryOverride(const char* title_id, const char* library_name,
@@ -587,6 +695,10 @@ uint32_t CalculateNID(const char* function_name) {
 }
 
 const char* GetFunctionNameByNID(uint32_t nid) {
+    if (const BuiltinFunction* func = FindByNid(ALL_FUNCS.data(), ALL_FUNCS.size(), nid)) {
+        return func->name;
+    }
+    
     auto it = g_nid_names.find(nid);
     if (it != g_nid_names.end()) {
         return it->second.c_str();
@@ -170,7 +170,7 @@ void ShutdownLibraryEmulation();
 bool IsLibraryEmulationActive();
 
 /**
- * Завантажити бібліотеку
+ * Завантажити бібліотеку; перший імпорт прив'язує її експорти
  * @param name Назва бібліотеки (без .sprx)
  * @return Handle бібліотеки або 0 при помилці
  */
@@ -226,7 +226,7 @@ bool CallLibraryFunction(const char* library_name, uint32_t nid,
 bool GetFunctionInfo(const char* library_name, uint32_t nid, FunctionExport* info);
 
 /**
- * Отримати список функцій бібліотеки
+ * Отримати список функцій бібліотеки (у порядку NID)
  */
 size_t GetLibraryFunctions(const char* library_name, FunctionExport* buffer, size_t buffer_size);
 
@@ -0,0 +1,238 @@
+/**
+ * Memory Accounting and Budgets Implementation
+ */
+
+#include "memory_budget.h"
+#include <android/log.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <vector>
+
+#define LOG_TAG "RPCSX-Memory"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace rpcsx::memory {
+
+// ComponentCallbacks2
+static constexpr int kTrimRunningModerate = 5;
+static constexpr int kTrimRunningLow = 10;
+static constexpr int kTrimRunningCritical = 15;
+static constexpr int kTrimUiHidden = 20;
+static constexpr int kTrimBackground = 40;
+static constexpr int kTrimModerate = 60;
+
+static constexpr uint64_t kBudgetCheckIntervalUs = 1000000;
+
+struct Consumer {
+    std::string name;
+    int priority;
+    UsageCallback usage;
+    TrimCallback trim;
+};
+
+static std::mutex g_registry_mutex;
+static std::vector<Consumer> g_consumers;   // За зростанням priority
+
+// Trim може тривати довго (RSX чекає межі кадру); паралельні trim не мають сенсу
+static std::mutex g_trim_mutex;
+
+static std::atomic<uint64_t> g_budget_bytes{0};
+static std::atomic<uint64_t> g_last_budget_check_us{0};
+static std::atomic<uint64_t> g_trims_total{0};
+static std::atomic<uint64_t> g_bytes_trimmed_total{0};
+
+static uint64_t MonotonicMicros() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000 + static_cast<uint64_t>(ts.tv_nsec) / 1000;
+}
+
+static const char* TrimLevelName(TrimLevel level) {
+    switch (level) {
+        case TrimLevel::None: return "none";
+        case TrimLevel::Moderate: return "moderate";
+        case TrimLevel::Low: return "low";
+        case TrimLevel::Critical: return "critical";
+    }
+    return "unknown";
+}
+
+// Підсистеми з priority нижче порогу стискаються на цьому рівні
+static int PriorityLimit(TrimLevel level) {
+    switch (level) {
+        case TrimLevel::None: return kPriorityShaderL1;
+        case TrimLevel::Moderate: return kPriorityTextureStreaming;
+        case TrimLevel::Low: return kPriorityPipelineCache;
+        case TrimLevel::Critical: return kPriorityReportOnly;
+    }
+    return kPriorityShaderL1;
+}
+
+// Callbacks викликаються без lock реєстру: вони ходять у чужі mutex
+static std::vector<Consumer> SnapshotConsumers() {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    return g_consumers;
+}
+
+// =============================================================================
+// API
+// =============================================================================
+
+void RegisterMemoryConsumer(const char* name, int priority, UsageCallback usage,
+                            TrimCallback trim) {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+
+    g_consumers.erase(std::remove_if(g_consumers.begin(), g_consumers.end(),
+                                     [&](const Consumer& c) { return c.name == name; }),
+                      g_consumers.end());
+
+    Consumer consumer{name, priority, std::move(usage), std::move(trim)};
+    auto pos = std::upper_bound(g_consumers.begin(), g_consumers.end(), priority,
+                                [](int p, const Consumer& c) { return p < c.priority; });
+    g_consumers.insert(pos, std::move(consumer));
+}
+
+void UnregisterMemoryConsumer(const char* name) {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    g_consumers.erase(std::remove_if(g_consumers.begin(), g_consumers.end(),
+                                     [&](const Consumer& c) { return c.name == name; }),
+                      g_consumers.end());
+}
+
+TrimLevel TrimLevelFromAndroid(int android_level) {
+    // Процес у LRU списку кешованих - наступним можуть вбити саме його
+    if (android_level >= kTrimModerate) return TrimLevel::Critical;
+    if (android_level >= kTrimBackground) return TrimLevel::Low;
+    if (android_level >= kTrimUiHidden) return TrimLevel::Moderate;
+    if (android_level >= kTrimRunningCritical) return TrimLevel::Critical;
+    if (android_level >= kTrimRunningLow) return TrimLevel::Low;
+    if (android_level >= kTrimRunningModerate) return TrimLevel::Moderate;
+    return TrimLevel::None;
+}
+
+uint64_t TrimMemory(TrimLevel level) {
+    if (level == TrimLevel::None) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> trim_lock(g_trim_mutex);
+
+    const int limit = PriorityLimit(level);
+    uint64_t freed_total = 0;
+
+    for (const Consumer& consumer : SnapshotConsumers()) {
+        if (consumer.priority >= limit) {
+            break;
+        }
+        if (!consumer.trim) {
+            continue;
+        }
+
+        const uint64_t freed = consumer.trim(level);
+        freed_total += freed;
+        if (freed) {
+            LOGI("Trim %s: %s released %llu KB", TrimLevelName(level), consumer.name.c_str(),
+                 static_cast<unsigned long long>(freed / 1024));
+        }
+    }
+
+    g_trims_total.fetch_add(1, std::memory_order_relaxed);
+    g_bytes_trimmed_total.fetch_add(freed_total, std::memory_order_relaxed);
+    return freed_total;
+}
+
+uint64_t OnTrimMemory(int android_level) {
+    const TrimLevel level = TrimLevelFromAndroid(android_level);
+    LOGI("onTrimMemory(%d) -> %s, tracked %llu MB", android_level, TrimLevelName(level),
+         static_cast<unsigned long long>(GetTotalMemoryUsage() / (1024 * 1024)));
+    return TrimMemory(level);
+}
+
+void SetMemoryBudget(uint64_t bytes) {
+    g_budget_bytes.store(bytes, std::memory_order_relaxed);
+    LOGI("Memory budget: %llu MB", static_cast<unsigned long long>(bytes / (1024 * 1024)));
+}
+
+uint64_t GetMemoryBudget() {
+    return g_budget_bytes.load(std::memory_order_relaxed);
+}
+
+void CheckMemoryBudget() {
+    const uint64_t budget = g_budget_bytes.load(std::memory_order_relaxed);
+    if (!budget) {
+        return;
+    }
+
+    const uint64_t now_us = MonotonicMicros();
+    uint64_t last_us = g_last_budget_check_us.load(std::memory_order_relaxed);
+    if (now_us - last_us < kBudgetCheckIntervalUs ||
+        !g_last_budget_check_us.compare_exchange_strong(last_us, now_us, std::memory_order_relaxed)) {
+        return;
+    }
+
+    const uint64_t used = GetTotalMemoryUsage();
+    if (used <= budget) {
+        return;
+    }
+
+    LOGW("Tracked memory %llu MB exceeds budget %llu MB",
+         static_cast<unsigned long long>(used / (1024 * 1024)),
+         static_cast<unsigned long long>(budget / (1024 * 1024)));
+
+    // Спершу дешеве; якщо облік і далі вище за бюджет - наступний рівень
+    if (used > budget + TrimMemory(TrimLevel::Moderate)) {
+        TrimMemory(TrimLevel::Low);
+    }
+}
+
+uint64_t GetTotalMemoryUsage() {
+    uint64_t total = 0;
+    for (const Consumer& consumer : SnapshotConsumers()) {
+        total += consumer.usage ? consumer.usage().used_bytes : 0;
+    }
+    return total;
+}
+
+std::string ExportMemoryReportJson() {
+    std::string json;
+    char buffer[256];
+
+    uint64_t total_used = 0;
+    uint64_t total_reclaimable = 0;
+
+    json += "{\"consumers\":[";
+    bool first = true;
+    for (const Consumer& consumer : SnapshotConsumers()) {
+        const MemoryUsage usage = consumer.usage ? consumer.usage() : MemoryUsage{};
+        total_used += usage.used_bytes;
+        total_reclaimable += usage.reclaimable_bytes;
+
+        snprintf(buffer, sizeof(buffer),
+                 "%s{\"name\":\"%s\",\"priority\":%d,\"used_bytes\":%llu,"
+                 "\"reclaimable_bytes\":%llu,\"trimmable\":%s}",
+                 first ? "" : ",", consumer.name.c_str(), consumer.priority,
+                 static_cast<unsigned long long>(usage.used_bytes),
+                 static_cast<unsigned long long>(usage.reclaimable_bytes),
+                 consumer.trim ? "true" : "false");
+        json += buffer;
+        first = false;
+    }
+
+    snprintf(buffer, sizeof(buffer),
+             "],\"used_bytes\":%llu,\"reclaimable_bytes\":%llu,\"budget_bytes\":%llu,"
+             "\"trims\":%llu,\"bytes_trimmed\":%llu}",
+             static_cast<unsigned long long>(total_used),
+             static_cast<unsigned long long>(total_reclaimable),
+             static_cast<unsigned long long>(g_budget_bytes.load(std::memory_order_relaxed)),
+             static_cast<unsigned long long>(g_trims_total.load(std::memory_order_relaxed)),
+             static_cast<unsigned long long>(g_bytes_trimmed_total.load(std::memory_order_relaxed)));
+    json += buffer;
+
+    return json;
+}
+
+} // namespace rpcsx::memory
@@ -0,0 +1,102 @@
+/**
+ * Memory Accounting and Budgets
+ *
+ * Єдиний реєстр пам'яті кешів (shader L1, pipeline cache, texture streaming,
+ * JIT code cache, RSX texture/surface cache, гостьова пам'ять). Кожна
+ * підсистема повідомляє зайняті та звільнювані байти; на onTrimMemory
+ * (ComponentCallbacks2) кеші стискаються за пріоритетом - спершу ті, що
+ * найдешевше відновити, - поки Android не вбив процес без попередження.
+ *
+ * Особливості:
+ * - Рівні ComponentCallbacks2 -> TrimLevel, для кожного рівня свій поріг пріоритету
+ * - Опціональний бюджет: перевищення на межі кадру обробляється як Moderate
+ * - JSON звіт для логів і діагностики
+ */
+
+#ifndef RPCSX_MEMORY_BUDGET_H
+#define RPCSX_MEMORY_BUDGET_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace rpcsx::memory {
+
+/**
+ * Наскільки агресивно звільняти пам'ять
+ */
+enum class TrimLevel : uint8_t {
+    None = 0,
+    Moderate = 1,                     // Лише те, що відновлюється без видимих наслідків
+    Low = 2,                          // Кеші, що швидко наповнюються знову
+    Critical = 3,                     // Усе звільнюване, ціною підвантажень і компіляцій
+};
+
+/**
+ * Пріоритети: менше значення - стискається раніше
+ */
+constexpr int kPriorityShaderL1 = 0;          // Дублює mmap архів
+constexpr int kPriorityTextureStreaming = 10;
+constexpr int kPriorityRsxCaches = 20;        // Повторні завантаження текстур, старі render targets
+constexpr int kPriorityPipelineCache = 30;    // Повторна компіляція pipelines - статтер
+constexpr int kPriorityReportOnly = 100;      // JIT код і гостьова пам'ять - лише облік
+
+struct MemoryUsage {
+    uint64_t used_bytes;
+    uint64_t reclaimable_bytes;       // Скільки реально може звільнити trim
+};
+
+using UsageCallback = std::function<MemoryUsage()>;
+
+/**
+ * Повертає звільнені байти (оцінку, якщо звільнення відкладене)
+ */
+using TrimCallback = std::function<uint64_t(TrimLevel level)>;
+
+/**
+ * Реєстрація підсистеми; повторна реєстрація з тим самим ім'ям замінює запис.
+ * trim може бути порожнім - тоді підсистема лише в обліку
+ */
+void RegisterMemoryConsumer(const char* name, int priority, UsageCallback usage,
+                            TrimCallback trim = {});
+void UnregisterMemoryConsumer(const char* name);
+
+/**
+ * Рівень ComponentCallbacks2.TRIM_MEMORY_* -> TrimLevel
+ */
+TrimLevel TrimLevelFromAndroid(int android_level);
+
+/**
+ * Стиснення кешів за пріоритетом; повертає звільнені байти
+ */
+uint64_t TrimMemory(TrimLevel level);
+
+/**
+ * onTrimMemory / onLowMemory з Java
+ */
+uint64_t OnTrimMemory(int android_level);
+
+/**
+ * Бюджет у байтах (0 - без бюджету)
+ */
+void SetMemoryBudget(uint64_t bytes);
+uint64_t GetMemoryBudget();
+
+/**
+ * Викликати на межі кадру: раз на секунду звіряє облік з бюджетом
+ */
+void CheckMemoryBudget();
+
+/**
+ * Сума used_bytes усіх підсистем
+ */
+uint64_t GetTotalMemoryUsage();
+
+/**
+ * Облік по підсистемах у JSON
+ */
+std::string ExportMemoryReportJson();
+
+} // namespace rpcsx::memory
+
+#endif // RPCSX_MEMORY_BUDGET_H
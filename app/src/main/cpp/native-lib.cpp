@@ -37,9 +37,12 @@
 #include "plt_hook.h"
 #include "drs_engine.h"
 #include "texture_streaming.h"
+#include "frame_telemetry.h"
+#include "memory_budget.h"
 #include "sve2_optimizations.h"
 #include "pipeline_cache.h"
 #include "game_profiles.h"
+#include "profile_autotune.h"
 #include "patch_installer.h"
 #include "syscall_stubs.h"
 #include "firmware_spoof.h"
@@ -51,6 +54,11 @@
 #include "gpu/shader_compiler.h"
 #include "gpu/vulkan_renderer.h"
 #include "nce_core/llvm_optimized_ppu_spu.h"
+#include "nce_core/game_mode_android.h"
+#include "nce_v8/nce_v8.h"
+#include "nbtc_engine/nbtc_engine.h"
+#include "nbtc_engine/compile_predictor.h"
+#include "init_graph.h"
 
 #define LOG_TAG "RPCSX-Native"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -93,6 +101,48 @@ struct RPCSXApi {
   bool (*settingsSet)(std::string_view path, std::string_view valueString);
   std::string (*getVersion)();
   void *(*setCustomDriver)(void *driverHandle);
+  // Optional: older librpcsx builds do not export it
+  void (*getPipelineDrawStats)(std::uint64_t *interpreterDraws,
+                               std::uint64_t *interpreterSwaps,
+                               std::uint64_t *skippedDraws);
+  void (*getPipelineProbeStats)(std::uint64_t *driverCacheHits,
+                                std::uint64_t *driverCacheMisses);
+  void (*getSpuIdleStats)(std::uint64_t *channelWaits,
+                          std::uint64_t *getllarSpins,
+                          std::uint64_t *getllarSleeps);
+  void (*getLockContentionStats)(std::uint64_t *contended,
+                                 std::uint64_t *spinResolved,
+                                 std::uint64_t *parked, std::uint64_t *spinNs);
+  void (*getFrameCounters)(std::uint64_t *ppuCpuNs, std::uint64_t *spuCpuNs,
+                           std::uint64_t *rsxCpuNs,
+                           std::uint64_t *pipelineMisses,
+                           std::uint64_t *textureUploads);
+  void (*setSamplerFeedbackCallback)(void (*callback)(const void *entries,
+                                                      std::size_t count));
+  void (*setFrameTimingCallback)(void (*callback)(float frameTimeMs,
+                                                  float gpuTimeMs));
+  void (*setGpuCostCallback)(void (*callback)(const void *entries,
+                                              std::size_t count));
+  void (*setPpuAnalysisCallback)(void (*callback)(const char *titleId,
+                                                  const void *blocks,
+                                                  std::size_t count));
+  void (*setRenderScale)(float scale);
+  void (*setShadingRate)(int level);
+  void (*getMemoryUsage)(std::uint64_t *guestBytes, std::uint64_t *deviceBytes,
+                         std::uint64_t *textureBytes);
+  void (*requestMemoryRelief)(int severity);
+  bool (*getHwCounters)(int threadClass, std::uint64_t *values, std::size_t count);
+  std::size_t (*getHotThreadIds)(std::int32_t *tids, std::size_t capacity);
+  void (*setZcullSpeculation)(bool allowed);
+  void (*setFrameGeneration)(bool enabled);
+  void (*setStaticHleFilter)(bool (*filter)(const char *titleId,
+                                            const char *function));
+  void (*setPpuHostFpcrFilter)(bool (*filter)(const char *titleId));
+  void (*setCodeInvalidationCallback)(void (*callback)(std::uint32_t addr,
+                                                       std::uint32_t size));
+  void (*setReplayBenchmark)(int iterations, std::string_view outputPath);
+  bool (*bootRsxCapture)(std::string_view path);
+  bool (*setContentRootFd)(std::string_view hostRoot, int fd);
 };
 
 struct RPCSXLibrary : RPCSXApi {
@@ -259,6 +309,29 @@ struct RPCSXLibrary : RPCSXApi {
     result.settingsSet = reinterpret_cast<decltype(settingsSet)>(dlsym(handle, "_rpcsx_settingsSet"));
     result.getVersion = reinterpret_cast<decltype(getVersion)>(dlsym(handle, "_rpcsx_getVersion"));
     result.setCustomDriver = reinterpret_cast<decltype(setCustomDriver)>(dlsym(handle, "_rpcsx_setCustomDriver"));
+    result.getPipelineDrawStats = reinterpret_cast<decltype(getPipelineDrawStats)>(dlsym(handle, "_rpcsx_getPipelineDrawStats"));
+    result.getPipelineProbeStats = reinterpret_cast<decltype(getPipelineProbeStats)>(dlsym(handle, "_rpcsx_getPipelineProbeStats"));
+    result.getSpuIdleStats = reinterpret_cast<decltype(getSpuIdleStats)>(dlsym(handle, "_rpcsx_getSpuIdleStats"));
+    result.getLockContentionStats = reinterpret_cast<decltype(getLockContentionStats)>(dlsym(handle, "_rpcsx_getLockContentionStats"));
+    result.getFrameCounters = reinterpret_cast<decltype(getFrameCounters)>(dlsym(handle, "_rpcsx_getFrameCounters"));
+    result.setSamplerFeedbackCallback = reinterpret_cast<decltype(setSamplerFeedbackCallback)>(dlsym(handle, "_rpcsx_setSamplerFeedbackCallback"));
+    result.setFrameTimingCallback = reinterpret_cast<decltype(setFrameTimingCallback)>(dlsym(handle, "_rpcsx_setFrameTimingCallback"));
+    result.setGpuCostCallback = reinterpret_cast<decltype(setGpuCostCallback)>(dlsym(handle, "_rpcsx_setGpuCostCallback"));
+    result.setPpuAnalysisCallback = reinterpret_cast<decltype(setPpuAnalysisCallback)>(dlsym(handle, "_rpcsx_setPpuAnalysisCallback"));
+    result.setRenderScale = reinterpret_cast<decltype(setRenderScale)>(dlsym(handle, "_rpcsx_setRenderScale"));
+    result.setShadingRate = reinterpret_cast<decltype(setShadingRate)>(dlsym(handle, "_rpcsx_setShadingRate"));
+    result.getMemoryUsage = reinterpret_cast<decltype(getMemoryUsage)>(dlsym(handle, "_rpcsx_getMemoryUsage"));
+    result.requestMemoryRelief = reinterpret_cast<decltype(requestMemoryRelief)>(dlsym(handle, "_rpcsx_requestMemoryRelief"));
+    result.getHwCounters = reinterpret_cast<decltype(getHwCounters)>(dlsym(handle, "_rpcsx_getHwCounters"));
+    result.getHotThreadIds = reinterpret_cast<decltype(getHotThreadIds)>(dlsym(handle, "_rpcsx_getHotThreadIds"));
+    result.setZcullSpeculation = reinterpret_cast<decltype(setZcullSpeculation)>(dlsym(handle, "_rpcsx_setZcullSpeculation"));
+    result.setFrameGeneration = reinterpret_cast<decltype(setFrameGeneration)>(dlsym(handle, "_rpcsx_setFrameGeneration"));
+    result.setStaticHleFilter = reinterpret_cast<decltype(setStaticHleFilter)>(dlsym(handle, "_rpcsx_setStaticHleFilter"));
+    result.setPpuHostFpcrFilter = reinterpret_cast<decltype(setPpuHostFpcrFilter)>(dlsym(handle, "_rpcsx_setPpuHostFpcrFilter"));
+    result.setCodeInvalidationCallback = reinterpret_cast<decltype(setCodeInvalidationCallback)>(dlsym(handle, "_rpcsx_setCodeInvalidationCallback"));
+    result.setReplayBenchmark = reinterpret_cast<decltype(setReplayBenchmark)>(dlsym(handle, "_rpcsx_setReplayBenchmark"));
+    result.bootRsxCapture = reinterpret_cast<decltype(bootRsxCapture)>(dlsym(handle, "_rpcsx_bootRsxCapture"));
+    result.setContentRootFd = reinterpret_cast<decltype(setContentRootFd)>(dlsym(handle, "_rpcsx_setContentRootFd"));
     // clang-format on
 
     return result;
@@ -267,6 +340,187 @@ struct RPCSXLibrary : RPCSXApi {
 
 static RPCSXLibrary rpcsxLib;
 
+// Підсистеми, не потрібні UI (JIT, кеші, fastmem, планувальник): піднімаються
+// паралельно при першому boot, а не на старті застосунку
+static rpcsx::init::InitGraph g_bootInit("boot");
+
+static bool RunBootInit() {
+  if (!g_bootInit.HasPending()) {
+    return true;
+  }
+  LOGI("Initializing deferred subsystems before boot...");
+  return g_bootInit.Run();
+}
+
+// RSX сам подає кадри в DRS (setFrameTimingCallback)
+static std::atomic<bool> g_drs_present_feed{false};
+
+// ADPF: гарячі потоки (PPU/SPU/RSX) і тривалість кадру проти цілі DRS; thermal
+// прогноз заздалегідь знижує GPU бюджет DRS. RSX потік, межа present
+static void UpdatePerformanceHint(float frameTimeMs) {
+  static constexpr uint32_t kThreadRefreshFrames = 120;
+  static constexpr std::size_t kMaxHintThreads = 64;
+  static constexpr int kThermalForecastSeconds = 10;
+  static uint32_t frameIndex = 0;
+
+  const uint32_t targetFps = std::max<uint32_t>(rpcsx::drs::GetTargetFPS(), 1);
+  const int64_t targetNs = 1000000000ll / targetFps;
+
+  // Потоки з'являються і зникають (SPU групи, PPU потоки гри)
+  if (frameIndex++ % kThreadRefreshFrames == 0) {
+    if (auto getTids = rpcsxLib.getHotThreadIds) {
+      std::int32_t tids[kMaxHintThreads];
+      rpcsx::android::UpdatePerformanceHintThreads(tids, getTids(tids, kMaxHintThreads), targetNs);
+    }
+  }
+
+  rpcsx::android::ReportFrameWorkDuration(static_cast<int64_t>(frameTimeMs * 1000000.0f), targetNs);
+
+  // Кешується на секунду всередині
+  rpcsx::android::GetThermalHeadroom(kThermalForecastSeconds);
+  rpcsx::drs::SetThermalBudget(rpcsx::android::GetThermalWorkBudget());
+}
+
+// Розбивка GPU часу по проходах коштує timestamp запитів, тож лише разом з телеметрією
+static void UpdateGpuCostSink() {
+  auto setCosts = rpcsxLib.setGpuCostCallback;
+  if (!setCosts) {
+    return;
+  }
+
+  if (rpcsx::telemetry::IsFrameTelemetryEnabled()) {
+    setCosts([](const void *entries, std::size_t count) {
+      rpcsx::telemetry::RecordGpuCosts(
+          static_cast<const rpcsx::telemetry::GpuCostEntry *>(entries), count);
+    });
+  } else {
+    setCosts(nullptr);
+  }
+}
+
+// IPC і промахи кешу PPU/SPU за останню секунду (utils::hw_counter у librpcsx)
+static bool GetHwCounterRates(rpcsx::telemetry::HwCounterRates *rates) {
+  auto getCounters = rpcsxLib.getHwCounters;
+  if (!getCounters) {
+    return false;
+  }
+
+  // cycles, instructions, l1d misses, l2 misses, branch misses
+  std::uint64_t ppu[5]{}, spu[5]{};
+  if (!getCounters(0, ppu, std::size(ppu)) || !getCounters(1, spu, std::size(spu))) {
+    return false;
+  }
+
+  auto ratio = [](std::uint64_t value, std::uint64_t base, float scale) {
+    return base ? static_cast<float>(value) * scale / static_cast<float>(base) : 0.0f;
+  };
+  rates->ppu_ipc = ratio(ppu[1], ppu[0], 1.0f);
+  rates->spu_ipc = ratio(spu[1], spu[0], 1.0f);
+  rates->spu_l1d_mpki = ratio(spu[2], spu[1], 1000.0f);
+  rates->spu_l2_mpki = ratio(spu[3], spu[1], 1000.0f);
+  return true;
+}
+
+// Облік пам'яті всіх кешів; librpcsx може бути ще не завантажена
+static void RegisterMemoryConsumers() {
+  namespace memory = rpcsx::memory;
+
+  memory::RegisterMemoryConsumer("shader_cache_l1", memory::kPriorityShaderL1,
+      [] {
+        size_t used = 0, reclaimable = 0;
+        rpcsx::shaders::GetShaderCacheL1Usage(&used, &reclaimable);
+        return memory::MemoryUsage{used, reclaimable};
+      },
+      [](memory::TrimLevel) -> uint64_t {
+        // Решта L1 дублює mmap архів, тож звільняємо все, що в ньому є
+        return rpcsx::shaders::TrimShaderCacheL1(0);
+      });
+
+  memory::RegisterMemoryConsumer("texture_streaming", memory::kPriorityTextureStreaming,
+      [] {
+        memory::MemoryUsage usage{};
+        rpcsx::textures::GetCacheUsage(&usage.used_bytes, &usage.reclaimable_bytes);
+        return usage;
+      },
+      [](memory::TrimLevel level) -> uint64_t {
+        memory::MemoryUsage usage{};
+        rpcsx::textures::GetCacheUsage(&usage.used_bytes, &usage.reclaimable_bytes);
+        return rpcsx::textures::TrimCache(level == memory::TrimLevel::Critical ? 0 : usage.used_bytes / 2);
+      });
+
+  memory::RegisterMemoryConsumer("rsx_caches", memory::kPriorityRsxCaches,
+      [] {
+        memory::MemoryUsage usage{};
+        if (auto getUsage = rpcsxLib.getMemoryUsage) {
+          std::uint64_t guest = 0, device = 0, textures = 0;
+          getUsage(&guest, &device, &textures);
+          usage.used_bytes = device;
+          usage.reclaimable_bytes = textures;
+        }
+        return usage;
+      },
+      [](memory::TrimLevel level) -> uint64_t {
+        // RSX звільняє на межі кадру, скільки - стане видно в наступному обліку
+        if (auto requestRelief = rpcsxLib.requestMemoryRelief) {
+          requestRelief(level == memory::TrimLevel::Critical ? 2 /* severe */ : 1 /* moderate */);
+        }
+        return 0;
+      });
+
+  memory::RegisterMemoryConsumer("pipeline_cache", memory::kPriorityPipelineCache,
+      [] {
+        memory::MemoryUsage usage{};
+        rpcsx::pipeline::GetMemoryUsage(&usage.used_bytes, &usage.reclaimable_bytes);
+        return usage;
+      },
+      [](memory::TrimLevel) -> uint64_t {
+        const uint32_t keep = rpcsx::pipeline::GetConfig().max_cached_pipelines / 4;
+        return static_cast<uint64_t>(rpcsx::pipeline::TrimCache(keep)) *
+               rpcsx::pipeline::kEstimatedPipelineBytes;
+      });
+
+  // Код JIT може виконуватись просто зараз, гостьова пам'ять - пам'ять гри: лише облік
+  memory::RegisterMemoryConsumer("jit_code_cache", memory::kPriorityReportOnly, [] {
+    size_t cacheUsage = 0;
+    rpcsx::nce::GetJITStats(&cacheUsage, nullptr, nullptr);
+    return memory::MemoryUsage{cacheUsage, 0};
+  });
+
+  memory::RegisterMemoryConsumer("guest_memory", memory::kPriorityReportOnly, [] {
+    memory::MemoryUsage usage{};
+    if (auto getUsage = rpcsxLib.getMemoryUsage) {
+      std::uint64_t device = 0, textures = 0;
+      getUsage(&usage.used_bytes, &device, &textures);
+    }
+    return usage;
+  });
+}
+
+// Кандидати auto-tune через конфіг librpcsx; частина налаштувань діє лише з boot
+static void ApplyAutoTuneCandidate(const rpcsx::profiles::GameProfile &candidate,
+                                   bool stopped) {
+  auto set = rpcsxLib.settingsSet;
+  if (!set) {
+    return;
+  }
+
+  const uint32_t spursThreads =
+      candidate.hacks.limit_spu_threads ? std::clamp(candidate.hacks.max_spu_threads, 1u, 6u) : 6;
+  set("Core@@Max SPURS Threads", std::to_string(spursThreads));
+
+  if (candidate.gpu.enable_drs) {
+    rpcsx::drs::SetMaxScale(candidate.gpu.drs_max_scale);
+  }
+
+  if (stopped) {
+    static constexpr std::string_view kBlockSizes[] = {"\"Safe\"", "\"Mega\"", "\"Giga\""};
+    set("Core@@SPU Block Size", kBlockSizes[static_cast<int>(candidate.cpu.spu_block_size) % 3]);
+    set("Video@@Shader Mode", candidate.gpu.async_shader_compile
+                                  ? "\"Async with Shader Interpreter\""
+                                  : "\"Shader Recompiler\"");
+  }
+}
+
 static std::string unwrap(JNIEnv *env, jstring string) {
   auto resultBuffer = env->GetStringUTFChars(string, nullptr);
   std::string result(resultBuffer);
@@ -298,6 +552,77 @@ Java_net_rpcsx_RPCSX_openLibrary(JNIEnv *env, jobject, jstring path) {
   if (auto library = RPCSXLibrary::Open(pathStr.c_str())) {
     rpcsxLib = std::move(*library);
     g_librpcsx_path = pathStr;
+
+    // Interpreter-draw лічильники RSX у PipelineCacheStats
+    rpcsx::pipeline::SetRendererStatsProvider([](rpcsx::pipeline::PipelineCacheStats *stats) {
+      if (auto getStats = rpcsxLib.getPipelineDrawStats) {
+        getStats(&stats->interpreter_draws, &stats->interpreter_swaps, &stats->skipped_draws);
+      }
+      if (auto getProbe = rpcsxLib.getPipelineProbeStats) {
+        getProbe(&stats->driver_cache_hits, &stats->driver_cache_misses);
+      }
+    });
+
+    // Аналіз PPU під час встановлення гри -> AOT черга tier-2 компілятора
+    if (auto setAnalysis = rpcsxLib.setPpuAnalysisCallback) {
+      setAnalysis([](const char *titleId, const void *blocks, std::size_t count) {
+        nbtc::SubmitAnalysedModule(titleId ? titleId : "",
+                                   static_cast<const nbtc::AnalysedBlock *>(blocks), count);
+      });
+    }
+
+    // Texture streaming за тим, що RSX реально семплює (раз на кадр)
+    if (auto setFeedback = rpcsxLib.setSamplerFeedbackCallback) {
+      setFeedback([](const void *entries, std::size_t count) {
+        rpcsx::textures::UpdateStreaming(
+            static_cast<const rpcsx::textures::SampledTextureFeedback *>(entries), count);
+      });
+    }
+
+    // DRS: frame time + GPU час з timestamp запитів, на межі present
+    if (auto setTiming = rpcsxLib.setFrameTimingCallback) {
+      setTiming([](float frameTimeMs, float gpuTimeMs) {
+        g_drs_present_feed.store(true, std::memory_order_relaxed);
+        UpdatePerformanceHint(frameTimeMs);
+        rpcsx::drs::ReportGPUTime(gpuTimeMs);
+        rpcsx::drs::UpdateDRS(frameTimeMs);
+        rpcsx::drs::OnPresent();
+
+        // Temporal upscaler рендерить з цим масштабом (RSX фіксує його між кадрами)
+        const float scale = rpcsx::drs::IsDRSActive() ? rpcsx::drs::GetCurrentScale() : 1.0f;
+        if (auto setScale = rpcsxLib.setRenderScale) {
+          setScale(scale);
+        }
+
+        // VRS - перший важіль DRS, до зниження роздільності
+        if (auto setRate = rpcsxLib.setShadingRate) {
+          setRate(rpcsx::drs::IsDRSActive() ? static_cast<int>(rpcsx::drs::GetShadingRateLevel()) : 0);
+        }
+
+        if (rpcsx::telemetry::IsFrameTelemetryEnabled()) {
+          rpcsx::telemetry::FrameCounters totals{};
+          if (auto getCounters = rpcsxLib.getFrameCounters) {
+            getCounters(&totals.ppu_cpu_ns, &totals.spu_cpu_ns, &totals.rsx_cpu_ns,
+                        &totals.pipeline_misses, &totals.texture_uploads);
+          }
+
+          size_t blockCount = 0;
+          rpcsx::nce::GetJITStats(nullptr, &blockCount, nullptr);
+          totals.jit_compiles = blockCount;
+
+          rpcsx::telemetry::HwCounterRates hw{};
+          const bool hasHw = GetHwCounterRates(&hw);
+
+          rpcsx::telemetry::RecordFrame(frameTimeMs, gpuTimeMs, scale, totals, hasHw ? &hw : nullptr);
+        }
+
+        rpcsx::profiles::OnAutoTuneFrame(frameTimeMs);
+
+        rpcsx::memory::CheckMemoryBudget();
+      });
+    }
+
+    UpdateGpuCostSink();
     
     // Initialize PPU Interceptor for NCE JIT
     if (rpcsx::nce::IsNCEActive()) {
@@ -345,22 +670,23 @@ extern "C" JNIEXPORT jboolean JNICALL Java_net_rpcsx_RPCSX_overlayPadData(
 extern "C" JNIEXPORT jboolean JNICALL Java_net_rpcsx_RPCSX_initialize(
     JNIEnv *env, jobject, jstring rootDir, jstring user) {
     
+  // Install crash handlers early; helps with SIGSEGV/SIGBUS on some kernels/devices.
+  rpcsx::crash::InstallSignalHandlers();
+
   // --- RPCSX ARMv9 Optimization Initialization ---
-  rpcsx::nce::InitializeNCE();
-  rpcsx::scheduler::InitializeScheduler();
-  
+  // UI потрібен лише librpcsx; NCE, планувальник і shader cache чекають boot.
+  // initializeARMv9Optimizations може замінити ці вузли своїми налаштуваннями
   std::string userDir = unwrap(env, user);
   std::string shaderCacheDir = userDir + "/shader_cache";
-  rpcsx::shaders::InitializeShaderCache(shaderCacheDir.c_str());
-  
+  g_bootInit.Add("nce", {"fastmem"}, [] { return rpcsx::nce::InitializeNCE(); });
+  g_bootInit.Add("scheduler", {}, [] { return rpcsx::scheduler::InitializeScheduler(); });
+  g_bootInit.Add("shader_cache", {}, [shaderCacheDir] {
+    return rpcsx::shaders::InitializeShaderCache(shaderCacheDir.c_str());
+  });
+
   // Initialize PS3 RSX Graphics Engine with worker threads on Cortex-X4
   // Use 3 worker threads for graphics command processing (leave 1 core for game logic)
   // rpcsx::vulkan::InitializeRSXEngine(nullptr, nullptr, 3);
-  
-  LOGI("RPCSX Optimized Modules Initialized: NCE, Scheduler, ShaderCache, RSX Graphics Engine");
-
-  // Install crash handlers early; helps with SIGSEGV/SIGBUS on some kernels/devices.
-  rpcsx::crash::InstallSignalHandlers();
   // -----------------------------------------------
 
   return rpcsxLib.initialize(unwrap(env, rootDir), unwrap(env, user));
@@ -402,7 +728,29 @@ extern "C" JNIEXPORT void JNICALL Java_net_rpcsx_RPCSX_shutdown(JNIEnv *env,
     LOGI("Shutting down PPU Interceptor...");
     rpcsx::ppu::ShutdownInterceptor();
   }
-  
+
+  // Телеметрія: як часто SPU цикли очікування засинали замість спіну
+  if (auto getIdleStats = rpcsxLib.getSpuIdleStats) {
+    std::uint64_t channelWaits = 0, getllarSpins = 0, getllarSleeps = 0;
+    getIdleStats(&channelWaits, &getllarSpins, &getllarSleeps);
+    LOGI("SPU idle: channel waits=%llu, GETLLAR spins=%llu, GETLLAR sleeps=%llu",
+         static_cast<unsigned long long>(channelWaits),
+         static_cast<unsigned long long>(getllarSpins),
+         static_cast<unsigned long long>(getllarSleeps));
+  }
+
+  if (auto getContention = rpcsxLib.getLockContentionStats) {
+    std::uint64_t contended = 0, spinResolved = 0, parked = 0, spinNs = 0;
+    getContention(&contended, &spinResolved, &parked, &spinNs);
+    LOGI("Lock contention: contended=%llu, resolved by spin=%llu, parked=%llu, spin time=%llu us",
+         static_cast<unsigned long long>(contended),
+         static_cast<unsigned long long>(spinResolved),
+         static_cast<unsigned long long>(parked),
+         static_cast<unsigned long long>(spinNs / 1000));
+  }
+
+  nbtc::StopCompilePredictor();
+  nbtc::SetEmulationActive(false);
   return rpcsxLib.shutdown();
 }
 
@@ -421,6 +769,36 @@ extern "C" JNIEXPORT jint JNICALL Java_net_rpcsx_RPCSX_boot(JNIEnv *env,
   // Since we don't have the Title ID easily before boot, we'll try to retrieve it after 
   // or infer from the path structure if possible.
   
+  // Static HLE patching runs while the game loads, so per-title kill switches
+  // are queried from inside boot
+  if (auto setFilter = rpcsxLib.setStaticHleFilter) {
+    setFilter(&rpcsx::profiles::IsHLEFastPathAllowed);
+  }
+
+  // NJ режим через FPCR обирається до компіляції PPU модулів
+  if (auto setFilter = rpcsxLib.setPpuHostFpcrFilter) {
+    setFilter(&rpcsx::profiles::IsPPUHostFPCREnabled);
+  }
+
+  // Unload модулів і патчі коду скидають лише блоки змінених сторінок
+  if (auto setCallback = rpcsxLib.setCodeInvalidationCallback) {
+    setCallback([](std::uint32_t addr, std::uint32_t size) {
+      rpcsx::nce::v8::InvalidateCode(addr, size);
+      rpcsx::ppu::InvalidateRange(addr, size);
+    });
+  }
+
+  // Відкладені на boot підсистеми (JIT, fastmem, кеші)
+  if (!RunBootInit()) {
+    LOGW("Some deferred subsystems failed to initialize - check logs");
+  }
+
+  // Кандидат auto-tune, що чекав перезапуску сегмента
+  rpcsx::profiles::OnAutoTuneBoot();
+
+  // AOT компіляція не конкурує з грою за CPU
+  nbtc::SetEmulationActive(true);
+
   int result = rpcsxLib.boot(path);
 
   if (!guard.ok()) {
@@ -434,7 +812,20 @@ extern "C" JNIEXPORT jint JNICALL Java_net_rpcsx_RPCSX_boot(JNIEnv *env,
       if (!titlId.empty()) {
           if (rpcsx::profiles::IsProfileSystemActive()) {
             rpcsx::profiles::ApplyProfileForGame(titlId.c_str());
+
+            const auto *profile = rpcsx::profiles::GetCurrentProfile();
+            if (auto setSpeculation = rpcsxLib.setZcullSpeculation) {
+              setSpeculation(!profile || !profile->hacks.disable_zcull_speculation);
+            }
+            // Генерація кадрів лише для профілів, що її дозволяють
+            rpcsx::fsr::SetFrameGeneration(profile && profile->gpu.frame_generation);
+            if (auto setFrameGeneration = rpcsxLib.setFrameGeneration) {
+              setFrameGeneration(rpcsx::fsr::IsFrameGenerationEnabled());
+            }
+            rpcsx::nce::SetVMXFastMath(profile && profile->hacks.vmx_fast_math);
           }
+          // Таблиця syscalls з overrides цієї гри
+          rpcsx::syscalls::SetSyscallTitle(titlId.c_str());
           // Universal game patches (Demon's Souls, Saw, inFamous, etc.)
           rpcsx::patches::InitializeGamePatches(titlId.c_str());
           // Frostbite engine games (BF4, PvZ:GW, etc.)
@@ -442,12 +833,101 @@ extern "C" JNIEXPORT jint JNICALL Java_net_rpcsx_RPCSX_boot(JNIEnv *env,
           // Real Steel (robot boxing game)
           rpcsx::realsteel::InitializeRealSteelHacks(titlId.c_str());
           LOGI("Applied game-specific patches for ID: %s", titlId.c_str());
+
+          // Передбачення наступних tier-1 / pipeline misses цієї гри
+          nbtc::StartCompilePredictor(titlId);
       }
   }
 
   return result;
 }
 
+/**
+ * RSX Capture Benchmark - відтворює .rrc захоплення iterations разів без гри
+ * і пише JSON звіт (CPU час запису, GPU час, pipeline misses, texture uploads)
+ */
+extern "C" JNIEXPORT jboolean JNICALL Java_net_rpcsx_RPCSX_runCaptureBenchmark(
+    JNIEnv *env, jobject, jstring jcapturePath, jint iterations,
+    jstring joutputPath) {
+  if (!rpcsxLib.setReplayBenchmark || !rpcsxLib.bootRsxCapture) {
+    LOGE("Capture benchmark is not supported by this librpcsx build");
+    return false;
+  }
+
+  rpcsxLib.setReplayBenchmark(iterations, unwrap(env, joutputPath));
+  const bool booted = rpcsxLib.bootRsxCapture(unwrap(env, jcapturePath));
+
+  if (!booted) {
+    // Не залишати режим бенчмарку для наступного захоплення
+    rpcsxLib.setReplayBenchmark(0, {});
+    LOGE("Failed to boot RSX capture for benchmark");
+  }
+
+  return booted;
+}
+
+/**
+ * Циклічне відтворення .rrc захоплення (сегмент для auto-tune профілю)
+ */
+extern "C" JNIEXPORT jboolean JNICALL Java_net_rpcsx_RPCSX_bootRsxCapture(
+    JNIEnv *env, jobject, jstring jcapturePath) {
+  if (!rpcsxLib.bootRsxCapture) {
+    LOGE("RSX capture replay is not supported by this librpcsx build");
+    return false;
+  }
+
+  rpcsx::profiles::OnAutoTuneBoot();
+  return rpcsxLib.bootRsxCapture(unwrap(env, jcapturePath));
+}
+
+/**
+ * Auto-tune профілю гри: source 0 - відрізок гри, 1 - RSX захоплення.
+ * Далі фронтенд робить boot сегмента і перезавантажує його щоразу, коли
+ * getProfileAutoTuneState() == 3 (AwaitingRestart); у стані 4 (Finished)
+ * найкращий профіль уже записаний через UpdateProfile
+ */
+extern "C" JNIEXPORT jboolean JNICALL Java_net_rpcsx_RPCSX_startProfileAutoTune(
+    JNIEnv *env, jobject, jstring jtitleId, jint source, jint warmupFrames,
+    jint measureFrames) {
+  rpcsx::profiles::AutoTuneConfig config;
+  config.source = source == 1 ? rpcsx::profiles::AutoTuneSource::RsxCapture
+                              : rpcsx::profiles::AutoTuneSource::LiveSegment;
+  config.warmup_frames = static_cast<uint32_t>(std::max(warmupFrames, 0));
+  config.measure_frames = static_cast<uint32_t>(std::max(measureFrames, 0));
+  return rpcsx::profiles::StartAutoTune(unwrap(env, jtitleId).c_str(), config);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_net_rpcsx_RPCSX_cancelProfileAutoTune(JNIEnv *env, jobject) {
+  rpcsx::profiles::CancelAutoTune();
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_net_rpcsx_RPCSX_getProfileAutoTuneState(JNIEnv *env, jobject) {
+  return static_cast<jint>(rpcsx::profiles::GetAutoTuneState());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_net_rpcsx_RPCSX_getProfileAutoTuneReportJson(JNIEnv *env, jobject) {
+  return wrap(env, rpcsx::profiles::ExportAutoTuneReportJson());
+}
+
+/**
+ * Каталог з іграми, відкритий один раз через SAF або MANAGE_EXTERNAL_STORAGE.
+ * Нативна сторона робить dup(fd) і відкриває вміст гри через openat відносно
+ * нього, без повторного обходу шляху через FUSE. fd < 0 скидає корінь.
+ * Діє для ігор, змонтованих після виклику
+ */
+extern "C" JNIEXPORT jboolean JNICALL Java_net_rpcsx_RPCSX_setContentRootFd(
+    JNIEnv *env, jobject, jstring jhostRoot, jint fd) {
+  if (!rpcsxLib.setContentRootFd) {
+    LOGW("Content root fd is not supported by this librpcsx build");
+    return false;
+  }
+
+  return rpcsxLib.setContentRootFd(unwrap(env, jhostRoot), fd);
+}
+
 extern "C" JNIEXPORT jint JNICALL Java_net_rpcsx_RPCSX_getState(JNIEnv *env,
                                                                 jobject) {
   return rpcsxLib.getState();
@@ -455,6 +935,8 @@ extern "C" JNIEXPORT jint JNICALL Java_net_rpcsx_RPCSX_getState(JNIEnv *env,
 
 extern "C" JNIEXPORT void JNICALL Java_net_rpcsx_RPCSX_kill(JNIEnv *env,
                                                             jobject) {
+  nbtc::StopCompilePredictor();
+  nbtc::SetEmulationActive(false);
   return rpcsxLib.kill();
 }
 
@@ -601,171 +1083,243 @@ Java_net_rpcsx_RPCSX_initializeARMv9Optimizations(JNIEnv *env, jobject,
   auto titleId = unwrap(env, jtitleId);
   auto buildId = ResolveBuildId(unwrap(env, jbuildId));
   
-  bool success = true;
-  
-  // 1. Ініціалізація NCE (Native Code Execution)
-  LOGI("Initializing NCE Engine...");
-  if (!rpcsx::nce::InitializeNCE()) {
-    LOGE("NCE initialization failed");
-    success = false;
-  }
-  
-  // 2. Ініціалізація Fastmem
-  LOGI("Initializing Fastmem (Direct Memory Mapping)...");
-  if (!rpcsx::memory::InitializeFastmem()) {
-    LOGE("Fastmem initialization failed");
-    success = false;
-  }
-  
-  // 3. Ініціалізація Shader Cache
-  LOGI("Initializing 3-tier Shader Cache with Zstd...");
-  if (!rpcsx::shaders::InitializeShaderCache(cacheDir.c_str(), buildId.c_str())) {
-    LOGE("Shader cache initialization failed");
-    success = false;
-  }
-  
-  // 4. Ініціалізація Thread Scheduler
-  LOGI("Initializing Aggressive Thread Scheduler...");
-  if (!rpcsx::scheduler::InitializeScheduler()) {
-    LOGE("Scheduler initialization failed");
-    success = false;
-  }
-
-  // 4.0.1. Ініціалізація LLVM Optimized PPU JIT (критично для продуктивності!)
-  LOGI("Initializing LLVM Optimized PPU (PowerPC64 -> ARM64 NEON)...");
-  if (ppu_llvm_opt_init() != 0) {
-    LOGW("LLVM PPU JIT initialization failed - falling back to interpreter");
-  } else {
-    LOGI("LLVM PPU JIT enabled - maximum performance mode");
-  }
-
-  // 4.0.2. Ініціалізація LLVM Optimized SPU JIT
-  LOGI("Initializing LLVM Optimized SPU (Cell SPU -> ARM64 NEON)...");
-  if (spu_llvm_opt_init() != 0) {
-    LOGW("LLVM SPU JIT initialization failed - falling back to interpreter");
-  } else {
-    LOGI("LLVM SPU JIT enabled - vectorized NEON execution");
-  }
-
-  // 4.1. Ініціалізація SVE2/NEON оптимізацій (не критично)
-  LOGI("Initializing SVE2/NEON optimizations...");
-  if (!rpcsx::sve2::InitializeSVE2()) {
-    LOGW("SVE2 initialization failed or not supported");
-  }
-
-  // 4.2. Ініціалізація Texture Streaming Cache (не критично)
-  LOGI("Initializing Texture Streaming Cache...");
-  rpcsx::textures::StreamingConfig tex_config;
-  tex_config.max_cache_size_mb = 512;
-  tex_config.async_pool_size = 3;
-  tex_config.mode = rpcsx::textures::StreamingMode::BALANCED;
-  if (!rpcsx::textures::InitializeTextureStreaming(tex_config)) {
-    LOGW("Texture streaming initialization failed");
-  }
-
-  // 4.3. Ініціалізація Vulkan Pipeline Cache (не критично)
-  LOGI("Initializing Vulkan Pipeline Cache...");
-  rpcsx::pipeline::PipelineCacheConfig pipeline_config;
-  pipeline_config.cache_path = cacheDir + "/pipeline_cache.bin";
-  pipeline_config.persist_to_disk = true;
-  pipeline_config.enable_precompilation = true;
-  if (!rpcsx::pipeline::InitializePipelineCache(nullptr, nullptr, pipeline_config)) {
-    LOGW("Pipeline cache initialization failed");
-  }
-
-  // 4.4. Ініціалізація Game Profiles (не критично)
-  LOGI("Initializing Game Performance Profiles...");
-  std::string profiles_dir = cacheDir + "/game_profiles";
-  if (!rpcsx::profiles::InitializeProfiles(profiles_dir.c_str())) {
-    LOGW("Game profiles initialization failed");
-  }
+  // Граф ініціалізації: незалежні підсистеми стартують паралельно.
+  // Те, що потрібне лише грі, відкладається в g_bootInit до першого boot,
+  // тож UI стає інтерактивним, не чекаючи JIT, кешів і fastmem
+  rpcsx::init::InitGraph init("startup");
+
+  // 1. NCE (Native Code Execution) і JIT - лише для гри. Після fastmem:
+  // JIT вмикає fast memory, лише якщо вікно fastmem вже зарезервоване
+  g_bootInit.Add("nce", {"fastmem"}, [] {
+    LOGI("Initializing NCE Engine...");
+    if (!rpcsx::nce::InitializeNCE()) {
+      LOGE("NCE initialization failed");
+      return false;
+    }
+    return true;
+  });
+
+  // 1.1. LLVM Optimized PPU JIT (PowerPC64 -> ARM64 NEON)
+  g_bootInit.Add("llvm_ppu", {}, [] {
+    if (ppu_llvm_opt_init() != 0) {
+      LOGW("LLVM PPU JIT initialization failed - falling back to interpreter");
+    } else {
+      LOGI("LLVM PPU JIT enabled - maximum performance mode");
+    }
+    return true;
+  }, false);
+
+  // 1.2. LLVM Optimized SPU JIT; після PPU - ініціалізація LLVM target спільна
+  g_bootInit.Add("llvm_spu", {"llvm_ppu"}, [] {
+    if (spu_llvm_opt_init() != 0) {
+      LOGW("LLVM SPU JIT initialization failed - falling back to interpreter");
+    } else {
+      LOGI("LLVM SPU JIT enabled - vectorized NEON execution");
+    }
+    return true;
+  }, false);
+
+  // 2. Fastmem (резервування гостьового адресного простору)
+  g_bootInit.Add("fastmem", {}, [] {
+    LOGI("Initializing Fastmem (Direct Memory Mapping)...");
+    if (!rpcsx::memory::InitializeFastmem()) {
+      LOGE("Fastmem initialization failed");
+      return false;
+    }
+    return true;
+  });
+
+  // 3. Shader Cache (читання архіву з диска)
+  g_bootInit.Add("shader_cache", {}, [cacheDir, buildId] {
+    LOGI("Initializing 3-tier Shader Cache with Zstd...");
+    if (!rpcsx::shaders::InitializeShaderCache(cacheDir.c_str(), buildId.c_str())) {
+      LOGE("Shader cache initialization failed");
+      return false;
+    }
+    return true;
+  });
+
+  // 3.1. Persistent JIT code cache (tier-2 блоки, інвалідація по build-id).
+  // Лише зберігає шлях - NCE v8 відкриє кеш при ініціалізації; AOT компіляція
+  // nbtc працює і без запущеної гри
+  std::string jit_cache_dir = cacheDir + "/jit_cache";
+  rpcsx::nce::v8::EnablePersistentCodeCache(jit_cache_dir.c_str(), titleId.c_str(), buildId.c_str());
+  nbtc::SetCacheLocation(jit_cache_dir, buildId);
+
+  // 4. Thread Scheduler (вимикає енергозбереження - лише під час гри)
+  g_bootInit.Add("scheduler", {}, [] {
+    LOGI("Initializing Aggressive Thread Scheduler...");
+    if (!rpcsx::scheduler::InitializeScheduler()) {
+      LOGE("Scheduler initialization failed");
+      return false;
+    }
+    return true;
+  });
+
+  // 4.1. SVE2/NEON оптимізації (не критично)
+  init.Add("sve2", {}, [cacheDir] {
+    LOGI("Initializing SVE2/NEON optimizations...");
+    // Вибір варіантів ядер міряється лише при першому запуску на пристрої
+    rpcsx::sve2::SVE2Config sve2_config;
+    sve2_config.dispatch_cache_path = cacheDir + "/simd_dispatch.txt";
+    if (!rpcsx::sve2::InitializeSVE2(sve2_config)) {
+      LOGW("SVE2 initialization failed or not supported");
+    }
+    return true;
+  }, false);
+
+  // 4.2. Texture Streaming Cache (не критично)
+  g_bootInit.Add("texture_streaming", {}, [] {
+    LOGI("Initializing Texture Streaming Cache...");
+    rpcsx::textures::StreamingConfig tex_config;
+    tex_config.max_cache_size_mb = 512;
+    tex_config.async_pool_size = 3;
+    tex_config.mode = rpcsx::textures::StreamingMode::BALANCED;
+    if (!rpcsx::textures::InitializeTextureStreaming(tex_config)) {
+      LOGW("Texture streaming initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
+
+  // 4.3. Vulkan Pipeline Cache (не критично, читання кешу з диска)
+  g_bootInit.Add("pipeline_cache", {}, [cacheDir] {
+    LOGI("Initializing Vulkan Pipeline Cache...");
+    rpcsx::pipeline::PipelineCacheConfig pipeline_config;
+    pipeline_config.cache_path = cacheDir + "/pipeline_cache.bin";
+    pipeline_config.persist_to_disk = true;
+    pipeline_config.enable_precompilation = true;
+    if (!rpcsx::pipeline::InitializePipelineCache(nullptr, nullptr, pipeline_config)) {
+      LOGW("Pipeline cache initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
+
+  // 4.4. Game Profiles (не критично; UI показує профілі у списку ігор)
+  init.Add("profiles", {}, [cacheDir] {
+    LOGI("Initializing Game Performance Profiles...");
+    std::string profiles_dir = cacheDir + "/game_profiles";
+    if (!rpcsx::profiles::InitializeProfiles(profiles_dir.c_str())) {
+      LOGW("Game profiles initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
+
+  // 4.5. PS3 Patch Installer (не критично)
+  init.Add("patch_installer", {}, [cacheDir] {
+    LOGI("Initializing PS3 Patch Installer...");
+    rpcsx::patches::installer::InstallerConfig patch_config;
+    patch_config.cache_dir = cacheDir + "/patches";
+    patch_config.auto_download = false;
+    patch_config.auto_apply_recommended = true;
+    if (!rpcsx::patches::installer::InitializePatchInstaller(patch_config)) {
+      LOGW("Patch installer initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
+
+  // 4.6. Syscall Stubs (не критично)
+  init.Add("syscall_stubs", {}, [] {
+    LOGI("Initializing Syscall Stub System...");
+    rpcsx::syscalls::StubConfig stub_config;
+    stub_config.enabled = true;
+    stub_config.log_unimplemented = true;
+    stub_config.auto_stub_missing = true;
+    if (!rpcsx::syscalls::InitializeSyscallStubs(stub_config)) {
+      LOGW("Syscall stubs initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
+
+  // 4.7. Firmware Spoof (не критично)
+  init.Add("firmware_spoof", {}, [] {
+    LOGI("Initializing Firmware Spoofing...");
+    rpcsx::firmware::SpoofConfig spoof_config;
+    spoof_config.enabled = true;
+    spoof_config.global_version = rpcsx::firmware::known_versions::V4_90;
+    spoof_config.enable_all_features = true;
+    if (!rpcsx::firmware::InitializeFirmwareSpoof(spoof_config)) {
+      LOGW("Firmware spoof initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
+
+  // 4.8. Library Emulation (не критично)
+  init.Add("library_emulation", {}, [] {
+    LOGI("Initializing Library Emulation Layer...");
+    rpcsx::libraries::LibraryEmulationConfig lib_config;
+    lib_config.enabled = true;
+    lib_config.log_missing_functions = true;
+    lib_config.auto_stub_missing = true;
+    if (!rpcsx::libraries::InitializeLibraryEmulation(lib_config)) {
+      LOGW("Library emulation initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
+
+  // 4.9. Save Converter (не критично)
+  init.Add("save_converter", {}, [cacheDir] {
+    LOGI("Initializing Save Converter...");
+    rpcsx::saves::SaveConverterConfig save_config;
+    save_config.enabled = true;
+    save_config.save_directory = cacheDir + "/savedata";
+    save_config.backup_directory = cacheDir + "/save_backups";
+    if (!rpcsx::saves::InitializeSaveConverter(save_config)) {
+      LOGW("Save converter initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
 
-  // 4.5. Ініціалізація PS3 Patch Installer (не критично)
-  LOGI("Initializing PS3 Patch Installer...");
-  rpcsx::patches::installer::InstallerConfig patch_config;
-  patch_config.cache_dir = cacheDir + "/patches";
-  patch_config.auto_download = false;
-  patch_config.auto_apply_recommended = true;
-  if (!rpcsx::patches::installer::InitializePatchInstaller(patch_config)) {
-    LOGW("Patch installer initialization failed");
-  }
+  // 5. Game-specific patches (Demon's Souls, Saw, inFamous, Frostbite, Real Steel) -
+  // на boot; boot ще раз застосує їх для фактичного title id
+  g_bootInit.Add("game_hacks", {}, [titleId] {
+    auto gameType = rpcsx::patches::DetectGame(titleId.c_str());
+    if (gameType != rpcsx::patches::GameType::UNKNOWN) {
+      const auto& config = rpcsx::patches::GetGameConfig(gameType);
+      LOGI("Detected game: %s - applying patches (target: %d FPS)...",
+           config.name, config.target_fps);
+      rpcsx::patches::InitializeGamePatches(titleId.c_str());
+    }
 
-  // 4.6. Ініціалізація Syscall Stubs (не критично)
-  LOGI("Initializing Syscall Stub System...");
-  rpcsx::syscalls::StubConfig stub_config;
-  stub_config.enabled = true;
-  stub_config.log_unimplemented = true;
-  stub_config.auto_stub_missing = true;
-  if (!rpcsx::syscalls::InitializeSyscallStubs(stub_config)) {
-    LOGW("Syscall stubs initialization failed");
-  }
+    if (rpcsx::frostbite::IsFrostbite3Game(titleId.c_str())) {
+      LOGI("Frostbite 3 game detected - applying engine-specific hacks...");
+      rpcsx::frostbite::InitializeFrostbiteHacks(titleId.c_str());
+    }
 
-  // 4.7. Ініціалізація Firmware Spoof (не критично)
-  LOGI("Initializing Firmware Spoofing...");
-  rpcsx::firmware::SpoofConfig spoof_config;
-  spoof_config.enabled = true;
-  spoof_config.global_version = rpcsx::firmware::known_versions::V4_90;
-  spoof_config.enable_all_features = true;
-  if (!rpcsx::firmware::InitializeFirmwareSpoof(spoof_config)) {
-    LOGW("Firmware spoof initialization failed");
-  }
+    if (rpcsx::realsteel::IsRealSteelGame(titleId.c_str())) {
+      LOGI("Real Steel detected - applying game-specific optimizations...");
+      rpcsx::realsteel::InitializeRealSteelHacks(titleId.c_str());
+    }
+    return true;
+  }, false);
+
+  // 6. FSR 3.1 (720p -> 1440p upscaling)
+  g_bootInit.Add("fsr", {}, [] {
+    LOGI("Initializing FSR 3.1 upscaler...");
+    if (!rpcsx::fsr::InitializeFSR(1280, 720, 2560, 1440,
+                                   rpcsx::fsr::FSRQuality::PERFORMANCE)) {
+      LOGE("FSR 3.1 initialization failed");
+      return false;
+    }
+    return true;
+  }, false);
 
-  // 4.8. Ініціалізація Library Emulation (не критично)
-  LOGI("Initializing Library Emulation Layer...");
-  rpcsx::libraries::LibraryEmulationConfig lib_config;
-  lib_config.enabled = true;
-  lib_config.log_missing_functions = true;
-  lib_config.auto_stub_missing = true;
-  if (!rpcsx::libraries::InitializeLibraryEmulation(lib_config)) {
-    LOGW("Library emulation initialization failed");
-  }
-
-  // 4.9. Ініціалізація Save Converter (не критично)
-  LOGI("Initializing Save Converter...");
-  rpcsx::saves::SaveConverterConfig save_config;
-  save_config.enabled = true;
-  save_config.save_directory = cacheDir + "/savedata";
-  save_config.backup_directory = cacheDir + "/save_backups";
-  if (!rpcsx::saves::InitializeSaveConverter(save_config)) {
-    LOGW("Save converter initialization failed");
-  }
-  
-  // 5. Game-specific patches (Demon's Souls, Saw, inFamous, etc.)
-  auto gameType = rpcsx::patches::DetectGame(titleId.c_str());
-  if (gameType != rpcsx::patches::GameType::UNKNOWN) {
-    const auto& config = rpcsx::patches::GetGameConfig(gameType);
-    LOGI("Detected game: %s - applying patches (target: %d FPS)...", 
-         config.name, config.target_fps);
-    rpcsx::patches::InitializeGamePatches(titleId.c_str());
-  }
-  
-  // 5.1. Ініціалізація Frostbite хаків (якщо потрібно)
-  if (rpcsx::frostbite::IsFrostbite3Game(titleId.c_str())) {
-    LOGI("Frostbite 3 game detected - applying engine-specific hacks...");
-    rpcsx::frostbite::InitializeFrostbiteHacks(titleId.c_str());
-  }
-  
-  // 5.2. Ініціалізація Real Steel хаків (якщо потрібно)
-  if (rpcsx::realsteel::IsRealSteelGame(titleId.c_str())) {
-    LOGI("Real Steel detected - applying game-specific optimizations...");
-    rpcsx::realsteel::InitializeRealSteelHacks(titleId.c_str());
-  }
-  
-  // 6. Ініціалізація FSR 3.1 (720p -> 1440p upscaling)
-  LOGI("Initializing FSR 3.1 upscaler...");
-  if (!rpcsx::fsr::InitializeFSR(1280, 720, 2560, 1440, 
-                                 rpcsx::fsr::FSRQuality::PERFORMANCE)) {
-    LOGE("FSR 3.1 initialization failed");
-    // Non-critical, продовжуємо
-  }
+  const bool success = init.Run();
 
   // Ensure handlers are installed for the optimisation path as well.
   rpcsx::crash::InstallSignalHandlers();
   
   LOGI("=======================================================");
   if (success) {
-    LOGI("All ARMv9 optimizations initialized successfully!");
-    LOGI("Expected performance: 30-60 FPS on heavy games");
+    LOGI("Startup optimizations initialized successfully!");
+    LOGI("JIT, fastmem, shader/pipeline caches and scheduler start with the first boot");
   } else {
     LOGE("Some optimizations failed - check logs");
   }
@@ -784,6 +1338,8 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /* reserved */) {
   }
 
   rpcsx::crash::InstallSignalHandlers();
+  RegisterMemoryConsumers();
+  rpcsx::profiles::SetAutoTuneApplyCallback(&ApplyAutoTuneCandidate);
 
   // Inform cutscene bridge (and other modules) about JavaVM
   rpcsx_set_jvm(vm);
@@ -797,6 +1353,9 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /* reserved */) {
 extern "C" JNIEXPORT void JNICALL
 Java_net_rpcsx_RPCSX_shutdownARMv9Optimizations(JNIEnv *env, jobject) {
   LOGI("Shutting down ARMv9 optimizations...");
+
+  // Не запущені відкладені підсистеми більше не потрібні
+  g_bootInit.Clear();
   
   // Shutdown LLVM JIT engines first
   LOGI("Shutting down LLVM PPU/SPU JIT...");
@@ -952,6 +1511,69 @@ Java_net_rpcsx_RPCSX_getJITStats(JNIEnv *env, jobject) {
   return wrap(env, buf);
 }
 
+/**
+ * Покадрова телеметрія: запис у кільце на межі present
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_net_rpcsx_RPCSX_setFrameTelemetryEnabled(JNIEnv *env, jobject, jboolean enabled) {
+  rpcsx::telemetry::SetFrameTelemetryEnabled(enabled == JNI_TRUE);
+  UpdateGpuCostSink();
+}
+
+/**
+ * Кадри з sequence >= sinceSequence одним byte[]: FrameTelemetryHeader + FrameSample[count]
+ * (little endian, див. frame_telemetry.h); наступний виклик з first_sequence + count
+ */
+extern "C" JNIEXPORT jbyteArray JNICALL
+Java_net_rpcsx_RPCSX_getFrameTelemetry(JNIEnv *env, jobject, jlong sinceSequence) {
+  std::vector<uint8_t> data;
+  rpcsx::telemetry::ExportFrameTelemetry(static_cast<uint64_t>(std::max<jlong>(sinceSequence, 0)), &data);
+
+  jbyteArray result = env->NewByteArray(static_cast<jsize>(data.size()));
+  if (result) {
+    env->SetByteArrayRegion(result, 0, static_cast<jsize>(data.size()),
+                            reinterpret_cast<const jbyte *>(data.data()));
+  }
+  return result;
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_net_rpcsx_RPCSX_getFrameTelemetryJson(JNIEnv *env, jobject, jlong sinceSequence) {
+  return wrap(env, rpcsx::telemetry::ExportFrameTelemetryJson(
+                       static_cast<uint64_t>(std::max<jlong>(sinceSequence, 0))));
+}
+
+/**
+ * Середній GPU час за кадр по render pass, compute і pipeline з моменту скидання
+ * (для рішень у game_profiles)
+ */
+extern "C" JNIEXPORT jstring JNICALL
+Java_net_rpcsx_RPCSX_getGpuCostBreakdownJson(JNIEnv *env, jobject) {
+  return wrap(env, rpcsx::telemetry::ExportGpuCostsJson());
+}
+
+/**
+ * ComponentCallbacks2.onTrimMemory / onLowMemory (TRIM_MEMORY_COMPLETE):
+ * кеші стискаються за пріоритетом, повертає звільнені байти
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_net_rpcsx_RPCSX_onTrimMemory(JNIEnv *env, jobject, jint level) {
+  return static_cast<jlong>(rpcsx::memory::OnTrimMemory(level));
+}
+
+/**
+ * Бюджет пам'яті кешів у MB (0 - без бюджету), перевіряється на межі кадру
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_net_rpcsx_RPCSX_setMemoryBudgetMb(JNIEnv *env, jobject, jlong budgetMb) {
+  rpcsx::memory::SetMemoryBudget(static_cast<uint64_t>(std::max<jlong>(budgetMb, 0)) * 1024 * 1024);
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_net_rpcsx_RPCSX_getMemoryReportJson(JNIEnv *env, jobject) {
+  return wrap(env, rpcsx::memory::ExportMemoryReportJson());
+}
+
 /**
  * Запуск JIT для тестування (debug)
  */
@@ -1043,6 +1665,32 @@ Java_net_rpcsx_RPCSX_rsxGetStats(JNIEnv *env, jobject) {
   return result;
 }
 
+/**
+ * Конкуренція за блокування емулятора (rx::shared_mutex, shared_atomic32):
+ * [contended, resolved_by_spin, parked, spin_ns], null - старий librpcsx
+ */
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_net_rpcsx_RPCSX_getLockContentionStats(JNIEnv *env, jobject) {
+  auto getContention = rpcsxLib.getLockContentionStats;
+  if (getContention == nullptr) {
+    return nullptr;
+  }
+
+  std::uint64_t contended = 0, spinResolved = 0, parked = 0, spinNs = 0;
+  getContention(&contended, &spinResolved, &parked, &spinNs);
+
+  jlong stat_array[] = {
+    static_cast<jlong>(contended),
+    static_cast<jlong>(spinResolved),
+    static_cast<jlong>(parked),
+    static_cast<jlong>(spinNs)
+  };
+
+  jlongArray result = env->NewLongArray(4);
+  env->SetLongArrayRegion(result, 0, 4, stat_array);
+  return result;
+}
+
 /**
  * GUI Button Control for RSX Graphics Engine
  */
@@ -1523,6 +2171,10 @@ Java_net_rpcsx_RPCSX_drsSetMaxScale(JNIEnv *env, jobject, jfloat scale) {
  */
 extern "C" JNIEXPORT jfloat JNICALL
 Java_net_rpcsx_RPCSX_drsUpdate(JNIEnv *env, jobject, jfloat frame_time_ms) {
+    // Кадри вже надходять з RSX - не рахуємо їх двічі
+    if (g_drs_present_feed.load(std::memory_order_relaxed)) {
+        return rpcsx::drs::GetCurrentScale();
+    }
     return rpcsx::drs::UpdateDRS(frame_time_ms);
 }
 
@@ -1554,7 +2206,12 @@ Java_net_rpcsx_RPCSX_drsGetStatsJson(JNIEnv *env, jobject) {
         "\"output_width\": %u,"
         "\"output_height\": %u,"
         "\"scale_changes\": %llu,"
-        "\"is_scaling_down\": %s"
+        "\"is_scaling_down\": %s,"
+        "\"gpu_time_ms\": %.2f,"
+        "\"predicted_gpu_time_ms\": %.2f,"
+        "\"gpu_bound\": %s,"
+        "\"has_gpu_feedback\": %s,"
+        "\"frames_held\": %llu"
         "}",
         rpcsx::drs::IsDRSActive() ? "true" : "false",
         stats.current_scale,
@@ -1565,7 +2222,12 @@ Java_net_rpcsx_RPCSX_drsGetStatsJson(JNIEnv *env, jobject) {
         stats.output_width,
         stats.output_height,
         (unsigned long long)stats.scale_changes,
-        stats.is_scaling_down ? "true" : "false"
+        stats.is_scaling_down ? "true" : "false",
+        stats.gpu_time_ms,
+        stats.predicted_gpu_time_ms,
+        stats.gpu_bound ? "true" : "false",
+        stats.has_gpu_feedback ? "true" : "false",
+        (unsigned long long)stats.frames_held
     );
     
     return wrap(env, buffer);
@@ -1653,7 +2315,10 @@ Java_net_rpcsx_RPCSX_textureStreamingGetStatsJson(JNIEnv *env, jobject) {
     "\"bytes_cached\": %llu,"
     "\"current_cache_size_mb\": %u,"
     "\"pending_loads\": %u,"
-    "\"average_load_time_ms\": %.2f"
+    "\"average_load_time_ms\": %.2f,"
+    "\"textures_sampled\": %u,"
+    "\"textures_evicted\": %llu,"
+    "\"mips_trimmed\": %llu"
         "}",
     (unsigned long long)stats.textures_loaded,
     (unsigned long long)stats.textures_streamed,
@@ -1664,7 +2329,10 @@ Java_net_rpcsx_RPCSX_textureStreamingGetStatsJson(JNIEnv *env, jobject) {
     (unsigned long long)stats.bytes_cached,
     stats.current_cache_size_mb,
     stats.pending_loads,
-    stats.average_load_time_ms
+    stats.average_load_time_ms,
+    stats.textures_sampled,
+    (unsigned long long)stats.textures_evicted,
+    (unsigned long long)stats.mips_trimmed
     );
     
     return wrap(env, buffer);
@@ -1800,7 +2468,7 @@ Java_net_rpcsx_RPCSX_pipelineCacheGetStatsJson(JNIEnv *env, jobject) {
     rpcsx::pipeline::PipelineCacheStats stats;
     rpcsx::pipeline::GetStats(&stats);
     
-    char buffer[512];
+    char buffer[768];
     snprintf(buffer, sizeof(buffer),
         "{"
         "\"pipelines_in_cache\": %u,"
@@ -1809,7 +2477,15 @@ Java_net_rpcsx_RPCSX_pipelineCacheGetStatsJson(JNIEnv *env, jobject) {
         "\"cache_misses\": %llu,"
         "\"cache_hit_ratio\": %.2f,"
         "\"pending_compilations\": %u,"
-        "\"average_compile_time_ms\": %.2f"
+        "\"average_compile_time_ms\": %.2f,"
+        "\"interpreter_draws\": %llu,"
+        "\"interpreter_swaps\": %llu,"
+        "\"skipped_draws\": %llu,"
+        "\"driver_cache_hits\": %llu,"
+        "\"driver_cache_misses\": %llu,"
+        "\"library_parts_created\": %llu,"
+        "\"library_part_hits\": %llu,"
+        "\"library_links\": %llu"
         "}",
         stats.pipelines_in_cache,
         (unsigned long long)stats.total_pipelines_created,
@@ -1817,7 +2493,15 @@ Java_net_rpcsx_RPCSX_pipelineCacheGetStatsJson(JNIEnv *env, jobject) {
         (unsigned long long)stats.cache_misses,
         stats.cache_hit_ratio,
         stats.pending_compilations,
-        stats.average_compile_time_ms
+        stats.average_compile_time_ms,
+        (unsigned long long)stats.interpreter_draws,
+        (unsigned long long)stats.interpreter_swaps,
+        (unsigned long long)stats.skipped_draws,
+        (unsigned long long)stats.driver_cache_hits,
+        (unsigned long long)stats.driver_cache_misses,
+        (unsigned long long)stats.library_parts_created,
+        (unsigned long long)stats.library_part_hits,
+        (unsigned long long)stats.library_links
     );
     
     return wrap(env, buffer);
@@ -2085,6 +2769,26 @@ Java_net_rpcsx_RPCSX_saveConverterConvert(JNIEnv *env, jobject,
     return result.success ? JNI_TRUE : JNI_FALSE;
 }
 
+extern "C" JNIEXPORT jstring JNICALL
+Java_net_rpcsx_RPCSX_saveConverterConvertAll(JNIEnv *env, jobject,
+                                              jstring src_dir, jstring dst_dir, jint format) {
+    rpcsx::saves::ConversionOptions options;
+    options.create_backup = true;
+    options.validate_after_conversion = true;
+    
+    auto batch = rpcsx::saves::ConvertSaveDirectory(
+        unwrap(env, src_dir).c_str(),
+        unwrap(env, dst_dir).c_str(),
+        static_cast<rpcsx::saves::SaveFormat>(format),
+        options);
+    
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer),
+        "{\"total\": %zu, \"converted\": %zu, \"failed\": %zu}",
+        batch.saves_total, batch.saves_converted, batch.saves_failed);
+    return wrap(env, buffer);
+}
+
 extern "C" JNIEXPORT jboolean JNICALL
 Java_net_rpcsx_RPCSX_saveConverterValidate(JNIEnv *env, jobject, jstring path) {
     return rpcsx::saves::ValidateSaveData(unwrap(env, path).c_str())
@@ -0,0 +1,488 @@
+// NBTC compile-priority predictor: TFLite model with a transition table fallback
+#include "compile_predictor.h"
+#include "nbtc_engine.h"
+#include "nce_v8/nce_v8.h"
+#include "pipeline_cache.h"
+#include <android/log.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define LOG_TAG "rpcsx-nbtc"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+#if defined(HAVE_TFLITE)
+#include "tensorflow/lite/c/c_api.h"
+#if defined(HAVE_TFLITE_GPU_DELEGATE)
+#include "tensorflow/lite/delegates/gpu/delegate.h"
+#endif
+#endif
+
+namespace nbtc {
+
+namespace {
+
+constexpr size_t kHistory = 8;                  // Misses fed to the model
+constexpr float kHistoryDecay = 0.7f;           // Weight of each older miss
+constexpr uint32_t kMaxIntervalMs = 1000;       // Backoff ceiling when over budget
+constexpr uint32_t kTableMagic = 0x50544E42;    // "NBTP"
+constexpr uint32_t kTableVersion = 1;
+
+enum class MissKind : uint8_t { None, Block, Pipeline };
+
+// Last thing that mapped to a bucket; predictions act on it
+struct BucketCandidate {
+    MissKind kind = MissKind::None;
+    uint64_t address = 0;
+    std::unique_ptr<rpcsx::pipeline::GraphicsPipelineDesc> pipeline;
+};
+
+struct PredictorState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+    bool running = false;
+    PredictorConfig config;
+    std::string title_id;
+    std::string table_path;
+
+    // Miss history, most recent at history[(head - 1) % kHistory]
+    std::array<uint16_t, kHistory> history{};
+    size_t history_size = 0;
+    size_t head = 0;
+    uint64_t misses = 0;
+
+    // Online first-order transitions between buckets (the fallback predictor)
+    std::vector<uint16_t> transitions = std::vector<uint16_t>(kPredictorBuckets * kPredictorBuckets);
+    std::array<uint32_t, kPredictorBuckets> row_sums{};
+
+    std::array<BucketCandidate, kPredictorBuckets> candidates;
+
+    PredictorStats stats;
+};
+
+PredictorState g_state;
+
+#if defined(HAVE_TFLITE)
+// Interpreter is used only by the worker and by load/unload, under g_model_mutex
+std::mutex g_model_mutex;
+TfLiteModel* s_model = nullptr;
+TfLiteInterpreterOptions* s_opts = nullptr;
+TfLiteInterpreter* s_interp = nullptr;
+TfLiteDelegate* s_delegate = nullptr;
+
+void ReleaseModelLocked() {
+    if (s_interp) TfLiteInterpreterDelete(s_interp);
+    if (s_opts) TfLiteInterpreterOptionsDelete(s_opts);
+#if defined(HAVE_TFLITE_GPU_DELEGATE)
+    if (s_delegate) TfLiteGpuDelegateV2Delete(s_delegate);
+#endif
+    if (s_model) TfLiteModelDelete(s_model);
+    s_interp = nullptr;
+    s_opts = nullptr;
+    s_delegate = nullptr;
+    s_model = nullptr;
+}
+#endif
+
+uint16_t BucketOf(MissKind kind, uint64_t id) {
+    uint64_t x = id ^ (static_cast<uint64_t>(kind) << 62);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return static_cast<uint16_t>(x % kPredictorBuckets);
+}
+
+// Called with g_state.mutex held
+void RecordMissLocked(uint16_t bucket) {
+    if (g_state.history_size > 0) {
+        const uint16_t previous = g_state.history[(g_state.head + kHistory - 1) % kHistory];
+        uint16_t* row = &g_state.transitions[previous * kPredictorBuckets];
+
+        // Halve the row on saturation so old phases of the game fade out
+        if (row[bucket] == UINT16_MAX) {
+            uint32_t sum = 0;
+            for (size_t i = 0; i < kPredictorBuckets; i++) {
+                row[i] /= 2;
+                sum += row[i];
+            }
+            g_state.row_sums[previous] = sum;
+        }
+        row[bucket]++;
+        g_state.row_sums[previous]++;
+    }
+
+    g_state.history[g_state.head] = bucket;
+    g_state.head = (g_state.head + 1) % kHistory;
+    g_state.history_size = std::min(g_state.history_size + 1, kHistory);
+    g_state.misses++;
+    g_state.cv.notify_one();
+}
+
+// Decayed bag of the history buckets, most recent miss weighs 1.0
+void BuildFeatures(const std::array<uint16_t, kHistory>& history, size_t size, size_t head,
+                   float* features) {
+    std::fill(features, features + kPredictorBuckets, 0.0f);
+    float weight = 1.0f;
+    for (size_t i = 0; i < size; i++) {
+        features[history[(head + kHistory - 1 - i) % kHistory]] += weight;
+        weight *= kHistoryDecay;
+    }
+}
+
+#if defined(HAVE_TFLITE)
+bool RunModel(const float* features, float* scores) {
+    std::lock_guard<std::mutex> lock(g_model_mutex);
+    if (!s_interp) return false;
+
+    TfLiteTensor* input = TfLiteInterpreterGetInputTensor(s_interp, 0);
+    const TfLiteTensor* output = TfLiteInterpreterGetOutputTensor(s_interp, 0);
+    return input && output &&
+           TfLiteTensorCopyFromBuffer(input, features, kPredictorBuckets * sizeof(float)) == kTfLiteOk &&
+           TfLiteInterpreterInvoke(s_interp) == kTfLiteOk &&
+           TfLiteTensorCopyToBuffer(output, scores, kPredictorBuckets * sizeof(float)) == kTfLiteOk;
+}
+#endif
+
+// Called with g_state.mutex held
+void RunTransitionTable(const float* features, float* scores) {
+    std::fill(scores, scores + kPredictorBuckets, 0.0f);
+    float total_weight = 0.0f;
+    for (size_t from = 0; from < kPredictorBuckets; from++) {
+        if (features[from] == 0.0f || g_state.row_sums[from] == 0) continue;
+
+        const uint16_t* row = &g_state.transitions[from * kPredictorBuckets];
+        const float scale = features[from] / static_cast<float>(g_state.row_sums[from]);
+        for (size_t to = 0; to < kPredictorBuckets; to++) {
+            scores[to] += row[to] * scale;
+        }
+        total_weight += features[from];
+    }
+
+    if (total_weight > 0.0f) {
+        for (size_t i = 0; i < kPredictorBuckets; i++) scores[i] /= total_weight;
+    }
+}
+
+struct Prediction {
+    MissKind kind;
+    uint64_t address;
+    rpcsx::pipeline::GraphicsPipelineDesc pipeline;
+    float confidence;
+};
+
+// Called with g_state.mutex held; the compilers are fed after it is released
+void CollectPredictions(const float* scores, const std::array<uint16_t, kHistory>& history,
+                        size_t history_size, size_t head, std::vector<Prediction>& predictions) {
+    predictions.clear();
+
+    std::array<uint16_t, kPredictorBuckets> order;
+    for (size_t i = 0; i < kPredictorBuckets; i++) order[i] = static_cast<uint16_t>(i);
+
+    const size_t top_k = std::min<size_t>(g_state.config.top_k, kPredictorBuckets);
+    std::partial_sort(order.begin(), order.begin() + top_k, order.end(),
+                      [&](uint16_t a, uint16_t b) { return scores[a] > scores[b]; });
+
+    for (size_t i = 0; i < top_k; i++) {
+        const uint16_t bucket = order[i];
+        const float confidence = std::min(scores[bucket], 1.0f);
+        if (confidence < g_state.config.min_confidence) break;
+
+        // The bucket just missed is already being compiled
+        if (history_size > 0 && history[(head + kHistory - 1) % kHistory] == bucket) continue;
+
+        const BucketCandidate& candidate = g_state.candidates[bucket];
+        if (candidate.kind == MissKind::Block) {
+            predictions.push_back({MissKind::Block, candidate.address, {}, confidence});
+            g_state.stats.block_predictions++;
+        } else if (candidate.kind == MissKind::Pipeline && candidate.pipeline) {
+            predictions.push_back({MissKind::Pipeline, 0, *candidate.pipeline, confidence});
+            g_state.stats.pipeline_predictions++;
+        }
+    }
+}
+
+void Dispatch(const std::vector<Prediction>& predictions) {
+    for (const Prediction& prediction : predictions) {
+        if (prediction.kind == MissKind::Block) {
+            rpcsx::nce::v8::PrioritizeTierUp(prediction.address, prediction.confidence);
+        } else {
+            // Ahead of manual requests (0.5), behind cache replay (> 1.0)
+            rpcsx::pipeline::RequestPrecompile(prediction.pipeline, 0.5f + 0.5f * prediction.confidence);
+        }
+    }
+}
+
+// Called with g_model_mutex held
+void SetModelStats(bool loaded, bool gpu_delegate) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    g_state.stats.model_loaded = loaded;
+    g_state.stats.gpu_delegate = gpu_delegate;
+}
+
+void WorkerLoop() {
+    // Prediction must never take time from the emulation threads
+    setpriority(PRIO_PROCESS, 0, 10);
+
+    std::vector<float> features(kPredictorBuckets);
+    std::vector<float> scores(kPredictorBuckets);
+    std::vector<Prediction> predictions;
+    uint64_t seen_misses = 0;
+    uint32_t interval_ms = 0;
+    double avg_us = 0.0;
+
+    std::unique_lock<std::mutex> lock(g_state.mutex);
+    interval_ms = g_state.config.interval_ms;
+
+    while (g_state.running) {
+        g_state.cv.wait_for(lock, std::chrono::milliseconds(interval_ms));
+        if (!g_state.running) break;
+        if (g_state.misses == seen_misses || g_state.history_size == 0) continue;
+        seen_misses = g_state.misses;
+
+        const auto history = g_state.history;
+        const size_t history_size = g_state.history_size;
+        const size_t head = g_state.head;
+        BuildFeatures(history, history_size, head, features.data());
+
+        const auto start = std::chrono::steady_clock::now();
+        bool predicted = false;
+#if defined(HAVE_TFLITE)
+        lock.unlock();
+        predicted = RunModel(features.data(), scores.data());
+        lock.lock();
+        if (!g_state.running) break;
+#endif
+        if (!predicted) RunTransitionTable(features.data(), scores.data());
+        const double us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count();
+
+        CollectPredictions(scores.data(), history, history_size, head, predictions);
+
+        // Over budget: back off the cadence, recover once the cost settles
+        avg_us = g_state.stats.inferences ? avg_us * 0.9 + us * 0.1 : us;
+        if (avg_us > g_state.config.budget_us) {
+            interval_ms = std::min(interval_ms * 2, kMaxIntervalMs);
+            g_state.stats.budget_backoffs++;
+        } else if (avg_us < g_state.config.budget_us / 2 && interval_ms > g_state.config.interval_ms) {
+            interval_ms = std::max(interval_ms / 2, g_state.config.interval_ms);
+        }
+
+        g_state.stats.inferences++;
+        g_state.stats.avg_inference_us = static_cast<uint32_t>(avg_us);
+        g_state.stats.current_interval_ms = interval_ms;
+
+        if (!predictions.empty()) {
+            lock.unlock();
+            Dispatch(predictions);
+            lock.lock();
+        }
+    }
+}
+
+// Called with g_state.mutex held
+void LoadTableLocked() {
+    std::fill(g_state.transitions.begin(), g_state.transitions.end(), 0);
+    g_state.row_sums.fill(0);
+    if (g_state.table_path.empty()) return;
+
+    std::ifstream in(g_state.table_path, std::ios::binary);
+    uint32_t header[3] = {};
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != kTableMagic || header[1] != kTableVersion || header[2] != kPredictorBuckets) return;
+
+    in.read(reinterpret_cast<char*>(g_state.transitions.data()),
+            g_state.transitions.size() * sizeof(uint16_t));
+    if (!in) {
+        std::fill(g_state.transitions.begin(), g_state.transitions.end(), 0);
+        return;
+    }
+
+    for (size_t from = 0; from < kPredictorBuckets; from++) {
+        uint32_t sum = 0;
+        for (size_t to = 0; to < kPredictorBuckets; to++) sum += g_state.transitions[from * kPredictorBuckets + to];
+        g_state.row_sums[from] = sum;
+    }
+}
+
+// Called with g_state.mutex held
+void SaveTableLocked() {
+    if (g_state.table_path.empty()) return;
+
+    const std::string temp_path = g_state.table_path + ".tmp";
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    const uint32_t header[3] = {kTableMagic, kTableVersion, static_cast<uint32_t>(kPredictorBuckets)};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(g_state.transitions.data()),
+              g_state.transitions.size() * sizeof(uint16_t));
+    out.close();
+
+    if (!out || std::rename(temp_path.c_str(), g_state.table_path.c_str()) != 0) {
+        LOGE("NBTC: failed to save predictor table %s", g_state.table_path.c_str());
+        std::remove(temp_path.c_str());
+    }
+}
+
+} // namespace
+
+bool LoadPredictorModel(const std::string& model_path) {
+#if defined(HAVE_TFLITE)
+    std::lock_guard<std::mutex> lock(g_model_mutex);
+    ReleaseModelLocked();
+    SetModelStats(false, false);
+
+    if (model_path.empty()) {
+        LOGI("NBTC: No model path provided; using the transition table predictor.");
+        return false;
+    }
+
+    s_model = TfLiteModelCreateFromFile(model_path.c_str());
+    if (!s_model) {
+        LOGE("NBTC: TfLiteModelCreateFromFile failed for %s", model_path.c_str());
+        return false;
+    }
+
+    // One CPU thread at most; the GPU delegate takes the graph when it can
+    s_opts = TfLiteInterpreterOptionsCreate();
+    TfLiteInterpreterOptionsSetNumThreads(s_opts, 1);
+#if defined(HAVE_TFLITE_GPU_DELEGATE)
+    TfLiteGpuDelegateOptionsV2 gpu_options = TfLiteGpuDelegateOptionsV2Default();
+    gpu_options.inference_preference = TFLITE_GPU_INFERENCE_PREFERENCE_SUSTAINED_SPEED;
+    gpu_options.inference_priority1 = TFLITE_GPU_INFERENCE_PRIORITY_MIN_LATENCY;
+    gpu_options.is_precision_loss_allowed = 1;
+    s_delegate = TfLiteGpuDelegateV2Create(&gpu_options);
+    if (s_delegate) TfLiteInterpreterOptionsAddDelegate(s_opts, s_delegate);
+#endif
+
+    s_interp = TfLiteInterpreterCreate(s_model, s_opts);
+    if (!s_interp || TfLiteInterpreterAllocateTensors(s_interp) != kTfLiteOk) {
+        LOGE("NBTC: TFLite interpreter setup failed for %s", model_path.c_str());
+        ReleaseModelLocked();
+        return false;
+    }
+
+    const size_t expected = kPredictorBuckets * sizeof(float);
+    const TfLiteTensor* input = TfLiteInterpreterGetInputTensor(s_interp, 0);
+    const TfLiteTensor* output = TfLiteInterpreterGetOutputTensor(s_interp, 0);
+    if (TfLiteTensorByteSize(input) != expected || TfLiteTensorByteSize(output) != expected) {
+        LOGE("NBTC: model %s does not take float32[%zu] history / scores", model_path.c_str(),
+             kPredictorBuckets);
+        ReleaseModelLocked();
+        return false;
+    }
+
+    SetModelStats(true, s_delegate != nullptr);
+    LOGI("NBTC: predictor model loaded (%s)", s_delegate ? "GPU delegate" : "CPU, 1 thread");
+    return true;
+#else
+    LOGI("NBTC: TFLite not available, using the transition table predictor.");
+    (void)model_path;
+    return false;
+#endif
+}
+
+void UnloadPredictorModel() {
+#if defined(HAVE_TFLITE)
+    std::lock_guard<std::mutex> lock(g_model_mutex);
+    ReleaseModelLocked();
+    SetModelStats(false, false);
+#endif
+}
+
+void StartCompilePredictor(const std::string& title_id, const PredictorConfig& config) {
+    StopCompilePredictor();
+
+    {
+        std::lock_guard<std::mutex> lock(g_state.mutex);
+        g_state.config = config;
+        g_state.config.interval_ms = std::max<uint32_t>(config.interval_ms, 1);
+        g_state.title_id = title_id;
+
+        const std::string dir = GetTitleCacheDir(title_id);
+        g_state.table_path = dir.empty() ? std::string() : dir + "/predictor.bin";
+        LoadTableLocked();
+
+        const PredictorStats previous = g_state.stats;
+        g_state.stats = {};
+        g_state.stats.model_loaded = previous.model_loaded;
+        g_state.stats.gpu_delegate = previous.gpu_delegate;
+        g_state.stats.current_interval_ms = g_state.config.interval_ms;
+
+        g_state.history_size = 0;
+        g_state.head = 0;
+        for (auto& candidate : g_state.candidates) {
+            candidate.kind = MissKind::None;
+            candidate.pipeline.reset();
+        }
+
+        g_state.running = true;
+        g_state.worker = std::thread(WorkerLoop);
+    }
+
+    rpcsx::nce::v8::SetBlockMissCallback(&RecordBlockMiss);
+    rpcsx::pipeline::SetPipelineMissObserver(&RecordPipelineMiss);
+    LOGI("NBTC: compile predictor started for %s", title_id.c_str());
+}
+
+void StopCompilePredictor() {
+    rpcsx::nce::v8::SetBlockMissCallback(nullptr);
+    rpcsx::pipeline::SetPipelineMissObserver(nullptr);
+
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(g_state.mutex);
+        if (!g_state.running) return;
+        g_state.running = false;
+        worker = std::move(g_state.worker);
+        g_state.cv.notify_all();
+    }
+    if (worker.joinable()) worker.join();
+
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    SaveTableLocked();
+    LOGI("NBTC: compile predictor stopped for %s (%llu inferences, avg %u us)",
+         g_state.title_id.c_str(), static_cast<unsigned long long>(g_state.stats.inferences),
+         g_state.stats.avg_inference_us);
+}
+
+void RecordBlockMiss(uint64_t address) {
+    const uint16_t bucket = BucketOf(MissKind::Block, address);
+
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    if (!g_state.running) return;
+
+    auto& candidate = g_state.candidates[bucket];
+    candidate.kind = MissKind::Block;
+    candidate.address = address;
+    RecordMissLocked(bucket);
+}
+
+void RecordPipelineMiss(const rpcsx::pipeline::GraphicsPipelineDesc& desc) {
+    const uint16_t bucket = BucketOf(MissKind::Pipeline, desc.CalculateHash());
+
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    if (!g_state.running) return;
+
+    auto& candidate = g_state.candidates[bucket];
+    candidate.kind = MissKind::Pipeline;
+    if (!candidate.pipeline) candidate.pipeline = std::make_unique<rpcsx::pipeline::GraphicsPipelineDesc>();
+    *candidate.pipeline = desc;
+    RecordMissLocked(bucket);
+}
+
+PredictorStats GetPredictorStats() {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    return g_state.stats;
+}
+
+} // namespace nbtc
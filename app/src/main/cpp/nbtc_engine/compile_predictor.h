@@ -0,0 +1,53 @@
+// NBTC: predicts which blocks and pipelines the title needs next from its recent miss history
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rpcsx::pipeline {
+struct GraphicsPipelineDesc;
+}
+
+namespace nbtc {
+
+struct PredictorConfig {
+    uint32_t interval_ms = 50;       // Inference cadence while new misses arrive
+    uint32_t budget_us = 2000;       // Average inference cost allowed per interval
+    uint32_t top_k = 4;              // Candidates acted on per inference
+    float min_confidence = 0.2f;     // Scores below this are ignored
+};
+
+struct PredictorStats {
+    bool model_loaded = false;       // TFLite model; otherwise the transition table predicts
+    bool gpu_delegate = false;
+    uint64_t inferences = 0;
+    uint64_t budget_backoffs = 0;    // Times the cadence was slowed to stay in budget
+    uint64_t block_predictions = 0;
+    uint64_t pipeline_predictions = 0;
+    uint32_t avg_inference_us = 0;
+    uint32_t current_interval_ms = 0;
+};
+
+// Model contract: input 0 and output 0 are float32[kPredictorBuckets]. The input is the
+// miss history as decayed bucket weights, the output the probability of each bucket.
+constexpr size_t kPredictorBuckets = 256;
+
+// Load (or replace) the TFLite model; false keeps the transition table predictor
+bool LoadPredictorModel(const std::string& model_path);
+void UnloadPredictorModel();
+
+// Start predicting for a title: installs the nce_v8 / pipeline cache miss observers and
+// restores the title's transition table from its cache directory
+void StartCompilePredictor(const std::string& title_id, const PredictorConfig& config = {});
+
+// Remove the observers, stop the worker and persist the transition table
+void StopCompilePredictor();
+
+// Miss observers, called on execution / draw threads
+void RecordBlockMiss(uint64_t address);
+void RecordPipelineMiss(const rpcsx::pipeline::GraphicsPipelineDesc& desc);
+
+PredictorStats GetPredictorStats();
+
+} // namespace nbtc
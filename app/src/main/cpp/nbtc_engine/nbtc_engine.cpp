@@ -1,144 +1,366 @@
-// Lightweight NBTC prototype implementation (optional TFLite integration)
+// NBTC implementation: AOT tier-2 queue; the TFLite model lives in compile_predictor
 #include "nbtc_engine.h"
+#include "compile_predictor.h"
+#include "nce_v8/nce_v8.h"
 #include <android/log.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #define LOG_TAG "rpcsx-nbtc"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-#if defined(HAVE_TFLITE)
-#include "tensorflow/lite/c/c_api.h"
-// File-scope TFLite pointers for simple lifecycle management
-static TfLiteModel* s_model = nullptr;
-static TfLiteInterpreterOptions* s_opts = nullptr;
-static TfLiteInterpreter* s_interp = nullptr;
-#endif
-
 namespace nbtc {
 
 bool Initialize(const std::string& model_path) {
     LOGI("NBTC: Initialize called, model_path=%s", model_path.c_str());
-#if defined(HAVE_TFLITE)
-    // If built with TFLite support, attempt to initialize interpreter here.
-    LOGI("NBTC: Built with TFLite support. Attempting to load model: %s", model_path.c_str());
-    if (model_path.empty()) {
-        LOGI("NBTC: No model path provided; skipping model load.");
-        return true;
+    // Without a model the predictor falls back to its transition table
+    LoadPredictorModel(model_path);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// AOT queue: install-time analysis output, compiled while the device charges
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr uint32_t kQueueMagic = 0x5154424E;    // "NBTQ"
+constexpr uint32_t kQueueVersion = 1;
+constexpr uint32_t kMaxBlockSize = 64 * 1024;   // Larger "blocks" are analyser noise
+constexpr size_t kProgressStride = 4096;        // Blocks between progress checkpoints
+
+// File: [QueueHeader][BlockRecord + code]...
+struct QueueHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t block_count;
+    uint32_t reserved;
+};
+
+struct BlockRecord {
+    uint32_t address;
+    uint32_t size;
+};
+
+struct Progress {
+    std::string build;
+    uint32_t done = 0;
+    uint32_t compiled = 0;
+};
+
+enum class RunResult { Done, Paused, Failed };
+
+struct EngineState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+    bool stop = false;
+    bool charging = false;
+    bool emulation_active = false;
+    std::deque<std::string> pending;
+    std::string cache_dir;
+    std::string build_id;
+
+    // Checked by the compiler between blocks
+    std::atomic<bool> paused{true};
+};
+
+EngineState g_state;
+
+std::string TitleDir(const std::string& cache_dir, const std::string& title_id) {
+    return cache_dir + "/" + (title_id.empty() ? std::string("default") : title_id);
+}
+
+std::string QueuePath(const std::string& cache_dir, const std::string& title_id) {
+    return TitleDir(cache_dir, title_id) + "/aot_queue.bin";
+}
+
+std::string ProgressPath(const std::string& cache_dir, const std::string& title_id) {
+    return TitleDir(cache_dir, title_id) + "/aot_progress.txt";
+}
+
+Progress ReadProgress(const std::string& path) {
+    Progress progress;
+    std::ifstream in(path);
+    std::string line;
+    while (in && std::getline(in, line)) {
+        if (line.rfind("build=", 0) == 0) progress.build = line.substr(6);
+        if (line.rfind("done=", 0) == 0) progress.done = static_cast<uint32_t>(std::strtoul(line.c_str() + 5, nullptr, 10));
+        if (line.rfind("compiled=", 0) == 0) progress.compiled = static_cast<uint32_t>(std::strtoul(line.c_str() + 9, nullptr, 10));
+    }
+    return progress;
+}
+
+void WriteProgress(const std::string& path, const Progress& progress) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    out << "build=" << progress.build << "\n";
+    out << "done=" << progress.done << "\n";
+    out << "compiled=" << progress.compiled << "\n";
+}
+
+bool ReadQueueHeader(const std::string& path, QueueHeader* header) {
+    std::ifstream in(path, std::ios::binary);
+    in.read(reinterpret_cast<char*>(header), sizeof(*header));
+    return in && header->magic == kQueueMagic && header->version == kQueueVersion;
+}
+
+// Loads the whole queue; block code points into storage
+bool LoadQueue(const std::string& path, std::vector<uint8_t>& storage,
+               std::vector<rpcsx::nce::v8::PrecompileBlock>& blocks) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+
+    const std::streamoff file_size = in.tellg();
+    if (file_size < static_cast<std::streamoff>(sizeof(QueueHeader))) return false;
+
+    storage.resize(static_cast<size_t>(file_size));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(storage.data()), file_size);
+    if (!in) return false;
+
+    QueueHeader header;
+    std::memcpy(&header, storage.data(), sizeof(header));
+    if (header.magic != kQueueMagic || header.version != kQueueVersion) return false;
+
+    blocks.clear();
+    blocks.reserve(header.block_count);
+
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.block_count; i++) {
+        BlockRecord record;
+        if (offset + sizeof(record) > storage.size()) return false;
+        std::memcpy(&record, storage.data() + offset, sizeof(record));
+        offset += sizeof(record);
+
+        if (record.size > kMaxBlockSize || offset + record.size > storage.size()) return false;
+        blocks.push_back({record.address, storage.data() + offset, record.size});
+        offset += record.size;
+    }
+    return true;
+}
+
+// Called with g_state.mutex held
+void UpdatePausedLocked() {
+    g_state.paused.store(g_state.stop || !g_state.charging || g_state.emulation_active,
+                         std::memory_order_relaxed);
+    g_state.cv.notify_all();
+}
+
+RunResult CompileTitle(const std::string& title_id, const std::string& cache_dir,
+                       const std::string& build_id) {
+    std::vector<uint8_t> storage;
+    std::vector<rpcsx::nce::v8::PrecompileBlock> blocks;
+    if (!LoadQueue(QueuePath(cache_dir, title_id), storage, blocks)) {
+        LOGE("NBTC: AOT queue for %s is missing or damaged", title_id.c_str());
+        return RunResult::Failed;
+    }
+
+    // The tier-2 cache is purged on a new build, progress goes with it
+    const std::string progress_path = ProgressPath(cache_dir, title_id);
+    Progress progress = ReadProgress(progress_path);
+    if (progress.build != build_id) {
+        progress = {};
+        progress.build = build_id;
+    }
+
+    LOGI("NBTC: AOT compile %s from block %u/%zu", title_id.c_str(), progress.done, blocks.size());
+
+    while (progress.done < blocks.size()) {
+        const size_t count = std::min(kProgressStride, blocks.size() - progress.done);
+
+        size_t compiled = 0;
+        const size_t processed = rpcsx::nce::v8::PrecompileToPersistentCache(
+            cache_dir.c_str(), title_id.c_str(), build_id.c_str(),
+            blocks.data() + progress.done, count, &g_state.paused, &compiled);
+
+        progress.done += static_cast<uint32_t>(processed);
+        progress.compiled += static_cast<uint32_t>(compiled);
+        WriteProgress(progress_path, progress);
+
+        if (processed < count) {
+            return g_state.paused.load(std::memory_order_relaxed) ? RunResult::Paused
+                                                                   : RunResult::Failed;
+        }
     }
-    // c_api.h functions
-    TfLiteModel* tmodel = nullptr;
-    TfLiteInterpreterOptions* opts = nullptr;
-    TfLiteInterpreter* interp = nullptr;
-    tmodel = TfLiteModelCreateFromFile(model_path.c_str());
-    if (!tmodel) {
-        LOGE("NBTC: TfLiteModelCreateFromFile failed for %s", model_path.c_str());
+
+    LOGI("NBTC: AOT bundle ready for %s (%u of %zu blocks compiled)",
+         title_id.c_str(), progress.compiled, blocks.size());
+    return RunResult::Done;
+}
+
+void WorkerLoop() {
+    // Lowest priority, compilation never competes with the UI
+    setpriority(PRIO_PROCESS, 0, 19);
+
+    std::unique_lock<std::mutex> lock(g_state.mutex);
+    while (true) {
+        g_state.cv.wait(lock, [] {
+            return g_state.stop || (!g_state.paused.load(std::memory_order_relaxed) &&
+                                    !g_state.pending.empty());
+        });
+        if (g_state.stop) return;
+
+        const std::string title_id = g_state.pending.front();
+        const std::string cache_dir = g_state.cache_dir;
+        const std::string build_id = g_state.build_id;
+
+        lock.unlock();
+        const RunResult result = CompileTitle(title_id, cache_dir, build_id);
+        lock.lock();
+
+        if (result != RunResult::Paused && !g_state.pending.empty() &&
+            g_state.pending.front() == title_id) {
+            g_state.pending.pop_front();
+        }
+    }
+}
+
+// Called with g_state.mutex held
+void ScheduleLocked(const std::string& title_id) {
+    if (std::find(g_state.pending.begin(), g_state.pending.end(), title_id) == g_state.pending.end()) {
+        g_state.pending.push_back(title_id);
+    }
+    if (!g_state.worker.joinable()) {
+        g_state.stop = false;
+        g_state.worker = std::thread(WorkerLoop);
+    }
+    UpdatePausedLocked();
+}
+
+} // namespace
+
+void SetCacheLocation(const std::string& jit_cache_dir, const std::string& build_id) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    g_state.cache_dir = jit_cache_dir;
+    g_state.build_id = build_id.empty() ? "unknown" : build_id;
+}
+
+std::string GetTitleCacheDir(const std::string& title_id) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    if (g_state.cache_dir.empty()) return {};
+
+    const std::string dir = TitleDir(g_state.cache_dir, title_id);
+    mkdir(g_state.cache_dir.c_str(), 0755);
+    mkdir(dir.c_str(), 0755);
+    return dir;
+}
+
+bool SubmitAnalysedModule(const std::string& title_id, const AnalysedBlock* blocks, size_t count) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    if (g_state.cache_dir.empty()) {
+        LOGE("NBTC: no cache location, dropping analysis of %s", title_id.c_str());
         return false;
     }
-    opts = TfLiteInterpreterOptionsCreate();
-    interp = TfLiteInterpreterCreate(tmodel, opts);
-    if (!interp) {
-        LOGE("NBTC: TfLiteInterpreterCreate failed");
-        TfLiteInterpreterOptionsDelete(opts);
-        TfLiteModelDelete(tmodel);
+
+    const std::string dir = TitleDir(g_state.cache_dir, title_id);
+    mkdir(g_state.cache_dir.c_str(), 0755);
+    mkdir(dir.c_str(), 0755);
+
+    const std::string path = QueuePath(g_state.cache_dir, title_id);
+    const std::string temp_path = path + ".tmp";
+
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        LOGE("NBTC: failed to create %s", temp_path.c_str());
         return false;
     }
-    if (TfLiteInterpreterAllocateTensors(interp) != kTfLiteOk) {
-        LOGE("NBTC: TfLiteInterpreterAllocateTensors failed");
-        TfLiteInterpreterDelete(interp);
-        TfLiteInterpreterOptionsDelete(opts);
-        TfLiteModelDelete(tmodel);
+
+    QueueHeader header = {kQueueMagic, kQueueVersion, 0, 0};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (size_t i = 0; i < count; i++) {
+        const AnalysedBlock& block = blocks[i];
+        if (!block.code || block.size == 0 || block.size > kMaxBlockSize) continue;
+
+        const BlockRecord record = {block.address, block.size};
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        out.write(reinterpret_cast<const char*>(block.code), block.size);
+        header.block_count++;
+    }
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+
+    if (!out || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        LOGE("NBTC: failed to write AOT queue %s", path.c_str());
+        std::remove(temp_path.c_str());
         return false;
     }
-    // Store pointers in file-scope variables so Shutdown can cleanup if needed.
-    s_model = tmodel;
-    s_opts = opts;
-    s_interp = interp;
-    LOGI("NBTC: TFLite model loaded and interpreter allocated");
-    return true;
-#else
-    // No TFLite available; remain in prototype fallback mode.
-    LOGI("NBTC: TFLite not available, running prototype stub.");
-    (void)model_path;
+
+    // New analysis, previous progress no longer describes this queue
+    std::remove(ProgressPath(g_state.cache_dir, title_id).c_str());
+
+    LOGI("NBTC: queued %u analysed blocks for %s", header.block_count, title_id.c_str());
+    ScheduleLocked(title_id);
     return true;
-#endif
-}
-
-bool AnalyzeAndCache(const std::string& game_path) {
-    LOGI("NBTC: AnalyzeAndCache called for %s", game_path.c_str());
-#if defined(HAVE_TFLITE)
-    // If interpreter available, run a minimal inference pass (prototype: zero input)
-    if (s_interp) {
-        LOGI("NBTC: Running TFLite inference for %s", game_path.c_str());
-        TfLiteTensor* input = TfLiteInterpreterGetInputTensor(s_interp, 0);
-        if (!input) {
-            LOGE("NBTC: failed to get input tensor");
-        } else {
-            size_t in_bytes = TfLiteTensorByteSize(input);
-            std::vector<uint8_t> in_buf(in_bytes);
-            // Prototype: fill zeros (real extractor should populate features)
-            if (TfLiteTensorCopyFromBuffer(input, in_buf.data(), in_bytes) != kTfLiteOk) {
-                LOGE("NBTC: TfLiteTensorCopyFromBuffer failed");
-            } else if (TfLiteInterpreterInvoke(s_interp) != kTfLiteOk) {
-                LOGE("NBTC: TfLiteInterpreterInvoke failed");
-            } else {
-                TfLiteTensor* out = TfLiteInterpreterGetOutputTensor(s_interp, 0);
-                if (out) {
-                    size_t out_bytes = TfLiteTensorByteSize(out);
-                    std::vector<uint8_t> out_buf(out_bytes);
-                    if (TfLiteTensorCopyToBuffer(out, out_buf.data(), out_bytes) == kTfLiteOk) {
-                        LOGI("NBTC: inference output size=%zu", out_bytes);
-                    } else {
-                        LOGE("NBTC: TfLiteTensorCopyToBuffer failed");
-                    }
-                } else {
-                    LOGE("NBTC: no output tensor");
-                }
-            }
-        }
-    } else {
-        LOGI("NBTC: interpreter not initialized, skipping TFLite inference");
-    }
-#endif
-    try {
-        std::string marker = game_path + ".nbtc.cache";
-        std::ofstream f(marker, std::ios::binary);
-        f << "nbtc-prototype";
-        f.close();
-        LOGI("NBTC: cache written %s", marker.c_str());
-        return true;
-    } catch (...) {
-        LOGE("NBTC: failed to write cache for %s", game_path.c_str());
+}
+
+bool AnalyzeAndCache(const std::string& title_id) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    if (g_state.cache_dir.empty()) return false;
+
+    QueueHeader header;
+    if (!ReadQueueHeader(QueuePath(g_state.cache_dir, title_id), &header)) {
+        LOGI("NBTC: no install-time analysis for %s", title_id.c_str());
         return false;
     }
+
+    ScheduleLocked(title_id);
+    return true;
 }
 
-bool LoadCacheForGame(const std::string& game_id) {
-    LOGI("NBTC: LoadCacheForGame called for %s", game_id.c_str());
-    // Prototype: check for marker file
-    std::string marker = game_id + ".nbtc.cache";
-    std::ifstream f(marker, std::ios::binary);
-    bool ok = f.good();
-    LOGI("NBTC: cache %s for %s", ok ? "found" : "not found", game_id.c_str());
-    return ok;
+bool LoadCacheForGame(const std::string& title_id) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    if (g_state.cache_dir.empty()) return false;
+
+    QueueHeader header;
+    if (!ReadQueueHeader(QueuePath(g_state.cache_dir, title_id), &header)) return false;
+
+    const Progress progress = ReadProgress(ProgressPath(g_state.cache_dir, title_id));
+    const bool ready = progress.build == g_state.build_id && progress.done >= header.block_count;
+    LOGI("NBTC: AOT bundle for %s %s (%u/%u blocks)", title_id.c_str(),
+         ready ? "ready" : "incomplete", progress.done, header.block_count);
+    return ready;
+}
+
+void SetDeviceCharging(bool charging) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    g_state.charging = charging;
+    UpdatePausedLocked();
+}
+
+void SetEmulationActive(bool active) {
+    std::lock_guard<std::mutex> lock(g_state.mutex);
+    g_state.emulation_active = active;
+    UpdatePausedLocked();
 }
 
 void Shutdown() {
     LOGI("NBTC: Shutdown");
-#if defined(HAVE_TFLITE)
-    if (s_interp) {
-        TfLiteInterpreterDelete(s_interp);
-        s_interp = nullptr;
-    }
-    if (s_opts) {
-        TfLiteInterpreterOptionsDelete(s_opts);
-        s_opts = nullptr;
+    StopCompilePredictor();
+    {
+        std::lock_guard<std::mutex> lock(g_state.mutex);
+        g_state.stop = true;
+        UpdatePausedLocked();
     }
-    if (s_model) {
-        TfLiteModelDelete(s_model);
-        s_model = nullptr;
+    // The compiler stops after the current block, progress is already on disk
+    if (g_state.worker.joinable()) {
+        g_state.worker.join();
     }
-#endif
+    UnloadPredictorModel();
 }
 
 } // namespace nbtc
@@ -1,19 +1,43 @@
-// Lightweight NBTC prototype header
+// NBTC: ahead-of-time tier-2 translation of a title's PPU code
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace nbtc {
 
-// Initialize engine (load model if available). Returns true on success.
+// One basic block found by PPUAnalyser (same layout as ppu_analysed_block in librpcsx)
+struct AnalysedBlock {
+    uint32_t address;
+    uint32_t size;
+    const uint8_t* code;    // Big-endian guest code, valid only during the call
+};
+
+// Initialize engine (load the compile predictor model if available). Returns true on success.
 bool Initialize(const std::string& model_path = "");
 
-// Analyze a game's binary data (path to unpacked game content) and generate cached optimized blocks.
-// This is a best-effort prototype that stores metadata to disk under app-specific cache.
-bool AnalyzeAndCache(const std::string& game_path);
+// Persistent tier-2 cache location, the same directory and build id NCE v8 opens at boot
+void SetCacheLocation(const std::string& jit_cache_dir, const std::string& build_id);
+
+// <jit_cache>/<title>, created on demand; empty while no cache location is set
+std::string GetTitleCacheDir(const std::string& title_id);
+
+// Install-time PPUAnalyser output for a title's main executable. The blocks are
+// copied into the title's AOT queue on disk and compiled in the background.
+bool SubmitAnalysedModule(const std::string& title_id, const AnalysedBlock* blocks, size_t count);
+
+// Schedule (or resume) tier-2 compilation of the title's AOT queue.
+// Returns false if install-time analysis has not produced a queue for it.
+bool AnalyzeAndCache(const std::string& title_id);
+
+// True once every queued block of the title went through the tier-2 compiler;
+// TieredCompilationManager picks the code up from the persistent cache at boot.
+bool LoadCacheForGame(const std::string& title_id);
 
-// Try to load cached optimized binary for given game id/path. Returns true if cache loaded.
-bool LoadCacheForGame(const std::string& game_id);
+// Background compilation only runs while the device is charging and no game is running
+void SetDeviceCharging(bool charging);
+void SetEmulationActive(bool active);
 
 // Shutdown and flush state
 void Shutdown();
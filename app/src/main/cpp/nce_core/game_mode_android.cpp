@@ -3,21 +3,237 @@
 // ============================================================================
 #include "game_mode_android.h"
 #include <android/log.h>
+#include <dlfcn.h>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <mutex>
+#include <type_traits>
+#include <vector>
 
 #define LOG_TAG "GameMode"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
 
 namespace rpcsx {
 namespace android {
 
+// APerformanceHint (API 33) і AThermal_getThermalHeadroom (API 31) шукаємо
+// в libandroid під час виконання, щоб не піднімати minSdk
+struct APerformanceHintManager;
+struct APerformanceHintSession;
+struct AThermalManager;
+
+struct HintApi {
+    APerformanceHintManager* (*getManager)() = nullptr;
+    APerformanceHintSession* (*createSession)(APerformanceHintManager*, const int32_t*, size_t, int64_t) = nullptr;
+    int (*updateTargetWorkDuration)(APerformanceHintSession*, int64_t) = nullptr;
+    int (*reportActualWorkDuration)(APerformanceHintSession*, int64_t) = nullptr;
+    void (*closeSession)(APerformanceHintSession*) = nullptr;
+    int (*setThreads)(APerformanceHintSession*, const int32_t*, size_t) = nullptr;  // API 34
+
+    AThermalManager* (*acquireThermal)() = nullptr;
+    float (*getThermalHeadroom)(AThermalManager*, int) = nullptr;
+};
+
+static constexpr int64_t kHeadroomIntervalNs = 1000000000;
+// Бюджет починає знижуватись з цього прогнозу і досягає мінімуму на 1.0
+static constexpr float kHeadroomSoftLimit = 0.85f;
+static constexpr float kMinThermalBudget = 0.75f;
+
+static std::once_flag g_api_once;
+static HintApi g_api;
+
+static std::mutex g_mutex;
+static APerformanceHintManager* g_hint_manager = nullptr;
+static APerformanceHintSession* g_session = nullptr;
+static std::vector<int32_t> g_session_tids;
+static int64_t g_target_work_ns = 0;
+
+static AThermalManager* g_thermal_manager = nullptr;
+static int64_t g_headroom_time_ns = 0;
+static float g_headroom = NAN;
+static float g_thermal_budget = 1.0f;
+
+static int64_t MonotonicNanos() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static void LoadApi() {
+    void* libandroid = dlopen("libandroid.so", RTLD_NOW | RTLD_NOLOAD);
+    if (!libandroid) {
+        libandroid = dlopen("libandroid.so", RTLD_NOW);
+    }
+    if (!libandroid) {
+        return;
+    }
+
+    auto load = [&](auto& fn, const char* name) {
+        fn = reinterpret_cast<std::remove_reference_t<decltype(fn)>>(dlsym(libandroid, name));
+    };
+
+    load(g_api.getManager, "APerformanceHint_getManager");
+    load(g_api.createSession, "APerformanceHint_createSession");
+    load(g_api.updateTargetWorkDuration, "APerformanceHint_updateTargetWorkDuration");
+    load(g_api.reportActualWorkDuration, "APerformanceHint_reportActualWorkDuration");
+    load(g_api.closeSession, "APerformanceHint_closeSession");
+    load(g_api.setThreads, "APerformanceHint_setThreads");
+    load(g_api.acquireThermal, "AThermal_acquireManager");
+    load(g_api.getThermalHeadroom, "AThermal_getThermalHeadroom");
+
+    if (!g_api.getManager || !g_api.createSession || !g_api.reportActualWorkDuration ||
+        !g_api.updateTargetWorkDuration || !g_api.closeSession) {
+        g_api.getManager = nullptr;
+        LOGW("APerformanceHint API unavailable");
+    }
+    if (!g_api.acquireThermal || !g_api.getThermalHeadroom) {
+        g_api.getThermalHeadroom = nullptr;
+        LOGW("AThermal headroom API unavailable");
+    }
+}
+
+static void CloseSessionLocked() {
+    if (g_session) {
+        g_api.closeSession(g_session);
+        g_session = nullptr;
+        LOGI("ADPF session closed");
+    }
+    g_session_tids.clear();
+    g_target_work_ns = 0;
+}
+
 void EnableGameMode() {
     // TODO: Використати Android Game Mode API (NDK/Java)
+    std::call_once(g_api_once, LoadApi);
     LOGI("Enable Game Mode (Performance Mode)");
 }
 
 void DisableGameMode() {
+    ClosePerformanceHintSession();
     LOGI("Disable Game Mode");
 }
 
+bool UpdatePerformanceHintThreads(const int32_t* tids, size_t count, int64_t target_work_ns) {
+    std::call_once(g_api_once, LoadApi);
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    if (!g_api.getManager) {
+        return false;
+    }
+
+    if (count == 0) {
+        CloseSessionLocked();
+        return false;
+    }
+
+    std::vector<int32_t> sorted(tids, tids + count);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    if (g_session && sorted == g_session_tids) {
+        return true;
+    }
+
+    // setThreads (API 34) зберігає історію сесії, інакше - нова сесія
+    if (g_session && g_api.setThreads &&
+        g_api.setThreads(g_session, sorted.data(), sorted.size()) == 0) {
+        g_session_tids = std::move(sorted);
+        return true;
+    }
+
+    CloseSessionLocked();
+
+    if (!g_hint_manager) {
+        g_hint_manager = g_api.getManager();
+    }
+    if (!g_hint_manager) {
+        return false;
+    }
+
+    g_session = g_api.createSession(g_hint_manager, sorted.data(), sorted.size(), target_work_ns);
+    if (!g_session) {
+        LOGW("APerformanceHint_createSession failed for %zu threads", sorted.size());
+        return false;
+    }
+
+    g_session_tids = std::move(sorted);
+    g_target_work_ns = target_work_ns;
+    LOGI("ADPF session: %zu threads, target %.2f ms", g_session_tids.size(),
+         target_work_ns / 1000000.0);
+    return true;
+}
+
+void ReportFrameWorkDuration(int64_t actual_work_ns, int64_t target_work_ns) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    if (!g_session || actual_work_ns <= 0) {
+        return;
+    }
+
+    if (target_work_ns > 0 && target_work_ns != g_target_work_ns) {
+        g_api.updateTargetWorkDuration(g_session, target_work_ns);
+        g_target_work_ns = target_work_ns;
+    }
+
+    g_api.reportActualWorkDuration(g_session, actual_work_ns);
+}
+
+void ClosePerformanceHintSession() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    CloseSessionLocked();
+}
+
+bool IsPerformanceHintActive() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_session != nullptr;
+}
+
+float GetThermalHeadroom(int forecast_seconds) {
+    std::call_once(g_api_once, LoadApi);
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    if (!g_api.getThermalHeadroom) {
+        return NAN;
+    }
+
+    const int64_t now = MonotonicNanos();
+    if (g_headroom_time_ns != 0 && now - g_headroom_time_ns < kHeadroomIntervalNs) {
+        return g_headroom;
+    }
+    g_headroom_time_ns = now;
+
+    if (!g_thermal_manager) {
+        g_thermal_manager = g_api.acquireThermal();
+    }
+    if (!g_thermal_manager) {
+        return NAN;
+    }
+
+    // NaN - датчики ще не готові або запит зарано; лишаємо попередній бюджет
+    const float headroom = g_api.getThermalHeadroom(g_thermal_manager, forecast_seconds);
+    g_headroom = headroom;
+
+    if (!std::isnan(headroom)) {
+        const float over = std::clamp((headroom - kHeadroomSoftLimit) / (1.0f - kHeadroomSoftLimit), 0.0f, 1.0f);
+        const float budget = 1.0f - over * (1.0f - kMinThermalBudget);
+        if (std::abs(budget - g_thermal_budget) > 0.05f) {
+            LOGI("Thermal headroom %.2f in %d s: DRS budget %.0f%%", headroom, forecast_seconds,
+                 budget * 100);
+        }
+        g_thermal_budget = budget;
+    }
+
+    return headroom;
+}
+
+float GetThermalWorkBudget() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_thermal_budget;
+}
+
 } // namespace android
 } // namespace rpcsx
@@ -3,14 +3,43 @@
 // ============================================================================
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace rpcsx {
 namespace android {
 
 // Enable Game Mode / Performance Mode (if supported)
 void EnableGameMode();
 
-// Disable Game Mode
+// Disable Game Mode (закриває і ADPF сесію)
 void DisableGameMode();
 
+// ============================================================================
+// ADPF (APerformanceHint, API 33) - підтримуваний шлях до стабільних частот
+// замість запису в cpufreq governor (потребує root)
+// ============================================================================
+
+// Сесія для гарячих потоків (kernel tid); повторний виклик замінює набір потоків
+bool UpdatePerformanceHintThreads(const int32_t* tids, size_t count, int64_t target_work_ns);
+
+// Фактична тривалість роботи кадру проти цільової (викликається раз на кадр)
+void ReportFrameWorkDuration(int64_t actual_work_ns, int64_t target_work_ns);
+
+void ClosePerformanceHintSession();
+bool IsPerformanceHintActive();
+
+// ============================================================================
+// Thermal headroom (AThermal, API 31)
+// ============================================================================
+
+// Прогноз через forecast_seconds: 1.0 - початок троттлінгу; NaN без API.
+// Система обмежує частоту запитів, тому значення кешується на секунду
+float GetThermalHeadroom(int forecast_seconds);
+
+// Частка GPU бюджету для DRS (0.75-1.0): знижується заздалегідь, коли прогноз
+// наближається до троттлінгу, щоб не впертися в thermal cliff
+float GetThermalWorkBudget();
+
 } // namespace android
 } // namespace rpcsx
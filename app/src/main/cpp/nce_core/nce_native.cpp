@@ -10,12 +10,14 @@
 
 #include "rsx_emulator.h"
 #include "shader_cache_manager.h"
+#include "nce_v8/nce_v8.h"
 
 #include <android/log.h>
 #include <sys/mman.h>
 #include <sys/auxv.h>
 #include <signal.h>
 #include <ucontext.h>
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 
@@ -604,10 +606,13 @@ bool NativeCodeExecutor::Initialize(const NCEConfig& config) {
         return false;
     }
     
-    // Thread pool: 4 потоки (можна зробити динамічно)
-    thread_pool_ = std::make_unique<util::ThreadPool>(4);
+    // Thread pool: по worker'у на ядро, lanes розділяють JIT / shaders / streaming
+    thread_pool_ = std::make_unique<util::ThreadPool>(
+        std::max(4u, std::thread::hardware_concurrency()));
     // Передаємо thread pool у shader cache
     rpcsx::shaders::SetThreadPool(thread_pool_.get());
+    // ... і в NCE v8 (LLVM tier-3 на BackgroundCompile lane)
+    rpcsx::nce::v8::SetCompileThreadPool(thread_pool_.get());
 
     // Game Mode (Android)
     game_mode_enabled_ = true;
@@ -639,6 +644,7 @@ void NativeCodeExecutor::Shutdown() {
     }
 
     // Thread pool
+    rpcsx::nce::v8::SetCompileThreadPool(nullptr);
     thread_pool_.reset();
 
     // Game Mode
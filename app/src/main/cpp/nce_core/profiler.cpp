@@ -3,30 +3,267 @@
 // ============================================================================
 #include "profiler.h"
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
 namespace rpcsx {
 namespace util {
 
-void Profiler::Start(const std::string& name) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    entries_[name].start = std::chrono::high_resolution_clock::now();
+namespace {
+
+struct Totals {
+    uint64_t ticks = 0;
+    uint64_t count = 0;
+};
+
+// (instance, parent, id) packed into one key
+inline uint64_t TotalsKey(uint32_t instance, uint16_t parent, uint16_t id) {
+    return (static_cast<uint64_t>(instance) << 32) | (static_cast<uint64_t>(parent) << 16) | id;
 }
 
-void Profiler::Stop(const std::string& name) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto now = std::chrono::high_resolution_clock::now();
-    auto& entry = entries_[name];
-    entry.elapsed += std::chrono::duration<double>(now - entry.start).count();
+double TicksToSeconds(uint64_t ticks) {
+#if defined(__aarch64__)
+    static const double period = [] {
+        uint64_t freq;
+        __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+        return freq ? 1.0 / static_cast<double>(freq) : 0.0;
+    }();
+    return static_cast<double>(ticks) * period;
+#else
+    return static_cast<double>(ticks) * 1e-9;
+#endif
 }
 
-double Profiler::GetElapsed(const std::string& name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = entries_.find(name);
-    return (it != entries_.end()) ? it->second.elapsed : 0.0;
+class Aggregator {
+public:
+    static constexpr auto kInterval = std::chrono::milliseconds(10);
+
+    static Aggregator& Get() {
+        static Aggregator instance;
+        return instance;
+    }
+
+    ~Aggregator() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    uint16_t Register(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(std::string(name));
+        if (it != ids_.end()) return it->second;
+
+        const auto id = static_cast<uint16_t>(names_.size());
+        names_.emplace_back(name);
+        ids_.emplace(names_.back(), id);
+        return id;
+    }
+
+    void Attach(std::shared_ptr<detail::ProfileThread> thread) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        threads_.push_back(std::move(thread));
+        if (!thread_.joinable()) thread_ = std::thread([this] { Run(); });
+    }
+
+    // Everything below runs with mutex_ held, draining the rings is only
+    // done under it so each ring keeps a single consumer
+    std::unique_lock<std::mutex> Lock() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        DrainLocked();
+        return lock;
+    }
+
+    std::unordered_map<uint64_t, Totals>& totals() { return totals_; }
+    std::string_view Name(uint16_t id) const { return names_[id]; }
+
+    bool FindId(std::string_view name, uint16_t& id) const {
+        auto it = ids_.find(std::string(name));
+        if (it == ids_.end()) return false;
+        id = it->second;
+        return true;
+    }
+
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    Aggregator() { names_.emplace_back(); }
+
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            cv_.wait_for(lock, kInterval);
+            DrainLocked();
+        }
+    }
+
+    void DrainLocked() {
+        for (auto it = threads_.begin(); it != threads_.end();) {
+            auto& thread = **it;
+            const bool retired = thread.retired.load(std::memory_order_acquire);
+            const size_t head = thread.head.load(std::memory_order_acquire);
+            size_t tail = thread.tail.load(std::memory_order_relaxed);
+
+            for (; tail != head; ++tail) {
+                const auto& sample = thread.ring[tail % detail::ProfileThread::kRingSize];
+                auto& totals = totals_[TotalsKey(sample.instance, sample.parent, sample.id)];
+                totals.ticks += sample.ticks;
+                totals.count += sample.count;
+            }
+
+            thread.tail.store(tail, std::memory_order_release);
+            dropped_ += thread.dropped.exchange(0, std::memory_order_relaxed);
+
+            it = retired ? threads_.erase(it) : it + 1;
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    bool stop_ = false;
+
+    std::deque<std::string> names_; // indexed by id, stable for string_views
+    std::unordered_map<std::string, uint16_t> ids_;
+    std::vector<std::shared_ptr<detail::ProfileThread>> threads_;
+    std::unordered_map<uint64_t, Totals> totals_;
+    uint64_t dropped_ = 0;
+};
+
+// Keeps the ring of a thread alive until the aggregator has drained it
+struct ThreadGuard {
+    std::shared_ptr<detail::ProfileThread> thread;
+
+    ~ThreadGuard() {
+        if (!thread) return;
+        thread->PublishAll();
+        thread->retired.store(true, std::memory_order_release);
+        detail::t_profile_thread = nullptr;
+    }
+};
+
+std::atomic<uint32_t> g_next_instance{1};
+
+} // namespace
+
+uint16_t RegisterProfileScope(std::string_view name) {
+    return Aggregator::Get().Register(name);
+}
+
+namespace detail {
+
+void ProfileThread::Publish(ProfileSample& sample) {
+    if (sample.count == 0) return;
+
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= kRingSize) {
+        dropped.fetch_add(sample.count, std::memory_order_relaxed);
+    } else {
+        ring[h % kRingSize] = sample;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    sample.count = 0;
+}
+
+void ProfileThread::PublishAll() {
+    for (auto& sample : merge) Publish(sample);
+}
+
+ProfileThread* AttachProfileThread() {
+    thread_local ThreadGuard guard;
+
+    if (!guard.thread) {
+        guard.thread = std::make_shared<ProfileThread>();
+        Aggregator::Get().Attach(guard.thread);
+    }
+
+    t_profile_thread = guard.thread.get();
+    return t_profile_thread;
+}
+
+} // namespace detail
+
+Profiler::Profiler() : instance_(g_next_instance.fetch_add(1, std::memory_order_relaxed)) {}
+
+Profiler::~Profiler() {
+    auto& aggregator = Aggregator::Get();
+    auto lock = aggregator.Lock();
+    auto& totals = aggregator.totals();
+
+    for (auto it = totals.begin(); it != totals.end();) {
+        it = (it->first >> 32) == instance_ ? totals.erase(it) : std::next(it);
+    }
+}
+
+double Profiler::GetElapsed(std::string_view name) const {
+    auto& aggregator = Aggregator::Get();
+    auto lock = aggregator.Lock();
+    uint16_t id;
+    if (!aggregator.FindId(name, id)) return 0.0;
+
+    uint64_t ticks = 0;
+    for (const auto& [key, totals] : aggregator.totals()) {
+        if ((key >> 32) == instance_ && static_cast<uint16_t>(key) == id) ticks += totals.ticks;
+    }
+
+    return TicksToSeconds(ticks);
+}
+
+uint64_t Profiler::GetCount(std::string_view name) const {
+    auto& aggregator = Aggregator::Get();
+    auto lock = aggregator.Lock();
+    uint16_t id;
+    if (!aggregator.FindId(name, id)) return 0;
+
+    uint64_t count = 0;
+    for (const auto& [key, totals] : aggregator.totals()) {
+        if ((key >> 32) == instance_ && static_cast<uint16_t>(key) == id) count += totals.count;
+    }
+
+    return count;
+}
+
+void Profiler::Reset(std::string_view name) {
+    auto& aggregator = Aggregator::Get();
+    auto lock = aggregator.Lock();
+    uint16_t id;
+    if (!aggregator.FindId(name, id)) return;
+
+    auto& totals = aggregator.totals();
+    for (auto it = totals.begin(); it != totals.end();) {
+        const bool match = (it->first >> 32) == instance_ && static_cast<uint16_t>(it->first) == id;
+        it = match ? totals.erase(it) : std::next(it);
+    }
+}
+
+std::vector<Profiler::Node> Profiler::Snapshot() const {
+    auto& aggregator = Aggregator::Get();
+    auto lock = aggregator.Lock();
+
+    std::vector<Node> nodes;
+    for (const auto& [key, totals] : aggregator.totals()) {
+        if ((key >> 32) != instance_) continue;
+
+        nodes.push_back({aggregator.Name(static_cast<uint16_t>(key >> 16)), aggregator.Name(static_cast<uint16_t>(key)),
+                         totals.count, TicksToSeconds(totals.ticks)});
+    }
+
+    return nodes;
 }
 
-void Profiler::Reset(const std::string& name) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    entries_[name].elapsed = 0.0;
+uint64_t Profiler::GetDropped() {
+    auto& aggregator = Aggregator::Get();
+    auto lock = aggregator.Lock();
+    return aggregator.dropped();
 }
 
 } // namespace util
@@ -1,31 +1,168 @@
 // ============================================================================
 // Profiler (Timing, counters, hot-spot detection)
 // ============================================================================
+// Scopes are named by string literals which are turned into small ids once,
+// at static init. Finished scopes are merged in a small per-thread table
+// (one slot per scope and enclosing scope) and flushed to a single-producer
+// ring per thread, which a background aggregator drains into per-profiler
+// totals. Recording a scope is two counter reads and a few thread-local
+// stores: no locks, no allocations, no string hashing.
+// ============================================================================
 #pragma once
 
+#include <atomic>
 #include <chrono>
-#include <string>
-#include <unordered_map>
-#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
 
 namespace rpcsx {
 namespace util {
 
+// Raw timestamp: the virtual counter on AArch64 (as rx::get_tsc does),
+// steady clock nanoseconds elsewhere
+inline uint64_t ProfilerTicks() {
+#if defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// String literal usable as a template argument
+template <size_t N>
+struct ProfileName {
+    char value[N];
+
+    constexpr ProfileName(const char (&str)[N]) {
+        for (size_t i = 0; i < N; ++i) value[i] = str[i];
+    }
+};
+
+// Returns the id of a scope name, registering it on first use. Id 0 is the
+// root (no enclosing scope)
+uint16_t RegisterProfileScope(std::string_view name);
+
+template <ProfileName Name>
+inline const uint16_t kProfileScopeId = RegisterProfileScope(Name.value);
+
+namespace detail {
+
+struct ProfileSample {
+    uint64_t ticks;
+    uint32_t instance;
+    uint32_t count;
+    uint16_t id;
+    uint16_t parent;
+};
+
+struct ProfileThread {
+    static constexpr size_t kRingSize = 1024;
+    static constexpr size_t kMergeSlots = 64;
+    // Merged samples are published at least this often so totals keep moving
+    // while a thread stays in the same scopes
+    static constexpr uint32_t kMergeLimit = 4096;
+
+    ProfileSample ring[kRingSize];
+    std::atomic<size_t> head{0}; // written by the owning thread
+    std::atomic<size_t> tail{0}; // written by the aggregator
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};
+
+    ProfileSample merge[kMergeSlots]{};
+    uint16_t current = 0; // innermost open scope
+
+    void Publish(ProfileSample& sample);
+    void PublishAll();
+
+    void Record(uint32_t instance, uint16_t id, uint16_t parent, uint64_t ticks) {
+        ProfileSample& slot = merge[(id * 7u + parent + instance * 13u) % kMergeSlots];
+
+        if (slot.count != 0 && slot.id == id && slot.parent == parent && slot.instance == instance) {
+            slot.ticks += ticks;
+            if (++slot.count >= kMergeLimit) Publish(slot);
+            return;
+        }
+
+        Publish(slot);
+        slot = {ticks, instance, 1, id, parent};
+    }
+};
+
+inline thread_local ProfileThread* t_profile_thread = nullptr;
+
+ProfileThread* AttachProfileThread();
+
+} // namespace detail
+
 class Profiler {
 public:
-    void Start(const std::string& name);
-    void Stop(const std::string& name);
-    double GetElapsed(const std::string& name) const;
-    void Reset(const std::string& name);
+    Profiler();
+    ~Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
 
-private:
-    struct Entry {
-        std::chrono::high_resolution_clock::time_point start;
-        double elapsed = 0.0;
+    // Times the enclosing block, use RPCSX_PROFILE_SCOPE
+    class Scope {
+    public:
+        Scope(const Profiler& profiler, uint16_t id)
+            : instance_(profiler.instance_), id_(id) {
+            thread_ = detail::t_profile_thread;
+            if (!thread_) thread_ = detail::AttachProfileThread();
+
+            parent_ = thread_->current;
+            thread_->current = id;
+            start_ = ProfilerTicks();
+        }
+
+        ~Scope() {
+            const uint64_t end = ProfilerTicks();
+            thread_->current = parent_;
+            thread_->Record(instance_, id_, parent_, end - start_);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        detail::ProfileThread* thread_;
+        uint64_t start_;
+        uint32_t instance_;
+        uint16_t id_;
+        uint16_t parent_;
     };
-    mutable std::mutex mutex_;
-    std::unordered_map<std::string, Entry> entries_;
+
+    struct Node {
+        std::string_view parent; // empty for a top level scope
+        std::string_view name;
+        uint64_t count;
+        double elapsed;
+    };
+
+    // Totals lag behind by at most kMergeLimit samples per thread
+    double GetElapsed(std::string_view name) const; // seconds, nested scopes included
+    uint64_t GetCount(std::string_view name) const;
+    void Reset(std::string_view name);
+
+    // Call tree, one node per (enclosing scope, scope) pair
+    std::vector<Node> Snapshot() const;
+
+    // Samples lost to full rings, across all profilers
+    static uint64_t GetDropped();
+
+private:
+    uint32_t instance_;
 };
 
 } // namespace util
 } // namespace rpcsx
+
+#define RPCSX_PROFILE_CONCAT_(a, b) a##b
+#define RPCSX_PROFILE_CONCAT(a, b) RPCSX_PROFILE_CONCAT_(a, b)
+#define RPCSX_PROFILE_SCOPE(profiler, name)                                        \
+    ::rpcsx::util::Profiler::Scope RPCSX_PROFILE_CONCAT(rpcsx_profile_scope_, __LINE__)( \
+        (profiler), ::rpcsx::util::kProfileScopeId<name>)
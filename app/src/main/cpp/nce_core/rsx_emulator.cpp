@@ -649,8 +649,8 @@ void RSXEmulator::Flip(uint32_t buffer_id) {
 void RSXEmulator::Run() {
     running_ = true;
     LOGI("RSX: Starting execution");
-        profiler_.Start("RSX_Run");
-    
+    RPCSX_PROFILE_SCOPE(profiler_, "RSX_Run");
+
     backend_.BeginFrame();
     
     while (running_) {
@@ -659,7 +659,6 @@ void RSXEmulator::Run() {
         }
         // In real emulator: sync with VSync or sleep
     }
-        profiler_.Stop("RSX_Run");
 }
 
 void RSXEmulator::Stop() {
@@ -45,7 +45,7 @@ void SPUInterpreter::Shutdown() {
 // Execution
 // ============================================================================
 void SPUInterpreter::Step(SPUState& state) {
-    profiler_.Start("SPU_Step");
+    RPCSX_PROFILE_SCOPE(profiler_, "SPU_Step");
     // Fetch instruction from Local Store (Big Endian)
     uint32_t* ls = reinterpret_cast<uint32_t*>(state.local_store + state.pc);
     uint32_t inst_raw = __builtin_bswap32(*ls);
@@ -53,19 +53,17 @@ void SPUInterpreter::Step(SPUState& state) {
     state.npc = state.pc + 4;
     ExecuteInstruction(state, inst);
     state.pc = state.npc;
-    profiler_.Stop("SPU_Step");
 }
 
 void SPUInterpreter::Execute(SPUState& state, uint64_t count) {
-    profiler_.Start("SPU_Execute");
+    RPCSX_PROFILE_SCOPE(profiler_, "SPU_Execute");
     for (uint64_t i = 0; i < count && state.running && !state.stop; ++i) {
         Step(state);
     }
-    profiler_.Stop("SPU_Execute");
 }
 
 void SPUInterpreter::Run(SPUState& state) {
-    profiler_.Start("SPU_Run");
+    RPCSX_PROFILE_SCOPE(profiler_, "SPU_Run");
     state.running = true;
     state.stop = false;
     LOGI("SPU %d starting execution at PC=0x%08x", state.spu_id, state.pc);
@@ -74,7 +72,6 @@ void SPUInterpreter::Run(SPUState& state) {
         ProcessMFCQueue(state);  // Process DMA
     }
     LOGI("SPU %d stopped at PC=0x%08x", state.spu_id, state.pc);
-    profiler_.Stop("SPU_Run");
 }
 
 void SPUInterpreter::RunInThread(SPUState& state) {
@@ -263,6 +260,7 @@ void SPUInterpreter::STQD(SPUState& state, SPUInstruction inst) {
     for (int i = 0; i < 16; i++) tmp[i] = state.gpr[rt].u8[15 - i];
     rpcsx::simd::memcpy_simd(dst, tmp, 16);
 #endif
+    state.ls_writes.MarkQuadword(addr);
 }
 
 void SPUInterpreter::STQX(SPUState& state, SPUInstruction inst) {
@@ -283,6 +281,7 @@ void SPUInterpreter::STQX(SPUState& state, SPUInstruction inst) {
     for (int i = 0; i < 16; i++) tmp[i] = state.gpr[rt].u8[15 - i];
     rpcsx::simd::memcpy_simd(dst, tmp, 16);
 #endif
+    state.ls_writes.MarkQuadword(addr);
 }
 
 // ============================================================================
@@ -747,6 +746,7 @@ void SPUInterpreter::ProcessMFCQueue(SPUState& state) {
         switch (cmd.cmd & 0xFF) {
             case 0x20: // GET - DMA from main memory to LS
                 rpcsx::simd::memcpy_simd(ls, ea, cmd.size);
+                state.ls_writes.MarkRange(cmd.lsa, cmd.size);
                 break;
             case 0x24: // PUT - DMA from LS to main memory
                 rpcsx::simd::memcpy_simd(ea, ls, cmd.size);
@@ -856,6 +856,7 @@ void SPUThreadGroup::LoadProgram(uint32_t spu_id, const void* program, size_t si
     
     size_t copy_size = std::min(size, static_cast<size_t>(256 * 1024));
     rpcsx::simd::memcpy_simd(states_[spu_id].local_store, program, copy_size);
+    states_[spu_id].ls_writes.MarkRange(0, static_cast<uint32_t>(copy_size));
     states_[spu_id].pc = entry & 0x3FFFC;
     
     LOGI("SPU %d: Loaded %zu bytes, entry=0x%08x", spu_id, copy_size, entry);
@@ -10,6 +10,7 @@
 #include <vector>
 #include <arm_neon.h>  // ARM NEON для 128-bit SIMD
 #include "profiler.h"
+#include "spu_ls_tracker.h"
 
 namespace rpcsx {
 namespace spu {
@@ -58,6 +59,7 @@ struct SPUState {
     // Local Store Address (256KB per SPU)
     uint8_t* local_store;
     uint32_t ls_size;
+    LSWriteTracker ls_writes;  // інвалідація SPU JIT блоків
     
     // DMA/MFC state
     struct MFCCommand {
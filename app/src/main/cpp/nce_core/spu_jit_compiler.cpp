@@ -1,9 +1,22 @@
 // ============================================================================
 // SPU JIT Compiler Implementation (Cell SPU → ARM64 NEON/SVE2)
 // ============================================================================
+// SPU регістр рівно 128 біт, тому мапимо його на NEON Q регістр, а не на SVE
+// Z (VL може бути > 128 і predication тут нічого не дає). Per-block
+// register allocation: GPR з >= 2 зверненнями в блоці живуть у V16-V31, потім
+// V8-V15 (callee-saved нижні 64 біти - зберігаємо D8-D15). Решта - через
+// scratch V0-V7 з негайним store назад у gpr128.
+//
+// Host регістри:
+//   X0 = gpr128 (SPUState::gpr), X1 = local store, X2 = LSWriteTracker::gen
+//   X3 = LS адреса квадрослова, W9 = next PC
+//   V0/V1 = пара таблиць для tbl (shufb), V2-V7 = scratch, V3 = результат
+// ============================================================================
 #include "spu_jit_compiler.h"
 #include <sys/mman.h>
 #include <cstring>
+#include <algorithm>
+#include <array>
 #include <android/log.h>
 
 #define LOG_TAG "SPU-JIT"
@@ -13,6 +26,553 @@
 namespace rpcsx {
 namespace spu {
 
+namespace {
+
+// ----------------------------------------------------------------------------
+// Decoder (raw = big-endian слово з LS, вже byte-swapped)
+// ----------------------------------------------------------------------------
+enum class Op : uint8_t {
+    Invalid,
+    Nop,
+    // RRR
+    SELB, SHUFB, FMA, FNMS, FMS,
+    // RR
+    A, AH, SF, SFH, AND, OR, XOR, ANDC, ORC, NAND, NOR, EQV,
+    CEQ, CEQH, CEQB, CGT, CGTH, CGTB, CLGT,
+    FA, FS, FM,
+    ROTQBY, ROTQBYI, LQX, STQX, BI,
+    // RI10
+    AI, AHI, ANDI, ORI, XORI, LQD, STQD,
+    // RI16 / RI18
+    IL, ILHU, IOHL, ILA, LQA, STQA, BR, BRZ, BRNZ,
+};
+
+struct Inst {
+    Op op = Op::Invalid;
+    uint8_t rt = 0, ra = 0, rb = 0, rc = 0;
+    int32_t imm = 0;
+};
+
+inline int32_t SignExtend(uint32_t value, int bits) {
+    const uint32_t shift = 32 - bits;
+    return static_cast<int32_t>(value << shift) >> shift;
+}
+
+Inst Decode(uint32_t raw) {
+    Inst in;
+    in.rt = raw & 0x7F;
+    in.ra = (raw >> 7) & 0x7F;
+    in.rb = (raw >> 14) & 0x7F;
+
+    switch (raw >> 28) {
+    case 0x8: case 0xB: case 0xC: case 0xD: case 0xE: case 0xF:
+        // RRR: target - біти 21..27, третій операнд - 0..6
+        in.rc = raw & 0x7F;
+        in.rt = (raw >> 21) & 0x7F;
+        switch (raw >> 28) {
+        case 0x8: in.op = Op::SELB; break;
+        case 0xB: in.op = Op::SHUFB; break;
+        case 0xD: in.op = Op::FNMS; break;
+        case 0xE: in.op = Op::FMA; break;
+        case 0xF: in.op = Op::FMS; break;
+        default: break; // MPYA
+        }
+        return in;
+    default:
+        break;
+    }
+
+    switch (raw >> 25) {
+    case 0x21: in.op = Op::ILA; in.imm = (raw >> 7) & 0x3FFFF; return in;
+    case 0x08: case 0x09: in.op = Op::Nop; return in; // HBRA / HBRR
+    default: break;
+    }
+
+    const int32_t i10 = SignExtend((raw >> 14) & 0x3FF, 10);
+    switch (raw >> 24) {
+    case 0x1C: in.op = Op::AI; in.imm = i10; return in;
+    case 0x1D: in.op = Op::AHI; in.imm = i10; return in;
+    case 0x14: in.op = Op::ANDI; in.imm = i10; return in;
+    case 0x04: in.op = Op::ORI; in.imm = i10; return in;
+    case 0x44: in.op = Op::XORI; in.imm = i10; return in;
+    case 0x34: in.op = Op::LQD; in.imm = i10 << 4; return in;
+    case 0x24: in.op = Op::STQD; in.imm = i10 << 4; return in;
+    default: break;
+    }
+
+    const uint32_t i16 = (raw >> 7) & 0xFFFF;
+    switch (raw >> 23) {
+    case 0x40: in.op = Op::BRZ; in.imm = SignExtend(i16, 16) << 2; return in;
+    case 0x42: in.op = Op::BRNZ; in.imm = SignExtend(i16, 16) << 2; return in;
+    case 0x64: in.op = Op::BR; in.imm = SignExtend(i16, 16) << 2; return in;
+    case 0x61: in.op = Op::LQA; in.imm = SignExtend(i16, 16) << 2; return in;
+    case 0x41: in.op = Op::STQA; in.imm = SignExtend(i16, 16) << 2; return in;
+    case 0x81: in.op = Op::IL; in.imm = SignExtend(i16, 16); return in;
+    case 0x82: in.op = Op::ILHU; in.imm = static_cast<int32_t>(i16 << 16); return in;
+    case 0xC1: in.op = Op::IOHL; in.imm = i16; return in;
+    default: break;
+    }
+
+    switch (raw >> 21) {
+    case 0x001: case 0x201: case 0x1AC: in.op = Op::Nop; break; // LNOP / NOP / HBR
+    case 0x0C0: in.op = Op::A; break;
+    case 0x0C8: in.op = Op::AH; break;
+    case 0x040: in.op = Op::SF; break;
+    case 0x048: in.op = Op::SFH; break;
+    case 0x0C1: in.op = Op::AND; break;
+    case 0x041: in.op = Op::OR; break;
+    case 0x241: in.op = Op::XOR; break;
+    case 0x2C1: in.op = Op::ANDC; break;
+    case 0x2C9: in.op = Op::ORC; break;
+    case 0x0C9: in.op = Op::NAND; break;
+    case 0x049: in.op = Op::NOR; break;
+    case 0x249: in.op = Op::EQV; break;
+    case 0x3C0: in.op = Op::CEQ; break;
+    case 0x3C8: in.op = Op::CEQH; break;
+    case 0x3D0: in.op = Op::CEQB; break;
+    case 0x240: in.op = Op::CGT; break;
+    case 0x248: in.op = Op::CGTH; break;
+    case 0x250: in.op = Op::CGTB; break;
+    case 0x2C0: in.op = Op::CLGT; break;
+    case 0x2C4: in.op = Op::FA; break;
+    case 0x2C5: in.op = Op::FS; break;
+    case 0x2C6: in.op = Op::FM; break;
+    case 0x1DC: in.op = Op::ROTQBY; break;
+    case 0x1FC: in.op = Op::ROTQBYI; in.imm = in.rb & 0xF; break; // I7 на місці rb
+    case 0x1C4: in.op = Op::LQX; break;
+    case 0x144: in.op = Op::STQX; break;
+    case 0x1A8: in.op = Op::BI; break;
+    default: break;
+    }
+    return in;
+}
+
+bool IsBranch(Op op) {
+    return op == Op::BR || op == Op::BRZ || op == Op::BRNZ || op == Op::BI;
+}
+
+// Операнди: до 3 читань і 1 запис (kNoReg = немає)
+constexpr uint8_t kNoReg = 0xFF;
+
+struct Operands {
+    uint8_t reads[3] = {kNoReg, kNoReg, kNoReg};
+    uint8_t write = kNoReg;
+};
+
+Operands GetOperands(const Inst& in) {
+    Operands o;
+    switch (in.op) {
+    case Op::SELB: case Op::SHUFB: case Op::FMA: case Op::FNMS: case Op::FMS:
+        o.reads[0] = in.ra; o.reads[1] = in.rb; o.reads[2] = in.rc; o.write = in.rt;
+        break;
+    case Op::ROTQBYI: case Op::AI: case Op::AHI: case Op::ANDI: case Op::ORI:
+    case Op::XORI: case Op::LQD:
+        o.reads[0] = in.ra; o.write = in.rt;
+        break;
+    case Op::LQX:
+        o.reads[0] = in.ra; o.reads[1] = in.rb; o.write = in.rt;
+        break;
+    case Op::STQD:
+        o.reads[0] = in.ra; o.reads[1] = in.rt;
+        break;
+    case Op::STQX:
+        o.reads[0] = in.ra; o.reads[1] = in.rb; o.reads[2] = in.rt;
+        break;
+    case Op::STQA: case Op::BRZ: case Op::BRNZ:
+        o.reads[0] = in.rt;
+        break;
+    case Op::BI:
+        o.reads[0] = in.ra;
+        break;
+    case Op::IOHL:
+        o.reads[0] = in.rt; o.write = in.rt;
+        break;
+    case Op::IL: case Op::ILHU: case Op::ILA: case Op::LQA:
+        o.write = in.rt;
+        break;
+    case Op::Nop: case Op::BR: case Op::Invalid:
+        break;
+    default: // RR: rt = f(ra, rb)
+        o.reads[0] = in.ra; o.reads[1] = in.rb; o.write = in.rt;
+        break;
+    }
+    return o;
+}
+
+// ----------------------------------------------------------------------------
+// ARM64 NEON code generator
+// ----------------------------------------------------------------------------
+constexpr uint8_t kScratchA = 0, kScratchB = 1, kScratchC = 2, kResult = 3;
+constexpr uint8_t kTemp0 = 4, kTemp1 = 5, kTemp2 = 6, kTemp3 = 7;
+constexpr uint8_t kTmpW = 9, kTmpW2 = 10, kTmpW3 = 11, kAddrX = 3, kLineGenX = 2;
+
+// Пул host регістрів: спочатку caller-saved V16-V31, потім V8-V15
+constexpr std::array<uint8_t, 24> kHostVRegs = {
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    8, 9, 10, 11, 12, 13, 14, 15,
+};
+
+class BlockEmitter {
+public:
+    explicit BlockEmitter(std::vector<uint32_t>& out) : code_(out) {
+        host_.fill(kNoReg);
+    }
+
+    void Allocate(const std::vector<Inst>& insts);
+    void EmitPrologue();
+    void EmitEpilogue();
+    void EmitInstruction(const Inst& in, uint32_t pc);
+    void EmitStaticExit(uint32_t next_pc) { MovW(kTmpW, next_pc); }
+
+private:
+    void Emit(uint32_t word) { code_.push_back(word); }
+
+    // --- Register mapping ---
+    uint8_t Src(uint8_t r, uint8_t scratch) {
+        if (host_[r] != kNoReg) return host_[r];
+        LoadQ(scratch, r);
+        return scratch;
+    }
+    uint8_t Dst(uint8_t r) const { return host_[r] != kNoReg ? host_[r] : kResult; }
+    void Commit(uint8_t r, uint8_t vreg) {
+        if (host_[r] != kNoReg) {
+            if (vreg != host_[r]) Mov(host_[r], vreg);
+            dirty_[r] = true;
+        } else {
+            StoreQ(vreg, r);
+        }
+    }
+
+    // --- Encodings ---
+    void LoadQ(uint8_t vt, uint8_t r) { Emit(0x3DC00000 | (uint32_t(r) << 10) | (0 << 5) | vt); }
+    void StoreQ(uint8_t vt, uint8_t r) { Emit(0x3D800000 | (uint32_t(r) << 10) | (0 << 5) | vt); }
+    void Vec3(uint32_t base, uint8_t d, uint8_t n, uint8_t m) {
+        Emit(base | (uint32_t(m) << 16) | (uint32_t(n) << 5) | d);
+    }
+    void Vec2(uint32_t base, uint8_t d, uint8_t n) { Emit(base | (uint32_t(n) << 5) | d); }
+    void Mov(uint8_t d, uint8_t n) { Vec3(0x4EA01C00, d, n, n); }
+    void Not(uint8_t d, uint8_t n) { Vec2(0x6E205800, d, n); }
+    void Ext(uint8_t d, uint8_t n, uint8_t m, uint8_t imm) {
+        Emit(0x6E000000 | (uint32_t(m) << 16) | (uint32_t(imm & 15) << 11) | (uint32_t(n) << 5) | d);
+    }
+    void Rev128(uint8_t d, uint8_t n) {
+        Vec2(0x4E200800, d, n); // rev64 .16b
+        Ext(d, d, d, 8);
+    }
+    void ShlB(uint8_t d, uint8_t n, uint8_t s) { Vec2(0x4F085400 | (uint32_t(s) << 16), d, n); }
+    void UshrB(uint8_t d, uint8_t n, uint8_t s) { Vec2(0x6F000400 | (uint32_t(16 - s) << 16), d, n); }
+    void CmltZeroB(uint8_t d, uint8_t n) { Vec2(0x4E20A800, d, n); }
+    void MoviB(uint8_t d, uint8_t imm) {
+        Emit(0x4F00E400 | (uint32_t(imm >> 5) << 16) | (uint32_t(imm & 31) << 5) | d);
+    }
+    void MovW(uint8_t wd, uint32_t value) {
+        Emit(0x52800000 | ((value & 0xFFFF) << 5) | wd);
+        if (value >> 16) Emit(0x72A00000 | ((value >> 16) << 5) | wd);
+    }
+    void MovX(uint8_t xd, uint64_t value) {
+        Emit(0xD2800000 | (uint32_t(value & 0xFFFF) << 5) | xd);
+        for (uint32_t hw = 1; hw < 4; ++hw) {
+            const uint32_t part = (value >> (hw * 16)) & 0xFFFF;
+            if (part) Emit(0xF2800000 | (hw << 21) | (part << 5) | xd);
+        }
+    }
+    void DupS(uint8_t vd, uint8_t wn) { Vec2(0x4E040C00, vd, wn); }
+    void DupH(uint8_t vd, uint8_t wn) { Vec2(0x4E020C00, vd, wn); }
+    void DupB(uint8_t vd, uint8_t wn) { Vec2(0x4E010C00, vd, wn); }
+    void PreferredSlot(uint8_t wd, uint8_t vn) { Vec2(0x0E1C3C00, wd, vn); } // umov wd, vn.s[3]
+    void AddW(uint8_t d, uint8_t n, uint8_t m) { Vec3(0x0B000000, d, n, m); }
+    void AndLSMask(uint8_t d, uint8_t n) { Vec2(0x12000000 | (28 << 16) | (13 << 10), d, n); } // & 0x3FFF0
+    void AndPCMask(uint8_t d, uint8_t n) { Vec2(0x12000000 | (30 << 16) | (15 << 10), d, n); } // & 0x3FFFC
+
+    // Адреса квадрослова в LS -> X3
+    void EmitLSAddress(const Inst& in);
+    void EmitSplatImm(const Inst& in, uint32_t value, bool halfword);
+    void EmitBinary(uint32_t base, const Inst& in, bool swap = false, bool invert = false);
+    void EmitShufb(const Inst& in);
+    void EmitMarkWrite();
+    void EmitRotqby(const Inst& in);
+
+    std::vector<uint32_t>& code_;
+    std::array<uint8_t, 128> host_;
+    std::array<bool, 128> dirty_{};
+    std::array<bool, 128> entry_load_{};
+    bool uses_callee_saved_ = false;
+};
+
+void BlockEmitter::Allocate(const std::vector<Inst>& insts) {
+    std::array<uint16_t, 128> refs{};
+    std::array<bool, 128> written{};
+    for (const Inst& in : insts) {
+        const Operands o = GetOperands(in);
+        for (uint8_t r : o.reads) {
+            if (r == kNoReg) continue;
+            ++refs[r];
+            if (!written[r]) entry_load_[r] = true;
+        }
+        if (o.write != kNoReg) {
+            ++refs[o.write];
+            written[o.write] = true;
+        }
+    }
+
+    std::array<uint8_t, 128> order;
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint8_t>(i);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint8_t a, uint8_t b) { return refs[a] > refs[b]; });
+
+    size_t next = 0;
+    for (uint8_t r : order) {
+        if (refs[r] < 2 || next == kHostVRegs.size()) break;
+        host_[r] = kHostVRegs[next++];
+        if (host_[r] < 16) uses_callee_saved_ = true;
+    }
+}
+
+void BlockEmitter::EmitPrologue() {
+    if (uses_callee_saved_) {
+        // stp d8, d9, [sp, #-64]! ; stp d10, d11 / d12, d13 / d14, d15, [sp, #16..48]
+        Emit(0x6D800000 | (0x78u << 15) | (9 << 10) | (31 << 5) | 8);
+        Emit(0x6D000000 | (2u << 15) | (11 << 10) | (31 << 5) | 10);
+        Emit(0x6D000000 | (4u << 15) | (13 << 10) | (31 << 5) | 12);
+        Emit(0x6D000000 | (6u << 15) | (15 << 10) | (31 << 5) | 14);
+    }
+    for (size_t r = 0; r < host_.size(); ++r) {
+        if (host_[r] != kNoReg && entry_load_[r]) LoadQ(host_[r], static_cast<uint8_t>(r));
+    }
+}
+
+void BlockEmitter::EmitEpilogue() {
+    for (size_t r = 0; r < host_.size(); ++r) {
+        if (host_[r] != kNoReg && dirty_[r]) StoreQ(host_[r], static_cast<uint8_t>(r));
+    }
+    if (uses_callee_saved_) {
+        Emit(0x6D400000 | (6u << 15) | (15 << 10) | (31 << 5) | 14);
+        Emit(0x6D400000 | (4u << 15) | (13 << 10) | (31 << 5) | 12);
+        Emit(0x6D400000 | (2u << 15) | (11 << 10) | (31 << 5) | 10);
+        Emit(0x6CC00000 | (8u << 15) | (9 << 10) | (31 << 5) | 8); // ldp d8, d9, [sp], #64
+    }
+    Emit(0x2A0003E0 | (kTmpW << 16)); // mov w0, w9
+    Emit(0xD65F03C0);                 // ret
+}
+
+void BlockEmitter::EmitLSAddress(const Inst& in) {
+    switch (in.op) {
+    case Op::LQD: case Op::STQD:
+        PreferredSlot(kAddrX, Src(in.ra, kTemp0));
+        MovW(kTmpW, static_cast<uint32_t>(in.imm));
+        AddW(kAddrX, kAddrX, kTmpW);
+        break;
+    case Op::LQX: case Op::STQX:
+        PreferredSlot(kAddrX, Src(in.ra, kTemp0));
+        PreferredSlot(kTmpW, Src(in.rb, kTemp1));
+        AddW(kAddrX, kAddrX, kTmpW);
+        break;
+    default: // LQA / STQA
+        MovW(kAddrX, static_cast<uint32_t>(in.imm));
+        break;
+    }
+    AndLSMask(kAddrX, kAddrX);
+}
+
+void BlockEmitter::EmitMarkWrite() {
+    // ++gen[addr >> kLineShift] - інвалідація блоків, що лежать у цій лінії
+    Emit(0x53000000 | (LSWriteTracker::kLineShift << 16) | (31 << 10) |
+         (uint32_t(kAddrX) << 5) | kTmpW2);                 // lsr w10, w3, #7
+    Vec3(0xB8607800, kTmpW3, kLineGenX, kTmpW2);            // ldr w11, [x2, x10, lsl #2]
+    Emit(0x11000400 | (uint32_t(kTmpW3) << 5) | kTmpW3);    // add w11, w11, #1
+    Vec3(0xB8207800, kTmpW3, kLineGenX, kTmpW2);            // str w11, [x2, x10, lsl #2]
+}
+
+void BlockEmitter::EmitSplatImm(const Inst& in, uint32_t value, bool halfword) {
+    const uint8_t d = Dst(in.rt);
+    MovW(kTmpW, value);
+    if (halfword) DupH(d, kTmpW); else DupS(d, kTmpW);
+    Commit(in.rt, d);
+}
+
+void BlockEmitter::EmitBinary(uint32_t base, const Inst& in, bool swap, bool invert) {
+    const uint8_t a = Src(in.ra, kScratchA);
+    const uint8_t b = Src(in.rb, kScratchB);
+    const uint8_t d = Dst(in.rt);
+    if (swap) Vec3(base, d, b, a); else Vec3(base, d, a, b);
+    if (invert) Not(d, d);
+    Commit(in.rt, d);
+}
+
+void BlockEmitter::EmitShufb(const Inst& in) {
+    // У host layout SPU байт i лежить у байті 15-i, тож індекс у конкатенації
+    // ra:rb перетворюється на tbl по {V0 = rb, V1 = ra} з індексом ~c & 0x1F.
+    if (host_[in.rb] != kNoReg) Mov(kScratchA, host_[in.rb]); else LoadQ(kScratchA, in.rb);
+    if (host_[in.ra] != kNoReg) Mov(kScratchB, host_[in.ra]); else LoadQ(kScratchB, in.ra);
+    const uint8_t c = Src(in.rc, kScratchC);
+
+    Not(kTemp0, c);
+    MoviB(kTemp1, 0x1F);
+    Vec3(0x4E201C00, kTemp0, kTemp0, kTemp1); // and
+    CmltZeroB(kTemp1, c);                      // 0xFF для c & 0x80
+    Vec3(0x4EA01C00, kTemp0, kTemp0, kTemp1); // orr -> індекс >= 32 => 0
+    Vec3(0x4E002000, kResult, kScratchA, kTemp0); // tbl {v0, v1}
+
+    // Спеціальні селектори: 10x -> 0x00, 110 -> 0xFF, 111 -> 0x80
+    ShlB(kTemp2, c, 1);
+    CmltZeroB(kTemp2, kTemp2);
+    Vec3(0x4E201C00, kTemp2, kTemp2, kTemp1); // c7 & c6
+    ShlB(kTemp3, c, 2);
+    CmltZeroB(kTemp3, kTemp3);
+    Vec3(0x4E201C00, kTemp3, kTemp3, kTemp2); // c7 & c6 & c5
+    UshrB(kTemp3, kTemp3, 1);
+    Vec3(0x6E201C00, kTemp2, kTemp2, kTemp3); // eor
+
+    const uint8_t d = Dst(in.rt);
+    Vec3(0x4EA01C00, d, kResult, kTemp2);
+    Commit(in.rt, d);
+}
+
+void BlockEmitter::EmitRotqby(const Inst& in) {
+    const uint8_t a = Src(in.ra, kScratchA);
+    const uint8_t d = Dst(in.rt);
+    if (in.op == Op::ROTQBYI) {
+        Ext(d, a, a, static_cast<uint8_t>((16 - in.imm) & 15));
+        Commit(in.rt, d);
+        return;
+    }
+    const uint8_t b = Src(in.rb, kScratchB);
+    // Ротація на змінну кількість байт: tbl з індексом (iota - n) & 15
+    MovX(kTmpW2, 0x0706050403020100ull);
+    Vec2(0x4E081C00, kTemp0, kTmpW2); // ins v4.d[0], x10
+    MovX(kTmpW2, 0x0F0E0D0C0B0A0908ull);
+    Vec2(0x4E181C00, kTemp0, kTmpW2); // ins v4.d[1], x10
+    PreferredSlot(kTmpW, b);
+    DupB(kTemp1, kTmpW);
+    Vec3(0x6E208400, kTemp0, kTemp0, kTemp1); // sub .16b
+    MoviB(kTemp1, 0x0F);
+    Vec3(0x4E201C00, kTemp0, kTemp0, kTemp1);
+    Vec3(0x4E000000, d, a, kTemp0); // tbl {a}
+    Commit(in.rt, d);
+}
+
+void BlockEmitter::EmitInstruction(const Inst& in, uint32_t pc) {
+    const uint32_t next_pc = (pc + 4) & SPUJITCompiler::kLocalStoreMask;
+    switch (in.op) {
+    case Op::Nop: break;
+
+    case Op::SELB: {
+        const uint8_t a = Src(in.ra, kScratchA);
+        const uint8_t b = Src(in.rb, kScratchB);
+        const uint8_t c = Src(in.rc, kScratchC);
+        Mov(kResult, c);
+        Vec3(0x6E601C00, kResult, b, a); // bsl: c ? rb : ra
+        Commit(in.rt, kResult);
+        break;
+    }
+    case Op::SHUFB: EmitShufb(in); break;
+    case Op::ROTQBY: case Op::ROTQBYI: EmitRotqby(in); break;
+
+    case Op::FMA: case Op::FNMS: case Op::FMS: {
+        const uint8_t a = Src(in.ra, kScratchA);
+        const uint8_t b = Src(in.rb, kScratchB);
+        const uint8_t c = Src(in.rc, kScratchC);
+        if (in.op == Op::FMS) Vec2(0x6EA0F800, kResult, c); // fneg
+        else Mov(kResult, c);
+        Vec3(in.op == Op::FNMS ? 0x4EA0CC00 : 0x4E20CC00, kResult, a, b); // fmls / fmla
+        Commit(in.rt, kResult);
+        break;
+    }
+
+    case Op::A: EmitBinary(0x4EA08400, in); break;
+    case Op::AH: EmitBinary(0x4E608400, in); break;
+    case Op::SF: EmitBinary(0x6EA08400, in, true); break;  // rb - ra
+    case Op::SFH: EmitBinary(0x6E608400, in, true); break;
+    case Op::AND: EmitBinary(0x4E201C00, in); break;
+    case Op::OR: EmitBinary(0x4EA01C00, in); break;
+    case Op::XOR: EmitBinary(0x6E201C00, in); break;
+    case Op::ANDC: EmitBinary(0x4E601C00, in); break; // bic
+    case Op::ORC: EmitBinary(0x4EE01C00, in); break;  // orn
+    case Op::NAND: EmitBinary(0x4E201C00, in, false, true); break;
+    case Op::NOR: EmitBinary(0x4EA01C00, in, false, true); break;
+    case Op::EQV: EmitBinary(0x6E201C00, in, false, true); break;
+    case Op::CEQ: EmitBinary(0x6EA08C00, in); break;
+    case Op::CEQH: EmitBinary(0x6E608C00, in); break;
+    case Op::CEQB: EmitBinary(0x6E208C00, in); break;
+    case Op::CGT: EmitBinary(0x4EA03400, in); break;
+    case Op::CGTH: EmitBinary(0x4E603400, in); break;
+    case Op::CGTB: EmitBinary(0x4E203400, in); break;
+    case Op::CLGT: EmitBinary(0x6EA03400, in); break; // cmhi
+    case Op::FA: EmitBinary(0x4E20D400, in); break;
+    case Op::FS: EmitBinary(0x4EA0D400, in); break;
+    case Op::FM: EmitBinary(0x6E20DC00, in); break;
+
+    case Op::AI: case Op::AHI: case Op::ANDI: case Op::ORI: case Op::XORI: {
+        const bool halfword = in.op == Op::AHI;
+        const uint8_t a = Src(in.ra, kScratchA);
+        MovW(kTmpW, halfword ? (static_cast<uint32_t>(in.imm) & 0xFFFF) : static_cast<uint32_t>(in.imm));
+        if (halfword) DupH(kTemp0, kTmpW); else DupS(kTemp0, kTmpW);
+        const uint8_t d = Dst(in.rt);
+        switch (in.op) {
+        case Op::AI: Vec3(0x4EA08400, d, a, kTemp0); break;
+        case Op::AHI: Vec3(0x4E608400, d, a, kTemp0); break;
+        case Op::ANDI: Vec3(0x4E201C00, d, a, kTemp0); break;
+        case Op::ORI: Vec3(0x4EA01C00, d, a, kTemp0); break;
+        default: Vec3(0x6E201C00, d, a, kTemp0); break;
+        }
+        Commit(in.rt, d);
+        break;
+    }
+
+    case Op::IL: case Op::ILHU: case Op::ILA:
+        EmitSplatImm(in, static_cast<uint32_t>(in.imm), false);
+        break;
+    case Op::IOHL: {
+        const uint8_t t = Src(in.rt, kScratchA);
+        MovW(kTmpW, static_cast<uint32_t>(in.imm));
+        DupS(kTemp0, kTmpW);
+        const uint8_t d = Dst(in.rt);
+        Vec3(0x4EA01C00, d, t, kTemp0);
+        Commit(in.rt, d);
+        break;
+    }
+
+    case Op::LQD: case Op::LQX: case Op::LQA: {
+        EmitLSAddress(in);
+        const uint8_t d = Dst(in.rt);
+        Emit(0x3CE06800 | (uint32_t(kAddrX) << 16) | (1 << 5) | d); // ldr q, [x1, x3]
+        Rev128(d, d);
+        Commit(in.rt, d);
+        break;
+    }
+    case Op::STQD: case Op::STQX: case Op::STQA: {
+        EmitLSAddress(in);
+        const uint8_t t = Src(in.rt, kScratchC);
+        Rev128(kResult, t);
+        Emit(0x3CA06800 | (uint32_t(kAddrX) << 16) | (1 << 5) | kResult); // str q, [x1, x3]
+        EmitMarkWrite();
+        break;
+    }
+
+    case Op::BR:
+        MovW(kTmpW, (pc + in.imm) & 0x3FFFC);
+        break;
+    case Op::BRZ: case Op::BRNZ: {
+        MovW(kTmpW2, (pc + in.imm) & 0x3FFFC);
+        MovW(kTmpW3, next_pc);
+        PreferredSlot(12, Src(in.rt, kScratchA));
+        Emit(0x7100001F | (12 << 5));  // cmp w12, #0
+        const uint32_t cond = in.op == Op::BRZ ? 0x0 : 0x1; // eq / ne
+        Emit(0x1A800000 | (uint32_t(kTmpW3) << 16) | (cond << 12) | (uint32_t(kTmpW2) << 5) | kTmpW);
+        break;
+    }
+    case Op::BI:
+        PreferredSlot(kTmpW, Src(in.ra, kScratchA));
+        AndPCMask(kTmpW, kTmpW);
+        break;
+
+    case Op::Invalid:
+        break;
+    }
+}
+
+} // namespace
+
 SPUJITCompiler::SPUJITCompiler() {}
 SPUJITCompiler::~SPUJITCompiler() { Shutdown(); }
 
@@ -36,25 +596,130 @@ void SPUJITCompiler::Shutdown() {
         code_cache_ = nullptr;
     }
     blocks_.clear();
+    block_index_.clear();
     cache_used_ = 0;
 }
 
-void* SPUJITCompiler::CompileBlock(uint32_t spu_addr) {
-    // TODO: Реальна генерація ARM64 NEON/SVE2 коду з SPU
-    // Поки що — заглушка
-    LOGI("CompileBlock: 0x%x", spu_addr);
-    return nullptr;
+void* SPUJITCompiler::CompileBlock(const uint8_t* local_store, const LSWriteTracker& writes,
+                                   uint32_t spu_addr) {
+    if (!code_cache_ || !local_store) return nullptr;
+    spu_addr &= 0x3FFFC;
+    if (void* existing = LookupBlock(local_store, writes, spu_addr)) return existing;
+
+    // 1. Decode до першої непідтримуваної інструкції або гілки
+    std::vector<Inst> insts;
+    std::vector<uint32_t> guest_code;
+    uint32_t pc = spu_addr;
+    bool ends_with_branch = false;
+    while (insts.size() < kMaxBlockInstructions) {
+        uint32_t raw;
+        std::memcpy(&raw, local_store + pc, sizeof(raw));
+        const Inst in = Decode(__builtin_bswap32(raw));
+        if (in.op == Op::Invalid) break;
+        insts.push_back(in);
+        guest_code.push_back(raw);
+        if (IsBranch(in.op)) {
+            ends_with_branch = true;
+            break;
+        }
+        pc = (pc + 4) & 0x3FFFC;
+        if (pc == spu_addr) break;
+    }
+    if (insts.empty()) return nullptr;
+
+    // 2. Allocation + emission
+    std::vector<uint32_t> code;
+    code.reserve(insts.size() * 8 + 64);
+    BlockEmitter emitter(code);
+    emitter.Allocate(insts);
+    emitter.EmitPrologue();
+
+    uint32_t inst_pc = spu_addr;
+    for (const Inst& in : insts) {
+        emitter.EmitInstruction(in, inst_pc);
+        inst_pc = (inst_pc + 4) & 0x3FFFC;
+    }
+    if (!ends_with_branch) emitter.EmitStaticExit(inst_pc);
+    emitter.EmitEpilogue();
+
+    // 3. Install
+    const size_t size = code.size() * sizeof(uint32_t);
+    if (cache_used_ + size > cache_size_) {
+        LOGI("SPU JIT cache full, flushing");
+        InvalidateAll();
+    }
+    uint8_t* dst = static_cast<uint8_t*>(code_cache_) + cache_used_;
+    std::memcpy(dst, code.data(), size);
+    __builtin___clear_cache(reinterpret_cast<char*>(dst), reinterpret_cast<char*>(dst + size));
+    cache_used_ += (size + 15) & ~size_t(15);
+
+    BlockInfo info{spu_addr, dst, size, static_cast<uint32_t>(guest_code.size() * 4),
+                   LSWriteTracker::LineOf(spu_addr), {}, std::move(guest_code)};
+    const uint32_t last_line = LSWriteTracker::LineOf(spu_addr + info.spu_size - 1);
+    for (uint32_t line = info.first_line;; line = (line + 1) % LSWriteTracker::kLineCount) {
+        info.line_gen.push_back(writes.gen[line]);
+        if (line == last_line) break;
+    }
+
+    // Застарілий блок на цій адресі замінюється на місці (його код лишається
+    // в cache до наступного flush)
+    auto it = block_index_.find(spu_addr);
+    if (it != block_index_.end()) {
+        blocks_[it->second] = std::move(info);
+        ++recompilations_;
+    } else {
+        block_index_[spu_addr] = blocks_.size();
+        blocks_.push_back(std::move(info));
+    }
+    return dst;
+}
+
+bool SPUJITCompiler::Validate(BlockInfo& block, const uint8_t* local_store,
+                              const LSWriteTracker& writes) {
+    // Fast path: жоден запис не торкався ліній блоку
+    bool clean = true;
+    for (size_t i = 0; i < block.line_gen.size(); ++i) {
+        const uint32_t line = (block.first_line + i) % LSWriteTracker::kLineCount;
+        if (writes.gen[line] != block.line_gen[i]) {
+            clean = false;
+            break;
+        }
+    }
+    if (clean) return true;
+
+    // Лінію хтось писав - перевіряємо лише байти самого блоку
+    uint32_t pc = block.spu_addr;
+    for (uint32_t word : block.guest_code) {
+        uint32_t raw;
+        std::memcpy(&raw, local_store + pc, sizeof(raw));
+        if (raw != word) return false;
+        pc = (pc + 4) & 0x3FFFC;
+    }
+    for (size_t i = 0; i < block.line_gen.size(); ++i) {
+        block.line_gen[i] = writes.gen[(block.first_line + i) % LSWriteTracker::kLineCount];
+    }
+    ++revalidations_;
+    return true;
+}
+
+void* SPUJITCompiler::LookupBlock(const uint8_t* local_store, const LSWriteTracker& writes,
+                                  uint32_t spu_addr) {
+    auto it = block_index_.find(spu_addr & 0x3FFFC);
+    if (it == block_index_.end()) return nullptr;
+    BlockInfo& block = blocks_[it->second];
+    return Validate(block, local_store, writes) ? block.code_ptr : nullptr;
 }
 
-uint32_t SPUJITCompiler::ExecuteBlock(void* code, uint32_t pc, void* gpr128) {
-    // TODO: Виконати ARM64 NEON/SVE2 код (inline asm або call)
-    // Поки що — stub
-    LOGI("ExecuteBlock: code=%p, pc=0x%x", code, pc);
-    return pc + 4;
+uint32_t SPUJITCompiler::ExecuteBlock(void* code, uint32_t pc, void* gpr128, uint8_t* local_store,
+                                      LSWriteTracker& writes) {
+    if (!code) return pc;
+    using BlockFn = uint32_t (*)(void*, uint8_t*, uint32_t*);
+    return reinterpret_cast<BlockFn>(code)(gpr128, local_store, writes.gen);
 }
 
 void SPUJITCompiler::InvalidateAll() {
     blocks_.clear();
+    block_index_.clear();
     cache_used_ = 0;
 }
 
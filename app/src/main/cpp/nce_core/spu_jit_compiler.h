@@ -1,6 +1,19 @@
 // ============================================================================
 // SPU JIT Compiler (Cell SPU → ARM64 NEON/SVE2)
 // ============================================================================
+// Block compiler: SPU регістри (128 x 128 біт, layout як у SPUState::gpr -
+// byte-reversed, preferred slot = u32[3]) на блок мапляться у V8-V31.
+// Найчастіше використовувані живуть у host регістрах увесь блок, решта -
+// load/store через scratch V0-V7. shufb / selb / rotqby емітяться inline
+// як tbl / bsl / ext.
+//
+// ABI блоку: uint32_t block(void* gpr128, uint8_t* local_store,
+//                           uint32_t* ls_line_gen) -> next PC
+//
+// Self-modifying code: блок зберігає generation лічильники LSWriteTracker
+// для своїх ліній; на вході перевіряються лише вони, а при розбіжності -
+// байти самого блоку (DMA в сусідні дані тієї ж лінії не змушує рекомпілювати).
+// ============================================================================
 #pragma once
 
 #include <cstdint>
@@ -8,6 +21,8 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include "spu_ls_tracker.h"
 
 namespace rpcsx {
 namespace spu {
@@ -21,11 +36,18 @@ public:
     bool Initialize(size_t cache_size = 64 * 1024 * 1024);
     void Shutdown();
 
-    // Compile a block of SPU code at given address
-    void* CompileBlock(uint32_t spu_addr);
+    // Compile a block of SPU code at given address (nullptr якщо перша
+    // інструкція не підтримується - її виконує інтерпретатор)
+    void* CompileBlock(const uint8_t* local_store, const LSWriteTracker& writes,
+                       uint32_t spu_addr);
+
+    // Блок для spu_addr, якщо він досі відповідає вмісту LS (інакше nullptr)
+    void* LookupBlock(const uint8_t* local_store, const LSWriteTracker& writes,
+                      uint32_t spu_addr);
 
     // Execute compiled block (returns next PC)
-    uint32_t ExecuteBlock(void* code, uint32_t pc, void* gpr128);
+    uint32_t ExecuteBlock(void* code, uint32_t pc, void* gpr128, uint8_t* local_store,
+                          LSWriteTracker& writes);
 
     // Invalidate code cache
     void InvalidateAll();
@@ -33,17 +55,32 @@ public:
     // Statistics
     size_t GetCompiledBlockCount() const;
     size_t GetCacheUsed() const;
+    uint64_t GetRevalidations() const { return revalidations_; }
+    uint64_t GetRecompilations() const { return recompilations_; }
+
+    static constexpr uint32_t kMaxBlockInstructions = 256;
+    static constexpr uint32_t kLocalStoreMask = 0x3FFFF;
 
 private:
     struct BlockInfo {
         uint32_t spu_addr;
         void* code_ptr;
         size_t code_size;
+        uint32_t spu_size;
+        uint32_t first_line;
+        std::vector<uint32_t> line_gen;    // LSWriteTracker::gen на момент перевірки
+        std::vector<uint32_t> guest_code;  // копія SPU слів блоку
     };
+
+    bool Validate(BlockInfo& block, const uint8_t* local_store, const LSWriteTracker& writes);
+
     std::vector<BlockInfo> blocks_;
+    std::unordered_map<uint32_t, size_t> block_index_;
     void* code_cache_ = nullptr;
     size_t cache_size_ = 0;
     size_t cache_used_ = 0;
+    uint64_t revalidations_ = 0;
+    uint64_t recompilations_ = 0;
 };
 
 } // namespace spu
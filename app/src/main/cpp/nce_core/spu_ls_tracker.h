@@ -0,0 +1,54 @@
+// ============================================================================
+// SPU Local Store Write Tracking
+// ============================================================================
+// Per-line generation counters для 256KB Local Store. Кожен запис у LS
+// (stq* інтерпретатора / JIT, MFC GET, завантаження програми) інкрементує
+// лічильник 128-байтних ліній, яких він торкається. Скомпільований блок
+// пам'ятає лічильники своїх ліній і на вході порівнює лише їх (блок <= 1KB,
+// тобто <= 9 ліній) замість перевірки вмісту LS.
+//
+// Лічильники, а не dirty біти: кілька блоків можуть ділити лінію, і кожен
+// з них валідується незалежно, без "хто скидає біт".
+// ============================================================================
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace rpcsx {
+namespace spu {
+
+struct LSWriteTracker {
+    static constexpr uint32_t kLocalStoreSize = 256 * 1024;
+    static constexpr uint32_t kLineShift = 7;  // 128 байт = MFC cache line
+    static constexpr uint32_t kLineCount = kLocalStoreSize >> kLineShift;
+
+    uint32_t gen[kLineCount];
+
+    LSWriteTracker() { Reset(); }
+
+    void Reset() { std::memset(gen, 0, sizeof(gen)); }
+
+    static uint32_t LineOf(uint32_t lsa) { return (lsa & (kLocalStoreSize - 1)) >> kLineShift; }
+
+    // Квадрослово (stqd/stqx/stqa) завжди в межах однієї лінії
+    void MarkQuadword(uint32_t lsa) { ++gen[LineOf(lsa)]; }
+
+    // Діапазон з wrap-around по 256KB (DMA)
+    void MarkRange(uint32_t lsa, uint32_t size) {
+        if (size == 0) return;
+        if (size >= kLocalStoreSize) {
+            for (uint32_t i = 0; i < kLineCount; ++i) ++gen[i];
+            return;
+        }
+        const uint32_t first = LineOf(lsa);
+        const uint32_t last = LineOf(lsa + size - 1);
+        for (uint32_t line = first;; line = (line + 1) % kLineCount) {
+            ++gen[line];
+            if (line == last) break;
+        }
+    }
+};
+
+} // namespace spu
+} // namespace rpcsx
@@ -6,49 +6,270 @@
 namespace rpcsx {
 namespace util {
 
-ThreadPool::ThreadPool(size_t num_threads) : stop_(false), active_tasks_(0) {
+namespace {
+// Поточний worker (для push у власну deque замість injection queue)
+thread_local ThreadPool* t_pool = nullptr;
+thread_local size_t t_worker_index = 0;
+} // namespace
+
+// ============================================================================
+// WorkStealingDeque
+// ============================================================================
+WorkStealingDeque::WorkStealingDeque(size_t log_capacity)
+    : ring_(new Ring(log_capacity)) {}
+
+WorkStealingDeque::~WorkStealingDeque() {
+    delete ring_.load(std::memory_order_relaxed);
+}
+
+WorkStealingDeque::Ring* WorkStealingDeque::grow(Ring* ring, int64_t top, int64_t bottom) {
+    size_t log_cap = 0;
+    while ((size_t(1) << log_cap) < ring->capacity() * 2) ++log_cap;
+
+    Ring* bigger = new Ring(log_cap);
+    for (int64_t i = top; i < bottom; ++i) {
+        bigger->put(i, ring->get(i));
+    }
+    retired_.emplace_back(ring);
+    ring_.store(bigger, std::memory_order_release);
+    return bigger;
+}
+
+void WorkStealingDeque::push(Task* task) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(ring->capacity()) - 1) {
+        ring = grow(ring, t, b);
+    }
+    ring->put(b, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+}
+
+Task* WorkStealingDeque::pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task* task = ring->get(b);
+    if (t == b) {
+        // Останній елемент - змагаємося зі steal()
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+Task* WorkStealingDeque::steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+
+    Ring* ring = ring_.load(std::memory_order_acquire);
+    Task* task = ring->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+bool WorkStealingDeque::empty() const {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    return t >= b;
+}
+
+// ============================================================================
+// ThreadPool
+// ============================================================================
+ThreadPool::ThreadPool(size_t num_threads) : stop_(false), active_tasks_(0), queued_tasks_(0) {
+    if (num_threads == 0) num_threads = 1;
+
+    // Compile не займає всі workers - хоча б один лишається для Interactive
+    lanes_[static_cast<size_t>(TaskLane::BackgroundCompile)].limit =
+        num_threads > 1 ? num_threads - 1 : 1;
+    lanes_[static_cast<size_t>(TaskLane::Streaming)].limit =
+        num_threads > 3 ? num_threads / 4 : 1;
+
+    locals_.reserve(num_threads);
     for (size_t i = 0; i < num_threads; ++i) {
-        workers_.emplace_back([this]() {
-            while (true) {
-                std::function<void()> task;
-                {
-                    std::unique_lock<std::mutex> lock(queue_mutex_);
-                    condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
-                    if (stop_ && tasks_.empty()) return;
-                    task = std::move(tasks_.front());
-                    tasks_.pop();
-                    ++active_tasks_;
-                }
-                task();
-                --active_tasks_;
-            }
-        });
+        locals_.emplace_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.emplace_back([this, i]() { worker_loop(i); });
     }
 }
 
 ThreadPool::~ThreadPool() {
     {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
         stop_ = true;
     }
-    condition_.notify_all();
+    sleep_cv_.notify_all();
     for (auto& worker : workers_) {
         if (worker.joinable()) worker.join();
     }
 }
 
-void ThreadPool::enqueue(std::function<void()> task) {
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        tasks_.push(std::move(task));
+void ThreadPool::submit(Task* task) {
+    const size_t lane = static_cast<size_t>(task->lane());
+    ++active_tasks_;
+    ++queued_tasks_;
+
+    if (t_pool == this) {
+        // Задача породжена worker'ом - у власну deque, без блокувань
+        locals_[t_worker_index]->deques[lane].push(task);
+    } else {
+        Lane& l = lanes_[lane];
+        std::lock_guard<std::mutex> lock(l.inject_mutex);
+        l.inject.push_back(task);
+        l.inject_size.fetch_add(1, std::memory_order_release);
+        ++injected_;
+    }
+
+    wake_one();
+}
+
+void ThreadPool::wake_one() {
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        sleep_cv_.notify_one();
+    }
+}
+
+bool ThreadPool::try_acquire_lane(size_t lane) {
+    Lane& l = lanes_[lane];
+    const size_t limit = l.limit.load(std::memory_order_relaxed);
+    size_t running = l.running.load(std::memory_order_relaxed);
+    do {
+        if (limit != 0 && running >= limit) return false;
+    } while (!l.running.compare_exchange_weak(running, running + 1, std::memory_order_acquire,
+                                              std::memory_order_relaxed));
+    return true;
+}
+
+void ThreadPool::release_lane(size_t lane) {
+    Lane& l = lanes_[lane];
+    l.running.fetch_sub(1, std::memory_order_release);
+    // Хтось міг заснути, бо lane був на ліміті
+    if (l.limit.load(std::memory_order_relaxed) != 0) {
+        wake_one();
+    }
+}
+
+Task* ThreadPool::take_from_lane(size_t index, size_t lane) {
+    // 1. Власна deque (LIFO - гарячий кеш)
+    if (Task* task = locals_[index]->deques[lane].pop()) return task;
+
+    // 2. Injection queue зовнішніх submit'ів
+    Lane& l = lanes_[lane];
+    if (l.inject_size.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(l.inject_mutex);
+        if (!l.inject.empty()) {
+            Task* task = l.inject.front();
+            l.inject.pop_front();
+            l.inject_size.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    // 3. Крадіжка у сусідів (FIFO - найстаріші задачі)
+    const size_t count = locals_.size();
+    for (size_t i = 1; i < count; ++i) {
+        const size_t victim = (index + i) % count;
+        if (Task* task = locals_[victim]->deques[lane].steal()) {
+            ++stolen_;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+Task* ThreadPool::find_task(size_t index) {
+    for (size_t lane = 0; lane < kTaskLaneCount; ++lane) {
+        if (!try_acquire_lane(lane)) continue;
+        if (Task* task = take_from_lane(index, lane)) {
+            --queued_tasks_;
+            return task;
+        }
+        release_lane(lane);
+    }
+    return nullptr;
+}
+
+void ThreadPool::run(Task* task) {
+    const size_t lane = static_cast<size_t>(task->lane());
+    (*task)();
+    delete task;
+
+    lanes_[lane].executed.fetch_add(1, std::memory_order_relaxed);
+    release_lane(lane);
+
+    if (--active_tasks_ == 0) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_cv_.notify_all();
+    }
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    t_pool = this;
+    t_worker_index = index;
+
+    while (true) {
+        const uint64_t seen = epoch_.load(std::memory_order_seq_cst);
+
+        if (Task* task = find_task(index)) {
+            run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        if (stop_ && queued_tasks_ == 0) return;
+
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        sleep_cv_.wait(lock, [&] {
+            return (stop_ && queued_tasks_ == 0) || epoch_.load(std::memory_order_seq_cst) != seen;
+        });
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
     }
-    condition_.notify_one();
 }
 
 void ThreadPool::wait() {
-    while (active_tasks_ > 0 || !tasks_.empty()) {
-        std::this_thread::yield();
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cv_.wait(lock, [this] { return active_tasks_ == 0; });
+}
+
+void ThreadPool::set_lane_limit(TaskLane lane, size_t max_concurrent) {
+    lanes_[static_cast<size_t>(lane)].limit = max_concurrent;
+    wake_one();
+}
+
+size_t ThreadPool::lane_limit(TaskLane lane) const {
+    return lanes_[static_cast<size_t>(lane)].limit.load(std::memory_order_relaxed);
+}
+
+ThreadPool::Stats ThreadPool::stats() const {
+    Stats s{};
+    for (size_t lane = 0; lane < kTaskLaneCount; ++lane) {
+        s.executed[lane] = lanes_[lane].executed.load(std::memory_order_relaxed);
     }
+    s.stolen = stolen_.load(std::memory_order_relaxed);
+    s.injected = injected_.load(std::memory_order_relaxed);
+    return s;
 }
 
 } // namespace util
@@ -1,37 +1,193 @@
 // ============================================================================
 // Thread Pool (Task-based parallelism)
 // ============================================================================
+// Work-stealing pool: кожен worker має власні Chase-Lev deques (по одній на
+// lane), зовнішні submit'и йдуть у injection queue lane'а, а вільні workers
+// крадуть задачі у сусідів. Lanes мають пріоритет і ліміт паралельності,
+// щоб шторм shader compile не з'їдав усі ядра під час tier-up JIT.
+// ============================================================================
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <thread>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
 
 namespace rpcsx {
 namespace util {
 
+// Priority lanes, у порядку спадання пріоритету
+enum class TaskLane : uint8_t {
+    Interactive = 0,        // JIT tier-up, IO на критичному шляху
+    BackgroundCompile = 1,  // Shader / pipeline compile
+    Streaming = 2,          // Asset / texture streaming
+};
+
+constexpr size_t kTaskLaneCount = 3;
+
+// ============================================================================
+// Task - small-buffer callable (замість std::function)
+// ============================================================================
+// Лямбди з захопленням до kInlineSize байт зберігаються inline у вузлі задачі,
+// тож submit робить одну алокацію замість двох (std::function + queue node).
+class Task {
+public:
+    static constexpr size_t kInlineSize = 48;
+
+    template <typename F>
+    explicit Task(F&& fn, TaskLane lane) : lane_(lane) {
+        using Fn = std::decay_t<F>;
+        if constexpr (sizeof(Fn) <= kInlineSize &&
+                      alignof(Fn) <= alignof(std::max_align_t) &&
+                      std::is_nothrow_move_constructible_v<Fn>) {
+            callable_ = new (storage_) Fn(std::forward<F>(fn));
+            destroy_ = [](void* p) { static_cast<Fn*>(p)->~Fn(); };
+        } else {
+            callable_ = new Fn(std::forward<F>(fn));
+            destroy_ = [](void* p) { delete static_cast<Fn*>(p); };
+        }
+        invoke_ = [](void* p) { (*static_cast<Fn*>(p))(); };
+    }
+
+    ~Task() { destroy_(callable_); }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    void operator()() { invoke_(callable_); }
+    TaskLane lane() const { return lane_; }
+
+private:
+    alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+    void* callable_ = nullptr;
+    void (*invoke_)(void*) = nullptr;
+    void (*destroy_)(void*) = nullptr;
+    TaskLane lane_;
+};
+
+// ============================================================================
+// WorkStealingDeque - Chase-Lev deque (Lê et al., C11 memory model)
+// ============================================================================
+// push()/pop() викликає лише власник, steal() - будь-який інший потік.
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t log_capacity = 8);
+    ~WorkStealingDeque();
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    void push(Task* task);
+    Task* pop();
+    Task* steal();
+    bool empty() const;
+
+private:
+    struct Ring {
+        explicit Ring(size_t log_cap)
+            : mask((size_t(1) << log_cap) - 1), slots(new std::atomic<Task*>[size_t(1) << log_cap]) {}
+        size_t capacity() const { return mask + 1; }
+        Task* get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, Task* t) { slots[i & mask].store(t, std::memory_order_relaxed); }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+    };
+
+    Ring* grow(Ring* ring, int64_t top, int64_t bottom);
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::atomic<Ring*> ring_;
+    // Старі кільця тримаємо до знищення deque - steal() може ще їх читати
+    std::vector<std::unique_ptr<Ring>> retired_;
+};
+
+// ============================================================================
+// ThreadPool
+// ============================================================================
 class ThreadPool {
 public:
     ThreadPool(size_t num_threads);
     ~ThreadPool();
 
-    // Submit a task
-    void enqueue(std::function<void()> task);
+    // Submit a task (Interactive lane)
+    void enqueue(std::function<void()> task) {
+        enqueue(TaskLane::Interactive, std::move(task));
+    }
+
+    // Submit a task into a specific lane
+    template <typename F>
+    void enqueue(TaskLane lane, F&& fn) {
+        submit(new Task(std::forward<F>(fn), lane));
+    }
 
     // Wait for all tasks
     void wait();
 
+    // Максимум одночасно виконуваних задач lane'а (0 = без обмежень)
+    void set_lane_limit(TaskLane lane, size_t max_concurrent);
+    size_t lane_limit(TaskLane lane) const;
+
+    size_t size() const { return workers_.size(); }
+
+    struct Stats {
+        uint64_t executed[kTaskLaneCount];
+        uint64_t stolen;
+        uint64_t injected;
+    };
+    Stats stats() const;
+
 private:
+    struct Lane {
+        std::mutex inject_mutex;
+        std::deque<Task*> inject;
+        std::atomic<size_t> inject_size{0};
+        std::atomic<size_t> running{0};
+        std::atomic<size_t> limit{0};
+        std::atomic<uint64_t> executed{0};
+    };
+
+    struct Worker {
+        WorkStealingDeque deques[kTaskLaneCount];
+    };
+
+    void submit(Task* task);
+    void worker_loop(size_t index);
+    Task* find_task(size_t index);
+    Task* take_from_lane(size_t index, size_t lane);
+    bool try_acquire_lane(size_t lane);
+    void release_lane(size_t lane);
+    void run(Task* task);
+    void wake_one();
+
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
-    std::mutex queue_mutex_;
-    std::condition_variable condition_;
+    std::vector<std::unique_ptr<Worker>> locals_;
+    Lane lanes_[kTaskLaneCount];
+
+    // Сон workers: epoch зростає на кожен submit і звільнення ліміту lane'а
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<size_t> sleeping_{0};
+
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+
     std::atomic<bool> stop_;
-    std::atomic<size_t> active_tasks_;
+    std::atomic<size_t> active_tasks_;   // submitted, ще не завершені
+    std::atomic<size_t> queued_tasks_;   // submitted, ще не взяті worker'ом
+    std::atomic<uint64_t> stolen_{0};
+    std::atomic<uint64_t> injected_{0};
 };
 
 } // namespace util
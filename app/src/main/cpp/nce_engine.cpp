@@ -10,6 +10,7 @@
 
 #include "nce_engine.h"
 #include "signal_handler.h"
+#include "fastmem_mapper.h"
 #include "nce_jit/jit_compiler.h"
 #include "nce_core/nce_native.h"  // NCE Native - Real PS3 Execution
 #include <android/log.h>
@@ -97,6 +98,11 @@ static NCEContext g_nce_ctx = {
 static std::unique_ptr<JitCompiler> g_jit_compiler;
 static PPCState g_ppc_state = {};  // Emulated PS3 Cell PPU state
 
+// Fastmem faults inside JIT code (MMIO / RSX) -> backpatch to slow path
+static bool HandleJITFastmemFault(void* fault_addr, void* ucontext) {
+    return g_jit_compiler && g_jit_compiler->HandleFastmemFault(fault_addr, ucontext);
+}
+
 // NCE Native instance
 static std::unique_ptr<NativeCodeExecutor> g_nce_native;
 
@@ -183,24 +189,31 @@ bool InitializeNCE() {
     g_nce_ctx.active = true;
     g_nce_ctx.regs_valid = false;
     
+    // Fastmem: guest EA 32-бітна, тож JIT потрібне вікно щонайменше 4GB
+    void* fastmem_base = rpcsx::memory::GetFastmemBase();
+    size_t fastmem_size = 0;
+    rpcsx::memory::GetFastmemStats(nullptr, nullptr, &fastmem_size);
+    const bool use_fastmem = fastmem_base && fastmem_size >= (4ULL << 30);
+    
     // Initialize JIT Compiler
     JitConfig jit_cfg;
     jit_cfg.code_cache_size = 64 * 1024 * 1024;  // 64MB JIT cache
     jit_cfg.max_block_size = 4096;
     jit_cfg.enable_block_linking = true;
-    jit_cfg.enable_fast_memory = true;
+    jit_cfg.enable_fast_memory = use_fastmem;
     
     g_jit_compiler = std::make_unique<JitCompiler>(jit_cfg);
     if (!g_jit_compiler->Initialize()) {
         LOGE("Failed to initialize JIT compiler");
         // Continue anyway - JIT is optional
     } else {
-        LOGI("JIT Compiler initialized (64MB cache)");
+        LOGI("JIT Compiler initialized (64MB cache, fastmem %s)", use_fastmem ? "on" : "off");
+        rpcsx::crash::AddFastmemFaultHandler(HandleJITFastmemFault);
     }
     
     // Initialize PPC state for PS3 Cell PPU
     memset(&g_ppc_state, 0, sizeof(g_ppc_state));
-    g_ppc_state.memory_base = g_nce_ctx.code_cache;
+    g_ppc_state.memory_base = use_fastmem ? fastmem_base : g_nce_ctx.code_cache;
     
     LOGI("NCE Engine initialized:");
     LOGI("  - Code cache: %zu MB at %p", g_nce_ctx.cache_size / (1024 * 1024), g_nce_ctx.code_cache);
@@ -558,6 +571,16 @@ void EmulateSPUWithSVE2(const void* spu_code, void* registers) {
     }
 }
 
+/**
+ * VMX fast math з профілю гри; JIT скидає кеш, якщо режим змінився
+ */
+void SetVMXFastMath(bool enable) {
+    if (!g_jit_compiler) return;
+    
+    g_jit_compiler->SetVmxFastMath(enable);
+    LOGI("NCE VMX fast math: %s", enable ? "on" : "off");
+}
+
 /**
  * Інвалідація code cache (потрібно при зміні пам'яті гри)
  */
@@ -604,6 +627,7 @@ void ShutdownNCE() {
     
     // Shutdown JIT compiler
     if (g_jit_compiler) {
+        rpcsx::crash::RemoveFastmemFaultHandler(HandleJITFastmemFault);
         g_jit_compiler->Shutdown();
         g_jit_compiler.reset();
         LOGI("JIT Compiler shutdown");
@@ -94,6 +94,12 @@ void EmulateSPUWithSVE2(const void* spu_code, void* registers);
  */
 void InvalidateCodeCache();
 
+/**
+ * Режим VMX трансляції для поточної гри (з профілю)
+ * @param enable true = без VSCR[SAT] і точного знаку vnmsubfp
+ */
+void SetVMXFastMath(bool enable);
+
 /**
  * Завершення роботи NCE
  */
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <atomic>
 
+#include "signal_handler.h"
 #include "nce_jit/jit_compiler.h"
 #include "nce_jit/ppc_decoder.h"
 #include "nce_jit/arm64_emitter.h"
@@ -24,6 +25,10 @@ static rpcsx::nce::PPCState g_ppu_state;
 static std::atomic<bool> g_nce_enabled{false};
 static std::atomic<uint64_t> g_instructions_jitted{0};
 
+static bool HandleJITFastmemFault(void* fault_addr, void* ucontext) {
+    return g_jit && g_jit->HandleFastmemFault(fault_addr, ucontext);
+}
+
 // Original function pointers (from librpcsx.so)
 typedef void (*ppu_execute_fn)(void* ppu_thread, uint32_t addr);
 static ppu_execute_fn g_original_ppu_execute = nullptr;
@@ -48,6 +53,7 @@ bool InitializeNCEHook() {
     }
     
     memset(&g_ppu_state, 0, sizeof(g_ppu_state));
+    rpcsx::crash::AddFastmemFaultHandler(HandleJITFastmemFault);
     g_nce_enabled = true;
     
     LOGI("NCE PPU Hook initialized successfully!");
@@ -56,6 +62,7 @@ bool InitializeNCEHook() {
 
 void ShutdownNCEHook() {
     if (g_jit) {
+        rpcsx::crash::RemoveFastmemFaultHandler(HandleJITFastmemFault);
         g_jit->Shutdown();
         g_jit.reset();
     }
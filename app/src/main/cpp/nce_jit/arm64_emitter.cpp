@@ -242,47 +242,155 @@ bool PPCTranslator::Translate(const ppc::DecodedInstr& instr) {
 }
 
 // ============================================
-// CR0 Update Helper
+// Lazy CR / XER Flags
 // ============================================
 
 void PPCTranslator::EmitCR0Update(GpReg result) {
-    // CR0 is set based on comparison with 0:
-    // CR0[LT] = result < 0
-    // CR0[GT] = result > 0
-    // CR0[EQ] = result == 0
-    // CR0[SO] = XER[SO] (copied)
-    
-    // Compare result with 0 (sets ARM64 flags)
+    // CR0 = result vs 0 (signed), LT/GT/EQ з NZCV, SO з XER - при матеріалізації
+    BeginCRProducer(0);
     emit_.CMP(result, GpReg::ZR);
+    lazy_.kind = LazyFlags::Kind::CRSigned;
+    lazy_.field = 0;
+}
+
+void PPCTranslator::BeginCRProducer(uint8_t field) {
+    // Попередній запис того ж поля ніхто не прочитав - просто відкидаємо
+    const bool same_field = (lazy_.kind == LazyFlags::Kind::CRSigned ||
+                             lazy_.kind == LazyFlags::Kind::CRUnsigned) &&
+                            lazy_.field == field;
+    if (same_field) {
+        lazy_.kind = LazyFlags::Kind::None;
+    }
+    FlushFlags();
+}
+
+void PPCTranslator::BeginCarryProducer() {
+    if (lazy_.kind == LazyFlags::Kind::Carry) {
+        lazy_.kind = LazyFlags::Kind::None;
+    }
+    FlushFlags();
+}
+
+void PPCTranslator::FlushFlags() {
+    switch (lazy_.kind) {
+    case LazyFlags::Kind::None:
+        return;
+        
+    case LazyFlags::Kind::Carry:
+        // XER[CA] - біт 29
+        emit_.CSET(REG_TMP1, Cond::CS);
+        emit_.BFI(REG_XER, REG_TMP1, 29, 1);
+        break;
+        
+    case LazyFlags::Kind::CRSigned:
+    case LazyFlags::Kind::CRUnsigned: {
+        // CR field f займає біти [31-4f-3 .. 31-4f]: LT, GT, EQ, SO
+        const bool is_unsigned = lazy_.kind == LazyFlags::Kind::CRUnsigned;
+        const uint8_t shift = 28 - lazy_.field * 4;
+        
+        emit_.CSET(REG_TMP1, is_unsigned ? Cond::CC : Cond::LT);
+        emit_.BFI(REG_CR, REG_TMP1, shift + 3, 1);
+        emit_.CSET(REG_TMP1, is_unsigned ? Cond::HI : Cond::GT);
+        emit_.BFI(REG_CR, REG_TMP1, shift + 2, 1);
+        emit_.CSET(REG_TMP1, Cond::EQ);
+        emit_.BFI(REG_CR, REG_TMP1, shift + 1, 1);
+        emit_.LSR_IMM(REG_TMP1, REG_XER, 31);  // SO = XER[SO]
+        emit_.BFI(REG_CR, REG_TMP1, shift, 1);
+        break;
+    }
+    }
+    lazy_.kind = LazyFlags::Kind::None;
+}
+
+Cond PPCTranslator::EmitBranchCondition(uint8_t bi, bool branch_true) {
+    const uint8_t bit = bi & 3;
+    const bool pending_cr = lazy_.kind == LazyFlags::Kind::CRSigned ||
+                            lazy_.kind == LazyFlags::Kind::CRUnsigned;
     
-    // Build CR0 value based on flags
-    // Use CSET to extract each flag
-    emit_.CSET(REG_TMP1, Cond::LT);     // LT bit
-    emit_.LSL_IMM(REG_TMP1, REG_TMP1, 3);
-    
-    emit_.CSET(REG_TMP2, Cond::GT);     // GT bit
-    emit_.LSL_IMM(REG_TMP2, REG_TMP2, 2);
-    emit_.ORR(REG_TMP1, REG_TMP1, REG_TMP2);
-    
-    emit_.CSET(REG_TMP2, Cond::EQ);     // EQ bit
-    emit_.LSL_IMM(REG_TMP2, REG_TMP2, 1);
-    emit_.ORR(REG_TMP1, REG_TMP1, REG_TMP2);
+    if (pending_cr && lazy_.field == bi / 4 && bit != 3) {
+        // cmp + bc -> cmp + b.cond; поле все одно матеріалізується для
+        // наступних блоків, але CSET/BFI не чіпають NZCV
+        const bool is_unsigned = lazy_.kind == LazyFlags::Kind::CRUnsigned;
+        Cond cond;
+        switch (bit) {
+        case 0:  cond = is_unsigned ? Cond::CC : Cond::LT; break;
+        case 1:  cond = is_unsigned ? Cond::HI : Cond::GT; break;
+        default: cond = Cond::EQ; break;
+        }
+        FlushFlags();
+        return branch_true ? cond : static_cast<Cond>(static_cast<uint8_t>(cond) ^ 1);
+    }
     
-    // Copy SO from XER (bit 0 of CR0)
-    // For simplicity, assume SO is stored in a known location
-    // TODO: Properly track XER[SO]
+    // Біт уже в REG_CR (або SO) - перевіряємо напряму
+    FlushFlags();
+    emit_.TST_IMM(REG_CR, 1ull << (31 - bi));
+    return branch_true ? Cond::NE : Cond::EQ;
+}
+
+// ============================================
+// Fastmem Load/Store Helpers
+// ============================================
+
+static uint8_t GuestAccessSize(ppc::InstrType type) {
+    switch (type) {
+    case ppc::InstrType::LOAD_DOUBLE:
+    case ppc::InstrType::STORE_DOUBLE:
+        return 8;
+    case ppc::InstrType::LOAD_HALF:
+    case ppc::InstrType::STORE_HALF:
+        return 2;
+    case ppc::InstrType::LOAD_BYTE:
+    case ppc::InstrType::STORE_BYTE:
+        return 1;
+    default:
+        return 4;
+    }
+}
+
+void PPCTranslator::EmitEffectiveAddress(const ppc::DecodedInstr& instr) {
+    // EA -> REG_TMP1: X-form (OP31) = (rA|0) + rB, D-form = (rA|0) + d
+    if (instr.primary == ppc::PrimaryOp::OP31) {
+        if (instr.rA == 0) {
+            emit_.MOV(REG_TMP1, MapPPCGPR(instr.rB));
+        } else {
+            emit_.ADD(REG_TMP1, MapPPCGPR(instr.rA), MapPPCGPR(instr.rB));
+        }
+    } else if (instr.rA == 0) {
+        emit_.MOVi(REG_TMP1, instr.simm);
+    } else {
+        emit_.ADDi(REG_TMP1, MapPPCGPR(instr.rA), instr.simm);
+    }
+}
+
+void PPCTranslator::EmitFastmemLoad(const ppc::DecodedInstr& instr, uint8_t size) {
+    GpReg rd = MapPPCGPR(instr.rD);
+    EmitEffectiveAddress(instr);
     
-    // Store CR0 field (bits 0-3 of CR)
-    // CR is stored in REG_CR, CR0 is the highest 4 bits
-    emit_.LSL_IMM(REG_TMP1, REG_TMP1, 28);  // Shift to CR0 position
+    // Один ldr + rev; MMIO/RSX сторінки фолтять і backpatch'аться на slow path
+    fastmem_sites_->push_back({fastmem_buf_->GetCurrent(), size, false, rd, REG_TMP1});
+    emit_.LDR_GUEST(size, rd, REG_TMP1);
+    emit_.BSWAP_GUEST(size, rd, rd);
+}
+
+void PPCTranslator::EmitFastmemStore(const ppc::DecodedInstr& instr, uint8_t size) {
+    GpReg rs = MapPPCGPR(instr.rS);
+    EmitEffectiveAddress(instr);
     
-    // Clear CR0 field in CR and OR in new value
-    emit_.MOV_IMM64(REG_TMP2, 0x0FFFFFFF);  // Mask to clear CR0
-    emit_.AND(REG_CR, REG_CR, REG_TMP2);
-    emit_.ORR(REG_CR, REG_CR, REG_TMP1);
+    GpReg value = rs;
+    if (size > 1) {
+        emit_.BSWAP_GUEST(size, REG_TMP2, rs);
+        value = REG_TMP2;
+    }
+    fastmem_sites_->push_back({fastmem_buf_->GetCurrent(), size, true, value, REG_TMP1});
+    emit_.STR_GUEST(size, value, REG_TMP1);
 }
 
 void PPCTranslator::EmitLoad(const ppc::DecodedInstr& instr) {
+    if (fastmem_sites_) {
+        EmitFastmemLoad(instr, GuestAccessSize(instr.type));
+        return;
+    }
+    
     GpReg rd = MapPPCGPR(instr.rD);
     GpReg ra = MapPPCGPR(instr.rA);
     int32_t offset = instr.simm;
@@ -325,6 +433,11 @@ void PPCTranslator::EmitLoad(const ppc::DecodedInstr& instr) {
 }
 
 void PPCTranslator::EmitStore(const ppc::DecodedInstr& instr) {
+    if (fastmem_sites_) {
+        EmitFastmemStore(instr, GuestAccessSize(instr.type));
+        return;
+    }
+    
     GpReg rs = MapPPCGPR(static_cast<ppc::GPR>(instr.rD));  // Source register
     GpReg ra = MapPPCGPR(instr.rA);
     int32_t offset = instr.simm;
@@ -447,22 +560,29 @@ void PPCTranslator::EmitAdd(const ppc::DecodedInstr& instr) {
         }
         break;
         
+    case ppc::InstrType::ADDIC:
+        // addic rd, ra, simm: CA = carry out (лише host C, XER - лениво)
+        BeginCarryProducer();
+        emit_.MOV_IMM64(REG_TMP1, instr.simm);
+        emit_.ADDS(rd, ra, REG_TMP1);
+        lazy_.kind = LazyFlags::Kind::Carry;
+        break;
+        
     case ppc::InstrType::ADD:
+        emit_.ADD(rd, ra, MapPPCGPR(instr.rB));
+        break;
+        
     case ppc::InstrType::ADDC:
-        {
-            GpReg rb = MapPPCGPR(instr.rB);
-            if (instr.rc) {
-                emit_.ADDS(rd, ra, rb);
-                // Update CR0 based on result
-            } else {
-                emit_.ADD(rd, ra, rb);
-            }
-        }
+        BeginCarryProducer();
+        emit_.ADDS(rd, ra, MapPPCGPR(instr.rB));
+        lazy_.kind = LazyFlags::Kind::Carry;
         break;
         
     default:
         break;
     }
+    
+    if (instr.rc) EmitCR0Update(rd);
 }
 
 void PPCTranslator::EmitSub(const ppc::DecodedInstr& instr) {
@@ -471,27 +591,30 @@ void PPCTranslator::EmitSub(const ppc::DecodedInstr& instr) {
     
     switch (instr.type) {
     case ppc::InstrType::SUBFIC:
-        // subfic rd, ra, simm: rd = simm - ra
+        // subfic rd, ra, simm: rd = simm - ra; CA = no borrow = host C
+        BeginCarryProducer();
         emit_.MOV_IMM64(REG_TMP1, instr.simm);
-        emit_.SUB(rd, REG_TMP1, ra);
+        emit_.SUBS(rd, REG_TMP1, ra);
+        lazy_.kind = LazyFlags::Kind::Carry;
         break;
         
     case ppc::InstrType::SUBF:
+        // subf rd, ra, rb: rd = rb - ra
+        emit_.SUB(rd, MapPPCGPR(instr.rB), ra);
+        break;
+        
     case ppc::InstrType::SUB:
-        {
-            // subf rd, ra, rb: rd = rb - ra
-            GpReg rb = MapPPCGPR(instr.rB);
-            if (instr.rc) {
-                emit_.SUBS(rd, rb, ra);
-            } else {
-                emit_.SUB(rd, rb, ra);
-            }
-        }
+        // subfc rd, ra, rb: rd = rb - ra, CA
+        BeginCarryProducer();
+        emit_.SUBS(rd, MapPPCGPR(instr.rB), ra);
+        lazy_.kind = LazyFlags::Kind::Carry;
         break;
         
     default:
         break;
     }
+    
+    if (instr.rc) EmitCR0Update(rd);
 }
 
 void PPCTranslator::EmitMul(const ppc::DecodedInstr& instr) {
@@ -612,6 +735,8 @@ void PPCTranslator::EmitLogic(const ppc::DecodedInstr& instr) {
     default:
         break;
     }
+    
+    if (instr.rc) EmitCR0Update(ra);
 }
 
 void PPCTranslator::EmitShift(const ppc::DecodedInstr& instr) {
@@ -639,6 +764,8 @@ void PPCTranslator::EmitShift(const ppc::DecodedInstr& instr) {
     default:
         break;
     }
+    
+    if (instr.rc) EmitCR0Update(ra);
 }
 
 void PPCTranslator::EmitRotate(const ppc::DecodedInstr& instr) {
@@ -669,44 +796,62 @@ void PPCTranslator::EmitRotate(const ppc::DecodedInstr& instr) {
     emit_.ROR_IMM(REG_TMP1, rs, ror_amount);
     emit_.MOV_IMM64(REG_TMP2, mask);
     emit_.AND(ra, REG_TMP1, REG_TMP2);
+    
+    if (instr.rc) EmitCR0Update(ra);
 }
 
 void PPCTranslator::EmitCompare(const ppc::DecodedInstr& instr) {
     GpReg ra = MapPPCGPR(instr.rA);
+    const uint8_t field = (instr.raw >> 23) & 7;          // crfD
+    const bool is_word = ((instr.raw >> 21) & 1) == 0;    // L=0: cmpw / cmplw
+    const bool is_unsigned = instr.type == ppc::InstrType::CMPL ||
+                             instr.type == ppc::InstrType::CMPLI;
+    
+    // Лише CMP: CR field матеріалізується, коли його прочитають
+    BeginCRProducer(field);
     
+    GpReg rb;
     switch (instr.type) {
     case ppc::InstrType::CMPI:
         // cmpi crD, L, ra, simm
-        emit_.CMP_IMM(ra, instr.simm);
-        // TODO: Store flags to CR field
+        if (!is_word && instr.simm > -4096 && instr.simm < 4096) {
+            emit_.CMP_IMM(ra, instr.simm);
+            lazy_.kind = LazyFlags::Kind::CRSigned;
+            lazy_.field = field;
+            return;
+        }
+        emit_.MOV_IMM64(REG_TMP1, instr.simm);
+        rb = REG_TMP1;
         break;
         
     case ppc::InstrType::CMPLI:
         // cmpli crD, L, ra, uimm
         emit_.MOV_IMM64(REG_TMP1, instr.uimm);
-        emit_.CMP(ra, REG_TMP1);
+        rb = REG_TMP1;
         break;
         
     case ppc::InstrType::CMP:
-        {
-            GpReg rb = MapPPCGPR(instr.rB);
-            emit_.CMP(ra, rb);
-        }
-        break;
-        
     case ppc::InstrType::CMPL:
-        {
-            GpReg rb = MapPPCGPR(instr.rB);
-            emit_.CMP(ra, rb);  // Same encoding, flags indicate unsigned
-        }
+        rb = MapPPCGPR(instr.rB);
         break;
         
     default:
-        break;
+        return;
+    }
+    
+    if (is_word) {
+        emit_.CMP_W(ra, rb);
+    } else {
+        emit_.CMP(ra, rb);
     }
+    lazy_.kind = is_unsigned ? LazyFlags::Kind::CRUnsigned : LazyFlags::Kind::CRSigned;
+    lazy_.field = field;
 }
 
 void PPCTranslator::EmitBranch(const ppc::DecodedInstr& instr) {
+    // Вихід з блоку - відкладені прапорці мають бути в REG_CR / REG_XER
+    if (instr.type != ppc::InstrType::BC) FlushFlags();
+    
     switch (instr.type) {
     case ppc::InstrType::B:
         // Unconditional branch
@@ -728,23 +873,16 @@ void PPCTranslator::EmitBranch(const ppc::DecodedInstr& instr) {
             // Decode BO field
             if ((bo & 0x14) == 0x14) {
                 // Always branch
+                FlushFlags();
                 cond = Cond::AL;
             } else if (bo & 0x10) {
                 // Branch if CTR != 0
+                FlushFlags();
                 emit_.SUB_IMM(REG_CTR, REG_CTR, 1);
                 cond = Cond::NE;
             } else {
-                // Branch based on CR bit
-                uint8_t bi = instr.bi;
-                bool branch_true = (bo & 0x08) != 0;
-                
-                // Map CR bit to ARM64 condition
-                switch (bi & 3) {
-                case 0: cond = branch_true ? Cond::LT : Cond::GE; break;  // LT
-                case 1: cond = branch_true ? Cond::GT : Cond::LE; break;  // GT
-                case 2: cond = branch_true ? Cond::EQ : Cond::NE; break;  // EQ
-                case 3: cond = branch_true ? Cond::VS : Cond::VC; break;  // SO/OV
-                }
+                // Branch based on CR bit (злиття з відкладеним cmp)
+                cond = EmitBranchCondition(instr.bi, (bo & 0x08) != 0);
             }
             
             emit_.B_COND(cond, instr.li);
@@ -775,6 +913,8 @@ void PPCTranslator::EmitBranch(const ppc::DecodedInstr& instr) {
 }
 
 void PPCTranslator::EmitSystem(const ppc::DecodedInstr& instr) {
+    FlushFlags();
+    
     // sc - system call
     // Trap to hypervisor/kernel
     emit_.SVC(0);
@@ -783,6 +923,12 @@ void PPCTranslator::EmitSystem(const ppc::DecodedInstr& instr) {
 void PPCTranslator::EmitSPR(const ppc::DecodedInstr& instr) {
     GpReg rd = MapPPCGPR(instr.rD);
     
+    // mfcr / mtcrf / XER читають або перезаписують відкладені прапорці
+    const bool touches_flags = instr.type == ppc::InstrType::MFCR ||
+                               instr.type == ppc::InstrType::MTCRF ||
+                               (instr.spr != 8 && instr.spr != 9);
+    if (touches_flags) FlushFlags();
+    
     switch (instr.type) {
     case ppc::InstrType::MFSPR:
         // Move from special purpose register
@@ -854,6 +1000,8 @@ void PPCTranslator::EmitTrap(const ppc::DecodedInstr& instr) {
     GpReg ra = MapPPCGPR(instr.rA);
     uint8_t to = instr.bo;  // TO field stored in bo
     
+    FlushFlags();  // CMP нижче перезаписує NZCV
+    
     if (instr.type == ppc::InstrType::TWI) {
         // twi TO, rA, SIMM
         emit_.MOV_IMM64(REG_TMP1, instr.simm);
@@ -898,6 +1046,7 @@ void PPCTranslator::EmitTrap(const ppc::DecodedInstr& instr) {
 void PPCTranslator::EmitCRLogic(const ppc::DecodedInstr& instr) {
     // CR logical operations operate on individual bits
     // crand, cror, crxor, etc.
+    FlushFlags();
     
     // Extract bit positions from instruction
     uint8_t bt = static_cast<uint8_t>(instr.rD);  // Target bit
@@ -1100,9 +1249,185 @@ void PPCTranslator::EmitFPArith(const ppc::DecodedInstr& instr) {
     
     // Update CR1 if Rc bit is set (not commonly used for FP)
     if (instr.rc) {
+        FlushFlags();
         // Copy FPSCR exception bits to CR1
         emit_.NOP();  // Simplified for now
     }
 }
 
+// ============================================
+// AltiVec / VMX
+// ============================================
+
+// VR у PPCState зберігаються як rpcs3 v128: 16 байт у зворотному порядку, тож
+// guest елемент 0 лежить у старших host лейнах. Лейнові операції - одна NEON
+// інструкція, pack кладе b у нижню половину, a у верхню, vperm індексує {b, a} через ~c.
+static bool IsSupportedVMX(bool va_form, uint32_t xo) {
+    if (va_form) {
+        return xo == 42 || xo == 43 || xo == 46 || xo == 47;
+    }
+    
+    switch (xo) {
+    case 0: case 64: case 128:          // vaddubm, vadduhm, vadduwm
+    case 1024: case 1088: case 1152:    // vsububm, vsubuhm, vsubuwm
+    case 10: case 74:                   // vaddfp, vsubfp
+    case 1034: case 1098:               // vmaxfp, vminfp
+    case 1028: case 1092: case 1156:    // vand, vandc, vor
+    case 1220: case 1284:               // vxor, vnor
+    case 14: case 78:                   // vpkuhum, vpkuwum
+    case 142: case 206:                 // vpkuhus, vpkuwus
+    case 270: case 334:                 // vpkshus, vpkswus
+    case 398: case 462:                 // vpkshss, vpkswss
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool PPCTranslator::TranslateVMX(const ppc::DecodedInstr& instr) {
+    if (vmx_vr_offset_ < 0) return false;
+    
+    const uint32_t raw = instr.raw;
+    const uint32_t vd = (raw >> 21) & 0x1F;
+    const uint32_t va = (raw >> 16) & 0x1F;
+    const uint32_t vb = (raw >> 11) & 0x1F;
+    const uint32_t vc = (raw >> 6) & 0x1F;
+    
+    // VA-form (xo 32-63 у бітах 26-31) або VX-form (xo у бітах 21-31)
+    const bool va_form = (raw & 0x20) != 0;
+    const uint32_t xo = va_form ? (raw & 0x3F) : (raw & 0x7FF);
+    if (!IsSupportedVMX(va_form, xo)) return false;
+    
+    // B і A сусідні - таблиця для TBL2
+    constexpr VecReg B = VecReg::V16;
+    constexpr VecReg A = VecReg::V17;
+    constexpr VecReg C = VecReg::V18;
+    constexpr VecReg T = VecReg::V19;
+    auto vr = [this](uint32_t n) { return vmx_vr_offset_ + static_cast<int32_t>(n) * 16; };
+    
+    // Guest f16-f19 (нижні 64 біти) на час операції
+    emit_.STP_D(B, A, REG_STATE, vmx_spill_offset_);
+    emit_.STP_D(C, T, REG_STATE, vmx_spill_offset_ + 16);
+    
+    emit_.LDR_VEC(A, REG_STATE, vr(va));
+    emit_.LDR_VEC(B, REG_STATE, vr(vb));
+    if (va_form) {
+        emit_.LDR_VEC(C, REG_STATE, vr(vc));
+    }
+    
+    VecReg result = A;
+    if (va_form) {
+        switch (xo) {
+        case 42:  // vsel: (c & b) | (~c & a)
+            emit_.BSL_VEC(C, B, A);
+            result = C;
+            break;
+        case 43:  // vperm
+            emit_.MOVI_16B(T, 0x1F);
+            emit_.BIC_VEC(T, T, C);
+            emit_.TBL2_16B(C, B, T);
+            result = C;
+            break;
+        case 46:  // vmaddfp: a * c + b
+            emit_.FMLA_4S(B, A, C);
+            result = B;
+            break;
+        case 47:  // vnmsubfp: -(a * c - b)
+            if (vmx_fast_math_) {
+                emit_.FMLS_4S(B, A, C);
+            } else {
+                emit_.FNEG_4S(B, B);
+                emit_.FMLA_4S(B, A, C);
+                emit_.FNEG_4S(B, B);
+            }
+            result = B;
+            break;
+        }
+    } else {
+        switch (xo) {
+        case 0: case 64: case 128:
+            emit_.ADD_VEC(A, A, B, static_cast<uint8_t>(xo >> 6));
+            break;
+        case 1024: case 1088: case 1152:
+            emit_.SUB_VEC(A, A, B, static_cast<uint8_t>((xo - 1024) >> 6));
+            break;
+        case 10:
+            emit_.FADD_4S(A, A, B);
+            break;
+        case 74:
+            emit_.FSUB_4S(A, A, B);
+            break;
+        case 1034:
+            emit_.FMAX_4S(A, A, B);
+            break;
+        case 1098:
+            emit_.FMIN_4S(A, A, B);
+            break;
+        case 1028:
+            emit_.AND_VEC(A, A, B);
+            break;
+        case 1092:
+            emit_.BIC_VEC(A, A, B);
+            break;
+        case 1156:
+            emit_.ORR_VEC(A, A, B);
+            break;
+        case 1220:
+            emit_.EOR_VEC(A, A, B);
+            break;
+        case 1284:
+            emit_.ORR_VEC(A, A, B);
+            emit_.NOT_VEC(A, A);
+            break;
+        default: {
+            // vpk*: біт 6 - halfword/word джерело, біти 7-8 - тип насичення
+            const uint8_t size = static_cast<uint8_t>((xo >> 6) & 1);
+            const uint32_t kind = xo >> 7;
+            const bool track_sat = kind != 0 && !vmx_fast_math_;
+            
+            if (track_sat) {
+                emit_.MSR_FPSR(GpReg::ZR);
+            }
+            switch (kind) {
+            case 0:
+                emit_.XTN_VEC(T, B, size, false);
+                emit_.XTN_VEC(T, A, size, true);
+                break;
+            case 1:
+                emit_.UQXTN_VEC(T, B, size, false);
+                emit_.UQXTN_VEC(T, A, size, true);
+                break;
+            case 2:
+                emit_.SQXTUN_VEC(T, B, size, false);
+                emit_.SQXTUN_VEC(T, A, size, true);
+                break;
+            default:
+                emit_.SQXTN_VEC(T, B, size, false);
+                emit_.SQXTN_VEC(T, A, size, true);
+                break;
+            }
+            if (track_sat) {
+                EmitVMXSaturation();
+            }
+            result = T;
+            break;
+        }
+        }
+    }
+    
+    emit_.STR_VEC(result, REG_STATE, vr(vd));
+    emit_.LDP_D(B, A, REG_STATE, vmx_spill_offset_);
+    emit_.LDP_D(C, T, REG_STATE, vmx_spill_offset_ + 16);
+    return true;
+}
+
+void PPCTranslator::EmitVMXSaturation() {
+    // VSCR[SAT] |= FPSR.QC (NZCV не зачіпається - lazy flags лишаються валідними)
+    emit_.MRS_FPSR(REG_TMP1);
+    emit_.UBFM(REG_TMP1, REG_TMP1, 27, 27);
+    emit_.LDR_W(REG_TMP2, REG_STATE, vmx_vscr_offset_);
+    emit_.ORR_W(REG_TMP2, REG_TMP2, REG_TMP1);
+    emit_.STR_W(REG_TMP2, REG_STATE, vmx_vscr_offset_);
+}
+
 } // namespace rpcsx::nce::arm64
@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
+#include <vector>
 #include "ppc_decoder.h"
 
 namespace rpcsx::nce::arm64 {
@@ -58,16 +59,48 @@ constexpr GpReg REG_XER = GpReg::X23;     // XER (carry, overflow)
 constexpr GpReg REG_CR = GpReg::X24;      // Condition Register
 constexpr GpReg REG_TMP1 = GpReg::X25;    // Temp register 1
 constexpr GpReg REG_TMP2 = GpReg::X26;    // Temp register 2
+constexpr GpReg REG_TMP3 = GpReg::X27;    // Temp register 3 (indirect branch target)
+constexpr GpReg REG_MEMBASE = GpReg::X28; // Fastmem base (pinned, guest address 0)
+
+// Guest memory access emitted through REG_MEMBASE (recorded for fault backpatching)
+struct FastmemAccess {
+    uint32_t* insn;          // ldr/str instruction
+    uint8_t size;            // 1, 2, 4, 8 bytes
+    bool store;
+    GpReg rt;                // Value register (stores: already byte-swapped)
+    GpReg ea;                // Guest effective address register
+};
+
+// Encodings for patching already emitted branches (block linking)
+inline uint32_t EncodeNOP() {
+    return 0xD503201F;
+}
+
+inline uint32_t EncodeB(ptrdiff_t offset) {
+    return 0x14000000 | (static_cast<uint32_t>(offset >> 2) & 0x3FFFFFF);
+}
+
+inline uint32_t EncodeBCond(Cond cond, ptrdiff_t offset) {
+    return 0x54000000 | ((static_cast<uint32_t>(offset >> 2) & 0x7FFFF) << 5) |
+           static_cast<uint32_t>(cond);
+}
+
+// B має діапазон +-128MB
+inline bool IsBranchInRange(ptrdiff_t offset) {
+    return offset >= -(ptrdiff_t(1) << 27) && offset < (ptrdiff_t(1) << 27);
+}
 
 /**
  * ARM64 Code Buffer with instruction emission
  */
 class CodeBuffer {
 public:
-    CodeBuffer(void* buffer, size_t capacity)
+    // write_offset: writable alias - buffer (dual-mapped code cache), addresses stay executable
+    CodeBuffer(void* buffer, size_t capacity, ptrdiff_t write_offset = 0)
         : base_(static_cast<uint32_t*>(buffer))
         , current_(static_cast<uint32_t*>(buffer))
-        , capacity_(capacity / 4) {}
+        , capacity_(capacity / 4)
+        , write_offset_(write_offset) {}
     
     // Current position in buffer
     uint32_t* GetCurrent() const { return current_; }
@@ -77,10 +110,15 @@ public:
     // Emit raw instruction
     void Emit(uint32_t instr) {
         if (current_ - base_ < static_cast<ptrdiff_t>(capacity_)) {
-            *current_++ = instr;
+            *Writable(current_++) = instr;
         }
     }
     
+    // Writable alias of an emitted instruction (for patching placeholders)
+    uint32_t* Writable(uint32_t* insn) const {
+        return reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(insn) + write_offset_);
+    }
+    
     // Reset buffer
     void Reset() { current_ = base_; }
     
@@ -88,6 +126,7 @@ private:
     uint32_t* base_;
     uint32_t* current_;
     size_t capacity_;
+    ptrdiff_t write_offset_;
 };
 
 /**
@@ -178,6 +217,12 @@ public:
                   (static_cast<uint32_t>(rn) << 5) | static_cast<uint32_t>(rd));
     }
     
+    // ADD Xd, Xn, Xm, LSL #shift
+    void ADD_LSL(GpReg rd, GpReg rn, GpReg rm, uint8_t shift) {
+        buf_.Emit(0x8B000000 | (static_cast<uint32_t>(rm) << 16) | ((shift & 0x3F) << 10) |
+                  (static_cast<uint32_t>(rn) << 5) | static_cast<uint32_t>(rd));
+    }
+    
     // ADD Xd, Xn, #imm12
     void ADD_IMM(GpReg rd, GpReg rn, uint16_t imm12) {
         buf_.Emit(0x91000000 | ((imm12 & 0xFFF) << 10) | 
@@ -312,6 +357,24 @@ public:
         ANDS(GpReg::ZR, rn, rm);
     }
     
+    // TST Xn, #imm (ANDS XZR, Xn, #imm; logical immediate)
+    void TST_IMM(GpReg rn, uint64_t imm) {
+        uint32_t n, immr, imms;
+        if (EncodeBitmaskImm(imm, n, immr, imms)) {
+            buf_.Emit(0xF2000000 | (n << 22) | (immr << 16) | (imms << 10) |
+                      (static_cast<uint32_t>(rn) << 5) | 31);
+        }
+    }
+    
+    // MRS Xt, NZCV / MSR NZCV, Xt
+    void MRS_NZCV(GpReg rt) {
+        buf_.Emit(0xD53B4200 | static_cast<uint32_t>(rt));
+    }
+    
+    void MSR_NZCV(GpReg rt) {
+        buf_.Emit(0xD51B4200 | static_cast<uint32_t>(rt));
+    }
+    
     // ============================================
     // Additional Arithmetic for PowerPC
     // ============================================
@@ -509,6 +572,11 @@ public:
                   (static_cast<uint32_t>(rn) << 5) | static_cast<uint32_t>(rd));
     }
     
+    // BFI Xd, Xn, #lsb, #width = BFM Xd, Xn, #(-lsb MOD 64), #(width-1)
+    void BFI(GpReg rd, GpReg rn, uint8_t lsb, uint8_t width) {
+        BFM(rd, rn, (-lsb) & 63, width - 1);
+    }
+    
     // EXTR Xd, Xn, Xm, #lsb (extract bits from pair)
     void EXTR(GpReg rd, GpReg rn, GpReg rm, uint8_t lsb) {
         buf_.Emit(0x93C00000 | (static_cast<uint32_t>(rm) << 16) | 
@@ -686,6 +754,33 @@ public:
                   static_cast<uint32_t>(rt));
     }
     
+    // ============================================
+    // Guest Memory (fastmem)
+    // ============================================
+    
+    // LDR{B,H,W,X} rt, [REG_MEMBASE, Wea, UXTW]
+    // Guest EA 32-бітна - доступ не може вийти за 4GB fastmem вікно
+    void LDR_GUEST(uint8_t size, GpReg rt, GpReg ea) {
+        buf_.Emit(GuestAccessOpcode(size) | 0x00404800 | (static_cast<uint32_t>(ea) << 16) |
+                  (static_cast<uint32_t>(REG_MEMBASE) << 5) | static_cast<uint32_t>(rt));
+    }
+    
+    // STR{B,H,W,X} rt, [REG_MEMBASE, Wea, UXTW]
+    void STR_GUEST(uint8_t size, GpReg rt, GpReg ea) {
+        buf_.Emit(GuestAccessOpcode(size) | 0x00004800 | (static_cast<uint32_t>(ea) << 16) |
+                  (static_cast<uint32_t>(REG_MEMBASE) << 5) | static_cast<uint32_t>(rt));
+    }
+    
+    // Big-endian guest <-> little-endian host
+    void BSWAP_GUEST(uint8_t size, GpReg rd, GpReg rn) {
+        switch (size) {
+            case 8: REV(rd, rn); break;
+            case 4: REV_W(rd, rn); break;
+            case 2: REV16(rd, rn); break;
+            default: if (rd != rn) MOV(rd, rn); break;
+        }
+    }
+    
     // ============================================
     // Byte Reversal (for Big-Endian support)
     // ============================================
@@ -970,7 +1065,146 @@ public:
                   (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
     }
     
+    // FMAX/FMIN Vd.4S, Vn.4S, Vm.4S
+    void FMAX_4S(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x4E20F400 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    void FMIN_4S(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x4EA0F400 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // FMLA/FMLS Vd.4S, Vn.4S, Vm.4S (Vd +/-= Vn * Vm, одне округлення)
+    void FMLA_4S(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x4E20CC00 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    void FMLS_4S(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x4EA0CC00 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // FNEG Vd.4S, Vn.4S
+    void FNEG_4S(VecReg vd, VecReg vn) {
+        buf_.Emit(0x6EA0F800 | (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // ADD/SUB Vd.T, Vn.T, Vm.T (size: 0 = 16B, 1 = 8H, 2 = 4S, 3 = 2D)
+    void ADD_VEC(VecReg vd, VecReg vn, VecReg vm, uint8_t size) {
+        buf_.Emit(0x4E208400 | (static_cast<uint32_t>(size & 3) << 22) |
+                  (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    void SUB_VEC(VecReg vd, VecReg vn, VecReg vm, uint8_t size) {
+        buf_.Emit(0x6E208400 | (static_cast<uint32_t>(size & 3) << 22) |
+                  (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // AND/BIC/ORR/EOR Vd.16B, Vn.16B, Vm.16B (BIC: Vn & ~Vm)
+    void AND_VEC(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x4E201C00 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    void BIC_VEC(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x4E601C00 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    void ORR_VEC(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x4EA01C00 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    void EOR_VEC(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x6E201C00 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // NOT Vd.16B, Vn.16B
+    void NOT_VEC(VecReg vd, VecReg vn) {
+        buf_.Emit(0x6E205800 | (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // BSL Vd.16B, Vn.16B, Vm.16B: Vd = (Vd & Vn) | (~Vd & Vm)
+    void BSL_VEC(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x6E601C00 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // MOVI Vd.16B, #imm8
+    void MOVI_16B(VecReg vd, uint8_t imm) {
+        buf_.Emit(0x4F00E400 | (static_cast<uint32_t>(imm >> 5) << 16) |
+                  (static_cast<uint32_t>(imm & 0x1F) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // TBL Vd.16B, {Vn.16B, Vn+1.16B}, Vm.16B (індекси >= 32 дають 0)
+    void TBL2_16B(VecReg vd, VecReg vn, VecReg vm) {
+        buf_.Emit(0x4E002000 | (static_cast<uint32_t>(vm) << 16) | 
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // Narrowing: size - розмір результату (0 = байти з 8H, 1 = halfwords з 4S).
+    // upper = false пише нижню половину Vd і обнуляє верхню, upper = true (…2) - лише верхню.
+    void XTN_VEC(VecReg vd, VecReg vn, uint8_t size, bool upper) {
+        EmitNarrow(upper ? 0x4E212800 : 0x0E212800, vd, vn, size);
+    }
+    
+    void SQXTN_VEC(VecReg vd, VecReg vn, uint8_t size, bool upper) {
+        EmitNarrow(upper ? 0x4E214800 : 0x0E214800, vd, vn, size);
+    }
+    
+    void UQXTN_VEC(VecReg vd, VecReg vn, uint8_t size, bool upper) {
+        EmitNarrow(upper ? 0x6E214800 : 0x2E214800, vd, vn, size);
+    }
+    
+    void SQXTUN_VEC(VecReg vd, VecReg vn, uint8_t size, bool upper) {
+        EmitNarrow(upper ? 0x6E212800 : 0x2E212800, vd, vn, size);
+    }
+    
+    // STP/LDP Dt1, Dt2, [Xn, #offset] (offset кратний 8, до 504)
+    void STP_D(VecReg rt1, VecReg rt2, GpReg rn, int32_t offset) {
+        uint32_t imm7 = static_cast<uint32_t>(offset >> 3) & 0x7F;
+        buf_.Emit(0x6D000000 | (imm7 << 15) | (static_cast<uint32_t>(rt2) << 10) |
+                  (static_cast<uint32_t>(rn) << 5) | static_cast<uint32_t>(rt1));
+    }
+    
+    void LDP_D(VecReg rt1, VecReg rt2, GpReg rn, int32_t offset) {
+        uint32_t imm7 = static_cast<uint32_t>(offset >> 3) & 0x7F;
+        buf_.Emit(0x6D400000 | (imm7 << 15) | (static_cast<uint32_t>(rt2) << 10) |
+                  (static_cast<uint32_t>(rn) << 5) | static_cast<uint32_t>(rt1));
+    }
+    
+    // MRS Xt, FPSR / MSR FPSR, Xt (QC = біт 27, sticky насичення)
+    void MRS_FPSR(GpReg rt) {
+        buf_.Emit(0xD53B4420 | static_cast<uint32_t>(rt));
+    }
+    
+    void MSR_FPSR(GpReg rt) {
+        buf_.Emit(0xD51B4420 | static_cast<uint32_t>(rt));
+    }
+    
 private:
+    void EmitNarrow(uint32_t opcode, VecReg vd, VecReg vn, uint8_t size) {
+        buf_.Emit(opcode | (static_cast<uint32_t>(size & 3) << 22) |
+                  (static_cast<uint32_t>(vn) << 5) | static_cast<uint32_t>(vd));
+    }
+    
+    // size field (bits 30-31) + register offset form
+    static uint32_t GuestAccessOpcode(uint8_t size) {
+        switch (size) {
+            case 8: return 0xF8200000;
+            case 4: return 0xB8200000;
+            case 2: return 0x78200000;
+            default: return 0x38200000;
+        }
+    }
+    
     CodeBuffer& buf_;
 };
 
@@ -1059,13 +1293,61 @@ struct PPUStateOffsets {
 /**
  * PowerPC → ARM64 Code Generator
  */
+/**
+ * Lazy CR / XER[CA] flags
+ *
+ * Compare і record-form інструкції лише виставляють host NZCV і запам'ятовують
+ * producer. CR field / CA матеріалізуються тільки коли їх читають (bc, mfcr,
+ * CR logic, mfxer, вихід з блоку) або перед наступним producer'ом.
+ * Producer того ж CR field без читачів між ними - мертвий і не матеріалізується.
+ */
+struct LazyFlags {
+    enum class Kind : uint8_t {
+        None,
+        CRSigned,     // CR field = signed compare (cmp/cmpi, record forms vs 0)
+        CRUnsigned,   // CR field = unsigned compare (cmpl/cmpli)
+        Carry,        // XER[CA] = host C (addic/addc/subfic/subfc)
+    };
+    Kind kind = Kind::None;
+    uint8_t field = 0;
+};
+
 class PPCTranslator {
 public:
     explicit PPCTranslator(Emitter& emit) : emit_(emit) {}
     
+    // Guest loads/stores via REG_MEMBASE; emitted accesses are appended to sites
+    void EnableFastmem(CodeBuffer* buf, std::vector<FastmemAccess>* sites) {
+        fastmem_buf_ = buf;
+        fastmem_sites_ = sites;
+    }
+    
+    // AltiVec/VMX: VR живуть у PPCState (vr_offset від REG_STATE). Host V0-V31 зайняті
+    // guest FPR, тому scratch V16-V19 спілляться в їх слоти fpr (fpr_spill_offset).
+    // fast_math: без VSCR[SAT] і з FMLS для vnmsubfp (інший знак нуля/NaN).
+    void EnableVMX(int32_t vr_offset, int32_t vscr_offset, int32_t fpr_spill_offset,
+                   bool fast_math) {
+        vmx_vr_offset_ = vr_offset;
+        vmx_vscr_offset_ = vscr_offset;
+        vmx_spill_offset_ = fpr_spill_offset;
+        vmx_fast_math_ = fast_math;
+    }
+    
+    // Primary opcode 4. false - інструкція не підтримується (нічого не емітовано)
+    bool TranslateVMX(const ppc::DecodedInstr& instr);
+    
     // Translate single PowerPC instruction
     bool Translate(const ppc::DecodedInstr& instr);
     
+    // Матеріалізує відкладений CR field / CA (NZCV не змінюється)
+    void FlushFlags();
+    
+    // Умова bc для CR біта bi. Якщо біт належить відкладеному CR field, NZCV ще
+    // містить результат порівняння - cmp + bc зливаються у нативний b.cond.
+    Cond EmitBranchCondition(uint8_t bi, bool branch_true);
+    
+    bool HasPendingFlags() const { return lazy_.kind != LazyFlags::Kind::None; }
+    
     // Translate OP31 (extended ALU) instructions
     void TranslateOp31(const ppc::DecodedInstr& instr) {
         // OP31 extended opcode is in bits 21-30
@@ -1105,7 +1387,11 @@ public:
                 break;
             case 0:    // CMP
             case 32:   // CMPL
-                EmitCompare(instr);
+                {
+                    ppc::DecodedInstr cmp = instr;
+                    cmp.type = xo == 0 ? ppc::InstrType::CMP : ppc::InstrType::CMPL;
+                    EmitCompare(cmp);
+                }
                 break;
             case 339:  // MFSPR
             case 467:  // MTSPR
@@ -1136,8 +1422,17 @@ public:
     
 private:
     Emitter& emit_;
+    CodeBuffer* fastmem_buf_ = nullptr;
+    std::vector<FastmemAccess>* fastmem_sites_ = nullptr;
+    int32_t vmx_vr_offset_ = -1;
+    int32_t vmx_vscr_offset_ = 0;
+    int32_t vmx_spill_offset_ = 0;
+    bool vmx_fast_math_ = false;
     
     // Load/Store
+    void EmitEffectiveAddress(const ppc::DecodedInstr& instr);
+    void EmitFastmemLoad(const ppc::DecodedInstr& instr, uint8_t size);
+    void EmitFastmemStore(const ppc::DecodedInstr& instr, uint8_t size);
     void EmitLoad(const ppc::DecodedInstr& instr);
     void EmitStore(const ppc::DecodedInstr& instr);
     void EmitLoadMultiple(const ppc::DecodedInstr& instr);
@@ -1164,6 +1459,11 @@ private:
     void EmitCRLogic(const ppc::DecodedInstr& instr);
     void EmitCR0Update(GpReg result);
     
+    // Lazy flags: викликається до емісії producer'а (яка перезапише NZCV)
+    void BeginCRProducer(uint8_t field);
+    void BeginCarryProducer();
+    LazyFlags lazy_;
+    
     // System
     void EmitSystem(const ppc::DecodedInstr& instr);
     void EmitSPR(const ppc::DecodedInstr& instr);
@@ -1173,6 +1473,9 @@ private:
     void EmitFPLoad(const ppc::DecodedInstr& instr);
     void EmitFPStore(const ppc::DecodedInstr& instr);
     void EmitFPArith(const ppc::DecodedInstr& instr);
+    
+    // Vector
+    void EmitVMXSaturation();
 };
 
 } // namespace rpcsx::nce::arm64
@@ -11,13 +11,40 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <cstddef>
 #include <sys/mman.h>
 
+#if defined(__linux__)
+#include <linux/memfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__aarch64__)
+#include <ucontext.h>
+#endif
+
 namespace rpcsx::nce {
 
 using namespace ppc;
 using namespace arm64;
 
+// Patchable direct exit of a block (block linking)
+struct BlockExit {
+    uint32_t* stub;          // First stub instruction: NOP, or B to target body when linked
+    uint64_t target;         // Guest target address
+    bool linked;
+};
+
+// Indirect branch target cache (inline cache for bctr/blr, return slot for RAS)
+struct IndirectTarget {
+    static constexpr uint64_t kNoTarget = ~0ull;
+    
+    uint64_t guest;          // Cached guest target (kNoTarget = empty)
+    void* host;              // Body of compiled target (nullptr = go through dispatcher)
+};
+
 // Compiled code block
 struct CompiledBlock {
     void* code;              // Pointer to generated ARM64 code
@@ -25,6 +52,23 @@ struct CompiledBlock {
     uint64_t guest_addr;     // Original PowerPC address
     size_t guest_size;       // Original PowerPC code size (always 4-byte aligned)
     uint64_t entry_count;    // Execution count
+    void* body;              // Entry past the prologue (target of linked branches)
+    uint32_t region;         // Code cache region holding the code
+    std::vector<BlockExit> exits;                          // Direct exits
+    std::vector<std::unique_ptr<IndirectTarget>> slots;    // IC / return slots used by this block
+};
+
+/**
+ * Return Address Stack
+ * bl кладе return slot (guest адреса після виклику), blr знімає його і,
+ * якщо LR збігається і блок вже скомпільований, стрибає напряму без dispatcher.
+ * Layout фіксований - генерований код звертається до полів за зміщенням.
+ */
+struct ReturnStack {
+    static constexpr uint64_t kSize = 16;  // Power of two
+    
+    uint64_t top;
+    IndirectTarget* entries[kSize];
 };
 
 /**
@@ -34,11 +78,19 @@ struct JitConfig {
     size_t code_cache_size = 64 * 1024 * 1024;  // 64MB code cache
     size_t max_block_size = 4096;                // Max guest bytes per block
     bool enable_block_linking = true;
-    bool enable_fast_memory = true;
+    bool enable_fast_memory = true;              // ldr/str via REG_MEMBASE (memory_base must reserve 4GB)
     bool enable_profiling = false;
     bool big_endian_memory = true;               // PS3 is big-endian
+    bool vmx_fast_math = false;                  // VMX без VSCR[SAT] і точного знаку vnmsubfp
 };
 
+/**
+ * Slow path для fastmem доступів, що фолтять (MMIO / RSX / захищені сторінки).
+ * Значення передаються в guest порядку (як після byte-swap).
+ */
+using MmioReadHandler = uint64_t (*)(uint64_t guest_addr, uint32_t size);
+using MmioWriteHandler = void (*)(uint64_t guest_addr, uint32_t size, uint64_t value);
+
 /**
  * PowerPC PPU CPU State (PS3 Cell)
  * 
@@ -60,7 +112,7 @@ struct PPCState {
     // Floating Point Registers (f0-f31)
     alignas(8) double fpr[32];
     
-    // Vector Registers (v0-v31) - AltiVec/VMX
+    // Vector Registers (v0-v31) - AltiVec/VMX, rpcs3 v128 layout (bytes reversed)
     alignas(16) uint8_t vr[32][16];
     
     // Special Purpose Registers
@@ -150,6 +202,12 @@ struct PPCState {
     uint64_t& GetTOC() { return gpr[2]; }
 };
 
+// PPCState offsets used by generated code
+constexpr int32_t kStateOffsetPC = offsetof(PPCState, pc);
+constexpr int32_t kStateOffsetLR = offsetof(PPCState, lr);
+constexpr int32_t kStateOffsetCTR = offsetof(PPCState, ctr);
+constexpr int32_t kStateOffsetMemBase = offsetof(PPCState, memory_base);
+
 /**
  * JIT Compiler - Main Translation Engine for PS3 PPU
  */
@@ -176,6 +234,21 @@ public:
     size_t GetCacheUsage() const { return code_cache_used_; }
     size_t GetBlockCount() const { return block_cache_.size(); }
     uint64_t GetExecutionCount() const { return total_executions_; }
+    uint64_t GetLinkCount() const { return links_patched_; }
+    uint64_t GetBackpatchCount() const { return fastmem_backpatched_; }
+    uint64_t GetEvictionCount() const { return regions_evicted_; }
+    
+    // Per-title: precise (VSCR[SAT], vnmsubfp як на Cell) або fast VMX.
+    // Вже скомпільовані блоки залежать від режиму, тому зміна скидає кеш.
+    void SetVmxFastMath(bool enable);
+    
+    // Fastmem fault handling (called from the SIGSEGV/SIGBUS handler).
+    // Backpatches the faulting access to a slow-path thunk and resumes there.
+    bool HandleFastmemFault(void* fault_addr, void* ucontext);
+    void SetMmioHandlers(MmioReadHandler read, MmioWriteHandler write) {
+        mmio_read_ = read;
+        mmio_write_ = write;
+    }
     
 private:
     // Translate single instruction
@@ -188,19 +261,103 @@ private:
     // Emit CR update code
     void EmitCR0Update(Emitter& emit, GpReg result);
     
+    // Block entry/exit sequences
+    void EmitPrologue(Emitter& emit);
+    void EmitReturnToDispatcher(Emitter& emit);
+    void EmitDirectExit(Emitter& emit, CodeBuffer& buf, CompiledBlock* block, uint64_t target);
+    void EmitIndirectExit(Emitter& emit, CodeBuffer& buf, CompiledBlock* block,
+                          int32_t target_offset, bool is_return, bool link, uint64_t next_addr);
+    void EmitSetLR(Emitter& emit, uint64_t return_addr);
+    void EmitReturnPush(Emitter& emit, CompiledBlock* block, uint64_t return_addr);
+    
+    // Fastmem
+    void EmitGuestLoad(Emitter& emit, CodeBuffer& buf, uint8_t size, GpReg rt,
+                       uint8_t ra, int32_t disp);
+    void EmitGuestStore(Emitter& emit, CodeBuffer& buf, uint8_t size, GpReg rs,
+                        uint8_t ra, int32_t disp);
+    void RecordFastmemSite(const FastmemAccess& access);
+    void* EmitSlowPathThunk(const FastmemAccess& access);
+    static uint64_t SlowLoad(JitCompiler* jit, uint64_t guest_addr, uint32_t size);
+    static void SlowStore(JitCompiler* jit, uint64_t guest_addr, uint32_t size, uint64_t value);
+    
+    // Block linking
+    void LinkBlock(CompiledBlock* block);
+    void LinkExit(BlockExit& exit, CompiledBlock* target);
+    void UnlinkExit(BlockExit& exit);
+    void BindSlot(IndirectTarget* slot, CompiledBlock* target);
+    void ResetReturnStack();
+    
+    using BlockMap = std::unordered_map<uint64_t, std::unique_ptr<CompiledBlock>>;
+    BlockMap::iterator RemoveBlock(BlockMap::iterator it);
+    void IndexCodePages(const CompiledBlock& block);
+    
+    // Code cache allocation
+    uint8_t* ReserveCode(size_t min_size, bool allow_evict);
+    size_t GetRegionRemaining() const { return region_size_ - regions_[current_region_].used; }
+    void CommitCode(const void* code, size_t size);
+    void EvictRegion(uint32_t index);
+    void TouchRegion(uint32_t index) { regions_[index].last_use = ++use_clock_; }
+    
+    // W^X: code is written through the RW view, caches are synced once per batch
+    uint32_t* Writable(uint32_t* insn) const {
+        return reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(insn) + code_write_offset_);
+    }
+    void MarkCodeDirty(const void* code, size_t size);
+    void SyncCode();
+    
     JitConfig config_;
     
-    // Code cache
+    // Code cache: executable view and a writable alias of the same memfd pages
     void* code_cache_;
+    ptrdiff_t code_write_offset_;    // RW view - RX view (0 = single RWX mapping)
+    int code_cache_fd_;
     size_t code_cache_size_;
     size_t code_cache_used_;
     
+    // Код кешу поділений на регіони: коли місця немає, витісняється регіон,
+    // у який найдовше не входили, замість повного FlushCache()
+    struct CacheRegion {
+        size_t begin;                  // Offset in the code cache
+        size_t used;
+        uint64_t last_use;             // use_clock_ of the last block entry (0 = never)
+        std::vector<uint64_t> pinned;  // Blocks in other regions whose fastmem thunks live here
+    };
+    static constexpr uint32_t kCacheRegions = 8;
+    CacheRegion regions_[kCacheRegions];
+    size_t region_size_;
+    uint32_t current_region_;
+    uint64_t use_clock_;
+    
+    // Executable ranges written since the last SyncCode()
+    std::vector<std::pair<uintptr_t, uintptr_t>> dirty_code_;
+    
     // Block cache: guest_addr -> compiled block
-    std::unordered_map<uint64_t, std::unique_ptr<CompiledBlock>> block_cache_;
+    BlockMap block_cache_;
+    
+    // Reverse mapping 4K guest сторінка -> блоки на ній; видалені блоки
+    // прибираються лише при InvalidateRange цієї сторінки
+    static constexpr uint32_t kCodePageShift = 12;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> code_pages_;
+    
+    // Incoming edges: target guest_addr -> exits / slots, що посилаються на нього
+    std::unordered_map<uint64_t, std::vector<BlockExit*>> incoming_exits_;
+    std::unordered_map<uint64_t, std::vector<IndirectTarget*>> incoming_slots_;
+    
+    // Shared with generated code (addresses are baked into blocks)
+    ReturnStack ras_;
+    IndirectTarget* pending_slot_;   // Set by generated code on inline cache miss
+    
+    // Fastmem access sites: host instruction address -> access
+    std::unordered_map<uintptr_t, FastmemAccess> fastmem_sites_;
+    MmioReadHandler mmio_read_;
+    MmioWriteHandler mmio_write_;
     
     // Stats
     uint64_t total_executions_;
     uint64_t total_instructions_;
+    uint64_t links_patched_;
+    uint64_t fastmem_backpatched_;
+    uint64_t regions_evicted_;
     
     bool initialized_;
 };
@@ -212,10 +369,23 @@ private:
 inline JitCompiler::JitCompiler(const JitConfig& config)
     : config_(config)
     , code_cache_(nullptr)
+    , code_write_offset_(0)
+    , code_cache_fd_(-1)
     , code_cache_size_(0)
     , code_cache_used_(0)
+    , regions_{}
+    , region_size_(0)
+    , current_region_(0)
+    , use_clock_(0)
+    , ras_{}
+    , pending_slot_(nullptr)
+    , mmio_read_(nullptr)
+    , mmio_write_(nullptr)
     , total_executions_(0)
     , total_instructions_(0)
+    , links_patched_(0)
+    , fastmem_backpatched_(0)
+    , regions_evicted_(0)
     , initialized_(false) {}
 
 inline JitCompiler::~JitCompiler() {
@@ -227,15 +397,48 @@ inline bool JitCompiler::Initialize() {
     
     // Allocate executable code cache
     code_cache_size_ = config_.code_cache_size;
-    code_cache_ = mmap(nullptr, code_cache_size_,
-                       PROT_READ | PROT_WRITE | PROT_EXEC,
-                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    code_cache_ = nullptr;
+    code_write_offset_ = 0;
     
-    if (code_cache_ == MAP_FAILED) {
-        code_cache_ = nullptr;
-        return false;
+#if defined(__linux__)
+    // Dual mapping: RX view for execution, RW view for emission - no mprotect flips
+    code_cache_fd_ = static_cast<int>(syscall(__NR_memfd_create, "rpcsx-jit", MFD_CLOEXEC));
+    if (code_cache_fd_ >= 0 && ftruncate(code_cache_fd_, code_cache_size_) == 0) {
+        void* rx = mmap(nullptr, code_cache_size_, PROT_READ | PROT_EXEC,
+                        MAP_SHARED, code_cache_fd_, 0);
+        void* rw = mmap(nullptr, code_cache_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, code_cache_fd_, 0);
+        if (rx != MAP_FAILED && rw != MAP_FAILED) {
+            code_cache_ = rx;
+            code_write_offset_ = static_cast<uint8_t*>(rw) - static_cast<uint8_t*>(rx);
+        } else {
+            if (rx != MAP_FAILED) munmap(rx, code_cache_size_);
+            if (rw != MAP_FAILED) munmap(rw, code_cache_size_);
+        }
+    }
+    if (!code_cache_ && code_cache_fd_ >= 0) {
+        close(code_cache_fd_);
+        code_cache_fd_ = -1;
+    }
+#endif
+    
+    if (!code_cache_) {
+        // Fallback: single RWX mapping
+        code_cache_ = mmap(nullptr, code_cache_size_,
+                           PROT_READ | PROT_WRITE | PROT_EXEC,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        
+        if (code_cache_ == MAP_FAILED) {
+            code_cache_ = nullptr;
+            return false;
+        }
     }
     
+    region_size_ = (code_cache_size_ / kCacheRegions) & ~size_t{15};
+    for (uint32_t i = 0; i < kCacheRegions; i++) {
+        regions_[i] = CacheRegion{i * region_size_, 0, 0, {}};
+    }
+    current_region_ = 0;
     code_cache_used_ = 0;
     initialized_ = true;
     return true;
@@ -248,7 +451,15 @@ inline void JitCompiler::Shutdown() {
     
     if (code_cache_) {
         munmap(code_cache_, code_cache_size_);
+        if (code_write_offset_) {
+            munmap(static_cast<uint8_t*>(code_cache_) + code_write_offset_, code_cache_size_);
+        }
         code_cache_ = nullptr;
+        code_write_offset_ = 0;
+    }
+    if (code_cache_fd_ >= 0) {
+        close(code_cache_fd_);
+        code_cache_fd_ = -1;
     }
     
     initialized_ = false;
@@ -263,22 +474,606 @@ inline CompiledBlock* JitCompiler::LookupBlock(uint64_t guest_addr) {
 }
 
 inline void JitCompiler::InvalidateBlock(uint64_t guest_addr) {
-    block_cache_.erase(guest_addr);
+    auto it = block_cache_.find(guest_addr);
+    if (it != block_cache_.end()) {
+        RemoveBlock(it);
+        SyncCode();
+    }
 }
 
 inline void JitCompiler::InvalidateRange(uint64_t start, uint64_t end) {
-    for (auto it = block_cache_.begin(); it != block_cache_.end(); ) {
-        if (it->first >= start && it->first < end) {
-            it = block_cache_.erase(it);
-        } else {
-            ++it;
+    if (start >= end) return;
+    
+    // Any overlap with [start, end) - block may start before the range
+    auto overlaps = [&](const CompiledBlock& block) {
+        return block.guest_addr < end && block.guest_addr + block.guest_size > start;
+    };
+    
+    const uint64_t first_page = start >> kCodePageShift;
+    const uint64_t last_page = (end - 1) >> kCodePageShift;
+    if (last_page - first_page >= code_pages_.size()) {
+        // Діапазон більший за індекс - дешевше пройти всі блоки
+        for (auto it = block_cache_.begin(); it != block_cache_.end(); ) {
+            it = overlaps(*it->second) ? RemoveBlock(it) : std::next(it);
+        }
+        code_pages_.clear();
+        for (const auto& [addr, block] : block_cache_) {
+            IndexCodePages(*block);
+        }
+    } else {
+        // Лише блоки змінених сторінок
+        for (uint64_t page = first_page; page <= last_page; ++page) {
+            auto pages = code_pages_.find(page);
+            if (pages == code_pages_.end()) continue;
+            
+            auto& blocks = pages->second;
+            blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [&](uint64_t addr) {
+                auto it = block_cache_.find(addr);
+                if (it == block_cache_.end()) return true;
+                if (!overlaps(*it->second)) return false;
+                RemoveBlock(it);
+                return true;
+            }), blocks.end());
+            if (blocks.empty()) code_pages_.erase(pages);
+        }
+    }
+    SyncCode();
+}
+
+inline void JitCompiler::IndexCodePages(const CompiledBlock& block) {
+    const uint64_t last_page = (block.guest_addr + std::max<size_t>(block.guest_size, 4) - 1) >> kCodePageShift;
+    for (uint64_t page = block.guest_addr >> kCodePageShift; page <= last_page; ++page) {
+        auto& blocks = code_pages_[page];
+        if (std::find(blocks.begin(), blocks.end(), block.guest_addr) == blocks.end()) {
+            blocks.push_back(block.guest_addr);
         }
     }
 }
 
+inline void JitCompiler::SetVmxFastMath(bool enable) {
+    if (config_.vmx_fast_math == enable) return;
+    config_.vmx_fast_math = enable;
+    FlushCache();
+}
+
 inline void JitCompiler::FlushCache() {
+    // Весь code cache перевикористовується - патчити stubs не потрібно
     block_cache_.clear();
+    code_pages_.clear();
+    incoming_exits_.clear();
+    incoming_slots_.clear();
+    fastmem_sites_.clear();
+    ResetReturnStack();
+    for (auto& region : regions_) {
+        region.used = 0;
+        region.last_use = 0;
+        region.pinned.clear();
+    }
+    current_region_ = 0;
     code_cache_used_ = 0;
+    dirty_code_.clear();
+}
+
+// =========================================
+// Code Cache Allocation
+// =========================================
+
+inline uint8_t* JitCompiler::ReserveCode(size_t min_size, bool allow_evict) {
+    if (GetRegionRemaining() < min_size) {
+        if (!allow_evict) return nullptr;
+        
+        // LRU: порожні регіони (last_use = 0) беруться першими
+        uint32_t victim = (current_region_ + 1) % kCacheRegions;
+        for (uint32_t i = 0; i < kCacheRegions; i++) {
+            if (i != current_region_ && regions_[i].last_use < regions_[victim].last_use) {
+                victim = i;
+            }
+        }
+        EvictRegion(victim);
+        current_region_ = victim;
+    }
+    
+    const CacheRegion& region = regions_[current_region_];
+    return static_cast<uint8_t*>(code_cache_) + region.begin + region.used;
+}
+
+inline void JitCompiler::CommitCode(const void* code, size_t size) {
+    MarkCodeDirty(code, size);
+    
+    size_t aligned = (size + 15) & ~size_t{15};
+    regions_[current_region_].used += aligned;
+    code_cache_used_ += aligned;
+}
+
+inline void JitCompiler::EvictRegion(uint32_t index) {
+    CacheRegion& region = regions_[index];
+    if (region.used == 0 && region.pinned.empty()) return;
+    
+    // RemoveBlock повертає incoming edges з інших регіонів на dispatcher
+    for (auto it = block_cache_.begin(); it != block_cache_.end(); ) {
+        bool pinned = std::find(region.pinned.begin(), region.pinned.end(), it->first) !=
+                      region.pinned.end();
+        if (it->second->region == index || pinned) {
+            it = RemoveBlock(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    uintptr_t begin = reinterpret_cast<uintptr_t>(code_cache_) + region.begin;
+    for (auto it = fastmem_sites_.begin(); it != fastmem_sites_.end(); ) {
+        if (it->first >= begin && it->first < begin + region_size_) {
+            it = fastmem_sites_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    code_cache_used_ -= region.used;
+    region.used = 0;
+    region.last_use = 0;
+    region.pinned.clear();
+    regions_evicted_++;
+}
+
+inline void JitCompiler::MarkCodeDirty(const void* code, size_t size) {
+    uintptr_t start = reinterpret_cast<uintptr_t>(code);
+    uintptr_t end = start + size;
+    
+    // Послідовна емісія - розширюємо останній діапазон
+    if (!dirty_code_.empty() && start <= dirty_code_.back().second &&
+        end >= dirty_code_.back().first) {
+        dirty_code_.back().first = std::min(dirty_code_.back().first, start);
+        dirty_code_.back().second = std::max(dirty_code_.back().second, end);
+        return;
+    }
+    dirty_code_.push_back({start, end});
+}
+
+inline void JitCompiler::SyncCode() {
+    if (dirty_code_.empty()) return;
+    
+#if defined(__aarch64__)
+    // Весь batch: DC CVAU по всіх діапазонах, один DSB, IC IVAU, один DSB + ISB
+    uint64_t ctr;
+    __asm__ volatile("mrs %0, ctr_el0" : "=r"(ctr));
+    const uintptr_t dline = uintptr_t{4} << ((ctr >> 16) & 0xf);
+    const uintptr_t iline = uintptr_t{4} << (ctr & 0xf);
+    
+    if (!(ctr & (1ull << 28))) {  // IDC: clean to PoU not required
+        for (const auto& [start, end] : dirty_code_) {
+            for (uintptr_t p = start & ~(dline - 1); p < end; p += dline) {
+                __asm__ volatile("dc cvau, %0" :: "r"(p) : "memory");
+            }
+        }
+    }
+    __asm__ volatile("dsb ish" ::: "memory");
+    
+    if (!(ctr & (1ull << 29))) {  // DIC: icache invalidation not required
+        for (const auto& [start, end] : dirty_code_) {
+            for (uintptr_t p = start & ~(iline - 1); p < end; p += iline) {
+                __asm__ volatile("ic ivau, %0" :: "r"(p) : "memory");
+            }
+        }
+        __asm__ volatile("dsb ish" ::: "memory");
+    }
+    __asm__ volatile("isb" ::: "memory");
+#else
+    for (const auto& [start, end] : dirty_code_) {
+        __builtin___clear_cache(reinterpret_cast<char*>(start), reinterpret_cast<char*>(end));
+    }
+#endif
+    
+    dirty_code_.clear();
+}
+
+// =========================================
+// Block Linking
+// =========================================
+
+template <typename T>
+inline void EraseLink(std::unordered_map<uint64_t, std::vector<T*>>& links,
+                      uint64_t addr, T* item) {
+    auto it = links.find(addr);
+    if (it == links.end()) return;
+    
+    auto& list = it->second;
+    list.erase(std::remove(list.begin(), list.end(), item), list.end());
+    if (list.empty()) {
+        links.erase(it);
+    }
+}
+
+inline JitCompiler::BlockMap::iterator JitCompiler::RemoveBlock(BlockMap::iterator it) {
+    CompiledBlock* block = it->second.get();
+    
+    // Outgoing edges of the removed block
+    for (auto& exit : block->exits) {
+        EraseLink(incoming_exits_, exit.target, &exit);
+    }
+    for (auto& slot : block->slots) {
+        if (slot->guest != IndirectTarget::kNoTarget) {
+            EraseLink(incoming_slots_, slot->guest, slot.get());
+        }
+    }
+    
+    // Incoming edges: повертаємо їх на dispatcher, але лишаємо зареєстрованими,
+    // щоб перекомпільований блок одразу знову прилінкувався
+    auto in_exits = incoming_exits_.find(block->guest_addr);
+    if (in_exits != incoming_exits_.end()) {
+        for (BlockExit* exit : in_exits->second) {
+            UnlinkExit(*exit);
+        }
+    }
+    auto in_slots = incoming_slots_.find(block->guest_addr);
+    if (in_slots != incoming_slots_.end()) {
+        for (IndirectTarget* slot : in_slots->second) {
+            slot->host = nullptr;
+        }
+    }
+    
+    // RAS може тримати slots цього блоку
+    ResetReturnStack();
+    
+    return block_cache_.erase(it);
+}
+
+inline void JitCompiler::LinkBlock(CompiledBlock* block) {
+    if (!config_.enable_block_linking) return;
+    
+    // Outgoing edges: реєструємо і лінкуємо на вже скомпільовані цілі
+    for (auto& exit : block->exits) {
+        incoming_exits_[exit.target].push_back(&exit);
+        if (auto* target = LookupBlock(exit.target)) {
+            LinkExit(exit, target);
+        }
+    }
+    for (auto& slot : block->slots) {
+        if (slot->guest == IndirectTarget::kNoTarget) continue;  // IC - заповнює dispatcher
+        incoming_slots_[slot->guest].push_back(slot.get());
+        if (auto* target = LookupBlock(slot->guest)) {
+            slot->host = target->body;
+        }
+    }
+    
+    // Incoming edges, що чекали на цей блок
+    auto in_exits = incoming_exits_.find(block->guest_addr);
+    if (in_exits != incoming_exits_.end()) {
+        for (BlockExit* exit : in_exits->second) {
+            LinkExit(*exit, block);
+        }
+    }
+    auto in_slots = incoming_slots_.find(block->guest_addr);
+    if (in_slots != incoming_slots_.end()) {
+        for (IndirectTarget* slot : in_slots->second) {
+            slot->host = block->body;
+        }
+    }
+}
+
+inline void JitCompiler::LinkExit(BlockExit& exit, CompiledBlock* target) {
+    if (exit.linked) return;
+    
+    ptrdiff_t offset = static_cast<uint8_t*>(target->body) -
+                       reinterpret_cast<uint8_t*>(exit.stub);
+    if (!IsBranchInRange(offset)) return;
+    
+    // NOP -> B: одна інструкція, безпечно патчити навіть під час виконання
+    *Writable(exit.stub) = EncodeB(offset);
+    MarkCodeDirty(exit.stub, 4);
+    exit.linked = true;
+    links_patched_++;
+}
+
+inline void JitCompiler::UnlinkExit(BlockExit& exit) {
+    if (!exit.linked) return;
+    
+    *Writable(exit.stub) = EncodeNOP();
+    MarkCodeDirty(exit.stub, 4);
+    exit.linked = false;
+}
+
+inline void JitCompiler::BindSlot(IndirectTarget* slot, CompiledBlock* target) {
+    if (slot->guest != IndirectTarget::kNoTarget) {
+        EraseLink(incoming_slots_, slot->guest, slot);
+    }
+    slot->guest = target->guest_addr;
+    slot->host = target->body;
+    incoming_slots_[slot->guest].push_back(slot);
+}
+
+inline void JitCompiler::ResetReturnStack() {
+    ras_ = ReturnStack{};
+    pending_slot_ = nullptr;
+}
+
+// =========================================
+// Fastmem
+// =========================================
+
+inline void JitCompiler::RecordFastmemSite(const FastmemAccess& access) {
+    fastmem_sites_[reinterpret_cast<uintptr_t>(access.insn)] = access;
+}
+
+inline void JitCompiler::EmitGuestLoad(Emitter& emit, CodeBuffer& buf, uint8_t size,
+                                       GpReg rt, uint8_t ra, int32_t disp) {
+    // EA = (rA|0) + d -> REG_TMP1
+    if (ra == 0) {
+        emit.MOVi(REG_TMP1, disp);
+    } else {
+        emit.ADDi(REG_TMP1, static_cast<GpReg>(ra), disp);
+    }
+    RecordFastmemSite({buf.GetCurrent(), size, false, rt, REG_TMP1});
+    emit.LDR_GUEST(size, rt, REG_TMP1);
+    emit.BSWAP_GUEST(size, rt, rt);
+}
+
+inline void JitCompiler::EmitGuestStore(Emitter& emit, CodeBuffer& buf, uint8_t size,
+                                        GpReg rs, uint8_t ra, int32_t disp) {
+    if (ra == 0) {
+        emit.MOVi(REG_TMP1, disp);
+    } else {
+        emit.ADDi(REG_TMP1, static_cast<GpReg>(ra), disp);
+    }
+    GpReg value = rs;
+    if (size > 1) {
+        emit.BSWAP_GUEST(size, REG_TMP2, rs);
+        value = REG_TMP2;
+    }
+    RecordFastmemSite({buf.GetCurrent(), size, true, value, REG_TMP1});
+    emit.STR_GUEST(size, value, REG_TMP1);
+}
+
+inline uint64_t SwapGuestValue(uint64_t value, uint32_t size) {
+    switch (size) {
+        case 8: return __builtin_bswap64(value);
+        case 4: return __builtin_bswap32(static_cast<uint32_t>(value));
+        case 2: return __builtin_bswap16(static_cast<uint16_t>(value));
+        default: return value & 0xFF;
+    }
+}
+
+inline uint64_t JitCompiler::SlowLoad(JitCompiler* jit, uint64_t guest_addr, uint32_t size) {
+    // Thunk замінює лише ldr - наступний rev все одно виконається
+    uint64_t value = jit->mmio_read_ ? jit->mmio_read_(guest_addr, size) : 0;
+    return SwapGuestValue(value, size);
+}
+
+inline void JitCompiler::SlowStore(JitCompiler* jit, uint64_t guest_addr, uint32_t size,
+                                   uint64_t value) {
+    if (jit->mmio_write_) {
+        jit->mmio_write_(guest_addr, size, SwapGuestValue(value, size));
+    }
+}
+
+inline void* JitCompiler::EmitSlowPathThunk(const FastmemAccess& access) {
+    constexpr size_t kThunkMaxSize = 272;
+    
+    // Fault handler can't evict: the faulting block itself may live in the victim
+    void* thunk = ReserveCode(kThunkMaxSize, false);
+    if (!thunk) return nullptr;
+    CodeBuffer buf(thunk, kThunkMaxSize, code_write_offset_);
+    Emitter emit(buf);
+    
+    // Guest state живе в усіх X регістрах - зберігаємо caller-saved x0-x18, x30
+    for (int r = 0; r < 18; r += 2) {
+        emit.STP_PRE(static_cast<GpReg>(r), static_cast<GpReg>(r + 1), GpReg::SP, -16);
+    }
+    emit.STP_PRE(GpReg::X18, GpReg::X30, GpReg::SP, -16);
+    
+    if (access.store) {
+        emit.MOV(GpReg::X3, access.rt);
+    }
+    emit.MOV(GpReg::X1, access.ea);
+    emit.UXTW(GpReg::X1, GpReg::X1);
+    emit.MOVZ(GpReg::X2, access.size);
+    emit.MOV_IMM64(GpReg::X0, reinterpret_cast<uint64_t>(this));
+    // NZCV може тримати відкладений cmp (lazy CR) - handler його не зберігає
+    emit.MRS_NZCV(GpReg::X17);
+    emit.STP_PRE(GpReg::X17, GpReg::X18, GpReg::SP, -16);
+    emit.MOV_IMM64(GpReg::X16, access.store ? reinterpret_cast<uint64_t>(&SlowStore)
+                                            : reinterpret_cast<uint64_t>(&SlowLoad));
+    emit.BLR(GpReg::X16);
+    
+    emit.LDP_POST(GpReg::X17, GpReg::X18, GpReg::SP, 16);
+    emit.MSR_NZCV(GpReg::X17);
+    
+    if (!access.store && access.rt != GpReg::ZR) {
+        int rt = static_cast<int>(access.rt);
+        if (rt <= 18 || rt == 30) {
+            // rt буде відновлено з стеку - пишемо результат у його слот
+            int32_t slot = (rt == 30) ? 8 : (rt == 18) ? 0 : (8 - rt / 2) * 16 + 16 + (rt & 1) * 8;
+            emit.STR(GpReg::X0, GpReg::SP, slot);
+        } else {
+            emit.MOV(access.rt, GpReg::X0);
+        }
+    }
+    
+    emit.LDP_POST(GpReg::X18, GpReg::X30, GpReg::SP, 16);
+    for (int r = 16; r >= 0; r -= 2) {
+        emit.LDP_POST(static_cast<GpReg>(r), static_cast<GpReg>(r + 1), GpReg::SP, 16);
+    }
+    
+    // Back to the instruction after the patched access
+    ptrdiff_t back = reinterpret_cast<uint8_t*>(access.insn + 1) -
+                     reinterpret_cast<uint8_t*>(buf.GetCurrent());
+    emit.B(static_cast<int32_t>(back));
+    
+    CommitCode(thunk, buf.GetOffset());
+    return thunk;
+}
+
+inline bool JitCompiler::HandleFastmemFault(void* fault_addr, void* ucontext) {
+#if defined(__aarch64__)
+    if (!initialized_ || !config_.enable_fast_memory || !ucontext) return false;
+    
+    auto* uctx = static_cast<ucontext_t*>(ucontext);
+    uintptr_t pc = uctx->uc_mcontext.pc;
+    uintptr_t cache = reinterpret_cast<uintptr_t>(code_cache_);
+    if (pc < cache || pc >= cache + code_cache_size_) return false;
+    
+    auto it = fastmem_sites_.find(pc);
+    if (it == fastmem_sites_.end()) return false;
+    
+    // Адреса має бути у 4GB вікні цього потоку
+    uintptr_t base = uctx->uc_mcontext.regs[static_cast<int>(REG_MEMBASE)];
+    uintptr_t addr = reinterpret_cast<uintptr_t>(fault_addr);
+    if (addr < base || addr - base >= (1ull << 32)) return false;
+    
+    const FastmemAccess access = it->second;
+    void* thunk = EmitSlowPathThunk(access);
+    if (!thunk) return false;
+    
+    // Блок не може пережити регіон, у якому лежить його thunk
+    for (const auto& [addr, block] : block_cache_) {
+        auto* code = static_cast<uint8_t*>(block->code);
+        auto* insn = reinterpret_cast<uint8_t*>(access.insn);
+        if (insn >= code && insn < code + block->code_size) {
+            if (block->region != current_region_) {
+                regions_[current_region_].pinned.push_back(addr);
+            }
+            break;
+        }
+    }
+    
+    // ldr/str -> B thunk (назавжди: цей site адресує MMIO/RSX)
+    ptrdiff_t offset = static_cast<uint8_t*>(thunk) - reinterpret_cast<uint8_t*>(access.insn);
+    *Writable(access.insn) = EncodeB(offset);
+    MarkCodeDirty(access.insn, 4);
+    SyncCode();
+    fastmem_sites_.erase(it);
+    fastmem_backpatched_++;
+    
+    uctx->uc_mcontext.pc = reinterpret_cast<uint64_t>(thunk);
+    return true;
+#else
+    (void)fault_addr;
+    (void)ucontext;
+    return false;
+#endif
+}
+
+// =========================================
+// Block Entry / Exit
+// =========================================
+
+inline void JitCompiler::EmitPrologue(Emitter& emit) {
+    // stp x29, x30, [sp, #-16]! ; stp x27, x28, [sp, #-16]! ; mov x29, x0 (PPCState*)
+    emit.STP_PRE(REG_STATE, GpReg::X30, GpReg::SP, -16);
+    emit.STP_PRE(REG_TMP3, REG_MEMBASE, GpReg::SP, -16);
+    emit.MOV(REG_STATE, GpReg::X0);
+    if (config_.enable_fast_memory) {
+        emit.LDR(REG_MEMBASE, REG_STATE, kStateOffsetMemBase);
+    }
+}
+
+inline void JitCompiler::EmitReturnToDispatcher(Emitter& emit) {
+    // Linked blocks share the frame of the first block in the chain
+    emit.LDP_POST(REG_TMP3, REG_MEMBASE, GpReg::SP, 16);
+    emit.LDP_POST(REG_STATE, GpReg::X30, GpReg::SP, 16);
+    emit.RET();
+}
+
+inline void JitCompiler::EmitDirectExit(Emitter& emit, CodeBuffer& buf,
+                                        CompiledBlock* block, uint64_t target) {
+    // Stub: NOP (-> B target body) ; state->pc = target ; return to dispatcher
+    block->exits.push_back({buf.GetCurrent(), target, false});
+    emit.NOP();
+    emit.MOV_IMM64(REG_TMP1, target);
+    emit.STR(REG_TMP1, REG_STATE, kStateOffsetPC);
+    EmitReturnToDispatcher(emit);
+}
+
+inline void JitCompiler::EmitSetLR(Emitter& emit, uint64_t return_addr) {
+    emit.MOV_IMM64(REG_TMP1, return_addr);
+    emit.STR(REG_TMP1, REG_STATE, kStateOffsetLR);
+}
+
+inline void JitCompiler::EmitReturnPush(Emitter& emit, CompiledBlock* block,
+                                        uint64_t return_addr) {
+    if (!config_.enable_block_linking) return;
+    
+    block->slots.push_back(std::make_unique<IndirectTarget>(
+        IndirectTarget{return_addr, nullptr}));
+    IndirectTarget* slot = block->slots.back().get();
+    
+    // ras_.entries[top] = slot ; top = (top + 1) & mask
+    emit.MOV_IMM64(REG_TMP2, reinterpret_cast<uint64_t>(&ras_));
+    emit.LDR(REG_TMP1, REG_TMP2, offsetof(ReturnStack, top));
+    emit.ADD_LSL(REG_TMP3, REG_TMP2, REG_TMP1, 3);
+    emit.ADD_IMM(REG_TMP1, REG_TMP1, 1);
+    emit.AND_IMM(REG_TMP1, REG_TMP1, ReturnStack::kSize - 1);
+    emit.STR(REG_TMP1, REG_TMP2, offsetof(ReturnStack, top));
+    emit.MOV_IMM64(REG_TMP2, reinterpret_cast<uint64_t>(slot));
+    emit.STR(REG_TMP2, REG_TMP3, offsetof(ReturnStack, entries));
+}
+
+inline void JitCompiler::EmitIndirectExit(Emitter& emit, CodeBuffer& buf,
+                                          CompiledBlock* block, int32_t target_offset,
+                                          bool is_return, bool link, uint64_t next_addr) {
+    // state->pc = LR / CTR
+    emit.LDR(REG_TMP3, REG_STATE, target_offset);
+    emit.STR(REG_TMP3, REG_STATE, kStateOffsetPC);
+    if (link) {
+        EmitSetLR(emit, next_addr);
+    }
+    
+    if (config_.enable_block_linking) {
+        std::vector<std::pair<uint32_t*, Cond>> to_cache, to_miss;
+        auto placeholder = [&](std::vector<std::pair<uint32_t*, Cond>>& list, Cond cond) {
+            list.push_back({buf.GetCurrent(), cond});
+            emit.NOP();
+        };
+        auto patch = [&](std::vector<std::pair<uint32_t*, Cond>>& list) {
+            for (auto& [site, cond] : list) {
+                *buf.Writable(site) = EncodeBCond(cond, reinterpret_cast<uint8_t*>(buf.GetCurrent()) -
+                                          reinterpret_cast<uint8_t*>(site));
+            }
+        };
+        
+        if (is_return) {
+            // RAS: top = (top - 1) & mask ; slot = entries[top]
+            emit.MOV_IMM64(REG_TMP2, reinterpret_cast<uint64_t>(&ras_));
+            emit.LDR(REG_TMP1, REG_TMP2, offsetof(ReturnStack, top));
+            emit.SUB_IMM(REG_TMP1, REG_TMP1, 1);
+            emit.AND_IMM(REG_TMP1, REG_TMP1, ReturnStack::kSize - 1);
+            emit.STR(REG_TMP1, REG_TMP2, offsetof(ReturnStack, top));
+            emit.ADD_LSL(REG_TMP1, REG_TMP2, REG_TMP1, 3);
+            emit.LDR(REG_TMP1, REG_TMP1, offsetof(ReturnStack, entries));
+            // if (slot && slot->guest == target && slot->host) goto slot->host
+            emit.CMP_IMM(REG_TMP1, 0);
+            placeholder(to_cache, Cond::EQ);
+            emit.LDR(REG_TMP2, REG_TMP1, offsetof(IndirectTarget, guest));
+            emit.CMP(REG_TMP2, REG_TMP3);
+            placeholder(to_cache, Cond::NE);
+            emit.LDR(REG_TMP2, REG_TMP1, offsetof(IndirectTarget, host));
+            emit.CMP_IMM(REG_TMP2, 0);
+            placeholder(to_cache, Cond::EQ);
+            emit.BR(REG_TMP2);
+            patch(to_cache);
+        }
+        
+        // Inline cache: один останній target цього call site
+        block->slots.push_back(std::make_unique<IndirectTarget>(
+            IndirectTarget{IndirectTarget::kNoTarget, nullptr}));
+        IndirectTarget* slot = block->slots.back().get();
+        
+        emit.MOV_IMM64(REG_TMP1, reinterpret_cast<uint64_t>(slot));
+        emit.LDR(REG_TMP2, REG_TMP1, offsetof(IndirectTarget, guest));
+        emit.CMP(REG_TMP2, REG_TMP3);
+        placeholder(to_miss, Cond::NE);
+        emit.LDR(REG_TMP2, REG_TMP1, offsetof(IndirectTarget, host));
+        emit.CMP_IMM(REG_TMP2, 0);
+        placeholder(to_miss, Cond::EQ);
+        emit.BR(REG_TMP2);
+        patch(to_miss);
+        
+        // Miss: dispatcher прив'яже slot до блоку за новим PC
+        emit.MOV_IMM64(REG_TMP2, reinterpret_cast<uint64_t>(&pending_slot_));
+        emit.STR(REG_TMP1, REG_TMP2, 0);
+    }
+    
+    EmitReturnToDispatcher(emit);
 }
 
 inline Cond JitCompiler::TranslatePPCCondition(uint8_t bi, bool branch_true) {
@@ -316,24 +1111,32 @@ inline CompiledBlock* JitCompiler::CompileBlock(const uint8_t* guest_code,
     // Check if already compiled
     if (auto* existing = LookupBlock(guest_addr)) {
         existing->entry_count++;
+        TouchRegion(existing->region);
         return existing;
     }
     
-    // Allocate code buffer
-    void* code_start = static_cast<uint8_t*>(code_cache_) + code_cache_used_;
-    size_t remaining = code_cache_size_ - code_cache_used_;
-    
-    if (remaining < 8192) {
-        // Cache full - flush and restart
-        FlushCache();
-        code_start = code_cache_;
-        remaining = code_cache_size_;
-    }
+    // Allocate code buffer (cache full - evict the least recently used region)
+    uint8_t* code_start = ReserveCode(8192, true);
+    size_t remaining = GetRegionRemaining();
     
     // Create code buffer and emitter
-    CodeBuffer codebuf(code_start, std::min(remaining, config_.max_block_size * 4));
+    CodeBuffer codebuf(code_start, std::min(remaining, config_.max_block_size * 4),
+                       code_write_offset_);
     Emitter emit(codebuf);
     PPCTranslator translator(emit);
+    std::vector<FastmemAccess> translator_sites;
+    if (config_.enable_fast_memory) {
+        translator.EnableFastmem(&codebuf, &translator_sites);
+    }
+    translator.EnableVMX(offsetof(PPCState, vr), offsetof(PPCState, vscr),
+                         offsetof(PPCState, fpr) + 16 * sizeof(double),
+                         config_.vmx_fast_math);
+    
+    auto block = std::make_unique<CompiledBlock>();
+    
+    // Block prologue - linked branches jump straight to body
+    EmitPrologue(emit);
+    block->body = codebuf.GetCurrent();
     
     size_t guest_offset = 0;
     size_t instr_count = 0;
@@ -402,6 +1205,12 @@ inline CompiledBlock* JitCompiler::CompileBlock(const uint8_t* guest_code,
                 break;
                 
             case ppc::PrimaryOp::LWZ:
+                if (config_.enable_fast_memory) {
+                    // lwz rD, d(rA) → ldr wD, [x28, wEA, uxtw] ; rev wD, wD
+                    EmitGuestLoad(emit, codebuf, 4, static_cast<GpReg>(instr.rD),
+                                  instr.rA, instr.simm);
+                    break;
+                }
                 // lwz rD, d(rA) → ldr wD, [xA, #d]
                 emit.LDRWi(static_cast<GpReg>(instr.rD),
                           instr.rA == 0 ? GpReg::ZR : static_cast<GpReg>(instr.rA),
@@ -409,34 +1218,103 @@ inline CompiledBlock* JitCompiler::CompileBlock(const uint8_t* guest_code,
                 break;
                 
             case ppc::PrimaryOp::STW:
+                if (config_.enable_fast_memory) {
+                    // stw rS, d(rA) → rev w26, wS ; str w26, [x28, wEA, uxtw]
+                    EmitGuestStore(emit, codebuf, 4, static_cast<GpReg>(instr.rS),
+                                   instr.rA, instr.simm);
+                    break;
+                }
                 // stw rS, d(rA) → str wS, [xA, #d]
                 emit.STRWi(static_cast<GpReg>(instr.rS),
                           instr.rA == 0 ? GpReg::ZR : static_cast<GpReg>(instr.rA),
                           instr.simm);
                 break;
                 
-            case ppc::PrimaryOp::B:
-                // Branch - end of block
-                emit.B(instr.li);
+            case ppc::PrimaryOp::CMPI:
+            case ppc::PrimaryOp::CMPLI:
+                // cmpi/cmpli → cmp; CR field матеріалізується лише при читанні
+                translator.Translate(instr);
+                break;
+                
+            case ppc::PrimaryOp::B: {
+                // Branch - end of block, exit stub is linked once target is compiled
+                translator.FlushFlags();
+                uint64_t target = instr.aa ? static_cast<uint64_t>(static_cast<int64_t>(instr.li))
+                                           : current_addr + instr.li;
+                if (instr.lk) {
+                    EmitSetLR(emit, next_addr);
+                    EmitReturnPush(emit, block.get(), next_addr);
+                }
+                EmitDirectExit(emit, codebuf, block.get(), target);
+                block_end = true;
+                break;
+            }
+                
+            case ppc::PrimaryOp::BC: {
+                // Branch conditional - taken and fall-through exits
+                uint64_t target = instr.aa ? static_cast<uint64_t>(static_cast<int64_t>(instr.bd))
+                                           : current_addr + instr.bd;
+                bool always = (instr.bo & 0x10) != 0;  // BO: ignore CR bit
+                if (instr.lk) {
+                    EmitSetLR(emit, next_addr);
+                    if (always) EmitReturnPush(emit, block.get(), next_addr);
+                }
+                if (!always) {
+                    // Fused з попереднім cmp, якщо bi у відкладеному CR field
+                    Cond cond = translator.EmitBranchCondition(instr.bi, (instr.bo & 8) != 0);
+                    uint32_t* taken = codebuf.GetCurrent();
+                    emit.NOP();
+                    EmitDirectExit(emit, codebuf, block.get(), next_addr);
+                    *codebuf.Writable(taken) = EncodeBCond(cond, (codebuf.GetCurrent() - taken) * 4);
+                } else {
+                    translator.FlushFlags();
+                }
+                EmitDirectExit(emit, codebuf, block.get(), target);
                 block_end = true;
                 break;
+            }
                 
-            case ppc::PrimaryOp::BC:
-                // Branch conditional
-                emit.Bcond(TranslatePPCCondition(instr.bi, (instr.bo & 8) != 0), 
-                          instr.bd);
-                if (instr.bo == 20) { // Unconditional
-                    block_end = true;
+            case ppc::PrimaryOp::OP19: {
+                auto xo = static_cast<ppc::ExtOp19>(instr.xo);
+                if (xo != ppc::ExtOp19::BCLR && xo != ppc::ExtOp19::BCCTR) {
+                    translator.FlushFlags();
+                    emit.BRK(static_cast<uint16_t>(instr.primary));
+                    break;
                 }
+                // blr / bctr - RAS (blr) та inline cache, інакше через dispatcher
+                bool is_return = xo == ppc::ExtOp19::BCLR;
+                uint32_t* taken = nullptr;
+                if ((instr.bo & 0x10) == 0) {
+                    Cond cond = translator.EmitBranchCondition(instr.bi, (instr.bo & 8) != 0);
+                    taken = codebuf.GetCurrent();
+                    emit.NOP();
+                    EmitDirectExit(emit, codebuf, block.get(), next_addr);
+                    *codebuf.Writable(taken) = EncodeBCond(cond, (codebuf.GetCurrent() - taken) * 4);
+                } else {
+                    translator.FlushFlags();  // inline cache нижче робить CMP
+                }
+                EmitIndirectExit(emit, codebuf, block.get(),
+                                 is_return ? kStateOffsetLR : kStateOffsetCTR,
+                                 is_return, instr.lk, next_addr);
+                block_end = true;
                 break;
+            }
                 
             case ppc::PrimaryOp::OP31:
                 // Extended ALU operations
                 translator.TranslateOp31(instr);
                 break;
                 
+            case ppc::PrimaryOp::VMX:
+                if (!translator.TranslateVMX(instr)) {
+                    translator.FlushFlags();
+                    emit.BRK(static_cast<uint16_t>(instr.primary));
+                }
+                break;
+                
             default:
                 // Unsupported - emit breakpoint or interpreter call
+                translator.FlushFlags();
                 emit.BRK(static_cast<uint16_t>(instr.primary));
                 break;
         }
@@ -446,28 +1324,37 @@ inline CompiledBlock* JitCompiler::CompileBlock(const uint8_t* guest_code,
         total_instructions_++;
     }
     
-    // Emit block epilogue - return to dispatcher
-    emit.RET();
+    for (const auto& access : translator_sites) {
+        RecordFastmemSite(access);
+    }
+    
+    // Block ended without a branch - fall through to the next block
+    if (!block_end) {
+        translator.FlushFlags();
+        EmitDirectExit(emit, codebuf, block.get(), guest_addr + guest_offset);
+    }
     
     // Finalize block
     size_t code_size = codebuf.GetOffset();
     
-    // Make code executable
-    __builtin___clear_cache(static_cast<char*>(code_start),
-                            static_cast<char*>(code_start) + code_size);
-    
-    auto block = std::make_unique<CompiledBlock>();
     block->code = code_start;
     block->code_size = code_size;
     block->guest_addr = guest_addr;
     block->guest_size = guest_offset;
     block->entry_count = 1;
+    block->region = current_region_;
     
     // Update cache usage (align to 16 bytes)
-    code_cache_used_ += (code_size + 15) & ~15;
+    CommitCode(code_start, code_size);
+    TouchRegion(current_region_);
     
     CompiledBlock* result = block.get();
     block_cache_[guest_addr] = std::move(block);
+    IndexCodePages(*result);
+    LinkBlock(result);
+    
+    // Make code executable: block body and linked stubs in one batch
+    SyncCode();
     
     return result;
 }
@@ -536,6 +1423,8 @@ inline void JitCompiler::Execute(PPCState* state, CompiledBlock* block) {
     
     block->entry_count++;
     total_executions_++;
+    TouchRegion(block->region);
+    SyncCode();
     
     // Cast compiled code to function pointer and execute
     // The generated code expects PPCState* in X0
@@ -543,10 +1432,17 @@ inline void JitCompiler::Execute(PPCState* state, CompiledBlock* block) {
     
     // Execute the compiled ARM64 code
     // This will modify state->gpr, state->pc, etc.
+    // Exit stubs store the next guest PC; linked blocks may run several blocks here
     code_fn(state);
     
-    // Update PC to next instruction after the block
-    state->pc = block->guest_addr + block->guest_size;
+    // Inline cache miss on blr/bctr - bind the slot to the block at the new PC
+    if (pending_slot_) {
+        IndirectTarget* slot = pending_slot_;
+        pending_slot_ = nullptr;
+        if (auto* target = LookupBlock(state->pc)) {
+            BindSlot(slot, target);
+        }
+    }
 }
 
 } // namespace rpcsx::nce
@@ -6,6 +6,7 @@
 #ifndef RPCSX_PPC_DECODER_H
 #define RPCSX_PPC_DECODER_H
 
+#include <array>
 #include <cstdint>
 #include <cstddef>
 
@@ -38,6 +39,7 @@ enum class VR : uint8_t {
 // PowerPC опкоди (primary opcode - біти 0-5)
 enum class PrimaryOp : uint8_t {
     TWI = 3,        // Trap Word Immediate
+    VMX = 4,        // AltiVec/VMX (VA/VX/VC forms)
     MULLI = 7,      // Multiply Low Immediate
     SUBFIC = 8,     // Subtract From Immediate Carrying
     CMPLI = 10,     // Compare Logical Immediate
@@ -334,6 +336,232 @@ struct DecodedInstr {
  */
 DecodedInstr DecodeInstruction(const uint8_t* code, uint64_t pc);
 
+/**
+ * Чи записує інструкція CR (Rc=1). addic./andi./andis. - окремі primary opcode,
+ * а в інших D-формах біт 31 належить immediate і не є Rc.
+ */
+inline bool IsRecordForm(uint32_t raw) {
+    switch ((raw >> 26) & 0x3F) {
+    case 13: case 28: case 29:              // addic., andi., andis.
+        return true;
+    case 20: case 21: case 23: case 30:     // M / MD-form rotates
+    case 31: case 59: case 63:              // X / XO / A-form
+        return (raw & 1) != 0;
+    default:
+        return false;
+    }
+}
+
+namespace detail {
+
+/**
+ * Таблиці типів інструкцій, згенеровані під час компіляції.
+ * Перший рівень - primary opcode разом з бітами 30-31 (AA/LK для b, DS для
+ * ld/std), другий - XO (біти 21-30) для груп 19 і 31
+ */
+struct DecodeTables {
+    std::array<InstrType, 256> primary{};
+    std::array<InstrType, 1024> op19{};
+    std::array<InstrType, 1024> op31{};
+};
+
+constexpr DecodeTables BuildDecodeTables() {
+    DecodeTables t{};
+
+    auto op = [&](PrimaryOp primary, InstrType type) {
+        for (uint32_t low = 0; low < 4; ++low) {
+            t.primary[(static_cast<uint32_t>(primary) << 2) | low] = type;
+        }
+    };
+    auto op_low = [&](PrimaryOp primary, uint32_t low, InstrType type) {
+        t.primary[(static_cast<uint32_t>(primary) << 2) | low] = type;
+    };
+    auto op19 = [&](ExtOp19 xo, InstrType type) { t.op19[static_cast<uint32_t>(xo)] = type; };
+    auto op31 = [&](ExtOp31 xo, InstrType type) { t.op31[static_cast<uint32_t>(xo)] = type; };
+
+    // Load/Store
+    op(PrimaryOp::LWZ, InstrType::LOAD_WORD);
+    op(PrimaryOp::LWZU, InstrType::LOAD_WORD);
+    op(PrimaryOp::LBZ, InstrType::LOAD_BYTE);
+    op(PrimaryOp::LBZU, InstrType::LOAD_BYTE);
+    op(PrimaryOp::LHZ, InstrType::LOAD_HALF);
+    op(PrimaryOp::LHZU, InstrType::LOAD_HALF);
+    op(PrimaryOp::LHA, InstrType::LOAD_HALF);
+    op(PrimaryOp::LHAU, InstrType::LOAD_HALF);
+    op(PrimaryOp::STW, InstrType::STORE_WORD);
+    op(PrimaryOp::STWU, InstrType::STORE_WORD);
+    op(PrimaryOp::STB, InstrType::STORE_BYTE);
+    op(PrimaryOp::STBU, InstrType::STORE_BYTE);
+    op(PrimaryOp::STH, InstrType::STORE_HALF);
+    op(PrimaryOp::STHU, InstrType::STORE_HALF);
+    op(PrimaryOp::LMW, InstrType::LOAD_MULTIPLE);
+    op(PrimaryOp::STMW, InstrType::STORE_MULTIPLE);
+
+    // 64-bit Load/Store: DS-form, біти 30-31 вибирають ld/ldu/lwa і std/stdu
+    op_low(PrimaryOp::OP58, 0, InstrType::LOAD_DOUBLE);
+    op_low(PrimaryOp::OP58, 1, InstrType::LOAD_DOUBLE);
+    op_low(PrimaryOp::OP58, 2, InstrType::LOAD_WORD);
+    op_low(PrimaryOp::OP62, 0, InstrType::STORE_DOUBLE);
+    op_low(PrimaryOp::OP62, 1, InstrType::STORE_DOUBLE);
+
+    // Arithmetic / Logic / Compare Immediate
+    op(PrimaryOp::ADDI, InstrType::ADDI);
+    op(PrimaryOp::ADDIS, InstrType::ADDIS);
+    op(PrimaryOp::ADDIC, InstrType::ADDIC);
+    op(PrimaryOp::ADDIC_RC, InstrType::ADDIC);
+    op(PrimaryOp::SUBFIC, InstrType::SUBFIC);
+    op(PrimaryOp::MULLI, InstrType::MULLI);
+    op(PrimaryOp::ORI, InstrType::ORI);
+    op(PrimaryOp::ORIS, InstrType::ORIS);
+    op(PrimaryOp::XORI, InstrType::XORI);
+    op(PrimaryOp::XORIS, InstrType::XORIS);
+    op(PrimaryOp::ANDI_RC, InstrType::ANDI);
+    op(PrimaryOp::ANDIS_RC, InstrType::ANDIS);
+    op(PrimaryOp::CMPI, InstrType::CMPI);
+    op(PrimaryOp::CMPLI, InstrType::CMPLI);
+
+    // Branch: біт 31 (LK) відрізняє bl від b
+    op_low(PrimaryOp::B, 0, InstrType::B);
+    op_low(PrimaryOp::B, 1, InstrType::BL);
+    op_low(PrimaryOp::B, 2, InstrType::B);
+    op_low(PrimaryOp::B, 3, InstrType::BL);
+    op(PrimaryOp::BC, InstrType::BC);
+    op(PrimaryOp::SC, InstrType::SC);
+
+    // Rotate / Trap / Float
+    op(PrimaryOp::RLWIMI, InstrType::RLWIMI);
+    op(PrimaryOp::RLWINM, InstrType::RLWINM);
+    op(PrimaryOp::RLWNM, InstrType::RLWNM);
+    op(PrimaryOp::TWI, InstrType::TWI);
+    op(PrimaryOp::LFS, InstrType::FP_LOAD);
+    op(PrimaryOp::LFSU, InstrType::FP_LOAD);
+    op(PrimaryOp::LFD, InstrType::FP_LOAD);
+    op(PrimaryOp::LFDU, InstrType::FP_LOAD);
+    op(PrimaryOp::STFS, InstrType::FP_STORE);
+    op(PrimaryOp::STFSU, InstrType::FP_STORE);
+    op(PrimaryOp::STFD, InstrType::FP_STORE);
+    op(PrimaryOp::STFDU, InstrType::FP_STORE);
+    op(PrimaryOp::OP59, InstrType::FP_ARITH);
+    op(PrimaryOp::OP63, InstrType::FP_ARITH);
+
+    // Extended opcode 19
+    op19(ExtOp19::BCLR, InstrType::BCLR);
+    op19(ExtOp19::BCCTR, InstrType::BCCTR);
+    op19(ExtOp19::MCRF, InstrType::MCRF);
+    op19(ExtOp19::CRAND, InstrType::CRAND);
+    op19(ExtOp19::CROR, InstrType::CROR);
+    op19(ExtOp19::CRXOR, InstrType::CRXOR);
+    op19(ExtOp19::CRNAND, InstrType::CRNAND);
+    op19(ExtOp19::CRNOR, InstrType::CRNOR);
+    op19(ExtOp19::CREQV, InstrType::CREQV);
+    op19(ExtOp19::CRANDC, InstrType::CRANDC);
+    op19(ExtOp19::CRORC, InstrType::CRORC);
+    op19(ExtOp19::RFI, InstrType::RFI);
+    op19(ExtOp19::ISYNC, InstrType::ISYNC);
+
+    // Extended opcode 31: arithmetic
+    op31(ExtOp31::ADD, InstrType::ADD);
+    op31(ExtOp31::ADDC, InstrType::ADDC);
+    op31(ExtOp31::ADDE, InstrType::ADD);
+    op31(ExtOp31::ADDZE, InstrType::ADD);
+    op31(ExtOp31::ADDME, InstrType::ADD);
+    op31(ExtOp31::SUBF, InstrType::SUBF);
+    op31(ExtOp31::SUBFC, InstrType::SUB);
+    op31(ExtOp31::SUBFE, InstrType::SUB);
+    op31(ExtOp31::SUBFZE, InstrType::SUB);
+    op31(ExtOp31::SUBFME, InstrType::SUB);
+    op31(ExtOp31::MULLW, InstrType::MULLW);
+    op31(ExtOp31::MULHW, InstrType::MULLW);
+    op31(ExtOp31::MULHWU, InstrType::MULLW);
+    op31(ExtOp31::DIVW, InstrType::DIVW);
+    op31(ExtOp31::DIVWU, InstrType::DIVWU);
+    op31(ExtOp31::NEG, InstrType::NEG);
+
+    // Logic / Shift / Compare
+    op31(ExtOp31::AND, InstrType::AND);
+    op31(ExtOp31::ANDC, InstrType::ANDC);
+    op31(ExtOp31::OR, InstrType::OR);
+    op31(ExtOp31::ORC, InstrType::ORC);
+    op31(ExtOp31::XOR, InstrType::XOR);
+    op31(ExtOp31::NAND, InstrType::NAND);
+    op31(ExtOp31::NOR, InstrType::NOR);
+    op31(ExtOp31::EQV, InstrType::EQV);
+    op31(ExtOp31::SLW, InstrType::SLW);
+    op31(ExtOp31::SRW, InstrType::SRW);
+    op31(ExtOp31::SRAW, InstrType::SRAW);
+    op31(ExtOp31::SRAWI, InstrType::SRAWI);
+    op31(ExtOp31::CMP, InstrType::CMP);
+    op31(ExtOp31::CMPL, InstrType::CMPL);
+
+    // Load / Store indexed (lwarx / stwcx. - як звичайні load / store)
+    op31(ExtOp31::LWZX, InstrType::LOAD_WORD);
+    op31(ExtOp31::LWZUX, InstrType::LOAD_WORD);
+    op31(ExtOp31::LWAX, InstrType::LOAD_WORD);
+    op31(ExtOp31::LWARX, InstrType::LOAD_WORD);
+    op31(ExtOp31::LBZX, InstrType::LOAD_BYTE);
+    op31(ExtOp31::LBZUX, InstrType::LOAD_BYTE);
+    op31(ExtOp31::LHZX, InstrType::LOAD_HALF);
+    op31(ExtOp31::LHZUX, InstrType::LOAD_HALF);
+    op31(ExtOp31::LHAX, InstrType::LOAD_HALF);
+    op31(ExtOp31::LHAUX, InstrType::LOAD_HALF);
+    op31(ExtOp31::LDX, InstrType::LOAD_DOUBLE);
+    op31(ExtOp31::LDUX, InstrType::LOAD_DOUBLE);
+    op31(ExtOp31::STWX, InstrType::STORE_WORD);
+    op31(ExtOp31::STWUX, InstrType::STORE_WORD);
+    op31(ExtOp31::STWCX, InstrType::STORE_WORD);
+    op31(ExtOp31::STBX, InstrType::STORE_BYTE);
+    op31(ExtOp31::STBUX, InstrType::STORE_BYTE);
+    op31(ExtOp31::STHX, InstrType::STORE_HALF);
+    op31(ExtOp31::STHUX, InstrType::STORE_HALF);
+    op31(ExtOp31::STDX, InstrType::STORE_DOUBLE);
+    op31(ExtOp31::STDUX, InstrType::STORE_DOUBLE);
+
+    // Special registers / Extend / Cache / Sync / Trap
+    op31(ExtOp31::MFSPR, InstrType::MFSPR);
+    op31(ExtOp31::MTSPR, InstrType::MTSPR);
+    op31(ExtOp31::MFCR, InstrType::MFCR);
+    op31(ExtOp31::MTCRF, InstrType::MTCRF);
+    op31(ExtOp31::EXTSB, InstrType::EXTSB);
+    op31(ExtOp31::EXTSH, InstrType::EXTSH);
+    op31(ExtOp31::EXTSW, InstrType::EXTSW);
+    op31(ExtOp31::CNTLZW, InstrType::CNTLZW);
+    op31(ExtOp31::DCBF, InstrType::DCBF);
+    op31(ExtOp31::DCBI, InstrType::DCBI);
+    op31(ExtOp31::DCBST, InstrType::DCBST);
+    op31(ExtOp31::DCBT, InstrType::DCBT);
+    op31(ExtOp31::DCBTST, InstrType::DCBTST);
+    op31(ExtOp31::DCBZ, InstrType::DCBZ);
+    op31(ExtOp31::ICBI, InstrType::ICBI);
+    op31(ExtOp31::EIEIO, InstrType::EIEIO);
+    op31(ExtOp31::TW, InstrType::TW);
+
+    return t;
+}
+
+inline constexpr DecodeTables kDecodeTables = BuildDecodeTables();
+
+} // namespace detail
+
+/**
+ * Тип інструкції: один індексований load, для груп 19/31 - ще один за XO
+ */
+constexpr InstrType DecodeType(uint32_t raw) {
+    const uint32_t primary = raw >> 26;
+    if (primary == static_cast<uint32_t>(PrimaryOp::OP19)) {
+        return detail::kDecodeTables.op19[(raw >> 1) & 0x3FF];
+    }
+    if (primary == static_cast<uint32_t>(PrimaryOp::OP31)) {
+        return detail::kDecodeTables.op31[(raw >> 1) & 0x3FF];
+    }
+    return detail::kDecodeTables.primary[(primary << 2) | (raw & 3)];
+}
+
+static_assert(DecodeType(0x38600001) == InstrType::ADDI);     // li r3, 1
+static_assert(DecodeType(0x48000001) == InstrType::BL);       // bl +0
+static_assert(DecodeType(0x4E800020) == InstrType::BCLR);     // blr
+static_assert(DecodeType(0x7C0802A6) == InstrType::MFSPR);    // mflr r0
+static_assert(DecodeType(0xE8010010) == InstrType::LOAD_DOUBLE); // ld r0, 16(r1)
+
 /**
  * Декодувати raw PowerPC інструкцію (convenience function)
  * @param raw 32-bit instruction (already byte-swapped if needed)
@@ -342,6 +570,7 @@ DecodedInstr DecodeInstruction(const uint8_t* code, uint64_t pc);
 inline DecodedInstr Decode(uint32_t raw) {
     DecodedInstr instr{};
     instr.raw = raw;
+    instr.type = DecodeType(raw);
     
     // Primary opcode (bits 0-5)
     instr.primary = static_cast<PrimaryOp>((raw >> 26) & 0x3F);
@@ -356,7 +585,7 @@ inline DecodedInstr Decode(uint32_t raw) {
     // X-form: rD (6-10), rA (11-15), rB (16-20), XO (21-30), Rc (31)
     instr.rB = (raw >> 11) & 0x1F;
     instr.xo = (raw >> 1) & 0x3FF;
-    instr.rc = raw & 1;
+    instr.rc = IsRecordForm(raw);
     instr.oe = (raw >> 10) & 1;
     
     // I-form (branch): LI (6-29), AA (30), LK (31)
@@ -68,6 +68,10 @@ public:
         return table_[idx].Predict();
     }
     
+    uint8_t GetConfidence(uint64_t pc, uint64_t history) const {
+        return table_[Hash(pc, history)].GetConfidence();
+    }
+    
     void Update(uint64_t pc, uint64_t history, bool taken) {
         size_t idx = Hash(pc, history);
         table_[idx].Update(taken);
@@ -123,7 +127,7 @@ public:
     }
     
     // Returns: true if prediction made, result in 'prediction'
-    bool Predict(uint64_t pc, bool& prediction) {
+    bool Predict(uint64_t pc, bool& prediction) const {
         size_t idx = pc & (TABLE_SIZE - 1);
         auto& entry = table_[idx];
         
@@ -140,6 +144,17 @@ public:
         return true;
     }
     
+    // Detected trip count for a loop branch (for tier-up scoring)
+    bool GetTripCount(uint64_t pc, uint16_t& trip_count, uint8_t& confidence) const {
+        const auto& entry = table_[pc & (TABLE_SIZE - 1)];
+        if (!entry.valid || entry.tag != (pc >> 8)) {
+            return false;
+        }
+        trip_count = entry.trip_count;
+        confidence = entry.confidence;
+        return true;
+    }
+    
     void Update(uint64_t pc, bool taken) {
         size_t idx = pc & (TABLE_SIZE - 1);
         auto& entry = table_[idx];
@@ -237,6 +252,11 @@ public:
         return false;
     }
     
+    uint8_t GetConfidence(uint64_t pc) const {
+        const auto& entry = table_[pc & (TABLE_SIZE - 1)];
+        return (entry.valid && entry.pc_tag == (pc >> 9)) ? entry.confidence : 0;
+    }
+    
     void Update(uint64_t pc, uint64_t actual_target) {
         size_t idx = pc & (TABLE_SIZE - 1);
         auto& entry = table_[idx];
@@ -310,6 +330,18 @@ public:
         correct_predictions_ = 0;
     }
     
+    // Per-branch summary for profile-guided tier-up and superblock layout
+    struct BranchSummary {
+        bool is_loop;              // LoopPredictor has a stable trip count
+        uint16_t trip_count;
+        uint8_t loop_confidence;   // 0-7
+        bool biased_taken;         // Bimodal direction
+        uint8_t bias_confidence;   // 1 (weak) or 3 (strong)
+        bool has_indirect_target;
+        uint64_t indirect_target;
+    };
+    BranchSummary Summarize(uint64_t pc) const;
+    
 private:
     // Bimodal predictor (fallback)
     BranchHistoryTable<4096> bimodal_;
@@ -400,6 +432,30 @@ CombinedBranchPredictor::Predict(uint64_t pc, bool is_call, bool is_return, bool
     return pred;
 }
 
+inline CombinedBranchPredictor::BranchSummary
+CombinedBranchPredictor::Summarize(uint64_t pc) const {
+    BranchSummary summary{};
+    
+    uint16_t trip = 0;
+    uint8_t confidence = 0;
+    if (loop_predictor_.GetTripCount(pc, trip, confidence)) {
+        summary.is_loop = trip > 0 && confidence >= 3;
+        summary.trip_count = trip;
+        summary.loop_confidence = confidence;
+    }
+    
+    summary.biased_taken = bimodal_.Predict(pc, 0);
+    summary.bias_confidence = bimodal_.GetConfidence(pc, 0);
+    
+    uint64_t target = 0;
+    if (ibtb_.Predict(pc, target)) {
+        summary.has_indirect_target = true;
+        summary.indirect_target = target;
+    }
+    
+    return summary;
+}
+
 inline void CombinedBranchPredictor::Update(uint64_t pc, bool taken, uint64_t actual_target,
                                              bool is_call, bool is_return, bool is_indirect) {
     // Update RAS for calls/returns
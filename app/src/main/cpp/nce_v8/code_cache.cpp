@@ -0,0 +1,350 @@
+/**
+ * ╔══════════════════════════════════════════════════════════════════════════╗
+ * ║                NCE v8 - Persistent JIT Code Cache Implementation         ║
+ * ╚══════════════════════════════════════════════════════════════════════════╝
+ */
+
+#include "code_cache.h"
+#include <android/log.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+
+#define LOG_TAG "NCE-v8-CodeCache"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace rpcsx::nce::v8 {
+
+static constexpr uint32_t kCodeCacheMetaVersion = 1;
+static constexpr uint32_t kCodeCacheMagic = 0x4A45434E;  // "NCEJ"
+static constexpr uint32_t kProfileMagic = 0x5045434E;    // "NCEP"
+
+// Профіль блоку: [addr:8][exec_count:8][flags:1]
+struct BlockProfileRecord {
+    uint64_t address;
+    uint64_t execution_count;
+    uint8_t flags;  // bit0 = loop header
+} __attribute__((packed));
+
+// Формат запису: [addr:8][guest_size:4][guest_hash:8][tier:1][code_size:4][code:code_size]
+struct EntryHeader {
+    uint64_t guest_address;
+    uint32_t guest_size;
+    uint64_t guest_hash;
+    uint8_t tier;
+    uint32_t code_size;
+} __attribute__((packed));
+
+static std::string Trim(std::string s) {
+    while (!s.empty() && (s.back() == '\n' || s.back() == '\r' || s.back() == ' ' || s.back() == '\t')) s.pop_back();
+    size_t i = 0;
+    while (i < s.size() && (s[i] == ' ' || s[i] == '\t')) i++;
+    if (i) s.erase(0, i);
+    return s;
+}
+
+PersistentCodeCache::~PersistentCodeCache() {
+    Close();
+}
+
+uint64_t PersistentCodeCache::HashGuestCode(const uint8_t* code, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV offset basis
+    for (size_t i = 0; i < size; i++) {
+        hash ^= code[i];
+        hash *= 0x100000001b3ULL;  // FNV prime
+    }
+    return hash;
+}
+
+bool PersistentCodeCache::EnsureCompatible(const std::string& root_dir, const std::string& build_id) {
+    const std::string meta_path = root_dir + "/jit_cache_meta.txt";
+
+    uint32_t version = 0;
+    std::string build;
+    std::string engine;
+    {
+        std::ifstream in(meta_path);
+        std::string line;
+        while (in && std::getline(in, line)) {
+            line = Trim(line);
+            if (line.rfind("version=", 0) == 0) version = static_cast<uint32_t>(std::strtoul(line.c_str() + 8, nullptr, 10));
+            if (line.rfind("build=", 0) == 0) build = line.substr(6);
+            if (line.rfind("engine=", 0) == 0) engine = line.substr(7);
+        }
+    }
+
+    const bool compatible = version == kCodeCacheMetaVersion && build == build_id &&
+                            engine == NCE_VERSION_STRING;
+    if (!compatible) {
+        if (version != 0) {
+            LOGI("JIT cache meta mismatch: v%u/%u build='%s'/'%s' engine='%s'/'%s'",
+                 version, kCodeCacheMetaVersion, build.c_str(), build_id.c_str(),
+                 engine.c_str(), NCE_VERSION_STRING);
+        }
+        if (unlink(cache_file_.c_str()) == 0) {
+            LOGI("Purged JIT cache file: %s", cache_file_.c_str());
+        }
+        unlink(profile_file_.c_str());
+
+        std::ofstream out(meta_path, std::ios::out | std::ios::trunc);
+        if (!out) {
+            LOGE("Failed to write JIT cache meta: %s", meta_path.c_str());
+            return false;
+        }
+        out << "version=" << kCodeCacheMetaVersion << "\n";
+        out << "build=" << build_id << "\n";
+        out << "engine=" << NCE_VERSION_STRING << "\n";
+    }
+    return true;
+}
+
+bool PersistentCodeCache::Open(const std::string& cache_directory, const std::string& title_id,
+                               const std::string& build_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const std::string title = title_id.empty() ? "default" : title_id;
+    const std::string root_dir = cache_directory + "/" + title;
+    mkdir(cache_directory.c_str(), 0755);
+    mkdir(root_dir.c_str(), 0755);
+
+    cache_file_ = root_dir + "/jit_cache.bin";
+    profile_file_ = root_dir + "/jit_profile.bin";
+    entries_.clear();
+    hits_ = 0;
+    rejected_ = 0;
+
+    if (!EnsureCompatible(root_dir, build_id.empty() ? "unknown" : build_id)) {
+        cache_file_.clear();
+        profile_file_.clear();
+        return false;
+    }
+
+    LoadEntries();
+
+    LOGI("JIT code cache opened: %s (%zu blocks)", cache_file_.c_str(), entries_.size());
+    return true;
+}
+
+void PersistentCodeCache::LoadEntries() {
+    std::ifstream in(cache_file_, std::ios::binary);
+    if (!in) return;
+
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    if (!in || magic != kCodeCacheMagic) {
+        LOGW("JIT cache has bad magic, ignoring: %s", cache_file_.c_str());
+        in.close();
+        unlink(cache_file_.c_str());
+        return;
+    }
+
+    while (true) {
+        EntryHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in) break;
+
+        // Обрізаний хвіст (crash під час запису) - зупиняємося на останньому цілому записі
+        if (header.code_size == 0 || header.code_size > 16 * 1024 * 1024) break;
+
+        Entry entry;
+        entry.guest_address = header.guest_address;
+        entry.guest_size = header.guest_size;
+        entry.guest_hash = header.guest_hash;
+        entry.tier = static_cast<CompilationTier>(header.tier);
+        entry.native_code.resize(header.code_size);
+        in.read(reinterpret_cast<char*>(entry.native_code.data()), header.code_size);
+        if (!in) break;
+
+        // Пізніші записи перекривають попередні
+        entries_[entry.guest_address] = std::move(entry);
+    }
+}
+
+void PersistentCodeCache::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_file_.empty()) return;
+
+    LOGI("JIT code cache closed: %zu blocks, %llu hits, %llu rejected",
+         entries_.size(),
+         static_cast<unsigned long long>(hits_),
+         static_cast<unsigned long long>(rejected_));
+
+    entries_.clear();
+    cache_file_.clear();
+    profile_file_.clear();
+}
+
+bool PersistentCodeCache::Lookup(uint64_t address, const uint8_t* guest_code, size_t guest_size,
+                                 Entry* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(address);
+    if (it == entries_.end()) return false;
+
+    const Entry& entry = it->second;
+    if (!guest_code || entry.guest_size != guest_size ||
+        entry.guest_hash != HashGuestCode(guest_code, guest_size)) {
+        // Guest код змінився (патч, інший регіон гри) - запис недійсний
+        rejected_++;
+        entries_.erase(it);
+        return false;
+    }
+
+    hits_++;
+    if (out) *out = entry;
+    return true;
+}
+
+void PersistentCodeCache::Store(uint64_t address, const uint8_t* guest_code, size_t guest_size,
+                                CompilationTier tier, const void* native_code, size_t native_size) {
+    if (!guest_code || !native_code || native_size == 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_file_.empty()) return;
+
+    EntryHeader header;
+    header.guest_address = address;
+    header.guest_size = static_cast<uint32_t>(guest_size);
+    header.guest_hash = HashGuestCode(guest_code, guest_size);
+    header.tier = static_cast<uint8_t>(tier);
+    header.code_size = static_cast<uint32_t>(native_size);
+
+    auto existing = entries_.find(address);
+    if (existing != entries_.end() && existing->second.guest_hash == header.guest_hash &&
+        existing->second.tier >= tier) {
+        return;
+    }
+
+    struct stat st;
+    const bool fresh = stat(cache_file_.c_str(), &st) != 0 || st.st_size == 0;
+
+    std::ofstream out(cache_file_, std::ios::binary | std::ios::app);
+    if (!out) {
+        LOGE("Failed to open JIT cache file: %s", cache_file_.c_str());
+        return;
+    }
+    if (fresh) {
+        out.write(reinterpret_cast<const char*>(&kCodeCacheMagic), sizeof(kCodeCacheMagic));
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(static_cast<const char*>(native_code), native_size);
+
+    Entry entry;
+    entry.guest_address = address;
+    entry.guest_size = header.guest_size;
+    entry.guest_hash = header.guest_hash;
+    entry.tier = tier;
+    entry.native_code.assign(static_cast<const uint8_t*>(native_code),
+                             static_cast<const uint8_t*>(native_code) + native_size);
+    entries_[address] = std::move(entry);
+}
+
+void PersistentCodeCache::Invalidate(uint64_t address, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ) {
+        if (it->first >= address && it->first < address + size) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool PersistentCodeCache::SaveProfiles(const std::vector<HotspotProfile>& blocks,
+                                       const std::vector<BranchEdgeProfile>& branches) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (profile_file_.empty()) return false;
+
+    // Пишемо у тимчасовий файл і перейменовуємо - частковий профіль гірший за старий
+    const std::string tmp_path = profile_file_ + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOGE("Failed to write JIT profile: %s", tmp_path.c_str());
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&kProfileMagic), sizeof(kProfileMagic));
+
+        uint32_t block_count = static_cast<uint32_t>(blocks.size());
+        out.write(reinterpret_cast<const char*>(&block_count), sizeof(block_count));
+        for (const auto& profile : blocks) {
+            BlockProfileRecord record;
+            record.address = profile.address;
+            record.execution_count = profile.execution_count;
+            record.flags = profile.is_loop_header ? 1 : 0;
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+
+        uint32_t branch_count = static_cast<uint32_t>(branches.size());
+        out.write(reinterpret_cast<const char*>(&branch_count), sizeof(branch_count));
+        out.write(reinterpret_cast<const char*>(branches.data()),
+                  branches.size() * sizeof(BranchEdgeProfile));
+        if (!out) return false;
+    }
+
+    if (rename(tmp_path.c_str(), profile_file_.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        return false;
+    }
+
+    LOGI("JIT profile saved: %zu blocks, %zu branches", blocks.size(), branches.size());
+    return true;
+}
+
+bool PersistentCodeCache::LoadProfiles(std::vector<HotspotProfile>& blocks,
+                                       std::vector<BranchEdgeProfile>& branches) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (profile_file_.empty()) return false;
+
+    std::ifstream in(profile_file_, std::ios::binary);
+    if (!in) return false;
+
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    if (!in || magic != kProfileMagic) return false;
+
+    uint32_t block_count = 0;
+    in.read(reinterpret_cast<char*>(&block_count), sizeof(block_count));
+    if (!in || block_count > (1u << 22)) return false;
+
+    blocks.clear();
+    blocks.reserve(block_count);
+    for (uint32_t i = 0; i < block_count; i++) {
+        BlockProfileRecord record;
+        in.read(reinterpret_cast<char*>(&record), sizeof(record));
+        if (!in) return false;
+
+        HotspotProfile profile{};
+        profile.address = record.address;
+        profile.execution_count = record.execution_count;
+        profile.is_loop_header = (record.flags & 1) != 0;
+        profile.current_tier = CompilationTier::INTERPRETER;
+        blocks.push_back(profile);
+    }
+
+    uint32_t branch_count = 0;
+    in.read(reinterpret_cast<char*>(&branch_count), sizeof(branch_count));
+    if (!in || branch_count > (1u << 22)) return false;
+
+    branches.resize(branch_count);
+    in.read(reinterpret_cast<char*>(branches.data()), branch_count * sizeof(BranchEdgeProfile));
+    if (!in) {
+        branches.clear();
+        return false;
+    }
+
+    return true;
+}
+
+size_t PersistentCodeCache::GetEntryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+} // namespace rpcsx::nce::v8
@@ -0,0 +1,94 @@
+/**
+ * ╔══════════════════════════════════════════════════════════════════════════╗
+ * ║                    NCE v8 - Persistent JIT Code Cache                    ║
+ * ║                                                                          ║
+ * ║  Tier-2 output зберігається на диск per-title / per-build, щоб другий    ║
+ * ║  запуск стартував з уже оптимізованим hot set.                           ║
+ * ║  - Ключ: guest address + FNV-1a hash байтів guest коду                   ║
+ * ║  - Валідація: hash перераховується з guest memory при завантаженні       ║
+ * ║  - Інвалідація: build-id / версія формату (як у shader cache)            ║
+ * ╚══════════════════════════════════════════════════════════════════════════╝
+ */
+
+#ifndef RPCSX_NCE_V8_CODE_CACHE_H
+#define RPCSX_NCE_V8_CODE_CACHE_H
+
+#include "nce_v8.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+namespace rpcsx::nce::v8 {
+
+class PersistentCodeCache {
+public:
+    struct Entry {
+        uint64_t guest_address;
+        uint32_t guest_size;
+        uint64_t guest_hash;
+        CompilationTier tier;
+        std::vector<uint8_t> native_code;
+    };
+
+    PersistentCodeCache() = default;
+    ~PersistentCodeCache();
+
+    /**
+     * Відкриття кешу для title у cache_directory.
+     * Якщо build_id або версія формату змінилися - кеш очищується.
+     */
+    bool Open(const std::string& cache_directory, const std::string& title_id,
+              const std::string& build_id);
+    void Close();
+
+    bool IsOpen() const { return !cache_file_.empty(); }
+
+    /**
+     * Пошук блоку (копія запису в out). Повертає false, якщо запису немає або
+     * guest код змінився (hash не збігається) - такий запис видаляється з індексу.
+     */
+    bool Lookup(uint64_t address, const uint8_t* guest_code, size_t guest_size, Entry* out);
+
+    /**
+     * Збереження tier-2 блоку (append у файл кешу).
+     * native_code має бути position-independent: OptimizingCompiler не
+     * генерує PC-relative посилань за межі блоку.
+     */
+    void Store(uint64_t address, const uint8_t* guest_code, size_t guest_size,
+               CompilationTier tier, const void* native_code, size_t native_size);
+
+    void Invalidate(uint64_t address, size_t size);
+
+    /**
+     * Per-block execution та branch профілі попереднього запуску
+     * (jit_profile.bin поруч із кешем коду, та сама інвалідація).
+     */
+    bool SaveProfiles(const std::vector<HotspotProfile>& blocks,
+                      const std::vector<BranchEdgeProfile>& branches);
+    bool LoadProfiles(std::vector<HotspotProfile>& blocks,
+                      std::vector<BranchEdgeProfile>& branches);
+
+    static uint64_t HashGuestCode(const uint8_t* code, size_t size);
+
+    size_t GetEntryCount() const;
+    uint64_t GetHits() const { return hits_; }
+    uint64_t GetRejected() const { return rejected_; }
+
+private:
+    bool EnsureCompatible(const std::string& root_dir, const std::string& build_id);
+    void LoadEntries();
+
+    std::string cache_file_;
+    std::string profile_file_;
+    std::unordered_map<uint64_t, Entry> entries_;
+    mutable std::mutex mutex_;
+
+    uint64_t hits_ = 0;
+    uint64_t rejected_ = 0;
+};
+
+} // namespace rpcsx::nce::v8
+
+#endif // RPCSX_NCE_V8_CODE_CACHE_H
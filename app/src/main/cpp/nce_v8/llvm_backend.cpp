@@ -10,6 +10,8 @@
 #include <dlfcn.h>
 #include <sys/mman.h>
 #include <sys/auxv.h>
+#include <unistd.h>
+#include <algorithm>
 #include <asm/hwcap.h>
 
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "NCE-LLVM", __VA_ARGS__)
@@ -255,6 +257,10 @@ void PPCToLLVMTranslator::StoreMemory(void* builder, void* addr, void* value, in
 // ============================================================================
 // LLVMJITEngine Implementation
 // ============================================================================
+
+// Executable allocation per compiled function
+static constexpr size_t kCodeAllocSize = 4096;
+
 LLVMJITEngine::LLVMJITEngine()
     : context_(nullptr)
     , jit_(nullptr)
@@ -275,6 +281,15 @@ bool LLVMJITEngine::Initialize(const LLVMConfig& config) {
     
     config_ = config;
     
+    memory_budget_ = config.memory_budget;
+    if (memory_budget_ == 0) {
+        const long pages = sysconf(_SC_PHYS_PAGES);
+        const long page_size = sysconf(_SC_PAGESIZE);
+        const size_t ram = pages > 0 && page_size > 0 ? size_t(pages) * size_t(page_size) : 0;
+        memory_budget_ = std::clamp<size_t>(ram / 48, 32u << 20, 256u << 20);
+    }
+    memory_used_ = 0;
+    
     // Initialize LLVM if not done
     if (!InitializeLLVM()) {
         LOGE("Failed to initialize LLVM");
@@ -291,6 +306,7 @@ bool LLVMJITEngine::Initialize(const LLVMConfig& config) {
     LOGI("  Vectorization: %s", config.enable_vectorization ? "enabled" : "disabled");
     LOGI("  Fast math: %s", config.enable_fast_math ? "enabled" : "disabled");
     LOGI("  SVE2: %s", config.use_sve2 ? "enabled" : "disabled");
+    LOGI("  Memory budget: %zu MB", memory_budget_ / (1024 * 1024));
     
     initialized_ = true;
     return true;
@@ -305,15 +321,53 @@ void LLVMJITEngine::Shutdown() {
     std::lock_guard<std::mutex> lock(cache_mutex_);
     for (auto& pair : code_cache_) {
         if (pair.second && pair.second->native_code) {
-            munmap(pair.second->native_code, pair.second->code_size);
+            munmap(pair.second->native_code, kCodeAllocSize);
         }
         delete pair.second;
     }
     code_cache_.clear();
+    memory_used_ = 0;
     
     initialized_ = false;
 }
 
+size_t LLVMJITEngine::EstimateCompileFootprint(size_t guest_size) {
+    // Module + TargetMachine state, плюс ~2KB IR / MC на guest інструкцію
+    return (256u << 10) + (guest_size / 4) * 2048;
+}
+
+bool LLVMJITEngine::HasMemoryBudget(size_t guest_size) const {
+    return GetMemoryUsed() + EstimateCompileFootprint(guest_size) + kCodeAllocSize <= memory_budget_;
+}
+
+bool LLVMJITEngine::ReserveMemory(size_t bytes) {
+    size_t used = memory_used_.load(std::memory_order_relaxed);
+    do {
+        if (used + bytes > memory_budget_) return false;
+    } while (!memory_used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+    return true;
+}
+
+void LLVMJITEngine::ReleaseMemory(size_t bytes) {
+    memory_used_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void LLVMJITEngine::Invalidate(uint64_t address, size_t size) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    for (auto it = code_cache_.begin(); it != code_cache_.end(); ) {
+        if (it->first - address < size) {
+            if (it->second && it->second->native_code) {
+                munmap(it->second->native_code, kCodeAllocSize);
+                ReleaseMemory(kCodeAllocSize);
+            }
+            delete it->second;
+            it = code_cache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 CompiledBlockV8* LLVMJITEngine::Compile(
     const uint8_t* ppc_code,
     uint64_t address,
@@ -334,9 +388,39 @@ CompiledBlockV8* LLVMJITEngine::Compile(
         }
     }
     
+    // Бюджет: на 6GB телефоні LLVM не повинен витіснити гру (OOM killer)
+    const size_t transient = EstimateCompileFootprint(size);
+    if (!ReserveMemory(transient + kCodeAllocSize)) {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (stats_.budget_rejections++ == 0) {
+            LOGW("LLVM memory budget exhausted (%zu / %zu MB)",
+                 GetMemoryUsed() / (1024 * 1024), memory_budget_ / (1024 * 1024));
+        }
+        return nullptr;
+    }
+    
+    std::lock_guard<std::mutex> compile_lock(compile_mutex_);
+    {
+        // Той самий блок міг бути скомпільований, поки чекали на compile_mutex_
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = code_cache_.find(address);
+        if (it != code_cache_.end()) {
+            ReleaseMemory(transient + kCodeAllocSize);
+            return it->second;
+        }
+    }
+    
     LOGI("LLVM compiling 0x%llx (%zu bytes)", 
          static_cast<unsigned long long>(address), size);
     
+    // Без IR немає чого встановлювати - викликач лишається на tier-2
+    void* module = translator_.TranslateBlock(ppc_code, address, size, nullptr);
+    if (!module) {
+        ReleaseMemory(transient + kCodeAllocSize);
+        return nullptr;
+    }
+    RunOptimizationPasses(module);
+    
     // Create compiled block
     CompiledBlockV8* block = new CompiledBlockV8();
     block->guest_address = address;
@@ -349,13 +433,14 @@ CompiledBlockV8* LLVMJITEngine::Compile(
     // In a full implementation, this would go through LLVM IR
     
     // Allocate executable memory
-    size_t alloc_size = 4096;  // Start with one page
+    size_t alloc_size = kCodeAllocSize;  // Start with one page
     void* code_mem = mmap(nullptr, alloc_size,
                           PROT_READ | PROT_WRITE | PROT_EXEC,
                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     
     if (code_mem == MAP_FAILED) {
         LOGE("Failed to allocate code memory");
+        ReleaseMemory(transient + kCodeAllocSize);
         delete block;
         return nullptr;
     }
@@ -398,16 +483,17 @@ CompiledBlockV8* LLVMJITEngine::Compile(
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     
+    // IR звільнено, лишається лише код
+    ReleaseMemory(transient);
+    
     // Update stats
+    std::lock_guard<std::mutex> lock(cache_mutex_);
     stats_.functions_compiled++;
     stats_.total_native_bytes += native_code_size;
     stats_.compile_time_us += duration.count();
     
     // Cache the block
-    {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
-        code_cache_[address] = block;
-    }
+    code_cache_[address] = block;
     
     LOGI("LLVM compiled 0x%llx -> %zu bytes in %lld us",
          static_cast<unsigned long long>(address),
@@ -565,6 +651,23 @@ CompiledBlockV8* NCEv8LLVMBackend::CompileWithLLVM(
     return block;
 }
 
+void NCEv8LLVMBackend::Invalidate(uint64_t address, size_t size) {
+    if (!initialized_) {
+        return;
+    }
+    
+    jit_engine_.Invalidate(address, size);
+    
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    for (auto it = metrics_.begin(); it != metrics_.end(); ) {
+        if (it->first - address < size) {
+            it = metrics_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 NCEv8LLVMBackend::Metrics NCEv8LLVMBackend::GetMetrics(uint64_t address) const {
     std::lock_guard<std::mutex> lock(metrics_mutex_);
     auto it = metrics_.find(address);
@@ -14,6 +14,7 @@
 #include <unordered_map>
 #include <functional>
 #include <mutex>
+#include <atomic>
 
 #include "nce_v8.h"
 
@@ -81,6 +82,10 @@ struct LLVMConfig {
     bool lazy_compilation = true;
     bool enable_gdb_listener = false;
     bool enable_perf_listener = false;
+    
+    // Бюджет пам'яті LLVM (context/IR під час компіляції + згенерований код).
+    // 0 = авто: ~1/48 RAM, 32-256MB (128MB на 6GB телефоні)
+    size_t memory_budget = 0;
 };
 
 // ============================================================================
@@ -210,6 +215,14 @@ public:
     // Add compiled module
     bool AddModule(void* module);
     
+    // Звільнення блоків у діапазоні (guest код змінився)
+    void Invalidate(uint64_t address, size_t size);
+    
+    // Чи вміститься компіляція блоку в бюджет пам'яті
+    bool HasMemoryBudget(size_t guest_size) const;
+    size_t GetMemoryUsed() const { return memory_used_.load(std::memory_order_relaxed); }
+    size_t GetMemoryBudget() const { return memory_budget_; }
+    
     // Get statistics
     struct Stats {
         uint64_t functions_compiled;
@@ -217,6 +230,7 @@ public:
         uint64_t total_native_bytes;
         uint64_t compile_time_us;
         double avg_speedup;
+        uint64_t budget_rejections;
     };
     Stats GetStats() const;
     
@@ -233,6 +247,14 @@ private:
     void* pass_builder_;   // PassBuilder
     
     PPCToLLVMTranslator translator_;
+    std::mutex compile_mutex_;  // LLVMContext / translator - один compile за раз
+    
+    // Пам'ять: transient (IR) резервується на час компіляції, код - до Invalidate
+    static size_t EstimateCompileFootprint(size_t guest_size);
+    bool ReserveMemory(size_t bytes);
+    void ReleaseMemory(size_t bytes);
+    std::atomic<size_t> memory_used_{0};
+    size_t memory_budget_ = 0;
     
     // Compiled code cache
     std::unordered_map<uint64_t, CompiledBlockV8*> code_cache_;
@@ -301,6 +323,13 @@ public:
     // Check if LLVM is available
     bool IsAvailable() const { return initialized_; }
     
+    // Tier-3 планувальник: не ставити задачу, якщо бюджет пам'яті вичерпано
+    bool HasMemoryBudget(size_t guest_size) const {
+        return initialized_ && jit_engine_.HasMemoryBudget(guest_size);
+    }
+    
+    void Invalidate(uint64_t address, size_t size);
+    
     // Get performance metrics
     struct Metrics {
         double compile_time_ms;
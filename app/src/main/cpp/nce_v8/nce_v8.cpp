@@ -17,6 +17,7 @@
 #include <sched.h>
 #include <cstring>
 #include <fstream>
+#include <string>
 
 #define LOG_TAG "NCE-v8"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -52,6 +53,17 @@ struct NCEv8State {
     
     // Current tier
     CompilationTier current_tier = CompilationTier::OPTIMIZING_JIT;
+    
+    // Persistent code cache config (застосовується в Initialize)
+    std::string jit_cache_dir;
+    std::string jit_cache_title;
+    std::string jit_cache_build;
+    
+    // Pool для tier-3 компіляції (застосовується в Initialize)
+    util::ThreadPool* compile_pool = nullptr;
+    
+    // Спостерігач tier-1 miss (застосовується в Initialize)
+    BlockMissCallback block_miss_callback = nullptr;
 };
 
 static NCEv8State g_state;
@@ -233,8 +245,17 @@ bool Initialize(const OptimizationFlags& flags) {
         return false;
     }
     
-    // Initialize branch predictor
+    if (!g_state.jit_cache_dir.empty()) {
+        g_state.compiler->EnablePersistentCache(g_state.jit_cache_dir, g_state.jit_cache_title,
+                                                g_state.jit_cache_build);
+    }
+    
+    g_state.compiler->SetThreadPool(g_state.compile_pool);
+    g_state.compiler->SetBlockMissCallback(g_state.block_miss_callback);
+    
+    // Initialize branch predictor (також джерело даних для tier-up)
     g_state.branch_predictor = std::make_unique<CombinedBranchPredictor>();
+    g_state.compiler->SetBranchPredictor(g_state.branch_predictor.get());
     
     // Initialize vectorizer
     g_state.vectorizer = std::make_unique<LoopVectorizer>(
@@ -426,9 +447,10 @@ void PrefetchMemory(const void* address, size_t size, bool for_write) {
 // Branch Prediction
 // ============================================================================
 
-void RecordBranch(uint64_t address, bool taken) {
+void RecordBranch(uint64_t address, bool taken, uint64_t target) {
     if (!g_state.branch_predictor) return;
-    g_state.branch_predictor->Update(address, taken, 0, false, false, false);
+    g_state.branch_predictor->Update(address, taken, target, false, false, false);
+    g_state.compiler->RecordBranch(address, taken, target);
 }
 
 void SetSpeculativeExecution(bool enable) {
@@ -442,6 +464,73 @@ void SetTierUpCallback(TierUpCallback callback) {
     }
 }
 
+bool EnablePersistentCodeCache(const char* cache_directory, const char* title_id, const char* build_id) {
+    if (!cache_directory) return false;
+    
+    g_state.jit_cache_dir = cache_directory;
+    g_state.jit_cache_title = title_id ? title_id : "";
+    g_state.jit_cache_build = build_id ? build_id : "";
+    
+    if (!g_state.initialized) return true;
+    return g_state.compiler->EnablePersistentCache(g_state.jit_cache_dir, g_state.jit_cache_title,
+                                                   g_state.jit_cache_build);
+}
+
+size_t PrecompileToPersistentCache(const char* cache_directory, const char* title_id,
+                                   const char* build_id, const PrecompileBlock* blocks,
+                                   size_t count, const std::atomic<bool>* cancel,
+                                   size_t* compiled) {
+    if (compiled) *compiled = 0;
+    if (!cache_directory || !blocks) return 0;
+    
+    PersistentCodeCache cache;
+    if (!cache.Open(cache_directory, title_id ? title_id : "", build_id ? build_id : "")) {
+        return 0;
+    }
+    
+    // Код не виконується, лише копіюється в кеш - звичайна RW пам'ять
+    constexpr size_t kScratchSize = 4 * 1024 * 1024;
+    std::unique_ptr<uint8_t[]> scratch(new uint8_t[kScratchSize]);
+    
+    OptimizingCompiler compiler(g_state.flags);
+    compiler.Initialize(scratch.get(), kScratchSize);
+    
+    size_t processed = 0;
+    size_t stored = 0;
+    for (; processed < count; processed++) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) break;
+        
+        const PrecompileBlock& block = blocks[processed];
+        if (!block.code || block.size == 0) continue;
+        if (cache.Lookup(block.address, block.code, block.size, nullptr)) continue;
+        
+        std::unique_ptr<CompiledBlockV8> result(
+            compiler.Compile(block.code, block.address, block.size));
+        if (result) {
+            cache.Store(block.address, block.code, block.size, result->tier,
+                        result->native_code, result->code_size);
+            stored++;
+        }
+        compiler.ResetCodeCache();
+    }
+    
+    compiler.Shutdown();
+    cache.Close();
+    
+    LOGI("AOT tier-2: %zu/%zu blocks processed, %zu compiled for %s",
+         processed, count, stored, title_id ? title_id : "default");
+    
+    if (compiled) *compiled = stored;
+    return processed;
+}
+
+void SetCompileThreadPool(util::ThreadPool* pool) {
+    g_state.compile_pool = pool;
+    if (g_state.initialized) {
+        g_state.compiler->SetThreadPool(pool);
+    }
+}
+
 void ForceTierUp(uint64_t address) {
     if (!g_state.initialized) return;
     
@@ -449,6 +538,19 @@ void ForceTierUp(uint64_t address) {
     g_state.compiler->ForceTierUp(address);
 }
 
+void SetBlockMissCallback(BlockMissCallback callback) {
+    g_state.block_miss_callback = callback;
+    if (g_state.compiler) {
+        g_state.compiler->SetBlockMissCallback(callback);
+    }
+}
+
+void PrioritizeTierUp(uint64_t address, float confidence) {
+    if (!g_state.initialized) return;
+    
+    g_state.compiler->PrioritizeTierUp(address, confidence);
+}
+
 bool AnalyzeLoop(uint64_t header_addr, CompiledBlockV8::LoopInfo* out_info) {
     if (!g_state.vectorizer || !out_info) return false;
     
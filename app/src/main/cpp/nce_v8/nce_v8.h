@@ -21,6 +21,10 @@
 #include <memory>
 #include <functional>
 
+namespace rpcsx::util {
+class ThreadPool;
+}
+
 namespace rpcsx::nce::v8 {
 
 // ============================================================================
@@ -51,6 +55,14 @@ struct OptimizationFlags {
     bool enable_tiered_compilation = true;
     uint32_t tier_up_threshold = 100;        // Executions before tier-up
     uint32_t osr_threshold = 1000;           // On-Stack Replacement threshold
+    bool enable_profile_guided_tier_up = true; // Weight threshold by loop/branch profile
+    uint32_t max_inflight_tier_ups = 4;      // Tier-2 compile budget (jobs in flight)
+    
+    // Tier 3 (LLVM) - фонова компіляція поверх tier-2, hot-swap у dispatch
+    bool enable_llvm_tier3 = true;
+    uint32_t tier3_threshold = 10000;        // Executions before tier-3
+    uint32_t max_inflight_tier3 = 1;         // LLVMContext не thread-safe
+    size_t llvm_memory_budget = 0;           // LLVM context + code bytes (0 = auto by RAM)
     
     // Branch optimization
     bool enable_branch_prediction = true;
@@ -101,6 +113,14 @@ struct HotspotProfile {
     bool is_polymorphic;
 };
 
+// Resolved guest branch edge (tier-up scoring, superblock layout)
+struct BranchEdgeProfile {
+    uint64_t pc;
+    uint64_t target;         // Last taken target
+    uint32_t taken_count;
+    uint32_t not_taken_count;
+};
+
 struct ProfilingStats {
     std::atomic<uint64_t> total_executions{0};
     std::atomic<uint64_t> total_compilations{0};
@@ -160,6 +180,13 @@ struct CompiledBlockV8 {
     // Deoptimization info
     bool has_deopt_points;
     std::vector<uint64_t> deopt_addresses;
+    
+    // Superblock (tier 1): guest блоки після першого, злиті в цей код
+    struct TraceSegment {
+        uint64_t address;
+        size_t size;
+    };
+    std::vector<TraceSegment> trace_segments;
 };
 
 // ============================================================================
@@ -238,9 +265,9 @@ HotspotProfile* GetHotspotProfile(uint64_t address);
 void PrefetchMemory(const void* address, size_t size, bool for_write = false);
 
 /**
- * Branch prediction hint
+ * Branch prediction hint (target - resolved taken target, 0 if unknown)
  */
-void RecordBranch(uint64_t address, bool taken);
+void RecordBranch(uint64_t address, bool taken, uint64_t target = 0);
 
 // ============================================================================
 // Advanced Features
@@ -262,6 +289,53 @@ void SetTierUpCallback(TierUpCallback callback);
  */
 void ForceTierUp(uint64_t address);
 
+/**
+ * Перший вхід у блок без скомпільованого коду (tier-1 miss); викликається
+ * з потоку виконання, тож callback має бути дешевим. nullptr - вимкнути
+ */
+using BlockMissCallback = void (*)(uint64_t address);
+void SetBlockMissCallback(BlockMissCallback callback);
+
+/**
+ * Передбачений блок: tier-up кандидат з пріоритетом над звичайними
+ * (confidence 0..1); блоки, яких ще не бачив baseline, ігноруються
+ */
+void PrioritizeTierUp(uint64_t address, float confidence);
+
+/**
+ * Persistent tier-2 code cache (per-title, per-build).
+ * Можна викликати до Initialize() - налаштування застосуються при ініціалізації.
+ */
+bool EnablePersistentCodeCache(const char* cache_directory, const char* title_id, const char* build_id);
+
+/**
+ * Guest блок для ahead-of-time компіляції (big-endian код, як у guest пам'яті)
+ */
+struct PrecompileBlock {
+    uint64_t address;
+    const uint8_t* code;
+    size_t size;
+};
+
+/**
+ * Ahead-of-time tier-2 компіляція без запущеної гри: окремий OptimizingCompiler
+ * пише блоки в persistent cache title, звідки TieredCompilationManager бере їх
+ * при boot (hash guest коду перевіряється як завжди). Блоки, що вже є в кеші,
+ * пропускаються. cancel перевіряється між блоками.
+ * Повертає кількість оброблених блоків (<= count, менше - якщо скасовано)
+ */
+size_t PrecompileToPersistentCache(const char* cache_directory, const char* title_id,
+                                   const char* build_id, const PrecompileBlock* blocks,
+                                   size_t count, const std::atomic<bool>* cancel,
+                                   size_t* compiled = nullptr);
+
+/**
+ * Work-stealing pool для фонової компіляції: LLVM tier-3 задачі йдуть у
+ * TaskLane::BackgroundCompile. Без пулу - на власному compile потоці.
+ * Можна викликати до Initialize().
+ */
+void SetCompileThreadPool(util::ThreadPool* pool);
+
 /**
  * Get loop optimization info
  */
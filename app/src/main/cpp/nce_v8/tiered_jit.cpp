@@ -5,8 +5,14 @@
  */
 
 #include "tiered_jit.h"
+#include "branch_predictor.h"
+#include "nce_jit/arm64_emitter.h"
+#include "nce_core/thread_pool.h"
+#include "fastmem_mapper.h"
 #include <android/log.h>
 #include <sys/mman.h>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 
 #define LOG_TAG "NCE-v8-JIT"
@@ -45,9 +51,29 @@ void BaselineCompiler::Shutdown() {
 }
 
 CompiledBlockV8* BaselineCompiler::Compile(const uint8_t* ppc_code, uint64_t address, size_t size) {
+    return CompileTrace({{ppc_code, address, size}});
+}
+
+// Умова bc (BO без декременту CTR, BI у cr0) як ARM64 cond для NZCV після EmitCompare
+static bool TraceBranchCondition(uint32_t bo, uint32_t bi, uint32_t& cond) {
+    static constexpr uint32_t kCrBitCond[3] = {0xB, 0xC, 0x0};  // LT, GT, EQ
+    if (bi >= 3) return false;  // SO і cr1-cr7 baseline не моделює
+    cond = kCrBitCond[bi];
+    if (!(bo & 0x08)) cond ^= 1;  // Branch if false
+    return true;
+}
+
+CompiledBlockV8* BaselineCompiler::CompileTrace(const std::vector<TraceSegment>& trace) {
     std::lock_guard<std::mutex> lock(compile_mutex_);
     
-    if (!code_cache_ || cache_used_ + 4096 > cache_size_) {
+    if (trace.empty()) return nullptr;
+    
+    size_t guest_bytes = 0;
+    for (const auto& segment : trace) guest_bytes += segment.size;
+    
+    // Найгірший випадок: 3 ARM64 інструкції на PPC + side exit stub на межу
+    const size_t worst_case = std::max<size_t>(4096, guest_bytes * 3 + trace.size() * 32 + 16);
+    if (!code_cache_ || cache_used_ + worst_case > cache_size_) {
         return nullptr;
     }
     
@@ -62,24 +88,77 @@ CompiledBlockV8* BaselineCompiler::Compile(const uint8_t* ppc_code, uint64_t add
     // MOV X29, SP
     *code++ = 0x910003FD;
     
-    // Template-based translation for each PPC instruction
-    size_t ppc_offset = 0;
-    while (ppc_offset < size) {
-        uint32_t ppc_instr = *reinterpret_cast<const uint32_t*>(ppc_code + ppc_offset);
-        // Big-endian swap
-        ppc_instr = __builtin_bswap32(ppc_instr);
+    struct SideExit {
+        uint32_t* branch;
+        uint64_t resume;
+    };
+    std::vector<SideExit> exits;
+    std::vector<CompiledBlockV8::BranchInfo> branches;
+    
+    for (size_t i = 0; i < trace.size(); ++i) {
+        const TraceSegment& segment = trace[i];
+        const bool boundary = i + 1 < trace.size() && segment.size >= 4;
+        const size_t body = boundary ? segment.size - 4 : segment.size;
         
-        emit_ptr = EmitPPCToARM64Template(ppc_instr, code);
-        code = static_cast<uint32_t*>(emit_ptr);
-        ppc_offset += 4;
+        // Template-based translation for each PPC instruction
+        size_t ppc_offset = 0;
+        while (ppc_offset < body) {
+            uint32_t ppc_instr = *reinterpret_cast<const uint32_t*>(segment.code + ppc_offset);
+            // Big-endian swap
+            ppc_instr = __builtin_bswap32(ppc_instr);
+            
+            emit_ptr = EmitPPCToARM64Template(ppc_instr, code);
+            code = static_cast<uint32_t*>(emit_ptr);
+            ppc_offset += 4;
+        }
+        
+        if (!boundary) continue;
+        
+        // Межа з наступним блоком trace'у: передбачений напрям - fall-through у коді
+        const uint64_t pc = segment.address + body;
+        const uint64_t next = trace[i + 1].address;
+        const uint32_t raw = __builtin_bswap32(*reinterpret_cast<const uint32_t*>(segment.code + body));
+        const ppc::DecodedInstr instr = ppc::Decode(raw);
+        
+        if (instr.type == ppc::InstrType::BC && !(instr.bo & 0x10)) {
+            const uint64_t target = pc + static_cast<int64_t>(instr.bd);
+            const bool predicted_taken = next == target;
+            uint32_t cond = 0;
+            TraceBranchCondition(instr.bo, instr.bi, cond);  // FormTrace пропускає лише такі bc
+            // Side exit - у протилежному до передбаченого напрямку
+            exits.push_back({code, predicted_taken ? pc + 4 : target});
+            *code++ = 0x54000000 | (predicted_taken ? cond ^ 1 : cond);  // B.cond stub (patched)
+            branches.push_back({pc, target, 0, 0, predicted_taken});
+        } else if (instr.type != ppc::InstrType::B && instr.type != ppc::InstrType::BC) {
+            // Не гілка (блок обрізано за розміром) - наступний блок і так fall-through
+            code = static_cast<uint32_t*>(EmitPPCToARM64Template(raw, code));
+        }
+        // b / bc-always на наступний блок: гілка зникає
     }
     
     // Emit ARM64 epilogue
+    uint32_t* epilogue = code;
     // LDP X29, X30, [SP], #16
     *code++ = 0xA8C17BFD;
     // RET
     *code++ = 0xD65F03C0;
     
+    // Side exit stubs: X28 = guest адреса продовження, далі спільний epilogue
+    for (const auto& exit : exits) {
+        const int64_t stub_offset = code - exit.branch;
+        *exit.branch |= (static_cast<uint32_t>(stub_offset) & 0x7FFFF) << 5;
+        
+        // MOVZ X28, #imm0; MOVK X28, #immN, LSL #16*N
+        *code++ = 0xD2800000 | ((exit.resume & 0xFFFF) << 5) | 28;
+        for (uint32_t hw = 1; hw < 4; hw++) {
+            const uint32_t part = (exit.resume >> (hw * 16)) & 0xFFFF;
+            if (part) *code++ = 0xF2800000 | (hw << 21) | (part << 5) | 28;
+        }
+        // B epilogue
+        const int64_t back = epilogue - code;
+        *code++ = 0x14000000 | (static_cast<uint32_t>(back) & 0x3FFFFFF);
+    }
+    
     size_t code_size = reinterpret_cast<uint8_t*>(code) - reinterpret_cast<uint8_t*>(code_start);
     
     // Flush instruction cache
@@ -87,20 +166,31 @@ CompiledBlockV8* BaselineCompiler::Compile(const uint8_t* ppc_code, uint64_t add
                             static_cast<char*>(code_start) + code_size);
     
     // Create compiled block
+    const TraceSegment& head = trace.front();
     auto* block = new CompiledBlockV8();
     block->native_code = code_start;
     block->code_size = code_size;
-    block->guest_address = address;
-    block->guest_size = size;
+    block->guest_address = head.address;
+    block->guest_size = head.size;
     block->tier = CompilationTier::BASELINE_JIT;
     block->execution_count = 0;
     block->last_execution_time = 0;
+    block->branches = std::move(branches);
     block->has_deopt_points = false;
+    for (size_t i = 1; i < trace.size(); ++i) {
+        block->trace_segments.push_back({trace[i].address, trace[i].size});
+    }
     
     cache_used_ += (code_size + 15) & ~15;  // 16-byte alignment
     
-    LOGI("Baseline compiled: 0x%llx (%zu PPC bytes -> %zu ARM64 bytes)",
-         static_cast<unsigned long long>(address), size, code_size);
+    if (trace.size() > 1) {
+        LOGI("Baseline compiled: 0x%llx (trace of %zu blocks, %zu PPC bytes -> %zu ARM64 bytes, %zu side exits)",
+             static_cast<unsigned long long>(head.address), trace.size(), guest_bytes, code_size,
+             exits.size());
+    } else {
+        LOGI("Baseline compiled: 0x%llx (%zu PPC bytes -> %zu ARM64 bytes)",
+             static_cast<unsigned long long>(head.address), guest_bytes, code_size);
+    }
     
     return block;
 }
@@ -351,7 +441,13 @@ bool OptimizingCompiler::Initialize(void* code_cache, size_t cache_size) {
     cache_size_ = cache_size;
     cache_used_ = 0;
     
-    memset(&reg_state_, 0xFF, sizeof(reg_state_));  // -1 = free
+    // -1 = free
+    std::fill(std::begin(reg_state_.gp_regs), std::end(reg_state_.gp_regs), -1);
+    std::fill(std::begin(reg_state_.fp_regs), std::end(reg_state_.fp_regs), -1);
+    std::fill(std::begin(reg_state_.vec_regs), std::end(reg_state_.vec_regs), -1);
+    std::fill(std::begin(reg_state_.guest_host), std::end(reg_state_.guest_host), -1);
+    reg_state_.allocated.reset();
+    reg_state_.entry_loads.reset();
     
     LOGI("Optimizing compiler initialized with %zu MB cache", cache_size / (1024*1024));
     return true;
@@ -362,7 +458,8 @@ void OptimizingCompiler::Shutdown() {
 }
 
 CompiledBlockV8* OptimizingCompiler::Compile(const uint8_t* ppc_code, uint64_t address, size_t size,
-                                              const HotspotProfile* profile) {
+                                              const HotspotProfile* profile,
+                                              const std::vector<BranchEdgeProfile>* branches) {
     std::lock_guard<std::mutex> lock(compile_mutex_);
     
     if (!code_cache_) return nullptr;
@@ -376,16 +473,22 @@ CompiledBlockV8* OptimizingCompiler::Compile(const uint8_t* ppc_code, uint64_t a
     // Convert to SSA
     ConvertToSSA(cfg);
     
+    // Superblock layout: гарячий шлях емітиться суцільно, холодні блоки - в кінці
+    if (branches && !branches->empty()) {
+        LayoutHotPath(cfg, *branches);
+    }
+    
     // Run optimization passes
     RunOptimizationPasses(cfg);
     
+    // Guest регістри у host регістрах через увесь CFG (включно з back-edges)
+    RegisterAllocation(cfg);
+    
     // Emit ARM64 code
-    void* native_code = EmitARM64(cfg);
+    size_t code_size = 0;
+    void* native_code = EmitARM64(cfg, &code_size);
     if (!native_code) return nullptr;
     
-    // Calculate code size (approximate)
-    size_t code_size = cfg.blocks.size() * 64;  // Rough estimate
-    
     // Create compiled block
     auto* block = new CompiledBlockV8();
     block->native_code = native_code;
@@ -413,24 +516,528 @@ CompiledBlockV8* OptimizingCompiler::Compile(const uint8_t* ppc_code, uint64_t a
     return block;
 }
 
+CompiledBlockV8* OptimizingCompiler::InstallPrecompiled(const void* native_code, size_t code_size,
+                                                        uint64_t address, size_t guest_size) {
+    std::lock_guard<std::mutex> lock(compile_mutex_);
+    
+    if (!code_cache_ || !native_code || cache_used_ + code_size > cache_size_) {
+        return nullptr;
+    }
+    
+    void* code_start = static_cast<uint8_t*>(code_cache_) + cache_used_;
+    memcpy(code_start, native_code, code_size);
+    
+    __builtin___clear_cache(static_cast<char*>(code_start),
+                            static_cast<char*>(code_start) + code_size);
+    
+    cache_used_ += (code_size + 15) & ~15;
+    
+    auto* block = new CompiledBlockV8();
+    block->native_code = code_start;
+    block->code_size = code_size;
+    block->guest_address = address;
+    block->guest_size = guest_size;
+    block->tier = CompilationTier::OPTIMIZING_JIT;
+    block->execution_count = 0;
+    block->last_execution_time = 0;
+    block->has_deopt_points = true;
+    
+    return block;
+}
+
+// Статичний target PPC branch (b / bc); false для bclr/bcctr та абсолютних адрес поза блоком
+static bool DecodeBranchTarget(uint32_t instr, uint64_t pc, uint64_t& target, bool& conditional) {
+    const uint32_t opcode = instr >> 26;
+    if (opcode == 18) {  // b, bl, ba
+        int64_t li = static_cast<int32_t>((instr & 0x03FFFFFC) << 6) >> 6;
+        target = (instr & 2) ? static_cast<uint64_t>(li) : pc + li;
+        conditional = false;
+        return true;
+    }
+    if (opcode == 16) {  // bc
+        int64_t bd = static_cast<int16_t>(instr & 0xFFFC);
+        target = (instr & 2) ? static_cast<uint64_t>(bd) : pc + bd;
+        const uint32_t bo = (instr >> 21) & 0x1F;
+        conditional = (bo & 0x14) != 0x14;  // BO=1z1zz -> branch always
+        return true;
+    }
+    return false;
+}
+
+static bool IsBlockTerminator(uint32_t instr) {
+    const uint32_t opcode = instr >> 26;
+    if (opcode == 16 || opcode == 18) return true;
+    if (opcode == 19) {
+        const uint32_t xo = (instr >> 1) & 0x3FF;
+        return xo == 16 || xo == 528;  // bclr, bcctr
+    }
+    return false;
+}
+
+// Guest регістри, які інструкція читає / пише. Консервативно: невідомі
+// форми читають усі поля операндів, тож liveness лише завищується.
+static void CollectRegisterUsage(uint32_t instr, GuestRegSet& reads, GuestRegSet& writes) {
+    const uint32_t opcode = instr >> 26;
+    const uint32_t rd = (instr >> 21) & 0x1F;  // rD / rS / frD / frS / BO
+    const uint32_t ra = (instr >> 16) & 0x1F;  // rA / frA / BI
+    const uint32_t rb = (instr >> 11) & 0x1F;  // rB / frB
+    const uint32_t rc = (instr >> 6) & 0x1F;   // frC
+    const bool rc_bit = instr & 1;
+    
+    auto gpr = [](uint32_t r) { return kGuestGPR0 + r; };
+    auto fpr = [](uint32_t r) { return kGuestFPR0 + r; };
+    auto read_base = [&]() { if (ra != 0) reads.set(gpr(ra)); };  // rA|0
+    auto branch_regs = [&](uint32_t bo) {
+        if (!(bo & 0x10)) reads.set(kGuestCR);
+        if (!(bo & 0x04)) { reads.set(kGuestCTR); writes.set(kGuestCTR); }
+        if (instr & 1) writes.set(kGuestLR);  // LK
+    };
+    auto spr_index = [](uint32_t instr) -> int {
+        const uint32_t spr = ((instr >> 16) & 0x1F) | (((instr >> 11) & 0x1F) << 5);
+        switch (spr) {
+            case 1: return kGuestXER;
+            case 8: return kGuestLR;
+            case 9: return kGuestCTR;
+            default: return -1;
+        }
+    };
+    
+    switch (opcode) {
+        case 7:                                 // mulli
+            reads.set(gpr(ra));
+            writes.set(gpr(rd));
+            break;
+        case 14: case 15:                       // addi, addis
+            read_base();
+            writes.set(gpr(rd));
+            break;
+        case 8: case 12: case 13:               // subfic, addic, addic.
+            reads.set(gpr(ra));
+            writes.set(gpr(rd));
+            writes.set(kGuestXER);
+            if (opcode == 13) writes.set(kGuestCR);
+            break;
+        case 10: case 11:                       // cmpli, cmpi
+            reads.set(gpr(ra));
+            writes.set(kGuestCR);
+            break;
+        case 16:                                // bc
+            branch_regs(rd);
+            break;
+        case 18:                                // b
+            if (instr & 1) writes.set(kGuestLR);
+            break;
+        case 19: {
+            const uint32_t xo = (instr >> 1) & 0x3FF;
+            if (xo == 16) {                     // bclr
+                reads.set(kGuestLR);
+                branch_regs(rd);
+            } else if (xo == 528) {             // bcctr
+                reads.set(kGuestCTR);
+                branch_regs(rd | 0x04);
+            } else if (xo != 150) {             // CR logical / mcrf (isync - нічого)
+                reads.set(kGuestCR);
+                writes.set(kGuestCR);
+            }
+            break;
+        }
+        case 20:                                // rlwimi
+            reads.set(gpr(ra));
+            [[fallthrough]];
+        case 21: case 23: case 30:              // rlwinm, rlwnm, rld*
+            reads.set(gpr(rd));
+            if (opcode == 23 || (opcode == 30 && (instr & 0x10))) reads.set(gpr(rb));
+            writes.set(gpr(ra));
+            if (rc_bit) writes.set(kGuestCR);
+            break;
+        case 24: case 25: case 26: case 27:     // ori, oris, xori, xoris
+        case 28: case 29:                       // andi., andis.
+            reads.set(gpr(rd));
+            writes.set(gpr(ra));
+            if (opcode >= 28) writes.set(kGuestCR);
+            break;
+        case 31: {
+            const uint32_t xo = (instr >> 1) & 0x3FF;
+            switch (xo) {
+                case 0: case 32:                // cmp, cmpl
+                    reads.set(gpr(ra));
+                    reads.set(gpr(rb));
+                    writes.set(kGuestCR);
+                    return;
+                case 19:                        // mfcr
+                    reads.set(kGuestCR);
+                    writes.set(gpr(rd));
+                    return;
+                case 144:                       // mtcrf
+                    reads.set(gpr(rd));
+                    writes.set(kGuestCR);
+                    return;
+                case 339: {                     // mfspr
+                    const int spr = spr_index(instr);
+                    if (spr >= 0) reads.set(spr);
+                    writes.set(gpr(rd));
+                    return;
+                }
+                case 467: {                     // mtspr
+                    const int spr = spr_index(instr);
+                    reads.set(gpr(rd));
+                    if (spr >= 0) writes.set(spr);
+                    return;
+                }
+                // Логічні / зсуви: rA = f(rS, rB)
+                case 24: case 27: case 28: case 60: case 124: case 284: case 316:
+                case 412: case 444: case 476: case 536: case 539: case 792: case 794:
+                case 26: case 58: case 824: case 826: case 827: case 922: case 954: case 986: {
+                    reads.set(gpr(rd));
+                    const bool unary = xo == 26 || xo == 58 || xo >= 824;
+                    if (!unary) reads.set(gpr(rb));
+                    writes.set(gpr(ra));
+                    if (xo == 792 || xo == 794 || xo == 824 || xo == 826 || xo == 827) {
+                        writes.set(kGuestXER);  // sraw/srad/srawi/sradi -> CA
+                    }
+                    if (rc_bit) writes.set(kGuestCR);
+                    return;
+                }
+                default:
+                    break;
+            }
+            
+            // Indexed load/store (X-form, bit 0x100 у xo = update форма для більшості)
+            const bool is_store = xo == 151 || xo == 183 || xo == 215 || xo == 247 ||
+                                  xo == 407 || xo == 439 || xo == 149 || xo == 181 ||
+                                  xo == 662 || xo == 918 || xo == 150 || xo == 214;
+            const bool is_load = xo == 23 || xo == 55 || xo == 87 || xo == 119 ||
+                                 xo == 279 || xo == 311 || xo == 343 || xo == 375 ||
+                                 xo == 21 || xo == 53 || xo == 341 || xo == 373 ||
+                                 xo == 534 || xo == 790 || xo == 20 || xo == 84;
+            const bool is_fp_load = xo == 535 || xo == 567 || xo == 599 || xo == 631;
+            const bool is_fp_store = xo == 663 || xo == 695 || xo == 727 || xo == 759 || xo == 983;
+            if (is_store || is_load || is_fp_load || is_fp_store) {
+                read_base();
+                reads.set(gpr(rb));
+                if (is_load) writes.set(gpr(rd));
+                if (is_store) reads.set(gpr(rd));
+                if (is_fp_load) writes.set(fpr(rd));
+                if (is_fp_store) reads.set(fpr(rd));
+                if (xo == 150 || xo == 214) writes.set(kGuestCR);  // stwcx., stdcx.
+                const bool update = xo == 55 || xo == 119 || xo == 311 || xo == 375 ||
+                                    xo == 53 || xo == 373 || xo == 183 || xo == 247 ||
+                                    xo == 439 || xo == 181 || xo == 567 || xo == 631 ||
+                                    xo == 695 || xo == 759;
+                if (update) writes.set(gpr(ra));
+                return;
+            }
+            
+            // Арифметика XO-form: rD = f(rA, rB); carrying / OE -> XER
+            reads.set(gpr(ra));
+            reads.set(gpr(rb));
+            writes.set(gpr(rd));
+            const uint32_t xo9 = xo & 0x1FF;
+            if (xo9 == 8 || xo9 == 10 || xo9 == 136 || xo9 == 138 || xo9 == 200 ||
+                xo9 == 202 || xo9 == 232 || xo9 == 234) {
+                reads.set(kGuestXER);   // subfc/addc/subfe/adde/...ze/...me
+                writes.set(kGuestXER);
+            }
+            if (xo & 0x200) writes.set(kGuestXER);  // OE
+            if (rc_bit) writes.set(kGuestCR);
+            break;
+        }
+        case 32: case 33: case 34: case 35:     // lwz(u), lbz(u)
+        case 40: case 41: case 42: case 43:     // lhz(u), lha(u)
+        case 46:                                // lmw
+            read_base();
+            if (opcode == 46) {
+                for (uint32_t r = rd; r < 32; r++) writes.set(gpr(r));
+            } else {
+                writes.set(gpr(rd));
+            }
+            if (opcode & 1 && opcode != 46) writes.set(gpr(ra));
+            break;
+        case 36: case 37: case 38: case 39:     // stw(u), stb(u)
+        case 44: case 45:                       // sth(u)
+        case 47:                                // stmw
+            read_base();
+            if (opcode == 47) {
+                for (uint32_t r = rd; r < 32; r++) reads.set(gpr(r));
+            } else {
+                reads.set(gpr(rd));
+            }
+            if (opcode & 1 && opcode != 47) writes.set(gpr(ra));
+            break;
+        case 48: case 49: case 50: case 51:     // lfs(u), lfd(u)
+            read_base();
+            writes.set(fpr(rd));
+            if (opcode & 1) writes.set(gpr(ra));
+            break;
+        case 52: case 53: case 54: case 55:     // stfs(u), stfd(u)
+            read_base();
+            reads.set(fpr(rd));
+            if (opcode & 1) writes.set(gpr(ra));
+            break;
+        case 58:                                // ld, ldu, lwa
+            read_base();
+            writes.set(gpr(rd));
+            if ((instr & 3) == 1) writes.set(gpr(ra));
+            break;
+        case 62:                                // std, stdu
+            read_base();
+            reads.set(gpr(rd));
+            if ((instr & 3) == 1) writes.set(gpr(ra));
+            break;
+        case 59: case 63: {                     // FP arithmetic
+            const uint32_t xo = (instr >> 1) & 0x3FF;
+            reads.set(fpr(ra));
+            reads.set(fpr(rb));
+            reads.set(fpr(rc));
+            if (opcode == 63 && (xo == 0 || xo == 32)) {  // fcmpu, fcmpo
+                writes.set(kGuestCR);
+            } else {
+                writes.set(fpr(rd));
+                if (rc_bit) writes.set(kGuestCR);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Guest load/store з базою rA: D-form 32-55 (крім lmw/stmw), DS-form ld/lwa/std.
+// update = після доступу rA += displacement
+static bool DecodeMemoryAccess(uint32_t instr, uint32_t& base, int32_t& disp,
+                               bool& update, bool& is_store) {
+    const uint32_t opcode = instr >> 26;
+    base = (instr >> 16) & 0x1F;
+    if (opcode >= 32 && opcode <= 55 && opcode != 46 && opcode != 47) {
+        disp = static_cast<int16_t>(instr & 0xFFFF);
+        update = opcode & 1;
+        is_store = (opcode >= 36 && opcode <= 39) || opcode == 44 || opcode == 45 || opcode >= 52;
+        return base != 0;
+    }
+    if (opcode == 58 || opcode == 62) {
+        const uint32_t xo = instr & 3;
+        disp = static_cast<int16_t>(instr & 0xFFFC);
+        update = xo == 1;
+        is_store = opcode == 62;
+        return base != 0 && (xo <= 1 || (opcode == 58 && xo == 2));
+    }
+    return false;
+}
+
+// Prefetch hints: не більше стількох баз на цикл, крок понад сторінку - не стрім
+static constexpr size_t kMaxLoopPrefetches = 4;
+static constexpr int64_t kMaxPrefetchStride = 4096;
+
 CFG OptimizingCompiler::BuildCFG(const uint8_t* code, uint64_t address, size_t size) {
     CFG cfg;
+    cfg.entry_block = 0;
     
-    // Create single basic block for now (simplified)
-    BasicBlock bb;
-    bb.start_address = address;
-    bb.end_address = address + size;
-    bb.loop_depth = 0;
-    bb.is_loop_header = false;
-    bb.is_hot = true;
+    const size_t count = size / 4;
+    if (!code || count == 0) {
+        BasicBlock bb{};
+        bb.start_address = address;
+        bb.end_address = address + size;
+        bb.is_hot = true;
+        bb.side_exit = true;
+        cfg.blocks.push_back(bb);
+        cfg.exit_blocks.push_back(0);
+        return cfg;
+    }
     
-    cfg.blocks.push_back(bb);
-    cfg.entry_block = 0;
-    cfg.exit_blocks.push_back(0);
+    auto fetch = [&](size_t i) {
+        return __builtin_bswap32(reinterpret_cast<const uint32_t*>(code)[i]);
+    };
+    
+    // 1. Leaders: вхід, цілі гілок усередині діапазону, інструкції після гілок
+    std::vector<bool> leader(count + 1, false);
+    leader[0] = true;
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t instr = fetch(i);
+        if (!IsBlockTerminator(instr)) continue;
+        
+        leader[i + 1] = true;
+        uint64_t target;
+        bool conditional;
+        if (DecodeBranchTarget(instr, address + i * 4, target, conditional) &&
+            target >= address && target < address + count * 4) {
+            leader[(target - address) / 4] = true;
+        }
+    }
+    
+    // 2. Блоки
+    std::vector<uint32_t> block_of(count, 0);
+    for (size_t i = 0; i < count; ) {
+        BasicBlock bb{};
+        bb.start_address = address + i * 4;
+        size_t j = i + 1;
+        while (j < count && !leader[j]) j++;
+        bb.end_address = address + j * 4;
+        bb.is_hot = true;
+        
+        // Guest register usage: upward-exposed reads + defs
+        for (size_t k = i; k < j; k++) {
+            GuestRegSet reads, writes;
+            CollectRegisterUsage(fetch(k), reads, writes);
+            bb.uses |= reads & ~bb.defs;
+            bb.defs |= writes;
+            for (uint32_t r = 0; r < kGuestRegCount; r++) {
+                bb.refs[r] += reads[r] + writes[r];
+            }
+        }
+        
+        const uint32_t index = static_cast<uint32_t>(cfg.blocks.size());
+        for (size_t k = i; k < j; k++) block_of[k] = index;
+        cfg.blocks.push_back(std::move(bb));
+        i = j;
+    }
+    
+    // 3. Ребра; successors[0] = fall-through, наступні - branch target
+    for (uint32_t b = 0; b < cfg.blocks.size(); b++) {
+        auto& bb = cfg.blocks[b];
+        const size_t last = (bb.end_address - address) / 4 - 1;
+        const uint32_t instr = fetch(last);
+        
+        uint64_t target = 0;
+        bool conditional = false;
+        const bool is_static_branch = DecodeBranchTarget(instr, bb.end_address - 4, target, conditional);
+        const bool falls_through = !IsBlockTerminator(instr) || (is_static_branch && conditional) ||
+                                   (instr >> 26 == 19 && ((instr >> 21) & 0x14) != 0x14);
+        
+        const bool target_inside = is_static_branch && target >= address && target < address + count * 4;
+        
+        if (falls_through && last + 1 < count) {
+            bb.successors.push_back(block_of[last + 1]);
+        }
+        if (target_inside) {
+            bb.successors.push_back(block_of[(target - address) / 4]);
+        }
+        // Вихід з регіону: гілка назовні / indirect, або fall-through за кінець
+        bb.side_exit = (IsBlockTerminator(instr) && !target_inside) ||
+                       (falls_through && last + 1 >= count);
+        if (bb.successors.empty()) {
+            cfg.exit_blocks.push_back(b);
+        }
+        for (uint32_t succ : bb.successors) {
+            cfg.blocks[succ].predecessors.push_back(b);
+        }
+    }
+    
+    // 4. Back edges -> прості (природні, без вкладеності) цикли
+    for (uint32_t b = 0; b < cfg.blocks.size(); b++) {
+        for (uint32_t succ : cfg.blocks[b].successors) {
+            if (succ > b) continue;
+            CFG::LoopNest loop;
+            loop.header = succ;
+            loop.back_edge_block = b;
+            loop.depth = 1;
+            for (uint32_t k = succ; k <= b; k++) {
+                loop.body.push_back(k);
+                cfg.blocks[k].loop_depth++;
+            }
+            cfg.blocks[succ].is_loop_header = true;
+            cfg.loops.push_back(std::move(loop));
+        }
+    }
+    
+    // 5. Strided guest доступи в циклах: база, яку тіло зсуває на сталий крок
+    // і більше нічим не пише. Крок - сума update-form displacement та addi.
+    if (flags_.enable_prefetching) {
+        for (auto& loop : cfg.loops) {
+            int64_t step[32] = {};
+            bool clobbered[32] = {};
+            uint8_t accessed[32] = {};  // bit0 = load, bit1 = store
+            
+            for (uint32_t b : loop.body) {
+                const auto& bb = cfg.blocks[b];
+                for (uint64_t pc = bb.start_address; pc < bb.end_address; pc += 4) {
+                    const uint32_t instr = fetch((pc - address) / 4);
+                    GuestRegSet reads, writes;
+                    CollectRegisterUsage(instr, reads, writes);
+                    
+                    uint32_t base;
+                    int32_t disp;
+                    bool update, is_store;
+                    uint32_t stepped = 0;
+                    if (DecodeMemoryAccess(instr, base, disp, update, is_store)) {
+                        accessed[base] |= is_store ? 2 : 1;
+                        if (update) {
+                            step[base] += disp;
+                            stepped = base;
+                        }
+                    } else if (instr >> 26 == 14) {  // addi rD, rA, simm
+                        const uint32_t rd = (instr >> 21) & 0x1F;
+                        const uint32_t ra = (instr >> 16) & 0x1F;
+                        if (rd == ra && ra != 0) {
+                            step[ra] += static_cast<int16_t>(instr & 0xFFFF);
+                            stepped = ra;
+                        }
+                    }
+                    for (uint32_t r = 1; r < 32; r++) {
+                        if (writes[kGuestGPR0 + r] && r != stepped) clobbered[r] = true;
+                    }
+                }
+            }
+            
+            for (uint32_t r = 1; r < 32 && loop.strided.size() < kMaxLoopPrefetches; r++) {
+                const int64_t stride = step[r];
+                if (!accessed[r] || clobbered[r] || stride == 0 ||
+                    std::abs(stride) > kMaxPrefetchStride) {
+                    continue;
+                }
+                const int64_t ahead = std::max<int64_t>(1, flags_.prefetch_distance / std::abs(stride));
+                CFG::StridedAccess access;
+                access.base_reg = r;
+                access.stride = static_cast<int32_t>(stride);
+                access.prefetch_offset = static_cast<int32_t>(stride * ahead);
+                access.is_store = accessed[r] == 2;
+                loop.strided.push_back(access);
+            }
+        }
+    }
     
     return cfg;
 }
 
+void OptimizingCompiler::LayoutHotPath(CFG& cfg, const std::vector<BranchEdgeProfile>& branches) {
+    std::unordered_map<uint64_t, const BranchEdgeProfile*> by_pc;
+    for (const auto& edge : branches) {
+        by_pc[edge.pc] = &edge;
+    }
+    
+    // Найімовірніший наступник: branch target, якщо профіль каже "taken" частіше
+    auto hot_successor = [&](uint32_t b) -> int64_t {
+        const auto& bb = cfg.blocks[b];
+        if (bb.successors.empty()) return -1;
+        if (bb.successors.size() == 1) return bb.successors[0];
+        
+        auto it = by_pc.find(bb.end_address - 4);
+        if (it != by_pc.end() && it->second->taken_count > it->second->not_taken_count) {
+            return bb.successors[1];
+        }
+        return bb.successors[0];
+    };
+    
+    std::vector<bool> placed(cfg.blocks.size(), false);
+    cfg.layout.clear();
+    cfg.layout.reserve(cfg.blocks.size());
+    
+    // Ланцюжок від входу вздовж гарячих ребер
+    int64_t current = cfg.entry_block;
+    while (current >= 0 && !placed[current]) {
+        placed[current] = true;
+        cfg.blocks[current].is_hot = true;
+        cfg.layout.push_back(static_cast<uint32_t>(current));
+        current = hot_successor(static_cast<uint32_t>(current));
+    }
+    
+    // Решта - холодні, в адресному порядку
+    for (uint32_t b = 0; b < cfg.blocks.size(); b++) {
+        if (placed[b]) continue;
+        cfg.blocks[b].is_hot = false;
+        cfg.layout.push_back(b);
+    }
+}
+
 void OptimizingCompiler::ConvertToSSA(CFG& cfg) {
     // Simplified SSA conversion
     // In full implementation, would do proper dominance analysis and phi insertion
@@ -514,8 +1121,16 @@ void OptimizingCompiler::TailDuplication(CFG& cfg) {
     // Duplicate small tail blocks to enable more optimizations
 }
 
-void* OptimizingCompiler::EmitARM64(const CFG& cfg) {
-    if (cache_used_ + 4096 > cache_size_) {
+void* OptimizingCompiler::EmitARM64(const CFG& cfg, size_t* out_size) {
+    // Prologue/epilogue/entry loads + по слову на інструкцію та spill
+    size_t budget_words = 64 + reg_state_.entry_loads.count();
+    for (const auto& block : cfg.blocks) {
+        budget_words += block.instructions.size() + block.writeback.count();
+    }
+    for (const auto& loop : cfg.loops) {
+        budget_words += loop.strided.size() * 6;  // MOVZ/MOVK x4 + ADD + PRFM
+    }
+    if (cache_used_ + std::max<size_t>(4096, budget_words * 4) > cache_size_) {
         return nullptr;
     }
     
@@ -523,9 +1138,18 @@ void* OptimizingCompiler::EmitARM64(const CFG& cfg) {
     void* emit_ptr = code_start;
     
     EmitPrologue(emit_ptr);
+    EmitGuestLoads(reg_state_.entry_loads, emit_ptr);
     
-    for (const auto& block : cfg.blocks) {
-        EmitBlock(block, emit_ptr);
+    if (!cfg.layout.empty()) {
+        for (uint32_t index : cfg.layout) {
+            EmitLoopPrefetches(cfg, index, emit_ptr);
+            EmitBlock(cfg.blocks[index], emit_ptr);
+        }
+    } else {
+        for (uint32_t index = 0; index < cfg.blocks.size(); index++) {
+            EmitLoopPrefetches(cfg, index, emit_ptr);
+            EmitBlock(cfg.blocks[index], emit_ptr);
+        }
     }
     
     EmitEpilogue(emit_ptr);
@@ -538,11 +1162,103 @@ void* OptimizingCompiler::EmitARM64(const CFG& cfg) {
     
     cache_used_ += (code_size + 15) & ~15;
     
+    if (out_size) *out_size = code_size;
     return code_start;
 }
 
 void OptimizingCompiler::RegisterAllocation(CFG& cfg) {
-    // Linear scan register allocation
+    auto& state = reg_state_;
+    std::fill(std::begin(state.gp_regs), std::end(state.gp_regs), -1);
+    std::fill(std::begin(state.fp_regs), std::end(state.fp_regs), -1);
+    std::fill(std::begin(state.guest_host), std::end(state.guest_host), -1);
+    state.allocated.reset();
+    state.entry_loads.reset();
+    
+    const size_t n = cfg.blocks.size();
+    if (n == 0) return;
+    
+    // 1. Liveness (backward). На side exit увесь guest state архітектурно живий
+    GuestRegSet all;
+    all.set();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = n; i-- > 0; ) {
+            auto& bb = cfg.blocks[i];
+            GuestRegSet out = bb.side_exit ? all : GuestRegSet{};
+            for (uint32_t succ : bb.successors) out |= cfg.blocks[succ].live_in;
+            const GuestRegSet in = bb.uses | (out & ~bb.defs);
+            if (in != bb.live_in || out != bb.live_out) {
+                bb.live_in = in;
+                bb.live_out = out;
+                changed = true;
+            }
+        }
+    }
+    
+    // 2. Dirty (forward): які регістри могли бути записані до виходу з блоку
+    std::vector<GuestRegSet> dirty_out(n);
+    changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < n; i++) {
+            const auto& bb = cfg.blocks[i];
+            GuestRegSet in;
+            for (uint32_t pred : bb.predecessors) in |= dirty_out[pred];
+            const GuestRegSet out = in | bb.defs;
+            if (out != dirty_out[i]) {
+                dirty_out[i] = out;
+                changed = true;
+            }
+        }
+    }
+    
+    // 3. Spill weight: refs * 8^loop_depth; холодні (за профілем) блоки дешевші
+    uint64_t weight[kGuestRegCount] = {};
+    for (const auto& bb : cfg.blocks) {
+        uint64_t scale = uint64_t(1) << (3 * std::min(bb.loop_depth, 4u));
+        scale = bb.is_hot ? scale * 4 : scale;
+        for (uint32_t r = 0; r < kGuestRegCount; r++) {
+            weight[r] += bb.refs[r] * scale;
+        }
+    }
+    
+    // 4. Вибір. Side exits тримають кожен guest регістр живим через увесь
+    // регіон, тож інтервали попарно перетинаються (interference graph повний)
+    // і розфарбування вироджується у top-K за spill weight на кожен клас
+    static constexpr int kGpPool[] = {19, 20, 21, 22, 23, 24, 25, 26};
+    static constexpr int kFpPool[] = {8, 9, 10, 11, 12, 13, 14, 15};
+    
+    std::vector<uint32_t> order;
+    for (uint32_t r = 0; r < kGuestRegCount; r++) {
+        if (weight[r] > 0) order.push_back(r);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t a, uint32_t b) { return weight[a] > weight[b]; });
+    
+    size_t gp_used = 0, fp_used = 0;
+    for (uint32_t r : order) {
+        const bool is_fpr = r >= kGuestFPR0 && r < kGuestFPR0 + 32;
+        if (is_fpr) {
+            if (fp_used == std::size(kFpPool)) continue;
+            const int host = kFpPool[fp_used++];
+            state.fp_regs[host] = static_cast<int>(r);
+            state.guest_host[r] = host;
+        } else {
+            if (gp_used == std::size(kGpPool)) continue;
+            const int host = kGpPool[gp_used++];
+            state.gp_regs[host] = static_cast<int>(r);
+            state.guest_host[r] = host;
+        }
+        state.allocated.set(r);
+    }
+    
+    // 5. Load на вході лише для живих; spill лише брудних і лише на side exit
+    state.entry_loads = state.allocated & cfg.blocks[cfg.entry_block].live_in;
+    for (size_t i = 0; i < n; i++) {
+        auto& bb = cfg.blocks[i];
+        bb.writeback = bb.side_exit ? (state.allocated & dirty_out[i]) : GuestRegSet{};
+    }
 }
 
 void OptimizingCompiler::InstructionScheduling(CFG& cfg) {
@@ -560,6 +1276,54 @@ void OptimizingCompiler::EmitPrologue(void*& emit_ptr) {
     *code++ = 0xA9BF63F7;  // STP X23, X24, [SP, #-16]!
     *code++ = 0xA9BF6BF9;  // STP X25, X26, [SP, #-16]!
     *code++ = 0xA9BF73FB;  // STP X27, X28, [SP, #-16]!
+    *code++ = 0x6DBF27E8;  // STP D8, D9, [SP, #-16]!
+    *code++ = 0x6DBF2FEA;  // STP D10, D11, [SP, #-16]!
+    *code++ = 0x6DBF37EC;  // STP D12, D13, [SP, #-16]!
+    *code++ = 0x6DBF3FEE;  // STP D14, D15, [SP, #-16]!
+    *code++ = 0xAA0003FB;  // MOV X27, X0 (PPU state)
+    
+    emit_ptr = code;
+}
+
+// Offset guest регістра у PPU state (arm64::PPUStateOffsets)
+static uint32_t GuestStateOffset(uint32_t reg) {
+    using Offsets = arm64::PPUStateOffsets;
+    if (reg < kGuestFPR0) return Offsets::GPR + (reg - kGuestGPR0) * 8;
+    if (reg < kGuestCR) return Offsets::FPR + (reg - kGuestFPR0) * 8;
+    switch (reg) {
+        case kGuestCR:  return Offsets::CR;
+        case kGuestXER: return Offsets::XER;
+        case kGuestLR:  return Offsets::LR;
+        default:        return Offsets::CTR;
+    }
+}
+
+void OptimizingCompiler::EmitGuestLoads(const GuestRegSet& regs, void*& emit_ptr) {
+    uint32_t* code = static_cast<uint32_t*>(emit_ptr);
+    
+    for (uint32_t r = 0; r < kGuestRegCount; r++) {
+        if (!regs[r]) continue;
+        const uint32_t host = static_cast<uint32_t>(reg_state_.guest_host[r]);
+        const uint32_t imm12 = GuestStateOffset(r) / 8;
+        const bool is_fpr = r >= kGuestFPR0 && r < kGuestCR;
+        // LDR Xt / Dt, [X27, #offset]
+        *code++ = (is_fpr ? 0xFD400000 : 0xF9400000) | (imm12 << 10) | (27 << 5) | host;
+    }
+    
+    emit_ptr = code;
+}
+
+void OptimizingCompiler::EmitGuestStores(const GuestRegSet& regs, void*& emit_ptr) {
+    uint32_t* code = static_cast<uint32_t*>(emit_ptr);
+    
+    for (uint32_t r = 0; r < kGuestRegCount; r++) {
+        if (!regs[r]) continue;
+        const uint32_t host = static_cast<uint32_t>(reg_state_.guest_host[r]);
+        const uint32_t imm12 = GuestStateOffset(r) / 8;
+        const bool is_fpr = r >= kGuestFPR0 && r < kGuestCR;
+        // STR Xt / Dt, [X27, #offset]
+        *code++ = (is_fpr ? 0xFD000000 : 0xF9000000) | (imm12 << 10) | (27 << 5) | host;
+    }
     
     emit_ptr = code;
 }
@@ -568,6 +1332,10 @@ void OptimizingCompiler::EmitEpilogue(void*& emit_ptr) {
     uint32_t* code = static_cast<uint32_t*>(emit_ptr);
     
     // Restore callee-saved registers
+    *code++ = 0x6CC13FEE;  // LDP D14, D15, [SP], #16
+    *code++ = 0x6CC137EC;  // LDP D12, D13, [SP], #16
+    *code++ = 0x6CC12FEA;  // LDP D10, D11, [SP], #16
+    *code++ = 0x6CC127E8;  // LDP D8, D9, [SP], #16
     *code++ = 0xA8C173FB;  // LDP X27, X28, [SP], #16
     *code++ = 0xA8C16BF9;  // LDP X25, X26, [SP], #16
     *code++ = 0xA8C163F7;  // LDP X23, X24, [SP], #16
@@ -583,6 +1351,45 @@ void OptimizingCompiler::EmitBlock(const BasicBlock& block, void*& emit_ptr) {
     for (const auto& instr : block.instructions) {
         EmitInstruction(instr, emit_ptr);
     }
+    
+    // Lazy spill: у PPU state повертаються лише брудні allocated регістри
+    if (block.side_exit) {
+        EmitGuestStores(block.writeback, emit_ptr);
+    }
+}
+
+// Software prefetch на вході в loop header: host = fastmem base + (u32)rA +
+// prefetch_offset. PRFM не фолтить, тож адреса поза мапою лише марна.
+void OptimizingCompiler::EmitLoopPrefetches(const CFG& cfg, uint32_t block_index, void*& emit_ptr) {
+    if (!cfg.blocks[block_index].is_loop_header) return;
+    
+    void* fastmem_base = rpcsx::memory::GetFastmemBase();
+    if (!fastmem_base) return;
+    
+    uint32_t* code = static_cast<uint32_t*>(emit_ptr);
+    
+    for (const auto& loop : cfg.loops) {
+        if (loop.header != block_index) continue;
+        
+        for (const auto& access : loop.strided) {
+            const int host = reg_state_.guest_host[kGuestGPR0 + access.base_reg];
+            if (host < 0) continue;  // База в PPU state - load зайвий
+            
+            const uint64_t target = reinterpret_cast<uint64_t>(fastmem_base) +
+                                    static_cast<int64_t>(access.prefetch_offset);
+            // MOVZ X28, #imm0; MOVK X28, #immN, LSL #16*N
+            *code++ = 0xD2800000 | ((target & 0xFFFF) << 5) | 28;
+            for (uint32_t hw = 1; hw < 4; hw++) {
+                *code++ = 0xF2800000 | (hw << 21) | (((target >> (hw * 16)) & 0xFFFF) << 5) | 28;
+            }
+            // ADD X28, X28, W<host>, UXTW
+            *code++ = 0x8B204000 | (static_cast<uint32_t>(host) << 16) | (28 << 5) | 28;
+            // PRFM PLDL1STRM / PSTL1STRM, [X28]
+            *code++ = 0xF9800000 | (28 << 5) | (access.is_store ? 0x11 : 0x01);
+        }
+    }
+    
+    emit_ptr = code;
 }
 
 void OptimizingCompiler::EmitInstruction(const SSAInstr& instr, void*& emit_ptr) {
@@ -612,12 +1419,18 @@ void OptimizingCompiler::EmitInstruction(const SSAInstr& instr, void*& emit_ptr)
 // Background Compiler Implementation
 // ============================================================================
 
-BackgroundCompiler::BackgroundCompiler(BaselineCompiler* baseline, OptimizingCompiler* optimizing)
+BackgroundCompiler::BackgroundCompiler(BaselineCompiler* baseline, OptimizingCompiler* optimizing,
+                                       NCEv8LLVMBackend* llvm)
     : baseline_(baseline)
-    , optimizing_(optimizing) {}
+    , optimizing_(optimizing)
+    , llvm_(llvm) {}
 
 BackgroundCompiler::~BackgroundCompiler() {
     Stop();
+    for (auto& [address, block] : completed_) {
+        delete block;
+    }
+    completed_.clear();
 }
 
 void BackgroundCompiler::Start() {
@@ -632,13 +1445,27 @@ void BackgroundCompiler::Stop() {
     if (compile_thread_.joinable()) {
         compile_thread_.join();
     }
+    
+    // LLVM задачі в пулі посилаються на this
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    pool_cv_.wait(lock, [this] { return pool_jobs_ == 0; });
     LOGI("Background compiler stopped");
 }
 
 void BackgroundCompiler::QueueForOptimization(const uint8_t* code, uint64_t address, size_t size,
-                                               const HotspotProfile& profile) {
+                                               const HotspotProfile& profile,
+                                               std::vector<BranchEdgeProfile> branches) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    job_queue_.push({code, address, size, profile, std::move(branches)});
+    pending_++;
+    queue_cv_.notify_one();
+}
+
+void BackgroundCompiler::QueueForLLVM(const uint8_t* code, uint64_t address, size_t size,
+                                      const HotspotProfile& profile) {
     std::lock_guard<std::mutex> lock(queue_mutex_);
-    job_queue_.push({code, address, size, profile});
+    job_queue_.push({code, address, size, profile, {}, CompilationTier::TIER_3_LLVM});
+    pending_llvm_++;
     queue_cv_.notify_one();
 }
 
@@ -646,7 +1473,10 @@ CompiledBlockV8* BackgroundCompiler::GetCompiledBlock(uint64_t address) {
     std::lock_guard<std::mutex> lock(queue_mutex_);
     auto it = completed_.find(address);
     if (it != completed_.end()) {
-        return it->second;
+        // Ownership переходить до caller (block cache)
+        CompiledBlockV8* block = it->second;
+        completed_.erase(it);
+        return block;
     }
     return nullptr;
 }
@@ -662,20 +1492,60 @@ void BackgroundCompiler::CompilerThread() {
             if (!running_) break;
             if (job_queue_.empty()) continue;
             
-            job = job_queue_.front();
+            job = std::move(job_queue_.front());
             job_queue_.pop();
         }
         
-        // Compile with optimizations
-        CompiledBlockV8* block = optimizing_->Compile(job.code, job.address, job.size, &job.profile);
+        // LLVM компілює на порядок довше за tier-2 - віддаємо його низькопріоритетному
+        // lane пулу, щоб черга tier-2 не стояла за ним
+        util::ThreadPool* pool = pool_.load(std::memory_order_acquire);
+        if (job.tier == CompilationTier::TIER_3_LLVM && pool) {
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                pool_jobs_++;
+            }
+            auto shared_job = std::make_shared<CompileJob>(std::move(job));
+            pool->enqueue(util::TaskLane::BackgroundCompile, [this, shared_job] {
+                if (running_) {
+                    RunJob(*shared_job);
+                } else {
+                    pending_llvm_--;
+                }
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                if (--pool_jobs_ == 0) pool_cv_.notify_all();
+            });
+            continue;
+        }
         
-        if (block) {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            completed_[job.address] = block;
-            LOGI("Background compilation complete: 0x%llx",
-                 static_cast<unsigned long long>(job.address));
+        RunJob(job);
+    }
+}
+
+void BackgroundCompiler::RunJob(CompileJob& job) {
+    CompiledBlockV8* block = nullptr;
+    if (job.tier == CompilationTier::TIER_3_LLVM) {
+        if (llvm_) {
+            block = llvm_->CompileWithLLVM(job.code, job.address, job.size, &job.profile);
         }
+        pending_llvm_--;
+    } else {
+        // Compile with optimizations
+        block = optimizing_->Compile(job.code, job.address, job.size, &job.profile,
+                                     &job.branches);
+        pending_--;
     }
+    
+    if (!block) return;
+    
+    if (install_) {
+        install_(job, block);
+    } else if (job.tier != CompilationTier::TIER_3_LLVM) {
+        // Tier-3 блоками володіє LLVMJITEngine - без install callback їх нікуди віддати
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        completed_[job.address] = block;
+    }
+    LOGI("Background compilation complete: 0x%llx (tier %d)",
+         static_cast<unsigned long long>(job.address), static_cast<int>(job.tier));
 }
 
 // ============================================================================
@@ -712,8 +1582,25 @@ bool TieredCompilationManager::Initialize() {
     optimizing_ = std::make_unique<OptimizingCompiler>(flags_);
     optimizing_->Initialize(static_cast<uint8_t*>(code_cache_) + baseline_size, optimizing_size);
     
+    dispatch_ = std::make_unique<DispatchSlot[]>(kDispatchSlots);
+    
+    if (flags_.enable_tiered_compilation && flags_.enable_llvm_tier3) {
+        LLVMConfig llvm_config;
+        llvm_config.memory_budget = flags_.llvm_memory_budget;
+        llvm_config.compile_threads = flags_.max_inflight_tier3;
+        if (NCEv8LLVMBackend::Instance().Initialize(llvm_config)) {
+            llvm_ = &NCEv8LLVMBackend::Instance();
+        } else {
+            LOGW("LLVM tier-3 unavailable");
+        }
+    }
+    
     if (flags_.enable_tiered_compilation) {
-        background_ = std::make_unique<BackgroundCompiler>(baseline_.get(), optimizing_.get());
+        background_ = std::make_unique<BackgroundCompiler>(baseline_.get(), optimizing_.get(), llvm_);
+        background_->SetInstallCallback(
+            [this](const BackgroundCompiler::CompileJob& job, CompiledBlockV8* block) {
+                InstallCompiled(job, block);
+            });
         background_->Start();
     }
     
@@ -730,6 +1617,25 @@ void TieredCompilationManager::Shutdown() {
         background_.reset();
     }
     
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        for (size_t i = 0; dispatch_ && i < kDispatchSlots; ++i) {
+            dispatch_[i].block.store(nullptr, std::memory_order_release);
+        }
+        llvm_blocks_.clear();
+        retired_blocks_.clear();
+    }
+    if (llvm_) {
+        llvm_->Shutdown();
+        llvm_ = nullptr;
+    }
+    
+    if (persistent_cache_) {
+        SaveProfiles();
+        persistent_cache_->Close();
+        persistent_cache_.reset();
+    }
+    
     optimizing_.reset();
     baseline_.reset();
     
@@ -740,41 +1646,168 @@ void TieredCompilationManager::Shutdown() {
 }
 
 CompiledBlockV8* TieredCompilationManager::GetOrCompile(const uint8_t* code, uint64_t address, size_t size) {
-    // Check cache first
+    // Fast path: lock-free dispatch (tier-up встановлюється сюди з compile потоків)
+    if (CompiledBlockV8* block = LookupDispatch(address)) {
+        stats_.cache_hits++;
+        return block;
+    }
+    
+    // Check cache (слот dispatch міг бути витіснений колізією)
     {
         std::lock_guard<std::mutex> lock(cache_mutex_);
-        auto it = block_cache_.find(address);
-        if (it != block_cache_.end()) {
+        CompiledBlockV8* cached = nullptr;
+        auto llvm = llvm_blocks_.find(address);
+        if (llvm != llvm_blocks_.end()) {
+            cached = llvm->second;
+        } else {
+            auto it = block_cache_.find(address);
+            if (it != block_cache_.end()) cached = it->second.get();
+        }
+        if (cached) {
             stats_.cache_hits++;
-            return it->second.get();
+            Publish(address, cached);
+            return cached;
         }
     }
     
     stats_.cache_misses++;
     
-    // Check if background compilation is ready
-    if (background_) {
-        CompiledBlockV8* optimized = background_->GetCompiledBlock(address);
-        if (optimized) {
-            std::lock_guard<std::mutex> lock(cache_mutex_);
-            // Replace baseline with optimized version
-            block_cache_[address].reset(optimized);
-            stats_.tier_ups++;
-            return optimized;
+    if (auto on_miss = block_miss_callback_.load(std::memory_order_acquire)) {
+        on_miss(address);
+    }
+    
+    // Tier-2 код з попереднього запуску (hash guest коду перевіряється в Lookup)
+    if (persistent_cache_) {
+        PersistentCodeCache::Entry entry;
+        if (persistent_cache_->Lookup(address, code, size, &entry)) {
+            CompiledBlockV8* restored = optimizing_->InstallPrecompiled(
+                entry.native_code.data(), entry.native_code.size(), address, size);
+            if (restored) {
+                {
+                    std::lock_guard<std::mutex> lock(profile_mutex_);
+                    guest_blocks_[address] = {code, size};
+                    auto& profile = profiles_[address];
+                    profile.address = address;
+                    profile.current_tier = CompilationTier::OPTIMIZING_JIT;
+                }
+                std::lock_guard<std::mutex> lock(cache_mutex_);
+                block_cache_[address].reset(restored);
+                IndexCodePages(address, *restored);
+                Publish(address, restored);
+                return restored;
+            }
         }
     }
     
-    // Compile with baseline
-    CompiledBlockV8* block = baseline_->Compile(code, address, size);
+    // Compile with baseline: superblock уздовж передбачених гілок через уже відомі блоки
+    std::vector<TraceSegment> trace;
+    {
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        trace = FormTrace(code, address, size);
+    }
+    CompiledBlockV8* block = baseline_->CompileTrace(trace);
     
     if (block) {
+        {
+            std::lock_guard<std::mutex> lock(profile_mutex_);
+            guest_blocks_[address] = {code, size};
+        }
+
         std::lock_guard<std::mutex> lock(cache_mutex_);
         block_cache_[address] = std::unique_ptr<CompiledBlockV8>(block);
+        IndexCodePages(address, *block);
+        Publish(address, block);
     }
     
     return block;
 }
 
+void TieredCompilationManager::InstallCompiled(const BackgroundCompiler::CompileJob& job,
+                                               CompiledBlockV8* block) {
+    const bool llvm_owned = block->tier == CompilationTier::TIER_3_LLVM;
+    {
+        // Guest код інвалідовано, поки блок компілювався - не встановлюємо
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        auto guest = guest_blocks_.find(job.address);
+        if (guest == guest_blocks_.end() || guest->second.code != job.code) {
+            if (!llvm_owned) delete block;
+            return;
+        }
+    }
+    
+    if (persistent_cache_ && !llvm_owned) {
+        persistent_cache_->Store(job.address, job.code, job.size, block->tier,
+                                 block->native_code, block->code_size);
+    }
+    
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    IndexCodePages(job.address, *block);
+    if (llvm_owned) {
+        // Tier-2 блок лишається в block_cache_ як fallback, dispatch - на LLVM код
+        llvm_blocks_[job.address] = block;
+    } else {
+        auto& slot = block_cache_[job.address];
+        if (slot) RetireBlock(std::move(slot));
+        slot.reset(block);
+        // Tier-3 вже встановлено (LLVM випередив tier-2) - dispatch не чіпаємо
+        if (llvm_blocks_.count(job.address)) return;
+    }
+    Publish(job.address, block);
+    stats_.tier_ups++;
+}
+
+CompiledBlockV8* TieredCompilationManager::LookupDispatch(uint64_t address) const {
+    if (!dispatch_) return nullptr;
+    const DispatchSlot& slot = dispatch_[(address >> 2) & (kDispatchSlots - 1)];
+    if (slot.address.load(std::memory_order_acquire) != address) return nullptr;
+    CompiledBlockV8* block = slot.block.load(std::memory_order_acquire);
+    // Слот міг бути перезаписаний між двома load'ами - блок сам знає свою адресу
+    return block && block->guest_address == address ? block : nullptr;
+}
+
+void TieredCompilationManager::Publish(uint64_t address, CompiledBlockV8* block) {
+    if (!dispatch_) return;
+    DispatchSlot& slot = dispatch_[(address >> 2) & (kDispatchSlots - 1)];
+    slot.block.store(nullptr, std::memory_order_release);
+    slot.address.store(address, std::memory_order_release);
+    slot.block.store(block, std::memory_order_release);
+}
+
+void TieredCompilationManager::Unpublish(uint64_t address) {
+    if (!dispatch_) return;
+    DispatchSlot& slot = dispatch_[(address >> 2) & (kDispatchSlots - 1)];
+    if (slot.address.load(std::memory_order_relaxed) == address) {
+        slot.block.store(nullptr, std::memory_order_release);
+    }
+}
+
+void TieredCompilationManager::RetireBlock(std::unique_ptr<CompiledBlockV8> block) {
+    // Інший потік міг щойно взяти блок з dispatch - звільняємо лише в InvalidateAll
+    retired_blocks_.push_back(std::move(block));
+}
+
+void TieredCompilationManager::IndexCodePages(uint64_t address, const CompiledBlockV8& block) {
+    auto add = [&](uint64_t start, uint64_t size) {
+        const uint64_t last = (start + std::max<uint64_t>(size, 1) - 1) >> kCodePageShift;
+        for (uint64_t page = start >> kCodePageShift; page <= last; ++page) {
+            auto& blocks = code_pages_[page];
+            if (std::find(blocks.begin(), blocks.end(), address) == blocks.end()) {
+                blocks.push_back(address);
+            }
+        }
+    };
+    add(address, block.guest_size);
+    for (const auto& segment : block.trace_segments) {
+        add(segment.address, segment.size);
+    }
+}
+
+void TieredCompilationManager::SetThreadPool(util::ThreadPool* pool) {
+    if (background_) {
+        background_->SetThreadPool(pool);
+    }
+}
+
 void TieredCompilationManager::RecordExecution(uint64_t address) {
     std::lock_guard<std::mutex> lock(profile_mutex_);
     
@@ -782,11 +1815,217 @@ void TieredCompilationManager::RecordExecution(uint64_t address) {
     profile.address = address;
     profile.execution_count++;
     
-    // Check for tier-up
-    if (flags_.enable_tiered_compilation && 
-        profile.execution_count >= flags_.tier_up_threshold &&
-        profile.current_tier < CompilationTier::OPTIMIZING_JIT) {
+    if (!flags_.enable_tiered_compilation ||
+        profile.current_tier >= CompilationTier::TIER_3_LLVM) {
+        return;
+    }
+    
+    if (profile.current_tier == CompilationTier::OPTIMIZING_JIT) {
+        if (llvm_ && profile.execution_count >= flags_.tier3_threshold) {
+            CheckTier3(address, profile);
+        }
+        return;
+    }
+    
+    if (!flags_.enable_profile_guided_tier_up) {
+        // Fixed call-count threshold
+        if (profile.execution_count >= flags_.tier_up_threshold) {
+            CheckTierUp(address);
+        }
+        return;
+    }
+    
+    // Перерахунок score лише на контрольних точках (range scan по branch профілях)
+    const uint64_t step = std::max<uint64_t>(1, flags_.tier_up_threshold / 8);
+    if (profile.execution_count % step == 0) {
+        auto it = guest_blocks_.find(address);
+        const size_t guest_size = it != guest_blocks_.end() ? it->second.size : 0;
+        const double score = ComputeTierUpScore(profile, guest_size);
+        if (score >= flags_.tier_up_threshold) {
+            tier_up_candidates_[address] = score;
+        }
+    }
+    
+    if (!tier_up_candidates_.empty()) {
+        DrainTierUpCandidates();
+    }
+}
+
+void TieredCompilationManager::RecordBranch(uint64_t pc, bool taken, uint64_t target) {
+    std::lock_guard<std::mutex> lock(profile_mutex_);
+    
+    auto& edge = branch_profiles_[pc];
+    edge.pc = pc;
+    if (taken) {
+        if (edge.taken_count != UINT32_MAX) edge.taken_count++;
+        if (target) edge.target = target;
+    } else {
+        if (edge.not_taken_count != UINT32_MAX) edge.not_taken_count++;
+    }
+}
+
+double TieredCompilationManager::ComputeTierUpScore(HotspotProfile& profile, size_t guest_size) {
+    double score = static_cast<double>(profile.execution_count);
+    if (guest_size == 0) return score;
+    
+    const uint64_t begin = profile.address;
+    const uint64_t end = profile.address + guest_size;
+    
+    double loop_weight = 1.0;
+    double bias_sum = 0.0;
+    uint32_t biased_branches = 0;
+    uint64_t taken = 0;
+    uint64_t not_taken = 0;
+    
+    auto weigh_loop = [&](double iterations) {
+        // log-шкала: цикл на 64 ітерації ~7x, а не 64x - інакше один цикл забирає весь бюджет
+        loop_weight = std::max(loop_weight, 1.0 + std::log2(1.0 + iterations));
+    };
+    
+    for (auto it = branch_profiles_.lower_bound(begin); it != branch_profiles_.end() && it->first < end; ++it) {
+        const auto& edge = it->second;
+        const uint64_t total = uint64_t(edge.taken_count) + edge.not_taken_count;
+        if (total == 0) continue;
+        
+        taken += edge.taken_count;
+        not_taken += edge.not_taken_count;
+        bias_sum += static_cast<double>(std::max(edge.taken_count, edge.not_taken_count)) / total;
+        biased_branches++;
+        
+        // Back edge усередині блоку
+        if (edge.target && edge.target <= edge.pc && edge.target >= begin) {
+            weigh_loop(static_cast<double>(edge.taken_count) / (edge.not_taken_count + 1));
+            if (edge.target == begin) profile.is_loop_header = true;
+        }
+        
+        if (predictor_) {
+            const auto summary = predictor_->Summarize(edge.pc);
+            if (summary.is_loop) weigh_loop(summary.trip_count);
+        }
+    }
+    
+    // Блок без записаних ребер: питаємо LoopPredictor про останню інструкцію
+    if (biased_branches == 0 && predictor_) {
+        const auto summary = predictor_->Summarize(end - 4);
+        if (summary.is_loop) {
+            weigh_loop(summary.trip_count);
+            profile.is_loop_header = true;
+        }
+    }
+    
+    profile.branch_taken_count = static_cast<uint32_t>(std::min<uint64_t>(taken, UINT32_MAX));
+    profile.branch_not_taken_count = static_cast<uint32_t>(std::min<uint64_t>(not_taken, UINT32_MAX));
+    
+    // Передбачувані гілки -> довші superblocks -> більший виграш від tier-2
+    const double predictability = biased_branches ? bias_sum / biased_branches : 0.75;
+    return score * loop_weight * (0.5 + predictability);
+}
+
+// Trace продовжується лише через прямі b / bc без link і декременту CTR,
+// bc - за сильним bias (edge profile або bimodal predictor)
+bool TieredCompilationManager::PredictTraceSuccessor(uint64_t pc, uint32_t branch, uint64_t& next) const {
+    static constexpr uint32_t kMinSamples = 16;
+    static constexpr double kMinBias = 0.9;
+    
+    const ppc::DecodedInstr instr = ppc::Decode(branch);
+    
+    if (instr.type == ppc::InstrType::B) {
+        if (instr.aa || instr.lk) return false;
+        next = pc + static_cast<int64_t>(instr.li);
+        return true;
+    }
+    
+    if (instr.type != ppc::InstrType::BC) {
+        // Блок обрізано не на гілці - наступний блок і є fall-through
+        if (ppc::IsBlockTerminator(instr.type)) return false;
+        next = pc + 4;
+        return true;
+    }
+    
+    if (instr.aa || instr.lk || !(instr.bo & 0x04)) return false;
+    
+    const uint64_t target = pc + static_cast<int64_t>(instr.bd);
+    if (instr.bo & 0x10) {
+        next = target;
+        return true;
+    }
+    
+    uint32_t cond = 0;
+    if (!TraceBranchCondition(instr.bo, instr.bi, cond)) return false;
+    
+    auto edge = branch_profiles_.find(pc);
+    if (edge != branch_profiles_.end()) {
+        const uint64_t total = uint64_t(edge->second.taken_count) + edge->second.not_taken_count;
+        if (total >= kMinSamples) {
+            const uint32_t major = std::max(edge->second.taken_count, edge->second.not_taken_count);
+            if (static_cast<double>(major) / total < kMinBias) return false;
+            next = edge->second.taken_count >= edge->second.not_taken_count ? target : pc + 4;
+            return true;
+        }
+    }
+    
+    if (predictor_) {
+        const auto summary = predictor_->Summarize(pc);
+        if (summary.bias_confidence >= 3 && !summary.is_loop) {
+            next = summary.biased_taken ? target : pc + 4;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// Викликається під profile_mutex_
+std::vector<TraceSegment> TieredCompilationManager::FormTrace(const uint8_t* code, uint64_t address,
+                                                              size_t size) const {
+    std::vector<TraceSegment> trace{{code, address, size}};
+    
+    while (trace.size() < BaselineCompiler::kMaxTraceBlocks) {
+        const TraceSegment& tail = trace.back();
+        if (tail.size < 4) break;
+        
+        const uint64_t pc = tail.address + tail.size - 4;
+        const uint32_t branch = __builtin_bswap32(*reinterpret_cast<const uint32_t*>(tail.code + tail.size - 4));
         
+        uint64_t next = 0;
+        if (!PredictTraceSuccessor(pc, branch, next)) break;
+        
+        // Лише блоки, guest код яких уже бачив baseline; цикл замикає trace
+        auto guest = guest_blocks_.find(next);
+        if (guest == guest_blocks_.end()) break;
+        if (std::any_of(trace.begin(), trace.end(),
+                        [next](const TraceSegment& s) { return s.address == next; })) {
+            break;
+        }
+        
+        trace.push_back({guest->second.code, next, guest->second.size});
+    }
+    
+    return trace;
+}
+
+std::vector<BranchEdgeProfile> TieredCompilationManager::CollectBranches(uint64_t address,
+                                                                         size_t guest_size) const {
+    std::vector<BranchEdgeProfile> result;
+    for (auto it = branch_profiles_.lower_bound(address);
+         it != branch_profiles_.end() && it->first < address + guest_size; ++it) {
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+void TieredCompilationManager::DrainTierUpCandidates() {
+    if (!background_) return;
+    
+    // Бюджет: не більше max_inflight_tier_ups задач у черзі; найгарячіші - першими
+    while (!tier_up_candidates_.empty() &&
+           background_->GetPendingCount() < flags_.max_inflight_tier_ups) {
+        auto best = tier_up_candidates_.begin();
+        for (auto it = tier_up_candidates_.begin(); it != tier_up_candidates_.end(); ++it) {
+            if (it->second > best->second) best = it;
+        }
+        const uint64_t address = best->first;
+        tier_up_candidates_.erase(best);
         CheckTierUp(address);
     }
 }
@@ -798,6 +2037,11 @@ void TieredCompilationManager::CheckTierUp(uint64_t address) {
         return;
     }
     
+    auto guest = guest_blocks_.find(address);
+    if (guest == guest_blocks_.end()) {
+        return;
+    }
+    
     // Queue for background optimization
     if (background_) {
         std::lock_guard<std::mutex> lock(cache_mutex_);
@@ -805,10 +2049,11 @@ void TieredCompilationManager::CheckTierUp(uint64_t address) {
         if (it != block_cache_.end()) {
             auto* block = it->second.get();
             background_->QueueForOptimization(
-                static_cast<const uint8_t*>(block->native_code),
+                guest->second.code,
                 address,
                 block->guest_size,
-                profile);
+                profile,
+                CollectBranches(address, block->guest_size));
             
             profile.current_tier = CompilationTier::OPTIMIZING_JIT;
             
@@ -823,30 +2068,242 @@ void TieredCompilationManager::CheckTierUp(uint64_t address) {
     }
 }
 
+void TieredCompilationManager::CheckTier3(uint64_t address, HotspotProfile& profile) {
+    if (!background_ || background_->GetPendingLLVMCount() >= flags_.max_inflight_tier3) {
+        return;
+    }
+    
+    auto guest = guest_blocks_.find(address);
+    if (guest == guest_blocks_.end()) {
+        return;
+    }
+    
+    // Бюджет вичерпано - лишаємося на tier-2, спробуємо на наступному виконанні
+    if (!llvm_->HasMemoryBudget(guest->second.size)) {
+        return;
+    }
+    
+    background_->QueueForLLVM(guest->second.code, address, guest->second.size, profile);
+    profile.current_tier = CompilationTier::TIER_3_LLVM;
+    
+    if (tier_up_callback_) {
+        tier_up_callback_(address, CompilationTier::OPTIMIZING_JIT, CompilationTier::TIER_3_LLVM);
+    }
+    
+    LOGI("Tier-3 queued: 0x%llx (exec count: %llu)",
+         static_cast<unsigned long long>(address),
+         static_cast<unsigned long long>(profile.execution_count));
+}
+
 void TieredCompilationManager::ForceTierUp(uint64_t address) {
     std::lock_guard<std::mutex> lock(profile_mutex_);
     profiles_[address].execution_count = flags_.tier_up_threshold;
     CheckTierUp(address);
 }
 
+void TieredCompilationManager::PrioritizeTierUp(uint64_t address, double confidence) {
+    if (!flags_.enable_tiered_compilation) return;
+    
+    std::lock_guard<std::mutex> lock(profile_mutex_);
+    
+    auto profile = profiles_.find(address);
+    if (profile == profiles_.end() ||
+        profile->second.current_tier >= CompilationTier::OPTIMIZING_JIT ||
+        guest_blocks_.find(address) == guest_blocks_.end()) {
+        return;
+    }
+    
+    // Вище будь-якого кандидата, що лише дотягнув до порогу, але не вище справжніх hotspots
+    const double score = flags_.tier_up_threshold * (1.0 + std::clamp(confidence, 0.0, 1.0));
+    auto& candidate = tier_up_candidates_[address];
+    candidate = std::max(candidate, score);
+    
+    DrainTierUpCandidates();
+}
+
 void TieredCompilationManager::Invalidate(uint64_t address, size_t size) {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (size == 0) return;
+    const uint64_t end = size > UINT64_MAX - address ? UINT64_MAX : address + size;
     
-    for (auto it = block_cache_.begin(); it != block_cache_.end(); ) {
-        if (it->first >= address && it->first < address + size) {
-            it = block_cache_.erase(it);
+    if (persistent_cache_) {
+        persistent_cache_->Invalidate(address, size);
+    }
+    
+    // Блок може починатися до діапазону і заходити в нього
+    auto overlaps = [&](uint64_t start, uint64_t length) {
+        return start < end && address < start + std::max<uint64_t>(length, 1);
+    };
+    
+    // Кандидати - блоки на змінених сторінках; якщо сторінок більше, ніж
+    // проіндексовано, дешевше пройти всі блоки
+    const uint64_t first_page = address >> kCodePageShift;
+    const uint64_t last_page = (end - 1) >> kCodePageShift;
+    std::vector<uint64_t> candidates;
+    bool full_scan;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        full_scan = last_page - first_page >= code_pages_.size();
+        for (uint64_t page = first_page; !full_scan && page <= last_page; ++page) {
+            auto it = code_pages_.find(page);
+            if (it != code_pages_.end()) {
+                candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    
+    {
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        auto drop = [&](std::unordered_map<uint64_t, GuestBlock>::iterator it) {
+            tier_up_candidates_.erase(it->first);
+            return guest_blocks_.erase(it);
+        };
+        if (full_scan) {
+            for (auto it = guest_blocks_.begin(); it != guest_blocks_.end(); ) {
+                it = overlaps(it->first, it->second.size) ? drop(it) : std::next(it);
+            }
         } else {
-            ++it;
+            for (uint64_t candidate : candidates) {
+                auto it = guest_blocks_.find(candidate);
+                if (it != guest_blocks_.end() && overlaps(it->first, it->second.size)) {
+                    drop(it);
+                }
+            }
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    
+    // Superblock інвалідується і тоді, коли змінено будь-який із злитих у нього блоків
+    auto stale = [&](uint64_t block_address, const CompiledBlockV8& block) {
+        return overlaps(block_address, block.guest_size) ||
+               std::any_of(block.trace_segments.begin(), block.trace_segments.end(),
+                           [&](const CompiledBlockV8::TraceSegment& s) {
+                               return overlaps(s.address, s.size);
+                           });
+    };
+    
+    if (full_scan) {
+        candidates.clear();
+        for (const auto& [block_address, block] : block_cache_) candidates.push_back(block_address);
+        for (const auto& [block_address, block] : llvm_blocks_) candidates.push_back(block_address);
+    }
+    
+    for (uint64_t candidate : candidates) {
+        auto it = block_cache_.find(candidate);
+        if (it != block_cache_.end() && stale(candidate, *it->second)) {
+            Unpublish(candidate);
+            RetireBlock(std::move(it->second));
+            block_cache_.erase(it);
+        }
+        auto llvm = llvm_blocks_.find(candidate);
+        if (llvm != llvm_blocks_.end() && stale(candidate, *llvm->second)) {
+            Unpublish(candidate);
+            llvm_blocks_.erase(llvm);
         }
     }
+    
+    // Прибираємо з індексу видалені блоки (решта блоків сторінки лишається)
+    auto prune = [&](std::unordered_map<uint64_t, std::vector<uint64_t>>::iterator it) {
+        auto& blocks = it->second;
+        blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [&](uint64_t block_address) {
+            return !block_cache_.count(block_address) && !llvm_blocks_.count(block_address);
+        }), blocks.end());
+        return blocks.empty() ? code_pages_.erase(it) : std::next(it);
+    };
+    if (full_scan) {
+        for (auto it = code_pages_.begin(); it != code_pages_.end(); ) it = prune(it);
+    } else {
+        for (uint64_t page = first_page; page <= last_page; ++page) {
+            auto it = code_pages_.find(page);
+            if (it != code_pages_.end()) prune(it);
+        }
+    }
+    
+    if (llvm_) {
+        llvm_->Invalidate(address, size);
+    }
 }
 
 void TieredCompilationManager::InvalidateAll() {
     std::lock_guard<std::mutex> lock(cache_mutex_);
+    for (size_t i = 0; dispatch_ && i < kDispatchSlots; ++i) {
+        dispatch_[i].block.store(nullptr, std::memory_order_release);
+    }
     block_cache_.clear();
+    retired_blocks_.clear();
+    llvm_blocks_.clear();
+    code_pages_.clear();
+    if (llvm_) {
+        llvm_->Invalidate(0, SIZE_MAX);
+    }
     
     std::lock_guard<std::mutex> profile_lock(profile_mutex_);
     profiles_.clear();
+    branch_profiles_.clear();
+    tier_up_candidates_.clear();
+    guest_blocks_.clear();
+}
+
+bool TieredCompilationManager::EnablePersistentCache(const std::string& cache_directory,
+                                                     const std::string& title_id,
+                                                     const std::string& build_id) {
+    auto cache = std::make_unique<PersistentCodeCache>();
+    if (!cache->Open(cache_directory, title_id, build_id)) {
+        LOGW("Persistent JIT cache disabled (failed to open %s)", cache_directory.c_str());
+        return false;
+    }
+    
+    persistent_cache_ = std::move(cache);
+    LOGI("Persistent JIT cache: %zu tier-2 blocks available",
+         persistent_cache_->GetEntryCount());
+    
+    LoadProfiles();
+    return true;
+}
+
+void TieredCompilationManager::LoadProfiles() {
+    std::vector<HotspotProfile> blocks;
+    std::vector<BranchEdgeProfile> branches;
+    if (!persistent_cache_ || !persistent_cache_->LoadProfiles(blocks, branches)) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(profile_mutex_);
+    for (auto& block : blocks) {
+        // Половина лічильника: минулий hot set тієриться швидше, але не миттєво
+        block.execution_count /= 2;
+        profiles_[block.address] = block;
+    }
+    for (const auto& edge : branches) {
+        branch_profiles_[edge.pc] = edge;
+    }
+    
+    LOGI("JIT profile restored: %zu blocks, %zu branches", blocks.size(), branches.size());
+}
+
+void TieredCompilationManager::SaveProfiles() {
+    if (!persistent_cache_) return;
+    
+    std::vector<HotspotProfile> blocks;
+    std::vector<BranchEdgeProfile> branches;
+    {
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        blocks.reserve(profiles_.size());
+        for (const auto& [address, profile] : profiles_) {
+            // Холодні блоки не варті місця на диску
+            if (profile.execution_count >= flags_.tier_up_threshold / 8) {
+                blocks.push_back(profile);
+            }
+        }
+        branches.reserve(branch_profiles_.size());
+        for (const auto& [pc, edge] : branch_profiles_) {
+            branches.push_back(edge);
+        }
+    }
+    
+    persistent_cache_->SaveProfiles(blocks, branches);
 }
 
 } // namespace rpcsx::nce::v8
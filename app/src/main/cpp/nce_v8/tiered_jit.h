@@ -13,17 +13,33 @@
 #define RPCSX_NCE_V8_TIERED_JIT_H
 
 #include "nce_v8.h"
+#include "code_cache.h"
+#include "llvm_backend.h"
+#include <array>
+#include <bitset>
+#include <string>
 #include <unordered_map>
+#include <map>
 #include <queue>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <functional>
 
 namespace rpcsx::nce::v8 {
 
+class CombinedBranchPredictor;
+
 // ============================================================================
 // Baseline Compiler (Tier 1) - Fast, template-based translation
 // ============================================================================
+// Guest блок у складі superblock'а
+struct TraceSegment {
+    const uint8_t* code;
+    uint64_t address;
+    size_t size;
+};
+
 class BaselineCompiler {
 public:
     BaselineCompiler();
@@ -34,6 +50,13 @@ public:
     
     CompiledBlockV8* Compile(const uint8_t* ppc_code, uint64_t address, size_t size);
     
+    // Superblock: блоки йдуть підряд під одним prologue/epilogue, гілка між
+    // сусідніми блоками стає side exit'ом у непередбаченому напрямку.
+    // На side exit'і X28 = guest адреса продовження.
+    CompiledBlockV8* CompileTrace(const std::vector<TraceSegment>& trace);
+    
+    static constexpr size_t kMaxTraceBlocks = 8;
+    
     size_t GetCacheUsage() const { return cache_used_; }
     
 private:
@@ -107,6 +130,16 @@ struct SSAInstr {
     uint32_t flags;
 };
 
+// Guest регістри для global register allocation (індекси у GuestRegSet)
+constexpr uint32_t kGuestGPR0 = 0;    // r0-r31
+constexpr uint32_t kGuestFPR0 = 32;   // f0-f31
+constexpr uint32_t kGuestCR = 64;
+constexpr uint32_t kGuestXER = 65;
+constexpr uint32_t kGuestLR = 66;
+constexpr uint32_t kGuestCTR = 67;
+constexpr uint32_t kGuestRegCount = 68;
+using GuestRegSet = std::bitset<kGuestRegCount>;
+
 // Basic Block
 struct BasicBlock {
     uint64_t start_address;
@@ -117,6 +150,17 @@ struct BasicBlock {
     uint32_t loop_depth;
     bool is_loop_header;
     bool is_hot;
+    
+    // Guest register usage (BuildCFG)
+    GuestRegSet uses;        // Upward-exposed reads
+    GuestRegSet defs;        // Written anywhere in the block
+    std::array<uint16_t, kGuestRegCount> refs;  // Reads + writes per register
+    bool side_exit;          // Control can leave the region from this block
+    
+    // RegisterAllocation
+    GuestRegSet live_in;
+    GuestRegSet live_out;
+    GuestRegSet writeback;   // Host regs to spill to PPU state on side exit
 };
 
 // Control Flow Graph
@@ -130,13 +174,25 @@ struct CFG {
     std::vector<std::vector<uint32_t>> dom_children;
     
     // Loop info
+    // Guest доступ з постійним кроком за ітерацію: update-form load/store
+    // або load/store від бази, яку цикл зсуває лише через addi rA,rA,imm
+    struct StridedAccess {
+        uint32_t base_reg;        // GPR з гостьовою адресою
+        int32_t stride;           // Байт за ітерацію
+        int32_t prefetch_offset;  // stride * ітерацій наперед
+        bool is_store;
+    };
     struct LoopNest {
         uint32_t header;
         std::vector<uint32_t> body;
         uint32_t back_edge_block;
         uint32_t depth;
+        std::vector<StridedAccess> strided;  // Prefetch hints у header
     };
     std::vector<LoopNest> loops;
+    
+    // Emission order (superblock layout along the hot path); empty = block order
+    std::vector<uint32_t> layout;
 };
 
 class OptimizingCompiler {
@@ -148,14 +204,23 @@ public:
     void Shutdown();
     
     CompiledBlockV8* Compile(const uint8_t* ppc_code, uint64_t address, size_t size,
-                              const HotspotProfile* profile = nullptr);
+                              const HotspotProfile* profile = nullptr,
+                              const std::vector<BranchEdgeProfile>* branches = nullptr);
+    
+    // Копіювання готового tier-2 коду (з persistent cache) у code cache
+    CompiledBlockV8* InstallPrecompiled(const void* native_code, size_t code_size,
+                                        uint64_t address, size_t guest_size);
     
     size_t GetCacheUsage() const { return cache_used_; }
     
+    // AOT: scratch буфер знову вільний, щойно блок записано в persistent cache
+    void ResetCodeCache() { cache_used_ = 0; }
+    
 private:
     // Frontend: PPC → SSA IR
     CFG BuildCFG(const uint8_t* code, uint64_t address, size_t size);
     void ConvertToSSA(CFG& cfg);
+    void LayoutHotPath(CFG& cfg, const std::vector<BranchEdgeProfile>& branches);
     
     // Middle-end: Optimizations
     void RunOptimizationPasses(CFG& cfg);
@@ -170,12 +235,15 @@ private:
     void TailDuplication(CFG& cfg);
     
     // Backend: SSA IR → ARM64
-    void* EmitARM64(const CFG& cfg);
+    void* EmitARM64(const CFG& cfg, size_t* out_size);
     void RegisterAllocation(CFG& cfg);
     void InstructionScheduling(CFG& cfg);
     void EmitPrologue(void*& emit_ptr);
     void EmitEpilogue(void*& emit_ptr);
+    void EmitGuestLoads(const GuestRegSet& regs, void*& emit_ptr);
+    void EmitGuestStores(const GuestRegSet& regs, void*& emit_ptr);
     void EmitBlock(const BasicBlock& block, void*& emit_ptr);
+    void EmitLoopPrefetches(const CFG& cfg, uint32_t block_index, void*& emit_ptr);
     void EmitInstruction(const SSAInstr& instr, void*& emit_ptr);
     
     // SVE2 vectorization
@@ -188,10 +256,16 @@ private:
     size_t cache_used_;
     
     // Register allocator state
+    // Tier-2 код: X0 = PPU state (layout arm64::PPUStateOffsets), X27 = state
+    // pointer, X28 = scratch. Allocatable: X19-X26 для GPR/CR/XER/LR/CTR,
+    // D8-D15 для FPR - callee-saved, тож переживають виклики helper'ів.
     struct RegAllocState {
-        int gp_regs[32];     // Which SSA value is in each GP reg
-        int fp_regs[32];     // Which SSA value is in each FP reg
+        int gp_regs[32];     // Which guest register is in each GP reg
+        int fp_regs[32];     // Which guest register is in each FP reg
         int vec_regs[32];    // Which SSA value is in each vector reg
+        int guest_host[kGuestRegCount];  // Host reg for guest reg, -1 = PPU state memory
+        GuestRegSet allocated;
+        GuestRegSet entry_loads;         // allocated ∩ live-in входу
     };
     RegAllocState reg_state_;
     
@@ -203,7 +277,20 @@ private:
 // ============================================================================
 class BackgroundCompiler {
 public:
-    BackgroundCompiler(BaselineCompiler* baseline, OptimizingCompiler* optimizing);
+    struct CompileJob {
+        const uint8_t* code;
+        uint64_t address;
+        size_t size;
+        HotspotProfile profile;
+        std::vector<BranchEdgeProfile> branches;
+        CompilationTier tier = CompilationTier::OPTIMIZING_JIT;
+    };
+    
+    // Готовий блок встановлюється прямо з compile потоку (hot-swap, без опитування)
+    using InstallCallback = std::function<void(const CompileJob& job, CompiledBlockV8* block)>;
+    
+    BackgroundCompiler(BaselineCompiler* baseline, OptimizingCompiler* optimizing,
+                       NCEv8LLVMBackend* llvm = nullptr);
     ~BackgroundCompiler();
     
     void Start();
@@ -211,31 +298,47 @@ public:
     
     // Queue for background compilation
     void QueueForOptimization(const uint8_t* code, uint64_t address, size_t size,
-                               const HotspotProfile& profile);
+                               const HotspotProfile& profile,
+                               std::vector<BranchEdgeProfile> branches = {});
+    
+    // Tier-3: та сама черга, але компіляція - на BackgroundCompile lane пулу
+    void QueueForLLVM(const uint8_t* code, uint64_t address, size_t size,
+                      const HotspotProfile& profile);
     
-    // Check if compilation is ready
+    // Check if compilation is ready (ownership passes to caller)
     CompiledBlockV8* GetCompiledBlock(uint64_t address);
     
+    // Викликати до Start()
+    void SetInstallCallback(InstallCallback callback) { install_ = std::move(callback); }
+    void SetThreadPool(util::ThreadPool* pool) { pool_.store(pool, std::memory_order_release); }
+    
+    // Jobs queued or compiling right now (tier-2 budget)
+    uint32_t GetPendingCount() const { return pending_.load(std::memory_order_relaxed); }
+    uint32_t GetPendingLLVMCount() const { return pending_llvm_.load(std::memory_order_relaxed); }
+    
 private:
     void CompilerThread();
+    void RunJob(CompileJob& job);
     
     BaselineCompiler* baseline_;
     OptimizingCompiler* optimizing_;
-    
-    struct CompileJob {
-        const uint8_t* code;
-        uint64_t address;
-        size_t size;
-        HotspotProfile profile;
-    };
+    NCEv8LLVMBackend* llvm_;
     
     std::queue<CompileJob> job_queue_;
     std::unordered_map<uint64_t, CompiledBlockV8*> completed_;
+    InstallCallback install_;
     
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
     std::thread compile_thread_;
     std::atomic<bool> running_{false};
+    std::atomic<uint32_t> pending_{0};
+    std::atomic<uint32_t> pending_llvm_{0};
+    
+    // Pool задачі, що ще тримають this (Stop чекає на них; під queue_mutex_)
+    std::atomic<util::ThreadPool*> pool_{nullptr};
+    uint32_t pool_jobs_ = 0;
+    std::condition_variable pool_cv_;
 };
 
 // ============================================================================
@@ -255,13 +358,30 @@ public:
     // Record execution for tier-up decision
     void RecordExecution(uint64_t address);
     
+    // Record resolved guest branch (edge profile for scoring / layout)
+    void RecordBranch(uint64_t pc, bool taken, uint64_t target);
+    
+    // Branch predictor whose loop / bias tables drive tier-up scoring
+    void SetBranchPredictor(const CombinedBranchPredictor* predictor) { predictor_ = predictor; }
+    
     // Force tier-up
     void ForceTierUp(uint64_t address);
     
+    // Передбачений tier-up: кандидат зі score вище порогу, у межах того самого бюджету
+    void PrioritizeTierUp(uint64_t address, double confidence);
+    void SetBlockMissCallback(BlockMissCallback callback) { block_miss_callback_.store(callback, std::memory_order_release); }
+    
     // Invalidate
     void Invalidate(uint64_t address, size_t size);
     void InvalidateAll();
     
+    // Pool для tier-3 LLVM компіляції (nullptr = compile потік)
+    void SetThreadPool(util::ThreadPool* pool);
+    
+    // Persistent tier-2 code cache (per-title, per-build)
+    bool EnablePersistentCache(const std::string& cache_directory, const std::string& title_id,
+                               const std::string& build_id);
+    
     // Stats
     const ProfilingStats& GetStats() const { return stats_; }
     
@@ -270,6 +390,29 @@ public:
     
 private:
     void CheckTierUp(uint64_t address);
+    void CheckTier3(uint64_t address, HotspotProfile& profile);
+    
+    // Встановлення результату фонової компіляції (з compile потоку / pool worker'а)
+    void InstallCompiled(const BackgroundCompiler::CompileJob& job, CompiledBlockV8* block);
+    
+    // Dispatch table (під cache_mutex_ для запису, lock-free для читання)
+    CompiledBlockV8* LookupDispatch(uint64_t address) const;
+    void Publish(uint64_t address, CompiledBlockV8* block);
+    void Unpublish(uint64_t address);
+    void RetireBlock(std::unique_ptr<CompiledBlockV8> block);
+    
+    // Reverse mapping guest сторінка -> блоки (під cache_mutex_)
+    void IndexCodePages(uint64_t address, const CompiledBlockV8& block);
+    
+    // Profile-guided tier-up (викликаються під profile_mutex_)
+    double ComputeTierUpScore(HotspotProfile& profile, size_t guest_size);
+    std::vector<TraceSegment> FormTrace(const uint8_t* code, uint64_t address, size_t size) const;
+    bool PredictTraceSuccessor(uint64_t pc, uint32_t branch, uint64_t& next) const;
+    std::vector<BranchEdgeProfile> CollectBranches(uint64_t address, size_t guest_size) const;
+    void DrainTierUpCandidates();
+    
+    void LoadProfiles();
+    void SaveProfiles();
     
     OptimizationFlags flags_;
     
@@ -285,12 +428,46 @@ private:
     std::unordered_map<uint64_t, std::unique_ptr<CompiledBlockV8>> block_cache_;
     std::mutex cache_mutex_;
     
+    // Direct-mapped dispatch: address -> найвищий встановлений tier. Tier-up
+    // підміняє слот атомарно, поки старий код ще виконується, тому замінені
+    // блоки не звільняються одразу, а йдуть у retired_blocks_.
+    struct DispatchSlot {
+        std::atomic<uint64_t> address{0};
+        std::atomic<CompiledBlockV8*> block{nullptr};
+    };
+    static constexpr size_t kDispatchSlots = 1 << 16;
+    std::unique_ptr<DispatchSlot[]> dispatch_;
+    std::vector<std::unique_ptr<CompiledBlockV8>> retired_blocks_;
+    
+    // Tier-3 блоки (власник - LLVMJITEngine; tier-2 лишається в block_cache_)
+    NCEv8LLVMBackend* llvm_ = nullptr;
+    std::unordered_map<uint64_t, CompiledBlockV8*> llvm_blocks_;
+    
+    // 4K guest сторінка -> адреси блоків, що її покривають (разом із сегментами
+    // superblock). Може містити вже видалені блоки - Invalidate перевіряє перетин
+    static constexpr uint32_t kCodePageShift = 12;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> code_pages_;
+    
+    // Persistent tier-2 cache (nullptr = вимкнено)
+    std::unique_ptr<PersistentCodeCache> persistent_cache_;
+    
+    // Guest code та розмір блоків (для tier-2 компіляції з guest байтів)
+    struct GuestBlock {
+        const uint8_t* code;
+        size_t size;
+    };
+    std::unordered_map<uint64_t, GuestBlock> guest_blocks_;
+    
     // Profiling
     std::unordered_map<uint64_t, HotspotProfile> profiles_;
+    std::map<uint64_t, BranchEdgeProfile> branch_profiles_;  // ordered: range lookup per block
+    std::unordered_map<uint64_t, double> tier_up_candidates_;
+    const CombinedBranchPredictor* predictor_ = nullptr;
     std::mutex profile_mutex_;
     
     ProfilingStats stats_;
     TierUpCallback tier_up_callback_;
+    std::atomic<BlockMissCallback> block_miss_callback_{nullptr};
 };
 
 } // namespace rpcsx::nce::v8
@@ -4,7 +4,11 @@
 
 #include "pipeline_cache.h"
 #include <android/log.h>
+#include <android/trace.h>
 #include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <memory>
 #include <queue>
 #include <mutex>
 #include <thread>
@@ -54,16 +58,6 @@ uint64_t ComputePipelineDesc::CalculateHash() const {
 // Внутрішні структури
 // =============================================================================
 
-struct CachedPipeline {
-    PipelineHandle handle;
-    PipelineType type;
-    PipelineState state;
-    void* vk_pipeline;  // VkPipeline
-    uint64_t hash;
-    uint64_t last_access_time;
-    uint64_t creation_time_ms;
-};
-
 struct ShaderModule {
     uint64_t hash;
     void* vk_module;    // VkShaderModule
@@ -76,215 +70,395 @@ struct CompileRequest {
     PipelineType type;
     std::vector<uint8_t> desc_data;
     float priority;
-    
+
     bool operator<(const CompileRequest& other) const {
         return priority < other.priority;
     }
 };
 
+// =============================================================================
+// Sharded open-addressing таблиця pipelines
+// =============================================================================
+// Draw thread (GetOrCreate*, GetVkPipeline) читає без локів: linear probe по
+// атомарних ключах, поля слоту публікуються release-store ключа / стану.
+// Писачі (промах на draw thread, compile threads, eviction) беруть лише
+// mutex свого shard'а.
+//
+// Ключ слоту ніколи не перезаписується: видалення ставить tombstone, а
+// tombstones прибираються RCU-копією shard'а. Стара таблиця та знищені
+// VkPipeline звільняються через kRetireFrames викликів Update() - lookup,
+// що почався до публікації нової таблиці, на той момент уже завершився.
+//
+// PipelineHandle == ключ слоту (hash дескриптора), тому пошук за handle -
+// той самий lock-free probe.
+
+static constexpr uint32_t kPipelineShards = 16;
+// Частини pipeline library - ключ кожної хешує лише поля свого етапу,
+// тож перестановки blend/depth над тією ж парою шейдерів ділять решту частин
+enum PipelineLibraryPart : uint32_t {
+    kLibraryVertexInput = 0,
+    kLibraryPreRasterization,
+    kLibraryFragmentShader,
+    kLibraryFragmentOutput,
+    kLibraryPartCount
+};
+
+static uint64_t HashCombine(uint64_t seed, uint64_t value) {
+    return HashBytes(&value, sizeof(value)) ^ (seed * 0x100000001b3ULL);
+}
+
+template <typename T>
+static uint64_t HashField(uint64_t seed, const T& value) {
+    return HashCombine(seed, HashBytes(&value, sizeof(value)));
+}
+
+static void LibraryPartKeys(const GraphicsPipelineDesc& d, uint64_t keys[kLibraryPartCount]) {
+    uint64_t h = HashField(kLibraryVertexInput, d.vertex_binding_count);
+    h = HashField(h, d.vertex_attribute_count);
+    h = HashField(h, d.topology);
+    keys[kLibraryVertexInput] = HashField(h, d.primitive_restart);
+
+    h = HashField(kLibraryPreRasterization, d.vertex_shader_hash);
+    h = HashField(h, d.geometry_shader_hash);
+    h = HashField(h, d.polygon_mode);
+    h = HashField(h, d.cull_mode);
+    h = HashField(h, d.front_face);
+    h = HashField(h, d.depth_clamp);
+    h = HashField(h, d.rasterizer_discard);
+    h = HashField(h, d.line_width);
+    keys[kLibraryPreRasterization] = HashField(h, d.render_pass_hash);
+
+    h = HashField(kLibraryFragmentShader, d.fragment_shader_hash);
+    h = HashField(h, d.depth_test_enable);
+    h = HashField(h, d.depth_write_enable);
+    h = HashField(h, d.depth_compare_op);
+    h = HashField(h, d.stencil_test_enable);
+    h = HashField(h, d.sample_count);
+    h = HashField(h, d.sample_shading);
+    h = HashField(h, d.min_sample_shading);
+    keys[kLibraryFragmentShader] = HashField(h, d.render_pass_hash);
+
+    h = HashField(kLibraryFragmentOutput, d.color_attachment_count);
+    h = HashField(h, d.blend_enable);
+    h = HashField(h, d.src_color_blend);
+    h = HashField(h, d.dst_color_blend);
+    h = HashField(h, d.color_blend_op);
+    h = HashField(h, d.src_alpha_blend);
+    h = HashField(h, d.dst_alpha_blend);
+    h = HashField(h, d.alpha_blend_op);
+    h = HashField(h, d.color_write_mask);
+    h = HashField(h, d.sample_count);
+    h = HashField(h, d.render_pass_hash);
+    keys[kLibraryFragmentOutput] = HashField(h, d.subpass_index);
+}
+
+static constexpr uint32_t kMinShardCapacity = 64;
+static constexpr uint64_t kRetireFrames = 3;
+static constexpr uint64_t kEmptyKey = 0;
+static constexpr uint64_t kTombstoneKey = 1;
+
+// 0 / 1 зарезервовані (0 ще й INVALID_PIPELINE)
+static uint64_t PipelineKey(uint64_t hash) {
+    return hash <= kTombstoneKey ? hash + 2 : hash;
+}
+
+struct PipelineSlot {
+    std::atomic<uint64_t> key{kEmptyKey};
+    std::atomic<uint32_t> state{static_cast<uint32_t>(PipelineState::NOT_FOUND)};
+    std::atomic<void*> vk_pipeline{nullptr};        // VkPipeline
+    std::atomic<uint64_t> last_access_time{0};
+    PipelineType type = PipelineType::GRAPHICS;
+    uint64_t creation_time_ms = 0;
+};
+
+struct PipelineTable {
+    explicit PipelineTable(uint32_t cap)
+        : capacity(cap), mask(cap - 1), slots(new PipelineSlot[cap]) {}
+
+    uint32_t capacity;
+    uint32_t mask;
+    std::unique_ptr<PipelineSlot[]> slots;
+
+    // Низькі біти ключа вибирають shard, наступні - стартовий слот
+    uint32_t Home(uint64_t key) const {
+        return static_cast<uint32_t>(key >> 4) & mask;
+    }
+
+    // Lock-free
+    PipelineSlot* Find(uint64_t key) const {
+        const uint32_t home = Home(key);
+        for (uint32_t probe = 0; probe < capacity; ++probe) {
+            PipelineSlot& slot = slots[(home + probe) & mask];
+            const uint64_t k = slot.key.load(std::memory_order_acquire);
+            if (k == key) return &slot;
+            if (k == kEmptyKey) return nullptr;
+        }
+        return nullptr;
+    }
+};
+
+struct PipelineShard {
+    std::atomic<PipelineTable*> table{nullptr};
+    std::unique_ptr<PipelineTable> owned;   // == table
+    std::mutex mutex;                       // лише писачі
+    uint32_t live = 0;
+    uint32_t used = 0;                      // live + tombstones
+};
+
+static uint32_t NextPow2(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
 class PipelineCacheSystem {
 public:
     PipelineCacheConfig config;
     PipelineCacheStats stats;
-    
+
     void* vk_device = nullptr;
     void* vk_physical_device = nullptr;
     void* vk_pipeline_cache = nullptr;
-    
-    std::unordered_map<uint64_t, CachedPipeline> pipeline_cache;
+
+    PipelineShard shards[kPipelineShards];
     std::unordered_map<uint64_t, ShaderModule> shader_modules;
     std::unordered_map<uint64_t, void*> render_passes;
-    
+    std::unordered_map<uint64_t, void*> library_parts[kLibraryPartCount];  // VkPipeline (LIBRARY_BIT)
+
     std::priority_queue<CompileRequest> compile_queue;
-    
+
+    // stats / shader_modules / render_passes / library_parts - не на draw-call шляху
     std::mutex cache_mutex;
     std::mutex queue_mutex;
     std::condition_variable queue_cv;
-    
+
     std::vector<std::thread> compile_threads;
     std::atomic<bool> running{false};
-    
-    uint64_t next_handle{1};
-    uint64_t frame_time{0};
-    
+
+    std::atomic<uint64_t> frame_time{0};
+    std::atomic<uint64_t> cache_hits{0};
+    std::atomic<uint64_t> cache_misses{0};
+    std::atomic<uint32_t> live_pipelines{0};
+
     CompileCallback compile_callback;
-    
+    RendererStatsProvider renderer_stats_provider;
+    std::atomic<PipelineMissObserver> miss_observer{nullptr};
+
     bool Initialize(void* device, void* phys_device, const PipelineCacheConfig& cfg) {
         vk_device = device;
         vk_physical_device = phys_device;
         config = cfg;
         stats = {};
+        cache_hits.store(0);
+        cache_misses.store(0);
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            for (auto& parts : library_parts) parts.clear();
+        }
         running = true;
-        
+
+        // ~50% заповнення при повному кеші
+        const uint32_t per_shard = NextPow2(std::max(
+            kMinShardCapacity, config.max_cached_pipelines * 2 / kPipelineShards));
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.owned = std::make_unique<PipelineTable>(per_shard);
+            shard.table.store(shard.owned.get(), std::memory_order_release);
+            shard.live = 0;
+            shard.used = 0;
+        }
+        live_pipelines.store(0);
+        {
+            std::lock_guard<std::mutex> lock(record_mutex);
+            recorded_descs.clear();
+            recorded_keys.clear();
+        }
+
         // Створення Vulkan Pipeline Cache
         // В реальній реалізації тут був би виклик vkCreatePipelineCache
         vk_pipeline_cache = nullptr; // Placeholder
-        
+
         // Спроба завантаження кешу з диску
         if (!config.cache_path.empty()) {
             LoadCacheFromDisk(config.cache_path.c_str());
         }
-        
+
         // Запуск потоків компіляції
         for (uint32_t i = 0; i < config.compile_threads; ++i) {
-            compile_threads.emplace_back([this]() { CompileThread(); });
+            compile_threads.emplace_back([this]() { CompileThread(false); });
+        }
+
+        // Replay записаного потоку до першого кадру: тимчасові потоки на
+        // решту ядер, виходять, коли черга порожня
+        if (g_pending_compilations.load() > 0) {
+            uint32_t prewarm = config.prewarm_threads
+                                   ? config.prewarm_threads
+                                   : std::thread::hardware_concurrency();
+            prewarm = prewarm > config.compile_threads ? prewarm - config.compile_threads : 0;
+            for (uint32_t i = 0; i < prewarm; ++i) {
+                compile_threads.emplace_back([this]() { CompileThread(true); });
+            }
+            LOGI("Pipeline prewarm: %u pipelines on %u extra threads",
+                 g_pending_compilations.load(), prewarm);
         }
-        
+
         LOGI("╔════════════════════════════════════════════════════════════╗");
         LOGI("║      Vulkan Pipeline State Object Cache                    ║");
         LOGI("╠════════════════════════════════════════════════════════════╣");
         LOGI("║  Max Pipelines: %5u                                       ║", config.max_cached_pipelines);
+        LOGI("║  Shards: %2u x %5u slots (lock-free lookup)               ║", kPipelineShards, per_shard);
         LOGI("║  VK Cache Size: %3zu MB                                     ║", config.vk_cache_size / (1024*1024));
         LOGI("║  Compile Threads: %u                                        ║", config.compile_threads);
         LOGI("║  Pipeline Library: %-8s                              ║", config.use_pipeline_library ? "Enabled" : "Disabled");
         LOGI("║  Precompilation: %-10s                              ║", config.enable_precompilation ? "Enabled" : "Disabled");
         LOGI("╚════════════════════════════════════════════════════════════╝");
-        
+
         g_cache_active.store(true);
         return true;
     }
-    
+
     void Shutdown() {
         running = false;
         queue_cv.notify_all();
-        
+
         for (auto& thread : compile_threads) {
             if (thread.joinable()) {
                 thread.join();
             }
         }
         compile_threads.clear();
-        
+
         // Збереження кешу
         if (config.persist_to_disk && !config.cache_path.empty()) {
             SaveCacheToDisk(config.cache_path.c_str());
         }
-        
-        // Очищення pipelines
+
+        // Очищення pipelines: compile threads зупинені, draw thread теж -
+        // grace period не потрібен
+        g_cache_active.store(false);
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            // В реальності тут були б виклики vkDestroyPipeline для live слотів
+            shard.table.store(nullptr, std::memory_order_release);
+            shard.owned.reset();
+            shard.live = 0;
+            shard.used = 0;
+        }
+        {
+            std::lock_guard<std::mutex> lock(retire_mutex);
+            retired_tables.clear();
+            retired_pipelines.clear();
+        }
         {
             std::lock_guard<std::mutex> lock(cache_mutex);
-            // В реальності тут були б виклики vkDestroyPipeline
-            pipeline_cache.clear();
             shader_modules.clear();
             render_passes.clear();
         }
-        
+
         // Знищення VkPipelineCache
         // vkDestroyPipelineCache(...)
-        
-        g_cache_active.store(false);
+
+        live_pipelines.store(0);
         g_pipelines_in_cache.store(0);
-        
+
+        const uint64_t hits = cache_hits.load();
+        const uint64_t misses = cache_misses.load();
         LOGI("Pipeline Cache shutdown complete");
         LOGI("Stats: Created=%llu, Hits=%llu, Misses=%llu, HitRatio=%.1f%%",
              (unsigned long long)stats.total_pipelines_created,
-             (unsigned long long)stats.cache_hits,
-             (unsigned long long)stats.cache_misses,
-             stats.cache_hit_ratio * 100.0f);
+             (unsigned long long)hits,
+             (unsigned long long)misses,
+             hits + misses ? 100.0f * hits / (hits + misses) : 0.0f);
     }
-    
+
     PipelineHandle GetOrCreateGraphics(const GraphicsPipelineDesc& desc) {
-        uint64_t hash = desc.CalculateHash();
-        
-        {
-            std::lock_guard<std::mutex> lock(cache_mutex);
-            
-            auto it = pipeline_cache.find(hash);
-            if (it != pipeline_cache.end()) {
-                it->second.last_access_time = frame_time;
-                stats.cache_hits++;
-                UpdateHitRatio();
-                return it->second.handle;
-            }
+        const uint64_t key = PipelineKey(desc.CalculateHash());
+
+        PipelineHandle handle;
+        if (LookupFast(key, &handle)) return handle;
+
+        cache_misses.fetch_add(1, std::memory_order_relaxed);
+
+        if (auto observer = miss_observer.load(std::memory_order_acquire)) {
+            observer(desc);
         }
-        
-        stats.cache_misses++;
-        UpdateHitRatio();
-        
+
         // Створення нового pipeline
-        return CreateGraphicsPipeline(desc, hash);
+        return CreateGraphicsPipeline(desc, key);
     }
-    
+
     PipelineHandle GetOrCreateCompute(const ComputePipelineDesc& desc) {
-        uint64_t hash = desc.CalculateHash();
-        
-        {
-            std::lock_guard<std::mutex> lock(cache_mutex);
-            
-            auto it = pipeline_cache.find(hash);
-            if (it != pipeline_cache.end()) {
-                it->second.last_access_time = frame_time;
-                stats.cache_hits++;
-                UpdateHitRatio();
-                return it->second.handle;
-            }
-        }
-        
-        stats.cache_misses++;
-        UpdateHitRatio();
-        
-        return CreateComputePipeline(desc, hash);
+        const uint64_t key = PipelineKey(desc.CalculateHash());
+
+        PipelineHandle handle;
+        if (LookupFast(key, &handle)) return handle;
+
+        cache_misses.fetch_add(1, std::memory_order_relaxed);
+
+        return CreateComputePipeline(desc, key);
     }
-    
-    void RequestPrecompileGraphics(const GraphicsPipelineDesc& desc) {
+
+    void RequestPrecompileGraphics(const GraphicsPipelineDesc& desc, float priority) {
         if (!config.enable_precompilation) return;
-        
-        uint64_t hash = desc.CalculateHash();
-        
+        QueuePrecompile(desc, PipelineKey(desc.CalculateHash()), priority);
+    }
+
+    // priority: більше - раніше (replay > 1.0, ручні запити 0.5)
+    bool QueuePrecompile(const GraphicsPipelineDesc& desc, uint64_t key, float priority) {
         {
-            std::lock_guard<std::mutex> lock(cache_mutex);
-            if (pipeline_cache.find(hash) != pipeline_cache.end()) {
-                return; // Already exists
+            PipelineTable* table = ShardFor(key).table.load(std::memory_order_acquire);
+            if (!table || table->Find(key)) {
+                return false; // Already exists
             }
         }
-        
+
         CompileRequest req;
-        req.hash = hash;
+        req.hash = key;
         req.type = PipelineType::GRAPHICS;
         req.desc_data.resize(sizeof(desc));
         memcpy(req.desc_data.data(), &desc, sizeof(desc));
-        req.priority = 0.5f;
-        
+        req.priority = priority;
+
         {
             std::lock_guard<std::mutex> lock(queue_mutex);
             compile_queue.push(req);
             g_pending_compilations++;
-            stats.pending_compilations++;
         }
         queue_cv.notify_one();
+        return true;
     }
-    
+
     PipelineState GetState(PipelineHandle handle) {
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        
-        for (const auto& [hash, pipeline] : pipeline_cache) {
-            if (pipeline.handle == handle) {
-                return pipeline.state;
-            }
-        }
-        return PipelineState::NOT_FOUND;
+        if (handle == INVALID_PIPELINE) return PipelineState::NOT_FOUND;
+
+        PipelineTable* table = ShardFor(handle).table.load(std::memory_order_acquire);
+        PipelineSlot* slot = table ? table->Find(handle) : nullptr;
+        if (!slot) return PipelineState::NOT_FOUND;
+        return static_cast<PipelineState>(slot->state.load(std::memory_order_acquire));
     }
-    
+
     void* GetVkPipeline(PipelineHandle handle) {
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        
-        for (const auto& [hash, pipeline] : pipeline_cache) {
-            if (pipeline.handle == handle && pipeline.state == PipelineState::READY) {
-                return pipeline.vk_pipeline;
-            }
+        if (handle == INVALID_PIPELINE) return nullptr;
+
+        PipelineTable* table = ShardFor(handle).table.load(std::memory_order_acquire);
+        PipelineSlot* slot = table ? table->Find(handle) : nullptr;
+        if (!slot) return nullptr;
+        if (slot->state.load(std::memory_order_acquire) !=
+            static_cast<uint32_t>(PipelineState::READY)) {
+            return nullptr;
         }
-        return nullptr;
+        return slot->vk_pipeline.load(std::memory_order_relaxed);
     }
-    
+
     uint64_t RegisterShader(const void* spirv, size_t size, uint32_t stage) {
         uint64_t hash = HashBytes(spirv, size);
-        
+
         std::lock_guard<std::mutex> lock(cache_mutex);
-        
+
         if (shader_modules.find(hash) != shader_modules.end()) {
             return hash;
         }
-        
+
         ShaderModule module;
         module.hash = hash;
         module.stage = stage;
@@ -292,76 +466,127 @@ public:
         memcpy(module.spirv.data(), spirv, size);
         // В реальності: vkCreateShaderModule
         module.vk_module = nullptr;
-        
+
         shader_modules[hash] = std::move(module);
         return hash;
     }
-    
+
     uint64_t RegisterRenderPass(void* vk_rp) {
         uint64_t hash = reinterpret_cast<uint64_t>(vk_rp);
-        
+
         std::lock_guard<std::mutex> lock(cache_mutex);
         render_passes[hash] = vk_rp;
         return hash;
     }
-    
+
     void Update() {
-        frame_time++;
-        
+        const uint64_t now = frame_time.fetch_add(1, std::memory_order_relaxed) + 1;
+
         // Перевірка на необхідність eviction
+        while (live_pipelines.load(std::memory_order_relaxed) > config.max_cached_pipelines) {
+            if (!EvictOldest()) break;
+        }
+
+        ReclaimRetired(now);
+
+        const uint32_t count = live_pipelines.load(std::memory_order_relaxed);
+        g_pipelines_in_cache.store(count);
+
         std::lock_guard<std::mutex> lock(cache_mutex);
-        
-        if (pipeline_cache.size() > config.max_cached_pipelines) {
-            EvictOldest();
+        stats.pipelines_in_cache = count;
+    }
+
+    // Драйвер не повідомляє розмір VkPipeline: оцінка пам'яті за кількістю
+    void GetMemoryUsage(uint64_t* used_bytes, uint64_t* reclaimable_bytes) {
+        uint64_t spirv_bytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            for (const auto& [hash, module] : shader_modules) {
+                spirv_bytes += module.spirv.size();
+            }
         }
-        
-        g_pipelines_in_cache.store(pipeline_cache.size());
-        stats.pipelines_in_cache = pipeline_cache.size();
+
+        const uint64_t pipeline_bytes =
+            static_cast<uint64_t>(live_pipelines.load(std::memory_order_relaxed)) * kEstimatedPipelineBytes;
+        *used_bytes = spirv_bytes + pipeline_bytes;
+        *reclaimable_bytes = pipeline_bytes;
     }
-    
+
+    uint32_t Trim(uint32_t max_pipelines) {
+        uint32_t evicted = 0;
+        while (live_pipelines.load(std::memory_order_relaxed) > max_pipelines) {
+            if (!EvictOldest()) break;
+            evicted++;
+        }
+        g_pipelines_in_cache.store(live_pipelines.load(std::memory_order_relaxed));
+        return evicted;
+    }
+
     bool SaveCache(const char* path) {
         std::string filepath = path ? path : config.cache_path;
         if (filepath.empty()) return false;
-        
+
         std::ofstream file(filepath, std::ios::binary);
         if (!file.is_open()) {
             LOGE("Failed to open cache file for writing: %s", filepath.c_str());
             return false;
         }
-        
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        
+
+        std::vector<std::pair<uint64_t, PipelineType>> entries;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            PipelineTable* table = shard.owned.get();
+            if (!table) continue;
+            for (uint32_t i = 0; i < table->capacity; ++i) {
+                const uint64_t key = table->slots[i].key.load(std::memory_order_relaxed);
+                if (key > kTombstoneKey) entries.emplace_back(key, table->slots[i].type);
+            }
+        }
+
         // Записуємо кількість pipelines
-        uint32_t count = pipeline_cache.size();
+        uint32_t count = entries.size();
         file.write(reinterpret_cast<const char*>(&count), sizeof(count));
-        
+
         // Записуємо кожен pipeline
-        for (const auto& [hash, pipeline] : pipeline_cache) {
+        for (const auto& [hash, type] : entries) {
             file.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
-            file.write(reinterpret_cast<const char*>(&pipeline.type), sizeof(pipeline.type));
+            file.write(reinterpret_cast<const char*>(&type), sizeof(type));
         }
-        
-        stats.disk_cache_size_bytes = file.tellp();
-        
+
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            stats.disk_cache_size_bytes = file.tellp();
+        }
+
         LOGI("Saved %u pipelines to cache: %s", count, filepath.c_str());
+
+        if (config.record_pipeline_stream) {
+            SaveReplayStream(filepath + ".replay");
+        }
         return true;
     }
-    
+
     bool LoadCache(const char* path) {
         std::string filepath = path ? path : config.cache_path;
         if (filepath.empty()) return false;
-        
+
         std::ifstream file(filepath, std::ios::binary);
         if (!file.is_open()) {
             LOGI("No cache file found: %s", filepath.c_str());
+
+            // Новий драйвер або видалений кеш: потік дескрипторів від драйвера
+            // не залежить, prewarm з нього відновлює pipelines у фоні
+            if (config.record_pipeline_stream && config.enable_precompilation) {
+                LoadReplayStream(filepath + ".replay");
+            }
             return false;
         }
-        
+
         uint32_t count;
         file.read(reinterpret_cast<char*>(&count), sizeof(count));
-        
+
         LOGI("Loading %u pipelines from cache: %s", count, filepath.c_str());
-        
+
         // В реальності тут було б відновлення pipelines
         // Поки що просто читаємо дані
         for (uint32_t i = 0; i < count; ++i) {
@@ -370,151 +595,487 @@ public:
             file.read(reinterpret_cast<char*>(&hash), sizeof(hash));
             file.read(reinterpret_cast<char*>(&type), sizeof(type));
         }
-        
+
+        if (config.record_pipeline_stream && config.enable_precompilation) {
+            LoadReplayStream(filepath + ".replay");
+        }
         return true;
     }
-    
+
     void ClearAll() {
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        
-        stats.pipelines_evicted += pipeline_cache.size();
-        pipeline_cache.clear();
-        
+        uint32_t cleared = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (!shard.owned) continue;
+            cleared += shard.live;
+            RetireTableLocked(shard, std::make_unique<PipelineTable>(shard.owned->capacity), true);
+            shard.live = 0;
+            shard.used = 0;
+        }
+        live_pipelines.store(0);
         g_pipelines_in_cache.store(0);
-        
+
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            stats.pipelines_evicted += cleared;
+        }
+
         LOGI("Pipeline cache cleared");
     }
-    
+
+    void ResetCounters() {
+        cache_hits.store(0);
+        cache_misses.store(0);
+    }
+
 private:
-    PipelineHandle CreateGraphicsPipeline(const GraphicsPipelineDesc& desc, uint64_t hash) {
+    // =========================================================================
+    // Запис / replay потоку дескрипторів
+    // =========================================================================
+    // Кожен унікальний GraphicsPipelineDesc логується при першій компіляції;
+    // SaveCache пише список у порядку першого використання. При старті він
+    // ставиться в чергу з пріоритетом за цим порядком - меню та перший рівень
+    // готові першими. Завантажені записи лишаються в списку, тож порядок
+    // зберігається між сесіями, а нові дописуються в кінець.
+
+    struct ReplayHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t desc_size;     // sizeof(GraphicsPipelineDesc) - зміна layout інвалідує файл
+        uint32_t count;
+    };
+
+    static constexpr char kReplayMagic[4] = {'P', 'S', 'O', 'R'};
+    static constexpr uint32_t kReplayVersion = 1;
+
+    std::mutex record_mutex;
+    std::vector<GraphicsPipelineDesc> recorded_descs;
+    std::unordered_set<uint64_t> recorded_keys;
+
+    void RecordFirstUse(const GraphicsPipelineDesc& desc, uint64_t key) {
+        if (!config.record_pipeline_stream) return;
+        std::lock_guard<std::mutex> lock(record_mutex);
+        if (recorded_keys.insert(key).second) {
+            recorded_descs.push_back(desc);
+        }
+    }
+
+    void SaveReplayStream(const std::string& filepath) {
+        std::lock_guard<std::mutex> lock(record_mutex);
+        if (recorded_descs.empty()) return;
+
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            LOGE("Failed to open replay stream for writing: %s", filepath.c_str());
+            return;
+        }
+
+        ReplayHeader header{};
+        memcpy(header.magic, kReplayMagic, sizeof(kReplayMagic));
+        header.version = kReplayVersion;
+        header.desc_size = sizeof(GraphicsPipelineDesc);
+        header.count = static_cast<uint32_t>(recorded_descs.size());
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(recorded_descs.data()),
+                   recorded_descs.size() * sizeof(GraphicsPipelineDesc));
+
+        LOGI("Saved pipeline replay stream: %u descriptors", header.count);
+    }
+
+    void LoadReplayStream(const std::string& filepath) {
+        std::ifstream file(filepath, std::ios::binary);
+        if (!file.is_open()) return;
+
+        ReplayHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || memcmp(header.magic, kReplayMagic, sizeof(kReplayMagic)) != 0 ||
+            header.version != kReplayVersion ||
+            header.desc_size != sizeof(GraphicsPipelineDesc)) {
+            LOGW("Pipeline replay stream incompatible, ignoring: %s", filepath.c_str());
+            return;
+        }
+
+        std::vector<GraphicsPipelineDesc> descs(header.count);
+        file.read(reinterpret_cast<char*>(descs.data()), descs.size() * sizeof(GraphicsPipelineDesc));
+        descs.resize(static_cast<size_t>(file.gcount()) / sizeof(GraphicsPipelineDesc));
+
+        uint32_t queued = 0;
+        {
+            std::lock_guard<std::mutex> lock(record_mutex);
+            for (size_t i = 0; i < descs.size(); ++i) {
+                const uint64_t key = PipelineKey(descs[i].CalculateHash());
+                if (!recorded_keys.insert(key).second) continue;
+                recorded_descs.push_back(descs[i]);
+
+                // Раніше використаний - вищий пріоритет
+                if (QueuePrecompile(descs[i], key, 1.0f + static_cast<float>(descs.size() - i))) {
+                    queued++;
+                }
+            }
+        }
+
+        LOGI("Pipeline replay stream: %zu descriptors, %u queued for prewarm", descs.size(), queued);
+    }
+
+    struct RetiredTable {
+        uint64_t frame;
+        std::unique_ptr<PipelineTable> table;
+    };
+
+    struct RetiredPipeline {
+        uint64_t frame;
+        void* vk_pipeline;
+    };
+
+    std::mutex retire_mutex;
+    std::vector<RetiredTable> retired_tables;
+    std::vector<RetiredPipeline> retired_pipelines;
+
+    PipelineShard& ShardFor(uint64_t key) {
+        return shards[key & (kPipelineShards - 1)];
+    }
+
+    // Draw-call шлях: без локів і алокацій
+    bool LookupFast(uint64_t key, PipelineHandle* handle) {
+        PipelineTable* table = ShardFor(key).table.load(std::memory_order_acquire);
+        PipelineSlot* slot = table ? table->Find(key) : nullptr;
+        if (!slot) return false;
+
+        slot->last_access_time.store(frame_time.load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+        cache_hits.fetch_add(1, std::memory_order_relaxed);
+
+        // Ще компілюється (precompile або інший потік) - не дублюємо роботу
+        const uint32_t state = slot->state.load(std::memory_order_acquire);
+        *handle = state == static_cast<uint32_t>(PipelineState::READY) ? key : INVALID_PIPELINE;
+        return true;
+    }
+
+    // Під shard.mutex. Повертає існуючий слот або новий у стані COMPILING.
+    PipelineSlot* InsertLocked(PipelineShard& shard, uint64_t key, PipelineType type,
+                               bool* inserted) {
+        *inserted = false;
+        PipelineTable* table = shard.owned.get();
+        if (!table) return nullptr;
+
+        if (PipelineSlot* existing = table->Find(key)) return existing;
+
+        // Tombstones не перевикористовуються на місці (lock-free reader міг
+        // уже зіставити старий ключ) - лише через RCU-копію
+        if ((shard.used + 1) * 4 > table->capacity * 3) {
+            const uint32_t capacity = (shard.live + 1) * 2 > table->capacity
+                                          ? table->capacity * 2 : table->capacity;
+            RebuildLocked(shard, capacity);
+            table = shard.owned.get();
+        }
+
+        const uint32_t home = table->Home(key);
+        for (uint32_t probe = 0; probe < table->capacity; ++probe) {
+            PipelineSlot& slot = table->slots[(home + probe) & table->mask];
+            if (slot.key.load(std::memory_order_relaxed) != kEmptyKey) continue;
+
+            slot.type = type;
+            slot.creation_time_ms = 0;
+            slot.vk_pipeline.store(nullptr, std::memory_order_relaxed);
+            slot.last_access_time.store(frame_time.load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+            slot.state.store(static_cast<uint32_t>(PipelineState::COMPILING),
+                             std::memory_order_relaxed);
+            slot.key.store(key, std::memory_order_release);
+
+            shard.live++;
+            shard.used++;
+            live_pipelines.fetch_add(1, std::memory_order_relaxed);
+            *inserted = true;
+            return &slot;
+        }
+        return nullptr;
+    }
+
+    // Під shard.mutex: копія live слотів у нову таблицю + публікація
+    void RebuildLocked(PipelineShard& shard, uint32_t capacity) {
+        auto fresh = std::make_unique<PipelineTable>(capacity);
+        PipelineTable* old = shard.owned.get();
+        uint32_t live = 0;
+
+        for (uint32_t i = 0; i < old->capacity; ++i) {
+            const PipelineSlot& src = old->slots[i];
+            const uint64_t key = src.key.load(std::memory_order_relaxed);
+            if (key <= kTombstoneKey) continue;
+
+            const uint32_t home = fresh->Home(key);
+            for (uint32_t probe = 0;; ++probe) {
+                PipelineSlot& dst = fresh->slots[(home + probe) & fresh->mask];
+                if (dst.key.load(std::memory_order_relaxed) != kEmptyKey) continue;
+                dst.type = src.type;
+                dst.creation_time_ms = src.creation_time_ms;
+                dst.vk_pipeline.store(src.vk_pipeline.load(std::memory_order_relaxed),
+                                      std::memory_order_relaxed);
+                dst.last_access_time.store(src.last_access_time.load(std::memory_order_relaxed),
+                                           std::memory_order_relaxed);
+                dst.state.store(src.state.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+                dst.key.store(key, std::memory_order_relaxed);
+                break;
+            }
+            live++;
+        }
+
+        shard.live = live;
+        shard.used = live;
+        RetireTableLocked(shard, std::move(fresh), false);
+    }
+
+    // Публікація нової таблиці; стара звільняється після grace period.
+    // destroy_pipelines - live VkPipeline старої таблиці теж відкладено знищуються.
+    void RetireTableLocked(PipelineShard& shard, std::unique_ptr<PipelineTable> fresh,
+                           bool destroy_pipelines) {
+        shard.table.store(fresh.get(), std::memory_order_release);
+        std::unique_ptr<PipelineTable> old = std::move(shard.owned);
+        shard.owned = std::move(fresh);
+
+        const uint64_t now = frame_time.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        if (destroy_pipelines) {
+            for (uint32_t i = 0; i < old->capacity; ++i) {
+                if (old->slots[i].key.load(std::memory_order_relaxed) <= kTombstoneKey) continue;
+                if (void* vk = old->slots[i].vk_pipeline.load(std::memory_order_relaxed)) {
+                    retired_pipelines.push_back({now, vk});
+                }
+            }
+        }
+        retired_tables.push_back({now, std::move(old)});
+    }
+
+    void RetirePipeline(void* vk_pipeline) {
+        if (!vk_pipeline) return;
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        retired_pipelines.push_back({frame_time.load(std::memory_order_relaxed), vk_pipeline});
+    }
+
+    void ReclaimRetired(uint64_t now) {
+        std::lock_guard<std::mutex> lock(retire_mutex);
+
+        auto expired = [now](uint64_t frame) { return frame + kRetireFrames <= now; };
+
+        retired_tables.erase(
+            std::remove_if(retired_tables.begin(), retired_tables.end(),
+                           [&](const RetiredTable& r) { return expired(r.frame); }),
+            retired_tables.end());
+
+        // В реальності: vkDestroyPipeline для кожного expired
+        retired_pipelines.erase(
+            std::remove_if(retired_pipelines.begin(), retired_pipelines.end(),
+                           [&](const RetiredPipeline& r) { return expired(r.frame); }),
+            retired_pipelines.end());
+    }
+
+    // Завершення компіляції: слот шукається заново - поки йшла компіляція,
+    // shard міг бути перебудований або pipeline витіснений
+    bool PublishCompiled(uint64_t key, void* vk_pipeline, PipelineState state,
+                         uint64_t creation_time_ms) {
+        PipelineShard& shard = ShardFor(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            PipelineSlot* slot = shard.owned ? shard.owned->Find(key) : nullptr;
+            if (slot) {
+                slot->creation_time_ms = creation_time_ms;
+                slot->vk_pipeline.store(vk_pipeline, std::memory_order_relaxed);
+                slot->state.store(static_cast<uint32_t>(state), std::memory_order_release);
+            }
+            if (!slot) {
+                RetirePipeline(vk_pipeline);
+                return false;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        stats.total_pipelines_created++;
+        stats.pipelines_compiled++;
+        stats.compile_time_total_ms += creation_time_ms;
+        stats.average_compile_time_ms = static_cast<float>(stats.compile_time_total_ms) /
+                                        stats.pipelines_compiled;
+        return true;
+    }
+
+    // Реєстрація слоту перед компіляцією. false - pipeline вже є (або
+    // компілюється іншим потоком), *handle - його поточний handle.
+    bool BeginCompile(uint64_t key, PipelineType type, PipelineHandle* handle) {
+        PipelineShard& shard = ShardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        bool inserted = false;
+        PipelineSlot* slot = InsertLocked(shard, key, type, &inserted);
+        if (!slot) {
+            *handle = INVALID_PIPELINE;
+            return false;
+        }
+        if (!inserted) {
+            *handle = slot->state.load(std::memory_order_acquire) ==
+                      static_cast<uint32_t>(PipelineState::READY) ? key : INVALID_PIPELINE;
+            return false;
+        }
+        return true;
+    }
+
+    PipelineHandle CreateGraphicsPipeline(const GraphicsPipelineDesc& desc, uint64_t key) {
+        PipelineHandle existing;
+        if (!BeginCompile(key, PipelineType::GRAPHICS, &existing)) return existing;
+
+        RecordFirstUse(desc, key);
+
         auto start = std::chrono::steady_clock::now();
-        
-        CachedPipeline pipeline;
-        pipeline.handle = next_handle++;
-        pipeline.type = PipelineType::GRAPHICS;
-        pipeline.hash = hash;
-        pipeline.last_access_time = frame_time;
-        
-        // В реальності тут був би виклик vkCreateGraphicsPipelines
-        // Симуляція компіляції
-        pipeline.vk_pipeline = reinterpret_cast<void*>(hash); // Placeholder
-        pipeline.state = PipelineState::READY;
-        
+
+        void* vk_pipeline = config.use_pipeline_library
+            ? LinkPipelineLibraries(desc, key)
+            // В реальності тут був би виклик vkCreateGraphicsPipelines
+            : reinterpret_cast<void*>(key); // Placeholder
+
         auto end = std::chrono::steady_clock::now();
-        pipeline.creation_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        const uint64_t creation_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
             end - start).count();
-        
+
+        if (!PublishCompiled(key, vk_pipeline, PipelineState::READY, creation_time_ms)) {
+            return INVALID_PIPELINE;
+        }
+        return key;
+    }
+
+    // Компілює лише відсутні частини, далі - дешевий link
+    // (vkCreateGraphicsPipelines з VkPipelineLibraryCreateInfoKHR)
+    void* LinkPipelineLibraries(const GraphicsPipelineDesc& desc, uint64_t key) {
+        uint64_t part_keys[kLibraryPartCount];
+        LibraryPartKeys(desc, part_keys);
+
+        uint32_t hits = 0;
+        uint32_t created = 0;
         {
             std::lock_guard<std::mutex> lock(cache_mutex);
-            pipeline_cache[hash] = pipeline;
-            
-            stats.total_pipelines_created++;
-            stats.pipelines_compiled++;
-            stats.compile_time_total_ms += pipeline.creation_time_ms;
-            stats.average_compile_time_ms = static_cast<float>(stats.compile_time_total_ms) / 
-                                            stats.pipelines_compiled;
-            
-            g_pipelines_in_cache.store(pipeline_cache.size());
-        }
-        
-        return pipeline.handle;
-    }
-    
-    PipelineHandle CreateComputePipeline(const ComputePipelineDesc& desc, uint64_t hash) {
+            for (uint32_t part = 0; part < kLibraryPartCount; ++part) {
+                auto [it, inserted] = library_parts[part].try_emplace(part_keys[part], nullptr);
+                if (inserted) {
+                    // vkCreateGraphicsPipelines(VK_PIPELINE_CREATE_LIBRARY_BIT_KHR, лише цей етап)
+                    it->second = reinterpret_cast<void*>(part_keys[part]); // Placeholder
+                    ++created;
+                } else {
+                    ++hits;
+                }
+            }
+            stats.library_parts_created += created;
+            stats.library_part_hits += hits;
+            stats.library_links++;
+        }
+
+        return reinterpret_cast<void*>(key); // Placeholder
+    }
+
+    PipelineHandle CreateComputePipeline(const ComputePipelineDesc& desc, uint64_t key) {
+        PipelineHandle existing;
+        if (!BeginCompile(key, PipelineType::COMPUTE, &existing)) return existing;
+
         auto start = std::chrono::steady_clock::now();
-        
-        CachedPipeline pipeline;
-        pipeline.handle = next_handle++;
-        pipeline.type = PipelineType::COMPUTE;
-        pipeline.hash = hash;
-        pipeline.last_access_time = frame_time;
-        
+
         // vkCreateComputePipelines
-        pipeline.vk_pipeline = reinterpret_cast<void*>(hash);
-        pipeline.state = PipelineState::READY;
-        
+        void* vk_pipeline = reinterpret_cast<void*>(key);
+
         auto end = std::chrono::steady_clock::now();
-        pipeline.creation_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        const uint64_t creation_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
             end - start).count();
-        
-        {
-            std::lock_guard<std::mutex> lock(cache_mutex);
-            pipeline_cache[hash] = pipeline;
-            
-            stats.total_pipelines_created++;
-            stats.pipelines_compiled++;
-            stats.compile_time_total_ms += pipeline.creation_time_ms;
-            
-            g_pipelines_in_cache.store(pipeline_cache.size());
-        }
-        
-        return pipeline.handle;
-    }
-    
-    void CompileThread() {
+
+        if (!PublishCompiled(key, vk_pipeline, PipelineState::READY, creation_time_ms)) {
+            return INVALID_PIPELINE;
+        }
+        return key;
+    }
+
+    // drain: prewarm потік - виходить, щойно черга спорожніла
+    void CompileThread(bool drain) {
         while (running) {
             CompileRequest request;
-            
+
             {
                 std::unique_lock<std::mutex> lock(queue_mutex);
+                if (drain && compile_queue.empty()) break;
                 queue_cv.wait(lock, [this]() {
                     return !running || !compile_queue.empty();
                 });
-                
+
                 if (!running) break;
                 if (compile_queue.empty()) continue;
-                
+
                 request = compile_queue.top();
                 compile_queue.pop();
                 g_pending_compilations--;
             }
-            
+
             // Компіляція
             bool success = false;
-            
+
             if (request.type == PipelineType::GRAPHICS) {
+                // Секція системного трейсу (Perfetto/systrace), лише під час запису
+                const bool traced = ATrace_isEnabled();
+                if (traced) ATrace_beginSection(drain ? "Pipeline prewarm" : "Pipeline compile");
+
                 GraphicsPipelineDesc desc;
                 memcpy(&desc, request.desc_data.data(), sizeof(desc));
                 PipelineHandle handle = CreateGraphicsPipeline(desc, request.hash);
                 success = (handle != INVALID_PIPELINE);
-                
+
+                if (traced) ATrace_endSection();
+
                 if (compile_callback) {
                     compile_callback(handle, success);
                 }
             }
-            
+
             {
                 std::lock_guard<std::mutex> lock(cache_mutex);
                 stats.pending_compilations = g_pending_compilations.load();
             }
         }
     }
-    
-    void EvictOldest() {
-        if (pipeline_cache.empty()) return;
-        
-        uint64_t oldest_hash = 0;
+
+    // Сканування без локів, tombstone - під mutex shard'а-переможця
+    bool EvictOldest() {
+        uint64_t oldest_key = kEmptyKey;
         uint64_t oldest_time = UINT64_MAX;
-        
-        for (const auto& [hash, pipeline] : pipeline_cache) {
-            if (pipeline.last_access_time < oldest_time) {
-                oldest_time = pipeline.last_access_time;
-                oldest_hash = hash;
+
+        for (auto& shard : shards) {
+            PipelineTable* table = shard.table.load(std::memory_order_acquire);
+            if (!table) continue;
+            for (uint32_t i = 0; i < table->capacity; ++i) {
+                const PipelineSlot& slot = table->slots[i];
+                const uint64_t key = slot.key.load(std::memory_order_acquire);
+                if (key <= kTombstoneKey) continue;
+                // Pipelines, що компілюються, не витісняємо
+                if (slot.state.load(std::memory_order_relaxed) ==
+                    static_cast<uint32_t>(PipelineState::COMPILING)) continue;
+                const uint64_t t = slot.last_access_time.load(std::memory_order_relaxed);
+                if (t < oldest_time) {
+                    oldest_time = t;
+                    oldest_key = key;
+                }
             }
         }
-        
-        if (oldest_hash != 0) {
-            // В реальності: vkDestroyPipeline
-            pipeline_cache.erase(oldest_hash);
-            stats.pipelines_evicted++;
-        }
-    }
-    
-    void UpdateHitRatio() {
-        uint64_t total = stats.cache_hits + stats.cache_misses;
-        if (total > 0) {
-            stats.cache_hit_ratio = static_cast<float>(stats.cache_hits) / total;
+
+        if (oldest_key == kEmptyKey) return false;
+
+        PipelineShard& shard = ShardFor(oldest_key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            PipelineSlot* slot = shard.owned ? shard.owned->Find(oldest_key) : nullptr;
+            if (!slot) return true;  // вже видалений іншим потоком
+
+            slot->key.store(kTombstoneKey, std::memory_order_release);
+            shard.live--;
+            live_pipelines.fetch_sub(1, std::memory_order_relaxed);
+            // В реальності: vkDestroyPipeline після grace period
+            RetirePipeline(slot->vk_pipeline.load(std::memory_order_relaxed));
         }
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        stats.pipelines_evicted++;
+        return true;
     }
 };
 
@@ -553,8 +1114,8 @@ void* GetVkPipeline(PipelineHandle handle) {
     return g_system.GetVkPipeline(handle);
 }
 
-void RequestPrecompile(const GraphicsPipelineDesc& desc) {
-    g_system.RequestPrecompileGraphics(desc);
+void RequestPrecompile(const GraphicsPipelineDesc& desc, float priority) {
+    g_system.RequestPrecompileGraphics(desc, priority);
 }
 
 void RequestPrecompile(const ComputePipelineDesc& desc) {
@@ -587,6 +1148,14 @@ void ClearCache() {
     g_system.ClearAll();
 }
 
+uint32_t TrimCache(uint32_t max_pipelines) {
+    return g_system.Trim(max_pipelines);
+}
+
+void GetMemoryUsage(uint64_t* used_bytes, uint64_t* reclaimable_bytes) {
+    g_system.GetMemoryUsage(used_bytes, reclaimable_bytes);
+}
+
 bool SaveCacheToDisk(const char* path) {
     return g_system.SaveCache(path);
 }
@@ -599,6 +1168,15 @@ void SetCompileCallback(CompileCallback callback) {
     g_system.compile_callback = std::move(callback);
 }
 
+void SetRendererStatsProvider(RendererStatsProvider provider) {
+    std::lock_guard<std::mutex> lock(g_system.cache_mutex);
+    g_system.renderer_stats_provider = std::move(provider);
+}
+
+void SetPipelineMissObserver(PipelineMissObserver observer) {
+    g_system.miss_observer.store(observer, std::memory_order_release);
+}
+
 void Update() {
     g_system.Update();
 }
@@ -607,6 +1185,14 @@ void GetStats(PipelineCacheStats* stats) {
     if (stats) {
         std::lock_guard<std::mutex> lock(g_system.cache_mutex);
         *stats = g_system.stats;
+        stats->cache_hits = g_system.cache_hits.load(std::memory_order_relaxed);
+        stats->cache_misses = g_system.cache_misses.load(std::memory_order_relaxed);
+        stats->pending_compilations = g_pending_compilations.load();
+        const uint64_t total = stats->cache_hits + stats->cache_misses;
+        stats->cache_hit_ratio = total ? static_cast<float>(stats->cache_hits) / total : 0.0f;
+        if (g_system.renderer_stats_provider) {
+            g_system.renderer_stats_provider(stats);
+        }
     }
 }
 
@@ -615,6 +1201,7 @@ void ResetStats() {
     auto pipelines = g_system.stats.pipelines_in_cache;
     g_system.stats = {};
     g_system.stats.pipelines_in_cache = pipelines;
+    g_system.ResetCounters();
 }
 
 void SetConfig(const PipelineCacheConfig& config) {
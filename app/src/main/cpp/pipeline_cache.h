@@ -70,6 +70,13 @@ struct PipelineCacheConfig {
     
     // Максимальний час компіляції (мс) перед timeout
     uint32_t compile_timeout_ms = 5000;
+    
+    // Запис унікальних GraphicsPipelineDesc у порядку першого використання
+    // (<cache_path>.replay) і replay при старті
+    bool record_pipeline_stream = true;
+    
+    // Потоки для replay при старті (0 = всі ядра), завершуються після черги
+    uint32_t prewarm_threads = 0;
 };
 
 /**
@@ -88,6 +95,20 @@ struct PipelineCacheStats {
     float cache_hit_ratio;                 // Відсоток попадань
     size_t cache_size_bytes;               // Розмір кешу в байтах
     size_t disk_cache_size_bytes;          // Розмір на диску
+    
+    // RSX draw path (async shader mode, заповнює renderer stats provider)
+    uint64_t interpreter_draws;            // Draws через shader interpreter, поки pipeline компілюється
+    uint64_t interpreter_swaps;            // Переходів interpreter -> специалізований pipeline
+    uint64_t skipped_draws;                // Пропущених draws (програма не готова)
+    
+    // VK_EXT_pipeline_creation_cache_control (проба з FAIL_ON_PIPELINE_COMPILE_REQUIRED)
+    uint64_t driver_cache_hits;            // Pipelines з кешу драйвера, використані одразу
+    uint64_t driver_cache_misses;          // Потребували компіляції - передані async workers
+    
+    // VK_EXT_graphics_pipeline_library
+    uint64_t library_parts_created;        // Скомпільованих частин (VI / pre-raster / FS / output)
+    uint64_t library_part_hits;            // Частин, взятих з кешу при link
+    uint64_t library_links;                // Pipelines, зібраних з частин
 };
 
 /**
@@ -207,8 +228,9 @@ void* GetVkPipeline(PipelineHandle handle);
 
 /**
  * Запит на попередню компіляцію pipeline
+ * priority: більше - раніше (replay > 1.0, ручні запити 0.5)
  */
-void RequestPrecompile(const GraphicsPipelineDesc& desc);
+void RequestPrecompile(const GraphicsPipelineDesc& desc, float priority = 0.5f);
 void RequestPrecompile(const ComputePipelineDesc& desc);
 
 /**
@@ -243,12 +265,25 @@ void FlushCompilations();
 void ClearCache();
 
 /**
- * Збереження кешу на диск
+ * Витіснення найдавніше використаних pipelines до max_pipelines
+ * (знищення після grace period, як і звичайний eviction); повертає кількість
+ */
+uint32_t TrimCache(uint32_t max_pipelines);
+
+/**
+ * Облік для memory budget: SPIR-V модулі + оцінка kEstimatedPipelineBytes на pipeline
+ */
+constexpr uint64_t kEstimatedPipelineBytes = 64 * 1024;  // Код шейдерів і стан у драйвері
+void GetMemoryUsage(uint64_t* used_bytes, uint64_t* reclaimable_bytes);
+
+/**
+ * Збереження кешу на диск (разом із записаним потоком дескрипторів)
  */
 bool SaveCacheToDisk(const char* path = nullptr);
 
 /**
- * Завантаження кешу з диску
+ * Завантаження кешу з диску; записані дескриптори ставляться в чергу
+ * precompile у порядку першого використання
  */
 bool LoadCacheFromDisk(const char* path = nullptr);
 
@@ -258,6 +293,19 @@ bool LoadCacheFromDisk(const char* path = nullptr);
 using CompileCallback = std::function<void(PipelineHandle handle, bool success)>;
 void SetCompileCallback(CompileCallback callback);
 
+/**
+ * Джерело лічильників draw path рендерера (librpcsx); викликається з GetStats
+ */
+using RendererStatsProvider = std::function<void(PipelineCacheStats* stats)>;
+void SetRendererStatsProvider(RendererStatsProvider provider);
+
+/**
+ * Спостерігач graphics pipeline miss; викликається з draw-call шляху,
+ * тож має лише записати подію. nullptr - вимкнути
+ */
+using PipelineMissObserver = void (*)(const GraphicsPipelineDesc& desc);
+void SetPipelineMissObserver(PipelineMissObserver observer);
+
 /**
  * Оновлення системи (викликати кожен кадр для background compilation)
  */
@@ -10,6 +10,7 @@
 
 #include "ppu_interceptor.h"
 #include "plt_hook.h"
+#include "signal_handler.h"
 #include "nce_jit/jit_compiler.h"
 #include "nce_jit/ppc_decoder.h"
 
@@ -34,6 +35,10 @@ std::unique_ptr<nce::JitCompiler> g_jit;
 nce::PPCState g_ppu_state;
 std::mutex g_jit_mutex;
 
+bool HandleJITFastmemFault(void* fault_addr, void* ucontext) {
+    return g_jit && g_jit->HandleFastmemFault(fault_addr, ucontext);
+}
+
 // ===== Statistics =====
 std::atomic<uint64_t> g_blocks_executed{0};
 std::atomic<uint64_t> g_blocks_jitted{0};
@@ -88,6 +93,7 @@ bool InitializeJIT() {
     }
     
     memset(&g_ppu_state, 0, sizeof(g_ppu_state));
+    crash::AddFastmemFaultHandler(HandleJITFastmemFault);
     
     LOGI("NCE JIT compiler initialized successfully!");
     return true;
@@ -95,6 +101,7 @@ bool InitializeJIT() {
 
 void ShutdownJIT() {
     if (g_jit) {
+        crash::RemoveFastmemFaultHandler(HandleJITFastmemFault);
         g_jit->Shutdown();
         g_jit.reset();
     }
@@ -381,7 +388,7 @@ void InvalidateBlock(uint32_t pc) {
 
 void InvalidateRange(uint32_t start, uint32_t size) {
     if (g_jit) {
-        g_jit->InvalidateRange(start, size);
+        g_jit->InvalidateRange(start, static_cast<uint64_t>(start) + size);
     }
     
     {
@@ -0,0 +1,486 @@
+/**
+ * Per-title Profile Auto-Tuning Implementation
+ */
+
+#include "profile_autotune.h"
+#include <android/log.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#define LOG_TAG "RPCSX-AutoTune"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace rpcsx::profiles {
+
+// =============================================================================
+// Сітка кандидатів
+// =============================================================================
+
+enum class Axis : uint8_t {
+    SpuBlockSize,                     // Tier SPU JIT
+    ShaderMode,                       // Async pipelines з interpreter чи синхронна компіляція
+    SpuThreads,                       // Max SPURS Threads
+    DrsScale,                         // Верхня межа DRS
+};
+
+struct AxisDesc {
+    Axis axis;
+    const char* name;
+    bool requires_restart;
+    bool cpu;                         // Без сенсу для RSX захоплення
+    uint32_t value_count;
+};
+
+// Осі з перезапуском першими: далі кандидати відрізняються лише на ходу
+static constexpr AxisDesc kAxes[] = {
+    {Axis::SpuBlockSize, "spu_block_size", true, true, 3},
+    {Axis::ShaderMode, "shader_mode", true, false, 2},
+    {Axis::SpuThreads, "spu_threads", false, true, 3},
+    {Axis::DrsScale, "drs_scale", false, false, 3},
+};
+
+static constexpr uint32_t kSpuThreadValues[] = {6, 5, 4};
+static constexpr float kDrsScaleValues[] = {1.0f, 0.85f, 0.75f};
+
+static void SetAxisValue(GameProfile& profile, Axis axis, uint32_t index) {
+    switch (axis) {
+        case Axis::SpuBlockSize:
+            profile.cpu.spu_block_size = static_cast<SPUBlockSize>(index);
+            break;
+        case Axis::ShaderMode:
+            profile.gpu.async_shader_compile = index == 0;
+            break;
+        case Axis::SpuThreads:
+            profile.hacks.max_spu_threads = kSpuThreadValues[index];
+            profile.hacks.limit_spu_threads = kSpuThreadValues[index] < 6;
+            break;
+        case Axis::DrsScale:
+            profile.gpu.enable_drs = true;
+            profile.gpu.drs_max_scale = kDrsScaleValues[index];
+            break;
+    }
+}
+
+static uint32_t SpuThreadLimit(const GameProfile& profile) {
+    return profile.hacks.limit_spu_threads ? profile.hacks.max_spu_threads : 6;
+}
+
+static bool SameAxisValue(const GameProfile& a, const GameProfile& b, Axis axis) {
+    switch (axis) {
+        case Axis::SpuBlockSize: return a.cpu.spu_block_size == b.cpu.spu_block_size;
+        case Axis::ShaderMode: return a.gpu.async_shader_compile == b.gpu.async_shader_compile;
+        case Axis::SpuThreads: return SpuThreadLimit(a) == SpuThreadLimit(b);
+        case Axis::DrsScale:
+            return a.gpu.enable_drs == b.gpu.enable_drs &&
+                   std::fabs(a.gpu.drs_max_scale - b.gpu.drs_max_scale) < 0.001f;
+    }
+    return true;
+}
+
+static bool NeedsRestart(const GameProfile& from, const GameProfile& to) {
+    for (const AxisDesc& desc : kAxes) {
+        if (desc.requires_restart && !SameAxisValue(from, to, desc.axis)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Чим більше, тим вища якість картинки
+static float Quality(const GameProfile& profile) {
+    return profile.gpu.enable_drs ? profile.gpu.drs_max_scale : profile.gpu.resolution_scale;
+}
+
+// =============================================================================
+// Сесія
+// =============================================================================
+
+struct Trial {
+    GameProfile profile;
+    int axis;                         // -1 для базового профілю
+    uint32_t frames;
+    float avg_ms;
+    float p50_ms;
+    float p95_ms;
+    float p99_ms;
+};
+
+struct Session {
+    AutoTuneConfig config;
+    std::string title_id;
+    float budget_ms = 0.0f;
+
+    GameProfile base;
+    GameProfile basis;                // Найкращий на початку поточної осі
+    GameProfile applied;              // Що зараз застосовано до емулятора
+    std::vector<Trial> trials;        // Останній - поточний прогін
+
+    size_t axis = 0;
+    uint32_t value = 0;
+    bool axes_started = false;
+
+    uint32_t warmup_seen = 0;
+    std::vector<float> frame_times;
+
+    std::optional<GameProfile> apply_on_boot;
+    int best = -1;
+};
+
+static std::mutex g_mutex;
+static Session g_session;
+static AutoTuneApplyCallback g_apply;
+static std::atomic<AutoTuneState> g_state{AutoTuneState::Idle};
+
+static const char* StateName(AutoTuneState state) {
+    switch (state) {
+        case AutoTuneState::Idle: return "idle";
+        case AutoTuneState::Warmup: return "warmup";
+        case AutoTuneState::Measuring: return "measuring";
+        case AutoTuneState::AwaitingRestart: return "awaiting_restart";
+        case AutoTuneState::Finished: return "finished";
+        case AutoTuneState::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+static bool AxisEnabled(const Session& session, const AxisDesc& desc) {
+    return !(desc.cpu && session.config.source == AutoTuneSource::RsxCapture);
+}
+
+// a краще за b
+static bool IsBetter(const Trial& a, const Trial& b, float budget_ms, float tolerance) {
+    const float limit = budget_ms * tolerance;
+    const bool a_fits = a.p95_ms <= limit;
+    const bool b_fits = b.p95_ms <= limit;
+    if (a_fits != b_fits) {
+        return a_fits;
+    }
+
+    // Обидва тримають бюджет - зниження масштабу нічого не дає
+    if (a_fits) {
+        const float qa = Quality(a.profile);
+        const float qb = Quality(b.profile);
+        if (std::fabs(qa - qb) > 0.01f) {
+            return qa > qb;
+        }
+    }
+
+    return a.p99_ms < b.p99_ms;
+}
+
+static int SelectBest(const Session& session) {
+    int best = -1;
+    for (size_t i = 0; i < session.trials.size(); i++) {
+        const Trial& trial = session.trials[i];
+        if (!trial.frames) {
+            continue;
+        }
+        if (best < 0 || IsBetter(trial, session.trials[best], session.budget_ms,
+                                 session.config.budget_tolerance)) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+// Наступний кандидат покоординатного пошуку; false - сітку пройдено
+static bool NextCandidate(Session& session, GameProfile* candidate, int* axis_index) {
+    if (!session.axes_started) {
+        session.axes_started = true;
+        session.axis = 0;
+        session.value = 0;
+        session.basis = session.trials[SelectBest(session)].profile;
+    }
+
+    while (session.axis < std::size(kAxes)) {
+        const AxisDesc& desc = kAxes[session.axis];
+
+        if (!AxisEnabled(session, desc) || session.value >= desc.value_count) {
+            session.axis++;
+            session.value = 0;
+            const int best = SelectBest(session);
+            if (best >= 0) {
+                session.basis = session.trials[best].profile;
+            }
+            continue;
+        }
+
+        GameProfile next = session.basis;
+        SetAxisValue(next, desc.axis, session.value++);
+        if (SameAxisValue(next, session.basis, desc.axis)) {
+            // Уже виміряно як basis
+            continue;
+        }
+
+        *candidate = next;
+        *axis_index = static_cast<int>(session.axis);
+        return true;
+    }
+
+    return false;
+}
+
+using PendingApply = std::optional<std::pair<GameProfile, bool>>;
+
+static PendingApply BeginTrial(Session& session, const GameProfile& candidate, int axis) {
+    session.trials.push_back({candidate, axis, 0, 0.0f, 0.0f, 0.0f, 0.0f});
+    session.warmup_seen = 0;
+    session.frame_times.clear();
+
+    if (NeedsRestart(session.applied, candidate)) {
+        session.apply_on_boot = candidate;
+        g_state.store(AutoTuneState::AwaitingRestart, std::memory_order_relaxed);
+        LOGI("Trial %zu (%s) needs a segment restart", session.trials.size() - 1,
+             axis >= 0 ? kAxes[axis].name : "base");
+        return std::nullopt;
+    }
+
+    session.applied = candidate;
+    g_state.store(AutoTuneState::Warmup, std::memory_order_relaxed);
+    return std::make_pair(candidate, false);
+}
+
+// Фінальний профіль: на ходу те, що можна, решта при наступному boot
+static PendingApply ApplyFinal(Session& session, const GameProfile& profile) {
+    if (NeedsRestart(session.applied, profile)) {
+        session.apply_on_boot = profile;
+    }
+    session.applied = profile;
+    return std::make_pair(profile, false);
+}
+
+static PendingApply FinishSession(Session& session) {
+    session.best = SelectBest(session);
+    if (session.best < 0) {
+        g_state.store(AutoTuneState::Cancelled, std::memory_order_relaxed);
+        return ApplyFinal(session, session.base);
+    }
+
+    GameProfile best = session.trials[session.best].profile;
+    snprintf(best.profile_name, sizeof(best.profile_name), "Auto-tuned");
+
+    if (!UpdateProfile(session.title_id.c_str(), best)) {
+        LOGW("Failed to store auto-tuned profile for %s", session.title_id.c_str());
+    }
+
+    const Trial& trial = session.trials[session.best];
+    LOGI("Auto-tune %s finished after %zu trials: best #%d p50 %.2f p95 %.2f p99 %.2f ms "
+         "(budget %.2f ms)", session.title_id.c_str(), session.trials.size(), session.best,
+         trial.p50_ms, trial.p95_ms, trial.p99_ms, session.budget_ms);
+
+    g_state.store(AutoTuneState::Finished, std::memory_order_relaxed);
+    return ApplyFinal(session, best);
+}
+
+static float Percentile(const std::vector<float>& sorted, float p) {
+    const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[index];
+}
+
+static void CompleteTrial(Session& session) {
+    Trial& trial = session.trials.back();
+    std::vector<float>& times = session.frame_times;
+    std::sort(times.begin(), times.end());
+
+    double sum = 0.0;
+    for (float t : times) {
+        sum += t;
+    }
+
+    trial.frames = static_cast<uint32_t>(times.size());
+    trial.avg_ms = static_cast<float>(sum / times.size());
+    trial.p50_ms = Percentile(times, 0.50f);
+    trial.p95_ms = Percentile(times, 0.95f);
+    trial.p99_ms = Percentile(times, 0.99f);
+
+    LOGI("Trial %zu (%s): avg %.2f p50 %.2f p95 %.2f p99 %.2f ms",
+         session.trials.size() - 1, trial.axis >= 0 ? kAxes[trial.axis].name : "base",
+         trial.avg_ms, trial.p50_ms, trial.p95_ms, trial.p99_ms);
+}
+
+static void RunApply(const PendingApply& pending) {
+    if (!pending) {
+        return;
+    }
+
+    // Поза lock сесії: settingsSet зберігає конфіг на диск
+    AutoTuneApplyCallback apply;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        apply = g_apply;
+    }
+    if (apply) {
+        apply(pending->first, pending->second);
+    }
+}
+
+// =============================================================================
+// API
+// =============================================================================
+
+void SetAutoTuneApplyCallback(AutoTuneApplyCallback callback) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_apply = std::move(callback);
+}
+
+bool StartAutoTune(const char* title_id, const AutoTuneConfig& config) {
+    if (!IsValidTitleId(title_id) || !config.measure_frames) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    const AutoTuneState state = g_state.load(std::memory_order_relaxed);
+    if (state == AutoTuneState::Warmup || state == AutoTuneState::Measuring ||
+        state == AutoTuneState::AwaitingRestart) {
+        LOGW("Auto-tune for %s is already running", g_session.title_id.c_str());
+        return false;
+    }
+
+    const GameProfile* current = GetProfileForGame(title_id);
+    if (!current) {
+        return false;
+    }
+
+    Session& session = g_session;
+    session = Session{};
+    session.config = config;
+    session.title_id = title_id;
+    session.base = *current;
+    snprintf(session.base.title_id, sizeof(session.base.title_id), "%s", title_id);
+    session.budget_ms = 1000.0f / std::max<uint32_t>(session.base.target_fps, 1);
+    session.frame_times.reserve(config.measure_frames);
+
+    // Базовий прогін з boot сегмента: невідомо, що зараз у конфігу емулятора
+    session.trials.push_back({session.base, -1, 0, 0.0f, 0.0f, 0.0f, 0.0f});
+    session.apply_on_boot = session.base;
+    g_state.store(AutoTuneState::AwaitingRestart, std::memory_order_relaxed);
+
+    LOGI("Auto-tune %s: %s, %u warmup + %u measured frames, budget %.2f ms", title_id,
+         config.source == AutoTuneSource::RsxCapture ? "RSX capture" : "live segment",
+         config.warmup_frames, config.measure_frames, session.budget_ms);
+    return true;
+}
+
+void CancelAutoTune() {
+    PendingApply pending;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        const AutoTuneState state = g_state.load(std::memory_order_relaxed);
+        if (state != AutoTuneState::Warmup && state != AutoTuneState::Measuring &&
+            state != AutoTuneState::AwaitingRestart) {
+            return;
+        }
+
+        g_state.store(AutoTuneState::Cancelled, std::memory_order_relaxed);
+        g_session.apply_on_boot.reset();
+        pending = ApplyFinal(g_session, g_session.base);
+        LOGI("Auto-tune %s cancelled", g_session.title_id.c_str());
+    }
+    RunApply(pending);
+}
+
+void OnAutoTuneFrame(float frame_time_ms) {
+    const AutoTuneState state = g_state.load(std::memory_order_relaxed);
+    if (state != AutoTuneState::Warmup && state != AutoTuneState::Measuring) {
+        return;
+    }
+
+    PendingApply pending;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        Session& session = g_session;
+
+        switch (g_state.load(std::memory_order_relaxed)) {
+            case AutoTuneState::Warmup:
+                if (++session.warmup_seen >= session.config.warmup_frames) {
+                    g_state.store(AutoTuneState::Measuring, std::memory_order_relaxed);
+                }
+                return;
+            case AutoTuneState::Measuring:
+                break;
+            default:
+                return;
+        }
+
+        session.frame_times.push_back(frame_time_ms);
+        if (session.frame_times.size() < session.config.measure_frames) {
+            return;
+        }
+
+        CompleteTrial(session);
+
+        GameProfile candidate;
+        int axis = -1;
+        pending = NextCandidate(session, &candidate, &axis) ? BeginTrial(session, candidate, axis)
+                                                            : FinishSession(session);
+    }
+    RunApply(pending);
+}
+
+void OnAutoTuneBoot() {
+    PendingApply pending;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        Session& session = g_session;
+        if (!session.apply_on_boot) {
+            return;
+        }
+
+        pending = std::make_pair(*session.apply_on_boot, true);
+        session.applied = *session.apply_on_boot;
+        session.apply_on_boot.reset();
+
+        if (g_state.load(std::memory_order_relaxed) == AutoTuneState::AwaitingRestart) {
+            g_state.store(AutoTuneState::Warmup, std::memory_order_relaxed);
+        }
+    }
+    RunApply(pending);
+}
+
+AutoTuneState GetAutoTuneState() {
+    return g_state.load(std::memory_order_relaxed);
+}
+
+std::string ExportAutoTuneReportJson() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    const Session& session = g_session;
+
+    std::string json;
+    char buffer[512];
+
+    snprintf(buffer, sizeof(buffer),
+             "{\"title_id\":\"%s\",\"state\":\"%s\",\"source\":\"%s\",\"budget_ms\":%.3f,"
+             "\"best\":%d,\"trials\":[",
+             session.title_id.c_str(), StateName(g_state.load(std::memory_order_relaxed)),
+             session.config.source == AutoTuneSource::RsxCapture ? "rsx_capture" : "live",
+             session.budget_ms, session.best);
+    json += buffer;
+
+    for (size_t i = 0; i < session.trials.size(); i++) {
+        const Trial& trial = session.trials[i];
+        snprintf(buffer, sizeof(buffer),
+                 "%s{\"axis\":\"%s\",\"spu_block_size\":%d,\"async_shader_compile\":%s,"
+                 "\"max_spu_threads\":%u,\"drs\":%s,\"drs_max_scale\":%.2f,\"frames\":%u,"
+                 "\"avg_ms\":%.3f,\"p50_ms\":%.3f,\"p95_ms\":%.3f,\"p99_ms\":%.3f}",
+                 i ? "," : "", trial.axis >= 0 ? kAxes[trial.axis].name : "base",
+                 static_cast<int>(trial.profile.cpu.spu_block_size),
+                 trial.profile.gpu.async_shader_compile ? "true" : "false",
+                 SpuThreadLimit(trial.profile), trial.profile.gpu.enable_drs ? "true" : "false",
+                 trial.profile.gpu.drs_max_scale, trial.frames, trial.avg_ms, trial.p50_ms,
+                 trial.p95_ms, trial.p99_ms);
+        json += buffer;
+    }
+
+    json += "]}";
+    return json;
+}
+
+} // namespace rpcsx::profiles
@@ -0,0 +1,94 @@
+/**
+ * Per-title Profile Auto-Tuning
+ *
+ * Автоматичний підбір налаштувань профілю гри замість ручного: той самий
+ * сегмент (RSX захоплення .rrc або фіксований відрізок гри) проганяється з
+ * кандидатами з сітки налаштувань, для кожного міряються перцентилі часу
+ * кадру, найкращий кандидат записується через UpdateProfile.
+ *
+ * Особливості:
+ * - Покоординатний пошук по сітці: вісь за віссю від поточного найкращого,
+ *   замість повного перебору (8-9 прогонів замість 54)
+ * - Осі, що потребують перезапуску (SPU block size, shader mode), йдуть
+ *   першими; фронтенд перезавантажує сегмент у стані AwaitingRestart
+ * - Для RSX захоплення CPU осі не мають сенсу (PPU/SPU не виконуються)
+ * - Вибір: кандидати, що тримають бюджет кадру за p95, ранжуються за якістю
+ *   (масштаб DRS), далі за p99; якщо бюджет не тримає ніхто - мінімальний p99
+ */
+
+#ifndef RPCSX_PROFILE_AUTOTUNE_H
+#define RPCSX_PROFILE_AUTOTUNE_H
+
+#include "game_profiles.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace rpcsx::profiles {
+
+/**
+ * Що відтворюється під час прогонів
+ */
+enum class AutoTuneSource : uint8_t {
+    LiveSegment = 0,                  // Відрізок гри (демо-режим, вбудований бенчмарк)
+    RsxCapture = 1,                   // Циклічне відтворення .rrc, лише GPU осі
+};
+
+enum class AutoTuneState : uint8_t {
+    Idle = 0,
+    Warmup,                           // Кадри після застосування кандидата відкидаються
+    Measuring,
+    AwaitingRestart,                  // Кандидат змінює налаштування, що діють лише з boot
+    Finished,
+    Cancelled,
+};
+
+struct AutoTuneConfig {
+    AutoTuneSource source = AutoTuneSource::LiveSegment;
+    uint32_t warmup_frames = 120;     // Компіляція shaders і pipelines після зміни
+    uint32_t measure_frames = 600;
+    float budget_tolerance = 1.05f;   // p95 <= бюджет кадру * tolerance
+};
+
+/**
+ * Застосувати кандидата. stopped = true - емулятор зупинений (перед boot),
+ * можна змінювати й ті налаштування, що не діють на ходу
+ */
+using AutoTuneApplyCallback = std::function<void(const GameProfile& candidate, bool stopped)>;
+
+/**
+ * Як застосовувати кандидатів (native-lib: settingsSet, DRS)
+ */
+void SetAutoTuneApplyCallback(AutoTuneApplyCallback callback);
+
+/**
+ * Почати підбір для гри; базові налаштування - поточний профіль гри.
+ * Перший прогін - базовий профіль, тож далі фронтенд робить boot сегмента
+ */
+bool StartAutoTune(const char* title_id, const AutoTuneConfig& config);
+
+/**
+ * Зупинити без запису профілю; базовий профіль застосовується знову
+ */
+void CancelAutoTune();
+
+/**
+ * Викликати на межі present з часом кадру
+ */
+void OnAutoTuneFrame(float frame_time_ms);
+
+/**
+ * Викликати перед boot сегмента: застосовує кандидата, що чекав перезапуску
+ */
+void OnAutoTuneBoot();
+
+AutoTuneState GetAutoTuneState();
+
+/**
+ * Прогони з перцентилями і вибраний кандидат у JSON
+ */
+std::string ExportAutoTuneReportJson();
+
+} // namespace rpcsx::profiles
+
+#endif // RPCSX_PROFILE_AUTOTUNE_H
@@ -15,11 +15,25 @@ Java_net_rpcsx_nbtc_NbtcBridge_initialize(JNIEnv* env, jclass, jstring modelPath
     return ok ? JNI_TRUE : JNI_FALSE;
 }
 
+extern "C" JNIEXPORT void JNICALL
+Java_net_rpcsx_nbtc_NbtcBridge_setCacheLocation(JNIEnv* env, jclass, jstring cacheDir, jstring buildId) {
+    const char* dir = env->GetStringUTFChars(cacheDir, nullptr);
+    const char* build = env->GetStringUTFChars(buildId, nullptr);
+    nbtc::SetCacheLocation(dir, build);
+    env->ReleaseStringUTFChars(buildId, build);
+    env->ReleaseStringUTFChars(cacheDir, dir);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_net_rpcsx_nbtc_NbtcBridge_setDeviceCharging(JNIEnv* env, jclass, jboolean charging) {
+    nbtc::SetDeviceCharging(charging == JNI_TRUE);
+}
+
 extern "C" JNIEXPORT jboolean JNICALL
-Java_net_rpcsx_nbtc_NbtcBridge_analyzeAndCache(JNIEnv* env, jclass, jstring gamePath) {
-    const char* path = env->GetStringUTFChars(gamePath, nullptr);
-    bool ok = nbtc::AnalyzeAndCache(path);
-    env->ReleaseStringUTFChars(gamePath, path);
+Java_net_rpcsx_nbtc_NbtcBridge_analyzeAndCache(JNIEnv* env, jclass, jstring gameId) {
+    const char* id = env->GetStringUTFChars(gameId, nullptr);
+    bool ok = nbtc::AnalyzeAndCache(id);
+    env->ReleaseStringUTFChars(gameId, id);
     return ok ? JNI_TRUE : JNI_FALSE;
 }
 
@@ -1,9 +1,14 @@
 #include "Crypto/unpkg.h"
+#include "Crypto/sha1.h"
 #include "Crypto/unself.h"
+#include "Emu/Audio/AAudio/AAudioBackend.h"
 #include "Emu/Audio/Cubeb/CubebBackend.h"
 #include "Emu/Audio/Null/NullAudioBackend.h"
 #include "Emu/Cell/PPUAnalyser.h"
+#include "Emu/Cell/PPUThread.h"
 #include "Emu/Cell/SPURecompiler.h"
+#include "Emu/Cell/SPUThread.h"
+#include "Emu/Cell/timers.hpp"
 #include "Emu/IdManager.h"
 #include "Emu/Io/KeyboardHandler.h"
 #include "Emu/Io/Null/NullKeyboardHandler.h"
@@ -12,6 +17,8 @@
 #include "Emu/Io/Null/null_camera_handler.h"
 #include "Emu/Io/Null/null_music_handler.h"
 #include "Emu/Io/pad_config_types.h"
+#include "Emu/Memory/vm.h"
+#include "Emu/RSX/Capture/rsx_replay.h"
 #include "Emu/RSX/Null/NullGSRender.h"
 #include "Emu/RSX/Overlays/overlay_manager.h"
 #include "Emu/RSX/Overlays/overlay_save_dialog.h"
@@ -19,6 +26,7 @@
 #include "Emu/RSX/RSXThread.h"
 #include "Emu/RSX/VK/VKGSRender.h"
 #include "Emu/localized_string_id.h"
+#include "Emu/perf_monitor.hpp"
 #include "Emu/system_config.h"
 #include "Emu/system_config_types.h"
 #include "Emu/system_progress.hpp"
@@ -35,14 +43,17 @@
 #include "Loader/TAR.h"
 #include "cellos/sys_sync.h"
 #include "dev/block_dev.hpp"
+#include "dev/dirfd_dev.hpp"
 #include "dev/iso.hpp"
 #include "hidapi_libusb.h"
 #include "libusb.h"
 #include "rpcs3_version.h"
 #include "rpcsx/fw/ps3/cellMsgDialog.h"
 #include "rpcsx/fw/ps3/cellSysutil.h"
+#include "rpcsx/fw/ps3/StaticHLE.h"
 #include "rx/asm.hpp"
 #include "rx/debug.hpp"
+#include "rx/SharedAtomic.hpp"
 #include "util/File.h"
 #include "util/JIT.h"
 #include "util/StrFmt.h"
@@ -73,11 +84,15 @@
 #include <functional>
 #include <iterator>
 #include <jni.h>
+#include <mutex>
 #include <optional>
+#include <pthread.h>
 #include <span>
 #include <string>
 #include <sys/resource.h>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #pragma GCC diagnostic push
@@ -520,6 +535,7 @@ static std::pair<std::string, std::u32string> g_strings[] = {
     MAKE_STRING(HOME_MENU_SAVESTATE_AND_EXIT, "Save Emulation State And Exit"),
     MAKE_STRING(HOME_MENU_RELOAD_SAVESTATE, "Reload Last Emulation State"),
     MAKE_STRING(HOME_MENU_RECORDING, "Start/Stop Recording"),
+    MAKE_STRING(HOME_MENU_PROFILER_REPORT, "Save Profiler Report"),
     MAKE_STRING(HOME_MENU_TROPHIES, "Trophies"),
     MAKE_STRING(HOME_MENU_TROPHY_HIDDEN_TITLE, "Hidden trophy"),
     MAKE_STRING(HOME_MENU_TROPHY_HIDDEN_DESCRIPTION, "This trophy is hidden"),
@@ -704,46 +720,6 @@ static bool tryUnlockGame(const psf::registry &psf) {
   return false;
 }
 
-static void collectGamePaths(std::vector<std::string> &paths,
-                             const std::string &rootDir) {
-  std::error_code ec;
-  std::vector<std::filesystem::path> workList;
-  workList.reserve(32);
-  if (!std::filesystem::is_directory(rootDir)) {
-    auto rootPath = std::filesystem::path(rootDir).parent_path();
-    if (rootPath.filename() == "USRDIR") {
-      rootPath = rootPath.parent_path();
-    }
-    if (rootPath.filename() == "PS3_GAME") {
-      rootPath = rootPath.parent_path();
-    }
-
-    workList.push_back(rootPath);
-  } else {
-    workList.push_back(rootDir);
-  }
-
-  while (!workList.empty()) {
-    auto dir = std::move(workList.back());
-    workList.pop_back();
-
-    for (auto &entry : std::filesystem::directory_iterator(dir, ec)) {
-      if (entry.is_directory()) {
-        if (entry.path().filename() != "C00") {
-          workList.push_back(entry.path());
-        }
-
-        continue;
-      }
-
-      if (entry.is_regular_file() && entry.path().filename() == "PARAM.SFO") {
-        paths.push_back(entry.path().parent_path().string());
-        continue;
-      }
-    }
-  }
-}
-
 static std::string locateEbootPath(std::string_view root) {
   if (std::filesystem::is_regular_file(root)) {
     return std::string(root);
@@ -880,23 +856,376 @@ fetchGameInfo(const psf::registry &psf,
   };
 }
 
-static void collectGameInfo(JNIEnv *env, jlong progressId,
-                            const std::vector<std::string> &rootDirs) {
-  std::vector<std::string> paths;
-  for (auto &&rootDir : rootDirs) {
-    collectGamePaths(paths, rootDir);
+// Game list entries of previous scans, keyed by the PARAM.SFO directory. An
+// entry is reused while PARAM.SFO, EBOOT.BIN and the license directory are
+// unchanged, so only new or updated games are parsed and decrypted again.
+// Directory listings of the walk are kept too and reused while the
+// directory's mtime is unchanged
+class GameListIndex {
+  static constexpr int kVersion = 2;
+
+  struct Stamp {
+    u64 size = 0;
+    s64 mtime = -1; // -1 if the file does not exist
+
+    static Stamp of(const std::string &path) {
+      fs::stat_t info{};
+      if (path.empty() || !fs::get_stat(path, info)) {
+        return {};
+      }
 
-    rpcsx_android.notice("collectGameInfo: processed %s", rootDir);
+      return {.size = info.size, .mtime = info.mtime};
+    }
+
+    bool operator==(const Stamp &) const = default;
+  };
+
+  struct Entry {
+    Stamp sfo;
+    Stamp eboot;
+    Stamp license;
+    std::string ebootPath;
+    bool hasC00 = false;
+    std::optional<GameInfo> info; // Not a bootable game if empty
+    bool seen = false;
+  };
+
+  struct DirEntry {
+    s64 mtime = -1;
+    std::vector<std::string> subDirs;
+    bool hasSfo = false;
+    bool seen = false;
+  };
+
+  std::mutex mutex;
+  std::unordered_map<std::string, Entry> entries;
+  std::unordered_map<std::string, DirEntry> dirs;
+  bool loaded = false;
+  bool dirty = false;
+
+  static std::string getIndexPath() {
+    return fs::get_cache_dir() + "game_list.json";
+  }
+
+  static std::string getLicenseDir() {
+    return fmt::format("%shome/%s/exdata/", rpcs3::utils::get_hdd0_dir(),
+                       Emu.GetUsr());
+  }
+
+  static std::string getEbootPath(const GameInfo &info) {
+    return info.path.starts_with(rpcs3::utils::get_hdd0_dir())
+               ? locateEbootPath(info.path)
+               : std::string{};
+  }
+
+  void load() {
+    loaded = true;
+
+    fs::file file(getIndexPath());
+    if (!file) {
+      return;
+    }
+
+    try {
+      auto json = nlohmann::json::parse(file.to_string());
+      if (json.value("version", 0) != kVersion) {
+        return;
+      }
+
+      auto toStamp = [](const nlohmann::json &value) {
+        return Stamp{.size = value.at(0).get<u64>(),
+                     .mtime = value.at(1).get<s64>()};
+      };
+
+      for (auto &item : json.at("games")) {
+        Entry entry;
+        entry.sfo = toStamp(item.at("sfo"));
+        entry.eboot = toStamp(item.at("eboot"));
+        entry.license = toStamp(item.at("license"));
+        entry.ebootPath = item.at("ebootPath").get<std::string>();
+        entry.hasC00 = item.at("c00").get<bool>();
+
+        if (item.contains("path")) {
+          entry.info = GameInfo{
+              .path = item.at("path").get<std::string>(),
+              .name = item.at("name").get<std::string>(),
+              .iconPath = item.at("icon").get<std::string>(),
+              .flags = item.at("flags").get<int>(),
+          };
+        }
+
+        entries.insert_or_assign(item.at("dir").get<std::string>(),
+                                 std::move(entry));
+      }
+
+      for (auto &item : json.at("dirs")) {
+        DirEntry entry;
+        entry.mtime = item.at("mtime").get<s64>();
+        entry.subDirs = item.at("subDirs").get<std::vector<std::string>>();
+        entry.hasSfo = item.at("sfo").get<bool>();
+
+        dirs.insert_or_assign(item.at("dir").get<std::string>(),
+                              std::move(entry));
+      }
+    } catch (const std::exception &e) {
+      rpcsx_android.warning("game list index is broken: %s", e.what());
+      entries.clear();
+      dirs.clear();
+    }
+  }
+
+  static bool isUnder(const std::string &path,
+                      std::span<const std::string> rootDirs) {
+    return std::ranges::any_of(rootDirs, [&](const auto &rootDir) {
+      return path.starts_with(rootDir);
+    });
+  }
+
+public:
+  // Game directories of previous scans under the roots, to be validated with
+  // find() and shown before the walk
+  std::vector<std::string> knownGames(std::span<const std::string> rootDirs) {
+    std::lock_guard lock(mutex);
+
+    if (!loaded) {
+      load();
+    }
+
+    std::vector<std::string> result;
+    for (auto &[dir, entry] : entries) {
+      if (entry.info && isUnder(dir, rootDirs)) {
+        result.push_back(dir);
+      }
+    }
+
+    std::ranges::sort(result);
+    return result;
+  }
+
+  // Subdirectories of dir (C00 excluded) and whether it holds PARAM.SFO. A
+  // directory's mtime changes whenever an entry is added, removed or renamed
+  // in it, so a directory with an unchanged mtime is not read again
+  bool listDir(const std::string &dir, std::vector<std::string> &subDirs) {
+    const Stamp stamp = Stamp::of(dir);
+
+    {
+      std::lock_guard lock(mutex);
+
+      if (!loaded) {
+        load();
+      }
+
+      if (auto it = dirs.find(dir); it != dirs.end() && stamp.mtime != -1 &&
+                                    it->second.mtime == stamp.mtime) {
+        it->second.seen = true;
+        subDirs = it->second.subDirs;
+        return it->second.hasSfo;
+      }
+    }
+
+    DirEntry entry;
+    entry.mtime = stamp.mtime;
+    entry.seen = true;
+
+    std::error_code ec;
+    for (auto &item : std::filesystem::directory_iterator(dir, ec)) {
+      if (item.is_directory()) {
+        if (item.path().filename() != "C00") {
+          entry.subDirs.push_back(item.path().string());
+        }
+
+        continue;
+      }
+
+      if (item.is_regular_file() && item.path().filename() == "PARAM.SFO") {
+        entry.hasSfo = true;
+      }
+    }
+
+    subDirs = entry.subDirs;
+    const bool hasSfo = entry.hasSfo;
+
+    // mtime has a one second resolution: a directory that is still being
+    // written to could change again within the same second
+    const s64 now = std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+
+    std::lock_guard lock(mutex);
+    if (stamp.mtime != -1 && stamp.mtime < now - 1) {
+      dirs.insert_or_assign(dir, std::move(entry));
+      dirty = true;
+    } else {
+      dirs.erase(dir);
+    }
+
+    return hasSfo;
+  }
+
+  // Returns the game of the directory if the cached entry is still valid
+  std::optional<std::optional<GameInfo>> find(const std::string &dir) {
+    std::lock_guard lock(mutex);
+
+    if (!loaded) {
+      load();
+    }
+
+    auto it = entries.find(dir);
+    if (it == entries.end()) {
+      return {};
+    }
+
+    auto &entry = it->second;
+
+    if (entry.sfo != Stamp::of(dir + "/PARAM.SFO") ||
+        entry.eboot != Stamp::of(entry.ebootPath) ||
+        entry.license != Stamp::of(getLicenseDir()) ||
+        (entry.info &&
+         entry.hasC00 != fs::is_dir(entry.info->path + "/C00"))) {
+      return {};
+    }
+
+    entry.seen = true;
+    return entry.info;
+  }
+
+  void store(const std::string &dir, const std::optional<GameInfo> &info) {
+    Entry entry;
+    entry.sfo = Stamp::of(dir + "/PARAM.SFO");
+    entry.license = Stamp::of(getLicenseDir());
+    entry.info = info;
+    entry.seen = true;
+
+    if (info) {
+      entry.ebootPath = getEbootPath(*info);
+      entry.eboot = Stamp::of(entry.ebootPath);
+      entry.hasC00 = fs::is_dir(info->path + "/C00");
+    }
+
+    std::lock_guard lock(mutex);
+    entries.insert_or_assign(dir, std::move(entry));
+    dirty = true;
+  }
+
+  // Drops games under the scanned directories which were not found and
+  // writes the index if anything changed
+  void commit(std::span<const std::string> rootDirs) {
+    std::lock_guard lock(mutex);
+
+    dirty |= std::erase_if(entries, [&](const auto &pair) {
+               return !pair.second.seen && isUnder(pair.first, rootDirs);
+             }) != 0;
+
+    dirty |= std::erase_if(dirs, [&](const auto &pair) {
+               return !pair.second.seen && isUnder(pair.first, rootDirs);
+             }) != 0;
+
+    for (auto &[dir, entry] : entries) {
+      entry.seen = false;
+    }
+
+    for (auto &[dir, entry] : dirs) {
+      entry.seen = false;
+    }
+
+    if (!dirty) {
+      return;
+    }
+
+    auto fromStamp = [](const Stamp &stamp) {
+      return nlohmann::json::array({stamp.size, stamp.mtime});
+    };
+
+    auto games = nlohmann::json::array();
+
+    for (auto &[dir, entry] : entries) {
+      nlohmann::json item = {
+          {"dir", dir},
+          {"sfo", fromStamp(entry.sfo)},
+          {"eboot", fromStamp(entry.eboot)},
+          {"license", fromStamp(entry.license)},
+          {"ebootPath", entry.ebootPath},
+          {"c00", entry.hasC00},
+      };
+
+      if (entry.info) {
+        item["path"] = entry.info->path;
+        item["name"] = entry.info->name;
+        item["icon"] = entry.info->iconPath;
+        item["flags"] = entry.info->flags;
+      }
+
+      games.push_back(std::move(item));
+    }
+
+    auto dirList = nlohmann::json::array();
+
+    for (auto &[dir, entry] : dirs) {
+      dirList.push_back({
+          {"dir", dir},
+          {"mtime", entry.mtime},
+          {"subDirs", entry.subDirs},
+          {"sfo", entry.hasSfo},
+      });
+    }
+
+    const auto data = nlohmann::json{{"version", kVersion},
+                                     {"games", std::move(games)},
+                                     {"dirs", std::move(dirList)}}
+                          .dump();
+
+    fs::pending_file file(getIndexPath());
+    if (file.file && file.file.write(data.data(), data.size()) == data.size() &&
+        file.commit()) {
+      dirty = false;
+    } else {
+      rpcsx_android.error("failed to write game list index (%s)",
+                          fs::g_tls_error);
+    }
+  }
+} static g_gameListIndex;
+
+static void collectGamePaths(std::vector<std::string> &paths,
+                             const std::string &rootDir) {
+  std::vector<std::string> workList;
+  workList.reserve(32);
+  if (!std::filesystem::is_directory(rootDir)) {
+    auto rootPath = std::filesystem::path(rootDir).parent_path();
+    if (rootPath.filename() == "USRDIR") {
+      rootPath = rootPath.parent_path();
+    }
+    if (rootPath.filename() == "PS3_GAME") {
+      rootPath = rootPath.parent_path();
+    }
+
+    workList.push_back(rootPath.string());
+  } else {
+    workList.push_back(rootDir);
   }
 
-  rpcsx_android.notice("collectGameInfo: found %d paths", paths.size());
+  std::vector<std::string> subDirs;
 
+  while (!workList.empty()) {
+    auto dir = std::move(workList.back());
+    workList.pop_back();
+
+    // Game data directories (USRDIR, TROPDIR...) do not contain other games
+    if (g_gameListIndex.listDir(dir, subDirs)) {
+      paths.push_back(std::move(dir));
+    } else {
+      std::ranges::move(subDirs, std::back_inserter(workList));
+    }
+  }
+}
+
+static void collectGameInfo(JNIEnv *env, jlong progressId,
+                            const std::vector<std::string> &rootDirs) {
   Progress progress(env, progressId);
-  progress.report(0, paths.size());
 
   std::vector<GameInfo> gameInfos;
   gameInfos.reserve(10);
   std::size_t processed = 0;
+  std::size_t total = 0;
 
   auto submit = [&] {
     if (gameInfos.empty()) {
@@ -904,31 +1233,123 @@ static void collectGameInfo(JNIEnv *env, jlong progressId,
     }
 
     sendGameInfo(env, progressId, gameInfos);
-    progress.report(processed, paths.size());
+    progress.report(processed, total);
     gameInfos.clear();
   };
 
+  auto add = [&](GameInfo &&info) {
+    gameInfos.push_back(std::move(info));
+
+    if (gameInfos.size() >= 10) {
+      submit();
+    }
+  };
+
+  // Unchanged games of earlier scans go to the UI before the walk
+  std::unordered_set<std::string> shown;
+  for (auto &&path : g_gameListIndex.knownGames(rootDirs)) {
+    if (auto gameInfo = g_gameListIndex.find(path); gameInfo && *gameInfo) {
+      shown.insert(path);
+      add(std::move(**gameInfo));
+    }
+  }
+
+  submit();
+
+  std::vector<std::string> paths;
+  for (auto &&rootDir : rootDirs) {
+    collectGamePaths(paths, rootDir);
+
+    rpcsx_android.notice("collectGameInfo: processed %s", rootDir);
+  }
+
+  rpcsx_android.notice("collectGameInfo: found %d paths, %d already shown",
+                       paths.size(), shown.size());
+
+  total = paths.size();
+  processed = shown.size();
+  progress.report(processed, total);
+
+  std::vector<std::string> changed;
   for (auto &&path : paths) {
-    processed++;
+    if (shown.contains(path)) {
+      continue;
+    }
+
+    auto gameInfo = g_gameListIndex.find(path);
 
-    if (!std::filesystem::is_regular_file(path + "/PARAM.SFO")) {
+    if (!gameInfo) {
+      changed.push_back(std::move(path));
       continue;
     }
 
-    const auto psf = psf::load_object(path + "/PARAM.SFO");
+    processed++;
+
+    if (*gameInfo) {
+      add(std::move(**gameInfo));
+    }
+  }
+
+  submit();
+
+  // New and changed games: PARAM.SFO parsing and the EBOOT.BIN decrypt run on
+  // workers, the JNI thread sends results as they come
+  std::mutex resultsMutex;
+  std::vector<GameInfo> results;
+  std::atomic<usz> nextPath = 0;
+  std::atomic<usz> donePaths = 0;
+
+  if (!changed.empty()) {
+    const u32 workerCount = std::clamp<u32>(utils::get_thread_count() / 2, 1,
+                                            std::min<usz>(changed.size(), 4));
+
+    named_thread_group workers("Game List ", workerCount, [&] {
+      for (usz i = nextPath++; i < changed.size(); i = nextPath++) {
+        const auto &path = changed[i];
+        std::optional<GameInfo> gameInfo;
+
+        if (std::filesystem::is_regular_file(path + "/PARAM.SFO")) {
+          const auto psf = psf::load_object(path + "/PARAM.SFO");
+
+          rpcsx_android.notice("collectGameInfo: sfo at %s", path);
 
-    rpcsx_android.notice("collectGameInfo: sfo at %s", path);
+          gameInfo = fetchGameInfo(psf, path);
+          g_gameListIndex.store(path, gameInfo);
+        }
 
-    if (auto gameInfo = fetchGameInfo(psf, path)) {
-      gameInfos.push_back(std::move(*gameInfo));
+        if (gameInfo) {
+          std::lock_guard lock(resultsMutex);
+          results.push_back(std::move(*gameInfo));
+        }
 
-      if (gameInfos.size() >= 10) {
+        donePaths++;
+        donePaths.notify_one();
+      }
+    });
+
+    for (usz done = 0; done < changed.size();) {
+      donePaths.wait(done);
+      done = donePaths.load();
+
+      {
+        std::lock_guard lock(resultsMutex);
+        for (auto &info : results) {
+          gameInfos.push_back(std::move(info));
+        }
+        results.clear();
+      }
+
+      processed = total - changed.size() + done;
+
+      if (gameInfos.empty()) {
+        progress.report(processed, total);
+      } else {
         submit();
       }
     }
   }
 
-  submit();
+  g_gameListIndex.commit(rootDirs);
 
   progress.success(processed);
 }
@@ -1257,6 +1678,17 @@ extern bool ppu_initialize(const ppu_module<lv2_obj> &, bool check_only = false,
 extern void ppu_finalize(const ppu_module<lv2_obj> &);
 extern bool ppu_load_rel_exec(const ppu_rel_object &);
 
+// Блок PPUAnalyser для AOT компіляції (той самий layout, що nbtc::AnalysedBlock)
+struct ppu_analysed_block {
+  u32 addr;
+  u32 size;
+  const u8 *code;
+};
+
+using ppu_analysis_sink_type = void (*)(const char *titleId,
+                                        const void *blocks, std::size_t count);
+static std::atomic<ppu_analysis_sink_type> g_ppu_analysis_sink;
+
 class CompilationQueue {
   std::atomic<std::uint64_t> nextWorkTag{0};
   std::uint64_t lastProcessedTag = 0;
@@ -1410,6 +1842,25 @@ private:
         rpcsx_android.error("Going to precompile main PPU module");
         ppu_initialize(_main);
         mod_list.emplace_back(&_main);
+
+        // SPRX переміщуються на базу, відому лише під час запуску, тож AOT
+        // отримує тільки блоки головного модуля
+        if (const auto sink = g_ppu_analysis_sink.load()) {
+          std::vector<ppu_analysed_block> blocks;
+          for (const auto &func : _main.funcs) {
+            for (const auto &[addr, size] : func) {
+              if (size == 0) {
+                continue;
+              }
+
+              if (const auto ptr = _main.get_ptr<u8>(addr, size)) {
+                blocks.push_back({addr, size, reinterpret_cast<const u8 *>(ptr)});
+              }
+            }
+          }
+
+          sink(Emu.GetTitleID().c_str(), blocks.data(), blocks.size());
+        }
       }
     }
 
@@ -1531,6 +1982,10 @@ static void setupCallbacks() {
               result = std::make_shared<NullAudioBackend>();
               break;
 
+            case audio_renderer::aaudio:
+              result = std::make_shared<AAudioBackend>();
+              break;
+
             case audio_renderer::cubeb:
             default:
               result = std::make_shared<CubebBackend>();
@@ -1687,27 +2142,21 @@ extern "C" bool _rpcsx_overlayPadData(int digital1, int digital2,
     return false;
   }
 
-  for (auto &btn : pad->m_buttons) {
-    if (btn.m_offset == CELL_PAD_BTN_OFFSET_DIGITAL1) {
-      btn.m_pressed = (digital1 & btn.m_outKeyCode) != 0;
-
-      if (btn.m_outKeyCode == CELL_PAD_CTRL_PS && btn.m_pressed) {
-        if (auto padThread = pad::get_pad_thread(true)) {
-          padThread->open_home_menu();
-        }
-      }
+  virtual_pad_handler::push_state({
+      .digital1 = static_cast<u16>(digital1),
+      .digital2 = static_cast<u16>(digital2),
+      .sticks = {static_cast<u16>(leftStickX), static_cast<u16>(leftStickY),
+                 static_cast<u16>(rightStickX),
+                 static_cast<u16>(rightStickY)},
+      .timestamp = get_system_time(),
+  });
 
-    } else if (btn.m_offset == CELL_PAD_BTN_OFFSET_DIGITAL2) {
-      btn.m_pressed = (digital2 & btn.m_outKeyCode) != 0;
+  if (digital1 & CELL_PAD_CTRL_PS) {
+    if (auto padThread = pad::get_pad_thread(true)) {
+      padThread->open_home_menu();
     }
-
-    btn.m_value = btn.m_pressed ? 255 : 0;
   }
 
-  pad->m_sticks[0].m_value = leftStickX;
-  pad->m_sticks[1].m_value = leftStickY;
-  pad->m_sticks[2].m_value = rightStickX;
-  pad->m_sticks[3].m_value = rightStickY;
   return true;
 }
 
@@ -1855,6 +2304,10 @@ extern "C" int _rpcsx_boot(std::string_view path_) {
   return static_cast<int>(Emu.BootGame(path, "", false, cfg_mode::global));
 }
 
+extern "C" bool _rpcsx_bootRsxCapture(std::string_view path) {
+  return Emu.BootRsxCapture(std::string(path));
+}
+
 extern "C" int _rpcsx_getState() {
   return static_cast<int>(Emu.GetStatus(false));
 }
@@ -2010,6 +2463,65 @@ extern "C" bool _rpcsx_usbDeviceEvent(int fd, int vendorId, int productId,
   return true;
 }
 
+// SHA-1 зашифрованого пакета прошивки, потоково з PUP
+static std::string hashFirmwarePackage(const fs::file &package) {
+  sha1_context ctx;
+  sha1_starts(&ctx);
+
+  std::vector<u8> buffer(1024 * 1024);
+  for (u64 offset = 0;;) {
+    const u64 read = package.read_at(offset, buffer.data(), buffer.size());
+    if (read == 0) {
+      break;
+    }
+
+    sha1_update(&ctx, buffer.data(), read);
+    offset += read;
+  }
+
+  u8 digest[20];
+  sha1_finish(&ctx, digest);
+
+  std::string result;
+  for (const u8 byte : digest) {
+    fmt::append(result, "%02x", byte);
+  }
+  return result;
+}
+
+// Рядки "<пакет> <sha1>"
+static std::map<std::string, std::string>
+loadFirmwareManifest(const std::string &path) {
+  std::map<std::string, std::string> result;
+
+  if (fs::file file{path}) {
+    for (const auto &line : fmt::split(file.to_string(), {"\n"})) {
+      const usz separator = line.find(' ');
+      if (separator != umax) {
+        result.emplace(line.substr(0, separator), line.substr(separator + 1));
+      }
+    }
+  }
+
+  return result;
+}
+
+static void
+saveFirmwareManifest(const std::string &path,
+                     const std::map<std::string, std::string> &manifest) {
+  std::string data;
+  for (const auto &[name, hash] : manifest) {
+    fmt::append(data, "%s %s\n", name, hash);
+  }
+
+  fs::pending_file file(path);
+  if (!file.file || file.file.write(data.data(), data.size()) != data.size() ||
+      !file.commit()) {
+    rpcsx_android.error("failed to write firmware manifest %s (%s)", path,
+                        fs::g_tls_error);
+  }
+}
+
 static bool installPup(JNIEnv *env, fs::file &&pup_f, jlong progressId) {
   Progress progress(env, progressId);
 
@@ -2028,7 +2540,8 @@ static bool installPup(JNIEnv *env, fs::file &&pup_f, jlong progressId) {
     return false;
   }
 
-  fs::file update_files_f = pup.get_file(0x300);
+  // Потоково з PUP, без копії update_files.tar у пам'яті
+  fs::file update_files_f = pup.get_file_view(0x300);
 
   const usz update_files_size = update_files_f ? update_files_f.size() : 0;
 
@@ -2073,51 +2586,153 @@ static bool installPup(JNIEnv *env, fs::file &&pup_f, jlong progressId) {
 
   sendVshBootable(env, progressId);
 
-  jlong processed = 0;
+  // Пакети з тим самим SHA-1 уже розпаковані попереднім встановленням;
+  // маніфест дійсний лише поки dev_flash містить прошивку
+  const std::string manifest_path =
+      fs::get_config_dir() + "firmware_packages.txt";
+  const bool has_firmware =
+      fs::is_file(g_cfg_vfs.get_dev_flash() + "vsh/etc/version.txt");
+  const auto previous_manifest =
+      has_firmware ? loadFirmwareManifest(manifest_path)
+                   : std::map<std::string, std::string>{};
+
+  struct FirmwarePackage {
+    std::string name;
+    fs::file data;
+    std::string hash;
+    bool started = false;
+    bool installed = false;
+    bool skipped = false;
+  };
+
+  // TAR індексується один раз тут; далі кожен потік читає свій view
+  std::vector<FirmwarePackage> packages;
+  packages.reserve(update_filenames.size());
   for (const auto &update_filename : update_filenames) {
-    auto update_file_stream = update_files.get_file(update_filename);
+    packages.push_back(
+        {update_filename, update_files.get_file_view(update_filename)});
+  }
 
-    if (update_file_stream->m_file_handler) {
-      // Forcefully read all the data
-      update_file_stream->m_file_handler->handle_file_op(
-          *update_file_stream, 0, update_file_stream->get_size(umax), nullptr);
+  std::atomic<usz> next_package = 0;
+  std::atomic<usz> done_packages = 0;
+  std::atomic<bool> stop = false;
+  std::mutex error_mutex;
+  std::string error_message;
+
+  auto fail = [&](std::string message) {
+    std::lock_guard lock(error_mutex);
+    if (error_message.empty()) {
+      error_message = std::move(message);
     }
+    stop = true;
+  };
 
-    fs::file update_file = fs::make_stream(std::move(update_file_stream->data));
+  // Кожен потік тримає в пам'яті один розшифрований пакет
+  const u32 worker_count = std::clamp<u32>(
+      utils::get_thread_count() / 2, 1, std::min<usz>(packages.size(), 4));
 
-    SCEDecrypter self_dec(update_file);
-    self_dec.LoadHeaders();
-    self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
-    self_dec.DecryptData();
+  {
+    named_thread_group workers("FW Installer ", worker_count, [&] {
+      for (usz i = next_package++; i < packages.size() && !stop;
+           i = next_package++) {
+        auto &package = packages[i];
+        package.started = true;
+
+        if (!package.data) {
+          fail(fmt::format("TAR contents are invalid (package=%s)",
+                           package.name));
+          break;
+        }
 
-    auto dev_flash_tar_f = self_dec.MakeFile();
+        package.hash = hashFirmwarePackage(package.data);
 
-    if (dev_flash_tar_f.size() < 3) {
-      rpcsx_android.error(
-          "Firmware installation failed: Firmware could not be decompressed");
+        if (const auto it = previous_manifest.find(package.name);
+            it != previous_manifest.end() && it->second == package.hash) {
+          package.skipped = true;
+          package.installed = true;
+          done_packages++;
+          continue;
+        }
 
-      progress.failure("Firmware update file could not be decompressed");
-      return false;
-    }
+        SCEDecrypter self_dec(package.data);
+        self_dec.LoadHeaders();
+        self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
+        self_dec.DecryptData();
 
-    tar_object dev_flash_tar(dev_flash_tar_f[2]);
+        auto dev_flash_tar_f = self_dec.MakeFile();
 
-    if (!dev_flash_tar.extract()) {
+        if (dev_flash_tar_f.size() < 3) {
+          rpcsx_android.error("Firmware installation failed: Firmware could "
+                              "not be decompressed");
+          fail("Firmware update file could not be decompressed");
+          break;
+        }
 
-      rpcsx_android.error("Error while installing firmware: TAR contents are "
-                          "invalid. (package=%s)",
-                          update_filename);
+        tar_object dev_flash_tar(dev_flash_tar_f[2]);
 
-      progress.failure(fmt::format("TAR contents are invalid (package=%s)",
-                                   update_filename));
-      return false;
+        if (!dev_flash_tar.extract()) {
+          rpcsx_android.error("Error while installing firmware: TAR contents "
+                              "are invalid. (package=%s)",
+                              package.name);
+          fail(fmt::format("TAR contents are invalid (package=%s)",
+                           package.name));
+          break;
+        }
+
+        package.installed = true;
+        done_packages++;
+      }
+    });
+
+    for (usz reported = umax; !stop;) {
+      const usz done = done_packages.load();
+
+      if (done != reported) {
+        reported = done;
+
+        if (!progress.report(done, packages.size())) {
+          // Installation was cancelled, workers stop after the current package
+          stop = true;
+          break;
+        }
+
+        if (done == packages.size()) {
+          break;
+        }
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
     }
+  }
 
-    if (!progress.report(processed++, update_filenames.size())) {
-      // Installation was cancelled
-      return false;
+  // Маніфест оновлюється і після невдачі: пакети, яких не торкалися, лишаються
+  // дійсними, а перервані - ні
+  auto manifest = previous_manifest;
+  for (const auto &package : packages) {
+    if (package.installed) {
+      manifest[package.name] = package.hash;
+    } else if (package.started) {
+      manifest.erase(package.name);
     }
   }
+  saveFirmwareManifest(manifest_path, manifest);
+
+  if (!error_message.empty()) {
+    progress.failure(error_message);
+    return false;
+  }
+
+  if (stop && done_packages != packages.size()) {
+    return false;
+  }
+
+  usz skipped = 0;
+  for (const auto &package : packages) {
+    skipped += package.skipped;
+  }
+
+  rpcsx_android.notice("Firmware installed: %u packages, %u unchanged skipped",
+                       packages.size(), skipped);
 
   sendFirmwareInstalled(env, utils::get_firmware_version());
 
@@ -2155,6 +2770,7 @@ static bool installPkg(JNIEnv *env, fs::file &&file, jlong progressId) {
 
   while (true) {
     std::uint64_t totalProgress = 0;
+    std::uint64_t decryptProgress = 0;
     for (auto &reader : readers) {
       if (result.error != package_install_result::error_type::no_error) {
         progress.failure("Installation failed");
@@ -2165,6 +2781,7 @@ static bool installPkg(JNIEnv *env, fs::file &&file, jlong progressId) {
       }
 
       totalProgress += reader.get_progress(maxProgress);
+      decryptProgress += reader.get_decrypt_progress(maxProgress);
     }
 
     if (totalProgress == maxProgress * readers.size()) {
@@ -2172,8 +2789,12 @@ static bool installPkg(JNIEnv *env, fs::file &&file, jlong progressId) {
     }
 
     totalProgress /= readers.size();
+    decryptProgress /= readers.size();
 
-    if (!progress.report(totalProgress, maxProgress)) {
+    if (!progress.report(totalProgress, maxProgress,
+                         fmt::format("Decrypted %u%%, written %u%%",
+                                     decryptProgress * 100 / maxProgress,
+                                     totalProgress * 100 / maxProgress))) {
       for (package_reader &reader : readers) {
         reader.abort_extract();
       }
@@ -2585,8 +3206,27 @@ extern "C" void _rpcsx_loginUser(std::string_view userId) {
 
 extern "C" std::string _rpcsx_getUser() { return Emu.GetUsr(); }
 
+// Вузли g_cfg статичні, тож шлях розв'язується один раз, далі - пошук у таблиці
+static cfg::_base *find_settings_node(std::string_view path) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, cfg::_base *> nodes;
+
+  std::lock_guard lock(mutex);
+
+  std::string key(path);
+  if (auto it = nodes.find(key); it != nodes.end()) {
+    return it->second;
+  }
+
+  auto node = find_cfg_node(&g_cfg, path);
+  if (node != nullptr) {
+    nodes.emplace(std::move(key), node);
+  }
+  return node;
+}
+
 extern "C" std::string _rpcsx_settingsGet(std::string_view path) {
-  auto root = find_cfg_node(&g_cfg, path);
+  auto root = find_settings_node(path);
 
   if (root == nullptr) {
     return nullptr;
@@ -2606,7 +3246,7 @@ extern "C" bool _rpcsx_settingsSet(std::string_view path,
     return false;
   }
 
-  auto root = find_cfg_node(&g_cfg, path);
+  auto root = find_settings_node(path);
 
   if (root == nullptr) {
     rpcsx_android.error("settingsSet: node %s not found", path);
@@ -2627,6 +3267,259 @@ extern "C" std::string _rpcsx_getVersion() {
   return rx::getVersion().toString();
 }
 
+extern "C" void _rpcsx_getPipelineDrawStats(std::uint64_t *interpreterDraws,
+                                            std::uint64_t *interpreterSwaps,
+                                            std::uint64_t *skippedDraws) {
+  *interpreterDraws = vk::g_pipeline_draw_stats.interpreter_draws.load();
+  *interpreterSwaps = vk::g_pipeline_draw_stats.interpreter_swaps.load();
+  *skippedDraws = vk::g_pipeline_draw_stats.skipped_draws.load();
+}
+
+// Проби кешу драйвера перед async компіляцією: hit - pipeline одразу, miss - workers
+extern "C" void _rpcsx_getPipelineProbeStats(std::uint64_t *driverCacheHits,
+                                             std::uint64_t *driverCacheMisses) {
+  *driverCacheHits = vk::g_pipeline_draw_stats.driver_cache_hits.load();
+  *driverCacheMisses = vk::g_pipeline_draw_stats.driver_cache_misses.load();
+}
+
+// Скільки разів SPU цикли очікування стали host очікуваннями замість спіну
+extern "C" void _rpcsx_getSpuIdleStats(std::uint64_t *channelWaits,
+                                       std::uint64_t *getllarSpins,
+                                       std::uint64_t *getllarSleeps) {
+  *channelWaits = g_spu_idle_stats.channel_waits.load();
+  *getllarSpins = g_spu_idle_stats.getllar_spins.load();
+  *getllarSleeps = g_spu_idle_stats.getllar_sleeps.load();
+}
+
+// Конкуренція за rx::shared_mutex і shared_atomic32 очікування: скільки очікувань
+// розв'язались у спіні, скільки заснули на futex і скільки часу (нс) пішло на спін
+extern "C" void _rpcsx_getLockContentionStats(std::uint64_t *contended,
+                                              std::uint64_t *spinResolved,
+                                              std::uint64_t *parked,
+                                              std::uint64_t *spinNs) {
+  const auto stats = rx::get_lock_contention_stats();
+  *contended = stats.contended;
+  *spinResolved = stats.spinResolved;
+  *parked = stats.parked;
+  *spinNs = stats.spinNs;
+}
+
+// Наростаючі підсумки для покадрової телеметрії: CPU час (нс) PPU, SPU і RSX потоків
+// та лічильники RSX бекенду. Потоки, що завершились, випадають із сум
+extern "C" void _rpcsx_getFrameCounters(std::uint64_t *ppuCpuNs,
+                                        std::uint64_t *spuCpuNs,
+                                        std::uint64_t *rsxCpuNs,
+                                        std::uint64_t *pipelineMisses,
+                                        std::uint64_t *textureUploads) {
+  u64 ppu_time = 0;
+  u64 spu_time = 0;
+
+  idm::select<named_thread<ppu_thread>>(
+      [&](u32, named_thread<ppu_thread> &ppu) {
+        ppu_time += thread_ctrl::get_cpu_time(ppu);
+      });
+
+  idm::select<named_thread<spu_thread>>(
+      [&](u32, named_thread<spu_thread> &spu) {
+        spu_time += thread_ctrl::get_cpu_time(spu);
+      });
+
+  *ppuCpuNs = ppu_time;
+  *spuCpuNs = spu_time;
+  *rsxCpuNs = 0;
+  *pipelineMisses = 0;
+  *textureUploads = 0;
+
+  if (const auto render = rsx::get_current_renderer()) {
+    const auto counters = render->get_backend_counters();
+    *rsxCpuNs = render->get_cpu_time();
+    *pipelineMisses = counters.pipeline_misses;
+    *textureUploads = counters.texture_uploads;
+  }
+}
+
+// Kernel tid гарячих потоків (PPU, SPU, RSX) для ADPF сесії; повертає кількість
+// записаних, не більше capacity
+extern "C" std::size_t _rpcsx_getHotThreadIds(std::int32_t *tids,
+                                              std::size_t capacity) {
+  std::size_t count = 0;
+
+  auto add = [&](u64 nativeId) {
+    if (count >= capacity || nativeId == 0) {
+      return;
+    }
+
+    if (const pid_t tid =
+            pthread_gettid_np(reinterpret_cast<pthread_t>(nativeId));
+        tid > 0) {
+      tids[count++] = tid;
+    }
+  };
+
+  if (const auto render = rsx::get_current_renderer()) {
+    add(render->get_native_thread_id());
+  }
+
+  idm::select<named_thread<spu_thread>>(
+      [&](u32, named_thread<spu_thread> &spu) {
+        add(thread_ctrl::get_native_id(spu));
+      });
+
+  idm::select<named_thread<ppu_thread>>(
+      [&](u32, named_thread<ppu_thread> &ppu) {
+        add(thread_ctrl::get_native_id(ppu));
+      });
+
+  return count;
+}
+
+// Викликається з потоку CompilationQueue після аналізу головного модуля гри
+// (ppu_analysed_block[]); блоки дійсні лише під час виклику
+extern "C" void _rpcsx_setPpuAnalysisCallback(
+    void (*callback)(const char *titleId, const void *blocks,
+                     std::size_t count)) {
+  g_ppu_analysis_sink.store(callback);
+}
+
+// Викликається з RSX потоку в кінці кадру; nullptr - вимкнути збір
+extern "C" void _rpcsx_setSamplerFeedbackCallback(
+    void (*callback)(const void *entries, std::size_t count)) {
+  rsx::g_sampler_feedback.set_sink(
+      reinterpret_cast<rsx::sampler_feedback_collector::sink_type>(callback));
+}
+
+// Викликається з RSX потоку для кожного кадру з готовими GPU timestamps
+extern "C" void _rpcsx_setFrameTimingCallback(void (*callback)(float frameTimeMs,
+                                                              float gpuTimeMs)) {
+  vk::g_frame_timing_sink.store(callback);
+}
+
+// GPU час по render pass / compute / pipeline за кадр (rsx::gpu_cost_entry[]);
+// поки callback встановлено, timestamp запити пишуться навколо кожного проходу
+extern "C" void _rpcsx_setGpuCostCallback(void (*callback)(const void *entries,
+                                                           std::size_t count)) {
+  vk::g_gpu_cost_sink.store(reinterpret_cast<vk::gpu_cost_sink_type>(callback));
+}
+
+// Апаратні лічильники потоків класу (0 - PPU, 1 - SPU, 2 - RSX) за останню секунду
+// у порядку utils::hw_counter; false, якщо вимкнено або perf_event_open недоступний
+extern "C" bool _rpcsx_getHwCounters(int threadClass, std::uint64_t *values,
+                                     std::size_t count) {
+  if (threadClass < 0 ||
+      threadClass >= static_cast<int>(perf_thread_class::count)) {
+    return false;
+  }
+
+  utils::hw_counter_values counters;
+  if (!perf_monitor::get_hw_counters(
+          static_cast<perf_thread_class>(threadClass), counters)) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    values[i] = i < counters.values.size() ? counters.values[i] : 0;
+  }
+  return true;
+}
+
+// Облік пам'яті для memory budget: гостьові блоки vm і device-local алокації RSX
+// (на Android - та сама системна пам'ять), зняті на останній межі кадру
+extern "C" void _rpcsx_getMemoryUsage(std::uint64_t *guestBytes,
+                                      std::uint64_t *deviceBytes,
+                                      std::uint64_t *textureBytes) {
+  u64 guest = 0;
+  for (const auto location : {vm::main, vm::user64k, vm::user1m, vm::video}) {
+    if (const auto block = vm::get(location)) {
+      guest += block->used();
+    }
+  }
+
+  *guestBytes = guest;
+  *deviceBytes = 0;
+  *textureBytes = 0;
+
+  if (const auto render = rsx::get_current_renderer()) {
+    const auto counters = render->get_backend_counters();
+    *deviceBytes = counters.device_memory_bytes;
+    *textureBytes = counters.texture_memory_bytes;
+  }
+}
+
+// Тиск пам'яті від onTrimMemory: RSX звільняє кеші як при нестачі VRAM
+// (0 - low ... 3 - fatal) на наступній межі кадру
+extern "C" void _rpcsx_requestMemoryRelief(int severity) {
+  if (const auto render = rsx::get_current_renderer()) {
+    render->request_memory_relief(
+        static_cast<rsx::problem_severity>(std::clamp(severity, 0, 3)));
+  }
+}
+
+// Масштаб рендеру від DRS (1.0 = без змін); діє лише з temporal апскейлером
+extern "C" void _rpcsx_setRenderScale(float scale) {
+  const auto percent = static_cast<u32>(std::clamp(scale, 0.f, 1.f) * 100.f + 0.5f);
+  rsx::g_dynamic_resolution.requested_percent.store(percent);
+}
+
+// Рівень VRS від DRS: 0 - вимкнено, 1 - 2x1, 2 - 2x2; потрібен
+// VK_KHR_fragment_shading_rate і увімкнений Variable Rate Shading
+extern "C" void _rpcsx_setShadingRate(int level) {
+  rsx::g_dynamic_resolution.requested_shading_rate.store(
+      static_cast<u32>(std::clamp(level, 0, 2)));
+}
+
+// Вимикає спекулятивні ZCULL звіти для ігор, яким потрібні точні результати
+extern "C" void _rpcsx_setZcullSpeculation(bool allowed) {
+  rsx::reports::g_zcull_speculation_allowed.store(allowed);
+}
+
+// Генерація проміжних кадрів для поточної гри, поверх налаштування Vulkan
+extern "C" void _rpcsx_setFrameGeneration(bool enabled) {
+  vk::g_frame_generation_requested.store(enabled);
+}
+
+// Per-title заборона Static HLE підмін; викликається під час завантаження гри
+extern "C" void _rpcsx_setStaticHleFilter(bool (*filter)(const char *titleId,
+                                                         const char *function)) {
+  g_shle_filter.store(filter);
+}
+
+// Guest діапазони, код яких став недійсним (unload PRX/overlay, патчі) - для NCE JIT
+extern "C" void _rpcsx_setCodeInvalidationCallback(void (*callback)(std::uint32_t addr,
+                                                                    std::uint32_t size)) {
+  g_ppu_code_invalidated.store(callback);
+}
+
+// Per-title вибір NJ режиму через FPCR; читається в ppu_initialize()
+extern "C" void _rpcsx_setPpuHostFpcrFilter(bool (*filter)(const char *titleId)) {
+  g_ppu_host_fpcr_filter.store(filter);
+}
+
+// Наступне завантаження .rrc захоплення стає бенчмарком: iterations проходів і JSON звіт у outputPath.
+// iterations = 0 повертає звичайне циклічне відтворення
+extern "C" void _rpcsx_setReplayBenchmark(int iterations,
+                                          std::string_view outputPath) {
+  rsx::g_replay_benchmark.iterations = static_cast<u32>(std::max(iterations, 0));
+  rsx::g_replay_benchmark.output_path = std::string(outputPath);
+}
+
+// Game content under hostRoot is opened relative to fd (duplicated), which the
+// frontend got once through SAF or shared storage access. fd < 0 drops it.
+// Takes effect for mounts done after the call
+extern "C" bool _rpcsx_setContentRootFd(std::string_view hostRoot, int fd) {
+  if (!dirfd_dev::set_root(hostRoot, fd)) {
+    rpcsx_android.error("Failed to use content root fd %d for '%s' (%s)", fd,
+                        hostRoot, fs::g_tls_error);
+    return false;
+  }
+
+  if (fd >= 0) {
+    rpcsx_android.notice("Game content under '%s' is accessed through fd %d",
+                         hostRoot, fd);
+  }
+
+  return true;
+}
+
 extern "C" void *_rpcsx_setCustomDriver(void *driverHandle) {
   auto prevLoader = vk::instance::g_vk_loader;
   if (prevLoader != nullptr) {
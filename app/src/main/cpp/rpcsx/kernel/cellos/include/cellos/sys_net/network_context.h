@@ -31,9 +31,18 @@ struct p2p_thread : base_network_thread {
   std::map<u16, nt_p2p_port> list_p2p_ports;
   atomic_t<u32> num_p2p_ports = 0;
 
+#ifdef __linux__
+  // P2P sockets are registered once on creation instead of rebuilding a poll
+  // list every iteration
+  int p2p_epoll = -1;
+#endif
+
   static constexpr auto thread_name = "Network P2P Thread";
 
   p2p_thread();
+  p2p_thread(const p2p_thread &) = delete;
+  p2p_thread &operator=(const p2p_thread &) = delete;
+  ~p2p_thread();
 
   void create_p2p_port(u16 p2p_port);
 
@@ -15,6 +15,7 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #ifdef __clang__
 #pragma GCC diagnostic pop
 #endif
@@ -65,7 +66,13 @@ struct nt_p2p_port {
   shared_mutex s_sign_mutex;
   std::vector<signaling_message> sign_msgs{};
 
-  std::array<u8, 65535> p2p_recv_data{};
+#ifdef __linux__
+  static constexpr u32 recv_batch_size = 8;
+#else
+  static constexpr u32 recv_batch_size = 1;
+#endif
+
+  std::array<std::array<u8, 65535>, recv_batch_size> p2p_recv_data{};
 
   nt_p2p_port(u16 port);
   ~nt_p2p_port();
@@ -78,5 +85,8 @@ struct nt_p2p_port {
                         u8 *data, ::sockaddr_storage *op_addr);
   bool handle_listening(s32 sock_id, p2ps_encapsulated_tcp *tcp_header,
                         u8 *data, ::sockaddr_storage *op_addr);
+  // Receives and dispatches pending datagrams, returns true if more may be
+  // queued
   bool recv_data();
+  void handle_packet(u8 *buf, s32 recv_res, ::sockaddr_storage &native_addr);
 };
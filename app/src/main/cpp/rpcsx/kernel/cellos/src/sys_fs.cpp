@@ -15,9 +15,25 @@
 #include "Emu/vfs_config.h"
 #include "cellos/sys_process.h"
 
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <span>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 LOG_CHANNEL(sys_fs);
 
@@ -676,6 +692,742 @@ fs::file lv2_file::make_view(const shared_ptr<lv2_file> &_file, u64 offset) {
   return result;
 }
 
+namespace {
+// Streaming games issue many small sequential reads, each one a synchronous
+// pread on the host. Once a read-only descriptor is read sequentially, the
+// following blocks are fetched by a background I/O thread and guest reads are
+// served from a small per-descriptor cache.
+constexpr u64 readahead_block_size = 512 * 1024;
+constexpr usz readahead_max_blocks = 4;
+constexpr usz readahead_depth = 3;
+constexpr u32 readahead_sequential_reads = 2;
+constexpr u64 readahead_min_file_size = 2 * readahead_block_size;
+constexpr usz readahead_max_jobs = 64;
+
+struct readahead_state {
+  struct block {
+    u64 offset = 0;
+    u64 last_use = 0;
+    bool ready = false;
+    std::vector<u8> data;
+  };
+
+  fs::file file;
+  const u64 file_size;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<block> blocks;
+  u64 use_clock = 0;
+  u64 next_offset = 0; // End of the previous guest read
+  u32 sequential = 0;
+
+  explicit readahead_state(fs::file &&f)
+      : file(std::move(f)), file_size(file.size()) {
+    blocks.reserve(readahead_max_blocks);
+  }
+
+  block *find(u64 offset) {
+    for (auto &b : blocks) {
+      if (offset - b.offset < readahead_block_size) {
+        return &b;
+      }
+    }
+
+    return nullptr;
+  }
+
+  // Get a slot for a new block, evicting the least recently used one.
+  // Blocks still being read are never evicted.
+  block *allocate(u64 offset) {
+    if (blocks.size() < readahead_max_blocks) {
+      return &blocks.emplace_back(block{.offset = offset});
+    }
+
+    block *victim = nullptr;
+
+    for (auto &b : blocks) {
+      if (b.ready && (!victim || b.last_use < victim->last_use)) {
+        victim = &b;
+      }
+    }
+
+    if (victim) {
+      *victim = block{.offset = offset};
+    }
+
+    return victim;
+  }
+
+  // Copy cached data starting at offset, stops at the first missing block
+  u64 copy_cached(std::unique_lock<std::mutex> &lock, u64 offset, u8 *out,
+                  u64 size) {
+    u64 done = 0;
+
+    while (done < size) {
+      const u64 pos = offset + done;
+      block *b = find(pos);
+
+      if (!b) {
+        break;
+      }
+
+      if (!b->ready) {
+        // The block is already being read, don't issue the same read twice
+        cv.wait(lock, [&] {
+          block *x = find(pos);
+          return !x || x->ready;
+        });
+
+        continue;
+      }
+
+      const u64 at = pos - b->offset;
+
+      if (at >= b->data.size()) {
+        // Short read (EOF or I/O error)
+        break;
+      }
+
+      const u64 count = std::min<u64>(b->data.size() - at, size - done);
+      std::memcpy(out + done, b->data.data() + at, count);
+      b->last_use = ++use_clock;
+      done += count;
+    }
+
+    return done;
+  }
+};
+
+class readahead_thread {
+public:
+  static readahead_thread &get() {
+    static readahead_thread instance;
+    return instance;
+  }
+
+  bool push(std::weak_ptr<readahead_state> state, u64 offset) {
+    {
+      std::lock_guard lock(m_mutex);
+
+      if (m_jobs.size() >= readahead_max_jobs) {
+        return false;
+      }
+
+      m_jobs.push_back({std::move(state), offset});
+    }
+
+    m_cv.notify_one();
+    return true;
+  }
+
+private:
+  struct job {
+    std::weak_ptr<readahead_state> state;
+    u64 offset;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<job> m_jobs;
+  bool m_stop = false;
+  std::thread m_thread{[this] { run(); }};
+
+  readahead_thread() = default;
+
+  ~readahead_thread() {
+    {
+      std::lock_guard lock(m_mutex);
+      m_stop = true;
+    }
+
+    m_cv.notify_one();
+    m_thread.join();
+  }
+
+  void run() {
+    while (true) {
+      job next;
+
+      {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+
+        if (m_stop) {
+          return;
+        }
+
+        next = std::move(m_jobs.front());
+        m_jobs.pop_front();
+      }
+
+      // Descriptor may have been closed while the job was queued
+      const auto state = next.state.lock();
+
+      if (!state) {
+        continue;
+      }
+
+      std::vector<u8> data(std::min<u64>(readahead_block_size,
+                                         state->file_size - next.offset));
+      data.resize(state->file.read_at(next.offset, data.data(), data.size()));
+
+      {
+        std::lock_guard lock(state->mutex);
+
+        if (auto b = state->find(next.offset); b && !b->ready) {
+          b->data = std::move(data);
+          b->ready = true;
+        }
+      }
+
+      state->cv.notify_all();
+    }
+  }
+};
+
+class readahead_file final : public fs::file_base {
+  std::shared_ptr<readahead_state> m_state;
+  u64 m_pos = 0;
+
+public:
+  explicit readahead_file(fs::file &&file)
+      : m_state(std::make_shared<readahead_state>(std::move(file))) {}
+
+  fs::stat_t get_stat() override { return m_state->file.get_stat(); }
+
+  void sync() override { m_state->file.sync(); }
+
+  // Only descriptors opened for reading are wrapped
+  bool trunc(u64) override { return false; }
+
+  u64 write(const void *, u64) override { return 0; }
+
+  u64 read(void *buffer, u64 size) override {
+    const u64 result = read_at(m_pos, buffer, size);
+    m_pos += result;
+    return result;
+  }
+
+  u64 read_at(u64 offset, void *buffer, u64 size) override {
+    auto &state = *m_state;
+    const auto out = static_cast<u8 *>(buffer);
+
+    std::unique_lock lock(state.mutex);
+
+    state.sequential = offset == state.next_offset ? state.sequential + 1 : 0;
+    state.next_offset = offset + size;
+
+    if (state.sequential < readahead_sequential_reads) {
+      lock.unlock();
+      return state.file.read_at(offset, buffer, size);
+    }
+
+    u64 done = state.copy_cached(lock, offset, out, size);
+
+    if (done < size) {
+      lock.unlock();
+      done += state.file.read_at(offset + done, out + done, size - done);
+      lock.lock();
+    }
+
+    // Keep the blocks following the read position in flight
+    const u64 first = (offset + size) / readahead_block_size;
+
+    for (u64 i = first; i < first + readahead_depth; i++) {
+      const u64 block_offset = i * readahead_block_size;
+
+      if (block_offset >= state.file_size) {
+        break;
+      }
+
+      if (state.find(block_offset)) {
+        continue;
+      }
+
+      if (!state.allocate(block_offset)) {
+        break;
+      }
+
+      if (!readahead_thread::get().push(m_state, block_offset)) {
+        std::erase_if(state.blocks, [&](const readahead_state::block &b) {
+          return b.offset == block_offset && !b.ready;
+        });
+
+        break;
+      }
+    }
+
+    return done;
+  }
+
+  u64 seek(s64 offset, fs::seek_mode whence) override {
+    const s64 new_pos = whence == fs::seek_set   ? offset
+                        : whence == fs::seek_cur ? offset + m_pos
+                        : whence == fs::seek_end ? offset + size()
+                                                 : -1;
+
+    if (new_pos < 0) {
+      fs::g_tls_error = fs::error::inval;
+      return -1;
+    }
+
+    m_pos = new_pos;
+    return m_pos;
+  }
+
+  u64 size() override { return m_state->file_size; }
+
+  fs::native_handle get_handle() override {
+    return m_state->file.get_handle();
+  }
+
+  // Same contents as the wrapped file
+  fs::file_id get_id() override { return m_state->file.get_id(); }
+};
+
+fs::file make_readahead_file(fs::file &&file) {
+  if (file.size() < readahead_min_file_size) {
+    return std::move(file);
+  }
+
+  fs::file result;
+  result.reset(std::make_unique<readahead_file>(std::move(file)));
+  return result;
+}
+
+// Host paths known to be missing on read-only devices. Titles probe many
+// optional files at boot, each miss costing several host stats (split file
+// fragments included) which is slow on FUSE backed storage. Writable devices
+// aren't cached because HLE modules create files there behind sys_fs.
+class lv2_fs_missing_cache {
+public:
+  static lv2_fs_missing_cache &get() {
+    static lv2_fs_missing_cache instance;
+    return instance;
+  }
+
+  bool contains(std::string_view path) {
+    reader_lock lock(m_mutex);
+    return m_generation == vfs::get_generation() && m_paths.contains(path);
+  }
+
+  void insert(std::string_view path) {
+    std::lock_guard lock(m_mutex);
+
+    // Mount table changed (e.g. disc swap) or too many entries
+    if (const u64 generation = vfs::get_generation();
+        generation != m_generation || m_paths.size() >= max_paths) {
+      m_paths.clear();
+      m_generation = generation;
+    }
+
+    m_paths.emplace(path);
+  }
+
+private:
+  static constexpr usz max_paths = 16384;
+
+  shared_mutex m_mutex;
+  u64 m_generation = umax;
+  std::unordered_set<std::string, fmt::string_hash, std::equal_to<>> m_paths;
+};
+
+// Titles read mostly the same files in the same order at every boot. The
+// reads of the first seconds of a boot are recorded per title, and on the next
+// boot the recorded ranges are handed to the kernel page cache ahead of the
+// guest (posix_fadvise WILLNEED) by a low priority thread. Profiles that
+// repeatedly fail to predict the boot stop being replayed.
+constexpr u64 boot_io_record_usec = 30'000'000;
+constexpr usz boot_io_max_extents = 8192;
+constexpr u64 boot_io_replay_lead = 64 * 1024 * 1024; // Prefetched ahead of guest reads
+constexpr u64 boot_io_replay_max_bytes = 1024 * 1024 * 1024;
+constexpr u32 boot_io_max_misses = 3;
+
+u64 boot_io_now_usec() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct boot_io_trace {
+  struct extent {
+    u32 path;
+    u64 offset;
+    u64 length;
+  };
+
+  std::mutex mutex;
+  std::vector<std::string> paths;
+  std::unordered_map<std::string, u32, fmt::string_hash, std::equal_to<>>
+      path_ids;
+  std::vector<usz> path_last_extent;
+  std::vector<extent> extents;
+  u64 deadline = 0;
+  atomic_t<bool> recording = false;
+  atomic_t<u64> guest_bytes = 0;
+
+  u32 get_path_id(std::string_view path) {
+    std::lock_guard lock(mutex);
+
+    if (auto found = path_ids.find(path); found != path_ids.end()) {
+      return found->second;
+    }
+
+    const u32 id = ::size32(paths);
+    paths.emplace_back(path);
+    path_ids.emplace(path, id);
+    path_last_extent.push_back(umax);
+    return id;
+  }
+
+  // Returns false once the recording window is over
+  bool record(u32 path, u64 offset, u64 length) {
+    if (!recording.observe()) {
+      return false;
+    }
+
+    guest_bytes += length;
+
+    std::lock_guard lock(mutex);
+
+    if (!recording || boot_io_now_usec() >= deadline) {
+      return false;
+    }
+
+    if (!length) {
+      return true;
+    }
+
+    // Extend the previous read of the same file when sequential
+    if (const usz last = path_last_extent[path]; last != umax) {
+      auto &prev = extents[last];
+
+      if (offset >= prev.offset && offset <= prev.offset + prev.length) {
+        prev.length = std::max(prev.length, offset + length - prev.offset);
+        return true;
+      }
+    }
+
+    if (extents.size() >= boot_io_max_extents) {
+      return true;
+    }
+
+    path_last_extent[path] = extents.size();
+    extents.push_back({path, offset, length});
+    return true;
+  }
+};
+
+class boot_trace_file final : public fs::file_base {
+  fs::file m_file;
+  std::shared_ptr<boot_io_trace> m_trace;
+  const u32 m_path;
+  u64 m_pos = 0;
+
+public:
+  boot_trace_file(fs::file &&file, std::shared_ptr<boot_io_trace> trace,
+                  u32 path)
+      : m_file(std::move(file)), m_trace(std::move(trace)), m_path(path) {}
+
+  fs::stat_t get_stat() override { return m_file.get_stat(); }
+
+  void sync() override { m_file.sync(); }
+
+  // Only descriptors opened for reading are wrapped
+  bool trunc(u64) override { return false; }
+
+  u64 write(const void *, u64) override { return 0; }
+
+  u64 read(void *buffer, u64 size) override {
+    const u64 result = read_at(m_pos, buffer, size);
+    m_pos += result;
+    return result;
+  }
+
+  u64 read_at(u64 offset, void *buffer, u64 size) override {
+    const u64 result = m_file.read_at(offset, buffer, size);
+    m_trace->record(m_path, offset, result);
+    return result;
+  }
+
+  u64 seek(s64 offset, fs::seek_mode whence) override {
+    const s64 new_pos = whence == fs::seek_set   ? offset
+                        : whence == fs::seek_cur ? offset + m_pos
+                        : whence == fs::seek_end ? offset + size()
+                                                 : -1;
+
+    if (new_pos < 0) {
+      fs::g_tls_error = fs::error::inval;
+      return -1;
+    }
+
+    m_pos = new_pos;
+    return m_pos;
+  }
+
+  u64 size() override { return m_file.size(); }
+
+  fs::native_handle get_handle() override { return m_file.get_handle(); }
+
+  fs::file_id get_id() override { return m_file.get_id(); }
+};
+
+struct boot_io_profile_entry {
+  std::string path;
+  u64 offset;
+  u64 length;
+};
+
+// Created per emulation run (g_fxo), the destructor stores the new profile
+struct lv2_fs_boot_io {
+  std::mutex mutex;
+  bool started = false;
+  bool finished = false;
+  bool replayed = false;
+  u32 misses = 0;
+  std::string profile_path;
+  std::vector<boot_io_profile_entry> previous;
+  std::shared_ptr<boot_io_trace> trace = std::make_shared<boot_io_trace>();
+  std::unique_ptr<named_thread<std::function<void()>>> replay_thread;
+
+  lv2_fs_boot_io() = default;
+  lv2_fs_boot_io(const lv2_fs_boot_io &) = delete;
+  lv2_fs_boot_io &operator=(const lv2_fs_boot_io &) = delete;
+
+  ~lv2_fs_boot_io() {
+    replay_thread.reset();
+    finish();
+  }
+
+  fs::file wrap(std::string_view local_path, fs::file &&file) {
+    if (!trace->recording.observe()) {
+      std::lock_guard lock(mutex);
+
+      if (started) {
+        return std::move(file);
+      }
+
+      start();
+
+      if (!trace->recording) {
+        return std::move(file);
+      }
+    } else if (boot_io_now_usec() >= trace->deadline) {
+      // Store the profile now rather than at emulation stop
+      finish();
+      return std::move(file);
+    }
+
+    const u32 path = trace->get_path_id(local_path);
+    fs::file result;
+    result.reset(
+        std::make_unique<boot_trace_file>(std::move(file), trace, path));
+    return result;
+  }
+
+  // Called with the mutex locked
+  void start() {
+    started = true;
+
+    const std::string title_id = Emu.GetTitleID();
+
+    if (title_id.empty()) {
+      return;
+    }
+
+    profile_path = rpcs3::utils::get_cache_dir() + title_id + "/boot_io.txt";
+    load();
+
+    trace->deadline = boot_io_now_usec() + boot_io_record_usec;
+    trace->recording = true;
+
+    if (previous.empty() || misses >= boot_io_max_misses) {
+      return;
+    }
+
+    replayed = true;
+    replay_thread = std::make_unique<named_thread<std::function<void()>>>(
+        "FS Boot Prefetch"sv, [entries = previous, trace = trace]() {
+          replay(entries, *trace);
+        });
+  }
+
+  // Format: "boot_io 1 <misses>" header, then "<offset> <length> <path>" lines
+  void load() {
+    const fs::file file(profile_path);
+
+    if (!file) {
+      return;
+    }
+
+    const std::string data = file.to_string();
+    std::string_view rest = data;
+    bool header = true;
+
+    while (!rest.empty()) {
+      const usz eol = rest.find('\n');
+      const std::string_view line = rest.substr(0, eol);
+      rest.remove_prefix(eol == umax ? rest.size() : eol + 1);
+
+      if (header) {
+        header = false;
+
+        if (!line.starts_with("boot_io 1 "sv)) {
+          return;
+        }
+
+        const auto tail = line.substr(10);
+        std::from_chars(tail.data(), tail.data() + tail.size(), misses);
+        continue;
+      }
+
+      boot_io_profile_entry entry{};
+      const char *pos = line.data();
+      const char *end = line.data() + line.size();
+
+      auto res = std::from_chars(pos, end, entry.offset);
+
+      if (res.ec != std::errc{} || res.ptr == end || *res.ptr != ' ') {
+        continue;
+      }
+
+      res = std::from_chars(res.ptr + 1, end, entry.length);
+
+      if (res.ec != std::errc{} || res.ptr == end || *res.ptr != ' ') {
+        continue;
+      }
+
+      entry.path.assign(res.ptr + 1, end);
+      previous.emplace_back(std::move(entry));
+    }
+  }
+
+  void finish() {
+    std::lock_guard lock(mutex);
+
+    if (!started || finished || profile_path.empty()) {
+      return;
+    }
+
+    finished = true;
+
+    std::lock_guard trace_lock(trace->mutex);
+    trace->recording = false;
+
+    if (trace->extents.empty()) {
+      return;
+    }
+
+    if (!previous.empty()) {
+      // Share of this boot's reads that the previous profile covered
+      std::unordered_map<std::string_view, std::vector<std::pair<u64, u64>>>
+          predicted;
+
+      for (const auto &entry : previous) {
+        predicted[entry.path].emplace_back(entry.offset,
+                                           entry.offset + entry.length);
+      }
+
+      u64 total = 0;
+      u64 covered = 0;
+
+      for (const auto &extent : trace->extents) {
+        const u64 begin = extent.offset;
+        const u64 end = extent.offset + extent.length;
+        total += extent.length;
+
+        if (auto found = predicted.find(trace->paths[extent.path]);
+            found != predicted.end()) {
+          for (const auto &[pbegin, pend] : found->second) {
+            if (pbegin < end && begin < pend) {
+              covered += std::min(end, pend) - std::max(begin, pbegin);
+            }
+          }
+        }
+      }
+
+      const bool hit = total && covered * 2 >= total;
+      misses = hit ? 0 : misses + 1;
+
+      sys_fs.notice("Boot I/O profile: %u%% of %u KB predicted (replayed=%d, "
+                    "misses=%u)",
+                    total ? std::min<u64>(covered * 100 / total, 100) : 0,
+                    total / 1024, replayed, misses);
+    }
+
+    std::string out = fmt::format("boot_io 1 %u\n", misses);
+
+    for (const auto &extent : trace->extents) {
+      fmt::append(out, "%u %u %s\n", extent.offset, extent.length,
+                  trace->paths[extent.path]);
+    }
+
+    if (!fs::create_path(fs::get_parent_dir(profile_path))) {
+      return;
+    }
+
+    if (fs::pending_file file(profile_path); file.file) {
+      file.file.write(out);
+      file.commit();
+    }
+  }
+
+  static void replay(const std::vector<boot_io_profile_entry> &entries,
+                     boot_io_trace &trace) {
+#ifndef _WIN32
+#ifdef __linux__
+    // Below the guest threads: only idle cycles go to prefetching
+    setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 10);
+#endif
+
+    std::unordered_map<std::string_view, int> fds;
+    u64 issued = 0;
+
+    for (const auto &entry : entries) {
+      // Stay a bounded distance ahead of the guest
+      while (issued > trace.guest_bytes + boot_io_replay_lead) {
+        if (thread_ctrl::state() == thread_state::aborting ||
+            !trace.recording) {
+          break;
+        }
+
+        thread_ctrl::wait_for(5000);
+      }
+
+      if (thread_ctrl::state() == thread_state::aborting ||
+          !trace.recording || issued >= boot_io_replay_max_bytes) {
+        break;
+      }
+
+      auto [found, inserted] = fds.try_emplace(entry.path, -1);
+
+      if (inserted) {
+        found->second = ::open(entry.path.c_str(), O_RDONLY | O_CLOEXEC);
+      }
+
+      if (found->second < 0) {
+        continue;
+      }
+
+      ::posix_fadvise(found->second, entry.offset, entry.length,
+                      POSIX_FADV_WILLNEED);
+      issued += entry.length;
+    }
+
+    for (const auto &[path, fd] : fds) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+#else
+    (void)entries;
+    (void)trace;
+#endif
+  }
+};
+} // namespace
+
 std::pair<CellError, std::string> translate_to_str(vm::cptr<char> ptr,
                                                    bool is_path = true) {
   constexpr usz max_length = CELL_FS_MAX_FS_PATH_LENGTH + 1;
@@ -736,6 +1488,11 @@ lv2_file::open_raw_result_t lv2_file::open_raw(const std::string &local_path,
                                                const lv2_fs_mount_info &mp) {
   // TODO: other checks for path
 
+  if (mp.read_only && !(flags & CELL_FS_O_CREAT) &&
+      lv2_fs_missing_cache::get().contains(local_path)) {
+    return {CELL_ENOENT};
+  }
+
   if (fs::is_dir(local_path)) {
     return {CELL_EISDIR};
   }
@@ -848,6 +1605,10 @@ lv2_file::open_raw_result_t lv2_file::open_raw(const std::string &local_path,
 
     switch (auto error = fs::g_tls_error) {
     case fs::error::noent:
+      if (mp.read_only) {
+        lv2_fs_missing_cache::get().insert(local_path);
+      }
+
       return {CELL_ENOENT};
     default:
       sys_fs.error("lv2_file::open(): unknown error %s", error);
@@ -856,6 +1617,16 @@ lv2_file::open_raw_result_t lv2_file::open_raw(const std::string &local_path,
     return {CELL_EIO};
   }
 
+  if (open_mode == fs::read && g_cfg.vfs.file_readahead) {
+    file = make_readahead_file(std::move(file));
+  }
+
+  if (open_mode == fs::read && g_cfg.vfs.boot_io_prefetch) {
+    if (auto boot_io = g_fxo->try_get<lv2_fs_boot_io>()) {
+      file = boot_io->wrap(local_path, std::move(file));
+    }
+  }
+
   if (flags & CELL_FS_O_MSELF && !verify_mself(file)) {
     return {CELL_ENOTMSELF};
   }
@@ -1460,6 +2231,11 @@ error_code sys_fs_stat(ppu_thread &ppu, vm::cptr<char> path,
     return {sys_fs.warning, CELL_ENOTMOUNTED, path};
   }
 
+  if (mp.read_only && lv2_fs_missing_cache::get().contains(local_path)) {
+    return {mp == &g_mp_sys_dev_hdd1 ? sys_fs.warning : sys_fs.error,
+            CELL_ENOENT, path};
+  }
+
   std::unique_lock lock(mp->mutex);
 
   fs::stat_t info{};
@@ -1487,6 +2263,10 @@ error_code sys_fs_stat(ppu_thread &ppu, vm::cptr<char> path,
         break;
       }
 
+      if (mp.read_only) {
+        lv2_fs_missing_cache::get().insert(local_path);
+      }
+
       return {mp == &g_mp_sys_dev_hdd1 ? sys_fs.warning : sys_fs.error,
               CELL_ENOENT, path};
     }
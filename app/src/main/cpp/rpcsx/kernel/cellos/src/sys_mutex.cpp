@@ -138,6 +138,18 @@ error_code sys_mutex_lock(ppu_thread &ppu, u32 mutex_id, u64 timeout) {
   sys_mutex.trace("sys_mutex_lock(mutex_id=0x%x, timeout=0x%llx)", mutex_id,
                   timeout);
 
+  // Uncontended fast path: resolved on the control word without taking a
+  // reference to the object or postponing notifications
+  if (const auto mutex = idm::check<lv2_obj, lv2_mutex>(
+          mutex_id, [&](lv2_mutex &mutex) { return mutex.try_lock(ppu); });
+      mutex && mutex.ret != CELL_EBUSY) {
+    if (mutex.ret) {
+      return mutex.ret;
+    }
+
+    return CELL_OK;
+  }
+
   const auto mutex = idm::get<lv2_obj, lv2_mutex>(
       mutex_id, [&, notify = lv2_obj::notify_all_t()](lv2_mutex &mutex) {
         CellError result = mutex.try_lock(ppu);
@@ -302,6 +314,17 @@ error_code sys_mutex_unlock(ppu_thread &ppu, u32 mutex_id) {
 
   sys_mutex.trace("sys_mutex_unlock(mutex_id=0x%x)", mutex_id);
 
+  // No waiters: release on the control word without postponing notifications
+  if (const auto mutex = idm::check<lv2_obj, lv2_mutex>(
+          mutex_id, [&](lv2_mutex &mutex) { return mutex.try_unlock(ppu); });
+      mutex && mutex.ret != CELL_EBUSY) {
+    if (mutex.ret) {
+      return mutex.ret;
+    }
+
+    return CELL_OK;
+  }
+
   const auto mutex = idm::check<lv2_obj, lv2_mutex>(
       mutex_id,
       [&, notify = lv2_obj::notify_all_t()](lv2_mutex &mutex) -> CellError {
@@ -857,7 +857,7 @@ lv2_socket_native::recvfrom(s32 flags, u32 len, bool is_lock) {
         nph.get_dns_ip();
     const auto sn_addr = native_addr_to_sys_net_addr(native_addr);
 
-    return {{::narrow<s32>(packet.size()), res_buf, sn_addr}};
+    return {{::narrow<s32>(packet.size()), std::move(res_buf), sn_addr}};
   }
 
   if (flags & SYS_NET_MSG_PEEK) {
@@ -875,7 +875,7 @@ lv2_socket_native::recvfrom(s32 flags, u32 len, bool is_lock) {
 
   if (native_result >= 0) {
     const auto sn_addr = native_addr_to_sys_net_addr(native_addr);
-    return {{::narrow<s32>(native_result), res_buf, sn_addr}};
+    return {{::narrow<s32>(native_result), std::move(res_buf), sn_addr}};
   }
 #ifdef _WIN32
   else {
@@ -883,7 +883,7 @@ lv2_socket_native::recvfrom(s32 flags, u32 len, bool is_lock) {
     // long enough to contain the whole message, should be ignored
     if ((native_flags & MSG_PEEK) && get_native_error() == WSAEMSGSIZE) {
       const auto sn_addr = native_addr_to_sys_net_addr(native_addr);
-      return {{len, res_buf, sn_addr}};
+      return {{len, std::move(res_buf), sn_addr}};
     }
     // Windows will return WSASHUTDOWN when the connection is shutdown, POSIX
     // just returns EOF (0) in this situation.
@@ -249,7 +249,7 @@ lv2_socket_p2p::recvfrom(s32 flags, u32 len, bool is_lock) {
 
   data.pop();
 
-  return {{native_result, res_buf, sn_addr}};
+  return {{native_result, std::move(res_buf), sn_addr}};
 }
 
 std::optional<s32>
@@ -7,6 +7,11 @@
 #include "sys_net/network_context.h"
 #include "sys_net/sys_net_helpers.h"
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
 LOG_CHANNEL(sys_net);
 
 // Used by RPCN to send signaling packets to RPCN server(for UDP hole punching)
@@ -155,7 +160,24 @@ void base_network_thread::wake_threads() {
   }
 }
 
-p2p_thread::p2p_thread() { np::init_np_handler_dependencies(); }
+p2p_thread::p2p_thread() {
+#ifdef __linux__
+  p2p_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+
+  if (p2p_epoll == -1) {
+    fmt::throw_exception("Failed to create epoll for P2P sockets: %s!",
+                         get_last_error(true));
+  }
+#endif
+
+  np::init_np_handler_dependencies();
+}
+
+p2p_thread::~p2p_thread() {
+#ifdef __linux__
+  ::close(p2p_epoll);
+#endif
+}
 
 void p2p_thread::bind_sce_np_port() {
   std::lock_guard list_lock(list_p2p_ports_mutex);
@@ -235,6 +257,16 @@ void p2p_thread::create_p2p_port(u16 p2p_port) {
     list_p2p_ports.emplace(std::piecewise_construct,
                            std::forward_as_tuple(p2p_port),
                            std::forward_as_tuple(p2p_port));
+#ifdef __linux__
+    // Map nodes are stable and ports are never removed
+    auto &port = ::at32(list_p2p_ports, p2p_port);
+    ::epoll_event event{.events = EPOLLIN, .data = {.ptr = &port}};
+
+    if (::epoll_ctl(p2p_epoll, EPOLL_CTL_ADD, port.p2p_socket, &event) != 0) {
+      sys_net.error("[P2P] Failed to add P2P port %d to epoll: %s", p2p_port,
+                    get_last_error(false));
+    }
+#endif
     const u32 prev_value = num_p2p_ports.fetch_add(1);
     if (!prev_value) {
       num_p2p_ports.notify_one();
@@ -243,7 +275,11 @@ void p2p_thread::create_p2p_port(u16 p2p_port) {
 }
 
 void p2p_thread::operator()() {
+#ifdef __linux__
+  std::array<::epoll_event, 16> events;
+#else
   std::vector<::pollfd> p2p_fd(lv2_socket::id_count);
+#endif
 
   while (thread_ctrl::state() != thread_state::aborting) {
     if (!num_p2p_ports) {
@@ -251,6 +287,28 @@ void p2p_thread::operator()() {
       continue;
     }
 
+#ifdef __linux__
+    // Ports added meanwhile are registered directly, so the timeout only
+    // bounds how long it takes to notice abort
+    const auto ret_p2p =
+        ::epoll_wait(p2p_epoll, events.data(), ::size32(events), 100);
+
+    if (ret_p2p > 0) {
+      std::lock_guard lock(list_p2p_ports_mutex);
+
+      for (int i = 0; i < ret_p2p; i++) {
+        auto &p2p_port = *static_cast<nt_p2p_port *>(events[i].data.ptr);
+
+        while (p2p_port.recv_data())
+          ;
+      }
+
+      wake_threads();
+    } else if (ret_p2p < 0 && errno != EINTR) {
+      sys_net.error("[P2P] Error epoll_wait on P2P sockets: %d",
+                    get_last_error(false));
+    }
+#else
     // Check P2P sockets for incoming packets
     auto num_p2p_sockets = 0;
     std::memset(p2p_fd.data(), 0, p2p_fd.size() * sizeof(::pollfd));
@@ -295,5 +353,6 @@ void p2p_thread::operator()() {
       sys_net.error("[P2P] Error poll on master P2P socket: %d",
                     get_last_error(false));
     }
+#endif
   }
 }
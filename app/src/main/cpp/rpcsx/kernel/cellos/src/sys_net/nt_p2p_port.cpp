@@ -147,12 +147,32 @@ bool nt_p2p_port::handle_listening(s32 sock_id,
 }
 
 bool nt_p2p_port::recv_data() {
-  ::sockaddr_storage native_addr{};
-  ::socklen_t native_addrlen = sizeof(native_addr);
+  std::array<::sockaddr_storage, recv_batch_size> native_addrs{};
+  u32 num_packets = 0;
+
+#ifdef __linux__
+  // Drain up to recv_batch_size datagrams with a single syscall
+  std::array<::mmsghdr, recv_batch_size> msgs{};
+  std::array<::iovec, recv_batch_size> iovs{};
+
+  for (u32 i = 0; i < recv_batch_size; i++) {
+    iovs[i].iov_base = p2p_recv_data[i].data();
+    iovs[i].iov_len = p2p_recv_data[i].size();
+    msgs[i].msg_hdr.msg_name = &native_addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(::sockaddr_storage);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  const auto recv_res =
+      ::recvmmsg(p2p_socket, msgs.data(), recv_batch_size, 0, nullptr);
+#else
+  ::socklen_t native_addrlen = sizeof(::sockaddr_storage);
   const auto recv_res = ::recvfrom(
-      p2p_socket, reinterpret_cast<char *>(p2p_recv_data.data()),
-      ::size32(p2p_recv_data), 0,
-      reinterpret_cast<struct sockaddr *>(&native_addr), &native_addrlen);
+      p2p_socket, reinterpret_cast<char *>(p2p_recv_data[0].data()),
+      ::size32(p2p_recv_data[0]), 0,
+      reinterpret_cast<struct sockaddr *>(&native_addrs[0]), &native_addrlen);
+#endif
 
   if (recv_res == -1) {
     auto lerr = get_last_error(false);
@@ -163,12 +183,31 @@ bool nt_p2p_port::recv_data() {
     return false;
   }
 
+#ifdef __linux__
+  num_packets = static_cast<u32>(recv_res);
+
+  for (u32 i = 0; i < num_packets; i++) {
+    handle_packet(p2p_recv_data[i].data(), static_cast<s32>(msgs[i].msg_len),
+                  native_addrs[i]);
+  }
+#else
+  num_packets = 1;
+  handle_packet(p2p_recv_data[0].data(), static_cast<s32>(recv_res),
+                native_addrs[0]);
+#endif
+
+  // A short batch means the socket queue is empty, skip the EWOULDBLOCK call
+  return num_packets == recv_batch_size;
+}
+
+void nt_p2p_port::handle_packet(u8 *buf, s32 recv_res,
+                                ::sockaddr_storage &native_addr) {
   if (recv_res < static_cast<s32>(sizeof(u16))) {
     sys_net.error("Received badly formed packet on P2P port(no vport)!");
-    return true;
+    return;
   }
 
-  u16 dst_vport = reinterpret_cast<le_t<u16> &>(p2p_recv_data[0]);
+  u16 dst_vport = reinterpret_cast<le_t<u16> &>(buf[0]);
 
   if (is_ipv6) {
     const auto *addr_ipv6 = reinterpret_cast<sockaddr_in6 *>(&native_addr);
@@ -180,20 +219,20 @@ bool nt_p2p_port::recv_data() {
   if (dst_vport == 0) {
     if (recv_res < VPORT_0_HEADER_SIZE) {
       sys_net.error("Bad vport 0 packet(no subset)!");
-      return true;
+      return;
     }
 
-    const u8 subset = p2p_recv_data[2];
+    const u8 subset = buf[2];
     const auto data_size = recv_res - VPORT_0_HEADER_SIZE;
-    std::vector<u8> vport_0_data(p2p_recv_data.data() + VPORT_0_HEADER_SIZE,
-                                 p2p_recv_data.data() + VPORT_0_HEADER_SIZE +
+    std::vector<u8> vport_0_data(buf + VPORT_0_HEADER_SIZE,
+                                 buf + VPORT_0_HEADER_SIZE +
                                      data_size);
 
     switch (subset) {
     case SUBSET_RPCN: {
       std::lock_guard lock(s_rpcn_mutex);
       rpcn_msgs.push_back(std::move(vport_0_data));
-      return true;
+      return;
     }
     case SUBSET_SIGNALING: {
       signaling_message msg;
@@ -210,25 +249,25 @@ bool nt_p2p_port::recv_data() {
 
       auto &sigh = g_fxo->get<named_thread<signaling_handler>>();
       sigh.wake_up();
-      return true;
+      return;
     }
     default: {
       sys_net.error("Invalid vport 0 subset!");
-      return true;
+      return;
     }
     }
   }
 
   if (recv_res < VPORT_P2P_HEADER_SIZE) {
-    return true;
+    return;
   }
 
   const u16 src_vport =
-      *reinterpret_cast<le_t<u16> *>(p2p_recv_data.data() + sizeof(u16));
+      *reinterpret_cast<le_t<u16> *>(buf + sizeof(u16));
   const u16 vport_flags = *reinterpret_cast<le_t<u16> *>(
-      p2p_recv_data.data() + sizeof(u16) + sizeof(u16));
+      buf + sizeof(u16) + sizeof(u16));
   std::vector<u8> p2p_data(recv_res - VPORT_P2P_HEADER_SIZE);
-  memcpy(p2p_data.data(), p2p_recv_data.data() + VPORT_P2P_HEADER_SIZE,
+  memcpy(p2p_data.data(), buf + VPORT_P2P_HEADER_SIZE,
          p2p_data.size());
 
   if (vport_flags & P2P_FLAG_P2P) {
@@ -266,14 +305,14 @@ bool nt_p2p_port::recv_data() {
         }
       }
 
-      return true;
+      return;
     }
   } else if (vport_flags & P2P_FLAG_P2PS) {
     if (p2p_data.size() < sizeof(p2ps_encapsulated_tcp)) {
       sys_net.notice("Received P2P packet targeted at unbound vport(likely) or "
                      "invalid(vport=%d)",
                      dst_vport);
-      return true;
+      return;
     }
 
     auto *tcp_header =
@@ -283,20 +322,20 @@ bool nt_p2p_port::recv_data() {
     if (tcp_header->signature != P2PS_U2S_SIG) {
       sys_net.notice("Received P2P packet targeted at unbound vport(vport=%d)",
                      dst_vport);
-      return true;
+      return;
     }
 
     if (tcp_header->length !=
         (p2p_data.size() - sizeof(p2ps_encapsulated_tcp))) {
       sys_net.error(
           "Received STREAM-P2P packet tcp length didn't match packet length");
-      return true;
+      return;
     }
 
     // Sanity check
     if (tcp_header->dst_port != dst_vport) {
       sys_net.error("Received STREAM-P2P packet with dst_port != vport");
-      return true;
+      return;
     }
 
     // Validate checksum
@@ -306,7 +345,7 @@ bool nt_p2p_port::recv_data() {
         u2s_tcp_checksum(reinterpret_cast<const le_t<u16> *>(p2p_data.data()),
                          p2p_data.size())) {
       sys_net.error("Checksum is invalid, dropping packet!");
-      return true;
+      return;
     }
 
     // The packet is valid
@@ -328,7 +367,7 @@ bool nt_p2p_port::recv_data() {
         handle_connected(sock_id, tcp_header,
                          p2p_data.data() + sizeof(p2ps_encapsulated_tcp),
                          &native_addr);
-        return true;
+        return;
       }
 
       if (bound_p2ps_vports.contains(tcp_header->dst_port)) {
@@ -342,12 +381,12 @@ bool nt_p2p_port::recv_data() {
                            p2p_data.data() + sizeof(p2ps_encapsulated_tcp),
                            &native_addr);
         }
-        return true;
+        return;
       }
 
       if (tcp_header->flags == p2ps_tcp_flags::RST) {
         sys_net.trace("[P2PS] Received RST on unbound P2PS");
-        return true;
+        return;
       }
 
       // The P2PS packet was sent to an unbound vport, send a RST packet
@@ -363,15 +402,14 @@ bool nt_p2p_port::recv_data() {
               reinterpret_cast<const sockaddr_in *>(&native_addr), 0) == -1) {
         sys_net.error("[P2PS] Error sending RST to sender to unbound P2PS: %s",
                       get_last_error(false));
-        return true;
+        return;
       }
 
       sys_net.trace("[P2PS] Sent RST to sender to unbound P2PS");
-      return true;
+      return;
     }
   }
 
   sys_net.notice("Received a P2P packet with no bound target(dst_vport = %d)",
                  dst_vport);
-  return true;
 }
@@ -22,6 +22,7 @@ extern bool ppu_initialize(const ppu_module<lv2_obj> &, bool check_only = false,
                            u64 file_size = 0);
 extern void ppu_finalize(const ppu_module<lv2_obj> &info,
                          bool force_mem_release = false);
+extern void ppu_notify_code_invalidated(u32 addr, u32 size);
 
 LOG_CHANNEL(sys_overlay);
 
@@ -201,6 +202,7 @@ error_code sys_overlay_unload_module(u32 ovlmid) {
   }
 
   for (auto &seg : _main->segs) {
+    ppu_notify_code_invalidated(seg.addr, seg.size);
     vm::dealloc(seg.addr);
   }
 
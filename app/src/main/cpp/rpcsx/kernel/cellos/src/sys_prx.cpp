@@ -26,6 +26,8 @@ extern shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object &,
                                         bool virtual_load, const std::string &,
                                         s64, utils::serial * = nullptr);
 extern void ppu_unload_prx(const lv2_prx &prx);
+extern fs::file ppu_get_firmware_image(const std::string &path);
+extern void ppu_add_firmware_image(const std::string &path, const fs::file &elf);
 extern bool ppu_initialize(const ppu_module<lv2_obj> &, bool check_only = false,
                            u64 file_size = 0);
 extern void ppu_finalize(const ppu_module<lv2_obj> &info,
@@ -247,31 +249,44 @@ prx_load_module(const std::string &vpath, u64 flags,
     return hle_load();
   }
 
-  if (!src) {
-    auto [fs_error, ppath, path0, lv2_file, type] = lv2_file::open(vpath, 0, 0);
+  // Firmware modules opened by path come decrypted from the firmware image pack
+  const bool use_firmware_image = is_firmware_sprx && !src;
+  fs::file elf = use_firmware_image ? ppu_get_firmware_image(path) : fs::file{};
+
+  if (!elf) {
+    if (!src) {
+      auto [fs_error, ppath, path0, lv2_file, type] =
+          lv2_file::open(vpath, 0, 0);
+
+      if (fs_error) {
+        if (fs_error + 0u == CELL_ENOENT && is_firmware_sprx) {
+          sys_prx.error(
+              "firmware SPRX not found: \"%s\" (forcing HLE implementation)",
+              vpath, idm::last_id());
+          return hle_load();
+        }
 
-    if (fs_error) {
-      if (fs_error + 0u == CELL_ENOENT && is_firmware_sprx) {
-        sys_prx.error(
-            "firmware SPRX not found: \"%s\" (forcing HLE implementation)",
-            vpath, idm::last_id());
-        return hle_load();
+        return {fs_error, vpath};
       }
 
-      return {fs_error, vpath};
+      src = std::move(lv2_file);
     }
 
-    src = std::move(lv2_file);
-  }
+    u128 klic = g_fxo->get<loaded_npdrm_keys>().last_key();
 
-  u128 klic = g_fxo->get<loaded_npdrm_keys>().last_key();
+    elf = decrypt_self(std::move(src), reinterpret_cast<u8 *>(&klic));
 
-  src = decrypt_self(std::move(src), reinterpret_cast<u8 *>(&klic));
+    if (!elf) {
+      return {CELL_PRX_ERROR_UNSUPPORTED_PRX_TYPE, +"Failed to decrypt file"};
+    }
 
-  if (!src) {
-    return {CELL_PRX_ERROR_UNSUPPORTED_PRX_TYPE, +"Failed to decrypt file"};
+    if (use_firmware_image) {
+      ppu_add_firmware_image(path, elf);
+    }
   }
 
+  src = std::move(elf);
+
   const auto src_data =
       g_cfg.core.ppu_debug ? src.to_vector<u8>() : std::vector<u8>{};
 
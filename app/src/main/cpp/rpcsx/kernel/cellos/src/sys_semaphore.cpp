@@ -114,6 +114,13 @@ error_code sys_semaphore_wait(ppu_thread &ppu, u32 sem_id, u64 timeout) {
   sys_semaphore.trace("sys_semaphore_wait(sem_id=0x%x, timeout=0x%llx)", sem_id,
                       timeout);
 
+  // Uncontended fast path: take a count without referencing the object
+  if (const auto sem = idm::check<lv2_obj, lv2_sema>(
+          sem_id, [&](lv2_sema &sema) { return sema.val.try_dec(0); });
+      sem && sem.ret) {
+    return CELL_OK;
+  }
+
   const auto sem = idm::get<lv2_obj, lv2_sema>(
       sem_id, [&, notify = lv2_obj::notify_all_t()](lv2_sema &sema) {
         const s32 val = sema.val;
@@ -231,6 +238,20 @@ error_code sys_semaphore_post(ppu_thread &ppu, u32 sem_id, s32 count) {
   sys_semaphore.trace("sys_semaphore_post(sem_id=0x%x, count=%d)", sem_id,
                       count);
 
+  // No waiters: add the count without referencing the object
+  if (count > 0) {
+    if (const auto sem = idm::check<lv2_obj, lv2_sema>(
+            sem_id,
+            [&](lv2_sema &sema) {
+              const s32 val = sema.val;
+              return val >= 0 && count <= sema.max - val &&
+                     sema.val.compare_and_swap_test(val, val + count);
+            });
+        sem && sem.ret) {
+      return CELL_OK;
+    }
+  }
+
   const auto sem = idm::get<lv2_obj, lv2_sema>(sem_id, [&](lv2_sema &sema) {
     const s32 val = sema.val;
 
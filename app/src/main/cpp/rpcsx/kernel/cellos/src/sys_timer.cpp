@@ -114,7 +114,9 @@ void lv2_timer_thread::operator()() {
     sleep_time = umax;
 
     if (Emu.IsPausedOrReady()) {
-      sleep_time = 10000;
+      // Emulator::Resume() wakes this thread, only the boot transition is
+      // polled (guest time does not advance while paused)
+      sleep_time = Emu.IsPaused() ? umax : 10000;
       continue;
     }
 
@@ -140,6 +142,12 @@ void lv2_timer_thread::operator()() {
   }
 }
 
+void lv2_timer_wake_up() {
+  if (auto thread = g_fxo->try_get<named_thread<lv2_timer_thread>>()) {
+    (*thread)([] {});
+  }
+}
+
 error_code sys_timer_create(ppu_thread &ppu, vm::ptr<u32> timer_id) {
   ppu.state += cpu_flag::wait;
 
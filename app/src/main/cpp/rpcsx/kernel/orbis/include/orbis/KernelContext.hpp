@@ -142,6 +142,10 @@ public:
   FwType fwType = FwType::Unknown;
   bool isDevKit = false;
 
+  // Guest threads below the default priority share this many host CPUs,
+  // 0 - each follows its own affinity
+  uint lowPrioCpuCount{};
+
   rx::Ref<Budget> createProcessTypeBudget(Budget::ProcessType processType,
                                           std::string_view name,
                                           std::span<const BudgetInfo> items) {
@@ -3,12 +3,29 @@
 #include "note.hpp"
 #include "rx/SharedCV.hpp"
 #include <list>
+#include <utility>
 
 namespace orbis {
 struct KQueue : orbis::File {
+  using NoteList = std::list<KNote, kallocator<KNote>>;
+
   rx::shared_cv cv;
   kstring name;
-  kvector<KEvent> triggeredEvents;
-  std::list<KNote, kallocator<KNote>> notes;
+
+  // Notes triggered since they were last collected, kevent() visits only
+  // these. Leaf lock, taken with the note locked
+  rx::shared_mutex readyMtx;
+  kvector<KNote *> readyNotes;
+
+  // Notes on host descriptors without an emitter, kevent() select()s them
+  kvector<KNote *> polledNotes;
+
+  // Declared after the ready list: destroying a note unlinks it from there
+  NoteList notes;
+  kmap<std::pair<uintptr_t, sshort>, NoteList::iterator> noteIndex;
+
+  // Queue a note that was just triggered and wake kevent()
+  void notifyReady(KNote *note);
+  void removeReady(KNote *note);
 };
 } // namespace orbis
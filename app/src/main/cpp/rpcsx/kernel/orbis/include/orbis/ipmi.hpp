@@ -6,6 +6,7 @@
 #include "rx/Rc.hpp"
 #include "rx/SharedCV.hpp"
 #include "rx/SharedMutex.hpp"
+#include <cstring>
 #include <list>
 #include <optional>
 
@@ -14,6 +15,50 @@ struct IpmiSession;
 struct IpmiClient;
 struct Thread;
 
+// Bytes of a queued message or response. System service calls are mostly a
+// header and a few small arguments, those stay inline in the queue entry and
+// cost one copy in and one copy out instead of a kernel heap allocation
+class IpmiMessage {
+public:
+  static constexpr std::size_t kInlineCapacity = 0x100;
+
+  IpmiMessage() = default;
+  explicit IpmiMessage(std::size_t size) { resize(size); }
+  IpmiMessage(const void *data, std::size_t size) {
+    resize(size);
+    std::memcpy(this->data(), data, size);
+  }
+
+  void resize(std::size_t size) {
+    if (size > kInlineCapacity) {
+      if (mSize <= kInlineCapacity) {
+        mHeap.assign(mInline, mInline + mSize);
+      }
+      mHeap.resize(size);
+    } else if (mSize > kInlineCapacity) {
+      std::memcpy(mInline, mHeap.data(), size);
+      mHeap = {};
+    } else if (size > mSize) {
+      // Zero-filled like a vector, messages are not always written fully
+      std::memset(mInline + mSize, 0, size - mSize);
+    }
+
+    mSize = size;
+  }
+
+  std::byte *data() { return mSize > kInlineCapacity ? mHeap.data() : mInline; }
+  const std::byte *data() const {
+    return mSize > kInlineCapacity ? mHeap.data() : mInline;
+  }
+  std::size_t size() const { return mSize; }
+  bool empty() const { return mSize == 0; }
+
+private:
+  std::size_t mSize = 0;
+  kvector<std::byte> mHeap;
+  alignas(8) std::byte mInline[kInlineCapacity];
+};
+
 struct IpmiServer : rx::RcBase {
   struct IpmiPacketInfo {
     ulong inputSize;
@@ -28,7 +73,7 @@ struct IpmiServer : rx::RcBase {
     IpmiPacketInfo info;
     lwpid_t clientTid;
     rx::Ref<IpmiSession> session;
-    kvector<std::byte> message;
+    IpmiMessage message;
   };
 
   struct ConnectionRequest {
@@ -56,13 +101,13 @@ struct IpmiServer : rx::RcBase {
 struct IpmiClient : rx::RcBase {
   struct MessageQueue {
     rx::shared_cv messageCv;
-    kdeque<kvector<std::byte>> messages;
+    kdeque<IpmiMessage> messages;
   };
 
   struct AsyncResponse {
     uint methodId;
     sint errorCode;
-    kvector<kvector<std::byte>> data;
+    kvector<IpmiMessage> data;
   };
 
   kstring name;
@@ -86,7 +131,7 @@ struct IpmiSession : rx::RcBase {
   struct SyncResponse {
     sint errorCode;
     std::uint32_t callerTid;
-    kvector<kvector<std::byte>> data;
+    kvector<IpmiMessage> data;
   };
 
   ptr<void> sessionImpl;
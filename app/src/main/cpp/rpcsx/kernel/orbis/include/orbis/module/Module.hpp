@@ -7,7 +7,9 @@
 #include "rx/Rc.hpp"
 
 #include "orbis-config.hpp"
+#include <span>
 #include <string>
+#include <utility>
 
 namespace orbis {
 struct Thread;
@@ -112,6 +114,8 @@ struct Module final {
 
   kstring interp;
   kvector<Symbol> symbols;
+  // (id, symbol index) of non-local symbols, sorted
+  kvector<std::pair<std::uint64_t, std::uint32_t>> exportIndex;
   kvector<Relocation> pltRelocations;
   kvector<Relocation> nonPltRelocations;
   kvector<ModuleNeeded> neededModules;
@@ -137,6 +141,13 @@ struct Module final {
 
   orbis::SysResult relocate(Process *process);
 
+  // Call once symbols are loaded, every importer looks symbols up through it
+  void buildExportIndex();
+
+  // Non-local symbols with the id, in symbol table order
+  std::span<const std::pair<std::uint64_t, std::uint32_t>>
+  findExports(std::uint64_t id) const;
+
   void operator delete(void *pointer);
 
 private:
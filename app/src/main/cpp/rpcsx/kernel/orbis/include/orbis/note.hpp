@@ -81,6 +81,7 @@ struct KNote {
   KEvent event{};
   bool enabled = true;
   bool triggered = false;
+  bool queued = false; // In queue->readyNotes, guarded by queue->readyMtx
   void *linked = nullptr; // TODO: use rx::Ref<>
   kvector<rx::Ref<EventEmitter>> emitters;
 
@@ -88,8 +89,12 @@ struct KNote {
 };
 
 struct EventEmitter : rx::RcBase {
+  using NoteSet = std::set<KNote *, std::less<>, kallocator<KNote *>>;
+
   rx::shared_mutex mutex;
-  std::set<KNote *, std::less<>, kallocator<KNote *>> notes;
+
+  // By filter, emit() visits only the notes it can trigger
+  kmap<sshort, NoteSet> notes;
 
   void emit(sshort filter, uint fflags = 0, intptr_t data = 0,
             uintptr_t ident = std::numeric_limits<uintptr_t>::max());
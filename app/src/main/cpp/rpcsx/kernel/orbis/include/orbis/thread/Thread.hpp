@@ -44,6 +44,13 @@ struct Thread final {
       .type = 2,
       .prio = 10,
   };
+
+  // Priorities inherited from threads sleeping on PI umutexes this thread
+  // owns, keyed by umutex address
+  rx::shared_mutex piMtx;
+  kmap<std::uintptr_t, std::uint16_t> piBoosts;
+  std::uint16_t hostPrio = 0;  // last priority applied to the host thread
+  bool hostCollapsed = false;  // runs on the low priority host CPU set
   rx::shared_mutex suspend_mtx;
   rx::shared_cv suspend_cv;
   kvector<UContext> sigReturns;
@@ -85,6 +92,16 @@ struct Thread final {
   void notifyUnblockedSignal(int signo);
   void setSigMask(SigSet newSigMask);
 
+  // Base priority or the best inherited one, lower value is more urgent
+  std::uint16_t getEffectivePriority();
+
+  // Map the effective priority onto host nice/SCHED_FIFO and the low priority
+  // CPU set, no-op until the host thread exists
+  void updateHostPriority();
+
+  void inheritPriority(std::uintptr_t key, std::uint16_t priority);
+  void disinheritPriority(std::uintptr_t key);
+
   template <rx::Serializable T>
   T *get(kernel::StaticObjectRef<OrbisNamespace, kernel::detail::ThreadScope, T>
              ref) {
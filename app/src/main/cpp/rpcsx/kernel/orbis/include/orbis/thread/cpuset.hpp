@@ -1,9 +1,12 @@
 #pragma once
 
 #include "orbis-config.hpp"
+#include <sched.h>
 
 namespace orbis {
 struct cpuset {
   uint bits;
 };
+
+cpu_set_t toHostCpuSet(cpuset cpuSet);
 } // namespace orbis
@@ -3,6 +3,9 @@
 #include "rx/Serializer.hpp"
 #include "rx/SharedMutex.hpp"
 #include "rx/print.hpp"
+#include <array>
+#include <atomic>
+#include <pthread.h>
 #include <sys/mman.h>
 
 static const std::uint64_t g_allocProtWord = 0xDEADBEAFBADCAFE1;
@@ -10,6 +13,31 @@ static constexpr std::uintptr_t kHeapBaseAddress = 0x00000600'0000'0000;
 static constexpr auto kHeapSize = 0x1'0000'0000;
 static constexpr int kDebugHeap = 0;
 
+// Small allocations come from per-size-class slabs. Free blocks are kept in
+// a per-thread magazine first and spill to a lock-free per-class stack that
+// lives in the (process-shared) heap itself.
+static constexpr std::size_t kSlabSizes[] = {
+    16,  32,  48,  64,   80,   96,   112,  128,  160,  192,  224,
+    256, 320, 384, 448,  512,  640,  768,  896,  1024, 1280, 1536,
+    1792, 2048, 2560, 3072, 3584, 4096,
+};
+static constexpr std::size_t kSlabClassCount = std::size(kSlabSizes);
+static constexpr std::size_t kSlabMaxSize = kSlabSizes[kSlabClassCount - 1];
+static constexpr std::size_t kSlabChunkSize = 64 * 1024;
+static constexpr std::uint32_t kMagazineSize = 32;
+
+static constexpr auto kSlabClassIndex = [] {
+  std::array<std::uint8_t, kSlabMaxSize / 16 + 1> result{};
+  std::size_t cls = 0;
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    while (kSlabSizes[cls] < i * 16) {
+      cls++;
+    }
+    result[i] = static_cast<std::uint8_t>(cls);
+  }
+  return result;
+}();
+
 namespace orbis {
 struct KernelMemoryResource {
   mutable rx::shared_mutex m_heap_mtx;
@@ -19,6 +47,10 @@ struct KernelMemoryResource {
   kmultimap<std::size_t, void *> m_free_heap;
   kmultimap<std::size_t, void *> m_used_node;
 
+  // Per class free list head: low 32 bits are the heap offset of the first
+  // block (0 is empty), high 32 bits are an ABA tag bumped on every update
+  std::atomic<std::uint64_t> m_slab_free[kSlabClassCount]{};
+
   ~KernelMemoryResource() {
     ::munmap(std::bit_cast<void *>(kHeapBaseAddress), kHeapSize);
   }
@@ -27,6 +59,11 @@ struct KernelMemoryResource {
                std::size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__);
   void kfree(void *ptr, std::size_t size);
 
+  void *kallocSlab(std::size_t cls);
+  void kfreeSlab(std::size_t cls, void *ptr);
+  void pushSlabChain(std::size_t cls, void *first, void *last);
+  void *popSlab(std::size_t cls);
+
   void serialize(rx::Serializer &) const {
     // FIXME: implement
   }
@@ -41,6 +78,42 @@ struct KernelMemoryResource {
 static KernelMemoryResource *sMemoryResource;
 std::byte *g_globalStorage;
 
+static std::uint32_t toHeapOffset(void *ptr) {
+  return static_cast<std::uint32_t>(std::bit_cast<std::uintptr_t>(ptr) -
+                                    kHeapBaseAddress);
+}
+
+static void *fromHeapOffset(std::uint32_t offset) {
+  return std::bit_cast<void *>(kHeapBaseAddress + offset);
+}
+
+// Free blocks store the heap offset of the next free block in their first
+// word. Read atomically: a racing pop may hand the block out in between, the
+// tagged CAS then fails and the value is discarded.
+static std::atomic_ref<std::uint32_t> slabLink(void *ptr) {
+  return std::atomic_ref(*static_cast<std::uint32_t *>(ptr));
+}
+
+struct ThreadMagazine {
+  std::uint32_t count[kSlabClassCount]{};
+  void *items[kSlabClassCount][kMagazineSize];
+
+  ~ThreadMagazine() {
+    if (sMemoryResource == nullptr) {
+      return;
+    }
+
+    for (std::size_t cls = 0; cls < kSlabClassCount; ++cls) {
+      while (count[cls] > 0) {
+        void *ptr = items[cls][--count[cls]];
+        sMemoryResource->pushSlabChain(cls, ptr, ptr);
+      }
+    }
+  }
+};
+
+static thread_local ThreadMagazine tMagazine;
+
 using GlobalStorage =
     kernel::StaticKernelObjectStorage<OrbisNamespace,
                                       kernel::detail::GlobalScope>;
@@ -67,6 +140,17 @@ void initializeAllocator() {
   sMemoryResource = new (ptr) KernelMemoryResource();
   sMemoryResource->m_heap_next = ptr + sizeof(KernelMemoryResource);
 
+  // The heap is shared with forked processes, but the magazine of the forking
+  // thread is copied: leave its blocks to the parent
+  static bool sForkHandlerInstalled = [] {
+    return pthread_atfork(nullptr, nullptr, [] {
+             for (auto &count : tMagazine.count) {
+               count = 0;
+             }
+           }) == 0;
+  }();
+  (void)sForkHandlerInstalled;
+
   rx::print(stderr, "global: size {}, alignment {}\n", GlobalStorage::GetSize(),
             GlobalStorage::GetAlignment());
   // allocate whole global storage
@@ -87,6 +171,18 @@ void *KernelMemoryResource::kalloc(std::size_t size, std::size_t align) {
   if (!size)
     std::abort();
 
+  if (kDebugHeap == 0 && size <= kSlabMaxSize) {
+    auto cls = kSlabClassIndex[size / 16];
+
+    if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      return kallocSlab(cls);
+    }
+
+    // Over-aligned small objects still use the heap, but with the class size
+    // so that kfree can return them to the slab
+    size = kSlabSizes[cls];
+  }
+
   if (m_heap_map_mtx.try_lock()) {
     std::lock_guard lock(m_heap_map_mtx, std::adopt_lock);
 
@@ -195,6 +291,11 @@ void KernelMemoryResource::kfree(void *ptr, std::size_t size) {
   // std::fprintf(stderr, "kfree: release %p-%p, size = %lx\n", ptr,
   //              (char *)ptr + size, size);
 
+  if (kDebugHeap == 0 && size <= kSlabMaxSize) {
+    kfreeSlab(kSlabClassIndex[size / 16], ptr);
+    return;
+  }
+
   std::lock_guard lock(m_heap_map_mtx);
   if (!m_used_node.empty()) {
     auto node = m_used_node.extract(m_used_node.begin());
@@ -206,6 +307,108 @@ void KernelMemoryResource::kfree(void *ptr, std::size_t size) {
   }
 }
 
+void *KernelMemoryResource::kallocSlab(std::size_t cls) {
+  auto &magazine = tMagazine;
+
+  if (magazine.count[cls] > 0) {
+    return magazine.items[cls][--magazine.count[cls]];
+  }
+
+  // Refill half of the magazine from the shared free list
+  while (magazine.count[cls] < kMagazineSize / 2) {
+    auto ptr = popSlab(cls);
+    if (ptr == nullptr) {
+      break;
+    }
+
+    magazine.items[cls][magazine.count[cls]++] = ptr;
+  }
+
+  if (magazine.count[cls] > 0) {
+    return magazine.items[cls][--magazine.count[cls]];
+  }
+
+  // Carve a new chunk: fill the magazine, publish the rest
+  auto blockSize = kSlabSizes[cls];
+  auto blockCount = kSlabChunkSize / blockSize;
+  auto chunk = static_cast<std::byte *>(kalloc(kSlabChunkSize, 64));
+
+  std::size_t block = 1;
+  for (; block < blockCount && magazine.count[cls] < kMagazineSize; ++block) {
+    magazine.items[cls][magazine.count[cls]++] = chunk + block * blockSize;
+  }
+
+  if (block < blockCount) {
+    for (std::size_t i = block; i + 1 < blockCount; ++i) {
+      slabLink(chunk + i * blockSize)
+          .store(toHeapOffset(chunk + (i + 1) * blockSize),
+                 std::memory_order::relaxed);
+    }
+
+    pushSlabChain(cls, chunk + block * blockSize,
+                  chunk + (blockCount - 1) * blockSize);
+  }
+
+  return chunk;
+}
+
+void KernelMemoryResource::kfreeSlab(std::size_t cls, void *ptr) {
+  auto &magazine = tMagazine;
+
+  if (magazine.count[cls] == kMagazineSize) {
+    // Spill the older half as a single chain
+    auto half = kMagazineSize / 2;
+    for (std::uint32_t i = 0; i + 1 < half; ++i) {
+      slabLink(magazine.items[cls][i])
+          .store(toHeapOffset(magazine.items[cls][i + 1]),
+                 std::memory_order::relaxed);
+    }
+
+    pushSlabChain(cls, magazine.items[cls][0], magazine.items[cls][half - 1]);
+    std::memmove(magazine.items[cls], magazine.items[cls] + half,
+                 (kMagazineSize - half) * sizeof(void *));
+    magazine.count[cls] -= half;
+  }
+
+  magazine.items[cls][magazine.count[cls]++] = ptr;
+}
+
+void KernelMemoryResource::pushSlabChain(std::size_t cls, void *first,
+                                         void *last) {
+  auto &head = m_slab_free[cls];
+  auto value = head.load(std::memory_order::relaxed);
+  std::uint64_t newValue;
+
+  do {
+    slabLink(last).store(static_cast<std::uint32_t>(value),
+                         std::memory_order::relaxed);
+    newValue = ((value >> 32) + 1) << 32 | toHeapOffset(first);
+  } while (!head.compare_exchange_weak(value, newValue,
+                                       std::memory_order::release,
+                                       std::memory_order::relaxed));
+}
+
+void *KernelMemoryResource::popSlab(std::size_t cls) {
+  auto &head = m_slab_free[cls];
+  auto value = head.load(std::memory_order::acquire);
+  std::uint64_t newValue;
+
+  do {
+    auto offset = static_cast<std::uint32_t>(value);
+    if (offset == 0) {
+      return nullptr;
+    }
+
+    auto next =
+        slabLink(fromHeapOffset(offset)).load(std::memory_order::relaxed);
+    newValue = ((value >> 32) + 1) << 32 | next;
+  } while (!head.compare_exchange_weak(value, newValue,
+                                       std::memory_order::acquire,
+                                       std::memory_order::acquire));
+
+  return fromHeapOffset(static_cast<std::uint32_t>(value));
+}
+
 void kfree(void *ptr, std::size_t size) {
   return sMemoryResource->kfree(ptr, size);
 }
@@ -8,15 +8,39 @@ orbis::KNote::~KNote() {
     emitters.back()->unsubscribe(this);
   }
 
-  if (linked == nullptr) {
-    return;
-  }
-
-  if (event.filter == kEvFiltProc) {
+  if (linked != nullptr && event.filter == kEvFiltProc) {
     auto proc = static_cast<Process *>(linked);
 
     std::lock_guard lock(proc->event.mutex);
-    proc->event.notes.erase(this);
+    if (auto it = proc->event.notes.find(kEvFiltProc);
+        it != proc->event.notes.end()) {
+      it->second.erase(this);
+    }
+  }
+
+  // No emitter can reach the note any more, it will not be queued again
+  if (queue != nullptr) {
+    queue->removeReady(this);
+  }
+}
+
+void orbis::KQueue::notifyReady(KNote *note) {
+  {
+    std::lock_guard lock(readyMtx);
+    if (!note->queued) {
+      note->queued = true;
+      readyNotes.push_back(note);
+    }
+  }
+
+  cv.notify_all(mtx);
+}
+
+void orbis::KQueue::removeReady(KNote *note) {
+  std::lock_guard lock(readyMtx);
+  if (note->queued) {
+    note->queued = false;
+    std::erase(readyNotes, note);
   }
 }
 
@@ -24,10 +48,12 @@ void orbis::EventEmitter::emit(sshort filter, uint fflags, intptr_t data,
                                uintptr_t ident) {
   std::lock_guard lock(mutex);
 
-  for (auto note : notes) {
-    if (note->event.filter != filter) {
-      continue;
-    }
+  auto filterNotes = notes.find(filter);
+  if (filterNotes == notes.end()) {
+    return;
+  }
+
+  for (auto note : filterNotes->second) {
     if (fflags != 0) {
       if ((note->event.fflags & fflags) == 0) {
         continue;
@@ -49,7 +75,7 @@ void orbis::EventEmitter::emit(sshort filter, uint fflags, intptr_t data,
 
     note->triggered = true;
     note->event.data = data;
-    note->queue->cv.notify_all(note->queue->mtx);
+    note->queue->notifyReady(note);
   }
 }
 
@@ -58,11 +84,12 @@ void orbis::EventEmitter::emit(
     std::optional<intptr_t> (*filterFn)(void *userData, KNote *note)) {
   std::lock_guard lock(mutex);
 
-  for (auto note : notes) {
-    if (note->event.filter != filter) {
-      continue;
-    }
+  auto filterNotes = notes.find(filter);
+  if (filterNotes == notes.end()) {
+    return;
+  }
 
+  for (auto note : filterNotes->second) {
     std::lock_guard lock(note->mutex);
 
     if (note->triggered) {
@@ -72,20 +99,25 @@ void orbis::EventEmitter::emit(
     if (auto data = filterFn(userData, note)) {
       note->event.data = *data;
       note->triggered = true;
-      note->queue->cv.notify_all(note->queue->mtx);
+      note->queue->notifyReady(note);
     }
   }
 }
 
 void orbis::EventEmitter::subscribe(KNote *note) {
   std::lock_guard lock(mutex);
-  notes.insert(note);
+  notes[note->event.filter].insert(note);
   note->emitters.emplace_back(this);
 }
 
 void orbis::EventEmitter::unsubscribe(KNote *note) {
   std::lock_guard lock(mutex);
-  notes.erase(note);
+  if (auto it = notes.find(note->event.filter); it != notes.end()) {
+    it->second.erase(note);
+    if (it->second.empty()) {
+      notes.erase(it);
+    }
+  }
 
   auto it = std::ranges::find(note->emitters, this);
   if (it == note->emitters.end()) {
@@ -361,7 +361,7 @@ orbis::SysResult orbis::sysIpmiSessionRespondSync(Thread *thread,
   IpmiRespondParams _params;
   ORBIS_RET_ON_ERROR(uread(_params, ptr<IpmiRespondParams>(params)));
 
-  kvector<kvector<std::byte>> buffers;
+  kvector<IpmiMessage> buffers;
 
   // if ((_params.flags & 1) || _params.bufferCount != 1) {
   auto count = _params.bufferCount;
@@ -435,6 +435,29 @@ orbis::SysResult orbis::sysIpmiClientInvokeAsyncMethod(Thread *thread,
     return ErrorCode::INVAL;
   }
 
+  // Guest memory is read before any IPMI lock is taken
+  std::size_t inSize = 0;
+  for (auto &data : std::span(_params.pInData, _params.numInData)) {
+    inSize += data.size;
+  }
+
+  auto size = sizeof(IpmiAsyncMessageHeader) + inSize +
+              _params.numInData * sizeof(uint32_t);
+  IpmiMessage message(size);
+  auto msg = new (message.data()) IpmiAsyncMessageHeader;
+  msg->pid = thread->tproc->pid;
+  msg->methodId = _params.method;
+  msg->numInData = _params.numInData;
+
+  auto bufLoc = std::bit_cast<char *>(msg + 1);
+
+  for (auto &data : std::span(_params.pInData, _params.numInData)) {
+    *std::bit_cast<uint32_t *>(bufLoc) = data.size;
+    bufLoc += sizeof(uint32_t);
+    ORBIS_RET_ON_ERROR(ureadRaw(bufLoc, data.data, data.size));
+    bufLoc += data.size;
+  }
+
   std::lock_guard clientLock(client->mutex);
   auto session = client->session;
 
@@ -449,32 +472,11 @@ orbis::SysResult orbis::sysIpmiClientInvokeAsyncMethod(Thread *thread,
     return ErrorCode::INVAL;
   }
 
+  msg->sessionImpl = session->sessionImpl;
+
   {
     std::lock_guard serverLock(server->mutex);
 
-    std::size_t inSize = 0;
-    for (auto &data : std::span(_params.pInData, _params.numInData)) {
-      inSize += data.size;
-    }
-
-    auto size = sizeof(IpmiAsyncMessageHeader) + inSize +
-                _params.numInData * sizeof(uint32_t);
-    kvector<std::byte> message(size);
-    auto msg = new (message.data()) IpmiAsyncMessageHeader;
-    msg->sessionImpl = session->sessionImpl;
-    msg->pid = thread->tproc->pid;
-    msg->methodId = _params.method;
-    msg->numInData = _params.numInData;
-
-    auto bufLoc = std::bit_cast<char *>(msg + 1);
-
-    for (auto &data : std::span(_params.pInData, _params.numInData)) {
-      *std::bit_cast<uint32_t *>(bufLoc) = data.size;
-      bufLoc += sizeof(uint32_t);
-      ORBIS_RET_ON_ERROR(ureadRaw(bufLoc, data.data, data.size));
-      bufLoc += data.size;
-    }
-
     uint type = 0x43;
 
     if ((_params.flags & 1) == 0) {
@@ -528,7 +530,7 @@ orbis::SysResult orbis::sysImpiSessionRespondAsync(Thread *thread,
   IpmiAsyncRespondParams _params;
   ORBIS_RET_ON_ERROR(uread(_params, (ptr<IpmiAsyncRespondParams>)params));
 
-  kvector<kvector<std::byte>> outData;
+  kvector<IpmiMessage> outData;
   outData.reserve(_params.numOutData);
   for (auto data : std::span(_params.pOutData, _params.numOutData)) {
     auto &elem = outData.emplace_back();
@@ -912,6 +914,37 @@ orbis::sysIpmiClientInvokeSyncMethod(Thread *thread, ptr<uint> result, uint kid,
     return ErrorCode::INVAL;
   }
 
+  // Guest memory is read before any IPMI lock is taken
+  std::size_t inSize = 0;
+  for (auto &data : std::span(_params.pInData, _params.numInData)) {
+    inSize += data.size;
+  }
+
+  auto headerSize = sizeof(IpmiSyncMessageHeader) + inSize +
+                    _params.numInData * sizeof(uint32_t);
+  auto size = headerSize + _params.numOutData * sizeof(uint);
+
+  IpmiMessage message(size);
+  auto msg = new (message.data()) IpmiSyncMessageHeader;
+  msg->pid = thread->tproc->pid;
+  msg->methodId = _params.method;
+  msg->numInData = _params.numInData;
+  msg->numOutData = _params.numOutData;
+
+  auto bufLoc = std::bit_cast<char *>(msg + 1);
+
+  for (auto &data : std::span(_params.pInData, _params.numInData)) {
+    *std::bit_cast<uint32_t *>(bufLoc) = data.size;
+    bufLoc += sizeof(uint32_t);
+    ORBIS_RET_ON_ERROR(ureadRaw(bufLoc, data.data, data.size));
+    bufLoc += data.size;
+  }
+
+  for (auto &data : std::span(_params.pOutData, _params.numOutData)) {
+    *std::bit_cast<uint32_t *>(bufLoc) = data.capacity;
+    bufLoc += sizeof(uint32_t);
+  }
+
   std::lock_guard sessionLock(session->mutex);
   auto server = session->server;
 
@@ -919,40 +952,11 @@ orbis::sysIpmiClientInvokeSyncMethod(Thread *thread, ptr<uint> result, uint kid,
     return ErrorCode::INVAL;
   }
 
+  msg->sessionImpl = session->sessionImpl;
+
   {
     std::lock_guard serverLock(server->mutex);
 
-    std::size_t inSize = 0;
-    for (auto &data : std::span(_params.pInData, _params.numInData)) {
-      inSize += data.size;
-    }
-
-    auto headerSize = sizeof(IpmiSyncMessageHeader) + inSize +
-                      _params.numInData * sizeof(uint32_t);
-    auto size = headerSize + _params.numOutData * sizeof(uint);
-
-    kvector<std::byte> message(size);
-    auto msg = new (message.data()) IpmiSyncMessageHeader;
-    msg->sessionImpl = session->sessionImpl;
-    msg->pid = thread->tproc->pid;
-    msg->methodId = _params.method;
-    msg->numInData = _params.numInData;
-    msg->numOutData = _params.numOutData;
-
-    auto bufLoc = std::bit_cast<char *>(msg + 1);
-
-    for (auto &data : std::span(_params.pInData, _params.numInData)) {
-      *std::bit_cast<uint32_t *>(bufLoc) = data.size;
-      bufLoc += sizeof(uint32_t);
-      ORBIS_RET_ON_ERROR(ureadRaw(bufLoc, data.data, data.size));
-      bufLoc += data.size;
-    }
-
-    for (auto &data : std::span(_params.pOutData, _params.numOutData)) {
-      *std::bit_cast<uint32_t *>(bufLoc) = data.capacity;
-      bufLoc += sizeof(uint32_t);
-    }
-
     uint type = 0x41;
 
     if ((_params.flags & 1) == 0) {
@@ -1102,7 +1106,7 @@ orbis::SysResult orbis::sysIpmiClientConnect(Thread *thread, ptr<uint> result,
 
     static_assert(sizeof(ConnectMessageHeader) == 0x150);
 
-    kvector<std::byte> message{
+    IpmiMessage message{
         sizeof(ConnectMessageHeader) + sizeof(uint) +
         std::max<std::size_t>(_params.userDataLen, 0x10)};
     auto header = new (message.data()) ConnectMessageHeader{};
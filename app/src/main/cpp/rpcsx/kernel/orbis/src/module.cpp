@@ -4,6 +4,8 @@
 #include <utility>
 
 #include "thread/Process.hpp"
+#include <algorithm>
+#include <optional>
 #include <string_view>
 
 // TODO: move relocations to the platform specific code
@@ -69,95 +71,94 @@ static void allocateTlsOffset(orbis::Process *process, orbis::Module *module) {
   module->isTlsDone = true;
 }
 
-static orbis::SysResult doPltRelocation(orbis::Process *process,
-                                        orbis::Module *module,
-                                        orbis::Relocation rel) {
-  auto symbol = module->symbols.at(rel.symbolIndex);
-
-  auto A = rel.addend;
-  auto B = reinterpret_cast<std::uint64_t>(module->base);
-  auto where = reinterpret_cast<std::uint64_t *>(B + rel.offset);
-  auto where32 = reinterpret_cast<std::uint32_t *>(B + rel.offset);
-  auto P = reinterpret_cast<std::uintptr_t>(where);
-
-  auto findDefModule = [module,
-                        symbol] -> std::pair<orbis::Module *, std::uint64_t> {
-    if (symbol.moduleIndex == -1 || symbol.bind == orbis::SymbolBind::Local) {
-      return std::pair(module, symbol.address);
-    }
-
-    auto &defModule = module->importedModules.at(symbol.moduleIndex);
-    if (!defModule) {
-      // std::printf(
-      //     "Delaying plt relocation '%s' ('%s'), symbol '%llx' in %s
-      //     module\n", module->moduleName, module->soName, (unsigned long
-      //     long)symbol.id,
-      //     module->neededModules[symbol.moduleIndex].name.c_str());
+// Where the symbol a relocation refers to is defined: the module's own
+// definition for local ones, otherwise the export of the imported module (or
+// its namespace modules) from the library the symbol was imported from
+static std::pair<orbis::Module *, std::uint64_t>
+findDefinition(orbis::Module *module, const orbis::Symbol &symbol) {
+  if (symbol.moduleIndex == -1 || symbol.bind == orbis::SymbolBind::Local) {
+    return std::pair(module, symbol.address);
+  }
 
-      return {};
-    }
+  auto &defModule = module->importedModules.at(symbol.moduleIndex);
+  if (!defModule) {
+    // Not loaded yet, the relocation is delayed
+    return {};
+  }
 
-    auto library = module->neededLibraries.at(symbol.libraryIndex);
+  auto &library = module->neededLibraries.at(symbol.libraryIndex);
 
-    std::vector<std::string> foundInLibs;
-    for (auto defSym : defModule->symbols) {
-      if (defSym.id != symbol.id || defSym.bind == orbis::SymbolBind::Local) {
-        continue;
-      }
+  auto findInModule = [&](orbis::Module *defModule,
+                          std::vector<std::string> *foundInLibs)
+      -> std::optional<std::uint64_t> {
+    for (auto [id, index] : defModule->findExports(symbol.id)) {
+      auto &defSym = defModule->symbols[index];
 
       if (defSym.visibility == orbis::SymbolVisibility::Hidden) {
         std::printf("Ignoring hidden symbol\n");
         continue;
       }
 
-      auto defLib = defModule->neededLibraries.at(defSym.libraryIndex);
+      auto &defLib = defModule->neededLibraries.at(defSym.libraryIndex);
 
       if (defLib.name == library.name) {
-        return std::pair(defModule.get(), defSym.address);
+        return defSym.address;
       }
 
-      foundInLibs.emplace_back(std::string_view(defLib.name));
+      if (foundInLibs != nullptr) {
+        foundInLibs->emplace_back(std::string_view(defLib.name));
+      }
     }
 
-    for (auto nsDefModule : defModule->namespaceModules) {
-      for (auto defSym : nsDefModule->symbols) {
-        if (defSym.id != symbol.id || defSym.bind == orbis::SymbolBind::Local) {
-          continue;
-        }
-
-        if (defSym.visibility == orbis::SymbolVisibility::Hidden) {
-          std::printf("Ignoring hidden symbol\n");
-          continue;
-        }
+    return {};
+  };
 
-        auto defLib = nsDefModule->neededLibraries.at(defSym.libraryIndex);
+  std::vector<std::string> foundInLibs;
+  if (auto address = findInModule(defModule.get(), &foundInLibs)) {
+    return std::pair(defModule.get(), *address);
+  }
 
-        if (defLib.name == library.name) {
-          return std::pair(nsDefModule.get(), defSym.address);
-        }
-      }
+  for (auto &nsDefModule : defModule->namespaceModules) {
+    if (auto address = findInModule(nsDefModule.get(), nullptr)) {
+      return std::pair(nsDefModule.get(), *address);
     }
+  }
 
-    std::printf(
-        "'%s' ('%s') uses undefined symbol '%llx' in '%s' ('%s') module\n",
-        module->moduleName, module->soName, (unsigned long long)symbol.id,
-        defModule->moduleName, defModule->soName);
-    if (foundInLibs.size() > 0) {
-      std::printf("Requested library is '%s', exists in libraries: [",
-                  library.name.c_str());
-
-      for (bool isFirst = true; auto &lib : foundInLibs) {
-        if (isFirst) {
-          isFirst = false;
-        } else {
-          std::printf(", ");
-        }
-
-        std::printf("'%s'", lib.c_str());
+  std::printf(
+      "'%s' ('%s') uses undefined symbol '%llx' in '%s' ('%s') module\n",
+      module->moduleName, module->soName, (unsigned long long)symbol.id,
+      defModule->moduleName, defModule->soName);
+  if (foundInLibs.size() > 0) {
+    std::printf("Requested library is '%s', exists in libraries: [",
+                library.name.c_str());
+
+    for (bool isFirst = true; auto &lib : foundInLibs) {
+      if (isFirst) {
+        isFirst = false;
+      } else {
+        std::printf(", ");
       }
-      std::printf("]\n");
+
+      std::printf("'%s'", lib.c_str());
     }
-    return std::pair(module, symbol.address);
+    std::printf("]\n");
+  }
+  return std::pair(module, symbol.address);
+}
+
+static orbis::SysResult doPltRelocation(orbis::Process *process,
+                                        orbis::Module *module,
+                                        orbis::Relocation rel) {
+  auto &symbol = module->symbols.at(rel.symbolIndex);
+
+  auto A = rel.addend;
+  auto B = reinterpret_cast<std::uint64_t>(module->base);
+  auto where = reinterpret_cast<std::uint64_t *>(B + rel.offset);
+  auto where32 = reinterpret_cast<std::uint32_t *>(B + rel.offset);
+  auto P = reinterpret_cast<std::uintptr_t>(where);
+
+  auto findDefModule = [module, &symbol] {
+    return findDefinition(module, symbol);
   };
 
   switch (rel.relType) {
@@ -187,7 +188,7 @@ static orbis::SysResult doPltRelocation(orbis::Process *process,
 static orbis::SysResult doRelocation(orbis::Process *process,
                                      orbis::Module *module,
                                      orbis::Relocation rel) {
-  auto symbol = module->symbols.at(rel.symbolIndex);
+  auto &symbol = module->symbols.at(rel.symbolIndex);
 
   auto A = rel.addend;
   auto B = reinterpret_cast<std::uint64_t>(module->base);
@@ -195,86 +196,8 @@ static orbis::SysResult doRelocation(orbis::Process *process,
   auto where32 = reinterpret_cast<std::uint32_t *>(B + rel.offset);
   auto P = reinterpret_cast<std::uintptr_t>(where);
 
-  auto findDefModule = [module, symbol,
-                        rel] -> std::pair<orbis::Module *, std::uint64_t> {
-    if (symbol.moduleIndex == -1 || symbol.bind == orbis::SymbolBind::Local) {
-      return std::pair(module, symbol.address);
-    }
-
-    auto &defModule = module->importedModules.at(symbol.moduleIndex);
-    if (!defModule) {
-      // std::printf("'%s' ('%s') uses undefined symbol '%llx' in unloaded
-      // module "
-      //             "'%s', rel %u\n",
-      //             module->moduleName, module->soName,
-      //             (unsigned long long)symbol.id,
-      //             module->neededModules.at(symbol.moduleIndex).name.c_str(),
-      //             rel.relType);
-
-      return {};
-    }
-
-    auto library = module->neededLibraries.at(symbol.libraryIndex);
-
-    std::vector<std::string> foundInLibs;
-    for (auto defSym : defModule->symbols) {
-      if (defSym.id != symbol.id || defSym.bind == orbis::SymbolBind::Local) {
-        continue;
-      }
-
-      if (defSym.visibility == orbis::SymbolVisibility::Hidden) {
-        std::printf("Ignoring hidden symbol\n");
-        continue;
-      }
-
-      auto defLib = defModule->neededLibraries.at(defSym.libraryIndex);
-
-      if (defLib.name == library.name) {
-        return std::pair(defModule.get(), defSym.address);
-      }
-
-      foundInLibs.emplace_back(std::string_view(defLib.name));
-    }
-
-    for (auto nsDefModule : defModule->namespaceModules) {
-      for (auto defSym : nsDefModule->symbols) {
-        if (defSym.id != symbol.id || defSym.bind == orbis::SymbolBind::Local) {
-          continue;
-        }
-
-        if (defSym.visibility == orbis::SymbolVisibility::Hidden) {
-          std::printf("Ignoring hidden symbol\n");
-          continue;
-        }
-
-        auto defLib = nsDefModule->neededLibraries.at(defSym.libraryIndex);
-
-        if (defLib.name == library.name) {
-          return std::pair(nsDefModule.get(), defSym.address);
-        }
-      }
-    }
-
-    std::printf(
-        "'%s' ('%s') uses undefined symbol '%llx' in '%s' ('%s') module\n",
-        module->moduleName, module->soName, (unsigned long long)symbol.id,
-        defModule->moduleName, defModule->soName);
-    if (foundInLibs.size() > 0) {
-      std::printf("Requested library is '%s', exists in libraries: [",
-                  library.name.c_str());
-
-      for (bool isFirst = true; auto &lib : foundInLibs) {
-        if (isFirst) {
-          isFirst = false;
-        } else {
-          std::printf(", ");
-        }
-
-        std::printf("'%s'", lib.c_str());
-      }
-      std::printf("]\n");
-    }
-    return std::pair(module, symbol.address);
+  auto findDefModule = [module, &symbol] {
+    return findDefinition(module, symbol);
   };
 
   switch (rel.relType) {
@@ -409,6 +332,27 @@ orbis::SysResult orbis::Module::relocate(Process *process) {
   return {};
 }
 
+void orbis::Module::buildExportIndex() {
+  exportIndex.clear();
+  exportIndex.reserve(symbols.size());
+
+  for (std::uint32_t index = 0; index < symbols.size(); ++index) {
+    if (symbols[index].bind != SymbolBind::Local) {
+      exportIndex.emplace_back(symbols[index].id, index);
+    }
+  }
+
+  std::ranges::sort(exportIndex);
+}
+
+std::span<const std::pair<std::uint64_t, std::uint32_t>>
+orbis::Module::findExports(std::uint64_t id) const {
+  auto [first, last] = std::ranges::equal_range(
+      exportIndex, id, {},
+      &std::pair<std::uint64_t, std::uint32_t>::first);
+  return {first, last};
+}
+
 void orbis::Module::operator delete(void *pointer) {
   kfree(pointer, sizeof(orbis::Module));
 }
@@ -24,7 +24,7 @@ enum class CpuWhich {
   Jail = 5,
 };
 
-static cpu_set_t toHostCpuSet(orbis::cpuset cpuSet) {
+cpu_set_t orbis::toHostCpuSet(orbis::cpuset cpuSet) {
   const int procCount = get_nprocs();
   cpu_set_t result{};
 
@@ -145,6 +145,13 @@ orbis::SysResult orbis::sys_cpuset_setaffinity(Thread *thread, cpulevel_t level,
       }
 
       ORBIS_RET_ON_ERROR(uread(whichThread->affinity, mask));
+
+      // Applied when the thread leaves the low priority CPU set
+      if (std::lock_guard piLock(whichThread->piMtx);
+          whichThread->hostCollapsed) {
+        return {};
+      }
+
       auto threadHandle = whichThread->getNativeHandle();
       auto hostCpuSet = toHostCpuSet(whichThread->affinity);
       ORBIS_LOG_ERROR(__FUNCTION__, threadHandle, thread->tid, id);
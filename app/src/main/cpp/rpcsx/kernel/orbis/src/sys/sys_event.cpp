@@ -60,13 +60,24 @@ static bool isWriteEventTriggered(int hostFd) {
 }
 
 namespace orbis {
+// Caller holds kq->mtx
+static void eraseNote(KQueue *kq, KQueue::NoteList::iterator it) {
+  kq->noteIndex.erase({it->event.ident, it->event.filter});
+  std::erase(kq->polledNotes, &*it);
+  kq->notes.erase(it);
+}
+
+// Triggered after the last collection, kevent() must not sleep
+static bool hasReadyNotes(KQueue *kq) {
+  std::lock_guard lock(kq->readyMtx);
+  return !kq->readyNotes.empty();
+}
+
 static SysResult keventChange(KQueue *kq, KEvent &change, Thread *thread) {
   auto nodeIt = kq->notes.end();
-  for (auto it = kq->notes.begin(); it != kq->notes.end(); ++it) {
-    if (it->event.ident == change.ident && it->event.filter == change.filter) {
-      nodeIt = it;
-      break;
-    }
+  if (auto it = kq->noteIndex.find({change.ident, change.filter});
+      it != kq->noteIndex.end()) {
+    nodeIt = it->second;
   }
 
   if (change.flags & kEvDelete) {
@@ -74,7 +85,7 @@ static SysResult keventChange(KQueue *kq, KEvent &change, Thread *thread) {
       return orbis::ErrorCode::NOENT;
     }
 
-    kq->notes.erase(nodeIt);
+    eraseNote(kq, nodeIt);
     nodeIt = kq->notes.end();
   }
 
@@ -87,6 +98,7 @@ static SysResult keventChange(KQueue *kq, KEvent &change, Thread *thread) {
       note.event = change;
       note.enabled = true;
       nodeIt = kq->notes.begin();
+      kq->noteIndex.emplace(std::pair{change.ident, change.filter}, nodeIt);
 
       if (change.filter == kEvFiltProc) {
         auto process = findProcessById(change.ident);
@@ -97,13 +109,13 @@ static SysResult keventChange(KQueue *kq, KEvent &change, Thread *thread) {
         noteLock = std::unique_lock(nodeIt->mutex);
 
         std::unique_lock lock(process->event.mutex);
-        process->event.notes.insert(&*nodeIt);
+        process->event.notes[kEvFiltProc].insert(&*nodeIt);
         nodeIt->linked = process;
         if ((change.fflags & orbis::kNoteExit) != 0 &&
             process->exitStatus.has_value()) {
           note.event.data = *process->exitStatus;
           note.triggered = true;
-          kq->cv.notify_all(kq->mtx);
+          kq->notifyReady(&note);
         }
       } else if (change.filter == kEvFiltRead ||
                  change.filter == kEvFiltWrite) {
@@ -118,8 +130,10 @@ static SysResult keventChange(KQueue *kq, KEvent &change, Thread *thread) {
         if (auto eventEmitter = fd->event) {
           eventEmitter->subscribe(&*nodeIt);
           nodeIt->triggered = true;
-          kq->cv.notify_all(kq->mtx);
-        } else if (note.file->hostFd < 0) {
+          kq->notifyReady(&*nodeIt);
+        } else if (note.file->hostFd >= 0) {
+          kq->polledNotes.push_back(&*nodeIt);
+        } else {
           ORBIS_LOG_ERROR("Unimplemented event emitter", change.ident);
         }
       } else if (change.filter == kEvFiltGraphicsCore ||
@@ -154,6 +168,10 @@ static SysResult keventChange(KQueue *kq, KEvent &change, Thread *thread) {
   if (change.flags & kEvClear) {
     nodeIt->triggered = false;
   }
+  if ((change.flags & kEvEnable) && nodeIt->triggered) {
+    // Dropped from the ready list while it was disabled
+    kq->notifyReady(&*nodeIt);
+  }
 
   if (change.filter == kEvFiltUser) {
     auto fflags = 0;
@@ -175,20 +193,20 @@ static SysResult keventChange(KQueue *kq, KEvent &change, Thread *thread) {
     if (change.fflags & kNoteTrigger) {
       nodeIt->event.udata = change.udata;
       nodeIt->triggered = true;
-      kq->cv.notify_all(kq->mtx);
+      kq->notifyReady(&*nodeIt);
     }
   } else if (change.filter == kEvFiltDisplay && change.ident >> 48 == 0x6301) {
     nodeIt->triggered = true;
-    kq->cv.notify_all(kq->mtx);
+    kq->notifyReady(&*nodeIt);
   } else if (change.filter == kEvFiltGraphicsCore && change.ident == 0x84) {
     nodeIt->triggered = true;
     nodeIt->event.data |= 1000ull << 16; // clock
 
-    kq->cv.notify_all(kq->mtx);
+    kq->notifyReady(&*nodeIt);
   } else if (g_context->fwType == FwType::Ps5 &&
              change.filter == kEvFiltGraphicsCore && change.ident == 0) {
     nodeIt->triggered = true;
-    kq->cv.notify_all(kq->mtx);
+    kq->notifyReady(&*nodeIt);
   }
 
   return {};
@@ -277,75 +295,84 @@ orbis::SysResult orbis::sys_kevent(Thread *thread, sint fd,
 
     {
       std::lock_guard lock(kq->mtx);
-      while (result.size() < nevents && !kq->triggeredEvents.empty()) {
-        result.push_back(kq->triggeredEvents.back());
-        kq->triggeredEvents.pop_back();
-      }
 
-      if (result.empty()) {
-        for (auto it = kq->notes.begin(); it != kq->notes.end();) {
-          auto &note = *it;
-          bool erase = false;
-          {
-            std::lock_guard lock(note.mutex);
-
-            if (!note.triggered) {
-              if (note.event.filter == kEvFiltRead) {
-                if (note.file->hostFd >= 0) {
-                  if (isReadEventTriggered(note.file->hostFd)) {
-                    note.triggered = true;
-                  } else {
-                    canSleep = false;
-                  }
-                }
-              } else if (note.event.filter == kEvFiltWrite) {
-                if (note.file->hostFd >= 0) {
-                  if (isWriteEventTriggered(note.file->hostFd)) {
-                    note.triggered = true;
-                  } else {
-                    canSleep = false;
-                  }
-                }
-              }
-            }
+      // Host descriptors have no emitter, poll them into the ready list
+      for (auto note : kq->polledNotes) {
+        std::lock_guard noteLock(note->mutex);
+        if (note->triggered) {
+          continue;
+        }
 
-            if (note.enabled && note.triggered) {
-              result.push_back(note.event);
+        bool ready = note->event.filter == kEvFiltRead
+                         ? isReadEventTriggered(note->file->hostFd)
+                         : isWriteEventTriggered(note->file->hostFd);
+        if (ready) {
+          note->triggered = true;
+          kq->notifyReady(note);
+        } else {
+          canSleep = false;
+        }
+      }
+
+      kvector<KNote *> readyNotes;
+      {
+        std::lock_guard readyLock(kq->readyMtx);
+        readyNotes.swap(kq->readyNotes);
+      }
 
-              if (note.event.filter == kEvFiltDisplay) {
-                note.triggered = false;
-              } else if (note.event.filter == kEvFiltGraphicsCore &&
-                         note.event.ident != 0x84) {
-                note.triggered = false;
-              }
+      std::size_t index = 0;
+      for (; index < readyNotes.size() && result.size() < nevents; ++index) {
+        auto note = readyNotes[index];
+        bool erase = false;
+        {
+          std::lock_guard noteLock(note->mutex);
+
+          if (note->enabled && note->triggered) {
+            result.push_back(note->event);
+
+            if (note->event.filter == kEvFiltDisplay) {
+              note->triggered = false;
+            } else if (note->event.filter == kEvFiltGraphicsCore &&
+                       note->event.ident != 0x84) {
+              note->triggered = false;
+            }
 
-              if (note.event.flags & kEvDispatch) {
-                note.enabled = false;
-              }
+            if (note->event.flags & kEvDispatch) {
+              note->enabled = false;
+            }
 
-              if (note.event.flags & kEvOneshot) {
-                erase = true;
-              }
+            if (note->event.flags & kEvOneshot) {
+              erase = true;
+            }
 
-              if (note.event.filter == kEvFiltRead ||
-                  note.event.filter == kEvFiltWrite) {
-                note.triggered = false;
-              }
+            if (note->event.filter == kEvFiltRead ||
+                note->event.filter == kEvFiltWrite) {
+              note->triggered = false;
             }
           }
 
-          if (erase) {
-            it = kq->notes.erase(it);
+          // Level-triggered notes stay ready for the next call, the rest are
+          // queued again by their next trigger
+          std::lock_guard readyLock(kq->readyMtx);
+          if (!erase && note->enabled && note->triggered) {
+            kq->readyNotes.push_back(note);
           } else {
-            ++it;
+            note->queued = false;
           }
         }
 
-        while (result.size() > nevents) {
-          kq->triggeredEvents.push_back(result.back());
-          result.pop_back();
+        if (erase) {
+          eraseNote(kq.get(), kq->noteIndex.at({note->event.ident,
+                                                note->event.filter}));
         }
       }
+
+      if (index < readyNotes.size()) {
+        // Did not fit into the event list, these are first next time
+        std::lock_guard readyLock(kq->readyMtx);
+        kq->readyNotes.insert(kq->readyNotes.begin(),
+                              readyNotes.begin() + index, readyNotes.end());
+      }
     }
 
     if (!result.empty()) {
@@ -363,7 +390,7 @@ orbis::SysResult orbis::sys_kevent(Thread *thread, sint fd,
 
       auto waitTimeout = std::chrono::duration_cast<std::chrono::microseconds>(
           timeoutPoint - now);
-      if (canSleep) {
+      if (canSleep && !hasReadyNotes(kq.get())) {
         if (waitTimeout.count() > 1000) {
           orbis::scoped_unblock unblock;
           kq->cv.wait(kq->mtx, waitTimeout.count());
@@ -374,8 +401,10 @@ orbis::SysResult orbis::sys_kevent(Thread *thread, sint fd,
     } else {
       if (canSleep) {
         std::lock_guard lock(kq->mtx);
-        orbis::scoped_unblock unblock;
-        kq->cv.wait(kq->mtx);
+        if (!hasReadyNotes(kq.get())) {
+          orbis::scoped_unblock unblock;
+          kq->cv.wait(kq->mtx);
+        }
       } else {
         std::this_thread::sleep_for(std::chrono::microseconds(30));
       }
@@ -441,10 +441,6 @@ orbis::SysResult orbis::sys_getdirentries(Thread *thread, sint fd,
   if (result.isError())
     return result;
 
-  for (auto &entry : std::span(entries + pos, next - pos)) {
-    ORBIS_LOG_ERROR(__FUNCTION__, entry.name);
-  }
-
   if (basep) {
     result = uwrite(basep, slong(file->nextOff));
     if (result.isError())
@@ -1,5 +1,123 @@
 #include "thread/Thread.hpp"
+#include "KernelContext.hpp"
 #include "thread/Process.hpp"
+#include "utils/Logs.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <sched.h>
+#include <sys/resource.h>
+
+namespace {
+// SCE priorities, lower value is more urgent
+constexpr std::uint16_t kPrioHighest = 256;
+constexpr std::uint16_t kPrioLowest = 767;
+constexpr std::uint16_t kPrioDefault = 700;
+
+// Audio, vsync and submission threads, worth asking the host for SCHED_FIFO
+constexpr std::uint16_t kPrioFifoBand = 320;
+
+constexpr int kNiceHighest = -10;
+constexpr int kNiceLowest = 10;
+
+// Android only grants SCHED_FIFO and negative nice to privileged processes,
+// once refused it is not asked again
+std::atomic<bool> g_fifoDenied{false};
+std::atomic<bool> g_niceDenied{false};
+
+std::uint16_t normalizePriority(std::uint16_t priority) {
+  // Threads nobody configured carry values outside the SCE range
+  if (priority < kPrioHighest || priority > kPrioLowest) {
+    return kPrioDefault;
+  }
+
+  return priority;
+}
+
+std::uint16_t effectivePriority(orbis::Thread *thread) {
+  auto result = normalizePriority(thread->prio.prio);
+  for (auto &[key, priority] : thread->piBoosts) {
+    result = std::min(result, priority);
+  }
+  return result;
+}
+
+int toHostNice(std::uint16_t priority) {
+  // The default priority stays at nice 0, next to the host threads
+  if (priority <= kPrioDefault) {
+    return kNiceHighest * (kPrioDefault - priority) /
+           (kPrioDefault - kPrioHighest);
+  }
+
+  return kNiceLowest * (priority - kPrioDefault) / (kPrioLowest - kPrioDefault);
+}
+
+// Caller holds thread->piMtx
+void applyHostPriority(orbis::Thread *thread) {
+  if (thread->hostTid < 0) {
+    return;
+  }
+
+  auto priority = effectivePriority(thread);
+  if (priority == thread->hostPrio) {
+    return;
+  }
+
+  thread->hostPrio = priority;
+  auto tid = static_cast<pid_t>(thread->hostTid);
+
+  bool fifo = false;
+  if (priority <= kPrioFifoBand &&
+      !g_fifoDenied.load(std::memory_order::relaxed)) {
+    ::sched_param param{};
+    param.sched_priority = ::sched_get_priority_min(SCHED_FIFO);
+    fifo = ::sched_setscheduler(tid, SCHED_FIFO, &param) == 0;
+
+    if (!fifo && errno == EPERM) {
+      g_fifoDenied.store(true, std::memory_order::relaxed);
+    }
+  }
+
+  if (!fifo) {
+    ::sched_param param{};
+    ::sched_setscheduler(tid, SCHED_OTHER, &param);
+
+    int nice = toHostNice(priority);
+    if (nice < 0 && g_niceDenied.load(std::memory_order::relaxed)) {
+      nice = 0;
+    }
+
+    if (::setpriority(PRIO_PROCESS, tid, nice) != 0 && nice < 0 &&
+        errno == EPERM) {
+      g_niceDenied.store(true, std::memory_order::relaxed);
+      ::setpriority(PRIO_PROCESS, tid, 0);
+    }
+  }
+
+  auto cpuCount = orbis::g_context->lowPrioCpuCount;
+  bool collapse = cpuCount != 0 && priority > kPrioDefault;
+  if (collapse == thread->hostCollapsed) {
+    return;
+  }
+
+  cpu_set_t cpuSet;
+  if (collapse) {
+    CPU_ZERO(&cpuSet);
+    for (uint cpu = 0; cpu < std::min<uint>(cpuCount, CPU_SETSIZE); ++cpu) {
+      CPU_SET(cpu, &cpuSet);
+    }
+  } else {
+    cpuSet = orbis::toHostCpuSet(thread->affinity);
+  }
+
+  if (::sched_setaffinity(tid, sizeof(cpuSet), &cpuSet) == 0) {
+    thread->hostCollapsed = collapse;
+  } else {
+    ORBIS_LOG_ERROR(__FUNCTION__, "failed to move host thread", thread->tid,
+                    collapse, errno);
+  }
+}
+} // namespace
 
 orbis::Thread::~Thread() {
   Thread::Storage::DestructAll(storage);
@@ -11,6 +129,38 @@ orbis::Thread::~Thread() {
   kfree(this, size);
 }
 
+std::uint16_t orbis::Thread::getEffectivePriority() {
+  std::lock_guard lock(piMtx);
+  return effectivePriority(this);
+}
+
+void orbis::Thread::updateHostPriority() {
+  std::lock_guard lock(piMtx);
+  applyHostPriority(this);
+}
+
+void orbis::Thread::inheritPriority(std::uintptr_t key,
+                                    std::uint16_t priority) {
+  std::lock_guard lock(piMtx);
+  auto [it, inserted] = piBoosts.try_emplace(key, priority);
+  if (!inserted) {
+    if (it->second <= priority) {
+      return;
+    }
+
+    it->second = priority;
+  }
+
+  applyHostPriority(this);
+}
+
+void orbis::Thread::disinheritPriority(std::uintptr_t key) {
+  std::lock_guard lock(piMtx);
+  if (piBoosts.erase(key) != 0) {
+    applyHostPriority(this);
+  }
+}
+
 orbis::Thread *orbis::createThread(Process *process, std::string_view name) {
   auto size = sizeof(Thread);
   size = rx::alignUp(size, Thread::Storage::GetAlignment());
@@ -5,6 +5,10 @@
 #include "orbis/thread.hpp"
 #include "orbis/utils/Logs.hpp"
 #include "rx/Serializer.hpp"
+#include "rx/SharedAtomic.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <limits>
 
 namespace orbis {
@@ -80,6 +84,43 @@ struct UmtxStorage {
 
 static auto umtxStorage = createGlobalObject<UmtxStorage>();
 
+// Process-private waits that nothing else keys on sleep on the guest word
+// itself, so wait and wake cost one futex syscall instead of a trip through
+// the chain lock and sleep queue
+static_assert(std::endian::native == std::endian::little);
+
+static rx::shared_atomic32 *futexWord(void *addr) {
+  // Low half of 64-bit words: that is where the owner id lives
+  return reinterpret_cast<rx::shared_atomic32 *>(addr);
+}
+
+static ErrorCode futexWait(void *addr, std::uint32_t expected,
+                           std::uint64_t ut) {
+  std::errc result;
+  {
+    orbis::scoped_unblock unblock;
+    if (ut + 1 == 0) {
+      result = futexWord(addr)->wait(expected);
+    } else {
+      result = futexWord(addr)->wait(
+          expected,
+          std::chrono::microseconds(static_cast<std::int64_t>(std::min<std::uint64_t>(
+              ut, std::numeric_limits<std::int64_t>::max() - 1))));
+    }
+  }
+
+  // Value already changed or a signal was handled: a normal wakeup for the guest
+  if (result == std::errc::resource_unavailable_try_again) {
+    return {};
+  }
+
+  return orbis::toErrorCode(result);
+}
+
+static void futexWake(void *addr, sint count) {
+  futexWord(addr)->notify_n(count);
+}
+
 std::pair<const UmtxKey, UmtxCond> *UmtxChain::enqueue(UmtxKey &key,
                                                        Thread *thr) {
   if (!spare_queue.empty()) {
@@ -139,21 +180,73 @@ uint UmtxChain::notify_all(const UmtxKey &key) {
 
 orbis::ErrorCode orbis::umtx_lock_umtx(Thread *thread, ptr<umtx> umtx, ulong id,
                                        std::uint64_t ut) {
-  ORBIS_LOG_TODO(__FUNCTION__, thread->tid, umtx, id, ut);
-  std::abort();
-  return ErrorCode::NOSYS;
+  ORBIS_LOG_TRACE(__FUNCTION__, thread->tid, umtx, id, ut);
+
+  auto start = std::chrono::steady_clock::now();
+  std::uint64_t udiff = 0;
+  while (true) {
+    ulong owner = kUmtxUnowned;
+    if (umtx->owner.compare_exchange_strong(owner, id,
+                                            std::memory_order::acquire))
+      return {};
+
+    if (owner == kUmtxContested) {
+      // Released while others still sleep, keep the contested bit for them
+      if (umtx->owner.compare_exchange_strong(owner, id | kUmtxContested,
+                                              std::memory_order::acquire))
+        return {};
+      continue;
+    }
+
+    if ((owner & kUmtxContested) == 0 &&
+        !umtx->owner.compare_exchange_strong(owner, owner | kUmtxContested))
+      continue;
+
+    // Unlock always changes the owner id, which is in the low half
+    if (auto error = futexWait(umtx, static_cast<std::uint32_t>(owner),
+                               ut + 1 == 0 ? ut : ut - udiff);
+        error != ErrorCode{})
+      return error;
+
+    if (ut + 1 != 0) {
+      udiff = std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+      if (udiff >= ut)
+        return ErrorCode::TIMEDOUT;
+    }
+  }
 }
 
 orbis::ErrorCode orbis::umtx_unlock_umtx(Thread *thread, ptr<umtx> umtx,
                                          ulong id) {
-  ORBIS_LOG_TODO(__FUNCTION__, thread->tid, umtx, id);
-  std::abort();
-  return ErrorCode::NOSYS;
+  ORBIS_LOG_TRACE(__FUNCTION__, thread->tid, umtx, id);
+
+  ulong owner = umtx->owner.load(std::memory_order::relaxed);
+  if ((owner & ~kUmtxContested) != id)
+    return ErrorCode::PERM;
+
+  if ((owner & kUmtxContested) == 0 &&
+      umtx->owner.compare_exchange_strong(owner, kUmtxUnowned,
+                                          std::memory_order::release))
+    return {};
+
+  // No sleeper count without a queue: leave the lock contested, the next
+  // owner unlocks through here and wakes the next sleeper
+  umtx->owner.store(kUmtxContested, std::memory_order::release);
+  futexWake(umtx, 1);
+  return {};
 }
 
 orbis::ErrorCode orbis::umtx_wait(Thread *thread, ptr<void> addr, ulong id,
                                   std::uint64_t ut, bool is32, bool ipc) {
   ORBIS_LOG_NOTICE(__FUNCTION__, thread->tid, addr, id, ut, is32);
+
+  if (is32 && !ipc) {
+    // Paired with umtx_wake_private only
+    return futexWait(addr, static_cast<std::uint32_t>(id), ut);
+  }
+
   auto [chain, key, lock] = umtxStorage->getUmtxChain0(thread, ipc, addr);
   auto node = chain.enqueue(key, thread);
   ErrorCode result = {};
@@ -232,10 +325,56 @@ void log_class_string<umutex_lock_mode>::format(std::string &out,
     break;
   }
 }
+// Priority inheritance: a waiter lends its priority to the owner before it
+// sleeps, a new owner that still has sleepers behind it takes the best of
+// theirs. Boosts are dropped on unlock. Chains of owners blocked on other PI
+// umutexes are not followed
+static void boostOwner(Thread *thread, const UmtxKey &key, lwpid_t ownerTid) {
+  if (key.pid == 0) {
+    // Process shared, the owner may belong to another process
+    return;
+  }
+
+  auto owner = thread->tproc->threadsMap.get(ownerTid - thread->tproc->pid);
+  if (owner == nullptr || owner.get() == thread) {
+    return;
+  }
+
+  owner->inheritPriority(key.addr, thread->getEffectivePriority());
+}
+
+static void inheritFromSleepers(UmtxChain &chain, const UmtxKey &key,
+                                Thread *thread) {
+  std::uint16_t best = std::numeric_limits<std::uint16_t>::max();
+  for (auto [it, end] = chain.sleep_queue.equal_range(key); it != end; ++it) {
+    if (it->second.thr != nullptr && it->second.thr != thread) {
+      best = std::min(best, it->second.thr->getEffectivePriority());
+    }
+  }
+
+  if (best != std::numeric_limits<std::uint16_t>::max()) {
+    thread->inheritPriority(key.addr, best);
+  }
+}
+
 static ErrorCode do_lock_normal(Thread *thread, ptr<umutex> m, uint flags,
-                                std::uint64_t ut, umutex_lock_mode mode) {
+                                std::uint64_t ut, umutex_lock_mode mode,
+                                bool inherit = false) {
   ORBIS_LOG_TRACE(__FUNCTION__, thread->tid, m, flags, ut, mode);
 
+  // Uncontended cases only touch the guest word, the chain is needed to sleep
+  {
+    int owner = kUmutexUnowned;
+    if (mode == umutex_lock_mode::wait) {
+      owner = m->owner.load(std::memory_order_acquire);
+      if (owner == kUmutexUnowned || owner == kUmutexContested)
+        return {};
+    } else if (m->owner.compare_exchange_strong(owner, thread->tid,
+                                                std::memory_order_acquire)) {
+      return {};
+    }
+  }
+
   auto [chain, key, lock] = umtxStorage->getUmtxChain1(thread, flags, m);
   ErrorCode error = {};
   while (true) {
@@ -249,8 +388,11 @@ static ErrorCode do_lock_normal(Thread *thread, ptr<umutex> m, uint flags,
         return {};
       if (owner == kUmutexContested) {
         if (m->owner.compare_exchange_strong(owner,
-                                             thread->tid | kUmutexContested))
+                                             thread->tid | kUmutexContested)) {
+          if (inherit)
+            inheritFromSleepers(chain, key, thread);
           return {};
+        }
         continue;
       }
     }
@@ -267,6 +409,8 @@ static ErrorCode do_lock_normal(Thread *thread, ptr<umutex> m, uint flags,
 
     auto node = chain.enqueue(key, thread);
     if (m->owner.compare_exchange_strong(owner, owner | kUmutexContested)) {
+      if (inherit)
+        boostOwner(thread, key, owner & ~kUmutexContested);
       {
         orbis::scoped_unblock unblock;
         error = orbis::toErrorCode(node->second.cv.wait(chain.mtx, ut));
@@ -282,8 +426,7 @@ static ErrorCode do_lock_normal(Thread *thread, ptr<umutex> m, uint flags,
 }
 static ErrorCode do_lock_pi(Thread *thread, ptr<umutex> m, uint flags,
                             std::uint64_t ut, umutex_lock_mode mode) {
-  // ORBIS_LOG_TODO(__FUNCTION__, m, flags, ut, mode);
-  return do_lock_normal(thread, m, flags, ut, mode);
+  return do_lock_normal(thread, m, flags, ut, mode, true);
 }
 static ErrorCode do_lock_pp(Thread *thread, ptr<umutex> m, uint flags,
                             std::uint64_t ut, umutex_lock_mode mode) {
@@ -293,6 +436,15 @@ static ErrorCode do_lock_pp(Thread *thread, ptr<umutex> m, uint flags,
 static ErrorCode do_unlock_normal(Thread *thread, ptr<umutex> m, uint flags) {
   ORBIS_LOG_TRACE(__FUNCTION__, thread->tid, m, flags);
 
+  // Not contested means nobody sleeps on the chain: waiters set the bit
+  // under the chain lock before they sleep, which fails this CAS
+  {
+    int owner = thread->tid;
+    if (m->owner.compare_exchange_strong(owner, kUmutexUnowned,
+                                         std::memory_order_release))
+      return {};
+  }
+
   auto [chain, key, lock] = umtxStorage->getUmtxChain1(thread, flags, m);
 
   int owner = m->owner.load(std::memory_order_acquire);
@@ -324,7 +476,10 @@ static ErrorCode do_unlock_normal(Thread *thread, ptr<umutex> m, uint flags) {
   return {};
 }
 static ErrorCode do_unlock_pi(Thread *thread, ptr<umutex> m, uint flags) {
-  return do_unlock_normal(thread, m, flags);
+  auto error = do_unlock_normal(thread, m, flags);
+  if (error == ErrorCode{})
+    thread->disinheritPriority(reinterpret_cast<std::uintptr_t>(m));
+  return error;
 }
 static ErrorCode do_unlock_pp(Thread *thread, ptr<umutex> m, uint flags) {
   ORBIS_LOG_TODO(__FUNCTION__, m, flags);
@@ -758,8 +913,7 @@ orbis::ErrorCode orbis::umtx_rw_unlock(Thread *thread, ptr<urwlock> rwlock) {
 orbis::ErrorCode orbis::umtx_wake_private(Thread *thread, ptr<void> addr,
                                           sint n_wake) {
   ORBIS_LOG_TRACE(__FUNCTION__, thread->tid, addr, n_wake);
-  auto [chain, key, lock] = umtxStorage->getUmtxChain0(thread, false, addr);
-  chain.notify_n(key, n_wake);
+  futexWake(addr, n_wake);
   return {};
 }
 
@@ -3,9 +3,12 @@
 #include "Emu/Cell/PPUModule.h"
 #include "Emu/Cell/PPUOpcodes.h"
 #include "Emu/IdManager.h"
+#include "Emu/System.h"
 
 LOG_CHANNEL(static_hle);
 
+atomic_t<shle_filter_t> g_shle_filter{};
+
 // for future use
 DECLARE(ppu_module_manager::static_hle)("static_hle", []() {});
 
@@ -150,6 +153,12 @@ bool statichle_handler::check_against_patterns(vm::cptr<u8>& data, u32 size, u32
 		// we got a match!
 		static_hle.success("Found function %s at 0x%x", pat.name, addr);
 
+		if (const auto filter = g_shle_filter.load(); filter && !filter(Emu.GetTitleID().c_str(), pat.name.c_str()))
+		{
+			static_hle.notice("Function %s is disabled for this title, keeping guest code", pat.name);
+			return false;
+		}
+
 		// patch the code
 		const auto smodule = ppu_module_manager::get_module(pat._module);
 
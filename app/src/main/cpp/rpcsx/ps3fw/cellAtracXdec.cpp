@@ -12,6 +12,10 @@
 
 #include "cellAtracXdec.h"
 
+#if defined(ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
 vm::gvar<CellAdecCoreOps> g_cell_adec_core_ops_atracx2ch;
 vm::gvar<CellAdecCoreOps> g_cell_adec_core_ops_atracx6ch;
 vm::gvar<CellAdecCoreOps> g_cell_adec_core_ops_atracx8ch;
@@ -262,6 +266,85 @@ error_code AtracXdecDecoder::parse_ats_header(vm::cptr<u8> au_start_addr)
 	return set_config_info(sampling_freq, ch_config_idx, nbytes); // Cannot return error here, values were already checked
 }
 
+#if defined(ARCH_ARM64)
+namespace
+{
+	static_assert(ATXDEC_SAMPLES_PER_FRAME % 4 == 0);
+
+	// Stores four big endian samples, nch apart from each other
+	template <typename T, typename V>
+	void store_samples(T* out, u32 nch, V v)
+	{
+		if (nch == 1)
+		{
+			std::memcpy(out, &v, sizeof(T) * 4);
+			return;
+		}
+
+		T tmp[4];
+		std::memcpy(tmp, &v, sizeof(tmp));
+
+		for (u32 i = 0; i < 4; i++)
+		{
+			out[i * nch] = tmp[i];
+		}
+	}
+
+	// Same clamping and rounding as the scalar conversion: vcvtmq rounds toward minus infinity like std::floor and saturates
+	void convert_channel(u32 bw_pcm, const f32* samples, u8* out, u32 nch, u32 count)
+	{
+		const float32x4_t minus_one = vdupq_n_f32(-1.f);
+
+		switch (bw_pcm)
+		{
+		case CELL_ADEC_ATRACX_WORD_SZ_FLOAT:
+		{
+			const float32x4_t max = vdupq_n_f32(std::bit_cast<f32>(std::bit_cast<u32>(1.f) - 1));
+
+			for (u32 i = 0; i < count; i += 4)
+			{
+				const float32x4_t v = vminq_f32(vmaxq_f32(vld1q_f32(samples + i), minus_one), max);
+				store_samples(reinterpret_cast<u32*>(out) + i * nch, nch, vrev32q_u8(vreinterpretq_u8_f32(v)));
+			}
+			break;
+		}
+		case CELL_ADEC_ATRACX_WORD_SZ_16BIT:
+		{
+			for (u32 i = 0; i < count; i += 4)
+			{
+				const int16x4_t v = vqmovn_s32(vcvtmq_s32_f32(vmulq_n_f32(vld1q_f32(samples + i), 0x8000u)));
+				store_samples(reinterpret_cast<u16*>(out) + i * nch, nch, vrev16_u8(vreinterpret_u8_s16(v)));
+			}
+			break;
+		}
+		case CELL_ADEC_ATRACX_WORD_SZ_24BIT:
+		{
+			const int32x4_t max = vdupq_n_s32(0x007fffff);
+			const int32x4_t min = vdupq_n_s32(-0x00800000);
+			const int32x4_t mask = vdupq_n_s32(0x00ffffff);
+
+			for (u32 i = 0; i < count; i += 4)
+			{
+				const int32x4_t v = vandq_s32(vmaxq_s32(vminq_s32(vcvtmq_s32_f32(vmulq_n_f32(vld1q_f32(samples + i), 0x00800000u)), max), min), mask);
+				store_samples(reinterpret_cast<u32*>(out) + i * nch, nch, vrev32q_u8(vreinterpretq_u8_s32(v)));
+			}
+			break;
+		}
+		case CELL_ADEC_ATRACX_WORD_SZ_32BIT:
+		{
+			for (u32 i = 0; i < count; i += 4)
+			{
+				const int32x4_t v = vcvtmq_s32_f32(vmulq_n_f32(vld1q_f32(samples + i), 0x80000000u));
+				store_samples(reinterpret_cast<u32*>(out) + i * nch, nch, vrev32q_u8(vreinterpretq_u8_s32(v)));
+			}
+			break;
+		}
+		default: break;
+		}
+	}
+} // namespace
+#endif
+
 void AtracXdecContext::exec(ppu_thread& ppu)
 {
 	perf_meter<"ATXDEC"_u64> perf0;
@@ -501,11 +584,21 @@ void AtracXdecContext::exec(ppu_thread& ppu)
 				}
 
 				// Convert FFmpeg output to LLE output
+				const u8* const ch_map = ATXDEC_AVCODEC_CH_MAP[decoder.ch_config_idx - 1];
+				const u32 nch_in = decoder.nch_in;
+
+#if defined(ARCH_ARM64)
+				const u32 sample_size = decoder.bw_pcm == CELL_ADEC_ATRACX_WORD_SZ_16BIT ? sizeof(s16) : sizeof(f32);
+
+				for (u32 channel_idx = 0; channel_idx < nch_in; channel_idx++)
+				{
+					const f32* samples = reinterpret_cast<f32*>(decoder.frame->data[channel_idx]);
+					convert_channel(decoder.bw_pcm, samples, static_cast<u8*>(output.get_ptr()) + ch_map[channel_idx] * sample_size, nch_in, decoded_samples_num);
+				}
+#else
 				const auto output_f32 = vm::static_ptr_cast<f32>(output).get_ptr();
 				const auto output_s16 = vm::static_ptr_cast<s16>(output).get_ptr();
 				const auto output_s32 = vm::static_ptr_cast<s32>(output).get_ptr();
-				const u8* const ch_map = ATXDEC_AVCODEC_CH_MAP[decoder.ch_config_idx - 1];
-				const u32 nch_in = decoder.nch_in;
 
 				switch (decoder.bw_pcm)
 				{
@@ -608,6 +701,7 @@ void AtracXdecContext::exec(ppu_thread& ppu)
 						}
 					}
 				}
+#endif
 
 				first_decode = false;
 
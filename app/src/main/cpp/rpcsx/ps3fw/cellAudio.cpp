@@ -4,6 +4,7 @@
 #include "Emu/Audio/audio_utils.h"
 #include "Emu/Cell/PPUModule.h"
 #include "Emu/Cell/timers.hpp"
+#include "Emu/perf_trace.hpp"
 #include "cellos/sys_process.h"
 #include "cellos/sys_event.h"
 #include "cellAudio.h"
@@ -11,6 +12,10 @@
 
 #include <cmath>
 
+#if defined(ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
 LOG_CHANNEL(cellAudio);
 
 extern atomic_t<recording_mode> g_recording_mode;
@@ -964,6 +969,7 @@ void cell_audio_thread::operator()()
 		}
 
 		// Mix
+		perf_trace::scope trace(perf_trace::category::audio, "cellAudio mix");
 		float* buf = ringbuffer->get_current_buffer();
 
 		switch (cfg.audio_channels)
@@ -1041,6 +1047,69 @@ audio_port* cell_audio_thread::open_port()
 	return nullptr;
 }
 
+namespace
+{
+	// Byteswap one block of port samples and apply the per frame volume
+	template <u32 port_channels>
+	void load_port_samples(const be_t<f32>* src, f32* dst, const f32* frame_volume)
+	{
+		u32 frame = 0;
+
+#if defined(ARCH_ARM64)
+		const u8* const src_bytes = reinterpret_cast<const u8*>(src);
+
+		const auto load_be = [&](u32 index)
+		{
+			return vreinterpretq_f32_u8(vrev32q_u8(vld1q_u8(src_bytes + index * sizeof(f32))));
+		};
+
+		if constexpr (port_channels == 2)
+		{
+			for (; frame + 2 <= AUDIO_BUFFER_SAMPLES; frame += 2)
+			{
+				const float32x2_t vol = vld1_f32(frame_volume + frame);
+				const float32x4_t vol2 = vcombine_f32(vdup_lane_f32(vol, 0), vdup_lane_f32(vol, 1));
+				vst1q_f32(dst + frame * 2, vmulq_f32(load_be(frame * 2), vol2));
+			}
+		}
+		else
+		{
+			for (; frame < AUDIO_BUFFER_SAMPLES; frame++)
+			{
+				const float32x4_t vol = vdupq_n_f32(frame_volume[frame]);
+				vst1q_f32(dst + frame * 8 + 0, vmulq_f32(load_be(frame * 8 + 0), vol));
+				vst1q_f32(dst + frame * 8 + 4, vmulq_f32(load_be(frame * 8 + 4), vol));
+			}
+		}
+#endif
+
+		for (; frame < AUDIO_BUFFER_SAMPLES; frame++)
+		{
+			for (u32 ch = 0; ch < port_channels; ch++)
+			{
+				dst[frame * port_channels + ch] = src[frame * port_channels + ch] * frame_volume[frame];
+			}
+		}
+	}
+
+	void accumulate_samples(f32* dst, const f32* src, u32 count)
+	{
+		u32 i = 0;
+
+#if defined(ARCH_ARM64)
+		for (; i + 4 <= count; i += 4)
+		{
+			vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			dst[i] += src[i];
+		}
+	}
+} // namespace
+
 template <AudioChannelCnt channels, AudioChannelCnt downmix>
 void cell_audio_thread::mix(float* out_buffer, s32 offset)
 {
@@ -1054,6 +1123,10 @@ void cell_audio_thread::mix(float* out_buffer, s32 offset)
 	// Reset out_buffer
 	std::memset(out_buffer, 0, out_buffer_sz * sizeof(float));
 
+	// Port samples in host order with the volume applied
+	alignas(16) f32 samples[AUDIO_BUFFER_SAMPLES * 8];
+	alignas(16) f32 frame_volume[AUDIO_BUFFER_SAMPLES];
+
 	// mixing
 	for (audio_port& port : ports)
 	{
@@ -1086,42 +1159,73 @@ void cell_audio_thread::mix(float* out_buffer, s32 offset)
 			m = port.level * master_volume;
 		};
 
-		if (port.num_channels == 2)
+		if (port.num_channels != 2 && port.num_channels != 8)
 		{
-			for (u32 out = 0, in = 0; out < out_buffer_sz; out += out_channels, in += 2)
-			{
-				step_volume(port);
+			fmt::throw_exception("Unknown channel count (port=%u, channel=%d)", port.number, port.num_channels);
+		}
+
+		for (u32 frame = 0; frame < AUDIO_BUFFER_SAMPLES; frame++)
+		{
+			step_volume(port);
+			frame_volume[frame] = m;
+		}
 
-				const float left = buf[in + 0] * m;
-				const float right = buf[in + 1] * m;
+		if (port.num_channels == 2)
+		{
+			load_port_samples<2>(buf, samples, frame_volume);
 
-				out_buffer[out + 0] += left;
-				out_buffer[out + 1] += right;
+			if constexpr (out_channels == 2)
+			{
+				accumulate_samples(out_buffer, samples, out_buffer_sz);
+			}
+			else
+			{
+				for (u32 out = 0, in = 0; out < out_buffer_sz; out += out_channels, in += 2)
+				{
+					out_buffer[out + 0] += samples[in + 0];
+					out_buffer[out + 1] += samples[in + 1];
+				}
 			}
 		}
-		else if (port.num_channels == 8)
+		else
 		{
-			for (u32 out = 0, in = 0; out < out_buffer_sz; out += out_channels, in += 8)
+			load_port_samples<8>(buf, samples, frame_volume);
+
+			if constexpr (downmix == AudioChannelCnt::STEREO)
 			{
-				step_volume(port);
-
-				const float left = buf[in + 0] * m;
-				const float right = buf[in + 1] * m;
-				const float center = buf[in + 2] * m;
-				const float low_freq = buf[in + 3] * m;
-				const float side_left = buf[in + 4] * m;
-				const float side_right = buf[in + 5] * m;
-				const float rear_left = buf[in + 6] * m;
-				const float rear_right = buf[in + 7] * m;
-
-				if constexpr (downmix == AudioChannelCnt::STEREO)
+				// Don't mix in the lfe as per dolby specification and based on documentation
+				for (u32 out = 0, in = 0; out < out_buffer_sz; out += out_channels, in += 8)
 				{
-					// Don't mix in the lfe as per dolby specification and based on documentation
-					const float mid = center * 0.5f;
-					out_buffer[out + 0] += left * minus_3db + mid + side_left * 0.5f + rear_left * 0.5f;
-					out_buffer[out + 1] += right * minus_3db + mid + side_right * 0.5f + rear_right * 0.5f;
+#if defined(ARCH_ARM64)
+					const float32x4_t front = vld1q_f32(samples + in);    // L, R, C, LFE
+					const float32x4_t back = vld1q_f32(samples + in + 4); // side L, side R, rear L, rear R
+
+					float32x2_t mixed = vmul_n_f32(vget_low_f32(front), minus_3db);
+					mixed = vfma_n_f32(mixed, vdup_laneq_f32(front, 2), 0.5f);
+					mixed = vfma_n_f32(mixed, vadd_f32(vget_low_f32(back), vget_high_f32(back)), 0.5f);
+					vst1_f32(out_buffer + out, vadd_f32(vld1_f32(out_buffer + out), mixed));
+#else
+					const float mid = samples[in + 2] * 0.5f;
+					out_buffer[out + 0] += samples[in + 0] * minus_3db + mid + samples[in + 4] * 0.5f + samples[in + 6] * 0.5f;
+					out_buffer[out + 1] += samples[in + 1] * minus_3db + mid + samples[in + 5] * 0.5f + samples[in + 7] * 0.5f;
+#endif
 				}
-				else if constexpr (downmix == AudioChannelCnt::SURROUND_5_1)
+
+				continue;
+			}
+
+			for (u32 out = 0, in = 0; out < out_buffer_sz; out += out_channels, in += 8)
+			{
+				const float left = samples[in + 0];
+				const float right = samples[in + 1];
+				const float center = samples[in + 2];
+				const float low_freq = samples[in + 3];
+				const float side_left = samples[in + 4];
+				const float side_right = samples[in + 5];
+				const float rear_left = samples[in + 6];
+				const float rear_right = samples[in + 7];
+
+				if constexpr (downmix == AudioChannelCnt::SURROUND_5_1)
 				{
 					out_buffer[out + 0] += left;
 					out_buffer[out + 1] += right;
@@ -1169,10 +1273,6 @@ void cell_audio_thread::mix(float* out_buffer, s32 offset)
 				}
 			}
 		}
-		else
-		{
-			fmt::throw_exception("Unknown channel count (port=%u, channel=%d)", port.number, port.num_channels);
-		}
 	}
 }
 
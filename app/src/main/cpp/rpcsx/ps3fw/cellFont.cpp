@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "Emu/VFS.h"
 #include "Emu/Cell/PPUModule.h"
+#include "util/mutex.h"
 
 #include <stb_truetype.h>
 
@@ -8,6 +9,100 @@
 
 LOG_CHANNEL(cellFont);
 
+// Rasterized glyphs, keyed by font data, scale and code point.
+// Games redraw the same strings every frame, so the bitmaps are reused instead of rasterizing them again on each call.
+struct font_glyph_cache
+{
+	static constexpr usz max_bytes = 8 * 1024 * 1024;
+
+	struct glyph_t
+	{
+		s32 width = 0;
+		s32 height = 0;
+		s32 xoff = 0;
+		s32 yoff = 0;
+		std::vector<u8> bitmap; // Empty for glyphs without an image (spaces)
+	};
+
+	struct key_t
+	{
+		const u8* font_data;
+		u32 scale_bits;
+		u32 code;
+
+		bool operator==(const key_t&) const = default;
+	};
+
+	struct key_hash
+	{
+		usz operator()(const key_t& key) const noexcept
+		{
+			return std::hash<const u8*>{}(key.font_data) ^ (u64{key.scale_bits} << 32 | key.code) * 0x9e3779b97f4a7c15ull;
+		}
+	};
+
+	shared_mutex mutex;
+	std::unordered_map<key_t, std::shared_ptr<const glyph_t>, key_hash> glyphs;
+	usz bytes = 0;
+
+	std::shared_ptr<const glyph_t> get(const stbtt_fontinfo* info, f32 scale, u32 code)
+	{
+		const key_t key{info->data, std::bit_cast<u32>(scale), code};
+
+		{
+			reader_lock lock(mutex);
+
+			if (auto found = glyphs.find(key); found != glyphs.end())
+			{
+				return found->second;
+			}
+		}
+
+		auto glyph = std::make_shared<glyph_t>();
+
+		if (u8* box = stbtt_GetCodepointBitmap(info, scale, scale, code, &glyph->width, &glyph->height, &glyph->xoff, &glyph->yoff))
+		{
+			glyph->bitmap.assign(box, box + static_cast<usz>(glyph->width) * glyph->height);
+			stbtt_FreeBitmap(box, nullptr);
+		}
+
+		std::lock_guard lock(mutex);
+
+		if (bytes + glyph->bitmap.size() > max_bytes)
+		{
+			glyphs.clear();
+			bytes = 0;
+		}
+
+		const auto [it, inserted] = glyphs.emplace(key, std::move(glyph));
+
+		if (inserted)
+		{
+			bytes += it->second->bitmap.size();
+		}
+
+		return it->second;
+	}
+
+	void erase_font(const u8* font_data)
+	{
+		std::lock_guard lock(mutex);
+
+		for (auto it = glyphs.begin(); it != glyphs.end();)
+		{
+			if (it->first.font_data == font_data)
+			{
+				bytes -= it->second->bitmap.size();
+				it = glyphs.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+};
+
 template <>
 void fmt_class_string<CellFontError>::format(std::string& out, u64 arg)
 {
@@ -708,15 +803,17 @@ error_code cellFontRenderCharGlyphImage(vm::ptr<CellFont> font, u32 code, vm::pt
 	}
 
 	// Render the character
-	s32 width, height, xoff, yoff;
 	const f32 scale = stbtt_ScaleForPixelHeight(font->stbfont, font->scale_y);
-	unsigned char* box = stbtt_GetCodepointBitmap(font->stbfont, scale, scale, code, &width, &height, &xoff, &yoff);
+	const auto glyph = g_fxo->get<font_glyph_cache>().get(font->stbfont, scale, code);
 
-	if (!box)
+	if (glyph->bitmap.empty())
 	{
 		return CELL_OK;
 	}
 
+	const s32 width = glyph->width, height = glyph->height, yoff = glyph->yoff;
+	const u8* box = glyph->bitmap.data();
+
 	// Get the baseLineY value
 	s32 ascent, descent, lineGap;
 	stbtt_GetFontVMetrics(font->stbfont, &ascent, &descent, &lineGap);
@@ -738,7 +835,6 @@ error_code cellFontRenderCharGlyphImage(vm::ptr<CellFont> font, u32 code, vm::pt
 			buffer[(static_cast<s32>(y) + ypos + yoff + baseLineY) * surface->width + static_cast<s32>(x) + xpos] = box[ypos * width + xpos];
 		}
 	}
-	stbtt_FreeBitmap(box, nullptr);
 	return CELL_OK;
 }
 
@@ -859,6 +955,7 @@ error_code cellFontCloseFont(vm::ptr<CellFont> font)
 		font->origin == CELL_FONT_OPEN_FONT_FILE ||
 		font->origin == CELL_FONT_OPEN_MEMORY)
 	{
+		g_fxo->get<font_glyph_cache>().erase_font(vm::_ptr<u8>(font->fontdata_addr));
 		vm::dealloc(font->fontdata_addr, vm::main);
 	}
 
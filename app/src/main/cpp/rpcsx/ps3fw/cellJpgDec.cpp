@@ -9,6 +9,8 @@
 #include "cellos/sys_fs.h"
 #include "cellJpgDec.h"
 
+#include <thread>
+
 LOG_CHANNEL(cellJpgDec);
 
 // Temporarily
@@ -38,6 +40,49 @@ void fmt_class_string<CellJpgDecError>::format(std::string& out, u64 arg)
 		});
 }
 
+struct jpg_decode_job
+{
+	std::vector<u8> stream;
+	std::unique_ptr<unsigned char, decltype(&::free)> image{nullptr, &::free};
+	int width = 0;
+	int height = 0;
+	atomic_t<u32> done = 0;
+
+	void wait()
+	{
+		while (!done)
+		{
+			done.wait(0);
+		}
+	}
+};
+
+// Games usually open, read the header and decode right away, so the file read and the decode
+// are moved off the PPU thread as soon as the stream is opened and overlap with the guest setup
+static std::shared_ptr<jpg_decode_job> jpg_start_decode(fs::file& file, u64 size)
+{
+	auto job = std::make_shared<jpg_decode_job>();
+	job->stream.resize(size);
+
+	if (file.read(job->stream.data(), size) != size)
+	{
+		return nullptr;
+	}
+
+	file.seek(0);
+
+	std::thread([job]()
+		{
+			int actual_components;
+			job->image.reset(stbi_load_from_memory(job->stream.data(), ::narrow<int>(job->stream.size()), &job->width, &job->height, &actual_components, 4));
+			job->done.release(1);
+			job->done.notify_all();
+		})
+		.detach();
+
+	return job;
+}
+
 error_code cellJpgDecCreate(u32 mainHandle, u32 threadInParam, u32 threadOutParam)
 {
 	UNIMPLEMENTED_FUNC(cellJpgDec);
@@ -80,6 +125,7 @@ error_code cellJpgDecOpen(u32 mainHandle, vm::ptr<u32> subHandle, vm::ptr<CellJp
 			return CELL_JPGDEC_ERROR_OPEN_FILE;
 
 		current_subHandle.fileSize = file_s.size();
+		current_subHandle.decode = jpg_start_decode(file_s, current_subHandle.fileSize);
 		current_subHandle.fd = idm::make<lv2_fs_object, lv2_file>(src->fileName.get_ptr(), std::move(file_s), 0, 0, real_path);
 		break;
 	}
@@ -126,31 +172,32 @@ error_code cellJpgDecReadHeader(u32 mainHandle, u32 subHandle, vm::ptr<CellJpgDe
 		return CELL_JPGDEC_ERROR_FATAL;
 	}
 
-	const u32 fd = subHandle_data->fd;
 	const u64 fileSize = subHandle_data->fileSize;
 	CellJpgDecInfo& current_info = subHandle_data->info;
 
-	// Write the header to buffer
-	std::unique_ptr<u8[]> buffer(new u8[fileSize]);
+	// Parse the header in place, the file was already read by cellJpgDecOpen
+	const u8* buffer = nullptr;
 
 	switch (subHandle_data->src.srcSelect)
 	{
 	case CELL_JPGDEC_BUFFER:
-		std::memcpy(buffer.get(), vm::base(subHandle_data->src.streamPtr), fileSize);
+		buffer = vm::_ptr<const u8>(subHandle_data->src.streamPtr);
 		break;
 
 	case CELL_JPGDEC_FILE:
-	{
-		auto file = idm::get_unlocked<lv2_fs_object, lv2_file>(fd);
-		file->file.seek(0);
-		file->file.read(buffer.get(), fileSize);
+		buffer = subHandle_data->decode ? subHandle_data->decode->stream.data() : nullptr;
 		break;
-	}
+
 	default: break; // TODO
 	}
 
-	if (read_from_ptr<le_t<u32>>(buffer.get() + 0) != 0xE0FFD8FF || // Error: Not a valid SOI header
-		read_from_ptr<u32>(buffer.get() + 6) != "JFIF"_u32)         // Error: Not a valid JFIF string
+	if (!buffer || fileSize < 10)
+	{
+		return CELL_JPGDEC_ERROR_HEADER;
+	}
+
+	if (read_from_ptr<le_t<u32>>(buffer + 0) != 0xE0FFD8FF || // Error: Not a valid SOI header
+		read_from_ptr<u32>(buffer + 6) != "JFIF"_u32)         // Error: Not a valid JFIF string
 	{
 		return CELL_JPGDEC_ERROR_HEADER;
 	}
@@ -207,36 +254,39 @@ error_code cellJpgDecDecodeData(u32 mainHandle, u32 subHandle, vm::ptr<u8> data,
 		return CELL_JPGDEC_ERROR_FATAL;
 	}
 
-	const u32& fd = subHandle_data->fd;
 	const u64& fileSize = subHandle_data->fileSize;
 	const CellJpgDecOutParam& current_outParam = subHandle_data->outParam;
 
-	// Copy the JPG file to a buffer
-	std::unique_ptr<u8[]> jpg(new u8[fileSize]);
+	int width = 0, height = 0;
+	const unsigned char* pixels = nullptr;
+	std::unique_ptr<unsigned char, decltype(&::free)> image(nullptr, &::free);
 
 	switch (subHandle_data->src.srcSelect)
 	{
 	case CELL_JPGDEC_BUFFER:
-		std::memcpy(jpg.get(), vm::base(subHandle_data->src.streamPtr), fileSize);
+	{
+		// Decode straight from guest memory
+		int actual_components;
+		image.reset(stbi_load_from_memory(vm::_ptr<const u8>(subHandle_data->src.streamPtr), ::narrow<int>(fileSize), &width, &height, &actual_components, 4));
+		pixels = image.get();
 		break;
+	}
 
 	case CELL_JPGDEC_FILE:
 	{
-		auto file = idm::get_unlocked<lv2_fs_object, lv2_file>(fd);
-		file->file.seek(0);
-		file->file.read(jpg.get(), fileSize);
+		if (const auto& job = subHandle_data->decode)
+		{
+			job->wait();
+			width = job->width;
+			height = job->height;
+			pixels = job->image.get();
+		}
 		break;
 	}
 	default: break; // TODO
 	}
 
-	// Decode JPG file. (TODO: Is there any faster alternative? Can we do it without external libraries?)
-	int width, height, actual_components;
-	auto image = std::unique_ptr<unsigned char, decltype(&::free)>(
-		stbi_load_from_memory(jpg.get(), ::narrow<int>(fileSize), &width, &height, &actual_components, 4),
-		&::free);
-
-	if (!image)
+	if (!pixels)
 		return CELL_JPGDEC_ERROR_STREAM_FORMAT;
 
 	const bool flip = current_outParam.outputMode == CELL_JPGDEC_BOTTOM_TO_TOP;
@@ -257,12 +307,12 @@ error_code cellJpgDecDecodeData(u32 mainHandle, u32 subHandle, vm::ptr<u8> data,
 			{
 				const int dstOffset = i * bytesPerLine;
 				const int srcOffset = width * nComponents * (flip ? height - i - 1 : i);
-				memcpy(&data[dstOffset], &image.get()[srcOffset], linesize);
+				memcpy(&data[dstOffset], &pixels[srcOffset], linesize);
 			}
 		}
 		else
 		{
-			memcpy(data.get_ptr(), image.get(), image_size);
+			memcpy(data.get_ptr(), pixels, image_size);
 		}
 		break;
 	}
@@ -281,27 +331,23 @@ error_code cellJpgDecDecodeData(u32 mainHandle, u32 subHandle, vm::ptr<u8> data,
 				const int srcOffset = width * nComponents * (flip ? height - i - 1 : i);
 				for (int j = 0; j < linesize; j += nComponents)
 				{
-					output[j + 0] = image.get()[srcOffset + j + 3];
-					output[j + 1] = image.get()[srcOffset + j + 0];
-					output[j + 2] = image.get()[srcOffset + j + 1];
-					output[j + 3] = image.get()[srcOffset + j + 2];
+					output[j + 0] = pixels[srcOffset + j + 3];
+					output[j + 1] = pixels[srcOffset + j + 0];
+					output[j + 2] = pixels[srcOffset + j + 1];
+					output[j + 3] = pixels[srcOffset + j + 2];
 				}
 				std::memcpy(&data[dstOffset], output.get(), linesize);
 			}
 		}
 		else
 		{
-			const auto img = std::make_unique<uint[]>(image_size);
-			uint* source_current = reinterpret_cast<uint*>(image.get());
-			uint* dest_current = img.get();
-			for (uint i = 0; i < image_size / nComponents; i++)
+			// Rotate RGBA to ARGB directly into the output
+			u8* dest = data.get_ptr();
+			for (usz i = 0; i < image_size; i += nComponents)
 			{
-				uint val = *source_current;
-				*dest_current = (val >> 24) | (val << 8); // set alpha (A8) as leftmost byte
-				source_current++;
-				dest_current++;
+				const u32 val = read_from_ptr<u32>(pixels + i);
+				write_to_ptr<u32>(dest + i, (val >> 24) | (val << 8)); // set alpha (A8) as leftmost byte
 			}
-			std::memcpy(data.get_ptr(), img.get(), image_size);
 		}
 		break;
 	}
@@ -7,6 +7,7 @@
 #include "Emu/RSX/Overlays/overlay_debug_overlay.h"
 #include "Input/pad_thread.h"
 #include "Input/product_info.h"
+#include "Input/virtual_pad_handler.h"
 #include "cellPad.h"
 
 error_code sys_config_start(ppu_thread& ppu);
@@ -350,6 +351,12 @@ void pad_get_data(u32 port_no, CellPadData* data, bool get_periph_data = false)
 	const auto& pad = handler->GetPads()[port_no];
 	const PadInfo& rinfo = handler->GetInfo();
 
+	if (pad->m_pad_handler == pad_handler::virtual_pad && pad->m_player_id == 0)
+	{
+		// The overlay state is taken when the guest asks for it, not when the pad thread runs
+		virtual_pad_handler::latch(*pad);
+	}
+
 	if (rinfo.system_info & CELL_PAD_INFO_INTERCEPTED)
 	{
 		data->len = CELL_PAD_LEN_NO_CHANGE;
@@ -24,8 +24,11 @@
 #include "util/sema.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <span>
+#include <thread>
 
 #include "rx/asm.hpp"
 #include "rx/align.hpp"
@@ -123,9 +126,192 @@ namespace
 
 vm::gvar<savedata_context> g_savedata_context;
 
+// Savedata directory update prepared by savedata_op(), files are in memory
+struct savedata_commit
+{
+	std::string base_dir;
+	std::string dir_path;
+	std::string old_path;
+	std::string new_path;
+	std::map<std::string, std::vector<uchar>> files;
+	std::map<std::string, std::pair<s64, s64>> times; // Unmodified files
+};
+
+static void commit_savedata(savedata_commit& job)
+{
+	// First, create temporary directory
+	if (fs::create_dir(job.new_path) || fs::g_tls_error == fs::error::exist)
+	{
+		fs::remove_all(job.new_path, false);
+	}
+	else
+	{
+		cellSaveData.fatal("Failed to create directory %s (%s)", job.new_path,
+			fs::g_tls_error);
+		return;
+	}
+
+	// Write all files in temporary directory
+	for (auto&& [name, data] : job.files)
+	{
+		const std::string path = job.new_path + vfs::escape(name);
+
+#ifdef _WIN32
+		fs::pending_file f(path);
+		f.file.write(data);
+
+		if (!f.commit())
+		{
+			cellSaveData.fatal("Failed to write %s (%s)", path, fs::g_tls_error);
+			return;
+		}
+#else
+		fs::file f(path, fs::rewrite);
+
+		if (!f || f.write(data) != data.size())
+		{
+			cellSaveData.fatal("Failed to write %s (%s)", path, fs::g_tls_error);
+			return;
+		}
+
+		// Data has to be on the disk before the directories are swapped
+		f.sync();
+#endif
+	}
+
+	for (auto&& [name, times] : job.times)
+	{
+		// Restore atime/mtime for files which have not been modified
+		fs::utime(job.new_path + vfs::escape(name), times.first, times.second);
+	}
+
+	// Remove old backup
+	fs::remove_all(job.old_path);
+
+	// Backup old savedata
+	if (!vfs::host::rename(job.dir_path, job.old_path, &g_mp_sys_dev_hdd0, false))
+	{
+		cellSaveData.fatal("Failed to move directory %s (%s)", job.dir_path,
+			fs::g_tls_error);
+		return;
+	}
+
+	// Commit new savedata, the backup is restored by savedata_op() if this
+	// didn't happen
+	if (!vfs::host::rename(job.new_path, job.dir_path, &g_mp_sys_dev_hdd0, false))
+	{
+		cellSaveData.fatal("Failed to move directory %s (%s)", job.new_path,
+			fs::g_tls_error);
+		return;
+	}
+
+	// Persist the renames before the backup is gone
+	if (fs::file dir{job.base_dir})
+	{
+		dir.sync();
+	}
+
+	// Remove backup again (TODO: may be changed to persistent backup
+	// implementation)
+	fs::remove_all(job.old_path);
+}
+
+// Write-behind queue of savedata commits. Commits are applied in order by a
+// single thread, the queue is drained before the next savedata operation and
+// on emulation stop
+class savedata_writer
+{
+public:
+	savedata_writer() = default;
+	savedata_writer(const savedata_writer&) = delete;
+	savedata_writer& operator=(const savedata_writer&) = delete;
+
+	~savedata_writer()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_stop = true;
+		}
+
+		m_cv.notify_all();
+
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+
+	void push(savedata_commit&& job)
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_jobs.push_back(std::move(job));
+
+			if (!m_thread.joinable())
+			{
+				m_thread = std::thread([this] { run(); });
+			}
+		}
+
+		m_cv.notify_all();
+	}
+
+	// Wait for all queued commits
+	void wait()
+	{
+		std::unique_lock lock(m_mutex);
+		m_cv.wait(lock, [this] { return m_jobs.empty() && !m_busy; });
+	}
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::deque<savedata_commit> m_jobs;
+	bool m_busy = false;
+	bool m_stop = false;
+	std::thread m_thread;
+
+	void run()
+	{
+		std::unique_lock lock(m_mutex);
+
+		while (true)
+		{
+			m_cv.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+
+			// Pending commits are still written on stop
+			if (m_jobs.empty())
+			{
+				return;
+			}
+
+			savedata_commit job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+			m_busy = true;
+
+			lock.unlock();
+
+			try
+			{
+				commit_savedata(job);
+			}
+			catch (const std::exception& e)
+			{
+				cellSaveData.fatal("Failed to commit %s: %s", job.dir_path, e.what());
+			}
+
+			lock.lock();
+
+			m_busy = false;
+			m_cv.notify_all();
+		}
+	}
+};
+
 struct savedata_manager
 {
 	semaphore<> mutex;
+	savedata_writer writer;
 	atomic_t<bool> enable_overlay{false};
 	atomic_t<s32> last_cbresult_error_dialog{0}; // CBRESULT errors are negative
 };
@@ -302,6 +488,9 @@ static error_code select_and_delete(ppu_thread& ppu)
 		return CELL_SAVEDATA_ERROR_BUSY;
 	}
 
+	// Savedata written by the previous operation must be visible to this one
+	g_fxo->get<savedata_manager>().writer.wait();
+
 	const std::string base_dir =
 		vfs::get(fmt::format("/dev_hdd0/home/%08u/savedata/", Emu.GetUsrId()));
 
@@ -818,6 +1007,9 @@ savedata_op(ppu_thread& ppu, u32 operation, u32 version, vm::cptr<char> dirName,
 		return CELL_SAVEDATA_ERROR_BUSY;
 	}
 
+	// Savedata written by the previous operation must be visible to this one
+	g_fxo->get<savedata_manager>().writer.wait();
+
 	// Simulate idle time while data is being sent to VSH
 	const auto lv2_sleep = [](ppu_thread& ppu, usz sleep_time)
 	{
@@ -1622,6 +1814,14 @@ savedata_op(ppu_thread& ppu, u32 operation, u32 version, vm::cptr<char> dirName,
 	const std::string new_path =
 		base_dir + ".working_" + save_entry.escaped + "/";
 
+	if (!fs::is_dir(dir_path) && fs::is_dir(old_path))
+	{
+		// Interrupted commit, restore the previous savedata
+		cellSaveData.warning("savedata_op(): restoring backup %s", old_path);
+		fs::remove_all(new_path);
+		vfs::host::rename(old_path, dir_path, &g_mp_sys_dev_hdd0, false);
+	}
+
 	psf::registry psf = psf::load_object(dir_path + "PARAM.SFO");
 	bool has_modified = false;
 	bool recreated = false;
@@ -2332,17 +2532,6 @@ savedata_op(ppu_thread& ppu, u32 operation, u32 version, vm::cptr<char> dirName,
 	// Write PARAM.SFO and savedata
 	if (!psf.empty() && has_modified)
 	{
-		// First, create temporary directory
-		if (fs::create_dir(new_path) || fs::g_tls_error == fs::error::exist)
-		{
-			fs::remove_all(new_path, false);
-		}
-		else
-		{
-			fmt::throw_exception("Failed to create directory %s (%s)", new_path,
-				fs::g_tls_error);
-		}
-
 		// add file list per FS order to PARAM.SFO
 		std::string final_blist;
 		final_blist = fmt::merge(blist, "/");
@@ -2355,52 +2544,25 @@ savedata_op(ppu_thread& ppu, u32 operation, u32 version, vm::cptr<char> dirName,
 		fsfo = fs::make_stream<std::vector<uchar>>();
 		fsfo.write(psf::save_object(psf));
 
+		savedata_commit job;
+		job.base_dir = base_dir;
+		job.dir_path = dir_path;
+		job.old_path = old_path;
+		job.new_path = new_path;
+		job.times = std::move(all_times);
+
 		for (auto&& pair : all_files)
 		{
 			if (auto file = pair.second.release())
 			{
 				auto&& fvec =
 					static_cast<fs::container_stream<std::vector<uchar>>&>(*file);
-#ifdef _WIN32
-				fs::pending_file f(new_path + vfs::escape(pair.first));
-				f.file.write(fvec.obj);
-				ensure(f.commit());
-#else
-				ensure(fs::write_file(new_path + vfs::escape(pair.first), fs::rewrite,
-					fvec.obj));
-#endif
+				job.files.emplace(pair.first, std::move(fvec.obj));
 			}
 		}
 
-		for (auto&& pair : all_times)
-		{
-			// Restore atime/mtime for files which have not been modified
-			fs::utime(new_path + vfs::escape(pair.first), pair.second.first,
-				pair.second.second);
-		}
-
-		// Remove old backup
-		fs::remove_all(old_path);
-		fs::sync();
-
-		// Backup old savedata
-		if (!vfs::host::rename(dir_path, old_path, &g_mp_sys_dev_hdd0, false))
-		{
-			fmt::throw_exception("Failed to move directory %s (%s)", dir_path,
-				fs::g_tls_error);
-		}
-
-		// Commit new savedata
-		if (!vfs::host::rename(new_path, dir_path, &g_mp_sys_dev_hdd0, false))
-		{
-			// TODO: handle the case when only commit failed at the next save load
-			fmt::throw_exception("Failed to move directory %s (%s)", new_path,
-				fs::g_tls_error);
-		}
-
-		// Remove backup again (TODO: may be changed to persistent backup
-		// implementation)
-		fs::remove_all(old_path);
+		// The guest continues once the data is queued
+		g_fxo->get<savedata_manager>().writer.push(std::move(job));
 	}
 
 	if (show_auto_indicator)
@@ -2932,7 +2932,7 @@ s32 cellSpursReadyCountSwap(ppu_thread& ppu, vm::ptr<CellSpurs> spurs, u32 wid,
 		return CELL_SPURS_POLICY_MODULE_ERROR_STAT;
 	}
 
-	*old = vm::light_op(spurs->readyCount(wid), [&](atomic_t<u8>& v)
+	*old = vm::light_op<true>(spurs->readyCount(wid), [&](atomic_t<u8>& v)
 		{
 			return v.exchange(static_cast<u8>(swap));
 		});
@@ -2972,7 +2972,7 @@ s32 cellSpursReadyCountCompareAndSwap(ppu_thread& ppu, vm::ptr<CellSpurs> spurs,
 
 	u8 temp = static_cast<u8>(compare);
 
-	vm::light_op(spurs->readyCount(wid), [&](atomic_t<u8>& v)
+	vm::light_op<true>(spurs->readyCount(wid), [&](atomic_t<u8>& v)
 		{
 			v.compare_exchange(temp, static_cast<u8>(swap));
 		});
@@ -3011,7 +3011,7 @@ s32 cellSpursReadyCountAdd(ppu_thread& ppu, vm::ptr<CellSpurs> spurs, u32 wid, v
 		return CELL_SPURS_POLICY_MODULE_ERROR_STAT;
 	}
 
-	*old = vm::fetch_op(spurs->readyCount(wid), [&](u8& val)
+	*old = vm::fetch_op<true>(spurs->readyCount(wid), [&](u8& val)
 		{
 			val = static_cast<u8>(std::clamp<s32>(val + static_cast<u32>(value), 0, 255));
 		});
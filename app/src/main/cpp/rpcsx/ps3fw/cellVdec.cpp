@@ -7,6 +7,7 @@
 #include "Emu/IdManager.h"
 #include "Emu/perf_meter.hpp"
 #include "Emu/savestate_utils.hpp"
+#include "Emu/system_config.h"
 #include "rx/align.hpp"
 #include "sysPrxForUser.h"
 #include "util/media_utils.h"
@@ -192,10 +193,12 @@ struct vdec_context final
 	atomic_t<bool> is_running = false;   // Used for thread interaction
 	atomic_t<sequence_state> seq_state = sequence_state::closed;
 
+	AVCodecID codec_id{};
 	const AVCodec* codec{};
 	const AVCodecDescriptor* codec_desc{};
 	AVCodecContext* ctx{};
 	SwsContext* sws{};
+	bool hw_decoder = false; // MediaCodec wrapper decoder is used
 
 	shared_mutex mutex; // Used for 'out' queue (TODO)
 
@@ -228,17 +231,17 @@ struct vdec_context final
 		{
 		case CELL_VDEC_CODEC_TYPE_MPEG2:
 		{
-			codec = avcodec_find_decoder(AV_CODEC_ID_MPEG2VIDEO);
+			codec_id = AV_CODEC_ID_MPEG2VIDEO;
 			break;
 		}
 		case CELL_VDEC_CODEC_TYPE_AVC:
 		{
-			codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+			codec_id = AV_CODEC_ID_H264;
 			break;
 		}
 		case CELL_VDEC_CODEC_TYPE_DIVX:
 		{
-			codec = avcodec_find_decoder(AV_CODEC_ID_MPEG4);
+			codec_id = AV_CODEC_ID_MPEG4;
 			break;
 		}
 		default:
@@ -247,11 +250,25 @@ struct vdec_context final
 		}
 		}
 
-		if (!codec)
+#ifdef ANDROID
+		if (g_cfg.video.hw_video_decoding && codec_id != AV_CODEC_ID_MPEG4)
 		{
-			fmt::throw_exception("avcodec_find_decoder() failed (type=0x%x)", type);
+			open_hw_decoder();
 		}
+#endif
+
+		if (!ctx)
+		{
+			open_sw_decoder();
+		}
+
+		seq_state = sequence_state::dormant;
+	}
 
+	// Returns avcodec_open2 error, ctx is left null on failure
+	int open_decoder(const AVCodec* dec, std::string& dict_content)
+	{
+		codec = dec;
 		codec_desc = avcodec_descriptor_get(codec->id);
 
 		if (!codec_desc)
@@ -266,6 +283,14 @@ struct vdec_context final
 			fmt::throw_exception("avcodec_alloc_context3() failed (type=0x%x)", type);
 		}
 
+		if (hw_decoder)
+		{
+			// MediaCodec is configured before the first sequence header is seen,
+			// the real dimensions are taken from its output format later
+			ctx->width = 1920;
+			ctx->height = 1088;
+		}
+
 		AVDictionary* opts = nullptr;
 
 		std::lock_guard lock(g_mutex_avcodec_open2);
@@ -274,7 +299,7 @@ struct vdec_context final
 		if (err || opts)
 		{
 			avcodec_free_context(&ctx);
-			std::string dict_content;
+
 			if (opts)
 			{
 				AVDictionaryEntry* tag = nullptr;
@@ -283,14 +308,64 @@ struct vdec_context final
 					fmt::append(dict_content, "['%s': '%s']", tag->key, tag->value);
 				}
 			}
+
+			av_dict_free(&opts);
+			return err ? err : AVERROR(EINVAL);
+		}
+
+		return 0;
+	}
+
+	void open_sw_decoder()
+	{
+		avcodec_free_context(&ctx);
+		hw_decoder = false;
+
+		const AVCodec* dec = avcodec_find_decoder(codec_id);
+
+		if (!dec)
+		{
+			fmt::throw_exception("avcodec_find_decoder() failed (type=0x%x)", type);
+		}
+
+		std::string dict_content;
+
+		if (int err = open_decoder(dec, dict_content))
+		{
 			fmt::throw_exception("avcodec_open2() failed (err=0x%x='%s', opts=%s)",
 				err, utils::av_error_to_string(err), dict_content);
 		}
+	}
 
-		av_dict_free(&opts);
+#ifdef ANDROID
+	// Hardware decoding through FFmpeg MediaCodec wrappers. Decoded pictures are
+	// copied back to system memory (NV12 in most cases) and go through the same
+	// swscale conversion as software frames
+	bool open_hw_decoder()
+	{
+		const AVCodec* dec = avcodec_find_decoder_by_name(codec_id == AV_CODEC_ID_H264 ? "h264_mediacodec" : "mpeg2_mediacodec");
 
-		seq_state = sequence_state::dormant;
+		if (!dec)
+		{
+			return false;
+		}
+
+		hw_decoder = true;
+
+		std::string dict_content;
+
+		if (int err = open_decoder(dec, dict_content))
+		{
+			cellVdec.warning("Failed to open %s, using software decoder (err=0x%x='%s', opts=%s)",
+				dec->name, err, utils::av_error_to_string(err), dict_content);
+			hw_decoder = false;
+			return false;
+		}
+
+		cellVdec.notice("Using hardware video decoder %s (type=0x%x)", dec->name, type);
+		return true;
 	}
+#endif
 
 	~vdec_context()
 	{
@@ -409,9 +484,10 @@ struct vdec_context final
 
 				const CellVdecPicAttr attr = au_mode == CELL_VDEC_DEC_MODE_NORMAL ? CELL_VDEC_PICITEM_ATTR_NORMAL : CELL_VDEC_PICITEM_ATTR_SKIPPED;
 
-				ctx->skip_frame =
+				const AVDiscard skip_frame =
 					au_mode == CELL_VDEC_DEC_MODE_NORMAL ? AVDISCARD_DEFAULT : au_mode == CELL_VDEC_DEC_MODE_B_SKIP ? AVDISCARD_NONREF :
 																													  AVDISCARD_NONINTRA;
+				ctx->skip_frame = skip_frame;
 
 				std::deque<vdec_frame> decoded_frames;
 
@@ -422,12 +498,24 @@ struct vdec_context final
 						handle, cmd->seq_id, cmd->id, au_size, au_pts, au_dts,
 						au_usrd);
 
-					if (int ret = avcodec_send_packet(ctx, &packet); ret < 0)
+					int send_ret = avcodec_send_packet(ctx, &packet);
+
+					if (send_ret < 0 && hw_decoder)
+					{
+						// References are lost, the software decoder resyncs on the next key frame
+						cellVdec.warning("Hardware decoder failed, switching to software (handle=0x%x, error=0x%x): %s",
+							handle, send_ret, utils::av_error_to_string(send_ret));
+						open_sw_decoder();
+						ctx->skip_frame = skip_frame;
+						send_ret = avcodec_send_packet(ctx, &packet);
+					}
+
+					if (send_ret < 0)
 					{
 						fmt::throw_exception("AU queuing error (handle=0x%x, seq_id=%d, "
 											 "cmd_id=%d, error=0x%x): %s",
-							handle, cmd->seq_id, cmd->id, ret,
-							utils::av_error_to_string(ret));
+							handle, cmd->seq_id, cmd->id, send_ret,
+							utils::av_error_to_string(send_ret));
 					}
 
 					while (!abort_decode && seq_id == cmd->seq_id)
@@ -453,6 +541,15 @@ struct vdec_context final
 								break;
 							}
 
+							if (hw_decoder)
+							{
+								cellVdec.warning("Hardware decoder failed, switching to software (handle=0x%x, error=0x%x): %s",
+									handle, ret, utils::av_error_to_string(ret));
+								open_sw_decoder();
+								ctx->skip_frame = skip_frame;
+								break;
+							}
+
 							fmt::throw_exception("AU decoding error (handle=0x%x, seq_id=%d, "
 												 "cmd_id=%d, error=0x%x): %s",
 								handle, cmd->seq_id, cmd->id, ret,
@@ -1498,6 +1595,10 @@ error_code cellVdecGetPictureExt(ppu_thread& ppu, u32 handle,
 		case AV_PIX_FMT_YUV420P:
 			in_f = alpha_plane ? AV_PIX_FMT_YUVA420P : static_cast<AVPixelFormat>(frame->format);
 			break;
+		case AV_PIX_FMT_NV12:
+			// Hardware decoder output, alpha is written after conversion
+			in_f = AV_PIX_FMT_NV12;
+			break;
 		default:
 			fmt::throw_exception("cellVdecGetPictureExt: Unknown frame format (%d)",
 				frame->format);
@@ -1542,6 +1643,16 @@ error_code cellVdecGetPictureExt(ppu_thread& ppu, u32 handle,
 		}
 
 		sws_scale(vdec->sws, in_data, in_line, 0, h, out_data, out_line);
+
+		if (alpha_plane && in_f == AV_PIX_FMT_NV12 && format->alpha != 0xff)
+		{
+			u8* alpha = out_data[0] + (out_f == AV_PIX_FMT_ARGB ? 0 : 3);
+
+			for (int i = 0; i < w * h; i++)
+			{
+				alpha[i * 4] = format->alpha;
+			}
+		}
 	}
 
 	return CELL_OK;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "util/types.hpp"
+#include "util/atomic.hpp"
 #include "Emu/Memory/vm_ptr.h"
 #include <vector>
 
@@ -16,6 +17,11 @@ struct shle_pattern
 	u32 fnid;
 };
 
+// Decides whether a matched function of the title may be replaced (null: all allowed)
+using shle_filter_t = bool (*)(const char* title_id, const char* func_name);
+
+extern atomic_t<shle_filter_t> g_shle_filter;
+
 class statichle_handler
 {
 public:
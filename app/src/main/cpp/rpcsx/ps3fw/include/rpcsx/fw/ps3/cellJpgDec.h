@@ -105,6 +105,9 @@ struct CellJpgDecDataOutInfo
 };
 
 // Custom structs
+// File stream read and decoded to RGBA8 in the background, see cellJpgDec.cpp
+struct jpg_decode_job;
+
 struct CellJpgDecSubHandle
 {
 	static const u32 id_base = 1;
@@ -117,4 +120,7 @@ struct CellJpgDecSubHandle
 	CellJpgDecInfo info;
 	CellJpgDecOutParam outParam;
 	CellJpgDecSrc src;
+
+	// Started by cellJpgDecOpen for file sources, null for buffer sources
+	std::shared_ptr<jpg_decode_job> decode;
 };
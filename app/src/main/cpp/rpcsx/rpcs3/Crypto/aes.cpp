@@ -31,6 +31,7 @@
 
 #include "aes.h"
 #include "aesni.h"
+#include "aesce.h"
 
 #include <algorithm>
 
@@ -670,6 +671,11 @@ int aes_crypt_ecb( aes_context *ctx,
         return( aesni_crypt_ecb( ctx, mode, input, output ) );
 #endif
 
+#if defined(POLARSSL_HAVE_AESCE)
+    if( aesce_supports( POLARSSL_AESCE_AES ) )
+        return( aesce_crypt_ecb( ctx, mode, input, output ) );
+#endif
+
     RK = ctx->rk;
 
     GET_UINT32_LE( X0, input,  0 ); X0 ^= *RK++;
@@ -770,6 +776,11 @@ int aes_crypt_cbc( aes_context *ctx,
     if( length % 16 )
         return( POLARSSL_ERR_AES_INVALID_INPUT_LENGTH );
 
+#if defined(POLARSSL_HAVE_AESCE)
+    if( mode == AES_DECRYPT && aesce_supports( POLARSSL_AESCE_AES ) )
+        return( aesce_crypt_cbc_dec( ctx, length, iv, input, output ) );
+#endif
+
     if( mode == AES_DECRYPT )
     {
         while( length > 0 )
@@ -866,6 +877,20 @@ int aes_crypt_ctr( aes_context *ctx,
     int c, i;
     size_t n = *nc_off;
 
+#if defined(POLARSSL_HAVE_AESCE)
+    // Block aligned part in bulk, the tail continues byte-wise below
+    if( n == 0 && length >= 16 && aesce_supports( POLARSSL_AESCE_AES ) )
+    {
+        const size_t blocks = length >> 4;
+
+        aesce_crypt_ctr( ctx, blocks, nonce_counter, stream_block, input, output );
+
+        input  += blocks << 4;
+        output += blocks << 4;
+        length &= 15;
+    }
+#endif
+
     while( length-- )
     {
         if( n == 0 ) {
@@ -0,0 +1,615 @@
+#include "aesce.h"
+
+#if defined(POLARSSL_HAVE_AESCE)
+
+/*
+ *  AES, SHA-1 and SHA-256 via the ARMv8 Cryptography Extensions
+ *
+ *  [ARMv8-ARM] Arm Architecture Reference Manual, AESE/AESD/AESMC/AESIMC,
+ *  SHA1C/SHA1P/SHA1M/SHA1H/SHA1SU0/SHA1SU1, SHA256H/SHA256H2/SHA256SU0/SHA256SU1
+ */
+
+#include <arm_neon.h>
+
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#if defined(__linux__)
+#ifndef HWCAP_AES
+#define HWCAP_AES   (1 << 3)
+#endif
+#ifndef HWCAP_SHA1
+#define HWCAP_SHA1  (1 << 5)
+#endif
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2  (1 << 6)
+#endif
+#endif
+
+/*
+ * Crypto Extensions support detection routine
+ */
+int aesce_supports( unsigned int what )
+{
+    static const unsigned int c = []
+    {
+        unsigned int caps = 0;
+#if defined(__linux__)
+        const unsigned long hwcap = getauxval( AT_HWCAP );
+
+        if( hwcap & HWCAP_AES )
+            caps |= POLARSSL_AESCE_AES;
+        if( hwcap & HWCAP_SHA1 )
+            caps |= POLARSSL_AESCE_SHA1;
+        if( hwcap & HWCAP_SHA2 )
+            caps |= POLARSSL_AESCE_SHA256;
+#elif defined(__APPLE__)
+        // Every Apple arm64 core implements them
+        caps = POLARSSL_AESCE_AES | POLARSSL_AESCE_SHA1 | POLARSSL_AESCE_SHA256;
+#elif defined(_WIN32)
+        if( IsProcessorFeaturePresent( PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE ) )
+            caps = POLARSSL_AESCE_AES | POLARSSL_AESCE_SHA1 | POLARSSL_AESCE_SHA256;
+#endif
+        return caps;
+    }();
+
+    return( ( c & what ) == what );
+}
+
+/*
+ * Single block: AESE folds the round key xor into SubBytes/ShiftRows,
+ * so the last round key is applied with a plain xor
+ */
+POLARSSL_AESCE_TARGET
+static inline uint8x16_t aesce_encrypt_block( uint8x16_t b, const unsigned char *rk, int nr )
+{
+    for( int i = nr - 1; i > 0; i--, rk += 16 )
+        b = vaesmcq_u8( vaeseq_u8( b, vld1q_u8( rk ) ) );
+
+    b = vaeseq_u8( b, vld1q_u8( rk ) );
+    return( veorq_u8( b, vld1q_u8( rk + 16 ) ) );
+}
+
+POLARSSL_AESCE_TARGET
+static inline uint8x16_t aesce_decrypt_block( uint8x16_t b, const unsigned char *rk, int nr )
+{
+    for( int i = nr - 1; i > 0; i--, rk += 16 )
+        b = vaesimcq_u8( vaesdq_u8( b, vld1q_u8( rk ) ) );
+
+    b = vaesdq_u8( b, vld1q_u8( rk ) );
+    return( veorq_u8( b, vld1q_u8( rk + 16 ) ) );
+}
+
+/*
+ * Four independent blocks: each round key is loaded once and the AES
+ * pipeline stays busy instead of waiting on the previous round's result
+ */
+POLARSSL_AESCE_TARGET
+static inline void aesce_encrypt_4( uint8x16_t &b0, uint8x16_t &b1, uint8x16_t &b2, uint8x16_t &b3,
+                                    const unsigned char *rk, int nr )
+{
+    uint8x16_t k;
+
+    for( int i = nr - 1; i > 0; i--, rk += 16 )
+    {
+        k = vld1q_u8( rk );
+        b0 = vaesmcq_u8( vaeseq_u8( b0, k ) );
+        b1 = vaesmcq_u8( vaeseq_u8( b1, k ) );
+        b2 = vaesmcq_u8( vaeseq_u8( b2, k ) );
+        b3 = vaesmcq_u8( vaeseq_u8( b3, k ) );
+    }
+
+    k = vld1q_u8( rk );
+    b0 = vaeseq_u8( b0, k );
+    b1 = vaeseq_u8( b1, k );
+    b2 = vaeseq_u8( b2, k );
+    b3 = vaeseq_u8( b3, k );
+
+    k = vld1q_u8( rk + 16 );
+    b0 = veorq_u8( b0, k );
+    b1 = veorq_u8( b1, k );
+    b2 = veorq_u8( b2, k );
+    b3 = veorq_u8( b3, k );
+}
+
+POLARSSL_AESCE_TARGET
+static inline void aesce_decrypt_4( uint8x16_t &b0, uint8x16_t &b1, uint8x16_t &b2, uint8x16_t &b3,
+                                    const unsigned char *rk, int nr )
+{
+    uint8x16_t k;
+
+    for( int i = nr - 1; i > 0; i--, rk += 16 )
+    {
+        k = vld1q_u8( rk );
+        b0 = vaesimcq_u8( vaesdq_u8( b0, k ) );
+        b1 = vaesimcq_u8( vaesdq_u8( b1, k ) );
+        b2 = vaesimcq_u8( vaesdq_u8( b2, k ) );
+        b3 = vaesimcq_u8( vaesdq_u8( b3, k ) );
+    }
+
+    k = vld1q_u8( rk );
+    b0 = vaesdq_u8( b0, k );
+    b1 = vaesdq_u8( b1, k );
+    b2 = vaesdq_u8( b2, k );
+    b3 = vaesdq_u8( b3, k );
+
+    k = vld1q_u8( rk + 16 );
+    b0 = veorq_u8( b0, k );
+    b1 = veorq_u8( b1, k );
+    b2 = veorq_u8( b2, k );
+    b3 = veorq_u8( b3, k );
+}
+
+/*
+ * AES-ECB block en(de)cryption
+ */
+POLARSSL_AESCE_TARGET
+int aesce_crypt_ecb( aes_context *ctx,
+                     int mode,
+                     const unsigned char input[16],
+                     unsigned char output[16] )
+{
+    const unsigned char *rk = reinterpret_cast<const unsigned char*>( ctx->rk );
+    const uint8x16_t b = vld1q_u8( input );
+
+    if( mode == AES_ENCRYPT )
+        vst1q_u8( output, aesce_encrypt_block( b, rk, ctx->nr ) );
+    else
+        vst1q_u8( output, aesce_decrypt_block( b, rk, ctx->nr ) );
+
+    return( 0 );
+}
+
+/*
+ * AES-CBC decryption (encryption is serial by definition and goes through ECB)
+ */
+POLARSSL_AESCE_TARGET
+int aesce_crypt_cbc_dec( aes_context *ctx,
+                         size_t length,
+                         unsigned char iv[16],
+                         const unsigned char *input,
+                         unsigned char *output )
+{
+    const unsigned char *rk = reinterpret_cast<const unsigned char*>( ctx->rk );
+    uint8x16_t prev = vld1q_u8( iv );
+
+    // Ciphertext is read before the plaintext is stored, input may equal output
+    while( length >= 64 )
+    {
+        const uint8x16_t c0 = vld1q_u8( input );
+        const uint8x16_t c1 = vld1q_u8( input + 16 );
+        const uint8x16_t c2 = vld1q_u8( input + 32 );
+        const uint8x16_t c3 = vld1q_u8( input + 48 );
+        uint8x16_t b0 = c0, b1 = c1, b2 = c2, b3 = c3;
+
+        aesce_decrypt_4( b0, b1, b2, b3, rk, ctx->nr );
+
+        vst1q_u8( output,      veorq_u8( b0, prev ) );
+        vst1q_u8( output + 16, veorq_u8( b1, c0 ) );
+        vst1q_u8( output + 32, veorq_u8( b2, c1 ) );
+        vst1q_u8( output + 48, veorq_u8( b3, c2 ) );
+        prev = c3;
+
+        input  += 64;
+        output += 64;
+        length -= 64;
+    }
+
+    while( length >= 16 )
+    {
+        const uint8x16_t c = vld1q_u8( input );
+
+        vst1q_u8( output, veorq_u8( aesce_decrypt_block( c, rk, ctx->nr ), prev ) );
+        prev = c;
+
+        input  += 16;
+        output += 16;
+        length -= 16;
+    }
+
+    vst1q_u8( iv, prev );
+
+    return( 0 );
+}
+
+/*
+ * AES-CTR over whole blocks
+ */
+POLARSSL_AESCE_TARGET
+void aesce_crypt_ctr( aes_context *ctx,
+                      size_t blocks,
+                      unsigned char nonce_counter[16],
+                      unsigned char stream_block[16],
+                      const unsigned char *input,
+                      unsigned char *output )
+{
+    const unsigned char *rk = reinterpret_cast<const unsigned char*>( ctx->rk );
+
+    // 128-bit big endian counter kept as two native halves
+    const uint64x2_t counter = vreinterpretq_u64_u8( vrev64q_u8( vld1q_u8( nonce_counter ) ) );
+    uint64_t hi = vgetq_lane_u64( counter, 0 );
+    uint64_t lo = vgetq_lane_u64( counter, 1 );
+
+    const auto next = [&]()
+    {
+        const uint8x16_t b = vrev64q_u8( vreinterpretq_u8_u64( vcombine_u64( vcreate_u64( hi ), vcreate_u64( lo ) ) ) );
+
+        if( ++lo == 0 )
+            ++hi;
+
+        return b;
+    };
+
+    uint8x16_t ks = vld1q_u8( stream_block );
+
+    while( blocks >= 4 )
+    {
+        uint8x16_t b0 = next(), b1 = next(), b2 = next(), b3 = next();
+
+        aesce_encrypt_4( b0, b1, b2, b3, rk, ctx->nr );
+
+        vst1q_u8( output,      veorq_u8( vld1q_u8( input ),      b0 ) );
+        vst1q_u8( output + 16, veorq_u8( vld1q_u8( input + 16 ), b1 ) );
+        vst1q_u8( output + 32, veorq_u8( vld1q_u8( input + 32 ), b2 ) );
+        vst1q_u8( output + 48, veorq_u8( vld1q_u8( input + 48 ), b3 ) );
+        ks = b3;
+
+        input  += 64;
+        output += 64;
+        blocks -= 4;
+    }
+
+    while( blocks-- )
+    {
+        ks = aesce_encrypt_block( next(), rk, ctx->nr );
+        vst1q_u8( output, veorq_u8( vld1q_u8( input ), ks ) );
+
+        input  += 16;
+        output += 16;
+    }
+
+    vst1q_u8( stream_block, ks );
+    vst1q_u8( nonce_counter, vrev64q_u8( vreinterpretq_u8_u64( vcombine_u64( vcreate_u64( hi ), vcreate_u64( lo ) ) ) ) );
+}
+
+/*
+ * SHA-1 compression
+ */
+POLARSSL_AESCE_TARGET
+void aesce_sha1_process( uint32_t state[5], const unsigned char *data, size_t blocks )
+{
+    const uint32x4_t k0 = vdupq_n_u32( 0x5A827999 );
+    const uint32x4_t k1 = vdupq_n_u32( 0x6ED9EBA1 );
+    const uint32x4_t k2 = vdupq_n_u32( 0x8F1BBCDC );
+    const uint32x4_t k3 = vdupq_n_u32( 0xCA62C1D6 );
+
+    uint32x4_t abcd = vld1q_u32( state );
+    uint32_t e0 = state[4];
+
+    for( ; blocks > 0; blocks--, data += 64 )
+    {
+        const uint32x4_t abcd_saved = abcd;
+        const uint32_t e0_saved = e0;
+        uint32_t e1;
+
+        uint32x4_t m0 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data ) ) );
+        uint32x4_t m1 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 16 ) ) );
+        uint32x4_t m2 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 32 ) ) );
+        uint32x4_t m3 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 48 ) ) );
+
+        uint32x4_t t0 = vaddq_u32( m0, k0 );
+        uint32x4_t t1 = vaddq_u32( m1, k0 );
+
+        // Rounds 0-3
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1cq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m2, k0 );
+        m0 = vsha1su0q_u32( m0, m1, m2 );
+
+        // Rounds 4-7
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1cq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m3, k0 );
+        m0 = vsha1su1q_u32( m0, m3 );
+        m1 = vsha1su0q_u32( m1, m2, m3 );
+
+        // Rounds 8-11
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1cq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m0, k0 );
+        m1 = vsha1su1q_u32( m1, m0 );
+        m2 = vsha1su0q_u32( m2, m3, m0 );
+
+        // Rounds 12-15
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1cq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m1, k1 );
+        m2 = vsha1su1q_u32( m2, m1 );
+        m3 = vsha1su0q_u32( m3, m0, m1 );
+
+        // Rounds 16-19
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1cq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m2, k1 );
+        m3 = vsha1su1q_u32( m3, m2 );
+        m0 = vsha1su0q_u32( m0, m1, m2 );
+
+        // Rounds 20-23
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m3, k1 );
+        m0 = vsha1su1q_u32( m0, m3 );
+        m1 = vsha1su0q_u32( m1, m2, m3 );
+
+        // Rounds 24-27
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m0, k1 );
+        m1 = vsha1su1q_u32( m1, m0 );
+        m2 = vsha1su0q_u32( m2, m3, m0 );
+
+        // Rounds 28-31
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m1, k1 );
+        m2 = vsha1su1q_u32( m2, m1 );
+        m3 = vsha1su0q_u32( m3, m0, m1 );
+
+        // Rounds 32-35
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m2, k2 );
+        m3 = vsha1su1q_u32( m3, m2 );
+        m0 = vsha1su0q_u32( m0, m1, m2 );
+
+        // Rounds 36-39
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m3, k2 );
+        m0 = vsha1su1q_u32( m0, m3 );
+        m1 = vsha1su0q_u32( m1, m2, m3 );
+
+        // Rounds 40-43
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1mq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m0, k2 );
+        m1 = vsha1su1q_u32( m1, m0 );
+        m2 = vsha1su0q_u32( m2, m3, m0 );
+
+        // Rounds 44-47
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1mq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m1, k2 );
+        m2 = vsha1su1q_u32( m2, m1 );
+        m3 = vsha1su0q_u32( m3, m0, m1 );
+
+        // Rounds 48-51
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1mq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m2, k2 );
+        m3 = vsha1su1q_u32( m3, m2 );
+        m0 = vsha1su0q_u32( m0, m1, m2 );
+
+        // Rounds 52-55
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1mq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m3, k3 );
+        m0 = vsha1su1q_u32( m0, m3 );
+        m1 = vsha1su0q_u32( m1, m2, m3 );
+
+        // Rounds 56-59
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1mq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m0, k3 );
+        m1 = vsha1su1q_u32( m1, m0 );
+        m2 = vsha1su0q_u32( m2, m3, m0 );
+
+        // Rounds 60-63
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m1, k3 );
+        m2 = vsha1su1q_u32( m2, m1 );
+        m3 = vsha1su0q_u32( m3, m0, m1 );
+
+        // Rounds 64-67
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e0, t0 );
+        t0 = vaddq_u32( m2, k3 );
+        m3 = vsha1su1q_u32( m3, m2 );
+
+        // Rounds 68-71
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e1, t1 );
+        t1 = vaddq_u32( m3, k3 );
+
+        // Rounds 72-75
+        e1 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e0, t0 );
+
+        // Rounds 76-79
+        e0 = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );
+        abcd = vsha1pq_u32( abcd, e1, t1 );
+
+        e0 += e0_saved;
+        abcd = vaddq_u32( abcd_saved, abcd );
+    }
+
+    vst1q_u32( state, abcd );
+    state[4] = e0;
+}
+
+static const uint32_t sha256_k[64] =
+{
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+    0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+    0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+    0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+    0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+    0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+    0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+    0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+    0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+/*
+ * SHA-256 compression
+ */
+POLARSSL_AESCE_TARGET
+void aesce_sha256_process( uint32_t state[8], const unsigned char *data, size_t blocks )
+{
+    uint32x4_t state0 = vld1q_u32( state );
+    uint32x4_t state1 = vld1q_u32( state + 4 );
+
+    for( ; blocks > 0; blocks--, data += 64 )
+    {
+        const uint32x4_t state0_saved = state0;
+        const uint32x4_t state1_saved = state1;
+        uint32x4_t t2;
+
+        uint32x4_t m0 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data ) ) );
+        uint32x4_t m1 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 16 ) ) );
+        uint32x4_t m2 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 32 ) ) );
+        uint32x4_t m3 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 48 ) ) );
+
+        uint32x4_t t0 = vaddq_u32( m0, vld1q_u32( &sha256_k[0] ) );
+        uint32x4_t t1;
+
+        // Rounds 0-3
+        m0 = vsha256su0q_u32( m0, m1 );
+        t2 = state0;
+        t1 = vaddq_u32( m1, vld1q_u32( &sha256_k[4] ) );
+        state0 = vsha256hq_u32( state0, state1, t0 );
+        state1 = vsha256h2q_u32( state1, t2, t0 );
+        m0 = vsha256su1q_u32( m0, m2, m3 );
+
+        // Rounds 4-7
+        m1 = vsha256su0q_u32( m1, m2 );
+        t2 = state0;
+        t0 = vaddq_u32( m2, vld1q_u32( &sha256_k[8] ) );
+        state0 = vsha256hq_u32( state0, state1, t1 );
+        state1 = vsha256h2q_u32( state1, t2, t1 );
+        m1 = vsha256su1q_u32( m1, m3, m0 );
+
+        // Rounds 8-11
+        m2 = vsha256su0q_u32( m2, m3 );
+        t2 = state0;
+        t1 = vaddq_u32( m3, vld1q_u32( &sha256_k[12] ) );
+        state0 = vsha256hq_u32( state0, state1, t0 );
+        state1 = vsha256h2q_u32( state1, t2, t0 );
+        m2 = vsha256su1q_u32( m2, m0, m1 );
+
+        // Rounds 12-15
+        m3 = vsha256su0q_u32( m3, m0 );
+        t2 = state0;
+        t0 = vaddq_u32( m0, vld1q_u32( &sha256_k[16] ) );
+        state0 = vsha256hq_u32( state0, state1, t1 );
+        state1 = vsha256h2q_u32( state1, t2, t1 );
+        m3 = vsha256su1q_u32( m3, m1, m2 );
+
+        // Rounds 16-19
+        m0 = vsha256su0q_u32( m0, m1 );
+        t2 = state0;
+        t1 = vaddq_u32( m1, vld1q_u32( &sha256_k[20] ) );
+        state0 = vsha256hq_u32( state0, state1, t0 );
+        state1 = vsha256h2q_u32( state1, t2, t0 );
+        m0 = vsha256su1q_u32( m0, m2, m3 );
+
+        // Rounds 20-23
+        m1 = vsha256su0q_u32( m1, m2 );
+        t2 = state0;
+        t0 = vaddq_u32( m2, vld1q_u32( &sha256_k[24] ) );
+        state0 = vsha256hq_u32( state0, state1, t1 );
+        state1 = vsha256h2q_u32( state1, t2, t1 );
+        m1 = vsha256su1q_u32( m1, m3, m0 );
+
+        // Rounds 24-27
+        m2 = vsha256su0q_u32( m2, m3 );
+        t2 = state0;
+        t1 = vaddq_u32( m3, vld1q_u32( &sha256_k[28] ) );
+        state0 = vsha256hq_u32( state0, state1, t0 );
+        state1 = vsha256h2q_u32( state1, t2, t0 );
+        m2 = vsha256su1q_u32( m2, m0, m1 );
+
+        // Rounds 28-31
+        m3 = vsha256su0q_u32( m3, m0 );
+        t2 = state0;
+        t0 = vaddq_u32( m0, vld1q_u32( &sha256_k[32] ) );
+        state0 = vsha256hq_u32( state0, state1, t1 );
+        state1 = vsha256h2q_u32( state1, t2, t1 );
+        m3 = vsha256su1q_u32( m3, m1, m2 );
+
+        // Rounds 32-35
+        m0 = vsha256su0q_u32( m0, m1 );
+        t2 = state0;
+        t1 = vaddq_u32( m1, vld1q_u32( &sha256_k[36] ) );
+        state0 = vsha256hq_u32( state0, state1, t0 );
+        state1 = vsha256h2q_u32( state1, t2, t0 );
+        m0 = vsha256su1q_u32( m0, m2, m3 );
+
+        // Rounds 36-39
+        m1 = vsha256su0q_u32( m1, m2 );
+        t2 = state0;
+        t0 = vaddq_u32( m2, vld1q_u32( &sha256_k[40] ) );
+        state0 = vsha256hq_u32( state0, state1, t1 );
+        state1 = vsha256h2q_u32( state1, t2, t1 );
+        m1 = vsha256su1q_u32( m1, m3, m0 );
+
+        // Rounds 40-43
+        m2 = vsha256su0q_u32( m2, m3 );
+        t2 = state0;
+        t1 = vaddq_u32( m3, vld1q_u32( &sha256_k[44] ) );
+        state0 = vsha256hq_u32( state0, state1, t0 );
+        state1 = vsha256h2q_u32( state1, t2, t0 );
+        m2 = vsha256su1q_u32( m2, m0, m1 );
+
+        // Rounds 44-47
+        m3 = vsha256su0q_u32( m3, m0 );
+        t2 = state0;
+        t0 = vaddq_u32( m0, vld1q_u32( &sha256_k[48] ) );
+        state0 = vsha256hq_u32( state0, state1, t1 );
+        state1 = vsha256h2q_u32( state1, t2, t1 );
+        m3 = vsha256su1q_u32( m3, m1, m2 );
+
+        // Rounds 48-51
+        t2 = state0;
+        t1 = vaddq_u32( m1, vld1q_u32( &sha256_k[52] ) );
+        state0 = vsha256hq_u32( state0, state1, t0 );
+        state1 = vsha256h2q_u32( state1, t2, t0 );
+
+        // Rounds 52-55
+        t2 = state0;
+        t0 = vaddq_u32( m2, vld1q_u32( &sha256_k[56] ) );
+        state0 = vsha256hq_u32( state0, state1, t1 );
+        state1 = vsha256h2q_u32( state1, t2, t1 );
+
+        // Rounds 56-59
+        t2 = state0;
+        t1 = vaddq_u32( m3, vld1q_u32( &sha256_k[60] ) );
+        state0 = vsha256hq_u32( state0, state1, t0 );
+        state1 = vsha256h2q_u32( state1, t2, t0 );
+
+        // Rounds 60-63
+        t2 = state0;
+        state0 = vsha256hq_u32( state0, state1, t1 );
+        state1 = vsha256h2q_u32( state1, t2, t1 );
+
+        state0 = vaddq_u32( state0, state0_saved );
+        state1 = vaddq_u32( state1, state1_saved );
+    }
+
+    vst1q_u32( state, state0 );
+    vst1q_u32( state + 4, state1 );
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+/**
+ * \file aesce.h
+ *
+ * \brief ARMv8 Cryptography Extensions for hardware AES, SHA-1 and SHA-256
+ *
+ *  The software key schedules of aes.cpp are used as is: encryption round
+ *  keys feed AESE/AESMC, the equivalent inverse cipher keys produced by
+ *  aes_setkey_dec feed AESD/AESIMC.
+ */
+
+#include "aes.h"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define POLARSSL_HAVE_AESCE
+
+#if defined(__clang__)
+#define POLARSSL_AESCE_TARGET __attribute__((target("aes,sha2")))
+#elif defined(__GNUC__)
+#define POLARSSL_AESCE_TARGET __attribute__((target("+crypto")))
+#else
+#define POLARSSL_AESCE_TARGET
+#endif
+#endif
+
+#define POLARSSL_AESCE_AES      0x00000001u
+#define POLARSSL_AESCE_SHA1     0x00000002u
+#define POLARSSL_AESCE_SHA256   0x00000004u
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief          Crypto Extensions features detection routine (cached)
+ *
+ * \param what     The features to detect (POLARSSL_AESCE_*)
+ *
+ * \return         1 if CPU supports all requested features, 0 otherwise
+ */
+int aesce_supports( unsigned int what );
+
+/**
+ * \brief          AES-ECB block en(de)cryption
+ *
+ * \return         0 on success (cannot fail)
+ */
+int aesce_crypt_ecb( aes_context *ctx,
+                     int mode,
+                     const unsigned char input[16],
+                     unsigned char output[16] );
+
+/**
+ * \brief          AES-CBC decryption, four blocks in flight
+ *
+ * \param length   Length of the input data, multiple of 16
+ * \param iv       Initialization vector (updated after use)
+ *
+ * \return         0 on success (cannot fail)
+ */
+int aesce_crypt_cbc_dec( aes_context *ctx,
+                         size_t length,
+                         unsigned char iv[16],
+                         const unsigned char *input,
+                         unsigned char *output );
+
+/**
+ * \brief          AES-CTR over whole blocks, four blocks in flight
+ *
+ * \param blocks        Number of 16-byte blocks
+ * \param nonce_counter 128-bit big endian counter (updated after use)
+ * \param stream_block  Receives the last keystream block
+ */
+void aesce_crypt_ctr( aes_context *ctx,
+                      size_t blocks,
+                      unsigned char nonce_counter[16],
+                      unsigned char stream_block[16],
+                      const unsigned char *input,
+                      unsigned char *output );
+
+/**
+ * \brief          SHA-1 compression of consecutive 64-byte blocks
+ */
+void aesce_sha1_process( uint32_t state[5], const unsigned char *data, size_t blocks );
+
+/**
+ * \brief          SHA-256 compression of consecutive 64-byte blocks
+ */
+void aesce_sha256_process( uint32_t state[8], const unsigned char *data, size_t blocks );
+
+#ifdef __cplusplus
+}
+#endif
@@ -29,6 +29,7 @@
  */
 
 #include "sha1.h"
+#include "aesce.h"
 #include "utils.h"
 
 /*
@@ -73,6 +74,14 @@ void sha1_process( sha1_context *ctx, const unsigned char data[64] )
 {
     uint32_t temp, W[16], A, B, C, D, E;
 
+#if defined(POLARSSL_HAVE_AESCE)
+    if( aesce_supports( POLARSSL_AESCE_SHA1 ) )
+    {
+        aesce_sha1_process( ctx->state, data, 1 );
+        return;
+    }
+#endif
+
     GET_UINT32_BE( W[ 0], data,  0 );
     GET_UINT32_BE( W[ 1], data,  4 );
     GET_UINT32_BE( W[ 2], data,  8 );
@@ -255,6 +264,15 @@ void sha1_update( sha1_context *ctx, const unsigned char *input, size_t ilen )
         left = 0;
     }
 
+#if defined(POLARSSL_HAVE_AESCE)
+    if( ilen >= 64 && aesce_supports( POLARSSL_AESCE_SHA1 ) )
+    {
+        aesce_sha1_process( ctx->state, input, ilen >> 6 );
+        input += ilen & ~static_cast<size_t>(63);
+        ilen  &= 63;
+    }
+#endif
+
     while( ilen >= 64 )
     {
         sha1_process( ctx, input );
@@ -27,6 +27,7 @@
  */
 
 #include "sha256.h"
+#include "aesce.h"
 #include "utils.h"
 
 #include <string.h>
@@ -201,6 +202,14 @@ int mbedtls_internal_sha256_process( mbedtls_sha256_context *ctx,
     SHA256_VALIDATE_RET( ctx != NULL );
     SHA256_VALIDATE_RET( (const unsigned char *)data != NULL );
 
+#if defined(POLARSSL_HAVE_AESCE)
+    if( aesce_supports( POLARSSL_AESCE_SHA256 ) )
+    {
+        aesce_sha256_process( ctx->state, data, 1 );
+        return( 0 );
+    }
+#endif
+
     for( i = 0; i < 8; i++ )
         A[i] = ctx->state[i];
 
@@ -299,6 +308,15 @@ int mbedtls_sha256_update_ret( mbedtls_sha256_context *ctx,
         left = 0;
     }
 
+#if defined(POLARSSL_HAVE_AESCE)
+    if( ilen >= 64 && aesce_supports( POLARSSL_AESCE_SHA256 ) )
+    {
+        aesce_sha256_process( ctx->state, input, ilen >> 6 );
+        input += ilen & ~static_cast<size_t>(63);
+        ilen  &= 63;
+    }
+#endif
+
     while( ilen >= 64 )
     {
         if( ( ret = mbedtls_internal_sha256_process( ctx, input ) ) != 0 )
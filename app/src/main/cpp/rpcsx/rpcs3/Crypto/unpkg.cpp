@@ -14,6 +14,10 @@
 
 #include <filesystem>
 
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
 LOG_CHANNEL(pkg_log, "PKG");
 
 package_reader::package_reader(const std::string& path, fs::file file)
@@ -834,6 +838,7 @@ bool package_reader::fill_data(std::map<std::string, install_entry*>& all_instal
 	m_bootable_file_path.clear();
 	m_entry_indexer = 0;
 	m_written_bytes = 0;
+	m_decrypted_bytes = 0;
 
 	usz num_failures = 0;
 
@@ -948,10 +953,148 @@ bool package_reader::fill_data(std::map<std::string, install_entry*>& all_instal
 
 fs::file DecryptEDAT(const fs::file& input, const std::string& input_file_name, int mode, u8 *custom_klic);
 
+void package_reader::prepare_split_entries()
+{
+	m_split_chunks.clear();
+	m_chunk_indexer = 0;
+
+	for (install_entry& entry : m_install_entries)
+	{
+		entry.is_split = false;
+
+		// SDAT goes through DecryptEDAT and must stay sequential
+		switch (entry.type & 0xff)
+		{
+		case PKG_FILE_ENTRY_NPDRM:
+		case PKG_FILE_ENTRY_NPDRMEDAT:
+		case PKG_FILE_ENTRY_REGULAR:
+		case PKG_FILE_ENTRY_UNK0:
+		case PKG_FILE_ENTRY_UNK1:
+			break;
+		default:
+			continue;
+		}
+
+		if (!entry.is_dominating() || entry.file_size < SPLIT_CHUNK_SIZE * 2)
+		{
+			continue;
+		}
+
+		const std::string& path = entry.weak_reference->first;
+		const bool did_overwrite = fs::is_file(path);
+
+		if (did_overwrite && !(entry.type & PKG_FILE_ENTRY_OVERWRITE))
+		{
+			// extract_worker reports it
+			continue;
+		}
+
+		fs::file out{path, did_overwrite ? fs::rewrite : fs::write_new};
+
+		if (!out)
+		{
+			continue;
+		}
+
+		// Reserve the blocks up front: chunks are written out of order
+#ifdef __linux__
+		if (::fallocate(out.get_handle(), 0, 0, entry.file_size) != 0)
+#endif
+		{
+			out.trunc(entry.file_size);
+		}
+
+		out.close();
+
+		for (u64 offset = 0; offset < entry.file_size; offset += SPLIT_CHUNK_SIZE)
+		{
+			m_split_chunks.push_back({&entry, offset, std::min<u64>(SPLIT_CHUNK_SIZE, entry.file_size - offset)});
+		}
+
+		entry.is_split = true;
+
+		if (did_overwrite)
+		{
+			pkg_log.warning("Overwriting file %s (%u chunks)", path, (entry.file_size + SPLIT_CHUNK_SIZE - 1) / SPLIT_CHUNK_SIZE);
+		}
+		else
+		{
+			pkg_log.notice("Creating file %s (%u chunks)", path, (entry.file_size + SPLIT_CHUNK_SIZE - 1) / SPLIT_CHUNK_SIZE);
+
+			if (entry.name == "USRDIR/EBOOT.BIN")
+			{
+				m_bootable_file_path = path;
+			}
+		}
+	}
+}
+
+bool package_reader::extract_chunk(const split_chunk& chunk, std::vector<u8>& buffer)
+{
+	const install_entry& entry = *chunk.entry;
+	const std::string& path = entry.weak_reference->first;
+	const bool is_psp = (entry.type & PKG_FILE_ENTRY_PSP) != 0u;
+
+	fs::file out{path, fs::write};
+
+	if (!out)
+	{
+		pkg_log.error("Failed to open %s (error=%s)", path, fs::g_tls_error);
+		return false;
+	}
+
+	buffer.resize(BUF_SIZE + BUF_PADDING);
+
+	for (u64 pos = 0; pos < chunk.size && !m_aborted;)
+	{
+		const u64 block_size = std::min<u64>(BUF_SIZE, chunk.size - pos);
+
+		if (decrypt(entry.file_offset + chunk.offset + pos, block_size, is_psp ? PKG_AES_KEY2 : m_dec_key.data(), buffer.data()) != block_size)
+		{
+			pkg_log.error("Failed to read %s at 0x%x", path, chunk.offset + pos);
+			return false;
+		}
+
+		m_decrypted_bytes += block_size;
+
+		if (out.write_at(chunk.offset + pos, buffer.data(), block_size) != block_size)
+		{
+			pkg_log.error("Failed to write %s at 0x%x (error=%s)", path, chunk.offset + pos, fs::g_tls_error);
+			return false;
+		}
+
+		m_written_bytes += block_size;
+		pos += block_size;
+	}
+
+	return true;
+}
+
 void package_reader::extract_worker()
 {
 	std::vector<u8> read_cache;
 
+	// Large files first: every worker takes chunks of them, so reads, decryption
+	// and writes of different chunks overlap instead of one thread doing
+	// all three in turn
+	while (m_num_failures == 0 && !m_aborted)
+	{
+		const usz index = m_chunk_indexer.fetch_add(1);
+
+		if (index >= m_split_chunks.size())
+		{
+			break;
+		}
+
+		if (!extract_chunk(::at32(m_split_chunks, index), read_cache))
+		{
+			m_num_failures++;
+			break;
+		}
+	}
+
+	read_cache = {};
+
 	while (m_num_failures == 0 && !m_aborted)
 	{
 		// Make sure m_entry_indexer does not exceed m_install_entries
@@ -980,6 +1123,11 @@ void package_reader::extract_worker()
 			continue;
 		}
 
+		if (entry.is_split)
+		{
+			continue;
+		}
+
 		const bool is_psp = (entry.type & PKG_FILE_ENTRY_PSP) != 0u;
 
 		const std::string& path = entry.weak_reference->first;
@@ -1155,6 +1303,8 @@ void package_reader::extract_worker()
 							return 0;
 						}
 
+						m_decrypted_bytes += advance_size;
+
 						read_cache.resize(advance_size);
 
 						size = std::min<usz>(advance_size, size);
@@ -1173,6 +1323,7 @@ void package_reader::extract_worker()
 							break;
 						}
 
+						m_decrypted_bytes += advance_size;
 						read_size += advance_size;
 						pos += advance_size;
 					}
@@ -1305,7 +1456,9 @@ package_install_result package_reader::extract_data(std::deque<package_reader>&
 
 		if (reader.m_num_failures == 0)
 		{
-			const usz thread_count = std::min<usz>(utils::get_thread_count(), reader.m_install_entries.size());
+			reader.prepare_split_entries();
+
+			const usz thread_count = std::min<usz>(utils::get_thread_count(), reader.m_install_entries.size() + reader.m_split_chunks.size());
 
 			named_thread_group workers("PKG Installer "sv, std::max<u32>(::narrow<u32>(thread_count), 1) - 1, [&]()
 			{
@@ -1442,19 +1595,13 @@ usz package_reader::decrypt(u64 offset, u64 size, const uchar* key, void* local_
 		// Set encryption key for stream cipher
 		aes_setkey_enc(&ctx, key, 128);
 
-		// Initialize stream cipher for start position
+		// Initialize stream cipher for start position, the big endian counter is
+		// incremented for every block by aes_crypt_ctr
 		be_t<u128> input = m_header.klicensee.value() + offset / 16;
+		u8 stream_block[16]{};
+		usz nc_off = 0;
 
-		// Increment stream position for every block
-		for (u64 i = 0; i < blocks; i++, input++)
-		{
-			u128 key;
-
-			aes_crypt_ecb(&ctx, AES_ENCRYPT, reinterpret_cast<const u8*>(&input), reinterpret_cast<u8*>(&key));
-
-			const u128 v = read_from_ptr<u128>(out_data, i * 16);
-			write_to_ptr<u128>(out_data, i * 16, v ^ key);
-		}
+		aes_crypt_ctr(&ctx, blocks * 16, &nc_off, reinterpret_cast<u8*>(&input), stream_block, out_data, out_data);
 	}
 	else
 	{
@@ -1478,6 +1625,14 @@ int package_reader::get_progress(int maximum) const
 	return wr >= m_header.data_size ? maximum : ::narrow<int>(wr * maximum / m_header.data_size);
 }
 
+int package_reader::get_decrypt_progress(int maximum) const
+{
+	// Skipped entries only ever advance the write counter
+	const usz rd = std::max<usz>(m_decrypted_bytes, m_written_bytes);
+
+	return rd >= m_header.data_size ? maximum : ::narrow<int>(rd * maximum / m_header.data_size);
+}
+
 void package_reader::abort_extract()
 {
 	m_aborted = true;
@@ -324,6 +324,9 @@ class package_reader
 		u32 type{};
 		u32 pad{};
 
+		// Extracted in chunks by all workers (see prepare_split_entries)
+		bool is_split = false;
+
 		// Check if the entry is the same one registered in entries to install
 		bool is_dominating() const
 		{
@@ -354,6 +357,7 @@ public:
 	result get_result() const { return m_result; };
 
 	int get_progress(int maximum = 100) const;
+	int get_decrypt_progress(int maximum = 100) const;
 
 	void abort_extract();
 
@@ -376,16 +380,31 @@ private:
 	usz decrypt(u64 offset, u64 size, const uchar* key, void* local_buf);
 	void extract_worker();
 
+	struct split_chunk
+	{
+		const install_entry* entry;
+		u64 offset;
+		u64 size;
+	};
+
+	void prepare_split_entries();
+	bool extract_chunk(const split_chunk& chunk, std::vector<u8>& buffer);
+
+	std::vector<split_chunk> m_split_chunks;
+
 	std::deque<install_entry> m_install_entries;
 	std::string m_install_path;
 	atomic_t<bool> m_aborted = false;
 	atomic_t<usz> m_num_failures = 0;
 	atomic_t<usz> m_entry_indexer = 0;
 	atomic_t<usz> m_written_bytes = 0;
+	atomic_t<usz> m_decrypted_bytes = 0;
+	atomic_t<usz> m_chunk_indexer = 0;
 	bool m_was_null = false;
 
 	static constexpr usz BUF_SIZE = 8192 * 1024; // 8 MB
 	static constexpr usz BUF_PADDING = 32;
+	static constexpr u64 SPLIT_CHUNK_SIZE = 32 * 1024 * 1024; // Files of at least two chunks are split
 
 	bool m_is_valid = false;
 	result m_result = result::not_started;
@@ -5,6 +5,8 @@
 #include "Emu/System.h"
 #include "Emu/system_utils.hpp"
 #include "Crypto/unzip.h"
+#include "Crypto/sha1.h"
+#include "util/vm.hpp"
 
 inline u8 Read8(const fs::file& f)
 {
@@ -1358,6 +1360,134 @@ static fs::file CheckDebugSelf(const fs::file& s)
 	return {};
 }
 
+// Decrypted ELF images, content addressed by the SELF file and the klic (the key
+// revision used for the metadata is part of the hashed SCE header)
+struct self_cache_header
+{
+	le_t<u32> magic;
+	le_t<u32> version;
+	le_t<u64> elf_size;
+};
+
+static constexpr u32 c_self_cache_magic = "RELF"_u32;
+static constexpr u32 c_self_cache_version = 1;
+
+static std::string get_self_cache_path(const fs::file& self, const u8* klic_key)
+{
+	sha1_context ctx;
+	sha1_starts(&ctx);
+
+	std::vector<u8> buf(0x10000);
+
+	for (u64 pos = 0; const u64 size = self.read_at(pos, buf.data(), buf.size()); pos += size)
+	{
+		sha1_update(&ctx, buf.data(), size);
+	}
+
+	u8 klic[16]{};
+
+	if (klic_key)
+	{
+		std::memcpy(klic, klic_key, sizeof(klic));
+	}
+
+	sha1_update(&ctx, klic, sizeof(klic));
+
+	u8 hash[20];
+	sha1_finish(&ctx, hash);
+
+	std::string name;
+
+	for (const u8 byte : hash)
+	{
+		fmt::append(name, "%02x", byte);
+	}
+
+	return fs::get_cache_dir() + "self/" + name + ".elf.z";
+}
+
+static fs::file load_cached_self(const std::string& path)
+{
+	const fs::file cached(path);
+
+	if (!cached || cached.size() <= sizeof(self_cache_header))
+	{
+		return {};
+	}
+
+	const usz size = cached.size();
+	std::vector<u8> data;
+	const u8* view = static_cast<const u8*>(utils::memory_map_fd(cached.get_handle(), size, utils::protection::ro));
+
+	if (!view)
+	{
+		data = cached.to_vector<u8>();
+		view = data.data();
+	}
+
+	self_cache_header header;
+	std::memcpy(&header, view, sizeof(header));
+
+	std::vector<u8> elf;
+
+	if (header.magic == c_self_cache_magic && header.version == c_self_cache_version)
+	{
+		elf.resize(header.elf_size);
+
+		uLongf elf_size = static_cast<uLongf>(elf.size());
+
+		if (uncompress(elf.data(), &elf_size, view + sizeof(header), static_cast<uLong>(size - sizeof(header))) != Z_OK || elf_size != elf.size())
+		{
+			elf.clear();
+		}
+	}
+
+	if (data.empty())
+	{
+		utils::memory_release(const_cast<u8*>(view), size);
+	}
+
+	if (elf.size() < 4 || std::memcmp(elf.data(), "\x7F" "ELF", 4) != 0)
+	{
+		self_log.warning("Dropping invalid decrypted SELF cache entry '%s'", path);
+		fs::remove_file(path);
+		return {};
+	}
+
+	return fs::make_stream(std::move(elf));
+}
+
+static void store_cached_self(const std::string& path, const fs::file& elf)
+{
+	const std::vector<u8> data = elf.to_vector<u8>();
+	elf.seek(0);
+
+	std::vector<u8> out(sizeof(self_cache_header) + compressBound(static_cast<uLong>(data.size())));
+	uLongf out_size = static_cast<uLongf>(out.size() - sizeof(self_cache_header));
+
+	// Decompression speed barely depends on the level, only the first boot pays for it
+	if (compress2(out.data() + sizeof(self_cache_header), &out_size, data.data(), static_cast<uLong>(data.size()), Z_DEFAULT_COMPRESSION) != Z_OK)
+	{
+		return;
+	}
+
+	const self_cache_header header{c_self_cache_magic, c_self_cache_version, data.size()};
+	std::memcpy(out.data(), &header, sizeof(header));
+	out.resize(sizeof(header) + out_size);
+
+	if (!fs::create_path(fs::get_parent_dir(path)))
+	{
+		return;
+	}
+
+	fs::pending_file file(path);
+
+	if (!file.file || file.file.write(out.data(), out.size()) != out.size() || !file.commit())
+	{
+		self_log.warning("Failed to store decrypted SELF cache entry '%s' (error=%s)", path, fs::g_tls_error);
+	}
+}
+
 fs::file decrypt_self(const fs::file& elf_or_self, const u8* klic_key, SelfAdditionalInfo* out_info)
 {
 	if (out_info)
@@ -1404,6 +1534,15 @@ fs::file decrypt_self(const fs::file& elf_or_self, const u8* klic_key, SelfAddit
 			return fs::file{};
 		}
 
+		// The metadata check rejects wrong klics cheaply, only then hash the whole file.
+		// Boot and PPU precompilation both go through here and share the entries.
+		const std::string cache_path = get_self_cache_path(elf_or_self, klic_key);
+
+		if (fs::file cached = load_cached_self(cache_path))
+		{
+			return cached;
+		}
+
 		// Decrypt the SELF file data.
 		if (!self_dec.DecryptData())
 		{
@@ -1412,7 +1551,14 @@ fs::file decrypt_self(const fs::file& elf_or_self, const u8* klic_key, SelfAddit
 		}
 
 		// Make a new ELF file from this SELF.
-		return self_dec.MakeElf(isElf32);
+		fs::file elf = self_dec.MakeElf(isElf32);
+
+		if (elf)
+		{
+			store_cached_self(cache_path, elf);
+		}
+
+		return elf;
 	}
 	else if (Emu.GetBoot().ends_with(".elf") || Emu.GetBoot().ends_with(".ELF"))
 	{
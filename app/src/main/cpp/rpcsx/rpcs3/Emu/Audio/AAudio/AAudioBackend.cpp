@@ -0,0 +1,252 @@
+#include "Emu/Audio/AAudio/AAudioBackend.h"
+
+#include <algorithm>
+#include "util/logs.hpp"
+#include "Emu/perf_trace.hpp"
+
+LOG_CHANNEL(AAudio);
+
+AAudioBackend::~AAudioBackend()
+{
+	Close();
+}
+
+bool AAudioBackend::Operational()
+{
+	return m_stream != nullptr && !m_reset_req.observe();
+}
+
+bool AAudioBackend::Open(std::string_view dev_id, AudioFreq freq, AudioSampleSize sample_size, AudioChannelCnt ch_cnt, audio_channel_layout layout)
+{
+	Close();
+	std::lock_guard lock{m_cb_mutex};
+
+	if (!dev_id.empty())
+	{
+		AAudio.notice("Device selection is not supported, using the default route (dev_id='%s')", dev_id);
+	}
+
+	m_sampling_rate = freq;
+	m_sample_size = sample_size;
+
+	// Android output routes are stereo, AAudio downmixes anything else itself
+	setup_channel_layout(static_cast<u32>(ch_cnt), 2, layout, AAudio);
+
+	full_sample_size = get_channels() * get_sample_size();
+
+	AAudioStreamBuilder* builder{};
+	if (aaudio_result_t err = AAudio_createStreamBuilder(&builder); err != AAUDIO_OK)
+	{
+		AAudio.error("AAudio_createStreamBuilder() failed: %s", AAudio_convertResultToText(err));
+		return false;
+	}
+
+	AAudioStreamBuilder_setDirection(builder, AAUDIO_DIRECTION_OUTPUT);
+	AAudioStreamBuilder_setPerformanceMode(builder, AAUDIO_PERFORMANCE_MODE_LOW_LATENCY);
+	AAudioStreamBuilder_setSharingMode(builder, AAUDIO_SHARING_MODE_EXCLUSIVE);
+	AAudioStreamBuilder_setSampleRate(builder, get_sampling_rate());
+	AAudioStreamBuilder_setChannelCount(builder, get_channels());
+	AAudioStreamBuilder_setFormat(builder, get_convert_to_s16() ? AAUDIO_FORMAT_PCM_I16 : AAUDIO_FORMAT_PCM_FLOAT);
+	AAudioStreamBuilder_setDataCallback(builder, data_cb, this);
+	AAudioStreamBuilder_setErrorCallback(builder, error_cb, this);
+
+	AAudioStream* stream{};
+	aaudio_result_t err = AAudioStreamBuilder_openStream(builder, &stream);
+
+	if (err != AAUDIO_OK)
+	{
+		// Exclusive mode is not granted silently on some devices, but refused on others
+		AAudio.warning("Exclusive stream could not be opened (%s), trying shared mode", AAudio_convertResultToText(err));
+		AAudioStreamBuilder_setSharingMode(builder, AAUDIO_SHARING_MODE_SHARED);
+		err = AAudioStreamBuilder_openStream(builder, &stream);
+	}
+
+	AAudioStreamBuilder_delete(builder);
+
+	if (err != AAUDIO_OK)
+	{
+		AAudio.error("AAudioStreamBuilder_openStream() failed: %s", AAudio_convertResultToText(err));
+		return false;
+	}
+
+	if (AAudioStream_getSampleRate(stream) != static_cast<s32>(get_sampling_rate()))
+	{
+		// Resampled by the framework, outside of the MMAP path
+		AAudio.warning("Stream sample rate is %d instead of %d", AAudioStream_getSampleRate(stream), get_sampling_rate());
+	}
+
+	m_burst_frames = std::max(AAudioStream_getFramesPerBurst(stream), 1);
+	m_max_buffer_frames = std::min(AAudioStream_getBufferCapacityInFrames(stream), m_burst_frames * static_cast<s32>(AUDIO_MAX_BUFFER_BURSTS));
+	m_xrun_count = AAudioStream_getXRunCount(stream);
+
+	// Start with double buffering, underruns add one burst at a time
+	AAudioStream_setBufferSizeInFrames(stream, m_burst_frames * 2);
+
+	AAudio.notice("Opened stream: sharing=%s, performance=%d, burst=%d frames, buffer=%d frames, capacity=%d frames",
+		AAudioStream_getSharingMode(stream) == AAUDIO_SHARING_MODE_EXCLUSIVE ? "exclusive" : "shared",
+		AAudioStream_getPerformanceMode(stream), m_burst_frames, AAudioStream_getBufferSizeInFrames(stream),
+		AAudioStream_getBufferCapacityInFrames(stream));
+
+	m_stream = stream;
+
+	if (err = AAudioStream_requestStart(m_stream); err != AAUDIO_OK)
+	{
+		AAudio.error("AAudioStream_requestStart() failed: %s", AAudio_convertResultToText(err));
+		AAudioStream_close(m_stream);
+		m_stream = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void AAudioBackend::Close()
+{
+	if (m_stream != nullptr)
+	{
+		// Returns after the data callback is done
+		if (aaudio_result_t err = AAudioStream_requestStop(m_stream); err != AAUDIO_OK)
+		{
+			AAudio.error("AAudioStream_requestStop() failed: %s", AAudio_convertResultToText(err));
+		}
+
+		AAudioStream_close(m_stream);
+	}
+
+	std::lock_guard lock{m_cb_mutex};
+	m_stream = nullptr;
+	m_playing = false;
+	m_reset_req = false;
+	m_last_sample.fill(0);
+}
+
+void AAudioBackend::Play()
+{
+	if (m_stream == nullptr)
+	{
+		AAudio.error("Play() called uninitialized");
+		return;
+	}
+
+	if (m_playing)
+		return;
+
+	std::lock_guard lock(m_cb_mutex);
+	m_playing = true;
+}
+
+void AAudioBackend::Pause()
+{
+	if (m_stream == nullptr)
+	{
+		AAudio.error("Pause() called uninitialized");
+		return;
+	}
+
+	if (!m_playing)
+		return;
+
+	std::lock_guard lock(m_cb_mutex);
+	m_playing = false;
+	m_last_sample.fill(0);
+}
+
+f64 AAudioBackend::GetCallbackFrameLen()
+{
+	if (m_stream == nullptr)
+	{
+		AAudio.error("GetCallbackFrameLen() called uninitialized");
+		return AUDIO_MIN_LATENCY;
+	}
+
+	return std::max<f64>(AUDIO_MIN_LATENCY, static_cast<f64>(m_burst_frames) / get_sampling_rate());
+}
+
+void AAudioBackend::tune_buffer_size(AAudioStream* stream)
+{
+	const s32 xrun_count = AAudioStream_getXRunCount(stream);
+
+	if (xrun_count <= m_xrun_count)
+	{
+		return;
+	}
+
+	m_xrun_count = xrun_count;
+
+	const s32 buffer_size = AAudioStream_getBufferSizeInFrames(stream);
+
+	if (buffer_size + m_burst_frames <= m_max_buffer_frames)
+	{
+		const s32 new_size = AAudioStream_setBufferSizeInFrames(stream, buffer_size + m_burst_frames);
+		AAudio.notice("Underrun detected (count=%d), buffer size is now %d frames", xrun_count, new_size);
+	}
+}
+
+aaudio_data_callback_result_t AAudioBackend::data_cb(AAudioStream* stream, void* user_data, void* audio_data, s32 num_frames)
+{
+	AAudioBackend* const aaudio = static_cast<AAudioBackend*>(user_data);
+	ensure(aaudio);
+
+	perf_trace::scope trace(perf_trace::category::audio, "AAudio callback");
+
+	if (num_frames <= 0)
+	{
+		return AAUDIO_CALLBACK_RESULT_CONTINUE;
+	}
+
+	std::unique_lock lock(aaudio->m_cb_mutex, std::defer_lock);
+
+	if (!aaudio->m_reset_req.observe() && lock.try_lock_for(std::chrono::microseconds{50}) && aaudio->m_write_callback && aaudio->m_playing)
+	{
+		if (stream != aaudio->m_stream)
+		{
+			return AAUDIO_CALLBACK_RESULT_STOP;
+		}
+
+		aaudio->tune_buffer_size(stream);
+
+		const u32 sample_size = aaudio->full_sample_size.observe();
+		const u32 bytes_req = num_frames * sample_size;
+		u32 written = std::min(aaudio->m_write_callback(bytes_req, audio_data), bytes_req);
+		written -= written % sample_size;
+
+		if (written >= sample_size)
+		{
+			memcpy(aaudio->m_last_sample.data(), static_cast<u8*>(audio_data) + written - sample_size, sample_size);
+		}
+
+		for (u32 i = written; i < bytes_req; i += sample_size)
+		{
+			memcpy(static_cast<u8*>(audio_data) + i, aaudio->m_last_sample.data(), sample_size);
+		}
+	}
+	else
+	{
+		// Stream parameters are modified only after the stream is stopped, which waits for this callback
+		memset(audio_data, 0, num_frames * aaudio->full_sample_size);
+	}
+
+	return AAUDIO_CALLBACK_RESULT_CONTINUE;
+}
+
+void AAudioBackend::error_cb(AAudioStream* stream, void* user_data, aaudio_result_t error)
+{
+	AAudioBackend* const aaudio = static_cast<AAudioBackend*>(user_data);
+	ensure(aaudio);
+
+	// The stream must not be closed from here (AAUDIO_ERROR_DISCONNECTED on a
+	// route change included), cellAudio reopens it once Operational() fails
+	AAudio.error("Stream error: %s", AAudio_convertResultToText(error));
+
+	std::lock_guard lock(aaudio->m_state_cb_mutex);
+
+	if (stream != aaudio->m_stream)
+	{
+		return;
+	}
+
+	if (!aaudio->m_reset_req.test_and_set() && aaudio->m_state_callback)
+	{
+		aaudio->m_state_callback(AudioStateEvent::UNSPECIFIED_ERROR);
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef __ANDROID__
+#error "AAudio backend is only available on Android"
+#endif
+
+#include "util/atomic.hpp"
+#include "Emu/Audio/AudioBackend.h"
+
+#include <aaudio/AAudio.h>
+
+// Direct AAudio output. Requests the exclusive MMAP path in low latency mode
+// and grows the device buffer by one burst on every underrun
+class AAudioBackend final : public AudioBackend
+{
+public:
+	AAudioBackend() = default;
+	~AAudioBackend() override;
+
+	AAudioBackend(const AAudioBackend&) = delete;
+	AAudioBackend& operator=(const AAudioBackend&) = delete;
+
+	std::string_view GetName() const override
+	{
+		return "AAudio"sv;
+	}
+
+	bool Operational() override;
+
+	bool Open(std::string_view dev_id, AudioFreq freq, AudioSampleSize sample_size, AudioChannelCnt ch_cnt, audio_channel_layout layout) override;
+	void Close() override;
+
+	f64 GetCallbackFrameLen() override;
+
+	void Play() override;
+	void Pause() override;
+
+private:
+	static constexpr f64 AUDIO_MIN_LATENCY = 256.0 / 48000; // One cellAudio block
+	static constexpr u32 AUDIO_MAX_BUFFER_BURSTS = 8;
+
+	AAudioStream* m_stream = nullptr;
+
+	std::array<u8, sizeof(float) * static_cast<u32>(AudioChannelCnt::SURROUND_7_1)> m_last_sample{};
+	atomic_t<u8> full_sample_size = 0;
+
+	atomic_t<bool> m_reset_req = false;
+
+	// Only accessed from the data callback after Open()
+	s32 m_burst_frames = 0;
+	s32 m_max_buffer_frames = 0;
+	s32 m_xrun_count = 0;
+
+	static aaudio_data_callback_result_t data_cb(AAudioStream* stream, void* user_data, void* audio_data, s32 num_frames);
+	static void error_cb(AAudioStream* stream, void* user_data, aaudio_result_t error);
+
+	void tune_buffer_size(AAudioStream* stream);
+};
@@ -421,6 +421,16 @@ namespace aarch64
 			!is_faux_function(instruction_info.callee_name)) // Ignore branch patch-points and imposter functions. Their behavior is unreliable.
 		{
 			// We're making a one-way call. This branch shouldn't even bother linking as it will never return here.
+			const auto ret = llvm::cast<llvm::ReturnInst>(&*where);
+			if ((!ret->getReturnValue() || ret->getReturnValue() == ci) && can_force_tail_call(ci, f))
+			{
+				// Nothing may follow a musttail call, LLVM then emits a plain "b" with no frame or link.
+				// LR is not needed on entry: every path back to the gateway reloads it from the hypervisor context.
+				ci->setTailCallKind(llvm::CallInst::TCK_MustTail);
+				return where;
+			}
+
+			// Signatures differ, the call may be lowered as "bl". Trap if it ever comes back.
 			ASMBlock c;
 			c.brk(0x99);
 			c.insert(irb, f.getContext());
@@ -441,6 +451,49 @@ namespace aarch64
 		return where;
 	}
 
+	bool GHC_frame_preservation_pass::can_force_tail_call(const llvm::CallInst* ci, const llvm::Function& f)
+	{
+		if (!m_config.optimize)
+		{
+			return false;
+		}
+
+		// musttail requires identical prototypes and calling conventions...
+		if (ci->getFunctionType() != f.getFunctionType() || ci->getCallingConv() != f.getCallingConv())
+		{
+			return false;
+		}
+
+		// ... and no ABI-impacting parameter attributes on either side
+		static constexpr llvm::Attribute::AttrKind abi_attrs[] =
+			{
+				llvm::Attribute::ByVal,
+				llvm::Attribute::ByRef,
+				llvm::Attribute::StructRet,
+				llvm::Attribute::InReg,
+				llvm::Attribute::InAlloca,
+				llvm::Attribute::Preallocated,
+				llvm::Attribute::ZExt,
+				llvm::Attribute::SExt,
+				llvm::Attribute::SwiftSelf,
+				llvm::Attribute::SwiftError,
+				llvm::Attribute::SwiftAsync,
+			};
+
+		for (unsigned i = 0; i < f.arg_size(); i++)
+		{
+			for (const auto kind : abi_attrs)
+			{
+				if (ci->paramHasAttr(i, kind) || f.getAttributes().hasParamAttr(i, kind))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
 	bool GHC_frame_preservation_pass::is_ret_instruction(const llvm::Instruction* i)
 	{
 		if (llvm::isa<llvm::ReturnInst>(i))
@@ -65,6 +65,8 @@ namespace aarch64
 
 		bool is_inlined_call(const llvm::CallInst* ci);
 
+		bool can_force_tail_call(const llvm::CallInst* ci, const llvm::Function& f);
+
 		bool is_faux_function(const std::string& function_name);
 
 		gpr get_base_register_for_call(const std::string& callee_name, gpr default_reg = gpr::x19);
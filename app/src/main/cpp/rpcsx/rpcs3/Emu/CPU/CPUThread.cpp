@@ -10,12 +10,15 @@
 #include "Emu/IdManager.h"
 #include "Emu/GDB.h"
 #include "cellos/sys_spu.h"
+#include "cellos/sys_prx.h"
+#include "cellos/sys_overlay.h"
 #include "Emu/Cell/PPUThread.h"
 #include "Emu/Cell/SPUThread.h"
 #include "Emu/RSX/RSXThread.h"
 #include "Emu/perf_meter.hpp"
 
 #include "rx/asm.hpp"
+#include "util/date_time.h"
 #include <thread>
 #include <unordered_map>
 #include <map>
@@ -37,6 +40,14 @@ static thread_local u32 s_tls_thread_slot = -1;
 // Suspend counter stamp
 static thread_local u64 s_tls_sctr = -1;
 
+// Paused threads spin this many busy_wait(300) rounds while the workload is being executed, then
+// sleep: with more CPU threads than cores, spinners can take the core of the thread owning suspend_all
+static constexpr u64 s_suspend_spin_rounds = 64;
+
+// Owner spins this many pause() rounds waiting for threads to reach check_state, then yields
+// (the thread it waits for may be preempted on the same core)
+static constexpr u64 s_suspend_ack_spin_rounds = 256;
+
 extern thread_local void (*g_tls_log_control)(const char* fmt, u64 progress);
 extern thread_local std::string (*g_tls_log_prefix)();
 
@@ -166,11 +177,88 @@ struct cpu_prof
 	// PPU/SPU id enqueued for registration
 	lf_queue<u32> registered;
 
+	// Function ranges of loaded PPU modules, used to attribute sampled PPU addresses
+	struct ppu_symbol_map
+	{
+		struct func_range
+		{
+			u32 addr;
+			u32 size;
+			u32 module;
+		};
+
+		std::vector<std::string> modules;
+		std::vector<func_range> funcs;
+
+		void collect()
+		{
+			auto add_module = [this](const ppu_module<lv2_obj>& _module)
+			{
+				const auto _funcs = _module.get_funcs();
+
+				if (_funcs.empty())
+				{
+					return;
+				}
+
+				const u32 index = ::size32(modules);
+				modules.emplace_back(_module.name.empty() ? _module.path : _module.name);
+
+				for (const ppu_function& func : _funcs)
+				{
+					if (func.size)
+					{
+						funcs.push_back({func.addr, func.size, index});
+					}
+				}
+			};
+
+			if (auto _main = g_fxo->try_get<main_ppu_module<lv2_obj>>())
+			{
+				add_module(*_main);
+			}
+
+			idm::select<lv2_obj, lv2_prx>([&](u32, lv2_prx& _module)
+				{
+					add_module(_module);
+				});
+
+			idm::select<lv2_obj, lv2_overlay>([&](u32, lv2_overlay& _module)
+				{
+					add_module(_module);
+				});
+
+			std::sort(funcs.begin(), funcs.end(), [](const func_range& a, const func_range& b)
+				{
+					return a.addr < b.addr;
+				});
+		}
+
+		const func_range* find(u32 addr) const
+		{
+			auto it = std::upper_bound(funcs.begin(), funcs.end(), addr, [](u32 addr, const func_range& func)
+				{
+					return addr < func.addr;
+				});
+
+			if (it == funcs.begin())
+			{
+				return nullptr;
+			}
+
+			--it;
+			return addr - it->addr < it->size ? &*it : nullptr;
+		}
+	};
+
 	struct sample_info
 	{
-		// Block occurences: name -> sample_count
+		// Block occurences: name -> sample_count (PPU: guest address -> sample_count)
 		std::unordered_map<u64, u64, value_hash<u64>> freq;
 
+		// PPU samples taken inside HLE functions: function name -> sample_count
+		std::unordered_map<const char*, u64> hle_freq;
+
 		// Total number of samples
 		u64 samples = 0, idle = 0;
 
@@ -186,6 +274,7 @@ struct cpu_prof
 		void reset()
 		{
 			freq.clear();
+			hle_freq.clear();
 			samples = 0;
 			idle = 0;
 			new_samples = 0;
@@ -222,6 +311,73 @@ struct cpu_prof
 			return results;
 		}
 
+		static std::string format_ppu(const sample_info& info, const ppu_symbol_map* symbols, bool extended_print = false)
+		{
+			// Aggregate addresses by containing function: (module index + 1) << 32 | function address
+			std::unordered_map<u64, u64, value_hash<u64>> funcs;
+
+			for (auto& [cia, count] : info.freq)
+			{
+				const auto func = symbols ? symbols->find(static_cast<u32>(cia)) : nullptr;
+				funcs[func ? (u64{func->module + 1} << 32 | func->addr) : cia] += count;
+			}
+
+			std::multimap<u64, std::string, std::greater<u64>> chart;
+
+			for (auto& [key, count] : funcs)
+			{
+				if (key >> 32)
+				{
+					chart.emplace(count, fmt::format("%s:0x%08x", symbols->modules[(key >> 32) - 1], static_cast<u32>(key)));
+				}
+				else
+				{
+					// Outside of any known function (or symbols unavailable)
+					chart.emplace(count, fmt::format("0x%08x", key));
+				}
+			}
+
+			for (auto& [name, count] : info.hle_freq)
+			{
+				chart.emplace(count, fmt::format("HLE %s", name));
+			}
+
+			std::string results;
+			results.reserve(extended_print ? 10100 : 5100);
+
+			const f64 busy = 1. * (info.samples - info.idle) / info.samples;
+
+			for (auto& [count, name] : chart)
+			{
+				fmt::append(results, "\n\t[%s]: %.4f%% (%u)", name, count / busy / info.samples * 100., count);
+
+				if (results.size() >= (extended_print ? 10000 : 5000))
+				{
+					break;
+				}
+			}
+
+			return results;
+		}
+
+		std::string format_freq(const ppu_symbol_map* symbols, bool is_ppu, bool extended_print = false) const
+		{
+			if (is_ppu)
+			{
+				return format_ppu(*this, symbols, extended_print);
+			}
+
+			// Make reversed map: sample_count -> name
+			std::multimap<u64, u64, std::greater<u64>> chart;
+
+			for (auto& [name, count] : freq)
+			{
+				chart.emplace(count, name);
+			}
+
+			return format(chart, samples, idle, extended_print);
+		}
+
 		static f64 get_percent(u64 dividend, u64 divisor)
 		{
 			if (!dividend)
@@ -238,7 +394,7 @@ struct cpu_prof
 		}
 
 		// Print info
-		void print(const shared_ptr<cpu_thread>& ptr)
+		void print(const shared_ptr<cpu_thread>& ptr, const ppu_symbol_map* symbols = nullptr)
 		{
 			if (new_samples < min_print_samples || samples == idle)
 			{
@@ -250,74 +406,110 @@ struct cpu_prof
 				return;
 			}
 
-			// Make reversed map: sample_count -> name
-			std::multimap<u64, u64, std::greater<u64>> chart;
-
-			for (auto& [name, count] : freq)
-			{
-				chart.emplace(count, name);
-			}
-
 			// Print results
-			const std::string results = format(chart, samples, idle);
+			const std::string results = format_freq(symbols, ptr->get_class() == thread_class::ppu);
 			profiler.notice("Thread \"%s\" [0x%08x]: %u samples (%.4f%% idle), %u new, %u reservation (%.4f%%):\n%s", ptr->get_name(), ptr->id, samples, get_percent(idle, samples), new_samples, reservation_samples, get_percent(reservation_samples, samples - idle), results);
 
 			new_samples = 0;
 		}
 
-		static void print_all(std::unordered_map<shared_ptr<cpu_thread>, sample_info>& threads, sample_info& all_info)
+		static void print_total(std::string_view what, const sample_info& total, u64 new_samples, bool is_ppu, const ppu_symbol_map* symbols, std::string* report)
 		{
-			u64 new_samples = 0;
+			const u64 samples = total.samples;
+			const u64 idle = total.idle;
+			const u64 reservation = total.reservation_samples;
 
-			// Print all results and cleanup
-			for (auto& [ptr, info] : threads)
+			if (samples == idle)
 			{
-				new_samples += info.new_samples;
-				info.print(ptr);
+				return;
 			}
 
-			std::multimap<u64, u64, std::greater<u64>> chart;
+			const std::string summary = fmt::format("%s: %u samples (%.4f%% idle), %u new, %u reservation (%.4f%%)", what, samples, get_percent(idle, samples), new_samples, reservation, get_percent(reservation, samples - idle));
+			const bool enough = new_samples >= min_print_all_samples || thread_ctrl::state() == thread_state::aborting;
 
-			for (auto& [_, info] : threads)
+			if (!enough)
 			{
-				// This function collects thread information regardless of 'new_samples' member state
-				for (auto& [name, count] : info.freq)
+				profiler.notice("%s: Not enough new samples have been collected since the last print.", summary);
+
+				if (!report)
 				{
-					all_info.freq[name] += count;
+					return;
 				}
-
-				all_info.samples += info.samples;
-				all_info.idle += info.idle;
-				all_info.reservation_samples += info.reservation_samples;
 			}
 
-			const u64 samples = all_info.samples;
-			const u64 idle = all_info.idle;
-			const u64 reservation = all_info.reservation_samples;
-			const auto& freq = all_info.freq;
+			const std::string results = total.format_freq(symbols, is_ppu, true);
 
-			if (samples == idle)
+			if (enough)
 			{
-				return;
+				profiler.notice("%s:%s", summary, results);
 			}
 
-			if (new_samples < min_print_all_samples && thread_ctrl::state() != thread_state::aborting)
+			if (report)
 			{
-				profiler.notice("All Threads: %u samples (%.4f%% idle), %u new, %u reservation (%.4f%%): Not enough new samples have been collected since the last print.", samples, get_percent(idle, samples), new_samples, reservation, get_percent(reservation, samples - idle));
-				return;
+				fmt::append(*report, "%s:%s\n\n", summary, results);
 			}
+		}
 
-			for (auto& [name, count] : freq)
+		static void print_all(std::unordered_map<shared_ptr<cpu_thread>, sample_info>& threads, sample_info& all_info, sample_info& all_ppu_info, const ppu_symbol_map* symbols = nullptr, std::string* report = nullptr)
+		{
+			u64 new_samples = 0;
+			u64 new_ppu_samples = 0;
+
+			// Print all results and cleanup
+			for (auto& [ptr, info] : threads)
 			{
-				chart.emplace(count, name);
+				(ptr->get_class() == thread_class::ppu ? new_ppu_samples : new_samples) += info.new_samples;
+				info.print(ptr, symbols);
+			}
+
+			for (auto& [ptr, info] : threads)
+			{
+				// PPU addresses and SPU block hashes are not comparable, keep separate totals
+				sample_info& total = ptr->get_class() == thread_class::ppu ? all_ppu_info : all_info;
+
+				// This function collects thread information regardless of 'new_samples' member state
+				for (auto& [name, count] : info.freq)
+				{
+					total.freq[name] += count;
+				}
+
+				for (auto& [name, count] : info.hle_freq)
+				{
+					total.hle_freq[name] += count;
+				}
+
+				total.samples += info.samples;
+				total.idle += info.idle;
+				total.reservation_samples += info.reservation_samples;
 			}
 
-			const std::string results = format(chart, samples, idle, true);
-			profiler.notice("All Threads: %u samples (%.4f%% idle), %u new, %u reservation (%.4f%%):%s", samples, get_percent(idle, samples), new_samples, reservation, get_percent(reservation, samples - idle), results);
+			print_total("All Threads", all_info, new_samples, false, symbols, report);
+			print_total("All PPU Threads", all_ppu_info, new_ppu_samples, true, symbols, report);
 		}
 	};
 
+	// Write flushed results to a file in the log directory
+	static void save_report(const std::string& report)
+	{
+		if (report.empty())
+		{
+			return;
+		}
+
+		const std::string dir = fs::get_log_dir() + "profiler/";
+		const std::string path = dir + Emu.GetTitleID() + '_' + date_time::current_time_narrow() + ".txt";
+
+		if (!fs::create_path(dir) || !fs::write_file(path, fs::rewrite, report))
+		{
+			profiler.error("Failed to save profiling report to '%s' (%s)", path, fs::g_tls_error);
+			return;
+		}
+
+		profiler.success("Profiling report saved to '%s'", path);
+	}
+
 	sample_info all_threads_info{};
+	sample_info all_ppu_info{};
 
 	void operator()()
 	{
@@ -378,14 +570,30 @@ struct cpu_prof
 			{
 				if (auto state = +ptr->state; cpu_flag::exit - state)
 				{
-					// Get short function hash
-					const u64 name = atomic_storage<u64>::load(ptr->block_hash);
-
 					// Append occurrence
 					info.samples++;
 
 					if (cpu_flag::wait - state)
 					{
+						if (auto ppu = ptr->try_get<ppu_thread>())
+						{
+							// Exact with the interpreter, the last updated call site with LLVM
+							if (const auto func = atomic_storage<const char*>::load(ppu->current_function))
+							{
+								info.hle_freq[func]++;
+							}
+							else
+							{
+								info.freq[atomic_storage<u32>::load(ppu->cia)]++;
+							}
+
+							info.new_samples++;
+							continue;
+						}
+
+						// Get short function hash
+						const u64 name = atomic_storage<u64>::load(ptr->block_hash);
+
 						info.freq[name]++;
 						info.new_samples++;
 
@@ -422,8 +630,14 @@ struct cpu_prof
 			{
 				profiler.success("Flushing profiling results...");
 
+				ppu_symbol_map symbols;
+				symbols.collect();
+
+				std::string report;
 				all_threads_info = {};
-				sample_info::print_all(threads, all_threads_info);
+				all_ppu_info = {};
+				sample_info::print_all(threads, all_threads_info, all_ppu_info, &symbols, &report);
+				save_report(report);
 			}
 
 			if (Emu.IsPaused())
@@ -443,8 +657,8 @@ struct cpu_prof
 			thread_ctrl::wait_for(20, false);
 		}
 
-		// Print all remaining results
-		sample_info::print_all(threads, all_threads_info);
+		// Print all remaining results (modules may be already unloaded, addresses are not symbolized)
+		sample_info::print_all(threads, all_threads_info, all_ppu_info);
 	}
 
 	static constexpr auto thread_name = "CPU Profiler"sv;
@@ -655,7 +869,11 @@ void cpu_thread::operator()()
 	{
 	case thread_class::ppu:
 	{
-		// g_fxo->get<cpu_profiler>().registered.push(id);
+		if (g_cfg.core.ppu_prof)
+		{
+			g_fxo->get<cpu_profiler>().registered.push(id);
+		}
+
 		break;
 	}
 	case thread_class::spu:
@@ -1060,7 +1278,7 @@ bool cpu_thread::check_state() noexcept
 
 					if (ctr >> 2 == s_tls_sctr >> 2 && state & cpu_flag::pause)
 					{
-						if (i < 20 || ctr & 1)
+						if (i < 20 || (ctr & 1 && i < s_suspend_spin_rounds))
 						{
 							rx::busy_wait(300);
 						}
@@ -1428,7 +1646,7 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 				return true;
 			});
 
-		while (copy)
+		for (u64 i = 0; copy; i++)
 		{
 			// Check only CPUs which haven't acknowledged their waiting state yet
 			copy = cpu_counter::for_all_cpu(copy, [&](cpu_thread* cpu, u32 /*index*/)
@@ -1446,7 +1664,14 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 				break;
 			}
 
-			rx::pause();
+			if (i < s_suspend_ack_spin_rounds)
+			{
+				rx::pause();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
 		}
 
 		// Second increment: all threads paused
@@ -1480,7 +1705,7 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 		{
 			for (u32 i = 0; i < work->prf_size; i++)
 			{
-				rx::prefetch_write(work->prf_list[0]);
+				rx::prefetch_write(work->prf_list[i]);
 			}
 		}
 
@@ -1548,7 +1773,7 @@ void cpu_thread::flush_profilers() noexcept
 		return;
 	}
 
-	if (g_cfg.core.spu_prof)
+	if (g_cfg.core.spu_prof || g_cfg.core.ppu_prof)
 	{
 		g_fxo->get<cpu_profiler>().registered.push(0);
 	}
@@ -9205,6 +9205,81 @@ void PPUInterpreter::interpret(PPUContext& context, std::uint32_t inst)
 	}
 }
 
+PPUInterpreter::decoded_inst PPUInterpreter::decode(u32 addr, u32 inst) const
+{
+	if (g_fxo->get<ppu_function_manager>().is_func(addr))
+	{
+		return {nullptr, inst, false};
+	}
+
+	const auto op = rx::cell::ppu::getOpcode(inst);
+
+	const bool is_branch =
+		op == rx::cell::ppu::Opcode::B ||
+		op == rx::cell::ppu::Opcode::BC ||
+		op == rx::cell::ppu::Opcode::BCLR ||
+		op == rx::cell::ppu::Opcode::BCCTR;
+
+	return {impl[static_cast<int>(op)], inst, is_branch};
+}
+
+void PPUInterpreter::interpret(PPUContext& context, decode_cache& cache)
+{
+	const u32 cia = context.cia;
+	const u32 inst = *reinterpret_cast<be_t<u32>*>(vm::g_base_addr + cia);
+
+	// Registered functions, breakpoints and far jumps take priority
+	if (*reinterpret_cast<ppu_intrp_func_t*>(vm::g_exec_addr + u64{cia} * 2))
+	{
+		return interpret(context, inst);
+	}
+
+	const u32 page = cia / decode_cache::page_size;
+
+	if (page != cache.last_page) [[unlikely]]
+	{
+		auto& insts = cache.pages[page];
+
+		if (!insts)
+		{
+			// Decode the whole page once, straight-line code mostly stays within it
+			constexpr u32 count = decode_cache::page_size / 4;
+			const u32 page_addr = page * decode_cache::page_size;
+			const auto code = reinterpret_cast<be_t<u32>*>(vm::g_base_addr + page_addr);
+
+			insts = std::make_unique<decoded_inst[]>(count);
+
+			for (u32 i = 0; i < count; i++)
+			{
+				insts[i] = decode(page_addr + i * 4, code[i]);
+			}
+		}
+
+		cache.last_page = page;
+		cache.last = insts.get();
+	}
+
+	decoded_inst& entry = cache.last[cia % decode_cache::page_size / 4];
+
+	if (entry.inst != inst) [[unlikely]]
+	{
+		// Code was written after the page was decoded
+		entry = decode(cia, inst);
+	}
+
+	if (!entry.fn) [[unlikely]]
+	{
+		return interpret(context, inst);
+	}
+
+	entry.fn(context, std::bit_cast<rx::cell::ppu::Instruction>(inst));
+
+	if (context.cia == cia && !entry.is_branch)
+	{
+		context.cia += sizeof(std::uint32_t);
+	}
+}
+
 extern "C"
 {
 	[[noreturn]] void rpcsx_trap()
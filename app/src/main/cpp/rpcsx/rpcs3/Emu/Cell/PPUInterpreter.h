@@ -6,6 +6,8 @@
 #include "rx/cpu/cell/ppu/PPUContext.hpp"
 #include "rx/refl.hpp"
 #include <array>
+#include <memory>
+#include <unordered_map>
 
 class ppu_thread;
 
@@ -52,7 +54,35 @@ struct PPUContext;
 
 struct PPUInterpreter
 {
-	std::array<void (*)(PPUContext& context, rx::cell::ppu::Instruction inst), rx::fieldCount<rx::cell::ppu::Opcode>> impl;
+	using impl_t = void (*)(PPUContext& context, rx::cell::ppu::Instruction inst);
+
+	// Instruction handler resolved ahead of execution
+	struct decoded_inst
+	{
+		// Null if the instruction needs the full lookup (HLE function)
+		impl_t fn;
+
+		// Instruction the handler was decoded from, re-decoded if the code changes
+		u32 inst;
+
+		bool is_branch;
+	};
+
+	// Per-thread predecoded code pages
+	struct decode_cache
+	{
+		static constexpr u32 page_size = 0x1000;
+
+		u32 last_page = umax;
+		decoded_inst* last = nullptr;
+		std::unordered_map<u32, std::unique_ptr<decoded_inst[]>> pages;
+	};
+
+	std::array<impl_t, rx::fieldCount<rx::cell::ppu::Opcode>> impl;
 	PPUInterpreter();
 	void interpret(PPUContext& context, std::uint32_t inst);
+	void interpret(PPUContext& context, decode_cache& cache);
+
+private:
+	decoded_inst decode(u32 addr, u32 inst) const;
 };
@@ -5,11 +5,14 @@
 #include "util/StrUtil.h"
 #include "util/address_range.h"
 #include "util/serialization.hpp"
+#include "util/sysinfo.hpp"
+#include "util/vm.hpp"
 #include "Crypto/sha1.h"
 #include "Crypto/unself.h"
 #include "Loader/ELF.h"
 #include "Emu/System.h"
 #include "Emu/system_config.h"
+#include "Emu/vfs_config.h"
 #include "Emu/VFS.h"
 
 #include "Emu/Cell/PPUOpcodes.h"
@@ -36,6 +39,7 @@ LOG_CHANNEL(ppu_loader);
 extern std::string ppu_get_function_name(const std::string& _module, u32 fnid);
 extern std::string ppu_get_variable_name(const std::string& _module, u32 vnid);
 extern void ppu_register_range(u32 addr, u32 size);
+extern void ppu_notify_code_invalidated(u32 addr, u32 size);
 extern void ppu_register_function_at(u32 addr, u32 size, ppu_intrp_func_t ptr);
 
 extern void sys_initialize_tls(ppu_thread&, u64, u32, u32, u32);
@@ -1484,6 +1488,297 @@ void try_spawn_ppu_if_exclusive_program(const ppu_module<lv2_obj>& m)
 	}
 }
 
+// Decrypted firmware SPRX images of the installed firmware, kept in one pack per firmware version
+// and mapped read-only. decrypt_self() has to hash the whole SELF and inflate its cached image on
+// every boot; a pack entry is found by name and only checked against the SELF size and mtime.
+// Modules decrypted during a run are added when the emulator stops.
+struct ppu_firmware_images
+{
+	struct pack_header
+	{
+		le_t<u32> magic;
+		le_t<u32> version;
+		le_t<u32> count;
+		le_t<u32> reserved;
+		u8 firmware_hash[20];
+		u8 pad[12];
+	};
+
+	struct pack_entry
+	{
+		char name[48];
+		le_t<u64> src_size;
+		le_t<s64> src_mtime;
+		le_t<u64> offset;
+		le_t<u64> size;
+	};
+
+	static constexpr u32 c_pack_magic = "FWPX"_u32;
+	static constexpr u32 c_pack_version = 1;
+	static constexpr usz c_image_align = 0x1000;
+
+	struct added_image
+	{
+		fs::stat_t src;
+		std::vector<u8> data;
+	};
+
+	std::string m_path;
+	u8 m_firmware_hash[20]{};
+
+	const u8* m_view = nullptr;
+	usz m_view_size = 0;
+	std::vector<u8> m_view_data; // When the pack could not be mapped
+	std::span<const pack_entry> m_entries;
+
+	shared_mutex m_mutex;
+	std::map<std::string, added_image, std::less<>> m_added;
+
+	ppu_firmware_images()
+	{
+		if (!g_cfg.core.firmware_image_cache)
+		{
+			return;
+		}
+
+		const std::string version = utils::get_firmware_version();
+		const fs::file version_file(g_cfg_vfs.get_dev_flash() + "vsh/etc/version.txt");
+
+		if (version.empty() || !version_file)
+		{
+			return;
+		}
+
+		// The version file changes with every firmware installation, a reinstall of the same version
+		// is caught by the per-module SELF size and mtime
+		const std::string version_data = version_file.to_string();
+		sha1(reinterpret_cast<const u8*>(version_data.data()), version_data.size(), m_firmware_hash);
+
+		m_path = fs::get_cache_dir() + "firmware/" + version + "/prx_images.bin";
+
+		const fs::file pack(m_path);
+
+		if (!pack || pack.size() <= sizeof(pack_header))
+		{
+			return;
+		}
+
+		m_view_size = pack.size();
+		m_view = static_cast<const u8*>(utils::memory_map_fd(pack.get_handle(), m_view_size, utils::protection::ro));
+
+		if (!m_view)
+		{
+			m_view_data = pack.to_vector<u8>();
+			m_view = m_view_data.data();
+		}
+
+		pack_header header;
+		std::memcpy(&header, m_view, sizeof(header));
+
+		const u64 table_end = sizeof(pack_header) + u64{header.count} * sizeof(pack_entry);
+
+		if (header.magic != c_pack_magic || header.version != c_pack_version || table_end > m_view_size ||
+			std::memcmp(header.firmware_hash, m_firmware_hash, sizeof(m_firmware_hash)) != 0)
+		{
+			ppu_loader.notice("Firmware image pack '%s' is stale, it will be rebuilt", m_path);
+			release_view();
+			return;
+		}
+
+		m_entries = {reinterpret_cast<const pack_entry*>(m_view + sizeof(pack_header)), header.count};
+
+		for (const pack_entry& entry : m_entries)
+		{
+			if (entry.offset < table_end || entry.size > m_view_size - entry.offset || entry.name[sizeof(entry.name) - 1])
+			{
+				ppu_loader.warning("Dropping corrupted firmware image pack '%s'", m_path);
+				release_view();
+				return;
+			}
+		}
+
+		ppu_loader.notice("Mapped %u firmware module images from '%s'", header.count, m_path);
+	}
+
+	ppu_firmware_images(const ppu_firmware_images&) = delete;
+	ppu_firmware_images& operator=(const ppu_firmware_images&) = delete;
+
+	~ppu_firmware_images()
+	{
+		if (!m_added.empty())
+		{
+			save();
+		}
+
+		release_view();
+	}
+
+	void release_view()
+	{
+		if (m_view && m_view_data.empty())
+		{
+			utils::memory_release(const_cast<u8*>(m_view), m_view_size);
+		}
+
+		m_view = nullptr;
+		m_view_size = 0;
+		m_view_data.clear();
+		m_entries = {};
+	}
+
+	static std::string_view get_name(std::string_view path)
+	{
+		return path.substr(path.find_last_of(fs::delim) + 1);
+	}
+
+	const pack_entry* find(std::string_view name, const fs::stat_t& src) const
+	{
+		for (const pack_entry& entry : m_entries)
+		{
+			if (name == entry.name)
+			{
+				return entry.src_size == src.size && entry.src_mtime == src.mtime ? &entry : nullptr;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// The view stays valid until the emulator stops, callers parse it into an ELF object right away
+	fs::file get(const std::string& path)
+	{
+		fs::stat_t src{};
+
+		if (m_path.empty() || !fs::get_stat(path, src))
+		{
+			return {};
+		}
+
+		const std::string_view name = get_name(path);
+
+		if (const pack_entry* entry = find(name, src); entry && entry->size >= 4 && std::memcmp(m_view + entry->offset, "\x7F" "ELF", 4) == 0)
+		{
+			ppu_loader.trace("Firmware module image hit: %s", name);
+			return fs::file(m_view + entry->offset, entry->size);
+		}
+
+		return {};
+	}
+
+	void add(const std::string& path, const fs::file& elf)
+	{
+		fs::stat_t src{};
+		const std::string_view name = get_name(path);
+
+		if (m_path.empty() || name.size() >= sizeof(pack_entry::name) || !fs::get_stat(path, src))
+		{
+			return;
+		}
+
+		added_image image{src, elf.to_vector<u8>()};
+		elf.seek(0);
+
+		std::lock_guard lock(m_mutex);
+		m_added.insert_or_assign(std::string(name), std::move(image));
+	}
+
+	void save()
+	{
+		struct source
+		{
+			std::string name;
+			fs::stat_t src;
+			const u8* data;
+			u64 size;
+		};
+
+		std::vector<source> sources;
+
+		for (const auto& [name, image] : m_added)
+		{
+			sources.push_back({name, image.src, image.data.data(), image.data.size()});
+		}
+
+		// Keep the entries of modules this run did not load, unless their SELF changed since
+		const std::string lle_dir = g_cfg_vfs.get_dev_flash() + "sys/external/";
+
+		for (const pack_entry& entry : m_entries)
+		{
+			fs::stat_t src{};
+
+			if (!m_added.contains(entry.name) && fs::get_stat(lle_dir + entry.name, src) && find(entry.name, src))
+			{
+				sources.push_back({entry.name, src, m_view + entry.offset, entry.size});
+			}
+		}
+
+		pack_header header{c_pack_magic, c_pack_version, ::size32(sources)};
+		std::memcpy(header.firmware_hash, m_firmware_hash, sizeof(m_firmware_hash));
+
+		std::vector<pack_entry> entries(sources.size());
+
+		u64 offset = rx::alignUp<u64>(sizeof(pack_header) + entries.size() * sizeof(pack_entry), c_image_align);
+
+		for (usz i = 0; i < sources.size(); i++)
+		{
+			strcpy_trunc(entries[i].name, sources[i].name);
+			entries[i].src_size = sources[i].src.size;
+			entries[i].src_mtime = sources[i].src.mtime;
+			entries[i].offset = offset;
+			entries[i].size = sources[i].size;
+			offset = rx::alignUp<u64>(offset + sources[i].size, c_image_align);
+		}
+
+		if (!fs::create_path(fs::get_parent_dir(m_path)))
+		{
+			ppu_loader.error("Failed to create firmware image pack directory for '%s' (%s)", m_path, fs::g_tls_error);
+			return;
+		}
+
+		fs::pending_file file(m_path);
+
+		if (!file.file)
+		{
+			return;
+		}
+
+		file.file.write(&header, sizeof(header));
+		file.file.write(entries.data(), entries.size() * sizeof(pack_entry));
+
+		for (usz i = 0; i < sources.size(); i++)
+		{
+			file.file.seek(entries[i].offset);
+			file.file.write(sources[i].data, sources[i].size);
+		}
+
+		if (!file.commit())
+		{
+			ppu_loader.error("Failed to write firmware image pack '%s' (%s)", m_path, fs::g_tls_error);
+			return;
+		}
+
+		ppu_loader.notice("Saved %u firmware module images to '%s' (%u new)", ::size32(sources), m_path, ::size32(m_added));
+	}
+};
+
+extern fs::file ppu_get_firmware_image(const std::string& path)
+{
+	if (auto images = g_fxo->try_get<ppu_firmware_images>())
+	{
+		return images->get(path);
+	}
+
+	return {};
+}
+
+extern void ppu_add_firmware_image(const std::string& path, const fs::file& elf)
+{
+	if (auto images = g_fxo->try_get<ppu_firmware_images>())
+	{
+		images->add(path, elf);
+	}
+}
+
 struct prx_names_table
 {
 	shared_mutex mutex;
@@ -2074,6 +2369,7 @@ void ppu_unload_prx(const lv2_prx& prx)
 		if (!seg.size)
 			continue;
 
+		ppu_notify_code_invalidated(seg.addr, seg.size);
 		vm::dealloc(seg.addr, vm::main);
 
 		const std::string hash_seg = fmt::format("%s-%u", hash, &seg - prx.segs.data());
@@ -2652,7 +2948,19 @@ bool ppu_load_exec(const ppu_exec_object& elf, bool virtual_load, const std::str
 	{
 		for (const auto& name : load_libs)
 		{
-			const ppu_prx_object obj = decrypt_self(fs::file(lle_dir + name));
+			fs::file image = ppu_get_firmware_image(lle_dir + name);
+
+			if (!image)
+			{
+				image = decrypt_self(fs::file(lle_dir + name));
+
+				if (image)
+				{
+					ppu_add_firmware_image(lle_dir + name, image);
+				}
+			}
+
+			const ppu_prx_object obj = std::move(image);
 
 			if (obj == elf_error::ok)
 			{
@@ -1253,6 +1253,18 @@ void ppu_remove_hle_instructions(u32 addr, u32 size)
 
 atomic_t<bool> g_debugger_pause_all_threads_on_bp = false;
 
+atomic_t<ppu_host_fpcr_filter_t> g_ppu_host_fpcr_filter{};
+bool g_ppu_nj_host_fpcr = false;
+atomic_t<ppu_code_invalidated_t> g_ppu_code_invalidated{};
+
+extern void ppu_notify_code_invalidated(u32 addr, u32 size)
+{
+	if (const auto callback = g_ppu_code_invalidated.load(); callback && size)
+	{
+		callback(addr, size);
+	}
+}
+
 // Breakpoint entry point
 static void ppu_break(ppu_thread& ppu, ppu_opcode_t, be_t<u32>* this_op, ppu_intrp_func* next_fn)
 {
@@ -1378,6 +1390,8 @@ extern bool ppu_patch(u32 addr, u32 value)
 		{
 			write_to_ptr<ppu_intrp_func_t>(ppu_ptr(addr), ppu_cache(addr));
 		}
+
+		ppu_notify_code_invalidated(addr, 4);
 	}
 
 	return true;
@@ -2453,6 +2467,17 @@ void ppu_thread::exec_task()
 		// HVContext push to allow recursion. This happens with guest callback invocations.
 		const auto old_hv_ctx = hv_ctx;
 
+#ifdef ARCH_ARM64
+		if (g_ppu_nj_host_fpcr)
+		{
+			// Compiled code only updates FPCR.FZ on MTVSCR, so seed it from this thread's NJ bit
+			u64 fpcr;
+			asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+			fpcr = (fpcr & ~(u64{1} << 24)) | (u64{nj} << 24);
+			asm volatile("msr fpcr, %0" ::"r"(fpcr));
+		}
+#endif
+
 		while (true)
 		{
 			if (state) [[unlikely]]
@@ -2475,6 +2500,8 @@ void ppu_thread::exec_task()
 	{
 		static PPUInterpreter interpreter;
 
+		PPUInterpreter::decode_cache decode_cache;
+
 		while (true)
 		{
 			if (test_stopped()) [[unlikely]]
@@ -2482,8 +2509,7 @@ void ppu_thread::exec_task()
 				return;
 			}
 
-			std::uint32_t inst = *reinterpret_cast<be_t<std::uint32_t>*>(mem_ + std::uint64_t{cia});
-			interpreter.interpret(*this, inst);
+			interpreter.interpret(*this, decode_cache);
 		}
 
 		return;
@@ -4636,6 +4662,24 @@ extern void ppu_initialize()
 
 	auto& _main = g_fxo->get<main_ppu_module<lv2_obj>>();
 
+#ifdef ARCH_ARM64
+	// Codegen mode, fixed for the whole session so that every module agrees on who handles NJ
+	if (g_cfg.core.ppu_decoder == ppu_decoder_type::llvm_legacy && !g_cfg.core.ppu_use_nj_bit)
+	{
+		const auto filter = g_ppu_host_fpcr_filter.load();
+		g_ppu_nj_host_fpcr = g_cfg.core.ppu_llvm_nj_host_fpcr || (filter && filter(Emu.GetTitleID().c_str()));
+	}
+	else
+	{
+		g_ppu_nj_host_fpcr = false;
+	}
+
+	if (g_ppu_nj_host_fpcr)
+	{
+		ppu_log.notice("PPU LLVM: Java Mode is handled by host FPCR.FZ");
+	}
+#endif
+
 	std::optional<scoped_progress_dialog> progress_dialog(std::in_place, get_localized_string(localized_string_id::PROGRESS_DIALOG_ANALYZING_PPU_EXECUTABLE));
 
 	// Analyse executable
@@ -4654,12 +4698,6 @@ extern void ppu_initialize()
 
 	bool compile_main = false;
 
-	// Check main module cache
-	if (!_main.segs.empty())
-	{
-		compile_main = ppu_initialize(_main, true);
-	}
-
 	std::vector<ppu_module<lv2_obj>*> module_list;
 	module_list.emplace_back(&g_fxo->get<main_ppu_module<lv2_obj>>());
 
@@ -4689,21 +4727,86 @@ extern void ppu_initialize()
 			module_list.emplace_back(&_module);
 		});
 
-	// Check preloaded libraries cache
-	if (!compile_fw)
+	// Modules whose cache has to be checked (main module first)
+	std::vector<const ppu_module<lv2_obj>*> check_list;
+
+	if (!_main.segs.empty())
+	{
+		check_list.emplace_back(&_main);
+	}
+
+	const bool check_fw = !compile_fw;
+
+	if (check_fw)
 	{
 		for (auto ptr : module_list)
 		{
 			if (ptr->path.starts_with(firmware_sprx_path))
 			{
-				compile_fw |= ppu_initialize(*ptr, true);
+				check_list.emplace_back(ptr);
+			}
+		}
+	}
+
+	// Check main module and preloaded libraries cache
+	// Each check hashes every function of the module, so spread the modules over worker threads
+	std::vector<u8> check_results(check_list.size());
+
+	if (check_list.size() > 1)
+	{
+		atomic_t<usz> check_next = 0;
+
+		g_progr_ptotal += ::size32(check_list);
+
+		named_thread_group workers("PPU Check ", std::min<u32>(::size32(check_list), rpcs3::utils::get_max_threads()), [&]
+			{
+				// Set low priority
+				thread_ctrl::scoped_priority low_prio(-1);
 
-				// Fixup for compatibility with old savestates
-				if (Emu.DeserialManager() && ptr->name == "liblv2.sprx")
+				for (usz i = check_next++; i < check_list.size(); i = check_next++, g_progr_pdone++)
 				{
-					static_cast<lv2_prx*>(ptr)->state = PRX_STATE_STARTED;
-					static_cast<lv2_prx*>(ptr)->load_exports();
+					if (Emu.IsStopped())
+					{
+						continue;
+					}
+
+					check_results[i] = ppu_initialize(*check_list[i], true);
 				}
+			});
+
+		workers.join();
+	}
+	else if (!check_list.empty())
+	{
+		check_results[0] = ppu_initialize(*check_list[0], true);
+	}
+
+	if (Emu.IsStopped())
+	{
+		return;
+	}
+
+	for (usz i = 0; i < check_list.size(); i++)
+	{
+		if (check_list[i] == &_main)
+		{
+			compile_main = check_results[i] != 0;
+		}
+		else
+		{
+			compile_fw |= check_results[i] != 0;
+		}
+	}
+
+	if (check_fw)
+	{
+		for (auto ptr : module_list)
+		{
+			// Fixup for compatibility with old savestates
+			if (Emu.DeserialManager() && ptr->name == "liblv2.sprx" && ptr->path.starts_with(firmware_sprx_path))
+			{
+				static_cast<lv2_prx*>(ptr)->state = PRX_STATE_STARTED;
+				static_cast<lv2_prx*>(ptr)->load_exports();
 			}
 		}
 	}
@@ -5421,8 +5524,10 @@ bool ppu_initialize(const ppu_module<lv2_obj>& info, bool check_only, u64 file_s
 				accurate_vnan,
 				accurate_nj_mode,
 				contains_symbol_resolver,
+				inline_leaf_calls,
+				nj_host_fpcr,
 
-				bitset_last = contains_symbol_resolver,
+				bitset_last = nj_host_fpcr,
 			};
 
 			be_t<rx::EnumBitSet<ppu_settings>> settings{};
@@ -5442,6 +5547,10 @@ bool ppu_initialize(const ppu_module<lv2_obj>& info, bool check_only, u64 file_s
 				settings += ppu_settings::reservations_128_byte;
 			if (g_cfg.core.ppu_llvm_greedy_mode)
 				settings += ppu_settings::greedy_mode;
+			if (g_cfg.core.ppu_llvm_inline_leaves)
+				settings += ppu_settings::inline_leaf_calls;
+			if (g_ppu_nj_host_fpcr)
+				settings += ppu_settings::nj_host_fpcr, settings -= ppu_settings::fixup_nj_denormals;
 			if (has_mfvscr && g_cfg.core.ppu_set_sat_bit)
 				settings += ppu_settings::accurate_sat;
 			if (g_cfg.core.ppu_set_fpcc)
@@ -284,6 +284,19 @@ public:
 
 static_assert(ppu_join_status::max <= ppu_join_status{ppu_thread::id_base});
 
+// Per-title opt-in for VSCR[NJ] via host FPCR.FZ (null: only the config option decides)
+using ppu_host_fpcr_filter_t = bool (*)(const char* title_id);
+
+extern atomic_t<ppu_host_fpcr_filter_t> g_ppu_host_fpcr_filter;
+
+// Set by ppu_initialize() before any PPU module is compiled
+extern bool g_ppu_nj_host_fpcr;
+
+// Observer of guest code ranges that stop being valid (module unload, code patches)
+using ppu_code_invalidated_t = void (*)(u32 addr, u32 size);
+
+extern atomic_t<ppu_code_invalidated_t> g_ppu_code_invalidated;
+
 template <typename T>
 struct ppu_gpr_cast_impl
 {
@@ -25,6 +25,7 @@
 using namespace llvm;
 
 const ppu_decoder<PPUTranslator> s_ppu_decoder;
+extern bool g_ppu_nj_host_fpcr;
 extern const ppu_decoder<ppu_itype> g_ppu_itype;
 extern const ppu_decoder<ppu_iname> g_ppu_iname;
 
@@ -456,7 +457,7 @@ Value* PPUTranslator::VecHandleDenormal(Value* val)
 Value* PPUTranslator::VecHandleResult(Value* val)
 {
 	val = g_cfg.core.ppu_fix_vnan ? VecHandleNan(val) : val;
-	val = g_cfg.core.ppu_llvm_nj_fixup ? VecHandleDenormal(val) : val;
+	val = g_cfg.core.ppu_llvm_nj_fixup && !g_ppu_nj_host_fpcr ? VecHandleDenormal(val) : val;
 	return val;
 }
 
@@ -616,6 +617,101 @@ void PPUTranslator::CallFunction(u64 target, Value* indirect)
 	m_ir->CreateRetVoid();
 }
 
+bool PPUTranslator::InlineLeafCall(u64 target)
+{
+	// Straight-line accessors: the body replaces the call, the entry check and the indirect return through LR
+	constexpr u32 max_inline_size = 12 * 4;
+
+	const u64 base = m_reloc ? m_reloc->addr : 0;
+	const u64 _target = target + base;
+	const u32 caddr = m_info.segs[0].addr;
+	const u32 cend = caddr + m_info.segs[0].size;
+
+	if (!g_cfg.core.ppu_llvm_inline_leaves || m_rel || _target < caddr || _target >= cend)
+	{
+		return false;
+	}
+
+	// Only inline function starts known to the analyser
+	const auto funcs = m_info.get_funcs(false);
+	const auto found = std::lower_bound(funcs.begin(), funcs.end(), _target, [](const ppu_function& func, u64 addr)
+		{
+			return func.addr < addr;
+		});
+
+	if (found == funcs.end() || found->addr != _target || !found->size || found->size > max_inline_size || found->addr + found->size > cend)
+	{
+		return false;
+	}
+
+	// Must end with BLR (return to the caller) or B (tail call, LR is preserved)
+	const u32 last = found->addr + found->size - 4;
+	const ppu_opcode_t last_op{*ensure(m_info.get_ptr<u32>(last))};
+	const bool is_tail_call = g_ppu_itype.decode(last_op.opcode) == ppu_itype::B && !last_op.lk && !last_op.aa;
+
+	if (last_op.opcode != ppu_instructions::BLR() && !is_tail_call)
+	{
+		return false;
+	}
+
+	for (u32 addr = found->addr; addr <= last; addr += 4)
+	{
+		if (m_relocs.contains(addr))
+		{
+			return false;
+		}
+
+		if (addr == last)
+		{
+			break;
+		}
+
+		switch (g_ppu_itype.decode(*ensure(m_info.get_ptr<u32>(addr))))
+		{
+		case ppu_itype::UNK:
+		case ppu_itype::ECIWX:
+		case ppu_itype::ECOWX:
+		case ppu_itype::TD:
+		case ppu_itype::TDI:
+		case ppu_itype::TW:
+		case ppu_itype::TWI:
+		case ppu_itype::B:
+		case ppu_itype::BC:
+		case ppu_itype::BCCTR:
+		case ppu_itype::BCLR:
+		case ppu_itype::SC:
+		case ppu_itype::MTSPR: // May change LR
+		{
+			return false;
+		}
+		default:
+		{
+			break;
+		}
+		}
+	}
+
+	// Translate the body at its own addresses (CIA of helper calls and checks stays exact)
+	const u64 caller = m_addr;
+
+	for (m_addr = found->addr - base; m_addr < last - base; m_addr += 4)
+	{
+		m_may_be_mmio = true;
+
+		const u32 op = *ensure(m_info.get_ptr<u32>(::narrow<u32>(m_addr + base)));
+
+		(this->*(s_ppu_decoder.decode(op)))({op});
+	}
+
+	if (is_tail_call)
+	{
+		B(last_op);
+	}
+
+	m_addr = caller;
+	return true;
+}
+
 Value* PPUTranslator::RegInit(Value*& local)
 {
 	const auto index = ::narrow<uint>(&local - m_locals);
@@ -956,6 +1052,15 @@ void PPUTranslator::MTVSCR(ppu_opcode_t op)
 	const auto vscr = m_ir->CreateExtractElement(GetVr(op.vb, VrType::vi32), m_ir->getInt32(m_is_be ? 3 : 0));
 	const auto nj = Trunc(m_ir->CreateLShr(vscr, 16), GetType<bool>());
 	RegStore(nj, m_nj);
+#ifdef ARCH_ARM64
+	if (g_ppu_nj_host_fpcr)
+	{
+		// Denormal flushing is done by the host for every following FP op
+		const auto fpcr = m_ir->CreateAnd(Call(GetType<u64>(), "llvm.aarch64.get.fpcr"), m_ir->getInt64(~(u64{1} << 24)));
+		Call(GetType<void>(), "llvm.aarch64.set.fpcr", m_ir->CreateOr(fpcr, m_ir->CreateShl(ZExt(nj, GetType<u64>()), 24)));
+	}
+	else
+#endif
 	if (g_cfg.core.ppu_llvm_nj_fixup)
 		RegStore(m_ir->CreateSelect(nj, m_ir->getInt32(0x7f80'0000), m_ir->getInt32(0x7fff'ffff)), m_jm_mask);
 	if (g_cfg.core.ppu_set_sat_bit)
@@ -2292,6 +2397,12 @@ void PPUTranslator::B(ppu_opcode_t op)
 	if (op.lk)
 	{
 		RegStore(GetAddr(+4), m_lr);
+
+		// Continue with the return address in the same block
+		if (!op.aa && InlineLeafCall(target))
+		{
+			return;
+		}
 	}
 
 	FlushRegisters();
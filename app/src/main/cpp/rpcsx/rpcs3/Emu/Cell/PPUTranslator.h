@@ -154,6 +154,9 @@ public:
 	// Emit function call
 	void CallFunction(u64 target, llvm::Value* indirect = nullptr);
 
+	// Translate a tiny leaf function in place of a direct call (false if not applicable)
+	bool InlineLeafCall(u64 target);
+
 	// Emit state check mid-block
 	void TestAborted();
 
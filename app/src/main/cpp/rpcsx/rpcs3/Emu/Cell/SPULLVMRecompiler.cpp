@@ -1526,6 +1526,18 @@ public:
 			return add_loc->compiled;
 		}
 
+		if (add_loc->compiling.exchange(1))
+		{
+			// The same program is already being compiled by another thread (e.g. one SPURS job on every SPU)
+			// Use the code installed by it, which may still be the fast tier's while the LLVM one is in progress
+			while (!add_loc->compiled)
+			{
+				add_loc->compiled.wait(nullptr);
+			}
+
+			return add_loc->compiled;
+		}
+
 		bool add_to_file = false;
 
 		if (auto& cache = g_fxo->get<spu_cache>(); cache && g_cfg.core.spu_cache && !add_loc->cached.exchange(1))
@@ -3516,13 +3528,19 @@ public:
 		}
 		case SPU_RdDec:
 		{
-#if defined(ARCH_X64)
+#if defined(ARCH_X64) || defined(ARCH_ARM64)
 			if (utils::get_tsc_freq() && !(g_cfg.core.spu_loop_detection) && (g_cfg.core.clocks_scale == 100))
 			{
 				const auto timebase_offs = m_ir->CreateLoad(get_type<u64>(), m_ir->CreateIntToPtr(m_ir->getInt64(reinterpret_cast<u64>(&g_timebase_offs)), get_type<u64*>()));
 				const auto timestamp = m_ir->CreateLoad(get_type<u64>(), spu_ptr<u64>(OFFSET_OF(spu_thread, ch_dec_start_timestamp)));
 				const auto dec_value = m_ir->CreateLoad(get_type<u32>(), spu_ptr<u32>(OFFSET_OF(spu_thread, ch_dec_value)));
+#if defined(ARCH_X64)
 				const auto tsc = m_ir->CreateCall(get_intrinsic(llvm::Intrinsic::x86_rdtsc));
+#else
+				// Same counter as rx::get_tsc(), utils::get_tsc_freq() is CNTFRQ_EL0 here
+				const auto cntvct_name = MetadataAsValue::get(m_context, MDNode::get(m_context, {MDString::get(m_context, "cntvct_el0")}));
+				const auto tsc = m_ir->CreateCall(get_intrinsic<u64>(Intrinsic::read_volatile_register), {cntvct_name});
+#endif
 				const auto tscx = m_ir->CreateMul(m_ir->CreateUDiv(tsc, m_ir->getInt64(utils::get_tsc_freq())), m_ir->getInt64(80000000));
 				const auto tscm = m_ir->CreateUDiv(m_ir->CreateMul(m_ir->CreateURem(tsc, m_ir->getInt64(utils::get_tsc_freq())), m_ir->getInt64(80000000)), m_ir->getInt64(utils::get_tsc_freq()));
 				const auto tsctb = m_ir->CreateSub(m_ir->CreateAdd(tscx, tscm), timebase_offs);
@@ -3608,6 +3626,8 @@ public:
 	{
 		auto wait_on_channel = [](spu_thread* _spu, spu_channel* ch, u32 is_read) -> u32
 		{
+			g_spu_idle_stats.channel_waits++;
+
 			if (is_read)
 			{
 				ch->pop_wait(*_spu, false);
@@ -3696,6 +3716,7 @@ public:
 			{
 				auto wait_inbox = [](spu_thread* _spu, spu_channel_4_t* ch) -> u32
 				{
+					g_spu_idle_stats.channel_waits++;
 					return ch->pop_wait(*_spu, false), ch->get_count();
 				};
 
@@ -3879,8 +3900,24 @@ public:
 		}
 		case SPU_WrOutMbox:
 		{
-			// TODO
-			break;
+			// Fast path: nothing pending and the mailbox is empty with no waiter, otherwise the handler may block
+			update_pc();
+			ensure_gpr_stores();
+			const auto next = llvm::BasicBlock::Create(m_context, "", m_function);
+			const auto push = llvm::BasicBlock::Create(m_context, "", m_function);
+			const auto _wrch = llvm::BasicBlock::Create(m_context, "", m_function);
+			const auto pstate = spu_ptr<u32>(OFFSET_OF(spu_thread, state));
+			m_ir->CreateCondBr(m_ir->CreateICmpEQ(m_ir->CreateLoad(get_type<u32>(), pstate, true), m_ir->getInt32(0)), push, _wrch, m_md_likely);
+			m_ir->SetInsertPoint(push);
+			const auto mbox = spu_ptr<u64>(OFFSET_OF(spu_thread, ch_out_mbox));
+			const auto data = m_ir->CreateOr(m_ir->CreateZExt(val.value, get_type<u64>()), m_ir->getInt64(spu_channel::bit_count));
+			const auto cmp_res = m_ir->CreateAtomicCmpXchg(mbox, m_ir->getInt64(0), data, llvm::MaybeAlign{8}, llvm::AtomicOrdering::SequentiallyConsistent, llvm::AtomicOrdering::SequentiallyConsistent);
+			m_ir->CreateCondBr(m_ir->CreateExtractValue(cmp_res, 1), next, _wrch, m_md_likely);
+			m_ir->SetInsertPoint(_wrch);
+			call("spu_write_channel", &exec_wrch, m_thread, m_ir->getInt32(op.ra), val.value);
+			m_ir->CreateBr(next);
+			m_ir->SetInsertPoint(next);
+			return;
 		}
 		case MFC_WrTagMask:
 		{
@@ -0,0 +1,201 @@
+#include "stdafx.h"
+#include "SPULoadBalancer.h"
+
+#include "Emu/IdManager.h"
+#include "Emu/system_config.h"
+#include "Emu/Cell/SPUThread.h"
+#include "util/cpu_stats.hpp"
+#include "util/sysinfo.hpp"
+#include "util/Thread.h"
+
+#include <algorithm>
+
+#ifdef ANDROID
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+	// Smoothed load above which an SPU is considered busy, and below which it is considered idle.
+	// The gap between both keeps threads from bouncing between tiers.
+	constexpr f64 promote_load_threshold = 60.;
+	constexpr f64 demote_load_threshold = 15.;
+
+#ifdef ANDROID
+	u32 read_core_capacity(u32 cpu)
+	{
+		for (const char* leaf : {"cpu_capacity", "cpufreq/cpuinfo_max_freq"})
+		{
+			std::ifstream file(fmt::format("/sys/devices/system/cpu/cpu%u/%s", cpu, leaf));
+			u32 value = 0;
+
+			if (file >> value && value)
+			{
+				return value;
+			}
+		}
+
+		return 0;
+	}
+#endif
+} // namespace
+
+void spu_load_balancer::detect_core_tiers()
+{
+	m_tiers_detected = true;
+
+#ifdef ANDROID
+	const u64 spu_mask = thread_ctrl::get_affinity_mask(thread_class::spu);
+	const u32 core_count = std::min<u32>(utils::get_thread_count(), 64);
+
+	std::vector<u32> capacities(core_count);
+	for (u32 cpu = 0; cpu < core_count; cpu++)
+	{
+		capacities[cpu] = read_core_capacity(cpu);
+	}
+
+	std::vector<u32> tiers = capacities;
+	std::sort(tiers.begin(), tiers.end(), std::greater<>());
+	tiers.erase(std::unique(tiers.begin(), tiers.end()), tiers.end());
+
+	if (tiers.size() < 2 || tiers.back() == 0)
+	{
+		spu_log.notice("SPU load balancing: homogeneous or unknown core layout, disabled");
+		return;
+	}
+
+	const u32 min_capacity = tiers.back();
+	const u32 big_capacity_limit = tiers.size() > 2 ? tiers[1] : tiers[0];
+
+	u64 big_mask = 0, little_mask = 0;
+	for (u32 cpu = 0; cpu < core_count; cpu++)
+	{
+		if (capacities[cpu] == min_capacity)
+		{
+			little_mask |= 1ull << cpu;
+		}
+		else if (capacities[cpu] <= big_capacity_limit)
+		{
+			big_mask |= 1ull << cpu;
+		}
+	}
+
+	m_big_mask = big_mask & spu_mask;
+	m_little_mask = little_mask & spu_mask;
+
+	if (!m_big_mask || !m_little_mask)
+	{
+		spu_log.notice("SPU load balancing: SPU affinity does not span both core tiers, disabled");
+		m_big_mask = m_little_mask = 0;
+		return;
+	}
+
+	spu_log.notice("SPU load balancing: big cores=0x%x, little cores=0x%x", m_big_mask, m_little_mask);
+#endif
+}
+
+void spu_load_balancer::update(utils::cpu_stats& stats)
+{
+#ifdef ANDROID
+	if (!g_cfg.core.spu_load_balancing)
+	{
+		return;
+	}
+
+	if (!m_tiers_detected)
+	{
+		detect_core_tiers();
+	}
+
+	if (!m_big_mask)
+	{
+		return;
+	}
+
+	m_tids.clear();
+	m_waiting.clear();
+
+	idm::select<named_thread<spu_thread>>([&](u32, named_thread<spu_thread>& spu)
+	{
+		const u64 native_id = thread_ctrl::get_native_id(spu);
+		if (!native_id)
+		{
+			// Not started yet
+			return;
+		}
+
+		if (const pid_t tid = pthread_gettid_np(reinterpret_cast<pthread_t>(native_id)); tid > 0)
+		{
+			m_tids.push_back(tid);
+
+			// Blocked in a channel read, event queue receive or group wait
+			m_waiting.push_back(!!(spu.state & cpu_flag::wait));
+		}
+	});
+
+	stats.get_per_thread_usage(m_tids, m_usage);
+
+	std::unordered_map<u64, thread_load> threads;
+	threads.reserve(m_tids.size());
+
+	for (usz i = 0; i < m_tids.size(); i++)
+	{
+		const u64 tid = m_tids[i];
+
+		thread_load info{};
+		if (const auto found = m_threads.find(tid); found != m_threads.end())
+		{
+			info = found->second;
+		}
+
+		// A waiting SPU may still burn time spinning; that time is not worth a big core
+		const f64 sample = m_waiting[i] ? 0. : m_usage[i];
+		info.load = info.samples ? (info.load + sample) / 2 : sample;
+
+		// The first usage sample of a thread always reads 0
+		if (++info.samples > 2)
+		{
+			core_tier target = info.placement;
+
+			if (info.load >= promote_load_threshold)
+			{
+				target = core_tier::big;
+			}
+			else if (info.load <= demote_load_threshold)
+			{
+				target = core_tier::little;
+			}
+
+			if (target != info.placement)
+			{
+				const u64 mask = target == core_tier::big ? m_big_mask : m_little_mask;
+
+				cpu_set_t cs;
+				CPU_ZERO(&cs);
+
+				for (u32 cpu = 0; cpu < 64; cpu++)
+				{
+					if (mask & (1ull << cpu))
+					{
+						CPU_SET(cpu, &cs);
+					}
+				}
+
+				if (sched_setaffinity(static_cast<pid_t>(tid), sizeof(cpu_set_t), &cs) == 0)
+				{
+					spu_log.trace("SPU load balancing: thread %u (load %.1f%%) moved to %s cores", tid, info.load, target == core_tier::big ? "big" : "little");
+					info.placement = target;
+				}
+			}
+		}
+
+		threads.emplace(tid, info);
+	}
+
+	m_threads = std::move(threads);
+#else
+	static_cast<void>(stats);
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "util/types.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace utils
+{
+	class cpu_stats;
+}
+
+// Moves SPU threads between core tiers of big.LITTLE CPUs depending on their measured load.
+// Busy SPUs are promoted to the big cores, idle or waiting SPUs are demoted to the little cores.
+// On CPUs with three or more tiers the top tier is left to the PPU.
+class spu_load_balancer
+{
+public:
+	// Expected to be called periodically (once a second from the performance monitor)
+	void update(utils::cpu_stats& stats);
+
+private:
+	enum class core_tier : u8
+	{
+		any,
+		big,
+		little,
+	};
+
+	struct thread_load
+	{
+		f64 load = 0.;   // Smoothed busy share, percent of one core
+		u32 samples = 0; // Number of samples taken so far
+		core_tier placement = core_tier::any;
+	};
+
+	void detect_core_tiers();
+
+	bool m_tiers_detected = false;
+	u64 m_big_mask = 0;
+	u64 m_little_mask = 0;
+
+	std::unordered_map<u64, thread_load> m_threads;
+
+	// Scratch buffers
+	std::vector<u64> m_tids;
+	std::vector<bool> m_waiting;
+	std::vector<f64> m_usage;
+};
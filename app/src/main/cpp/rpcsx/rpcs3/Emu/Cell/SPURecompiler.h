@@ -80,6 +80,9 @@ public:
 	atomic_t<u8> cached = false;
 	atomic_t<u8> logged = false;
 
+	// Claimed by the first thread that starts an LLVM compilation of this item
+	atomic_t<u8> compiling = false;
+
 	spu_item(spu_program&& data)
 		: data(std::move(data))
 	{
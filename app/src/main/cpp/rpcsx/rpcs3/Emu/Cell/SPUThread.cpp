@@ -193,11 +193,50 @@ static FORCE_INLINE void __movsb(unsigned char* Dst, const unsigned char* Src, s
 		"rep; movsb" :
 		[Dst] "=D"(Dst), [Src] "=S"(Src), [Size] "=c"(Size) : "[Dst]"(Dst), "[Src]"(Src), "[Size]"(Size));
 }
+#elif defined(ARCH_ARM64)
+// Bulk copy with non-temporal stores, large transfers are not expected to be read back soon by the writer
+#define s_rep_movsb_threshold 0x2000u
+
+static FORCE_INLINE void __movsb(unsigned char* Dst, const unsigned char* Src, size_t Size)
+{
+	for (; Size >= 64; Dst += 64, Src += 64, Size -= 64)
+	{
+		__asm__ __volatile__(
+			"ldp q0, q1, [%[Src]]\n"
+			"ldp q2, q3, [%[Src], #32]\n"
+			"stnp q0, q1, [%[Dst]]\n"
+			"stnp q2, q3, [%[Dst], #32]\n" : : [Dst] "r"(Dst), [Src] "r"(Src) : "v0", "v1", "v2", "v3", "memory");
+	}
+
+	if (Size)
+	{
+		std::memcpy(Dst, Src, Size);
+	}
+}
 #else
 #define s_rep_movsb_threshold umax
 #define __movsb std::memcpy
 #endif
 
+spu_idle_stats g_spu_idle_stats;
+
+#if defined(ARCH_ARM64)
+// Sleep until another core writes the reservation line (the load arms the exclusive monitor)
+// WFE is also woken by interrupts and the kernel timer event stream, so the wait stays short
+static FORCE_INLINE void spu_wait_for_store(const void* mem, u64 old)
+{
+	u64 value;
+	__asm__ __volatile__("ldaxr %0, [%1]" : "=r"(value) : "r"(mem) : "memory");
+
+	if (value == old)
+	{
+		__asm__ __volatile__("wfe" : : : "memory");
+	}
+
+	__asm__ __volatile__("clrex" : : : "memory");
+}
+#endif
+
 #if defined(ARCH_X64)
 static FORCE_INLINE bool cmp_rdata_avx(const __m256i* lhs, const __m256i* rhs)
 {
@@ -456,7 +495,7 @@ waitpkg_func static void __tpause(u32 cycles, u32 cstate)
 
 namespace vm
 {
-	std::array<atomic_t<reservation_waiter_t>, 1024> g_resrv_waiters_count{};
+	std::array<reservation_waiter_shard_t, reservation_waiter_shards> g_resrv_waiters_count{};
 }
 
 void do_cell_atomic_128_store(u32 addr, const void* to_write);
@@ -1841,6 +1880,14 @@ void spu_thread::cpu_task()
 
 	pc &= 0x3fffc;
 
+#if defined(__GNUC__)
+	// Sibling SPUs usually run the same kernel with the same frames at the same page offsets,
+	// shift each stack by a few cache lines so their hot frames don't compete for the same sets
+	// of the shared cluster cache
+	volatile u8* const stack_color = static_cast<u8*>(__builtin_alloca(8 + (index % 16) * 256));
+	stack_color[0] = 0;
+#endif
+
 	std::fesetround(FE_TOWARDZERO);
 
 	gv_set_zeroing_denormals();
@@ -2099,6 +2146,21 @@ u8* spu_thread::map_ls(utils::shm& shm, void* ptr)
 
 	const auto ls = ptr ? static_cast<u8*>(ptr) : static_cast<u8*>(ensure(utils::memory_reserve(SPU_LS_SIZE * 5, nullptr, true))) + SPU_LS_SIZE * 2;
 	ensure(shm.map_critical(ls - SPU_LS_SIZE).first && shm.map_critical(ls).first && shm.map_critical(ls + SPU_LS_SIZE).first);
+
+	if (g_cfg.core.spu_lock_ls)
+	{
+		// The mirrors share the same shm pages, locking one view pins them all
+		if (!utils::memory_lock(ls, SPU_LS_SIZE))
+		{
+			static atomic_t<bool> s_warned = false;
+
+			if (!s_warned.exchange(true))
+			{
+				spu_log.warning("Failed to lock SPU local storage in memory (RLIMIT_MEMLOCK?)");
+			}
+		}
+	}
+
 	return ls;
 }
 
@@ -3145,10 +3207,21 @@ bool spu_thread::do_list_transfer(spu_mfc_cmd& args)
 	alignas(16) list_element items[fetch_size];
 	static_assert(sizeof(v128) % sizeof(list_element) == 0);
 
+	// Elements which are not inlined are accumulated here, contiguous ones are merged into one transfer
 	spu_mfc_cmd transfer;
 	transfer.eah = 0;
 	transfer.tag = args.tag;
 	transfer.cmd = MFC{static_cast<u8>(args.cmd & ~0xf)};
+	transfer.size = 0;
+
+	auto flush_transfer = [&]()
+	{
+		if (transfer.size)
+		{
+			do_dma_transfer(this, transfer, ls);
+			transfer.size = 0;
+		}
+	};
 
 	u32 index = fetch_size;
 
@@ -3173,6 +3246,8 @@ bool spu_thread::do_list_transfer(spu_mfc_cmd& args)
 		// Check if fetching is needed
 		if (index == fetch_size)
 		{
+			flush_transfer();
+
 			const v128 data0 = v128::loadu(item_ptr, 0);
 			const v128 data1 = v128::loadu(item_ptr, 1);
 			const v128 data2 = v128::loadu(item_ptr, 2);
@@ -3485,6 +3560,8 @@ bool spu_thread::do_list_transfer(spu_mfc_cmd& args)
 		// Try to inline the transfer
 		if (addr < RAW_SPU_BASE_ADDR && size && optimization_compatible == MFC_GET_CMD)
 		{
+			flush_transfer();
+
 			const u8* src = vm::_ptr<u8>(addr);
 			u8* dst = this->ls + arg_lsa + (addr & 0xf);
 
@@ -3556,6 +3633,8 @@ bool spu_thread::do_list_transfer(spu_mfc_cmd& args)
 		// Avoid inlining huge transfers because it intentionally drops range lock unlock
 		else if (optimization_compatible == MFC_PUT_CMD && ((addr >> 28 == rsx::constants::local_mem_base >> 28) || (addr < RAW_SPU_BASE_ADDR && size - 1 <= 0x400 - 1 && (addr % 0x10000 + (size - 1)) < 0x10000)))
 		{
+			flush_transfer();
+
 			if (addr >> 28 != rsx::constants::local_mem_base >> 28)
 			{
 				rsx_lock.update_if_enabled(addr, size, range_lock);
@@ -3646,12 +3725,25 @@ bool spu_thread::do_list_transfer(spu_mfc_cmd& args)
 
 			spu_log.trace("LIST: item=0x%016x, lsa=0x%05x", std::bit_cast<be_t<u64>>(items[index]), arg_lsa | (addr & 0xf));
 
-			transfer.eal = addr;
-			transfer.lsa = arg_lsa | (addr & 0xf);
-			transfer.size = size;
+			const u32 lsa = arg_lsa | (addr & 0xf);
 
 			arg_lsa += rx::alignUp<u32>(size, 16);
-			do_dma_transfer(this, transfer, ls);
+
+			// Merge with the previous element if it ends exactly where this one starts, both in EA and LS
+			// Not done with accurate DMA or MFC debugging (optimization_compatible is 0) to keep per-element behaviour
+			if (optimization_compatible && transfer.size && transfer.size % 16 == 0 && addr < RAW_SPU_BASE_ADDR && transfer.eal + transfer.size == addr &&
+				transfer.lsa + transfer.size == lsa && transfer.size + size <= 0x4000)
+			{
+				transfer.size += size;
+			}
+			else
+			{
+				flush_transfer();
+
+				transfer.eal = addr;
+				transfer.lsa = lsa;
+				transfer.size = size;
+			}
 		}
 
 		arg_size -= 8;
@@ -3666,6 +3758,8 @@ bool spu_thread::do_list_transfer(spu_mfc_cmd& args)
 
 		if (items[index].sb & 0x80) [[unlikely]]
 		{
+			flush_transfer();
+
 			range_lock->release(0);
 
 			ch_stall_mask |= rx::rol32(1, args.tag);
@@ -3687,6 +3781,8 @@ bool spu_thread::do_list_transfer(spu_mfc_cmd& args)
 		index++;
 	}
 
+	flush_transfer();
+
 	range_lock->release(0);
 	return true;
 }
@@ -4655,6 +4751,7 @@ bool spu_thread::process_mfc_cmd()
 							if (getllar_busy_waiting_switch == 1)
 							{
 								getllar_wait_time[(addr % SPU_LS_SIZE) / 128].front() = 0;
+								g_spu_idle_stats.getllar_spins++;
 
 #if defined(ARCH_X64)
 								if (utils::has_um_wait())
@@ -4680,7 +4777,11 @@ bool spu_thread::process_mfc_cmd()
 								else
 #endif
 								{
+#if defined(ARCH_ARM64)
+									spu_wait_for_store(&res, this_time);
+#else
 									rx::busy_wait(300);
+#endif
 								}
 
 								if (getllar_spin_count == 3)
@@ -4699,6 +4800,7 @@ bool spu_thread::process_mfc_cmd()
 
 						// Spinning, might as well yield cpu resources
 						state += cpu_flag::wait;
+						g_spu_idle_stats.getllar_sleeps++;
 
 						usz cache_line_waiter_index = umax;
 
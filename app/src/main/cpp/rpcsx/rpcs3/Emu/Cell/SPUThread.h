@@ -627,6 +627,16 @@ enum class spu_block_hash : u64
 {
 };
 
+// How often detected SPU wait loops were turned into host waits, polled by the frontend
+struct spu_idle_stats
+{
+	atomic_t<u64> channel_waits = 0; // RCHCNT polling loops blocked on the channel instead
+	atomic_t<u64> getllar_spins = 0; // GETLLAR spin iterations parked on the reservation line (busy waiting mode)
+	atomic_t<u64> getllar_sleeps = 0; // GETLLAR spin loops slept on the reservation notifier
+};
+
+extern spu_idle_stats g_spu_idle_stats;
+
 class spu_thread : public cpu_thread
 {
 public:
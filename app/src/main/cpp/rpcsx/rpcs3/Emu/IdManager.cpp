@@ -48,7 +48,7 @@ id_manager::id_key* idm::allocate_id(std::span<id_manager::id_key> keys, u32& hi
 		}
 
 		id_manager::g_id = dst_id;
-		keys[index] = id_manager::id_key(dst_id, type_id);
+		keys[index].publish(id_manager::id_key(dst_id, type_id));
 		return &keys[index];
 	}
 
@@ -62,7 +62,8 @@ id_manager::id_key* idm::allocate_id(std::span<id_manager::id_key> keys, u32& hi
 		// Try to emplace back
 		const u32 _next = base + step * highest_index;
 		id_manager::g_id = _next;
-		return &(keys[highest_index++] = (id_manager::id_key(_next, type_id)));
+		keys[highest_index].publish(id_manager::id_key(_next, type_id));
+		return &keys[highest_index++];
 	}
 
 	// Check all IDs starting from "next id" (TODO)
@@ -76,7 +77,7 @@ id_manager::id_key* idm::allocate_id(std::span<id_manager::id_key> keys, u32& hi
 			// Incremenet ID invalidation counter
 			const u32 id = next | ((ptr->value() + (1u << invl_range.first)) & (invl_range.second ? (((1u << invl_range.second) - 1) << invl_range.first) : 0));
 			id_manager::g_id = id;
-			*ptr = id_manager::id_key(id, type_id);
+			ptr->publish(id_manager::id_key(id, type_id));
 			return ptr;
 		}
 	}
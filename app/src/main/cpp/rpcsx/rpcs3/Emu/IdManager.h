@@ -264,7 +264,8 @@ namespace id_manager
 	};
 
 	// ID value with additional type stored
-	class id_key
+	// Keys are written under the exclusive lock, but may be sampled without it (see idm::find_lockfree)
+	class alignas(8) id_key
 	{
 		u32 m_value = 0;   // ID value
 		u32 m_base = umax; // ID base (must be unique for each type in the same container)
@@ -289,9 +290,24 @@ namespace id_manager
 
 		void clear()
 		{
-			m_base = umax;
+			atomic_storage<u32>::release(m_base, umax);
 		}
 
+		// Replace the key, visible to lock-free readers only after the previous slot value was released
+		void publish(id_key key) noexcept
+		{
+			atomic_storage<u64>::release(*reinterpret_cast<u64*>(this), u64{key.m_base} << 32 | key.m_value);
+		}
+
+		// Load both halves of the key at once
+		id_key snapshot() const noexcept
+		{
+			const u64 raw = atomic_storage<u64>::load(*reinterpret_cast<const u64*>(this));
+			return id_key(static_cast<u32>(raw), static_cast<u32>(raw >> 32));
+		}
+
+		bool operator==(const id_key&) const noexcept = default;
+
 		operator u32() const noexcept
 		{
 			return m_value;
@@ -357,7 +373,7 @@ namespace id_manager
 
 				highest_index = std::max(highest_index, object_index + 1);
 
-				vec_keys[object_index] = id_key(id, static_cast<u32>(static_cast<u64>(type_init_pos >> 64)));
+				vec_keys[object_index].publish(id_key(id, static_cast<u32>(static_cast<u64>(type_init_pos >> 64))));
 				info->load(ar)(&obj);
 			}
 		}
@@ -545,6 +561,45 @@ class idm
 		return {};
 	}
 
+	// Get object by internal index without taking the lock.
+	// The key is sampled before and after loading the slot: a slot is cleared before its key is released and published
+	// after its key, so an unchanged key (which includes the invalidation counter) proves the object belongs to the ID.
+	// The returned reference keeps the object alive if it is removed afterwards.
+	template <typename T, typename Type>
+	static stx::shared_ptr<T> find_lockfree(u32 index, u32 id)
+	{
+		static_assert(IdmTypesCompatible<T, Type>, "Invalid ID type combination");
+
+		auto& map = g_fxo->get<id_manager::id_map<T>>();
+
+		if (index >= T::id_count)
+		{
+			return {};
+		}
+
+		auto& key = map.vec_keys[index];
+		const id_manager::id_key old_key = key.snapshot();
+
+		if (old_key.type() == umax || (!std::is_same_v<T, Type> && old_key.type() != get_type<Type>()))
+		{
+			return {};
+		}
+
+		if (id_manager::id_traits<Type>::invl_range.second && old_key.value() != id)
+		{
+			return {};
+		}
+
+		auto ptr = map.vec_data[index].load();
+
+		if (!ptr || key.snapshot() != old_key) [[unlikely]]
+		{
+			return {};
+		}
+
+		return ptr;
+	}
+
 	// Find ID
 	template <typename T, typename Type>
 	static std::pair<atomic_ptr<T>*, id_manager::id_key*> find_id(u32 id)
@@ -584,7 +639,7 @@ class idm
 				return object;
 			}
 
-			*key_ptr = {};
+			key_ptr->publish({});
 		}
 
 		return {};
@@ -721,14 +776,7 @@ public:
 		requires IdmTypesCompatible<T, Get>
 	static inline stx::shared_ptr<Get> get_unlocked(u32 id)
 	{
-		const auto found = find_id<T, Get>(id);
-
-		if (!found.first) [[unlikely]]
-		{
-			return null_ptr;
-		}
-
-		return static_cast<stx::shared_ptr<Get>>(found.first->load());
+		return static_cast<stx::shared_ptr<Get>>(find_lockfree<T, Get>(get_index<Get>(id), id));
 	}
 
 	// Get the object, access object under reader lock
@@ -7,6 +7,7 @@
 #include "vm_reservation.h"
 
 #include "util/Thread.h"
+#include "util/StrUtil.h"
 #include "util/address_range.h"
 #include "Emu/CPU/CPUThread.h"
 #include "Emu/RSX/RSXThread.h"
@@ -20,8 +21,15 @@
 #include "rx/align.hpp"
 #include "util/simd.hpp"
 #include "util/serialization.hpp"
+#include "Emu/savestate_utils.hpp"
+#include "Emu/system_config.h"
 
 #include <thread>
+#include <bit>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 LOG_CHANNEL(vm_log, "VM");
 
@@ -1310,6 +1318,15 @@ namespace vm
 			{
 				fmt::throw_exception("Memory mapping failed (addr=0x%x, size=0x%x, flags=0x%x): %s", addr, size, flags, map_error);
 			}
+
+			if (g_cfg.core.guest_huge_pages && !(this->flags & page_size_4k))
+			{
+				// Texture cache write watches and page protection still work at 4k, the kernel splits the affected huge pages
+				const bool base_ok = utils::memory_advise_hugepages(vm::_ptr<u8>(addr), size);
+				const bool sudo_ok = utils::memory_advise_hugepages(vm::get_super_ptr(addr), size);
+
+				vm_log.notice("Huge pages for block 0x%x (size=0x%x): base=%s, sudo=%s", addr, size, base_ok, sudo_ok);
+			}
 		}
 	}
 
@@ -1730,6 +1747,168 @@ namespace vm
 		ar.breathe();
 	}
 
+	// Incremental savestates: memory images are compared page-by-page against the last full savestate (the base)
+	// Only changed pages are stored, the rest is read from the base file when loading
+	struct snapshot_image_t
+	{
+		usz base_pos = 0; // Position of the image data in the base stream
+		usz size = 0;
+		std::vector<u64> hashes;
+	};
+
+	struct snapshot_state_t
+	{
+		std::string base_path;
+		u64 base_size = 0;
+		std::map<u64, snapshot_image_t> base;
+		std::map<u64, snapshot_image_t> pending; // Images of the full savestate being written
+		bool writing_delta = false;
+		u32 delta_count = 0;
+		usz dirty_pages = 0; // Of the last delta
+		usz total_pages = 0;
+
+		// Base reader while loading a delta
+		std::shared_ptr<utils::serial> reader;
+		std::string reader_path;
+	};
+
+	static snapshot_state_t s_snapshot;
+
+	// Rebase after this many deltas or when more than half of the pages changed
+	constexpr u32 max_snapshot_deltas = 32;
+
+	static u64 hash_memory_page(const u8* ptr)
+	{
+		// Independent lanes keep the multiplies in flight
+		u64 h[4]{0x9e3779b97f4a7c15, 0xc2b2ae3d27d4eb4f, 0x165667b19e3779f9, 0x27d4eb2f165667c5};
+
+		for (usz i = 0; i < 4096; i += 32)
+		{
+			for (usz lane = 0; lane < 4; lane++)
+			{
+				h[lane] = std::rotl((h[lane] ^ read_from_ptr<u64>(ptr, i + lane * 8)) * 0x9fb21c651e98df25, 29);
+			}
+		}
+
+		u64 result = h[0] ^ std::rotl(h[1], 16) ^ std::rotl(h[2], 32) ^ std::rotl(h[3], 48);
+		result ^= result >> 33;
+		result *= 0xff51afd7ed558ccd;
+		result ^= result >> 33;
+		return result;
+	}
+
+	static void serialize_memory_image(utils::serial& ar, u8* ptr, usz size, u64 key)
+	{
+		ensure((size % 4096) == 0);
+
+		const usz pages = size / 4096;
+
+		if (ar.is_writing())
+		{
+			std::vector<u64> hashes(pages);
+
+			for (usz i = 0; i < pages; i++)
+			{
+				hashes[i] = hash_memory_page(ptr + i * 4096);
+			}
+
+			const auto found = s_snapshot.writing_delta ? s_snapshot.base.find(key) : s_snapshot.base.end();
+
+			if (found == s_snapshot.base.end() || found->second.size != size)
+			{
+				ar(u8{0});
+
+				if (s_snapshot.writing_delta)
+				{
+					// New or resized since the base
+					s_snapshot.dirty_pages += pages;
+					s_snapshot.total_pages += pages;
+				}
+				else
+				{
+					s_snapshot.pending.insert_or_assign(key, snapshot_image_t{ar.pos, size, std::move(hashes)});
+				}
+
+				serialize_memory_bytes(ar, ptr, size);
+				return;
+			}
+
+			std::vector<u8> dirty(rx::aligned_div<usz>(pages, 8));
+			usz dirty_count = 0;
+
+			for (usz i = 0; i < pages; i++)
+			{
+				if (hashes[i] != found->second.hashes[i])
+				{
+					dirty[i / 8] |= 1u << (i % 8);
+					dirty_count++;
+				}
+			}
+
+			ar(u8{1});
+			ar(found->second.base_pos);
+			ar(dirty);
+
+			for (usz i = 0; i < pages; i++)
+			{
+				if (dirty[i / 8] & (1u << (i % 8)))
+				{
+					ar(std::span<u8>(ptr + i * 4096, 4096));
+
+					if (i % 256 == 0)
+					{
+						ar.breathe();
+					}
+				}
+			}
+
+			ar.breathe();
+
+			s_snapshot.dirty_pages += dirty_count;
+			s_snapshot.total_pages += pages;
+			return;
+		}
+
+		if (GET_SERIALIZATION_VERSION(global_version) < 20 || ar.pop<u8>() == 0)
+		{
+			serialize_memory_bytes(ar, ptr, size);
+			return;
+		}
+
+		const usz base_pos = ar.pop<usz>();
+		const std::vector<u8> dirty = ar.pop<std::vector<u8>>();
+
+		if (!s_snapshot.reader || dirty.size() != rx::aligned_div<usz>(pages, 8))
+		{
+			fmt::throw_exception("Invalid incremental memory image (size=0x%x, base='%s')", size, s_snapshot.reader_path);
+		}
+
+		if (s_snapshot.reader->pos > base_pos)
+		{
+			// Images are not in base order, restart the (sequential) base stream
+			s_snapshot.reader = make_savestate_reader(s_snapshot.reader_path);
+			ensure(s_snapshot.reader);
+		}
+
+		s_snapshot.reader->seek_pos(base_pos, true);
+		serialize_memory_bytes(*s_snapshot.reader, ptr, size);
+
+		for (usz i = 0; i < pages; i++)
+		{
+			if (dirty[i / 8] & (1u << (i % 8)))
+			{
+				ar(std::span<u8>(ptr + i * 4096, 4096));
+
+				if (i % 256 == 0)
+				{
+					ar.breathe();
+				}
+			}
+		}
+
+		ar.breathe();
+	}
+
 	void block_t::save(utils::serial& ar, std::map<utils::shm*, usz>& shared)
 	{
 		auto& m_map = (m.*block_map)();
@@ -1757,7 +1936,7 @@ namespace vm
 
 				// Save raw binary image
 				const u32 guard_size = flags & stack_guarded ? 0x1000 : 0;
-				serialize_memory_bytes(ar, vm::get_super_ptr<u8>(addr + guard_size), shm.first - guard_size * 2);
+				serialize_memory_image(ar, vm::get_super_ptr<u8>(addr + guard_size), shm.first - guard_size * 2, addr + guard_size);
 			}
 			else
 			{
@@ -1829,7 +2008,7 @@ namespace vm
 			{
 				// Load binary image
 				const u32 guard_size = flags & stack_guarded ? 0x1000 : 0;
-				serialize_memory_bytes(ar, vm::get_super_ptr<u8>(addr0 + guard_size), size0 - guard_size * 2);
+				serialize_memory_image(ar, vm::get_super_ptr<u8>(addr0 + guard_size), size0 - guard_size * 2, addr0 + guard_size);
 			}
 		}
 	}
@@ -2211,6 +2390,19 @@ namespace vm
 
 			std::memset(&g_pages, 0, sizeof(g_pages));
 
+#ifdef __linux__
+			if (g_cfg.core.guest_huge_pages)
+			{
+				// Guest memory is shared memory, transparent huge pages need shmem support ("advise" or "always")
+				const std::string shmem_thp = fs::file("/sys/kernel/mm/transparent_hugepage/shmem_enabled").to_string();
+
+				if (shmem_thp.find("[advise]") == umax && shmem_thp.find("[always]") == umax)
+				{
+					vm_log.warning("Guest memory huge pages requested, but shmem transparent huge pages are disabled by the kernel (%s)", shmem_thp.empty() ? "unavailable" : fmt::trim(shmem_thp, " \t\n"));
+				}
+			}
+#endif
+
 			g_locations =
 				{
 					std::make_shared<block_t>(0x00010000, 0x0FFF0000, page_size_64k | preallocated),                          // main
@@ -2304,16 +2496,36 @@ namespace vm
 			shared_map.emplace(p.first, &p - shared.data());
 		}
 
+		auto& snapshot = s_snapshot;
+		snapshot.pending.clear();
+
+		{
+			fs::stat_t base_stat{};
+
+			// The base must be the untouched file the page hashes were taken from
+			snapshot.writing_delta = g_cfg.savestate.incremental && !g_cfg.savestate.suspend_emu && !snapshot.base_path.empty() &&
+				snapshot.delta_count < max_snapshot_deltas && snapshot.dirty_pages * 2 <= snapshot.total_pages &&
+				fs::get_stat(snapshot.base_path, base_stat) && base_stat.size == snapshot.base_size;
+
+			snapshot.dirty_pages = 0;
+			snapshot.total_pages = 0;
+
+			ar(snapshot.writing_delta ? snapshot.base_path : std::string{});
+			ar(snapshot.writing_delta ? snapshot.base_size : u64{0});
+		}
+
 		// TODO: proper serialization of std::map
 		ar(static_cast<usz>(shared_map.size()));
 
-		for (const auto& [shm, addr] : shared)
+		for (usz i = 0; i < shared.size(); i++)
 		{
+			const auto& [shm, addr] = shared[i];
+
 			//  Save shared memory
 			ar(shm->flags());
 
 			ar(shm->size());
-			serialize_memory_bytes(ar, vm::get_super_ptr<u8>(addr), shm->size());
+			serialize_memory_image(ar, vm::get_super_ptr<u8>(addr), shm->size(), (1ull << 63) | i);
 		}
 
 		// TODO: Serialize std::vector direcly
@@ -2337,6 +2549,34 @@ namespace vm
 	{
 		std::vector<std::shared_ptr<utils::shm>> shared;
 
+		auto& snapshot = s_snapshot;
+		snapshot.reader.reset();
+		snapshot.reader_path.clear();
+
+		if (GET_SERIALIZATION_VERSION(global_version) >= 20)
+		{
+			std::string base_path = ar.pop<std::string>();
+			const u64 base_size = ar.pop<u64>();
+
+			if (!base_path.empty())
+			{
+				fs::stat_t base_stat{};
+
+				if (!fs::get_stat(base_path, base_stat) || base_stat.size != base_size)
+				{
+					fmt::throw_exception("Incremental savestate base is missing or has changed: '%s' (size=0x%x)", base_path, base_size);
+				}
+
+				snapshot.reader = make_savestate_reader(base_path);
+				snapshot.reader_path = std::move(base_path);
+
+				if (!snapshot.reader)
+				{
+					fmt::throw_exception("Failed to open incremental savestate base: '%s'", snapshot.reader_path);
+				}
+			}
+		}
+
 		const usz shared_size = ar.pop<usz>();
 
 		if (!shared_size || ar.get_size(umax) / 4096 < shared_size)
@@ -2356,7 +2596,7 @@ namespace vm
 
 			// Load binary image
 			// elad335: I'm not proud about it as well.. (ideal situation is to not call map_self())
-			serialize_memory_bytes(ar, shm->map_self(), shm->size());
+			serialize_memory_image(ar, shm->map_self(), shm->size(), 0);
 		}
 
 		for (auto& block : g_locations)
@@ -2377,6 +2617,81 @@ namespace vm
 				loc = std::make_shared<block_t>(ar, shared);
 			}
 		}
+
+		snapshot.reader.reset();
+	}
+
+	void commit_snapshot(const std::string& path)
+	{
+		auto& snapshot = s_snapshot;
+
+		if (path.empty())
+		{
+			// Failed to save: the previous base is still valid
+			snapshot.pending.clear();
+			snapshot.writing_delta = false;
+			return;
+		}
+
+		if (snapshot.writing_delta)
+		{
+			snapshot.delta_count++;
+			snapshot.writing_delta = false;
+			vm_log.success("Saved incremental savestate: %u/%u pages changed since the base", snapshot.dirty_pages, snapshot.total_pages);
+			return;
+		}
+
+		// A full savestate replaces the base, deltas referencing the old one are gone
+		if (!snapshot.base_path.empty())
+		{
+			fs::remove_file(snapshot.base_path);
+		}
+
+		snapshot.base_path.clear();
+		snapshot.base.clear();
+		snapshot.delta_count = 0;
+		snapshot.dirty_pages = 0;
+		snapshot.total_pages = 0;
+
+		if (!g_cfg.savestate.incremental || g_cfg.savestate.suspend_emu || snapshot.pending.empty())
+		{
+			snapshot.pending.clear();
+			return;
+		}
+
+		// Keep the full savestate under another name: the next delta overwrites the original file
+		const std::string base_dir = fs::get_parent_dir(path) + "/base/";
+		const std::string base_path = base_dir + path.substr(path.find_last_of(fs::delim) + 1);
+
+		fs::stat_t base_stat{};
+
+		if (!fs::create_path(base_dir))
+		{
+			vm_log.error("Failed to create incremental savestate directory '%s' (%s)", base_dir, fs::g_tls_error);
+			snapshot.pending.clear();
+			return;
+		}
+
+		fs::remove_file(base_path);
+
+#ifdef _WIN32
+		const bool linked = fs::copy_file(path, base_path, true);
+#else
+		// Hard link: no extra storage until the original is replaced
+		const bool linked = ::link(path.c_str(), base_path.c_str()) == 0 || fs::copy_file(path, base_path, true);
+#endif
+
+		if (!linked || !fs::get_stat(base_path, base_stat))
+		{
+			vm_log.error("Failed to keep incremental savestate base '%s' (%s)", base_path, fs::g_tls_error);
+			snapshot.pending.clear();
+			return;
+		}
+
+		snapshot.base_path = base_path;
+		snapshot.base_size = base_stat.size;
+		snapshot.base = std::move(snapshot.pending);
+		snapshot.pending.clear();
 	}
 
 	u32 get_shm_addr(const std::shared_ptr<utils::shm>& shared)
@@ -375,6 +375,10 @@ namespace vm
 	void load(utils::serial& ar);
 	void save(utils::serial& ar);
 
+	// Called after the savestate written by save() has been committed to path (empty on failure)
+	// With incremental savestates, a full savestate becomes the base of following ones
+	void commit_snapshot(const std::string& path);
+
 	// Returns sample address for shared memory, 0 on failure (wraps block_t::get_shm_addr)
 	u32 get_shm_addr(const std::shared_ptr<utils::shm>& shared);
 
@@ -43,16 +43,29 @@ namespace vm
 		u8 waiters_index = 0;
 	};
 
+	// Waiter variables of one reservation shard, each shard owns a full cache line
+	struct alignas(64) reservation_waiter_shard_t
+	{
+		static constexpr u32 wait_vars_for_each = 8;
+
+		atomic_t<reservation_waiter_t> vars[wait_vars_for_each];
+	};
+
+	static_assert(sizeof(reservation_waiter_shard_t) == 64);
+
+	// Must be a power of 2
+	constexpr u32 reservation_waiter_shards = 1024;
+
 	static inline std::pair<atomic_t<reservation_waiter_t>*, atomic_t<reservation_waiter_t>*> reservation_notifier(u32 raddr)
 	{
-		extern std::array<atomic_t<reservation_waiter_t>, 1024> g_resrv_waiters_count;
-
-		// Storage efficient method to distinguish different nearby addresses (which are likely)
-		constexpr u32 wait_vars_for_each = 8;
-		constexpr u32 unique_address_bit_mask = 0b11;
-		const usz index = std::popcount(raddr & -1024) + ((raddr / 128) & unique_address_bit_mask) * 32;
-		auto& waiter = g_resrv_waiters_count[index * wait_vars_for_each];
-		return {&g_resrv_waiters_count[index * wait_vars_for_each + waiter.load().waiters_index % wait_vars_for_each], &waiter};
+		extern std::array<reservation_waiter_shard_t, reservation_waiter_shards> g_resrv_waiters_count;
+
+		// Fibonacci hash of the 128-byte line index. Neighbouring lines (SPURS lock arrays, queue heads) get distinct shards
+		// and unrelated hot lines rarely collide, so threads spinning on different reservations do not share waiter cache lines.
+		const u32 index = ((raddr / 128) * 0x9e3779b1u) >> (32 - std::countr_zero(reservation_waiter_shards));
+		auto& shard = g_resrv_waiters_count[index];
+		auto& waiter = shard.vars[0];
+		return {&shard.vars[waiter.load().waiters_index % shard.wait_vars_for_each], &waiter};
 	}
 
 	// Returns waiter count and index
@@ -508,7 +521,8 @@ namespace vm
 
 			if constexpr (Ack)
 			{
-				res.notify_all();
+				// Wake threads waiting for a reservation lost event on this line (SPURS kernel idle loop)
+				reservation_notifier_notify(addr);
 			}
 		}
 		else
@@ -518,7 +532,7 @@ namespace vm
 
 			if constexpr (Ack)
 			{
-				res.notify_all();
+				reservation_notifier_notify(addr);
 			}
 
 			return result;
@@ -5,6 +5,7 @@
 #include <mutex>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
 #include "rpcn_client.h"
 #include "util/StrUtil.h"
 #include "util/StrFmt.h"
@@ -923,8 +924,86 @@ namespace rpcn
 		return true;
 	}
 
+	bool rpcn_client::wait_for_socket(s16 events)
+	{
+		for (u32 num_timeouts = 0; num_timeouts <= (RPCN_TIMEOUT / RPCN_TIMEOUT_INTERVAL); num_timeouts++)
+		{
+			if (terminate)
+				return false;
+
+			pollfd poll_fd{};
+			poll_fd.fd = sockfd;
+			poll_fd.events = events;
+#ifdef _WIN32
+			const int res_poll = WSAPoll(&poll_fd, 1, RPCN_TIMEOUT_INTERVAL);
+#else
+			const int res_poll = poll(&poll_fd, 1, RPCN_TIMEOUT_INTERVAL);
+#endif
+			if (res_poll < 0)
+			{
+				rpcn_log.error("wait_for_socket failed with native error: %d", get_native_error());
+				return false;
+			}
+
+			// Errors and hang ups are left for the caller to report
+			if (res_poll > 0)
+				return true;
+		}
+
+		return false;
+	}
+
 	// Connect & disconnect functions
 
+	namespace
+	{
+		// getaddrinfo can't be given a timeout nor be cancelled so it's run on a detached thread,
+		// on a stalled resolver the request is abandoned and freed by whichever side finishes last
+		struct resolve_request
+		{
+			std::mutex mutex;
+			std::condition_variable cond;
+			bool done = false;
+			addrinfo* info = nullptr;
+
+			~resolve_request()
+			{
+				if (info)
+					freeaddrinfo(info);
+			}
+		};
+
+		std::shared_ptr<resolve_request> resolve_host(const std::string& hostname, const atomic_t<bool>& terminate, int timeout_ms, int interval_ms)
+		{
+			auto request = std::make_shared<resolve_request>();
+
+			std::thread([request, hostname]()
+				{
+					addrinfo* info{};
+					if (getaddrinfo(hostname.c_str(), nullptr, nullptr, &info) != 0)
+						info = nullptr;
+
+					std::lock_guard lock(request->mutex);
+					request->info = info;
+					request->done = true;
+					request->cond.notify_one();
+				})
+				.detach();
+
+			std::unique_lock lock(request->mutex);
+
+			for (int waited = 0; !request->done; waited += interval_ms)
+			{
+				if (terminate || waited >= timeout_ms)
+					return nullptr;
+
+				request->cond.wait_for(lock, std::chrono::milliseconds(interval_ms));
+			}
+
+			return request;
+		}
+	} // namespace
+
 	void rpcn_client::disconnect()
 	{
 		if (read_wssl)
@@ -1035,9 +1114,9 @@ namespace rpcn
 			addr_rpcn.sin_port = std::bit_cast<u16, be_t<u16>>(port); // htons
 			addr_rpcn.sin_family = AF_INET;
 
-			addrinfo* addr_info{};
+			const auto resolved = resolve_host(splithost[0], terminate, RPCN_TIMEOUT, RPCN_TIMEOUT_INTERVAL);
 
-			if (getaddrinfo(splithost[0].c_str(), nullptr, nullptr, &addr_info))
+			if (!resolved || !resolved->info)
 			{
 				rpcn_log.error("connect: Failed to getaddrinfo %s", host);
 				state = rpcn_state::failure_resolve;
@@ -1045,7 +1124,7 @@ namespace rpcn
 			}
 
 			bool found_ipv4 = false, found_ipv6 = false;
-			addrinfo* found = addr_info;
+			addrinfo* found = resolved->info;
 
 			while (found != nullptr)
 			{
@@ -1102,15 +1181,7 @@ namespace rpcn
 				return false;
 			}
 
-			if (::connect(sockfd, reinterpret_cast<struct sockaddr*>(&addr_rpcn), sizeof(addr_rpcn)) != 0)
-			{
-				rpcn_log.error("connect: Failed to connect to RPCN server!");
-				state = rpcn_state::failure_connect;
-				return false;
-			}
-
-			rpcn_log.notice("connect: Connection successful");
-
+			// Connect in non blocking mode so an unreachable server fails after RPCN_TIMEOUT instead of the OS timeout
 #ifdef _WIN32
 			u_long _true = 1;
 			ensure(::ioctlsocket(sockfd, FIONBIO, &_true) == 0);
@@ -1118,6 +1189,27 @@ namespace rpcn
 			ensure(::fcntl(sockfd, F_SETFL, ::fcntl(sockfd, F_GETFL, 0) | O_NONBLOCK) == 0);
 #endif
 
+			if (::connect(sockfd, reinterpret_cast<struct sockaddr*>(&addr_rpcn), sizeof(addr_rpcn)) != 0)
+			{
+#ifdef _WIN32
+				const bool in_progress = get_native_error() == WSAEWOULDBLOCK;
+#else
+				const bool in_progress = get_native_error() == EINPROGRESS;
+#endif
+				int so_error = 0;
+				socklen_t so_error_len = sizeof(so_error);
+
+				if (!in_progress || !wait_for_socket(POLLOUT) ||
+					getsockopt(sockfd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&so_error), &so_error_len) != 0 || so_error != 0)
+				{
+					rpcn_log.error("connect: Failed to connect to RPCN server!");
+					state = rpcn_state::failure_connect;
+					return false;
+				}
+			}
+
+			rpcn_log.notice("connect: Connection successful");
+
 			sockaddr_in client_addr;
 			socklen_t client_addr_size = sizeof(client_addr);
 			if (getsockname(sockfd, reinterpret_cast<struct sockaddr*>(&client_addr), &client_addr_size) != 0)
@@ -1138,7 +1230,11 @@ namespace rpcn
 			int ret_connect;
 			while ((ret_connect = wolfSSL_connect(read_wssl)) != SSL_SUCCESS)
 			{
-				if (wolfSSL_want_read(read_wssl) || wolfSSL_want_write(read_wssl))
+				// Wait for the server instead of spinning on the non blocking socket
+				if (wolfSSL_want_read(read_wssl) && wait_for_socket(POLLIN))
+					continue;
+
+				if (wolfSSL_want_write(read_wssl) && wait_for_socket(POLLOUT))
 					continue;
 
 				state = rpcn_state::failure_wolfssl;
@@ -277,6 +277,8 @@ namespace rpcn
 
 		recvn_result recvn(u8* buf, usz n);
 		bool send_packet(const std::vector<u8>& packet);
+		// Waits up to RPCN_TIMEOUT for events on the socket, false on timeout, error or termination
+		bool wait_for_socket(s16 events);
 
 	private:
 		bool connect(const std::string& host);
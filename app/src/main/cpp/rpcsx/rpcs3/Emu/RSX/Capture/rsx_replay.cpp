@@ -2,10 +2,12 @@
 #include "rsx_replay.h"
 
 #include "Emu/System.h"
+#include "Emu/system_config.h"
 #include "Emu/Cell/ErrorCodes.h"
 #include "cellos/sys_rsx.h"
 #include "cellos/sys_memory.h"
 #include "Emu/RSX/RSXThread.h"
+#include "util/File.h"
 
 #include "rx/asm.hpp"
 #include "rx/align.hpp"
@@ -14,6 +16,8 @@
 
 namespace rsx
 {
+	replay_benchmark_settings g_replay_benchmark;
+
 	be_t<u32> rsx_replay_thread::allocate_context()
 	{
 		u32 buffer_size = 4;
@@ -178,8 +182,22 @@ namespace rsx
 
 		auto fifo_stops = alloc_write_fifo(context_id);
 
+		// One-shot, the next boot of a capture replays normally unless configured again
+		const u32 benchmark_iterations = std::exchange(g_replay_benchmark.iterations, 0);
+		const std::string benchmark_output = std::move(g_replay_benchmark.output_path);
+		g_replay_benchmark.output_path.clear();
+
+		if (benchmark_iterations)
+		{
+			benchmark_samples.reserve(benchmark_iterations);
+			get_current_renderer()->request_gpu_timing(true);
+		}
+
 		while (thread_ctrl::state() != thread_state::aborting)
 		{
+			const u64 pass_start = get_system_time();
+			const auto counters_start = get_current_renderer()->get_backend_counters();
+
 			// Load registers while the RSX is still idle
 			method_registers = frame->reg_state;
 			atomic_fence_seq_cst();
@@ -242,10 +260,77 @@ namespace rsx
 				render->request_emu_flip(1u);
 			}
 
+			if (benchmark_iterations && thread_ctrl::state() != thread_state::aborting)
+			{
+				// GPU results arrive a few frames late, so the GPU columns hold whatever frames resolved during this pass
+				const auto counters_end = render->get_backend_counters();
+				benchmark_samples.push_back(
+					{
+						.cpu_time_us = get_system_time() - pass_start,
+						.gpu_time_us = counters_end.gpu_time_us - counters_start.gpu_time_us,
+						.gpu_frames = counters_end.gpu_frames - counters_start.gpu_frames,
+						.pipeline_misses = counters_end.pipeline_misses - counters_start.pipeline_misses,
+						.texture_uploads = counters_end.texture_uploads - counters_start.texture_uploads,
+					});
+
+				if (benchmark_samples.size() >= benchmark_iterations)
+				{
+					render->request_gpu_timing(false);
+					write_benchmark_report(benchmark_output);
+
+					Emu.CallFromMainThread([]()
+						{
+							Emu.GracefulShutdown(false, true);
+						});
+					break;
+				}
+			}
+
 			// random pause to not destroy gpu
 			thread_ctrl::wait_for(10'000);
 		}
 
 		get_current_cpu_thread()->state += (cpu_flag::exit + cpu_flag::wait);
 	}
+
+	void rsx_replay_thread::write_benchmark_report(const std::string& path) const
+	{
+		u64 cpu_total = 0, cpu_max = 0, gpu_total = 0, gpu_frames = 0, pipeline_misses = 0, texture_uploads = 0;
+
+		std::string frames;
+		for (const auto& sample : benchmark_samples)
+		{
+			cpu_total += sample.cpu_time_us;
+			cpu_max = std::max(cpu_max, sample.cpu_time_us);
+			gpu_total += sample.gpu_time_us;
+			gpu_frames += sample.gpu_frames;
+			pipeline_misses += sample.pipeline_misses;
+			texture_uploads += sample.texture_uploads;
+
+			fmt::append(frames, "%s\n    {\"cpu_record_us\": %u, \"gpu_time_us\": %u, \"gpu_frames\": %u, \"pipeline_misses\": %u, \"texture_uploads\": %u}",
+				frames.empty() ? "" : ",", sample.cpu_time_us, sample.gpu_time_us, sample.gpu_frames, sample.pipeline_misses, sample.texture_uploads);
+		}
+
+		const u64 count = std::max<u64>(benchmark_samples.size(), 1);
+		const std::string report = fmt::format(
+			"{\n"
+			"  \"version\": 1,\n"
+			"  \"renderer\": \"%s\",\n"
+			"  \"iterations\": %u,\n"
+			"  \"summary\": {\"cpu_record_us_avg\": %u, \"cpu_record_us_max\": %u, \"gpu_time_us_avg\": %u, \"pipeline_misses\": %u, \"texture_uploads\": %u},\n"
+			"  \"frames\": [%s\n  ]\n"
+			"}\n",
+			g_cfg.video.renderer.to_string(), benchmark_samples.size(),
+			cpu_total / count, cpu_max, gpu_frames ? gpu_total / gpu_frames : 0, pipeline_misses, texture_uploads,
+			frames);
+
+		if (path.empty() || !fs::write_file(path, fs::rewrite, report))
+		{
+			rsx_log.error("Capture Replay: failed to write benchmark report to '%s' (%s)", path, fs::g_tls_error);
+			rsx_log.notice("Capture Replay: benchmark report:\n%s", report);
+			return;
+		}
+
+		rsx_log.success("Capture Replay: benchmark report written to %s", path);
+	}
 } // namespace rsx
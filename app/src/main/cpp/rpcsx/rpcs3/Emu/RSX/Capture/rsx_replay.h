@@ -157,6 +157,16 @@ namespace rsx
 		}
 	};
 
+	// Headless replay benchmark. With a non-zero iteration count the replay stops after that many passes
+	// over the capture and writes a JSON report to output_path. Must be set before the capture is booted, consumed by the replay.
+	struct replay_benchmark_settings
+	{
+		u32 iterations = 0;
+		std::string output_path;
+	};
+
+	extern replay_benchmark_settings g_replay_benchmark;
+
 	class rsx_replay_thread : public cpu_thread
 	{
 		struct rsx_context
@@ -179,9 +189,19 @@ namespace rsx
 			frame_capture_data::tile_state tile_state{};
 		};
 
+		struct benchmark_sample
+		{
+			u64 cpu_time_us;
+			u64 gpu_time_us;
+			u64 gpu_frames;
+			u64 pipeline_misses;
+			u64 texture_uploads;
+		};
+
 		u32 user_mem_addr{};
 		current_state cs{};
 		std::unique_ptr<frame_capture_data> frame;
+		std::vector<benchmark_sample> benchmark_samples;
 
 	public:
 		rsx_replay_thread(std::unique_ptr<frame_capture_data>&& frame_data)
@@ -196,5 +216,6 @@ namespace rsx
 		be_t<u32> allocate_context();
 		std::vector<u32> alloc_write_fifo(be_t<u32> context_id) const;
 		void apply_frame_state(be_t<u32> context_id, const frame_capture_data::replay_command& replay_cmd);
+		void write_benchmark_report(const std::string& path) const;
 	};
 } // namespace rsx
@@ -6,6 +6,10 @@
 #include "util/v128.hpp"
 #include "util/simd.hpp"
 
+#if defined(ARCH_ARM64) && defined(__ARM_FEATURE_SVE2)
+#include <arm_sve.h>
+#endif
+
 #if !defined(_MSC_VER)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -53,6 +57,12 @@
 [[maybe_unused]] constexpr bool s_use_avx3 = false;
 #endif
 
+#if defined(ARCH_ARM64) && defined(__ARM_FEATURE_SVE2)
+[[maybe_unused]] const bool s_use_sve2 = utils::has_sve2();
+#else
+[[maybe_unused]] constexpr bool s_use_sve2 = false;
+#endif
+
 const v128 s_bswap_u32_mask = v128::from32(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f);
 const v128 s_bswap_u16_mask = v128::from32(0x02030001, 0x06070405, 0x0a0b0809, 0x0e0f0c0d);
 
@@ -67,6 +77,122 @@ namespace utils
 
 namespace
 {
+#if defined(ARCH_ARM64)
+	// Byteswapping loads and the shuffles needed by the index kernels, for 128-bit NEON vectors
+	template <typename T>
+	struct neon_index_vec;
+
+	template <>
+	struct neon_index_vec<u16>
+	{
+		using type = uint16x8_t;
+		static constexpr u32 lanes = 8;
+
+		static type load_swapped(const void* src)
+		{
+			return vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(static_cast<const u8*>(src))));
+		}
+
+		static void store(u16* dst, type v) { vst1q_u16(dst, v); }
+		static type dup(u16 v) { return vdupq_n_u16(v); }
+		static type min(type a, type b) { return vminq_u16(a, b); }
+		static type max(type a, type b) { return vmaxq_u16(a, b); }
+		static type cmp_eq(type a, type b) { return vceqq_u16(a, b); }
+		static type or_(type a, type b) { return vorrq_u16(a, b); }
+		static type andn(type a, type mask) { return vbicq_u16(a, mask); }
+		static bool any(type v) { return vmaxvq_u16(v) != 0; }
+		static u16 hmin(type v) { return vminvq_u16(v); }
+		static u16 hmax(type v) { return vmaxvq_u16(v); }
+		static u16 last(type v) { return vgetq_lane_u16(v, 7); }
+
+		// { prev_last, v[0], ..., v[6] }
+		static type shift_in(type prev, type v) { return vextq_u16(prev, v, 7); }
+
+		// Interleaved triangles { a[i], b[i], c[i] }
+		static void store_triangles(u16* dst, type a, type b, type c)
+		{
+			vst3q_u16(dst, uint16x8x3_t{{a, b, c}});
+		}
+
+		// Two quads { 0, 1, 2, 2, 3, 0 } per 4 lanes, 12 indices in total
+		static void store_quads(u16* dst, type v)
+		{
+			static constexpr u8 lo[16] = {0, 1, 2, 3, 4, 5, 4, 5, 6, 7, 0, 1, 8, 9, 10, 11};
+			static constexpr u8 hi[8] = {12, 13, 12, 13, 14, 15, 8, 9};
+			const uint8x16_t bytes = vreinterpretq_u8_u16(v);
+			vst1q_u8(reinterpret_cast<u8*>(dst), vqtbl1q_u8(bytes, vld1q_u8(lo)));
+			vst1_u8(reinterpret_cast<u8*>(dst + 8), vqtbl1_u8(bytes, vld1_u8(hi)));
+		}
+	};
+
+	template <>
+	struct neon_index_vec<u32>
+	{
+		using type = uint32x4_t;
+		static constexpr u32 lanes = 4;
+
+		static type load_swapped(const void* src)
+		{
+			return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(static_cast<const u8*>(src))));
+		}
+
+		static void store(u32* dst, type v) { vst1q_u32(dst, v); }
+		static type dup(u32 v) { return vdupq_n_u32(v); }
+		static type min(type a, type b) { return vminq_u32(a, b); }
+		static type max(type a, type b) { return vmaxq_u32(a, b); }
+		static type cmp_eq(type a, type b) { return vceqq_u32(a, b); }
+		static type or_(type a, type b) { return vorrq_u32(a, b); }
+		static type andn(type a, type mask) { return vbicq_u32(a, mask); }
+		static bool any(type v) { return vmaxvq_u32(v) != 0; }
+		static u32 hmin(type v) { return vminvq_u32(v); }
+		static u32 hmax(type v) { return vmaxvq_u32(v); }
+		static u32 last(type v) { return vgetq_lane_u32(v, 3); }
+
+		// { prev_last, v[0], v[1], v[2] }
+		static type shift_in(type prev, type v) { return vextq_u32(prev, v, 3); }
+
+		// Interleaved triangles { a[i], b[i], c[i] }
+		static void store_triangles(u32* dst, type a, type b, type c)
+		{
+			vst3q_u32(dst, uint32x4x3_t{{a, b, c}});
+		}
+
+		// One quad { 0, 1, 2, 2, 3, 0 }
+		static void store_quads(u32* dst, type v)
+		{
+			static constexpr u8 lo[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 8, 9, 10, 11};
+			static constexpr u8 hi[8] = {12, 13, 14, 15, 0, 1, 2, 3};
+			const uint8x16_t bytes = vreinterpretq_u8_u32(v);
+			vst1q_u8(reinterpret_cast<u8*>(dst), vqtbl1q_u8(bytes, vld1q_u8(lo)));
+			vst1_u8(reinterpret_cast<u8*>(dst + 4), vqtbl1_u8(bytes, vld1_u8(hi)));
+		}
+	};
+
+#if defined(__ARM_FEATURE_SVE2)
+	// Width dependent parts of the SVE kernels, the rest goes through the overloaded ACLE intrinsics
+	template <typename T>
+	struct sve_index_vec;
+
+	template <>
+	struct sve_index_vec<u16>
+	{
+		static u32 lanes() { return static_cast<u32>(svcnth()); }
+		static svbool_t whilelt(u32 i, u32 count) { return svwhilelt_b16(i, count); }
+		static svbool_t all() { return svptrue_b16(); }
+		static svuint16_t dup(u16 v) { return svdup_n_u16(v); }
+	};
+
+	template <>
+	struct sve_index_vec<u32>
+	{
+		static u32 lanes() { return static_cast<u32>(svcntw()); }
+		static svbool_t whilelt(u32 i, u32 count) { return svwhilelt_b32(i, count); }
+		static svbool_t all() { return svptrue_b32(); }
+		static svuint32_t dup(u32 v) { return svdup_n_u32(v); }
+	};
+#endif
+#endif
+
 	template <bool Compare>
 	auto copy_data_swap_u32_naive(u32* dst, const u32* src, u32 count)
 	{
@@ -167,11 +293,102 @@ namespace
 		c.vec_cleanup_ret();
 	}
 #endif
+
+#if defined(ARCH_ARM64)
+	template <bool Compare>
+	auto copy_data_swap_u32_neon(u32* dst, const u32* src, u32 count)
+	{
+		using vec = neon_index_vec<u32>;
+
+		uint32x4_t diff = vdupq_n_u32(0);
+		u32 i = 0;
+
+		for (; i + 4 * vec::lanes <= count; i += 4 * vec::lanes)
+		{
+			for (u32 j = 0; j < 4 * vec::lanes; j += vec::lanes)
+			{
+				const uint32x4_t data = vec::load_swapped(src + i + j);
+
+				if constexpr (Compare)
+				{
+					diff = vorrq_u32(diff, veorq_u32(data, vld1q_u32(dst + i + j)));
+				}
+
+				vec::store(dst + i + j, data);
+			}
+		}
+
+		for (; i + vec::lanes <= count; i += vec::lanes)
+		{
+			const uint32x4_t data = vec::load_swapped(src + i);
+
+			if constexpr (Compare)
+			{
+				diff = vorrq_u32(diff, veorq_u32(data, vld1q_u32(dst + i)));
+			}
+
+			vec::store(dst + i, data);
+		}
+
+		if constexpr (Compare)
+		{
+			const bool tail = copy_data_swap_u32_naive<true>(dst + i, src + i, count - i);
+			return vec::any(diff) || tail;
+		}
+		else
+		{
+			copy_data_swap_u32_naive<false>(dst + i, src + i, count - i);
+		}
+	}
+
+#if defined(__ARM_FEATURE_SVE2)
+	template <bool Compare>
+	auto copy_data_swap_u32_sve2(u32* dst, const u32* src, u32 count)
+	{
+		using vec = sve_index_vec<u32>;
+
+		svbool_t diff = svpfalse_b();
+
+		for (u32 i = 0; i < count; i += vec::lanes())
+		{
+			const svbool_t pg = vec::whilelt(i, count);
+			const svuint32_t data = svrevb_x(pg, svld1(pg, src + i));
+
+			if constexpr (Compare)
+			{
+				diff = svorr_b_z(pg, diff, svcmpne(pg, data, svld1(pg, dst + i)));
+			}
+
+			svst1(pg, dst + i, data);
+		}
+
+		if constexpr (Compare)
+		{
+			return svptest_any(vec::all(), diff);
+		}
+	}
+#endif
+
+	template <bool Compare>
+	auto select_copy_data_swap_u32()
+	{
+#if defined(__ARM_FEATURE_SVE2)
+		if (s_use_sve2)
+		{
+			return &copy_data_swap_u32_sve2<Compare>;
+		}
+#endif
+		return &copy_data_swap_u32_neon<Compare>;
+	}
+#endif
 } // namespace
 
 #if defined(ARCH_X64)
 DECLARE(copy_data_swap_u32) = build_function_asm<void (*)(u32*, const u32*, u32), asmjit::simd_builder>("copy_data_swap_u32", &build_copy_data_swap_u32<false>);
 DECLARE(copy_data_swap_u32_cmp) = build_function_asm<bool (*)(u32*, const u32*, u32), asmjit::simd_builder>("copy_data_swap_u32_cmp", &build_copy_data_swap_u32<true>);
+#elif defined(ARCH_ARM64)
+DECLARE(copy_data_swap_u32) = select_copy_data_swap_u32<false>();
+DECLARE(copy_data_swap_u32_cmp) = select_copy_data_swap_u32<true>();
 #else
 DECLARE(copy_data_swap_u32) = copy_data_swap_u32_naive<false>;
 DECLARE(copy_data_swap_u32_cmp) = copy_data_swap_u32_naive<true>;
@@ -277,6 +494,62 @@ namespace
 		static inline auto upload_xi32 = build_function_asm<u64 (*)(const be_t<u32>*, u32*, u32), asmjit::simd_builder>("untouched_upload_xi32", &build_upload_untouched<u32>);
 #endif
 
+#if defined(ARCH_ARM64)
+		template <typename T>
+		static u64 upload_untouched_neon(const be_t<T>* src, T* dst, u32 count)
+		{
+			using vec = neon_index_vec<T>;
+
+			auto vmin = vec::dup(index_limit<T>());
+			auto vmax = vec::dup(0);
+			u32 i = 0;
+
+			for (; i + vec::lanes <= count; i += vec::lanes)
+			{
+				const auto index = vec::load_swapped(src + i);
+				vmin = vec::min(vmin, index);
+				vmax = vec::max(vmax, index);
+				vec::store(dst + i, index);
+			}
+
+			T min_index = vec::hmin(vmin);
+			T max_index = vec::hmax(vmax);
+
+			for (; i < count; ++i)
+			{
+				T index = src[i];
+				dst[i] = min_max(min_index, max_index, index);
+			}
+
+			return (u64{max_index} << 32) | u64{min_index};
+		}
+
+#if defined(__ARM_FEATURE_SVE2)
+		template <typename T>
+		static u64 upload_untouched_sve2(const be_t<T>* src, T* dst, u32 count)
+		{
+			using vec = sve_index_vec<T>;
+
+			const T* data = reinterpret_cast<const T*>(src);
+			auto vmin = vec::dup(index_limit<T>());
+			auto vmax = vec::dup(0);
+
+			for (u32 i = 0; i < count; i += vec::lanes())
+			{
+				const svbool_t pg = vec::whilelt(i, count);
+				const auto index = svrevb_x(pg, svld1(pg, data + i));
+				vmin = svmin_m(pg, vmin, index);
+				vmax = svmax_m(pg, vmax, index);
+				svst1(pg, dst + i, index);
+			}
+
+			const T min_index = svminv(vec::all(), vmin);
+			const T max_index = svmaxv(vec::all(), vmax);
+			return (u64{max_index} << 32) | u64{min_index};
+		}
+#endif
+#endif
+
 		template <typename T>
 		static std::tuple<T, T, u32> upload_untouched(std::span<to_be_t<const T>> src, std::span<T> dst)
 		{
@@ -289,6 +562,13 @@ namespace
 				r = upload_xi16(src.data(), dst.data(), count);
 			else
 				r = upload_xi32(src.data(), dst.data(), count);
+#elif defined(ARCH_ARM64)
+#if defined(__ARM_FEATURE_SVE2)
+			if (s_use_sve2)
+				r = upload_untouched_sve2(src.data(), dst.data(), count);
+			else
+#endif
+				r = upload_untouched_neon(src.data(), dst.data(), count);
 #else
 			r = upload_untouched_naive(src.data(), dst.data(), count);
 #endif
@@ -384,6 +664,68 @@ namespace
 		static inline auto upload_xi32 = build_function_asm<u64 (*)(const be_t<u32>*, u32*, u32, u32), asmjit::simd_builder>("restart_untouched_upload_xi32", &build_upload_untouched<u32>);
 #endif
 
+#if defined(ARCH_ARM64)
+		template <typename T>
+		static u64 upload_untouched_neon(const be_t<T>* src, T* dst, u32 count, T restart_index)
+		{
+			using vec = neon_index_vec<T>;
+
+			const auto restart = vec::dup(restart_index);
+			auto vmin = vec::dup(index_limit<T>());
+			auto vmax = vec::dup(0);
+			u32 i = 0;
+
+			for (; i + vec::lanes <= count; i += vec::lanes)
+			{
+				// Restart lanes become index_limit, which is neutral for min and is masked out of max
+				const auto index = vec::load_swapped(src + i);
+				const auto is_restart = vec::cmp_eq(index, restart);
+				const auto result = vec::or_(index, is_restart);
+				vmax = vec::max(vmax, vec::andn(index, is_restart));
+				vmin = vec::min(vmin, result);
+				vec::store(dst + i, result);
+			}
+
+			T min_index = vec::hmin(vmin);
+			T max_index = vec::hmax(vmax);
+
+			for (; i < count; ++i)
+			{
+				T index = src[i].value();
+				dst[i] = index == restart_index ? index_limit<T>() : min_max(min_index, max_index, index);
+			}
+
+			return (u64{max_index} << 32) | u64{min_index};
+		}
+
+#if defined(__ARM_FEATURE_SVE2)
+		template <typename T>
+		static u64 upload_untouched_sve2(const be_t<T>* src, T* dst, u32 count, T restart_index)
+		{
+			using vec = sve_index_vec<T>;
+
+			const T* data = reinterpret_cast<const T*>(src);
+			const auto invalid = vec::dup(index_limit<T>());
+			auto vmin = invalid;
+			auto vmax = vec::dup(0);
+
+			for (u32 i = 0; i < count; i += vec::lanes())
+			{
+				const svbool_t pg = vec::whilelt(i, count);
+				const auto index = svrevb_x(pg, svld1(pg, data + i));
+				const svbool_t valid = svcmpne(pg, index, restart_index);
+				vmin = svmin_m(valid, vmin, index);
+				vmax = svmax_m(valid, vmax, index);
+				svst1(pg, dst + i, svsel(valid, index, invalid));
+			}
+
+			const T min_index = svminv(vec::all(), vmin);
+			const T max_index = svmaxv(vec::all(), vmax);
+			return (u64{max_index} << 32) | u64{min_index};
+		}
+#endif
+#endif
+
 		template <typename T>
 		static inline std::tuple<T, T, u32> upload_untouched(std::span<to_be_t<const T>> src, std::span<T> dst, T restart_index)
 		{
@@ -396,6 +738,13 @@ namespace
 				r = upload_xi16(src.data(), dst.data(), count, restart_index);
 			else
 				r = upload_xi32(src.data(), dst.data(), count, restart_index);
+#elif defined(ARCH_ARM64)
+#if defined(__ARM_FEATURE_SVE2)
+			if (s_use_sve2)
+				r = upload_untouched_sve2(src.data(), dst.data(), count, restart_index);
+			else
+#endif
+				r = upload_untouched_neon(src.data(), dst.data(), count, restart_index);
 #else
 			r = upload_untouched_naive(src.data(), dst.data(), count, restart_index);
 #endif
@@ -414,8 +763,45 @@ namespace
 		T max_index = 0;
 		u32 written = 0;
 		u32 length = ::size32(src);
+		u32 i = 0;
+
+#if defined(ARCH_ARM64)
+		using vec = neon_index_vec<T>;
 
-		for (u32 i = written; i < length; ++i)
+		const auto restart = vec::dup(restart_index);
+		auto vmin = vec::dup(index_limit<T>());
+		auto vmax = vec::dup(0);
+
+		// Blocks without a restart index are copied as is, the others are compacted below
+		for (; i + vec::lanes <= length; i += vec::lanes)
+		{
+			const auto index = vec::load_swapped(&src[i]);
+
+			if (vec::any(vec::cmp_eq(index, restart)))
+			{
+				for (u32 j = i; j < i + vec::lanes; ++j)
+				{
+					T value = src[j];
+					if (value != restart_index)
+					{
+						dst[written++] = min_max(min_index, max_index, value);
+					}
+				}
+
+				continue;
+			}
+
+			vmin = vec::min(vmin, index);
+			vmax = vec::max(vmax, index);
+			vec::store(dst.data() + written, index);
+			written += vec::lanes;
+		}
+
+		min_index = std::min<T>(min_index, vec::hmin(vmin));
+		max_index = std::max<T>(max_index, vec::hmax(vmax));
+#endif
+
+		for (; i < length; ++i)
 		{
 			T index = src[i];
 			if (index != restart_index)
@@ -475,8 +861,50 @@ namespace
 		T anchor = invalid_index;
 		T last_index = invalid_index;
 
-		for (const T index : src)
+		const u32 count = ::size32(src);
+
+#if defined(ARCH_ARM64)
+		using vec = neon_index_vec<T>;
+
+		// A u16 restart index above 0xffff never matches
+		const bool test_restart = is_primitive_restart_enabled && primitive_restart_index <= invalid_index;
+		const auto restart = vec::dup(static_cast<T>(primitive_restart_index));
+		const auto invalid = vec::dup(invalid_index);
+		auto vmin = invalid;
+		auto vmax = vec::dup(0);
+#endif
+
+		for (u32 i = 0; i < count;)
 		{
+#if defined(ARCH_ARM64)
+			// Inside a fan, a block of outer indices emits one triangle per lane
+			if (!needs_anchor && last_index != invalid_index && i + vec::lanes <= count)
+			{
+				const auto index = vec::load_swapped(&src[i]);
+
+				// Restart and invalid indices change the fan state, leave those blocks to the scalar path
+				auto special = vec::cmp_eq(index, invalid);
+				if (test_restart)
+				{
+					special = vec::or_(special, vec::cmp_eq(index, restart));
+				}
+
+				if (!vec::any(special))
+				{
+					vmin = vec::min(vmin, index);
+					vmax = vec::max(vmax, index);
+					vec::store_triangles(dst.data() + dst_idx, vec::dup(anchor), vec::shift_in(vec::dup(last_index), index), index);
+
+					dst_idx += 3 * vec::lanes;
+					last_index = vec::last(index);
+					i += vec::lanes;
+					continue;
+				}
+			}
+#endif
+
+			const T index = src[i++];
+
 			if (needs_anchor)
 			{
 				if (is_primitive_restart_enabled && index == primitive_restart_index)
@@ -508,6 +936,11 @@ namespace
 			last_index = index;
 		}
 
+#if defined(ARCH_ARM64)
+		min_index = std::min<T>(min_index, vec::hmin(vmin));
+		max_index = std::max<T>(max_index, vec::hmax(vmax));
+#endif
+
 		return std::make_tuple(min_index, max_index, dst_idx);
 	}
 
@@ -523,8 +956,41 @@ namespace
 		u8 set_size = 0;
 		T tmp_indices[4];
 
-		for (const T index : src)
+		const u32 count = ::size32(src);
+
+#if defined(ARCH_ARM64)
+		using vec = neon_index_vec<T>;
+
+		// A u16 restart index above 0xffff never matches
+		const bool test_restart = is_primitive_restart_enabled && primitive_restart_index <= index_limit<T>();
+		const auto restart = vec::dup(static_cast<T>(primitive_restart_index));
+		auto vmin = vec::dup(index_limit<T>());
+		auto vmax = vec::dup(0);
+#endif
+
+		for (u32 i = 0; i < count;)
 		{
+#if defined(ARCH_ARM64)
+			// Whole quads without a restart index are expanded with a byte shuffle
+			if (set_size == 0 && i + vec::lanes <= count)
+			{
+				const auto index = vec::load_swapped(&src[i]);
+
+				if (!test_restart || !vec::any(vec::cmp_eq(index, restart)))
+				{
+					vmin = vec::min(vmin, index);
+					vmax = vec::max(vmax, index);
+					vec::store_quads(dst.data() + dst_idx, index);
+
+					dst_idx += 6 * vec::lanes / 4;
+					i += vec::lanes;
+					continue;
+				}
+			}
+#endif
+
+			const T index = src[i++];
+
 			if (is_primitive_restart_enabled && index == primitive_restart_index)
 			{
 				// empty temp buffer
@@ -549,6 +1015,11 @@ namespace
 			}
 		}
 
+#if defined(ARCH_ARM64)
+		min_index = std::min<T>(min_index, vec::hmin(vmin));
+		max_index = std::max<T>(max_index, vec::hmax(vmax));
+#endif
+
 		return std::make_tuple(min_index, max_index, dst_idx);
 	}
 } // namespace
@@ -560,6 +560,211 @@ namespace
 		}
 	};
 
+	struct copy_transcoded_bc1_astc_block
+	{
+		// DXT1 blocks are repacked as single-partition ASTC 4x4 blocks with direct LDR endpoints.
+		// 4-color blocks keep their endpoints and 2-bit indices (1/3 steps become 21/64 in ASTC).
+		// 3-color blocks need the exact midpoint and a transparent index, so they use a dual-plane block
+		// with trit weights (0, 1/2, 1) and alpha on the second plane.
+		static constexpr u32 block_mode_4color = 0x042; // 4x4 weight grid, 2-bit weights, single plane
+		static constexpr u32 block_mode_3color = 0x451; // 4x4 weight grid, trit weights, dual plane
+		static constexpr u32 cem_rgb_direct = 8;
+		static constexpr u32 cem_rgba_direct = 12;
+
+		static constexpr std::array<u8, 243> build_trit_encode_table()
+		{
+			// Inverse of the ISE trit block decode, T[7:0] -> 5 trits
+			std::array<u8, 243> table{};
+			for (u32 T = 0; T < 256; T++)
+			{
+				u32 C, t0, t1, t2, t3, t4;
+				if (((T >> 2) & 7) == 7)
+				{
+					C = (((T >> 5) & 7) << 2) | (T & 3);
+					t4 = t3 = 2;
+				}
+				else
+				{
+					C = T & 0x1f;
+					if (((T >> 5) & 3) == 3)
+					{
+						t4 = 2;
+						t3 = (T >> 7) & 1;
+					}
+					else
+					{
+						t4 = (T >> 7) & 1;
+						t3 = (T >> 5) & 3;
+					}
+				}
+
+				if ((C & 3) == 3)
+				{
+					t2 = 2;
+					t1 = (C >> 4) & 1;
+					t0 = (((C >> 3) & 1) << 1) | ((C >> 2) & 1 & ~(C >> 3));
+				}
+				else if (((C >> 2) & 3) == 3)
+				{
+					t2 = t1 = 2;
+					t0 = C & 3;
+				}
+				else
+				{
+					t2 = (C >> 4) & 1;
+					t1 = (C >> 2) & 3;
+					t0 = (((C >> 1) & 1) << 1) | (C & 1 & ~(C >> 1));
+				}
+
+				table[t0 + t1 * 3 + t2 * 9 + t3 * 27 + t4 * 81] = static_cast<u8>(T);
+			}
+			return table;
+		}
+
+		static void write_bits(u8* block, u32 offset, u32 count, u32 value)
+		{
+			for (u32 bit = 0; bit < count; bit++, offset++)
+			{
+				block[offset / 8] |= ((value >> bit) & 1) << (offset % 8);
+			}
+		}
+
+		static void write_weight_bits(u8* block, u32 offset, u32 count, u32 value)
+		{
+			// The weight stream grows down from the top of the block in reversed bit order
+			for (u32 bit = 0; bit < count; bit++, offset++)
+			{
+				const u32 dst = 127 - offset;
+				block[dst / 8] |= ((value >> bit) & 1) << (dst % 8);
+			}
+		}
+
+		static void expand_rgb565(u16 color, u32 (&rgb)[3])
+		{
+			const u32 r = (color >> 11) & 0x1f, g = (color >> 5) & 0x3f, b = color & 0x1f;
+			rgb[0] = (r << 3) | (r >> 2);
+			rgb[1] = (g << 2) | (g >> 4);
+			rgb[2] = (b << 3) | (b >> 2);
+		}
+
+		static void transcode_block(const u8* src, u8* dst)
+		{
+			const u16 color0 = src[0] | (src[1] << 8);
+			const u16 color1 = src[2] | (src[3] << 8);
+			const u32 indices = src[4] | (src[5] << 8) | (src[6] << 16) | (static_cast<u32>(src[7]) << 24);
+
+			u32 e0[3], e1[3];
+			expand_rgb565(color0, e0);
+			expand_rgb565(color1, e1);
+
+			std::memset(dst, 0, 16);
+
+			if (color0 > color1)
+			{
+				// Index order is c0, c1, 2/3c0 + 1/3c1, 1/3c0 + 2/3c1
+				static constexpr u32 weights[4] = {0, 3, 1, 2};
+
+				// CEM 8 blue-contracts and swaps the endpoints unless the second one is brighter
+				const bool swap = (e1[0] + e1[1] + e1[2]) < (e0[0] + e0[1] + e0[2]);
+				const u32* lo = swap ? e1 : e0;
+				const u32* hi = swap ? e0 : e1;
+
+				write_bits(dst, 0, 11, block_mode_4color);
+				write_bits(dst, 13, 4, cem_rgb_direct);
+
+				// 79 endpoint bits select the 8-bit range for the 6 values
+				for (u32 c = 0; c < 3; c++)
+				{
+					write_bits(dst, 17 + c * 16, 8, lo[c]);
+					write_bits(dst, 25 + c * 16, 8, hi[c]);
+				}
+
+				for (u32 texel = 0; texel < 16; texel++)
+				{
+					const u32 weight = weights[(indices >> (texel * 2)) & 3];
+					write_weight_bits(dst, texel * 2, 2, swap ? (3 - weight) : weight);
+				}
+				return;
+			}
+
+			// 57 endpoint bits left by the trit weights select the 7-bit range for the 8 values
+			u32 q0[3], q1[3], sum0 = 0, sum1 = 0;
+			for (u32 c = 0; c < 3; c++)
+			{
+				q0[c] = e0[c] >> 1;
+				q1[c] = e1[c] >> 1;
+				sum0 += (q0[c] << 1) | (q0[c] >> 6);
+				sum1 += (q1[c] << 1) | (q1[c] >> 6);
+			}
+
+			// Endpoint 0 is transparent and endpoint 1 opaque before the swap
+			const bool swap = sum1 < sum0;
+			const u32* lo = swap ? q1 : q0;
+			const u32* hi = swap ? q0 : q1;
+
+			write_bits(dst, 0, 11, block_mode_3color);
+			write_bits(dst, 13, 4, cem_rgba_direct);
+
+			for (u32 c = 0; c < 3; c++)
+			{
+				write_bits(dst, 17 + c * 14, 7, lo[c]);
+				write_bits(dst, 24 + c * 14, 7, hi[c]);
+			}
+			write_bits(dst, 59, 7, swap ? 0x7f : 0);
+			write_bits(dst, 66, 7, swap ? 0 : 0x7f);
+
+			// Plane 2 drives alpha, the component selector sits right below the 52 weight bits
+			write_bits(dst, 128 - 52 - 2, 2, 3);
+
+			// Index order is c0, c1, 1/2c0 + 1/2c1, transparent black. The transparent texels take endpoint 0,
+			// the darker one and the closest color to black on the line, for games that sample DXT1 as opaque.
+			u32 trits[35]{};
+			for (u32 texel = 0; texel < 16; texel++)
+			{
+				const u32 index = (indices >> (texel * 2)) & 3;
+				u32 color_weight = index == 0 ? 0 : index == 1 ? 2 : 1;
+				u32 alpha_weight = 2;
+
+				if (index == 3)
+				{
+					color_weight = 0;
+					alpha_weight = 0;
+				}
+				else if (swap)
+				{
+					color_weight = 2 - color_weight;
+				}
+
+				trits[texel * 2] = color_weight;
+				trits[texel * 2 + 1] = swap ? (2 - alpha_weight) : alpha_weight;
+			}
+
+			// 32 trits, 6 full groups of 8 bits and 2 trits (4 bits) in the last group
+			static constexpr std::array<u8, 243> trit_encode_table = build_trit_encode_table();
+			for (u32 group = 0, offset = 0; group < 7; group++, offset += 8)
+			{
+				const u32* t = &trits[group * 5];
+				const u32 packed = trit_encode_table[t[0] + t[1] * 3 + t[2] * 9 + t[3] * 27 + t[4] * 81];
+				write_weight_bits(dst, offset, group < 6 ? 8 : 4, packed);
+			}
+		}
+
+		static void copy_mipmap_level(std::span<u128> dst, std::span<const u64> src, u16 width_in_block, u32 row_count, u16 depth, u32 dst_pitch_in_block, u32 src_pitch_in_block)
+		{
+			u32 src_offset = 0, dst_offset = 0;
+			for (u32 row = 0; row < row_count * depth; row++)
+			{
+				for (u32 col = 0; col < width_in_block; col++)
+				{
+					transcode_block(reinterpret_cast<const u8*>(&src[src_offset + col]), reinterpret_cast<u8*>(&dst[dst_offset + col]));
+				}
+
+				src_offset += src_pitch_in_block;
+				dst_offset += dst_pitch_in_block;
+			}
+		}
+	};
+
 	namespace
 	{
 		/**
@@ -1015,6 +1220,21 @@ namespace rsx
 
 		case CELL_GCM_TEXTURE_COMPRESSED_DXT1:
 		{
+			if (!caps.supports_dxt && caps.supports_astc_transcode)
+			{
+				// Repack the blocks as ASTC, the host image stays compressed
+				copy_transcoded_bc1_astc_block::copy_mipmap_level(dst_buffer.as_span<u128>(), src_layout.data.as_span<const u64>(), w, h, depth, get_row_pitch_in_block<u128>(w, caps.alignment), src_layout.pitch_in_block);
+				break;
+			}
+
+			if (!caps.supports_dxt && caps.supports_hw_dxt_decode)
+			{
+				// Pack the raw blocks, the uploader decodes them on the GPU
+				result.require_dxt_decode = true;
+				copy_unmodified_block::copy_mipmap_level(dst_buffer.as_span<u64>(), src_layout.data.as_span<const u64>(), 1, w, h, depth, 0, w, src_layout.pitch_in_block);
+				break;
+			}
+
 			if (!caps.supports_dxt)
 			{
 				copy_decoded_bc1_block::copy_mipmap_level(dst_buffer.as_span<u32>(), src_layout.data.as_span<const u64>(), w, h, depth, get_row_pitch_in_block<u32>(w, caps.alignment), src_layout.pitch_in_block);
@@ -1051,6 +1271,13 @@ namespace rsx
 
 		case CELL_GCM_TEXTURE_COMPRESSED_DXT23:
 		{
+			if (!caps.supports_dxt && caps.supports_hw_dxt_decode)
+			{
+				result.require_dxt_decode = true;
+				copy_unmodified_block::copy_mipmap_level(dst_buffer.as_span<u128>(), src_layout.data.as_span<const u128>(), 1, w, h, depth, 0, w, src_layout.pitch_in_block);
+				break;
+			}
+
 			if (!caps.supports_dxt)
 			{
 				copy_decoded_bc2_block::copy_mipmap_level(dst_buffer.as_span<u32>(), src_layout.data.as_span<const u128>(), w, h, depth, get_row_pitch_in_block<u32>(w, caps.alignment), src_layout.pitch_in_block);
@@ -1060,6 +1287,13 @@ namespace rsx
 		}
 		case CELL_GCM_TEXTURE_COMPRESSED_DXT45:
 		{
+			if (!caps.supports_dxt && caps.supports_hw_dxt_decode)
+			{
+				result.require_dxt_decode = true;
+				copy_unmodified_block::copy_mipmap_level(dst_buffer.as_span<u128>(), src_layout.data.as_span<const u128>(), 1, w, h, depth, 0, w, src_layout.pitch_in_block);
+				break;
+			}
+
 			if (!caps.supports_dxt)
 			{
 				copy_decoded_bc3_block::copy_mipmap_level(dst_buffer.as_span<u32>(), src_layout.data.as_span<const u128>(), w, h, depth, get_row_pitch_in_block<u32>(w, caps.alignment), src_layout.pitch_in_block);
@@ -1210,6 +1444,7 @@ namespace rsx
 			return false;
 		// True compressed formats on the host device
 		case CELL_GCM_TEXTURE_COMPRESSED_DXT1:
+			return caps.supports_dxt || caps.supports_astc_transcode;
 		case CELL_GCM_TEXTURE_COMPRESSED_DXT23:
 		case CELL_GCM_TEXTURE_COMPRESSED_DXT45:
 			return caps.supports_dxt;
@@ -218,6 +218,7 @@ namespace rsx
 		bool require_swap;
 		bool require_deswizzle;
 		bool require_upload;
+		bool require_dxt_decode;
 
 		std::vector<memory_transfer_cmd> deferred_cmds;
 	};
@@ -229,6 +230,8 @@ namespace rsx
 		bool supports_hw_deswizzle;
 		bool supports_zero_copy;
 		bool supports_dxt;
+		bool supports_hw_dxt_decode;
+		bool supports_astc_transcode; // DXT1 is uploaded as ASTC 4x4 when BC formats are missing
 		usz alignment;
 	};
 
@@ -88,7 +88,7 @@ namespace rsx
 				auto dst_h = std::get<3>(region);
 
 				// Apply resolution scale if needed
-				if (g_cfg.video.resolution_scale_percent != 100)
+				if (rsx::get_resolution_scale_percent() != 100)
 				{
 					auto src = static_cast<T>(source);
 
@@ -537,7 +537,7 @@ namespace rsx
 			}
 
 			// Apply resolution scale if needed
-			if (g_cfg.video.resolution_scale_percent != 100)
+			if (rsx::get_resolution_scale_percent() != 100)
 			{
 				auto [src_width, src_height] = rsx::apply_resolution_scale<true>(slice.width, slice.height, slice.source->width(), slice.source->height());
 				auto [dst_width, dst_height] = rsx::apply_resolution_scale<true>(slice.width, slice.height, slice.target->width(), slice.target->height());
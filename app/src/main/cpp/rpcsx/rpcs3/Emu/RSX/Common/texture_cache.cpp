@@ -10,6 +10,78 @@ namespace rsx
 		return static_cast<u32>(utils::get_page_size());
 	} // Using runtime page size to adapt to 16K pages on some Android ARM64 devices
 
+	// Largest section that may be switched to hash validation on write-hot pages; the hash is recomputed on every lookup
+	static constexpr u32 max_hot_page_hash_size = 0x10000;
+
+	// Larger sections on write-hot pages hash a sample of every sampled_hash_stride bytes, and all of it every sampled_hash_full_interval checks
+	static constexpr u32 max_hot_page_sampled_size = 0x400000;
+	static constexpr u32 sampled_hash_stride = 0x400;
+	static constexpr u32 sampled_hash_chunk = 0x80;
+	static constexpr u32 sampled_hash_full_interval = 8;
+
+	static inline u64 hash_round(u64 acc, u64 value)
+	{
+		// xxHash64 round, four independent lanes keep the multipliers busy
+		acc += value * 0xC2B2AE3D27D4EB4Full;
+		acc = std::rotl(acc, 31);
+		return acc * 0x9E3779B185EBCA87ull;
+	}
+
+	static u64 hash_memory(usz hash, const char* src, u32 length)
+	{
+		const u32 blocks = length / 32;
+
+		if (blocks)
+		{
+			u64 acc[4] = {hash + 0x60EA27EEADC0B5D6ull, hash + 0xC2B2AE3D27D4EB4Full, hash, hash - 0x9E3779B185EBCA87ull};
+			auto data64 = reinterpret_cast<const u64*>(src);
+
+			for (u32 i = 0; i < blocks; ++i, data64 += 4)
+			{
+				acc[0] = hash_round(acc[0], data64[0]);
+				acc[1] = hash_round(acc[1], data64[1]);
+				acc[2] = hash_round(acc[2], data64[2]);
+				acc[3] = hash_round(acc[3], data64[3]);
+			}
+
+			hash = std::rotl(acc[0], 1) + std::rotl(acc[1], 7) + std::rotl(acc[2], 12) + std::rotl(acc[3], 18);
+			src += blocks * 32;
+			length -= blocks * 32;
+		}
+
+		while (length >= 8)
+		{
+			hash = rpcs3::hash64(hash, *reinterpret_cast<const u64*>(src));
+			src += 8;
+			length -= 8;
+		}
+
+		if (length) [[unlikely]] // Data often aligned to some power of 2
+		{
+			if (length > 4)
+			{
+				hash = rpcs3::hash64(hash, *reinterpret_cast<const u32*>(src));
+				src += 4;
+				length -= 4;
+			}
+
+			if (length > 2)
+			{
+				hash = rpcs3::hash64(hash, *reinterpret_cast<const u16*>(src));
+				src += 2;
+				length -= 2;
+			}
+
+			while (length--)
+			{
+				hash = rpcs3::hash64(hash, *reinterpret_cast<const u8*>(src));
+				src++;
+			}
+		}
+
+		return hash;
+	}
+
 	void buffered_section::init_lockable_range(const address_range& range)
 	{
 		locked_range = range.to_page_range();
@@ -32,11 +104,41 @@ namespace rsx
 
 		init_lockable_range(cpu_range);
 
-		if (memory_range.length() < min_lockable_data_size())
+		if (memory_range.length() < min_lockable_data_size() ||
+			(memory_range.length() <= max_hot_page_hash_size && tex_cache_write_heat.is_hot(locked_range)))
 		{
+			// Sections that need protection::no still get locked in protect()
 			protection_strat = section_protection_strategy::hash;
 			mem_hash = 0;
 		}
+		else if (memory_range.length() <= max_hot_page_sampled_size && tex_cache_write_heat.is_hot(locked_range))
+		{
+			protection_strat = section_protection_strategy::sampled_hash;
+			mem_hash = 0;
+			mem_sampled_hash = 0;
+		}
+	}
+
+	void buffered_section::update_page_index()
+	{
+		const address_range target = locked ? locked_range : address_range{};
+
+		if (target == indexed_range)
+		{
+			return;
+		}
+
+		if (indexed_range.valid())
+		{
+			tex_cache_page_index.remove(indexed_range);
+		}
+
+		if (target.valid())
+		{
+			tex_cache_page_index.add(target);
+		}
+
+		indexed_range = target;
 	}
 
 	void buffered_section::invalidate_range()
@@ -79,6 +181,8 @@ namespace rsx
 		else if (new_prot != utils::protection::rw)
 		{
 			mem_hash = fast_hash_internal();
+			mem_sampled_hash = protection_strat == section_protection_strategy::sampled_hash ? sampled_hash_internal() : 0;
+			sync_count = 0;
 		}
 
 		protection = new_prot;
@@ -89,6 +193,8 @@ namespace rsx
 			// Unprotect range also invalidates secured range
 			confirmed_range.invalidate();
 		}
+
+		update_page_index();
 	}
 
 	void buffered_section::protect(utils::protection prot, const std::pair<u32, u32>& new_confirm)
@@ -123,6 +229,9 @@ namespace rsx
 		}
 
 		protect(prot, confirmed_range != prev_confirmed_range);
+
+		// The nested call returns early when nothing changed
+		update_page_index();
 	}
 
 	void buffered_section::unprotect()
@@ -141,6 +250,8 @@ namespace rsx
 		protection = utils::protection::rw;
 		confirmed_range.invalidate();
 		locked = false;
+
+		update_page_index();
 	}
 
 	const address_range& buffered_section::get_bounds(section_bounds bounds) const
@@ -161,40 +272,25 @@ namespace rsx
 	u64 buffered_section::fast_hash_internal() const
 	{
 		const auto hash_range = confirmed_range.valid() ? confirmed_range : cpu_range;
-		const auto hash_length = hash_range.length();
-		const auto cycles = hash_length / 8;
-		auto rem = hash_length % 8;
+		return hash_memory(rpcs3::fnv_seed, get_ptr<const char>(hash_range.start), hash_range.length());
+	}
 
-		auto src = get_ptr<const char>(hash_range.start);
-		auto data64 = reinterpret_cast<const u64*>(src);
+	u64 buffered_section::sampled_hash_internal() const
+	{
+		const auto hash_range = confirmed_range.valid() ? confirmed_range : cpu_range;
+		const auto hash_length = hash_range.length();
+		const auto src = get_ptr<const char>(hash_range.start);
 
+		// The first chunk of every stride, plus the tail so the last rows are always covered
 		usz hash = rpcs3::fnv_seed;
-		for (unsigned i = 0; i < cycles; ++i)
+		for (u32 offset = 0; offset < hash_length; offset += sampled_hash_stride)
 		{
-			hash = rpcs3::hash64(hash, data64[i]);
+			hash = hash_memory(hash, src + offset, std::min(sampled_hash_chunk, hash_length - offset));
 		}
 
-		if (rem) [[unlikely]] // Data often aligned to some power of 2
+		if (hash_length > sampled_hash_chunk)
 		{
-			src += hash_length - rem;
-
-			if (rem > 4)
-			{
-				hash = rpcs3::hash64(hash, *reinterpret_cast<const u32*>(src));
-				src += 4;
-			}
-
-			if (rem > 2)
-			{
-				hash = rpcs3::hash64(hash, *reinterpret_cast<const u16*>(src));
-				src += 2;
-			}
-
-			while (rem--)
-			{
-				hash = rpcs3::hash64(hash, *reinterpret_cast<const u8*>(src));
-				src++;
-			}
+			hash = hash_memory(hash, src + hash_length - sampled_hash_chunk, sampled_hash_chunk);
 		}
 
 		return hash;
@@ -217,6 +313,23 @@ namespace rsx
 			return true;
 		}
 
-		return (fast_hash_internal() == mem_hash);
+		bool valid;
+
+		if (protection_strat == section_protection_strategy::sampled_hash && ++sync_count % sampled_hash_full_interval)
+		{
+			valid = (sampled_hash_internal() == mem_sampled_hash);
+		}
+		else
+		{
+			valid = (fast_hash_internal() == mem_hash);
+		}
+
+		if (!valid)
+		{
+			// Keep the pages hot while their contents keep changing, a locked replacement would just start faulting again
+			tex_cache_write_heat.record_write(locked_range);
+		}
+
+		return valid;
 	}
 } // namespace rsx
@@ -462,6 +462,7 @@ namespace rsx
 		atomic_t<u32> m_texture_upload_calls_this_frame = {0};
 		atomic_t<u32> m_texture_upload_misses_this_frame = {0};
 		atomic_t<u32> m_texture_copies_ellided_this_frame = {0};
+		atomic_t<u64> m_texture_uploads_total = {0};
 		static const u32 m_predict_max_flushes_per_frame = 50; // Above this number the predictions are disabled
 
 		// Invalidation
@@ -1169,6 +1170,8 @@ namespace rsx
 
 			m_temporary_subresource_cache.clear();
 			m_predictor.on_frame_end();
+			g_sampler_feedback.on_frame_end();
+			tex_cache_write_heat.on_frame_end();
 			reset_frame_statistics();
 		}
 
@@ -1510,7 +1513,15 @@ namespace rsx
 				return {};
 
 			std::lock_guard lock(m_cache_mutex);
-			return invalidate_range_impl_base(cmd, range, cause, on_data_transfer_completed, std::forward<Args>(extras)...);
+			thrashed_set result = invalidate_range_impl_base(cmd, range, cause, on_data_transfer_completed, std::forward<Args>(extras)...);
+
+			if (!cause.is_read() && result.violation_handled && !result.num_flushable)
+			{
+				// Only read-only sections were hit, track pages that keep faulting
+				tex_cache_write_heat.record_fault(address);
+			}
+
+			return result;
 		}
 
 		template <typename... Args>
@@ -2251,6 +2262,14 @@ namespace rsx
 			const bool is_unnormalized = !!(tex.format() & CELL_GCM_TEXTURE_UN);
 			auto extended_dimension = tex.get_extended_texture_dimension();
 
+			if (g_sampler_feedback.enabled()) [[unlikely]]
+			{
+				// LOD is clamped after bias, so min_lod bounds the finest level this draw can touch
+				const u32 finest_mip = std::min(static_cast<u32>(std::max(tex.min_lod(), 0.f)), attributes.mipmaps - 1u);
+				g_sampler_feedback.record(attributes.address, attributes.gcm_format, static_cast<u16>(attributes.width), static_cast<u16>(attributes.height),
+					static_cast<u8>(attributes.mipmaps), static_cast<u8>(finest_mip));
+			}
+
 			options.is_compressed_format = helpers::is_compressed_gcm_format(attributes.gcm_format);
 
 			u32 tex_size = 0, required_surface_height = 1;
@@ -2394,7 +2413,7 @@ namespace rsx
 				// 2. The image has to have been generated on the GPU (fbo or blit target only)
 
 				std::vector<copy_region_descriptor> sections;
-				const bool use_upscaling = (result.upload_context == rsx::texture_upload_context::framebuffer_storage && g_cfg.video.resolution_scale_percent != 100);
+				const bool use_upscaling = (result.upload_context == rsx::texture_upload_context::framebuffer_storage && rsx::get_resolution_scale_percent() != 100);
 
 				if (!helpers::append_mipmap_level(sections, result, attributes, 0, use_upscaling, attributes)) [[unlikely]]
 				{
@@ -2468,6 +2487,7 @@ namespace rsx
 
 			// Do direct upload from CPU as the last resort
 			m_texture_upload_misses_this_frame++;
+			m_texture_uploads_total++;
 
 			const auto subresources_layout = get_subresources_layout(tex);
 			const auto format_class = classify_format(attributes.gcm_format);
@@ -2759,7 +2779,7 @@ namespace rsx
 					surf->template get_surface_height<rsx::surface_metrics::pixels>() != surf->height())
 				{
 					// Must go through a scaling operation due to resolution scaling being present
-					ensure(g_cfg.video.resolution_scale_percent != 100);
+					ensure(rsx::get_resolution_scale_percent() != 100);
 					use_null_region = false;
 				}
 			}
@@ -3538,6 +3558,7 @@ namespace rsx
 			m_texture_upload_calls_this_frame.store(0u);
 			m_texture_upload_misses_this_frame.store(0u);
 			m_texture_copies_ellided_this_frame.store(0u);
+			tex_cache_page_index.reset_statistics();
 		}
 
 		void on_flush()
@@ -3585,6 +3606,16 @@ namespace rsx
 			return m_predictor.m_mispredictions_this_frame;
 		}
 
+		u32 get_num_range_index_lookups() const
+		{
+			return tex_cache_page_index.get_lookups();
+		}
+
+		u32 get_num_range_index_hits() const
+		{
+			return tex_cache_page_index.get_hits();
+		}
+
 		u32 get_num_cache_speculative_writes() const
 		{
 			return m_speculations_this_frame;
@@ -3625,5 +3656,11 @@ namespace rsx
 		{
 			return m_texture_copies_ellided_this_frame;
 		}
+
+		// Uploads from CPU memory since creation, not reset per frame
+		u64 get_texture_uploads_total() const
+		{
+			return m_texture_uploads_total;
+		}
 	};
 } // namespace rsx
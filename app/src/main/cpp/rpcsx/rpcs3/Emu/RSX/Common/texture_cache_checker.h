@@ -1,10 +1,284 @@
 #pragma once
 
-#ifdef TEXTURE_CACHE_DEBUG
-
 #include "../rsx_utils.h"
+#include <bit>
 #include <vector>
 #include "util/vm.hpp"
+#include "util/atomic.hpp"
+#include "util/mutex.h"
+
+namespace rsx
+{
+	/**
+	 * Page granular index of the memory covered by locked sections, used to answer "is anything locked in this range" without walking the sections.
+	 * Level 0 counts the locked sections touching each page, level 1 has one bit per used page and level 2 one bit per non-zero level 1 word.
+	 * Updated from the same protection path as the debug checker below, under the texture cache lock.
+	 */
+	class tex_cache_page_index_t
+	{
+		static constexpr u32 no_page = umax;
+
+		u32 m_page_shift;
+		std::vector<u16> m_refcount;
+		std::vector<u64> m_pages;
+		std::vector<u64> m_words;
+
+		atomic_t<u32> m_lookups = 0;
+		atomic_t<u32> m_hits = 0;
+
+		void set_page(usz page)
+		{
+			const usz word = page / 64;
+			m_pages[word] |= (1ull << (page % 64));
+			m_words[word / 64] |= (1ull << (word % 64));
+		}
+
+		void clear_page(usz page)
+		{
+			const usz word = page / 64;
+			if (!(m_pages[word] &= ~(1ull << (page % 64))))
+			{
+				m_words[word / 64] &= ~(1ull << (word % 64));
+			}
+		}
+
+		u32 find_first_page(usz first, usz last) const
+		{
+			usz word = first / 64;
+			u64 bits = m_pages[word] & (~0ull << (first % 64));
+
+			while (!bits)
+			{
+				// Jump to the next non-empty level 1 word
+				if (++word * 64 > last)
+				{
+					return no_page;
+				}
+
+				usz top = word / 64;
+				u64 top_bits = m_words[top] & (~0ull << (word % 64));
+
+				while (!top_bits)
+				{
+					if (++top * 4096 > last)
+					{
+						return no_page;
+					}
+
+					top_bits = m_words[top];
+				}
+
+				word = top * 64 + std::countr_zero(top_bits);
+				bits = m_pages[word];
+			}
+
+			const usz page = word * 64 + std::countr_zero(bits);
+			return page <= last ? static_cast<u32>(page) : no_page;
+		}
+
+	public:
+		tex_cache_page_index_t()
+		{
+			m_page_shift = static_cast<u32>(std::countr_zero(static_cast<u64>(utils::get_page_size())));
+
+			const usz num_pages = 0x1'0000'0000ull >> m_page_shift;
+			m_refcount.resize(num_pages);
+			m_pages.resize(num_pages / 64);
+			m_words.resize(std::max<usz>(num_pages / 4096, 1));
+		}
+
+		void add(const address_range& range)
+		{
+			AUDIT(range.is_page_range());
+
+			for (usz page = range.start >> m_page_shift, last = range.end >> m_page_shift; page <= last; ++page)
+			{
+				if (m_refcount[page]++ == 0)
+				{
+					set_page(page);
+				}
+
+				ensure(m_refcount[page] != 0); // "Page refcount overflow"
+			}
+		}
+
+		void remove(const address_range& range)
+		{
+			AUDIT(range.is_page_range());
+
+			for (usz page = range.start >> m_page_shift, last = range.end >> m_page_shift; page <= last; ++page)
+			{
+				ensure(m_refcount[page] != 0); // "Page refcount underflow"
+
+				if (--m_refcount[page] == 0)
+				{
+					clear_page(page);
+				}
+			}
+		}
+
+		// First address of the first page in range touched by a locked section, or umax
+		u32 find_first(const address_range& range) const
+		{
+			const u32 page = find_first_page(range.start >> m_page_shift, range.end >> m_page_shift);
+			return page == no_page ? umax : page << m_page_shift;
+		}
+
+		// Same as find_first, counted in the per-frame statistics
+		bool test(const address_range& range)
+		{
+			m_lookups++;
+
+			if (find_first(range) == umax)
+			{
+				return false;
+			}
+
+			m_hits++;
+			return true;
+		}
+
+		u32 get_lookups() const
+		{
+			return m_lookups;
+		}
+
+		u32 get_hits() const
+		{
+			return m_hits;
+		}
+
+		void reset_statistics()
+		{
+			m_lookups.release(0);
+			m_hits.release(0);
+		}
+	};
+
+	extern tex_cache_page_index_t tex_cache_page_index;
+
+	/**
+	 * Per-page count of write faults that hit read-only sections, folded into a "hot" flag at the end of each frame.
+	 * Pages that keep faulting (e.g. streamed vertex data sharing a page with a texture) make new small sections on them use hash validation instead of page locks.
+	 * Heat decays one step per frame once the faults stop, after which the pages go back to mprotect.
+	 */
+	class tex_cache_write_heat_t
+	{
+		static constexpr u8 hot_fault_threshold = 8; // Faults per frame before a page is considered hot
+		static constexpr u8 hot_frames = 60;         // Frames a page stays hot after the last storm
+
+		u32 m_page_shift;
+		std::vector<u8> m_faults;
+		std::vector<u8> m_heat;
+		std::vector<u32> m_touched;
+		atomic_t<u32> m_hot_pages = 0;
+		shared_mutex m_mutex;
+
+	public:
+		tex_cache_write_heat_t()
+		{
+			m_page_shift = static_cast<u32>(std::countr_zero(static_cast<u64>(utils::get_page_size())));
+
+			const usz num_pages = 0x1'0000'0000ull >> m_page_shift;
+			m_faults.resize(num_pages);
+			m_heat.resize(num_pages);
+		}
+
+		// Called from the access violation handler after a write invalidated read-only sections only
+		void record_fault(u32 address)
+		{
+			const u32 page = address >> m_page_shift;
+
+			std::lock_guard lock(m_mutex);
+
+			if (!m_faults[page] && !m_heat[page])
+			{
+				m_touched.push_back(page);
+			}
+
+			if (m_faults[page] != umax)
+			{
+				m_faults[page]++;
+			}
+		}
+
+		// Called when a hash validated section found its contents changed; such pages would fault if locked again
+		void record_write(const address_range& range)
+		{
+			std::lock_guard lock(m_mutex);
+
+			for (usz page = range.start >> m_page_shift, last = range.end >> m_page_shift; page <= last; ++page)
+			{
+				if (!m_faults[page] && !m_heat[page])
+				{
+					m_touched.push_back(static_cast<u32>(page));
+				}
+
+				m_faults[page] = std::max(m_faults[page], hot_fault_threshold);
+			}
+		}
+
+		bool is_hot(const address_range& range)
+		{
+			if (!m_hot_pages)
+			{
+				return false;
+			}
+
+			reader_lock lock(m_mutex);
+
+			for (usz page = range.start >> m_page_shift, last = range.end >> m_page_shift; page <= last; ++page)
+			{
+				if (m_heat[page])
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void on_frame_end()
+		{
+			std::lock_guard lock(m_mutex);
+
+			u32 hot_pages = 0;
+			usz kept = 0;
+
+			for (const u32 page : m_touched)
+			{
+				if (m_faults[page] >= hot_fault_threshold)
+				{
+					m_heat[page] = hot_frames;
+				}
+				else if (m_heat[page])
+				{
+					m_heat[page]--;
+				}
+
+				m_faults[page] = 0;
+
+				if (m_heat[page])
+				{
+					m_touched[kept++] = page;
+					hot_pages++;
+				}
+			}
+
+			m_touched.resize(kept);
+			m_hot_pages.release(hot_pages);
+		}
+
+		u32 get_hot_pages() const
+		{
+			return m_hot_pages;
+		}
+	};
+
+	extern tex_cache_write_heat_t tex_cache_write_heat;
+} // namespace rsx
+
+#ifdef TEXTURE_CACHE_DEBUG
 
 namespace rsx
 {
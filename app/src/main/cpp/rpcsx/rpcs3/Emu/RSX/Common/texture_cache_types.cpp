@@ -33,4 +33,45 @@ namespace rsx
 			m_flag_bits &= ~flags::cause_skips_flush;
 		}
 	}
+
+	sampler_feedback_collector g_sampler_feedback;
+
+	void sampler_feedback_collector::record(u32 address, u32 gcm_format, u16 width, u16 height, u8 mipmaps, u8 finest_mip)
+	{
+		const auto [found, inserted] = m_frame_entries.try_emplace(address, sampled_texture_feedback{address, gcm_format, width, height, mipmaps, finest_mip, 0});
+		if (inserted)
+		{
+			return;
+		}
+
+		auto& entry = found->second;
+		if (entry.gcm_format != gcm_format || entry.width != width || entry.height != height || entry.mipmaps != mipmaps)
+		{
+			// Memory reused for a different image within the frame, the last one wins
+			entry = {address, gcm_format, width, height, mipmaps, finest_mip, 0};
+			return;
+		}
+
+		entry.finest_mip = std::min(entry.finest_mip, finest_mip);
+	}
+
+	void sampler_feedback_collector::on_frame_end()
+	{
+		const auto sink = m_sink.load();
+		if (!sink)
+		{
+			m_frame_entries.clear();
+			return;
+		}
+
+		m_publish_buffer.clear();
+		m_publish_buffer.reserve(m_frame_entries.size());
+		for (const auto& [address, entry] : m_frame_entries)
+		{
+			m_publish_buffer.push_back(entry);
+		}
+		m_frame_entries.clear();
+
+		sink(m_publish_buffer.data(), m_publish_buffer.size());
+	}
 } // namespace rsx
@@ -135,4 +135,48 @@ namespace rsx
 
 		void flag_bits_from_cause(enum_type cause);
 	};
+
+	/**
+	 * Per-frame sampler usage, reported to the frontend texture streamer at frame end
+	 */
+	struct sampled_texture_feedback
+	{
+		u32 address;
+		u32 gcm_format;
+		u16 width;
+		u16 height;
+		u8 mipmaps;
+		u8 finest_mip; // Most detailed level the sampler LOD clamp allows, over all draws this frame
+		u16 reserved;
+	};
+
+	static_assert(sizeof(sampled_texture_feedback) == 16);
+
+	class sampler_feedback_collector
+	{
+	public:
+		using sink_type = void (*)(const sampled_texture_feedback* entries, usz count);
+
+		// Nothing is recorded until the frontend installs a sink
+		bool enabled() const
+		{
+			return !!m_sink.load();
+		}
+
+		void set_sink(sink_type sink)
+		{
+			m_sink.store(sink);
+		}
+
+		// RSX thread only
+		void record(u32 address, u32 gcm_format, u16 width, u16 height, u8 mipmaps, u8 finest_mip);
+		void on_frame_end();
+
+	private:
+		atomic_t<sink_type> m_sink{nullptr};
+		std::unordered_map<u32, sampled_texture_feedback> m_frame_entries;
+		std::vector<sampled_texture_feedback> m_publish_buffer;
+	};
+
+	extern sampler_feedback_collector g_sampler_feedback;
 } // namespace rsx
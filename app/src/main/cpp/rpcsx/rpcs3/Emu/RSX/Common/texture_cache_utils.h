@@ -3,6 +3,7 @@
 #include "Emu/System.h"
 #include "texture_cache_types.h"
 #include "texture_cache_predictor.h"
+#include "texture_cache_checker.h"
 #include "TextureUtils.h"
 
 #include "Emu/Memory/vm.h"
@@ -24,7 +25,8 @@ namespace rsx
 	enum section_protection_strategy
 	{
 		lock,
-		hash
+		hash,
+		sampled_hash // Large sections on write-hot pages: part of the data per check, all of it every few checks
 	};
 
 	static inline void memory_protect(const address_range& range, utils::protection prot)
@@ -799,6 +801,14 @@ namespace rsx
 			explicit range_iterator_tmpl(parent_type& storage, const address_range& _range, section_bounds _bounds, bool _locked_only)
 				: range(_range), bounds(_bounds), block(&storage.block_for(range.start)), unowned_remaining(true), unowned_it(block->unowned_begin()), cur_block_it(block->begin()), locked_only(_locked_only)
 			{
+				// Locked ranges are mirrored in the page index, skip the walk when no locked page intersects the range
+				if (locked_only && bounds == locked_range && !tex_cache_page_index.test(range))
+				{
+					block = nullptr;
+					unowned_remaining = false;
+					return;
+				}
+
 				// do a "fake" iteration to ensure the internal state is consistent
 				next(false);
 			}
@@ -1005,15 +1015,20 @@ namespace rsx
 		address_range locked_range;
 		address_range cpu_range = {};
 		address_range confirmed_range;
+		address_range indexed_range; // Range registered in tex_cache_page_index
 
 		utils::protection protection = utils::protection::rw;
 
 		section_protection_strategy protection_strat = section_protection_strategy::lock;
 		u64 mem_hash = 0;
+		u64 mem_sampled_hash = 0;
+		mutable u32 sync_count = 0;
 
 		bool locked = false;
 		void init_lockable_range(const address_range& range);
+		void update_page_index();
 		u64 fast_hash_internal() const;
+		u64 sampled_hash_internal() const;
 
 	public:
 		buffered_section() = default;
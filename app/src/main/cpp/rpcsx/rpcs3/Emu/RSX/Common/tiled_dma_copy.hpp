@@ -1,7 +1,9 @@
 #pragma once
 
 #include <util/types.hpp>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 // Set this to 1 to force all decoding to be done on the CPU.
 #define DEBUG_DMA_TILING 0
@@ -32,7 +34,8 @@ namespace rsx
 #define RSX_DMA_OP_ENCODE_TILE 0
 #define RSX_DMA_OP_DECODE_TILE 1
 
-	static inline void tiled_dma_copy(const uint32_t row, const uint32_t col, const detiler_config& conf, char* tiled_data, char* linear_data, int direction)
+	// Tiled offset of the texel at (row, col) relative to the data base address, umax if it is outside the tile
+	static inline uint32_t get_tiled_data_offset(const uint32_t row, const uint32_t col, const detiler_config& conf)
 	{
 		const uint32_t row_offset = (row * conf.tile_pitch) + conf.tile_base_address + conf.tile_address_offset;
 		const uint32_t this_address = row_offset + (col * conf.image_bpp);
@@ -102,14 +105,25 @@ namespace rsx
 		tile_address ^= (((tile_address >> 12) ^ ((bank_selector ^ tile_selector) & 1) ^ (tile_address >> 14)) & 1) << 9;
 		tile_address ^= ((tile_address >> 11) & 1) << 10;
 
-		// Calculate relative addresses and sample
-		const uint32_t linear_image_offset = (row * conf.image_pitch) + (col * conf.image_bpp);
-		const uint32_t tile_base_offset = tile_address - conf.tile_base_address;  // Distance from tile base address
-		const uint32_t tile_data_offset = tile_base_offset - conf.tile_rw_offset; // Distance from data base address
+		// Calculate relative addresses
+		const uint32_t tile_base_offset = tile_address - conf.tile_base_address; // Distance from tile base address
 
 		if (tile_base_offset >= conf.tile_size)
 		{
 			// Do not touch anything out of bounds
+			return umax;
+		}
+
+		return tile_base_offset - conf.tile_rw_offset; // Distance from data base address
+	}
+
+	static inline void tiled_dma_copy(const uint32_t row, const uint32_t col, const detiler_config& conf, char* tiled_data, char* linear_data, int direction)
+	{
+		const uint32_t linear_image_offset = (row * conf.image_pitch) + (col * conf.image_bpp);
+		const uint32_t tile_data_offset = get_tiled_data_offset(row, col, conf);
+
+		if (tile_data_offset == umax)
+		{
 			return;
 		}
 
@@ -170,18 +184,69 @@ namespace rsx
 			.image_pitch = row_pitch_in_bytes,
 			.image_bpp = sizeof(T)};
 
+		char* tiled_data = Decode ? src2 : dst2;
+		char* linear_data = Decode ? dst2 : src2;
+
+		if (base_address % 32)
+		{
+			// Unaligned base, the 32-byte runs below do not hold
+			for (u16 row = 0; row < image_height; ++row)
+			{
+				for (u16 col = 0; col < image_width; ++col)
+				{
+					tiled_dma_copy(row, col, dconf, tiled_data, linear_data, op);
+				}
+			}
+
+			return;
+		}
+
+		// Address bits [4:0] pass through the tiling unchanged, so each aligned 32-byte run of a row stays contiguous in tiled memory.
+		// The address is computed once per run and the run is moved with a single copy.
 		for (u16 row = 0; row < image_height; ++row)
 		{
-			for (u16 col = 0; col < image_width; ++col)
+			const uint32_t row_address = (row * dconf.tile_pitch) + dconf.tile_base_address + dconf.tile_address_offset;
+
+			for (u32 col = 0; col < image_width;)
 			{
-				if constexpr (op == RSX_DMA_OP_DECODE_TILE)
+				const uint32_t this_address = row_address + (col * dconf.image_bpp);
+				const u32 run_length = std::min<u32>(image_width - col, (32 - (this_address % 32)) / dconf.image_bpp);
+
+				if (run_length == 0)
 				{
-					tiled_dma_copy(row, col, dconf, src2, dst2, op);
+					// Texel straddles a run boundary
+					tiled_dma_copy(row, col, dconf, tiled_data, linear_data, op);
+					col++;
+					continue;
+				}
+
+				const uint32_t first = get_tiled_data_offset(row, col, dconf);
+				const uint32_t last = get_tiled_data_offset(row, col + run_length - 1, dconf);
+
+				if (first == umax || last == umax)
+				{
+					// Crosses the end of the tile, take it one texel at a time
+					for (u32 i = 0; i < run_length; ++i)
+					{
+						tiled_dma_copy(row, col + i, dconf, tiled_data, linear_data, op);
+					}
 				}
 				else
 				{
-					tiled_dma_copy(row, col, dconf, dst2, src2, op);
+					const uint32_t linear_offset = (row * dconf.image_pitch) + (col * dconf.image_bpp);
+					const usz run_bytes = run_length * dconf.image_bpp;
+
+					if constexpr (op == RSX_DMA_OP_DECODE_TILE)
+					{
+						std::memcpy(linear_data + linear_offset, tiled_data + first, run_bytes);
+					}
+					else
+					{
+						std::memcpy(tiled_data + first, linear_data + linear_offset, run_bytes);
+					}
 				}
+
+				col += run_length;
 			}
 		}
 	}
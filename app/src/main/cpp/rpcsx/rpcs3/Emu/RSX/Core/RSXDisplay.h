@@ -65,6 +65,40 @@ namespace rsx
 		framebuffer_statistics_t framebuffer_stats;
 	};
 
+	// Running totals kept by the backend, sampled around a frame by the capture replay benchmark
+	struct backend_counters_t
+	{
+		u64 pipeline_misses;  // Pipeline lookups that had to compile
+		u64 texture_uploads;  // Texture cache upload calls
+		u64 gpu_time_us;      // GPU busy time of the frames measured so far
+		u64 gpu_frames;       // Number of frames included in gpu_time_us
+		u64 device_memory_bytes;  // Device-local allocations, sampled at the last frame boundary
+		u64 texture_memory_bytes; // Texture cache share of device_memory_bytes
+	};
+
+	enum class gpu_cost_kind : u8
+	{
+		render_pass, // One render target configuration, keyed by renderpass key
+		compute,     // One compute task, keyed by shader source
+		pipeline,    // Graphics shader pair, share of its render passes by draw count
+	};
+
+	// GPU time attributed to one render pass, compute task or pipeline over a frame.
+	// Passed to the frontend as is, keep the layout stable.
+	struct gpu_cost_entry
+	{
+		u64 key;          // Renderpass key or shader hash, 0 for passes not created through the renderpass cache
+		f32 gpu_time_ms;
+		u16 count;        // Passes, dispatches or draws
+		u16 width;        // Render area, render passes only
+		u16 height;
+		gpu_cost_kind kind;
+		u8 reserved;
+		u32 reserved2;
+	};
+
+	static_assert(sizeof(gpu_cost_entry) == 24);
+
 	struct frame_time_t
 	{
 		u64 preempt_count;
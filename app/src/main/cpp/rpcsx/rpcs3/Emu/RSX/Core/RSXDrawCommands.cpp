@@ -331,10 +331,13 @@ namespace rsx
 		{
 			for (const auto& block : layout.interleaved_blocks)
 			{
+				// Individually cached blocks sit anywhere in the window
+				const u32 block_offset = (block->window_offset != umax) ? (persistent_offset_base + block->window_offset) : persistent_offset;
+
 				for (const auto& attrib : block->locations)
 				{
 					const u32 local_address = (REGS(m_ctx)->vertex_arrays_info[attrib.index].offset() & 0x7fffffff);
-					offset_in_block[attrib.index] = persistent_offset + (local_address - block->base_offset);
+					offset_in_block[attrib.index] = block_offset + (local_address - block->base_offset);
 				}
 
 				const auto range = block->calculate_required_range(first_vertex, vertex_count);
@@ -63,6 +63,7 @@ namespace rsx
 		u8 memory_location = 0;
 		u8 attribute_stride = 0;
 		std::pair<u32, u32> vertex_range{};
+		u32 window_offset = umax; // Offset in the persistent window when not packed after the previous block
 
 		rsx::simple_array<interleaved_attribute_t> locations;
 
@@ -103,6 +104,7 @@ namespace rsx
 			result->locations.clear();
 			result->interleaved = true;
 			result->vertex_range.second = 0;
+			result->window_offset = umax;
 			return result;
 		}
 
@@ -40,6 +40,11 @@ u64 GLGSRender::get_cycles()
 	return thread_ctrl::get_cycles(static_cast<named_thread<GLGSRender>&>(*this));
 }
 
+u64 GLGSRender::get_cpu_time() const
+{
+	return thread_ctrl::get_cpu_time(static_cast<const named_thread<GLGSRender>&>(*this));
+}
+
 GLGSRender::GLGSRender(utils::serial* ar) noexcept : GSRender(ar)
 {
 	m_shaders_cache = std::make_unique<gl::shader_cache>(m_prog_buffer, "opengl", "v1.95");
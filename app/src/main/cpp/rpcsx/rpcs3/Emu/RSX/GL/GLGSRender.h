@@ -157,6 +157,7 @@ class GLGSRender : public GSRender, public ::rsx::reports::ZCULL_control
 
 public:
 	u64 get_cycles() final;
+	u64 get_cpu_time() const final;
 
 	GLGSRender(utils::serial* ar) noexcept;
 	GLGSRender() noexcept : GLGSRender(nullptr) {}
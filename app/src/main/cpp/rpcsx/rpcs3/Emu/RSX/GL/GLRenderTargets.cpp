@@ -446,7 +446,7 @@ void gl::render_target::load_memory(gl::command_context& cmd)
 	subres.data = {vm::get_super_ptr<const std::byte>(base_addr), static_cast<std::span<const std::byte>::size_type>(rsx_pitch * surface_height * samples_y)};
 
 	// TODO: MSAA support
-	if (g_cfg.video.resolution_scale_percent == 100 && spp == 1) [[likely]]
+	if (rsx::get_resolution_scale_percent() == 100 && spp == 1) [[likely]]
 	{
 		gl::upload_texture(cmd, this, get_gcm_format(), is_swizzled, {subres});
 	}
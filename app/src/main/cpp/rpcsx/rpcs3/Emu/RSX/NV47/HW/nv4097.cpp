@@ -116,10 +116,15 @@ namespace rsx
 				rcount = ::size32(fifo_span);
 			}
 
+			// Written vec4 registers, so the backend can keep its upload if the bound program reads none of them
+			const u32 first_constant = load + constant_id;
+			const u32 constant_count = (subreg + rcount + 3) / 4;
+
 			if (RSX(ctx)->m_graphics_state & rsx::pipeline_state::transform_constants_dirty)
 			{
 				// Minor optimization: don't compare values if we already know we need invalidation
 				copy_data_swap_u32(values, fifo_span.data(), rcount);
+				RSX(ctx)->mark_transform_constants_dirty_range(first_constant, constant_count);
 			}
 			else
 			{
@@ -127,6 +132,7 @@ namespace rsx
 				{
 					// Transform constants invalidation is expensive (~8k bytes per update)
 					RSX(ctx)->m_graphics_state |= rsx::pipeline_state::transform_constants_dirty;
+					RSX(ctx)->mark_transform_constants_dirty_range(first_constant, constant_count);
 				}
 			}
 
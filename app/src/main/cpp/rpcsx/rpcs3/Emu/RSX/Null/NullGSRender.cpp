@@ -6,6 +6,11 @@ u64 NullGSRender::get_cycles()
 	return thread_ctrl::get_cycles(static_cast<named_thread<NullGSRender>&>(*this));
 }
 
+u64 NullGSRender::get_cpu_time() const
+{
+	return thread_ctrl::get_cpu_time(static_cast<const named_thread<NullGSRender>&>(*this));
+}
+
 NullGSRender::NullGSRender(utils::serial* ar) noexcept : GSRender(ar)
 {
 }
@@ -5,6 +5,7 @@ class NullGSRender : public GSRender
 {
 public:
 	u64 get_cycles() final;
+	u64 get_cpu_time() const final;
 
 	NullGSRender(utils::serial* ar) noexcept;
 	NullGSRender() noexcept : NullGSRender(nullptr) {}
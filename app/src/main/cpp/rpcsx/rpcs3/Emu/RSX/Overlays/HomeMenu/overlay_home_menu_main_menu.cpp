@@ -7,6 +7,7 @@
 #include "Emu/RSX/Overlays/Trophies/overlay_trophy_list_dialog.h"
 #include "Emu/RSX/Overlays/overlay_manager.h"
 #include "Emu/System.h"
+#include "Emu/CPU/CPUThread.h"
 #include "Emu/system_config.h"
 #include "rpcsx/fw/ps3/sceNpTrophy.h"
 
@@ -117,6 +118,20 @@ namespace rsx
 					return page_navigation::exit;
 				});
 
+			if (g_cfg.core.spu_prof || g_cfg.core.ppu_prof)
+			{
+				std::unique_ptr<overlay_element> profiler_report = std::make_unique<home_menu_entry>(get_localized_string(localized_string_id::HOME_MENU_PROFILER_REPORT));
+				add_item(profiler_report, [](pad_button btn) -> page_navigation
+					{
+						if (btn != pad_button::cross)
+							return page_navigation::stay;
+
+						rsx_log.notice("User selected profiler report in home menu");
+						cpu_thread::flush_profilers();
+						return page_navigation::exit;
+					});
+			}
+
 			add_page(std::make_shared<home_menu_savestate>(x, y, width, height, use_separators, this));
 
 			std::unique_ptr<overlay_element> restart = std::make_unique<home_menu_entry>(get_localized_string(localized_string_id::HOME_MENU_RESTART));
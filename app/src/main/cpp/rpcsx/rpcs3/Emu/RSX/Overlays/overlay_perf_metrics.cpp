@@ -334,6 +334,59 @@ namespace rsx
 			m_force_repaint = true;
 		}
 
+		void perf_metrics_overlay::set_gpu_cost_breakdown_enabled(bool enabled)
+		{
+			if (m_gpu_cost_breakdown_enabled == enabled)
+				return;
+
+			m_gpu_cost_breakdown_enabled = enabled;
+			m_gpu_costs.clear();
+
+			m_force_repaint = true;
+		}
+
+		void perf_metrics_overlay::append_gpu_costs(std::string& perf_text) const
+		{
+			constexpr u32 max_lines = 4;
+
+			// Entries come sorted by kind, then by cost
+			u32 passes = 0;
+			u32 pipelines = 0;
+
+			for (const auto& entry : m_gpu_costs)
+			{
+				switch (entry.kind)
+				{
+				case gpu_cost_kind::render_pass:
+				case gpu_cost_kind::compute:
+				{
+					if (passes++ >= max_lines)
+						break;
+
+					if (passes == 1)
+						fmt::append(perf_text, "\n\nGPU Passes (ms):");
+
+					if (entry.kind == gpu_cost_kind::compute)
+						fmt::append(perf_text, "\n CS %08x     : %05.2f (%u)", static_cast<u32>(entry.key), entry.gpu_time_ms, entry.count);
+					else
+						fmt::append(perf_text, "\n RP %4ux%-4u %04x : %05.2f (%u)", entry.width, entry.height, static_cast<u16>(entry.key), entry.gpu_time_ms, entry.count);
+					break;
+				}
+				case gpu_cost_kind::pipeline:
+				{
+					if (pipelines++ >= max_lines)
+						break;
+
+					if (pipelines == 1)
+						fmt::append(perf_text, "\n\nGPU Pipelines (ms, est.):");
+
+					fmt::append(perf_text, "\n PL %016llx : %05.2f (%u)", entry.key, entry.gpu_time_ms, entry.count);
+					break;
+				}
+				}
+			}
+		}
+
 		void perf_metrics_overlay::set_detail_level(detail_level level)
 		{
 			if (m_detail == level)
@@ -514,6 +567,11 @@ namespace rsx
 					}
 					case detail_level::none:
 					{
+						if (m_gpu_cost_breakdown_enabled)
+						{
+							m_gpu_costs = rsx_thread.get_gpu_cost_breakdown();
+						}
+
 						m_fps = std::max(0.f, static_cast<f32>(m_frames / (elapsed_update / 1000)));
 						if (m_is_initialised && m_framerate_graph_enabled)
 						{
@@ -572,6 +630,11 @@ namespace rsx
 				}
 				}
 
+				if (m_gpu_cost_breakdown_enabled && m_detail != detail_level::none)
+				{
+					append_gpu_costs(perf_text);
+				}
+
 				m_body.set_text(perf_text);
 
 				if (perf_text.empty())
@@ -905,6 +968,7 @@ namespace rsx
 					perf_overlay->set_frametime_datapoint_count(perf_settings.frametime_datapoint_count);
 					perf_overlay->set_framerate_graph_enabled(perf_settings.framerate_graph_enabled.get());
 					perf_overlay->set_frametime_graph_enabled(perf_settings.frametime_graph_enabled.get());
+					perf_overlay->set_gpu_cost_breakdown_enabled(perf_settings.gpu_cost_breakdown.get());
 					perf_overlay->set_graph_detail_levels(perf_settings.framerate_graph_detail_level.get(), perf_settings.frametime_graph_detail_level.get());
 					perf_overlay->init();
 				}
@@ -3,6 +3,7 @@
 #include "overlays.h"
 #include "util/cpu_stats.hpp"
 #include "Emu/system_config_types.h"
+#include "Emu/RSX/Core/RSXDisplay.h"
 
 namespace rsx
 {
@@ -27,6 +28,7 @@ namespace rsx
 
 			bool m_framerate_graph_enabled{};
 			bool m_frametime_graph_enabled{};
+			bool m_gpu_cost_breakdown_enabled{};
 			graph m_fps_graph;
 			graph m_frametime_graph;
 
@@ -78,6 +80,10 @@ namespace rsx
 			f32 m_rsx_usage{0};
 			u32 m_rsx_load{0};
 
+			// Most expensive passes and pipelines of the last GPU-measured frame
+			std::vector<gpu_cost_entry> m_gpu_costs;
+
+			void append_gpu_costs(std::string& perf_text) const;
 			void reset_transform(label& elm) const;
 			void reset_transforms();
 			void reset_body();
@@ -88,6 +94,7 @@ namespace rsx
 
 			void set_framerate_graph_enabled(bool enabled);
 			void set_frametime_graph_enabled(bool enabled);
+			void set_gpu_cost_breakdown_enabled(bool enabled);
 			void set_framerate_datapoint_count(u32 datapoint_count);
 			void set_frametime_datapoint_count(u32 datapoint_count);
 			void set_graph_detail_levels(perf_graph_detail_level framerate_level, perf_graph_detail_level frametime_level);
@@ -0,0 +1,156 @@
+R"(
+#version 450
+
+#define SSBO_LOCATION(x) (x + %loc)
+#define DXT_FORMAT %_format
+
+layout(local_size_x = %ws, local_size_y = 1, local_size_z = 1) in;
+
+layout(%set, binding=SSBO_LOCATION(0), std430) buffer ssbo0{ uint data_in[]; };
+layout(%set, binding=SSBO_LOCATION(1), std430) buffer ssbo1{ uint data_out[]; };
+layout(%push_block) uniform parameters
+{
+	uint width_in_blocks;
+	uint block_rows;
+	uint dst_pitch;
+};
+
+uint pack_rgba8(const in uvec3 rgb, const in uint a)
+{
+	return rgb.r | (rgb.g << 8) | (rgb.b << 16) | (a << 24);
+}
+
+uvec3 expand_rgb565(const in uint c)
+{
+	return uvec3(
+		(((c >> 11) & 0x1F) * 527 + 23) >> 6,
+		(((c >> 5) & 0x3F) * 259 + 33) >> 6,
+		((c & 0x1F) * 527 + 23) >> 6);
+}
+
+void decode_color_palette(const in uint endpoints, const in bool opaque_only, out uint palette[4])
+{
+	const uint c0 = endpoints & 0xFFFF;
+	const uint c1 = endpoints >> 16;
+	const uvec3 rgb0 = expand_rgb565(c0);
+	const uvec3 rgb1 = expand_rgb565(c1);
+
+	palette[0] = pack_rgba8(rgb0, 0xFF);
+	palette[1] = pack_rgba8(rgb1, 0xFF);
+
+	if (c0 > c1 || opaque_only)
+	{
+		palette[2] = pack_rgba8((rgb0 * 2 + rgb1 + 1) / 3, 0xFF);
+		palette[3] = pack_rgba8((rgb0 + rgb1 * 2 + 1) / 3, 0xFF);
+	}
+	else
+	{
+		// 3-color mode with transparent black
+		palette[2] = pack_rgba8((rgb0 + rgb1 + 1) / 2, 0xFF);
+		palette[3] = 0;
+	}
+}
+
+#if DXT_FORMAT == 3
+void decode_alpha_palette(const in uint endpoints, out uint palette[8])
+{
+	const uint a0 = endpoints & 0xFF;
+	const uint a1 = (endpoints >> 8) & 0xFF;
+
+	palette[0] = a0;
+	palette[1] = a1;
+
+	if (a0 > a1)
+	{
+		for (uint i = 1; i < 7; ++i)
+		{
+			palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+		}
+	}
+	else
+	{
+		for (uint i = 1; i < 5; ++i)
+		{
+			palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+		}
+
+		palette[6] = 0;
+		palette[7] = 0xFF;
+	}
+}
+
+uint get_alpha_index(const in uint lo, const in uint hi, const in uint texel)
+{
+	// 48 bits of 3-bit indices split across two words
+	const uint bit = texel * 3;
+	if (bit >= 32)
+	{
+		return (hi >> (bit - 32)) & 7;
+	}
+
+	if (bit > 29)
+	{
+		return ((lo >> bit) | (hi << (32 - bit))) & 7;
+	}
+
+	return (lo >> bit) & 7;
+}
+#endif
+
+void main()
+{
+	uint invocations_x = (gl_NumWorkGroups.x * gl_WorkGroupSize.x);
+	uint block_id = (gl_GlobalInvocationID.y * invocations_x) + gl_GlobalInvocationID.x;
+
+	if (block_id >= (width_in_blocks * block_rows))
+		return;
+
+	uint block_x = (block_id % width_in_blocks);
+	uint block_y = (block_id / width_in_blocks);
+	uint dst_id = (block_y * 4 * dst_pitch) + (block_x * 4);
+
+	uint color_palette[4];
+
+#if DXT_FORMAT == 1
+	uint src_id = block_id * 2;
+	decode_color_palette(data_in[src_id], false, color_palette);
+	uint color_bits = data_in[src_id + 1];
+#else
+	uint src_id = block_id * 4;
+	uint alpha_lo = data_in[src_id];
+	uint alpha_hi = data_in[src_id + 1];
+	decode_color_palette(data_in[src_id + 2], true, color_palette);
+	uint color_bits = data_in[src_id + 3];
+#endif
+
+#if DXT_FORMAT == 3
+	uint alpha_palette[8];
+	decode_alpha_palette(alpha_lo, alpha_palette);
+	uint alpha_index_lo = (alpha_lo >> 16) | (alpha_hi << 16);
+	uint alpha_index_hi = (alpha_hi >> 16);
+#endif
+
+	for (uint row = 0; row < 4; ++row)
+	{
+		for (uint col = 0; col < 4; ++col)
+		{
+			uint texel = (row * 4) + col;
+			uint value = color_palette[(color_bits >> (texel * 2)) & 3];
+
+#if DXT_FORMAT == 2
+			// Explicit 4-bit alpha
+			uint alpha_word = (texel < 8) ? alpha_lo : alpha_hi;
+			uint alpha = ((alpha_word >> ((texel & 7) * 4)) & 0xF) * 17;
+			value = (value & 0x00FFFFFF) | (alpha << 24);
+#elif DXT_FORMAT == 3
+			uint alpha = alpha_palette[get_alpha_index(alpha_index_lo, alpha_index_hi, texel)];
+			value = (value & 0x00FFFFFF) | (alpha << 24);
+#endif
+
+			data_out[dst_id + col] = value;
+		}
+
+		dst_id += dst_pitch;
+	}
+}
+)"
@@ -418,25 +418,30 @@ vertex_program_utils::vertex_program_metadata vertex_program_utils::analyse_vert
 	}
 
 	result.referenced_inputs_mask |= 1u; // VPOS is always enabled, else no rendering can happen
+	dst_prog.ucode_generation++;
 	return result;
 }
 
 usz vertex_program_storage_hash::operator()(const RSXVertexProgram& program) const
 {
-#ifdef ARCH_X64
-	usz ucode_hash;
-
-	if (utils::has_avx512_icl())
+	if (program.ucode_hash_generation != program.ucode_generation)
 	{
-		ucode_hash = get_vertex_program_ucode_hash_512(program);
-	}
-	else
-	{
-		ucode_hash = vertex_program_utils::get_vertex_program_ucode_hash(program);
-	}
+#ifdef ARCH_X64
+		if (utils::has_avx512_icl())
+		{
+			program.ucode_hash = get_vertex_program_ucode_hash_512(program);
+		}
+		else
+		{
+			program.ucode_hash = vertex_program_utils::get_vertex_program_ucode_hash(program);
+		}
 #else
-	const usz ucode_hash = vertex_program_utils::get_vertex_program_ucode_hash(program);
+		program.ucode_hash = vertex_program_utils::get_vertex_program_ucode_hash(program);
 #endif
+		program.ucode_hash_generation = program.ucode_generation;
+	}
+
+	const usz ucode_hash = program.ucode_hash;
 	const u32 state_params[] =
 		{
 			program.ctrl,
@@ -724,7 +729,13 @@ usz fragment_program_utils::get_fragment_program_ucode_hash(const RSXFragmentPro
 
 usz fragment_program_storage_hash::operator()(const RSXFragmentProgram& program) const
 {
-	const usz ucode_hash = fragment_program_utils::get_fragment_program_ucode_hash(program);
+	if (program.ucode_hash_generation != program.ucode_generation)
+	{
+		program.ucode_hash = fragment_program_utils::get_fragment_program_ucode_hash(program);
+		program.ucode_hash_generation = program.ucode_generation;
+	}
+
+	const usz ucode_hash = program.ucode_hash;
 	const u32 state_params[] =
 		{
 			program.ctrl,
@@ -5,6 +5,7 @@
 
 #include "util/mutex.h"
 #include "util/logs.hpp"
+#include "util/Thread.h"
 #include "util/fnv_hash.hpp"
 #include "util/v128.hpp"
 #include <util/bless.hpp>
@@ -154,6 +155,8 @@ namespace rsx
  * - static void recompile_vertex_program(RSXVertexProgram *RSXVP, VertexProgramData& vertexProgramData, usz ID);
  * - static PipelineData build_program(VertexProgramData &vertexProgramData, FragmentProgramData &fragmentProgramData, const pipeline_properties &pipeline_properties, const ExtraData& extraData);
  * - static void validate_pipeline_properties(const VertexProgramData &vertexProgramData, const FragmentProgramData &fragmentProgramData, pipeline_properties& props);
+ * It may also declare :
+ * - static constexpr bool parallel_recompile = true; if recompile_*_program may run off the calling thread
  */
 template <typename backend_traits>
 class program_state_cache
@@ -217,10 +220,22 @@ protected:
 	fragment_program_type __null_fragment_program;
 	pipeline_storage_type __null_pipeline_handle;
 
+	static constexpr bool has_parallel_recompile()
+	{
+		if constexpr (requires { backend_traits::parallel_recompile; })
+		{
+			return backend_traits::parallel_recompile;
+		}
+
+		return false;
+	}
+
 	/// bool here to inform that the program was preexisting.
+	/// If pending is set, a new program is inserted but left for the caller to recompile.
 	std::tuple<const vertex_program_type&, bool> search_vertex_program(
 		rsx::program_cache_hint_t* cache_hint,
-		const RSXVertexProgram& rsx_vp)
+		const RSXVertexProgram& rsx_vp,
+		vertex_program_type** pending = nullptr)
 	{
 		if (cache_hint && cache_hint->has_vertex_program())
 		{
@@ -250,7 +265,14 @@ protected:
 
 		if (recompile)
 		{
-			backend_traits::recompile_vertex_program(rsx_vp, *new_shader, m_next_id++);
+			if (pending)
+			{
+				*pending = new_shader;
+			}
+			else
+			{
+				backend_traits::recompile_vertex_program(rsx_vp, *new_shader, m_next_id++);
+			}
 		}
 
 		rsx::program_cache_hint_t::cache_vertex_program(cache_hint, rsx_vp, new_shader);
@@ -258,7 +280,11 @@ protected:
 	}
 
 	/// bool here to inform that the program was preexisting.
-	std::tuple<const fragment_program_type&, bool> search_fragment_program(rsx::program_cache_hint_t* cache_hint, const RSXFragmentProgram& rsx_fp)
+	/// If pending is set, a new program is inserted but left for the caller to recompile.
+	std::tuple<const fragment_program_type&, bool> search_fragment_program(
+		rsx::program_cache_hint_t* cache_hint,
+		const RSXFragmentProgram& rsx_fp,
+		fragment_program_type** pending = nullptr)
 	{
 		if (cache_hint && cache_hint->has_fragment_program())
 		{
@@ -289,7 +315,15 @@ protected:
 		if (recompile)
 		{
 			it->first.clone_data();
-			backend_traits::recompile_fragment_program(rsx_fp, *new_shader, m_next_id++);
+
+			if (pending)
+			{
+				*pending = new_shader;
+			}
+			else
+			{
+				backend_traits::recompile_fragment_program(rsx_fp, *new_shader, m_next_id++);
+			}
 		}
 
 		rsx::program_cache_hint_t::cache_fragment_program(cache_hint, rsx_fp, new_shader);
@@ -355,8 +389,31 @@ public:
 		bool allow_notification,
 		Args&&... args)
 	{
-		const auto& vp_search = search_vertex_program(cache_hint, vertex_shader);
-		const auto& fp_search = search_fragment_program(cache_hint, fragment_shader);
+		vertex_program_type* pending_vp = nullptr;
+		fragment_program_type* pending_fp = nullptr;
+
+		const auto& vp_search = search_vertex_program(cache_hint, vertex_shader, has_parallel_recompile() ? &pending_vp : nullptr);
+		const auto& fp_search = search_fragment_program(cache_hint, fragment_shader, has_parallel_recompile() ? &pending_fp : nullptr);
+
+		if (pending_vp && pending_fp)
+		{
+			// Both shaders are new: decompile and compile the vertex program on a worker while this thread takes the fragment program
+			named_thread vp_worker("RSX Shader Worker", [&, id = m_next_id++]()
+				{
+					backend_traits::recompile_vertex_program(vertex_shader, *pending_vp, id);
+				});
+
+			backend_traits::recompile_fragment_program(fragment_shader, *pending_fp, m_next_id++);
+			vp_worker();
+		}
+		else if (pending_vp)
+		{
+			backend_traits::recompile_vertex_program(vertex_shader, *pending_vp, m_next_id++);
+		}
+		else if (pending_fp)
+		{
+			backend_traits::recompile_fragment_program(fragment_shader, *pending_fp, m_next_id++);
+		}
 
 		const bool already_existing_fragment_program = std::get<1>(fp_search);
 		const bool already_existing_vertex_program = std::get<1>(vp_search);
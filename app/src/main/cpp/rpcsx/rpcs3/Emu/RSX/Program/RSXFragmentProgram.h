@@ -309,6 +309,11 @@ struct RSXFragmentProgram
 
 	bool valid = false;
 
+	// Bumped whenever the ucode is rewritten, see RSXVertexProgram
+	u32 ucode_generation = 0;
+	mutable u32 ucode_hash_generation = umax;
+	mutable usz ucode_hash = 0;
+
 	RSXFragmentProgram() = default;
 
 	rsx::texture_dimension_extended get_texture_dimension(u8 id) const
@@ -228,6 +228,12 @@ struct RSXVertexProgram
 	std::bitset<rsx::max_vertex_program_instructions> instruction_mask;
 	std::set<u32> jump_table;
 
+	// Bumped whenever the ucode is rewritten. The ucode hash is only recomputed when this moves,
+	// so lookups after a state-only change skip rehashing the whole program.
+	u32 ucode_generation = 0;
+	mutable u32 ucode_hash_generation = umax;
+	mutable usz ucode_hash = 0;
+
 	rsx::texture_dimension_extended get_texture_dimension(u8 id) const
 	{
 		return rsx::texture_dimension_extended{static_cast<u8>((texture_state.texture_dimensions >> (id * 2)) & 0x3)};
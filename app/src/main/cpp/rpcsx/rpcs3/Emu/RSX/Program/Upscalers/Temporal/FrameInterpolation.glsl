@@ -0,0 +1,52 @@
+R"(
+#version 450
+layout(local_size_x = %WORKGROUP_SIZE_X, local_size_y = %WORKGROUP_SIZE_Y, local_size_z = 1) in;
+
+// Builds the image halfway between two flips. The block matcher's vectors point from where a tile was in the previous
+// frame to where it is now, so the midpoint fetches the previous frame half a vector behind the pixel and the current
+// frame half a vector ahead of it.
+
+#define TILE_SIZE %TILE_SIZE
+
+layout(set = 0, binding = 0) uniform sampler2D PreviousColor;
+layout(set = 0, binding = 1) uniform sampler2D CurrentColor;
+layout(set = 0, binding = 2) uniform sampler2D Motion;
+layout(set = 0, binding = 3, rgba16f) uniform writeonly restrict image2D Output;
+
+layout(push_constant) uniform static_data
+{
+	ivec2 frame_size;
+	ivec2 tile_count;
+};
+
+float get_luma(const in vec3 color)
+{
+	return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+void main()
+{
+	const ivec2 pos = ivec2(gl_GlobalInvocationID.xy);
+	if (any(greaterThanEqual(pos, frame_size)))
+	{
+		return;
+	}
+
+	const vec2 texel = 1. / vec2(frame_size);
+	const vec2 center = vec2(pos) + 0.5;
+
+	// Vectors are filtered between tile centers, a nearest fetch shows the tile grid on moving edges
+	const vec4 motion = textureLod(Motion, center / vec2(tile_count * TILE_SIZE), 0.);
+	const vec2 half_motion = motion.xy * 0.5;
+
+	const vec3 previous = textureLod(PreviousColor, (center - half_motion) * texel, 0.).rgb;
+	const vec3 current = textureLod(CurrentColor, (center + half_motion) * texel, 0.).rgb;
+
+	// Both fetches should land on the same surface. Where they disagree (disocclusion, failed match) a blend ghosts,
+	// show the newer frame instead.
+	const float mismatch = abs(get_luma(previous) - get_luma(current));
+	const float weight = motion.w * (1. - smoothstep(0.05, 0.2, mismatch));
+
+	imageStore(Output, pos, vec4(mix(current, (previous + current) * 0.5, weight), 1.));
+}
+)"
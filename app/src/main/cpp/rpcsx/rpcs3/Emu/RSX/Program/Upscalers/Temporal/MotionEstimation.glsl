@@ -0,0 +1,142 @@
+R"(
+#version 450
+layout(local_size_x = %WORKGROUP_SIZE_X, local_size_y = %WORKGROUP_SIZE_Y, local_size_z = 1) in;
+
+// RSX does not expose motion vectors, so they are recovered per tile by block matching
+// the current frame against the previous one. One invocation handles one tile.
+
+#define TILE_SIZE %TILE_SIZE
+#define FLAG_HISTORY_VALID 1
+#define FLAG_DEPTH_VALID 2
+#define MAX_MOTION 24.
+
+layout(set = 0, binding = 0) uniform sampler2D CurrentColor;
+layout(set = 0, binding = 1) uniform sampler2D PreviousLuma;
+layout(set = 0, binding = 2) uniform sampler2D CurrentDepth;
+layout(set = 0, binding = 3) uniform sampler2D PreviousMotion;
+layout(set = 0, binding = 4, %LUMA_FORMAT) uniform writeonly restrict image2D CurrentLuma;
+layout(set = 0, binding = 5, rgba16f) uniform writeonly restrict image2D MotionOut;
+
+layout(push_constant) uniform static_data
+{
+	ivec2 input_size;
+	ivec2 depth_size;
+	ivec2 tile_count;
+	uint flags;
+	uint reserved;
+};
+
+float get_luma(const in vec3 color)
+{
+	return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+// Sum of absolute differences on a 4x4 grid of the tile against the previous frame displaced by 'motion'.
+// A small penalty on the vector length keeps flat areas from picking random vectors.
+float match_cost(const in ivec2 base, const in vec2 motion, const in float samples[16])
+{
+	const vec2 texel = 1. / vec2(input_size);
+	float cost = 0.;
+
+	for (int i = 0; i < 16; ++i)
+	{
+		const vec2 pos = vec2(base + ivec2(i & 3, i >> 2) * (TILE_SIZE / 4)) + 0.5 - motion;
+		cost += abs(samples[i] - textureLod(PreviousLuma, pos * texel, 0.).r);
+	}
+
+	return cost + length(motion) * 0.002;
+}
+
+void main()
+{
+	const ivec2 tile = ivec2(gl_GlobalInvocationID.xy);
+	if (any(greaterThanEqual(tile, tile_count)))
+	{
+		return;
+	}
+
+	const ivec2 base = tile * TILE_SIZE;
+	const ivec2 limit = input_size - 1;
+	float samples[16];
+
+	// Publish this tile's luma for the next frame and keep the sparse grid for matching
+	for (int y = 0; y < TILE_SIZE; ++y)
+	{
+		for (int x = 0; x < TILE_SIZE; ++x)
+		{
+			const ivec2 pos = base + ivec2(x, y);
+			const float luma = get_luma(texelFetch(CurrentColor, min(pos, limit), 0).rgb);
+
+			if (all(lessThanEqual(pos, limit)))
+			{
+				imageStore(CurrentLuma, pos, vec4(luma));
+			}
+
+			if (((x | y) % (TILE_SIZE / 4)) == 0)
+			{
+				samples[(y / (TILE_SIZE / 4)) * 4 + (x / (TILE_SIZE / 4))] = luma;
+			}
+		}
+	}
+
+	// Closest depth of the tile. Used to dilate vectors towards foreground edges and to detect disocclusion.
+	float closest_depth = 1.;
+	if ((flags & FLAG_DEPTH_VALID) != 0)
+	{
+		const ivec2 depth_limit = depth_size - 1;
+		const ivec2 depth_taps[5] = { ivec2(0), ivec2(TILE_SIZE - 1, 0), ivec2(0, TILE_SIZE - 1), ivec2(TILE_SIZE - 1), ivec2(TILE_SIZE / 2) };
+
+		for (int i = 0; i < 5; ++i)
+		{
+			closest_depth = min(closest_depth, texelFetch(CurrentDepth, min(base + depth_taps[i], depth_limit), 0).r);
+		}
+	}
+
+	if ((flags & FLAG_HISTORY_VALID) == 0)
+	{
+		imageStore(MotionOut, tile, vec4(0., 0., closest_depth, 0.));
+		return;
+	}
+
+	// Candidates: static, last frame's vector for this tile, then a logarithmic search around the best one
+	vec2 best = vec2(0.);
+	const float static_cost = match_cost(base, best, samples);
+	float best_cost = static_cost;
+
+	const vec2 predicted = clamp(texelFetch(PreviousMotion, tile, 0).xy, vec2(-MAX_MOTION), vec2(MAX_MOTION));
+	const float predicted_cost = match_cost(base, predicted, samples);
+	if (predicted_cost < best_cost)
+	{
+		best = predicted;
+		best_cost = predicted_cost;
+	}
+
+	for (float step_size = 8.; step_size >= 0.5; step_size *= 0.5)
+	{
+		const vec2 center = best;
+		for (int j = -1; j <= 1; ++j)
+		{
+			for (int i = -1; i <= 1; ++i)
+			{
+				if (i == 0 && j == 0)
+				{
+					continue;
+				}
+
+				const vec2 candidate = clamp(center + vec2(i, j) * step_size, vec2(-MAX_MOTION), vec2(MAX_MOTION));
+				const float cost = match_cost(base, candidate, samples);
+
+				if (cost < best_cost)
+				{
+					best = candidate;
+					best_cost = cost;
+				}
+			}
+		}
+	}
+
+	// Confidence drops with the residual error of the match. Mean error above ~6% luma is treated as a miss.
+	const float confidence = clamp(1. - (best_cost / 16.) / 0.06, 0., 1.);
+	imageStore(MotionOut, tile, vec4(best, closest_depth, confidence));
+}
+)"
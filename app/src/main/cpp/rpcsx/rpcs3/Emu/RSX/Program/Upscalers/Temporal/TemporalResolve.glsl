@@ -0,0 +1,150 @@
+R"(
+#version 450
+layout(local_size_x = %WORKGROUP_SIZE_X, local_size_y = %WORKGROUP_SIZE_Y, local_size_z = 1) in;
+
+// Reprojects the accumulated output-resolution history with the reconstructed motion field,
+// clips it against the current frame's neighbourhood and blends the new frame in.
+
+#define TILE_SIZE %TILE_SIZE
+#define FLAG_HISTORY_VALID 1
+#define FLAG_DEPTH_VALID 2
+
+layout(set = 0, binding = 0) uniform sampler2D CurrentColor;
+layout(set = 0, binding = 1) uniform sampler2D History;
+layout(set = 0, binding = 2) uniform sampler2D Motion;
+layout(set = 0, binding = 3) uniform sampler2D PreviousMotion;
+layout(set = 0, binding = 4, rgba16f) uniform writeonly restrict image2D HistoryOut;
+
+layout(push_constant) uniform static_data
+{
+	vec2 input_size;
+	vec2 input_texel;
+	vec2 output_size;
+	ivec2 tile_count;
+	float blend_factor;
+	uint flags;
+};
+
+// Catmull-Rom through 5 bilinear taps (corners dropped). Plain bilinear history fetches blur the image a bit more every frame.
+vec3 sample_history(const in vec2 uv)
+{
+	const vec2 pos = uv * output_size;
+	const vec2 center = floor(pos - 0.5) + 0.5;
+	const vec2 f = pos - center;
+
+	const vec2 w0 = f * (-0.5 + f * (1. - 0.5 * f));
+	const vec2 w1 = 1. + f * f * (-2.5 + 1.5 * f);
+	const vec2 w2 = f * (0.5 + f * (2. - 1.5 * f));
+	const vec2 w3 = f * f * (-0.5 + 0.5 * f);
+	const vec2 w12 = w1 + w2;
+
+	const vec2 texel = 1. / output_size;
+	const vec2 tc0 = (center - 1.) * texel;
+	const vec2 tc3 = (center + 2.) * texel;
+	const vec2 tc12 = (center + w2 / w12) * texel;
+
+	vec3 result =
+		textureLod(History, vec2(tc12.x, tc0.y), 0.).rgb * (w12.x * w0.y) +
+		textureLod(History, vec2(tc0.x, tc12.y), 0.).rgb * (w0.x * w12.y) +
+		textureLod(History, vec2(tc12.x, tc12.y), 0.).rgb * (w12.x * w12.y) +
+		textureLod(History, vec2(tc3.x, tc12.y), 0.).rgb * (w3.x * w12.y) +
+		textureLod(History, vec2(tc12.x, tc3.y), 0.).rgb * (w12.x * w3.y);
+
+	const float weight = (w12.x * w0.y) + (w0.x * w12.y) + (w12.x * w12.y) + (w3.x * w12.y) + (w12.x * w3.y);
+	return max(result / weight, vec3(0.));
+}
+
+vec3 clip_to_box(const in vec3 history, const in vec3 box_min, const in vec3 box_max)
+{
+	const vec3 center = 0.5 * (box_max + box_min);
+	const vec3 extents = max(0.5 * (box_max - box_min), vec3(0.0001));
+	const vec3 offset = history - center;
+	const vec3 units = abs(offset / extents);
+	const float max_unit = max(units.x, max(units.y, units.z));
+
+	return (max_unit > 1.) ? center + offset / max_unit : history;
+}
+
+void main()
+{
+	const ivec2 pos = ivec2(gl_GlobalInvocationID.xy);
+	if (any(greaterThanEqual(vec2(pos), output_size)))
+	{
+		return;
+	}
+
+	const vec2 uv = (vec2(pos) + 0.5) / output_size;
+	const vec2 input_pos = uv * input_size;
+	const vec3 current = textureLod(CurrentColor, input_pos * input_texel, 0.).rgb;
+
+	if ((flags & FLAG_HISTORY_VALID) == 0)
+	{
+		imageStore(HistoryOut, pos, vec4(current, 1.));
+		return;
+	}
+
+	// Neighbourhood of the current frame at input resolution
+	const ivec2 texel_pos = ivec2(input_pos);
+	const ivec2 input_limit = ivec2(input_size) - 1;
+	vec3 m1 = vec3(0.), m2 = vec3(0.);
+
+	for (int y = -1; y <= 1; ++y)
+	{
+		for (int x = -1; x <= 1; ++x)
+		{
+			const vec3 color = texelFetch(CurrentColor, clamp(texel_pos + ivec2(x, y), ivec2(0), input_limit), 0).rgb;
+			m1 += color;
+			m2 += color * color;
+		}
+	}
+
+	const vec3 mean = m1 / 9.;
+	const vec3 sigma = sqrt(max(m2 / 9. - mean * mean, vec3(0.)));
+
+	// Take the vector of the closest tile around this pixel so foreground edges carry their own motion
+	const ivec2 tile_limit = tile_count - 1;
+	const ivec2 tile = clamp(texel_pos / TILE_SIZE, ivec2(0), tile_limit);
+	vec4 motion = texelFetch(Motion, tile, 0);
+
+	for (int y = -1; y <= 1; ++y)
+	{
+		for (int x = -1; x <= 1; ++x)
+		{
+			const vec4 candidate = texelFetch(Motion, clamp(tile + ivec2(x, y), ivec2(0), tile_limit), 0);
+			if (candidate.z < motion.z)
+			{
+				motion = candidate;
+			}
+		}
+	}
+
+	const vec2 history_uv = uv - motion.xy / input_size;
+	float alpha = blend_factor;
+
+	if (any(lessThan(history_uv, vec2(0.))) || any(greaterThan(history_uv, vec2(1.))))
+	{
+		// Nothing to reproject from
+		alpha = 1.;
+	}
+	else if ((flags & FLAG_DEPTH_VALID) != 0)
+	{
+		// Disocclusion: the surface seen at the reprojected location last frame was at a different depth
+		const ivec2 history_tile = clamp(ivec2(history_uv * input_size) / TILE_SIZE, ivec2(0), tile_limit);
+		const float previous_depth = texelFetch(PreviousMotion, history_tile, 0).z;
+		const float depth_delta = abs(previous_depth - motion.z) / max(1. - min(previous_depth, motion.z), 0.0001);
+		alpha = max(alpha, smoothstep(0.05, 0.25, depth_delta));
+	}
+
+	// Unreliable vectors get a tighter box so mismatched history cannot ghost
+	const float box_scale = mix(0.75, 1.5, motion.w);
+	vec3 history = sample_history(history_uv);
+	history = clip_to_box(history, mean - sigma * box_scale, mean + sigma * box_scale);
+
+	// Weigh by inverse luma so small bright features do not flicker
+	const float w_current = alpha / (1. + dot(current, vec3(0.299, 0.587, 0.114)));
+	const float w_history = (1. - alpha) / (1. + dot(history, vec3(0.299, 0.587, 0.114)));
+	const vec3 result = (current * w_current + history * w_history) / max(w_current + w_history, 0.0001);
+
+	imageStore(HistoryOut, pos, vec4(result, 1.));
+}
+)"
@@ -11,6 +11,7 @@
 
 #include "rx/align.hpp"
 #include "rx/asm.hpp"
+#include "util/Thread.h"
 
 #include <thread>
 #include <bitset>
@@ -24,13 +25,324 @@ namespace rsx
 {
 	namespace FIFO
 	{
+		lookahead_decoder::lookahead_decoder(::rsx::thread* pctrl)
+			: m_ctrl(pctrl->ctrl), m_iotable(&pctrl->iomap_table), m_ring(std::make_unique<predecoded_packet[]>(ring_size))
+		{
+		}
+
+		void lookahead_decoder::restart(u32 get, u32 ret_addr)
+		{
+			m_fallback_count = 0;
+			m_request_ret.release(ret_addr);
+			m_request.release((u64{++m_epoch} << 32) | get);
+		}
+
+		void lookahead_decoder::on_fallback(u32 header, u32 ret_addr)
+		{
+			if (m_fallback_count == max_fallback_history)
+			{
+				// The decoder is lost or stalled, start over from the puller position
+				restart(header, ret_addr);
+				return;
+			}
+
+			m_fallback_headers[m_fallback_count++] = header;
+		}
+
+		const predecoded_packet* lookahead_decoder::fetch_method(u32 header, u32 ret_addr)
+		{
+			const u32 write = m_write.load();
+
+			for (u32 read = m_read.raw(); read != write; read++)
+			{
+				const auto& packet = m_ring[read % ring_size];
+
+				if (packet.epoch != m_epoch)
+				{
+					// Stale stream
+					continue;
+				}
+
+				if (packet.header == header && packet.flags & (PACKET_METHOD_BEGIN | PACKET_NOP | PACKET_FLOW))
+				{
+					m_fallback_count = 0;
+					m_read.release(read);
+					return &packet;
+				}
+
+				if (!(packet.flags & (PACKET_METHOD_BEGIN | PACKET_NOP | PACKET_FLOW)))
+				{
+					// Remainder of a method already consumed or skipped
+					continue;
+				}
+
+				// Methods read from memory while the decoder was catching up lag behind the puller
+				if (std::find(m_fallback_headers.begin(), m_fallback_headers.begin() + m_fallback_count, packet.header) != m_fallback_headers.begin() + m_fallback_count)
+				{
+					continue;
+				}
+
+				// Mispredicted
+				m_read.release(write);
+				restart(header, ret_addr);
+				return nullptr;
+			}
+
+			m_read.release(write);
+			on_fallback(header, ret_addr);
+			return nullptr;
+		}
+
+		const predecoded_packet* lookahead_decoder::fetch_arg(u32 header, u32 get)
+		{
+			const u32 write = m_write.load();
+
+			for (u32 read = m_read.raw(); read != write; read++)
+			{
+				const auto& packet = m_ring[read % ring_size];
+
+				if (packet.epoch != m_epoch || packet.header != header)
+				{
+					return nullptr;
+				}
+
+				if (packet.get == get)
+				{
+					m_read.release(read);
+					return &packet;
+				}
+
+				if (packet.get > get)
+				{
+					return nullptr;
+				}
+
+				// Skipped by skip_methods
+			}
+
+			return nullptr;
+		}
+
+		void lookahead_decoder::pop()
+		{
+			m_read.release(m_read.raw() + 1);
+		}
+
+		bool lookahead_decoder::publish(const predecoded_packet& packet)
+		{
+			const u32 write = m_write.raw();
+
+			if (write - m_read.load() >= ring_size)
+			{
+				return false;
+			}
+
+			m_ring[write % ring_size] = packet;
+			m_write.release(write + 1);
+			return true;
+		}
+
+		bool lookahead_decoder::decode_next()
+		{
+			const u32 put = m_ctrl->put & ~3;
+
+			if (m_decode_pos == put)
+			{
+				return false;
+			}
+
+			const u32 addr = m_iotable->get_addr(m_decode_pos);
+
+			if (addr == umax || !vm::check_addr(addr, vm::page_readable, 4))
+			{
+				m_decode_stalled = true;
+				return false;
+			}
+
+			const u32 cmd = vm::read32(addr);
+
+			predecoded_packet packet{};
+			packet.epoch = m_decode_epoch;
+			packet.header = m_decode_pos;
+			packet.get = m_decode_pos;
+			packet.cmd = cmd;
+
+			if (cmd & RSX_METHOD_NON_METHOD_CMD_MASK)
+			{
+				u32 target = umax;
+				u32 ret = m_decode_ret;
+
+				if ((cmd & RSX_METHOD_OLD_JUMP_CMD_MASK) == RSX_METHOD_OLD_JUMP_CMD)
+				{
+					target = cmd & RSX_METHOD_OLD_JUMP_OFFSET_MASK;
+				}
+				else if ((cmd & RSX_METHOD_NEW_JUMP_CMD_MASK) == RSX_METHOD_NEW_JUMP_CMD)
+				{
+					target = cmd & RSX_METHOD_NEW_JUMP_OFFSET_MASK;
+				}
+				else if ((cmd & RSX_METHOD_CALL_CMD_MASK) == RSX_METHOD_CALL_CMD)
+				{
+					if (ret != RSX_CALL_STACK_EMPTY)
+					{
+						// Nested call, the puller reports an error here
+						m_decode_stalled = true;
+						return false;
+					}
+
+					target = cmd & RSX_METHOD_CALL_OFFSET_MASK;
+					ret = m_decode_pos + 4;
+				}
+				else if ((cmd & RSX_METHOD_RETURN_MASK) == RSX_METHOD_RETURN_CMD)
+				{
+					if (ret == RSX_CALL_STACK_EMPTY)
+					{
+						m_decode_stalled = true;
+						return false;
+					}
+
+					target = std::exchange(ret, RSX_CALL_STACK_EMPTY);
+
+					// Same as the puller, returning to another CALL goes straight to its target
+					if (put != target)
+					{
+						if (const u32 ret_ptr = m_iotable->get_addr(target); ret_ptr != umax && vm::check_addr(ret_ptr, vm::page_readable, 4))
+						{
+							if (const u32 cmd0 = vm::read32(ret_ptr); (cmd0 & RSX_METHOD_CALL_CMD_MASK) == RSX_METHOD_CALL_CMD)
+							{
+								ret = target + 4;
+								target = cmd0 & RSX_METHOD_CALL_OFFSET_MASK;
+							}
+						}
+					}
+				}
+				else
+				{
+					// Malformed, left to the puller
+					m_decode_stalled = true;
+					return false;
+				}
+
+				if (target == m_decode_pos)
+				{
+					// Jump to self, the guest patches it in place. Poll until it changes
+					return false;
+				}
+
+				packet.flags = PACKET_FLOW;
+
+				if (!publish(packet))
+				{
+					return false;
+				}
+
+				m_decode_pos = target;
+				m_decode_ret = ret;
+				return true;
+			}
+
+			const u32 count = (cmd >> 18) & 0x7ff;
+
+			if (!count)
+			{
+				packet.flags = PACKET_NOP;
+
+				if (!publish(packet))
+				{
+					return false;
+				}
+
+				m_decode_pos += 4;
+				return true;
+			}
+
+			if (put - m_decode_pos <= count * 4 || ring_size - (m_write.raw() - m_read.load()) < count)
+			{
+				// Arguments not submitted yet, or no room for the whole method
+				return false;
+			}
+
+			const u32 args_ptr = m_iotable->get_addr(m_decode_pos + 4);
+
+			if (args_ptr == umax || !vm::check_addr(args_ptr, vm::page_readable, count * 4))
+			{
+				m_decode_stalled = true;
+				return false;
+			}
+
+			const u32 inc = ((cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD) ? 0 : 4;
+			const u32 write = m_write.raw();
+
+			// Published as a whole so the puller never sees a partial method
+			for (u32 i = 0; i < count; i++)
+			{
+				auto& arg = m_ring[(write + i) % ring_size];
+				arg = packet;
+				arg.get = m_decode_pos + 4 + i * 4;
+				arg.args_ptr = args_ptr + i * 4;
+				arg.reg = (cmd & 0xfffc) + inc * i;
+				arg.value = vm::read32(arg.args_ptr);
+				arg.remaining = static_cast<u16>(count - 1 - i);
+				arg.flags = i ? 0 : PACKET_METHOD_BEGIN;
+
+				if (((arg.reg & 0xffff) >> 2) == NV4097_SET_BEGIN_END)
+				{
+					arg.flags |= PACKET_DRAW_BOUNDARY;
+				}
+			}
+
+			m_write.release(write + count);
+			m_decode_pos += 4 + count * 4;
+			return true;
+		}
+
+		void lookahead_decoder::operator()()
+		{
+			while (thread_ctrl::state() != thread_state::aborting)
+			{
+				if (const u64 request = m_request.load(); static_cast<u32>(request >> 32) != m_decode_epoch)
+				{
+					m_decode_epoch = static_cast<u32>(request >> 32);
+					m_decode_pos = static_cast<u32>(request);
+					m_decode_ret = m_request_ret.load();
+					m_decode_stalled = false;
+				}
+
+				if (m_decode_stalled)
+				{
+					thread_ctrl::wait_for(200);
+					continue;
+				}
+
+				u32 decoded = 0;
+
+				while (decoded < 256 && decode_next())
+				{
+					decoded++;
+				}
+
+				if (!decoded)
+				{
+					// Waiting for PUT, for the puller to drain the ring, or on a jump to self
+					thread_ctrl::wait_for(50);
+				}
+			}
+		}
+
 		FIFO_control::FIFO_control(::rsx::thread* pctrl)
 		{
 			m_thread = pctrl;
 			m_ctrl = pctrl->ctrl;
 			m_iotable = &pctrl->iomap_table;
+
+			if (g_cfg.core.rsx_fifo_lookahead && !g_cfg.core.rsx_fifo_accuracy)
+			{
+				m_lookahead = std::make_unique<named_thread<lookahead_decoder>>(pctrl);
+				m_lookahead->restart(m_ctrl->get, RSX_CALL_STACK_EMPTY);
+			}
 		}
 
+		FIFO_control::~FIFO_control() = default;
+
 		u32 FIFO_control::translate_address(u32 address) const
 		{
 			return m_iotable->get_addr(address);
@@ -49,6 +361,8 @@ namespace rsx
 			m_internal_get = m_ctrl->get - 4;
 			m_args_ptr = m_iotable->get_addr(m_internal_get);
 			m_command_reg = (m_cmd & 0xffff) + m_command_inc * (((m_cmd >> 18) - count) & 0x7ff) - m_command_inc;
+			m_command_header = umax;
+			m_draw_boundary = true;
 		}
 
 		void FIFO_control::inc_get(bool wait)
@@ -274,6 +588,22 @@ namespace rsx
 			// Fast read with no processing, only safe inside a PACKET_BEGIN+count block
 			if (m_remaining_commands)
 			{
+				if (m_lookahead)
+				{
+					if (const auto packet = m_lookahead->fetch_arg(m_command_header, m_internal_get + 4))
+					{
+						m_internal_get = packet->get;
+						m_args_ptr = packet->args_ptr;
+						m_command_reg += m_command_inc;
+						--m_remaining_commands;
+						m_draw_boundary |= !!(packet->flags & PACKET_DRAW_BOUNDARY);
+
+						data.set(m_command_reg, packet->value);
+						m_lookahead->pop();
+						return true;
+					}
+				}
+
 				bool ok{};
 				u32 arg = 0;
 
@@ -313,9 +643,60 @@ namespace rsx
 			}
 
 			m_internal_get += 4;
+
+			if (m_lookahead && !m_draw_boundary && !m_memwatch_addr && m_chained_methods < 64)
+			{
+				// Chain into the next method, draw boundaries still go back to the puller loop
+				if (read_predecoded(data, true))
+				{
+					m_chained_methods++;
+					return true;
+				}
+			}
+
 			return false;
 		}
 
+		bool FIFO_control::read_predecoded(register_pair& data, bool chain)
+		{
+			const auto packet = m_lookahead->fetch_method(m_internal_get, m_thread->get_fifo_ret_addr());
+
+			if (!packet || (chain && !(packet->flags & PACKET_METHOD_BEGIN)))
+			{
+				return false;
+			}
+
+			m_cmd = packet->cmd;
+
+			if (packet->flags & PACKET_FLOW)
+			{
+				// Flow control is still executed by the puller, the target has been decoded already
+				m_lookahead->pop();
+				data.reg = m_cmd;
+				return true;
+			}
+
+			if (packet->flags & PACKET_NOP)
+			{
+				m_lookahead->pop();
+				m_ctrl->get.release(m_internal_get += 4);
+				data.reg = FIFO_NOP;
+				return true;
+			}
+
+			m_command_header = packet->header;
+			m_command_reg = packet->reg;
+			m_command_inc = ((m_cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD) ? 0 : 4;
+			m_remaining_commands = packet->remaining;
+			m_internal_get = packet->get;
+			m_args_ptr = packet->args_ptr;
+			m_draw_boundary = !!(packet->flags & PACKET_DRAW_BOUNDARY);
+
+			data.set(packet->reg, packet->value);
+			m_lookahead->pop();
+			return true;
+		}
+
 		// Optimization for methods which can be batched together
 		// Beware, can be easily misused
 		bool FIFO_control::skip_methods(u32 count)
@@ -367,6 +748,19 @@ namespace rsx
 				m_memwatch_cmp = 0;
 			}
 
+			if (m_lookahead)
+			{
+				m_chained_methods = 0;
+
+				if (read_predecoded(data, false))
+				{
+					return;
+				}
+			}
+
+			m_command_header = umax;
+			m_draw_boundary = true;
+
 			if (!g_cfg.core.rsx_fifo_accuracy) [[likely]]
 			{
 				const u32 put = read_put();
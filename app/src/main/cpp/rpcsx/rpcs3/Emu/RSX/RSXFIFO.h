@@ -1,12 +1,17 @@
 #pragma once
 
 #include "util/types.hpp"
+#include "util/atomic.hpp"
 #include "Emu/RSX/gcm_enums.h"
 
+#include <memory>
 #include <span>
 
 struct RsxDmaControl;
 
+template <class Context>
+class named_thread;
+
 namespace rsx
 {
 	class thread;
@@ -60,6 +65,78 @@ namespace rsx
 			}
 		};
 
+		enum packet_flags : u16
+		{
+			PACKET_METHOD_BEGIN = (1 << 0),  // First argument of a method
+			PACKET_NOP = (1 << 1),           // Method header without arguments
+			PACKET_FLOW = (1 << 2),          // Jump, call or return, already followed by the decoder
+			PACKET_DRAW_BOUNDARY = (1 << 3), // Write to NV4097_SET_BEGIN_END
+		};
+
+		// A FIFO word decoded ahead of the puller
+		struct predecoded_packet
+		{
+			u32 epoch;
+			u32 header;   // IO address of the method header
+			u32 get;      // IO address of the argument. For NOP and flow packets, same as header
+			u32 args_ptr; // Effective address of the argument
+			u32 cmd;
+			u32 reg;
+			u32 value;
+			u16 remaining; // Arguments left in the method after this one
+			u16 flags;
+		};
+
+		// Walks the command buffer between GET and PUT on a helper thread, following jumps and calls.
+		// Packets are matched against the puller's address, a mispredicted stream is discarded and decoding restarts at GET.
+		class lookahead_decoder
+		{
+			static constexpr u32 ring_size = 8192;
+			static constexpr u32 max_fallback_history = 32;
+
+			RsxDmaControl* m_ctrl;
+			const rsx::rsx_iomap_table* m_iotable;
+			std::unique_ptr<predecoded_packet[]> m_ring;
+
+			atomic_t<u32> m_write = 0;
+			atomic_t<u32> m_read = 0;
+			atomic_t<u64> m_request = 0; // epoch << 32 | get
+			atomic_t<u32> m_request_ret = RSX_CALL_STACK_EMPTY;
+
+			// Puller side only
+			u32 m_epoch = 0;
+			u32 m_fallback_count = 0;
+			std::array<u32, max_fallback_history> m_fallback_headers{};
+
+			// Decoder side only
+			u32 m_decode_epoch = 0;
+			u32 m_decode_pos = 0;
+			u32 m_decode_ret = RSX_CALL_STACK_EMPTY;
+			bool m_decode_stalled = true;
+
+			bool decode_next();
+			bool publish(const predecoded_packet& packet);
+			void on_fallback(u32 header, u32 ret_addr);
+
+		public:
+			lookahead_decoder(rsx::thread* pctrl);
+
+			// Packet starting the method at 'header', or null if the caller has to read the FIFO
+			const predecoded_packet* fetch_method(u32 header, u32 ret_addr);
+
+			// Packet for the argument at 'get' of the current method
+			const predecoded_packet* fetch_arg(u32 header, u32 get);
+
+			// Consumes the packet returned by fetch_method or fetch_arg
+			void pop();
+
+			void restart(u32 get, u32 ret_addr);
+
+			void operator()();
+
+			static constexpr auto thread_name = "RSX FIFO Lookahead"sv;
+		};
+
 		class flattening_helper
 		{
 			enum register_props : u8
@@ -151,9 +228,17 @@ namespace rsx
 			u32 m_cache_size = 0;
 			alignas(64) std::byte m_cache[8][128];
 
+			// Lookahead state, only used in fast mode
+			std::unique_ptr<named_thread<lookahead_decoder>> m_lookahead;
+			u32 m_command_header = umax;
+			u32 m_chained_methods = 0;
+			bool m_draw_boundary = false;
+
+			bool read_predecoded(register_pair& data, bool chain);
+
 		public:
 			FIFO_control(rsx::thread* pctrl);
-			~FIFO_control() = default;
+			~FIFO_control();
 
 			u32 translate_address(u32 addr) const;
 
@@ -8,13 +8,91 @@
 
 #include "util/lockless.h"
 
+#include <algorithm>
 #include <thread>
 #include "rx/asm.hpp"
 
 namespace rsx
 {
+	void dma_manager::execute(transport_packet& job)
+	{
+		switch (job.type)
+		{
+		case raw_copy:
+		{
+			const u32 vm_addr = vm::try_get_addr(job.src).first;
+			rsx::reservation_lock<true, 1> rsx_lock(vm_addr, job.length, g_cfg.video.strict_rendering_mode && vm_addr);
+			std::memcpy(job.dst, job.src, job.length);
+			break;
+		}
+		case vector_copy:
+		{
+			std::memcpy(job.dst, job.opt_storage.data(), job.length);
+			break;
+		}
+		case index_emulate:
+		{
+			write_index_array_for_non_indexed_non_native_primitive_to_buffer(static_cast<char*>(job.dst), static_cast<rsx::primitive_type>(job.aux_param0), job.length);
+			break;
+		}
+		case callback:
+		{
+			rsx::get_current_renderer()->renderctl(job.aux_param0, job.src);
+			break;
+		}
+		default: fmt::throw_exception("Unreachable");
+		}
+	}
+
+	struct dma_manager::copy_worker
+	{
+		lf_queue<transport_packet> m_work_queue;
+		atomic_t<u64> m_enqueued_count = 0;
+		atomic_t<u64> m_processed_count = 0;
+		transport_packet* m_current_job = nullptr;
+
+		thread_base* current_thread_ = nullptr;
+
+		void operator()()
+		{
+			current_thread_ = thread_ctrl::get_current();
+			ensure(current_thread_);
+
+			while (thread_ctrl::state() != thread_state::aborting)
+			{
+				for (auto&& job : m_work_queue.pop_all())
+				{
+					m_current_job = &job;
+					execute(job);
+					m_processed_count.release(m_processed_count + 1);
+				}
+
+				m_current_job = nullptr;
+
+				if (m_enqueued_count.load() == m_processed_count.load())
+				{
+					m_processed_count.notify_all();
+					thread_ctrl::wait_on(m_work_queue);
+				}
+			}
+
+			m_processed_count = -1;
+			m_processed_count.notify_all();
+		}
+
+		bool is_idle() const
+		{
+			return m_enqueued_count.load() <= m_processed_count.load();
+		}
+
+		static constexpr auto thread_name = "RSX Offload Worker"sv;
+	};
+
 	struct dma_manager::offload_thread
 	{
+		// Writes to the same bytes always fall into the same granule, and so keep their order on one worker
+		static constexpr usz dispatch_granule = 0x10000;
+
 		lf_queue<transport_packet> m_work_queue;
 		atomic_t<u64> m_enqueued_count = 0;
 		atomic_t<u64> m_processed_count = 0;
@@ -22,6 +100,95 @@ namespace rsx
 
 		thread_base* current_thread_ = nullptr;
 
+		std::vector<std::unique_ptr<named_thread<copy_worker>>> m_workers;
+
+		offload_thread()
+		{
+			if (g_cfg.video.multithreaded_rsx)
+			{
+				// The offload thread itself counts as the first one
+				for (u32 i = 1; i < g_cfg.video.rsx_offload_threads; ++i)
+				{
+					m_workers.emplace_back(std::make_unique<named_thread<copy_worker>>());
+				}
+			}
+		}
+
+		copy_worker& get_worker(const void* dst) const
+		{
+			return *m_workers[(reinterpret_cast<uptr>(dst) / dispatch_granule) % m_workers.size()];
+		}
+
+		template <typename... Args>
+		void push_to_worker(void* dst, Args&&... args)
+		{
+			auto& worker = get_worker(dst);
+			worker.m_enqueued_count++;
+			worker.m_work_queue.push(dst, std::forward<Args>(args)...);
+		}
+
+		// Hands the job to the workers, returns false if it has to run in order on this thread
+		bool dispatch(transport_packet& job)
+		{
+			if (m_workers.empty())
+			{
+				return false;
+			}
+
+			const auto dst = static_cast<u8*>(job.dst);
+
+			switch (job.type)
+			{
+			case raw_copy:
+			{
+				// Split along the granules, large uploads are spread over all workers
+				const auto src = static_cast<u8*>(job.src);
+
+				for (u32 offset = 0; offset < job.length;)
+				{
+					const auto granule_remaining = dispatch_granule - (reinterpret_cast<uptr>(dst + offset) % dispatch_granule);
+					const u32 length = static_cast<u32>(std::min<usz>(job.length - offset, granule_remaining));
+
+					push_to_worker(dst + offset, src + offset, length);
+					offset += length;
+				}
+
+				return true;
+			}
+			case index_emulate:
+			{
+				const usz size = get_index_count(static_cast<rsx::primitive_type>(job.aux_param0), job.length) * sizeof(u16);
+				if (size && &get_worker(dst) != &get_worker(dst + size - 1))
+				{
+					// Cannot be split without knowing the index pattern
+					return false;
+				}
+
+				push_to_worker(dst, static_cast<rsx::primitive_type>(job.aux_param0), job.length);
+				return true;
+			}
+			default:
+				// Callbacks depend on all earlier transfers, vector copies own their storage
+				return false;
+			}
+		}
+
+		bool workers_idle() const
+		{
+			return std::all_of(m_workers.begin(), m_workers.end(), [](const auto& worker)
+				{
+					return worker->is_idle();
+				});
+		}
+
+		void drain_workers() const
+		{
+			while (!workers_idle())
+			{
+				rx::pause();
+			}
+		}
+
 		void operator()()
 		{
 			if (!g_cfg.video.multithreaded_rsx)
@@ -44,31 +211,10 @@ namespace rsx
 				{
 					m_current_job = &job;
 
-					switch (job.type)
-					{
-					case raw_copy:
-					{
-						const u32 vm_addr = vm::try_get_addr(job.src).first;
-						rsx::reservation_lock<true, 1> rsx_lock(vm_addr, job.length, g_cfg.video.strict_rendering_mode && vm_addr);
-						std::memcpy(job.dst, job.src, job.length);
-						break;
-					}
-					case vector_copy:
-					{
-						std::memcpy(job.dst, job.opt_storage.data(), job.length);
-						break;
-					}
-					case index_emulate:
-					{
-						write_index_array_for_non_indexed_non_native_primitive_to_buffer(static_cast<char*>(job.dst), static_cast<rsx::primitive_type>(job.aux_param0), job.length);
-						break;
-					}
-					case callback:
+					if (!dispatch(job))
 					{
-						rsx::get_current_renderer()->renderctl(job.aux_param0, job.src);
-						break;
-					}
-					default: fmt::throw_exception("Unreachable");
+						drain_workers();
+						execute(job);
 					}
 
 					m_processed_count.release(m_processed_count + 1);
@@ -83,10 +229,23 @@ namespace rsx
 				}
 			}
 
+			drain_workers();
+
+			for (auto& worker : m_workers)
+			{
+				*worker = thread_state::aborting;
+			}
+
 			m_processed_count = -1;
 			m_processed_count.notify_all();
 		}
 
+		bool is_idle() const
+		{
+			// Jobs are counted as processed once handed out, check the workers last
+			return m_enqueued_count.load() <= m_processed_count.load() && workers_idle();
+		}
+
 		static constexpr auto thread_name = "RSX Offloader"sv;
 	};
 
@@ -154,7 +313,10 @@ namespace rsx
 	{
 		if (auto cpu = thread_ctrl::get_current())
 		{
-			return m_thread->current_thread_ == cpu;
+			return m_thread->current_thread_ == cpu || std::any_of(m_thread->m_workers.begin(), m_thread->m_workers.end(), [&](const auto& worker)
+				{
+					return worker->current_thread_ == cpu;
+				});
 		}
 
 		return false;
@@ -164,7 +326,7 @@ namespace rsx
 	{
 		auto& _thr = *m_thread;
 
-		if (_thr.m_enqueued_count.load() <= _thr.m_processed_count.load()) [[likely]]
+		if (_thr.is_idle()) [[likely]]
 		{
 			// Nothing to do
 			return true;
@@ -178,7 +340,7 @@ namespace rsx
 				return false;
 			}
 
-			while (_thr.m_enqueued_count.load() > _thr.m_processed_count.load())
+			while (!_thr.is_idle())
 			{
 				rsxthr->on_semaphore_acquire_wait();
 				rx::pause();
@@ -186,7 +348,7 @@ namespace rsx
 		}
 		else
 		{
-			while (_thr.m_enqueued_count.load() > _thr.m_processed_count.load())
+			while (!_thr.is_idle())
 				rx::pause();
 		}
 
@@ -202,6 +364,7 @@ namespace rsx
 	void dma_manager::set_mem_fault_flag()
 	{
 		ensure(is_current_thread()); // "Access denied"
+		m_mem_fault_lock.lock();
 		m_mem_fault_flag.release(true);
 	}
 
@@ -209,12 +372,25 @@ namespace rsx
 	{
 		ensure(is_current_thread()); // "Access denied"
 		m_mem_fault_flag.release(false);
+		m_mem_fault_lock.unlock();
 	}
 
 	// Fault recovery
 	utils::address_range dma_manager::get_fault_range(bool writing) const
 	{
-		const auto m_current_job = ensure(m_thread->m_current_job);
+		const auto cpu = thread_ctrl::get_current();
+		transport_packet* m_current_job = m_thread->m_current_job;
+
+		for (const auto& worker : m_thread->m_workers)
+		{
+			if (worker->current_thread_ == cpu)
+			{
+				m_current_job = worker->m_current_job;
+				break;
+			}
+		}
+
+		ensure(m_current_job);
 
 		void* address = nullptr;
 		u32 range = m_current_job->length;
@@ -4,6 +4,7 @@
 #include "util/address_range.h"
 #include "gcm_enums.h"
 
+#include <mutex>
 #include <vector>
 
 template <typename T>
@@ -56,10 +57,15 @@ namespace rsx
 		};
 
 		atomic_t<bool> m_mem_fault_flag = false;
+		std::mutex m_mem_fault_lock;
 
+		// The offload thread keeps the packet order. Transfers are handed to the copy workers by destination granule.
 		struct offload_thread;
+		struct copy_worker;
 		std::shared_ptr<named_thread<offload_thread>> m_thread;
 
+		static void execute(transport_packet& job);
+
 		// TODO: Improved benchmarks here; value determined by profiling on a Ryzen CPU, rounded to the nearest 512 bytes
 		const u32 max_immediate_transfer_size = 3584;
 
@@ -83,6 +89,8 @@ namespace rsx
 		bool is_current_thread() const;
 		bool sync() const;
 		void join();
+
+		// Serializes fault recovery between the offload threads, the flag is held until cleared
 		void set_mem_fault_flag();
 		void clear_mem_fault_flag();
 
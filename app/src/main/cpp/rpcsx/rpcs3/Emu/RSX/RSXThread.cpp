@@ -17,6 +17,7 @@
 #include "Emu/System.h"
 #include "Emu/Cell/PPUThread.h"
 #include "Emu/Cell/timers.hpp"
+#include "Emu/perf_trace.hpp"
 #include "cellos/sys_event.h"
 #include "cellos/sys_time.h"
 #include "rpcsx/fw/ps3/cellGcmSys.h"
@@ -1184,6 +1185,8 @@ namespace rsx
 
 	void thread::do_local_task(FIFO::state state)
 	{
+		perf_trace::scope trace(perf_trace::category::rsx, "RSX local task");
+
 		m_eng_interrupt_mask.clear(rsx::backend_interrupt);
 
 		if (async_flip_requested & flip_request::emu_requested)
@@ -1916,6 +1919,7 @@ namespace rsx
 		current_fragment_program.offset = program_offset + current_fp_metadata.program_start_offset;
 		current_fragment_program.ucode_length = current_fp_metadata.program_ucode_length;
 		current_fragment_program.total_length = current_fp_metadata.program_ucode_length + current_fp_metadata.program_start_offset;
+		current_fragment_program.ucode_generation++;
 		current_fragment_program.texture_state.import(current_fp_texture_state, current_fp_metadata.referenced_textures_mask);
 		current_fragment_program.valid = true;
 
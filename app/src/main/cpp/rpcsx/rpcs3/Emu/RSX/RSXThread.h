@@ -186,6 +186,7 @@ namespace rsx
 
 		static void fifo_wake_delay(u64 div = 1);
 		u32 get_fifo_cmd() const;
+		u32 get_fifo_ret_addr() const { return fifo_ret_addr; }
 
 		void dump_regs(std::string&, std::any& custom_data) const override;
 		void cpu_wait(rx::EnumBitSet<cpu_flag> old) override;
@@ -247,6 +248,23 @@ namespace rsx
 		rsx::atomic_bitmask_t<rsx::eng_interrupt_reason> m_eng_interrupt_mask;
 		rsx::bitmask_t<rsx::pipeline_state> m_graphics_state;
 
+		// Transform constants written through NV4097_SET_TRANSFORM_CONSTANT since the backend last consumed them,
+		// as [first, last) in vec4 units. first == umax means the invalidation did not come from register writes.
+		u32 m_transform_constants_dirty_first = umax;
+		u32 m_transform_constants_dirty_last = 0;
+
+		void mark_transform_constants_dirty_range(u32 first, u32 count)
+		{
+			m_transform_constants_dirty_first = std::min(m_transform_constants_dirty_first, first);
+			m_transform_constants_dirty_last = std::max(m_transform_constants_dirty_last, first + count);
+		}
+
+		void reset_transform_constants_dirty_range()
+		{
+			m_transform_constants_dirty_first = umax;
+			m_transform_constants_dirty_last = 0;
+		}
+
 		u64 ROP_sync_timestamp = 0;
 
 		program_hash_util::fragment_program_utils::fragment_program_metadata current_fp_metadata = {};
@@ -322,6 +340,8 @@ namespace rsx
 		reports::conditional_render_eval cond_render_ctrl;
 
 		virtual u64 get_cycles() = 0;
+		virtual u64 get_cpu_time() const = 0;
+		virtual u64 get_native_thread_id() { return 0; } // 0 if the backend does not expose its thread
 		virtual ~thread();
 
 		static constexpr auto thread_name = "rsx::thread"sv;
@@ -480,6 +500,23 @@ namespace rsx
 			return m_frame_stats;
 		}
 
+		// Backend totals for benchmarking. GPU timing is only collected while requested.
+		virtual backend_counters_t get_backend_counters() const
+		{
+			return {};
+		}
+
+		virtual void request_gpu_timing(bool /*enabled*/) {}
+
+		// Host memory pressure, handled like VRAM exhaustion at the next frame boundary
+		virtual void request_memory_relief(problem_severity /*severity*/) {}
+
+		// Most expensive passes and pipelines of the last measured frame, empty unless GPU pass timing is active
+		virtual std::vector<gpu_cost_entry> get_gpu_cost_breakdown() const
+		{
+			return {};
+		}
+
 		// Returns true if the current thread is the active RSX thread
 		inline bool is_current_thread() const
 		{
@@ -7,6 +7,8 @@ namespace rsx
 {
 	namespace reports
 	{
+		atomic_t<bool> g_zcull_speculation_allowed = true;
+
 		ZCULL_control::ZCULL_control()
 		{
 			for (auto& query : m_occlusion_query_data)
@@ -192,7 +194,11 @@ namespace rsx
 				break;
 			}
 
-			on_report_enqueued(sink);
+			if (on_report_enqueued(sink))
+			{
+				// The guest polls this page, leave a placeholder until the GPU result lands
+				write(sink, ptimer->timestamp(), type, get_speculative_result(sink));
+			}
 
 			ptimer->async_tasks_pending++;
 
@@ -362,6 +368,11 @@ namespace rsx
 
 		void ZCULL_control::write(queued_report_write* writer, u64 timestamp, u32 value)
 		{
+			if (speculation_enabled())
+			{
+				m_last_results[writer->sink] = value;
+			}
+
 			write(writer->sink, timestamp, writer->type, value);
 			on_report_completed(writer->sink);
 
@@ -808,7 +819,7 @@ namespace rsx
 			return bytes_to_write;
 		}
 
-		void ZCULL_control::on_report_enqueued(vm::addr_t address)
+		bool ZCULL_control::on_report_enqueued(vm::addr_t address)
 		{
 			const auto location = rsx::classify_location(address);
 			std::scoped_lock lock(m_pages_mutex);
@@ -819,6 +830,17 @@ namespace rsx
 				auto& page = m_locked_pages[location][page_address];
 				page.add_ref();
 
+				if (page.speculative)
+				{
+					if (speculation_enabled())
+					{
+						return true;
+					}
+
+					// Speculation was turned off, go back to trapping reads
+					page.speculative = false;
+				}
+
 				if (page.prot == utils::protection::rw)
 				{
 					utils::memory_protect(vm::base(page_address), utils::get_page_size(), utils::protection::no);
@@ -829,6 +851,8 @@ namespace rsx
 			{
 				m_critical_reports_in_flight++;
 			}
+
+			return false;
 		}
 
 		void ZCULL_control::on_report_completed(vm::addr_t address)
@@ -883,6 +907,51 @@ namespace rsx
 			m_locked_pages[location].clear();
 		}
 
+		bool ZCULL_control::speculation_enabled() const
+		{
+			return g_cfg.video.speculative_zcull_reports && g_zcull_speculation_allowed;
+		}
+
+		u32 ZCULL_control::get_speculative_result(vm::addr_t sink) const
+		{
+			// Without history, report the samples as visible. A false positive only costs some overdraw.
+			const auto found = m_last_results.find(sink);
+			return found != m_last_results.end() ? found->second : 1u;
+		}
+
+		void ZCULL_control::speculate_page(::rsx::thread* ptimer, u32 location, u32 page_address)
+		{
+			// Externally synchronized with the RSX thread
+			const u64 timestamp = ptimer->timestamp();
+
+			for (auto& writer : m_pending_writes)
+			{
+				if (!writer.sink)
+					break;
+
+				if (utils::page_start(static_cast<u32>(writer.sink)) == page_address)
+				{
+					write(writer.sink, timestamp, writer.type, get_speculative_result(writer.sink));
+				}
+			}
+
+			std::scoped_lock lock(m_pages_mutex);
+
+			if (auto found = m_locked_pages[location].find(page_address);
+				found != m_locked_pages[location].end())
+			{
+				auto& page = found->second;
+
+				if (page.prot != utils::protection::rw)
+				{
+					utils::memory_protect(vm::base(page_address), utils::get_page_size(), utils::protection::rw);
+					page.prot = utils::protection::rw;
+				}
+
+				page.speculative = true;
+			}
+		}
+
 		bool ZCULL_control::on_access_violation(u32 address)
 		{
 			const auto page_address = utils::page_start(address);
@@ -895,6 +964,7 @@ namespace rsx
 			}
 
 			bool need_disable_optimizations = false;
+			bool need_speculation = false;
 			{
 				reader_lock lock(m_pages_mutex);
 
@@ -906,7 +976,12 @@ namespace rsx
 					auto& fault_page = m_locked_pages[location][page_address];
 					if (fault_page.prot != utils::protection::rw)
 					{
-						if (fault_page.has_refs())
+						if (fault_page.has_refs() && speculation_enabled())
+						{
+							// R/W to active block, answer with placeholders and keep the queries in flight
+							need_speculation = true;
+						}
+						else if (fault_page.has_refs())
 						{
 							// R/W to active block
 							need_disable_optimizations = true; // Defer actual operation
@@ -925,6 +1000,14 @@ namespace rsx
 			}
 
 			// Deadlock avoidance, do not pause RSX FIFO eng while holding the pages lock
+			if (need_speculation)
+			{
+				auto thr = rsx::get_current_renderer();
+				rsx::eng_lock rlock(thr);
+				speculate_page(thr, location, page_address);
+				return true;
+			}
+
 			if (need_disable_optimizations)
 			{
 				auto thr = rsx::get_current_renderer();
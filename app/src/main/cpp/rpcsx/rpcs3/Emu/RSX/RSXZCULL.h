@@ -77,8 +77,12 @@ namespace rsx
 		struct MMIO_page_data_t : public rsx::ref_counted
 		{
 			utils::protection prot = utils::protection::rw;
+			bool speculative = false; // The guest polls this page, reports are written ahead of the GPU results
 		};
 
+		// Per-title switch for speculative reports, set by the frontend. Only effective with the config option enabled.
+		extern atomic_t<bool> g_zcull_speculation_allowed;
+
 		enum sync_control
 		{
 			sync_none = 0,
@@ -103,10 +107,17 @@ namespace rsx
 			atomic_t<s32> m_critical_reports_in_flight = {0};
 			shared_mutex m_pages_mutex;
 
-			void on_report_enqueued(vm::addr_t address);
+			// Last result retired to each report address, used as the speculative value
+			std::unordered_map<u32, u32> m_last_results;
+
+			bool on_report_enqueued(vm::addr_t address);
 			void on_report_completed(vm::addr_t address);
 			void disable_optimizations(class ::rsx::thread* ptimer, u32 location);
 
+			bool speculation_enabled() const;
+			u32 get_speculative_result(vm::addr_t sink) const;
+			void speculate_page(class ::rsx::thread* ptimer, u32 location, u32 page_address);
+
 		protected:
 			bool unit_enabled = false;        // The ZCULL unit is on
 			bool write_enabled = false;       // A surface in the ZCULL-monitored tile region has been loaded for rasterization
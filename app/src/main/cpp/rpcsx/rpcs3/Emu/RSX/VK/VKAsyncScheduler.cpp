@@ -49,28 +49,29 @@ namespace vk
 		auto pdev = get_current_renderer();
 		m_command_pool.create(*const_cast<render_device*>(pdev), pdev->get_transfer_queue_family());
 
+		// Sync objects are created as the rings first go around, most titles never use more than a few hundred.
+		// Mobile drivers back each one with a kernel object, creating all of them up front costs seconds on boot.
 		if (m_use_host_scheduler)
 		{
-			for (usz i = 0; i < events_pool_size; ++i)
-			{
-				auto sema = std::make_unique<semaphore>(*pdev);
-				m_semaphore_pool.emplace_back(std::move(sema));
-			}
-
-			return;
+			m_semaphore_pool.reserve(events_pool_size);
 		}
-
-		for (usz i = 0; i < events_pool_size; ++i)
+		else
 		{
-			auto ev = std::make_unique<vk::event>(*pdev, sync_domain::gpu);
-			m_events_pool.emplace_back(std::move(ev));
+			m_events_pool.reserve(events_pool_size);
 		}
 	}
 
 	void AsyncTaskScheduler::insert_sync_event()
 	{
 		ensure(m_current_cb);
-		auto& sync_label = m_events_pool[m_next_event_id++ % events_pool_size];
+
+		const usz event_id = m_next_event_id++ % events_pool_size;
+		if (event_id == m_events_pool.size())
+		{
+			m_events_pool.emplace_back(std::make_unique<vk::event>(*get_current_renderer(), sync_domain::gpu));
+		}
+
+		auto& sync_label = m_events_pool[event_id];
 
 		sync_label->reset();
 		sync_label->signal(*m_current_cb, m_dependency_info);
@@ -135,13 +136,15 @@ namespace vk
 
 	semaphore* AsyncTaskScheduler::get_sema()
 	{
-		if (m_semaphore_pool.empty())
+		ensure(m_use_host_scheduler);
+		std::lock_guard lock(m_submit_mutex);
+
+		const usz sema_id = m_next_semaphore_id++ % events_pool_size;
+		if (sema_id == m_semaphore_pool.size())
 		{
-			delayed_init();
-			ensure(!m_semaphore_pool.empty());
+			m_semaphore_pool.emplace_back(std::make_unique<semaphore>(*get_current_renderer()));
 		}
 
-		const u32 sema_id = static_cast<u32>(m_next_semaphore_id++ % m_semaphore_pool.size());
 		return m_semaphore_pool[sema_id].get();
 	}
 
@@ -101,16 +101,20 @@ namespace vk
 		return bindings;
 	}
 
-	std::tuple<VkPipelineLayout, VkDescriptorSetLayout> get_common_pipeline_layout(VkDevice dev)
+	std::tuple<VkPipelineLayout, VkDescriptorSetLayout> get_common_pipeline_layout(VkDevice dev, VkDescriptorSetLayout bindless_textures_layout)
 	{
 		const auto& binding_table = vk::get_current_renderer()->get_pipeline_binding_table();
+		const bool bindless = bindless_textures_layout != VK_NULL_HANDLE;
+		const u32 num_fs_samplers = binding_table.vertex_textures_first_bind_slot - binding_table.textures_first_bind_slot;
 		auto bindings = get_common_binding_table();
 		u32 idx = ::size32(bindings);
 
-		bindings.resize(binding_table.total_descriptor_bindings);
+		bindings.resize(binding_table.total_descriptor_bindings - (bindless ? num_fs_samplers : 0));
 
+		// Fragment textures, unless they live in the bindless set
+		const auto fs_textures_end = bindless ? binding_table.textures_first_bind_slot : binding_table.vertex_textures_first_bind_slot;
 		for (auto binding = binding_table.textures_first_bind_slot;
-			binding < binding_table.vertex_textures_first_bind_slot;
+			binding < fs_textures_end;
 			binding++)
 		{
 			bindings[idx].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -131,9 +135,9 @@ namespace vk
 			idx++;
 		}
 
-		ensure(idx == binding_table.total_descriptor_bindings);
+		ensure(idx == bindings.size());
 
-		std::array<VkPushConstantRange, 1> push_constants;
+		std::array<VkPushConstantRange, 2> push_constants;
 		push_constants[0].offset = 0;
 		push_constants[0].size = 16;
 		push_constants[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
@@ -144,13 +148,19 @@ namespace vk
 			push_constants[0].size = 20;
 		}
 
+		// Bindless texture slots
+		push_constants[1].offset = vk::bindless_texture_table::push_constants_offset;
+		push_constants[1].size = vk::bindless_texture_table::push_constants_size;
+		push_constants[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
 		const auto set_layout = vk::descriptors::create_layout(bindings);
+		const std::array<VkDescriptorSetLayout, 2> set_layouts = {set_layout, bindless_textures_layout};
 
 		VkPipelineLayoutCreateInfo layout_info = {};
 		layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		layout_info.setLayoutCount = 1;
-		layout_info.pSetLayouts = &set_layout;
-		layout_info.pushConstantRangeCount = 1;
+		layout_info.setLayoutCount = bindless ? 2 : 1;
+		layout_info.pSetLayouts = set_layouts.data();
+		layout_info.pushConstantRangeCount = bindless ? 2 : 1;
 		layout_info.pPushConstantRanges = push_constants.data();
 
 		VkPipelineLayout result;
@@ -7,7 +7,8 @@ namespace vk
 {
 	// Grab standard layout for decompiled RSX programs. Also used by the interpreter.
 	// FIXME: This generates a bloated monstrosity that needs to die.
-	std::tuple<VkPipelineLayout, VkDescriptorSetLayout> get_common_pipeline_layout(VkDevice dev);
+	// With a bindless set layout, fragment textures move to that set and are selected through fragment push constants.
+	std::tuple<VkPipelineLayout, VkDescriptorSetLayout> get_common_pipeline_layout(VkDevice dev, VkDescriptorSetLayout bindless_textures_layout = VK_NULL_HANDLE);
 
 	// Returns the standard binding layout without texture slots. Those have special handling depending on the consumer.
 	rsx::simple_array<VkDescriptorSetLayoutBinding> get_common_binding_table();
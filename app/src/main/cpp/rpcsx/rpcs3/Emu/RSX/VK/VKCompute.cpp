@@ -3,8 +3,10 @@
 #include "VKRenderPass.h"
 #include "vkutils/buffer_object.h"
 #include "VKPipelineCompiler.h"
+#include "VKQueryPool.h"
 
 #include "rx/align.hpp"
+#include "util/fnv_hash.hpp"
 
 #define VK_MAX_COMPUTE_TASKS 8192 // Max number of jobs per frame
 
@@ -151,6 +153,13 @@ namespace vk
 			auto compiler = vk::get_pipe_compiler();
 			m_program = compiler->compile(info, m_pipeline_layout, vk::pipe_compiler::COMPILE_INLINE);
 			declare_inputs();
+
+			// Stable across runs, identifies the task in GPU pass timing
+			m_src_hash = rpcs3::fnv_seed;
+			for (const char c : m_src)
+			{
+				m_src_hash = rpcs3::hash64(m_src_hash, static_cast<u8>(c));
+			}
 		}
 
 		ensure(m_used_descriptors < VK_MAX_COMPUTE_TASKS);
@@ -172,7 +181,19 @@ namespace vk
 		}
 
 		load_program(cmd);
+
+		const auto timer = g_gpu_frame_timer;
+		if (timer)
+		{
+			timer->begin_dispatch(cmd, m_src_hash);
+		}
+
 		VK_GET_SYMBOL(vkCmdDispatch)(cmd, invocations_x, invocations_y, invocations_z);
+
+		if (timer)
+		{
+			timer->end_dispatch(cmd);
+		}
 	}
 
 	void compute_task::run(const vk::command_buffer& cmd, u32 num_invocations)
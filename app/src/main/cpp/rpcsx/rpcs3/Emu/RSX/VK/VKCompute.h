@@ -25,6 +25,7 @@ namespace vk
 		VkDescriptorSetLayout m_descriptor_layout = nullptr;
 		VkPipelineLayout m_pipeline_layout = nullptr;
 		u32 m_used_descriptors = 0;
+		u64 m_src_hash = 0;
 
 		bool initialized = false;
 		bool unroll_loops = true;
@@ -490,6 +491,86 @@ namespace vk
 		}
 	};
 
+	// Decodes DXT1 (_Format = 1), DXT23 (_Format = 2) or DXT45 (_Format = 3) blocks into RGBA8 texels.
+	// Used when the host lacks BC texture support, replacing the CPU decode on upload.
+	template <u32 _Format>
+	struct cs_decode_dxt : compute_task
+	{
+		union params_t
+		{
+			u32 data[3];
+
+			struct
+			{
+				u32 width_in_blocks;
+				u32 block_rows;
+				u32 dst_pitch;
+			};
+		} params;
+
+		const vk::buffer* src_buffer = nullptr;
+		const vk::buffer* dst_buffer = nullptr;
+		u32 in_offset = 0;
+		u32 out_offset = 0;
+		u32 in_block_length = 0;
+		u32 out_block_length = 0;
+
+		static constexpr u32 block_size = (_Format == 1) ? 8 : 16;
+
+		cs_decode_dxt()
+		{
+			static_assert(_Format >= 1 && _Format <= 3, "Unsupported DXT format");
+
+			ssbo_count = 2;
+			use_push_constants = true;
+			push_constants_size = 12;
+
+			create();
+
+			m_src =
+#include "../Program/GLSLSnippets/GPUDecodeDXT.glsl"
+				;
+
+			const std::pair<std::string_view, std::string> syntax_replace[] =
+				{
+					{"%loc", "0"},
+					{"%set", "set = 0"},
+					{"%push_block", "push_constant"},
+					{"%ws", std::to_string(optimal_group_size)},
+					{"%_format", std::to_string(_Format)}};
+
+			m_src = fmt::replace_all(m_src, syntax_replace);
+		}
+
+		void bind_resources() override
+		{
+			m_program->bind_buffer({src_buffer->value, in_offset, in_block_length}, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_descriptor_set);
+			m_program->bind_buffer({dst_buffer->value, out_offset, out_block_length}, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_descriptor_set);
+		}
+
+		// dst_pitch is the output row length in texels and must fit a whole number of blocks
+		void run(const vk::command_buffer& cmd, const vk::buffer* dst, u32 out_offset, const vk::buffer* src, u32 in_offset, u32 width_in_blocks, u32 block_rows, u32 dst_pitch)
+		{
+			ensure(dst_pitch >= width_in_blocks * 4);
+
+			dst_buffer = dst;
+			src_buffer = src;
+
+			this->in_offset = in_offset;
+			this->out_offset = out_offset;
+			this->in_block_length = width_in_blocks * block_rows * block_size;
+			this->out_block_length = block_rows * 4 * dst_pitch * 4;
+
+			params.width_in_blocks = width_in_blocks;
+			params.block_rows = block_rows;
+			params.dst_pitch = dst_pitch;
+			VK_GET_SYMBOL(vkCmdPushConstants)(cmd, m_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, push_constants_size, params.data);
+
+			const u32 linear_invocations = rx::aligned_div(width_in_blocks * block_rows, optimal_group_size);
+			compute_task::run(cmd, linear_invocations);
+		}
+	};
+
 	struct cs_aggregator : compute_task
 	{
 		const buffer* src = nullptr;
@@ -7,6 +7,8 @@
 #include "vkutils/buffer_object.h"
 #include "vkutils/chip_class.h"
 
+#include "Emu/perf_trace.hpp"
+
 namespace vk
 {
 	VkImageViewType get_view_type(rsx::texture_dimension_extended type)
@@ -162,6 +164,30 @@ void VKGSRender::update_draw_state()
 		}
 	}
 
+	if (m_device->get_fragment_shading_rate_support())
+	{
+		// Declared dynamic in every pipeline, so it has to be set for each draw
+		VkExtent2D shading_rate = {1, 1};
+
+		// Alpha tested, depth exporting and multisampled draws keep full rate, coarse shading breaks their edges
+		const bool full_rate_only = rsx::method_registers.alpha_test_enabled() ||
+			(rsx::method_registers.shader_control() & CELL_GCM_SHADER_CONTROL_DEPTH_EXPORT) ||
+			rsx::method_registers.surface_antialias() != rsx::surface_antialiasing::center_1_sample;
+
+		if (!full_rate_only)
+		{
+			switch (rsx::g_dynamic_resolution.latched_shading_rate)
+			{
+			case 0: break;
+			case 1: shading_rate = {2, 1}; break;
+			default: shading_rate = {2, 2}; break;
+			}
+		}
+
+		const VkFragmentShadingRateCombinerOpKHR combiner_ops[2] = {VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR, VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR};
+		m_device->_vkCmdSetFragmentShadingRateKHR(*m_current_command_buffer, &shading_rate, combiner_ops);
+	}
+
 	// The remaining dynamic state should only be set once and we have signals to enable/disable mid-renderpass
 	if (!(m_current_command_buffer->flags & vk::command_buffer::cb_reload_dynamic_state))
 	{
@@ -515,6 +541,36 @@ bool VKGSRender::bind_texture_env()
 {
 	bool out_of_memory = false;
 
+	auto bind_fragment_texture = [&](const VkDescriptorImageInfo& image_info, u32 index, bool is_stencil_mirror = false)
+	{
+		if (!m_bindless_textures)
+		{
+			m_program->bind_uniform(image_info,
+				index,
+				::glsl::program_domain::glsl_fragment_program,
+				m_current_frame->descriptor_set,
+				is_stencil_mirror);
+			return;
+		}
+
+		u32 slot = m_bindless_textures->get_slot(image_info.imageView, image_info.sampler, image_info.imageLayout);
+		if (slot == vk::bindless_texture_table::invalid_slot) [[unlikely]]
+		{
+			// Table is full. Treat it like OOM so that evictions get a chance to release slots.
+			out_of_memory = true;
+			slot = 0;
+		}
+
+		if (is_stencil_mirror)
+		{
+			m_bindless_fs_slots[index] = (m_bindless_fs_slots[index] & 0xffff) | (slot << 16);
+		}
+		else
+		{
+			m_bindless_fs_slots[index] = (m_bindless_fs_slots[index] & 0xffff0000) | slot;
+		}
+	};
+
 	for (u32 textures_ref = current_fp_metadata.referenced_textures_mask, i = 0; textures_ref; textures_ref >>= 1, ++i)
 	{
 		if (!(textures_ref & 1))
@@ -542,10 +598,7 @@ bool VKGSRender::bind_texture_env()
 
 		if (view) [[likely]]
 		{
-			m_program->bind_uniform({fs_sampler_handles[i]->value, view->value, view->image()->current_layout},
-				i,
-				::glsl::program_domain::glsl_fragment_program,
-				m_current_frame->descriptor_set);
+			bind_fragment_texture({fs_sampler_handles[i]->value, view->value, view->image()->current_layout}, i);
 
 			if (current_fragment_program.texture_state.redirected_textures & (1 << i))
 			{
@@ -564,28 +617,17 @@ bool VKGSRender::bind_texture_env()
 						VK_BORDER_COLOR_INT_OPAQUE_BLACK);
 				}
 
-				m_program->bind_uniform({m_stencil_mirror_sampler->value, stencil_view->value, stencil_view->image()->current_layout},
-					i,
-					::glsl::program_domain::glsl_fragment_program,
-					m_current_frame->descriptor_set,
-					true);
+				bind_fragment_texture({m_stencil_mirror_sampler->value, stencil_view->value, stencil_view->image()->current_layout}, i, true);
 			}
 		}
 		else
 		{
 			const VkImageViewType view_type = vk::get_view_type(current_fragment_program.get_texture_dimension(i));
-			m_program->bind_uniform({vk::null_sampler(), vk::null_image_view(*m_current_command_buffer, view_type)->value, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
-				i,
-				::glsl::program_domain::glsl_fragment_program,
-				m_current_frame->descriptor_set);
+			bind_fragment_texture({vk::null_sampler(), vk::null_image_view(*m_current_command_buffer, view_type)->value, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}, i);
 
 			if (current_fragment_program.texture_state.redirected_textures & (1 << i))
 			{
-				m_program->bind_uniform({vk::null_sampler(), vk::null_image_view(*m_current_command_buffer, view_type)->value, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
-					i,
-					::glsl::program_domain::glsl_fragment_program,
-					m_current_frame->descriptor_set,
-					true);
+				bind_fragment_texture({vk::null_sampler(), vk::null_image_view(*m_current_command_buffer, view_type)->value, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}, i, true);
 			}
 		}
 	}
@@ -714,6 +756,20 @@ bool VKGSRender::bind_interpreter_texture_env()
 	return out_of_memory;
 }
 
+u64 VKGSRender::get_current_pipeline_hash() const
+{
+	// The interpreter runs every shader pair, report it as a single pipeline
+	if (m_shader_interpreter.is_interpreter(m_program))
+	{
+		return 0;
+	}
+
+	// Storage hashes cache the ucode hash per program generation, stable across runs
+	const usz vp_hash = program_hash_util::vertex_program_storage_hash{}(current_vertex_program);
+	const usz fp_hash = program_hash_util::fragment_program_storage_hash{}(current_fragment_program);
+	return rpcs3::hash64(rpcs3::hash64(rpcs3::fnv_seed, vp_hash), fp_hash);
+}
+
 void VKGSRender::emit_geometry(u32 sub_index)
 {
 	auto& draw_call = rsx::method_registers.current_draw_clause;
@@ -843,11 +899,18 @@ void VKGSRender::emit_geometry(u32 sub_index)
 		VkDescriptorSet previous_set = m_current_frame->descriptor_set.value();
 		m_current_frame->descriptor_set.flush();
 		m_current_frame->descriptor_set = allocate_descriptor_set();
-		rsx::simple_array<VkCopyDescriptorSet> copy_cmds(binding_table.total_descriptor_bindings);
+		rsx::simple_array<VkCopyDescriptorSet> copy_cmds;
+		copy_cmds.reserve(binding_table.total_descriptor_bindings);
 
 		for (u32 n = 0; n < binding_table.total_descriptor_bindings; ++n)
 		{
-			copy_cmds[n] =
+			if (m_bindless_textures && n >= binding_table.textures_first_bind_slot && n < binding_table.vertex_textures_first_bind_slot)
+			{
+				// Not part of the set layout, fragment textures are in the bindless set
+				continue;
+			}
+
+			copy_cmds.push_back(
 				{
 					VK_STRUCTURE_TYPE_COPY_DESCRIPTOR_SET,   // sType
 					nullptr,                                 // pNext
@@ -858,7 +921,7 @@ void VKGSRender::emit_geometry(u32 sub_index)
 					n,                                       // dstBinding
 					0u,                                      // dstArrayElement
 					1u                                       // descriptorCount
-				};
+				});
 		}
 
 		m_current_frame->descriptor_set.push(copy_cmds);
@@ -919,6 +982,20 @@ void VKGSRender::emit_geometry(u32 sub_index)
 
 	// Bind the new set of descriptors for use with this draw call
 	m_current_frame->descriptor_set.bind(*m_current_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_program->pipeline_layout);
+
+	if (m_bindless_textures && !m_shader_interpreter.is_interpreter(m_program))
+	{
+		// The table set never changes, only the slots do. Both are cheap to re-emit and survive command buffer switches this way.
+		m_bindless_textures->bind(*m_current_command_buffer, m_program->pipeline_layout);
+		VK_GET_SYMBOL(vkCmdPushConstants)(*m_current_command_buffer, m_program->pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT,
+			vk::bindless_texture_table::push_constants_offset, vk::bindless_texture_table::push_constants_size, m_bindless_fs_slots.data());
+	}
+
+	if (m_gpu_frame_timer && m_gpu_frame_timer->is_pass_timing_enabled())
+	{
+		m_gpu_frame_timer->on_draw(get_current_pipeline_hash());
+	}
+
 	m_frame_stats.setup_time += m_profiler.duration();
 
 	if (!upload_info.index_info)
@@ -999,6 +1076,8 @@ void VKGSRender::begin()
 
 void VKGSRender::end()
 {
+	perf_trace::scope trace(perf_trace::category::rsx, "RSX draw");
+
 	if (skip_current_frame || !m_graphics_state.test(rsx::rtt_config_valid) || swapchain_unavailable || cond_render_ctrl.disable_rendering())
 	{
 		execute_nop_draw();
@@ -1035,6 +1114,7 @@ void VKGSRender::end()
 	if (!load_program())
 	{
 		// Program is not ready, skip drawing this
+		vk::g_pipeline_draw_stats.skipped_draws++;
 		std::this_thread::yield();
 		execute_nop_draw();
 		// m_rtts.on_write(); - breaks games for obvious reasons
@@ -1042,6 +1122,11 @@ void VKGSRender::end()
 		return;
 	}
 
+	if (m_shader_interpreter.is_interpreter(m_program))
+	{
+		vk::g_pipeline_draw_stats.interpreter_draws++;
+	}
+
 	// Allocate descriptor set
 	m_current_frame->descriptor_set = allocate_descriptor_set();
 
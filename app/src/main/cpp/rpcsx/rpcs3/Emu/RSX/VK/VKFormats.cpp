@@ -212,6 +212,7 @@ namespace vk
 	VkFormat get_compatible_sampler_format(const gpu_formats_support& support, u32 format)
 	{
 		const bool supports_dxt = vk::get_current_renderer()->get_texture_compression_bc_support();
+		const auto dxt1_fallback_format = vk::get_current_renderer()->get_dxt1_astc_transcode_support() ? VK_FORMAT_ASTC_4x4_UNORM_BLOCK : VK_FORMAT_B8G8R8A8_UNORM;
 		switch (format)
 		{
 #ifndef __APPLE__
@@ -232,7 +233,7 @@ namespace vk
 #endif
 		case CELL_GCM_TEXTURE_B8: return VK_FORMAT_R8_UNORM;
 		case CELL_GCM_TEXTURE_A8R8G8B8: return VK_FORMAT_B8G8R8A8_UNORM;
-		case CELL_GCM_TEXTURE_COMPRESSED_DXT1: return supports_dxt ? VK_FORMAT_BC1_RGBA_UNORM_BLOCK : VK_FORMAT_B8G8R8A8_UNORM;
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT1: return supports_dxt ? VK_FORMAT_BC1_RGBA_UNORM_BLOCK : dxt1_fallback_format;
 		case CELL_GCM_TEXTURE_COMPRESSED_DXT23: return supports_dxt ? VK_FORMAT_BC2_UNORM_BLOCK : VK_FORMAT_B8G8R8A8_UNORM;
 		case CELL_GCM_TEXTURE_COMPRESSED_DXT45: return supports_dxt ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_B8G8R8A8_UNORM;
 		case CELL_GCM_TEXTURE_G8B8: return VK_FORMAT_R8G8_UNORM;
@@ -269,6 +270,8 @@ namespace vk
 			return VK_FORMAT_BC2_SRGB_BLOCK;
 		case VK_FORMAT_BC3_UNORM_BLOCK:
 			return VK_FORMAT_BC3_SRGB_BLOCK;
+		case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+			return VK_FORMAT_ASTC_4x4_SRGB_BLOCK;
 		default:
 			return rgb_format;
 		}
@@ -303,6 +306,8 @@ namespace vk
 		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
 		case VK_FORMAT_BC2_SRGB_BLOCK:
 		case VK_FORMAT_BC3_SRGB_BLOCK:
+		case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+		case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
 			return 4;
 		case VK_FORMAT_R16G16B16A16_SFLOAT:
 			return 8;
@@ -360,13 +365,15 @@ namespace vk
 			return {4, 1}; // FLOAT
 		case VK_FORMAT_R32G32B32A32_SFLOAT:
 			return {4, 4}; // FLOAT
-		// DXT
+		// DXT (and DXT1 transcoded to ASTC)
 		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
 		case VK_FORMAT_BC2_UNORM_BLOCK:
 		case VK_FORMAT_BC3_UNORM_BLOCK:
 		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
 		case VK_FORMAT_BC2_SRGB_BLOCK:
 		case VK_FORMAT_BC3_SRGB_BLOCK:
+		case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+		case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
 			return {4, 1};
 		// Depth
 		case VK_FORMAT_D16_UNORM:
@@ -420,6 +427,8 @@ namespace vk
 		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
 		case VK_FORMAT_BC2_SRGB_BLOCK:
 		case VK_FORMAT_BC3_SRGB_BLOCK:
+		case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+		case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
 			return {false, 1};
 			// Depth
 		case VK_FORMAT_D16_UNORM:
@@ -95,6 +95,9 @@ void VKFragmentDecompilerThread::insertOutputs(std::stringstream& OS)
 void VKFragmentDecompilerThread::insertConstants(std::stringstream& OS)
 {
 	u32 location = m_binding_table.textures_first_bind_slot;
+	std::set<std::string> bindless_sampler_types;
+	std::stringstream bindless_samplers;
+
 	for (const ParamType& PT : m_parr.params[PF_PARAM_UNIFORM])
 	{
 		if (PT.type != "sampler1D" &&
@@ -132,6 +135,21 @@ void VKFragmentDecompilerThread::insertConstants(std::stringstream& OS)
 				}
 			}
 
+			if (m_bindless_textures)
+			{
+				// Slot of the texture in the low half of the push constant word, stencil mirror in the high half
+				bindless_sampler_types.insert(samplerType);
+				bindless_samplers << "#define " << PI.name << " _bindless_" << samplerType << "[_bindless_fs_slots[" << index << "] & 0xffff]\n";
+
+				if (properties.redirected_sampler_mask & mask)
+				{
+					bindless_sampler_types.insert("u" + samplerType);
+					bindless_samplers << "#define " << PI.name << "_stencil _bindless_u" << samplerType << "[_bindless_fs_slots[" << index << "] >> 16]\n";
+				}
+
+				continue;
+			}
+
 			vk::glsl::program_input in;
 			in.location = location;
 			in.domain = glsl::glsl_fragment_program;
@@ -157,6 +175,22 @@ void VKFragmentDecompilerThread::insertConstants(std::stringstream& OS)
 
 	ensure(location <= m_binding_table.vertex_textures_first_bind_slot); // "Too many sampler descriptors!"
 
+	if (!bindless_sampler_types.empty())
+	{
+		// All declarations alias the same binding, each slot is only read through the type matching its view
+		for (const auto& type : bindless_sampler_types)
+		{
+			OS << "layout(set=" << vk::bindless_texture_table::set_index << ", binding=0) uniform " << type << " _bindless_" << type << "[" << vk::bindless_texture_table::max_slots << "];\n";
+		}
+
+		OS << "\n";
+		OS << "layout(push_constant) uniform BindlessTextureSlots\n";
+		OS << "{\n";
+		OS << "	layout(offset=" << vk::bindless_texture_table::push_constants_offset << ") uint _bindless_fs_slots[16];\n";
+		OS << "};\n\n";
+		OS << bindless_samplers.str() << "\n";
+	}
+
 	std::string constants_block;
 	for (const ParamType& PT : m_parr.params[PF_PARAM_UNIFORM])
 	{
@@ -396,6 +430,7 @@ void VKFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 
 	decompiler.device_props.emulate_depth_compare = !pdev->get_formats_support().d24_unorm_s8;
 	decompiler.device_props.has_low_precision_rounding = vk::is_NVIDIA(vk::get_driver_vendor());
+	decompiler.m_bindless_textures = pdev->get_bindless_textures_support();
 	decompiler.Task();
 
 	shader.create(::glsl::program_domain::glsl_fragment_program, source);
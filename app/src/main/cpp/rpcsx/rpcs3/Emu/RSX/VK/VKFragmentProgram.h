@@ -20,6 +20,7 @@ struct VKFragmentDecompilerThread : public FragmentProgramDecompiler
 	class VKFragmentProgram* vk_prog;
 	glsl::shader_properties m_shader_props{};
 	vk::pipeline_binding_table m_binding_table{};
+	bool m_bindless_textures = false; // Fragment textures are read from vk::bindless_texture_table
 
 public:
 	VKFragmentDecompilerThread(std::string& shader, ParamArray& parr, const RSXFragmentProgram& prog, u32& size, class VKFragmentProgram& dst)
@@ -19,6 +19,7 @@
 #include "Emu/RSX/Host/RSXDMAWriter.h"
 #include "Emu/RSX/NV47/HW/context_accessors.define.h"
 #include "Emu/Memory/vm_locking.h"
+#include "Emu/perf_trace.hpp"
 
 #include "../Program/SPIRVCommon.h"
 
@@ -27,6 +28,8 @@
 
 namespace vk
 {
+	pipeline_draw_stats g_pipeline_draw_stats;
+
 	VkCompareOp get_compare_func(rsx::comparison_function op, bool reverse_direction = false);
 
 	std::pair<VkFormat, VkComponentMapping> get_compatible_surface_format(rsx::surface_color_format color_format)
@@ -406,6 +409,16 @@ u64 VKGSRender::get_cycles()
 	return thread_ctrl::get_cycles(static_cast<named_thread<VKGSRender>&>(*this));
 }
 
+u64 VKGSRender::get_cpu_time() const
+{
+	return thread_ctrl::get_cpu_time(static_cast<const named_thread<VKGSRender>&>(*this));
+}
+
+u64 VKGSRender::get_native_thread_id()
+{
+	return thread_ctrl::get_native_id(static_cast<named_thread<VKGSRender>&>(*this));
+}
+
 VKGSRender::VKGSRender(utils::serial* ar) noexcept : GSRender(ar)
 {
 	// Initialize dependencies
@@ -494,7 +507,13 @@ VKGSRender::VKGSRender(utils::serial* ar) noexcept : GSRender(ar)
 	m_secondary_cb_list.create(m_secondary_command_buffer_pool, vk::command_buffer::access_type_hint::all);
 
 	// Precalculated stuff
-	std::tie(m_pipeline_layout, m_descriptor_layouts) = vk::get_common_pipeline_layout(*m_device);
+	if (m_device->get_bindless_textures_support())
+	{
+		m_bindless_textures = std::make_unique<vk::bindless_texture_table>();
+		m_bindless_textures->create(*m_device);
+	}
+
+	std::tie(m_pipeline_layout, m_descriptor_layouts) = vk::get_common_pipeline_layout(*m_device, m_bindless_textures ? m_bindless_textures->layout() : VK_NULL_HANDLE);
 
 	// Occlusion
 	m_occlusion_query_manager = std::make_unique<vk::query_pool_manager>(*m_device, VK_QUERY_TYPE_OCCLUSION, OCCLUSION_MAX_POOL_SIZE);
@@ -508,10 +527,16 @@ VKGSRender::VKGSRender(utils::serial* ar) noexcept : GSRender(ar)
 		m_occlusion_query_manager->set_control_flags(VK_QUERY_CONTROL_PRECISE_BIT, 0);
 	}
 
+	// GPU frame time for the frontend resolution scaler
+	if (m_device->get_timestamp_query_support())
+	{
+		m_gpu_frame_timer = std::make_unique<vk::gpu_frame_timer>(*m_device);
+	}
+
 	// Generate frame contexts
 	const u32 max_draw_calls = m_device->get_descriptor_max_draw_calls();
 	const auto& binding_table = m_device->get_pipeline_binding_table();
-	const u32 num_fs_samplers = binding_table.vertex_textures_first_bind_slot - binding_table.textures_first_bind_slot;
+	const u32 num_fs_samplers = m_bindless_textures ? 0 : binding_table.vertex_textures_first_bind_slot - binding_table.textures_first_bind_slot;
 
 	rsx::simple_array<VkDescriptorPoolSize> descriptor_type_sizes =
 		{
@@ -602,6 +627,7 @@ VKGSRender::VKGSRender(utils::serial* ar) noexcept : GSRender(ar)
 		vk::change_image_layout(*m_current_command_buffer, target_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, target_layout, range);
 	}
 
+	m_frames_in_flight = std::clamp<u32>(static_cast<u32>(g_cfg.video.vk.frames_in_flight.get()), 1, VK_MAX_ASYNC_FRAMES);
 	m_current_frame = &frame_context_storage[0];
 
 	m_texture_cache.initialize((*m_device), m_device->get_graphics_queue(),
@@ -807,6 +833,7 @@ VKGSRender::~VKGSRender()
 
 	// Upscaler (references some global resources)
 	m_upscaler.reset();
+	m_frame_generation.reset();
 
 	// Heaps
 	m_attrib_ring_info.destroy();
@@ -857,10 +884,13 @@ VKGSRender::~VKGSRender()
 
 	VK_GET_SYMBOL(vkDestroyPipelineLayout)(*m_device, m_pipeline_layout, nullptr);
 	VK_GET_SYMBOL(vkDestroyDescriptorSetLayout)(*m_device, m_descriptor_layouts, nullptr);
+	m_bindless_textures.reset();
 
 	// Queries
 	m_occlusion_query_manager.reset();
+	m_gpu_frame_timer.reset();
 	m_cond_render_buffer.reset();
+	m_frame_readback_buffer.reset();
 
 	// Command buffer
 	m_primary_cb_list.destroy();
@@ -908,12 +938,13 @@ bool VKGSRender::on_access_violation(u32 address, bool is_writing)
 		if (g_fxo->get<rsx::dma_manager>().is_current_thread())
 		{
 			// The offloader thread cannot handle flush requests
+			// With several copy workers, faults are handled one at a time
+			g_fxo->get<rsx::dma_manager>().set_mem_fault_flag();
 			ensure(!(m_queue_status & flush_queue_state::deadlock));
 
 			m_offloader_fault_range = g_fxo->get<rsx::dma_manager>().get_fault_range(is_writing);
 			m_offloader_fault_cause = (is_writing) ? rsx::invalidation_cause::write : rsx::invalidation_cause::read;
 
-			g_fxo->get<rsx::dma_manager>().set_mem_fault_flag();
 			m_queue_status |= flush_queue_state::deadlock;
 			m_eng_interrupt_mask |= rsx::backend_interrupt;
 
@@ -1237,6 +1268,9 @@ void VKGSRender::check_heap_status(u32 flags)
 			m_instancing_buffer_ring_info.reset_allocation_stats();
 			m_current_frame->reset_heap_ptrs();
 			m_last_heap_sync_time = rsx::get_shared_tag();
+
+			// The last constants upload may be overwritten from now on
+			m_transform_constants_upload_prog = nullptr;
 		}
 		else
 		{
@@ -1412,6 +1446,9 @@ void VKGSRender::clear_surface(u32 mask)
 
 	const bool full_frame = (scissor_w == fb_width && scissor_h == fb_height);
 	bool update_color = false, update_z = false;
+
+	// Attachments whose previous contents are fully overwritten by this clear
+	u32 discard_load_mask = 0;
 	auto surface_depth_format = rsx::method_registers.surface_depth_fmt();
 
 	if (auto ds = std::get<1>(m_rtts.m_bound_depth_stencil); mask & RSX_GCM_CLEAR_DEPTH_STENCIL_MASK)
@@ -1565,6 +1602,11 @@ void VKGSRender::clear_surface(u32 mask)
 					{
 						clear_descriptors.push_back({VK_IMAGE_ASPECT_COLOR_BIT, index, color_clear_values});
 					}
+
+					if (full_frame)
+					{
+						discard_load_mask |= (1u << m_draw_buffers.size()) - 1;
+					}
 				}
 				else
 				{
@@ -1605,6 +1647,11 @@ void VKGSRender::clear_surface(u32 mask)
 		if (depth_stencil_mask)
 		{
 			clear_descriptors.push_back({static_cast<VkImageAspectFlags>(depth_stencil_mask), 0, depth_stencil_clear_values});
+
+			if (full_frame && depth_stencil_mask == std::get<1>(m_rtts.m_bound_depth_stencil)->aspect())
+			{
+				discard_load_mask |= (1u << m_draw_buffers.size());
+			}
 		}
 
 		update_z = true;
@@ -1617,14 +1664,38 @@ void VKGSRender::clear_surface(u32 mask)
 
 	if (!clear_descriptors.empty())
 	{
-		begin_render_pass();
+		bool resumes_pass = false;
+		if (discard_load_mask && vk::is_renderpass_open(*m_current_command_buffer))
+		{
+			vk::renderpass_op(*m_current_command_buffer, [&](const vk::command_buffer&, VkRenderPass, VkFramebuffer fbo)
+			{
+				resumes_pass = (fbo == m_draw_fbo->value);
+			});
+		}
+
+		if (discard_load_mask && !resumes_pass)
+		{
+			// The pass opens with a clear of these attachments. Skip loading their old contents into tile memory.
+			const auto discard_key = vk::get_renderpass_key_discard_load(m_current_renderpass_key, discard_load_mask);
+			vk::begin_renderpass(
+				*m_current_command_buffer,
+				vk::get_renderpass(*m_device, discard_key),
+				m_draw_fbo->value,
+				{positionu{0u, 0u}, sizeu{m_draw_fbo->width(), m_draw_fbo->height()}},
+				get_render_pass());
+		}
+		else
+		{
+			begin_render_pass();
+		}
+
 		VK_GET_SYMBOL(vkCmdClearAttachments)(*m_current_command_buffer, ::size32(clear_descriptors), clear_descriptors.data(), 1, &region);
 	}
 }
 
-void VKGSRender::flush_command_queue(bool hard_sync, bool do_not_switch)
+void VKGSRender::flush_command_queue(bool hard_sync, bool do_not_switch, VkSemaphore signal_semaphore)
 {
-	close_and_submit_command_buffer();
+	close_and_submit_command_buffer(nullptr, VK_NULL_HANDLE, signal_semaphore);
 
 	if (hard_sync)
 	{
@@ -1665,6 +1736,11 @@ void VKGSRender::flush_command_queue(bool hard_sync, bool do_not_switch)
 	}
 
 	m_current_command_buffer->begin();
+
+	if (m_gpu_frame_timer)
+	{
+		m_gpu_frame_timer->begin_span(*m_current_command_buffer);
+	}
 }
 
 std::pair<volatile vk::host_data_t*, VkBuffer> VKGSRender::map_host_object_data() const
@@ -1986,6 +2062,8 @@ bool VKGSRender::load_program()
 
 		if (m_prog_buffer->check_cache_missed())
 		{
+			vk::g_pipeline_draw_stats.pipeline_misses++;
+
 			// Notify the user with HUD notification
 			if (g_cfg.misc.show_shader_compilation_hint)
 			{
@@ -2029,6 +2107,7 @@ bool VKGSRender::load_program()
 			if (was_interpreter)
 			{
 				m_graphics_state |= rsx::fragment_constants_dirty;
+				vk::g_pipeline_draw_stats.interpreter_swaps++;
 			}
 		}
 	}
@@ -2101,23 +2180,37 @@ void VKGSRender::load_program_env()
 	}
 	else if (update_transform_constants)
 	{
-		// Transform constants
-		usz mem_offset = 0;
-		auto alloc_storage = [&](usz size) -> std::pair<void*, usz>
+		// Only registers the bound program does not read were written since its own upload: that copy is still exact
+		const bool is_interpreter = m_shader_interpreter.is_interpreter(m_program);
+		const u32 dirty_first = m_transform_constants_dirty_first;
+		const u32 dirty_last = m_transform_constants_dirty_last;
+		const bool reuse_upload = !is_interpreter && m_vertex_prog && m_vertex_prog == m_transform_constants_upload_prog &&
+			dirty_first < dirty_last && !m_vertex_prog->overlaps_constants_range(dirty_first, dirty_last - dirty_first);
+
+		if (!reuse_upload)
 		{
-			const auto alignment = m_device->gpu().get_limits().minUniformBufferOffsetAlignment;
-			mem_offset = m_transform_constants_ring_info.alloc<1>(rx::alignUp(size, alignment));
-			return std::make_pair(m_transform_constants_ring_info.map(mem_offset, size), size);
-		};
+			// Transform constants
+			usz mem_offset = 0;
+			auto alloc_storage = [&](usz size) -> std::pair<void*, usz>
+			{
+				const auto alignment = m_device->gpu().get_limits().minUniformBufferOffsetAlignment;
+				mem_offset = m_transform_constants_ring_info.alloc<1>(rx::alignUp(size, alignment));
+				return std::make_pair(m_transform_constants_ring_info.map(mem_offset, size), size);
+			};
 
-		auto io_buf = rsx::io_buffer(alloc_storage);
-		upload_transform_constants(io_buf);
+			auto io_buf = rsx::io_buffer(alloc_storage);
+			upload_transform_constants(io_buf);
 
-		if (!io_buf.empty())
-		{
-			m_transform_constants_ring_info.unmap();
-			m_vertex_constants_buffer_info = {m_transform_constants_ring_info.heap->value, mem_offset, io_buf.size()};
+			if (!io_buf.empty())
+			{
+				m_transform_constants_ring_info.unmap();
+				m_vertex_constants_buffer_info = {m_transform_constants_ring_info.heap->value, mem_offset, io_buf.size()};
+			}
+
+			m_transform_constants_upload_prog = is_interpreter ? nullptr : m_vertex_prog;
 		}
+
+		reset_transform_constants_dirty_range();
 	}
 
 	if (update_fragment_constants && !m_shader_interpreter.is_interpreter(m_program))
@@ -2279,6 +2372,50 @@ bool VKGSRender::is_current_program_interpreted() const
 	return m_program && m_shader_interpreter.is_interpreter(m_program);
 }
 
+rsx::backend_counters_t VKGSRender::get_backend_counters() const
+{
+	rsx::backend_counters_t result{};
+	result.pipeline_misses = vk::g_pipeline_draw_stats.pipeline_misses;
+	result.texture_uploads = m_texture_cache.get_texture_uploads_total();
+
+	if (m_gpu_frame_timer)
+	{
+		result.gpu_time_us = m_gpu_frame_timer->get_total_gpu_time_us();
+		result.gpu_frames = m_gpu_frame_timer->get_measured_frames();
+	}
+
+	result.device_memory_bytes = m_device_memory_bytes;
+	result.texture_memory_bytes = m_texture_memory_bytes;
+	return result;
+}
+
+void VKGSRender::request_gpu_timing(bool enabled)
+{
+	if (m_gpu_frame_timer)
+	{
+		m_gpu_frame_timer->set_forced(enabled);
+	}
+}
+
+void VKGSRender::request_memory_relief(rsx::problem_severity severity)
+{
+	// Keep the strongest request until the RSX thread gets to it
+	m_requested_memory_relief.fetch_op([&](u8& value)
+		{
+			value = std::max<u8>(value, static_cast<u8>(severity) + 1);
+		});
+}
+
+std::vector<rsx::gpu_cost_entry> VKGSRender::get_gpu_cost_breakdown() const
+{
+	if (m_gpu_frame_timer)
+	{
+		return m_gpu_frame_timer->get_last_breakdown();
+	}
+
+	return {};
+}
+
 void VKGSRender::upload_transform_constants(const rsx::io_buffer& buffer)
 {
 	const bool is_interpreter = m_shader_interpreter.is_interpreter(m_program);
@@ -2330,7 +2467,8 @@ void VKGSRender::update_vertex_env(u32 id, const vk::vertex_upload_info& vertex_
 		data_size = 20;
 	}
 
-	VK_GET_SYMBOL(vkCmdPushConstants)(*m_current_command_buffer, m_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, data_size, draw_info);
+	// Use the layout of the bound program, the interpreter layout has no bindless push constant range
+	VK_GET_SYMBOL(vkCmdPushConstants)(*m_current_command_buffer, m_program->pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, data_size, draw_info);
 
 	const usz data_offset = (id * 128) + m_vertex_layout_stream_info.offset;
 	auto dst = m_vertex_layout_ring_info.map(data_offset, 128);
@@ -2353,6 +2491,7 @@ void VKGSRender::patch_transform_constants(rsx::context* ctx, u32 index, u32 cou
 	{
 		// Shouldn't be reachable, but handle it correctly anyway
 		m_graphics_state |= rsx::pipeline_state::transform_constants_dirty;
+		mark_transform_constants_dirty_range(index, count);
 		return;
 	}
 
@@ -2447,6 +2586,8 @@ void VKGSRender::init_buffers(rsx::framebuffer_creation_context context, bool)
 
 void VKGSRender::close_and_submit_command_buffer(vk::fence* pFence, VkSemaphore wait_semaphore, VkSemaphore signal_semaphore, VkPipelineStageFlags pipeline_stage_flags)
 {
+	perf_trace::scope trace(perf_trace::category::vk, "VK submit");
+
 	ensure(!m_queue_status.test_and_set(flush_queue_state::flushing));
 
 	// Host MM sync before executing anything on the GPU
@@ -2528,6 +2669,11 @@ void VKGSRender::close_and_submit_command_buffer(vk::fence* pFence, VkSemaphore
 		m_host_dma_ctrl->host_ctx()->on_label_release();
 	}
 
+	if (m_gpu_frame_timer)
+	{
+		m_gpu_frame_timer->end_span(*m_current_command_buffer);
+	}
+
 	m_current_command_buffer->end();
 	m_current_command_buffer->tag();
 
@@ -2541,6 +2687,12 @@ void VKGSRender::close_and_submit_command_buffer(vk::fence* pFence, VkSemaphore
 		primary_submit_info.wait_on(wait_semaphore, pipeline_stage_flags);
 	}
 
+	if (m_present_compute_semaphore)
+	{
+		// This submission acquires the results of the async upscaling pass
+		primary_submit_info.wait_on(std::exchange(m_present_compute_semaphore, VK_NULL_HANDLE), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+	}
+
 	if (auto async_scheduler = g_fxo->try_get<vk::AsyncTaskScheduler>();
 		async_scheduler && async_scheduler->is_recording())
 	{
@@ -2674,6 +2826,11 @@ void VKGSRender::prepare_rtts(rsx::framebuffer_creation_context context)
 		m_depth_surface_info.pitch = m_framebuffer_layout.actual_zeta_pitch;
 		ensure(ds->rsx_pitch == m_framebuffer_layout.actual_zeta_pitch);
 
+		if (const u32 area = ds->width() * ds->height(); area > m_scene_depth_hint.area)
+		{
+			m_scene_depth_hint = {m_framebuffer_layout.zeta_address, area};
+		}
+
 		m_texture_cache.notify_surface_changed(m_depth_surface_info.get_memory_range(m_framebuffer_layout.aa_factors));
 	}
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "upscalers/upscaling.h"
+#include "upscalers/frame_generation_pass.h"
 
 #include "vkutils/descriptors.h"
 #include "vkutils/data_heap.h"
@@ -62,6 +63,7 @@ private:
 private:
 	const VKFragmentProgram* m_fragment_prog = nullptr;
 	const VKVertexProgram* m_vertex_prog = nullptr;
+	const VKVertexProgram* m_transform_constants_upload_prog = nullptr; // Layout of m_vertex_constants_buffer_info, null if unknown
 	vk::glsl::program* m_program = nullptr;
 	vk::glsl::program* m_prev_program = nullptr;
 	vk::pipeline_props m_pipeline_properties;
@@ -74,10 +76,24 @@ private:
 
 	std::unique_ptr<vk::upscaler> m_upscaler;
 	output_scaling_mode m_output_scaling{output_scaling_mode::bilinear};
+	std::unique_ptr<vk::frame_generation_pass> m_frame_generation;
+
+	// Largest depth target bound during the frame. Used as the scene depth by the temporal upscaler.
+	struct
+	{
+		u32 address = 0;
+		u32 area = 0;
+	} m_scene_depth_hint;
+
+	// Signaled by the async upscaling pass, waited on by the next primary submission
+	VkSemaphore m_present_compute_semaphore = VK_NULL_HANDLE;
 
 	std::unique_ptr<vk::buffer> m_cond_render_buffer;
 	u64 m_cond_render_sync_tag = 0;
 
+	// Host-visible target for screenshot/recording readback, kept across frames while recording
+	std::unique_ptr<vk::buffer> m_frame_readback_buffer;
+
 	shared_mutex m_sampler_mutex;
 	atomic_t<bool> m_samplers_dirty = {true};
 	std::unique_ptr<vk::sampler> m_stencil_mirror_sampler;
@@ -105,6 +121,12 @@ private:
 
 	// Vulkan internals
 	std::unique_ptr<vk::query_pool_manager> m_occlusion_query_manager;
+	std::unique_ptr<vk::gpu_frame_timer> m_gpu_frame_timer;
+
+	// Host memory accounting for the frontend, sampled on the frame boundary
+	atomic_t<u8> m_requested_memory_relief = 0; // problem_severity + 1, 0 if none
+	atomic_t<u64> m_device_memory_bytes = 0;
+	atomic_t<u64> m_texture_memory_bytes = 0;
 	bool m_occlusion_query_active = false;
 	rsx::reports::occlusion_query_info* m_active_query_info = nullptr;
 	std::vector<vk::occlusion_data> m_occlusion_map;
@@ -123,6 +145,10 @@ private:
 	VkDescriptorSetLayout m_descriptor_layouts = VK_NULL_HANDLE;
 	VkPipelineLayout m_pipeline_layout = VK_NULL_HANDLE;
 
+	// Optional, fragment textures of recompiled programs are selected by slot instead of written per draw
+	std::unique_ptr<vk::bindless_texture_table> m_bindless_textures;
+	std::array<u32, rsx::limits::fragment_textures_count> m_bindless_fs_slots{};
+
 	vk::framebuffer_holder* m_draw_fbo = nullptr;
 
 	sizeu m_swapchain_dims{};
@@ -166,6 +192,7 @@ private:
 	vk::frame_context_t m_aux_frame_context;
 
 	u32 m_current_queue_index = 0;
+	u32 m_frames_in_flight = 2; // Frames FIFO processing may run ahead of the GPU, <= VK_MAX_ASYNC_FRAMES
 	vk::frame_context_t* m_current_frame = nullptr;
 	std::deque<vk::frame_context_t*> m_queued_frames;
 
@@ -201,6 +228,8 @@ private:
 
 public:
 	u64 get_cycles() final;
+	u64 get_cpu_time() const final;
+	u64 get_native_thread_id() final;
 	~VKGSRender() override;
 
 	VKGSRender(utils::serial* ar) noexcept;
@@ -215,14 +244,15 @@ private:
 		VkSemaphore signal_semaphore = VK_NULL_HANDLE,
 		VkPipelineStageFlags pipeline_stage_flags = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
 
-	void flush_command_queue(bool hard_sync = false, bool do_not_switch = false);
-	void queue_swap_request();
+	void flush_command_queue(bool hard_sync = false, bool do_not_switch = false, VkSemaphore signal_semaphore = VK_NULL_HANDLE);
+	void queue_swap_request(bool generated_frame = false);
 	void frame_context_cleanup(vk::frame_context_t* ctx);
 	void advance_queued_frames();
 	void present(vk::frame_context_t* ctx);
 	void reinitialize_swapchain();
 
 	vk::viewable_image* get_present_source(vk::present_surface_info* info, const rsx::avconf& avconfig);
+	bool present_generated_frame(const rsx::avconf& avconfig, const areai& aspect_ratio, u32 buffer_width, u32 buffer_height);
 
 	void begin_render_pass();
 	void close_render_pass();
@@ -236,6 +266,7 @@ private:
 	VkDescriptorSet allocate_descriptor_set();
 
 	vk::vertex_upload_info upload_vertex_data();
+	bool upload_persistent_streams(u32 vertex_base, u32 vertex_count, u32& window_base, u32& window_length);
 	rsx::simple_array<u8> m_scratch_mem;
 
 	bool load_program();
@@ -284,6 +315,12 @@ public:
 
 	// Misc
 	bool is_current_program_interpreted() const override;
+	u64 get_current_pipeline_hash() const;
+
+	rsx::backend_counters_t get_backend_counters() const override;
+	void request_gpu_timing(bool enabled) override;
+	void request_memory_relief(rsx::problem_severity severity) override;
+	std::vector<rsx::gpu_cost_entry> get_gpu_cost_breakdown() const override;
 
 protected:
 	void clear_surface(u32 mask) override;
@@ -22,7 +22,7 @@
 #define VK_INDEX_RING_BUFFER_SIZE_M 16
 
 #define VK_MAX_ASYNC_CB_COUNT 512
-#define VK_MAX_ASYNC_FRAMES 2
+#define VK_MAX_ASYNC_FRAMES 3 // Frame context storage, the active depth is g_cfg.video.vk.frames_in_flight
 
 #define FRAME_PRESENT_TIMEOUT 10000000ull // 10 seconds
 #define GENERAL_WAIT_TIMEOUT 2000000ull   // 2 seconds
@@ -612,6 +612,9 @@ namespace vk
 		switch (type)
 		{
 		case rsx::overlays::primitive_type::quad_list:
+			// Expanded to triangles on upload
+			renderpass_config.set_primitive_type(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+			break;
 		case rsx::overlays::primitive_type::triangle_strip:
 			renderpass_config.set_primitive_type(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP);
 			break;
@@ -629,26 +632,6 @@ namespace vk
 		}
 	}
 
-	void ui_overlay_renderer::emit_geometry(vk::command_buffer& cmd)
-	{
-		if (m_current_primitive_type == rsx::overlays::primitive_type::quad_list)
-		{
-			// Emulate quads with disjointed triangle strips
-			u32 first = 0;
-			u32 num_quads = num_drawable_elements / 4;
-
-			for (u32 n = 0; n < num_quads; ++n)
-			{
-				VK_GET_SYMBOL(vkCmdDraw)(cmd, 4, 1, first, 0);
-				first += 4;
-			}
-		}
-		else
-		{
-			overlay_pass::emit_geometry(cmd);
-		}
-	}
-
 	void ui_overlay_renderer::run(vk::command_buffer& cmd, const areau& viewport, vk::framebuffer* target, VkRenderPass render_pass,
 		vk::data_heap& upload_heap, rsx::overlays::overlay& ui)
 	{
@@ -667,9 +650,34 @@ namespace vk
 
 		for (auto& command : ui.get_compiled().draw_commands)
 		{
-			num_drawable_elements = static_cast<u32>(command.verts.size());
+			if (command.config.primitives == rsx::overlays::primitive_type::quad_list)
+			{
+				// Each quad is a 4-vertex strip, as a triangle list the whole command is one draw instead of one per glyph
+				const usz num_quads = command.verts.size() / 4;
+				m_quad_expansion.resize(num_quads * 6);
+
+				for (usz n = 0; n < num_quads; ++n)
+				{
+					const auto quad = &command.verts[n * 4];
+					auto dst = &m_quad_expansion[n * 6];
+
+					dst[0] = quad[0];
+					dst[1] = quad[1];
+					dst[2] = quad[2];
+					dst[3] = quad[2];
+					dst[4] = quad[1];
+					dst[5] = quad[3];
+				}
+
+				num_drawable_elements = static_cast<u32>(m_quad_expansion.size());
+				upload_vertex_data(m_quad_expansion.data(), num_drawable_elements);
+			}
+			else
+			{
+				num_drawable_elements = static_cast<u32>(command.verts.size());
+				upload_vertex_data(command.verts.data(), num_drawable_elements);
+			}
 
-			upload_vertex_data(command.verts.data(), num_drawable_elements);
 			set_primitive_type(command.config.primitives);
 
 			m_time = command.config.get_sinus_value();
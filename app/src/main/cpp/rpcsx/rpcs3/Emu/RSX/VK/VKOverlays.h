@@ -157,6 +157,7 @@ namespace vk
 		std::unordered_map<u64, std::pair<u32, std::unique_ptr<vk::image>>> temp_image_cache;
 		std::unordered_map<u64, std::unique_ptr<vk::image_view>> temp_view_cache;
 		rsx::overlays::primitive_type m_current_primitive_type = rsx::overlays::primitive_type::quad_list;
+		std::vector<rsx::overlays::vertex> m_quad_expansion;
 
 		ui_overlay_renderer();
 
@@ -181,8 +182,6 @@ namespace vk
 
 		void set_primitive_type(rsx::overlays::primitive_type type);
 
-		void emit_geometry(vk::command_buffer& cmd) override;
-
 		void run(vk::command_buffer& cmd, const areau& viewport, vk::framebuffer* target, VkRenderPass render_pass,
 			vk::data_heap& upload_heap, rsx::overlays::overlay& ui);
 	};
@@ -5,6 +5,10 @@
 #include "util/Thread.h"
 
 #include "util/sysinfo.hpp"
+#include "util/mutex.h"
+#include "Emu/perf_trace.hpp"
+
+#include <bit>
 
 namespace vk
 {
@@ -13,6 +17,249 @@ namespace vk
 	int g_num_pipe_compilers = 0;
 	atomic_t<int> g_compiler_index{};
 
+	// VK_EXT_pipeline_creation_cache_control
+	// Deferred graphics compiles are first created with FAIL_ON_PIPELINE_COMPILE_REQUIRED. A driver cache hit returns
+	// the pipeline at once, so warm caches never fall back to the interpreter; only real compiles reach the workers.
+	bool g_probe_driver_cache = false;
+
+	namespace
+	{
+		// VK_EXT_graphics_pipeline_library
+		// The four pipeline parts are compiled and cached independently. RSX blend/depth/raster permutations of
+		// the same shader pair then only build the part that changed plus a cheap link, instead of a full pipeline.
+		class pipeline_library_cache
+		{
+		public:
+			enum part : u32
+			{
+				vertex_input = 0,
+				pre_rasterization,
+				fragment_shader,
+				fragment_output,
+
+				part_count
+			};
+
+			VkPipeline find(part which, u64 key)
+			{
+				reader_lock lock(m_mutex);
+				const auto found = m_libraries[which].find(key);
+				return found == m_libraries[which].end() ? VK_NULL_HANDLE : found->second;
+			}
+
+			// Returns the cached library if another compiler thread got there first
+			VkPipeline insert(const vk::render_device& dev, part which, u64 key, VkPipeline library)
+			{
+				std::lock_guard lock(m_mutex);
+				const auto [found, inserted] = m_libraries[which].try_emplace(key, library);
+				if (!inserted)
+				{
+					VK_GET_SYMBOL(vkDestroyPipeline)(dev, library, nullptr);
+				}
+				return found->second;
+			}
+
+			void clear(const vk::render_device& dev)
+			{
+				std::lock_guard lock(m_mutex);
+				for (auto& libraries : m_libraries)
+				{
+					for (const auto& [key, library] : libraries)
+					{
+						VK_GET_SYMBOL(vkDestroyPipeline)(dev, library, nullptr);
+					}
+					libraries.clear();
+				}
+			}
+
+		private:
+			shared_mutex m_mutex;
+			std::unordered_map<u64, VkPipeline> m_libraries[part_count];
+		};
+
+		pipeline_library_cache g_pipeline_libraries;
+		const vk::render_device* g_pipeline_library_device = nullptr;
+
+		template <typename T>
+		u64 hash_handle(u64 seed, T handle)
+		{
+			return rpcs3::hash64(seed, std::bit_cast<u64>(handle));
+		}
+
+		u64 hash_multisample_state(u64 seed, const VkPipelineMultisampleStateCreateInfo& ms)
+		{
+			seed = rpcs3::hash64(seed, static_cast<u32>(ms.rasterizationSamples));
+			seed = rpcs3::hash64(seed, ms.sampleShadingEnable);
+			seed = rpcs3::hash64(seed, std::bit_cast<u32>(ms.minSampleShading));
+			seed = rpcs3::hash64(seed, ms.alphaToCoverageEnable);
+			seed = rpcs3::hash64(seed, ms.alphaToOneEnable);
+			return rpcs3::hash64(seed, ms.pSampleMask ? *ms.pSampleMask : ~0u);
+		}
+
+		// Only the dynamic states owned by a library part may be declared on it
+		VkPipelineDynamicStateCreateInfo filter_dynamic_state(const VkPipelineDynamicStateCreateInfo& all, std::vector<VkDynamicState>& storage, std::initializer_list<VkDynamicState> owned)
+		{
+			storage.clear();
+			for (u32 i = 0; i < all.dynamicStateCount; ++i)
+			{
+				if (std::find(owned.begin(), owned.end(), all.pDynamicStates[i]) != owned.end())
+				{
+					storage.push_back(all.pDynamicStates[i]);
+				}
+			}
+
+			VkPipelineDynamicStateCreateInfo result = all;
+			result.pDynamicStates = storage.data();
+			result.dynamicStateCount = ::size32(storage);
+			return result;
+		}
+
+		VkPipeline create_pipeline_library(const vk::render_device& dev, VkGraphicsPipelineCreateInfo info, VkGraphicsPipelineLibraryFlagsEXT part_flags)
+		{
+			VkGraphicsPipelineLibraryCreateInfoEXT library_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT};
+			library_info.flags = part_flags;
+
+			info.pNext = &library_info;
+			info.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+			info.basePipelineIndex = -1;
+			info.basePipelineHandle = VK_NULL_HANDLE;
+
+			VkPipeline library = VK_NULL_HANDLE;
+			if (const auto error = VK_GET_SYMBOL(vkCreateGraphicsPipelines)(dev, VK_NULL_HANDLE, 1, &info, nullptr, &library))
+			{
+				rsx_log.error("Failed to create graphics pipeline library (part flags 0x%x): %d", part_flags, static_cast<int>(error));
+				return VK_NULL_HANDLE;
+			}
+			return library;
+		}
+
+		// Builds the missing parts of a monolithic create info and links them. Returns VK_NULL_HANDLE on failure.
+		VkPipeline link_pipeline_libraries(const vk::render_device& dev, const VkGraphicsPipelineCreateInfo& full, const vk::pipeline_props& props,
+			VkShaderModule modules[2], bool link_time_optimize)
+		{
+			using cache = pipeline_library_cache;
+			std::vector<VkDynamicState> dynamic_storage;
+
+			VkPipeline libraries[cache::part_count];
+
+			// Vertex input interface (attributes are fetched in the shader, only IA matters)
+			{
+				const u64 key = rpcs3::hash_struct(*full.pInputAssemblyState);
+				if (!(libraries[cache::vertex_input] = g_pipeline_libraries.find(cache::vertex_input, key)))
+				{
+					VkGraphicsPipelineCreateInfo info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+					info.pVertexInputState = full.pVertexInputState;
+					info.pInputAssemblyState = full.pInputAssemblyState;
+
+					const auto library = create_pipeline_library(dev, info, VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT);
+					if (!library) return VK_NULL_HANDLE;
+					libraries[cache::vertex_input] = g_pipeline_libraries.insert(dev, cache::vertex_input, key, library);
+				}
+			}
+
+			// Pre-rasterization: vertex shader + raster state
+			{
+				u64 key = hash_handle(rpcs3::hash_struct(*full.pRasterizationState), modules[0]);
+				key = hash_handle(key, full.layout);
+				key = rpcs3::hash64(key, props.renderpass_key);
+
+				if (!(libraries[cache::pre_rasterization] = g_pipeline_libraries.find(cache::pre_rasterization, key)))
+				{
+					const auto dynamic_state = filter_dynamic_state(*full.pDynamicState, dynamic_storage,
+						{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_LINE_WIDTH, VK_DYNAMIC_STATE_DEPTH_BIAS, VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR});
+
+					VkGraphicsPipelineCreateInfo info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+					info.stageCount = 1;
+					info.pStages = &full.pStages[0];
+					info.pViewportState = full.pViewportState;
+					info.pRasterizationState = full.pRasterizationState;
+					info.pDynamicState = &dynamic_state;
+					info.layout = full.layout;
+					info.renderPass = full.renderPass;
+
+					const auto library = create_pipeline_library(dev, info, VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT);
+					if (!library) return VK_NULL_HANDLE;
+					libraries[cache::pre_rasterization] = g_pipeline_libraries.insert(dev, cache::pre_rasterization, key, library);
+				}
+			}
+
+			// Fragment shader + depth/stencil
+			{
+				u64 key = hash_handle(rpcs3::hash_struct(*full.pDepthStencilState), modules[1]);
+				key = hash_multisample_state(key, *full.pMultisampleState);
+				key = hash_handle(key, full.layout);
+				key = rpcs3::hash64(key, props.renderpass_key);
+
+				if (!(libraries[cache::fragment_shader] = g_pipeline_libraries.find(cache::fragment_shader, key)))
+				{
+					const auto dynamic_state = filter_dynamic_state(*full.pDynamicState, dynamic_storage,
+						{VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK, VK_DYNAMIC_STATE_STENCIL_WRITE_MASK, VK_DYNAMIC_STATE_STENCIL_REFERENCE, VK_DYNAMIC_STATE_DEPTH_BOUNDS, VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR});
+
+					VkGraphicsPipelineCreateInfo info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+					info.stageCount = 1;
+					info.pStages = &full.pStages[1];
+					info.pDepthStencilState = full.pDepthStencilState;
+					info.pMultisampleState = full.pMultisampleState;
+					info.pDynamicState = &dynamic_state;
+					info.layout = full.layout;
+					info.renderPass = full.renderPass;
+
+					const auto library = create_pipeline_library(dev, info, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT);
+					if (!library) return VK_NULL_HANDLE;
+					libraries[cache::fragment_shader] = g_pipeline_libraries.insert(dev, cache::fragment_shader, key, library);
+				}
+			}
+
+			// Fragment output interface: blend state
+			{
+				const auto& cs = *full.pColorBlendState;
+				u64 key = rpcs3::hash64(rpcs3::fnv_seed, cs.attachmentCount);
+				key = rpcs3::hash64(key, cs.logicOpEnable);
+				key = rpcs3::hash64(key, static_cast<u32>(cs.logicOp));
+				for (u32 i = 0; i < cs.attachmentCount; ++i)
+				{
+					key ^= rpcs3::hash_struct(cs.pAttachments[i]) + i;
+				}
+				key = hash_multisample_state(key, *full.pMultisampleState);
+				key = rpcs3::hash64(key, props.renderpass_key);
+
+				if (!(libraries[cache::fragment_output] = g_pipeline_libraries.find(cache::fragment_output, key)))
+				{
+					const auto dynamic_state = filter_dynamic_state(*full.pDynamicState, dynamic_storage, {VK_DYNAMIC_STATE_BLEND_CONSTANTS});
+
+					VkGraphicsPipelineCreateInfo info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+					info.pColorBlendState = full.pColorBlendState;
+					info.pMultisampleState = full.pMultisampleState;
+					info.pDynamicState = &dynamic_state;
+					info.renderPass = full.renderPass;
+
+					const auto library = create_pipeline_library(dev, info, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT);
+					if (!library) return VK_NULL_HANDLE;
+					libraries[cache::fragment_output] = g_pipeline_libraries.insert(dev, cache::fragment_output, key, library);
+				}
+			}
+
+			VkPipelineLibraryCreateInfoKHR link_info{VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR};
+			link_info.libraryCount = cache::part_count;
+			link_info.pLibraries = libraries;
+
+			VkGraphicsPipelineCreateInfo info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+			info.pNext = &link_info;
+			info.flags = link_time_optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+			info.layout = full.layout;
+			info.basePipelineIndex = -1;
+			info.basePipelineHandle = VK_NULL_HANDLE;
+
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			if (const auto error = VK_GET_SYMBOL(vkCreateGraphicsPipelines)(dev, VK_NULL_HANDLE, 1, &info, nullptr, &pipeline))
+			{
+				rsx_log.error("Failed to link graphics pipeline libraries: %d", static_cast<int>(error));
+				return VK_NULL_HANDLE;
+			}
+			return pipeline;
+		}
+	} // namespace
+
 	pipe_compiler::pipe_compiler()
 	{
 		// TODO: Initialize workqueue
@@ -34,9 +281,12 @@ namespace vk
 		{
 			for (auto&& job : m_work_queue.pop_all())
 			{
+				perf_trace::scope trace(perf_trace::category::shader, job.is_graphics_job ? "VK pipeline compile" : "VK compute pipeline compile");
+
 				if (job.is_graphics_job)
 				{
-					auto compiled = int_compile_graphics_pipe(job.graphics_data, job.graphics_modules, job.pipe_layout, job.inputs, {});
+					// Off the draw thread, so pay for link-time optimization
+					auto compiled = int_compile_graphics_pipe(job.graphics_data, job.graphics_modules, job.pipe_layout, job.inputs, {}, true);
 					job.callback_func(compiled);
 				}
 				else
@@ -68,7 +318,8 @@ namespace vk
 	}
 
 	std::unique_ptr<glsl::program> pipe_compiler::int_compile_graphics_pipe(const vk::pipeline_props& create_info, VkShaderModule modules[2], VkPipelineLayout pipe_layout,
-		const std::vector<glsl::program_input>& vs_inputs, const std::vector<glsl::program_input>& fs_inputs)
+		const std::vector<glsl::program_input>& vs_inputs, const std::vector<glsl::program_input>& fs_inputs, bool link_time_optimize,
+		bool fail_on_compile_required)
 	{
 		VkPipelineShaderStageCreateInfo shader_stages[2] = {};
 		shader_stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -106,6 +357,11 @@ namespace vk
 			ds2.depthBoundsTestEnable = VK_FALSE;
 		}
 
+		if (g_render_device->get_fragment_shading_rate_support())
+		{
+			dynamic_state_descriptors.push_back(VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR);
+		}
+
 		VkPipelineDynamicStateCreateInfo dynamic_state_info = {};
 		dynamic_state_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 		dynamic_state_info.pDynamicStates = dynamic_state_descriptors.data();
@@ -162,6 +418,34 @@ namespace vk
 		info.basePipelineHandle = VK_NULL_HANDLE;
 		info.renderPass = vk::get_renderpass(*m_device, create_info.renderpass_key);
 
+		if (fail_on_compile_required)
+		{
+			// VK_PIPELINE_COMPILE_REQUIRED is a success code without a pipeline, errors are reported by the worker retry
+			info.flags |= VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_EXT;
+
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			if (VK_GET_SYMBOL(vkCreateGraphicsPipelines)(*m_device, VK_NULL_HANDLE, 1, &info, nullptr, &pipeline) != VK_SUCCESS || !pipeline)
+			{
+				return {};
+			}
+
+			auto result = std::make_unique<vk::glsl::program>(*m_device, pipeline, pipe_layout, vs_inputs, fs_inputs);
+			result->link();
+			return result;
+		}
+
+		if (m_device->get_graphics_pipeline_library_support())
+		{
+			if (const auto pipeline = link_pipeline_libraries(*m_device, info, create_info, modules, link_time_optimize))
+			{
+				auto result = std::make_unique<vk::glsl::program>(*m_device, pipeline, pipe_layout, vs_inputs, fs_inputs);
+				result->link();
+				return result;
+			}
+
+			// Fall back to a monolithic pipeline
+		}
+
 		return int_compile_graphics_pipe(info, pipe_layout, vs_inputs, fs_inputs);
 	}
 
@@ -202,6 +486,17 @@ namespace vk
 			return int_compile_graphics_pipe(create_info, module_handles, pipe_layout, vs_inputs, fs_inputs);
 		}
 
+		if (g_probe_driver_cache)
+		{
+			if (auto result = int_compile_graphics_pipe(create_info, module_handles, pipe_layout, vs_inputs, fs_inputs, false, true))
+			{
+				g_pipeline_draw_stats.driver_cache_hits++;
+				return result;
+			}
+
+			g_pipeline_draw_stats.driver_cache_misses++;
+		}
+
 		m_work_queue.push(create_info, pipe_layout, module_handles, vs_inputs, fs_inputs, callback);
 		return {};
 	}
@@ -242,11 +537,32 @@ namespace vk
 		{
 			compiler.initialize(g_render_device);
 		}
+
+		if (g_render_device->get_graphics_pipeline_library_support())
+		{
+			rsx_log.notice("Using graphics pipeline libraries for split pipeline compilation.");
+			g_pipeline_library_device = g_render_device;
+		}
+
+		// Library links are cached by the driver under different keys than a monolithic probe, so it would never hit
+		g_probe_driver_cache = g_render_device->get_pipeline_creation_cache_control_support() && !g_render_device->get_graphics_pipeline_library_support();
+		if (g_probe_driver_cache)
+		{
+			rsx_log.notice("Probing the driver pipeline cache before deferring pipeline compiles.");
+		}
 	}
 
 	void destroy_pipe_compiler()
 	{
 		g_pipe_compilers.reset();
+		g_probe_driver_cache = false;
+
+		// Linked pipelines do not reference their libraries, only the cache owns them
+		if (g_pipeline_library_device)
+		{
+			g_pipeline_libraries.clear(*g_pipeline_library_device);
+			g_pipeline_library_device = nullptr;
+		}
 	}
 
 	pipe_compiler* get_pipe_compiler()
@@ -8,6 +8,19 @@ namespace vk
 {
 	class render_device;
 
+	// Draw-path counters for the async shader modes, polled by the frontend
+	struct pipeline_draw_stats
+	{
+		atomic_t<u64> interpreter_draws = 0;   // Drawn through the shader interpreter while the specialized pipeline compiles
+		atomic_t<u64> interpreter_swaps = 0;   // Interpreter -> specialized pipeline transitions
+		atomic_t<u64> skipped_draws = 0;       // Dropped because no program was ready (async_recompiler)
+		atomic_t<u64> pipeline_misses = 0;     // Pipeline lookups that missed the cache and had to compile
+		atomic_t<u64> driver_cache_hits = 0;   // Deferred compiles the driver served from its cache, used inline
+		atomic_t<u64> driver_cache_misses = 0; // Deferred compiles that needed a real compile and went to the workers
+	};
+
+	extern pipeline_draw_stats g_pipeline_draw_stats;
+
 	struct pipeline_props
 	{
 		graphics_pipeline_state state;
@@ -155,7 +168,8 @@ namespace vk
 		std::unique_ptr<glsl::program> int_compile_graphics_pipe(const VkGraphicsPipelineCreateInfo& create_info, VkPipelineLayout pipe_layout,
 			const std::vector<glsl::program_input>& vs_inputs, const std::vector<glsl::program_input>& fs_inputs);
 		std::unique_ptr<glsl::program> int_compile_graphics_pipe(const vk::pipeline_props& create_info, VkShaderModule modules[2], VkPipelineLayout pipe_layout,
-			const std::vector<glsl::program_input>& vs_inputs, const std::vector<glsl::program_input>& fs_inputs);
+			const std::vector<glsl::program_input>& vs_inputs, const std::vector<glsl::program_input>& fs_inputs, bool link_time_optimize = false,
+			bool fail_on_compile_required = false);
 	};
 
 	void initialize_pipe_compiler(int num_worker_threads = -1);
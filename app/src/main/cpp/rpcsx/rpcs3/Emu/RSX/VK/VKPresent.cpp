@@ -8,9 +8,11 @@
 #include "upscalers/bilinear_pass.hpp"
 #include "upscalers/fsr_pass.h"
 #include "upscalers/nearest_pass.hpp"
+#include "upscalers/temporal_pass.h"
 #include "rx/asm.hpp"
 #include "rx/align.hpp"
 #include "util/video_provider.h"
+#include "Emu/perf_trace.hpp"
 
 extern atomic_t<bool> g_user_asked_for_screenshot;
 extern atomic_t<recording_mode> g_recording_mode;
@@ -71,6 +73,11 @@ void VKGSRender::reinitialize_swapchain()
 	m_current_command_buffer->reset();
 	m_current_command_buffer->begin();
 
+	if (m_gpu_frame_timer)
+	{
+		m_gpu_frame_timer->begin_span(*m_current_command_buffer);
+	}
+
 	for (auto& ctx : frame_context_storage)
 	{
 		if (ctx.present_image == umax)
@@ -118,6 +125,11 @@ void VKGSRender::reinitialize_swapchain()
 	m_current_command_buffer->reset();
 	m_current_command_buffer->begin();
 
+	if (m_gpu_frame_timer)
+	{
+		m_gpu_frame_timer->begin_span(*m_current_command_buffer);
+	}
+
 	swapchain_unavailable = false;
 	should_reinitialize_swapchain = false;
 }
@@ -126,6 +138,8 @@ void VKGSRender::present(vk::frame_context_t* ctx)
 {
 	ensure(ctx->present_image != umax);
 
+	perf_trace::scope trace(perf_trace::category::vk, "VK present");
+
 	// Partial CS flush
 	ctx->swap_command_buffer->flush();
 
@@ -170,8 +184,23 @@ void VKGSRender::advance_queued_frames()
 	m_device->rebalance_memory_type_usage();
 	vk::vmm_check_memory_usage();
 
+	// Host memory pressure reported by the frontend, on top of the VRAM balancer
+	auto trim_severity = vk::vmm_determine_memory_load_severity();
+	if (const u8 relief = m_requested_memory_relief.exchange(0))
+	{
+		const auto severity = static_cast<rsx::problem_severity>(relief - 1);
+		rsx_log.warning("Host memory pressure, releasing resources (severity %d)", static_cast<int>(severity));
+
+		on_vram_exhausted(severity);
+		trim_severity = std::max(trim_severity, severity);
+	}
+
 	// m_rtts storage is double buffered and should be safe to tag on frame boundary
-	m_rtts.trim(*m_current_command_buffer, vk::vmm_determine_memory_load_severity());
+	m_rtts.trim(*m_current_command_buffer, trim_severity);
+
+	const auto mem_info = m_device->get_memory_mapping();
+	m_device_memory_bytes = vk::vmm_get_application_memory_usage(mem_info.device_local);
+	m_texture_memory_bytes = m_texture_cache.get_texture_memory_in_use();
 
 	// Texture cache is also double buffered to prevent use-after-free
 	m_texture_cache.on_frame_end();
@@ -180,6 +209,14 @@ void VKGSRender::advance_queued_frames()
 	vk::remove_unused_framebuffers();
 
 	m_vertex_cache->purge();
+
+	for (auto heap : {&m_attrib_ring_info, &m_vertex_env_ring_info, &m_fragment_env_ring_info, &m_vertex_layout_ring_info,
+			 &m_fragment_texture_params_ring_info, &m_fragment_constants_ring_info, &m_transform_constants_ring_info,
+			 &m_index_buffer_ring_info, &m_texture_upload_buffer_ring_info, &m_raster_env_ring_info, &m_instancing_buffer_ring_info})
+	{
+		heap->on_frame_end(m_frames_in_flight);
+	}
+
 	m_current_frame->tag_frame_end(m_attrib_ring_info.get_current_put_pos_minus_one(),
 		m_vertex_env_ring_info.get_current_put_pos_minus_one(),
 		m_fragment_env_ring_info.get_current_put_pos_minus_one(),
@@ -193,16 +230,18 @@ void VKGSRender::advance_queued_frames()
 		m_instancing_buffer_ring_info.get_current_put_pos_minus_one());
 
 	m_queued_frames.push_back(m_current_frame);
-	ensure(m_queued_frames.size() <= VK_MAX_ASYNC_FRAMES);
+	ensure(m_queued_frames.size() <= m_frames_in_flight);
 
-	m_current_queue_index = (m_current_queue_index + 1) % VK_MAX_ASYNC_FRAMES;
+	// The next context is reused only after its previous frame retired (see flip), which
+	// bounds how far FIFO processing runs ahead of the GPU
+	m_current_queue_index = (m_current_queue_index + 1) % m_frames_in_flight;
 	m_current_frame = &frame_context_storage[m_current_queue_index];
 	m_current_frame->flags |= frame_context_state::dirty;
 
 	vk::advance_frame_counter();
 }
 
-void VKGSRender::queue_swap_request()
+void VKGSRender::queue_swap_request(bool generated_frame)
 {
 	ensure(!m_current_frame->swap_command_buffer);
 	m_current_frame->swap_command_buffer = m_current_command_buffer;
@@ -223,15 +262,179 @@ void VKGSRender::queue_swap_request()
 	// Set up a present request for this frame as well
 	present(m_current_frame);
 
+	// Frame boundary for GPU timing, report whatever frames the GPU has finished.
+	// Generated frames are accounted to the flip that follows them, consumers count guest frames.
+	if (m_gpu_frame_timer && !generated_frame)
+	{
+		m_gpu_frame_timer->on_frame_end();
+		m_gpu_frame_timer->poll();
+
+		const auto& perf_overlay = g_cfg.video.perf_overlay;
+		m_gpu_frame_timer->set_pass_timing_forced(perf_overlay.perf_overlay_enabled && perf_overlay.gpu_cost_breakdown);
+	}
+
 	// Grab next cb in line and make it usable
 	m_current_command_buffer = m_primary_cb_list.next();
 	m_current_command_buffer->reset();
 	m_current_command_buffer->begin();
 
+	if (m_gpu_frame_timer)
+	{
+		m_gpu_frame_timer->begin_span(*m_current_command_buffer);
+	}
+
 	// Set up new pointers for the next frame
 	advance_queued_frames();
 }
 
+bool VKGSRender::present_generated_frame(const rsx::avconf& avconfig, const areai& aspect_ratio, u32 buffer_width, u32 buffer_height)
+{
+	perf_trace::scope trace(perf_trace::category::vk, "VK generated present");
+
+	m_swapchain->wait_for_present(1, 50'000'000);
+
+	ensure(m_current_frame->present_image == umax);
+	ensure(m_current_frame->swap_command_buffer == nullptr);
+
+	// Never hold the real flip back for longer than a refresh, drop the generated frame instead.
+	// Errors are left to the acquire of the real flip which knows how to recover from them.
+	const u64 timeout = m_swapchain->get_swap_image_count() <= m_frames_in_flight ? 0ull : 16'000'000ull;
+	switch (m_swapchain->acquire_next_swapchain_image(m_current_frame->acquire_signal_semaphore, timeout, &m_current_frame->present_image))
+	{
+	case VK_SUCCESS:
+		break;
+	case VK_SUBOPTIMAL_KHR:
+		should_reinitialize_swapchain = true;
+		break;
+	default:
+		m_current_frame->present_image = -1;
+		return false;
+	}
+
+	VkImage target_image = m_swapchain->get_image(m_current_frame->present_image);
+	const auto present_layout = m_swapchain->get_optimal_present_layout();
+
+	const VkImageSubresourceRange subresource_range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+	VkImageLayout target_layout = present_layout;
+
+	VkRenderPass single_target_pass = VK_NULL_HANDLE;
+	vk::framebuffer_holder* direct_fbo = nullptr;
+
+	auto frame = m_frame_generation->acquire_output(*m_current_command_buffer);
+	auto upscaler = m_frame_generation->get_upscaler(m_upscaler.get(), m_output_scaling == output_scaling_mode::temporal);
+
+	if (aspect_ratio.x1 || aspect_ratio.y1)
+	{
+		// Clear the window background to black
+		VkClearColorValue clear_black{};
+		vk::change_image_layout(*m_current_command_buffer, target_image, present_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range);
+		VK_GET_SYMBOL(vkCmdClearColorImage)(*m_current_command_buffer, target_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear_black, 1, &subresource_range);
+
+		target_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	}
+
+	// Same output effects as the real flips, minus stereo which disables generation
+	const bool use_full_rgb_range_output = g_cfg.video.full_rgb_range_output.get();
+	if (!use_full_rgb_range_output || !rsx::fcmp(avconfig.gamma, 1.f))
+	{
+		rsx::simple_array<vk::viewable_image*> calibration_src = {frame};
+
+		if (m_output_scaling == output_scaling_mode::fsr || m_output_scaling == output_scaling_mode::temporal)
+		{
+			VkImageBlit request = {};
+			request.srcSubresource = {frame->aspect(), 0, 0, 1};
+			request.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+			request.srcOffsets[0] = {0, 0, 0};
+			request.srcOffsets[1] = {s32(buffer_width), s32(buffer_height), 1};
+			request.dstOffsets[0] = {0, 0, 0};
+			request.dstOffsets[1] = {aspect_ratio.width(), aspect_ratio.height(), 1};
+
+			calibration_src[0] = upscaler->scale_output(*m_current_command_buffer, frame, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED, request, UPSCALE_LEFT_VIEW);
+		}
+
+		vk::change_image_layout(*m_current_command_buffer, target_image, target_layout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, subresource_range);
+		target_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		const auto key = vk::get_renderpass_key(m_swapchain->get_surface_format());
+		single_target_pass = vk::get_renderpass(*m_device, key);
+		ensure(single_target_pass != VK_NULL_HANDLE);
+
+		direct_fbo = vk::get_framebuffer(*m_device, m_swapchain_dims.width, m_swapchain_dims.height, VK_FALSE, single_target_pass, m_swapchain->get_surface_format(), target_image);
+		direct_fbo->add_ref();
+
+		vk::get_overlay_pass<vk::video_out_calibration_pass>()->run(
+			*m_current_command_buffer, areau(aspect_ratio), direct_fbo, calibration_src,
+			avconfig.gamma, !use_full_rgb_range_output, avconfig.stereo_mode, single_target_pass);
+
+		direct_fbo->release();
+	}
+	else
+	{
+		VkImageBlit rgn = {};
+		rgn.srcSubresource = {frame->aspect(), 0, 0, 1};
+		rgn.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+		rgn.srcOffsets[0] = {0, 0, 0};
+		rgn.srcOffsets[1] = {s32(buffer_width), s32(buffer_height), 1};
+		rgn.dstOffsets[0] = {aspect_ratio.x1, aspect_ratio.y1, 0};
+		rgn.dstOffsets[1] = {aspect_ratio.x2, aspect_ratio.y2, 1};
+
+		if (target_layout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+		{
+			vk::change_image_layout(*m_current_command_buffer, target_image, target_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource_range);
+			target_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		}
+
+		upscaler->scale_output(*m_current_command_buffer, frame, target_image, target_layout, rgn, UPSCALE_AND_COMMIT | UPSCALE_DEFAULT_VIEW);
+	}
+
+	// Overlays would flicker if they were missing from every other frame
+	if (m_overlay_manager && m_overlay_manager->has_visible())
+	{
+		if (target_layout != VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
+		{
+			vk::change_image_layout(*m_current_command_buffer, target_image, target_layout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, subresource_range);
+			target_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		}
+
+		if (!direct_fbo)
+		{
+			const auto key = vk::get_renderpass_key(m_swapchain->get_surface_format());
+			single_target_pass = vk::get_renderpass(*m_device, key);
+			ensure(single_target_pass != VK_NULL_HANDLE);
+
+			direct_fbo = vk::get_framebuffer(*m_device, m_swapchain_dims.width, m_swapchain_dims.height, VK_FALSE, single_target_pass, m_swapchain->get_surface_format(), target_image);
+		}
+
+		direct_fbo->add_ref();
+
+		// Lock to avoid modification during run-update chain
+		auto ui_renderer = vk::get_overlay_pass<vk::ui_overlay_renderer>();
+		std::lock_guard lock(*m_overlay_manager);
+
+		for (const auto& view : m_overlay_manager->get_views())
+		{
+			ui_renderer->run(*m_current_command_buffer, areau(aspect_ratio), direct_fbo, single_target_pass, m_texture_upload_buffer_ring_info, *view.get());
+		}
+
+		direct_fbo->release();
+	}
+
+	if (target_layout != present_layout)
+	{
+		vk::change_image_layout(*m_current_command_buffer, target_image, target_layout, present_layout, subresource_range);
+	}
+
+	queue_swap_request(true);
+
+	// The real flip reuses the next context, it may still be in flight
+	if (m_current_frame->swap_command_buffer)
+	{
+		frame_context_cleanup(m_current_frame);
+	}
+
+	return true;
+}
+
 void VKGSRender::frame_context_cleanup(vk::frame_context_t* ctx)
 {
 	ensure(ctx->swap_command_buffer);
@@ -448,6 +651,8 @@ vk::viewable_image* VKGSRender::get_present_source(/* inout */ vk::present_surfa
 
 void VKGSRender::flip(const rsx::display_flip_info_t& info)
 {
+	perf_trace::scope trace(perf_trace::category::vk, "VK flip");
+
 	// Check swapchain condition/status
 	if (!m_swapchain->supports_automatic_wm_reports())
 	{
@@ -582,11 +787,115 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 		evaluate_cpu_usage_reduction_limits();
 	}
 
+	const output_scaling_mode output_scaling = g_cfg.video.output_scaling.get();
+
+	if (!m_upscaler || m_output_scaling != output_scaling)
+	{
+		m_output_scaling = output_scaling;
+
+		if (m_output_scaling == output_scaling_mode::nearest)
+		{
+			m_upscaler = std::make_unique<vk::nearest_upscale_pass>();
+		}
+		else if (m_output_scaling == output_scaling_mode::fsr)
+		{
+			m_upscaler = std::make_unique<vk::fsr_upscale_pass>();
+		}
+		else if (m_output_scaling == output_scaling_mode::temporal)
+		{
+			m_upscaler = std::make_unique<vk::temporal_upscale_pass>();
+		}
+		else
+		{
+			m_upscaler = std::make_unique<vk::bilinear_upscale_pass>();
+		}
+	}
+
+	auto get_output_region = [&]() -> areai
+	{
+		if (!g_cfg.video.stretch_to_display_area)
+		{
+			const auto converted = avconfig.aspect_convert_region({buffer_width, buffer_height}, m_swapchain_dims);
+			return static_cast<areai>(converted);
+		}
+
+		return {0, 0, s32(m_swapchain_dims.width), s32(m_swapchain_dims.height)};
+	};
+
+	// Present the frame halfway to the previous flip ahead of this one. Its submission also consumes the
+	// async compute semaphore, which must happen before the temporal upscaler below produces its own.
+	u64 generated_present_us = 0;
+	if (!(g_cfg.video.vk.frame_generation || vk::g_frame_generation_requested) || m_swapchain->is_headless())
+	{
+		m_frame_generation.reset();
+	}
+	else if (image_to_flip && info.emu_flip && avconfig.stereo_mode == stereo_render_mode_options::disabled)
+	{
+		if (!m_frame_generation)
+		{
+			m_frame_generation = std::make_unique<vk::frame_generation_pass>();
+		}
+
+		// Without GPU timing there is no load to judge by, generation is then only limited by the flip rate
+		const u64 gpu_time_us = m_gpu_frame_timer ? m_gpu_frame_timer->get_total_gpu_time_us() : 0;
+		const u64 gpu_frames = m_gpu_frame_timer ? m_gpu_frame_timer->get_measured_frames() : 0;
+
+		if (m_frame_generation->schedule(get_system_time(), get_cached_display_refresh_rate(), gpu_time_us, gpu_frames))
+		{
+			const bool generate = m_frame_generation->queue(*m_current_command_buffer, image_to_flip, {buffer_width, buffer_height});
+
+			if (const auto inputs_ready = m_frame_generation->get_inputs_semaphore())
+			{
+				flush_command_queue(false, false, inputs_ready);
+				m_present_compute_semaphore = m_frame_generation->submit_async();
+			}
+
+			if (generate && present_generated_frame(avconfig, get_output_region(), buffer_width, buffer_height))
+			{
+				generated_present_us = get_system_time();
+			}
+		}
+	}
+
+	if (m_output_scaling == output_scaling_mode::temporal && image_to_flip)
+	{
+		auto temporal_upscaler = static_cast<vk::temporal_upscale_pass*>(m_upscaler.get());
+
+		vk::viewable_image* scene_depth = nullptr;
+		if (m_scene_depth_hint.address)
+		{
+			if (auto surface = m_rtts.get_surface_at(m_scene_depth_hint.address); surface && surface->is_depth_surface())
+			{
+				scene_depth = surface;
+			}
+		}
+
+		temporal_upscaler->set_depth_source(scene_depth);
+
+		// Run the pass on the compute queue so that it overlaps with the image acquire and the rest of the flip.
+		// The output size is predicted from the current swapchain; if it is recreated below the pass falls back to running inline.
+		if (avconfig.stereo_mode == stereo_render_mode_options::disabled)
+		{
+			const auto output_region = get_output_region();
+			const size2u input_size = {buffer_width, buffer_height};
+			const size2u output_size = {u32(output_region.width()), u32(output_region.height())};
+
+			if (const auto inputs_ready = temporal_upscaler->queue_async(*m_current_command_buffer, image_to_flip, input_size, output_size))
+			{
+				flush_command_queue(false, false, inputs_ready);
+				m_present_compute_semaphore = temporal_upscaler->submit_async();
+			}
+		}
+	}
+
+	// Pace to the display instead of the swapchain depth, a deep present queue only adds latency
+	m_swapchain->wait_for_present(1, 50'000'000);
+
 	// Prepare surface for new frame. Set no timeout here so that we wait for the next image if need be
 	ensure(m_current_frame->present_image == umax);
 	ensure(m_current_frame->swap_command_buffer == nullptr);
 
-	u64 timeout = m_swapchain->get_swap_image_count() <= VK_MAX_ASYNC_FRAMES ? 0ull :
+	u64 timeout = m_swapchain->get_swap_image_count() <= m_frames_in_flight ? 0ull :
 #ifdef ANDROID
 	                                                                           1000ull
 #else
@@ -641,16 +950,7 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 	ensure(m_current_frame->present_image != umax);
 
 	// Calculate output dimensions. Done after swapchain acquisition in case it was recreated.
-	areai aspect_ratio;
-	if (!g_cfg.video.stretch_to_display_area)
-	{
-		const auto converted = avconfig.aspect_convert_region({buffer_width, buffer_height}, m_swapchain_dims);
-		aspect_ratio = static_cast<areai>(converted);
-	}
-	else
-	{
-		aspect_ratio = {0, 0, s32(m_swapchain_dims.width), s32(m_swapchain_dims.height)};
-	}
+	const areai aspect_ratio = get_output_region();
 
 	// Blit contents to screen..
 	VkImage target_image = m_swapchain->get_image(m_current_frame->present_image);
@@ -673,26 +973,6 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 		target_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 	}
 
-	const output_scaling_mode output_scaling = g_cfg.video.output_scaling.get();
-
-	if (!m_upscaler || m_output_scaling != output_scaling)
-	{
-		m_output_scaling = output_scaling;
-
-		if (m_output_scaling == output_scaling_mode::nearest)
-		{
-			m_upscaler = std::make_unique<vk::nearest_upscale_pass>();
-		}
-		else if (m_output_scaling == output_scaling_mode::fsr)
-		{
-			m_upscaler = std::make_unique<vk::fsr_upscale_pass>();
-		}
-		else
-		{
-			m_upscaler = std::make_unique<vk::bilinear_upscale_pass>();
-		}
-	}
-
 	if (image_to_flip)
 	{
 		const bool use_full_rgb_range_output = g_cfg.video.full_rgb_range_output.get();
@@ -704,7 +984,7 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 			if (image_to_flip2)
 				calibration_src.push_back(image_to_flip2);
 
-			if (m_output_scaling == output_scaling_mode::fsr && avconfig.stereo_mode == stereo_render_mode_options::disabled) // 3D will be implemented later
+			if ((m_output_scaling == output_scaling_mode::fsr || m_output_scaling == output_scaling_mode::temporal) && avconfig.stereo_mode == stereo_render_mode_options::disabled) // 3D will be implemented later
 			{
 				// Run upscaling pass before the rest of the output effects pipeline
 				// This can be done with all upscalers but we already get bilinear upscaling for free if we just out the filters directly
@@ -763,8 +1043,14 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 		{
 			const usz sshot_size = buffer_height * buffer_width * 4;
 
-			vk::buffer sshot_vkbuf(*m_device, rx::alignUp(sshot_size, 0x100000), m_device->get_memory_mapping().host_visible_coherent,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0, VMM_ALLOCATION_POOL_UNDEFINED);
+			// Recording reads back every frame; do not allocate and free device memory each time
+			if (!m_frame_readback_buffer || m_frame_readback_buffer->size() < sshot_size)
+			{
+				m_frame_readback_buffer = std::make_unique<vk::buffer>(*m_device, rx::alignUp(sshot_size, 0x100000), m_device->get_memory_mapping().host_visible_coherent,
+					VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0, VMM_ALLOCATION_POOL_UNDEFINED);
+			}
+
+			vk::buffer& sshot_vkbuf = *m_frame_readback_buffer;
 
 			VkBufferImageCopy copy_info;
 			copy_info.bufferOffset = 0;
@@ -791,6 +1077,12 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 			memcpy(sshot_frame.data(), src, sshot_size);
 			sshot_vkbuf.unmap();
 
+			if (g_recording_mode == recording_mode::stopped)
+			{
+				// One-off screenshot, the queue is idle after the flush above
+				m_frame_readback_buffer.reset();
+			}
+
 			const bool is_bgra = image_to_flip->format() == VK_FORMAT_B8G8R8A8_UNORM;
 
 			if (g_user_asked_for_screenshot.exchange(false))
@@ -863,6 +1155,8 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 			const auto num_texture_upload_miss = m_texture_cache.get_texture_upload_misses_this_frame();
 			const auto texture_upload_miss_ratio = m_texture_cache.get_texture_upload_miss_percentage();
 			const auto texture_copies_ellided = m_texture_cache.get_texture_copies_ellided_this_frame();
+			const auto range_index_lookups = m_texture_cache.get_num_range_index_lookups();
+			const auto range_index_hits = m_texture_cache.get_num_range_index_hits();
 			const auto vertex_cache_hit_count = (info.stats.vertex_cache_request_count - info.stats.vertex_cache_miss_count);
 			const auto vertex_cache_hit_ratio = info.stats.vertex_cache_request_count ? (vertex_cache_hit_count * 100) / info.stats.vertex_cache_request_count : 0;
 			const auto program_cache_lookups = info.stats.program_cache_lookups_total;
@@ -883,6 +1177,7 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 				"Texture cache memory: %7dM\n"
 				"Temporary texture memory: %3dM\n"
 				"Flush requests: %13d  = %2d (%3d%%) hard faults, %2d unavoidable, %2d misprediction(s), %2d speculation(s)\n"
+				"Range index lookups: %u (%u hit)\n"
 				"Texture uploads: %12u (%u from CPU - %02u%%, %u copies avoided)\n"
 				"Vertex cache hits: %10u/%u (%u%%)\n"
 				"Program cache lookup ellision: %u/%u (%u%%)",
@@ -891,6 +1186,7 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 				info.stats.textures_upload_time, info.stats.draw_exec_time, info.stats.flip_time,
 				num_dirty_textures, texture_memory_size, tmp_texture_memory_size,
 				num_flushes, num_misses, cache_miss_ratio, num_unavoidable, num_mispredict, num_speculate,
+				range_index_lookups, range_index_hits,
 				num_texture_upload, num_texture_upload_miss, texture_upload_miss_ratio, texture_copies_ellided,
 				vertex_cache_hit_count, info.stats.vertex_cache_request_count, vertex_cache_hit_ratio,
 				program_cache_ellided, program_cache_lookups, program_cache_ellision_rate));
@@ -904,8 +1200,31 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 		vk::change_image_layout(*m_current_command_buffer, target_image, target_layout, present_layout, subresource_range);
 	}
 
+	if (generated_present_us)
+	{
+		if (const u64 delay = m_frame_generation->get_present_delay_us(generated_present_us, get_system_time()))
+		{
+			thread_ctrl::wait_for(delay);
+		}
+	}
+
 	queue_swap_request();
 
+	// Render scale steps are applied between frames. Surfaces of the old scale cannot be mixed with new ones, drop them all.
+	if (rsx::latch_dynamic_resolution(m_output_scaling == output_scaling_mode::temporal && avconfig.stereo_mode == stereo_render_mode_options::disabled))
+	{
+		if (m_draw_fbo)
+		{
+			m_draw_fbo->release();
+			m_draw_fbo = nullptr;
+		}
+
+		m_rtts.invalidate_all();
+		m_graphics_state |= rsx::rtt_config_dirty;
+	}
+
+	m_scene_depth_hint = {};
+
 	m_frame_stats.flip_time = m_profiler.duration();
 
 	m_frame->flip(m_context);
@@ -14,6 +14,9 @@ namespace vk
 		using pipeline_storage_type = std::unique_ptr<vk::glsl::program>;
 		using pipeline_properties = vk::pipeline_props;
 
+		// Decompilation and glslang keep no shared state, vkCreateShaderModule is free-threaded
+		static constexpr bool parallel_recompile = true;
+
 		static void recompile_fragment_program(const RSXFragmentProgram& RSXFP, fragment_program_type& fragmentProgramData, usz ID)
 		{
 			fragmentProgramData.Decompile(RSXFP);
@@ -6,6 +6,12 @@
 #include "VKResourceManager.h"
 #include "rx/asm.hpp"
 #include "VKGSRender.h"
+#include "Emu/Cell/timers.hpp"
+#include "Emu/perf_trace.hpp"
+#include "util/fnv_hash.hpp"
+
+#include <algorithm>
+#include <unordered_map>
 
 namespace vk
 {
@@ -248,4 +254,359 @@ namespace vk
 	{
 		m_pool_man->on_query_pool_released(m_object);
 	}
+
+	atomic_t<frame_timing_sink_type> g_frame_timing_sink{nullptr};
+	atomic_t<gpu_cost_sink_type> g_gpu_cost_sink{nullptr};
+	gpu_frame_timer* g_gpu_frame_timer = nullptr;
+
+	gpu_frame_timer::gpu_frame_timer(vk::render_device& dev)
+		: m_device(&dev)
+	{
+		const u32 valid_bits = dev.get_graphics_timestamp_valid_bits();
+		m_timestamp_mask = valid_bits >= 64 ? umax : ((1ull << valid_bits) - 1);
+		m_timestamp_period_ns = dev.gpu().get_limits().timestampPeriod;
+
+		for (auto& frame : m_frames)
+		{
+			frame.pool = std::make_unique<query_pool>(dev, VK_QUERY_TYPE_TIMESTAMP, max_spans_per_frame * 2);
+			frame.pass_pool = std::make_unique<query_pool>(dev, VK_QUERY_TYPE_TIMESTAMP, max_passes_per_frame * 2);
+		}
+
+		m_last_frame_end_us = get_system_time();
+		g_gpu_frame_timer = this;
+	}
+
+	gpu_frame_timer::~gpu_frame_timer()
+	{
+		if (g_gpu_frame_timer == this)
+		{
+			g_gpu_frame_timer = nullptr;
+		}
+	}
+
+	bool gpu_frame_timer::read_results(frame_data& frame, f32& gpu_time_ms)
+	{
+		// {value, availability} per query
+		std::array<u64, max_spans_per_frame * 2 * 2> data;
+		const u32 query_count = frame.spans * 2;
+
+		switch (const auto error = VK_GET_SYMBOL(vkGetQueryPoolResults)(*m_device, *frame.pool, 0, query_count, query_count * 2 * sizeof(u64), data.data(),
+			2 * sizeof(u64), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT))
+		{
+		case VK_SUCCESS:
+			break;
+		case VK_NOT_READY:
+			return false;
+		default:
+			die_with_error(error);
+			return false;
+		}
+
+		u64 busy_ticks = 0;
+		for (u32 span = 0; span < frame.spans; ++span)
+		{
+			const u64 begin = data[span * 4];
+			const u64 end = data[span * 4 + 2];
+			busy_ticks += (end - begin) & m_timestamp_mask;
+		}
+
+		gpu_time_ms = static_cast<f32>(busy_ticks * m_timestamp_period_ns / 1000000.);
+		frame.pending = false;
+		return true;
+	}
+
+	void gpu_frame_timer::read_pass_results(frame_data& frame)
+	{
+		// {value, availability} per query
+		std::array<u64, max_passes_per_frame * 2 * 2> data;
+		const u32 query_count = ::size32(frame.passes) * 2;
+
+		switch (const auto error = VK_GET_SYMBOL(vkGetQueryPoolResults)(*m_device, *frame.pass_pool, 0, query_count, query_count * 2 * sizeof(u64), data.data(),
+			2 * sizeof(u64), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT))
+		{
+		case VK_SUCCESS:
+			break;
+		case VK_NOT_READY:
+			// Written before the last span end, only possible if the driver reports pools independently
+			return;
+		default:
+			die_with_error(error);
+			return;
+		}
+
+		m_cost_scratch.clear();
+		std::unordered_map<u64, u32> entry_index;
+
+		auto add_cost = [&](rsx::gpu_cost_kind kind, u64 key, u16 width, u16 height, f32 gpu_time_ms, u32 count)
+		{
+			usz id = rpcs3::hash64(rpcs3::fnv_seed, key);
+			id = rpcs3::hash64(id, u64{width} | u64{height} << 16 | u64{static_cast<u8>(kind)} << 32);
+
+			const auto [found, inserted] = entry_index.try_emplace(id, ::size32(m_cost_scratch));
+			if (inserted)
+			{
+				m_cost_scratch.push_back({.key = key, .gpu_time_ms = 0.f, .count = 0, .width = width, .height = height, .kind = kind});
+			}
+
+			auto& entry = m_cost_scratch[found->second];
+			entry.gpu_time_ms += gpu_time_ms;
+			entry.count = static_cast<u16>(std::min<u32>(entry.count + count, u16{umax}));
+		};
+
+		for (u32 i = 0; i < frame.passes.size(); ++i)
+		{
+			const auto& pass = frame.passes[i];
+			const u64 ticks = (data[i * 4 + 2] - data[i * 4]) & m_timestamp_mask;
+			const f32 gpu_time_ms = static_cast<f32>(ticks * m_timestamp_period_ns / 1000000.);
+
+			add_cost(pass.kind, pass.key, pass.width, pass.height, gpu_time_ms, 1);
+
+			// No per-draw timestamps, the pass time is shared out by draw count
+			u32 draws = 0;
+			for (u32 p = 0; p < pass.pipeline_count; ++p)
+			{
+				draws += frame.pipelines[pass.first_pipeline + p].second;
+			}
+
+			for (u32 p = 0; p < pass.pipeline_count; ++p)
+			{
+				const auto& [hash, count] = frame.pipelines[pass.first_pipeline + p];
+				add_cost(rsx::gpu_cost_kind::pipeline, hash, 0, 0, gpu_time_ms * count / draws, count);
+			}
+		}
+
+		// Most expensive first within each kind, pipelines overlap their passes and cannot be ranked against them
+		std::sort(m_cost_scratch.begin(), m_cost_scratch.end(), [](const rsx::gpu_cost_entry& a, const rsx::gpu_cost_entry& b)
+			{
+				return a.kind != b.kind ? a.kind < b.kind : a.gpu_time_ms > b.gpu_time_ms;
+			});
+
+		u32 kept = 0;
+		u32 kind_count = 0;
+		for (u32 i = 0; i < m_cost_scratch.size(); ++i)
+		{
+			kind_count = (i && m_cost_scratch[i].kind == m_cost_scratch[i - 1].kind) ? kind_count + 1 : 0;
+
+			if (kind_count < max_reported_costs)
+			{
+				m_cost_scratch[kept++] = m_cost_scratch[i];
+			}
+		}
+
+		m_cost_scratch.resize(kept);
+
+		if (const auto sink = g_gpu_cost_sink.load())
+		{
+			sink(m_cost_scratch.data(), m_cost_scratch.size());
+		}
+
+		std::lock_guard lock(m_breakdown_mutex);
+		m_last_breakdown = m_cost_scratch;
+	}
+
+	void gpu_frame_timer::begin_span(vk::command_buffer& cmd)
+	{
+		auto& frame = m_frames[m_current];
+		if (!is_enabled() || frame.span_open || frame.spans >= max_spans_per_frame)
+		{
+			return;
+		}
+
+		if (frame.needs_reset)
+		{
+			VK_GET_SYMBOL(vkCmdResetQueryPool)(cmd, *frame.pool, 0, frame.pool->size());
+			VK_GET_SYMBOL(vkCmdResetQueryPool)(cmd, *frame.pass_pool, 0, frame.pass_pool->size());
+			frame.needs_reset = false;
+		}
+
+		VK_GET_SYMBOL(vkCmdWriteTimestamp)(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, *frame.pool, frame.spans * 2);
+		frame.span_open = true;
+		m_span_cmd = cmd;
+	}
+
+	void gpu_frame_timer::end_span(vk::command_buffer& cmd)
+	{
+		auto& frame = m_frames[m_current];
+		if (!frame.span_open)
+		{
+			return;
+		}
+
+		if (frame.pass_open)
+		{
+			// Render passes may be left open until the command buffer is closed
+			end_pass_scope(cmd);
+		}
+
+		VK_GET_SYMBOL(vkCmdWriteTimestamp)(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *frame.pool, frame.spans * 2 + 1);
+		frame.span_open = false;
+		frame.spans++;
+		m_span_cmd = VK_NULL_HANDLE;
+	}
+
+	void gpu_frame_timer::begin_pass_scope(const vk::command_buffer& cmd, rsx::gpu_cost_kind kind, u64 key, u16 width, u16 height)
+	{
+		auto& frame = m_frames[m_current];
+		if (!frame.span_open || m_span_cmd != static_cast<VkCommandBuffer>(cmd) || frame.passes.size() >= max_passes_per_frame)
+		{
+			return;
+		}
+
+		if (frame.pass_open)
+		{
+			end_pass_scope(cmd);
+		}
+
+		// Bottom of pipe for both ends: the timestamp lands once earlier work has drained, so back to back passes are not counted twice
+		VK_GET_SYMBOL(vkCmdWriteTimestamp)(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *frame.pass_pool, ::size32(frame.passes) * 2);
+		frame.passes.push_back({key, width, height, kind, ::size32(frame.pipelines), 0});
+		frame.pass_open = true;
+	}
+
+	void gpu_frame_timer::end_pass_scope(const vk::command_buffer& cmd)
+	{
+		auto& frame = m_frames[m_current];
+		if (!frame.pass_open || m_span_cmd != static_cast<VkCommandBuffer>(cmd))
+		{
+			return;
+		}
+
+		VK_GET_SYMBOL(vkCmdWriteTimestamp)(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *frame.pass_pool, ::size32(frame.passes) * 2 - 1);
+		frame.pass_open = false;
+	}
+
+	void gpu_frame_timer::begin_renderpass(const vk::command_buffer& cmd, u64 renderpass_key, u16 width, u16 height)
+	{
+		if (is_pass_timing_enabled())
+		{
+			begin_pass_scope(cmd, rsx::gpu_cost_kind::render_pass, renderpass_key, width, height);
+		}
+	}
+
+	void gpu_frame_timer::end_renderpass(const vk::command_buffer& cmd)
+	{
+		end_pass_scope(cmd);
+	}
+
+	void gpu_frame_timer::begin_dispatch(const vk::command_buffer& cmd, u64 shader_hash)
+	{
+		if (is_pass_timing_enabled())
+		{
+			begin_pass_scope(cmd, rsx::gpu_cost_kind::compute, shader_hash, 0, 0);
+		}
+	}
+
+	void gpu_frame_timer::end_dispatch(const vk::command_buffer& cmd)
+	{
+		end_pass_scope(cmd);
+	}
+
+	void gpu_frame_timer::on_draw(u64 pipeline_hash)
+	{
+		auto& frame = m_frames[m_current];
+		if (!frame.pass_open)
+		{
+			return;
+		}
+
+		auto& pass = frame.passes.back();
+		if (pass.kind != rsx::gpu_cost_kind::render_pass)
+		{
+			return;
+		}
+
+		// Few pipelines per pass, and consecutive draws usually share one
+		for (u32 p = pass.pipeline_count; p > 0; --p)
+		{
+			if (auto& entry = frame.pipelines[pass.first_pipeline + p - 1]; entry.first == pipeline_hash)
+			{
+				entry.second++;
+				return;
+			}
+		}
+
+		frame.pipelines.emplace_back(pipeline_hash, 1);
+		pass.pipeline_count++;
+	}
+
+	std::vector<rsx::gpu_cost_entry> gpu_frame_timer::get_last_breakdown() const
+	{
+		reader_lock lock(m_breakdown_mutex);
+		return m_last_breakdown;
+	}
+
+	void gpu_frame_timer::on_frame_end()
+	{
+		const u64 now = get_system_time();
+		auto& frame = m_frames[m_current];
+
+		// A span still open here straddles the flip, its frame cannot be measured
+		frame.pending = frame.spans && !frame.span_open;
+		frame.span_open = false;
+		frame.pass_open = false;
+		frame.frame_time_ms = (now - m_last_frame_end_us) / 1000.f;
+		m_last_frame_end_us = now;
+
+		m_current = (m_current + 1) % tracked_frames;
+
+		// GPU more than tracked_frames behind: drop the oldest sample rather than stall
+		auto& next = m_frames[m_current];
+		if (f32 unused; next.pending && !read_results(next, unused))
+		{
+			next.pending = false;
+		}
+
+		next.spans = 0;
+		next.needs_reset = true;
+		next.passes.clear();
+		next.pipelines.clear();
+	}
+
+	void gpu_frame_timer::poll()
+	{
+		const auto sink = g_frame_timing_sink.load();
+		const bool traced = perf_trace::is_enabled(perf_trace::category::gpu);
+		if (!sink && !m_forced && !traced && !is_pass_timing_enabled())
+		{
+			return;
+		}
+
+		// Oldest first
+		for (u32 i = 1; i <= tracked_frames; ++i)
+		{
+			auto& frame = m_frames[(m_current + i) % tracked_frames];
+			if (f32 gpu_time_ms; frame.pending && read_results(frame, gpu_time_ms))
+			{
+				m_total_gpu_time_us += static_cast<u64>(gpu_time_ms * 1000.f);
+				m_measured_frames++;
+
+				if (!frame.passes.empty())
+				{
+					read_pass_results(frame);
+				}
+
+				if (sink)
+				{
+					sink(frame.frame_time_ms, gpu_time_ms);
+				}
+
+				if (traced)
+				{
+					// Counters land when the results are read back, up to tracked_frames after the frame
+					perf_trace::counter("GPU busy us", static_cast<s64>(gpu_time_ms * 1000.f));
+					perf_trace::counter("GPU frame us", static_cast<s64>(frame.frame_time_ms * 1000.f));
+				}
+			}
+		}
+	}
+
+	bool gpu_frame_timer::is_enabled() const
+	{
+		return g_frame_timing_sink || m_forced || perf_trace::is_enabled(perf_trace::category::gpu) || is_pass_timing_enabled();
+	}
+
+	void gpu_frame_timer::set_forced(bool forced)
+	{
+		m_forced = forced;
+	}
 } // namespace vk
@@ -1,6 +1,10 @@
 #pragma once
 #include "VulkanAPI.h"
+#include "Emu/RSX/Core/RSXDisplay.h"
+#include "util/mutex.h"
+#include <array>
 #include <deque>
+#include <vector>
 
 namespace vk
 {
@@ -78,4 +82,106 @@ namespace vk
 			}
 		}
 	};
+
+	// Frontend hook, called on the RSX thread once results for a frame are available
+	using frame_timing_sink_type = void (*)(f32 frame_time_ms, f32 gpu_time_ms);
+	extern atomic_t<frame_timing_sink_type> g_frame_timing_sink;
+
+	// Frontend hook for the per-frame pass/pipeline breakdown, sorted by cost. Enables pass timing while set.
+	using gpu_cost_sink_type = void (*)(const rsx::gpu_cost_entry* entries, usz count);
+	extern atomic_t<gpu_cost_sink_type> g_gpu_cost_sink;
+
+	// Measures GPU busy time per frame with a timestamp pair around every primary command buffer.
+	// Gaps between submits are not counted, so a CPU/SPU-bound frame reports a short GPU time.
+	// With pass timing active, render passes and compute dispatches recorded inside a span get their own
+	// timestamp pair, and render pass time is split between the pipelines drawn in it by draw count.
+	class gpu_frame_timer
+	{
+		static constexpr u32 tracked_frames = 4;
+		static constexpr u32 max_spans_per_frame = 64;
+		static constexpr u32 max_passes_per_frame = 512;
+		static constexpr u32 max_reported_costs = 32;
+
+		struct pass_data
+		{
+			u64 key;
+			u16 width;
+			u16 height;
+			rsx::gpu_cost_kind kind;
+			u32 first_pipeline; // Range in frame_data::pipelines
+			u32 pipeline_count;
+		};
+
+		struct frame_data
+		{
+			std::unique_ptr<query_pool> pool;
+			std::unique_ptr<query_pool> pass_pool;
+			u32 spans = 0;
+			bool span_open = false;
+			bool pass_open = false;
+			bool needs_reset = true;
+			bool pending = false;
+			f32 frame_time_ms = 0.f;
+
+			std::vector<pass_data> passes;
+			std::vector<std::pair<u64, u32>> pipelines; // Pipeline hash, draws
+		};
+
+		vk::render_device* m_device = nullptr;
+		std::array<frame_data, tracked_frames> m_frames;
+		u32 m_current = 0;
+		u64 m_timestamp_mask = 0;
+		f64 m_timestamp_period_ns = 1.;
+		u64 m_last_frame_end_us = 0;
+
+		// Measure even without a frontend sink, totals are read through get_total_gpu_time_us
+		atomic_t<bool> m_forced = false;
+		atomic_t<u64> m_total_gpu_time_us = 0;
+		atomic_t<u64> m_measured_frames = 0;
+
+		// Pass timing for the performance overlay
+		bool m_pass_timing_forced = false;
+		VkCommandBuffer m_span_cmd = VK_NULL_HANDLE;
+		std::vector<rsx::gpu_cost_entry> m_cost_scratch;
+
+		mutable shared_mutex m_breakdown_mutex;
+		std::vector<rsx::gpu_cost_entry> m_last_breakdown;
+
+		bool read_results(frame_data& frame, f32& gpu_time_ms);
+		void read_pass_results(frame_data& frame);
+		bool is_enabled() const;
+
+		void begin_pass_scope(const vk::command_buffer& cmd, rsx::gpu_cost_kind kind, u64 key, u16 width, u16 height);
+		void end_pass_scope(const vk::command_buffer& cmd);
+
+	public:
+		gpu_frame_timer(vk::render_device& dev);
+		~gpu_frame_timer();
+
+		// Called right after a primary command buffer is opened / right before it is closed
+		void begin_span(vk::command_buffer& cmd);
+		void end_span(vk::command_buffer& cmd);
+
+		void on_frame_end();
+		void poll();
+
+		void set_forced(bool forced);
+		u64 get_total_gpu_time_us() const { return m_total_gpu_time_us; }
+		u64 get_measured_frames() const { return m_measured_frames; }
+
+		// Render pass and compute dispatch scopes, only recorded on the command buffer of the open span
+		bool is_pass_timing_enabled() const { return m_pass_timing_forced || g_gpu_cost_sink; }
+		void set_pass_timing_forced(bool forced) { m_pass_timing_forced = forced; }
+
+		void begin_renderpass(const vk::command_buffer& cmd, u64 renderpass_key, u16 width, u16 height);
+		void end_renderpass(const vk::command_buffer& cmd);
+		void begin_dispatch(const vk::command_buffer& cmd, u64 shader_hash);
+		void end_dispatch(const vk::command_buffer& cmd);
+		void on_draw(u64 pipeline_hash);
+
+		std::vector<rsx::gpu_cost_entry> get_last_breakdown() const;
+	};
+
+	// Timer of the active renderer, for the render pass and compute helpers (RSX thread only)
+	extern gpu_frame_timer* g_gpu_frame_timer;
 }; // namespace vk
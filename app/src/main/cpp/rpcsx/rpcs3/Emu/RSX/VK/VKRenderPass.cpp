@@ -2,6 +2,7 @@
 
 #include "util/mutex.h"
 #include "VKRenderPass.h"
+#include "VKQueryPool.h"
 #include "vkutils/image.h"
 
 namespace vk
@@ -10,6 +11,9 @@ namespace vk
 	{
 		VkRenderPass pass = VK_NULL_HANDLE;
 		VkFramebuffer fbo = VK_NULL_HANDLE;
+
+		// Pass that may be resumed by this instance (compatible, differs only in load ops)
+		VkRenderPass compatible_pass = VK_NULL_HANDLE;
 	};
 
 	atomic_t<u64> g_cached_renderpass_key = 0;
@@ -18,6 +22,7 @@ namespace vk
 
 	shared_mutex g_renderpass_cache_mutex;
 	std::unordered_map<u64, VkRenderPass> g_renderpass_cache;
+	std::unordered_map<VkRenderPass, u64> g_renderpass_keys; // Reverse lookup for GPU pass timing
 
 	// Key structure
 	// 0-7 color_format
@@ -25,6 +30,7 @@ namespace vk
 	// 16-21 sample_counts
 	// 22-36 current layouts
 	// 37-41 input attachments
+	// 42-46 attachments with discarded contents on load
 	union renderpass_key_blob
 	{
 	private:
@@ -69,6 +75,7 @@ namespace vk
 			u64 sample_count : 6;
 			u64 layout_blob : 15;
 			u64 input_attachments_mask : 5;
+			u64 load_discard_mask : 5;
 		};
 
 		renderpass_key_blob(u64 encoded_) : encoded(encoded_)
@@ -225,6 +232,25 @@ namespace vk
 		return key.encoded;
 	}
 
+	u64 get_renderpass_key_discard_load(u64 renderpass_key, u32 attachment_mask)
+	{
+		renderpass_key_blob key(renderpass_key);
+		key.load_discard_mask = attachment_mask;
+		return key.encoded;
+	}
+
+	static bool is_stencil_format(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return true;
+		default:
+			return false;
+		}
+	}
+
 	VkRenderPass get_renderpass(VkDevice dev, u64 renderpass_key)
 	{
 		// 99.999% of checks will go through this block once on-disk shader cache has loaded
@@ -272,7 +298,7 @@ namespace vk
 			VkAttachmentDescription color_attachment_description = {};
 			color_attachment_description.format = color_format;
 			color_attachment_description.samples = samples;
-			color_attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+			color_attachment_description.loadOp = (key.load_discard_mask & (1u << attachment_count)) ? VK_ATTACHMENT_LOAD_OP_DONT_CARE : VK_ATTACHMENT_LOAD_OP_LOAD;
 			color_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 			color_attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 			color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
@@ -285,13 +311,17 @@ namespace vk
 
 		if (depth_format)
 		{
+			// Tilers skip the tile load for discarded attachments and never touch stencil memory that does not exist
+			const bool discard_contents = !!(key.load_discard_mask & (1u << attachment_count));
+			const bool has_stencil = is_stencil_format(depth_format);
+
 			VkAttachmentDescription depth_attachment_description = {};
 			depth_attachment_description.format = depth_format;
 			depth_attachment_description.samples = samples;
-			depth_attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+			depth_attachment_description.loadOp = discard_contents ? VK_ATTACHMENT_LOAD_OP_DONT_CARE : VK_ATTACHMENT_LOAD_OP_LOAD;
 			depth_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			depth_attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-			depth_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+			depth_attachment_description.stencilLoadOp = (has_stencil && !discard_contents) ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			depth_attachment_description.stencilStoreOp = has_stencil ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
 			depth_attachment_description.initialLayout = dsv_layout;
 			depth_attachment_description.finalLayout = dsv_layout;
 			attachments.push_back(depth_attachment_description);
@@ -323,6 +353,7 @@ namespace vk
 		CHECK_RESULT(VK_GET_SYMBOL(vkCreateRenderPass)(dev, &rp_info, NULL, &result));
 
 		g_renderpass_cache[renderpass_key] = result;
+		g_renderpass_keys[result] = renderpass_key;
 		return result;
 	}
 
@@ -340,12 +371,14 @@ namespace vk
 		}
 
 		g_renderpass_cache.clear();
+		g_renderpass_keys.clear();
 	}
 
-	void begin_renderpass(const vk::command_buffer& cmd, VkRenderPass pass, VkFramebuffer target, const coordu& framebuffer_region)
+	void begin_renderpass(const vk::command_buffer& cmd, VkRenderPass pass, VkFramebuffer target, const coordu& framebuffer_region, VkRenderPass compatible_pass)
 	{
 		auto& renderpass_info = g_current_renderpass[cmd];
-		if (renderpass_info.pass == pass && renderpass_info.fbo == target)
+		if (renderpass_info.fbo == target &&
+			(renderpass_info.pass == pass || (renderpass_info.compatible_pass == pass && pass != VK_NULL_HANDLE)))
 		{
 			return;
 		}
@@ -363,8 +396,22 @@ namespace vk
 		rp_begin.renderArea.extent.width = framebuffer_region.width;
 		rp_begin.renderArea.extent.height = framebuffer_region.height;
 
+		if (const auto timer = g_gpu_frame_timer; timer && timer->is_pass_timing_enabled())
+		{
+			u64 renderpass_key = 0;
+			{
+				reader_lock lock(g_renderpass_cache_mutex);
+				if (auto found = g_renderpass_keys.find(pass); found != g_renderpass_keys.end())
+				{
+					renderpass_key = found->second;
+				}
+			}
+
+			timer->begin_renderpass(cmd, renderpass_key, static_cast<u16>(framebuffer_region.width), static_cast<u16>(framebuffer_region.height));
+		}
+
 		VK_GET_SYMBOL(vkCmdBeginRenderPass)(cmd, &rp_begin, VK_SUBPASS_CONTENTS_INLINE);
-		renderpass_info = {pass, target};
+		renderpass_info = {pass, target, compatible_pass};
 	}
 
 	void begin_renderpass(VkDevice dev, const vk::command_buffer& cmd, u64 renderpass_key, VkFramebuffer target, const coordu& framebuffer_region)
@@ -382,6 +429,11 @@ namespace vk
 	{
 		VK_GET_SYMBOL(vkCmdEndRenderPass)(cmd);
 		g_current_renderpass[cmd] = {};
+
+		if (const auto timer = g_gpu_frame_timer)
+		{
+			timer->end_renderpass(cmd);
+		}
 	}
 
 	bool is_renderpass_open(const vk::command_buffer& cmd)
@@ -11,6 +11,7 @@ namespace vk
 	u64 get_renderpass_key(const std::vector<vk::image*>& images, const std::vector<u8>& input_attachment_ids = {});
 	u64 get_renderpass_key(const std::vector<vk::image*>& images, u64 previous_key);
 	u64 get_renderpass_key(VkFormat surface_format);
+	u64 get_renderpass_key_discard_load(u64 renderpass_key, u32 attachment_mask);
 	VkRenderPass get_renderpass(VkDevice dev, u64 renderpass_key);
 
 	void clear_renderpass_cache(VkDevice dev);
@@ -18,7 +19,8 @@ namespace vk
 	// Renderpass scope management helpers.
 	// NOTE: These are not thread safe by design.
 	void begin_renderpass(VkDevice dev, const vk::command_buffer& cmd, u64 renderpass_key, VkFramebuffer target, const coordu& framebuffer_region);
-	void begin_renderpass(const vk::command_buffer& cmd, VkRenderPass pass, VkFramebuffer target, const coordu& framebuffer_region);
+	// compatible_pass: a pass that the opened pass may stand in for without restarting (e.g. a load-discarding variant)
+	void begin_renderpass(const vk::command_buffer& cmd, VkRenderPass pass, VkFramebuffer target, const coordu& framebuffer_region, VkRenderPass compatible_pass = VK_NULL_HANDLE);
 	void end_renderpass(const vk::command_buffer& cmd);
 	bool is_renderpass_open(const vk::command_buffer& cmd);
 
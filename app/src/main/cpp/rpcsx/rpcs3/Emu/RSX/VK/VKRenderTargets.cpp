@@ -1,3 +1,4 @@
+#include "vkutils/barriers.h"
 #include "vkutils/data_heap.h"
 #include "VKRenderTargets.h"
 #include "VKResourceManager.h"
@@ -15,6 +16,110 @@ namespace vk
 			auto obj = vk::disposable_t::make(buf);
 			vk::get_resource_manager()->dispose(obj);
 		}
+
+		// Plain copies into one surface, recorded together so that all sources share one set of layout transitions.
+		// Copies with overlapping destination areas must not be in the same batch, their order matters.
+		class inheritance_copy_batch
+		{
+			struct source_copies
+			{
+				vk::image* image;
+				VkImageLayout restore_layout;
+				std::vector<VkImageCopy> regions;
+			};
+
+			vk::image* m_dst = nullptr;
+			std::vector<source_copies> m_sources;
+			std::vector<areai> m_dst_areas;
+
+		public:
+			bool reads_from(const vk::image* image) const
+			{
+				return std::any_of(m_sources.begin(), m_sources.end(), [&](const auto& e)
+					{
+						return e.image == image;
+					});
+			}
+
+			bool overlaps(const areai& dst_area) const
+			{
+				return std::any_of(m_dst_areas.begin(), m_dst_areas.end(), [&](const areai& area)
+					{
+						return area.x1 < dst_area.x2 && dst_area.x1 < area.x2 && area.y1 < dst_area.y2 && dst_area.y1 < area.y2;
+					});
+			}
+
+			void add(vk::image* src, vk::image* dst, const areai& src_area, const areai& dst_area)
+			{
+				AUDIT(!m_dst || m_dst == dst);
+				m_dst = dst;
+
+				VkImageCopy rgn = {};
+				rgn.extent = {u32(src_area.width()), u32(src_area.height()), 1};
+				rgn.srcOffset = {src_area.x1, src_area.y1, 0};
+				rgn.dstOffset = {dst_area.x1, dst_area.y1, 0};
+				rgn.srcSubresource = {src->aspect(), 0, 0, 1};
+				rgn.dstSubresource = {dst->aspect(), 0, 0, 1};
+
+				auto found = std::find_if(m_sources.begin(), m_sources.end(), [&](const auto& e)
+					{
+						return e.image == src;
+					});
+
+				if (found == m_sources.end())
+				{
+					found = m_sources.insert(m_sources.end(), {src, VK_IMAGE_LAYOUT_UNDEFINED, {}});
+				}
+
+				found->regions.push_back(rgn);
+				m_dst_areas.push_back(dst_area);
+			}
+
+			void flush(vk::command_buffer& cmd)
+			{
+				if (m_sources.empty())
+				{
+					return;
+				}
+
+				vk::image_barrier_batch barriers;
+				const auto dst_layout = m_dst->current_layout;
+
+				for (auto& e : m_sources)
+				{
+					e.restore_layout = e.image->current_layout;
+					barriers.change_layout(e.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+				}
+
+				barriers.change_layout(m_dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+				barriers.flush(cmd);
+
+				for (auto& e : m_sources)
+				{
+					VK_GET_SYMBOL(vkCmdCopyImage)(cmd, e.image->value, e.image->current_layout, m_dst->value, m_dst->current_layout, ::size32(e.regions), e.regions.data());
+				}
+
+				// Images that were never initialized stay in the transfer layouts
+				for (auto& e : m_sources)
+				{
+					if (e.restore_layout != VK_IMAGE_LAYOUT_UNDEFINED)
+					{
+						barriers.change_layout(e.image, e.restore_layout);
+					}
+				}
+
+				if (dst_layout != VK_IMAGE_LAYOUT_UNDEFINED)
+				{
+					barriers.change_layout(m_dst, dst_layout);
+				}
+
+				barriers.flush(cmd);
+
+				m_dst = nullptr;
+				m_sources.clear();
+				m_dst_areas.clear();
+			}
+		};
 	} // namespace surface_cache_utils
 
 	void surface_cache::destroy()
@@ -399,6 +504,65 @@ namespace vk
 		msaa_flags &= ~(rsx::surface_state_flags::require_resolve);
 	}
 
+	vk::image* render_target::get_resolved_scaled_surface(vk::command_buffer& cmd, u32 dst_width, u32 dst_height)
+	{
+		if (samples() == 1 || is_depth_surface() || !(info.usage & VK_IMAGE_USAGE_STORAGE_BIT) || !vk::is_resolve_scale_supported(format()))
+		{
+			return nullptr;
+		}
+
+		const auto resolve_w = width() * samples_x;
+		const auto resolve_h = height() * samples_y;
+		if (resolve_w == dst_width && resolve_h == dst_height)
+		{
+			// No scaling, the regular resolve writes the same amount of data
+			return nullptr;
+		}
+
+		// Bring the contents up to date without resolving
+		memory_barrier(cmd, rsx::surface_access::shader_read);
+
+		if ((msaa_flags & rsx::surface_state_flags::require_resolve) == 0 ||
+			(msaa_flags & rsx::surface_state_flags::require_unresolve) != 0)
+		{
+			// The resolve surface holds the latest data already
+			return nullptr;
+		}
+
+		auto dst = vk::get_typeless_helper(format(), format_class(), dst_width, dst_height, VK_IMAGE_USAGE_STORAGE_BIT);
+		VkImageSubresourceRange range = {aspect(), 0, 1, 0, 1};
+
+		// Finish writing before reading
+		vk::insert_image_memory_barrier(
+			cmd, this->value,
+			this->current_layout, VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			range);
+
+		this->current_layout = VK_IMAGE_LAYOUT_GENERAL;
+		dst->change_layout(cmd, VK_IMAGE_LAYOUT_GENERAL);
+
+		vk::resolve_image_scaled(cmd, dst, dst_width, dst_height, this);
+
+		vk::insert_image_memory_barrier(
+			cmd, this->value,
+			this->current_layout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			VK_ACCESS_SHADER_READ_BIT,
+			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+			range);
+
+		this->current_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		// The resolve surface is left stale, require_resolve stays set for other readers
+		dst->change_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+		return dst;
+	}
+
 	// Unresolve the linear data into planar MSAA data
 	void render_target::unresolve(vk::command_buffer& cmd)
 	{
@@ -719,7 +883,7 @@ namespace vk
 #endif
 		}
 
-		if (g_cfg.video.resolution_scale_percent == 100 && spp == 1) [[likely]]
+		if (rsx::get_resolution_scale_percent() == 100 && spp == 1) [[likely]]
 		{
 			push_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 			vk::upload_image(cmd, this, {subres}, get_gcm_format(), is_swizzled, 1, aspect(), upload_heap, heap_align, upload_flags);
@@ -996,6 +1160,7 @@ namespace vk
 		// Memory transfers
 		vk::image* target_image = (samples() > 1) ? get_resolve_target_safe(cmd) : this;
 		vk::blitter hw_blitter;
+		surface_cache_utils::inheritance_copy_batch copy_batch;
 		const auto dst_bpp = get_bpp();
 
 		unsigned first = prepare_rw_barrier_for_transfer(this);
@@ -1007,6 +1172,14 @@ namespace vk
 		{
 			auto& section = old_contents[i];
 			auto src_texture = static_cast<vk::render_target*>(section.source);
+
+			if (!src_texture->old_contents.empty() || copy_batch.reads_from(src_texture) ||
+				(src_texture->resolve_surface && copy_batch.reads_from(src_texture->resolve_surface.get())))
+			{
+				// The source is about to be written to
+				copy_batch.flush(cmd);
+			}
+
 			src_texture->memory_barrier(cmd, rsx::surface_access::transfer_read);
 
 			if (!accept_all && !src_texture->test()) [[likely]]
@@ -1053,6 +1226,7 @@ namespace vk
 			else if (state_flags & rsx::surface_state_flags::erase_bkgnd)
 			{
 				// Might introduce MSAA flags
+				copy_batch.flush(cmd);
 				initialize_memory(cmd, rsx::surface_access::memory_write);
 				ensure(state_flags == rsx::surface_state_flags::ready);
 			}
@@ -1060,6 +1234,7 @@ namespace vk
 			if (msaa_flags & rsx::surface_state_flags::require_resolve)
 			{
 				// Need to forward resolve this
+				copy_batch.flush(cmd);
 				resolve(cmd);
 			}
 
@@ -1075,18 +1250,42 @@ namespace vk
 				src_texture->get_resolve_target_safe(cmd);
 			}
 
-			hw_blitter.scale_image(
-				cmd,
-				src_texture->get_surface(rsx::surface_access::transfer_read),
-				this->get_surface(rsx::surface_access::transfer_write),
-				src_area,
-				dst_area,
-				/*linear?*/ false, typeless_info);
+			vk::image* src_image = src_texture->get_surface(rsx::surface_access::transfer_read);
+			vk::image* dst_image = this->get_surface(rsx::surface_access::transfer_write);
+
+			if (!typeless_info.src_is_typeless && src_image != dst_image &&
+				src_area.width() == dst_area.width() && src_area.height() == dst_area.height() &&
+				((src_image->aspect() | dst_image->aspect()) & VK_IMAGE_ASPECT_COLOR_BIT || src_image->format() == dst_image->format()) &&
+				(src_image->current_queue_family == VK_QUEUE_FAMILY_IGNORED || src_image->current_queue_family == cmd.get_queue_family()) &&
+				(dst_image->current_queue_family == VK_QUEUE_FAMILY_IGNORED || dst_image->current_queue_family == cmd.get_queue_family()))
+			{
+				// Plain copy, defer it so that it shares the barriers of the other copies into this surface
+				if (copy_batch.overlaps(dst_area))
+				{
+					copy_batch.flush(cmd);
+				}
+
+				copy_batch.add(src_image, dst_image, src_area, dst_area);
+			}
+			else
+			{
+				copy_batch.flush(cmd);
+
+				hw_blitter.scale_image(
+					cmd,
+					src_image,
+					dst_image,
+					src_area,
+					dst_area,
+					/*linear?*/ false, typeless_info);
+			}
 
 			optimize_copy = optimize_copy && !memory_load;
 			newest_tag = src_texture->last_use_tag;
 		}
 
+		copy_batch.flush(cmd);
+
 		if (!newest_tag) [[unlikely]]
 		{
 			// Underlying memory has been modified and we could not find valid data to fill it
@@ -20,6 +20,8 @@ namespace vk
 
 	void resolve_image(vk::command_buffer& cmd, vk::viewable_image* dst, vk::viewable_image* src);
 	void unresolve_image(vk::command_buffer& cmd, vk::viewable_image* dst, vk::viewable_image* src);
+	bool is_resolve_scale_supported(VkFormat format);
+	void resolve_image_scaled(vk::command_buffer& cmd, vk::image* dst, u32 dst_width, u32 dst_height, vk::viewable_image* src);
 
 	class image_reference_sync_barrier
 	{
@@ -106,6 +108,8 @@ namespace vk
 		using viewable_image::viewable_image;
 
 		vk::viewable_image* get_surface(rsx::surface_access access_type) override;
+		// Resolve a pending MSAA surface into a scratch image of the given size for readback. Returns null if the fused pass cannot be used
+		vk::image* get_resolved_scaled_surface(vk::command_buffer& cmd, u32 dst_width, u32 dst_height);
 		bool is_depth_surface() const override;
 		bool matches_dimensions(u16 _width, u16 _height) const;
 		void reset_surface_counters();
@@ -3,6 +3,7 @@
 #include "VKResolveHelper.h"
 #include "VKRenderPass.h"
 #include "VKRenderTargets.h"
+#include "VKResourceManager.h"
 
 namespace
 {
@@ -37,6 +38,7 @@ namespace vk
 {
 	std::unordered_map<VkFormat, std::unique_ptr<vk::cs_resolve_task>> g_resolve_helpers;
 	std::unordered_map<VkFormat, std::unique_ptr<vk::cs_unresolve_task>> g_unresolve_helpers;
+	std::unordered_map<VkFormat, std::unique_ptr<vk::cs_resolve_scale_task>> g_resolve_scale_helpers;
 	std::unique_ptr<vk::depthonly_resolve> g_depth_resolver;
 	std::unique_ptr<vk::depthonly_unresolve> g_depth_unresolver;
 	std::unique_ptr<vk::stencilonly_resolve> g_stencil_resolver;
@@ -123,6 +125,50 @@ namespace vk
 		}
 	}
 
+	bool is_resolve_scale_supported(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+		case VK_FORMAT_R32G32B32A32_SFLOAT:
+		case VK_FORMAT_R8_UNORM:
+		case VK_FORMAT_R8G8_UNORM:
+		case VK_FORMAT_R32_SFLOAT:
+			break;
+		case VK_FORMAT_B8G8R8A8_UNORM:
+			if (vk::get_chip_family() == vk::chip_class::NV_kepler)
+			{
+				// Broken image_load_store, keep to the resolve pass with the swap workaround
+				return false;
+			}
+			break;
+		default:
+			// Packed 16-bit formats are read as r16 and cannot be filtered per channel
+			return false;
+		}
+
+		return true;
+	}
+
+	void resolve_image_scaled(vk::command_buffer& cmd, vk::image* dst, u32 dst_width, u32 dst_height, vk::viewable_image* src)
+	{
+		ensure(src->aspect() == VK_IMAGE_ASPECT_COLOR_BIT);
+
+		auto& job = g_resolve_scale_helpers[src->format()];
+		if (!job)
+		{
+			job.reset(new vk::cs_resolve_scale_task(get_format_prefix(src->format())));
+		}
+
+		auto& dev = cmd.get_command_pool().get_owner();
+		auto dst_view = std::make_unique<vk::image_view>(dev, dst);
+
+		job->run(cmd, src, dst_view.get(), dst_width, dst_height);
+
+		vk::get_resource_manager()->dispose(dst_view);
+	}
+
 	void unresolve_image(vk::command_buffer& cmd, vk::viewable_image* dst, vk::viewable_image* src)
 	{
 		if (src->aspect() == VK_IMAGE_ASPECT_COLOR_BIT)
@@ -204,8 +250,14 @@ namespace vk
 			task.second->destroy();
 		}
 
+		for (auto& task : g_resolve_scale_helpers)
+		{
+			task.second->destroy();
+		}
+
 		g_resolve_helpers.clear();
 		g_unresolve_helpers.clear();
+		g_resolve_scale_helpers.clear();
 
 		if (g_depth_resolver)
 		{
@@ -298,6 +350,75 @@ namespace vk
 		rsx_log.notice("Compute shader:\n%s", m_src);
 	}
 
+	cs_resolve_scale_task::cs_resolve_scale_task(const std::string& format_prefix)
+	{
+		use_push_constants = true;
+		push_constants_size = 16;
+
+		create();
+
+		switch (optimal_group_size)
+		{
+		default:
+		case 64:
+			cs_wave_x = 8;
+			cs_wave_y = 8;
+			break;
+		case 32:
+			cs_wave_x = 8;
+			cs_wave_y = 4;
+			break;
+		}
+
+		// Sample layout matches ColorResolvePass: 2 samples are 2x1, 4 samples are 2x2
+		static const char* resolve_scale_kernel =
+			"#version 450\n"
+			"layout(local_size_x=%WORKGROUP_SIZE_X, local_size_y=%WORKGROUP_SIZE_Y, local_size_z=1) in;\n"
+			"\n"
+			"layout(set=0, binding=0, %IMAGE_FORMAT) uniform readonly restrict image2DMS multisampled;\n"
+			"layout(set=0, binding=1, %IMAGE_FORMAT) uniform writeonly restrict image2D scaled;\n"
+			"layout(push_constant) uniform parameters { uvec4 params; };\n"
+			"\n"
+			"ivec2 sample_count;\n"
+			"ivec2 resolve_size;\n"
+			"\n"
+			"vec4 load_resolved(ivec2 coords)\n"
+			"{\n"
+			"	coords = clamp(coords, ivec2(0), resolve_size - 1);\n"
+			"	const ivec2 sample_loc = coords % sample_count;\n"
+			"	return imageLoad(multisampled, coords / sample_count, sample_loc.x + (sample_loc.y * sample_count.x));\n"
+			"}\n"
+			"\n"
+			"void main()\n"
+			"{\n"
+			"	const ivec2 coords = ivec2(gl_GlobalInvocationID.xy);\n"
+			"	const ivec2 scaled_size = ivec2(params.xy);\n"
+			"	if (any(greaterThanEqual(coords, scaled_size))) return;\n"
+			"\n"
+			"	sample_count = ivec2(2, imageSamples(multisampled) / 2);\n"
+			"	resolve_size = imageSize(multisampled) * sample_count;\n"
+			"\n"
+			"	// Texel centers mapped the same way vkCmdBlitImage does with linear filtering\n"
+			"	const vec2 location = ((vec2(coords) + 0.5) * vec2(resolve_size) / vec2(scaled_size)) - 0.5;\n"
+			"	const ivec2 base = ivec2(floor(location));\n"
+			"	const vec2 weight = location - vec2(base);\n"
+			"\n"
+			"	const vec4 top = mix(load_resolved(base), load_resolved(base + ivec2(1, 0)), weight.x);\n"
+			"	const vec4 bottom = mix(load_resolved(base + ivec2(0, 1)), load_resolved(base + ivec2(1, 1)), weight.x);\n"
+			"	imageStore(scaled, coords, mix(top, bottom, weight.y));\n"
+			"}\n";
+
+		const std::pair<std::string_view, std::string> syntax_replace[] =
+			{
+				{"%WORKGROUP_SIZE_X", std::to_string(cs_wave_x)},
+				{"%WORKGROUP_SIZE_Y", std::to_string(cs_wave_y)},
+				{"%IMAGE_FORMAT", format_prefix}};
+
+		m_src = fmt::replace_all(resolve_scale_kernel, syntax_replace);
+
+		rsx_log.notice("Compute shader:\n%s", m_src);
+	}
+
 	void depth_resolve_base::build(bool resolve_depth, bool resolve_stencil, bool is_unresolve)
 	{
 		vs_src =
@@ -91,6 +91,67 @@ namespace vk
 		}
 	};
 
+	// Resolve and rescale in one pass for readback of resolution-scaled MSAA surfaces.
+	// Filters like a linear blit of the resolved image would, without writing the full-size resolve surface.
+	struct cs_resolve_scale_task : compute_task
+	{
+		vk::viewable_image* multisampled = nullptr;
+		vk::image_view* scaled_view = nullptr;
+
+		u32 cs_wave_x = 1;
+		u32 cs_wave_y = 1;
+
+		cs_resolve_scale_task(const std::string& format_prefix);
+
+		std::vector<std::pair<VkDescriptorType, u8>> get_descriptor_layout() override
+		{
+			return {
+				{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2}};
+		}
+
+		void declare_inputs() override
+		{
+			std::vector<vk::glsl::program_input> inputs =
+				{
+					{::glsl::program_domain::glsl_compute_program,
+						vk::glsl::program_input_type::input_type_texture,
+						{}, {},
+						0,
+						"multisampled"},
+					{::glsl::program_domain::glsl_compute_program,
+						vk::glsl::program_input_type::input_type_texture,
+						{}, {},
+						1,
+						"scaled"}};
+
+			m_program->load_uniforms(inputs);
+		}
+
+		void bind_resources() override
+		{
+			auto msaa_view = multisampled->get_view(rsx::default_remap_vector.with_encoding(VK_REMAP_VIEW_MULTISAMPLED));
+			m_program->bind_uniform({VK_NULL_HANDLE, msaa_view->value, multisampled->current_layout}, "multisampled", VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_descriptor_set);
+			m_program->bind_uniform({VK_NULL_HANDLE, scaled_view->value, scaled_view->image()->current_layout}, "scaled", VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_descriptor_set);
+		}
+
+		void run(const vk::command_buffer& cmd, vk::viewable_image* msaa_image, vk::image_view* dst_view, u32 dst_width, u32 dst_height)
+		{
+			ensure(msaa_image->samples() > 1);
+			ensure(dst_view->image()->samples() == 1);
+
+			multisampled = msaa_image;
+			scaled_view = dst_view;
+
+			const u32 params[4] = {dst_width, dst_height, 0, 0};
+			VK_GET_SYMBOL(vkCmdPushConstants)(cmd, m_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, push_constants_size, params);
+
+			const u32 invocations_x = rx::alignUp(dst_width, cs_wave_x) / cs_wave_x;
+			const u32 invocations_y = rx::alignUp(dst_height, cs_wave_y) / cs_wave_y;
+
+			compute_task::run(cmd, invocations_x, invocations_y, 1);
+		}
+	};
+
 	struct depth_resolve_base : public overlay_pass
 	{
 		u8 samples_x = 1;
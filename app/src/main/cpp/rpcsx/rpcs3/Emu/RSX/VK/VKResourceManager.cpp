@@ -2,6 +2,7 @@
 #include "VKResourceManager.h"
 #include "VKGSRender.h"
 #include "VKCommandStream.h"
+#include "Emu/Cell/timers.hpp"
 
 namespace vk
 {
@@ -45,8 +46,54 @@ namespace vk
 		return &g_resource_manager;
 	}
 
+	void resource_manager::collect_retired(u64 budget_us)
+	{
+		// Past this backlog everything is released regardless of the budget
+		constexpr usz max_retired_objects = 4096;
+		constexpr usz batch_size = 16;
+
+		const u64 start = get_system_time();
+
+		while (true)
+		{
+			std::vector<disposable_t> batch;
+			{
+				std::lock_guard lock(m_retired_lock);
+
+				if (m_retired.empty())
+				{
+					return;
+				}
+
+				usz count = std::min(batch_size, m_retired.size());
+				if (m_retired.size() > max_retired_objects)
+				{
+					count = m_retired.size() - max_retired_objects + batch_size;
+				}
+
+				batch.reserve(count);
+				for (usz i = 0; i < count; ++i)
+				{
+					batch.emplace_back(std::move(m_retired.front()));
+					m_retired.pop_front();
+				}
+			}
+
+			// Driver frees happen here, outside the lock
+			batch.clear();
+
+			if (get_system_time() - start >= budget_us)
+			{
+				return;
+			}
+		}
+	}
+
 	void resource_manager::trim()
 	{
+		// Frame boundary, also catches up on retired objects if no event completed in a while
+		collect_retired();
+
 		// For any managed resources, try to keep the number of unused/idle resources as low as possible.
 		// Improves search times as well as keeping us below the hardware limit.
 		const auto limits = get_current_renderer()->gpu().get_limits();
@@ -7,6 +7,7 @@
 #include "util/mutex.h"
 
 #include <deque>
+#include <iterator>
 #include <memory>
 
 namespace vk
@@ -55,6 +56,10 @@ namespace vk
 		std::deque<eid_scope_t> m_eid_map;
 		shared_mutex m_eid_map_lock;
 
+		// Objects whose scope has completed but that were not destroyed yet, drained under a time budget
+		std::deque<disposable_t> m_retired;
+		shared_mutex m_retired_lock;
+
 		std::vector<std::function<void()>> m_exit_handlers;
 
 		inline eid_scope_t& get_current_eid_scope()
@@ -88,6 +93,7 @@ namespace vk
 		void flush()
 		{
 			m_eid_map.clear();
+			m_retired.clear();
 			m_sampler_pool.clear();
 		}
 
@@ -172,9 +178,21 @@ namespace vk
 					m_eid_map.front().swap(tmp);
 					m_eid_map.pop_front();
 				}
+
+				if (!tmp.m_disposables.empty())
+				{
+					std::lock_guard lock(m_retired_lock);
+					std::move(tmp.m_disposables.begin(), tmp.m_disposables.end(), std::back_inserter(m_retired));
+					tmp.m_disposables.clear();
+				}
 			}
+
+			collect_retired();
 		}
 
+		// Destroy retired objects until the time budget runs out
+		void collect_retired(u64 budget_us = 500);
+
 		void trim();
 
 		std::vector<const gpu_debug_marker*> gather_debug_markers() const
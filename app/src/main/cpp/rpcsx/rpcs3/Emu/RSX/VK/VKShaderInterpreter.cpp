@@ -447,6 +447,11 @@ namespace vk
 			dynamic_state_descriptors.push_back(VK_DYNAMIC_STATE_DEPTH_BOUNDS);
 		}
 
+		if (vk::get_current_renderer()->get_fragment_shading_rate_support())
+		{
+			dynamic_state_descriptors.push_back(VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR);
+		}
+
 		VkPipelineDynamicStateCreateInfo dynamic_state_info = {};
 		dynamic_state_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 		dynamic_state_info.pDynamicStates = dynamic_state_descriptors.data();
@@ -870,6 +870,55 @@ namespace vk
 		ensure(dst_offset <= scratch_buf->size());
 	}
 
+	static u32 get_dxt_decoded_size(const VkExtent3D& extent)
+	{
+		// Decoded output always covers whole 4x4 blocks
+		return rx::alignUp(extent.width, 4) * rx::alignUp(extent.height, 4) * extent.depth * 4;
+	}
+
+	template <u32 Format>
+	static void gpu_decode_dxt_sections(const vk::command_buffer& cmd, vk::buffer* scratch_buf, u32 dst_offset, std::vector<VkBufferImageCopy>& sections)
+	{
+		auto job = vk::get_compute_task<cs_decode_dxt<Format>>();
+
+		for (auto& section : sections)
+		{
+			// Align output to 128-byte boundary to keep some drivers happy
+			dst_offset = rx::alignUp(dst_offset, 128);
+
+			const u32 width_in_blocks = rx::aligned_div(section.imageExtent.width, 4u);
+			const u32 block_rows = rx::aligned_div(section.imageExtent.height, 4u) * section.imageExtent.depth;
+			const u32 src_offset = static_cast<u32>(section.bufferOffset);
+
+			job->run(cmd, scratch_buf, dst_offset, scratch_buf, src_offset, width_in_blocks, block_rows, width_in_blocks * 4);
+
+			section.bufferOffset = dst_offset;
+			section.bufferRowLength = width_in_blocks * 4;
+			section.bufferImageHeight = rx::alignUp(section.imageExtent.height, 4);
+			dst_offset += get_dxt_decoded_size(section.imageExtent);
+		}
+
+		ensure(dst_offset <= scratch_buf->size());
+	}
+
+	static void gpu_decode_dxt_sections_impl(const vk::command_buffer& cmd, vk::buffer* scratch_buf, u32 dst_offset, int format, std::vector<VkBufferImageCopy>& sections)
+	{
+		switch (format)
+		{
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT1:
+			gpu_decode_dxt_sections<1>(cmd, scratch_buf, dst_offset, sections);
+			break;
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT23:
+			gpu_decode_dxt_sections<2>(cmd, scratch_buf, dst_offset, sections);
+			break;
+		case CELL_GCM_TEXTURE_COMPRESSED_DXT45:
+			gpu_decode_dxt_sections<3>(cmd, scratch_buf, dst_offset, sections);
+			break;
+		default:
+			fmt::throw_exception("Unreachable");
+		}
+	}
+
 	static const vk::command_buffer& prepare_for_transfer(const vk::command_buffer& primary_cb, vk::image* dst_image, rsx::flags32_t& flags)
 	{
 		AsyncTaskScheduler* async_scheduler = (flags & image_upload_options::upload_contents_async) ? std::addressof(g_fxo->get<AsyncTaskScheduler>()) : nullptr;
@@ -938,6 +987,12 @@ namespace vk
 		u32 block_in_pixel = rsx::get_format_block_size_in_texel(format);
 		u8 block_size_in_bytes = rsx::get_format_block_size_in_bytes(format);
 
+		if (format == CELL_GCM_TEXTURE_COMPRESSED_DXT1 && !caps.supports_dxt && caps.supports_astc_transcode)
+		{
+			// ASTC 4x4 blocks are twice the size of the DXT1 input
+			block_size_in_bytes = 16;
+		}
+
 		u32 row_pitch, upload_pitch_in_texel;
 
 		if (!heap_align) [[likely]]
@@ -982,7 +1037,7 @@ namespace vk
 	{
 		const bool requires_depth_processing = (dst_image->aspect() & VK_IMAGE_ASPECT_STENCIL_BIT) || (format == CELL_GCM_TEXTURE_DEPTH16_FLOAT);
 		auto pdev = vk::get_current_renderer();
-		rsx::texture_uploader_capabilities caps{.supports_dxt = pdev->get_texture_compression_bc_support(), .alignment = heap_align};
+		rsx::texture_uploader_capabilities caps{.supports_dxt = pdev->get_texture_compression_bc_support(), .supports_astc_transcode = pdev->get_dxt1_astc_transcode_support(), .alignment = heap_align};
 		rsx::texture_memory_info opt{};
 		bool check_caps = true;
 
@@ -1015,6 +1070,7 @@ namespace vk
 				caps.supports_hw_deswizzle = caps.supports_byteswap;
 				caps.supports_zero_copy = caps.supports_byteswap;
 				caps.supports_vtc_decoding = false;
+				caps.supports_hw_dxt_decode = caps.supports_byteswap && !caps.supports_dxt && !(image_setup_flags & source_is_gpu_resident);
 				check_caps = false;
 			}
 
@@ -1097,7 +1153,7 @@ namespace vk
 				caps.supports_zero_copy = false;
 			}
 
-			if (opt.require_swap || opt.require_deswizzle || requires_depth_processing)
+			if (opt.require_swap || opt.require_deswizzle || opt.require_dxt_decode || requires_depth_processing)
 			{
 				if (!scratch_buf)
 				{
@@ -1111,6 +1167,15 @@ namespace vk
 						scratch_buf_size += scratch_buf_size;
 					}
 
+					if (opt.require_dxt_decode)
+					{
+						// DXT decode also writes its output past the uploaded blocks, but expands them to RGBA8
+						for (const auto& section : subresource_layout)
+						{
+							scratch_buf_size += 128u + get_dxt_decoded_size({section.width_in_texel, section.height_in_texel, section.depth});
+						}
+					}
+
 					if (requires_depth_processing)
 					{
 						// D-S aspect requires a load section that can fit a separated block => D(4) + S(1)
@@ -1173,7 +1238,7 @@ namespace vk
 
 		ensure(upload_buffer);
 
-		if (opt.require_swap || opt.require_deswizzle || requires_depth_processing)
+		if (opt.require_swap || opt.require_deswizzle || opt.require_dxt_decode || requires_depth_processing)
 		{
 			ensure(scratch_buf);
 
@@ -1196,7 +1261,11 @@ namespace vk
 		}
 
 		// Swap and deswizzle if requested
-		if (opt.require_deswizzle)
+		if (opt.require_dxt_decode)
+		{
+			gpu_decode_dxt_sections_impl(cmd2, scratch_buf, scratch_offset, format, copy_regions);
+		}
+		else if (opt.require_deswizzle)
 		{
 			gpu_deswizzle_sections_impl(cmd2, scratch_buf, scratch_offset, opt.element_size, opt.block_length, opt.require_swap, copy_regions);
 		}
@@ -1216,10 +1285,11 @@ namespace vk
 		}
 		else if (scratch_buf)
 		{
-			ensure(opt.require_deswizzle || opt.require_swap);
+			ensure(opt.require_deswizzle || opt.require_swap || opt.require_dxt_decode);
 
 			const auto block_start = copy_regions.front().bufferOffset;
-			insert_buffer_memory_barrier(cmd2, scratch_buf->value, block_start, scratch_offset, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			const auto block_length = opt.require_dxt_decode ? (scratch_buf->size() - block_start) : scratch_offset; // Decoded DXT data outgrows the input
+			insert_buffer_memory_barrier(cmd2, scratch_buf->value, block_start, block_length, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
 				VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
 
 			VK_GET_SYMBOL(vkCmdCopyBufferToImage)(cmd2, scratch_buf->value, dst_image->value, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<u32>(copy_regions.size()), copy_regions.data());
@@ -4,8 +4,11 @@
 #include "VKCompute.h"
 #include "VKAsyncScheduler.h"
 
+#include "util/fnv_hash.hpp"
 #include "rx/asm.hpp"
 
+#include <bit>
+
 namespace vk
 {
 	u64 hash_image_properties(VkFormat format, u16 w, u16 h, u16 d, u16 mipmaps, VkImageType type, VkImageCreateFlags create_flags, VkSharingMode sharing_mode)
@@ -32,6 +35,81 @@ namespace vk
 		       (static_cast<u64>(create_flags) << 57);
 	}
 
+	u64 hash_texture_contents(const u8* data, usz length)
+	{
+		// XXH64. Four independent multiply-rotate lanes run at memory speed on the host
+		constexpr u64 prime1 = 0x9E3779B185EBCA87ull;
+		constexpr u64 prime2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr u64 prime3 = 0x165667B19E3779F9ull;
+		constexpr u64 prime4 = 0x85EBCA77C2B2AE63ull;
+		constexpr u64 prime5 = 0x27D4EB2F165667C5ull;
+
+		const auto read64 = [](const u8* src)
+		{
+			u64 value;
+			std::memcpy(&value, src, sizeof(value));
+			return value;
+		};
+
+		const auto round = [](u64 acc, u64 input)
+		{
+			return std::rotl(acc + input * prime2, 31) * prime1;
+		};
+
+		const u8* src = data;
+		const u8* end = data + length;
+		u64 hash;
+
+		if (length >= 32)
+		{
+			u64 v1 = prime1 + prime2, v2 = prime2, v3 = 0, v4 = 0 - prime1;
+			for (; src + 32 <= end; src += 32)
+			{
+				v1 = round(v1, read64(src));
+				v2 = round(v2, read64(src + 8));
+				v3 = round(v3, read64(src + 16));
+				v4 = round(v4, read64(src + 24));
+			}
+
+			hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+			for (const u64 lane : {v1, v2, v3, v4})
+			{
+				hash = (hash ^ round(0, lane)) * prime1 + prime4;
+			}
+		}
+		else
+		{
+			hash = prime5;
+		}
+
+		hash += length;
+
+		for (; src + 8 <= end; src += 8)
+		{
+			hash = std::rotl(hash ^ round(0, read64(src)), 27) * prime1 + prime4;
+		}
+
+		if (src + 4 <= end)
+		{
+			u32 value;
+			std::memcpy(&value, src, sizeof(value));
+			hash = std::rotl(hash ^ (value * prime1), 23) * prime2 + prime3;
+			src += 4;
+		}
+
+		for (; src < end; src++)
+		{
+			hash = std::rotl(hash ^ (*src * prime5), 11) * prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
 	texture_cache::cached_image_reference_t::cached_image_reference_t(texture_cache* parent, std::unique_ptr<vk::viewable_image>& previous)
 	{
 		ensure(previous);
@@ -375,6 +453,15 @@ namespace vk
 
 	void texture_cache::on_section_destroyed(cached_texture_section& tex)
 	{
+		if (const u64 hash = tex.get_content_hash())
+		{
+			if (auto found = m_uploaded_contents.find(hash);
+				found != m_uploaded_contents.end() && found->second.section == &tex)
+			{
+				m_uploaded_contents.erase(found);
+			}
+		}
+
 		if (tex.is_managed() && tex.exists())
 		{
 			auto disposable = vk::disposable_t::make(new cached_image_reference_t(this, tex.get_texture()));
@@ -390,6 +477,7 @@ namespace vk
 		}
 		baseclass::clear();
 
+		m_uploaded_contents.clear();
 		m_cached_images.clear();
 		m_cached_memory_size = 0;
 	}
@@ -1093,6 +1181,46 @@ namespace vk
 		return &region;
 	}
 
+	bool texture_cache::copy_uploaded_contents(vk::command_buffer& cmd, vk::image* dst, u64 content_hash)
+	{
+		const auto found = m_uploaded_contents.find(content_hash);
+		if (found == m_uploaded_contents.end())
+		{
+			return false;
+		}
+
+		// The owner must still hold the same image, and its guest memory must not have been written since the upload
+		auto section = found->second.section;
+		auto src = found->second.image;
+		if (section->get_content_hash() != content_hash || !section->exists() || section->get_raw_texture() != src ||
+			section->is_dirty() || !section->is_locked() ||
+			src->format() != dst->format() || src->width() != dst->width() || src->height() != dst->height() ||
+			src->depth() != dst->depth() || src->mipmaps() != dst->mipmaps() || src->layers() != dst->layers())
+		{
+			m_uploaded_contents.erase(found);
+			return false;
+		}
+
+		if (vk::is_renderpass_open(cmd))
+		{
+			vk::end_renderpass(cmd);
+		}
+
+		rsx::simple_array<VkImageCopy> regions;
+		for (u32 level = 0; level < dst->mipmaps(); ++level)
+		{
+			const VkImageSubresourceLayers subresource = {dst->aspect(), level, 0, dst->layers()};
+			const VkExtent3D extent = {std::max(dst->width() >> level, 1u), std::max(dst->height() >> level, 1u), std::max(dst->depth() >> level, 1u)};
+			regions.push_back({subresource, {}, subresource, {}, extent});
+		}
+
+		src->push_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+		dst->change_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+		VK_GET_SYMBOL(vkCmdCopyImage)(cmd, src->value, src->current_layout, dst->value, dst->current_layout, regions.size(), regions.data());
+		src->pop_layout(cmd);
+		return true;
+	}
+
 	cached_texture_section* texture_cache::upload_image_from_cpu(vk::command_buffer& cmd, const utils::address_range& rsx_range, u16 width, u16 height, u16 depth, u16 mipmaps, u32 pitch, u32 gcm_format,
 		rsx::texture_upload_context context, const std::vector<rsx::subresource_layout>& subresource_layout, rsx::texture_dimension_extended type, bool swizzled)
 	{
@@ -1167,8 +1295,30 @@ namespace vk
 		}
 
 		const u16 layer_count = (type == rsx::texture_dimension_extended::texture_dimension_cubemap) ? 6 : 1;
-		vk::upload_image(cmd, image, *p_subresource_layout, gcm_format, input_swizzled, layer_count, image->aspect(),
-			*m_texture_upload_heap, heap_align, upload_command_flags);
+
+		// Identical guest data at another address (streamed copies, repeated atlases) is copied from the resident image
+		// instead of being converted and uploaded again. Async uploads are skipped, their images may still be in flight.
+		u64 content_hash = 0;
+		if (g_cfg.video.vk.texture_upload_dedup && context == rsx::texture_upload_context::shader_read &&
+			!(upload_command_flags & upload_contents_async) && rsx_range.length() >= min_dedup_upload_size)
+		{
+			content_hash = hash_texture_contents(vm::_ptr<const u8>(rsx_range.start), rsx_range.length());
+			content_hash = rpcs3::hash64(content_hash, hash_image_properties(image->format(), width, height, depth, mipmaps, image->info.imageType, image->info.flags, image->info.sharingMode));
+			content_hash = rpcs3::hash64(content_hash, (u64{pitch} << 32) | (u64{gcm_format} << 8) | (swizzled ? 1 : 0));
+			content_hash = content_hash ? content_hash : 1;
+		}
+
+		if (!content_hash || !copy_uploaded_contents(cmd, image, content_hash))
+		{
+			vk::upload_image(cmd, image, *p_subresource_layout, gcm_format, input_swizzled, layer_count, image->aspect(),
+				*m_texture_upload_heap, heap_align, upload_command_flags);
+		}
+
+		if (content_hash)
+		{
+			section->set_content_hash(content_hash);
+			m_uploaded_contents[content_hash] = {section, image};
+		}
 
 		vk::leave_uninterruptible();
 
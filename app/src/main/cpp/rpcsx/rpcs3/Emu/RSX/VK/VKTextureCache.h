@@ -45,6 +45,9 @@ namespace vk
 		vk::render_device* m_device = nullptr;
 		vk::viewable_image* vram_texture = nullptr;
 
+		// Hash of the guest data uploaded into vram_texture, 0 when the section is not tracked for upload dedup
+		u64 content_hash = 0;
+
 	public:
 		using baseclass::cached_texture_section;
 
@@ -76,6 +79,7 @@ namespace vk
 
 			this->gcm_format = gcm_format;
 			this->pack_unpack_swap_bytes = pack_swap_bytes;
+			this->content_hash = 0;
 
 			if (managed)
 			{
@@ -128,6 +132,7 @@ namespace vk
 			m_tex_cache->on_section_destroyed(*this);
 
 			vram_texture = nullptr;
+			content_hash = 0;
 			ensure(!managed_texture);
 			release_dma_resources();
 
@@ -156,6 +161,16 @@ namespace vk
 			return vram_texture->get_view(rsx::default_remap_vector);
 		}
 
+		u64 get_content_hash() const
+		{
+			return content_hash;
+		}
+
+		void set_content_hash(u64 hash)
+		{
+			content_hash = hash;
+		}
+
 		vk::viewable_image* get_raw_texture()
 		{
 			return managed_texture.get();
@@ -210,6 +225,7 @@ namespace vk
 			}
 
 			vk::image* locked_resource = vram_texture;
+			vk::image* target = nullptr;
 			u32 transfer_width = width;
 			u32 transfer_height = height;
 			u32 transfer_x = 0, transfer_y = 0;
@@ -217,28 +233,38 @@ namespace vk
 			if (context == rsx::texture_upload_context::framebuffer_storage)
 			{
 				auto surface = vk::as_rtt(vram_texture);
-				surface->memory_barrier(cmd, rsx::surface_access::transfer_read);
-				locked_resource = surface->get_surface(rsx::surface_access::transfer_read);
 				transfer_width *= surface->samples_x;
 				transfer_height *= surface->samples_y;
+
+				// Scaled MSAA surfaces resolve straight to the readback size when possible
+				target = surface->get_resolved_scaled_surface(cmd, transfer_width, transfer_height);
+
+				if (!target)
+				{
+					surface->memory_barrier(cmd, rsx::surface_access::transfer_read);
+					locked_resource = surface->get_surface(rsx::surface_access::transfer_read);
+				}
 			}
 
-			vk::image* target = locked_resource;
-			if (transfer_width != locked_resource->width() || transfer_height != locked_resource->height())
+			if (!target)
 			{
-				// TODO: Synchronize access to typeles textures
-				target = vk::get_typeless_helper(vram_texture->format(), vram_texture->format_class(), transfer_width, transfer_height);
-				target->change_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+				target = locked_resource;
+				if (transfer_width != locked_resource->width() || transfer_height != locked_resource->height())
+				{
+					// TODO: Synchronize access to typeles textures
+					target = vk::get_typeless_helper(vram_texture->format(), vram_texture->format_class(), transfer_width, transfer_height);
+					target->change_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-				// Allow bilinear filtering on color textures where compatibility is likely
-				const auto filter = (target->aspect() == VK_IMAGE_ASPECT_COLOR_BIT) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+					// Allow bilinear filtering on color textures where compatibility is likely
+					const auto filter = (target->aspect() == VK_IMAGE_ASPECT_COLOR_BIT) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
 
-				vk::copy_scaled_image(cmd, locked_resource, target,
-					{0, 0, static_cast<s32>(locked_resource->width()), static_cast<s32>(locked_resource->height())},
-					{0, 0, static_cast<s32>(transfer_width), static_cast<s32>(transfer_height)},
-					1, true, filter);
+					vk::copy_scaled_image(cmd, locked_resource, target,
+						{0, 0, static_cast<s32>(locked_resource->width()), static_cast<s32>(locked_resource->height())},
+						{0, 0, static_cast<s32>(transfer_width), static_cast<s32>(transfer_height)},
+						1, true, filter);
 
-				target->change_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+					target->change_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+				}
 			}
 
 			const auto internal_bpp = vk::get_format_texel_width(vram_texture->format());
@@ -441,6 +467,15 @@ namespace vk
 		// Blocks some operations when exiting
 		atomic_t<bool> m_cache_is_exiting = false;
 
+		// Upload dedup: content hash -> section whose image already holds those texels
+		struct uploaded_content_t
+		{
+			cached_texture_section* section;
+			vk::image* image;
+		};
+		std::unordered_map<u64, uploaded_content_t> m_uploaded_contents;
+		const u32 min_dedup_upload_size = 0x10000;
+
 		void clear();
 
 		VkComponentMapping apply_component_mapping_flags(u32 gcm_format, rsx::component_order flags, const rsx::texture_channel_remap_t& remap_vector) const;
@@ -449,6 +484,8 @@ namespace vk
 
 		vk::image* get_template_from_collection_impl(const std::vector<copy_region_descriptor>& sections_to_transfer) const;
 
+		bool copy_uploaded_contents(vk::command_buffer& cmd, vk::image* dst, u64 content_hash);
+
 		std::unique_ptr<vk::viewable_image> find_cached_image(VkFormat format, u16 w, u16 h, u16 d, u16 mipmaps, VkImageType type, VkImageCreateFlags create_flags, VkImageUsageFlags usage, VkSharingMode sharing);
 
 	protected:
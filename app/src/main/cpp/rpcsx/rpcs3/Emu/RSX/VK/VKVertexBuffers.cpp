@@ -217,6 +217,60 @@ namespace
 	};
 } // namespace
 
+bool VKGSRender::upload_persistent_streams(u32 vertex_base, u32 vertex_count, u32& window_base, u32& window_length)
+{
+	std::array<u32, 16> offsets;
+	usz window_start = umax, window_end = 0;
+	bool all_cached = true;
+
+	for (u32 i = 0; i < m_vertex_layout.interleaved_blocks.size(); ++i)
+	{
+		const auto block = m_vertex_layout.interleaved_blocks[i];
+		const auto range = block->calculate_required_range(vertex_base, vertex_count);
+		const u32 data_size = range.second * block->attribute_stride;
+		const u32 storage_address = block->real_offset_address + range.first * block->attribute_stride;
+
+		if (auto cached = m_vertex_cache->find_vertex_range(storage_address, data_size))
+		{
+			offsets[i] = cached->offset_in_heap;
+		}
+		else
+		{
+			all_cached = false;
+			offsets[i] = static_cast<u32>(m_attrib_ring_info.alloc<256>(data_size));
+
+			void* mapping = m_attrib_ring_info.map(offsets[i], data_size);
+			g_fxo->get<rsx::dma_manager>().copy(mapping, vm::_ptr<char>(storage_address), data_size);
+			m_attrib_ring_info.unmap();
+
+			m_vertex_cache->store_range(storage_address, data_size, offsets[i]);
+		}
+
+		window_start = std::min<usz>(window_start, offsets[i]);
+		window_end = std::max<usz>(window_end, offsets[i] + data_size);
+	}
+
+	// A grown heap invalidates the cached offsets, a wrapped ring spreads the streams across the whole heap
+	if (vk::test_status_interrupt(vk::heap_changed) || (window_end - window_start) > m_texbuffer_view_size)
+	{
+		return false;
+	}
+
+	for (u32 i = 0; i < m_vertex_layout.interleaved_blocks.size(); ++i)
+	{
+		m_vertex_layout.interleaved_blocks[i]->window_offset = static_cast<u32>(offsets[i] - window_start);
+	}
+
+	if (!all_cached)
+	{
+		m_frame_stats.vertex_cache_miss_count++;
+	}
+
+	window_base = static_cast<u32>(window_start);
+	window_length = static_cast<u32>(window_end - window_start);
+	return true;
+}
+
 vk::vertex_upload_info VKGSRender::upload_vertex_data()
 {
 	draw_command_visitor visitor(m_index_buffer_ring_info, m_vertex_layout);
@@ -235,8 +289,14 @@ vk::vertex_upload_info VKGSRender::upload_vertex_data()
 	// Do actual vertex upload
 	auto required = calculate_memory_requirements(m_vertex_layout, vertex_base, vertex_count);
 	u32 persistent_range_base = -1, volatile_range_base = -1;
+	u32 persistent_range_length = required.first;
 	usz persistent_offset = -1, volatile_offset = -1;
 
+	for (auto block : m_vertex_layout.interleaved_blocks)
+	{
+		block->window_offset = umax;
+	}
+
 	if (required.first > 0)
 	{
 		// Check if cacheable
@@ -266,6 +326,13 @@ vk::vertex_upload_info VKGSRender::upload_vertex_data()
 				to_store = true;
 			}
 		}
+		else if (m_vertex_layout.interleaved_blocks.size() > 1 &&
+			rsx::method_registers.current_draw_clause.command != rsx::draw_command::inlined_array)
+		{
+			// Streams in separate arrays (e.g positions and UVs) are cached one by one, so that passes reusing
+			// some of them only copy the rest. The window just has to cover all of them.
+			in_cache = upload_persistent_streams(vertex_base, vertex_count, persistent_range_base, persistent_range_length);
+		}
 
 		if (!in_cache)
 		{
@@ -332,14 +399,16 @@ vk::vertex_upload_info VKGSRender::upload_vertex_data()
 			m_current_frame->buffer_views_to_clean.push_back(std::move(m_volatile_attribute_storage));
 		}
 
+		// Cached ranges point into the discarded heap
+		m_vertex_cache->purge();
 		vk::clear_status_interrupt(vk::heap_changed);
 	}
 
 	if (persistent_range_base != umax)
 	{
-		if (!m_persistent_attribute_storage || !m_persistent_attribute_storage->in_range(persistent_range_base, required.first, persistent_range_base))
+		if (!m_persistent_attribute_storage || !m_persistent_attribute_storage->in_range(persistent_range_base, persistent_range_length, persistent_range_base))
 		{
-			ensure(m_texbuffer_view_size >= required.first); // "Incompatible driver (MacOS?)"
+			ensure(m_texbuffer_view_size >= persistent_range_length); // "Incompatible driver (MacOS?)"
 
 			if (m_persistent_attribute_storage)
 				m_current_frame->buffer_views_to_clean.push_back(std::move(m_persistent_attribute_storage));
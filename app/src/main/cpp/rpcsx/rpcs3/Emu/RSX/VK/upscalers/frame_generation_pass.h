@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../vkutils/commands.h"
+#include "../vkutils/image.h"
+#include "../vkutils/sync.h"
+
+#include "upscaling.h"
+
+namespace vk
+{
+	// Requested by the frontend for the running title, on top of the global setting
+	extern atomic_t<bool> g_frame_generation_requested;
+
+	// Frame interpolation for titles that flip at half the display rate or slower.
+	// Every flip is kept, and the image halfway to the previous flip is synthesized from block-matched motion
+	// so that it can be presented between the two. Runs on the transfer+compute queue when there is one.
+	class frame_generation_pass
+	{
+		static constexpr u32 async_slot_count = 4;
+
+		struct async_slot
+		{
+			vk::command_buffer cmd;
+			std::unique_ptr<vk::fence> fence;
+			std::unique_ptr<vk::semaphore> inputs_ready;
+			std::unique_ptr<vk::semaphore> outputs_ready;
+			bool pending = false;
+		};
+
+		std::unique_ptr<vk::viewable_image> m_frames[2];
+		std::unique_ptr<vk::viewable_image> m_luma[2];
+		std::unique_ptr<vk::viewable_image> m_motion[2];
+		std::unique_ptr<vk::viewable_image> m_output;
+		u32 m_index = 0;
+		u32 m_history_queue_family = VK_QUEUE_FAMILY_IGNORED;
+		bool m_history_valid = false;
+
+		size2u m_size{};
+		VkFormat m_frame_format = VK_FORMAT_UNDEFINED;
+
+		// Generated frames skip the temporal upscaler, its history must only ever see real flips
+		std::unique_ptr<vk::upscaler> m_upscaler;
+
+		vk::command_pool m_async_command_pool;
+		std::array<async_slot, async_slot_count> m_async_slots;
+		u32 m_async_slot_index = 0;
+		async_slot* m_async_recording = nullptr;
+		bool m_async_results_pending = false;
+
+		// Flip rate tracking
+		u64 m_last_flip_us = 0;
+		u64 m_flip_interval_us = 0;
+		f64 m_display_rate = 0.;
+
+		// GPU load over the current measurement window, from the totals of the GPU frame timer
+		u64 m_window_start_us = 0;
+		u64 m_window_gpu_time_us = 0;
+		u64 m_window_gpu_frames = 0;
+		u64 m_suspended_until_us = 0;
+		bool m_suspended = false;
+
+		void dispose_images();
+		bool prepare(const size2u& size, VkFormat format);
+		bool has_gpu_headroom(u64 now_us, u64 gpu_time_us, u64 gpu_frames);
+		void run_passes(const vk::command_buffer& cmd);
+
+	public:
+		frame_generation_pass() = default;
+		~frame_generation_pass();
+
+		// Called on every flip. Returns true if a frame should be generated ahead of this one.
+		bool schedule(u64 now_us, f64 display_rate, u64 gpu_time_us, u64 gpu_frames);
+
+		// Stores the flip in the history and records the generation of the frame before it.
+		// Returns false if there is nothing to present yet, e.g. right after a resize or a pause.
+		bool queue(const vk::command_buffer& cmd, vk::viewable_image* src, const size2u& size);
+
+		// Set when queue() recorded the pass for the compute queue. The submission of its command buffer must signal it.
+		VkSemaphore get_inputs_semaphore() const;
+
+		// Submits the work prepared by queue(). The returned semaphore must be waited on by the next primary submission.
+		VkSemaphore submit_async();
+
+		// The generated frame, ready to be read by 'cmd'
+		vk::viewable_image* acquire_output(const vk::command_buffer& cmd);
+
+		// Scaler for generated frames; the presenter's own one unless that keeps history
+		vk::upscaler* get_upscaler(vk::upscaler* presenter_upscaler, bool presenter_is_temporal);
+
+		// How long to hold the real flip back so that both frames land evenly when a flip spans several refreshes
+		u64 get_present_delay_us(u64 generated_present_us, u64 now_us) const;
+	};
+} // namespace vk
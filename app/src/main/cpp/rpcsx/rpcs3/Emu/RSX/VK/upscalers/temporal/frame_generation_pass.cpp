@@ -0,0 +1,506 @@
+#include "../../vkutils/barriers.h"
+#include "../../VKHelpers.h"
+#include "../../VKResourceManager.h"
+
+#include "../fsr_pass.h"
+#include "../frame_generation_pass.h"
+#include "../temporal_pass.h"
+
+#include "Emu/system_config.h"
+
+namespace vk
+{
+	atomic_t<bool> g_frame_generation_requested = false;
+
+	namespace temporal
+	{
+		interpolation_pass::interpolation_pass()
+		{
+			use_push_constants = true;
+			push_constants_size = 16;
+
+			build(
+#include "Emu/RSX/Program/Upscalers/Temporal/FrameInterpolation.glsl"
+			);
+		}
+
+		std::vector<std::pair<VkDescriptorType, u8>> interpolation_pass::get_descriptor_layout()
+		{
+			return {
+				{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3},
+				{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1}};
+		}
+
+		void interpolation_pass::declare_inputs()
+		{
+			const char* names[] = {"PreviousColor", "CurrentColor", "Motion", "Output"};
+			std::vector<vk::glsl::program_input> inputs;
+
+			for (u32 n = 0; n < std::size(names); ++n)
+			{
+				inputs.push_back({::glsl::program_domain::glsl_compute_program,
+					vk::glsl::program_input_type::input_type_texture,
+					{}, {},
+					n,
+					names[n]});
+			}
+
+			m_program->load_uniforms(inputs);
+		}
+
+		void interpolation_pass::bind_resources()
+		{
+			create_samplers();
+
+			m_program->bind_uniform({m_linear_sampler->value, m_previous->value, m_previous->image()->current_layout}, "PreviousColor", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({m_linear_sampler->value, m_current->value, m_current->image()->current_layout}, "CurrentColor", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({m_linear_sampler->value, m_motion->value, m_motion->image()->current_layout}, "Motion", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({VK_NULL_HANDLE, m_output->value, m_output->image()->current_layout}, "Output", VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_descriptor_set);
+		}
+
+		void interpolation_pass::run(const vk::command_buffer& cmd, vk::viewable_image* previous, vk::viewable_image* current,
+			vk::viewable_image* motion, vk::viewable_image* output, const size2u& size)
+		{
+			const auto remap = rsx::default_remap_vector.with_encoding(VK_REMAP_IDENTITY);
+			m_previous = previous->get_view(remap);
+			m_current = current->get_view(remap);
+			m_motion = motion->get_view(remap);
+			m_output = output->get_view(remap);
+
+			const s32 constants[4] =
+				{
+					s32(size.width), s32(size.height),
+					s32(rx::aligned_div(size.width, tile_size)), s32(rx::aligned_div(size.height, tile_size))};
+
+			VK_GET_SYMBOL(vkCmdPushConstants)(cmd, m_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, push_constants_size, constants);
+			compute_task::run(cmd, rx::aligned_div(size.width, m_wg_x), rx::aligned_div(size.height, m_wg_y), 1);
+		}
+	} // namespace temporal
+
+	namespace
+	{
+		// Flips further apart than this are stalls (loading, shader compilation), not a frame rate
+		constexpr u64 max_flip_interval_us = 100'000;
+
+		// A flip must span this many refreshes to leave one free for the generated frame
+		constexpr f64 min_refreshes_per_flip = 1.8;
+
+		// GPU load is judged over windows of this length. Generation pauses above the upper bound and,
+		// measured without it, resumes below the lower one once the pause is over.
+		constexpr u64 gpu_load_window_us = 500'000;
+		constexpr f64 max_gpu_load = 0.85;
+		constexpr f64 resume_gpu_load = 0.6;
+		constexpr u64 suspend_duration_us = 5'000'000;
+
+		bool can_run_async()
+		{
+			// Without a second queue the pass would only be serialized behind the frame again
+			const auto pdev = vk::get_current_renderer();
+			return pdev->get_transfer_queue() != pdev->get_graphics_queue();
+		}
+	} // namespace
+
+	frame_generation_pass::~frame_generation_pass()
+	{
+		for (auto& slot : m_async_slots)
+		{
+			if (!slot.fence)
+			{
+				continue;
+			}
+
+			if (slot.pending)
+			{
+				vk::wait_for_fence(slot.fence.get());
+			}
+
+			slot.cmd.destroy();
+		}
+
+		m_async_command_pool.destroy();
+		dispose_images();
+	}
+
+	void frame_generation_pass::dispose_images()
+	{
+		auto safe_delete = [](auto& data)
+		{
+			if (data && data->value)
+			{
+				vk::get_resource_manager()->dispose(data);
+			}
+			else if (data)
+			{
+				data.reset();
+			}
+		};
+
+		safe_delete(m_output);
+		for (u32 i = 0; i < 2; ++i)
+		{
+			safe_delete(m_frames[i]);
+			safe_delete(m_luma[i]);
+			safe_delete(m_motion[i]);
+		}
+
+		m_history_valid = false;
+		m_size = {};
+		m_frame_format = VK_FORMAT_UNDEFINED;
+	}
+
+	bool frame_generation_pass::prepare(const size2u& size, VkFormat format)
+	{
+		if (m_output && m_size == size && m_frame_format == format)
+		{
+			return true;
+		}
+
+		dispose_images();
+
+		const auto pdev = vk::get_current_renderer();
+
+		// The copies of the flips keep the format of the presented image and are sampled between texels
+		const VkFlags frame_format_bits = VK_FORMAT_FEATURE_TRANSFER_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+		if ((pdev->get_format_properties(format).optimalTilingFeatures & frame_format_bits) != frame_format_bits)
+		{
+			return false;
+		}
+
+		auto initialize_image_impl = [pdev](u32 w, u32 h, VkImageUsageFlags usage, VkFormat image_format)
+		{
+			return std::make_unique<vk::viewable_image>(
+				*pdev,                                   // Owner
+				pdev->get_memory_mapping().device_local, // Must be in device optimal memory
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				VK_IMAGE_TYPE_2D,
+				image_format,
+				w, h, 1, 1, 1, VK_SAMPLE_COUNT_1_BIT, // Dimensions (w, h, d, mips, layers, samples)
+				VK_IMAGE_LAYOUT_UNDEFINED,
+				VK_IMAGE_TILING_OPTIMAL,
+				usage,
+				VK_IMAGE_CREATE_ALLOW_NULL_RPCS3, // Allow creation to fail if there is no memory
+				VMM_ALLOCATION_POOL_SWAPCHAIN,
+				RSX_FORMAT_CLASS_COLOR);
+		};
+
+		const VkFlags usage_mask_frame = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		const VkFlags usage_mask_output = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		const VkFlags usage_mask_intermediate = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+		const VkFormat luma_format = vk::temporal::get_luma_format().first;
+		const u32 tiles_x = rx::aligned_div(size.width, vk::temporal::temporal_pass::tile_size);
+		const u32 tiles_y = rx::aligned_div(size.height, vk::temporal::temporal_pass::tile_size);
+
+		bool failed = false;
+		auto create = [&](std::unique_ptr<vk::viewable_image>& dst, u32 w, u32 h, VkImageUsageFlags usage, VkFormat image_format)
+		{
+			if (!failed)
+			{
+				dst = initialize_image_impl(w, h, usage, image_format);
+				failed |= (dst->value == VK_NULL_HANDLE);
+			}
+		};
+
+		// The output format has mandatory storage and blit source support
+		create(m_output, size.width, size.height, usage_mask_output, VK_FORMAT_R16G16B16A16_SFLOAT);
+		for (u32 i = 0; i < 2; ++i)
+		{
+			create(m_frames[i], size.width, size.height, usage_mask_frame, format);
+			create(m_luma[i], size.width, size.height, usage_mask_intermediate, luma_format);
+			create(m_motion[i], tiles_x, tiles_y, usage_mask_intermediate, VK_FORMAT_R16G16B16A16_SFLOAT);
+		}
+
+		if (failed)
+		{
+			dispose_images();
+			rsx_log.warning("Frame generation is enabled, but the system is out of memory. Frames will not be generated.");
+			return false;
+		}
+
+		m_size = size;
+		m_frame_format = format;
+		return true;
+	}
+
+	bool frame_generation_pass::has_gpu_headroom(u64 now_us, u64 gpu_time_us, u64 gpu_frames)
+	{
+		if (!m_window_start_us || gpu_time_us < m_window_gpu_time_us)
+		{
+			m_window_start_us = now_us;
+			m_window_gpu_time_us = gpu_time_us;
+			m_window_gpu_frames = gpu_frames;
+			return !m_suspended;
+		}
+
+		const u64 elapsed = now_us - m_window_start_us;
+		if (elapsed < gpu_load_window_us)
+		{
+			return !m_suspended;
+		}
+
+		// Nothing to judge by without GPU timing (no timestamp queries, or nobody reading them)
+		if (gpu_frames != m_window_gpu_frames)
+		{
+			const f64 load = f64(gpu_time_us - m_window_gpu_time_us) / f64(elapsed);
+
+			if (!m_suspended && load > max_gpu_load)
+			{
+				rsx_log.notice("Frame generation paused, the GPU is busy %u%% of the time", static_cast<u32>(load * 100.));
+				m_suspended = true;
+				m_suspended_until_us = now_us + suspend_duration_us;
+			}
+			else if (m_suspended && now_us >= m_suspended_until_us)
+			{
+				if (load < resume_gpu_load)
+				{
+					rsx_log.notice("Frame generation resumed");
+					m_suspended = false;
+				}
+				else
+				{
+					m_suspended_until_us = now_us + suspend_duration_us;
+				}
+			}
+		}
+
+		m_window_start_us = now_us;
+		m_window_gpu_time_us = gpu_time_us;
+		m_window_gpu_frames = gpu_frames;
+		return !m_suspended;
+	}
+
+	bool frame_generation_pass::schedule(u64 now_us, f64 display_rate, u64 gpu_time_us, u64 gpu_frames)
+	{
+		const u64 interval = m_last_flip_us ? now_us - m_last_flip_us : 0;
+		m_last_flip_us = now_us;
+		m_display_rate = display_rate;
+
+		// Smoothed flip interval. A stall restarts the estimate instead of skewing it for seconds.
+		if (!interval || interval > max_flip_interval_us)
+		{
+			m_flip_interval_us = 0;
+		}
+		else if (!m_flip_interval_us)
+		{
+			m_flip_interval_us = interval;
+		}
+		else
+		{
+			m_flip_interval_us = (m_flip_interval_us * 7 + interval) / 8;
+		}
+
+		bool generate = false;
+		if (m_flip_interval_us && display_rate > 0.)
+		{
+			// Judder in the flip rate would place generated frames away from the middle
+			const bool stable = interval * 3 >= m_flip_interval_us * 2 && interval * 3 <= m_flip_interval_us * 4;
+			generate = stable && (f64(m_flip_interval_us) * display_rate / 1'000'000.) >= min_refreshes_per_flip;
+		}
+
+		// Always evaluated so that the load window keeps moving
+		if (!has_gpu_headroom(now_us, gpu_time_us, gpu_frames))
+		{
+			generate = false;
+		}
+
+		if (!generate)
+		{
+			// The next generated frame needs two consecutive flips again
+			m_history_valid = false;
+		}
+
+		return generate;
+	}
+
+	void frame_generation_pass::run_passes(const vk::command_buffer& cmd)
+	{
+		const VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+		const u32 previous = m_index;
+		const u32 current = previous ^ 1;
+
+		if (!m_history_valid)
+		{
+			for (u32 i = 0; i < 2; ++i)
+			{
+				vk::temporal::discard_image(cmd, m_luma[i].get());
+				vk::temporal::discard_image(cmd, m_motion[i].get());
+			}
+		}
+		else
+		{
+			// R/W CS-CS barrier against the previous flip
+			vk::insert_global_memory_barrier(cmd,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+		}
+
+		// Without history this only publishes the luma of the flip for the next one
+		const rsx::flags32_t flags = m_history_valid ? vk::temporal::TEMPORAL_HISTORY_VALID : 0;
+		vk::get_compute_task<vk::temporal::motion_estimation_pass>()->run(cmd, m_frames[current].get(), nullptr,
+			m_luma[previous].get(), m_motion[previous].get(), m_luma[current].get(), m_motion[current].get(), m_size, flags);
+
+		if (m_history_valid)
+		{
+			vk::insert_image_memory_barrier(cmd, m_motion[current]->value, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, range);
+
+			vk::temporal::discard_image(cmd, m_output.get());
+			vk::get_compute_task<vk::temporal::interpolation_pass>()->run(cmd,
+				m_frames[previous].get(), m_frames[current].get(), m_motion[current].get(), m_output.get(), m_size);
+		}
+
+		m_index = current;
+		m_history_valid = true;
+	}
+
+	bool frame_generation_pass::queue(const vk::command_buffer& cmd, vk::viewable_image* src, const size2u& size)
+	{
+		ensure(!m_async_recording);
+
+		// The last generated frame was never presented. Its contents are discarded below, so is the queue ownership.
+		m_async_results_pending = false;
+
+		if (!prepare(size, src->format()))
+		{
+			return false;
+		}
+
+		const bool use_async = can_run_async();
+		const auto pdev = vk::get_current_renderer();
+		const u32 graphics_family = cmd.get_queue_family();
+		const u32 pass_family = use_async ? pdev->get_transfer_queue_family() : graphics_family;
+
+		// History lives on whichever queue ran the pass
+		if (m_history_queue_family != pass_family)
+		{
+			m_history_queue_family = pass_family;
+			m_history_valid = false;
+		}
+
+		const bool generate = m_history_valid;
+
+		// Keep a copy of the flip, the guest is free to render into the source again right away
+		auto frame = m_frames[m_index ^ 1].get();
+		const areai region = {0, 0, s32(size.width), s32(size.height)};
+
+		vk::temporal::discard_image(cmd, frame);
+		vk::copy_image(cmd, src, frame, region, region, 1);
+		frame->change_layout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		if (!use_async)
+		{
+			run_passes(cmd);
+			return generate;
+		}
+
+		if (!m_async_command_pool)
+		{
+			m_async_command_pool.create(*const_cast<render_device*>(pdev), pass_family);
+		}
+
+		auto& slot = m_async_slots[m_async_slot_index];
+		m_async_slot_index = (m_async_slot_index + 1) % async_slot_count;
+
+		if (!slot.fence)
+		{
+			slot.cmd.create(m_async_command_pool);
+			slot.fence = std::make_unique<vk::fence>(*pdev);
+			slot.inputs_ready = std::make_unique<vk::semaphore>(*pdev);
+			slot.outputs_ready = std::make_unique<vk::semaphore>(*pdev);
+		}
+		else if (slot.pending)
+		{
+			vk::wait_for_fence(slot.fence.get());
+			slot.fence->reset();
+			slot.pending = false;
+		}
+
+		// The copy stays on the compute queue, it is the previous frame of the next flip
+		frame->queue_release(cmd, pass_family, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		slot.cmd.begin();
+		vk::temporal::acquire_image(slot.cmd, frame, graphics_family);
+
+		run_passes(slot.cmd);
+
+		if (generate)
+		{
+			m_output->queue_release(slot.cmd, graphics_family, VK_IMAGE_LAYOUT_GENERAL);
+		}
+
+		slot.cmd.end();
+
+		m_async_recording = &slot;
+		return generate;
+	}
+
+	VkSemaphore frame_generation_pass::get_inputs_semaphore() const
+	{
+		return m_async_recording ? m_async_recording->inputs_ready->handle : VK_NULL_HANDLE;
+	}
+
+	VkSemaphore frame_generation_pass::submit_async()
+	{
+		ensure(m_async_recording);
+		auto& slot = *m_async_recording;
+
+		vk::queue_submit_t submit_info{vk::get_current_renderer()->get_transfer_queue(), slot.fence.get()};
+		submit_info.wait_on(*slot.inputs_ready, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+		submit_info.queue_signal(*slot.outputs_ready);
+		slot.cmd.submit(submit_info, VK_FALSE);
+
+		slot.pending = true;
+		m_async_recording = nullptr;
+		m_async_results_pending = true;
+		return *slot.outputs_ready;
+	}
+
+	vk::viewable_image* frame_generation_pass::acquire_output(const vk::command_buffer& cmd)
+	{
+		if (m_async_results_pending)
+		{
+			vk::temporal::acquire_image(cmd, m_output.get(), m_async_command_pool.get_queue_family());
+			m_async_results_pending = false;
+		}
+
+		// Explicit CS-Transfer/FS barrier, the output is either blitted or sampled by the output passes
+		vk::insert_image_memory_barrier(cmd, m_output->value, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+			{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
+
+		return m_output.get();
+	}
+
+	vk::upscaler* frame_generation_pass::get_upscaler(vk::upscaler* presenter_upscaler, bool presenter_is_temporal)
+	{
+		if (!presenter_is_temporal)
+		{
+			m_upscaler.reset();
+			return presenter_upscaler;
+		}
+
+		// Closest stateless match for the temporal output
+		if (!m_upscaler)
+		{
+			m_upscaler = std::make_unique<vk::fsr_upscale_pass>();
+		}
+
+		return m_upscaler.get();
+	}
+
+	u64 frame_generation_pass::get_present_delay_us(u64 generated_present_us, u64 now_us) const
+	{
+		// At two refreshes per flip the FIFO already shows the frames one refresh apart
+		if (!m_flip_interval_us || f64(m_flip_interval_us) * m_display_rate / 1'000'000. < 3.)
+		{
+			return 0;
+		}
+
+		// Aim half a refresh early so that the real flip makes the refresh in the middle of the interval
+		const u64 refresh_us = static_cast<u64>(1'000'000. / m_display_rate);
+		const u64 target = generated_present_us + m_flip_interval_us / 2 - refresh_us / 2;
+		return target > now_us ? std::min(target - now_us, m_flip_interval_us / 2) : 0;
+	}
+} // namespace vk
@@ -0,0 +1,688 @@
+#include "../../vkutils/barriers.h"
+#include "../../VKHelpers.h"
+#include "../../VKResourceManager.h"
+
+#include "../fsr_pass.h"
+#include "../temporal_pass.h"
+
+#include "Emu/system_config.h"
+
+namespace vk
+{
+	namespace temporal
+	{
+		// Weight of the new frame in the accumulated history
+		constexpr f32 history_blend_factor = 0.1f;
+
+		// The previous luma is sampled at sub-pixel offsets, so it needs both storage and linear filtering.
+		// Neither of the single channel float formats is guaranteed to have both.
+		std::pair<VkFormat, const char*> get_luma_format()
+		{
+			const auto pdev = vk::get_current_renderer();
+			const VkFlags all_required_bits = VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+			for (const auto& [format, qualifier] : {std::pair{VK_FORMAT_R16_SFLOAT, "r16f"}, std::pair{VK_FORMAT_R32_SFLOAT, "r32f"}})
+			{
+				if ((pdev->get_format_properties(format).optimalTilingFeatures & all_required_bits) == all_required_bits)
+				{
+					return {format, qualifier};
+				}
+			}
+
+			return {VK_FORMAT_R16G16B16A16_SFLOAT, "rgba16f"};
+		}
+
+		void temporal_pass::build(const char* kernel)
+		{
+			// Initialize to allow detecting optimal settings
+			create();
+
+			switch (optimal_group_size)
+			{
+			default:
+			case 64:
+				m_wg_x = 8;
+				m_wg_y = 8;
+				break;
+			case 32:
+				m_wg_x = 8;
+				m_wg_y = 4;
+				break;
+			}
+
+			const std::pair<std::string_view, std::string> syntax_replace[] =
+				{
+					{"%WORKGROUP_SIZE_X", std::to_string(m_wg_x)},
+					{"%WORKGROUP_SIZE_Y", std::to_string(m_wg_y)},
+					{"%TILE_SIZE", std::to_string(tile_size)},
+					{"%LUMA_FORMAT", get_luma_format().second}};
+
+			m_src = kernel;
+			m_src = fmt::replace_all(m_src, syntax_replace);
+		}
+
+		void temporal_pass::create_samplers()
+		{
+			if (m_linear_sampler)
+			{
+				return;
+			}
+
+			const auto pdev = vk::get_current_renderer();
+			m_linear_sampler = std::make_unique<vk::sampler>(*pdev,
+				VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+				VK_FALSE, 0.f, 1.f, 0.f, 0.f, VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK);
+			m_nearest_sampler = std::make_unique<vk::sampler>(*pdev,
+				VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+				VK_FALSE, 0.f, 1.f, 0.f, 0.f, VK_FILTER_NEAREST, VK_FILTER_NEAREST, VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK);
+		}
+
+		motion_estimation_pass::motion_estimation_pass()
+		{
+			use_push_constants = true;
+			push_constants_size = 32;
+
+			build(
+#include "Emu/RSX/Program/Upscalers/Temporal/MotionEstimation.glsl"
+			);
+		}
+
+		std::vector<std::pair<VkDescriptorType, u8>> motion_estimation_pass::get_descriptor_layout()
+		{
+			return {
+				{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+				{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2}};
+		}
+
+		void motion_estimation_pass::declare_inputs()
+		{
+			const char* names[] = {"CurrentColor", "PreviousLuma", "CurrentDepth", "PreviousMotion", "CurrentLuma", "MotionOut"};
+			std::vector<vk::glsl::program_input> inputs;
+
+			for (u32 n = 0; n < std::size(names); ++n)
+			{
+				inputs.push_back({::glsl::program_domain::glsl_compute_program,
+					vk::glsl::program_input_type::input_type_texture,
+					{}, {},
+					n,
+					names[n]});
+			}
+
+			m_program->load_uniforms(inputs);
+		}
+
+		void motion_estimation_pass::bind_resources()
+		{
+			create_samplers();
+
+			m_program->bind_uniform({m_nearest_sampler->value, m_color->value, m_color->image()->current_layout}, "CurrentColor", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({m_linear_sampler->value, m_previous_luma->value, m_previous_luma->image()->current_layout}, "PreviousLuma", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({m_nearest_sampler->value, m_depth->value, m_depth->image()->current_layout}, "CurrentDepth", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({m_nearest_sampler->value, m_previous_motion->value, m_previous_motion->image()->current_layout}, "PreviousMotion", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({VK_NULL_HANDLE, m_luma_out->value, m_luma_out->image()->current_layout}, "CurrentLuma", VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_descriptor_set);
+			m_program->bind_uniform({VK_NULL_HANDLE, m_motion_out->value, m_motion_out->image()->current_layout}, "MotionOut", VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_descriptor_set);
+		}
+
+		void motion_estimation_pass::run(const vk::command_buffer& cmd, vk::viewable_image* color, vk::viewable_image* depth,
+			vk::viewable_image* previous_luma, vk::viewable_image* previous_motion,
+			vk::viewable_image* luma_out, vk::viewable_image* motion_out,
+			const size2u& input_size, rsx::flags32_t flags)
+		{
+			const auto remap = rsx::default_remap_vector.with_encoding(VK_REMAP_IDENTITY);
+			m_color = color->get_view(remap);
+			m_depth = (depth ? depth : color)->get_view(remap);
+			m_previous_luma = previous_luma->get_view(remap);
+			m_previous_motion = previous_motion->get_view(remap);
+			m_luma_out = luma_out->get_view(remap);
+			m_motion_out = motion_out->get_view(remap);
+
+			const u32 tiles_x = rx::aligned_div(input_size.width, tile_size);
+			const u32 tiles_y = rx::aligned_div(input_size.height, tile_size);
+
+			const s32 constants[8] =
+				{
+					s32(input_size.width), s32(input_size.height),
+					depth ? s32(depth->width()) : 1, depth ? s32(depth->height()) : 1,
+					s32(tiles_x), s32(tiles_y),
+					s32(flags), 0};
+
+			VK_GET_SYMBOL(vkCmdPushConstants)(cmd, m_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, push_constants_size, constants);
+			compute_task::run(cmd, rx::aligned_div(tiles_x, m_wg_x), rx::aligned_div(tiles_y, m_wg_y), 1);
+		}
+
+		resolve_pass::resolve_pass()
+		{
+			use_push_constants = true;
+			push_constants_size = 40;
+
+			build(
+#include "Emu/RSX/Program/Upscalers/Temporal/TemporalResolve.glsl"
+			);
+		}
+
+		std::vector<std::pair<VkDescriptorType, u8>> resolve_pass::get_descriptor_layout()
+		{
+			return {
+				{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+				{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1}};
+		}
+
+		void resolve_pass::declare_inputs()
+		{
+			const char* names[] = {"CurrentColor", "History", "Motion", "PreviousMotion", "HistoryOut"};
+			std::vector<vk::glsl::program_input> inputs;
+
+			for (u32 n = 0; n < std::size(names); ++n)
+			{
+				inputs.push_back({::glsl::program_domain::glsl_compute_program,
+					vk::glsl::program_input_type::input_type_texture,
+					{}, {},
+					n,
+					names[n]});
+			}
+
+			m_program->load_uniforms(inputs);
+		}
+
+		void resolve_pass::bind_resources()
+		{
+			create_samplers();
+
+			m_program->bind_uniform({m_linear_sampler->value, m_color->value, m_color->image()->current_layout}, "CurrentColor", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({m_linear_sampler->value, m_history->value, m_history->image()->current_layout}, "History", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({m_nearest_sampler->value, m_motion->value, m_motion->image()->current_layout}, "Motion", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({m_nearest_sampler->value, m_previous_motion->value, m_previous_motion->image()->current_layout}, "PreviousMotion", VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_descriptor_set);
+			m_program->bind_uniform({VK_NULL_HANDLE, m_history_out->value, m_history_out->image()->current_layout}, "HistoryOut", VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_descriptor_set);
+		}
+
+		void resolve_pass::run(const vk::command_buffer& cmd, vk::viewable_image* color,
+			vk::viewable_image* history, vk::viewable_image* motion, vk::viewable_image* previous_motion,
+			vk::viewable_image* history_out, const size2u& input_size, const size2u& output_size, rsx::flags32_t flags)
+		{
+			const auto remap = rsx::default_remap_vector.with_encoding(VK_REMAP_IDENTITY);
+			m_color = color->get_view(remap);
+			m_history = history->get_view(remap);
+			m_motion = motion->get_view(remap);
+			m_previous_motion = previous_motion->get_view(remap);
+			m_history_out = history_out->get_view(remap);
+
+			struct
+			{
+				f32 input_size[2];
+				f32 input_texel[2];
+				f32 output_size[2];
+				s32 tile_count[2];
+				f32 blend_factor;
+				u32 flags;
+			} constants =
+				{
+					{f32(input_size.width), f32(input_size.height)},
+					{1.f / color->width(), 1.f / color->height()},
+					{f32(output_size.width), f32(output_size.height)},
+					{s32(rx::aligned_div(input_size.width, tile_size)), s32(rx::aligned_div(input_size.height, tile_size))},
+					history_blend_factor,
+					flags};
+
+			static_assert(sizeof(constants) == 40);
+
+			VK_GET_SYMBOL(vkCmdPushConstants)(cmd, m_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, push_constants_size, &constants);
+			compute_task::run(cmd, rx::aligned_div(output_size.width, m_wg_x), rx::aligned_div(output_size.height, m_wg_y), 1);
+		}
+
+		void acquire_image(const vk::command_buffer& cmd, vk::image* img, u32 src_queue_family)
+		{
+			if (img->info.sharingMode != VK_SHARING_MODE_EXCLUSIVE || src_queue_family == cmd.get_queue_family())
+			{
+				return;
+			}
+
+			const VkImageSubresourceRange range = {img->aspect(), 0, img->mipmaps(), 0, img->layers()};
+			vk::change_image_layout(cmd, img->value, img->current_layout, img->current_layout, range, src_queue_family, cmd.get_queue_family(), 0u, ~0u);
+		}
+
+		void discard_image(const vk::command_buffer& cmd, vk::image* img)
+		{
+			img->current_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			img->current_queue_family = VK_QUEUE_FAMILY_IGNORED;
+			img->change_layout(cmd, VK_IMAGE_LAYOUT_GENERAL);
+		}
+	} // namespace temporal
+
+	namespace
+	{
+		bool is_upscale_request(const size2u& input_size, const size2u& output_size)
+		{
+			return input_size.width <= output_size.width && input_size.height <= output_size.height &&
+			       (input_size.width < output_size.width || input_size.height < output_size.height);
+		}
+	} // namespace
+
+	temporal_upscale_pass::~temporal_upscale_pass()
+	{
+		for (auto& slot : m_async_slots)
+		{
+			if (!slot.fence)
+			{
+				continue;
+			}
+
+			if (slot.pending)
+			{
+				vk::wait_for_fence(slot.fence.get());
+			}
+
+			slot.cmd.destroy();
+		}
+
+		m_async_command_pool.destroy();
+		dispose_images();
+	}
+
+	void temporal_upscale_pass::dispose_images()
+	{
+		auto safe_delete = [](auto& data)
+		{
+			if (data && data->value)
+			{
+				vk::get_resource_manager()->dispose(data);
+			}
+			else if (data)
+			{
+				data.reset();
+			}
+		};
+
+		safe_delete(m_output);
+		for (u32 i = 0; i < 2; ++i)
+		{
+			safe_delete(m_history[i]);
+			safe_delete(m_luma[i]);
+			safe_delete(m_motion[i]);
+		}
+
+		m_history_valid = false;
+		m_input_size = {};
+		m_output_size = {};
+	}
+
+	bool temporal_upscale_pass::prepare(const size2u& input_size, const size2u& output_size)
+	{
+		if (m_output && m_input_size == input_size && m_output_size == output_size)
+		{
+			return true;
+		}
+
+		dispose_images();
+
+		const auto pdev = vk::get_current_renderer();
+		auto initialize_image_impl = [pdev](u32 w, u32 h, VkImageUsageFlags usage, VkFormat format)
+		{
+			return std::make_unique<vk::viewable_image>(
+				*pdev,                                   // Owner
+				pdev->get_memory_mapping().device_local, // Must be in device optimal memory
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				VK_IMAGE_TYPE_2D,
+				format,
+				w, h, 1, 1, 1, VK_SAMPLE_COUNT_1_BIT, // Dimensions (w, h, d, mips, layers, samples)
+				VK_IMAGE_LAYOUT_UNDEFINED,
+				VK_IMAGE_TILING_OPTIMAL,
+				usage,
+				VK_IMAGE_CREATE_ALLOW_NULL_RPCS3, // Allow creation to fail if there is no memory
+				VMM_ALLOCATION_POOL_SWAPCHAIN,
+				RSX_FORMAT_CLASS_COLOR);
+		};
+
+		const VkFlags usage_mask_output = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		const VkFlags usage_mask_intermediate = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+		// History and motion use formats with mandatory storage support
+		VkFormat output_format = VK_FORMAT_UNDEFINED;
+		for (const auto& format : {VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM})
+		{
+			const VkFlags all_required_bits = VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT;
+			if ((pdev->get_format_properties(format).optimalTilingFeatures & all_required_bits) == all_required_bits)
+			{
+				output_format = format;
+				break;
+			}
+		}
+
+		if (output_format == VK_FORMAT_UNDEFINED)
+		{
+			rsx_log.error("Temporal upscaling is not supported by this driver and hardware combination.");
+			return false;
+		}
+
+		const VkFormat luma_format = vk::temporal::get_luma_format().first;
+		const u32 tiles_x = rx::aligned_div(input_size.width, vk::temporal::temporal_pass::tile_size);
+		const u32 tiles_y = rx::aligned_div(input_size.height, vk::temporal::temporal_pass::tile_size);
+
+		bool failed = false;
+		auto create = [&](std::unique_ptr<vk::viewable_image>& dst, u32 w, u32 h, VkImageUsageFlags usage, VkFormat format)
+		{
+			if (!failed)
+			{
+				dst = initialize_image_impl(w, h, usage, format);
+				failed |= (dst->value == VK_NULL_HANDLE);
+			}
+		};
+
+		create(m_output, output_size.width, output_size.height, usage_mask_output, output_format);
+		for (u32 i = 0; i < 2; ++i)
+		{
+			create(m_history[i], output_size.width, output_size.height, usage_mask_intermediate, VK_FORMAT_R16G16B16A16_SFLOAT);
+			create(m_luma[i], input_size.width, input_size.height, usage_mask_intermediate, luma_format);
+			create(m_motion[i], tiles_x, tiles_y, usage_mask_intermediate, VK_FORMAT_R16G16B16A16_SFLOAT);
+		}
+
+		if (failed)
+		{
+			dispose_images();
+			rsx_log.warning("Temporal upscaling is enabled, but the system is out of memory. Will fall back to bilinear upscaling.");
+			return false;
+		}
+
+		m_input_size = input_size;
+		m_output_size = output_size;
+		return true;
+	}
+
+	void temporal_upscale_pass::set_depth_source(vk::viewable_image* depth)
+	{
+		m_depth_source = depth;
+	}
+
+	vk::viewable_image* temporal_upscale_pass::get_depth_input(const size2u& input_size) const
+	{
+		// Only a depth buffer covering the same pixels as the color input is useful. Post-processed or downscaled frames may have none.
+		if (!m_depth_source || !m_depth_source->value || m_depth_source->samples() != 1)
+		{
+			return nullptr;
+		}
+
+		const u32 w = m_depth_source->width(), h = m_depth_source->height();
+		if (w < input_size.width || h < input_size.height || w > input_size.width + input_size.width / 8 || h > input_size.height + input_size.height / 8)
+		{
+			return nullptr;
+		}
+
+		return m_depth_source;
+	}
+
+	void temporal_upscale_pass::run_passes(const vk::command_buffer& cmd, vk::viewable_image* src, vk::viewable_image* depth)
+	{
+		const VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+		// History lives on whichever queue ran the pass. Switching queues is rare, restart accumulation instead of transferring it.
+		if (m_history_queue_family != cmd.get_queue_family())
+		{
+			m_history_queue_family = cmd.get_queue_family();
+			m_history_valid = false;
+		}
+
+		if (!m_history_valid)
+		{
+			for (u32 i = 0; i < 2; ++i)
+			{
+				temporal::discard_image(cmd, m_history[i].get());
+				temporal::discard_image(cmd, m_luma[i].get());
+				temporal::discard_image(cmd, m_motion[i].get());
+			}
+		}
+		else
+		{
+			// R/W CS-CS barrier against the previous frame
+			vk::insert_global_memory_barrier(cmd,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+		}
+
+		temporal::discard_image(cmd, m_output.get());
+
+		const u32 previous = m_history_index;
+		const u32 current = previous ^ 1;
+		const rsx::flags32_t flags = (m_history_valid ? vk::temporal::TEMPORAL_HISTORY_VALID : 0) | (depth ? vk::temporal::TEMPORAL_DEPTH_VALID : 0);
+
+		vk::get_compute_task<vk::temporal::motion_estimation_pass>()->run(cmd, src, depth,
+			m_luma[previous].get(), m_motion[previous].get(), m_luma[current].get(), m_motion[current].get(), m_input_size, flags);
+
+		vk::insert_image_memory_barrier(cmd, m_motion[current]->value, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, range);
+
+		vk::get_compute_task<vk::temporal::resolve_pass>()->run(cmd, src,
+			m_history[previous].get(), m_motion[current].get(), m_motion[previous].get(), m_history[current].get(),
+			m_input_size, m_output_size, flags);
+
+		vk::insert_image_memory_barrier(cmd, m_history[current]->value, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, range);
+
+		// Accumulation softens the image, sharpen at output resolution
+		vk::get_compute_task<vk::FidelityFX::rcas_pass>()->run(cmd, m_history[current].get(), m_output.get(), m_output_size, m_output_size);
+
+		m_history_index = current;
+		m_history_valid = true;
+	}
+
+	bool temporal_upscale_pass::can_run_async() const
+	{
+		if (!g_cfg.video.vk.temporal_upscaling_async_compute)
+		{
+			return false;
+		}
+
+		// Without a second queue the pass would only be serialized behind the frame again
+		const auto pdev = vk::get_current_renderer();
+		return pdev->get_transfer_queue() != pdev->get_graphics_queue();
+	}
+
+	VkSemaphore temporal_upscale_pass::queue_async(const vk::command_buffer& cmd, vk::viewable_image* src, const size2u& input_size, const size2u& output_size)
+	{
+		ensure(!m_async_recording && !m_async_results_pending);
+
+		if (!can_run_async() || !is_upscale_request(input_size, output_size) || !prepare(input_size, output_size))
+		{
+			return VK_NULL_HANDLE;
+		}
+
+		const auto pdev = vk::get_current_renderer();
+		if (!m_async_command_pool)
+		{
+			m_async_command_pool.create(*const_cast<render_device*>(pdev), pdev->get_transfer_queue_family());
+		}
+
+		auto& slot = m_async_slots[m_async_slot_index];
+		m_async_slot_index = (m_async_slot_index + 1) % async_slot_count;
+
+		if (!slot.fence)
+		{
+			slot.cmd.create(m_async_command_pool);
+			slot.fence = std::make_unique<vk::fence>(*pdev);
+			slot.inputs_ready = std::make_unique<vk::semaphore>(*pdev);
+			slot.outputs_ready = std::make_unique<vk::semaphore>(*pdev);
+		}
+		else if (slot.pending)
+		{
+			vk::wait_for_fence(slot.fence.get());
+			slot.fence->reset();
+			slot.pending = false;
+		}
+
+		const u32 graphics_family = cmd.get_queue_family();
+		const u32 compute_family = m_async_command_pool.get_queue_family();
+		auto depth = get_depth_input(input_size);
+
+		// Hand the inputs over on the primary queue
+		src->change_layout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		src->queue_release(cmd, compute_family, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		if (depth)
+		{
+			depth->change_layout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+			depth->queue_release(cmd, compute_family, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
+
+		// Record the whole pass now, it is submitted after the primary queue signals the inputs
+		slot.cmd.begin();
+
+		temporal::acquire_image(slot.cmd, src, graphics_family);
+		if (depth)
+		{
+			temporal::acquire_image(slot.cmd, depth, graphics_family);
+		}
+
+		run_passes(slot.cmd, src, depth);
+
+		m_output->queue_release(slot.cmd, graphics_family, VK_IMAGE_LAYOUT_GENERAL);
+		src->queue_release(slot.cmd, graphics_family, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		if (depth)
+		{
+			depth->queue_release(slot.cmd, graphics_family, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
+
+		slot.cmd.end();
+
+		m_async_recording = &slot;
+		m_async_source = src;
+		m_async_depth = depth;
+		return *slot.inputs_ready;
+	}
+
+	VkSemaphore temporal_upscale_pass::submit_async()
+	{
+		ensure(m_async_recording);
+		auto& slot = *m_async_recording;
+
+		vk::queue_submit_t submit_info{vk::get_current_renderer()->get_transfer_queue(), slot.fence.get()};
+		submit_info.wait_on(*slot.inputs_ready, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+		submit_info.queue_signal(*slot.outputs_ready);
+		slot.cmd.submit(submit_info, VK_FALSE);
+
+		slot.pending = true;
+		m_async_recording = nullptr;
+		m_async_results_pending = true;
+		return *slot.outputs_ready;
+	}
+
+	void temporal_upscale_pass::acquire_async_results(const vk::command_buffer& cmd)
+	{
+		if (!m_async_results_pending)
+		{
+			return;
+		}
+
+		const u32 compute_family = m_async_command_pool.get_queue_family();
+		temporal::acquire_image(cmd, m_async_source, compute_family);
+		temporal::acquire_image(cmd, m_output.get(), compute_family);
+
+		if (m_async_depth)
+		{
+			temporal::acquire_image(cmd, m_async_depth, compute_family);
+		}
+
+		m_async_results_pending = false;
+	}
+
+	vk::viewable_image* temporal_upscale_pass::scale_output(
+		const vk::command_buffer& cmd,
+		vk::viewable_image* src,
+		VkImage present_surface,
+		VkImageLayout present_surface_layout,
+		const VkImageBlit& request,
+		rsx::flags32_t mode)
+	{
+		size2u input_size, output_size;
+		input_size.width = std::abs(request.srcOffsets[1].x - request.srcOffsets[0].x);
+		input_size.height = std::abs(request.srcOffsets[1].y - request.srcOffsets[0].y);
+		output_size.width = std::abs(request.dstOffsets[1].x - request.dstOffsets[0].x);
+		output_size.height = std::abs(request.dstOffsets[1].y - request.dstOffsets[0].y);
+
+		auto src_image = src;
+		auto output_request = request;
+		vk::viewable_image* result = nullptr;
+
+		// History is only kept for a single view
+		ensure(!(mode & UPSCALE_RIGHT_VIEW));
+
+		if (m_async_results_pending)
+		{
+			const bool matches = (m_async_source == src && m_input_size == input_size && m_output_size == output_size);
+			acquire_async_results(cmd);
+
+			if (matches)
+			{
+				result = m_output.get();
+			}
+		}
+
+		if (!result && is_upscale_request(input_size, output_size) && prepare(input_size, output_size))
+		{
+			auto depth = get_depth_input(input_size);
+
+			src->push_layout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+			if (depth)
+			{
+				depth->push_layout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+			}
+
+			run_passes(cmd, src, depth);
+
+			if (depth)
+			{
+				depth->pop_layout(cmd);
+			}
+			src->pop_layout(cmd);
+
+			result = m_output.get();
+		}
+
+		m_depth_source = nullptr;
+
+		if (result)
+		{
+			src_image = result;
+
+			if (mode & UPSCALE_AND_COMMIT)
+			{
+				// Explicit CS-Transfer barrier
+				vk::insert_image_memory_barrier(cmd,
+					result->value,
+					result->current_layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+					VK_PIPELINE_STAGE_TRANSFER_BIT,
+					VK_ACCESS_SHADER_WRITE_BIT,
+					VK_ACCESS_TRANSFER_READ_BIT,
+					{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
+
+				result->current_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+				output_request.srcOffsets[0].x = 0;
+				output_request.srcOffsets[1].x = output_size.width;
+				output_request.srcOffsets[0].y = 0;
+				output_request.srcOffsets[1].y = output_size.height;
+
+				// Preserve mirroring/flipping
+				if (request.srcOffsets[0].x > request.srcOffsets[1].x)
+				{
+					std::swap(output_request.srcOffsets[0].x, output_request.srcOffsets[1].x);
+				}
+
+				if (request.srcOffsets[0].y > request.srcOffsets[1].y)
+				{
+					std::swap(output_request.srcOffsets[0].y, output_request.srcOffsets[1].y);
+				}
+			}
+		}
+
+		if (mode & UPSCALE_AND_COMMIT)
+		{
+			src_image->push_layout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+			VK_GET_SYMBOL(vkCmdBlitImage)(cmd, src_image->value, src_image->current_layout, present_surface, present_surface_layout, 1, &output_request, VK_FILTER_LINEAR);
+			src_image->pop_layout(cmd);
+			return nullptr;
+		}
+
+		return src_image;
+	}
+} // namespace vk
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "../vkutils/sampler.h"
+#include "../vkutils/sync.h"
+#include "../VKCompute.h"
+
+#include "upscaling.h"
+
+namespace vk
+{
+	namespace temporal
+	{
+		enum temporal_pass_flags : u32
+		{
+			TEMPORAL_HISTORY_VALID = (1 << 0),
+			TEMPORAL_DEPTH_VALID = (1 << 1)
+		};
+
+		class temporal_pass : public compute_task
+		{
+		protected:
+			std::unique_ptr<vk::sampler> m_linear_sampler;
+			std::unique_ptr<vk::sampler> m_nearest_sampler;
+			u32 m_wg_x = 8;
+			u32 m_wg_y = 8;
+
+			void build(const char* kernel);
+			void create_samplers();
+
+		public:
+			// Motion is reconstructed per block of tile_size x tile_size input pixels
+			static constexpr u32 tile_size = 8;
+		};
+
+		class motion_estimation_pass : public temporal_pass
+		{
+			const vk::image_view* m_color = nullptr;
+			const vk::image_view* m_previous_luma = nullptr;
+			const vk::image_view* m_depth = nullptr;
+			const vk::image_view* m_previous_motion = nullptr;
+			const vk::image_view* m_luma_out = nullptr;
+			const vk::image_view* m_motion_out = nullptr;
+
+			std::vector<std::pair<VkDescriptorType, u8>> get_descriptor_layout() override;
+			void declare_inputs() override;
+			void bind_resources() override;
+
+		public:
+			motion_estimation_pass();
+			void run(const vk::command_buffer& cmd, vk::viewable_image* color, vk::viewable_image* depth,
+				vk::viewable_image* previous_luma, vk::viewable_image* previous_motion,
+				vk::viewable_image* luma_out, vk::viewable_image* motion_out,
+				const size2u& input_size, rsx::flags32_t flags);
+		};
+
+		class resolve_pass : public temporal_pass
+		{
+			const vk::image_view* m_color = nullptr;
+			const vk::image_view* m_history = nullptr;
+			const vk::image_view* m_motion = nullptr;
+			const vk::image_view* m_previous_motion = nullptr;
+			const vk::image_view* m_history_out = nullptr;
+
+			std::vector<std::pair<VkDescriptorType, u8>> get_descriptor_layout() override;
+			void declare_inputs() override;
+			void bind_resources() override;
+
+		public:
+			resolve_pass();
+			void run(const vk::command_buffer& cmd, vk::viewable_image* color,
+				vk::viewable_image* history, vk::viewable_image* motion, vk::viewable_image* previous_motion,
+				vk::viewable_image* history_out, const size2u& input_size, const size2u& output_size, rsx::flags32_t flags);
+		};
+
+		// Synthesizes the image halfway between two frames from the motion found by motion_estimation_pass
+		class interpolation_pass : public temporal_pass
+		{
+			const vk::image_view* m_previous = nullptr;
+			const vk::image_view* m_current = nullptr;
+			const vk::image_view* m_motion = nullptr;
+			const vk::image_view* m_output = nullptr;
+
+			std::vector<std::pair<VkDescriptorType, u8>> get_descriptor_layout() override;
+			void declare_inputs() override;
+			void bind_resources() override;
+
+		public:
+			interpolation_pass();
+			void run(const vk::command_buffer& cmd, vk::viewable_image* previous, vk::viewable_image* current,
+				vk::viewable_image* motion, vk::viewable_image* output, const size2u& size);
+		};
+
+		// Single channel format usable for the luma images, and its GLSL qualifier
+		std::pair<VkFormat, const char*> get_luma_format();
+
+		// Image bookkeeping treats queue_release as the whole transfer. Emit the matching acquire on the receiving queue.
+		void acquire_image(const vk::command_buffer& cmd, vk::image* img, u32 src_queue_family);
+
+		// Contents are about to be fully rewritten, drop them together with any queue ownership
+		void discard_image(const vk::command_buffer& cmd, vk::image* img);
+	} // namespace temporal
+
+	// Temporal reconstruction of the presented image from a lower internal resolution.
+	// The guest provides neither motion vectors nor jitter, so motion is estimated from the frames themselves.
+	class temporal_upscale_pass : public upscaler
+	{
+		static constexpr u32 async_slot_count = 4;
+
+		struct async_slot
+		{
+			vk::command_buffer cmd;
+			std::unique_ptr<vk::fence> fence;
+			std::unique_ptr<vk::semaphore> inputs_ready;
+			std::unique_ptr<vk::semaphore> outputs_ready;
+			bool pending = false;
+		};
+
+		std::unique_ptr<vk::viewable_image> m_output;
+		std::unique_ptr<vk::viewable_image> m_history[2];
+		std::unique_ptr<vk::viewable_image> m_luma[2];
+		std::unique_ptr<vk::viewable_image> m_motion[2];
+		u32 m_history_index = 0;
+		u32 m_history_queue_family = VK_QUEUE_FAMILY_IGNORED;
+		bool m_history_valid = false;
+
+		size2u m_input_size{};
+		size2u m_output_size{};
+		vk::viewable_image* m_depth_source = nullptr;
+
+		// Async compute state. The frame is recorded on the primary queue up to the release of the inputs,
+		// the pass runs on the transfer+compute queue and the swap command buffer consumes the results.
+		vk::command_pool m_async_command_pool;
+		std::array<async_slot, async_slot_count> m_async_slots;
+		u32 m_async_slot_index = 0;
+		async_slot* m_async_recording = nullptr;
+		vk::viewable_image* m_async_source = nullptr;
+		vk::viewable_image* m_async_depth = nullptr;
+		bool m_async_results_pending = false;
+
+		void dispose_images();
+		bool prepare(const size2u& input_size, const size2u& output_size);
+		vk::viewable_image* get_depth_input(const size2u& input_size) const;
+		void run_passes(const vk::command_buffer& cmd, vk::viewable_image* src, vk::viewable_image* depth);
+		void acquire_async_results(const vk::command_buffer& cmd);
+
+	public:
+		temporal_upscale_pass() = default;
+		~temporal_upscale_pass();
+
+		// Depth of the scene for the next frame, may be null
+		void set_depth_source(vk::viewable_image* depth);
+
+		bool can_run_async() const;
+
+		// Releases the inputs to the compute queue. The returned semaphore must be signaled by the submission of 'cmd'.
+		VkSemaphore queue_async(const vk::command_buffer& cmd, vk::viewable_image* src, const size2u& input_size, const size2u& output_size);
+
+		// Submits the work prepared by queue_async. The returned semaphore must be waited on by the next primary submission.
+		VkSemaphore submit_async();
+
+		vk::viewable_image* scale_output(
+			const vk::command_buffer& cmd,        // CB
+			vk::viewable_image* src,              // Source input
+			VkImage present_surface,              // Present target. May be VK_NULL_HANDLE for some passes
+			VkImageLayout present_surface_layout, // Present surface layout, or VK_IMAGE_LAYOUT_UNDEFINED if no present target is provided
+			const VkImageBlit& request,           // Scaling request information
+			rsx::flags32_t mode                   // Mode
+			) override;
+	};
+} // namespace vk
@@ -1,6 +1,7 @@
 #include "barriers.h"
 #include "commands.h"
 #include "image.h"
+#include "image_helpers.h"
 
 #include "../../rsx_methods.h"
 #include "../VKRenderPass.h"
@@ -126,4 +127,39 @@ namespace vk
 		insert_texture_barrier(cmd, image->value, image->current_layout, new_layout, {image->aspect(), 0, 1, 0, 1}, preserve_renderpass);
 		image->current_layout = new_layout;
 	}
+
+	void image_barrier_batch::change_layout(vk::image* image, VkImageLayout new_layout)
+	{
+		if (image->current_layout == new_layout)
+		{
+			return;
+		}
+
+		VkPipelineStageFlags src_stage, dst_stage;
+		m_barriers.push_back(get_image_layout_barrier(image->value, image->current_layout, new_layout,
+			{image->aspect(), 0, image->mipmaps(), 0, image->layers()}, src_stage, dst_stage));
+
+		m_src_stage |= src_stage;
+		m_dst_stage |= dst_stage;
+		image->current_layout = new_layout;
+	}
+
+	void image_barrier_batch::flush(const vk::command_buffer& cmd)
+	{
+		if (m_barriers.empty())
+		{
+			return;
+		}
+
+		if (vk::is_renderpass_open(cmd))
+		{
+			vk::end_renderpass(cmd);
+		}
+
+		VK_GET_SYMBOL(vkCmdPipelineBarrier)(cmd, m_src_stage, m_dst_stage, 0, 0, nullptr, 0, nullptr, ::size32(m_barriers), m_barriers.data());
+
+		m_barriers.clear();
+		m_src_stage = 0;
+		m_dst_stage = 0;
+	}
 } // namespace vk
@@ -2,6 +2,8 @@
 
 #include "../VulkanAPI.h"
 
+#include <vector>
+
 namespace vk
 {
 	class image;
@@ -25,4 +27,21 @@ namespace vk
 		VkAccessFlags src_access = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
 		VkAccessFlags dst_access = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
 		bool preserve_renderpass = false);
+
+	// Collects the layout transitions of several images and records them as one pipeline barrier
+	class image_barrier_batch
+	{
+		std::vector<VkImageMemoryBarrier> m_barriers;
+		VkPipelineStageFlags m_src_stage = 0;
+		VkPipelineStageFlags m_dst_stage = 0;
+
+	public:
+		// Queues a transition of the whole image. The tracked image layout is updated immediately.
+		void change_layout(vk::image* image, VkImageLayout new_layout);
+
+		// Records the queued transitions, if any
+		void flush(const vk::command_buffer& cmd);
+
+		bool empty() const { return m_barriers.empty(); }
+	};
 } // namespace vk
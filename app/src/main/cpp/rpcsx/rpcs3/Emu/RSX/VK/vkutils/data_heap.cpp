@@ -8,12 +8,17 @@
 #include "Emu/IdManager.h"
 #include "rx/align.hpp"
 
+#include <algorithm>
 #include <memory>
 
 namespace vk
 {
 	data_heap g_upload_heap;
 
+	// All heap sizes are aligned up by 64M, upto 1GiB
+	static constexpr usz heap_growth_alignment = 64 * 0x100000;
+	static constexpr usz heap_size_limit = 1024 * 0x100000;
+
 	void data_heap::create(VkBufferUsageFlags usage, usz size, const char* name, usz guard, VkBool32 notify)
 	{
 		::data_heap::init(size, name, guard);
@@ -59,15 +64,14 @@ namespace vk
 			return false;
 		}
 
-		// Create new heap. All sizes are aligned up by 64M, upto 1GiB
-		const usz size_limit = 1024 * 0x100000;
-		usz aligned_new_size = rx::alignUp(m_size + size, 64 * 0x100000);
+		// Create new heap
+		usz aligned_new_size = rx::alignUp(m_size + size, heap_growth_alignment);
 
-		if (aligned_new_size >= size_limit)
+		if (aligned_new_size >= heap_size_limit)
 		{
 			// Too large, try to swap out the heap instead of growing.
 			rsx_log.error("[%s] Pool limit was reached. Will attempt to swap out the current heap.", m_name);
-			aligned_new_size = size_limit;
+			aligned_new_size = heap_size_limit;
 		}
 
 		// Wait for DMA activity to end
@@ -87,6 +91,7 @@ namespace vk
 
 		// Update heap information and reset the allocator
 		::data_heap::init(aligned_new_size, m_name, m_min_guard_size);
+		frame_start_pos = 0;
 
 		// Discard old heap and create a new one. Old heap will be garbage collected when no longer needed
 		get_resource_manager()->dispose(heap);
@@ -150,6 +155,29 @@ namespace vk
 		}
 	}
 
+	void data_heap::on_frame_end(usz frames_in_flight)
+	{
+		const usz used = (m_put_pos >= frame_start_pos) ? (m_put_pos - frame_start_pos) : (m_size - frame_start_pos + m_put_pos);
+		frame_usage[frame_history_index++ % frame_history_length] = used;
+		frame_start_pos = m_put_pos;
+
+		if (shadow || m_size >= heap_size_limit || m_size >= initial_size * 8)
+		{
+			// Growth is not possible or the soft limit is reached, is_critical takes over from here
+			return;
+		}
+
+		const usz high_water = *std::max_element(frame_usage.begin(), frame_usage.end());
+		const usz required = high_water * frames_in_flight + std::max(m_min_guard_size, m_largest_allocated_pool);
+
+		if (required > m_size)
+		{
+			// Growing on the frame boundary avoids taking the DMA sync and heap swap in the middle of a draw sequence
+			rsx_log.notice("[%s] Heap is growing ahead of demand. Peak frame usage=0x%llx, size=0x%llx", m_name, high_water, m_size);
+			grow(required - m_size);
+		}
+	}
+
 	bool data_heap::is_dirty() const
 	{
 		return !dirty_ranges.empty();
@@ -5,6 +5,7 @@
 #include "buffer_object.h"
 #include "commands.h"
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -22,6 +23,12 @@ namespace vk
 		std::unique_ptr<buffer> shadow;
 		std::vector<VkBufferCopy> dirty_ranges;
 
+		// Bytes consumed by each of the last frames, drives growth ahead of demand
+		static constexpr usz frame_history_length = 16;
+		std::array<usz, frame_history_length> frame_usage{};
+		usz frame_history_index = 0;
+		usz frame_start_pos = 0;
+
 	protected:
 		bool grow(usz size) override;
 
@@ -40,6 +47,9 @@ namespace vk
 
 		void sync(const vk::command_buffer& cmd);
 
+		// Record this frame's usage and grow now if the recent peak would not fit frames_in_flight times
+		void on_frame_end(usz frames_in_flight);
+
 		// Properties
 		bool is_dirty() const;
 		bool is_critical() const override;
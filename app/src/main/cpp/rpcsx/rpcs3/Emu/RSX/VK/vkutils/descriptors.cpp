@@ -7,6 +7,9 @@ namespace vk
 	// Error handler callback
 	extern void on_descriptor_pool_fragmentation(bool fatal);
 
+	// Active bindless table, set while it exists
+	static std::atomic<bindless_texture_table*> g_bindless_texture_table = nullptr;
+
 	namespace descriptors
 	{
 		class dispatch_manager
@@ -108,6 +111,22 @@ namespace vk
 			CHECK_RESULT(VK_GET_SYMBOL(vkCreateDescriptorSetLayout)(*g_render_device, &infos, nullptr, &result));
 			return result;
 		}
+
+		void notify_image_view_destroyed(VkImageView view)
+		{
+			if (auto table = g_bindless_texture_table.load()) [[unlikely]]
+			{
+				table->on_image_view_destroyed(view);
+			}
+		}
+
+		void notify_sampler_destroyed(VkSampler sampler)
+		{
+			if (auto table = g_bindless_texture_table.load()) [[unlikely]]
+			{
+				table->on_sampler_destroyed(sampler);
+			}
+		}
 	} // namespace descriptors
 
 	void descriptor_pool::create(const vk::render_device& dev, const rsx::simple_array<VkDescriptorPoolSize>& pool_sizes, u32 max_sets)
@@ -274,6 +293,194 @@ namespace vk
 		m_current_pool_handle = m_device_subpools[m_current_subpool_index].handle;
 	}
 
+	bindless_texture_table::~bindless_texture_table()
+	{
+		destroy();
+	}
+
+	void bindless_texture_table::create(const vk::render_device& dev)
+	{
+		ensure(dev.get_bindless_textures_support());
+
+		VkDescriptorSetLayoutBinding binding = {};
+		binding.binding = 0;
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		binding.descriptorCount = max_slots;
+		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		// Slots are written while the set is bound and while older submissions still read other slots
+		const VkDescriptorBindingFlags binding_flags =
+			VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+			VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+			VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo binding_infos = {};
+		binding_infos.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+		binding_infos.bindingCount = 1;
+		binding_infos.pBindingFlags = &binding_flags;
+
+		VkDescriptorSetLayoutCreateInfo layout_info = {};
+		layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layout_info.pNext = &binding_infos;
+		layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+		layout_info.bindingCount = 1;
+		layout_info.pBindings = &binding;
+		CHECK_RESULT(VK_GET_SYMBOL(vkCreateDescriptorSetLayout)(dev, &layout_info, nullptr, &m_set_layout));
+
+		const VkDescriptorPoolSize pool_size = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, max_slots};
+
+		VkDescriptorPoolCreateInfo pool_info = {};
+		pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		pool_info.maxSets = 1;
+		pool_info.poolSizeCount = 1;
+		pool_info.pPoolSizes = &pool_size;
+		CHECK_RESULT(VK_GET_SYMBOL(vkCreateDescriptorPool)(dev, &pool_info, nullptr, &m_pool));
+
+		VkDescriptorSetAllocateInfo alloc_info = {};
+		alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		alloc_info.descriptorPool = m_pool;
+		alloc_info.descriptorSetCount = 1;
+		alloc_info.pSetLayouts = &m_set_layout;
+		CHECK_RESULT(VK_GET_SYMBOL(vkAllocateDescriptorSets)(dev, &alloc_info, &m_set));
+
+		m_owner = &dev;
+		m_free_slots.reserve(max_slots);
+		g_bindless_texture_table = this;
+
+		rsx_log.notice("Bindless textures enabled with %u slots", max_slots);
+	}
+
+	void bindless_texture_table::destroy()
+	{
+		if (!m_owner)
+		{
+			return;
+		}
+
+		g_bindless_texture_table = nullptr;
+
+		std::lock_guard lock(m_lock);
+
+		VK_GET_SYMBOL(vkDestroyDescriptorPool)(*m_owner, m_pool, nullptr);
+		VK_GET_SYMBOL(vkDestroyDescriptorSetLayout)(*m_owner, m_set_layout, nullptr);
+
+		m_pool = VK_NULL_HANDLE;
+		m_set_layout = VK_NULL_HANDLE;
+		m_set = VK_NULL_HANDLE;
+		m_owner = nullptr;
+
+		m_slots.clear();
+		m_free_slots.clear();
+		m_next_slot = 0;
+	}
+
+	u32 bindless_texture_table::get_slot(VkImageView view, VkSampler sampler, VkImageLayout layout)
+	{
+		std::lock_guard lock(m_lock);
+
+		auto& entries = m_slots[view];
+		for (const auto& entry : entries)
+		{
+			if (entry.sampler == sampler && entry.layout == layout)
+			{
+				return entry.slot;
+			}
+		}
+
+		u32 slot;
+		if (!m_free_slots.empty())
+		{
+			slot = m_free_slots.pop_back();
+		}
+		else if (m_next_slot < max_slots)
+		{
+			slot = m_next_slot++;
+		}
+		else
+		{
+			if (!m_exhausted)
+			{
+				rsx_log.error("Bindless texture table is full (%u slots)", max_slots);
+				m_exhausted = true;
+			}
+
+			if (entries.empty())
+			{
+				m_slots.erase(view);
+			}
+
+			return invalid_slot;
+		}
+
+		// Update-after-bind, the write is visible to everything submitted from now on
+		const VkDescriptorImageInfo image_info = {sampler, view, layout};
+
+		VkWriteDescriptorSet write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_set;
+		write.dstBinding = 0;
+		write.dstArrayElement = slot;
+		write.descriptorCount = 1;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.pImageInfo = &image_info;
+		VK_GET_SYMBOL(vkUpdateDescriptorSets)(*m_owner, 1, &write, 0, nullptr);
+
+		entries.push_back({sampler, layout, slot});
+		return slot;
+	}
+
+	void bindless_texture_table::bind(const vk::command_buffer& cmd, VkPipelineLayout layout) const
+	{
+		VK_GET_SYMBOL(vkCmdBindDescriptorSets)(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, set_index, 1, &m_set, 0, nullptr);
+	}
+
+	void bindless_texture_table::on_image_view_destroyed(VkImageView view)
+	{
+		// Views are released through the GC, no submission still reads these slots
+		std::lock_guard lock(m_lock);
+
+		const auto found = m_slots.find(view);
+		if (found == m_slots.end())
+		{
+			return;
+		}
+
+		for (const auto& entry : found->second)
+		{
+			m_free_slots.push_back(entry.slot);
+		}
+
+		m_slots.erase(found);
+		m_exhausted = false;
+	}
+
+	void bindless_texture_table::on_sampler_destroyed(VkSampler sampler)
+	{
+		// Rare, only happens when the sampler pool is trimmed
+		std::lock_guard lock(m_lock);
+
+		for (auto it = m_slots.begin(); it != m_slots.end();)
+		{
+			auto& entries = it->second;
+			for (u32 i = 0; i < entries.size();)
+			{
+				if (entries[i].sampler == sampler)
+				{
+					m_free_slots.push_back(entries[i].slot);
+					entries[i] = entries.back();
+					entries.pop_back();
+					m_exhausted = false;
+					continue;
+				}
+
+				++i;
+			}
+
+			it = entries.empty() ? m_slots.erase(it) : std::next(it);
+		}
+	}
+
 	descriptor_set::descriptor_set(VkDescriptorSet set)
 	{
 		flush();
@@ -8,6 +8,8 @@
 
 #include "Emu/RSX/Common/simple_array.hpp"
 
+#include <unordered_map>
+
 namespace vk
 {
 	struct gc_callback_t
@@ -159,11 +161,68 @@ namespace vk
 		rsx::simple_array<VkCopyDescriptorSet> m_pending_copies;
 	};
 
+	// One update-after-bind array of combined image samplers for all fragment textures.
+	// Each (view, sampler, layout) combination gets a slot on first use and keeps it until the view or the sampler is destroyed.
+	// Shaders select the slots through push constants, so changing textures does not touch the per-draw descriptor set.
+	class bindless_texture_table
+	{
+	public:
+		static constexpr u32 max_slots = BINDLESS_MAX_TEXTURE_SLOTS;
+		static constexpr u32 invalid_slot = umax;
+
+		// Pipeline layout interface
+		static constexpr u32 set_index = 1;
+		static constexpr u32 push_constants_offset = 32;
+		static constexpr u32 push_constants_size = 64; // One word per fragment texture unit, stencil mirror slot in the high half
+
+		bindless_texture_table() = default;
+		~bindless_texture_table();
+
+		void create(const vk::render_device& dev);
+		void destroy();
+
+		// Returns invalid_slot if the table is full
+		u32 get_slot(VkImageView view, VkSampler sampler, VkImageLayout layout);
+
+		void bind(const vk::command_buffer& cmd, VkPipelineLayout layout) const;
+
+		VkDescriptorSetLayout layout() const
+		{
+			return m_set_layout;
+		}
+
+		void on_image_view_destroyed(VkImageView view);
+		void on_sampler_destroyed(VkSampler sampler);
+
+	private:
+		struct slot_entry_t
+		{
+			VkSampler sampler;
+			VkImageLayout layout;
+			u32 slot;
+		};
+
+		const vk::render_device* m_owner = nullptr;
+		VkDescriptorPool m_pool = VK_NULL_HANDLE;
+		VkDescriptorSetLayout m_set_layout = VK_NULL_HANDLE;
+		VkDescriptorSet m_set = VK_NULL_HANDLE;
+
+		shared_mutex m_lock;
+		std::unordered_map<VkImageView, rsx::simple_array<slot_entry_t>> m_slots;
+		rsx::simple_array<u32> m_free_slots;
+		u32 m_next_slot = 0;
+		bool m_exhausted = false;
+	};
+
 	namespace descriptors
 	{
 		void init();
 		void flush();
 
 		VkDescriptorSetLayout create_layout(const rsx::simple_array<VkDescriptorSetLayoutBinding>& bindings);
+
+		// Lifetime notifications for the bindless table, no-ops if it is not in use
+		void notify_image_view_destroyed(VkImageView view);
+		void notify_sampler_destroyed(VkSampler sampler);
 	} // namespace descriptors
 } // namespace vk
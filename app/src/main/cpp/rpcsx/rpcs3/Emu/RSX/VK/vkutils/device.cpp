@@ -36,6 +36,11 @@ namespace vk
 			VkPhysicalDeviceCustomBorderColorFeaturesEXT custom_border_color_info{};
 			VkPhysicalDeviceBorderColorSwizzleFeaturesEXT border_color_swizzle_info{};
 			VkPhysicalDeviceFaultFeaturesEXT device_fault_info{};
+			VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipeline_library_info{};
+			VkPhysicalDevicePresentIdFeaturesKHR present_id_info{};
+			VkPhysicalDevicePresentWaitFeaturesKHR present_wait_info{};
+			VkPhysicalDeviceFragmentShadingRateFeaturesKHR shading_rate_info{};
+			VkPhysicalDevicePipelineCreationCacheControlFeaturesEXT cache_control_info{};
 
 			if (device_extensions.is_supported(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME))
 			{
@@ -86,6 +91,42 @@ namespace vk
 				features2.pNext = &device_fault_info;
 			}
 
+			if (device_extensions.is_supported(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+				device_extensions.is_supported(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+			{
+				pipeline_library_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+				pipeline_library_info.pNext = features2.pNext;
+				features2.pNext = &pipeline_library_info;
+			}
+
+			if (device_extensions.is_supported(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+				device_extensions.is_supported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+			{
+				present_id_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+				present_id_info.pNext = features2.pNext;
+				present_wait_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+				present_wait_info.pNext = &present_id_info;
+				features2.pNext = &present_wait_info;
+			}
+
+			// VK_KHR_create_renderpass2 and its dependencies are required by the extension on Vulkan 1.0
+			if (device_extensions.is_supported(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME) &&
+				device_extensions.is_supported(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME) &&
+				device_extensions.is_supported(VK_KHR_MULTIVIEW_EXTENSION_NAME) &&
+				device_extensions.is_supported(VK_KHR_MAINTENANCE2_EXTENSION_NAME))
+			{
+				shading_rate_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+				shading_rate_info.pNext = features2.pNext;
+				features2.pNext = &shading_rate_info;
+			}
+
+			if (device_extensions.is_supported(VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME))
+			{
+				cache_control_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES_EXT;
+				cache_control_info.pNext = features2.pNext;
+				features2.pNext = &cache_control_info;
+			}
+
 			auto _vkGetPhysicalDeviceFeatures2KHR = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(VK_GET_SYMBOL(vkGetInstanceProcAddr)(parent, "vkGetPhysicalDeviceFeatures2KHR"));
 			ensure(_vkGetPhysicalDeviceFeatures2KHR); // "vkGetInstanceProcAddress failed to find entry point!"
 			_vkGetPhysicalDeviceFeatures2KHR(dev, &features2);
@@ -101,6 +142,10 @@ namespace vk
 			optional_features_support.barycentric_coords = !!shader_barycentric_info.fragmentShaderBarycentric;
 			optional_features_support.framebuffer_loops = !!fbo_loops_info.attachmentFeedbackLoopLayout;
 			optional_features_support.extended_device_fault = !!device_fault_info.deviceFault;
+			optional_features_support.graphics_pipeline_library = !!pipeline_library_info.graphicsPipelineLibrary && g_cfg.video.vk.graphics_pipeline_library;
+			optional_features_support.present_wait = !!present_id_info.presentId && !!present_wait_info.presentWait && g_cfg.video.vk.present_wait_pacing;
+			optional_features_support.fragment_shading_rate = !!shading_rate_info.pipelineFragmentShadingRate && g_cfg.video.vk.fragment_shading_rate;
+			optional_features_support.pipeline_creation_cache_control = !!cache_control_info.pipelineCreationCacheControl && g_cfg.video.vk.pipeline_cache_probe;
 
 			features = features2.features;
 
@@ -117,6 +162,12 @@ namespace vk
 				SET_DESCRIPTOR_BITFLAG(descriptorBindingUniformTexelBufferUpdateAfterBind, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER);
 				SET_DESCRIPTOR_BITFLAG(descriptorBindingStorageTexelBufferUpdateAfterBind, VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER);
 #undef SET_DESCRIPTOR_BITFLAG
+
+				descriptor_indexing_support.bindless_textures = g_cfg.video.vk.bindless_textures &&
+					features2.features.shaderSampledImageArrayDynamicIndexing &&
+					descriptor_indexing_info.descriptorBindingSampledImageUpdateAfterBind &&
+					descriptor_indexing_info.descriptorBindingPartiallyBound &&
+					descriptor_indexing_info.descriptorBindingUpdateUnusedWhilePending;
 			}
 		}
 
@@ -130,6 +181,9 @@ namespace vk
 		optional_features_support.debug_utils = instance_extensions.is_supported(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 		optional_features_support.surface_capabilities_2 = instance_extensions.is_supported(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 
+		// VMA queries the budget through vkGetPhysicalDeviceMemoryProperties2KHR
+		optional_features_support.memory_budget = optional_features_support.surface_capabilities_2 && device_extensions.is_supported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
 		// Post-initialization checks
 		if (!custom_border_color_support.swizzle_extension_supported)
 		{
@@ -139,6 +193,9 @@ namespace vk
 
 		// v3dv and PanVK support BC1-BC3 which is all we require, support is reported as false since not all formats are supported
 		optional_features_support.texture_compression_bc = features.textureCompressionBC || get_driver_vendor() == driver_vendor::V3DV || get_driver_vendor() == driver_vendor::PANVK;
+
+		// Without BC, DXT1 can still stay compressed in VRAM as ASTC 4x4 (Adreno, Mali)
+		optional_features_support.dxt1_astc_transcode = !optional_features_support.texture_compression_bc && features.textureCompressionASTC_LDR && g_cfg.video.vk.dxt1_astc_transcode;
 	}
 
 	void physical_device::get_physical_device_properties(bool allow_extensions)
@@ -165,6 +222,7 @@ namespace vk
 			properties2.pNext = nullptr;
 
 			VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptor_indexing_props{};
+			VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT pipeline_library_props{};
 
 			if (descriptor_indexing_support)
 			{
@@ -180,24 +238,51 @@ namespace vk
 				properties2.pNext = &driver_properties;
 			}
 
+			if (optional_features_support.graphics_pipeline_library)
+			{
+				pipeline_library_props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+				pipeline_library_props.pNext = properties2.pNext;
+				properties2.pNext = &pipeline_library_props;
+			}
+
 			auto _vkGetPhysicalDeviceProperties2KHR = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2KHR>(VK_GET_SYMBOL(vkGetInstanceProcAddr)(parent, "vkGetPhysicalDeviceProperties2KHR"));
 			ensure(_vkGetPhysicalDeviceProperties2KHR);
 
 			_vkGetPhysicalDeviceProperties2KHR(dev, &properties2);
 			props = properties2.properties;
 
+			if (optional_features_support.graphics_pipeline_library && !pipeline_library_props.graphicsPipelineLibraryFastLinking)
+			{
+				// Without fast linking every link is a full compile, no better than monolithic pipelines
+				rsx_log.notice("Graphics pipeline libraries are supported but fast linking is not. Pipeline libraries are disabled.");
+				optional_features_support.graphics_pipeline_library = false;
+			}
+
 			if (descriptor_indexing_support)
 			{
 				if (descriptor_indexing_props.maxUpdateAfterBindDescriptorsInAllPools < 800'000)
 				{
 					rsx_log.error("Physical device does not support enough descriptors for deferred updates to work effectively. Deferred updates are disabled.");
 					descriptor_indexing_support.update_after_bind_mask = 0;
+					descriptor_indexing_support.bindless_textures = false;
 				}
 				else if (descriptor_indexing_props.maxUpdateAfterBindDescriptorsInAllPools < 2'000'000)
 				{
 					rsx_log.warning("Physical device reports a low amount of allowed deferred descriptor updates. Draw call threshold will be lowered accordingly.");
 					descriptor_max_draw_calls = 8192;
 				}
+
+				// The bindless table comes on top of the per-draw set, leave room for the vertex textures
+				constexpr u32 bindless_required_descriptors = BINDLESS_MAX_TEXTURE_SLOTS + 64;
+				if (descriptor_indexing_support.bindless_textures &&
+					(descriptor_indexing_props.maxPerStageDescriptorUpdateAfterBindSamplers < bindless_required_descriptors ||
+					 descriptor_indexing_props.maxPerStageDescriptorUpdateAfterBindSampledImages < bindless_required_descriptors ||
+					 descriptor_indexing_props.maxDescriptorSetUpdateAfterBindSamplers < bindless_required_descriptors ||
+					 descriptor_indexing_props.maxDescriptorSetUpdateAfterBindSampledImages < bindless_required_descriptors))
+				{
+					rsx_log.warning("Physical device does not support %u update-after-bind samplers per stage. Bindless textures are disabled.", bindless_required_descriptors);
+					descriptor_indexing_support.bindless_textures = false;
+				}
 			}
 		}
 	}
@@ -442,7 +527,10 @@ namespace vk
 	// Render Device - The actual usable device
 	void render_device::create(vk::physical_device& pdev, u32 graphics_queue_idx, u32 present_queue_idx, u32 transfer_queue_idx)
 	{
-		float queue_priorities[1] = {0.f};
+		// Graphics first, the second entry covers a transfer queue taken from the same family.
+		// On GPUs with a single universal family (Adreno, Mali) the hint keeps streaming from delaying the frame.
+		const float queue_priorities[2] = {1.f, 0.5f};
+		const float transfer_queue_priority = 0.5f;
 		pgpu = &pdev;
 
 		ensure(graphics_queue_idx == present_queue_idx || present_queue_idx == umax); // TODO
@@ -473,6 +561,7 @@ namespace vk
 		}
 
 		m_graphics_queue_family = graphics_queue_idx;
+		m_graphics_timestamp_valid_bits = pdev.get_queue_properties(graphics_queue_idx).timestampValidBits;
 		m_present_queue_family = present_queue_idx;
 		m_transfer_queue_family = transfer_queue_idx;
 
@@ -484,7 +573,7 @@ namespace vk
 			transfer_queue.flags = 0;
 			transfer_queue.queueFamilyIndex = transfer_queue_idx;
 			transfer_queue.queueCount = 1;
-			transfer_queue.pQueuePriorities = queue_priorities;
+			transfer_queue.pQueuePriorities = &transfer_queue_priority;
 		}
 
 		// Set up instance information
@@ -557,6 +646,36 @@ namespace vk
 			requested_extensions.push_back(VK_EXT_DEVICE_FAULT_EXTENSION_NAME);
 		}
 
+		if (pgpu->optional_features_support.graphics_pipeline_library)
+		{
+			requested_extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+			requested_extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+		}
+
+		if (pgpu->optional_features_support.present_wait)
+		{
+			requested_extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+			requested_extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+		}
+
+		if (pgpu->optional_features_support.memory_budget)
+		{
+			requested_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
+
+		if (pgpu->optional_features_support.fragment_shading_rate)
+		{
+			requested_extensions.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME);
+			requested_extensions.push_back(VK_KHR_MAINTENANCE2_EXTENSION_NAME);
+			requested_extensions.push_back(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME);
+			requested_extensions.push_back(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+		}
+
+		if (pgpu->optional_features_support.pipeline_creation_cache_control)
+		{
+			requested_extensions.push_back(VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME);
+		}
+
 		enabled_features.robustBufferAccess = ensure(pgpu->features.robustBufferAccess, "robustBufferAccess is unsupported");
 		enabled_features.fullDrawIndexUint32 = VK_TRUE;
 		enabled_features.independentBlend = ensure(pgpu->features.independentBlend, "independentBlend is unsupported");
@@ -588,6 +707,7 @@ namespace vk
 
 		enabled_features.samplerAnisotropy = VK_TRUE;
 		enabled_features.textureCompressionBC = pgpu->optional_features_support.texture_compression_bc;
+		enabled_features.textureCompressionASTC_LDR = pgpu->optional_features_support.dxt1_astc_transcode;
 		enabled_features.shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
 
 		// Optionally disable unsupported stuff
@@ -722,6 +842,13 @@ namespace vk
 			SET_DESCRIPTOR_BITFLAG(descriptorBindingStorageTexelBufferUpdateAfterBind, VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER);
 #undef SET_DESCRIPTOR_BITFLAG
 
+			if (pgpu->descriptor_indexing_support.bindless_textures)
+			{
+				indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+				indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+				enabled_features.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+			}
+
 			indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
 			indexing_features.pNext = const_cast<void*>(device.pNext);
 			device.pNext = &indexing_features;
@@ -765,6 +892,47 @@ namespace vk
 			device.pNext = &device_fault_info;
 		}
 
+		VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipeline_library_info{};
+		if (pgpu->optional_features_support.graphics_pipeline_library)
+		{
+			pipeline_library_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+			pipeline_library_info.pNext = const_cast<void*>(device.pNext);
+			pipeline_library_info.graphicsPipelineLibrary = VK_TRUE;
+			device.pNext = &pipeline_library_info;
+		}
+
+		VkPhysicalDevicePresentIdFeaturesKHR present_id_info{};
+		VkPhysicalDevicePresentWaitFeaturesKHR present_wait_info{};
+		if (pgpu->optional_features_support.present_wait)
+		{
+			present_id_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+			present_id_info.pNext = const_cast<void*>(device.pNext);
+			present_id_info.presentId = VK_TRUE;
+			present_wait_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+			present_wait_info.pNext = &present_id_info;
+			present_wait_info.presentWait = VK_TRUE;
+			device.pNext = &present_wait_info;
+		}
+
+		VkPhysicalDeviceFragmentShadingRateFeaturesKHR shading_rate_info{};
+		if (pgpu->optional_features_support.fragment_shading_rate)
+		{
+			// Per-draw rate only, no shading rate attachments
+			shading_rate_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+			shading_rate_info.pNext = const_cast<void*>(device.pNext);
+			shading_rate_info.pipelineFragmentShadingRate = VK_TRUE;
+			device.pNext = &shading_rate_info;
+		}
+
+		VkPhysicalDevicePipelineCreationCacheControlFeaturesEXT cache_control_info{};
+		if (pgpu->optional_features_support.pipeline_creation_cache_control)
+		{
+			cache_control_info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES_EXT;
+			cache_control_info.pNext = const_cast<void*>(device.pNext);
+			cache_control_info.pipelineCreationCacheControl = VK_TRUE;
+			device.pNext = &cache_control_info;
+		}
+
 		VkPhysicalDeviceConditionalRenderingFeaturesEXT conditional_rendering_info{};
 		if (pgpu->optional_features_support.conditional_rendering)
 		{
@@ -831,6 +999,16 @@ namespace vk
 			_vkGetDeviceFaultInfoEXT = reinterpret_cast<PFN_vkGetDeviceFaultInfoEXT>(VK_GET_SYMBOL(vkGetDeviceProcAddr)(dev, "vkGetDeviceFaultInfoEXT"));
 		}
 
+		if (pgpu->optional_features_support.present_wait)
+		{
+			_vkWaitForPresentKHR = reinterpret_cast<PFN_vkWaitForPresentKHR>(VK_GET_SYMBOL(vkGetDeviceProcAddr)(dev, "vkWaitForPresentKHR"));
+		}
+
+		if (pgpu->optional_features_support.fragment_shading_rate)
+		{
+			_vkCmdSetFragmentShadingRateKHR = reinterpret_cast<PFN_vkCmdSetFragmentShadingRateKHR>(VK_GET_SYMBOL(vkGetDeviceProcAddr)(dev, "vkCmdSetFragmentShadingRateKHR"));
+		}
+
 		memory_map = vk::get_memory_mapping(pdev);
 		m_formats_support = vk::get_optimal_tiling_supported_formats(pdev);
 		m_pipeline_binding_table = vk::get_pipeline_binding_table(pdev);
@@ -10,6 +10,7 @@
 #include <unordered_map>
 
 #define DESCRIPTOR_MAX_DRAW_CALLS 32768
+#define BINDLESS_MAX_TEXTURE_SLOTS 4096
 
 namespace vk
 {
@@ -45,6 +46,7 @@ namespace vk
 	{
 		bool supported = false;
 		u64 update_after_bind_mask = 0;
+		bool bindless_textures = false; // Partially bound update-after-bind sampler arrays, see vk::bindless_texture_table
 
 		descriptor_indexing_features(bool supported = false)
 			: supported(supported) {}
@@ -98,7 +100,13 @@ namespace vk
 			bool synchronization_2 = false;
 			bool unrestricted_depth_range = false;
 			bool extended_device_fault = false;
+			bool graphics_pipeline_library = false;
 			bool texture_compression_bc = false;
+			bool dxt1_astc_transcode = false;
+			bool present_wait = false;
+			bool memory_budget = false;
+			bool fragment_shading_rate = false;
+			bool pipeline_creation_cache_control = false;
 		} optional_features_support;
 
 		friend class render_device;
@@ -148,6 +156,7 @@ namespace vk
 		u32 m_graphics_queue_family = 0;
 		u32 m_present_queue_family = 0;
 		u32 m_transfer_queue_family = 0;
+		u32 m_graphics_timestamp_valid_bits = 0;
 
 		void dump_debug_info(
 			const std::vector<const char*>& requested_extensions,
@@ -164,6 +173,8 @@ namespace vk
 		PFN_vkCmdWaitEvents2KHR _vkCmdWaitEvents2KHR = nullptr;
 		PFN_vkCmdPipelineBarrier2KHR _vkCmdPipelineBarrier2KHR = nullptr;
 		PFN_vkGetDeviceFaultInfoEXT _vkGetDeviceFaultInfoEXT = nullptr;
+		PFN_vkWaitForPresentKHR _vkWaitForPresentKHR = nullptr;
+		PFN_vkCmdSetFragmentShadingRateKHR _vkCmdSetFragmentShadingRateKHR = nullptr;
 
 	public:
 		render_device() = default;
@@ -222,6 +233,14 @@ namespace vk
 		{
 			return pgpu->features.wideLines != VK_FALSE;
 		}
+		bool get_timestamp_query_support() const
+		{
+			return pgpu->props.limits.timestampComputeAndGraphics != VK_FALSE && m_graphics_timestamp_valid_bits != 0;
+		}
+		u32 get_graphics_timestamp_valid_bits() const
+		{
+			return m_graphics_timestamp_valid_bits;
+		}
 		bool get_conditional_render_support() const
 		{
 			return pgpu->optional_features_support.conditional_rendering;
@@ -266,7 +285,35 @@ namespace vk
 		{
 			return pgpu->optional_features_support.texture_compression_bc;
 		}
+		bool get_dxt1_astc_transcode_support() const
+		{
+			return pgpu->optional_features_support.dxt1_astc_transcode;
+		}
+		bool get_graphics_pipeline_library_support() const
+		{
+			return pgpu->optional_features_support.graphics_pipeline_library;
+		}
+		bool get_present_wait_support() const
+		{
+			return pgpu->optional_features_support.present_wait;
+		}
+		bool get_memory_budget_support() const
+		{
+			return pgpu->optional_features_support.memory_budget;
+		}
+		bool get_fragment_shading_rate_support() const
+		{
+			return pgpu->optional_features_support.fragment_shading_rate;
+		}
+		bool get_pipeline_creation_cache_control_support() const
+		{
+			return pgpu->optional_features_support.pipeline_creation_cache_control;
+		}
 
+		bool get_bindless_textures_support() const
+		{
+			return pgpu->descriptor_indexing_support.bindless_textures;
+		}
 		u64 get_descriptor_update_after_bind_support() const
 		{
 			return pgpu->descriptor_indexing_support.update_after_bind_mask;
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "barriers.h"
+#include "descriptors.h"
 #include "device.h"
 #include "image.h"
 #include "image_helpers.h"
@@ -357,6 +358,7 @@ namespace vk
 
 	image_view::~image_view()
 	{
+		vk::descriptors::notify_image_view_destroyed(value);
 		VK_GET_SYMBOL(vkDestroyImageView)(m_device, value, nullptr);
 	}
 
@@ -34,14 +34,10 @@ namespace vk
 		return {final_mapping[1], final_mapping[2], final_mapping[3], final_mapping[0]};
 	}
 
-	void change_image_layout(const vk::command_buffer& cmd, VkImage image, VkImageLayout current_layout, VkImageLayout new_layout, const VkImageSubresourceRange& range,
+	VkImageMemoryBarrier get_image_layout_barrier(VkImage image, VkImageLayout current_layout, VkImageLayout new_layout, const VkImageSubresourceRange& range,
+		VkPipelineStageFlags& src_stage, VkPipelineStageFlags& dst_stage,
 		u32 src_queue_family, u32 dst_queue_family, u32 src_access_mask_bits, u32 dst_access_mask_bits)
 	{
-		if (vk::is_renderpass_open(cmd))
-		{
-			vk::end_renderpass(cmd);
-		}
-
 		// Prepare an image to match the new layout..
 		VkImageMemoryBarrier barrier = {};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -54,8 +50,8 @@ namespace vk
 		barrier.dstQueueFamilyIndex = dst_queue_family;
 		barrier.subresourceRange = range;
 
-		VkPipelineStageFlags src_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-		VkPipelineStageFlags dst_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		src_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		dst_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 
 		switch (+new_layout)
 		{
@@ -181,6 +177,21 @@ namespace vk
 		if (!barrier.dstAccessMask)
 			dst_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 
+		return barrier;
+	}
+
+	void change_image_layout(const vk::command_buffer& cmd, VkImage image, VkImageLayout current_layout, VkImageLayout new_layout, const VkImageSubresourceRange& range,
+		u32 src_queue_family, u32 dst_queue_family, u32 src_access_mask_bits, u32 dst_access_mask_bits)
+	{
+		if (vk::is_renderpass_open(cmd))
+		{
+			vk::end_renderpass(cmd);
+		}
+
+		VkPipelineStageFlags src_stage, dst_stage;
+		const auto barrier = get_image_layout_barrier(image, current_layout, new_layout, range, src_stage, dst_stage,
+			src_queue_family, dst_queue_family, src_access_mask_bits, dst_access_mask_bits);
+
 		VK_GET_SYMBOL(vkCmdPipelineBarrier)(cmd, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 	}
 
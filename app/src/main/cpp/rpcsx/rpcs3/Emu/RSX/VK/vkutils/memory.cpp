@@ -165,9 +165,24 @@ namespace vk
 		std::fill(stats.begin(), stats.end(), VmaBudget{});
 
 		VmaAllocatorCreateInfo allocatorInfo = {};
+		allocatorInfo.instance = dev.gpu();
 		allocatorInfo.physicalDevice = pdev;
 		allocatorInfo.device = dev;
 
+		// Without VK_EXT_memory_budget VMA reports 80% of the heap size as the budget and only counts its own allocations
+		VmaVulkanFunctions vulkan_functions = {};
+		if (dev.get_memory_budget_support())
+		{
+			vulkan_functions.vkGetPhysicalDeviceMemoryProperties2KHR = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(
+				VK_GET_SYMBOL(vkGetInstanceProcAddr)(dev.gpu(), "vkGetPhysicalDeviceMemoryProperties2KHR"));
+
+			if (vulkan_functions.vkGetPhysicalDeviceMemoryProperties2KHR)
+			{
+				allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+				allocatorInfo.pVulkanFunctions = &vulkan_functions;
+			}
+		}
+
 		std::vector<VkDeviceSize> heap_limits;
 		const auto vram_allocation_limit = g_cfg.video.vk.vram_allocation_limit * 0x100000ull;
 		if (vram_allocation_limit < dev.get_memory_mapping().device_local_total_bytes)
@@ -191,9 +206,59 @@ namespace vk
 
 	void mem_allocator_vma::destroy()
 	{
+		for (auto& pools : m_pools)
+		{
+			for (auto& pool : pools)
+			{
+				if (pool)
+				{
+					vmaDestroyPool(m_allocator, pool);
+					pool = VK_NULL_HANDLE;
+				}
+			}
+		}
+
 		vmaDestroyAllocator(m_allocator);
 	}
 
+	VmaPool mem_allocator_vma::get_pool(vmm_allocation_pool pool, u32 memory_type_index)
+	{
+		usage_class usage;
+		switch (pool)
+		{
+		case VMM_ALLOCATION_POOL_SURFACE_CACHE:
+		case VMM_ALLOCATION_POOL_SWAPCHAIN:
+			usage = usage_class::render_target;
+			break;
+		case VMM_ALLOCATION_POOL_TEXTURE_CACHE:
+			usage = usage_class::sampled_image;
+			break;
+		case VMM_ALLOCATION_POOL_SCRATCH:
+			usage = usage_class::scratch;
+			break;
+		default:
+			// Buffers and everything else stay in the default pools
+			return VK_NULL_HANDLE;
+		}
+
+		std::lock_guard lock(m_pool_lock);
+
+		auto& result = m_pools[static_cast<usz>(usage)][memory_type_index];
+		if (!result)
+		{
+			VmaPoolCreateInfo pool_info = {};
+			pool_info.memoryTypeIndex = memory_type_index;
+
+			if (vmaCreatePool(m_allocator, &pool_info, &result) != VK_SUCCESS)
+			{
+				rsx_log.warning("Failed to create VMA pool for memory type %u, falling back to the default pool", memory_type_index);
+				result = VK_NULL_HANDLE;
+			}
+		}
+
+		return result;
+	}
+
 	mem_allocator_vk::mem_handle_t mem_allocator_vma::alloc(u64 block_sz, u64 alignment, const memory_type_info& memory_type, vmm_allocation_pool pool, bool throw_on_fail)
 	{
 		VmaAllocation vma_alloc;
@@ -210,6 +275,7 @@ namespace vk
 				mem_req.alignment = alignment;
 				create_info.memoryTypeBits = 1u << memory_type_index;
 				create_info.flags = m_allocation_flags;
+				create_info.pool = get_pool(pool, memory_type_index);
 
 				error_code = vmaAllocateMemory(m_allocator, &mem_req, &create_info, &vma_alloc, nullptr);
 				if (error_code == VK_SUCCESS)
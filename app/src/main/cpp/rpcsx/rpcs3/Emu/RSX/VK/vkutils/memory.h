@@ -4,6 +4,8 @@
 #include "../../rsx_utils.h"
 #include "shared.h"
 
+#include "util/mutex.h"
+
 #include "3rdparty/GPUOpen/VulkanMemoryAllocator/src/vk_mem_alloc.h"
 
 namespace vk
@@ -101,8 +103,24 @@ namespace vk
 		void set_fastest_allocation_flags() override;
 
 	private:
+		// Allocations with different lifetimes are kept in separate blocks so that texture
+		// churn does not fragment the blocks holding long-lived render targets
+		enum class usage_class : u32
+		{
+			render_target = 0,
+			sampled_image,
+			scratch,
+
+			count
+		};
+
+		VmaPool get_pool(vmm_allocation_pool pool, u32 memory_type_index);
+
 		VmaAllocator m_allocator;
 		std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> stats;
+
+		shared_mutex m_pool_lock;
+		std::array<std::array<VmaPool, VK_MAX_MEMORY_TYPES>, static_cast<usz>(usage_class::count)> m_pools{};
 	};
 
 	// Memory Allocator - built-in Vulkan device memory allocate/free
@@ -1,4 +1,5 @@
 #include "Emu/RSX/VK/vkutils/instance.h"
+#include "descriptors.h"
 #include "memory.h"
 #include "sampler.h"
 #include "../../color_utils.h"
@@ -98,6 +99,7 @@ namespace vk
 
 	sampler::~sampler()
 	{
+		vk::descriptors::notify_sampler_destroyed(value);
 		VK_GET_SYMBOL(vkDestroySampler)(m_device, value, nullptr);
 		vmm_notify_object_freed(VMM_ALLOCATION_POOL_SAMPLER);
 	}
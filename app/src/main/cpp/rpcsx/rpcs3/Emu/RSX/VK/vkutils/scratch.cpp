@@ -120,8 +120,10 @@ namespace vk
 		return tex->get_view(rsx::default_remap_vector.with_encoding(VK_REMAP_IDENTITY));
 	}
 
-	vk::image* get_typeless_helper(VkFormat format, rsx::format_class format_class, u32 requested_width, u32 requested_height)
+	vk::image* get_typeless_helper(VkFormat format, rsx::format_class format_class, u32 requested_width, u32 requested_height, VkImageUsageFlags extra_usage)
 	{
+		VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | extra_usage;
+
 		auto create_texture = [&]()
 		{
 			u32 new_width = rx::alignUp(requested_width, 256u);
@@ -129,19 +131,20 @@ namespace vk
 
 			return new vk::image(*g_render_device, g_render_device->get_memory_mapping().device_local, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 				VK_IMAGE_TYPE_2D, format, new_width, new_height, 1, 1, 1, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
-				VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, 0, VMM_ALLOCATION_POOL_SCRATCH,
+				VK_IMAGE_TILING_OPTIMAL, usage, 0, VMM_ALLOCATION_POOL_SCRATCH,
 				format_class);
 		};
 
 		const u32 key = (format_class << 24u) | format;
 		auto& ptr = g_typeless_textures[key];
 
-		if (!ptr || ptr->width() < requested_width || ptr->height() < requested_height)
+		if (!ptr || ptr->width() < requested_width || ptr->height() < requested_height || (ptr->info.usage & usage) != usage)
 		{
 			if (ptr)
 			{
 				requested_width = std::max(requested_width, ptr->width());
 				requested_height = std::max(requested_height, ptr->height());
+				usage |= ptr->info.usage;
 				get_resource_manager()->dispose(ptr);
 			}
 
@@ -348,6 +348,7 @@ namespace vk
 #endif
 
 		_vkCreateSwapchainKHR(dev, &swap_info, nullptr, &m_vk_swapchain);
+		m_present_id = 0;
 
 		if (old_swapchain)
 		{
@@ -372,6 +373,15 @@ namespace vk
 		present.pSwapchains = &m_vk_swapchain;
 		present.pImageIndices = &image;
 
+		VkPresentIdKHR present_id = {};
+		if (dev.get_present_wait_support())
+		{
+			present_id.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+			present_id.swapchainCount = 1;
+			present_id.pPresentIds = &(++m_present_id);
+			present.pNext = &present_id;
+		}
+
 		if (semaphore != VK_NULL_HANDLE)
 		{
 			present.waitSemaphoreCount = 1;
@@ -380,4 +390,15 @@ namespace vk
 
 		return _vkQueuePresentKHR(dev.get_present_queue(), &present);
 	}
+
+	void swapchain_WSI::wait_for_present(u32 max_pending, u64 timeout)
+	{
+		if (!dev.get_present_wait_support() || m_present_id <= max_pending)
+		{
+			return;
+		}
+
+		// Timeouts and lost surfaces are not errors here, the next acquire reports those
+		dev._vkWaitForPresentKHR(dev, m_vk_swapchain, m_present_id - max_pending, timeout);
+	}
 } // namespace vk
@@ -63,6 +63,11 @@ namespace vk
 		virtual VkResult present(VkSemaphore semaphore, u32 index) = 0;
 		virtual VkImageLayout get_optimal_present_layout() const = 0;
 
+		// Block until no more than max_pending presents are waiting for the display
+		virtual void wait_for_present(u32 /*max_pending*/, u64 /*timeout*/)
+		{
+		}
+
 		virtual bool supports_automatic_wm_reports() const
 		{
 			return false;
@@ -177,6 +182,9 @@ namespace vk
 
 		bool m_wm_reports_flag = false;
 
+		// Ids handed to VK_KHR_present_id, restart with every swapchain
+		u64 m_present_id = 0;
+
 	protected:
 		void init_swapchain_images(render_device& dev, u32 preferred_count = 0) override;
 
@@ -210,6 +218,8 @@ namespace vk
 
 		VkResult present(VkSemaphore semaphore, u32 image) override;
 
+		void wait_for_present(u32 max_pending, u64 timeout) override;
+
 		VkImage get_image(u32 index) override
 		{
 			return swapchain_images[index].value;
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "rsx_utils.h"
 #include "rsx_methods.h"
+#include "Common/texture_cache_checker.h"
 #include "rpcsx/fw/ps3/cellVideoOut.h"
 
 #ifdef _MSC_VER
@@ -27,6 +28,41 @@ extern "C"
 namespace rsx
 {
 	atomic_t<u64> g_rsx_shared_tag{0};
+	dynamic_resolution_state g_dynamic_resolution{};
+
+	bool latch_dynamic_resolution(bool enabled)
+	{
+		// Every step drops the surface cache, so only move in coarse steps and not more than about once a second
+		constexpr u32 step_percent = 5;
+		constexpr u32 min_frames_between_changes = 60;
+
+		auto& state = g_dynamic_resolution;
+		state.frames_since_change++;
+		state.latched_shading_rate = std::min<u32>(state.requested_shading_rate.load(), 2);
+
+		u32 target = 100;
+		if (enabled)
+		{
+			const u32 min_percent = g_cfg.video.dynamic_resolution_min_scale;
+			target = std::clamp<u32>(state.requested_percent.load(), min_percent, 100);
+			target = std::max<u32>(((target + step_percent / 2) / step_percent) * step_percent, min_percent);
+		}
+
+		if (target == state.latched_percent)
+		{
+			return false;
+		}
+
+		if (enabled && state.frames_since_change < min_frames_between_changes)
+		{
+			return false;
+		}
+
+		rsx_log.notice("Dynamic resolution: render scale %u%% -> %u%%", state.latched_percent, target);
+		state.latched_percent = target;
+		state.frames_since_change = 0;
+		return true;
+	}
 
 	void convert_scale_image(u8* dst, AVPixelFormat dst_format, int dst_width, int dst_height, int dst_pitch,
 		const u8* src, AVPixelFormat src_format, int src_width, int src_height, int src_pitch, int src_slice_h, bool bilinear)
@@ -224,6 +260,9 @@ namespace rsx
 		return static_cast<areau>(static_cast<aread>(area1) * size2d{stretch_x, stretch_y}) + size2u{area2.x1, area2.y1};
 	}
 
+	tex_cache_page_index_t tex_cache_page_index = {};
+	tex_cache_write_heat_t tex_cache_write_heat = {};
+
 #ifdef TEXTURE_CACHE_DEBUG
 	tex_cache_checker_t tex_cache_checker = {};
 #endif
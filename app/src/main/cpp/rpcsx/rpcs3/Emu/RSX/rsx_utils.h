@@ -29,6 +29,25 @@ namespace rsx
 
 	extern atomic_t<u64> g_rsx_shared_tag;
 
+	// Dynamic resolution. The frontend requests a render scale (percent of the configured resolution scale),
+	// the renderer latches it on flip boundaries so that a frame never mixes surfaces of different scales.
+	struct dynamic_resolution_state
+	{
+		atomic_t<u32> requested_percent{100};
+		u32 latched_percent = 100;
+		u32 frames_since_change = 0;
+
+		// Coarse shading level (0 - off, 1 - 2x1, 2 - 2x2), the cheaper lever before the render scale drops.
+		// Latched together with the render scale, takes effect without rebuilding surfaces.
+		atomic_t<u32> requested_shading_rate{0};
+		u32 latched_shading_rate = 0;
+	};
+
+	extern dynamic_resolution_state g_dynamic_resolution;
+
+	// Returns true if the effective resolution scale changed. Must only be called by the renderer between frames.
+	bool latch_dynamic_resolution(bool enabled);
+
 	enum class problem_severity : u8
 	{
 		low,
@@ -590,14 +609,25 @@ namespace rsx
 		}
 	}
 
-	static inline f32 get_resolution_scale()
+	static inline int get_resolution_scale_percent()
 	{
-		return g_cfg.video.strict_rendering_mode ? 1.f : (g_cfg.video.resolution_scale_percent / 100.f);
+		if (g_cfg.video.strict_rendering_mode)
+		{
+			return 100;
+		}
+
+		const int configured = g_cfg.video.resolution_scale_percent;
+		if (g_dynamic_resolution.latched_percent == 100) [[likely]]
+		{
+			return configured;
+		}
+
+		return std::max<int>((configured * static_cast<int>(g_dynamic_resolution.latched_percent)) / 100, 1);
 	}
 
-	static inline int get_resolution_scale_percent()
+	static inline f32 get_resolution_scale()
 	{
-		return g_cfg.video.strict_rendering_mode ? 100 : g_cfg.video.resolution_scale_percent;
+		return get_resolution_scale_percent() / 100.f;
 	}
 
 	template <bool clamp = false>
@@ -98,6 +98,7 @@ extern bool ppu_load_rel_exec(const ppu_rel_object&);
 extern void send_close_home_menu_cmds();
 
 extern void signal_system_cache_can_stay();
+extern void lv2_timer_wake_up();
 
 fs::file make_file_view(const fs::file& file, u64 offset, u64 size);
 
@@ -1631,9 +1632,8 @@ game_boot_result Emulator::Load(const std::string& title_id, bool is_disc_patch,
 			// Initialize patch engine
 			g_fxo->need<patch_engine>();
 
-			// Load patches from different locations
-			g_fxo->get<patch_engine>().append_global_patches();
-			g_fxo->get<patch_engine>().append_title_patches(m_title_id);
+			// Load patches from different locations (compiled bundle is rebuilt when any of them changed)
+			g_fxo->get<patch_engine>().append_title_bundle(m_title_id);
 		}
 
 		if (g_use_rtm)
@@ -2934,6 +2934,9 @@ void Emulator::Resume()
 		rsx->state -= cpu_flag::dbg_global_pause;
 	}
 
+	// The timer thread sleeps without a deadline while paused
+	lv2_timer_wake_up();
+
 	GetCallbacks().on_resume();
 
 	sys_log.success("Emulation has been resumed!");
@@ -3682,6 +3685,8 @@ void Emulator::Kill(bool allow_autoexit, bool savestate, savestate_stage* save_s
 				}
 			}
 
+			vm::commit_snapshot(savestate ? path : std::string{});
+
 			// Log additional debug information - do not do it on the main thread due to the concern of halting UI events
 
 			if (g_tty && sys_log.notice)
@@ -4,6 +4,7 @@
 #include "VFS.h"
 
 #include "cellos/sys_fs.h"
+#include "dev/dirfd_dev.hpp"
 
 #include "util/mutex.h"
 #include "util/StrUtil.h"
@@ -14,6 +15,8 @@
 
 #include <thread>
 #include <map>
+#include <optional>
+#include <unordered_map>
 
 LOG_CHANNEL(vfs_log, "VFS");
 
@@ -26,12 +29,35 @@ struct vfs_directory
 	std::map<std::string, std::unique_ptr<vfs_directory>> dirs;
 };
 
+struct vfs_resolved_path
+{
+	std::string path;
+	std::optional<std::string> vpath;
+};
+
 struct vfs_manager
 {
 	shared_mutex mutex{};
 
 	// VFS root
 	vfs_directory root{};
+
+	// Results of vfs::get, only depend on the mount table
+	shared_mutex cache_mutex{};
+	std::unordered_map<std::string, vfs_resolved_path, fmt::string_hash, std::equal_to<>> resolved{};
+
+	// Bumped on every mount table change
+	atomic_t<u64> generation{0};
+
+	static constexpr usz max_resolved = 8192;
+
+	// Must be called with mutex locked for writing
+	void on_mount_changed()
+	{
+		std::lock_guard lock(cache_mutex);
+		resolved.clear();
+		generation++;
+	}
 };
 
 bool vfs::mount(std::string_view vpath, std::string_view path, bool is_dir)
@@ -52,6 +78,8 @@ bool vfs::mount(std::string_view vpath, std::string_view path, bool is_dir)
 
 	std::lock_guard lock(table.mutex);
 
+	table.on_mount_changed();
+
 	const std::string_view vpath_backup = vpath;
 
 	for (std::vector<vfs_directory*> list{&table.root};;)
@@ -80,6 +108,10 @@ bool vfs::mount(std::string_view vpath, std::string_view path, bool is_dir)
 			if (path == "/") // Special
 				list.back()->path = "/";
 
+			// Game content inside the directory handed over by the frontend is accessed through its descriptor
+			if (vpath_backup.starts_with("/dev_bdvd") || vpath_backup.starts_with("/dev_hdd0/game/"))
+				list.back()->path = dirfd_dev::map_path(list.back()->path);
+
 			vfs_log.notice("Mounted path \"%s\" to \"%s\"", vpath_backup, list.back()->path);
 			return true;
 		}
@@ -156,6 +188,8 @@ bool vfs::unmount(std::string_view vpath)
 
 	std::lock_guard lock(table.mutex);
 
+	table.on_mount_changed();
+
 	// Search entry recursively and remove it (including all children)
 	std::function<void(vfs_directory&, usz)> unmount_children;
 	unmount_children = [&entry_list, &unmount_children](vfs_directory& dir, usz depth) -> void
@@ -194,19 +228,8 @@ bool vfs::unmount(std::string_view vpath)
 	return true;
 }
 
-std::string vfs::get(std::string_view vpath, std::vector<std::string>* out_dir, std::string* out_path)
+static std::string get_uncached(const vfs_manager& table, std::string_view vpath, std::vector<std::string>* out_dir, std::string* out_path)
 {
-	// Just to make the code more robust.
-	// It should never happen because we take care to initialize Emu (and so also vfs_manager) with Emu.Init() before this function is invoked
-	if (!g_fxo->is_init<vfs_manager>())
-	{
-		fmt::throw_exception("vfs_manager not initialized");
-	}
-
-	auto& table = g_fxo->get<vfs_manager>();
-
-	reader_lock lock(table.mutex);
-
 	// Resulting path fragments: decoded ones
 	std::vector<std::string_view> result;
 	result.reserve(vpath.size() / 2);
@@ -375,6 +398,76 @@ std::string vfs::get(std::string_view vpath, std::vector<std::string>* out_dir,
 	return std::string{result_base} + fmt::merge(escaped, "/");
 }
 
+std::string vfs::get(std::string_view vpath, std::vector<std::string>* out_dir, std::string* out_path)
+{
+	// Just to make the code more robust.
+	// It should never happen because we take care to initialize Emu (and so also vfs_manager) with Emu.Init() before this function is invoked
+	if (!g_fxo->is_init<vfs_manager>())
+	{
+		fmt::throw_exception("vfs_manager not initialized");
+	}
+
+	auto& table = g_fxo->get<vfs_manager>();
+
+	reader_lock lock(table.mutex);
+
+	if (out_dir)
+	{
+		// Listing of mounted subdirectories is not cached
+		return get_uncached(table, vpath, out_dir, out_path);
+	}
+
+	{
+		reader_lock cache_lock(table.cache_mutex);
+
+		if (const auto found = table.resolved.find(vpath); found != table.resolved.end())
+		{
+			if (out_path && found->second.vpath)
+			{
+				*out_path = *found->second.vpath;
+			}
+
+			return found->second.path;
+		}
+	}
+
+	// Not a valid VFS path: stays as is if the path doesn't resolve
+	std::string resolved_vpath = "?";
+	std::string result = get_uncached(table, vpath, nullptr, &resolved_vpath);
+
+	vfs_resolved_path entry{result};
+
+	if (resolved_vpath != "?")
+	{
+		entry.vpath = resolved_vpath;
+
+		if (out_path)
+		{
+			*out_path = std::move(resolved_vpath);
+		}
+	}
+
+	std::lock_guard cache_lock(table.cache_mutex);
+
+	if (table.resolved.size() >= vfs_manager::max_resolved)
+	{
+		table.resolved.clear();
+	}
+
+	table.resolved.emplace(vpath, std::move(entry));
+	return result;
+}
+
+u64 vfs::get_generation()
+{
+	if (!g_fxo->is_init<vfs_manager>())
+	{
+		return 0;
+	}
+
+	return g_fxo->get<vfs_manager>().generation;
+}
+
 using char2 = char8_t;
 
 std::string vfs::retrieve(std::string_view path, const vfs_directory* node, std::vector<std::string_view>* mount_path)
@@ -411,6 +504,17 @@ std::string vfs::retrieve(std::string_view path, const vfs_directory* node, std:
 
 		mount_path_empty.clear();
 
+		// Mount points which were redirected by dirfd_dev
+		if (const std::string mapped = dirfd_dev::map_path(rpath.empty() ? path : rpath); mapped != (rpath.empty() ? path : std::string_view(rpath)))
+		{
+			if (std::string res = vfs::retrieve(mapped, &table.root, &mount_path_empty); !res.empty())
+			{
+				return res;
+			}
+
+			mount_path_empty.clear();
+		}
+
 		return vfs::retrieve(path, &table.root, &mount_path_empty);
 	}
 
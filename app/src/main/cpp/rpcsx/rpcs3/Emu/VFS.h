@@ -1,5 +1,7 @@
 #pragma once
 
+#include "util/types.hpp"
+
 #include <vector>
 #include <string>
 #include <string_view>
@@ -18,6 +20,9 @@ namespace vfs
 	// Convert VFS path to fs path, optionally listing directories mounted in it
 	std::string get(std::string_view vpath, std::vector<std::string>* out_dir = nullptr, std::string* out_path = nullptr);
 
+	// Get counter changed on every mount or unmount, for caches of resolved paths
+	u64 get_generation();
+
 	// Convert fs path to VFS path
 	std::string retrieve(std::string_view path, const vfs_directory* node = nullptr, std::vector<std::string_view>* mount_path = nullptr);
 
@@ -271,6 +271,7 @@ enum class localized_string_id
 	HOME_MENU_SAVESTATE_AND_EXIT,
 	HOME_MENU_RELOAD_SAVESTATE,
 	HOME_MENU_RECORDING,
+	HOME_MENU_PROFILER_REPORT,
 	HOME_MENU_TROPHIES,
 	HOME_MENU_TROPHY_LIST_TITLE,
 	HOME_MENU_TROPHY_LOCKED_TITLE,
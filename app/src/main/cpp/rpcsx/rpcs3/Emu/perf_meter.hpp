@@ -4,6 +4,7 @@
 #include "util/logs.hpp"
 #include "rx/tsc.hpp"
 #include "system_config.h"
+#include "perf_trace.hpp"
 #include <array>
 #include <cmath>
 
@@ -84,9 +85,33 @@ public:
 template <auto ShortName, auto... SubEvents>
 class perf_meter
 {
+	template <auto SN, auto... S>
+	friend class perf_meter;
+
 	// Initialize array (possibly only 1 element) with timestamp
 	u64 m_timestamps[1 + sizeof...(SubEvents)];
 
+	// A system trace section was opened on this thread and is owned by this counter
+	bool m_traced = false;
+
+	FORCE_INLINE void trace_begin() noexcept
+	{
+		if (perf_trace::is_enabled(perf_trace::category::cpu)) [[unlikely]]
+		{
+			perf_trace::begin(perf_name<ShortName>.data());
+			m_traced = true;
+		}
+	}
+
+	FORCE_INLINE void trace_end() noexcept
+	{
+		if (m_traced) [[unlikely]]
+		{
+			perf_trace::end();
+			m_traced = false;
+		}
+	}
+
 public:
 	FORCE_INLINE SAFE_BUFFERS() perf_meter() noexcept
 	{
@@ -103,12 +128,30 @@ public:
 		return m_timestamps[0] != 0;
 	}
 
+	// Copy all timestamps, the trace section stays owned by the original
+	FORCE_INLINE SAFE_BUFFERS() perf_meter(const perf_meter& r) noexcept
+	{
+		std::memcpy(m_timestamps, r.m_timestamps, sizeof(m_timestamps));
+	}
+
+	SAFE_BUFFERS(perf_meter&)
+	operator=(const perf_meter& r) noexcept
+	{
+		std::memcpy(m_timestamps, r.m_timestamps, sizeof(m_timestamps));
+		return *this;
+	}
+
 	// Copy first timestamp
 	template <auto SN, auto... S>
 	FORCE_INLINE SAFE_BUFFERS() perf_meter(const perf_meter<SN, S...>& r) noexcept
 	{
 		m_timestamps[0] = r.get();
 		std::memset(m_timestamps + 1, 0, sizeof(m_timestamps) - sizeof(u64));
+
+		if (m_timestamps[0])
+		{
+			trace_begin();
+		}
 	}
 
 	template <auto SN, auto... S>
@@ -116,6 +159,7 @@ public:
 	perf_meter(perf_meter<SN, S...>&& r) noexcept
 	{
 		m_timestamps[0] = r.get();
+		m_traced = std::exchange(r.m_traced, false);
 		r.reset();
 	}
 
@@ -132,7 +176,9 @@ public:
 	SAFE_BUFFERS(perf_meter&)
 	operator=(perf_meter<SN, S...>& r) noexcept
 	{
+		trace_end();
 		m_timestamps[0] = r.get();
+		m_traced = std::exchange(r.m_traced, false);
 		r.reset();
 		return *this;
 	}
@@ -165,18 +211,23 @@ public:
 	FORCE_INLINE SAFE_BUFFERS(void) reset() noexcept
 	{
 		m_timestamps[0] = 0;
+		trace_end();
 	}
 
 	// Re-initialize first timestamp
 	FORCE_INLINE SAFE_BUFFERS(void) restart() noexcept
 	{
+		trace_end();
 		m_timestamps[0] = rx::get_tsc();
 		std::memset(m_timestamps + 1, 0, sizeof(m_timestamps) - sizeof(u64));
+		trace_begin();
 	}
 
 	SAFE_BUFFERS()
 	~perf_meter()
 	{
+		trace_end();
+
 		// Disabled counter
 		if (!m_timestamps[0]) [[unlikely]]
 		{
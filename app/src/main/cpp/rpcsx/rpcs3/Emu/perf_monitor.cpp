@@ -2,12 +2,116 @@
 #include "perf_monitor.hpp"
 
 #include "Emu/System.h"
+#include "Emu/IdManager.h"
+#include "Emu/system_config.h"
 #include "Emu/Cell/timers.hpp"
+#include "Emu/Cell/PPUThread.h"
+#include "Emu/Cell/SPUThread.h"
+#include "Emu/Cell/SPULoadBalancer.h"
+#include "Emu/RSX/RSXThread.h"
+#include "Input/virtual_pad_handler.h"
 #include "util/cpu_stats.hpp"
+#include "util/mutex.h"
 #include "util/Thread.h"
 
+#ifdef ANDROID
+#include <pthread.h>
+#endif
+
 LOG_CHANNEL(perf_log, "PERF");
 
+namespace
+{
+	shared_mutex g_hw_counters_mutex;
+	std::array<utils::hw_counter_values, static_cast<usz>(perf_thread_class::count)> g_hw_counters{};
+	bool g_hw_counters_valid = false;
+
+	u64 get_kernel_tid(u64 native_id)
+	{
+#ifdef ANDROID
+		if (const pid_t tid = native_id ? pthread_gettid_np(reinterpret_cast<pthread_t>(native_id)) : 0; tid > 0)
+		{
+			return tid;
+		}
+#endif
+		return 0;
+	}
+
+	// Per thread class hardware counters of emulator threads
+	struct hw_counter_sampler
+	{
+		utils::hw_thread_counters counters;
+		std::vector<u64> tids;
+		std::vector<perf_thread_class> classes;
+		std::vector<utils::hw_counter_values> deltas;
+
+		void add(perf_thread_class type, u64 native_id)
+		{
+			if (const u64 tid = get_kernel_tid(native_id))
+			{
+				tids.push_back(tid);
+				classes.push_back(type);
+			}
+		}
+
+		bool update()
+		{
+			tids.clear();
+			classes.clear();
+
+			idm::select<named_thread<ppu_thread>>([&](u32, named_thread<ppu_thread>& ppu)
+				{
+					add(perf_thread_class::ppu, thread_ctrl::get_native_id(ppu));
+				});
+
+			idm::select<named_thread<spu_thread>>([&](u32, named_thread<spu_thread>& spu)
+				{
+					add(perf_thread_class::spu, thread_ctrl::get_native_id(spu));
+				});
+
+			if (const auto render = rsx::get_current_renderer())
+			{
+				add(perf_thread_class::rsx, render->get_native_thread_id());
+			}
+
+			if (!counters.sample(tids, deltas))
+			{
+				return false;
+			}
+
+			std::array<utils::hw_counter_values, static_cast<usz>(perf_thread_class::count)> totals{};
+			for (usz i = 0; i < tids.size(); i++)
+			{
+				totals[static_cast<usz>(classes[i])] += deltas[i];
+			}
+
+			std::lock_guard lock(g_hw_counters_mutex);
+			g_hw_counters = totals;
+			g_hw_counters_valid = true;
+			return true;
+		}
+	};
+
+	void invalidate_hw_counters()
+	{
+		std::lock_guard lock(g_hw_counters_mutex);
+		g_hw_counters_valid = false;
+	}
+}
+
+bool perf_monitor::get_hw_counters(perf_thread_class type, utils::hw_counter_values& out)
+{
+	reader_lock lock(g_hw_counters_mutex);
+
+	if (!g_hw_counters_valid || type >= perf_thread_class::count)
+	{
+		return false;
+	}
+
+	out = g_hw_counters[static_cast<usz>(type)];
+	return true;
+}
+
 void perf_monitor::operator()()
 {
 	constexpr u64 update_interval_us = 1000000; // Update every second
@@ -17,6 +121,11 @@ void perf_monitor::operator()()
 	utils::cpu_stats stats;
 	stats.init_cpu_query();
 
+	spu_load_balancer spu_balancer;
+
+	// Opened on first use and closed once disabled, the groups hold one fd per counter and thread
+	std::unique_ptr<hw_counter_sampler> hw_sampler;
+
 	u32 logged_pause = 0;
 	u64 last_pause_time = umax;
 
@@ -37,6 +146,29 @@ void perf_monitor::operator()()
 
 		stats.get_per_core_usage(per_core_usage, total_usage);
 
+		if (!Emu.IsPaused())
+		{
+			spu_balancer.update(stats);
+		}
+
+		if (g_cfg.core.hw_counters && !Emu.IsPaused())
+		{
+			if (!hw_sampler)
+			{
+				hw_sampler = std::make_unique<hw_counter_sampler>();
+			}
+
+			if (hw_sampler->counters.is_supported() && !hw_sampler->update())
+			{
+				invalidate_hw_counters();
+			}
+		}
+		else if (hw_sampler)
+		{
+			hw_sampler.reset();
+			invalidate_hw_counters();
+		}
+
 		if (elapsed_us >= log_interval_us)
 		{
 			elapsed_us = 0;
@@ -76,6 +208,24 @@ void perf_monitor::operator()()
 				fmt::append(msg, "%s %.1f%%", i > 0 ? "," : "", per_core_usage[i]);
 			}
 
+			if (u64 avg_latency, max_latency; virtual_pad_handler::take_latency_stats(avg_latency, max_latency))
+			{
+				fmt::append(msg, ", Input latency: avg %.2fms, max %.2fms", avg_latency / 1000., max_latency / 1000.);
+			}
+
+			// Last interval only: low IPC with high miss rates means the threads are memory-bound
+			for (const auto [type, name] : {std::pair{perf_thread_class::ppu, "PPU"}, std::pair{perf_thread_class::spu, "SPU"}, std::pair{perf_thread_class::rsx, "RSX"}})
+			{
+				using utils::hw_counter;
+
+				if (utils::hw_counter_values values; get_hw_counters(type, values) && values[hw_counter::cycles])
+				{
+					fmt::append(msg, ", %s: IPC %.2f, L1D %.1f, L2 %.1f, BR %.1f MPKI", name, values.ipc(),
+						values.per_kilo_instruction(hw_counter::l1d_misses), values.per_kilo_instruction(hw_counter::l2_misses),
+						values.per_kilo_instruction(hw_counter::branch_misses));
+				}
+			}
+
 			perf_log.notice("%s", msg);
 		}
 	}
@@ -83,4 +233,5 @@ void perf_monitor::operator()()
 
 perf_monitor::~perf_monitor()
 {
+	invalidate_hw_counters();
 }
@@ -1,12 +1,27 @@
 #pragma once
 
+#include "util/hw_counters.hpp"
+
 #include <string_view>
 using namespace std::literals;
 
+enum class perf_thread_class : u8
+{
+	ppu,
+	spu,
+	rsx,
+
+	count
+};
+
 struct perf_monitor
 {
 	void operator()();
 	~perf_monitor();
 
+	// Hardware counters of the last update interval, summed over the threads of a class.
+	// Returns false unless "Hardware Performance Counters" is enabled and the kernel allows them.
+	static bool get_hw_counters(perf_thread_class type, utils::hw_counter_values& out);
+
 	static constexpr auto thread_name = "Performance Sensor"sv;
 };
@@ -0,0 +1,76 @@
+#include "stdafx.h"
+#include "perf_trace.hpp"
+
+#ifdef ANDROID
+#include "util/dyn_lib.hpp"
+
+// Resolved at runtime: the async and counter entries only exist since API 29
+DYNAMIC_IMPORT_RENAME("libandroid.so", atrace_is_enabled, "ATrace_isEnabled", bool());
+DYNAMIC_IMPORT_RENAME("libandroid.so", atrace_begin_section, "ATrace_beginSection", void(const char*));
+DYNAMIC_IMPORT_RENAME("libandroid.so", atrace_end_section, "ATrace_endSection", void());
+DYNAMIC_IMPORT_RENAME("libandroid.so", atrace_begin_async_section, "ATrace_beginAsyncSection", void(const char*, s32));
+DYNAMIC_IMPORT_RENAME("libandroid.so", atrace_end_async_section, "ATrace_endAsyncSection", void(const char*, s32));
+DYNAMIC_IMPORT_RENAME("libandroid.so", atrace_set_counter, "ATrace_setCounter", void(const char*, s64));
+#endif
+
+namespace perf_trace
+{
+	bool is_recording() noexcept
+	{
+#ifdef ANDROID
+		return atrace_is_enabled && atrace_is_enabled();
+#else
+		return false;
+#endif
+	}
+
+	void begin([[maybe_unused]] const char* name) noexcept
+	{
+#ifdef ANDROID
+		if (atrace_begin_section)
+		{
+			atrace_begin_section(name);
+		}
+#endif
+	}
+
+	void end() noexcept
+	{
+#ifdef ANDROID
+		if (atrace_end_section)
+		{
+			atrace_end_section();
+		}
+#endif
+	}
+
+	void begin_async([[maybe_unused]] const char* name, [[maybe_unused]] s32 cookie) noexcept
+	{
+#ifdef ANDROID
+		if (atrace_begin_async_section)
+		{
+			atrace_begin_async_section(name, cookie);
+		}
+#endif
+	}
+
+	void end_async([[maybe_unused]] const char* name, [[maybe_unused]] s32 cookie) noexcept
+	{
+#ifdef ANDROID
+		if (atrace_end_async_section)
+		{
+			atrace_end_async_section(name, cookie);
+		}
+#endif
+	}
+
+	void counter([[maybe_unused]] const char* name, [[maybe_unused]] s64 value) noexcept
+	{
+#ifdef ANDROID
+		if (atrace_set_counter)
+		{
+			atrace_set_counter(name, value);
+		}
+#endif
+	}
+} // namespace perf_trace
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "util/types.hpp"
+#include "system_config.h"
+
+// Android system trace (ATrace) markers, recorded by Perfetto and systrace
+// through the atrace data source while a session captures the app. Markers of
+// a category are only emitted when it is set in the "Trace Categories" mask,
+// which can be changed while the game is running
+namespace perf_trace
+{
+	enum class category : u32
+	{
+		cpu = 1u << 0,    // perf_meter scopes (PPU/SPU threads, memory manager, codecs)
+		rsx = 1u << 1,    // RSX FIFO processing
+		vk = 1u << 2,     // VKGSRender submit and present
+		shader = 1u << 3, // Pipeline compile workers
+		audio = 1u << 4,  // cellAudio mixing and backend callbacks
+		gpu = 1u << 5,    // GPU busy time counters from Vulkan timestamps
+	};
+
+	// A trace session currently records this process
+	bool is_recording() noexcept;
+
+	inline bool is_enabled(category cat) noexcept
+	{
+		return (g_cfg.core.trace_categories & static_cast<u32>(cat)) && is_recording();
+	}
+
+	// Must be ended on the same thread, in reverse order
+	void begin(const char* name) noexcept;
+	void end() noexcept;
+
+	// May end on another thread, cookie tells apart concurrent spans of the same name
+	void begin_async(const char* name, s32 cookie) noexcept;
+	void end_async(const char* name, s32 cookie) noexcept;
+
+	void counter(const char* name, s64 value) noexcept;
+
+	// Marks the enclosing block
+	class scope
+	{
+		bool m_active;
+
+	public:
+		scope(category cat, const char* name) noexcept
+			: m_active(is_enabled(cat))
+		{
+			if (m_active)
+			{
+				begin(name);
+			}
+		}
+
+		scope(const scope&) = delete;
+
+		scope& operator=(const scope&) = delete;
+
+		~scope()
+		{
+			if (m_active)
+			{
+				end();
+			}
+		}
+	};
+} // namespace perf_trace
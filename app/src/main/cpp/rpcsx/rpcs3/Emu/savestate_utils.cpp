@@ -48,7 +48,7 @@ static std::array<serial_ver_t, 27> s_serial_versions;
 		return ::s_serial_versions[identifier].current_version; \
 	}
 
-SERIALIZATION_VER(global_version, 0, 19) // For stuff not listed here
+SERIALIZATION_VER(global_version, 0, 19, 20 /*Incremental memory images*/) // For stuff not listed here
 SERIALIZATION_VER(ppu, 1, 1, 2 /*PPU sleep order*/, 3 /*PPU FNID and module*/)
 SERIALIZATION_VER(spu, 2, 1)
 SERIALIZATION_VER(lv2_sync, 3, 1)
@@ -32,7 +32,9 @@ struct cfg_root : cfg::node
 				return std::thread::hardware_concurrency() * 2;
 			}};
 		cfg::_bool ppu_llvm_greedy_mode{this, "PPU LLVM Greedy Mode", false, false};
+		cfg::_bool ppu_llvm_inline_leaves{this, "PPU LLVM Inline Leaf Functions", true, false}; // Translate tiny leaf functions in place of direct calls
 		cfg::_bool llvm_precompilation{this, "LLVM Precompilation", true};
+		cfg::_bool firmware_image_cache{this, "Firmware Image Cache", true}; // Map decrypted firmware SPRX images from a per-firmware pack instead of decrypting them every boot
 		cfg::_enum<thread_scheduler_mode> thread_scheduler{this, "Thread Scheduler Mode", thread_scheduler_mode::os};
 		cfg::_bool set_daz_and_ftz{this, "Set DAZ and FTZ", false};
 		cfg::_enum<spu_decoder_type> spu_decoder{this, "SPU Decoder", spu_decoder_type::llvm};
@@ -49,6 +51,7 @@ struct cfg_root : cfg::node
 		cfg::_bool spu_accurate_dma{this, "Accurate SPU DMA", false};
 		cfg::_bool spu_accurate_reservations{this, "Accurate SPU Reservations", true};
 		cfg::_bool accurate_cache_line_stores{this, "Accurate Cache Line Stores", false};
+		cfg::_bool guest_huge_pages{this, "Guest Memory Huge Pages", false}; // Back main memory and VRAM with transparent huge pages
 		cfg::_bool rsx_accurate_res_access{this, "Accurate RSX reservation access", false, true};
 
 #ifdef ANDROID
@@ -65,6 +68,8 @@ struct cfg_root : cfg::node
 			cfg::_enum<thread_class> cpu6{this, "CPU6", thread_class::general, true};
 			cfg::_enum<thread_class> cpu7{this, "CPU7", thread_class::general, true};
 		} affinity{this};
+
+		cfg::_bool spu_load_balancing{this, "SPU Load Balancing", true, true}; // Move SPU threads between big and little cores by load
 #endif
 
 		struct fifo_setting : public cfg::_enum<rsx_fifo_mode>
@@ -79,9 +84,13 @@ struct cfg_root : cfg::node
 		};
 
 		fifo_setting rsx_fifo_accuracy{this, "RSX FIFO Accuracy", rsx_fifo_mode::fast};
+		cfg::_bool rsx_fifo_lookahead{this, "RSX FIFO Lookahead", false}; // Decode the FIFO ahead of the RSX thread on a helper thread, fast FIFO mode only
 		cfg::_bool spu_verification{this, "SPU Verification", true}; // Should be enabled
 		cfg::_bool spu_cache{this, "SPU Cache", true};
+		cfg::_bool spu_lock_ls{this, "Lock SPU Local Storage", false}; // mlock LS pages so reclaim never stalls an SPU on a page-in
 		cfg::_bool spu_prof{this, "SPU Profiler", false};
+		cfg::_bool ppu_prof{this, "PPU Profiler", false}; // Sample guest addresses of PPU threads, attributed to module functions
+		cfg::_bool hw_counters{this, "Hardware Performance Counters", false, true}; // IPC and cache misses of emulator threads via perf_event_open
 		cfg::uint<0, 16> mfc_transfers_shuffling{this, "MFC Commands Shuffling Limit", 0};
 		cfg::uint<0, 10000> mfc_transfers_timeout{this, "MFC Commands Timeout", 0, true};
 		cfg::_bool mfc_shuffling_in_steps{this, "MFC Commands Shuffling In Steps", false, true};
@@ -91,6 +100,7 @@ struct cfg_root : cfg::node
 		cfg::_int<-64, 64> stub_ppu_traps{this, "Stub PPU Traps", 0, true};                                                       // Hack, skip PPU traps for rare cases where the trap is continueable (specify relative instructions to skip)
 		cfg::_bool precise_spu_verification{this, "Precise SPU Verification", false};                                             // Disables use of xorsum based spu verification if enabled.
 		cfg::_bool ppu_llvm_nj_fixup{this, "PPU LLVM Java Mode Handling", true};                                                  // Partially respect current Java Mode for alti-vec ops by PPU LLVM
+		cfg::_bool ppu_llvm_nj_host_fpcr{this, "PPU LLVM Java Mode via Host FPCR", false};                                        // ARM64: mirror NJ in FPCR.FZ instead of masking every vector result. Also flushes scalar denormals.
 		cfg::_bool use_accurate_dfma{this, "Use Accurate DFMA", true};                                                            // Enable accurate double-precision FMA for CPUs which do not support it natively
 		cfg::_bool ppu_set_sat_bit{this, "PPU Set Saturation Bit", false};                                                        // Accuracy. If unset, completely disable saturation flag handling.
 		cfg::_bool ppu_use_nj_bit{this, "PPU Accurate Non-Java Mode", false};                                                     // Accuracy. If set, accurately emulate NJ flag. Implies NJ fixup.
@@ -121,6 +131,7 @@ struct cfg_root : cfg::node
 
 		cfg::uint64 perf_report_threshold{this, "Performance Report Threshold", 500, true}; // In µs, 0.5ms = default, 0 = everything
 		cfg::_bool perf_report{this, "Enable Performance Report", false, true};             // Show certain perf-related logs
+		cfg::uint<0, (1 << 6) - 1> trace_categories{this, "Trace Categories", 0, true};      // perf_trace::category mask of system trace markers
 		cfg::_bool external_debugger{this, "Assume External Debugger"};
 	} core{this};
 
@@ -134,6 +145,8 @@ struct cfg_root : cfg::node
 		cfg::_bool limit_cache_size{this, "Limit disk cache size", false};
 		cfg::_int<0, 10240> cache_max_size{this, "Disk cache maximum size (MB)", 5120};
 		cfg::_bool empty_hdd0_tmp{this, "Empty /dev_hdd0/tmp/", true};
+		cfg::_bool file_readahead{this, "Asynchronous File Read-Ahead", true, true}; // Prefetch sequentially read files on a background thread
+		cfg::_bool boot_io_prefetch{this, "Boot I/O Prefetch", true}; // Record file reads at boot and prefetch them on the next boot
 
 	} vfs{this};
 
@@ -152,8 +165,16 @@ struct cfg_root : cfg::node
 		cfg::_enum<frame_limit_type> frame_limit{this, "Frame limit", frame_limit_type::_auto, true};
 		cfg::_float<0, 1000> second_frame_limit{this, "Second Frame Limit", 0, true}; // 0 disables its effect
 		cfg::_enum<msaa_level> antialiasing_level{this, "MSAA", msaa_level::_auto};
+#ifdef ANDROID
+		// Frame pacing over throughput: draw through the interpreter while pipelines compile
+		cfg::_enum<shader_mode> shadermode{this, "Shader Mode", shader_mode::async_with_interpreter};
+#else
 		cfg::_enum<shader_mode> shadermode{this, "Shader Mode", shader_mode::async_recompiler};
+#endif
 		cfg::_enum<gpu_preset_level> shader_precision{this, "Shader Precision", gpu_preset_level::high};
+#ifdef ANDROID
+		cfg::_bool hw_video_decoding{this, "Hardware Video Decoding", true}; // cellVdec H.264/MPEG-2 through MediaCodec
+#endif
 
 		cfg::_bool write_color_buffers{this, "Write Color Buffers"};
 		cfg::_bool write_depth_buffer{this, "Write Depth Buffer"};
@@ -180,7 +201,9 @@ struct cfg_root : cfg::node
 		cfg::_bool full_rgb_range_output{this, "Use full RGB output range", true, true}; // Video out dynamic range
 		cfg::_bool strict_texture_flushing{this, "Strict Texture Flushing", false};
 		cfg::_bool multithreaded_rsx{this, "Multithreaded RSX", false};
+		cfg::_int<1, 8> rsx_offload_threads{this, "RSX Offload Threads", 1};
 		cfg::_bool relaxed_zcull_sync{this, "Relaxed ZCULL Sync", false};
+		cfg::_bool speculative_zcull_reports{this, "Speculative ZCULL Reports", false, true};
 		cfg::_bool force_hw_MSAA_resolve{this, "Force Hardware MSAA Resolve", false, true};
 		cfg::_enum<stereo_render_mode_options> stereo_render_mode{this, "3D Display Mode", stereo_render_mode_options::disabled};
 		cfg::_bool debug_program_analyser{this, "Debug Program Analyser", false};
@@ -201,6 +224,7 @@ struct cfg_root : cfg::node
 		cfg::_bool disable_msl_fast_math{this, "Disable MSL Fast Math", false};
 		cfg::_bool disable_async_host_memory_manager{this, "Disable Asynchronous Memory Manager", false, true};
 		cfg::_enum<output_scaling_mode> output_scaling{this, "Output Scaling Mode", output_scaling_mode::bilinear, true};
+		cfg::uint<50, 100> dynamic_resolution_min_scale{this, "Dynamic Resolution Minimum Scale", 50, true}; // Lower bound for frontend-driven render scale, temporal upscaling only
 
 		struct node_vk : cfg::node
 		{
@@ -214,6 +238,16 @@ struct cfg_root : cfg::node
 			cfg::uint<0, 100> rcas_sharpening_intensity{this, "FidelityFX CAS Sharpening Intensity", 50, true};
 			cfg::_enum<vk_gpu_scheduler_mode> asynchronous_scheduler{this, "Asynchronous Queue Scheduler", vk_gpu_scheduler_mode::safe};
 			cfg::uint<256, 65536> vram_allocation_limit{this, "VRAM allocation limit (MB)", 65536, false};
+			cfg::_bool graphics_pipeline_library{this, "Use Graphics Pipeline Library", true};
+			cfg::_bool temporal_upscaling_async_compute{this, "Temporal Upscaling on Async Compute", true, true};
+			cfg::_bool bindless_textures{this, "Bindless Textures", false}; // Fragment textures through one descriptor-indexed array, needs VK_EXT_descriptor_indexing
+			cfg::_bool present_wait_pacing{this, "Present Wait Frame Pacing", true}; // Keep at most one present queued ahead of the display, needs VK_KHR_present_wait
+			cfg::_bool frame_generation{this, "Frame Generation", false, true}; // Present an interpolated frame between flips of titles running at half the display rate or less
+			cfg::_bool fragment_shading_rate{this, "Variable Rate Shading", false}; // Coarse shading requested by the frontend (DRS), needs VK_KHR_fragment_shading_rate
+			cfg::_bool dxt1_astc_transcode{this, "Transcode DXT1 to ASTC", true}; // Keep DXT1 compressed on GPUs without BC formats, needs textureCompressionASTC_LDR
+			cfg::_bool texture_upload_dedup{this, "Deduplicate Texture Uploads", false}; // Copy textures whose guest data matches a resident one instead of uploading them
+			cfg::uint<1, 3> frames_in_flight{this, "Frames In Flight", 2}; // Frames RSX FIFO processing may run ahead of GPU execution and present
+			cfg::_bool pipeline_cache_probe{this, "Probe Driver Pipeline Cache", true}; // Async shader modes take driver cache hits inline, needs VK_EXT_pipeline_creation_cache_control
 #ifdef ANDROID
 			struct driver : cfg::node
 			{
@@ -262,6 +296,7 @@ struct cfg_root : cfg::node
 			cfg::string background_body{this, "Body Background (hex)", "#002339FF", true};
 			cfg::string color_title{this, "Title Color (hex)", "#F26C24FF", true};
 			cfg::string background_title{this, "Title Background (hex)", "#00000000", true};
+			cfg::_bool gpu_cost_breakdown{this, "Show GPU Pass Breakdown", false, true}; // Timestamps around every render pass and compute dispatch (Vulkan)
 
 		} perf_overlay{this};
 
@@ -374,6 +409,7 @@ struct cfg_root : cfg::node
 		cfg::_bool compatible_mode{this, "Compatible Savestate Mode", false};    // SPU emulation optimized for savestate compatibility (off by default for performance reasons)
 		cfg::_bool state_inspection_mode{this, "Inspection Mode Savestates"};    // Save memory stored in executable files, thus allowing to view state without any files (for debugging)
 		cfg::_bool save_disc_game_data{this, "Save Disc Game Data", false};
+		cfg::_bool incremental{this, "Incremental Savestates", false};           // Store only memory pages changed since the last full savestate (not with Suspend Emulation)
 	} savestate{this};
 
 	struct node_misc : cfg::node
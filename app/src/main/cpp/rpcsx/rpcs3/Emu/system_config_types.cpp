@@ -116,6 +116,9 @@ void fmt_class_string<audio_renderer>::format(std::string& out, u64 arg)
 			case audio_renderer::cubeb: return "Cubeb";
 #ifdef HAVE_FAUDIO
 			case audio_renderer::faudio: return "FAudio";
+#endif
+#ifdef __ANDROID__
+			case audio_renderer::aaudio: return "AAudio";
 #endif
 			}
 
@@ -695,6 +698,7 @@ void fmt_class_string<output_scaling_mode>::format(std::string& out, u64 arg)
 			case output_scaling_mode::nearest: return "Nearest";
 			case output_scaling_mode::bilinear: return "Bilinear";
 			case output_scaling_mode::fsr: return "FidelityFX Super Resolution";
+			case output_scaling_mode::temporal: return "Temporal Upscaling";
 			}
 
 			return unknown;
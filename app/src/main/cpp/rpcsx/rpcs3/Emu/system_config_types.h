@@ -59,6 +59,9 @@ enum class audio_renderer
 #ifdef HAVE_FAUDIO
 	faudio,
 #endif
+#ifdef __ANDROID__
+	aaudio,
+#endif
 };
 
 enum class audio_provider
@@ -331,7 +334,8 @@ enum class output_scaling_mode
 {
 	nearest,
 	bilinear,
-	fsr
+	fsr,
+	temporal
 };
 
 enum class stereo_render_mode_options
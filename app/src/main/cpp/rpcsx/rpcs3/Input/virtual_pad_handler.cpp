@@ -1,12 +1,147 @@
 #include "virtual_pad_handler.h"
 #include "pad_thread.h"
 #include "Emu/Io/pad_config.h"
+#include "Emu/Cell/timers.hpp"
+#include "rx/asm.hpp"
+
+#include <mutex>
 
 virtual_pad_handler::on_connect_cb virtual_pad_handler::mOnConnect = [](auto...)
 {
 	return false;
 };
 
+namespace
+{
+	// Seqlock: odd sequence while the writer updates the words
+	struct virtual_pad_shared_state
+	{
+		std::mutex writer_mutex;
+		atomic_t<u64> seq{0};
+		atomic_t<u64> buttons{0}; // digital1 | digital2 << 16 | left stick << 32
+		atomic_t<u64> right_stick{0x0080'0080};
+		atomic_t<u64> timestamp{0};
+
+		u64 latched_seq = 0; // Only touched by the reader under pad::g_pad_mutex
+
+		atomic_t<u64> latency_sum{0};
+		atomic_t<u64> latency_count{0};
+		atomic_t<u64> latency_max{0};
+	};
+
+	virtual_pad_shared_state& get_shared_state()
+	{
+		static virtual_pad_shared_state state;
+		return state;
+	}
+} // namespace
+
+void virtual_pad_handler::push_state(const virtual_pad_state& state)
+{
+	auto& shared = get_shared_state();
+	std::lock_guard lock(shared.writer_mutex);
+
+	const u64 seq = shared.seq.load();
+	shared.seq.release(seq + 1);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	shared.buttons.release(u64{state.digital1} | u64{state.digital2} << 16 | u64{state.sticks[0]} << 32 | u64{state.sticks[1]} << 48);
+	shared.right_stick.release(u64{state.sticks[2]} | u64{state.sticks[3]} << 16);
+	shared.timestamp.release(state.timestamp);
+
+	shared.seq.release(seq + 2);
+}
+
+void virtual_pad_handler::latch(Pad& pad)
+{
+	auto& shared = get_shared_state();
+
+	u64 seq;
+	u64 buttons;
+	u64 right_stick;
+	u64 timestamp;
+
+	while (true)
+	{
+		seq = shared.seq.load();
+
+		if (seq & 1)
+		{
+			rx::pause();
+			continue;
+		}
+
+		buttons = shared.buttons.observe();
+		right_stick = shared.right_stick.observe();
+		timestamp = shared.timestamp.observe();
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (shared.seq.observe() == seq)
+		{
+			break;
+		}
+	}
+
+	if (seq == shared.latched_seq)
+	{
+		return;
+	}
+
+	shared.latched_seq = seq;
+
+	const u16 digital1 = static_cast<u16>(buttons);
+	const u16 digital2 = static_cast<u16>(buttons >> 16);
+
+	for (Button& btn : pad.m_buttons)
+	{
+		if (btn.m_offset == CELL_PAD_BTN_OFFSET_DIGITAL1)
+		{
+			btn.m_pressed = (digital1 & btn.m_outKeyCode) != 0;
+		}
+		else if (btn.m_offset == CELL_PAD_BTN_OFFSET_DIGITAL2)
+		{
+			btn.m_pressed = (digital2 & btn.m_outKeyCode) != 0;
+		}
+
+		btn.m_value = btn.m_pressed ? 255 : 0;
+	}
+
+	pad.m_sticks[0].m_value = static_cast<u16>(buttons >> 32);
+	pad.m_sticks[1].m_value = static_cast<u16>(buttons >> 48);
+	pad.m_sticks[2].m_value = static_cast<u16>(right_stick);
+	pad.m_sticks[3].m_value = static_cast<u16>(right_stick >> 16);
+
+	if (timestamp)
+	{
+		const u64 now = get_system_time();
+		const u64 latency = now > timestamp ? now - timestamp : 0;
+
+		shared.latency_sum += latency;
+		shared.latency_count++;
+		shared.latency_max.fetch_op([latency](u64& value)
+			{
+				value = std::max(value, latency);
+			});
+	}
+}
+
+bool virtual_pad_handler::take_latency_stats(u64& avg_us, u64& max_us)
+{
+	auto& shared = get_shared_state();
+
+	const u64 count = shared.latency_count.exchange(0);
+	const u64 sum = shared.latency_sum.exchange(0);
+	max_us = shared.latency_max.exchange(0);
+
+	if (!count)
+	{
+		return false;
+	}
+
+	avg_us = sum / count;
+	return true;
+}
+
 virtual_pad_handler::virtual_pad_handler()
 	: PadHandlerBase(pad_handler::virtual_pad)
 {
@@ -2,6 +2,15 @@
 
 #include "Emu/Io/PadHandler.h"
 
+// Overlay state as reported by the frontend input event
+struct virtual_pad_state
+{
+	u16 digital1 = 0;
+	u16 digital2 = 0;
+	u16 sticks[4]{128, 128, 128, 128};
+	u64 timestamp = 0; // get_system_time() of the event
+};
+
 class virtual_pad_handler final : public PadHandlerBase
 {
 	using on_connect_cb = std::function<bool(const std::shared_ptr<Pad>&)>;
@@ -15,6 +24,16 @@ public:
 		mOnConnect = std::move(cb);
 	}
 
+	// Publish the latest state, called from the input event thread.
+	// The state is latched by the pad when the guest reads it instead of going through the pad thread
+	static void push_state(const virtual_pad_state& state);
+
+	// Apply the latest published state to the pad, doesn't lock against the writer
+	static void latch(Pad& pad);
+
+	// Average and maximum event to latch latency since the previous call, false if nothing was latched
+	static bool take_latency_stats(u64& avg_us, u64& max_us);
+
 	bool Init() override
 	{
 		return true;
@@ -285,7 +285,16 @@ namespace psf
 
 	load_result_t load(const std::string& filename)
 	{
-		return load(fs::file(filename), filename);
+		fs::file file(filename);
+
+		// Parse from memory instead of a seek and a read per entry, PARAM.SFO
+		// is small but may live on slow storage
+		if (file && file.size() <= 0x100000)
+		{
+			return load(fs::make_stream(file.to_vector<u8>()), filename);
+		}
+
+		return load(file, filename);
 	}
 
 	std::vector<u8> save_object(const psf::registry& psf, std::vector<u8>&& init)
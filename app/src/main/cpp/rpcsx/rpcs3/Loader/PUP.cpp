@@ -5,6 +5,8 @@
 
 #include "PUP.h"
 
+fs::file make_file_view(const fs::file& file, u64 offset, u64 size);
+
 pup_object::pup_object(fs::file&& file) : m_file(std::move(file))
 {
 	if (!m_file)
@@ -79,6 +81,21 @@ fs::file pup_object::get_file(u64 entry_id) const
 	return {};
 }
 
+fs::file pup_object::get_file_view(u64 entry_id) const
+{
+	if (m_error != pup_error::ok) return {};
+
+	for (const PUPFileEntry& file_entry : m_file_tbl)
+	{
+		if (file_entry.entry_id == entry_id)
+		{
+			return make_file_view(m_file, file_entry.data_offset, file_entry.data_length);
+		}
+	}
+
+	return {};
+}
+
 pup_error pup_object::validate_hashes()
 {
 	AUDIT(m_error == pup_error::ok);
@@ -65,4 +65,7 @@ public:
 	const std::string& get_formatted_error() const { return m_formatted_error; }
 
 	fs::file get_file(u64 entry_id) const;
+
+	// Read-only view of the entry inside the PUP, nothing is copied into memory
+	fs::file get_file_view(u64 entry_id) const;
 };
@@ -200,6 +200,32 @@ std::unique_ptr<utils::serial> tar_object::get_file(const std::string& path, std
 	return m_out;
 }
 
+fs::file tar_object::get_file_view(const std::string& path)
+{
+	if (!m_file)
+	{
+		return {};
+	}
+
+	auto it = m_map.find(path);
+
+	if (it == m_map.end())
+	{
+		// Scan up to the entry
+		get_file(path);
+		it = m_map.find(path);
+	}
+
+	if (it == m_map.end())
+	{
+		return {};
+	}
+
+	u64 size = 0;
+	std::memcpy(&size, it->second.second.size, sizeof(size));
+	return make_file_view(*m_file, it->second.first, size);
+}
+
 bool tar_object::extract(const std::string& prefix_path, bool is_vfs)
 {
 	std::vector<std::vector<u8>> filedata_buffers;
@@ -51,6 +51,10 @@ public:
 
 	std::unique_ptr<utils::serial> get_file(const std::string& path, std::string* new_file_path = nullptr);
 
+	// Read-only view of an entry of a file-backed archive (empty for streams or unknown paths).
+	// Views read with read_at and may be used from other threads while the archive is alive.
+	fs::file get_file_view(const std::string& path);
+
 	using process_func = std::function<bool(const fs::file&, std::string&, utils::serial&)>;
 
 	// Extract all files in archive to destination (as VFS if is_vfs is true)
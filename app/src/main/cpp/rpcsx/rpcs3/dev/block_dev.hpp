@@ -1,8 +1,13 @@
 #pragma once
 
 #include "util/File.h"
+#include "util/vm.hpp"
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <utility>
+#include <vector>
 
 class block_dev
 {
@@ -31,6 +36,47 @@ public:
 	virtual std::size_t write(std::size_t blockIndex, const void* data,
 		std::size_t blockCount) = 0;
 
+	// Read arbitrary byte range, returns count of bytes read
+	virtual std::size_t read_bytes(std::uint64_t offset, void* data, std::size_t size)
+	{
+		const std::size_t bsize = block_size();
+		auto out = static_cast<std::byte*>(data);
+		std::vector<std::byte> bounce(bsize);
+		std::size_t done = 0;
+
+		while (done < size)
+		{
+			const std::uint64_t pos = offset + done;
+			const std::size_t in_block = pos % bsize;
+			const std::size_t count = std::min<std::size_t>(bsize - in_block, size - done);
+
+			if (in_block == 0 && count == bsize)
+			{
+				// Aligned middle part goes straight to the output
+				const std::size_t blocks = (size - done) / bsize;
+				const std::size_t read_blocks = read(pos / bsize, out + done, blocks);
+				done += read_blocks * bsize;
+
+				if (read_blocks != blocks)
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			if (read(pos / bsize, bounce.data(), 1) != 1)
+			{
+				break;
+			}
+
+			std::memcpy(out + done, bounce.data() + in_block, count);
+			done += count;
+		}
+
+		return done;
+	}
+
 protected:
 	void set_block_info(std::size_t size, std::size_t count)
 	{
@@ -39,23 +85,55 @@ protected:
 	}
 };
 
+// Maps the whole image read-only when the host allows it, falls back to pread
 class file_block_dev final : public block_dev
 {
 	fs::file m_file;
+	const std::byte* m_view = nullptr;
+	std::size_t m_view_size = 0;
 
 public:
 	explicit file_block_dev(fs::file file, std::size_t blockSize = 2048)
 		: m_file(std::move(file))
 	{
 		set_block_info(blockSize, m_file.size() / blockSize);
+
+		if (const std::size_t size = m_file.size())
+		{
+			m_view = static_cast<const std::byte*>(utils::memory_map_fd(m_file.get_handle(), size, utils::protection::ro));
+			m_view_size = m_view ? size : 0;
+		}
+	}
+
+	file_block_dev(const file_block_dev&) = delete;
+	file_block_dev& operator=(const file_block_dev&) = delete;
+
+	~file_block_dev() override
+	{
+		unmap();
 	}
 
 	std::size_t read(std::size_t blockIndex, void* data,
 		std::size_t blockCount) override
 	{
-		auto result = m_file.read_at(block_size() * blockIndex, data,
-			blockCount * block_size());
-		return result / block_size();
+		return read_bytes(block_size() * blockIndex, data, blockCount * block_size()) / block_size();
+	}
+
+	std::size_t read_bytes(std::uint64_t offset, void* data, std::size_t size) override
+	{
+		if (m_view)
+		{
+			if (offset >= m_view_size)
+			{
+				return 0;
+			}
+
+			size = std::min<std::uint64_t>(size, m_view_size - offset);
+			std::memcpy(data, m_view + offset, size);
+			return size;
+		}
+
+		return m_file.read_at(offset, data, size);
 	}
 
 	std::size_t write(std::size_t blockIndex, const void* data,
@@ -72,8 +150,20 @@ public:
 	}
 	fs::file release()
 	{
+		unmap();
 		return std::exchange(m_file, {});
 	}
+
+private:
+	void unmap()
+	{
+		if (m_view)
+		{
+			utils::memory_release(const_cast<std::byte*>(m_view), m_view_size);
+			m_view = nullptr;
+			m_view_size = 0;
+		}
+	}
 };
 
 class file_view_block_dev final : public block_dev
@@ -96,6 +186,11 @@ public:
 		return result / block_size();
 	}
 
+	std::size_t read_bytes(std::uint64_t offset, void* data, std::size_t size) override
+	{
+		return m_file->read_at(offset, data, size);
+	}
+
 	std::size_t write(std::size_t blockIndex, const void* data,
 		std::size_t blockCount) override
 	{
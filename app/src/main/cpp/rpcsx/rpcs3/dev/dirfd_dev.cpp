@@ -0,0 +1,378 @@
+#include "dirfd_dev.hpp"
+#include "util/mutex.h"
+#include "util/types.hpp"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <mutex>
+
+#ifndef _WIN32
+
+static fs::error to_error(int e)
+{
+	switch (e)
+	{
+	case ENOENT: return fs::error::noent;
+	case EEXIST: return fs::error::exist;
+	case EINVAL: return fs::error::inval;
+	case EACCES: return fs::error::acces;
+	case EPERM: return fs::error::acces;
+	case ENOTEMPTY: return fs::error::notempty;
+	case EROFS: return fs::error::readonly;
+	case EISDIR: return fs::error::isdir;
+	case ENOSPC: return fs::error::nospace;
+	case EXDEV: return fs::error::xdev;
+	case ENAMETOOLONG: return fs::error::toolong;
+	default: return fs::error::unknown;
+	}
+}
+
+// Device path to a path relative to the directory descriptor
+static std::string to_relative(std::string_view path)
+{
+	while (!path.empty() && (path.front() == '/' || path.front() == '\\'))
+	{
+		path.remove_prefix(1);
+	}
+
+	return path.empty() ? std::string(".") : std::string(path);
+}
+
+static void to_fs_stat(const struct ::stat& file_info, fs::stat_t& info)
+{
+	info.is_directory = S_ISDIR(file_info.st_mode);
+	info.is_symlink = S_ISLNK(file_info.st_mode);
+	info.is_writable = file_info.st_mode & 0200; // HACK: approximation
+	info.size = file_info.st_size;
+	info.atime = file_info.st_atime;
+	info.mtime = file_info.st_mtime;
+	info.ctime = info.mtime;
+
+	if (info.atime < info.mtime)
+		info.atime = info.mtime;
+}
+
+dirfd_dev::dirfd_dev(int dirfd)
+	: m_dirfd(dirfd)
+{
+}
+
+dirfd_dev::~dirfd_dev()
+{
+	::close(m_dirfd);
+}
+
+bool dirfd_dev::stat(const std::string& path, fs::stat_t& info)
+{
+	info = {};
+
+	struct ::stat file_info;
+	if (::fstatat(m_dirfd, to_relative(path).c_str(), &file_info, 0) != 0)
+	{
+		fs::g_tls_error = to_error(errno);
+		return false;
+	}
+
+	to_fs_stat(file_info, info);
+	return true;
+}
+
+bool dirfd_dev::statfs(const std::string&, fs::device_stat& info)
+{
+	struct ::statvfs buf;
+	if (::fstatvfs(m_dirfd, &buf) != 0)
+	{
+		fs::g_tls_error = to_error(errno);
+		return false;
+	}
+
+	info.block_size = buf.f_frsize;
+	info.total_size = info.block_size * buf.f_blocks;
+	info.total_free = info.block_size * buf.f_bfree;
+	info.avail_free = info.block_size * buf.f_bavail;
+	return true;
+}
+
+bool dirfd_dev::remove_dir(const std::string& path)
+{
+	if (::unlinkat(m_dirfd, to_relative(path).c_str(), AT_REMOVEDIR) != 0)
+	{
+		fs::g_tls_error = to_error(errno);
+		return false;
+	}
+
+	return true;
+}
+
+bool dirfd_dev::create_dir(const std::string& path)
+{
+	if (::mkdirat(m_dirfd, to_relative(path).c_str(), S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) != 0)
+	{
+		fs::g_tls_error = to_error(errno);
+		return false;
+	}
+
+	return true;
+}
+
+bool dirfd_dev::rename(const std::string& from, const std::string& to)
+{
+	if (::renameat(m_dirfd, to_relative(from).c_str(), m_dirfd, to_relative(to).c_str()) != 0)
+	{
+		fs::g_tls_error = to_error(errno);
+		return false;
+	}
+
+	return true;
+}
+
+bool dirfd_dev::remove(const std::string& path)
+{
+	if (::unlinkat(m_dirfd, to_relative(path).c_str(), 0) != 0)
+	{
+		fs::g_tls_error = to_error(errno);
+		return false;
+	}
+
+	return true;
+}
+
+bool dirfd_dev::trunc(const std::string& path, u64 length)
+{
+	const int fd = ::openat(m_dirfd, to_relative(path).c_str(), O_WRONLY | O_CLOEXEC);
+
+	if (fd == -1 || ::ftruncate(fd, length) != 0)
+	{
+		fs::g_tls_error = to_error(errno);
+
+		if (fd != -1)
+		{
+			::close(fd);
+		}
+
+		return false;
+	}
+
+	::close(fd);
+	return true;
+}
+
+bool dirfd_dev::utime(const std::string& path, s64 atime, s64 mtime)
+{
+	const struct ::timespec times[2]{{.tv_sec = static_cast<time_t>(atime)}, {.tv_sec = static_cast<time_t>(mtime)}};
+
+	if (::utimensat(m_dirfd, to_relative(path).c_str(), times, 0) != 0)
+	{
+		fs::g_tls_error = to_error(errno);
+		return false;
+	}
+
+	return true;
+}
+
+std::unique_ptr<fs::file_base> dirfd_dev::open(const std::string& path, rx::EnumBitSet<fs::open_mode> mode)
+{
+	int flags = O_CLOEXEC;
+
+	if (mode & fs::read && mode & fs::write)
+		flags |= O_RDWR;
+	else if (mode & fs::read)
+		flags |= O_RDONLY;
+	else if (mode & fs::write)
+		flags |= O_WRONLY;
+
+	if (mode & fs::append)
+		flags |= O_APPEND;
+	if (mode & fs::create)
+		flags |= O_CREAT;
+	if (mode & fs::trunc && !(mode & fs::lock))
+		flags |= O_TRUNC;
+	if (mode & fs::excl)
+		flags |= O_EXCL;
+
+	const int fd = ::openat(m_dirfd, to_relative(path).c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+	if (fd == -1)
+	{
+		fs::g_tls_error = to_error(errno);
+		return {};
+	}
+
+	if (mode & fs::write && mode & fs::lock && ::flock(fd, LOCK_EX | LOCK_NB) != 0)
+	{
+		fs::g_tls_error = errno == EWOULDBLOCK ? fs::error::acces : to_error(errno);
+		::close(fd);
+		return {};
+	}
+
+	if (mode & fs::trunc && mode & fs::lock && mode & fs::write)
+	{
+		// Postpone truncation in order to avoid using O_TRUNC on a locked file
+		ensure(::ftruncate(fd, 0) == 0);
+	}
+
+	fs::file file = fs::file::from_native_handle(fd);
+
+	if (mode & fs::isfile && !(mode & fs::write) && file.get_stat().is_directory)
+	{
+		fs::g_tls_error = fs::error::isdir;
+		return {};
+	}
+
+	return file.release();
+}
+
+std::unique_ptr<fs::dir_base> dirfd_dev::open_dir(const std::string& path)
+{
+	const int fd = ::openat(m_dirfd, to_relative(path).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		fs::g_tls_error = to_error(errno);
+		return {};
+	}
+
+	::DIR* const ptr = ::fdopendir(fd);
+
+	if (!ptr)
+	{
+		fs::g_tls_error = to_error(errno);
+		::close(fd);
+		return {};
+	}
+
+	class unix_dir final : public fs::dir_base
+	{
+		::DIR* m_dd;
+
+	public:
+		unix_dir(::DIR* dd)
+			: m_dd(dd)
+		{
+		}
+
+		unix_dir(const unix_dir&) = delete;
+
+		unix_dir& operator=(const unix_dir&) = delete;
+
+		~unix_dir() override
+		{
+			::closedir(m_dd);
+		}
+
+		bool read(fs::dir_entry& info) override
+		{
+			while (const auto found = ::readdir(m_dd))
+			{
+				struct ::stat file_info;
+
+				if (::fstatat(::dirfd(m_dd), found->d_name, &file_info, 0) != 0)
+				{
+					// failed metadata (broken symlink?), ignore and skip to next file
+					continue;
+				}
+
+				info.name = found->d_name;
+				to_fs_stat(file_info, info);
+				return true;
+			}
+
+			return false;
+		}
+
+		void rewind() override
+		{
+			::rewinddir(m_dd);
+		}
+	};
+
+	return std::make_unique<unix_dir>(ptr);
+}
+
+#endif
+
+namespace
+{
+	struct dirfd_root
+	{
+		shared_mutex mutex;
+		std::string host_root; // Ends with '/'
+		shared_ptr<dirfd_dev> device;
+	};
+
+	dirfd_root& get_root()
+	{
+		static dirfd_root root;
+		return root;
+	}
+} // namespace
+
+bool dirfd_dev::set_root([[maybe_unused]] std::string_view host_root, [[maybe_unused]] int fd)
+{
+	auto& root = get_root();
+	std::lock_guard lock(root.mutex);
+
+	if (root.device)
+	{
+		fs::set_virtual_device(root.device->fs_prefix, null_ptr);
+		root.device.reset();
+		root.host_root.clear();
+	}
+
+#ifdef _WIN32
+	return false;
+#else
+	if (fd < 0 || host_root.empty())
+	{
+		return fd < 0;
+	}
+
+	const int dirfd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+
+	if (dirfd == -1)
+	{
+		fs::g_tls_error = to_error(errno);
+		return false;
+	}
+
+	auto device = stx::make_shared<dirfd_dev>(dirfd);
+
+	if (!fs::set_virtual_device(device->fs_prefix, device))
+	{
+		return false;
+	}
+
+	root.host_root = host_root;
+
+	if (!root.host_root.ends_with('/'))
+	{
+		root.host_root += '/';
+	}
+
+	root.device = std::move(device);
+	return true;
+#endif
+}
+
+std::string dirfd_dev::map_path(std::string_view host_path)
+{
+	auto& root = get_root();
+	reader_lock lock(root.mutex);
+
+	if (!root.device || !(host_path.starts_with(root.host_root) || host_path == std::string_view(root.host_root).substr(0, root.host_root.size() - 1)))
+	{
+		return std::string(host_path);
+	}
+
+	host_path.remove_prefix(std::min(host_path.size(), root.host_root.size()));
+	return root.device->fs_prefix + '/' + std::string(host_path);
+}
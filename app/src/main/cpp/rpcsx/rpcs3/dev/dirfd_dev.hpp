@@ -0,0 +1,39 @@
+#pragma once
+
+#include "util/File.h"
+#include <string>
+#include <string_view>
+
+// Serves a host directory through an already open directory descriptor, all
+// accesses are done with *at() calls relative to it. On Android the descriptor
+// is handed over by the Java side (SAF tree or shared storage directory), so
+// the path walk through the FUSE daemon is done once instead of on every open
+class dirfd_dev final : public fs::device_base
+{
+	int m_dirfd;
+
+public:
+	// Takes ownership of the descriptor
+	explicit dirfd_dev(int dirfd);
+	dirfd_dev(const dirfd_dev&) = delete;
+	dirfd_dev& operator=(const dirfd_dev&) = delete;
+	~dirfd_dev() override;
+
+	bool stat(const std::string& path, fs::stat_t& info) override;
+	bool statfs(const std::string& path, fs::device_stat& info) override;
+	bool remove_dir(const std::string& path) override;
+	bool create_dir(const std::string& path) override;
+	bool rename(const std::string& from, const std::string& to) override;
+	bool remove(const std::string& path) override;
+	bool trunc(const std::string& path, u64 length) override;
+	bool utime(const std::string& path, s64 atime, s64 mtime) override;
+	std::unique_ptr<fs::file_base> open(const std::string& path, rx::EnumBitSet<fs::open_mode> mode) override;
+	std::unique_ptr<fs::dir_base> open_dir(const std::string& path) override;
+
+	// Serve host_root through a duplicate of fd, replaces the previous root.
+	// Negative fd removes the root
+	static bool set_root(std::string_view host_root, int fd);
+
+	// Get device path for the host path if it is inside the root, or the path as is
+	static std::string map_path(std::string_view host_path);
+};
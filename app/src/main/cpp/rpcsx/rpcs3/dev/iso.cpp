@@ -1,16 +1,21 @@
 
 #include "iso.hpp"
 #include "util/File.h"
+#include "util/StrFmt.h"
+#include "util/fnv_hash.hpp"
 #include "util/types.hpp"
+#include <algorithm>
 #include <bit>
 #include <cctype>
 #include <codecvt>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <memory>
 #include <string>
+#include <unordered_set>
 
 static std::string u16_ne_to_string(const char16_t* bytes, std::size_t count)
 {
@@ -43,6 +48,35 @@ static std::string u16_be_to_string(const char16_t* bytes, std::size_t count)
 	}
 }
 
+// Index key of the path: lowercase, no leading, trailing or repeated separators
+static std::string normalize_path(std::string_view path)
+{
+	std::string result;
+	result.reserve(path.size());
+
+	for (char c : path)
+	{
+		if (c == '/' || c == '\\')
+		{
+			if (!result.empty() && result.back() != '/')
+			{
+				result += '/';
+			}
+
+			continue;
+		}
+
+		result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+
+	if (!result.empty() && result.back() == '/')
+	{
+		result.pop_back();
+	}
+
+	return result;
+}
+
 static std::string decodeString(std::string_view data,
 	iso::StringEncoding encoding)
 {
@@ -111,26 +145,126 @@ bool iso_dev::initialize()
 	m_encoding = supplementaryVolume ? iso::StringEncoding::utf16_be : iso::StringEncoding::ascii;
 	m_root_dir = pvd.root;
 
+	m_volume_block.resize(sizeof(pvd));
+	std::memcpy(m_volume_block.data(), &pvd, sizeof(pvd));
+
 	return true;
 }
 
+// Reads file contents from the image on demand
+class iso_file final : public fs::file_base
+{
+	std::shared_ptr<block_dev> m_dev;
+	std::vector<iso::Extent> m_extents;
+	fs::stat_t m_stat;
+	u64 m_pos = 0;
+
+public:
+	iso_file(std::shared_ptr<block_dev> dev, const iso::IndexEntry& entry)
+		: m_dev(std::move(dev)), m_extents(entry.extents), m_stat(entry.to_fs_stat())
+	{
+		m_stat.is_writable = false;
+	}
+
+	fs::stat_t get_stat() override
+	{
+		return m_stat;
+	}
+
+	bool trunc(u64) override
+	{
+		return false;
+	}
+
+	u64 read(void* buffer, u64 size) override
+	{
+		const u64 result = read_at(m_pos, buffer, size);
+		m_pos += result;
+		return result;
+	}
+
+	u64 read_at(u64 offset, void* buffer, u64 size) override
+	{
+		if (offset >= m_stat.size)
+		{
+			return 0;
+		}
+
+		size = std::min<u64>(size, m_stat.size - offset);
+
+		auto out = static_cast<u8*>(buffer);
+		u64 extent_start = 0;
+		u64 done = 0;
+
+		for (const auto& extent : m_extents)
+		{
+			const u64 extent_end = extent_start + extent.length;
+
+			if (offset + done < extent_end)
+			{
+				const u64 in_extent = offset + done - extent_start;
+				const u64 count = std::min<u64>(extent.length - in_extent, size - done);
+				const u64 read = m_dev->read_bytes(u64{extent.lba} * m_dev->block_size() + in_extent, out + done, count);
+				done += read;
+
+				if (read != count || done == size)
+				{
+					break;
+				}
+			}
+
+			extent_start = extent_end;
+		}
+
+		return done;
+	}
+
+	u64 write(const void*, u64) override
+	{
+		return 0;
+	}
+
+	u64 seek(s64 offset, fs::seek_mode whence) override
+	{
+		const s64 new_pos =
+			whence == fs::seek_set ? offset :
+			whence == fs::seek_cur ? offset + m_pos :
+			whence == fs::seek_end ? offset + m_stat.size :
+									 -1;
+
+		if (new_pos < 0)
+		{
+			fs::g_tls_error = fs::error::inval;
+			return -1;
+		}
+
+		m_pos = new_pos;
+		return m_pos;
+	}
+
+	u64 size() override
+	{
+		return m_stat.size;
+	}
+};
+
 bool iso_dev::stat(const std::string& path, fs::stat_t& info)
 {
-	auto optEntry = open_entry(path);
-	if (!optEntry)
+	auto entry = open_entry(path);
+	if (!entry)
 	{
 		fs::g_tls_error = fs::error::noent;
 		return false;
 	}
 
-	info = optEntry->to_fs_stat();
+	info = entry->to_fs_stat();
 	return true;
 }
 
 bool iso_dev::statfs(const std::string& path, fs::device_stat& info)
 {
-	auto optEntry = open_entry(path);
-	if (!optEntry)
+	auto entry = open_entry(path);
+	if (!entry)
 	{
 		fs::g_tls_error = fs::error::noent;
 		return false;
@@ -154,123 +288,72 @@ std::unique_ptr<fs::file_base> iso_dev::open(const std::string& path, rx::EnumBi
 		return {};
 	}
 
-	auto optEntry = open_entry(path);
-	if (!optEntry)
+	auto entry = open_entry(path);
+	if (!entry)
 	{
 		fs::g_tls_error = fs::error::noent;
 		return {};
 	}
 
-	if ((optEntry->flags & iso::DirEntryFlags::Directory) == iso::DirEntryFlags::Directory)
+	if (entry->is_directory())
 	{
 		fs::g_tls_error = fs::error::isdir;
 		return {};
 	}
 
-	return read_file(*optEntry).release();
+	return std::make_unique<iso_file>(m_dev, *entry);
 }
 
 std::unique_ptr<fs::dir_base> iso_dev::open_dir(const std::string& path)
 {
-	auto optEntry = open_entry(path);
-	if (!optEntry)
+	auto entry = open_entry(path);
+	if (!entry)
 	{
 		fs::g_tls_error = fs::error::noent;
 		return {};
 	}
 
-	if ((optEntry->flags & iso::DirEntryFlags::Directory) != iso::DirEntryFlags::Directory)
+	if (!entry->is_directory())
 	{
 		fs::g_tls_error = fs::error::exist;
 		return {};
 	}
 
-	auto items = read_dir(*optEntry);
-	std::vector<fs::dir_entry> result_items(items.first.size());
+	const std::string key = normalize_path(path);
+	const auto sep = key.find_last_of('/');
+	const auto parent = open_entry(sep == std::string::npos ? std::string_view{} : std::string_view(key).substr(0, sep));
 
-	for (std::size_t i = 0; i < result_items.size(); ++i)
+	std::vector<fs::dir_entry> result_items;
+	result_items.reserve(entry->children.size() + 2);
+	result_items.emplace_back(entry->to_fs_entry("."));
+	result_items.emplace_back((parent ? parent : entry)->to_fs_entry(".."));
+
+	for (const auto& name : entry->children)
 	{
-		result_items[i] = items.first[i].to_fs_entry(items.second[i]);
+		if (const auto child = open_entry(key + '/' + name))
+		{
+			result_items.emplace_back(child->to_fs_entry(name));
+		}
 	}
 
 	return std::make_unique<fs::virtual_dir>(std::move(result_items));
 }
 
-std::optional<iso::DirEntry>
-iso_dev::open_entry(std::string_view path)
+const iso::IndexEntry* iso_dev::open_entry(std::string_view path)
 {
-	if (path == "/" || path == "\\" || path.empty())
-	{
-		return m_root_dir;
-	}
-
-	auto item = m_root_dir;
-
-	auto isStringEqNoCase = [](std::string_view lhs, std::string_view rhs)
-	{
-		if (lhs.size() != rhs.size())
+	std::call_once(m_index->once, [this]
 		{
-			return false;
-		}
-
-		for (std::size_t i = 0; i < lhs.size(); ++i)
-		{
-			if (std::tolower(lhs[i]) != std::tolower(rhs[i]))
-			{
-				return false;
-			}
-		}
+			build_index();
+		});
 
-		return true;
-	};
+	const auto found = m_index->entries.find(normalize_path(path));
 
-	while (!path.empty())
+	if (found == m_index->entries.end())
 	{
-		auto sepPos = path.find_first_of("/\\");
-		if (sepPos == 0)
-		{
-			path.remove_prefix(1);
-			continue;
-		}
-
-		if ((item.flags & iso::DirEntryFlags::Directory) !=
-			iso::DirEntryFlags::Directory)
-		{
-			return {};
-		}
-
-		auto dirName = path.substr(0, sepPos);
-		if (sepPos == std::string_view::npos)
-		{
-			path = {};
-		}
-		else
-		{
-			path.remove_prefix(sepPos);
-		}
-
-		auto items = read_dir(item);
-
-		bool found = false;
-		for (std::size_t i = 0; i < items.first.size(); ++i)
-		{
-			if (!isStringEqNoCase(items.second[i], dirName))
-			{
-				continue;
-			}
-
-			item = items.first[i];
-			found = true;
-			break;
-		}
-
-		if (!found)
-		{
-			return {};
-		}
+		return nullptr;
 	}
 
-	return item;
+	return &found->second;
 }
 
 std::pair<std::vector<iso::DirEntry>, std::vector<std::string>>
@@ -365,29 +448,255 @@ iso_dev::read_dir(const iso::DirEntry& entry)
 	return {std::move(isoEntries), std::move(names)};
 }
 
-fs::file iso_dev::read_file(const iso::DirEntry& entry)
+void iso_dev::build_index()
 {
-	if ((entry.flags & iso::DirEntryFlags::Directory) ==
-		iso::DirEntryFlags::Directory)
+	const std::string cache_path = get_index_path();
+
+	if (load_index(cache_path))
 	{
-		return {};
+		return;
+	}
+
+	auto& entries = m_index->entries;
+	entries.clear();
+
+	auto& root = entries[""];
+	root.entry = m_root_dir;
+	root.size = m_root_dir.length.value();
+	root.extents = {{m_root_dir.lba.value(), m_root_dir.length.value()}};
+
+	std::vector<std::string> work_list{""};
+	std::unordered_set<u32> visited_dirs{m_root_dir.lba.value()};
+
+	while (!work_list.empty())
+	{
+		const std::string dir_key = std::move(work_list.back());
+		work_list.pop_back();
+
+		auto items = read_dir(entries.at(dir_key).entry);
+		std::vector<std::string> children;
+
+		iso::IndexEntry* last = nullptr;
+		std::string last_key;
+
+		for (std::size_t i = 0; i < items.first.size(); ++i)
+		{
+			const auto& item = items.first[i];
+			const auto& name = items.second[i];
+
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			std::string key = normalize_path(dir_key + '/' + name);
+			const iso::Extent extent{item.lba.value(), item.length.value()};
+
+			// Next part of the previous multi extent file
+			if (last && key == last_key &&
+				(last->entry.flags & iso::DirEntryFlags::MultiExtent) != iso::DirEntryFlags::None)
+			{
+				last->entry.flags = item.flags;
+				last->size += extent.length;
+				last->extents.push_back(extent);
+				continue;
+			}
+
+			auto [it, inserted] = entries.try_emplace(key);
+			last = nullptr;
+
+			if (!inserted)
+			{
+				// Names that only differ in case, the first one wins
+				continue;
+			}
+
+			it->second.entry = item;
+			it->second.size = extent.length;
+			it->second.extents.push_back(extent);
+			children.push_back(name);
+
+			if (it->second.is_directory() && visited_dirs.insert(extent.lba).second)
+			{
+				work_list.push_back(key);
+			}
+
+			last = &it->second;
+			last_key = std::move(key);
+		}
+
+		entries.at(dir_key).children = std::move(children);
 	}
 
-	if (entry.length.value() == 0)
+	save_index(cache_path);
+}
+
+namespace
+{
+	struct index_header
 	{
-		return fs::make_stream<std::vector<std::uint8_t>>();
+		u32 magic = "ISOI"_u32;
+		u32 version = 1;
+		u64 image_size;
+		u64 entry_count;
+	};
+} // namespace
+
+std::string iso_dev::get_index_path() const
+{
+	usz hash = rpcs3::hash64(rpcs3::fnv_seed, u64{m_dev->size()});
+
+	for (std::byte b : m_volume_block)
+	{
+		hash = rpcs3::hash64(hash, static_cast<u8>(b));
 	}
 
-	auto block_size = m_dev->block_size();
-	auto block_count = (entry.length.value() + block_size - 1) / block_size;
+	return fs::get_cache_dir() + fmt::format("iso/%016llx.idx", hash);
+}
 
-	std::vector<std::uint8_t> data;
-	data.resize(block_count * block_size);
-	if (!m_dev->read(entry.lba.value(), data.data(), block_count))
+bool iso_dev::load_index(const std::string& path)
+{
+	fs::file file(path);
+
+	if (!file)
 	{
-		return {};
+		return false;
+	}
+
+	const std::vector<u8> data = file.to_vector<u8>();
+	usz pos = 0;
+
+	auto read_raw = [&](void* dst, usz size)
+	{
+		if (data.size() - pos < size)
+		{
+			return false;
+		}
+
+		std::memcpy(dst, data.data() + pos, size);
+		pos += size;
+		return true;
+	};
+
+	auto read_string = [&](std::string& str)
+	{
+		u16 length = 0;
+
+		if (!read_raw(&length, sizeof(length)) || data.size() - pos < length)
+		{
+			return false;
+		}
+
+		str.assign(reinterpret_cast<const char*>(data.data() + pos), length);
+		pos += length;
+		return true;
+	};
+
+	index_header header{};
+
+	if (!read_raw(&header, sizeof(header)) || header.magic != "ISOI"_u32 || header.version != index_header{}.version ||
+		header.image_size != m_dev->size() || data.size() - pos < m_volume_block.size() ||
+		std::memcmp(data.data() + pos, m_volume_block.data(), m_volume_block.size()) != 0)
+	{
+		return false;
 	}
 
-	data.resize(entry.length.value());
-	return fs::make_stream(std::move(data), entry.to_fs_stat());
+	pos += m_volume_block.size();
+
+	std::unordered_map<std::string, iso::IndexEntry> entries;
+	entries.reserve(header.entry_count);
+
+	for (u64 i = 0; i < header.entry_count; i++)
+	{
+		std::string key;
+		iso::IndexEntry entry;
+		u32 extent_count = 0;
+		u32 child_count = 0;
+
+		if (!read_string(key) || !read_raw(&entry.entry, sizeof(entry.entry)) || !read_raw(&entry.size, sizeof(entry.size)) ||
+			!read_raw(&extent_count, sizeof(extent_count)) || (data.size() - pos) / sizeof(iso::Extent) < extent_count)
+		{
+			return false;
+		}
+
+		entry.extents.resize(extent_count);
+		read_raw(entry.extents.data(), extent_count * sizeof(iso::Extent));
+
+		if (!read_raw(&child_count, sizeof(child_count)) || (data.size() - pos) / sizeof(u16) < child_count)
+		{
+			return false;
+		}
+
+		entry.children.resize(child_count);
+
+		for (auto& child : entry.children)
+		{
+			if (!read_string(child))
+			{
+				return false;
+			}
+		}
+
+		entries.emplace(std::move(key), std::move(entry));
+	}
+
+	if (pos != data.size() || !entries.contains(""))
+	{
+		return false;
+	}
+
+	m_index->entries = std::move(entries);
+	return true;
+}
+
+void iso_dev::save_index(const std::string& path) const
+{
+	std::vector<u8> data;
+
+	auto write_raw = [&](const void* src, usz size)
+	{
+		data.insert(data.end(), static_cast<const u8*>(src), static_cast<const u8*>(src) + size);
+	};
+
+	auto write_string = [&](const std::string& str)
+	{
+		const u16 length = static_cast<u16>(std::min<usz>(str.size(), 0xffff));
+		write_raw(&length, sizeof(length));
+		write_raw(str.data(), length);
+	};
+
+	const index_header header{.image_size = m_dev->size(), .entry_count = m_index->entries.size()};
+	write_raw(&header, sizeof(header));
+	write_raw(m_volume_block.data(), m_volume_block.size());
+
+	for (const auto& [key, entry] : m_index->entries)
+	{
+		const u32 extent_count = static_cast<u32>(entry.extents.size());
+		const u32 child_count = static_cast<u32>(entry.children.size());
+
+		write_string(key);
+		write_raw(&entry.entry, sizeof(entry.entry));
+		write_raw(&entry.size, sizeof(entry.size));
+		write_raw(&extent_count, sizeof(extent_count));
+		write_raw(entry.extents.data(), extent_count * sizeof(iso::Extent));
+		write_raw(&child_count, sizeof(child_count));
+
+		for (const auto& child : entry.children)
+		{
+			write_string(child);
+		}
+	}
+
+	if (!fs::create_path(fs::get_parent_dir(path)))
+	{
+		return;
+	}
+
+	fs::pending_file file(path);
+
+	if (file.file)
+	{
+		file.file.write(data);
+		file.commit();
+	}
 }
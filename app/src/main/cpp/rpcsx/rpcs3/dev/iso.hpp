@@ -5,8 +5,13 @@
 #include "util/endian.hpp"
 #include "util/types.hpp"
 #include <bit>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace iso
 {
@@ -96,6 +101,7 @@ namespace iso
 		File = 1 << 2,
 		ExtAttr = 1 << 3,
 		Permissions = 1 << 4,
+		MultiExtent = 1 << 7,
 	};
 
 	constexpr DirEntryFlags operator&(DirEntryFlags lhs, DirEntryFlags rhs)
@@ -204,13 +210,56 @@ namespace iso
 	};
 
 #pragma pack(pop)
+
+	struct Extent
+	{
+		u32 lba;
+		u32 length;
+	};
+
+	// Resolved path of the image, files over 4 GB are split in several extents
+	struct IndexEntry
+	{
+		DirEntry entry;
+		u64 size = 0;
+		std::vector<Extent> extents;
+		std::vector<std::string> children; // Directory items, original case
+
+		bool is_directory() const
+		{
+			return (entry.flags & DirEntryFlags::Directory) == DirEntryFlags::Directory;
+		}
+
+		fs::stat_t to_fs_stat() const
+		{
+			fs::stat_t result = entry.to_fs_stat();
+			result.size = size;
+			return result;
+		}
+
+		fs::dir_entry to_fs_entry(std::string name) const
+		{
+			fs::dir_entry result = entry.to_fs_entry(std::move(name));
+			result.size = size;
+			return result;
+		}
+	};
 } // namespace iso
 
 class iso_dev final : public fs::device_base
 {
-	std::unique_ptr<block_dev> m_dev;
+	// Lowercase path without leading slash -> entry, built on first lookup
+	struct index
+	{
+		std::once_flag once;
+		std::unordered_map<std::string, iso::IndexEntry> entries;
+	};
+
+	std::shared_ptr<block_dev> m_dev;
 	iso::DirEntry m_root_dir;
 	iso::StringEncoding m_encoding = iso::StringEncoding::ascii;
+	std::vector<std::byte> m_volume_block; // Chosen volume descriptor, identifies the image
+	std::unique_ptr<index> m_index = std::make_unique<index>();
 
 public:
 	iso_dev() = default;
@@ -236,7 +285,11 @@ public:
 private:
 	bool initialize();
 
-	std::optional<iso::DirEntry> open_entry(std::string_view path);
+	const iso::IndexEntry* open_entry(std::string_view path);
 	std::pair<std::vector<iso::DirEntry>, std::vector<std::string>> read_dir(const iso::DirEntry& entry);
-	fs::file read_file(const iso::DirEntry& entry);
+
+	void build_index();
+	std::string get_index_path() const;
+	bool load_index(const std::string& path);
+	void save_index(const std::string& path) const;
 };
@@ -4,6 +4,8 @@
 #include "util/yaml.hpp"
 
 #include <charconv>
+#include <deque>
+#include <mutex>
 
 LOG_CHANNEL(cfg_log, "CFG");
 
@@ -618,18 +620,59 @@ bool cfg::node::from_json(const nlohmann::json& json, bool dynamic)
 	return false;
 }
 
+// Parsed documents of the last loaded configs, keyed by their text.
+// The same config.yml is applied again at every boot, settings write and backup copy, so only its first load goes through the YAML parser.
+struct cfg_document_cache
+{
+	static constexpr usz max_entries = 8;
+
+	struct entry
+	{
+		std::string text;
+		YAML::Node document;
+	};
+
+	std::recursive_mutex mutex; // Held while decoding, entries may load nested nodes
+	std::deque<entry> entries;
+};
+
+static cfg_document_cache s_cfg_documents;
+
 bool cfg::node::from_string(std::string_view value, bool dynamic)
 {
-	auto [result, error] = yaml_load(std::string(value));
+	std::lock_guard lock(s_cfg_documents.mutex);
+
+	auto& entries = s_cfg_documents.entries;
+	auto found = std::find_if(entries.begin(), entries.end(), [&](const cfg_document_cache::entry& e) { return e.text == value; });
 
-	if (error.empty())
+	if (found == entries.end())
 	{
-		cfg::decode(result, *this, dynamic);
-		return true;
+		auto [result, error] = yaml_load(std::string(value));
+
+		if (!error.empty())
+		{
+			cfg_log.error("Failed to load node: %s", error);
+			return false;
+		}
+
+		if (entries.size() >= cfg_document_cache::max_entries)
+		{
+			entries.pop_back();
+		}
+
+		entries.push_front({std::string(value), std::move(result)});
+		found = entries.begin();
+	}
+	else if (found != entries.begin())
+	{
+		std::rotate(entries.begin(), found, found + 1);
+		found = entries.begin();
 	}
 
-	cfg_log.error("Failed to load node: %s", error);
-	return false;
+	// Decode from a const node, lookups on a non-const YAML::Node insert missing keys into the shared document
+	const YAML::Node& document = found->document;
+	cfg::decode(document, *this, dynamic);
+	return true;
 }
 
 void cfg::node::from_default()
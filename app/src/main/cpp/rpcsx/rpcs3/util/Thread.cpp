@@ -2639,6 +2639,24 @@ u64 thread_base::get_native_id() const
 }
 
 u64 thread_base::get_cycles()
+{
+	if (const u64 cycles = get_cpu_time())
+	{
+		if (const u64 old_cycles = m_cycles.exchange(cycles))
+		{
+			return cycles - old_cycles;
+		}
+
+		// Report 0 the first time this function is called
+		return 0;
+	}
+	else
+	{
+		return m_cycles;
+	}
+}
+
+u64 thread_base::get_cpu_time() const
 {
 	u64 cycles = 0;
 
@@ -2668,18 +2686,10 @@ u64 thread_base::get_cycles()
 	{
 		cycles = static_cast<u64>(thread_time.tv_sec) * 1'000'000'000 + thread_time.tv_nsec;
 #endif
-		if (const u64 old_cycles = m_cycles.exchange(cycles))
-		{
-			return cycles - old_cycles;
-		}
-
-		// Report 0 the first time this function is called
-		return 0;
-	}
-	else
-	{
-		return m_cycles;
+		return cycles;
 	}
+
+	return 0;
 }
 
 void thread_base::push(shared_ptr<thread_future> task)
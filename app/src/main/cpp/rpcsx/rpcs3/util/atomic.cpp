@@ -95,6 +95,182 @@ static NEVER_INLINE bool ptr_cmp(const void* data, u32 old, atomic_wait::info* e
 	return false;
 }
 
+#ifdef __linux__
+#if defined(ARCH_ARM64)
+#include <sys/auxv.h>
+
+#ifndef HWCAP_EVTSTRM
+#define HWCAP_EVTSTRM (1 << 2)
+#endif
+#endif
+
+namespace
+{
+	// Single-word waits without futex_waitv sleep on the word itself (FUTEX_WAIT_BITSET). The bucket
+	// counts them by address hash, so notifiers only make the wake syscall when someone may sleep there.
+	// Multi-word waits (atomic_wait::list, 64-bit atomics) keep using the semaphore table below.
+	struct alignas(16) futex_bucket
+	{
+		atomic_t<u32> waiters;
+
+		// Recent waits resolved by the wfe spin (saturating), 0 - sleep straight away
+		atomic_t<u32> spin_score;
+
+		// Sleeps since the spin was last tried
+		atomic_t<u32> sleeps;
+	};
+
+	static constexpr usz s_futex_bucket_count = 4096;
+
+	futex_bucket s_futex_buckets[s_futex_bucket_count]{};
+
+	futex_bucket& get_futex_bucket(const void* data)
+	{
+		const u64 hash = (reinterpret_cast<uptr>(data) >> 2) * 0x9e3779b97f4a7c15ull;
+		return s_futex_buckets[hash >> (64 - std::countr_zero(s_futex_bucket_count))];
+	}
+
+#if defined(ARCH_ARM64)
+	// Without the kernel event stream nothing bounds wfe on an idle line
+	const bool s_has_event_stream = (getauxval(AT_HWCAP) & HWCAP_EVTSTRM) != 0;
+
+	static constexpr u32 s_spin_score_max = 8;
+
+	// Short wait before the syscall, true if the word changed. The exclusive load arms the monitor,
+	// the store that changes the word ends wfe; the event stream ends it within ~100us otherwise.
+	bool wfe_wait(const void* data, u32 old_value, u64 timeout)
+	{
+		auto& bucket = get_futex_bucket(data);
+
+		if (!s_has_event_stream || !bucket.spin_score)
+		{
+			return false;
+		}
+
+		u64 freq = 0;
+		__asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+
+		// About the cost of a futex sleep and wake, a quarter of short timeouts
+		u64 budget_ns = 5'000;
+
+		if (timeout + 1)
+		{
+			budget_ns = std::min<u64>(budget_ns, timeout / 4);
+		}
+
+		const u64 start = rx::get_tsc();
+		const u64 budget = budget_ns * freq / 1'000'000'000;
+
+		do
+		{
+			u32 current;
+			__asm__ volatile("ldaxr %w0, [%1]" : "=&r"(current) : "r"(data) : "memory");
+
+			if (current != old_value)
+			{
+				bucket.spin_score.fetch_op([](u32& v)
+					{
+						v = std::min(v + 1, s_spin_score_max);
+					});
+				return true;
+			}
+
+			__asm__ volatile("wfe" ::: "memory");
+		} while (rx::get_tsc() - start < budget);
+
+		// Ran out: halve, a word that keeps sleeping stops spinning
+		bucket.spin_score.fetch_op([](u32& v)
+			{
+				v /= 2;
+			});
+		return reinterpret_cast<const atomic_t<u32>*>(data)->load() != old_value;
+	}
+#endif
+
+	void futex_wait_direct(const void* data, u32 old_value, u64 timeout, u64 stamp0)
+	{
+		auto& bucket = get_futex_bucket(data);
+
+#if defined(ARCH_ARM64)
+		if (wfe_wait(data, old_value, timeout))
+		{
+			return;
+		}
+#endif
+
+		// Pairs with the fence in notify: either the notifier sees the waiter or the waiter sees the new value
+		bucket.waiters++;
+		atomic_fence_seq_cst();
+
+		u64 attempts = 0;
+
+		while (ptr_cmp(data, old_value))
+		{
+			if (s_tls_one_time_wait_cb)
+			{
+				if (!s_tls_one_time_wait_cb(attempts))
+				{
+					break;
+				}
+			}
+
+			::timespec ts{};
+
+			if (timeout + 1)
+			{
+				// Absolute monotonic deadline (FUTEX_WAIT_BITSET)
+				::clock_gettime(CLOCK_MONOTONIC, &ts);
+				ts.tv_sec += timeout / 1'000'000'000;
+				ts.tv_nsec += timeout % 1'000'000'000;
+				if (ts.tv_nsec >= 1'000'000'000)
+				{
+					ts.tv_sec++;
+					ts.tv_nsec -= 1'000'000'000;
+				}
+			}
+
+			futex(const_cast<void*>(data), FUTEX_WAIT_BITSET_PRIVATE, old_value, timeout + 1 ? &ts : nullptr, FUTEX_BITSET_MATCH_ANY);
+
+			if (!s_tls_wait_cb(data, ++attempts, stamp0))
+			{
+				break;
+			}
+
+			if (timeout + 1)
+			{
+				if (s_tls_one_time_wait_cb)
+				{
+					continue;
+				}
+
+				break;
+			}
+		}
+
+		bucket.waiters--;
+
+		// Every 32nd sleep lets the next wait probe the spin again
+		if ((++bucket.sleeps & 31) == 0 && !bucket.spin_score)
+		{
+			bucket.spin_score.compare_and_swap(0, 1);
+		}
+	}
+
+	// Wake direct waiters, returns the number woken
+	int futex_wake_direct(const void* data, int count)
+	{
+		atomic_fence_seq_cst();
+
+		if (!get_futex_bucket(data).waiters)
+		{
+			return 0;
+		}
+
+		return futex(const_cast<void*>(data), FUTEX_WAKE_PRIVATE, count);
+	}
+} // namespace
+#endif
+
 static atomic_t<u64> s_min_tsc{0};
 
 namespace
@@ -926,6 +1102,23 @@ atomic_wait_engine::wait(const void* data, u32 old_value, u64 timeout, atomic_wa
 		return;
 	}
 
+	// futex needs an aligned word
+	if (!ext_size && !(reinterpret_cast<uptr>(data) % 4))
+	{
+		if (!s_tls_wait_cb(data, 0, 0))
+		{
+			return;
+		}
+
+		const auto stamp0 = utils::get_unique_tsc();
+
+		futex_wait_direct(data, old_value, timeout, stamp0);
+
+		s_tls_wait_cb(data, -1, stamp0);
+		s_tls_one_time_wait_cb = nullptr;
+		return;
+	}
+
 	ext_size = 0;
 #endif
 
@@ -1266,6 +1459,11 @@ void atomic_wait_engine::notify_one(const void* data)
 		futex(const_cast<void*>(data), FUTEX_WAKE_PRIVATE, 1);
 		return;
 	}
+
+	if (futex_wake_direct(data, 1) > 0)
+	{
+		return;
+	}
 #endif
 	const uptr iptr = reinterpret_cast<uptr>(data) & (~s_ref_mask >> 16);
 
@@ -1289,6 +1487,9 @@ atomic_wait_engine::notify_all(const void* data)
 		futex(const_cast<void*>(data), FUTEX_WAKE_PRIVATE, INT_MAX);
 		return;
 	}
+
+	// Single-word waiters sleep on the word, list waiters in the table
+	futex_wake_direct(data, INT_MAX);
 #endif
 	const uptr iptr = reinterpret_cast<uptr>(data) & (~s_ref_mask >> 16);
 
@@ -9,6 +9,8 @@
 #include "Emu/VFS.h"
 
 #include "util/types.hpp"
+#include "util/fnv_hash.hpp"
+#include "util/serialization.hpp"
 #include "rx/asm.hpp"
 #include "rx/align.hpp"
 
@@ -919,6 +921,233 @@ void patch_engine::append_title_patches(std::string_view title_id)
 	load(m_map, fmt::format("%s%s_patch.yml", get_patches_path(), title_id));
 }
 
+void patch_engine::patch_data::operator()(utils::serial& ar)
+{
+	ar(type, offset, original_offset, original_value, value.long_value);
+}
+
+void patch_engine::patch_allowed_value::operator()(utils::serial& ar)
+{
+	ar(label, value);
+}
+
+void patch_engine::patch_config_value::operator()(utils::serial& ar)
+{
+	ar(value, min, max, type, allowed_values);
+}
+
+void patch_engine::patch_config_values::operator()(utils::serial& ar)
+{
+	ar(enabled, config_values);
+}
+
+void patch_engine::patch_info::operator()(utils::serial& ar)
+{
+	ar(data_list, titles, description, patch_version, patch_group, author, notes, source_path, default_config_values, hash, version);
+}
+
+void patch_engine::patch_container::operator()(utils::serial& ar)
+{
+	ar(patch_info_map, hash, version);
+}
+
+// Compiled per-title bundle: the YAML files parsed once, anchors and offsets already resolved,
+// only the patches enabled for this serial (or All). Rebuilt when any source file changes.
+struct patch_bundle_header
+{
+	u64 magic;
+	u32 version;
+	u32 source_count;
+	u64 payload_size;
+	u64 payload_hash;
+};
+
+static constexpr u32 patch_bundle_version = 1;
+
+static std::string get_patch_bundle_path(std::string_view title_id)
+{
+	return fmt::format("%scompiled/%s.bin", patch_engine::get_patches_path(), title_id);
+}
+
+static u64 get_patch_bundle_hash(const u8* data, usz size)
+{
+	usz hash = rpcs3::fnv_seed;
+
+	for (usz i = 0; i < size; i++)
+	{
+		hash = rpcs3::hash64(hash, data[i]);
+	}
+
+	return hash;
+}
+
+// Size and modification time of every file the bundle is compiled from
+static std::vector<u64> get_patch_bundle_sources(std::string_view title_id)
+{
+	std::vector<u64> sources;
+	sources.push_back(get_patch_bundle_hash(reinterpret_cast<const u8*>(patch_engine_version.data()), patch_engine_version.size()));
+
+	for (const std::string& path : {patch_engine::get_patches_path() + "patch.yml", patch_engine::get_imported_patch_path(),
+			 fmt::format("%s%s_patch.yml", patch_engine::get_patches_path(), title_id), patch_engine::get_patch_config_path()})
+	{
+		fs::stat_t info{};
+
+		if (fs::get_stat(path, info) && !info.is_directory)
+		{
+			sources.push_back(info.size);
+			sources.push_back(static_cast<u64>(info.mtime));
+		}
+		else
+		{
+			sources.push_back(umax);
+			sources.push_back(umax);
+		}
+	}
+
+	return sources;
+}
+
+// Drop everything apply() would skip for this title
+static void filter_title_patches(patch_engine::patch_map& patches, std::string_view title_id)
+{
+	for (auto it = patches.begin(); it != patches.end();)
+	{
+		auto& info_map = it->second.patch_info_map;
+
+		for (auto info_it = info_map.begin(); info_it != info_map.end();)
+		{
+			bool enabled = false;
+
+			for (auto& [title, serials] : info_it->second.titles)
+			{
+				std::erase_if(serials, [&](const auto& entry)
+					{
+						return entry.first != title_id && entry.first != patch_key::all;
+					});
+
+				for (const auto& [serial, app_versions] : serials)
+				{
+					for (const auto& [app_version, config_values] : app_versions)
+					{
+						enabled |= config_values.enabled;
+					}
+				}
+			}
+
+			info_it = enabled ? std::next(info_it) : info_map.erase(info_it);
+		}
+
+		it = info_map.empty() ? patches.erase(it) : std::next(it);
+	}
+}
+
+bool patch_engine::load_title_bundle(std::string_view title_id)
+{
+	fs::file file{get_patch_bundle_path(title_id)};
+
+	if (!file)
+	{
+		return false;
+	}
+
+	const std::vector<u8> data = file.to_vector<u8>();
+	const std::vector<u64> sources = get_patch_bundle_sources(title_id);
+	const usz sources_size = sources.size() * sizeof(u64);
+
+	patch_bundle_header header{};
+
+	if (data.size() < sizeof(header))
+	{
+		return false;
+	}
+
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	if (header.magic != "RPCSXPAT"_u64 || header.version != patch_bundle_version || header.source_count != sources.size() ||
+		data.size() != sizeof(header) + sources_size + header.payload_size ||
+		std::memcmp(data.data() + sizeof(header), sources.data(), sources_size) != 0)
+	{
+		patch_log.notice("Compiled patches for %s are outdated", title_id);
+		return false;
+	}
+
+	const u8* payload = data.data() + sizeof(header) + sources_size;
+
+	if (get_patch_bundle_hash(payload, header.payload_size) != header.payload_hash)
+	{
+		patch_log.warning("Compiled patches for %s are corrupted", title_id);
+		return false;
+	}
+
+	utils::serial ar;
+	ar.set_reading_state(std::vector<u8>(payload, payload + header.payload_size));
+	ar(m_map);
+	return true;
+}
+
+void patch_engine::save_title_bundle(std::string_view title_id) const
+{
+	const std::string path = get_patch_bundle_path(title_id);
+
+	if (!fs::create_path(fs::get_parent_dir(path)))
+	{
+		patch_log.error("Could not create path for compiled patches: %s (%s)", path, fs::g_tls_error);
+		return;
+	}
+
+	utils::serial ar;
+	ar(m_map);
+
+	const std::vector<u64> sources = get_patch_bundle_sources(title_id);
+
+	patch_bundle_header header{};
+	header.magic = "RPCSXPAT"_u64;
+	header.version = patch_bundle_version;
+	header.source_count = ::size32(sources);
+	header.payload_size = ar.data.size();
+	header.payload_hash = get_patch_bundle_hash(ar.data.data(), ar.data.size());
+
+	fs::pending_file file(path);
+
+	if (!file.file)
+	{
+		patch_log.error("Failed to write compiled patches: %s (%s)", path, fs::g_tls_error);
+		return;
+	}
+
+	file.file.write(header);
+	file.file.write(sources);
+	file.file.write(ar.data);
+
+	if (!file.commit())
+	{
+		patch_log.error("Failed to commit compiled patches: %s (%s)", path, fs::g_tls_error);
+	}
+}
+
+void patch_engine::append_title_bundle(std::string_view title_id)
+{
+	if (title_id.empty() || !m_map.empty())
+	{
+		append_global_patches();
+		append_title_patches(title_id);
+		return;
+	}
+
+	if (load_title_bundle(title_id))
+	{
+		patch_log.notice("Loaded compiled patches for %s (%d hashes)", title_id, m_map.size());
+		return;
+	}
+
+	m_map.clear();
+	append_global_patches();
+	append_title_patches(title_id);
+
+	filter_title_patches(m_map, title_id);
+	save_title_bundle(title_id);
+}
+
 void unmap_vm_area(std::shared_ptr<vm::block_t>& ptr)
 {
 	if (ptr && ptr->flags & (1ull << 62))
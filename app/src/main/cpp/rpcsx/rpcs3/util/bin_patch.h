@@ -8,6 +8,11 @@
 #include "util/types.hpp"
 #include "util/yaml.hpp"
 
+namespace utils
+{
+	struct serial;
+}
+
 namespace patch_key
 {
 	static const std::string all = "All";
@@ -87,6 +92,8 @@ public:
 			f64 double_value;
 		} value{0};
 		mutable u32 alloc_addr = 0; // Used to save optional allocation address (if occured)
+
+		void operator()(utils::serial& ar);
 	};
 
 	struct patch_allowed_value
@@ -98,6 +105,8 @@ public:
 		{
 			return value == other.value && label == other.label;
 		}
+
+		void operator()(utils::serial& ar);
 	};
 
 	struct patch_config_value
@@ -114,12 +123,16 @@ public:
 		}
 
 		void set_and_check_value(f64 new_value, std::string_view name);
+
+		void operator()(utils::serial& ar);
 	};
 
 	struct patch_config_values
 	{
 		bool enabled{};
 		std::map<std::string, patch_config_value> config_values;
+
+		void operator()(utils::serial& ar);
 	};
 
 	using patch_app_versions = std::unordered_map<std::string /*app_version*/, patch_config_values>;
@@ -143,6 +156,8 @@ public:
 		std::string hash{};
 		std::string version{};
 		std::map<std::string, patch_config_value> actual_config_values;
+
+		void operator()(utils::serial& ar);
 	};
 
 	struct patch_container
@@ -150,6 +165,8 @@ public:
 		std::unordered_map<std::string /*description*/, patch_info> patch_info_map{};
 		std::string hash{};
 		std::string version{};
+
+		void operator()(utils::serial& ar);
 	};
 
 	enum mem_protection : u8
@@ -214,6 +231,9 @@ public:
 	// Load from title relevant files and append to member patches map
 	void append_title_patches(std::string_view title_id);
 
+	// Load global and title patches that can apply to this title, from the compiled bundle if it is up to date
+	void append_title_bundle(std::string_view title_id);
+
 	// Apply patch (returns the number of entries applied)
 	void apply(std::vector<u32>& applied_total, const std::string& name, std::function<u8*(u32, u32)> mem_translate, u32 filesz = -1, u32 min_addr = 0);
 
@@ -221,6 +241,9 @@ public:
 	void unload(const std::string& name);
 
 private:
+	bool load_title_bundle(std::string_view title_id);
+	void save_title_bundle(std::string_view title_id) const;
+
 	// Database
 	patch_map m_map{};
 
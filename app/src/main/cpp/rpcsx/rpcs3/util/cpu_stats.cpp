@@ -5,6 +5,7 @@
 #include "util/StrUtil.h"
 
 #include <algorithm>
+#include <chrono>
 
 #ifdef _WIN32
 #include "rx/asm.hpp"
@@ -28,6 +29,7 @@
 
 #ifdef __linux__
 #include <dirent.h>
+#include <unistd.h>
 #endif
 
 #if defined(__DragonFly__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
@@ -293,6 +295,71 @@ namespace utils
 #endif
 	}
 
+	void cpu_stats::get_per_thread_usage(const std::vector<u64>& tids, std::vector<double>& per_thread_usage)
+	{
+		per_thread_usage.resize(tids.size());
+		std::fill(per_thread_usage.begin(), per_thread_usage.end(), 0.0);
+
+#if defined(__linux__)
+		static const u64 ticks_per_second = ::sysconf(_SC_CLK_TCK);
+		const u64 now_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		std::unordered_map<u64, thread_time_sample> current_times;
+		current_times.reserve(tids.size());
+
+		for (usz i = 0; i < tids.size(); i++)
+		{
+			std::ifstream task_stat(fmt::format("/proc/self/task/%u/stat", tids[i]));
+			if (!task_stat.good())
+			{
+				// Thread has exited
+				continue;
+			}
+
+			std::string content;
+			std::getline(task_stat, content);
+
+			// The thread name may contain spaces, fields are counted from the closing parenthesis
+			const usz name_end = content.rfind(')');
+			if (name_end == umax)
+			{
+				continue;
+			}
+
+			// Fields after the name: state(3) ... utime(14) stime(15)
+			const std::vector<std::string> tokens = fmt::split(content.substr(name_end + 1), {" "});
+			if (tokens.size() < 13)
+			{
+				continue;
+			}
+
+			const auto [utime_ok, utime] = string_to_number(tokens[11]);
+			const auto [stime_ok, stime] = string_to_number(tokens[12]);
+			if (!utime_ok || !stime_ok)
+			{
+				perf_log.error("Can not convert thread times for per thread cpu usage. (tid=%u, line='%s')", tids[i], content);
+				continue;
+			}
+
+			const thread_time_sample sample{static_cast<u64>(utime) + static_cast<u64>(stime), now_us};
+			current_times[tids[i]] = sample;
+
+			if (const auto found = m_previous_thread_times.find(tids[i]); found != m_previous_thread_times.end())
+			{
+				const u64 wall_delta_us = sample.wall_us - found->second.wall_us;
+				if (wall_delta_us && ticks_per_second)
+				{
+					const double busy_us = (sample.cpu_ticks - found->second.cpu_ticks) * 1'000'000.0 / ticks_per_second;
+					per_thread_usage[i] = std::min(100.0, 100.0 * busy_us / wall_delta_us);
+				}
+			}
+		}
+
+		// Drop threads that were not sampled this time
+		m_previous_thread_times = std::move(current_times);
+#endif
+	}
+
 	double cpu_stats::get_usage()
 	{
 #ifdef _WIN32
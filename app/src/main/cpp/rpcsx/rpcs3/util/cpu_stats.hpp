@@ -2,6 +2,7 @@
 
 #include "util/types.hpp"
 #include <vector>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <pdh.h>
@@ -26,6 +27,14 @@ namespace utils
 		std::vector<size_t> m_previous_total_times_per_cpu;
 #endif
 
+		struct thread_time_sample
+		{
+			u64 cpu_ticks = 0;
+			u64 wall_us = 0;
+		};
+
+		std::unordered_map<u64, thread_time_sample> m_previous_thread_times;
+
 	public:
 		cpu_stats();
 		~cpu_stats();
@@ -35,6 +44,10 @@ namespace utils
 		void init_cpu_query();
 		void get_per_core_usage(std::vector<double>& per_core_usage, double& total_usage);
 
+		// Usage of each thread (kernel thread ids) since the previous call, in percent of one core.
+		// Threads sampled for the first time report 0.
+		void get_per_thread_usage(const std::vector<u64>& tids, std::vector<double>& per_thread_usage);
+
 		static u32 get_current_thread_count();
 	};
 } // namespace utils
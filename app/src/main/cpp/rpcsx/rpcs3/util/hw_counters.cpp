@@ -0,0 +1,265 @@
+#include "util/hw_counters.hpp"
+#include "util/logs.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+LOG_CHANNEL(perf_log, "PERF");
+
+namespace utils
+{
+	hw_counter_values& hw_counter_values::operator+=(const hw_counter_values& rhs)
+	{
+		for (usz i = 0; i < values.size(); i++)
+		{
+			values[i] += rhs.values[i];
+		}
+
+		return *this;
+	}
+
+	f64 hw_counter_values::ipc() const
+	{
+		const u64 cycles = (*this)[hw_counter::cycles];
+		return cycles ? static_cast<f64>((*this)[hw_counter::instructions]) / cycles : 0.;
+	}
+
+	f64 hw_counter_values::per_kilo_instruction(hw_counter counter) const
+	{
+		const u64 instructions = (*this)[hw_counter::instructions];
+		return instructions ? (*this)[counter] * 1000. / instructions : 0.;
+	}
+
+#ifdef __linux__
+	namespace
+	{
+		struct event_desc
+		{
+			u32 type;
+			u64 config;
+		};
+
+		constexpr u64 cache_event(u64 cache, u64 op, u64 result)
+		{
+			return cache | (op << 8) | (result << 16);
+		}
+
+		constexpr event_desc get_event_desc(hw_counter counter)
+		{
+			switch (counter)
+			{
+			case hw_counter::cycles: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+			case hw_counter::instructions: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+			case hw_counter::l1d_misses: return {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)};
+#ifdef __aarch64__
+			// The generic LL event is not mapped by most ARMv8 PMU drivers, L2D_CACHE_REFILL is a common PMUv3 event
+			case hw_counter::l2_misses: return {PERF_TYPE_RAW, 0x17};
+#else
+			case hw_counter::l2_misses: return {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)};
+#endif
+			case hw_counter::branch_misses: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+			case hw_counter::count: break;
+			}
+
+			return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+		}
+
+		int open_event(hw_counter counter, u64 tid, int group_fd)
+		{
+			const auto desc = get_event_desc(counter);
+
+			perf_event_attr attr{};
+			attr.size = sizeof(attr);
+			attr.type = desc.type;
+			attr.config = desc.config;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			attr.disabled = 0;
+			attr.exclude_kernel = 1; // Allowed up to perf_event_paranoid 2
+			attr.exclude_hv = 1;
+
+			return static_cast<int>(::syscall(SYS_perf_event_open, &attr, static_cast<pid_t>(tid), -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+		}
+	} // namespace
+
+	bool hw_thread_counters::open_group(u64 tid, thread_group& group)
+	{
+		group.fds.fill(-1);
+
+		const int leader = open_event(hw_counter::cycles, tid, -1);
+		if (leader < 0)
+		{
+			if (errno == EACCES || errno == EPERM || errno == ENOENT || errno == ENODEV || errno == ENOSYS || errno == EOPNOTSUPP)
+			{
+				perf_log.warning("Hardware performance counters are not available: %s", strerror(errno));
+				m_unsupported = true;
+			}
+
+			return false;
+		}
+
+		group.fds[static_cast<usz>(hw_counter::cycles)] = leader;
+
+		// Members the PMU does not know stay closed and read as 0
+		for (usz i = 0; i < group.fds.size(); i++)
+		{
+			if (i != static_cast<usz>(hw_counter::cycles))
+			{
+				group.fds[i] = open_event(static_cast<hw_counter>(i), tid, leader);
+			}
+		}
+
+		return true;
+	}
+
+	bool hw_thread_counters::read_group(const thread_group& group, hw_counter_values& out)
+	{
+		for (usz i = 0; i < group.fds.size(); i++)
+		{
+			out.values[i] = 0;
+
+			if (group.fds[i] < 0)
+			{
+				continue;
+			}
+
+			// value, time enabled, time running
+			u64 data[3]{};
+			if (::read(group.fds[i], data, sizeof(data)) != sizeof(data))
+			{
+				if (i == static_cast<usz>(hw_counter::cycles))
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			// Scale up if the group had to share the PMU with other events
+			out.values[i] = data[2] ? static_cast<u64>(static_cast<f64>(data[0]) * data[1] / data[2]) : 0;
+		}
+
+		return true;
+	}
+
+	void hw_thread_counters::close_group(thread_group& group)
+	{
+		// Members first, the leader owns the group
+		for (usz i = group.fds.size(); i-- > 0;)
+		{
+			if (group.fds[i] >= 0)
+			{
+				::close(group.fds[i]);
+				group.fds[i] = -1;
+			}
+		}
+	}
+
+	hw_thread_counters::~hw_thread_counters()
+	{
+		for (auto& [tid, group] : m_groups)
+		{
+			close_group(group);
+		}
+	}
+
+	bool hw_thread_counters::sample(const std::vector<u64>& tids, std::vector<hw_counter_values>& deltas)
+	{
+		deltas.clear();
+		deltas.resize(tids.size());
+
+		if (m_unsupported)
+		{
+			return false;
+		}
+
+		for (auto& [tid, group] : m_groups)
+		{
+			group.seen = false;
+		}
+
+		for (usz i = 0; i < tids.size(); i++)
+		{
+			auto [found, inserted] = m_groups.try_emplace(tids[i]);
+			thread_group& group = found->second;
+
+			if (inserted && !open_group(tids[i], group))
+			{
+				m_groups.erase(found);
+
+				if (m_unsupported)
+				{
+					return false;
+				}
+
+				// Thread has exited
+				continue;
+			}
+
+			group.seen = true;
+
+			hw_counter_values current;
+			if (!read_group(group, current))
+			{
+				continue;
+			}
+
+			if (!inserted)
+			{
+				for (usz j = 0; j < current.values.size(); j++)
+				{
+					deltas[i].values[j] = current.values[j] >= group.last.values[j] ? current.values[j] - group.last.values[j] : 0;
+				}
+			}
+
+			group.last = current;
+		}
+
+		// Threads that have exited or are not tracked any more
+		for (auto it = m_groups.begin(); it != m_groups.end();)
+		{
+			if (!it->second.seen)
+			{
+				close_group(it->second);
+				it = m_groups.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		return true;
+	}
+#else
+	bool hw_thread_counters::open_group(u64, thread_group&)
+	{
+		return false;
+	}
+
+	bool hw_thread_counters::read_group(const thread_group&, hw_counter_values&)
+	{
+		return false;
+	}
+
+	void hw_thread_counters::close_group(thread_group&)
+	{
+	}
+
+	hw_thread_counters::~hw_thread_counters()
+	{
+	}
+
+	bool hw_thread_counters::sample(const std::vector<u64>& tids, std::vector<hw_counter_values>& deltas)
+	{
+		deltas.clear();
+		deltas.resize(tids.size());
+		m_unsupported = true;
+		return false;
+	}
+#endif
+} // namespace utils
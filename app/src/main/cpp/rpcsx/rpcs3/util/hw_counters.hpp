@@ -0,0 +1,67 @@
+#pragma once
+
+#include "util/types.hpp"
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace utils
+{
+	enum class hw_counter : u8
+	{
+		cycles,
+		instructions,
+		l1d_misses,    // L1 data cache read refills
+		l2_misses,     // L2 data cache refills (last level cache misses off ARM)
+		branch_misses, // Mispredicted branches
+
+		count
+	};
+
+	struct hw_counter_values
+	{
+		std::array<u64, static_cast<usz>(hw_counter::count)> values{};
+
+		u64& operator[](hw_counter counter) { return values[static_cast<usz>(counter)]; }
+		u64 operator[](hw_counter counter) const { return values[static_cast<usz>(counter)]; }
+
+		hw_counter_values& operator+=(const hw_counter_values& rhs);
+
+		f64 ipc() const;
+
+		// Events per thousand instructions
+		f64 per_kilo_instruction(hw_counter counter) const;
+	};
+
+	// User mode hardware counter groups of other threads of this process, read through perf_event_open.
+	// On Android this needs perf_event_paranoid <= 2 (security.perf_harden=0), otherwise nothing is counted.
+	class hw_thread_counters
+	{
+		struct thread_group
+		{
+			std::array<int, static_cast<usz>(hw_counter::count)> fds;
+			hw_counter_values last{};
+			bool seen = false;
+		};
+
+		std::unordered_map<u64, thread_group> m_groups;
+		bool m_unsupported = false;
+
+		bool open_group(u64 tid, thread_group& group);
+		static bool read_group(const thread_group& group, hw_counter_values& out);
+		static void close_group(thread_group& group);
+
+	public:
+		hw_thread_counters() = default;
+		hw_thread_counters(const hw_thread_counters&) = delete;
+		hw_thread_counters& operator=(const hw_thread_counters&) = delete;
+		~hw_thread_counters();
+
+		// Counts of each thread (kernel thread ids) since the previous call, scaled for multiplexing.
+		// Threads sampled for the first time report 0, groups of threads not listed any more are closed.
+		// Returns false if the kernel refuses hardware counters for this process.
+		bool sample(const std::vector<u64>& tids, std::vector<hw_counter_values>& deltas);
+
+		bool is_supported() const { return !m_unsupported; }
+	};
+} // namespace utils
@@ -12,6 +12,7 @@
 #include <cstring>
 #include <cerrno>
 #include <regex>
+#include <algorithm>
 
 using namespace std::literals::chrono_literals;
 
@@ -315,6 +316,475 @@ namespace logs
 	}
 } // namespace logs
 
+namespace logs
+{
+	// Per-thread queue size (bytes)
+	constexpr u32 s_queue_size = 128 * 1024;
+
+	// Bigger messages bypass the queue
+	constexpr u32 s_queue_max_record = s_queue_size / 8;
+
+	static constexpr fmt_type_info s_empty_sup{};
+
+	static atomic_t<u64> s_queued{0};
+	static atomic_t<u64> s_dropped{0};
+	static atomic_t<u64> s_direct{0};
+
+	// Queue record header, followed by raw arguments, prefix and preformatted text
+	struct queued_record
+	{
+		u32 size; // Total size (multiple of 8), 0 marks the unused tail of the queue
+		u32 argc;
+		u32 prefix_size;
+		u32 text_size;
+		const message* msg;
+		const char* fmt; // nullptr if the text is preformatted
+		const fmt_type_info* sup;
+		u64 stamp;
+	};
+
+	static_assert(sizeof(queued_record) % 8 == 0);
+
+	// Single producer (owner thread), single consumer (dispatcher)
+	struct thread_queue
+	{
+		const std::unique_ptr<u64[]> data = std::make_unique<u64[]>(s_queue_size / 8);
+
+		atomic_t<u64, 64> write{0};
+		atomic_t<u64, 64> read{0};
+
+		// Owner thread has exited, remove once drained
+		atomic_t<bool> orphaned{false};
+
+		atomic_t<u64> dropped{0};
+		u64 reported_drops = 0;
+
+		uchar* base() const
+		{
+			return reinterpret_cast<uchar*>(data.get());
+		}
+
+		bool push(const queued_record& rec, const u64* args, std::string_view prefix, std::string_view text)
+		{
+			u64 pos = write.observe();
+			const u32 offset = pos % s_queue_size;
+			const u32 tail = s_queue_size - offset;
+			const u32 skip = tail < rec.size ? tail : 0;
+
+			if (pos + skip + rec.size - read.load() > s_queue_size)
+			{
+				dropped++;
+				return false;
+			}
+
+			if (skip)
+			{
+				std::memset(base() + offset, 0, sizeof(u32));
+				pos += skip;
+			}
+
+			uchar* dst = base() + pos % s_queue_size;
+			std::memcpy(dst, &rec, sizeof(rec));
+			dst += sizeof(rec);
+			std::memcpy(dst, args, rec.argc * sizeof(u64));
+			dst += rec.argc * sizeof(u64);
+			std::memcpy(dst, prefix.data(), prefix.size());
+			dst += prefix.size();
+			std::memcpy(dst, text.data(), text.size());
+
+			// Sequentially consistent: pairs with the dispatcher going idle
+			write = pos + rec.size;
+			return true;
+		}
+
+		// Pass each record to func, return false if there were none
+		template <typename F>
+		bool pop(F&& func)
+		{
+			u64 pos = read.observe();
+			const u64 end = write.load();
+
+			if (pos == end)
+			{
+				return false;
+			}
+
+			while (pos < end)
+			{
+				const uchar* src = base() + pos % s_queue_size;
+
+				u32 size;
+				std::memcpy(&size, src, sizeof(size));
+
+				if (size == 0)
+				{
+					pos += s_queue_size - pos % s_queue_size;
+					continue;
+				}
+
+				func(*reinterpret_cast<const queued_record*>(src), reinterpret_cast<const u64*>(src + sizeof(queued_record)));
+
+				pos += size;
+				read.release(pos);
+			}
+
+			read.release(pos);
+			return true;
+		}
+
+		bool empty() const
+		{
+			return read.load() == write.load();
+		}
+	};
+
+	// Set on the dispatcher thread: its own messages are written directly
+	static thread_local bool s_tls_is_dispatcher = false;
+
+	// Set once the thread's queue holder is destroyed (thread exit)
+	static thread_local bool s_tls_queue_gone = false;
+
+	// Alive between construction and destruction of the dispatcher
+	static atomic_t<dispatcher*> s_dispatcher{nullptr};
+
+	// Formats queued messages and feeds the listeners on a background thread
+	class dispatcher
+	{
+		std::thread m_thread;
+
+		shared_mutex m_mutex;
+		std::vector<std::shared_ptr<thread_queue>> m_queues;
+
+		atomic_t<u32> m_idle{0};
+		atomic_t<bool> m_stop{false};
+
+		std::string m_prefix;
+		std::string m_text;
+
+		void dispatch(thread_queue& queue)
+		{
+			queue.pop([&](const queued_record& rec, const u64* args)
+				{
+					const char* payload = reinterpret_cast<const char*>(args + rec.argc);
+
+					m_prefix.assign(payload, rec.prefix_size);
+					m_text.clear();
+
+					if (rec.fmt)
+					{
+						fmt::raw_append(m_text, rec.fmt, rec.sup ? rec.sup : &s_empty_sup, args);
+					}
+					else
+					{
+						m_text.assign(payload + rec.prefix_size, rec.text_size);
+					}
+
+					rec.msg->dispatch(rec.stamp, m_prefix, m_text);
+				});
+
+			if (const u64 dropped = queue.dropped.load(); dropped != queue.reported_drops) [[unlikely]]
+			{
+				m_text = fmt::format("Log queue overflow: %u messages dropped", dropped - queue.reported_drops);
+				queue.reported_drops = dropped;
+				m_prefix.clear();
+				report_message().dispatch(get_stamp(), m_prefix, m_text);
+			}
+		}
+
+		// Dispatch all queued messages once, false if there were none
+		bool dispatch_all()
+		{
+			bool result = false;
+			bool orphans = false;
+
+			{
+				reader_lock lock(m_mutex);
+
+				for (const auto& queue : m_queues)
+				{
+					const bool orphaned = queue->orphaned.load();
+
+					if (!queue->empty())
+					{
+						dispatch(*queue);
+						result = true;
+					}
+					else if (orphaned)
+					{
+						orphans = true;
+					}
+				}
+			}
+
+			if (orphans)
+			{
+				std::lock_guard lock(m_mutex);
+
+				std::erase_if(m_queues, [](const std::shared_ptr<thread_queue>& queue)
+					{
+						return queue->orphaned && queue->empty();
+					});
+			}
+
+			return result;
+		}
+
+		void operator()()
+		{
+			thread_base::set_name("Log Dispatcher");
+
+			s_tls_is_dispatcher = true;
+
+			while (true)
+			{
+				const bool stop = m_stop;
+
+				if (dispatch_all())
+				{
+					continue;
+				}
+
+				if (stop)
+				{
+					break;
+				}
+
+				// Producers wake the dispatcher only when it announced going idle
+				m_idle = 1;
+
+				if (dispatch_all())
+				{
+					m_idle = 0;
+					continue;
+				}
+
+				m_idle.wait(1);
+			}
+		}
+
+	public:
+		static const message& report_message();
+
+		// Queue the message for this thread, or write it directly
+		static void submit(const message& msg, const char* fmt, const fmt_type_info* sup, const u64* args, usz argc, bool deferrable);
+
+		dispatcher()
+		{
+			m_thread = std::thread([this]() { (*this)(); });
+			s_dispatcher = this;
+		}
+
+		~dispatcher()
+		{
+			s_dispatcher = nullptr;
+			m_stop = true;
+			wake(true);
+			m_thread.join();
+		}
+
+		std::shared_ptr<thread_queue> make_queue()
+		{
+			auto queue = std::make_shared<thread_queue>();
+
+			std::lock_guard lock(m_mutex);
+			m_queues.emplace_back(queue);
+			return queue;
+		}
+
+		void wake(bool force = false)
+		{
+			if (m_idle.exchange(0) || force)
+			{
+				m_idle.notify_one();
+			}
+		}
+
+		// Wait until the listeners received everything queued so far (bounded, may run in crash handlers)
+		void drain()
+		{
+			if (s_tls_is_dispatcher)
+			{
+				return;
+			}
+
+			wake();
+
+			const auto deadline = steady_clock::now() + 1s;
+
+			while (steady_clock::now() < deadline)
+			{
+				if (m_mutex.try_lock_shared())
+				{
+					const bool empty = std::all_of(m_queues.begin(), m_queues.end(), [](const std::shared_ptr<thread_queue>& queue)
+						{
+							return queue->empty();
+						});
+
+					m_mutex.unlock_shared();
+
+					if (empty)
+					{
+						return;
+					}
+				}
+
+				std::this_thread::yield();
+			}
+		}
+	};
+
+	static dispatcher& get_dispatcher()
+	{
+		static dispatcher s_instance{};
+		return s_instance;
+	}
+
+	struct queue_holder
+	{
+		std::shared_ptr<thread_queue> queue;
+
+		~queue_holder()
+		{
+			s_tls_queue_gone = true;
+
+			if (queue)
+			{
+				queue->orphaned = true;
+			}
+		}
+	};
+
+	// Queue of the current thread, nullptr if messages must be written directly
+	static thread_queue* get_thread_queue()
+	{
+		if (!g_init || s_tls_is_dispatcher || s_tls_queue_gone)
+		{
+			return nullptr;
+		}
+
+		static thread_local queue_holder s_holder{};
+
+		if (!s_holder.queue) [[unlikely]]
+		{
+			s_holder.queue = get_dispatcher().make_queue();
+		}
+
+		return s_holder.queue.get();
+	}
+
+	enum class queue_result
+	{
+		queued,
+		dropped,
+		direct,
+	};
+
+	static queue_result try_queue(thread_queue* queue, const message& msg, u64 stamp, const char* fmt, const fmt_type_info* sup, const u64* args, usz argc, std::string_view prefix, std::string_view text)
+	{
+		const usz size = (sizeof(queued_record) + argc * sizeof(u64) + prefix.size() + text.size() + 7) & ~usz{7};
+
+		if (!queue || size > s_queue_max_record)
+		{
+			return queue_result::direct;
+		}
+
+		const queued_record rec{
+			.size = static_cast<u32>(size),
+			.argc = static_cast<u32>(argc),
+			.prefix_size = static_cast<u32>(prefix.size()),
+			.text_size = static_cast<u32>(text.size()),
+			.msg = &msg,
+			.fmt = fmt,
+			.sup = sup,
+			.stamp = stamp,
+		};
+
+		if (!queue->push(rec, args, prefix, text))
+		{
+			s_dropped++;
+			return queue_result::dropped;
+		}
+
+		s_queued++;
+
+		if (auto d = s_dispatcher.load())
+		{
+			d->wake();
+		}
+
+		return queue_result::queued;
+	}
+
+	// Errors and worse are written synchronously: they usually precede a crash or an abort
+	void dispatcher::submit(const message& msg, const char* fmt, const fmt_type_info* sup, const u64* args, usz argc, bool deferrable)
+	{
+		// Get timestamp
+		const u64 stamp = get_stamp();
+
+		// Notify start operation
+		g_tls_log_control(fmt, 0);
+
+		std::string prefix = g_tls_log_prefix();
+
+		thread_queue* const queue = level(msg) > level::error ? get_thread_queue() : nullptr;
+
+		if (deferrable && try_queue(queue, msg, stamp, fmt, sup, args, argc, prefix, {}) != queue_result::direct)
+		{
+			g_tls_log_control(fmt, -1);
+			return;
+		}
+
+		/*constinit thread_local*/ std::string text;
+		text.reserve(50000);
+		fmt::raw_append(text, fmt, sup ? sup : &s_empty_sup, args);
+
+		if (!deferrable && try_queue(queue, msg, stamp, nullptr, nullptr, nullptr, 0, prefix, text) != queue_result::direct)
+		{
+			g_tls_log_control(fmt, -1);
+			return;
+		}
+
+		s_direct++;
+
+		bool sent = false;
+
+		if (!g_init)
+		{
+			std::lock_guard lock(g_mutex);
+
+			if (!g_init)
+			{
+				msg.dispatch(stamp, prefix, text);
+				sent = true;
+
+				// Store message additionally
+				get_logger()->messages.emplace_back(stored_message{msg, stamp, std::move(prefix), text});
+			}
+		}
+
+		// Send message to all listeners
+		if (!sent)
+		{
+			msg.dispatch(stamp, prefix, text);
+		}
+
+		// Notify end operation
+		g_tls_log_control(fmt, -1);
+	}
+} // namespace logs
+
+LOG_CHANNEL(log_dispatcher, "LOG");
+
+const logs::message& logs::dispatcher::report_message()
+{
+	return log_dispatcher.warning;
+}
+
+logs::async_stats logs::get_async_stats()
+{
+	return {s_queued.load(), s_dropped.load(), s_direct.load()};
+}
+
 logs::listener::~listener()
 {
 	// Shut up all channels on exit
@@ -367,6 +837,12 @@ void logs::listener::close_prematurely()
 
 void logs::listener::sync_all()
 {
+	// Queued messages reach the listeners first
+	if (auto d = s_dispatcher.load())
+	{
+		d->drain();
+	}
+
 	for (listener* lis = get_logger(); lis; lis = lis->m_next)
 	{
 		lis->sync();
@@ -375,6 +851,11 @@ void logs::listener::sync_all()
 
 void logs::listener::close_all_prematurely()
 {
+	if (auto d = s_dispatcher.load())
+	{
+		d->drain();
+	}
+
 	for (listener* lis = get_logger(); lis; lis = lis->m_next)
 	{
 		lis->close_prematurely();
@@ -390,23 +871,13 @@ logs::registerer::registerer(channel& _ch)
 
 void logs::message::broadcast(const char* fmt, const fmt_type_info* sup, ...) const
 {
-	// Get timestamp
-	const u64 stamp = get_stamp();
-
-	// Notify start operation
-	g_tls_log_control(fmt, 0);
-
-	// Get text, extract va_args
-	/*constinit thread_local*/ std::string text;
+	// Extract va_args
 	/*constinit thread_local*/ std::vector<u64> args;
 
-	static constexpr fmt_type_info empty_sup{};
-
 	usz args_count = 0;
 	for (auto v = sup; v && v->fmt_string; v++)
 		args_count++;
 
-	text.reserve(50000);
 	args.resize(args_count);
 
 	va_list c_args;
@@ -414,38 +885,21 @@ void logs::message::broadcast(const char* fmt, const fmt_type_info* sup, ...) co
 	for (u64& arg : args)
 		arg = va_arg(c_args, u64);
 	va_end(c_args);
-	fmt::raw_append(text, fmt, sup ? sup : &empty_sup, args.data());
-	std::string prefix = g_tls_log_prefix();
-
-	// Get first (main) listener
-	listener* lis = get_logger();
 
-	if (!g_init)
-	{
-		std::lock_guard lock(g_mutex);
-
-		if (!g_init)
-		{
-			while (lis)
-			{
-				lis->log(stamp, *this, prefix, text);
-				lis = lis->m_next;
-			}
+	dispatcher::submit(*this, fmt, sup, args.data(), args_count, false);
+}
 
-			// Store message additionally
-			get_logger()->messages.emplace_back(stored_message{*this, stamp, std::move(prefix), text});
-		}
-	}
+void logs::message::defer(const char* fmt, const fmt_type_info* sup, const u64* args, usz count) const
+{
+	dispatcher::submit(*this, fmt, sup, args, count, true);
+}
 
-	// Send message to all listeners
-	while (lis)
+void logs::message::dispatch(u64 stamp, const std::string& prefix, const std::string& text) const
+{
+	for (listener* lis = get_logger(); lis; lis = lis->m_next)
 	{
 		lis->log(stamp, *this, prefix, text);
-		lis = lis->m_next;
 	}
-
-	// Notify end operation
-	g_tls_log_control(fmt, -1);
 }
 
 logs::file_writer::file_writer(const std::string& name, u64 max_size)
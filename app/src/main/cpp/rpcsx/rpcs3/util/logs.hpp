@@ -24,6 +24,16 @@ namespace logs
 
 	struct channel;
 
+	class dispatcher;
+
+	template <typename T>
+	concept deferrable_arg_type = sizeof(T) <= 8 && (std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+		(std::is_pointer_v<T> && !fmt::CharT<std::remove_pointer_t<T>> && !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, wchar_t>));
+
+	// Arguments formatted from their value alone (not by reference): the message can be queued as format string + raw arguments
+	template <typename T>
+	concept deferrable_arg = !requires { typename fmt_unveil<T>::u64_wrapper; } && deferrable_arg_type<fmt_unveil_t<T>>;
+
 	// Message information
 	struct message
 	{
@@ -55,7 +65,14 @@ namespace logs
 		// Send log message to global logger instance
 		void broadcast(const char*, const fmt_type_info*, ...) const;
 
+		// Queue log message for the dispatcher thread (formatted there), or broadcast it now
+		void defer(const char*, const fmt_type_info*, const u64* args, usz count) const;
+
+		// Send formatted message to all listeners
+		void dispatch(u64 stamp, const std::string& prefix, const std::string& text) const;
+
 		friend struct channel;
+		friend class dispatcher;
 	};
 
 	struct stored_message
@@ -100,6 +117,16 @@ namespace logs
 		static void close_all_prematurely();
 	};
 
+	// Counters of the asynchronous log dispatcher
+	struct async_stats
+	{
+		u64 queued;  // Messages handed to the dispatcher thread
+		u64 dropped; // Messages lost to a full per-thread queue
+		u64 direct;  // Messages written on the calling thread (errors, oversized, before init)
+	};
+
+	async_stats get_async_stats();
+
 	struct alignas(16) channel : private message
 	{
 		// Channel prefix (added to every log message)
@@ -145,13 +172,18 @@ namespace logs
 	{
 		if (operator bool()) [[unlikely]]
 		{
-			if constexpr (sizeof...(Args) > 0)
+			if constexpr (sizeof...(Args) == 0)
 			{
-				broadcast(fmt, fmt::type_info_v<Args...>, u64{fmt_unveil<Args>::get(args)}...);
+				defer(fmt, nullptr, nullptr, 0);
+			}
+			else if constexpr ((deferrable_arg<Args> && ...))
+			{
+				const u64 raw[]{u64{fmt_unveil<Args>::get(args)}...};
+				defer(fmt, fmt::type_info_v<Args...>, raw, sizeof...(Args));
 			}
 			else
 			{
-				broadcast(fmt, nullptr);
+				broadcast(fmt, fmt::type_info_v<Args...>, u64{fmt_unveil<Args>::get(args)}...);
 			}
 		}
 	}
@@ -175,11 +175,14 @@ namespace utils
 			requires Integral<T>
 		bool serialize_vle(T&& value)
 		{
-			for (auto i = value;;)
+			// Encode into a local buffer, the whole value is a single raw_serialize
+			u8 buf[(sizeof(value) * 8 + 6) / 7];
+			usz size = 0;
+
+			for (auto i = value; size < std::size(buf);)
 			{
 				const auto i_old = std::exchange(i, i >> 7);
-				const u8 to_write = static_cast<u8>((static_cast<u8>(i_old) % 0x80) | (i ? 0x80 : 0));
-				raw_serialize(&to_write, 1);
+				buf[size++] = static_cast<u8>((static_cast<u8>(i_old) % 0x80) | (i ? 0x80 : 0));
 
 				if (!i)
 				{
@@ -187,7 +190,7 @@ namespace utils
 				}
 			}
 
-			return true;
+			return raw_serialize(buf, size);
 		}
 
 		template <typename T>
@@ -788,8 +788,16 @@ struct compressed_zstd_stream_data
 	ZSTD_DStream* m_zs{};
 	lf_queue<std::vector<u8>> m_queued_data_to_process;
 	lf_queue<std::vector<u8>> m_queued_data_to_write;
+
+	// Filled by the reader thread, an empty chunk marks EOF
+	lf_queue<std::vector<u8>> m_read_ahead_data;
+	atomic_t<usz> m_read_ahead_bytes = 0;
 };
 
+// Read-ahead is bounded so a large savestate is not pulled into memory faster than it is consumed
+constexpr usz zstd_read_ahead_chunk_size = 0x40'0000;
+constexpr usz zstd_read_ahead_max_bytes = 0x200'0000;
+
 void compressed_zstd_serialization_file_handler::initialize(utils::serial& ar)
 {
 	if (!m_stream)
@@ -1077,19 +1085,26 @@ usz compressed_zstd_serialization_file_handler::read_at(utils::serial& ar, usz r
 		}
 
 		const usz add_size = ar.expect_little_data() ? 0x1'0000 : 0x10'0000;
-		const usz old_file_buf_size = m_stream_data.size();
 
-		m_stream_data.resize(old_file_buf_size + add_size);
-		m_stream_data.resize(old_file_buf_size + m_file->read_at(m_file_read_index, m_stream_data.data() + old_file_buf_size, add_size));
+		if (!m_file_reader_thread && !ar.expect_little_data())
+		{
+			// Bulk reading (memory images): keep the file ahead of the decompressor from now on
+			m_file_reader_thread = std::make_unique<named_thread<std::function<void()>>>("CompressedReader Thread"sv, [this, file_pos = m_file_read_index]()
+				{
+					this->file_reader_thread_op(file_pos);
+				});
+		}
 
-		if (m_stream_data.size() == old_file_buf_size)
+		const usz read_bytes = read_file_chunk(add_size);
+
+		if (!read_bytes)
 		{
 			// EOF
 			// ensure(read_size == total_to_read);
 			break;
 		}
 
-		m_file_read_index += m_stream_data.size() - old_file_buf_size;
+		m_file_read_index += read_bytes;
 	}
 
 	if (m_stream_data.size() - m_stream_data_index <= m_stream_data_index / 5)
@@ -1109,6 +1124,88 @@ usz compressed_zstd_serialization_file_handler::read_at(utils::serial& ar, usz r
 	return read_size;
 }
 
+usz compressed_zstd_serialization_file_handler::read_file_chunk(usz max_size)
+{
+	const usz old_file_buf_size = m_stream_data.size();
+
+	if (!m_file_reader_thread)
+	{
+		m_stream_data.resize(old_file_buf_size + max_size);
+		m_stream_data.resize(old_file_buf_size + m_file->read_at(m_file_read_index, m_stream_data.data() + old_file_buf_size, max_size));
+		return m_stream_data.size() - old_file_buf_size;
+	}
+
+	auto& stream = *m_stream;
+
+	while (m_read_ahead_chunks.empty())
+	{
+		for (auto&& chunk : stream.m_read_ahead_data.pop_all())
+		{
+			m_read_ahead_chunks.emplace_back(std::move(chunk));
+		}
+
+		if (m_read_ahead_chunks.empty())
+		{
+			stream.m_read_ahead_data.wait();
+		}
+	}
+
+	if (m_read_ahead_chunks.front().empty())
+	{
+		// EOF, keep the marker for subsequent reads
+		return 0;
+	}
+
+	std::vector<u8> chunk = std::move(m_read_ahead_chunks.front());
+	m_read_ahead_chunks.pop_front();
+
+	const usz chunk_size = chunk.size();
+
+	if (m_stream_data_index == old_file_buf_size)
+	{
+		// Everything before was consumed, adopt the chunk instead of copying it
+		m_stream_data = std::move(chunk);
+		m_stream_data_index = 0;
+	}
+	else
+	{
+		m_stream_data.insert(m_stream_data.end(), chunk.begin(), chunk.end());
+	}
+
+	stream.m_read_ahead_bytes -= chunk_size;
+	stream.m_read_ahead_bytes.notify_one();
+
+	return chunk_size;
+}
+
+void compressed_zstd_serialization_file_handler::file_reader_thread_op(usz file_pos)
+{
+	auto& stream = *m_stream;
+
+	while (thread_ctrl::state() != thread_state::aborting)
+	{
+		if (const usz queued = stream.m_read_ahead_bytes; queued >= zstd_read_ahead_max_bytes)
+		{
+			thread_ctrl::wait_on(stream.m_read_ahead_bytes, queued);
+			continue;
+		}
+
+		std::vector<u8> chunk(zstd_read_ahead_chunk_size);
+		chunk.resize(m_file->read_at(file_pos, chunk.data(), chunk.size()));
+		file_pos += chunk.size();
+
+		const bool eof = chunk.empty();
+
+		stream.m_read_ahead_bytes += chunk.size();
+		stream.m_read_ahead_data.push(std::move(chunk));
+
+		if (eof)
+		{
+			break;
+		}
+	}
+}
+
 void compressed_zstd_serialization_file_handler::skip_until(utils::serial& ar)
 {
 	ensure(!ar.is_writing() && ar.pos >= ar.data_offset);
@@ -1132,6 +1229,12 @@ void compressed_zstd_serialization_file_handler::finalize(utils::serial& ar)
 
 	if (m_read_inited)
 	{
+		// Stop the read-ahead and drop what it fetched
+		m_file_reader_thread.reset();
+		m_read_ahead_chunks.clear();
+		m_stream->m_read_ahead_data.pop_all();
+		m_stream->m_read_ahead_bytes = 0;
+
 		// ZSTD_decompressEnd(m_stream->m_zd);
 		ensure(ZSTD_freeDCtx(m_zd));
 		m_read_inited = false;
@@ -173,10 +173,16 @@ private:
 	std::shared_ptr<compressed_zstd_stream_data> m_stream;
 	std::unique_ptr<named_thread<std::function<void()>>> m_file_writer_thread;
 
+	// Reading: file chunks fetched ahead by the reader thread so file I/O overlaps decompression
+	std::deque<std::vector<u8>> m_read_ahead_chunks;
+	std::unique_ptr<named_thread<std::function<void()>>> m_file_reader_thread;
+
 	usz read_at(utils::serial& ar, usz read_pos, void* data, usz size);
+	usz read_file_chunk(usz max_size);
 	void initialize(utils::serial& ar);
 	void stream_data_prepare_thread_op();
 	void file_writer_thread_op();
+	void file_reader_thread_op(usz file_pos);
 };
 
 template <typename File>
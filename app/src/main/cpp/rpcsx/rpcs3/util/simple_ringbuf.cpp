@@ -7,25 +7,13 @@ simple_ringbuf::simple_ringbuf(u64 size)
 
 simple_ringbuf::~simple_ringbuf()
 {
-	rw_ptr.load(); // Sync
+	read_ptr.load(); // Sync
+	write_ptr.load();
 }
 
 simple_ringbuf::simple_ringbuf(const simple_ringbuf& other)
 {
-	ctr_state old = other.rw_ptr.load();
-
-	for (;;)
-	{
-		buf = other.buf;
-		rw_ptr = old;
-
-		const ctr_state current = other.rw_ptr.load();
-		if (old == current)
-		{
-			break;
-		}
-		old = current;
-	}
+	copy_from(other);
 }
 
 simple_ringbuf& simple_ringbuf::operator=(const simple_ringbuf& other)
@@ -33,31 +21,43 @@ simple_ringbuf& simple_ringbuf::operator=(const simple_ringbuf& other)
 	if (this == &other)
 		return *this;
 
-	ctr_state old = other.rw_ptr.load();
+	copy_from(other);
+
+	return *this;
+}
+
+void simple_ringbuf::copy_from(const simple_ringbuf& other)
+{
+	u64 old_rd = other.read_ptr.load();
+	u64 old_wr = other.write_ptr.load();
 
 	for (;;)
 	{
 		buf = other.buf;
-		rw_ptr = old;
+		read_ptr = old_rd;
+		write_ptr = old_wr;
 
-		const ctr_state current = other.rw_ptr.load();
-		if (old == current)
+		const u64 rd = other.read_ptr.load();
+		const u64 wr = other.write_ptr.load();
+		if (old_rd == rd && old_wr == wr)
 		{
 			break;
 		}
-		old = current;
+		old_rd = rd;
+		old_wr = wr;
 	}
-
-	return *this;
 }
 
 simple_ringbuf::simple_ringbuf(simple_ringbuf&& other)
 {
-	const ctr_state other_rw_ptr = other.rw_ptr.load();
+	const u64 other_rd = other.read_ptr.load();
+	const u64 other_wr = other.write_ptr.load();
 	buf = std::move(other.buf);
-	rw_ptr = other_rw_ptr;
+	read_ptr = other_rd;
+	write_ptr = other_wr;
 
-	other.rw_ptr.store({});
+	other.read_ptr.store(0);
+	other.write_ptr.store(0);
 }
 
 simple_ringbuf& simple_ringbuf::operator=(simple_ringbuf&& other)
@@ -65,45 +65,50 @@ simple_ringbuf& simple_ringbuf::operator=(simple_ringbuf&& other)
 	if (this == &other)
 		return *this;
 
-	const ctr_state other_rw_ptr = other.rw_ptr.load();
+	const u64 other_rd = other.read_ptr.load();
+	const u64 other_wr = other.write_ptr.load();
 	buf = std::move(other.buf);
-	rw_ptr = other_rw_ptr;
+	read_ptr = other_rd;
+	write_ptr = other_wr;
 
-	other.rw_ptr.store({});
+	other.read_ptr.store(0);
+	other.write_ptr.store(0);
 
 	return *this;
 }
 
 u64 simple_ringbuf::get_free_size() const
 {
-	return get_free_size(rw_ptr);
+	const u64 rd = read_ptr.load();
+	return get_free_size(rd, write_ptr.load());
 }
 
 u64 simple_ringbuf::get_used_size() const
 {
-	return get_used_size(rw_ptr);
+	const u64 rd = read_ptr.load();
+	return get_used_size(rd, write_ptr.load());
 }
 
 u64 simple_ringbuf::get_total_size() const
 {
-	rw_ptr.load(); // Sync
+	read_ptr.load(); // Sync
 	return buf.size() - 1;
 }
 
-u64 simple_ringbuf::get_free_size(ctr_state val) const
+u64 simple_ringbuf::get_free_size(u64 rd, u64 wr) const
 {
 	const u64 buf_size = buf.size();
-	const u64 rd = val.read_ptr % buf_size;
-	const u64 wr = val.write_ptr % buf_size;
+	rd %= buf_size;
+	wr %= buf_size;
 
 	return (wr >= rd ? buf_size + rd - wr : rd - wr) - 1;
 }
 
-u64 simple_ringbuf::get_used_size(ctr_state val) const
+u64 simple_ringbuf::get_used_size(u64 rd, u64 wr) const
 {
 	const u64 buf_size = buf.size();
-	const u64 rd = val.read_ptr % buf_size;
-	const u64 wr = val.write_ptr % buf_size;
+	rd %= buf_size;
+	wr %= buf_size;
 
 	return wr >= rd ? wr - rd : buf_size + wr - rd;
 }
@@ -113,93 +118,153 @@ void simple_ringbuf::set_buf_size(u64 size)
 	ensure(size != umax);
 
 	buf.resize(size + 1);
-	rw_ptr.store({});
+	read_ptr.store(0);
+	write_ptr.store(0);
 }
 
 void simple_ringbuf::writer_flush(u64 cnt)
 {
-	rw_ptr.atomic_op([&](ctr_state& val)
+	const u64 wr = write_ptr.observe();
+	u64 rd = read_ptr.load();
+
+	for (;;)
+	{
+		const u64 used = get_used_size(rd, wr);
+		if (used == 0)
+			return;
+
+		if (cnt < used)
 		{
-			const u64 used = get_used_size(val);
-			if (used == 0)
-				return;
+			// Drop the newest data: the reader has not been told about it yet
+			write_ptr.release(wr + buf.size() - cnt);
+			return;
+		}
 
-			val.write_ptr += buf.size() - std::min<u64>(used, cnt);
-		});
+		// Drop everything by catching the reader up, racing with its own read_ptr updates
+		if (read_ptr.compare_exchange(rd, wr))
+			return;
+	}
 }
 
 void simple_ringbuf::reader_flush(u64 cnt)
 {
-	rw_ptr.atomic_op([&](ctr_state& val)
-		{
-			val.read_ptr += std::min(get_used_size(val), cnt);
-		});
+	u64 rd = read_ptr.observe();
+
+	for (;;)
+	{
+		const u64 new_rd = rd + std::min(get_used_size(rd, write_ptr.load()), cnt);
+		if (new_rd == rd || read_ptr.compare_exchange(rd, new_rd))
+			return;
+	}
 }
 
 u64 simple_ringbuf::push(const void* data, u64 size, bool force)
 {
 	ensure(data != nullptr);
 
-	return rw_ptr.atomic_op([&](ctr_state& val) -> u64
-		{
-			const u64 buf_size = buf.size();
-			const u64 old = val.write_ptr % buf_size;
-			const u64 free_size = get_free_size(val);
-			const u64 to_push = std::min(size, free_size);
-			const auto b_data = static_cast<const u8*>(data);
-
-			if (!to_push || (!force && free_size < size))
-			{
-				return 0;
-			}
-
-			if (old + to_push > buf_size)
-			{
-				const auto first_write_sz = buf_size - old;
-				memcpy(&buf[old], b_data, first_write_sz);
-				memcpy(&buf[0], b_data + first_write_sz, to_push - first_write_sz);
-			}
-			else
-			{
-				memcpy(&buf[old], b_data, to_push);
-			}
-
-			val.write_ptr += to_push;
-
-			return to_push;
-		});
+	const u64 buf_size = buf.size();
+	const u64 wr = write_ptr.observe();
+	const u64 old = wr % buf_size;
+	const u64 free_size = get_free_size(read_ptr.load(), wr);
+	const u64 to_push = std::min(size, free_size);
+	const auto b_data = static_cast<const u8*>(data);
+
+	if (!to_push || (!force && free_size < size))
+	{
+		return 0;
+	}
+
+	if (old + to_push > buf_size)
+	{
+		const auto first_write_sz = buf_size - old;
+		memcpy(&buf[old], b_data, first_write_sz);
+		memcpy(&buf[0], b_data + first_write_sz, to_push - first_write_sz);
+	}
+	else
+	{
+		memcpy(&buf[old], b_data, to_push);
+	}
+
+	write_ptr.release(wr + to_push);
+
+	return to_push;
+}
+
+std::span<u8> simple_ringbuf::get_write_span()
+{
+	const u64 buf_size = buf.size();
+	const u64 wr = write_ptr.observe();
+	const u64 old = wr % buf_size;
+	const u64 free_size = get_free_size(read_ptr.load(), wr);
+
+	return {buf.data() + old, std::min(free_size, buf_size - old)};
+}
+
+void simple_ringbuf::commit_write(u64 size)
+{
+	const u64 wr = write_ptr.observe();
+	ensure(size <= std::min(get_free_size(read_ptr.load(), wr), buf.size() - wr % buf.size()));
+
+	if (size)
+	{
+		write_ptr.release(wr + size);
+	}
 }
 
 u64 simple_ringbuf::pop(void* data, u64 size, bool force)
 {
 	ensure(data != nullptr);
 
-	return rw_ptr.atomic_op([&](ctr_state& val) -> u64
+	const u64 buf_size = buf.size();
+	const auto b_data = static_cast<u8*>(data);
+	u64 rd = read_ptr.observe();
+
+	for (;;)
+	{
+		const u64 old = rd % buf_size;
+		const u64 used_size = get_used_size(rd, write_ptr.load());
+		const u64 to_pop = std::min(size, used_size);
+
+		if (!to_pop || (!force && used_size < size))
 		{
-			const u64 buf_size = buf.size();
-			const u64 old = val.read_ptr % buf_size;
-			const u64 used_size = get_used_size(val);
-			const u64 to_pop = std::min(size, used_size);
-			const auto b_data = static_cast<u8*>(data);
-
-			if (!to_pop || (!force && used_size < size))
-			{
-				return 0;
-			}
-
-			if (old + to_pop > buf_size)
-			{
-				const auto first_read_sz = buf_size - old;
-				memcpy(b_data, &buf[old], first_read_sz);
-				memcpy(b_data + first_read_sz, &buf[0], to_pop - first_read_sz);
-			}
-			else
-			{
-				memcpy(b_data, &buf[old], to_pop);
-			}
-
-			val.read_ptr += to_pop;
+			return 0;
+		}
 
+		if (old + to_pop > buf_size)
+		{
+			const auto first_read_sz = buf_size - old;
+			memcpy(b_data, &buf[old], first_read_sz);
+			memcpy(b_data + first_read_sz, &buf[0], to_pop - first_read_sz);
+		}
+		else
+		{
+			memcpy(b_data, &buf[old], to_pop);
+		}
+
+		// Fails only if writer_flush() dropped the data meanwhile: retry from the new position
+		if (read_ptr.compare_exchange(rd, rd + to_pop))
+		{
 			return to_pop;
-		});
+		}
+	}
+}
+
+std::span<const u8> simple_ringbuf::get_read_span()
+{
+	const u64 buf_size = buf.size();
+	const u64 rd = read_ptr.observe();
+	read_span_ptr = rd;
+	const u64 old = rd % buf_size;
+	const u64 used_size = get_used_size(rd, write_ptr.load());
+
+	return {buf.data() + old, std::min(used_size, buf_size - old)};
+}
+
+bool simple_ringbuf::commit_read(u64 size)
+{
+	// Compare against the position the span was taken at, not the current one
+	u64 rd = read_span_ptr;
+	ensure(size <= buf.size() - rd % buf.size());
+
+	return !size || read_ptr.compare_exchange(rd, rd + size);
 }
@@ -2,9 +2,13 @@
 
 #include "util/types.hpp"
 #include "util/atomic.hpp"
+#include <span>
 #include <vector>
 
 // Single reader/writer simple ringbuffer.
+// The writer owns write_ptr and the reader owns read_ptr, each on its own cache line: data is copied
+// without holding any lock and published with a release store of the owner's counter.
+// Sizes queried from a third thread are a snapshot and may be off by an in-flight push/pop.
 class simple_ringbuf
 {
 public:
@@ -28,25 +32,29 @@ public:
 	u64 push(const void* data, u64 size, bool force = false);
 	void writer_flush(u64 cnt = umax);
 
+	// Zero-copy writer access: contiguous free space at the write position (may be shorter than
+	// get_free_size() at the wrap point). Fill it, then publish the filled part with commit_write().
+	std::span<u8> get_write_span();
+	void commit_write(u64 size);
+
 	// Reader functions
 	u64 pop(void* data, u64 size, bool force = false);
 	void reader_flush(u64 cnt = umax);
 
-private:
-	struct ctr_state
-	{
-		alignas(sizeof(u64) * 2)
-			u64 read_ptr = 0;
-		u64 write_ptr = 0;
-
-		auto operator<=>(const ctr_state& other) const = default;
-	};
+	// Zero-copy reader access: contiguous readable data at the read position. Returns false from
+	// commit_read() if a concurrent writer_flush() discarded the data, which must then be ignored.
+	std::span<const u8> get_read_span();
+	bool commit_read(u64 size);
 
-	static_assert(sizeof(ctr_state) == sizeof(u64) * 2);
+private:
+	// Only the reader advances read_ptr, except writer_flush() dropping all data (hence CAS on it)
+	alignas(64) atomic_t<u64> read_ptr{};
+	u64 read_span_ptr = 0; // Reader-only: read_ptr seen by the last get_read_span()
+	alignas(64) atomic_t<u64> write_ptr{};
+	alignas(64) std::vector<u8> buf{};
 
-	atomic_t<ctr_state> rw_ptr{};
-	std::vector<u8> buf{};
+	void copy_from(const simple_ringbuf& other);
 
-	u64 get_free_size(ctr_state val) const;
-	u64 get_used_size(ctr_state val) const;
+	u64 get_free_size(u64 rd, u64 wr) const;
+	u64 get_used_size(u64 rd, u64 wr) const;
 };
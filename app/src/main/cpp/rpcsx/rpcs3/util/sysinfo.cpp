@@ -6,6 +6,9 @@
 
 #if defined(ARCH_ARM64)
 #include "Emu/CPU/Backends/AArch64/AArch64Common.h"
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
 #endif
 
 #ifdef _WIN32
@@ -422,6 +425,19 @@ bool utils::has_um_wait()
 	return g_value;
 }
 
+bool utils::has_sve2()
+{
+#if defined(ARCH_ARM64) && defined(__linux__)
+#ifndef HWCAP2_SVE2
+#define HWCAP2_SVE2 (1 << 1)
+#endif
+	static const bool g_value = (getauxval(AT_HWCAP2) & HWCAP2_SVE2) != 0;
+	return g_value;
+#else
+	return false;
+#endif
+}
+
 u32 utils::get_rep_movsb_threshold()
 {
 	static const u32 g_value = []()
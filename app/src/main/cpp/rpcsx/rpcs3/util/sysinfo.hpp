@@ -55,6 +55,8 @@ namespace utils
 
 	bool has_um_wait();
 
+	bool has_sve2();
+
 	std::string get_cpu_brand();
 
 	std::string get_system_info();
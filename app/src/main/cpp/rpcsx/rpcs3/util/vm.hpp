@@ -51,6 +51,9 @@ namespace utils
 	// Set memory protection
 	void memory_protect(void* pointer, usz size, protection prot);
 
+	// Ask for transparent huge pages on the 2 MiB aligned part of the range, returns false if the hint was rejected
+	bool memory_advise_hugepages(void* pointer, usz size);
+
 	// Lock pages in memory
 	bool memory_lock(void* pointer, usz size);
 
@@ -462,6 +462,29 @@ namespace utils
 #endif
 	}
 
+	bool memory_advise_hugepages([[maybe_unused]] void* pointer, [[maybe_unused]] usz size)
+	{
+#ifdef _WIN32
+		return false;
+#else
+		if constexpr (c_madv_hugepage == 0)
+		{
+			return false;
+		}
+
+		// Protection changes on smaller ranges (e.g. write watches) make the kernel split the huge page mapping again
+		const u64 begin = rx::alignUp(reinterpret_cast<u64>(pointer), 0x200000);
+		const u64 end = (reinterpret_cast<u64>(pointer) + size) & -0x200000ull;
+
+		if (begin >= end)
+		{
+			return false;
+		}
+
+		return ::madvise(reinterpret_cast<void*>(begin), end - begin, c_madv_hugepage) == 0;
+#endif
+	}
+
 	bool memory_lock(void* pointer, usz size)
 	{
 		if (!size)
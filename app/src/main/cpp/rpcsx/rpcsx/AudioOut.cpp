@@ -2,9 +2,11 @@
 #include "rx/format.hpp"
 #include "rx/mem.hpp"
 #include "rx/watchdog.hpp"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <fcntl.h>
+#include <memory>
 #include <mutex>
 #include <orbis/evf.hpp>
 #include <orbis/utils/Logs.hpp>
@@ -23,19 +25,59 @@ AudioOut::AudioOut() {
 
 AudioOut::~AudioOut() {
   exit = true;
-  for (auto &thread : threads) {
-    thread.join();
+  if (mixerThread.joinable()) {
+    mixerThread.join();
   }
   sox_quit();
 }
 
 void AudioOut::start() {
   std::lock_guard lock(thrMtx);
-  threads.emplace_back(
-      [this, channelInfo = channelInfo] { channelEntry(channelInfo); });
+  pendingChannels.push_back(channelInfo);
+  hasPendingChannels.store(true, std::memory_order::release);
+
+  if (!mixerThread.joinable()) {
+    mixerThread = std::thread([this] { mixerEntry(); });
+  }
 }
 
-void AudioOut::channelEntry(AudioOutChannelInfo info) {
+namespace {
+constexpr unsigned kMixerChannels = 2;
+constexpr unsigned kMixerFrames = 256; // smallest port granularity
+constexpr sox_rate_t kMixerRate = 48000; // probably there is no point to parse
+                                         // frequency, because it's always 48000
+
+struct MixerChannel {
+  AudioOutChannelInfo info;
+  int controlFd = -1;
+  int bufferFd = -1;
+  std::uint8_t *controlPtr = nullptr;
+  std::size_t controlSize = 0;
+  void *audioBuffer = nullptr;
+  std::size_t bufferSize = 0;
+  AudioOutParams *params = nullptr;
+
+  // zero until the port parameters are initialized
+  unsigned inChannels = 0;
+  unsigned inSamples = 0;
+  bool isFloat = false;
+
+  // frames of the current buffer already mixed
+  unsigned position = 0;
+  bool drained = false;
+
+  explicit MixerChannel(const AudioOutChannelInfo &info);
+  MixerChannel(const MixerChannel &) = delete;
+  MixerChannel &operator=(const MixerChannel &) = delete;
+  ~MixerChannel();
+
+  bool configure();
+  void mix(float *output, unsigned frames);
+  void release();
+};
+} // namespace
+
+MixerChannel::MixerChannel(const AudioOutChannelInfo &info) : info(info) {
   char control_shm_name[128];
   char audio_shm_name[128];
 
@@ -47,7 +89,7 @@ void AudioOut::channelEntry(AudioOutChannelInfo info) {
       rx::getShmGuestPath(rx::format("shm_{}_{}_A", info.channel, info.port))
           .string());
 
-  int controlFd = ::open(control_shm_name, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  controlFd = ::open(control_shm_name, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
   if (controlFd == -1) {
     perror("shm_open");
     std::abort();
@@ -59,15 +101,15 @@ void AudioOut::channelEntry(AudioOutChannelInfo info) {
     std::abort();
   }
 
-  auto controlPtr = reinterpret_cast<std::uint8_t *>(
-      rx::mem::map(nullptr, controlStat.st_size, PROT_READ | PROT_WRITE,
-                   MAP_SHARED, controlFd));
+  controlSize = controlStat.st_size;
+  controlPtr = reinterpret_cast<std::uint8_t *>(rx::mem::map(
+      nullptr, controlSize, PROT_READ | PROT_WRITE, MAP_SHARED, controlFd));
   if (controlPtr == MAP_FAILED) {
     perror("mmap");
     std::abort();
   }
 
-  int bufferFd = ::open(audio_shm_name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+  bufferFd = ::open(audio_shm_name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
   if (bufferFd == -1) {
     perror("open");
     std::abort();
@@ -79,26 +121,35 @@ void AudioOut::channelEntry(AudioOutChannelInfo info) {
     std::abort();
   }
 
-  auto audioBuffer = ::mmap(NULL, bufferStat.st_size, PROT_READ | PROT_WRITE,
-                            MAP_SHARED, bufferFd, 0);
-  auto bitPattern = 1u << info.port;
+  bufferSize = bufferStat.st_size;
+  audioBuffer = ::mmap(NULL, bufferSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       bufferFd, 0);
 
   auto portOffset = 32 + 0x94 * info.port * 4;
+  params = reinterpret_cast<AudioOutParams *>(controlPtr + portOffset);
+}
+
+MixerChannel::~MixerChannel() {
+  ::munmap(audioBuffer, bufferSize);
+  ::munmap(controlPtr, controlSize);
 
-  auto *params = reinterpret_cast<AudioOutParams *>(controlPtr + portOffset);
+  ::close(controlFd);
+  ::close(bufferFd);
+}
 
+bool MixerChannel::configure() {
   // samples length will be inited after some time, so we wait for it
-  while (params->sampleLength == 0) {
+  if (params->sampleLength == 0) {
+    return false;
   }
 
   ORBIS_LOG_NOTICE("AudioOut: params", params->port, params->control,
                    params->formatChannels, params->formatIsFloat,
                    params->formatIsStd, params->freq, params->sampleLength);
 
-  unsigned inChannels = 2;
-  unsigned inSamples = params->sampleLength;
-  sox_rate_t sampleRate = 48000; // probably there is no point to parse
-                                 // frequency, because it's always 48000
+  inChannels = 2;
+  inSamples = params->sampleLength;
+  isFloat = params->formatIsFloat;
   if (params->formatChannels == 2 && !params->formatIsFloat) {
     inChannels = 1;
     ORBIS_LOG_NOTICE(
@@ -139,62 +190,126 @@ void AudioOut::channelEntry(AudioOutChannelInfo info) {
     ORBIS_LOG_ERROR("AudioOut: unknown format type");
   }
 
+  return true;
+}
+
+void MixerChannel::mix(float *output, unsigned frames) {
+  auto count = std::min(frames, inSamples - position);
+  auto offset = std::size_t(position) * inChannels;
+
+  auto sample = [&](std::size_t index) {
+    if (isFloat) {
+      return reinterpret_cast<const float *>(audioBuffer)[offset + index];
+    }
+
+    return reinterpret_cast<const std::int16_t *>(audioBuffer)[offset + index] *
+           (1.f / 32768.f);
+  };
+
+  for (unsigned frame = 0; frame < count; ++frame, offset += inChannels) {
+    float left;
+    float right;
+
+    if (inChannels == 1) {
+      left = right = sample(0);
+    } else if (inChannels == 2) {
+      left = sample(0);
+      right = sample(1);
+    } else {
+      // both 8ch layouts keep left side channels on even, right side channels
+      // on odd slots after center and lfe, lfe is dropped
+      constexpr float kSide = 0.70710678f;
+      auto center = sample(2) * kSide;
+      left = sample(0) + center + (sample(4) + sample(6)) * kSide;
+      right = sample(1) + center + (sample(5) + sample(7)) * kSide;
+    }
+
+    output[frame * kMixerChannels] += left;
+    output[frame * kMixerChannels + 1] += right;
+  }
+
+  position += count;
+  drained = position >= inSamples;
+}
+
+void MixerChannel::release() {
+  position = 0;
+  drained = false;
+
+  // set zero to freeing audiooutput
+  params->control = 0;
+
+  // skip sceAudioOutMix%x event
+  info.evf->set(1u << info.port);
+}
+
+void AudioOut::mixerEntry() {
   sox_signalinfo_t out_si = {
-      .rate = sampleRate,
-      .channels = inChannels,
+      .rate = kMixerRate,
+      .channels = kMixerChannels,
       .precision = SOX_SAMPLE_PRECISION,
   };
 
-  // need to be locked because libsox doesn't like simultaneous opening of the
-  // output
-  std::unique_lock lock(soxMtx);
   sox_format_t *output =
       sox_open_write("default", &out_si, NULL, "alsa", nullptr, nullptr);
-  soxMtx.unlock();
 
   if (!output) {
     std::abort();
   }
 
-  std::vector<sox_sample_t> samples(inSamples * inChannels);
+  std::vector<std::unique_ptr<MixerChannel>> channels;
+  std::vector<float> mix(kMixerFrames * kMixerChannels);
+  std::vector<sox_sample_t> samples(mix.size());
 
   std::size_t clips = 0;
   SOX_SAMPLE_LOCALS;
 
   while (!exit.load(std::memory_order::relaxed)) {
-    if (params->control == 0) {
-      std::this_thread::sleep_for(std::chrono::microseconds(10));
-      continue;
+    if (hasPendingChannels.exchange(false, std::memory_order::acquire)) {
+      std::lock_guard lock(thrMtx);
+      for (auto &info : pendingChannels) {
+        channels.push_back(std::make_unique<MixerChannel>(info));
+      }
+      pendingChannels.clear();
     }
 
-    if (!params->formatIsFloat) {
-      auto data = reinterpret_cast<const std::int16_t *>(audioBuffer);
-      for (std::size_t i = 0; i < samples.size(); i++) {
-        samples[i] = SOX_SIGNED_16BIT_TO_SAMPLE(data[i], clips);
+    std::ranges::fill(mix, 0.f);
+    bool active = false;
+
+    for (auto &channel : channels) {
+      if (channel->inChannels == 0 && !channel->configure()) {
+        continue;
       }
-    } else {
-      auto data = reinterpret_cast<const float *>(audioBuffer);
-      for (std::size_t i = 0; i < samples.size(); i++) {
-        samples[i] = SOX_FLOAT_32BIT_TO_SAMPLE(data[i], clips);
+
+      if (channel->params->control == 0) {
+        continue;
       }
+
+      channel->mix(mix.data(), kMixerFrames);
+      active = true;
+    }
+
+    if (!active) {
+      std::this_thread::sleep_for(std::chrono::microseconds(10));
+      continue;
+    }
+
+    for (std::size_t i = 0; i < mix.size(); i++) {
+      samples[i] = SOX_FLOAT_32BIT_TO_SAMPLE(mix[i], clips);
     }
 
     if (sox_write(output, samples.data(), samples.size()) != samples.size()) {
       ORBIS_LOG_ERROR("AudioOut: sox_write failed");
     }
 
-    // set zero to freeing audiooutput
-    params->control = 0;
-
-    // skip sceAudioOutMix%x event
-    info.evf->set(bitPattern);
+    // buffers are handed back once they were played, like the output used to
+    // pace every port
+    for (auto &channel : channels) {
+      if (channel->drained) {
+        channel->release();
+      }
+    }
   }
 
   sox_close(output);
-
-  ::munmap(audioBuffer, bufferStat.st_size);
-  ::munmap(controlPtr, controlStat.st_size);
-
-  ::close(controlFd);
-  ::close(bufferFd);
 }
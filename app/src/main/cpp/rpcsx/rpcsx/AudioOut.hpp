@@ -38,10 +38,13 @@ struct AudioOutParams {
   std::uint32_t sampleLength{};
 };
 
+// All ports are mixed to a single stereo output by one thread, started with
+// the first port
 struct AudioOut : rx::RcBase {
   std::mutex thrMtx;
-  std::mutex soxMtx;
-  std::vector<std::thread> threads;
+  std::thread mixerThread;
+  std::vector<AudioOutChannelInfo> pendingChannels;
+  std::atomic<bool> hasPendingChannels{false};
   AudioOutChannelInfo channelInfo;
   std::atomic<bool> exit{false};
 
@@ -51,5 +54,5 @@ struct AudioOut : rx::RcBase {
   void start();
 
 private:
-  void channelEntry(AudioOutChannelInfo info);
+  void mixerEntry();
 };
@@ -1,12 +1,26 @@
 #pragma once
 
+#include <string>
+
 namespace rx {
+enum class FramePacing {
+  Off,
+  // present on the next refresh after the frame is ready
+  LowLatency,
+  // hold frames to keep an even number of refreshes between presents
+  Smooth,
+};
+
 // FIXME: serialization
 struct Config {
   int gpuIndex = 0;
   bool validateGpu = false;
   bool disableGpuCache = false;
+  bool disableGpuHostImport = false;
+  bool disableCpuTiler = false;
   bool debugGpu = false;
+  std::string shaderCachePath;
+  FramePacing framePacing = FramePacing::Off;
 };
 
 extern Config g_config;
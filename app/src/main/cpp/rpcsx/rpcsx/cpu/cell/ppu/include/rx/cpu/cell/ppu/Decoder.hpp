@@ -8,7 +8,9 @@
 namespace rx::cell::ppu {
 template <typename T> using DecoderTable = std::array<T, 0x20000>;
 
-extern DecoderTable<Opcode> g_ppuOpcodeTable;
+// Generated at compile time: primary opcode in bits 0..5 of the index, extended
+// opcode above it, so decoding is a single indexed load
+extern const DecoderTable<Opcode> g_ppuOpcodeTable;
 // extern std::array<Form, rx::fieldCount<Opcode>> g_opcodeForms;
 
 inline Opcode getOpcode(std::uint32_t instruction) {
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
+
 namespace rx::cell::ppu {
-enum class Opcode {
+// 16-bit so the 128K-entry decoder table stays at 256 KiB of read-only data
+enum class Opcode : std::uint16_t {
   Invalid,
 
   MFVSCR,
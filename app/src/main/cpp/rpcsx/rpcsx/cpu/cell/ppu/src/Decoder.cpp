@@ -335,7 +335,7 @@ buildOpcodeTable() {
   return result;
 }
 
-rx::cell::ppu::DecoderTable<rx::cell::ppu::Opcode>
+constinit const rx::cell::ppu::DecoderTable<rx::cell::ppu::Opcode>
     rx::cell::ppu::g_ppuOpcodeTable = buildOpcodeTable();
 
 rx::cell::ppu::Opcode rx::cell::ppu::fixOpcode(Opcode opcode,
@@ -1,6 +1,7 @@
 #include "Cache.hpp"
 #include "Device.hpp"
 #include "amdgpu/tiler.hpp"
+#include "amdgpu/tiler_cpu.hpp"
 #include "gnm/vulkan.hpp"
 #include "rx/Config.hpp"
 #include "rx/Rc.hpp"
@@ -155,9 +156,54 @@ shader::eval::Value Cache::ShaderResources::eval(shader::ir::Value op) {
   return Evaluator::eval(op);
 }
 
-void Cache::ShaderResources::loadResources(
-    gcn::Resources &res, std::span<const std::uint32_t> userSgprs) {
-  this->userSgprs = userSgprs;
+void Cache::ShaderResources::evaluateResources(gcn::Resources &res,
+                                               ResourceSnapshot &snapshot) {
+  snapshot.valid = false;
+  snapshot.userSgprs.assign(userSgprs.begin(), userSgprs.end());
+  snapshot.reads.clear();
+  snapshot.pointers.clear();
+  snapshot.buffers.clear();
+  snapshot.imageBuffers.clear();
+  snapshot.textures.clear();
+  snapshot.samplers.clear();
+
+  // drop values of the previous evaluation so every memory read the
+  // descriptors depend on is recorded
+  Evaluator::invalidate();
+  recordedReads = &snapshot.reads;
+
+  auto evalWords = [this](std::span<const ir::Value> words, void *result) {
+    auto resultWords = static_cast<std::uint32_t *>(result);
+
+    for (auto word : words) {
+      auto value = eval(word).zExtScalar();
+      if (!value) {
+        return false;
+      }
+
+      *resultWords++ = static_cast<std::uint32_t>(*value);
+    }
+
+    return true;
+  };
+
+  auto evalTBuffer = [&](std::span<const ir::Value, 8> words) {
+    gnm::TBuffer tbuffer{};
+    if (!evalWords(words.first(4), &tbuffer)) {
+      res.dump();
+      rx::die("failed to evaluate 128 bit T#");
+    }
+
+    if (words[4] != nullptr &&
+        !evalWords(words.subspan(4),
+                   reinterpret_cast<std::uint32_t *>(&tbuffer) + 4)) {
+      res.dump();
+      rx::die("failed to evaluate 256 bit T#");
+    }
+
+    return tbuffer;
+  };
+
   for (auto &pointer : res.pointers) {
     auto pointerBase = eval(pointer.base).zExtScalar();
     auto pointerOffset = eval(pointer.offset).zExtScalar();
@@ -167,33 +213,101 @@ void Cache::ShaderResources::loadResources(
       rx::die("failed to evaluate pointer");
     }
 
-    bufferMemoryTable.map(*pointerBase + *pointerOffset,
-                          *pointerBase + *pointerOffset + pointer.size,
-                          Access::Read);
-    resourceSlotToAddress.emplace_back(slotOffset + pointer.resourceSlot,
-                                       *pointerBase + *pointerOffset);
+    snapshot.pointers.push_back(*pointerBase + *pointerOffset);
   }
 
   for (auto &bufferRes : res.buffers) {
-    auto word0 = eval(bufferRes.words[0]).zExtScalar();
-    auto word1 = eval(bufferRes.words[1]).zExtScalar();
-    auto word2 = eval(bufferRes.words[2]).zExtScalar();
-    auto word3 = eval(bufferRes.words[3]).zExtScalar();
-
-    if (!word0 || !word1 || !word2 || !word3) {
+    gnm::VBuffer buffer{};
+    if (!evalWords(bufferRes.words, &buffer)) {
       res.dump();
       rx::die("failed to evaluate V#");
     }
 
-    gnm::VBuffer buffer{};
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&buffer), &*word0,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&buffer) + 1, &*word1,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&buffer) + 2, &*word2,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&buffer) + 3, &*word3,
-                sizeof(std::uint32_t));
+    snapshot.buffers.push_back(buffer);
+  }
+
+  for (auto &imageBuffer : res.imageBuffers) {
+    auto tbuffer = evalTBuffer(imageBuffer.words);
+
+    auto info = computeSurfaceInfo(
+        getDefaultTileModes()[tbuffer.tiling_idx], tbuffer.type, tbuffer.dfmt,
+        tbuffer.width + 1, tbuffer.height + 1, tbuffer.depth + 1,
+        tbuffer.pitch + 1, 0, tbuffer.last_array + 1, 0, tbuffer.last_level + 1,
+        tbuffer.pow2pad != 0);
+
+    snapshot.imageBuffers.emplace_back(tbuffer, info.totalTiledSize);
+  }
+
+  for (auto &texture : res.textures) {
+    snapshot.textures.push_back(evalTBuffer(texture.words));
+  }
+
+  for (auto &sampler : res.samplers) {
+    gnm::SSampler sSampler{};
+    if (!evalWords(sampler.words, &sSampler)) {
+      res.dump();
+      rx::die("failed to evaluate S#");
+    }
+
+    if (sampler.unorm) {
+      sSampler.force_unorm_coords = true;
+    }
+
+    snapshot.samplers.push_back(sSampler);
+  }
+
+  recordedReads = nullptr;
+  snapshot.valid = true;
+}
+
+bool Cache::ShaderResources::isInSync(const ResourceSnapshot &snapshot) {
+  if (!snapshot.valid || !std::ranges::equal(snapshot.userSgprs, userSgprs)) {
+    return false;
+  }
+
+  for (auto &[address, bytes] : snapshot.reads) {
+    if (cacheTag->compareMemory(bytes.data(), rx::AddressRange::fromBeginSize(
+                                                  address, bytes.size())) !=
+        0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Cache::ShaderResources::loadResources(
+    gcn::Resources &res, std::span<const std::uint32_t> userSgprs,
+    ResourceSnapshot &snapshot) {
+  this->userSgprs = userSgprs;
+
+  auto cache = cacheTag->getCache();
+  if (isInSync(snapshot)) {
+    cache->mResourceReuseCount.fetch_add(1, std::memory_order::relaxed);
+  } else {
+    cache->mResourceEvalCount.fetch_add(1, std::memory_order::relaxed);
+    evaluateResources(res, snapshot);
+  }
+
+  if (rx::g_config.debugGpu) {
+    auto stats = cache->getResourceReuseStats();
+    auto total = stats.reused + stats.evaluated;
+    if (total % 0x10000 == 0) {
+      rx::println(stderr, "shader resources: reused {} of {} bindings",
+                  stats.reused, total);
+    }
+  }
+
+  for (std::size_t i = 0; auto &pointer : res.pointers) {
+    auto address = snapshot.pointers[i++];
+
+    bufferMemoryTable.map(address, address + pointer.size, Access::Read);
+    resourceSlotToAddress.emplace_back(slotOffset + pointer.resourceSlot,
+                                       address);
+  }
+
+  for (std::size_t i = 0; auto &bufferRes : res.buffers) {
+    auto &buffer = snapshot.buffers[i++];
 
     if (auto it = bufferMemoryTable.queryArea(buffer.address());
         it != bufferMemoryTable.end() &&
@@ -207,109 +321,24 @@ void Cache::ShaderResources::loadResources(
                                        buffer.address());
   }
 
-  for (auto &imageBuffer : res.imageBuffers) {
-    auto word0 = eval(imageBuffer.words[0]).zExtScalar();
-    auto word1 = eval(imageBuffer.words[1]).zExtScalar();
-    auto word2 = eval(imageBuffer.words[2]).zExtScalar();
-    auto word3 = eval(imageBuffer.words[3]).zExtScalar();
-
-    if (!word0 || !word1 || !word2 || !word3) {
-      res.dump();
-      rx::die("failed to evaluate V#");
-    }
-
-    gnm::TBuffer tbuffer{};
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer), &*word0,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 1, &*word1,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 2, &*word2,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 3, &*word3,
-                sizeof(std::uint32_t));
-
-    if (imageBuffer.words[4] != nullptr) {
-      auto word4 = eval(imageBuffer.words[4]).zExtScalar();
-      auto word5 = eval(imageBuffer.words[5]).zExtScalar();
-      auto word6 = eval(imageBuffer.words[6]).zExtScalar();
-      auto word7 = eval(imageBuffer.words[7]).zExtScalar();
-
-      if (!word4 || !word5 || !word6 || !word7) {
-        res.dump();
-        rx::die("failed to evaluate 256 bit T#");
-      }
-
-      std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 4, &*word4,
-                  sizeof(std::uint32_t));
-      std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 5, &*word5,
-                  sizeof(std::uint32_t));
-      std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 6, &*word6,
-                  sizeof(std::uint32_t));
-      std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 7, &*word7,
-                  sizeof(std::uint32_t));
-    }
-
-    auto info = computeSurfaceInfo(
-        getDefaultTileModes()[tbuffer.tiling_idx], tbuffer.type, tbuffer.dfmt,
-        tbuffer.width + 1, tbuffer.height + 1, tbuffer.depth + 1,
-        tbuffer.pitch + 1, 0, tbuffer.last_array + 1, 0, tbuffer.last_level + 1,
-        tbuffer.pow2pad != 0);
+  for (std::size_t i = 0; auto &imageBuffer : res.imageBuffers) {
+    auto &[tbuffer, tiledSize] = snapshot.imageBuffers[i++];
 
     if (auto it = imageMemoryTable.queryArea(tbuffer.address());
         it != imageMemoryTable.end() &&
-        it.beginAddress() == tbuffer.address() &&
-        it.size() == info.totalTiledSize) {
+        it.beginAddress() == tbuffer.address() && it.size() == tiledSize) {
       it.get().second |= imageBuffer.access;
     } else {
       imageMemoryTable.map(
-          tbuffer.address(), tbuffer.address() + info.totalTiledSize,
+          tbuffer.address(), tbuffer.address() + tiledSize,
           {ImageBufferKey::createFrom(tbuffer), imageBuffer.access});
     }
     resourceSlotToAddress.emplace_back(slotOffset + imageBuffer.resourceSlot,
                                        tbuffer.address());
   }
 
-  for (auto &texture : res.textures) {
-    auto word0 = eval(texture.words[0]).zExtScalar();
-    auto word1 = eval(texture.words[1]).zExtScalar();
-    auto word2 = eval(texture.words[2]).zExtScalar();
-    auto word3 = eval(texture.words[3]).zExtScalar();
-
-    if (!word0 || !word1 || !word2 || !word3) {
-      res.dump();
-      rx::die("failed to evaluate 128 bit T#");
-    }
-
-    gnm::TBuffer tbuffer{};
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer), &*word0,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 1, &*word1,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 2, &*word2,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 3, &*word3,
-                sizeof(std::uint32_t));
-
-    if (texture.words[4] != nullptr) {
-      auto word4 = eval(texture.words[4]).zExtScalar();
-      auto word5 = eval(texture.words[5]).zExtScalar();
-      auto word6 = eval(texture.words[6]).zExtScalar();
-      auto word7 = eval(texture.words[7]).zExtScalar();
-
-      if (!word4 || !word5 || !word6 || !word7) {
-        res.dump();
-        rx::die("failed to evaluate 256 bit T#");
-      }
-
-      std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 4, &*word4,
-                  sizeof(std::uint32_t));
-      std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 5, &*word5,
-                  sizeof(std::uint32_t));
-      std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 6, &*word6,
-                  sizeof(std::uint32_t));
-      std::memcpy(reinterpret_cast<std::uint32_t *>(&tbuffer) + 7, &*word7,
-                  sizeof(std::uint32_t));
-    }
+  for (std::size_t i = 0; auto &texture : res.textures) {
+    auto &tbuffer = snapshot.textures[i++];
 
     std::vector<amdgpu::Cache::ImageView> *resources = nullptr;
 
@@ -339,30 +368,8 @@ void Cache::ShaderResources::loadResources(
         amdgpu::ImageViewKey::createFrom(tbuffer), texture.access));
   }
 
-  for (auto &sampler : res.samplers) {
-    auto word0 = eval(sampler.words[0]).zExtScalar();
-    auto word1 = eval(sampler.words[1]).zExtScalar();
-    auto word2 = eval(sampler.words[2]).zExtScalar();
-    auto word3 = eval(sampler.words[3]).zExtScalar();
-
-    if (!word0 || !word1 || !word2 || !word3) {
-      res.dump();
-      rx::die("failed to evaluate S#");
-    }
-
-    gnm::SSampler sSampler{};
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&sSampler), &*word0,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&sSampler) + 1, &*word1,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&sSampler) + 2, &*word2,
-                sizeof(std::uint32_t));
-    std::memcpy(reinterpret_cast<std::uint32_t *>(&sSampler) + 3, &*word3,
-                sizeof(std::uint32_t));
-
-    if (sampler.unorm) {
-      sSampler.force_unorm_coords = true;
-    }
+  for (std::size_t i = 0; auto &sampler : res.samplers) {
+    auto &sSampler = snapshot.samplers[i++];
 
     slotResources[slotOffset + sampler.resourceSlot] = samplerResources.size();
     samplerResources.push_back(
@@ -495,10 +502,7 @@ Cache::ShaderResources::eval(ir::InstructionId instId,
   if (instId == ir::amdgpu::IMM) {
     auto address = static_cast<std::uint64_t>(*operands[1].getAsInt64());
 
-    std::uint32_t result;
-    cacheTag->readMemory(
-        &result, rx::AddressRange::fromBeginSize(address, sizeof(result)));
-    return result;
+    return readPointer<std::uint32_t>(address);
   }
 
   return Evaluator::eval(instId, operands);
@@ -673,6 +677,7 @@ struct CachedShader : Cache::Entry {
   std::uint64_t magic;
   VkShaderEXT handle;
   gcn::ShaderInfo info;
+  Cache::ResourceSnapshot resourceSnapshot;
   std::vector<std::pair<std::uint64_t, std::vector<std::byte>>> usedMemory;
 
   ~CachedShader() {
@@ -710,11 +715,46 @@ struct CachedBuffer : Cache::Entry {
 struct CachedHostVisibleBuffer : CachedBuffer {
   using CachedBuffer::update;
 
+  // Set when the buffer is bound directly to imported guest memory, update
+  // and flush have nothing to copy then
+  std::shared_ptr<Cache::HostImport> hostImport;
+
   bool expensive() {
     return !rx::g_config.disableGpuCache &&
            addressRange.size() >= rx::mem::pageSize;
   }
 
+  bool importHostMemory(Cache &cache, VkBufferUsageFlags usage) {
+    auto import = cache.getHostImport(addressRange);
+    if (import == nullptr) {
+      return false;
+    }
+
+    auto offset = addressRange.beginAddress() - import->address;
+    auto importedBuffer =
+        vk::Buffer::CreateExternal(addressRange.size(), usage);
+    auto requirements = importedBuffer.getMemoryRequirements();
+
+    if (offset % requirements.alignment != 0 ||
+        offset + requirements.size > Cache::kHostImportChunkSize ||
+        (requirements.memoryTypeBits &
+         (1u << import->memory.getMemoryTypeIndex())) == 0) {
+      // Misaligned guest buffer, use a copy
+      return false;
+    }
+
+    importedBuffer.bindMemory({
+        .deviceMemory = import->memory.getHandle(),
+        .offset = offset,
+        .size = requirements.size,
+        .data = import->data,
+    });
+
+    buffer = std::move(importedBuffer);
+    hostImport = std::move(import);
+    return true;
+  }
+
   bool flush(void *target, rx::AddressRange range) {
     if (!hasDelayedFlush) {
       return false;
@@ -722,6 +762,10 @@ struct CachedHostVisibleBuffer : CachedBuffer {
 
     hasDelayedFlush = false;
 
+    if (hostImport != nullptr) {
+      return false;
+    }
+
     auto data =
         buffer.getData() + range.beginAddress() - addressRange.beginAddress();
     std::memcpy(target, data, range.size());
@@ -730,6 +774,10 @@ struct CachedHostVisibleBuffer : CachedBuffer {
   }
 
   void update(rx::AddressRange range, void *from) {
+    if (hostImport != nullptr) {
+      return;
+    }
+
     auto data =
         buffer.getData() + range.beginAddress() - addressRange.beginAddress();
     std::memcpy(data, from, range.size());
@@ -831,11 +879,61 @@ struct CachedImageBuffer : Cache::Entry {
     return info.totalLinearSize;
   }
 
+  // Surfaces up to this size are detiled on the host, recording a compute
+  // dispatch per mip level costs more than the detiling itself
+  static constexpr std::uint64_t kCpuDetileMaxSize = 256 * 1024;
+
+  [[nodiscard]] bool canDetileOnCpu(const VkImageSubresourceRange &subresource,
+                                    const Cache::Buffer &tiledBuffer) const {
+    if (rx::g_config.disableCpuTiler || tiledBuffer.data == nullptr ||
+        info.totalLinearSize > kCpuDetileMaxSize) {
+      return false;
+    }
+
+    for (unsigned mipLevel = subresource.baseMipLevel;
+         mipLevel < subresource.baseMipLevel + subresource.levelCount;
+         ++mipLevel) {
+      if (!isCpuTilerSupported(info, tileMode, mipLevel,
+                               info.arrayLayerCount)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   void update(Cache::Tag *tag, rx::AddressRange range,
               Cache::Buffer tiledBuffer) {
     auto subresource = getSubresource(range);
     auto &sched = tag->getScheduler();
 
+    if (!isLinear() && canDetileOnCpu(subresource, tiledBuffer)) {
+      // Detile into a fresh staging buffer, the linear buffer can still be
+      // in use by already recorded commands
+      auto staging = tag->getInternalHostVisibleBuffer(info.totalLinearSize);
+      std::vector<VkBufferCopy> regions;
+      regions.reserve(subresource.levelCount);
+
+      for (unsigned mipLevel = subresource.baseMipLevel;
+           mipLevel < subresource.baseMipLevel + subresource.levelCount;
+           ++mipLevel) {
+        detileCpu(info, tileMode, tiledBuffer.data, info.totalTiledSize,
+                  staging.data, info.totalLinearSize, mipLevel, 0,
+                  info.arrayLayerCount);
+
+        auto &mipInfo = info.getSubresourceInfo(mipLevel);
+        regions.push_back({
+            .srcOffset = staging.offset + mipInfo.linearOffset,
+            .dstOffset = mipInfo.linearOffset,
+            .size = mipInfo.linearSize * info.arrayLayerCount,
+        });
+      }
+
+      vkCmdCopyBuffer(sched.getCommandBuffer(), staging.handle,
+                      buffer.getHandle(), regions.size(), regions.data());
+      return;
+    }
+
     if (!isLinear()) {
       auto linearAddress = buffer.getAddress();
 
@@ -945,12 +1043,39 @@ struct CachedImageBuffer : Cache::Entry {
   }
 };
 
+// bumped whenever cached image views are destroyed, see
+// Cache::DescriptorSetState
+static std::atomic<std::uint64_t> g_imageViewGeneration{0};
+
+struct ImageViewCacheKey {
+  VkImageViewType type;
+  VkFormat format;
+  std::array<VkComponentSwizzle, 4> components;
+  VkImageAspectFlags aspectMask;
+  std::uint32_t baseMipLevel;
+  std::uint32_t levelCount;
+  std::uint32_t baseArrayLayer;
+  std::uint32_t layerCount;
+
+  constexpr auto operator<=>(const ImageViewCacheKey &) const = default;
+};
+
 struct CachedImage : Cache::Entry {
   vk::Image image;
   ImageKind kind;
   ImageBufferKey imageBufferKey;
   SurfaceInfo info;
 
+  // views live as long as the image, so descriptor sets that reference them
+  // stay valid from draw to draw
+  std::map<ImageViewCacheKey, vk::ImageView> views;
+
+  ~CachedImage() override {
+    if (!views.empty()) {
+      g_imageViewGeneration.fetch_add(1, std::memory_order::relaxed);
+    }
+  }
+
   bool expensive() {
     return false;
     if (rx::g_config.disableGpuCache) {
@@ -1114,10 +1239,6 @@ struct CachedImage : Cache::Entry {
   }
 };
 
-struct CachedImageView : Cache::Entry {
-  vk::ImageView view;
-};
-
 ImageViewKey ImageViewKey::createFrom(const gnm::TBuffer &tbuffer) {
   std::uint32_t width = tbuffer.width + 1u;
   std::uint32_t height = tbuffer.height + 1u;
@@ -1316,21 +1437,37 @@ Cache::Shader Cache::Tag::getShader(const ShaderKey &key,
     return {
         .handle = cachedShader->handle,
         .info = &cachedShader->info,
+        .resourceSnapshot = &cachedShader->resourceSnapshot,
         .stage = stage,
     };
   }
 
   auto vmId = mParent->mVmId;
 
+  auto env = key.env;
+  env.supportsBarycentric = vk::context->supportsBarycentric;
+  env.supportsInt8 = vk::context->supportsInt8;
+  env.supportsInt64Atomics = vk::context->supportsInt64Atomics;
+  env.supportsNonSemanticInfo = vk::context->supportsNonSemanticInfo;
+
+  std::uint64_t magic;
+  readMemory(&magic,
+             rx::AddressRange::fromBeginSize(key.address, sizeof(magic)));
+
+  auto &diskCache = mParent->mDevice->shaderDiskCache;
   std::optional<gcn::ConvertedShader> converted;
+  std::optional<ShaderDiskCache::UsedMemory> cachedUsedMemory;
+  std::vector<std::byte> binary;
 
-  {
-    auto env = key.env;
-    env.supportsBarycentric = vk::context->supportsBarycentric;
-    env.supportsInt8 = vk::context->supportsInt8;
-    env.supportsInt64Atomics = vk::context->supportsInt64Atomics;
-    env.supportsNonSemanticInfo = vk::context->supportsNonSemanticInfo;
+  auto readShaderMemory = [this](void *target, rx::AddressRange range) {
+    readMemory(target, range);
+  };
 
+  if (auto cached = diskCache.find(key.stage, env, magic, readShaderMemory)) {
+    converted = std::move(cached->converted);
+    cachedUsedMemory = std::move(cached->usedMemory);
+    binary = std::move(cached->binary);
+  } else {
     gcn::Context context;
     auto deserialized = gcn::deserialize(
         context, env, mParent->mDevice->gcnSemantic, key.address,
@@ -1378,9 +1515,26 @@ Cache::Shader Cache::Tag::getShader(const ShaderKey &key,
                           ? &mParent->mComputeDescriptorSetLayout
                           : mParent->mGraphicsDescriptorSetLayouts.data())};
 
-  VkShaderEXT handle;
-  VK_VERIFY(vk::CreateShadersEXT(vk::context->device, 1, &createInfo,
-                                 vk::context->allocator, &handle));
+  VkShaderEXT handle = VK_NULL_HANDLE;
+
+  if (!binary.empty()) {
+    auto binaryInfo = createInfo;
+    binaryInfo.codeType = VK_SHADER_CODE_TYPE_BINARY_EXT;
+    binaryInfo.codeSize = binary.size();
+    binaryInfo.pCode = binary.data();
+
+    // the driver may reject binaries of an other driver build, fall back to
+    // stored spirv in this case
+    if (vk::CreateShadersEXT(vk::context->device, 1, &binaryInfo,
+                             vk::context->allocator, &handle) != VK_SUCCESS) {
+      handle = VK_NULL_HANDLE;
+    }
+  }
+
+  if (handle == VK_NULL_HANDLE) {
+    VK_VERIFY(vk::CreateShadersEXT(vk::context->device, 1, &createInfo,
+                                   vk::context->allocator, &handle));
+  }
 
   auto magicRange =
       rx::AddressRange::fromBeginSize(key.address, sizeof(std::uint64_t));
@@ -1389,25 +1543,47 @@ Cache::Shader Cache::Tag::getShader(const ShaderKey &key,
   result->tagId = getReadId();
   result->handle = handle;
   result->info = std::move(converted->info);
-  readMemory(&result->magic, rx::AddressRange::fromBeginSize(
-                                 key.address, sizeof(result->magic)));
+  result->magic = magic;
 
-  for (auto entry : result->info.memoryMap) {
-    auto entryRange =
-        rx::AddressRange::fromBeginEnd(entry.beginAddress, entry.endAddress);
-    auto &inserted = result->usedMemory.emplace_back();
-    inserted.first = entryRange.beginAddress();
-    inserted.second.resize(entryRange.size());
-    readMemory(inserted.second.data(), entryRange);
+  if (cachedUsedMemory) {
+    result->usedMemory = std::move(*cachedUsedMemory);
+  } else {
+    for (auto entry : result->info.memoryMap) {
+      auto entryRange =
+          rx::AddressRange::fromBeginEnd(entry.beginAddress, entry.endAddress);
+      auto &inserted = result->usedMemory.emplace_back();
+      inserted.first = entryRange.beginAddress();
+      inserted.second.resize(entryRange.size());
+      readMemory(inserted.second.data(), entryRange);
+    }
+
+    std::size_t binarySize = 0;
+    if (vk::GetShaderBinaryDataEXT(vk::context->device, handle, &binarySize,
+                                   nullptr) == VK_SUCCESS) {
+      binary.resize(binarySize);
+      if (vk::GetShaderBinaryDataEXT(vk::context->device, handle, &binarySize,
+                                     binary.data()) != VK_SUCCESS) {
+        binary.clear();
+      }
+    }
+
+    diskCache.store(key.stage, env, magic, converted->spv, result->info,
+                    result->usedMemory, binary);
   }
 
   auto &info = result->info;
+  auto &resourceSnapshot = result->resourceSnapshot;
 
   mParent->trackUpdate(EntryType::Shader, result->addressRange, result,
                        getReadId(), true);
   mStorage->mAcquiredViewResources.push_back(std::move(result));
 
-  return {.handle = handle, .info = &info, .stage = stage};
+  return {
+      .handle = handle,
+      .info = &info,
+      .resourceSnapshot = &resourceSnapshot,
+      .stage = stage,
+  };
 }
 
 std::shared_ptr<Cache::Entry>
@@ -1491,17 +1667,26 @@ Cache::Buffer Cache::Tag::getBuffer(rx::AddressRange range, Access access) {
 
     it = table.map(range.beginAddress(), range.endAddress(), nullptr, false,
                    true);
+  } else if (auto entry = static_cast<CachedHostVisibleBuffer *>(it->get());
+             entry != nullptr && entry->hostImport != nullptr &&
+             !entry->hostImport->valid) {
+    // Guest pages were remapped under the imported memory
+    it = table.map(range.beginAddress(), range.endAddress(), nullptr, false);
   }
 
   if (it.get() == nullptr) {
+    constexpr VkBufferUsageFlags usage =
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+        VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT |
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
     auto cached = std::make_shared<CachedHostVisibleBuffer>();
     cached->addressRange = range;
-    cached->buffer = vk::Buffer::Allocate(
-        vk::getHostVisibleMemory(), range.size(),
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-            VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT |
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-            VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+
+    if (!cached->importHostMemory(*mParent, usage)) {
+      cached->buffer =
+          vk::Buffer::Allocate(vk::getHostVisibleMemory(), range.size(), usage);
+    }
 
     it.get() = std::move(cached);
   }
@@ -1527,9 +1712,11 @@ Cache::Buffer Cache::Tag::getBuffer(rx::AddressRange range, Access access) {
         getScheduler().wait();
       }
 
-      mParent->trackUpdate(
-          EntryType::HostVisibleBuffer, addressRange, it.get(), getReadId(),
-          (access & Access::Write) == Access::None && cached->expensive());
+      mParent->trackUpdate(EntryType::HostVisibleBuffer, addressRange,
+                           it.get(), getReadId(),
+                           (access & Access::Write) == Access::None &&
+                               cached->expensive() &&
+                               cached->hostImport == nullptr);
       amdgpu::RemoteMemory memory{mParent->mVmId};
       cached->update(addressRange,
                      memory.getPointer(addressRange.beginAddress()));
@@ -1547,6 +1734,16 @@ Cache::Buffer Cache::Tag::getBuffer(rx::AddressRange range, Access access) {
 }
 
 Cache::Buffer Cache::Tag::getInternalHostVisibleBuffer(std::uint64_t size) {
+  if (auto staging = getCache()->mStagingRing.allocate(*mScheduler, size)) {
+    return {
+        .handle = staging->handle,
+        .offset = staging->offset,
+        .deviceAddress = staging->deviceAddress,
+        .tagId = getReadId(),
+        .data = staging->data,
+    };
+  }
+
   auto buffer = vk::Buffer::Allocate(vk::getHostVisibleMemory(), size,
                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
                                          VK_BUFFER_USAGE_TRANSFER_DST_BIT |
@@ -1590,7 +1787,8 @@ Cache::Buffer Cache::Tag::getInternalDeviceLocalBuffer(std::uint64_t size) {
   };
 }
 
-void Cache::Tag::buildDescriptors(VkDescriptorSet descriptorSet) {
+void Cache::Tag::buildDescriptors(VkDescriptorSet descriptorSet,
+                                  DescriptorSetState &state) {
   auto &res = mStorage->shaderResources;
   auto memoryTableBuffer = getMemoryTable();
   auto imageMemoryTableBuffer = getImageMemoryTable();
@@ -1601,51 +1799,90 @@ void Cache::Tag::buildDescriptors(VkDescriptorSet descriptorSet) {
   res.buildMemoryTable(*memoryTable);
   res.buildImageMemoryTable(*imageMemoryTable);
 
+  auto viewGeneration = g_imageViewGeneration.load(std::memory_order::relaxed);
+  if (state.viewGeneration != viewGeneration) {
+    state.viewGeneration = viewGeneration;
+    state.samplers.clear();
+    for (auto &images : state.images) {
+      images.clear();
+    }
+  }
+
+  std::size_t descriptorCount = res.samplerResources.size();
+  for (auto &imageResources : res.imageResources) {
+    descriptorCount += imageResources.size();
+  }
+
+  // reserved up front, writes point into it
+  std::vector<VkDescriptorImageInfo> imageInfos;
+  std::vector<VkWriteDescriptorSet> writes;
+  imageInfos.reserve(descriptorCount);
+  writes.reserve(descriptorCount);
+
+  if (state.samplers.size() < res.samplerResources.size()) {
+    state.samplers.resize(res.samplerResources.size(), VK_NULL_HANDLE);
+  }
+
   for (auto &sampler : res.samplerResources) {
     uint32_t index = &sampler - res.samplerResources.data();
 
-    VkDescriptorImageInfo samplerInfo{.sampler = sampler.handle};
+    if (state.samplers[index] == sampler.handle) {
+      continue;
+    }
+
+    state.samplers[index] = sampler.handle;
 
-    VkWriteDescriptorSet writeDescSet{
+    writes.push_back({
         .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
         .dstSet = descriptorSet,
         .dstBinding = Cache::getDescriptorBinding(VK_DESCRIPTOR_TYPE_SAMPLER),
         .dstArrayElement = index,
         .descriptorCount = 1,
         .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
-        .pImageInfo = &samplerInfo,
-    };
-
-    vkUpdateDescriptorSets(vk::context->device, 1, &writeDescSet, 0, nullptr);
+        .pImageInfo = &imageInfos.emplace_back(
+            VkDescriptorImageInfo{.sampler = sampler.handle}),
+    });
   }
 
   for (auto &imageResources : res.imageResources) {
     auto dim = (&imageResources - res.imageResources) + 1;
     auto binding = static_cast<uint32_t>(
         Cache::getDescriptorBinding(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, dim));
+    auto &writtenImages = state.images[dim - 1];
+
+    if (writtenImages.size() < imageResources.size()) {
+      writtenImages.resize(imageResources.size(), VK_NULL_HANDLE);
+    }
 
     for (auto &image : imageResources) {
       uint32_t index = &image - imageResources.data();
 
-      VkDescriptorImageInfo imageInfo{
-          .imageView = image.handle,
-          .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
-      };
+      if (writtenImages[index] == image.handle) {
+        continue;
+      }
 
-      VkWriteDescriptorSet writeDescSet{
+      writtenImages[index] = image.handle;
+
+      writes.push_back({
           .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
           .dstSet = descriptorSet,
           .dstBinding = binding,
           .dstArrayElement = index,
           .descriptorCount = 1,
           .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-          .pImageInfo = &imageInfo,
-      };
-
-      vkUpdateDescriptorSets(vk::context->device, 1, &writeDescSet, 0, nullptr);
+          .pImageInfo = &imageInfos.emplace_back(VkDescriptorImageInfo{
+              .imageView = image.handle,
+              .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+          }),
+      });
     }
   }
 
+  if (!writes.empty()) {
+    vkUpdateDescriptorSets(vk::context->device, writes.size(), writes.data(),
+                           0, nullptr);
+  }
+
   for (auto &mtConfig : mStorage->memoryTableConfigSlots) {
     auto config = mStorage->descriptorBuffers[mtConfig.bufferIndex];
     config[mtConfig.configIndex] =
@@ -2053,14 +2290,6 @@ Cache::Image Cache::Tag::getImage(const ImageKey &key, Access access) {
 
 Cache::ImageView Cache::Tag::getImageView(const ImageViewKey &key,
                                           Access access) {
-  auto surfaceInfo = computeSurfaceInfo(
-      key.tileMode, key.type, key.dfmt, key.extent.width, key.extent.height,
-      key.extent.depth, key.pitch, key.baseArrayLayer, key.arrayLayerCount,
-      key.baseMipLevel, key.mipCount, key.pow2pad);
-
-  auto storeRange = rx::AddressRange::fromBeginSize(key.writeAddress,
-                                                    surfaceInfo.totalTiledSize);
-
   auto image = getImage(ImageKey::createFrom(key), access);
 
   VkComponentMapping components{
@@ -2081,21 +2310,33 @@ Cache::ImageView Cache::Tag::getImageView(const ImageViewKey &key,
     format = image.format;
   }
 
-  auto result = vk::ImageView(gnm::toVkImageViewType(key.type), image.handle,
-                              image.format, components,
-                              {
-                                  .aspectMask = toAspect(key.kind),
-                                  .baseMipLevel = key.baseMipLevel,
-                                  .levelCount = key.mipCount,
-                                  .baseArrayLayer = key.baseArrayLayer,
-                                  .layerCount = key.arrayLayerCount,
-                              });
-  auto cached = std::make_shared<CachedImageView>();
-  cached->addressRange = storeRange;
-  cached->view = std::move(result);
-
-  auto handle = cached->view.getHandle();
-  mStorage->mAcquiredViewResources.push_back(std::move(cached));
+  ImageViewCacheKey viewKey{
+      .type = gnm::toVkImageViewType(key.type),
+      .format = image.format,
+      .components = {components.r, components.g, components.b, components.a},
+      .aspectMask = toAspect(key.kind),
+      .baseMipLevel = key.baseMipLevel,
+      .levelCount = key.mipCount,
+      .baseArrayLayer = key.baseArrayLayer,
+      .layerCount = key.arrayLayerCount,
+  };
+
+  auto cachedImage = static_cast<CachedImage *>(image.entry);
+  auto [viewIt, inserted] = cachedImage->views.try_emplace(viewKey);
+
+  if (inserted) {
+    viewIt->second = vk::ImageView(viewKey.type, image.handle, viewKey.format,
+                                   components,
+                                   {
+                                       .aspectMask = viewKey.aspectMask,
+                                       .baseMipLevel = viewKey.baseMipLevel,
+                                       .levelCount = viewKey.levelCount,
+                                       .baseArrayLayer = viewKey.baseArrayLayer,
+                                       .layerCount = viewKey.layerCount,
+                                   });
+  }
+
+  auto handle = viewIt->second.getHandle();
 
   return {
       .handle = handle,
@@ -2204,6 +2445,7 @@ void Cache::Tag::release() {
     tmpResources.push_back(std::move(resource));
   }
 
+  mParent->flushPageWatches();
   mStorage->clear();
   auto storageIndex = mStorage - mParent->mTagStorages;
   mStorage = nullptr;
@@ -2320,7 +2562,8 @@ Cache::Shader Cache::GraphicsTag::getShader(
 
   mStorage->shaderResources.loadResources(
       shader.info->resources,
-      std::span(pgm.userData.data(), pgm.rsrc2.userSgpr));
+      std::span(pgm.userData.data(), pgm.rsrc2.userSgpr),
+      *shader.resourceSnapshot);
 
   const auto &configSlots = shader.info->configSlots;
 
@@ -2483,7 +2726,8 @@ Cache::ComputeTag::getShader(const Registers::ComputeConfig &pgm) {
 
   mStorage->shaderResources.loadResources(
       shader.info->resources,
-      std::span(pgm.userData.data(), pgm.rsrc2.userSgpr));
+      std::span(pgm.userData.data(), pgm.rsrc2.userSgpr),
+      *shader.resourceSnapshot);
 
   const auto &configSlots = shader.info->configSlots;
 
@@ -2606,6 +2850,7 @@ Cache::Cache(Device *device, int vmId) : mDevice(device), mVmId(vmId) {
       vk::getHostVisibleMemory(), kMemoryTableSize * kMemoryTableCount);
 
   mGdsBuffer = vk::Buffer::Allocate(vk::getHostVisibleMemory(), 0x40000);
+  mStagingRing.init(kStagingRingSize);
 
   {
     VkDescriptorSetLayoutBinding bindings[kGraphicsStages.size()]
@@ -2798,7 +3043,74 @@ void Cache::trackUpdate(EntryType type, rx::AddressRange range,
   table.map(range.beginAddress(), range.endAddress(), std::move(entry));
 
   if (watchChanges) {
-    mDevice->watchWrites(mVmId, range.beginAddress(), range.size());
+    std::lock_guard lock(mPageWatchMtx);
+    mPendingPageWatches.push_back({
+        .address = range.beginAddress(),
+        .size = range.size(),
+        .lockReadWrite = false,
+    });
+  }
+}
+
+std::shared_ptr<Cache::HostImport>
+Cache::getHostImport(rx::AddressRange range) {
+  auto alignment = mDevice->hostImportAlignment;
+
+  if (alignment == 0 || kHostImportChunkSize % alignment != 0) {
+    return {};
+  }
+
+  auto chunk = range.beginAddress() / kHostImportChunkSize;
+
+  if (chunk == 0 || (range.endAddress() - 1) / kHostImportChunkSize != chunk) {
+    return {};
+  }
+
+  std::lock_guard lock(mHostImportMtx);
+
+  auto [it, inserted] = mHostImports.try_emplace(chunk);
+  if (!inserted) {
+    return it->second;
+  }
+
+  if (mHostImports.size() > kMaxHostImports) {
+    mHostImports.erase(it);
+    return {};
+  }
+
+  auto address = chunk * kHostImportChunkSize;
+  auto data = RemoteMemory{mVmId}.getPointer<std::byte>(address);
+  auto memory = vk::DeviceMemory::CreateExternalHostMemory(
+      data, kHostImportChunkSize,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  if (memory.getHandle() == nullptr) {
+    // Partially mapped chunk or not importable pages, keep the nullptr
+    // entry until the range is remapped
+    return {};
+  }
+
+  auto import = std::make_shared<HostImport>();
+  import->memory = std::move(memory);
+  import->address = address;
+  import->data = data;
+  it->second = import;
+  return import;
+}
+
+void Cache::invalidateHostImports(rx::AddressRange range) {
+  std::lock_guard lock(mHostImportMtx);
+
+  auto it = mHostImports.lower_bound(range.beginAddress() /
+                                     kHostImportChunkSize);
+  auto end = mHostImports.upper_bound((range.endAddress() - 1) /
+                                      kHostImportChunkSize);
+
+  for (; it != end; it = mHostImports.erase(it)) {
+    if (it->second != nullptr) {
+      it->second->valid = false;
+    }
   }
 }
 
@@ -2813,7 +3125,27 @@ void Cache::trackWrite(rx::AddressRange range, TagId tagId, bool lockMemory) {
     return;
   }
 
-  mDevice->lockReadWrite(mVmId, range.beginAddress(), range.size(), true);
+  std::lock_guard lock(mPageWatchMtx);
+  mPendingPageWatches.push_back({
+      .address = range.beginAddress(),
+      .size = range.size(),
+      .lockReadWrite = true,
+  });
+}
+
+void Cache::flushPageWatches() {
+  std::vector<PageWatchRequest> requests;
+
+  {
+    std::lock_guard lock(mPageWatchMtx);
+    if (mPendingPageWatches.empty()) {
+      return;
+    }
+
+    requests.swap(mPendingPageWatches);
+  }
+
+  mDevice->applyPageWatches(mVmId, requests);
 }
 
 rx::AddressRange Cache::flushImages(Tag &tag, rx::AddressRange range) {
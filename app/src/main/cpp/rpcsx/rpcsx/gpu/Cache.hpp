@@ -1,19 +1,24 @@
 #pragma once
 
 #include "Pipe.hpp"
+#include "StagingRing.hpp"
 #include "amdgpu/tiler.hpp"
 #include "gnm/constants.hpp"
+#include "gnm/descriptors.hpp"
 #include "rx/AddressRange.hpp"
 #include "shader/Access.hpp"
 #include "shader/Evaluator.hpp"
 #include "shader/GcnConverter.hpp"
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <rx/ConcurrentBitPool.hpp>
 #include <rx/MemoryTable.hpp>
 #include <shader/gcn.hpp>
 #include <utility>
+#include <vector>
 #include <vulkan/vulkan_core.h>
 
 namespace amdgpu {
@@ -27,6 +32,14 @@ struct ShaderKey {
 
 enum class ImageKind : std::uint8_t { Color, Depth, Stencil };
 
+struct PageWatchRequest {
+  std::uint64_t address;
+  std::uint64_t size;
+
+  // lazy read/write lock instead of write watch
+  bool lockReadWrite;
+};
+
 struct ImageViewKey {
   std::uint64_t readAddress;
   std::uint64_t writeAddress;
@@ -170,9 +183,33 @@ struct Cache {
   enum class TagId : std::uint64_t {};
   struct Entry;
 
+  // descriptors evaluated for the last draw of a shader, reused while the
+  // user sgprs and the memory the evaluator read stay the same. Guarded by
+  // the resources lock of the tag
+  struct ResourceSnapshot {
+    bool valid = false;
+    std::vector<std::uint32_t> userSgprs;
+    std::vector<std::pair<std::uint64_t, std::vector<std::byte>>> reads;
+    std::vector<std::uint64_t> pointers;
+    std::vector<gnm::VBuffer> buffers;
+    std::vector<std::pair<gnm::TBuffer, std::uint64_t>> imageBuffers;
+    std::vector<gnm::TBuffer> textures;
+    std::vector<gnm::SSampler> samplers;
+  };
+
+  // descriptors last written to a pooled descriptor set, unchanged entries
+  // are not written again. Dropped when any cached image view is destroyed,
+  // its handle could be reused by a new view
+  struct DescriptorSetState {
+    std::uint64_t viewGeneration = 0;
+    std::vector<VkSampler> samplers;
+    std::vector<VkImageView> images[3];
+  };
+
   struct Shader {
     VkShaderEXT handle = VK_NULL_HANDLE;
     shader::gcn::ShaderInfo *info;
+    ResourceSnapshot *resourceSnapshot = nullptr;
     VkShaderStageFlagBits stage;
   };
 
@@ -250,6 +287,8 @@ private:
     std::vector<std::pair<std::uint32_t, std::uint64_t>> resourceSlotToAddress;
     std::vector<Cache::Sampler> samplerResources;
     std::vector<Cache::ImageView> imageResources[3];
+    std::vector<std::pair<std::uint64_t, std::vector<std::byte>>>
+        *recordedReads = nullptr;
 
     using Evaluator::eval;
 
@@ -272,7 +311,11 @@ private:
     }
 
     void loadResources(shader::gcn::Resources &res,
-                       std::span<const std::uint32_t> userSgprs);
+                       std::span<const std::uint32_t> userSgprs,
+                       ResourceSnapshot &snapshot);
+    void evaluateResources(shader::gcn::Resources &res,
+                           ResourceSnapshot &snapshot);
+    bool isInSync(const ResourceSnapshot &snapshot);
     void buildMemoryTable(MemoryTable &memoryTable);
     void buildImageMemoryTable(MemoryTable &memoryTable);
     std::uint32_t getResourceSlot(std::uint32_t id);
@@ -281,6 +324,12 @@ private:
       T result{};
       cacheTag->readMemory(
           &result, rx::AddressRange::fromBeginSize(address, sizeof(result)));
+
+      if (recordedReads != nullptr) {
+        auto bytes = reinterpret_cast<const std::byte *>(&result);
+        recordedReads->emplace_back(
+            address, std::vector<std::byte>(bytes, bytes + sizeof(result)));
+      }
       return result;
     }
 
@@ -358,7 +407,8 @@ public:
 
     void unlock() { mResourcesLock.unlock(); }
 
-    void buildDescriptors(VkDescriptorSet descriptorSet);
+    void buildDescriptors(VkDescriptorSet descriptorSet,
+                          DescriptorSetState &state);
 
     Sampler getSampler(const SamplerKey &key);
     Buffer getBuffer(rx::AddressRange range, Access access);
@@ -441,6 +491,13 @@ public:
       return mParent->mGraphicsDescriptorSets[mAcquiredGraphicsDescriptorSet];
     }
 
+    // state of the first set of getDescriptorSets()
+    DescriptorSetState &getDescriptorSetState() {
+      getDescriptorSets();
+      return mParent
+          ->mGraphicsDescriptorSetStates[mAcquiredGraphicsDescriptorSet];
+    }
+
     Shader getShader(shader::gcn::Stage stage, const SpiShaderPgm &pgm,
                      const Registers::Context &context,
                      std::uint32_t indexOffset, gnm::PrimitiveType vsPrimType,
@@ -488,6 +545,12 @@ public:
       return mParent->mComputeDescriptorSets[mAcquiredComputeDescriptorSet];
     }
 
+    DescriptorSetState &getDescriptorSetState() {
+      getDescriptorSet();
+      return mParent
+          ->mComputeDescriptorSetStates[mAcquiredComputeDescriptorSet];
+    }
+
     void release();
 
     void swap(ComputeTag &other) noexcept {
@@ -556,6 +619,23 @@ public:
     invalidate(tag, range);
   }
 
+  // Guest memory imported with VK_EXT_external_memory_host, in fixed chunks
+  static constexpr std::uint64_t kHostImportChunkSize = 4 * 1024 * 1024;
+
+  struct HostImport {
+    vk::DeviceMemory memory;
+    std::uint64_t address = 0;
+    std::byte *data = nullptr;
+    std::atomic<bool> valid{true};
+  };
+
+  // Import of the chunk holding the whole range, or nullptr if the range
+  // crosses chunks or the chunk cannot be imported
+  std::shared_ptr<HostImport> getHostImport(rx::AddressRange range);
+
+  // Must be called when guest pages are remapped
+  void invalidateHostImports(rx::AddressRange range);
+
   [[nodiscard]] VkPipelineLayout getGraphicsPipelineLayout() const {
     return mGraphicsPipelineLayout;
   }
@@ -568,12 +648,29 @@ public:
     return mGraphicsDescriptorSetLayouts;
   }
 
+  struct ResourceReuseStats {
+    std::uint64_t reused;
+    std::uint64_t evaluated;
+  };
+
+  // how often shader resources were bound from the previous draw's snapshot
+  [[nodiscard]] ResourceReuseStats getResourceReuseStats() const {
+    return {
+        .reused = mResourceReuseCount.load(std::memory_order::relaxed),
+        .evaluated = mResourceEvalCount.load(std::memory_order::relaxed),
+    };
+  }
+
   void trackUpdate(EntryType type, rx::AddressRange range,
                    std::shared_ptr<Entry> entry, TagId tagId,
                    bool watchChanges);
 
   void trackWrite(rx::AddressRange range, TagId tagId, bool lockMemory);
 
+  // applies page protection requested by trackUpdate and trackWrite since the
+  // previous flush
+  void flushPageWatches();
+
   [[nodiscard]] bool isInSync(rx::AddressRange range, TagId expTagId) {
     auto syncIt = mSyncTable.queryArea(range.beginAddress());
     return syncIt != mSyncTable.end() && syncIt.range().contains(range) &&
@@ -591,15 +688,19 @@ private:
   Device *mDevice;
   int mVmId;
   std::atomic<TagId> mNextTagId{TagId{2}};
+  std::atomic<std::uint64_t> mResourceReuseCount{0};
+  std::atomic<std::uint64_t> mResourceEvalCount{0};
   vk::Buffer mGdsBuffer;
 
   static constexpr auto kMemoryTableSize = 0x10000;
   static constexpr auto kMemoryTableCount = 64;
   static constexpr auto kDescriptorSetCount = 128;
   static constexpr auto kTagStorageCount = 128;
+  static constexpr auto kStagingRingSize = 16 * 1024 * 1024;
 
   rx::ConcurrentBitPool<kMemoryTableCount> mMemoryTablePool;
   vk::Buffer mMemoryTableBuffer;
+  StagingRing mStagingRing;
 
   std::array<VkDescriptorSetLayout, kGraphicsStages.size()>
       mGraphicsDescriptorSetLayouts{};
@@ -614,14 +715,25 @@ private:
   std::array<VkDescriptorSet, kGraphicsStages.size()>
       mGraphicsDescriptorSets[kDescriptorSetCount];
   VkDescriptorSet mComputeDescriptorSets[kDescriptorSetCount];
+  DescriptorSetState mGraphicsDescriptorSetStates[kDescriptorSetCount];
+  DescriptorSetState mComputeDescriptorSetStates[kDescriptorSetCount];
   TagStorage mTagStorages[kTagStorageCount];
   std::map<SamplerKey, VkSampler> mSamplers;
 
   std::shared_ptr<Entry> mFrameBuffers[10];
   std::mutex mResourcesMtx;
 
-  rx::MemoryTableWithPayload<std::shared_ptr<Entry>>
+  rx::PageIndexedMemoryTable<std::shared_ptr<Entry>>
       mTables[static_cast<std::size_t>(EntryType::Count)];
-  rx::MemoryTableWithPayload<TagId> mSyncTable;
+  rx::PageIndexedMemoryTable<TagId> mSyncTable;
+
+  static constexpr std::size_t kMaxHostImports = 1024;
+
+  std::mutex mPageWatchMtx;
+  std::vector<PageWatchRequest> mPendingPageWatches;
+
+  std::mutex mHostImportMtx;
+  // Keyed by chunk index, nullptr marks chunks that failed to import
+  std::map<std::uint64_t, std::shared_ptr<HostImport>> mHostImports;
 };
 } // namespace amdgpu
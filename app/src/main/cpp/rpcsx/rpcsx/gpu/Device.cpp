@@ -18,6 +18,7 @@
 #include "shader/spv.hpp"
 #include "shaders/rdna-semantic-spirv.hpp"
 #include "vk.hpp"
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <fcntl.h>
@@ -144,7 +145,6 @@ static vk::Context createVkContext(Device *device) {
                           // VK_EXT_DEPTH_CLIP_ENABLE_EXTENSION_NAME,
                           // VK_EXT_INLINE_UNIFORM_BLOCK_EXTENSION_NAME,
                           // VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
-                          // VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
                           // VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME,
                           VK_EXT_SEPARATE_STENCIL_USAGE_EXTENSION_NAME,
                           VK_KHR_SWAPCHAIN_EXTENSION_NAME,
@@ -155,8 +155,27 @@ static vk::Context createVkContext(Device *device) {
                       {
                           VK_KHR_FRAGMENT_SHADER_BARYCENTRIC_EXTENSION_NAME,
                           VK_KHR_SHADER_NON_SEMANTIC_INFO_EXTENSION_NAME,
+                          VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+                          VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME,
                       });
 
+  if (!rx::g_config.disableGpuHostImport &&
+      result.hasDeviceExtension(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME)) {
+    VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostProperties{
+        .sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT,
+    };
+
+    VkPhysicalDeviceProperties2 properties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &hostProperties,
+    };
+
+    vkGetPhysicalDeviceProperties2(result.physicalDevice, &properties);
+    device->hostImportAlignment =
+        hostProperties.minImportedHostPointerAlignment;
+  }
+
   auto getTotalMemorySize = [&](int memoryType) -> VkDeviceSize {
     auto deviceLocalMemoryType =
         result.findPhysicalMemoryTypeIndex(~0, memoryType);
@@ -207,6 +226,16 @@ Device::Device() : vkContext(createVkContext(this)) {
     rx::die("failed to deserialize builtin semantics\n");
   }
 
+  if (!rx::g_config.shaderCachePath.empty()) {
+    shaderDiskCache.open(rx::g_config.shaderCachePath, g_rdna_semantic_spirv,
+                         vkContext.shaderObjectProps.shaderBinaryUUID,
+                         vkContext.shaderObjectProps.shaderBinaryVersion);
+  }
+
+  framePacer.setMode(rx::g_config.framePacing);
+  hasDisplayTiming =
+      vkContext.hasDeviceExtension(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
+
   for (auto &pipe : graphicsPipes) {
     pipe.device = this;
   }
@@ -570,6 +599,8 @@ void Device::submitGfxCommand(int gfxPipe,
 void Device::mapProcess(std::uint32_t pid, int vmId) {
   auto &process = processInfo[pid];
   process.vmId = vmId;
+  caches[vmId].invalidateHostImports(
+      rx::AddressRange::fromBeginEnd(orbis::kMinAddress, orbis::kMaxAddress));
 
   auto memory = amdgpu::RemoteMemory{vmId};
 
@@ -617,6 +648,12 @@ void Device::mapProcess(std::uint32_t pid, int vmId) {
 
 void Device::unmapProcess(std::uint32_t pid) {
   auto &process = processInfo[pid];
+
+  if (process.vmId >= 0) {
+    caches[process.vmId].invalidateHostImports(rx::AddressRange::fromBeginEnd(
+        orbis::kMinAddress, orbis::kMaxAddress));
+  }
+
   auto startAddress = static_cast<std::uint64_t>(process.vmId) << 40;
   auto size = static_cast<std::uint64_t>(1) << 40;
 
@@ -910,7 +947,38 @@ bool Device::flip(std::uint32_t pid, int bufferIndex, std::uint64_t arg,
 }
 
 void Device::flip(std::uint32_t pid, int bufferIndex, std::uint64_t arg) {
-  auto recreateSwapchain = [this] {
+  auto updateRefreshDuration = [this] {
+    if (framePacer.getMode() == rx::FramePacing::Off) {
+      return;
+    }
+
+    std::uint64_t refreshDuration = 0;
+
+    if (hasDisplayTiming) {
+      VkRefreshCycleDurationGOOGLE refreshCycle{};
+      if (vk::GetRefreshCycleDurationGOOGLE(vk::context->device,
+                                            vk::context->swapchain,
+                                            &refreshCycle) == VK_SUCCESS) {
+        refreshDuration = refreshCycle.refreshDuration;
+      }
+    }
+
+    if (refreshDuration == 0) {
+      auto monitor = glfwGetWindowMonitor(window);
+      if (monitor == nullptr) {
+        monitor = glfwGetPrimaryMonitor();
+      }
+
+      if (auto mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+          mode != nullptr && mode->refreshRate > 0) {
+        refreshDuration = 1'000'000'000 / mode->refreshRate;
+      }
+    }
+
+    framePacer.setRefreshDuration(refreshDuration);
+  };
+
+  auto recreateSwapchain = [&] {
     int width;
     int height;
     glfwGetWindowSize(window, &width, &height);
@@ -918,8 +986,13 @@ void Device::flip(std::uint32_t pid, int bufferIndex, std::uint64_t arg) {
         .width = static_cast<uint32_t>(width),
         .height = static_cast<uint32_t>(height),
     });
+    updateRefreshDuration();
   };
 
+  if (framePacer.getRefreshDuration() == 0) {
+    updateRefreshDuration();
+  }
+
   if (!isImageAcquired) {
     while (true) {
       auto acquireNextImageResult = vkAcquireNextImageKHR(
@@ -957,8 +1030,49 @@ void Device::flip(std::uint32_t pid, int bufferIndex, std::uint64_t arg) {
 
   isImageAcquired = false;
 
+  if (hasDisplayTiming && framePacer.getMode() != rx::FramePacing::Off) {
+    std::uint32_t timingCount = 0;
+    vk::GetPastPresentationTimingGOOGLE(
+        vk::context->device, vk::context->swapchain, &timingCount, nullptr);
+
+    if (timingCount > 0) {
+      std::vector<VkPastPresentationTimingGOOGLE> timings(timingCount);
+      if (vk::GetPastPresentationTimingGOOGLE(
+              vk::context->device, vk::context->swapchain, &timingCount,
+              timings.data()) >= VK_SUCCESS) {
+        for (std::uint32_t i = 0; i < timingCount; ++i) {
+          framePacer.onPresented(timings[i].actualPresentTime);
+        }
+      }
+    }
+  }
+
+  auto flipTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count();
+  auto desiredPresentTime = framePacer.schedule(flipTime);
+
+  VkPresentTimeGOOGLE presentTime{
+      .presentID = ++presentId,
+      .desiredPresentTime = desiredPresentTime,
+  };
+
+  VkPresentTimesInfoGOOGLE presentTimesInfo{
+      .sType = VK_STRUCTURE_TYPE_PRESENT_TIMES_INFO_GOOGLE,
+      .swapchainCount = 1,
+      .pTimes = &presentTime,
+  };
+
+  if (desiredPresentTime != 0 && !hasDisplayTiming) {
+    // no display timing, hold the present on the cpu instead
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+        std::chrono::nanoseconds(desiredPresentTime)));
+  }
+
   VkPresentInfoKHR presentInfo{
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+      .pNext = desiredPresentTime != 0 && hasDisplayTiming ? &presentTimesInfo
+                                                           : nullptr,
       .waitSemaphoreCount = 1,
       .pWaitSemaphores = &vk::context->renderCompleteSemaphore,
       .swapchainCount = 1,
@@ -1037,6 +1151,10 @@ void Device::mapMemory(std::uint32_t pid, std::uint64_t address,
             memoryType, offset, prot);
   }
 
+  // Imports pin the pages that were mapped before
+  caches[process.vmId].invalidateHostImports(
+      rx::AddressRange::fromBeginSize(address, size));
+
   // std::println(stderr, "map memory of process {}, address {}-{}, prot {:x}",
   //              (int)pid, memory.getPointer(address),
   //              memory.getPointer(address + size), prot);
@@ -1072,11 +1190,10 @@ static void notifyPageChanges(Device *device, int vmId, std::uint32_t firstPage,
   }
 }
 
-static void modifyWatchFlags(Device *device, int vmId, std::uint64_t address,
-                             std::uint64_t size, std::uint8_t addFlags,
-                             std::uint8_t removeFlags) {
-  auto firstPage = address / rx::mem::pageSize;
-  auto lastPage = (address + size + rx::mem::pageSize - 1) / rx::mem::pageSize;
+static bool modifyPageWatchFlags(Device *device, int vmId,
+                                 std::uint64_t firstPage,
+                                 std::uint64_t lastPage, std::uint8_t addFlags,
+                                 std::uint8_t removeFlags) {
   bool hasChanges = false;
   for (auto page = firstPage; page < lastPage; ++page) {
     auto prevValue =
@@ -1097,7 +1214,17 @@ static void modifyWatchFlags(Device *device, int vmId, std::uint64_t address,
     }
   }
 
-  if (hasChanges) {
+  return hasChanges;
+}
+
+static void modifyWatchFlags(Device *device, int vmId, std::uint64_t address,
+                             std::uint64_t size, std::uint8_t addFlags,
+                             std::uint8_t removeFlags) {
+  auto firstPage = address / rx::mem::pageSize;
+  auto lastPage = (address + size + rx::mem::pageSize - 1) / rx::mem::pageSize;
+
+  if (modifyPageWatchFlags(device, vmId, firstPage, lastPage, addFlags,
+                           removeFlags)) {
     notifyPageChanges(device, vmId, firstPage, lastPage - firstPage);
   }
 }
@@ -1117,3 +1244,43 @@ void Device::unlockReadWrite(int vmId, std::uint64_t address,
   modifyWatchFlags(this, vmId, address, size, kPageWriteWatch,
                    kPageReadWriteLock | kPageLazyLock);
 }
+
+void Device::applyPageWatches(int vmId,
+                              std::span<PageWatchRequest> requests) {
+  std::ranges::sort(requests, {}, &PageWatchRequest::address);
+
+  std::uint64_t runFirstPage = 0;
+  std::uint64_t runLastPage = 0;
+  bool runHasChanges = false;
+
+  for (auto &request : requests) {
+    auto firstPage = request.address / rx::mem::pageSize;
+    auto lastPage = (request.address + request.size + rx::mem::pageSize - 1) /
+                    rx::mem::pageSize;
+
+    if (firstPage > runLastPage) {
+      if (runHasChanges) {
+        notifyPageChanges(this, vmId, runFirstPage,
+                          runLastPage - runFirstPage);
+      }
+
+      runFirstPage = firstPage;
+      runHasChanges = false;
+    }
+
+    runLastPage = std::max(runLastPage, lastPage);
+
+    std::uint8_t addFlags = request.lockReadWrite
+                                ? kPageReadWriteLock | kPageLazyLock
+                                : kPageWriteWatch;
+
+    if (modifyPageWatchFlags(this, vmId, firstPage, lastPage, addFlags,
+                             kPageInvalidated)) {
+      runHasChanges = true;
+    }
+  }
+
+  if (runHasChanges) {
+    notifyPageChanges(this, vmId, runFirstPage, runLastPage - runFirstPage);
+  }
+}
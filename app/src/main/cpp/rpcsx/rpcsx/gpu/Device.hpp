@@ -2,7 +2,9 @@
 #include "Cache.hpp"
 #include "DeviceContext.hpp"
 #include "FlipPipeline.hpp"
+#include "FramePacer.hpp"
 #include "Pipe.hpp"
+#include "ShaderDiskCache.hpp"
 #include "amdgpu/tiler_vulkan.hpp"
 #include "orbis/KernelAllocator.hpp"
 #include "rx/MemoryTable.hpp"
@@ -12,6 +14,7 @@
 #include "shader/SpvConverter.hpp"
 #include "shader/gcn.hpp"
 #include <array>
+#include <span>
 #include <thread>
 #include <vulkan/vulkan_core.h>
 
@@ -50,7 +53,7 @@ struct ProcessInfo {
   int vmFd = -1;
   BufferAttribute bufferAttributes[10];
   Buffer buffers[10];
-  rx::MemoryTableWithPayload<VmMapSlot> vmTable;
+  rx::PageIndexedMemoryTable<VmMapSlot> vmTable;
 };
 
 struct RemoteMemory {
@@ -74,6 +77,10 @@ struct Device : rx::RcBase, DeviceContext {
   GLFWwindow *window = nullptr;
   VkSurfaceKHR surface = VK_NULL_HANDLE;
   VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
+
+  // minImportedHostPointerAlignment, 0 without VK_EXT_external_memory_host.
+  // Initialized by the vkContext constructor, so declared before it
+  VkDeviceSize hostImportAlignment = 0;
   vk::Context vkContext;
 
   GpuTiler tiler;
@@ -81,10 +88,14 @@ struct Device : rx::RcBase, DeviceContext {
   ComputePipe computePipes[kComputePipeCount]{0, 1, 2, 3, 4, 5, 6, 7};
   CommandPipe commandPipe;
   FlipPipeline flipPipeline;
+  ShaderDiskCache shaderDiskCache;
+  FramePacer framePacer;
 
   rx::shared_mutex writeCommandMtx;
   uint32_t imageIndex = 0;
   bool isImageAcquired = false;
+  bool hasDisplayTiming = false;
+  std::uint32_t presentId = 0;
 
   std::jthread cacheUpdateThread;
 
@@ -137,5 +148,8 @@ struct Device : rx::RcBase, DeviceContext {
   void lockReadWrite(int vmId, std::uint64_t address, std::uint64_t size,
                      bool isLazy);
   void unlockReadWrite(int vmId, std::uint64_t address, std::uint64_t size);
+
+  // requests are sorted in place and notified once per contiguous page run
+  void applyPageWatches(int vmId, std::span<PageWatchRequest> requests);
 };
 } // namespace amdgpu
@@ -0,0 +1,70 @@
+#include "FramePacer.hpp"
+#include <algorithm>
+
+using namespace amdgpu;
+
+// longer gaps are pauses (loading, menus) and don't describe the frame rate
+static constexpr std::uint64_t kMaxTrackedFlipInterval = 250'000'000;
+
+std::uint64_t FramePacer::schedule(std::uint64_t flipTime) {
+  if (mMode == rx::FramePacing::Off || mRefreshDuration == 0) {
+    return 0;
+  }
+
+  if (mLastFlipTime != 0 && flipTime > mLastFlipTime) {
+    auto interval = flipTime - mLastFlipTime;
+
+    if (interval < kMaxTrackedFlipInterval) {
+      mAverageFlipInterval = mAverageFlipInterval == 0
+                                 ? interval
+                                 : (mAverageFlipInterval * 7 + interval) / 8;
+    }
+  }
+
+  mLastFlipTime = flipTime;
+
+  // first grid point at or after the flip, phased by the latest present the
+  // display reported
+  auto alignToGrid = [&](std::uint64_t time) {
+    auto anchor = mLastActualTime != 0 ? mLastActualTime : mLastPresentTime;
+
+    if (anchor == 0) {
+      return time;
+    }
+
+    if (anchor >= time) {
+      return anchor - (anchor - time) / mRefreshDuration * mRefreshDuration;
+    }
+
+    auto cycles = (time - anchor + mRefreshDuration - 1) / mRefreshDuration;
+    return anchor + cycles * mRefreshDuration;
+  };
+
+  std::uint64_t target;
+
+  if (mMode == rx::FramePacing::LowLatency || mLastPresentTime == 0) {
+    target = alignToGrid(flipTime);
+  } else {
+    // a whole number of refreshes per frame, an interval at least a quarter
+    // refresh over is rounded up so 40 fps on a 120 Hz panel takes 3
+    // refreshes per frame instead of alternating between 2 and 4
+    std::uint64_t cycles = std::max<std::uint64_t>(
+        1, (mAverageFlipInterval + mRefreshDuration * 3 / 4) /
+               mRefreshDuration);
+
+    target = mLastPresentTime + cycles * mRefreshDuration;
+
+    if (target < flipTime ||
+        target > flipTime + 2 * cycles * mRefreshDuration) {
+      // the frame came late or after a pause, restart the cadence
+      target = alignToGrid(flipTime);
+    }
+  }
+
+  mLastPresentTime = target;
+  return target;
+}
+
+void FramePacer::onPresented(std::uint64_t actualTime) {
+  mLastActualTime = std::max(mLastActualTime, actualTime);
+}
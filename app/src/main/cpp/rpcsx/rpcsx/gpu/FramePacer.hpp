@@ -0,0 +1,39 @@
+#pragma once
+
+#include "rx/Config.hpp"
+#include <cstdint>
+
+namespace amdgpu {
+// Chooses present times for guest flips. Frames are kept on the refresh grid
+// of the display and in smooth mode are spaced by a stable number of
+// refreshes, so a game running below the panel rate doesn't alternate
+// between short and long frames
+class FramePacer {
+public:
+  void setMode(rx::FramePacing mode) { mMode = mode; }
+  void setRefreshDuration(std::uint64_t refreshDuration) {
+    mRefreshDuration = refreshDuration;
+  }
+
+  [[nodiscard]] rx::FramePacing getMode() const { return mMode; }
+  [[nodiscard]] std::uint64_t getRefreshDuration() const {
+    return mRefreshDuration;
+  }
+
+  // returns the earliest steady clock time in nanoseconds the frame flipped
+  // at flipTime should be shown at, 0 if it should be presented right away
+  std::uint64_t schedule(std::uint64_t flipTime);
+
+  // time the display actually showed a previously scheduled frame, used to
+  // keep the refresh grid in phase with the display
+  void onPresented(std::uint64_t actualTime);
+
+private:
+  rx::FramePacing mMode = rx::FramePacing::Off;
+  std::uint64_t mRefreshDuration = 0;
+  std::uint64_t mLastFlipTime = 0;
+  std::uint64_t mAverageFlipInterval = 0;
+  std::uint64_t mLastPresentTime = 0;
+  std::uint64_t mLastActualTime = 0;
+};
+} // namespace amdgpu
@@ -63,6 +63,35 @@ static Scheduler createComputeScheduler(int index) {
   return Scheduler{queue, family};
 }
 
+// Packets that only update pipe state, they can be decoded while the
+// previous draw is still executing on the GPU
+static bool isStatePacket(std::uint32_t op) {
+  switch (op) {
+  case gnm::IT_NOP:
+  case gnm::IT_SET_BASE:
+  case gnm::IT_CLEAR_STATE:
+  case gnm::IT_INDEX_BUFFER_SIZE:
+  case gnm::IT_INDEX_BASE:
+  case gnm::IT_INDEX_TYPE:
+  case gnm::IT_NUM_INSTANCES:
+  case gnm::IT_CONTEXT_CONTROL:
+  case gnm::IT_DRAW_PREAMBLE:
+  case gnm::IT_SET_CONFIG_REG:
+  case gnm::IT_SET_CONTEXT_REG:
+  case gnm::IT_SET_SH_REG:
+  case gnm::IT_SET_UCONFIG_REG:
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+static bool isRegisterWritePacket(std::uint32_t op) {
+  return op == gnm::IT_SET_CONTEXT_REG || op == gnm::IT_SET_SH_REG ||
+         op == gnm::IT_SET_UCONFIG_REG;
+}
+
 static bool compare(int cmpFn, std::uint32_t poll, std::uint32_t mask,
                     std::uint32_t ref) {
   poll &= mask;
@@ -107,7 +136,9 @@ ComputePipe::ComputePipe(int index)
 }
 
 bool ComputePipe::processAllRings() {
-  bool allProcessed = true;
+  // Dispatches run asynchronously on the compute queue, keep polling until
+  // their cache tags are released
+  bool allProcessed = scheduler.poll();
 
   for (auto &queue : queues) {
     std::lock_guard lock(queueMtx[&queue - queues]);
@@ -274,6 +305,12 @@ bool ComputePipe::setShReg(Ring &ring) {
 }
 
 bool ComputePipe::dispatchDirect(Ring &ring) {
+  // The next dispatch can read what the previous one writes, keep a single
+  // submission in flight and let the other pipes run meanwhile
+  if (!scheduler.poll()) {
+    return false;
+  }
+
   auto config = std::bit_cast<Registers::ComputeConfig *>(ring.doorbell);
   auto dimX = ring.rptr[1];
   auto dimY = ring.rptr[2];
@@ -281,12 +318,17 @@ bool ComputePipe::dispatchDirect(Ring &ring) {
   auto dispatchInitiator = ring.rptr[4];
   config->computeDispatchInitiator = dispatchInitiator;
 
-  amdgpu::dispatch(device->caches[ring.vmId], scheduler, *config, dimX, dimY,
-                   dimZ);
+  amdgpu::recordDispatch(device->caches[ring.vmId], scheduler, *config, dimX,
+                         dimY, dimZ);
+  scheduler.submitAsync();
   return true;
 }
 
 bool ComputePipe::dispatchIndirect(Ring &ring) {
+  if (!scheduler.poll()) {
+    return false;
+  }
+
   auto config = std::bit_cast<Registers::ComputeConfig *>(ring.doorbell);
   auto offset = ring.rptr[1];
   auto dispatchInitiator = ring.rptr[2];
@@ -299,12 +341,19 @@ bool ComputePipe::dispatchIndirect(Ring &ring) {
   auto dimY = buffer[1];
   auto dimZ = buffer[2];
 
-  amdgpu::dispatch(device->caches[ring.vmId], scheduler, *config, dimX, dimY,
-                   dimZ);
+  amdgpu::recordDispatch(device->caches[ring.vmId], scheduler, *config, dimX,
+                         dimY, dimZ);
+  scheduler.submitAsync();
   return true;
 }
 
 bool ComputePipe::releaseMem(Ring &ring) {
+  // End of pipe event, signal only after the compute queue timeline reached
+  // the preceding dispatches
+  if (!scheduler.poll()) {
+    return false;
+  }
+
   auto eventCntl = ring.rptr[1];
   auto dataCntl = ring.rptr[2];
   auto addressLo = ring.rptr[3] & ~3;
@@ -360,6 +409,8 @@ bool ComputePipe::releaseMem(Ring &ring) {
 }
 
 bool ComputePipe::waitRegMem(Ring &ring) {
+  scheduler.poll();
+
   auto engine = rx::getBit(ring.rptr[1], 8);
   auto memSpace = rx::getBit(ring.rptr[1], 4);
   auto function = rx::getBits(ring.rptr[1], 2, 0);
@@ -444,9 +495,14 @@ bool ComputePipe::indirectBuffer(Ring &ring) {
   return true;
 }
 
-bool ComputePipe::acquireMem(Ring &ring) { return true; }
+bool ComputePipe::acquireMem(Ring &ring) { return scheduler.poll(); }
 
 bool ComputePipe::dmaData(Ring &ring) {
+  // The copy goes through the cache, dispatch results must be released first
+  if (!scheduler.poll()) {
+    return false;
+  }
+
   auto control = ring.rptr[1];
   auto srcAddressLo = ring.rptr[2];
   auto data = srcAddressLo;
@@ -840,6 +896,22 @@ void GraphicsPipe::processRing(Ring &ring) {
       //   std::println(stderr, "queue {}: {:x}", ring.indirectLevel, op);
       // }
 
+      if (cp == 2 && isRegisterWritePacket(op)) {
+        if (!setRegisterRun(ring)) {
+          return;
+        }
+        continue;
+      }
+
+      if (!isStatePacket(op)) {
+        // Wait for the deferred draw, everything else can touch memory or
+        // cache entries it is still using
+        if (!scheduler.poll()) {
+          scheduler.wait();
+          scheduler.poll();
+        }
+      }
+
       if (op == gnm::IT_COND_EXEC) {
         std::println("unimplemented COND_EXEC");
       } else {
@@ -871,6 +943,78 @@ void GraphicsPipe::processRing(Ring &ring) {
   }
 }
 
+// Register writes make up most of the DE traffic. Consume the whole run of
+// SET_*_REG packets in the contiguous part of the ring here, decoding each
+// header once and copying the payload straight into the register file instead
+// of going through the handler table. Packets that wrap around the ring end or
+// fail the bounds check are left to the regular handlers.
+bool GraphicsPipe::setRegisterRun(Ring &ring) {
+  static constexpr std::uint32_t kPrefetchDistance = 64;
+
+  auto rptr = const_cast<std::uint32_t *>(ring.rptr);
+  auto wptr = const_cast<std::uint32_t *>(ring.wptr);
+  auto ringEnd = ring.base + ring.size;
+  auto end = wptr > rptr && wptr <= ringEnd ? wptr : ringEnd;
+
+  bool first = true;
+
+  while (rptr < end) {
+    if (rptr + kPrefetchDistance < end) {
+      __builtin_prefetch(rptr + kPrefetchDistance);
+    }
+
+    auto header = *rptr;
+    if (rx::getBits(header, 31, 30) != 3) {
+      break;
+    }
+
+    auto op = rx::getBits(header, 15, 8);
+    auto count = rx::getBits(header, 29, 16);
+    auto len = count + 2;
+
+    if (!isRegisterWritePacket(op) || rptr + len > end) {
+      break;
+    }
+
+    auto offset = rptr[1] & 0xffff;
+    std::uint32_t *regs;
+    std::size_t regsSize;
+
+    if (op == gnm::IT_SET_CONTEXT_REG) {
+      regs = reinterpret_cast<std::uint32_t *>(&context);
+      regsSize = sizeof(context);
+    } else if (op == gnm::IT_SET_SH_REG) {
+      regs = reinterpret_cast<std::uint32_t *>(&sh);
+      regsSize = sizeof(sh);
+    } else {
+      regs = reinterpret_cast<std::uint32_t *>(&uConfig);
+      regsSize = sizeof(uConfig);
+    }
+
+    if ((offset + count) * sizeof(std::uint32_t) > regsSize) {
+      break;
+    }
+
+    std::memcpy(regs + offset, rptr + 2, sizeof(std::uint32_t) * count);
+    rptr += len;
+    first = false;
+  }
+
+  if (first) {
+    // Let the handler report the failure
+    auto op = rx::getBits(*rptr, 15, 8);
+    if (!(this->*commandHandlers[2][op])(ring)) {
+      return false;
+    }
+
+    rptr += std::min<std::uint32_t>(ring.size - (rptr - ring.base),
+                                    rx::getBits(*rptr, 29, 16) + 2);
+  }
+
+  ring.rptr = rptr;
+  return true;
+}
+
 bool GraphicsPipe::handleNop(Ring &ring) { return true; }
 
 bool GraphicsPipe::setBase(Ring &ring) {
@@ -123,6 +123,7 @@ struct GraphicsPipe {
 
   bool processAllRings();
   void processRing(Ring &ring);
+  bool setRegisterRun(Ring &ring);
 
   bool drawPreamble(Ring &ring);
   bool indexBufferSize(Ring &ring);
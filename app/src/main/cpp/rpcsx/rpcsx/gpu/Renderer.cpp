@@ -501,7 +501,8 @@ void amdgpu::draw(GraphicsPipe &pipe, int vmId, std::uint32_t firstVertex,
           stencilAccess != Access::None ? &stencilAttachment : nullptr,
   };
 
-  cacheTag.buildDescriptors(descriptorSets[0]);
+  cacheTag.buildDescriptors(descriptorSets[0],
+                            cacheTag.getDescriptorSetState());
 
   pipe.scheduler.submit();
   pipe.scheduler.afterSubmit([cacheTag = std::move(cacheTag)] {});
@@ -595,18 +596,30 @@ void amdgpu::draw(GraphicsPipe &pipe, int vmId, std::uint32_t firstVertex,
   }
 
   vkCmdEndRendering(commandBuffer);
-  pipe.scheduler.submit();
-  pipe.scheduler.wait();
+
+  // GraphicsPipe::processRing keeps decoding register packets while the draw
+  // executes and waits before anything that can observe its results
+  pipe.scheduler.submitAsync();
 }
 
 void amdgpu::dispatch(Cache &cache, Scheduler &sched,
                       Registers::ComputeConfig &pgm, std::uint32_t groupCountX,
                       std::uint32_t groupCountY, std::uint32_t groupCountZ) {
+  recordDispatch(cache, sched, pgm, groupCountX, groupCountY, groupCountZ);
+  sched.submit();
+  sched.wait();
+}
+
+void amdgpu::recordDispatch(Cache &cache, Scheduler &sched,
+                            Registers::ComputeConfig &pgm,
+                            std::uint32_t groupCountX,
+                            std::uint32_t groupCountY,
+                            std::uint32_t groupCountZ) {
   auto tag = cache.createComputeTag(sched);
   auto descriptorSet = tag.getDescriptorSet();
   auto shader = tag.getShader(pgm);
   auto pipelineLayout = tag.getComputePipelineLayout();
-  tag.buildDescriptors(descriptorSet);
+  tag.buildDescriptors(descriptorSet, tag.getDescriptorSetState());
 
   auto commandBuffer = sched.getCommandBuffer();
   VkShaderStageFlagBits stages[]{VK_SHADER_STAGE_COMPUTE_BIT};
@@ -615,8 +628,6 @@ void amdgpu::dispatch(Cache &cache, Scheduler &sched,
   vk::CmdBindShadersEXT(commandBuffer, 1, stages, &shader.handle);
   vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
   sched.afterSubmit([tag = std::move(tag)] {});
-  sched.submit();
-  sched.wait();
 }
 
 void amdgpu::flip(Cache::Tag &cacheTag, VkExtent2D targetExtent,
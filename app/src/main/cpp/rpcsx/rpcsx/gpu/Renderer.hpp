@@ -15,6 +15,13 @@ void dispatch(Cache &cache, Scheduler &sched,
               Registers::ComputeConfig &computeConfig,
               std::uint32_t groupCountX, std::uint32_t groupCountY,
               std::uint32_t groupCountZ);
+
+// Records a dispatch without submitting it, the cache tag is released by the
+// after submit tasks of the next submission
+void recordDispatch(Cache &cache, Scheduler &sched,
+                    Registers::ComputeConfig &computeConfig,
+                    std::uint32_t groupCountX, std::uint32_t groupCountY,
+                    std::uint32_t groupCountZ);
 void flip(Cache::Tag &cacheTag, VkExtent2D targetExtent, std::uint64_t address,
           VkImageView target, VkExtent2D imageExtent, FlipType type,
           TileMode tileMode, gnm::DataFormat dfmt, gnm::NumericFormat nfmt);
@@ -0,0 +1,665 @@
+#include "ShaderDiskCache.hpp"
+#include "rx/Serializer.hpp"
+#include "rx/print.hpp"
+#include "shader/ir.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <typeinfo>
+
+using namespace amdgpu;
+using namespace shader;
+
+// bump on changes of the record layout or of the converter output
+static constexpr std::uint32_t kCacheVersion = 1;
+static constexpr std::uint32_t kCacheMagic = 0x43535852; // RXSC
+static constexpr std::uint32_t kNullValue = ~static_cast<std::uint32_t>(0);
+static constexpr std::size_t kMaxRecordSize = 64 * 1024 * 1024;
+
+namespace {
+struct FileHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t buildId;
+  std::uint8_t binaryUuid[16];
+  std::uint32_t binaryVersion;
+  std::uint32_t reserved;
+};
+
+struct ByteSerializer : rx::Serializer {
+  std::vector<std::byte> data;
+
+  void write(std::span<const std::byte> bytes) override {
+    data.insert(data.end(), bytes.begin(), bytes.end());
+  }
+
+  void writev(std::span<const std::span<const std::byte>> chunks) override {
+    std::size_t total = 0;
+    for (auto chunk : chunks) {
+      total += chunk.size();
+    }
+
+    data.reserve(data.size() + total);
+    for (auto chunk : chunks) {
+      data.insert(data.end(), chunk.begin(), chunk.end());
+    }
+  }
+};
+
+struct ByteDeserializer : rx::Deserializer {
+  std::span<const std::byte> data;
+  std::size_t position = 0;
+
+  ByteDeserializer(std::span<const std::byte> data) : data(data) {}
+
+  void read(std::span<std::byte> bytes) override {
+    if (failure() || data.size() - position < bytes.size()) {
+      setFailure();
+      std::memset(bytes.data(), 0, bytes.size());
+      return;
+    }
+
+    std::memcpy(bytes.data(), data.data() + position, bytes.size());
+    position += bytes.size();
+  }
+};
+
+struct Hasher {
+  std::uint64_t value = 0xcbf29ce484222325;
+
+  void update(const void *data, std::size_t size) {
+    auto bytes = static_cast<const std::uint8_t *>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      value ^= bytes[i];
+      value *= 0x100000001b3;
+    }
+  }
+
+  template <typename T> void update(const T &object) {
+    update(&object, sizeof(object));
+  }
+};
+
+// Flattens the evaluator expressions of the resources into a node table.
+// Only plain spirv and amdgpu values are supported, the cache refuses to
+// store shaders with resources defined by blocks or memory ssa phis
+struct ValueWriter {
+  std::map<ir::ValueImpl *, std::uint32_t> ids;
+  std::vector<ir::Value> nodes;
+  bool failed = false;
+
+  void visit(ir::Value value) {
+    if (value == nullptr || failed) {
+      return;
+    }
+
+    auto [it, inserted] = ids.try_emplace(value.impl, kNullValue);
+    if (!inserted) {
+      if (it->second == kNullValue) {
+        // cycle
+        failed = true;
+      }
+      return;
+    }
+
+    if (typeid(*value.impl) != typeid(ir::ValueImpl) ||
+        (value.getKind() != ir::Kind::Spv &&
+         value.getKind() != ir::Kind::AmdGpu)) {
+      failed = true;
+      return;
+    }
+
+    for (auto &operand : value.getOperands()) {
+      visit(operand.getAsValue());
+    }
+
+    it->second = nodes.size();
+    nodes.push_back(value);
+  }
+
+  std::uint32_t getId(ir::Value value) const {
+    if (value == nullptr) {
+      return kNullValue;
+    }
+
+    return ids.at(value.impl);
+  }
+
+  void serializeNodes(rx::Serializer &s) const {
+    s.serialize(static_cast<std::uint32_t>(nodes.size()));
+
+    for (auto node : nodes) {
+      s.serialize(static_cast<std::uint32_t>(node.getKind()));
+      s.serialize(static_cast<std::uint32_t>(node.getOp()));
+
+      auto operands = node.getOperands();
+      s.serialize(static_cast<std::uint32_t>(operands.size()));
+
+      for (auto &operand : operands) {
+        s.serialize(static_cast<std::uint8_t>(operand.value.index()));
+
+        std::visit(
+            [&](auto &&value) {
+              using type = std::remove_cvref_t<decltype(value)>;
+              if constexpr (std::is_same_v<type, std::nullptr_t>) {
+              } else if constexpr (std::is_same_v<type, ir::ValueImpl *>) {
+                s.serialize(ids.at(value));
+              } else if constexpr (std::is_same_v<type, std::string>) {
+                s.serialize(static_cast<std::uint32_t>(value.size()));
+                s.write(std::as_bytes(std::span(value)));
+              } else {
+                s.serialize(value);
+              }
+            },
+            operand.value);
+      }
+    }
+  }
+};
+
+struct ValueReader {
+  std::vector<ir::Value> nodes;
+
+  bool deserializeNodes(rx::Deserializer &d, ir::Context &context) {
+    auto count = d.deserialize<std::uint32_t>();
+    ir::Location location = context.getUnknownLocation();
+
+    for (std::uint32_t i = 0; i < count && !d.failure(); ++i) {
+      auto kind = static_cast<ir::Kind>(d.deserialize<std::uint32_t>());
+      auto op = d.deserialize<std::uint32_t>();
+      auto operandCount = d.deserialize<std::uint32_t>();
+
+      auto node = context.create<ir::Value>(location, kind, op);
+
+      for (std::uint32_t j = 0; j < operandCount && !d.failure(); ++j) {
+        switch (d.deserialize<std::uint8_t>()) {
+        case 0:
+          node.addOperand(nullptr);
+          break;
+        case 1: {
+          auto id = d.deserialize<std::uint32_t>();
+          if (id >= nodes.size()) {
+            return false;
+          }
+          node.addOperand(nodes[id]);
+          break;
+        }
+        case 2:
+          node.addOperand(d.deserialize<std::int64_t>());
+          break;
+        case 3:
+          node.addOperand(d.deserialize<std::int32_t>());
+          break;
+        case 4:
+          node.addOperand(d.deserialize<double>());
+          break;
+        case 5:
+          node.addOperand(d.deserialize<float>());
+          break;
+        case 6:
+          node.addOperand(d.deserialize<bool>());
+          break;
+        case 7: {
+          std::string string(d.deserialize<std::uint32_t>(), '\0');
+          d.read(std::as_writable_bytes(std::span(string)));
+          node.addOperand(std::move(string));
+          break;
+        }
+        default:
+          return false;
+        }
+      }
+
+      nodes.push_back(node);
+    }
+
+    return !d.failure();
+  }
+
+  bool getValue(rx::Deserializer &d, ir::Value &result) const {
+    auto id = d.deserialize<std::uint32_t>();
+    if (id == kNullValue) {
+      result = nullptr;
+      return true;
+    }
+
+    if (id >= nodes.size()) {
+      return false;
+    }
+
+    result = nodes[id];
+    return true;
+  }
+
+  bool getValues(rx::Deserializer &d, std::span<ir::Value> result) const {
+    return std::ranges::all_of(
+        result, [&](ir::Value &value) { return getValue(d, value); });
+  }
+};
+} // namespace
+
+static bool serializeResources(rx::Serializer &s,
+                               const gcn::Resources &resources) {
+  ValueWriter writer;
+
+  for (auto &pointer : resources.pointers) {
+    writer.visit(pointer.base);
+    writer.visit(pointer.offset);
+  }
+
+  auto visitWords = [&](auto &list) {
+    for (auto &resource : list) {
+      for (auto word : resource.words) {
+        writer.visit(word);
+      }
+    }
+  };
+
+  visitWords(resources.buffers);
+  visitWords(resources.textures);
+  visitWords(resources.imageBuffers);
+  visitWords(resources.samplers);
+
+  if (writer.failed) {
+    return false;
+  }
+
+  writer.serializeNodes(s);
+
+  auto serializeWords = [&](auto &words) {
+    for (auto word : words) {
+      s.serialize(writer.getId(word));
+    }
+  };
+
+  s.serialize(resources.hasUnknown);
+  s.serialize(resources.slots);
+
+  s.serialize(static_cast<std::uint32_t>(resources.pointers.size()));
+  for (auto &pointer : resources.pointers) {
+    s.serialize(pointer.resourceSlot);
+    s.serialize(pointer.size);
+    s.serialize(writer.getId(pointer.base));
+    s.serialize(writer.getId(pointer.offset));
+  }
+
+  s.serialize(static_cast<std::uint32_t>(resources.buffers.size()));
+  for (auto &buffer : resources.buffers) {
+    s.serialize(buffer.resourceSlot);
+    s.serialize(buffer.access);
+    serializeWords(buffer.words);
+  }
+
+  s.serialize(static_cast<std::uint32_t>(resources.textures.size()));
+  for (auto &texture : resources.textures) {
+    s.serialize(texture.resourceSlot);
+    s.serialize(texture.access);
+    serializeWords(texture.words);
+  }
+
+  s.serialize(static_cast<std::uint32_t>(resources.imageBuffers.size()));
+  for (auto &imageBuffer : resources.imageBuffers) {
+    s.serialize(imageBuffer.resourceSlot);
+    s.serialize(imageBuffer.access);
+    serializeWords(imageBuffer.words);
+  }
+
+  s.serialize(static_cast<std::uint32_t>(resources.samplers.size()));
+  for (auto &sampler : resources.samplers) {
+    s.serialize(sampler.resourceSlot);
+    s.serialize(sampler.unorm);
+    serializeWords(sampler.words);
+  }
+
+  return true;
+}
+
+static bool deserializeResources(rx::Deserializer &d,
+                                 gcn::Resources &resources) {
+  ValueReader reader;
+  if (!reader.deserializeNodes(d, resources.context)) {
+    return false;
+  }
+
+  resources.hasUnknown = d.deserialize<bool>();
+  resources.slots = d.deserialize<std::uint32_t>();
+
+  resources.pointers.resize(d.deserialize<std::uint32_t>());
+  for (auto &pointer : resources.pointers) {
+    pointer.resourceSlot = d.deserialize<std::uint32_t>();
+    pointer.size = d.deserialize<std::uint32_t>();
+    if (!reader.getValue(d, pointer.base) ||
+        !reader.getValue(d, pointer.offset)) {
+      return false;
+    }
+  }
+
+  resources.buffers.resize(d.deserialize<std::uint32_t>());
+  for (auto &buffer : resources.buffers) {
+    buffer.resourceSlot = d.deserialize<std::uint32_t>();
+    buffer.access = d.deserialize<Access>();
+    if (!reader.getValues(d, buffer.words)) {
+      return false;
+    }
+  }
+
+  resources.textures.resize(d.deserialize<std::uint32_t>());
+  for (auto &texture : resources.textures) {
+    texture.resourceSlot = d.deserialize<std::uint32_t>();
+    texture.access = d.deserialize<Access>();
+    if (!reader.getValues(d, texture.words)) {
+      return false;
+    }
+  }
+
+  resources.imageBuffers.resize(d.deserialize<std::uint32_t>());
+  for (auto &imageBuffer : resources.imageBuffers) {
+    imageBuffer.resourceSlot = d.deserialize<std::uint32_t>();
+    imageBuffer.access = d.deserialize<Access>();
+    if (!reader.getValues(d, imageBuffer.words)) {
+      return false;
+    }
+  }
+
+  resources.samplers.resize(d.deserialize<std::uint32_t>());
+  for (auto &sampler : resources.samplers) {
+    sampler.resourceSlot = d.deserialize<std::uint32_t>();
+    sampler.unorm = d.deserialize<bool>();
+    if (!reader.getValues(d, sampler.words)) {
+      return false;
+    }
+  }
+
+  return !d.failure();
+}
+
+template <typename T>
+static void serializeVector(rx::Serializer &s, std::span<const T> data) {
+  auto size = static_cast<std::uint32_t>(data.size());
+  const std::span<const std::byte> chunks[] = {
+      std::as_bytes(std::span(&size, 1)),
+      std::as_bytes(data),
+  };
+  s.writev(chunks);
+}
+
+template <typename T>
+static std::vector<T> deserializeVector(rx::Deserializer &d) {
+  std::vector<T> result;
+  auto size = d.deserialize<std::uint32_t>();
+  if (d.failure() || size > kMaxRecordSize / sizeof(T)) {
+    d.setFailure();
+    return result;
+  }
+
+  result.resize(size);
+  d.read(std::as_writable_bytes(std::span(result)));
+  return result;
+}
+
+static void serializeUsedMemory(rx::Serializer &s,
+                                const ShaderDiskCache::UsedMemory &usedMemory) {
+  s.serialize(static_cast<std::uint32_t>(usedMemory.size()));
+  for (auto &[address, bytes] : usedMemory) {
+    s.serialize(address);
+    serializeVector<std::byte>(s, bytes);
+  }
+}
+
+static ShaderDiskCache::UsedMemory deserializeUsedMemory(rx::Deserializer &d) {
+  ShaderDiskCache::UsedMemory result;
+  auto count = d.deserialize<std::uint32_t>();
+
+  for (std::uint32_t i = 0; i < count && !d.failure(); ++i) {
+    auto address = d.deserialize<std::uint64_t>();
+    result.emplace_back(address, deserializeVector<std::byte>(d));
+  }
+
+  return result;
+}
+
+static std::uint64_t getKeyHash(gcn::Stage stage, const gcn::Environment &env,
+                                std::uint64_t magic) {
+  Hasher hasher;
+  hasher.update(stage);
+  hasher.update(env.vgprCount);
+  hasher.update(env.sgprCount);
+  hasher.update(env.numThreadX);
+  hasher.update(env.numThreadY);
+  hasher.update(env.numThreadZ);
+  hasher.update(env.supportsBarycentric);
+  hasher.update(env.supportsInt8);
+  hasher.update(env.supportsInt64Atomics);
+  hasher.update(env.supportsNonSemanticInfo);
+  hasher.update(magic);
+  return hasher.value;
+}
+
+ShaderDiskCache::~ShaderDiskCache() {
+  if (mFile != nullptr) {
+    std::fclose(mFile);
+  }
+}
+
+void ShaderDiskCache::open(const std::filesystem::path &path,
+                           std::span<const std::uint32_t> semanticModule,
+                           std::span<const std::uint8_t> binaryUuid,
+                           std::uint32_t binaryVersion) {
+  std::lock_guard lock(mMtx);
+
+  if (mFile != nullptr || path.empty()) {
+    return;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(path, ec);
+  auto filePath = path / "shaders.bin";
+
+  Hasher buildHasher;
+  buildHasher.update(semanticModule.data(), semanticModule.size_bytes());
+
+  FileHeader expectedHeader{
+      .magic = kCacheMagic,
+      .version = kCacheVersion,
+      .buildId = buildHasher.value,
+      .binaryUuid = {},
+      .binaryVersion = binaryVersion,
+      .reserved = 0,
+  };
+  std::memcpy(expectedHeader.binaryUuid, binaryUuid.data(),
+              std::min(binaryUuid.size(), sizeof(expectedHeader.binaryUuid)));
+
+  std::vector<std::byte> fileData;
+  if (auto file = std::fopen(filePath.c_str(), "rb")) {
+    std::fseek(file, 0, SEEK_END);
+    auto fileSize = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    fileData.resize(fileSize > 0 ? fileSize : 0);
+    if (std::fread(fileData.data(), 1, fileData.size(), file) !=
+        fileData.size()) {
+      fileData.clear();
+    }
+    std::fclose(file);
+  }
+
+  FileHeader header{};
+  if (fileData.size() >= sizeof(header)) {
+    std::memcpy(&header, fileData.data(), sizeof(header));
+  }
+
+  if (std::memcmp(&header, &expectedHeader, sizeof(header)) != 0) {
+    mFile = std::fopen(filePath.c_str(), "wb");
+    if (mFile == nullptr) {
+      rx::println(stderr, "shader cache: failed to create {}",
+                  filePath.string());
+      return;
+    }
+
+    std::fwrite(&expectedHeader, sizeof(expectedHeader), 1, mFile);
+    std::fflush(mFile);
+    return;
+  }
+
+  std::size_t validSize = sizeof(header);
+  std::size_t recordCount = 0;
+
+  while (fileData.size() - validSize >= sizeof(std::uint32_t)) {
+    std::uint32_t recordSize;
+    std::memcpy(&recordSize, fileData.data() + validSize, sizeof(recordSize));
+
+    auto recordBegin = validSize + sizeof(recordSize);
+    if (fileData.size() - recordBegin < recordSize) {
+      break;
+    }
+
+    ByteDeserializer d(std::span(fileData).subspan(recordBegin, recordSize));
+    auto keyHash = d.deserialize<std::uint64_t>();
+
+    Record record;
+    record.usedMemory = deserializeUsedMemory(d);
+
+    auto sgprCount = d.deserialize<std::uint32_t>();
+    for (std::uint32_t i = 0; i < sgprCount && !d.failure(); ++i) {
+      auto index = d.deserialize<std::int32_t>();
+      auto value = d.deserialize<std::uint32_t>();
+      record.requiredSgprs.emplace_back(index, value);
+    }
+
+    if (d.failure()) {
+      break;
+    }
+
+    auto payload = d.data.subspan(d.position);
+    record.payload.assign(payload.begin(), payload.end());
+    mRecords[keyHash].push_back(std::move(record));
+
+    validSize = recordBegin + recordSize;
+    recordCount++;
+  }
+
+  if (validSize != fileData.size()) {
+    // drop partially written tail
+    std::filesystem::resize_file(filePath, validSize, ec);
+  }
+
+  mFile = std::fopen(filePath.c_str(), "ab");
+  if (mFile == nullptr) {
+    rx::println(stderr, "shader cache: failed to open {}", filePath.string());
+  }
+
+  rx::println(stderr, "shader cache: loaded {} shaders", recordCount);
+}
+
+std::optional<ShaderDiskCache::Shader>
+ShaderDiskCache::find(gcn::Stage stage, const gcn::Environment &env,
+                      std::uint64_t magic, ReadMemory readMemory) {
+  std::lock_guard lock(mMtx);
+
+  auto it = mRecords.find(getKeyHash(stage, env, magic));
+  if (it == mRecords.end()) {
+    return {};
+  }
+
+  std::vector<std::byte> memory;
+
+  auto isMatches = [&](const Record &record) {
+    for (auto [index, sgpr] : record.requiredSgprs) {
+      if (index < 0 || static_cast<std::size_t>(index) >= env.userSgprs.size() ||
+          env.userSgprs[index] != sgpr) {
+        return false;
+      }
+    }
+
+    for (auto &[address, bytes] : record.usedMemory) {
+      memory.resize(bytes.size());
+      readMemory(memory.data(),
+                 rx::AddressRange::fromBeginSize(address, bytes.size()));
+
+      if (memory != bytes) {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  for (auto &record : it->second) {
+    if (!isMatches(record)) {
+      continue;
+    }
+
+    Shader result;
+    auto &info = result.converted.info;
+
+    ByteDeserializer d(record.payload);
+    info.configSlots = deserializeVector<gcn::ConfigSlot>(d);
+    if (!deserializeResources(d, info.resources)) {
+      return {};
+    }
+
+    result.converted.spv = deserializeVector<std::uint32_t>(d);
+    result.binary = deserializeVector<std::byte>(d);
+
+    if (d.failure()) {
+      return {};
+    }
+
+    info.requiredSgprs = record.requiredSgprs;
+    result.usedMemory = record.usedMemory;
+
+    for (auto &[address, bytes] : record.usedMemory) {
+      info.memoryMap.map(address, address + bytes.size());
+    }
+
+    return result;
+  }
+
+  return {};
+}
+
+void ShaderDiskCache::store(gcn::Stage stage, const gcn::Environment &env,
+                            std::uint64_t magic,
+                            std::span<const std::uint32_t> spv,
+                            const gcn::ShaderInfo &info,
+                            const UsedMemory &usedMemory,
+                            std::span<const std::byte> binary) {
+  std::lock_guard lock(mMtx);
+
+  if (mFile == nullptr) {
+    return;
+  }
+
+  ByteSerializer payload;
+  serializeVector<gcn::ConfigSlot>(payload, info.configSlots);
+  if (!serializeResources(payload, info.resources)) {
+    return;
+  }
+
+  serializeVector<std::uint32_t>(payload, spv);
+  serializeVector<std::byte>(payload, binary);
+
+  auto keyHash = getKeyHash(stage, env, magic);
+
+  Record record;
+  record.usedMemory = usedMemory;
+  record.requiredSgprs = info.requiredSgprs;
+  record.payload = std::move(payload.data);
+
+  ByteSerializer s;
+  s.serialize(keyHash);
+  serializeUsedMemory(s, record.usedMemory);
+  s.serialize(static_cast<std::uint32_t>(record.requiredSgprs.size()));
+  for (auto [index, sgpr] : record.requiredSgprs) {
+    s.serialize(static_cast<std::int32_t>(index));
+    s.serialize(sgpr);
+  }
+  s.write(record.payload);
+
+  auto recordSize = static_cast<std::uint32_t>(s.data.size());
+  std::fwrite(&recordSize, sizeof(recordSize), 1, mFile);
+  std::fwrite(s.data.data(), 1, s.data.size(), mFile);
+  std::fflush(mFile);
+
+  mRecords[keyHash].push_back(std::move(record));
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "rx/AddressRange.hpp"
+#include "rx/FunctionRef.hpp"
+#include "shader/GcnConverter.hpp"
+#include "shader/gcn.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace amdgpu {
+// Keeps converted shaders between launches. Entries are keyed by the shader
+// stage, environment and the first code bytes of the shader, and are only
+// reused if all GCN code the converter read and the user sgprs it specialized
+// on still match
+class ShaderDiskCache {
+public:
+  using UsedMemory =
+      std::vector<std::pair<std::uint64_t, std::vector<std::byte>>>;
+  using ReadMemory = rx::FunctionRef<void(void *, rx::AddressRange)>;
+
+  struct Shader {
+    shader::gcn::ConvertedShader converted;
+    UsedMemory usedMemory;
+
+    // driver binary of the shader object, empty if driver doesn't provide it
+    std::vector<std::byte> binary;
+  };
+
+  ShaderDiskCache() = default;
+  ShaderDiskCache(const ShaderDiskCache &) = delete;
+  ShaderDiskCache &operator=(const ShaderDiskCache &) = delete;
+  ~ShaderDiskCache();
+
+  // the cache is dropped if the builtin gcn semantic or the driver shader
+  // binary format changes
+  void open(const std::filesystem::path &path,
+            std::span<const std::uint32_t> semanticModule,
+            std::span<const std::uint8_t> binaryUuid,
+            std::uint32_t binaryVersion);
+
+  std::optional<Shader> find(shader::gcn::Stage stage,
+                             const shader::gcn::Environment &env,
+                             std::uint64_t magic, ReadMemory readMemory);
+
+  void store(shader::gcn::Stage stage, const shader::gcn::Environment &env,
+             std::uint64_t magic, std::span<const std::uint32_t> spv,
+             const shader::gcn::ShaderInfo &info, const UsedMemory &usedMemory,
+             std::span<const std::byte> binary);
+
+private:
+  struct Record {
+    UsedMemory usedMemory;
+    std::vector<std::pair<int, std::uint32_t>> requiredSgprs;
+
+    // serialized config slots, resources, spirv and driver binary
+    std::vector<std::byte> payload;
+  };
+
+  std::mutex mMtx;
+  std::FILE *mFile = nullptr;
+  std::map<std::uint64_t, std::vector<Record>> mRecords;
+};
+} // namespace amdgpu
@@ -0,0 +1,85 @@
+#include "StagingRing.hpp"
+#include <algorithm>
+
+using namespace amdgpu;
+
+void StagingRing::init(std::uint64_t size) {
+  mBuffer = vk::Buffer::Allocate(vk::getHostVisibleMemory(), size,
+                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  mSize = size;
+  mHead = 0;
+  mFences.clear();
+}
+
+void StagingRing::reclaim() {
+  // fences are released in allocation order, a completed submission of
+  // another scheduler waits until the older ones complete
+  while (!mFences.empty() &&
+         mFences.front().sched->isComplete(mFences.front().signalValue)) {
+    mFences.pop_front();
+  }
+
+  if (mFences.empty()) {
+    mHead = 0;
+  }
+}
+
+std::optional<StagingRing::Allocation>
+StagingRing::allocate(Scheduler &sched, std::uint64_t size) {
+  size = std::max<std::uint64_t>(size, 1);
+  size = (size + kAlignment - 1) & ~(kAlignment - 1);
+
+  std::lock_guard lock(mMtx);
+
+  if (size > mSize) {
+    return {};
+  }
+
+  reclaim();
+
+  std::uint64_t offset = mHead;
+
+  if (!mFences.empty()) {
+    auto tail = mFences.front().begin;
+
+    if (mHead > tail) {
+      if (offset + size > mSize) {
+        // wrap around, the rest of the buffer stays unused until the tail
+        // passes it
+        if (size > tail) {
+          return {};
+        }
+
+        offset = 0;
+      }
+    } else if (offset + size > tail) {
+      return {};
+    }
+  }
+
+  mHead = offset + size;
+
+  auto signalValue = sched.getNextSignal();
+
+  if (!mFences.empty() && mFences.back().sched == &sched &&
+      mFences.back().signalValue == signalValue &&
+      mFences.back().end == offset) {
+    mFences.back().end = mHead;
+  } else {
+    mFences.push_back({
+        .sched = &sched,
+        .signalValue = signalValue,
+        .begin = offset,
+        .end = mHead,
+    });
+  }
+
+  return Allocation{
+      .handle = mBuffer.getHandle(),
+      .offset = offset,
+      .deviceAddress = mBuffer.getAddress() + offset,
+      .data = mBuffer.getData() + offset,
+  };
+}
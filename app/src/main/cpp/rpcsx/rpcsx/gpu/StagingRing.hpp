@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Scheduler.hpp"
+#include "vk.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace amdgpu {
+// Host visible buffer shared by short lived uploads. Space is handed out by a
+// bump pointer and reused once the submission that consumed it completed
+class StagingRing {
+public:
+  static constexpr std::uint64_t kAlignment = 256;
+
+  struct Allocation {
+    VkBuffer handle;
+    std::uint64_t offset;
+    std::uint64_t deviceAddress;
+    std::byte *data;
+  };
+
+  void init(std::uint64_t size);
+
+  // the space is owned by the commands recorded into sched until their
+  // submission completes. Returns nullopt if the ring has no free space left
+  std::optional<Allocation> allocate(Scheduler &sched, std::uint64_t size);
+
+private:
+  struct Fence {
+    Scheduler *sched;
+    std::uint64_t signalValue;
+    std::uint64_t begin;
+    std::uint64_t end;
+  };
+
+  void reclaim();
+
+  std::mutex mMtx;
+  vk::Buffer mBuffer;
+  std::uint64_t mSize = 0;
+  std::uint64_t mHead = 0;
+  std::deque<Fence> mFences;
+};
+} // namespace amdgpu
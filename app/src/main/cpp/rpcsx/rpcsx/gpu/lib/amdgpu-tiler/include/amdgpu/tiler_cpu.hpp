@@ -2,9 +2,27 @@
 
 #include "gnm/constants.hpp"
 #include "tiler.hpp"
+#include <cstddef>
 #include <cstdint>
 
 namespace amdgpu {
+// Host counterpart of GpuTiler::detile/tile for small surfaces. Processes a
+// whole micro tile at a time, the 8x8 element permutation is applied with
+// byte table lookups instead of computing the tiled offset of each texel.
+// Only thin, single sample micro tiles which stay inside one pipe interleave
+// chunk are handled, isCpuTilerSupported must be checked first
+bool isCpuTilerSupported(const SurfaceInfo &info, TileMode tileMode,
+                         int mipLevel, int arrayCount);
+void detileCpu(const SurfaceInfo &info, TileMode tileMode,
+               const std::byte *srcTiled, std::uint64_t srcSize,
+               std::byte *dstLinear, std::uint64_t dstSize, int mipLevel,
+               int baseArray, int arrayCount);
+void tileCpu(const SurfaceInfo &info, TileMode tileMode,
+             const std::byte *srcLinear, std::uint64_t srcSize,
+             std::byte *dstTiled, std::uint64_t dstSize, int mipLevel,
+             int baseArray, int arrayCount);
+
+
 std::uint64_t getTiledOffset(gnm::TextureType texType, bool isPow2Padded,
                              int numFragments, gnm::DataFormat dfmt,
                              amdgpu::TileMode tileMode,
@@ -1,6 +1,12 @@
 #include "amdgpu/tiler_cpu.hpp"
 #include "amdgpu/tiler.hpp"
 #include "gnm/gnm.hpp"
+#include <array>
+#include <cstring>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 constexpr std::uint64_t
 getTiledOffset1D(gnm::TextureType texType, bool isPow2Padded,
@@ -439,3 +445,401 @@ std::uint64_t amdgpu::getTiledOffset(gnm::TextureType texType,
 
   std::abort();
 }
+
+namespace {
+// Byte permutation of one packed micro tile, split into 16 byte output
+// chunks. Every chunk gathers from at most 4 windows of 64 source bytes,
+// index 0xff marks bytes taken from another window
+struct MicroTileShuffle {
+  struct Chunk {
+    std::uint8_t windowCount;
+    std::uint8_t window[4];
+    std::uint8_t index[4][16];
+  };
+
+  std::uint32_t chunkCount = 0;
+  Chunk chunks[64];
+};
+
+struct MicroTileShuffles {
+  bool valid = false;
+  MicroTileShuffle detile; // tiled micro tile -> 8 packed linear rows
+  MicroTileShuffle tile;   // 8 packed linear rows -> tiled micro tile
+};
+
+constexpr int kElementSizeCount = 5; // 8, 16, 32, 64 and 128 bits
+
+MicroTileShuffle buildShuffle(const std::uint32_t *source,
+                              std::uint32_t size) {
+  MicroTileShuffle result;
+  result.chunkCount = size / 16;
+
+  for (std::uint32_t c = 0; c < result.chunkCount; ++c) {
+    auto &chunk = result.chunks[c];
+    chunk.windowCount = 0;
+    std::memset(chunk.index, 0xff, sizeof(chunk.index));
+
+    for (std::uint32_t i = 0; i < 16; ++i) {
+      auto from = source[c * 16 + i];
+      std::uint8_t window = from / 64;
+      std::uint32_t slot = 0;
+
+      while (slot < chunk.windowCount && chunk.window[slot] != window) {
+        ++slot;
+      }
+
+      if (slot == chunk.windowCount) {
+        chunk.window[chunk.windowCount++] = window;
+      }
+
+      chunk.index[slot][i] = from % 64;
+    }
+  }
+
+  return result;
+}
+
+MicroTileShuffles buildShuffles(int sizeIndex, bool display) {
+  MicroTileShuffles result;
+  std::uint32_t bitsPerElement = 8u << sizeIndex;
+  std::uint32_t bytesPerElement = bitsPerElement / 8;
+
+  if (display && bitsPerElement > 64) {
+    return result;
+  }
+
+  auto microTileMode =
+      display ? amdgpu::kMicroTileModeDisplay : amdgpu::kMicroTileModeThin;
+  std::uint32_t size = 64 * bytesPerElement;
+  std::uint32_t detileSource[64 * 16];
+  std::uint32_t tileSource[64 * 16];
+
+  for (std::uint32_t y = 0; y < amdgpu::kMicroTileHeight; ++y) {
+    for (std::uint32_t x = 0; x < amdgpu::kMicroTileWidth; ++x) {
+      auto linearIndex = y * amdgpu::kMicroTileWidth + x;
+      auto tiledIndex =
+          amdgpu::getElementIndex(x, y, 0, bitsPerElement, microTileMode,
+                                  amdgpu::kArrayMode1dTiledThin);
+
+      for (std::uint32_t b = 0; b < bytesPerElement; ++b) {
+        detileSource[linearIndex * bytesPerElement + b] =
+            tiledIndex * bytesPerElement + b;
+        tileSource[tiledIndex * bytesPerElement + b] =
+            linearIndex * bytesPerElement + b;
+      }
+    }
+  }
+
+  result.detile = buildShuffle(detileSource, size);
+  result.tile = buildShuffle(tileSource, size);
+  result.valid = true;
+  return result;
+}
+
+const MicroTileShuffles &getShuffles(int sizeIndex, bool display) {
+  static const auto table = [] {
+    std::array<std::array<MicroTileShuffles, 2>, kElementSizeCount> result;
+    for (int i = 0; i < kElementSizeCount; ++i) {
+      result[i][0] = buildShuffles(i, false);
+      result[i][1] = buildShuffles(i, true);
+    }
+    return result;
+  }();
+
+  return table[sizeIndex][display ? 1 : 0];
+}
+
+void applyShuffle(const MicroTileShuffle &shuffle, const std::byte *src,
+                  std::byte *dst) {
+  auto source = reinterpret_cast<const std::uint8_t *>(src);
+  auto target = reinterpret_cast<std::uint8_t *>(dst);
+
+  for (std::uint32_t c = 0; c < shuffle.chunkCount; ++c) {
+    auto &chunk = shuffle.chunks[c];
+#if defined(__aarch64__)
+    auto value = vqtbl4q_u8(vld1q_u8_x4(source + chunk.window[0] * 64),
+                            vld1q_u8(chunk.index[0]));
+    for (std::uint32_t w = 1; w < chunk.windowCount; ++w) {
+      value = vqtbx4q_u8(value, vld1q_u8_x4(source + chunk.window[w] * 64),
+                         vld1q_u8(chunk.index[w]));
+    }
+    vst1q_u8(target + c * 16, value);
+#else
+    for (std::uint32_t w = 0; w < chunk.windowCount; ++w) {
+      auto window = source + chunk.window[w] * 64;
+      for (std::uint32_t i = 0; i < 16; ++i) {
+        if (chunk.index[w][i] != 0xff) {
+          target[c * 16 + i] = window[chunk.index[w][i]];
+        }
+      }
+    }
+#endif
+  }
+}
+
+bool isThin2dArrayMode(amdgpu::ArrayMode arrayMode) {
+  switch (arrayMode) {
+  case amdgpu::kArrayMode2dTiledThin:
+  case amdgpu::kArrayMode3dTiledThin:
+  case amdgpu::kArrayModeTiledThinPrt:
+  case amdgpu::kArrayMode2dTiledThinPrt:
+  case amdgpu::kArrayMode3dTiledThinPrt:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Byte offset of the micro tile at element (x, y) of the first slice,
+// getTiledOffset2D reduced to z = 0, no fragments and no tile split
+std::uint64_t getMicroTileOffset2D(amdgpu::TileMode tileMode,
+                                   amdgpu::MacroTileMode macroTileMode,
+                                   std::uint32_t tileBytes,
+                                   std::uint32_t dataWidth, std::uint32_t x,
+                                   std::uint32_t y) {
+  using namespace amdgpu;
+
+  std::uint32_t bankWidth = 1 << macroTileMode.bankWidth();
+  std::uint32_t bankHeight = 1 << macroTileMode.bankHeight();
+  std::uint32_t numBanks = 2 << macroTileMode.numBanks();
+  std::uint32_t macroTileAspect = 1 << macroTileMode.macroTileAspect();
+  std::uint32_t numPipes = getPipeCount(tileMode.pipeConfig());
+  auto pipeInterleaveBits = std::countr_zero(kPipeInterleaveBytes);
+  auto pipeBits = std::countr_zero(numPipes);
+  auto bankBits = std::countr_zero(numBanks);
+
+  auto macroTileWidth =
+      (kMicroTileWidth * bankWidth * numPipes) * macroTileAspect;
+  auto macroTileHeight =
+      (kMicroTileHeight * bankHeight * numBanks) / macroTileAspect;
+
+  std::uint32_t xh = x, yh = y;
+  if (tileMode.arrayMode() == kArrayModeTiledThinPrt) {
+    xh %= macroTileWidth;
+    yh %= macroTileHeight;
+  }
+
+  std::uint64_t pipe = getPipeIndex(xh, yh, tileMode.pipeConfig());
+  std::uint64_t bank =
+      getBankIndex(xh, yh, bankWidth, bankHeight, numBanks, numPipes);
+
+  std::uint64_t macroTileBytes = (macroTileWidth / kMicroTileWidth) *
+                                 (macroTileHeight / kMicroTileHeight) *
+                                 tileBytes / (numPipes * numBanks);
+  std::uint64_t macroTilesPerRow = dataWidth / macroTileWidth;
+  std::uint64_t macroTileIndex =
+      (y / macroTileHeight) * macroTilesPerRow + x / macroTileWidth;
+
+  std::uint64_t tileRowIndex = (y / kMicroTileHeight) % bankHeight;
+  std::uint64_t tileColumnIndex =
+      ((x / kMicroTileWidth) / numPipes) % bankWidth;
+  std::uint64_t tileOffset =
+      (tileRowIndex * bankWidth + tileColumnIndex) * tileBytes;
+
+  std::uint64_t totalOffset = macroTileIndex * macroTileBytes + tileOffset;
+  std::uint64_t pipeInterleaveOffset =
+      totalOffset & (kPipeInterleaveBytes - 1);
+  std::uint64_t offset = totalOffset >> pipeInterleaveBits;
+
+  return pipeInterleaveOffset | (pipe << pipeInterleaveBits) |
+         (bank << (pipeInterleaveBits + pipeBits)) |
+         (offset << (pipeInterleaveBits + pipeBits + bankBits));
+}
+
+struct MicroTileWalker {
+  const amdgpu::SurfaceInfo &info;
+  amdgpu::TileMode tileMode;
+  const amdgpu::SurfaceInfo::SubresourceInfo &subresource;
+  std::uint32_t bytesPerElement;
+  std::uint32_t tileBytes;
+  const MicroTileShuffles &shuffles;
+
+  MicroTileWalker(const amdgpu::SurfaceInfo &info, amdgpu::TileMode tileMode,
+                  int mipLevel)
+      : info(info), tileMode(tileMode),
+        subresource(info.getSubresourceInfo(mipLevel)),
+        bytesPerElement(info.bitsPerElement / 8),
+        tileBytes(kMicroTileWidth * kMicroTileHeight * info.bitsPerElement /
+                  8),
+        shuffles(getShuffles(std::countr_zero(bytesPerElement),
+                             tileMode.microTileMode() ==
+                                 amdgpu::kMicroTileModeDisplay)) {}
+
+  static constexpr auto kMicroTileWidth = amdgpu::kMicroTileWidth;
+  static constexpr auto kMicroTileHeight = amdgpu::kMicroTileHeight;
+
+  std::uint64_t getTileOffset(std::uint32_t x, std::uint32_t y) const {
+    if (tileMode.arrayMode() == amdgpu::kArrayMode1dTiledThin) {
+      std::uint64_t tilesPerRow = subresource.tiledWidth / kMicroTileWidth;
+      return ((y / kMicroTileHeight) * tilesPerRow + x / kMicroTileWidth) *
+             tileBytes;
+    }
+
+    return getMicroTileOffset2D(tileMode, info.macroTileMode, tileBytes,
+                                subresource.tiledWidth, x, y);
+  }
+
+  template <typename Fn> void forEachTile(int baseArray, int arrayCount,
+                                          Fn &&fn) const {
+    for (int layer = baseArray; layer < baseArray + arrayCount; ++layer) {
+      auto tiledBase =
+          subresource.tiledOffset + layer * subresource.tiledSize;
+      auto linearBase =
+          subresource.linearOffset + layer * subresource.linearSize;
+
+      for (std::uint32_t y = 0; y < subresource.linearHeight;
+           y += kMicroTileHeight) {
+        for (std::uint32_t x = 0; x < subresource.linearWidth;
+             x += kMicroTileWidth) {
+          auto rows = std::min(kMicroTileHeight, subresource.linearHeight - y);
+          auto columns = std::min(kMicroTileWidth, subresource.linearWidth - x);
+          auto linearOffset =
+              linearBase +
+              (std::uint64_t(y) * subresource.linearPitch + x) *
+                  bytesPerElement;
+
+          fn(tiledBase + getTileOffset(x, y), linearOffset, rows, columns);
+        }
+      }
+    }
+  }
+};
+} // namespace
+
+bool amdgpu::isCpuTilerSupported(const SurfaceInfo &info, TileMode tileMode,
+                                 int mipLevel, int arrayCount) {
+  auto arrayMode = tileMode.arrayMode();
+  auto microTileMode = tileMode.microTileMode();
+  auto &subresource = info.getSubresourceInfo(mipLevel);
+
+  if (info.numFragments != 0 || subresource.linearDepth != 1 ||
+      subresource.tiledWidth % kMicroTileWidth != 0 ||
+      subresource.tiledHeight % kMicroTileHeight != 0) {
+    return false;
+  }
+
+  if (microTileMode != kMicroTileModeDisplay &&
+      microTileMode != kMicroTileModeThin &&
+      microTileMode != kMicroTileModeDepth) {
+    return false;
+  }
+
+  switch (info.bitsPerElement) {
+  case 8:
+  case 16:
+  case 32:
+  case 64:
+  case 128:
+    break;
+  default:
+    return false;
+  }
+
+  if (!getShuffles(std::countr_zero(unsigned(info.bitsPerElement / 8)),
+                   microTileMode == kMicroTileModeDisplay)
+           .valid) {
+    return false;
+  }
+
+  if (arrayMode == kArrayMode1dTiledThin) {
+    return true;
+  }
+
+  if (!isThin2dArrayMode(arrayMode)) {
+    return false;
+  }
+
+  // Slices after the first one are rotated through the banks and pipes
+  if (arrayCount != 1) {
+    return false;
+  }
+
+  // The tile must not cross a pipe interleave chunk, otherwise its elements
+  // are not contiguous
+  std::uint32_t tileBytes =
+      kMicroTileWidth * kMicroTileHeight * info.bitsPerElement / 8;
+  if (tileBytes > kPipeInterleaveBytes) {
+    return false;
+  }
+
+  std::uint32_t tileSplit =
+      microTileMode == kMicroTileModeDepth
+          ? (64u << tileMode.tileSplit())
+          : std::max(256u, tileBytes * (1u << tileMode.sampleSplit()));
+  return tileBytes <= std::min(kDramRowSize, tileSplit);
+}
+
+void amdgpu::detileCpu(const SurfaceInfo &info, TileMode tileMode,
+                       const std::byte *srcTiled, std::uint64_t srcSize,
+                       std::byte *dstLinear, std::uint64_t dstSize,
+                       int mipLevel, int baseArray, int arrayCount) {
+  MicroTileWalker walker(info, tileMode, mipLevel);
+  auto rowBytes = kMicroTileWidth * walker.bytesPerElement;
+  auto linearPitch = walker.subresource.linearPitch * walker.bytesPerElement;
+  alignas(64) std::byte packed[kMicroTileWidth * kMicroTileHeight * 16];
+
+  walker.forEachTile(baseArray, arrayCount,
+                     [&](std::uint64_t tiledOffset, std::uint64_t linearOffset,
+                         std::uint32_t rows, std::uint32_t columns) {
+                       if (tiledOffset + walker.tileBytes > srcSize) {
+                         return;
+                       }
+
+                       applyShuffle(walker.shuffles.detile,
+                                    srcTiled + tiledOffset, packed);
+
+                       auto copyBytes = columns * walker.bytesPerElement;
+                       for (std::uint32_t row = 0; row < rows; ++row) {
+                         auto offset = linearOffset + row * linearPitch;
+                         if (offset + copyBytes > dstSize) {
+                           break;
+                         }
+
+                         std::memcpy(dstLinear + offset, packed + row * rowBytes,
+                                     copyBytes);
+                       }
+                     });
+}
+
+void amdgpu::tileCpu(const SurfaceInfo &info, TileMode tileMode,
+                     const std::byte *srcLinear, std::uint64_t srcSize,
+                     std::byte *dstTiled, std::uint64_t dstSize, int mipLevel,
+                     int baseArray, int arrayCount) {
+  MicroTileWalker walker(info, tileMode, mipLevel);
+  auto rowBytes = kMicroTileWidth * walker.bytesPerElement;
+  auto linearPitch = walker.subresource.linearPitch * walker.bytesPerElement;
+  alignas(64) std::byte packed[kMicroTileWidth * kMicroTileHeight * 16];
+
+  walker.forEachTile(
+      baseArray, arrayCount,
+      [&](std::uint64_t tiledOffset, std::uint64_t linearOffset,
+          std::uint32_t rows, std::uint32_t columns) {
+        if (tiledOffset + walker.tileBytes > dstSize) {
+          return;
+        }
+
+        auto copyBytes = columns * walker.bytesPerElement;
+        bool partial = rows != kMicroTileHeight || columns != kMicroTileWidth;
+
+        if (!partial && linearOffset + (rows - 1) * linearPitch + copyBytes >
+                            srcSize) {
+          partial = true;
+        }
+
+        if (partial) {
+          // Keep the elements outside of the linear data
+          applyShuffle(walker.shuffles.detile, dstTiled + tiledOffset, packed);
+        }
+
+        for (std::uint32_t row = 0; row < rows; ++row) {
+          auto offset = linearOffset + row * linearPitch;
+          if (offset + copyBytes > srcSize) {
+            break;
+          }
+
+          std::memcpy(packed + row * rowBytes, srcLinear + offset, copyBytes);
+        }
+
+        applyShuffle(walker.shuffles.tile, packed, dstTiled + tiledOffset);
+      });
+}
@@ -1678,6 +1678,94 @@ static void instructionsToSpv(GcnConverter &converter, gcn::Import &importer,
   }
 }
 
+static bool isExecWritten(gcn::Context &context,
+                          const SemanticInfo &semanticInfo, ir::Region body) {
+  if (auto it = context.registerVariables.find(gcn::RegId::Exec);
+      it != context.registerVariables.end()) {
+    std::vector<ir::Value> pointers = {it->second};
+
+    while (!pointers.empty()) {
+      auto pointer = pointers.back();
+      pointers.pop_back();
+
+      for (auto &use : pointer.getUseList()) {
+        if (use.user == ir::spv::OpAccessChain) {
+          pointers.push_back(use.user.staticCast<ir::Value>());
+          continue;
+        }
+
+        if (use.user == ir::spv::OpLoad || use.user == ir::spv::OpName) {
+          continue;
+        }
+
+        return true;
+      }
+    }
+  }
+
+  for (auto inst : body.children()) {
+    if (inst.getKind() == ir::Kind::Spv) {
+      continue;
+    }
+
+    auto semantic = semanticInfo.findSemantic(inst.getInstId());
+    if (semantic == nullptr) {
+      continue;
+    }
+
+    if (auto it = semantic->registerAccesses.find(int(gcn::RegId::Exec));
+        it != semantic->registerAccesses.end() &&
+        (it->second & Access::Write) != Access::None) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Graphics stages run a single lane per invocation with exec set to 1, if the
+// shader never changes exec every exec test passes and the masked writes and
+// branches around vector instructions can be dropped
+static void foldExecTests(gcn::Context &context, ir::Region body) {
+  std::vector<ir::Value> execTests;
+  for (auto inst : body.children()) {
+    if (inst == ir::amdgpu::EXEC_TEST) {
+      execTests.push_back(inst.staticCast<ir::Value>());
+    }
+  }
+
+  if (execTests.empty()) {
+    return;
+  }
+
+  for (auto execTest : execTests) {
+    while (!execTest.getUseList().empty()) {
+      auto use = *execTest.getUseList().begin();
+
+      if (use.user == ir::spv::OpSelect && use.operandIndex == 1) {
+        auto select = use.user.staticCast<ir::Value>();
+        select.replaceAllUsesWith(select.getOperand(2).getAsValue());
+        select.remove();
+        continue;
+      }
+
+      if (use.user == ir::spv::OpBranchConditional && use.operandIndex == 0) {
+        gcn::Builder::createInsertBefore(context, use.user)
+            .createSpvBranch(use.user.getLocation(),
+                             use.user.getOperand(1).getAsValue());
+        use.user.remove();
+        continue;
+      }
+
+      use.user.replaceOperand(use.operandIndex, context.getTrue());
+    }
+
+    execTest.remove();
+  }
+
+  context.analysis.invalidateAll();
+}
+
 static void createEntryPoint(gcn::Context &context, const gcn::Environment &env,
                              gcn::Stage stage, ir::Region &&body) {
   auto executionModel = ir::spv::ExecutionModel::GLCompute;
@@ -1997,6 +2085,10 @@ gcn::convertToSpv(Context &context, ir::Region body,
   GcnConverter converter{context};
   gcn::Import importer;
 
+  if (stage != gcn::Stage::Cs && !isExecWritten(context, semanticInfo, body)) {
+    foldExecTests(context, body);
+  }
+
   createInitialValues(converter, env, stage, result.info, body);
   instructionsToSpv(converter, importer, stage, env, semanticInfo,
                     semanticModule, result.info, body);
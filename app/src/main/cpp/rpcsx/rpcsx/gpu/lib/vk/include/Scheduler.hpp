@@ -52,44 +52,7 @@ public:
     }
     mIsEmpty = true;
 
-    mCommandBuffer.end();
-
-    VkSemaphoreSubmitInfo waitSemSubmitInfo = {
-        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-        .semaphore = mSemaphore.getHandle(),
-        .value = mNextSignal - 1,
-        .stageMask = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
-    };
-
-    VkSemaphoreSubmitInfo signalSemSubmitInfo = {
-        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-        .semaphore = mSemaphore.getHandle(),
-        .value = mNextSignal,
-        .stageMask = VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
-    };
-
-    VkCommandBufferSubmitInfo cmdBufferSubmitInfo{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
-        .commandBuffer = mCommandBuffer,
-    };
-
-    VkSubmitInfo2 submitInfo{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-        .waitSemaphoreInfoCount = mNextSignal != 1 ? 1u : 0u,
-        .pWaitSemaphoreInfos = &waitSemSubmitInfo,
-        .commandBufferInfoCount = 1,
-        .pCommandBufferInfos = &cmdBufferSubmitInfo,
-        .signalSemaphoreInfoCount = 1,
-        .pSignalSemaphoreInfos = &signalSemSubmitInfo,
-    };
-
-    mCommandBuffer = mCommandPool.createOneTimeSubmitBuffer();
-
-    wait();
-
-    VK_VERIFY(vkQueueSubmit2(mQueue, 1, &submitInfo, VK_NULL_HANDLE));
-
-    ++mNextSignal;
+    submitCommandBuffer(true);
 
     // then([afterSubmit = std::move(mAfterSubmitTasks)] mutable {
     //   for (auto &&fn : afterSubmit) {
@@ -99,9 +62,13 @@ public:
 
     // mAfterSubmitTasks.clear();
 
-    auto endIt = mTasks.upper_bound(mNextSignal - 1);
+    bool hasTasks;
+    {
+      std::lock_guard lock(mTaskMutex);
+      hasTasks = !mTasks.empty();
+    }
 
-    if (mAfterSubmitTasks.empty() && endIt == mTasks.end()) {
+    if (mAfterSubmitTasks.empty() && !hasTasks) {
       return *this;
     }
 
@@ -110,18 +77,58 @@ public:
 
     wait();
 
+    // Tasks of earlier async submissions go first
+    poll();
+
     while (!afterSubmit.empty()) {
       auto task = std::move(afterSubmit.back());
       afterSubmit.pop_back();
       std::move(task)();
     }
 
+    return *this;
+  }
+
+  // Submits the recorded commands without waiting for the GPU, after submit
+  // tasks are deferred until poll() observes the submission complete
+  std::uint64_t submitAsync() {
+    if (mIsEmpty) {
+      return mNextSignal - 1;
+    }
+    mIsEmpty = true;
+
+    submitCommandBuffer(false);
+    auto signalValue = mNextSignal - 1;
+
+    if (!mAfterSubmitTasks.empty()) {
+      std::lock_guard lock(mTaskMutex);
+      auto &tasks = mTasks[signalValue];
+
+      // keep the order of submit()
+      while (!mAfterSubmitTasks.empty()) {
+        tasks.push_back(std::move(mAfterSubmitTasks.back()));
+        mAfterSubmitTasks.pop_back();
+      }
+    }
+
+    return signalValue;
+  }
+
+  // Runs tasks of completed async submissions, returns false while some
+  // submission is still executing
+  bool poll() {
     std::vector<std::move_only_function<void()>> taskList;
+    auto value = mSemaphore.getCounterValue();
 
-    for (auto it = mTasks.begin(); it != mTasks.end(); it = mTasks.erase(it)) {
-      taskList.reserve(taskList.size() + it->second.size());
-      for (auto &&fn : it->second) {
-        taskList.push_back(std::move(fn));
+    {
+      std::lock_guard lock(mTaskMutex);
+      auto endIt = mTasks.upper_bound(value);
+
+      for (auto it = mTasks.begin(); it != endIt; it = mTasks.erase(it)) {
+        taskList.reserve(taskList.size() + it->second.size());
+        for (auto &&fn : it->second) {
+          taskList.push_back(std::move(fn));
+        }
       }
     }
 
@@ -129,7 +136,7 @@ public:
       std::move(task)();
     }
 
-    return *this;
+    return value >= mNextSignal - 1;
   }
 
   Scheduler &afterSubmit(std::move_only_function<void()> fn) {
@@ -157,11 +164,60 @@ public:
   // }
 
   std::uint64_t createExternalSubmit() { return mNextSignal++; }
+
+  // value signaled by the submission of the commands being recorded now
+  std::uint64_t getNextSignal() const { return mNextSignal; }
+  bool isComplete(std::uint64_t signalValue) const {
+    return mSemaphore.getCounterValue() >= signalValue;
+  }
   void wait() const { mSemaphore.wait(mNextSignal - 1, UINT64_MAX); }
 
   VkSemaphore getSemaphoreHandle() const { return mSemaphore.getHandle(); }
 
 private:
+  void submitCommandBuffer(bool waitPrevious) {
+    mCommandBuffer.end();
+
+    VkSemaphoreSubmitInfo waitSemSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = mSemaphore.getHandle(),
+        .value = mNextSignal - 1,
+        .stageMask = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+    };
+
+    VkSemaphoreSubmitInfo signalSemSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = mSemaphore.getHandle(),
+        .value = mNextSignal,
+        .stageMask = VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
+    };
+
+    VkCommandBufferSubmitInfo cmdBufferSubmitInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+        .commandBuffer = mCommandBuffer,
+    };
+
+    VkSubmitInfo2 submitInfo{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+        .waitSemaphoreInfoCount = mNextSignal != 1 ? 1u : 0u,
+        .pWaitSemaphoreInfos = &waitSemSubmitInfo,
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &cmdBufferSubmitInfo,
+        .signalSemaphoreInfoCount = 1,
+        .pSignalSemaphoreInfos = &signalSemSubmitInfo,
+    };
+
+    mCommandBuffer = mCommandPool.createOneTimeSubmitBuffer();
+
+    if (waitPrevious) {
+      wait();
+    }
+
+    VK_VERIFY(vkQueueSubmit2(mQueue, 1, &submitInfo, VK_NULL_HANDLE));
+
+    ++mNextSignal;
+  }
+
   void schedulerEntry(std::stop_token stopToken) {
     std::vector<std::move_only_function<void()>> taskList;
     while (!stopToken.stop_requested()) {
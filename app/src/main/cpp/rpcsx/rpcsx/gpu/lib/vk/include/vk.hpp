@@ -61,6 +61,7 @@ struct Context {
   VkSemaphore presentCompleteSemaphore = VK_NULL_HANDLE;
   VkSemaphore renderCompleteSemaphore = VK_NULL_HANDLE;
   VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProps;
+  VkPhysicalDeviceShaderObjectPropertiesEXT shaderObjectProps;
 
   bool supportsBarycentric = false;
   bool supportsInt8 = false;
@@ -233,6 +234,7 @@ public:
     result.mMemoryTypeIndex = memoryTypeIndex;
     return result;
   }
+  // Returns empty memory if the driver cannot import the pages
   static DeviceMemory
   CreateExternalHostMemory(void *hostPointer, std::size_t size,
                            VkMemoryPropertyFlags properties) {
@@ -243,15 +245,43 @@ public:
         (PFN_vkGetMemoryHostPointerPropertiesEXT)vkGetDeviceProcAddr(
             context->device, "vkGetMemoryHostPointerPropertiesEXT");
 
-    VK_VERIFY(vkGetMemoryHostPointerPropertiesEXT(
-        context->device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
-        hostPointer, &hostPointerProperties));
+    if (vkGetMemoryHostPointerPropertiesEXT == nullptr ||
+        vkGetMemoryHostPointerPropertiesEXT(
+            context->device,
+            VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, hostPointer,
+            &hostPointerProperties) != VK_SUCCESS) {
+      return {};
+    }
 
     auto memoryTypeBits = hostPointerProperties.memoryTypeBits;
+    bool hasMemoryType = false;
+
+    for (auto bits = memoryTypeBits; bits != 0; bits &= bits - 1) {
+      auto typeIndex = std::countr_zero(bits);
+
+      if (typeIndex <
+              static_cast<int>(
+                  context->physicalMemoryProperties.memoryTypeCount) &&
+          (context->physicalMemoryProperties.memoryTypes[typeIndex]
+               .propertyFlags &
+           properties) == properties) {
+        hasMemoryType = true;
+        break;
+      }
+    }
+
+    if (!hasMemoryType) {
+      return {};
+    }
+
+    VkMemoryAllocateFlagsInfo flags{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+        .flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+    };
 
     VkImportMemoryHostPointerInfoEXT importMemoryInfo = {
         VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT,
-        nullptr,
+        &flags,
         VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
         hostPointer,
     };
@@ -267,8 +297,11 @@ public:
     };
 
     DeviceMemory result;
-    VK_VERIFY(vkAllocateMemory(context->device, &allocInfo, context->allocator,
-                               &result.mDeviceMemory));
+    if (vkAllocateMemory(context->device, &allocInfo, context->allocator,
+                         &result.mDeviceMemory) != VK_SUCCESS) {
+      return {};
+    }
+
     result.mSize = size;
     result.mMemoryTypeIndex = memoryTypeIndex;
     return result;
@@ -740,7 +773,7 @@ public:
     bufferInfo.pNext = &info;
     bufferInfo.flags = flags;
     bufferInfo.size = size;
-    bufferInfo.usage = usage;
+    bufferInfo.usage = usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
     bufferInfo.sharingMode = sharingMode;
     bufferInfo.queueFamilyIndexCount = queueFamilyIndices.size();
     bufferInfo.pQueueFamilyIndices = queueFamilyIndices.data();
@@ -992,6 +1025,17 @@ VkResult CreateShadersEXT(VkDevice device, uint32_t createInfoCount,
 void DestroyShaderEXT(VkDevice device, VkShaderEXT shader,
                       const VkAllocationCallbacks *pAllocator);
 
+VkResult GetShaderBinaryDataEXT(VkDevice device, VkShaderEXT shader,
+                                size_t *pDataSize, void *pData);
+
+VkResult GetRefreshCycleDurationGOOGLE(
+    VkDevice device, VkSwapchainKHR swapchain,
+    VkRefreshCycleDurationGOOGLE *pDisplayTimingProperties);
+VkResult GetPastPresentationTimingGOOGLE(
+    VkDevice device, VkSwapchainKHR swapchain,
+    uint32_t *pPresentationTimingCount,
+    VkPastPresentationTimingGOOGLE *pPresentationTimings);
+
 void CmdBindShadersEXT(VkCommandBuffer commandBuffer, uint32_t stageCount,
                        const VkShaderStageFlagBits *pStages,
                        const VkShaderEXT *pShaders);
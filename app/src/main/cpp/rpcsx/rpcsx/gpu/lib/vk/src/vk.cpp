@@ -354,9 +354,13 @@ void vk::Context::createDevice(VkSurfaceKHR surface, int gpuIndex,
 
   physicalDevice = getVkPhyDevice(gpuIndex);
 
+  shaderObjectProps = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_PROPERTIES_EXT};
+
   descriptorBufferProps = {
       .sType =
-          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT,
+      .pNext = &shaderObjectProps};
 
   VkPhysicalDeviceProperties2 deviceProperties{
       .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
@@ -594,11 +598,15 @@ void vk::Context::createDevice(VkSurfaceKHR surface, int gpuIndex,
   VK_VERIFY(
       vkCreateDevice(physicalDevice, &deviceCreateInfo, allocator, &device));
 
+  // Queues of the graphics family left after the present and graphics ones,
+  // used for compute when there is no dedicated compute family
+  std::vector<std::pair<VkQueue, unsigned>> spareComputeQueues;
+
   for (auto &queueInfo : requestedQueues) {
     if (queueFamiliesWithGraphicsSupport.contains(queueInfo.queueFamilyIndex) &&
         graphicsQueues.empty()) {
-      for (uint32_t queueIndex = 0; queueIndex < queueInfo.queueCount;
-           ++queueIndex) {
+      uint32_t queueIndex = 0;
+      for (; queueIndex < queueInfo.queueCount; ++queueIndex) {
         if (presentQueue == VK_NULL_HANDLE &&
             queueFamiliesWithPresentSupport.contains(
                 queueInfo.queueFamilyIndex)) {
@@ -613,9 +621,20 @@ void vk::Context::createDevice(VkSurfaceKHR surface, int gpuIndex,
         index = queueInfo.queueFamilyIndex;
         vkGetDeviceQueue(device, queueInfo.queueFamilyIndex, queueIndex,
                          &queue);
+        ++queueIndex;
         break;
       }
 
+      if (queueFamiliesWithComputeSupport.contains(
+              queueInfo.queueFamilyIndex)) {
+        for (; queueIndex < queueInfo.queueCount; ++queueIndex) {
+          auto &[queue, index] = spareComputeQueues.emplace_back();
+          index = queueInfo.queueFamilyIndex;
+          vkGetDeviceQueue(device, queueInfo.queueFamilyIndex, queueIndex,
+                           &queue);
+        }
+      }
+
       continue;
     }
 
@@ -637,6 +656,10 @@ void vk::Context::createDevice(VkSurfaceKHR surface, int gpuIndex,
     }
   }
 
+  if (computeQueues.empty()) {
+    computeQueues = std::move(spareComputeQueues);
+  }
+
   rx::dieIf(presentQueue == VK_NULL_HANDLE, "present queue not found");
 
   if (graphicsQueues.empty()) {
@@ -814,6 +837,33 @@ void vk::DestroyShaderEXT(VkDevice device, VkShaderEXT shader,
   fn(device, shader, pAllocator);
 }
 
+VkResult vk::GetShaderBinaryDataEXT(VkDevice device, VkShaderEXT shader,
+                                    size_t *pDataSize, void *pData) {
+  static auto fn = (PFN_vkGetShaderBinaryDataEXT)importDeviceVkProc(
+      context->device, "vkGetShaderBinaryDataEXT");
+
+  return fn(device, shader, pDataSize, pData);
+}
+
+VkResult vk::GetRefreshCycleDurationGOOGLE(
+    VkDevice device, VkSwapchainKHR swapchain,
+    VkRefreshCycleDurationGOOGLE *pDisplayTimingProperties) {
+  static auto fn = (PFN_vkGetRefreshCycleDurationGOOGLE)importDeviceVkProc(
+      context->device, "vkGetRefreshCycleDurationGOOGLE");
+
+  return fn(device, swapchain, pDisplayTimingProperties);
+}
+
+VkResult vk::GetPastPresentationTimingGOOGLE(
+    VkDevice device, VkSwapchainKHR swapchain,
+    uint32_t *pPresentationTimingCount,
+    VkPastPresentationTimingGOOGLE *pPresentationTimings) {
+  static auto fn = (PFN_vkGetPastPresentationTimingGOOGLE)importDeviceVkProc(
+      context->device, "vkGetPastPresentationTimingGOOGLE");
+
+  return fn(device, swapchain, pPresentationTimingCount, pPresentationTimings);
+}
+
 void vk::CmdBindShadersEXT(VkCommandBuffer commandBuffer, uint32_t stageCount,
                            const VkShaderStageFlagBits *pStages,
                            const VkShaderEXT *pShaders) {
@@ -734,19 +734,178 @@ orbis::ErrorCode createSocket(rx::Ref<orbis::File> *file, orbis::kstring name,
   return {};
 }
 
-static std::optional<std::string>
-findFileInDir(const std::filesystem::path &dir, const char *name) {
-  for (auto entry : std::filesystem::directory_iterator(dir)) {
-    auto entryName = entry.path().filename();
-    if (strcasecmp(entryName.c_str(), name) == 0) {
-      return entryName;
+static constexpr std::size_t kMaxDirSnapshots = 4096;
+
+static orbis::kstring getDirCacheKey(std::string_view path) {
+  orbis::kstring result;
+  result.reserve(path.size());
+
+  for (char c : path) {
+    if (c == '/' && result.ends_with('/')) {
+      continue;
+    }
+
+    result += c;
+  }
+
+  while (result.size() > 1 && result.ends_with('/')) {
+    result.pop_back();
+  }
+
+  return result;
+}
+
+static std::string_view getParentPath(std::string_view path) {
+  auto pos = path.rfind('/');
+  if (pos == std::string_view::npos) {
+    return {};
+  }
+
+  return path.substr(0, pos == 0 ? 1 : pos);
+}
+
+static void enumerateHostDir(int hostFd, std::string_view realPath,
+                             orbis::kvector<orbis::Dirent> &dirEntries) {
+  alignas(dirent64) char hostEntryBuffer[16 * 1024];
+
+  while (true) {
+    auto r = getdents64(hostFd, hostEntryBuffer, sizeof(hostEntryBuffer));
+    if (r <= 0)
+      break;
+
+    std::size_t offset = 0;
+
+    while (offset < r) {
+      ::dirent64 *entryPtr =
+          reinterpret_cast<dirent64 *>(hostEntryBuffer + offset);
+      offset += entryPtr->d_reclen;
+
+      if (entryPtr->d_name == std::string_view("..") ||
+          entryPtr->d_name == std::string_view(".") ||
+          entryPtr->d_name == std::string_view(".rpcsx")) {
+        continue;
+      }
+
+      auto type = entryPtr->d_type;
+
+      if (type == DT_UNKNOWN) {
+        // some FUSE backed storages do not report the type
+        struct ::stat entryStat;
+        if (::fstatat(hostFd, entryPtr->d_name, &entryStat, 0) == 0) {
+          type = S_ISDIR(entryStat.st_mode) ? DT_DIR : DT_REG;
+        }
+      }
+
+      if (type != DT_REG && type != DT_DIR && type != DT_LNK) {
+        ORBIS_LOG_ERROR("host_open: unknown directory entry d_type",
+                        std::string(realPath).c_str(), entryPtr->d_name, type);
+        continue;
+      }
+
+      std::string_view entryName = entryPtr->d_name;
+
+      auto &entry = dirEntries.emplace_back();
+      entry.fileno = dirEntries.size(); // TODO
+      entry.reclen = sizeof(entry);
+      entry.namlen = std::min(entryName.size(), sizeof(entry.name) - 1);
+      std::strncpy(entry.name, entryPtr->d_name, sizeof(entry.name) - 1);
+      entry.name[sizeof(entry.name) - 1] = '\0';
+      entry.type = type == DT_REG ? orbis::kDtReg
+                                  : orbis::kDtDir; // Assume symlinks to be dirs
+    }
+  }
+}
+
+bool HostFsDevice::readDirEntries(int hostFd, std::string_view realPath,
+                                  orbis::kvector<orbis::Dirent> &result) {
+  struct ::stat hostStat;
+  if (::fstat(hostFd, &hostStat) != 0 || !S_ISDIR(hostStat.st_mode)) {
+    return false;
+  }
+
+  auto isSameDir = [&](const DirSnapshot &snapshot) {
+    return snapshot.dev == hostStat.st_dev && snapshot.ino == hostStat.st_ino &&
+           snapshot.mtimeSec == hostStat.st_mtim.tv_sec &&
+           snapshot.mtimeNsec == hostStat.st_mtim.tv_nsec;
+  };
+
+  auto key = getDirCacheKey(realPath);
+
+  {
+    rx::reader_lock lock(dirCacheMtx);
+    if (auto it = dirCache.find(key);
+        it != dirCache.end() && isSameDir(it->second)) {
+      result = it->second.entries;
+      return true;
+    }
+  }
+
+  // enumerate without the lock, concurrent readers of other directories are
+  // not blocked by the host
+  DirSnapshot snapshot;
+  snapshot.dev = hostStat.st_dev;
+  snapshot.ino = hostStat.st_ino;
+  snapshot.mtimeSec = hostStat.st_mtim.tv_sec;
+  snapshot.mtimeNsec = hostStat.st_mtim.tv_nsec;
+  enumerateHostDir(hostFd, realPath, snapshot.entries);
+  result = snapshot.entries;
+
+  std::lock_guard lock(dirCacheMtx);
+  if (dirCache.size() >= kMaxDirSnapshots) {
+    dirCache.clear();
+  }
+
+  dirCache.insert_or_assign(std::move(key), std::move(snapshot));
+  return true;
+}
+
+void HostFsDevice::invalidateDirEntries(std::string_view realPath,
+                                        bool recursive) {
+  auto key = getDirCacheKey(realPath);
+
+  std::lock_guard lock(dirCacheMtx);
+  if (auto parent = getParentPath(key); !parent.empty()) {
+    if (auto it = dirCache.find(parent); it != dirCache.end()) {
+      dirCache.erase(it);
+    }
+  }
+
+  if (!recursive) {
+    return;
+  }
+
+  for (auto it = dirCache.lower_bound(key);
+       it != dirCache.end() && it->first.starts_with(key);) {
+    if (it->first.size() == key.size() || it->first[key.size()] == '/') {
+      it = dirCache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+static std::optional<std::string> findFileInDir(HostFsDevice *device,
+                                                const std::filesystem::path &dir,
+                                                const char *name) {
+  int dirFd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dirFd < 0) {
+    return {};
+  }
+
+  orbis::kvector<orbis::Dirent> entries;
+  device->readDirEntries(dirFd, dir.native(), entries);
+  ::close(dirFd);
+
+  for (auto &entry : entries) {
+    if (strcasecmp(entry.name, name) == 0) {
+      return std::string(entry.name, entry.namlen);
     }
   }
   return {};
 }
 
 static std::optional<std::filesystem::path>
-toRealPath(const std::filesystem::path &inp) {
+toRealPath(HostFsDevice *device, const std::filesystem::path &inp) {
   if (inp.empty()) {
     return {};
   }
@@ -758,7 +917,7 @@ toRealPath(const std::filesystem::path &inp) {
       continue;
     }
 
-    auto icaseElem = findFileInDir(result, elem.c_str());
+    auto icaseElem = findFileInDir(device, result, elem.c_str());
     if (!icaseElem) {
       return {};
     }
@@ -822,12 +981,13 @@ orbis::ErrorCode HostFsDevice::open(rx::Ref<orbis::File> *file,
   }
 
   int hostFd = ::open(realPath.c_str(), realFlags, 0777);
+  orbis::kstring openedPath = realPath;
 
   orbis::ErrorCode error{};
   if (hostFd < 0) {
     error = convertErrno();
 
-    if (auto icaseRealPath = toRealPath(realPath)) {
+    if (auto icaseRealPath = toRealPath(this, realPath)) {
       ORBIS_LOG_WARNING(__FUNCTION__, path, realPath.c_str(),
                         icaseRealPath->c_str());
       hostFd = ::open(icaseRealPath->c_str(), realFlags, 0777);
@@ -837,6 +997,8 @@ orbis::ErrorCode HostFsDevice::open(rx::Ref<orbis::File> *file,
                         icaseRealPath->c_str(), error);
         return convertErrno();
       }
+
+      openedPath = icaseRealPath->c_str();
     }
   }
   if (hostFd < 0) {
@@ -844,48 +1006,13 @@ orbis::ErrorCode HostFsDevice::open(rx::Ref<orbis::File> *file,
     return error;
   }
 
-  // Assume the file is a directory and try to read direntries
-  orbis::kvector<orbis::Dirent> dirEntries;
-  char hostEntryBuffer[sizeof(dirent64) * 4];
-  while (true) {
-    auto r = getdents64(hostFd, hostEntryBuffer, sizeof(hostEntryBuffer));
-    if (r <= 0)
-      break;
-
-    std::size_t offset = 0;
-
-    while (offset < r) {
-      ::dirent64 *entryPtr =
-          reinterpret_cast<dirent64 *>(hostEntryBuffer + offset);
-      offset += entryPtr->d_reclen;
-
-      if (entryPtr->d_name == std::string_view("..") ||
-          entryPtr->d_name == std::string_view(".") ||
-          entryPtr->d_name == std::string_view(".rpcsx")) {
-        continue;
-      }
-
-      // auto entryPath = (std::filesystem::path(virtualPath) / path /
-      // entryPtr->d_name).lexically_normal().string();
-      std::string entryPath = entryPtr->d_name;
-
-      auto &entry = dirEntries.emplace_back();
-      entry.fileno = dirEntries.size(); // TODO
-      entry.reclen = sizeof(entry);
-      entry.namlen = entryPath.length();
-      std::strncpy(entry.name, entryPath.c_str(), sizeof(entry.name));
-      if (entryPtr->d_type == DT_REG)
-        entry.type = orbis::kDtReg;
-      else if (entryPtr->d_type == DT_DIR || entryPtr->d_type == DT_LNK)
-        entry.type = orbis::kDtDir; // Assume symlinks to be dirs
-      else {
-        ORBIS_LOG_ERROR("host_open: unknown directory entry d_type",
-                        realPath.c_str(), entryPtr->d_name, entryPtr->d_type);
-        dirEntries.pop_back();
-      }
-    }
+  if ((realFlags & (O_CREAT | O_TRUNC)) != 0) {
+    invalidateDirEntries(openedPath, false);
   }
 
+  orbis::kvector<orbis::Dirent> dirEntries;
+  readDirEntries(hostFd, openedPath, dirEntries);
+
   auto newFile = orbis::knew<HostFile>();
   newFile->hostFd = hostFd;
   newFile->dirEntries = std::move(dirEntries);
@@ -898,13 +1025,15 @@ orbis::ErrorCode HostFsDevice::open(rx::Ref<orbis::File> *file,
 orbis::ErrorCode HostFsDevice::unlink(const char *path, bool recursive,
                                       orbis::Thread *thread) {
   std::error_code ec;
+  auto realPath = hostPath + "/" + path;
 
   if (recursive) {
-    std::filesystem::remove_all(hostPath + "/" + path, ec);
+    std::filesystem::remove_all(realPath, ec);
   } else {
-    std::filesystem::remove(hostPath + "/" + path, ec);
+    std::filesystem::remove(realPath, ec);
   }
 
+  invalidateDirEntries(realPath, true);
   return convertErrorCode(ec);
 }
 
@@ -915,24 +1044,39 @@ orbis::ErrorCode HostFsDevice::createSymlink(const char *linkPath,
   std::filesystem::create_symlink(
       std::filesystem::absolute(hostPath + "/" + linkPath),
       hostPath + "/" + target, ec);
+  invalidateDirEntries(hostPath + "/" + target, false);
   return convertErrorCode(ec);
 }
 
 orbis::ErrorCode HostFsDevice::mkdir(const char *path, int mode,
                                      orbis::Thread *thread) {
   std::error_code ec;
-  std::filesystem::create_directories(hostPath + "/" + path, ec);
+  auto realPath = hostPath + "/" + path;
+  std::filesystem::create_directories(realPath, ec);
+
+  // create_directories might create the parents as well
+  for (std::string_view dir = realPath; dir.size() > hostPath.size();
+       dir = getParentPath(dir)) {
+    invalidateDirEntries(dir, false);
+  }
+
   return convertErrorCode(ec);
 }
 orbis::ErrorCode HostFsDevice::rmdir(const char *path, orbis::Thread *thread) {
   std::error_code ec;
-  std::filesystem::remove_all(hostPath + "/" + path, ec);
+  auto realPath = hostPath + "/" + path;
+  std::filesystem::remove_all(realPath, ec);
+  invalidateDirEntries(realPath, true);
   return convertErrorCode(ec);
 }
 orbis::ErrorCode HostFsDevice::rename(const char *from, const char *to,
                                       orbis::Thread *thread) {
   std::error_code ec;
-  std::filesystem::rename(hostPath + "/" + from, hostPath + "/" + to, ec);
+  auto realFrom = hostPath + "/" + from;
+  auto realTo = hostPath + "/" + to;
+  std::filesystem::rename(realFrom, realTo, ec);
+  invalidateDirEntries(realFrom, true);
+  invalidateDirEntries(realTo, true);
   return convertErrorCode(ec);
 }
 
@@ -4,13 +4,29 @@
 #include "orbis/KernelAllocator.hpp"
 #include "orbis/file.hpp"
 #include "rx/Rc.hpp"
+#include "rx/SharedMutex.hpp"
 #include <cstdint>
+#include <string_view>
 #include <system_error>
 
 struct HostFsDevice : orbis::IoDevice {
   orbis::kstring hostPath;
   orbis::kstring virtualPath;
 
+  // Entries of host directories in guest layout, keyed by normalized host
+  // path. A snapshot is reused while the directory keeps its inode and mtime
+  // and is dropped by guest writes through this device
+  struct DirSnapshot {
+    std::uint64_t dev = 0;
+    std::uint64_t ino = 0;
+    std::int64_t mtimeSec = 0;
+    std::int64_t mtimeNsec = 0;
+    orbis::kvector<orbis::Dirent> entries;
+  };
+
+  rx::shared_mutex dirCacheMtx;
+  orbis::kmap<orbis::kstring, DirSnapshot> dirCache;
+
   HostFsDevice(orbis::kstring path, orbis::kstring virtualPath)
       : hostPath(std::move(path)), virtualPath(std::move(virtualPath)) {}
   orbis::ErrorCode open(rx::Ref<orbis::File> *file, const char *path,
@@ -25,6 +41,11 @@ struct HostFsDevice : orbis::IoDevice {
   orbis::ErrorCode rmdir(const char *path, orbis::Thread *thread) override;
   orbis::ErrorCode rename(const char *from, const char *to,
                           orbis::Thread *thread) override;
+
+  // Returns false if hostFd is not a directory
+  bool readDirEntries(int hostFd, std::string_view realPath,
+                      orbis::kvector<orbis::Dirent> &result);
+  void invalidateDirEntries(std::string_view realPath, bool recursive);
 };
 
 orbis::ErrorCode convertErrorCode(const std::error_code &code);
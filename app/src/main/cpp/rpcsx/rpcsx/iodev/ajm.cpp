@@ -6,10 +6,16 @@
 #include "orbis/file.hpp"
 #include "orbis/thread/Thread.hpp"
 #include "orbis/utils/Logs.hpp"
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <mutex>
 #include <rx/atScopeExit.hpp>
 #include <rx/hexdump.hpp>
+#include <thread>
+#include <vector>
 
 extern "C" {
 #include <libatrac9/decoder.h>
@@ -57,6 +63,7 @@ struct AjmDevice
     : orbis::IoDeviceWithIoctl<orbis::ioctl::group(AJM_IOCTL_FINALIZE)> {
   rx::shared_mutex mtx;
   orbis::uint32_t batchId = 1; // temp
+  orbis::uint32_t completedBatchId = 0;
 
   orbis::uint32_t instanceIds[AJM_CODEC_COUNT]{};
   orbis::uint32_t unimplementedInstanceId = 0;
@@ -310,17 +317,10 @@ struct AjmIoctlStartBatchBuffer {
   orbis::uint64_t batchError;
   orbis::uint32_t batchId;
 };
-static orbis::ErrorCode
-ajm_ioctl_start_batch_buffer(orbis::Thread *, AjmDevice *device,
-                             AjmIoctlStartBatchBuffer &args) {
-  args.result = 0;
-  args.batchId = device->batchId++;
-  // ORBIS_LOG_ERROR(__FUNCTION__, args.result, args.unk0, args.pBatch,
-  //                 args.batchSize, args.priority, args.batchError, args.batchId);
-  // thread->where();
 
-  auto ptr = args.pBatch;
-  auto endPtr = args.pBatch + args.batchSize;
+static orbis::ErrorCode ajm_run_batch(AjmDevice *device, std::byte *ptr,
+                                      std::byte *endPtr) {
+  std::lock_guard lock(device->mtx);
 
   while (ptr < endPtr) {
     auto header = (InstructionHeader *)ptr;
@@ -824,6 +824,113 @@ ajm_ioctl_start_batch_buffer(orbis::Thread *, AjmDevice *device,
   return {};
 }
 
+namespace {
+struct AjmBatch {
+  AjmDevice *device;
+  orbis::uint32_t id;
+  std::vector<std::byte> data;
+};
+
+// Decodes batches off the ioctl thread, in submission order. Instances keep
+// host codec state, so the worker lives in the process that submits batches
+struct AjmBatchWorker {
+  std::mutex mtx;
+  std::condition_variable queueCv;
+  std::condition_variable doneCv;
+  std::deque<AjmBatch> queue;
+  std::thread thread;
+  bool exit = false;
+
+  ~AjmBatchWorker() {
+    {
+      std::lock_guard lock(mtx);
+      exit = true;
+    }
+
+    queueCv.notify_one();
+
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+  orbis::uint32_t push(AjmDevice *device, std::vector<std::byte> data) {
+    std::lock_guard lock(mtx);
+
+    if (!thread.joinable()) {
+      thread = std::thread([this] { entry(); });
+    }
+
+    auto id = device->batchId++;
+    queue.push_back({device, id, std::move(data)});
+    queueCv.notify_one();
+    return id;
+  }
+
+  // timeout is in microseconds, ~0 waits until the batch is done
+  bool wait(AjmDevice *device, orbis::uint32_t id, orbis::uint32_t timeout) {
+    std::unique_lock lock(mtx);
+    auto isDone = [&] { return device->completedBatchId >= id; };
+
+    if (timeout == ~orbis::uint32_t(0)) {
+      doneCv.wait(lock, isDone);
+      return true;
+    }
+
+    return doneCv.wait_for(lock, std::chrono::microseconds(timeout), isDone);
+  }
+
+private:
+  void entry() {
+    std::unique_lock lock(mtx);
+
+    while (true) {
+      queueCv.wait(lock, [this] { return exit || !queue.empty(); });
+
+      if (queue.empty()) {
+        break;
+      }
+
+      auto batch = std::move(queue.front());
+      queue.pop_front();
+      lock.unlock();
+
+      if (auto errc = ajm_run_batch(batch.device, batch.data.data(),
+                                    batch.data.data() + batch.data.size());
+          errc != orbis::ErrorCode{}) {
+        ORBIS_LOG_ERROR("ajm: batch failed", batch.id, errc);
+      }
+
+      lock.lock();
+      batch.device->completedBatchId = batch.id;
+      doneCv.notify_all();
+    }
+  }
+};
+
+AjmBatchWorker &getBatchWorker() {
+  static AjmBatchWorker worker;
+  return worker;
+}
+} // namespace
+
+static orbis::ErrorCode
+ajm_ioctl_start_batch_buffer(orbis::Thread *, AjmDevice *device,
+                             AjmIoctlStartBatchBuffer &args) {
+  args.result = 0;
+  // ORBIS_LOG_ERROR(__FUNCTION__, args.result, args.unk0, args.pBatch,
+  //                 args.batchSize, args.priority, args.batchError, args.batchId);
+  // thread->where();
+
+  // the batch buffer can be reused by the guest as soon as it is submitted,
+  // input and output buffers stay valid until the batch is waited for
+  std::vector<std::byte> data(args.batchSize);
+  ORBIS_RET_ON_ERROR(orbis::ureadRaw(data.data(), args.pBatch, data.size()));
+
+  args.batchId = getBatchWorker().push(device, std::move(data));
+  return {};
+}
+
 struct AjmIoctlWaitBatchBuffer {
   orbis::uint32_t result;
   orbis::uint32_t unk0;
@@ -839,6 +946,11 @@ ajm_ioctl_wait_batch_buffer(orbis::Thread *thread, AjmDevice *device,
   // ORBIS_LOG_ERROR(__FUNCTION__, request, args.result, args.unk0,
   //                 args.batchId, args.timeout, args.batchError);
   // thread->where();
+
+  if (!getBatchWorker().wait(device, args.batchId, args.timeout)) {
+    return orbis::ErrorCode::BUSY;
+  }
+
   return {};
 }
 
@@ -11,6 +11,7 @@
 #include "rx/format.hpp"
 #include "rx/watchdog.hpp"
 #include "vm.hpp"
+#include <bit>
 #include <fcntl.h>
 #include <filesystem>
 #include <mutex>
@@ -146,6 +147,7 @@ static orbis::ErrorCode dmem_ioctl(orbis::File *file, std::uint64_t request,
 
     device->allocations.map(args->address, args->address + args->size,
                             {.memoryType = -1u});
+    device->markFree(args->address, args->address + args->size);
     return {};
   }
 
@@ -259,12 +261,130 @@ static const orbis::FileOps ops = {
     .mmap = dmem_mmap,
 };
 
+static int getFreeClass(std::uint64_t size) { return std::bit_width(size) - 1; }
+
+void DmemDevice::markFree(std::uint64_t begin, std::uint64_t end) {
+  end = std::min<std::uint64_t>(end, dmemTotalSize);
+  if (begin >= end) {
+    return;
+  }
+
+  auto eraseRange = [this](auto it) {
+    auto freeClass = getFreeClass(it->second - it->first);
+    auto &bucket = freeRangesByClass[freeClass];
+    bucket.erase(it->first);
+    if (bucket.empty()) {
+      freeClassMask &= ~(1ull << freeClass);
+    }
+    return freeRanges.erase(it);
+  };
+
+  // Merge with overlapping and adjacent free ranges
+  auto it = freeRanges.upper_bound(begin);
+  if (it != freeRanges.begin()) {
+    auto prev = std::prev(it);
+    if (prev->second >= begin) {
+      begin = prev->first;
+      end = std::max(end, prev->second);
+      it = eraseRange(prev);
+    }
+  }
+
+  while (it != freeRanges.end() && it->first <= end) {
+    end = std::max(end, it->second);
+    it = eraseRange(it);
+  }
+
+  auto freeClass = getFreeClass(end - begin);
+  freeRanges.emplace(begin, end);
+  freeRangesByClass[freeClass].emplace(begin, end);
+  freeClassMask |= 1ull << freeClass;
+}
+
+void DmemDevice::markAllocated(std::uint64_t begin, std::uint64_t end) {
+  if (begin >= end) {
+    return;
+  }
+
+  auto it = freeRanges.upper_bound(begin);
+  if (it != freeRanges.begin() && std::prev(it)->second > begin) {
+    --it;
+  }
+
+  while (it != freeRanges.end() && it->first < end) {
+    auto [rangeBegin, rangeEnd] = *it;
+
+    auto freeClass = getFreeClass(rangeEnd - rangeBegin);
+    auto &bucket = freeRangesByClass[freeClass];
+    bucket.erase(rangeBegin);
+    if (bucket.empty()) {
+      freeClassMask &= ~(1ull << freeClass);
+    }
+    it = freeRanges.erase(it);
+
+    if (rangeBegin < begin) {
+      markFree(rangeBegin, begin);
+    }
+
+    if (rangeEnd > end) {
+      markFree(end, rangeEnd);
+      break;
+    }
+  }
+}
+
+// Lowest aligned offset in [searchStart, searchEnd) that starts a free area of
+// len bytes, or ~0 if there is none. Ranges of a size class that covers
+// len + alignment always fit, so only the classes below that are scanned past
+// their first entry.
+std::uint64_t DmemDevice::findFree(std::uint64_t searchStart,
+                                   std::uint64_t searchEnd, std::uint64_t len,
+                                   std::uint64_t alignment) {
+  auto fits = [&](std::uint64_t begin, std::uint64_t end) -> std::uint64_t {
+    auto offset = rx::alignUp(std::max(begin, searchStart), alignment);
+    if (offset < begin || offset >= searchEnd || offset + len > end ||
+        offset + len < offset) {
+      return ~0ull;
+    }
+    return offset;
+  };
+
+  // The range containing searchStart is the lowest possible candidate
+  if (auto it = freeRanges.upper_bound(searchStart);
+      it != freeRanges.begin()) {
+    auto prev = std::prev(it);
+    if (prev->second > searchStart) {
+      if (auto offset = fits(prev->first, prev->second); offset != ~0ull) {
+        return offset;
+      }
+    }
+  }
+
+  std::uint64_t result = ~0ull;
+  auto mask = freeClassMask & (~0ull << getFreeClass(len));
+
+  while (mask != 0) {
+    auto freeClass = std::countr_zero(mask);
+    mask &= mask - 1;
+
+    auto &bucket = freeRangesByClass[freeClass];
+    for (auto it = bucket.lower_bound(searchStart);
+         it != bucket.end() && it->first < std::min(result, searchEnd); ++it) {
+      if (auto offset = fits(it->first, it->second); offset != ~0ull) {
+        result = offset;
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
 orbis::ErrorCode DmemDevice::allocate(std::uint64_t *start,
                                       std::uint64_t searchEnd,
                                       std::uint64_t len,
                                       std::uint64_t alignment,
                                       std::uint32_t memoryType) {
-  std::size_t offset = *start;
   if (alignment == 0) {
     alignment = 1;
   }
@@ -272,54 +392,32 @@ orbis::ErrorCode DmemDevice::allocate(std::uint64_t *start,
     searchEnd = dmemTotalSize;
   }
 
-  while (offset < searchEnd) {
-    offset += alignment - 1;
-    offset &= ~(alignment - 1);
-
-    if (offset + len > dmemTotalSize) {
-      ORBIS_LOG_ERROR("dmem: failed to allocate direct memory: out of memory",
-                      *start, searchEnd, len, alignment, memoryType, offset);
-      return orbis::ErrorCode::AGAIN;
-    }
+  if (len == 0) {
+    return orbis::ErrorCode::INVAL;
+  }
 
-    auto it = allocations.lowerBound(offset);
-
-    if (it != allocations.end()) {
-      if (it->memoryType == -1u) {
-        if (offset < it.beginAddress()) {
-          offset = it.beginAddress() + alignment - 1;
-          offset &= ~(alignment - 1);
-        }
-
-        if (offset + len >= it.endAddress()) {
-          offset = it.endAddress();
-          continue;
-        }
-      } else {
-        if (offset + len > it.beginAddress()) {
-          offset = it.endAddress();
-          continue;
-        }
-      }
-    }
+  auto offset = findFree(*start, searchEnd, len, alignment);
 
-    allocations.map(offset, offset + len,
-                    {
-                        .memoryType = memoryType,
-                    });
-    ORBIS_LOG_WARNING("dmem: allocated direct memory", *start, searchEnd, len,
-                      alignment, memoryType, offset);
-    *start = offset;
-    return {};
+  if (offset == ~0ull) {
+    ORBIS_LOG_ERROR("dmem: failed to allocate direct memory", *start,
+                    searchEnd, len, alignment, memoryType);
+    return orbis::ErrorCode::AGAIN;
   }
 
-  ORBIS_LOG_ERROR("dmem: failed to allocate direct memory", *start, searchEnd,
-                  len, alignment, memoryType, offset);
-  return orbis::ErrorCode::AGAIN;
+  allocations.map(offset, offset + len,
+                  {
+                      .memoryType = memoryType,
+                  });
+  markAllocated(offset, offset + len);
+  ORBIS_LOG_WARNING("dmem: allocated direct memory", *start, searchEnd, len,
+                    alignment, memoryType, offset);
+  *start = offset;
+  return {};
 }
 
 orbis::ErrorCode DmemDevice::release(std::uint64_t start, std::uint64_t size) {
   allocations.unmap(start, start + size);
+  markFree(start, start + size);
   return {};
 }
 
@@ -327,49 +425,50 @@ orbis::ErrorCode DmemDevice::queryMaxFreeChunkSize(std::uint64_t *start,
                                                    std::uint64_t searchEnd,
                                                    std::uint64_t alignment,
                                                    std::uint64_t *size) {
-  std::size_t offset = *start;
   std::size_t resultSize = 0;
   std::size_t resultOffset = 0;
 
   alignment = std::max(alignment, vm::kPageSize);
   alignment = rx::alignUp(alignment, vm::kPageSize);
 
-  while (offset < searchEnd) {
-    offset += alignment - 1;
-    offset &= ~(alignment - 1);
+  auto searchStart = *start;
+  auto check = [&](std::uint64_t begin, std::uint64_t end) {
+    auto offset = rx::alignUp(std::max(begin, searchStart), alignment);
+    if (offset >= searchEnd || offset >= end) {
+      return;
+    }
 
-    if (offset >= dmemTotalSize) {
-      break;
+    if (resultSize < end - offset ||
+        (resultSize == end - offset && offset < resultOffset)) {
+      resultSize = end - offset;
+      resultOffset = offset;
     }
+  };
 
-    auto it = allocations.lowerBound(offset);
+  if (auto it = freeRanges.upper_bound(searchStart);
+      it != freeRanges.begin()) {
+    auto prev = std::prev(it);
+    if (prev->second > searchStart) {
+      check(prev->first, prev->second);
+    }
+  }
 
-    if (it == allocations.end()) {
-      if (resultSize < dmemTotalSize - offset) {
-        resultSize = dmemTotalSize - offset;
-        resultOffset = offset;
-      }
+  // Walk the size classes from the largest, a class cannot beat a chunk that
+  // is at least as large as the biggest range it can hold
+  auto mask = freeClassMask;
+  while (mask != 0) {
+    auto freeClass = 63 - std::countl_zero(mask);
+    mask &= ~(1ull << freeClass);
 
+    if (freeClass < 63 && resultSize >= (2ull << freeClass)) {
       break;
     }
 
-    if (it->memoryType == -1u) {
-      if (offset < it.beginAddress()) {
-        offset = it.beginAddress() + alignment - 1;
-        offset &= ~(alignment - 1);
-      }
-
-      if (it.endAddress() > offset && resultSize < it.endAddress() - offset) {
-        resultSize = it.endAddress() - offset;
-        resultOffset = offset;
-      }
-    } else if (offset > it.beginAddress() &&
-               resultSize < offset - it.beginAddress()) {
-      resultSize = offset - it.beginAddress();
-      resultOffset = offset;
+    auto &bucket = freeRangesByClass[freeClass];
+    for (auto it = bucket.lower_bound(searchStart);
+         it != bucket.end() && it->first < searchEnd; ++it) {
+      check(it->first, it->second);
     }
-
-    offset = it.endAddress();
   }
 
   resultSize /= 0x20;
@@ -399,6 +498,7 @@ orbis::IoDevice *createDmemCharacterDevice(int index) {
   auto *newDevice = orbis::knew<DmemDevice>();
   newDevice->index = index;
   newDevice->dmemTotalSize = dmemSize;
+  newDevice->markFree(0, dmemSize);
 
   auto path = rx::format("{}/dmem-{}", rx::getShmPath(), index);
   auto shmFd = ::open(path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
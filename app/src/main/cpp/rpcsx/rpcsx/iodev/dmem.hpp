@@ -27,6 +27,21 @@ struct DmemDevice : public orbis::IoDevice {
 
   rx::MemoryTableWithPayload<AllocationInfo, orbis::kallocator> allocations;
 
+  // Unallocated parts of the direct memory, kept next to `allocations` so
+  // allocate/query do not have to walk every allocated area. Ranges are
+  // stored by address and again in a bucket per size class
+  // (floor(log2(size))); freeClassMask has a bit set for every non-empty
+  // bucket.
+  static constexpr int kFreeClassCount = 64;
+  orbis::kmap<std::uint64_t, std::uint64_t> freeRanges;
+  orbis::kmap<std::uint64_t, std::uint64_t> freeRangesByClass[kFreeClassCount];
+  std::uint64_t freeClassMask = 0;
+
+  void markFree(std::uint64_t begin, std::uint64_t end);
+  void markAllocated(std::uint64_t begin, std::uint64_t end);
+  std::uint64_t findFree(std::uint64_t searchStart, std::uint64_t searchEnd,
+                         std::uint64_t len, std::uint64_t alignment);
+
   orbis::ErrorCode allocate(std::uint64_t *start, std::uint64_t searchEnd,
                             std::uint64_t len, std::uint64_t alignment,
                             std::uint32_t memoryType);
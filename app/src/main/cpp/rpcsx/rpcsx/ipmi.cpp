@@ -220,8 +220,9 @@ ipmi::IpmiServer::handle(orbis::IpmiSession *session,
     }
   }
 
-  for (auto out : outData) {
-    response.data.push_back({out.data(), out.data() + out.size()});
+  response.data.reserve(outData.size());
+  for (auto &out : outData) {
+    response.data.emplace_back(out.data(), out.size());
   }
 
   std::lock_guard clientLock(session->client->mutex);
@@ -286,8 +287,9 @@ ipmi::IpmiServer::handle(orbis::IpmiSession *session,
   }
 
   response.callerTid = packet.clientTid;
-  for (auto out : outData) {
-    response.data.push_back({out.data(), out.data() + out.size()});
+  response.data.reserve(outData.size());
+  for (auto &out : outData) {
+    response.data.emplace_back(out.data(), out.size());
   }
 
   std::lock_guard lock(session->mutex);
@@ -341,9 +343,8 @@ ipmi::IpmiServer &ipmi::createIpmiServer(orbis::Process *process,
           conReq.client->session = session;
 
           for (auto &message : server->messages) {
-            conReq.client->messageQueues[0].messages.push_back(
-                orbis::kvector<std::byte>(message.data(),
-                                          message.data() + message.size()));
+            conReq.client->messageQueues[0].messages.emplace_back(
+                message.data(), message.size());
           }
 
           conReq.client->connectionStatus = 0;
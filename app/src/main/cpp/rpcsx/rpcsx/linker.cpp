@@ -879,6 +879,8 @@ rx::Ref<orbis::Module> rx::linker::loadModule(std::span<std::byte> image,
 
         result->symbols.push_back(symbol);
       }
+
+      result->buildExportIndex();
     }
   }
 
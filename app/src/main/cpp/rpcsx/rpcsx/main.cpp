@@ -55,12 +55,21 @@ extern bool allowMonoDebug;
 
 __attribute__((no_stack_protector)) static void
 handle_signal(int sig, siginfo_t *info, void *ucontext) {
+  auto entryFs = _readfsbase_u64();
   if (auto hostFs = _readgsbase_u64()) {
     _writefsbase_u64(hostFs);
   }
 
   auto signalAddress = reinterpret_cast<std::uintptr_t>(info->si_addr);
 
+  // Any thread may touch a range whose protection grant is still deferred
+  if (sig == SIGSEGV && signalAddress >= orbis::kMinAddress &&
+      signalAddress < orbis::kMaxAddress &&
+      vm::applyPendingProtection(signalAddress)) {
+    _writefsbase_u64(entryFs);
+    return;
+  }
+
   if (orbis::g_currentThread != nullptr &&
       orbis::g_currentThread->tproc->vmId >= 0 && sig == SIGSEGV &&
       signalAddress >= orbis::kMinAddress &&
@@ -767,6 +776,16 @@ static void usage(const char *argv0) {
   std::println(
       "    --gpu <index> - specify physical gpu index to use, default is 0");
   std::println("    --disable-cache - disable cache of gpu resources");
+  std::println("    --disable-host-import - copy guest buffers instead of "
+               "importing guest memory into the gpu");
+  std::println("    --disable-cpu-tiler - detile small images with compute "
+               "shaders only");
+  std::println("    --shader-cache <path> - keep converted shaders in the "
+               "specified directory between launches");
+  std::println("    --frame-pacing <off|low-latency|smooth> - schedule "
+               "presents against the display refresh, default is off");
+  std::println("    --low-prio-cpus <count> - run guest threads below the "
+               "default priority on the first <count> host cpus only");
   // std::println("    --presenter <window>");
   std::println("    --trace");
 }
@@ -908,6 +927,7 @@ int main(int argc, const char *argv[]) {
   bool asRoot = false;
   bool isSystem = false;
   bool isSafeMode = false;
+  unsigned lowPrioCpuCount = 0;
 
   int argIndex = 1;
   orbis::initializeAllocator();
@@ -999,6 +1019,64 @@ int main(int argc, const char *argv[]) {
       continue;
     }
 
+    if (argv[argIndex] == std::string_view("--disable-host-import")) {
+      argIndex++;
+      rx::g_config.disableGpuHostImport = true;
+      continue;
+    }
+
+    if (argv[argIndex] == std::string_view("--disable-cpu-tiler")) {
+      argIndex++;
+      rx::g_config.disableCpuTiler = true;
+      continue;
+    }
+
+    if (argv[argIndex] == std::string_view("--shader-cache")) {
+      if (argc <= argIndex + 1) {
+        usage(argv[0]);
+        return 1;
+      }
+
+      rx::g_config.shaderCachePath = argv[argIndex + 1];
+      argIndex += 2;
+      continue;
+    }
+
+    if (argv[argIndex] == std::string_view("--frame-pacing")) {
+      if (argc <= argIndex + 1) {
+        usage(argv[0]);
+        return 1;
+      }
+
+      std::string_view mode = argv[argIndex + 1];
+
+      if (mode == "off") {
+        rx::g_config.framePacing = rx::FramePacing::Off;
+      } else if (mode == "low-latency") {
+        rx::g_config.framePacing = rx::FramePacing::LowLatency;
+      } else if (mode == "smooth") {
+        rx::g_config.framePacing = rx::FramePacing::Smooth;
+      } else {
+        usage(argv[0]);
+        return 1;
+      }
+
+      argIndex += 2;
+      continue;
+    }
+
+    if (argv[argIndex] == std::string_view("--low-prio-cpus")) {
+      if (argc <= argIndex + 1) {
+        usage(argv[0]);
+        return 1;
+      }
+
+      lowPrioCpuCount = std::atoi(argv[argIndex + 1]);
+
+      argIndex += 2;
+      continue;
+    }
+
     if (argv[argIndex] == std::string_view("--debug-gpu")) {
       argIndex++;
       rx::g_config.debugGpu = true;
@@ -1029,6 +1107,7 @@ int main(int argc, const char *argv[]) {
   setupSigHandlers();
   orbis::constructAllGlobals();
   orbis::g_context->deviceEventEmitter = orbis::knew<orbis::EventEmitter>();
+  orbis::g_context->lowPrioCpuCount = lowPrioCpuCount;
 
   rx::startWatchdog();
   rx::createGpuDevice();
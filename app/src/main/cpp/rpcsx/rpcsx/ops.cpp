@@ -412,13 +412,13 @@ orbis::SysResult dynlib_get_obj_member(orbis::Thread *thread,
 }
 
 ptr<char> findSymbolById(orbis::Module *module, std::uint64_t id) {
-  for (auto sym : module->symbols) {
-    if (sym.id == id && sym.bind != orbis::SymbolBind::Local) {
-      return sym.address != 0 ? (ptr<char>)module->base + sym.address : 0;
-    }
+  auto exports = module->findExports(id);
+  if (exports.empty()) {
+    return nullptr;
   }
 
-  return nullptr;
+  auto &sym = module->symbols[exports.front().second];
+  return sym.address != 0 ? (ptr<char>)module->base + sym.address : 0;
 }
 
 orbis::SysResult dynlib_dlsym(orbis::Thread *thread, orbis::ModuleHandle handle,
@@ -565,6 +565,9 @@ SysResult thr_new(orbis::Thread *thread, orbis::ptr<thr_param> param,
     rtprio _rtp;
     ORBIS_RET_ON_ERROR(uread(_rtp, _param.rtp));
     ORBIS_LOG_NOTICE("  rtp: ", _rtp.type, _rtp.prio);
+    childThread->prio = _rtp;
+  } else {
+    childThread->prio = thread->prio;
   }
   childThread->handle =
       std::thread{[=, childThread = rx::Ref<Thread>(childThread)] {
@@ -584,6 +587,7 @@ SysResult thr_new(orbis::Thread *thread, orbis::ptr<thr_param> param,
         childThread->hostTid = ::gettid();
         childThread->context = context;
         childThread->state = orbis::ThreadState::RUNNING;
+        childThread->updateHostPriority();
 
         rx::thread::setupSignalStack();
         rx::thread::setupThisThread();
@@ -11,6 +11,8 @@
 #include "rx/format.hpp"
 #include "rx/print.hpp"
 #include "rx/watchdog.hpp"
+#include <algorithm>
+#include <atomic>
 #include <bit>
 #include <cassert>
 #include <cstdint>
@@ -463,6 +465,37 @@ struct Block {
     }
   }
 
+  // True if none of the pages has a CPU access that prot lacks and none is
+  // visible to the GPU (its cache watches pages with its own protection)
+  bool isCpuOnlyGrant(std::uint64_t firstPage, std::uint64_t pagesCount,
+                      std::uint32_t prot) const {
+    if (prot & (kGpuReadable | kGpuWritable)) {
+      return false;
+    }
+
+    std::uint64_t forbidden = 0;
+    while (pagesCount > 0) {
+      auto pageInGroup = firstPage & kGroupMask;
+      auto count = std::min(kGroupSize - pageInGroup, pagesCount);
+      auto mask = makePagesMask(pageInGroup, count);
+      auto &group = groups[firstPage / kGroupSize];
+
+      forbidden |= (prot & kReadable) ? 0 : group.readable & mask;
+      forbidden |= (prot & kWritable) ? 0 : group.writable & mask;
+      forbidden |= (prot & kExecutable) ? 0 : group.executable & mask;
+      forbidden |= (group.gpuReadable | group.gpuWritable) & mask;
+
+      if (forbidden != 0) {
+        return false;
+      }
+
+      firstPage += count;
+      pagesCount -= count;
+    }
+
+    return true;
+  }
+
   bool isFreePages(std::uint64_t page, std::uint64_t count) {
     auto groupIndex = page / kGroupSize;
 
@@ -648,6 +681,115 @@ struct Block {
 
 static Block gBlocks[kBlockCount];
 
+// Protection grants (no page loses CPU access, no GPU visible pages) are not
+// applied right away: runs of them with the same protection merge and reach
+// the host as one mprotect. Removals, map, unmap and fork flush them first,
+// and a fault on a pending range applies it (vm::applyPendingProtection).
+// Removals are never deferred, so a pending entry cannot hide a fault the
+// guest relies on.
+//
+// Entries are written under g_mtx, the fault handler reads them through the
+// sequence counter without taking it
+struct PendingProtection {
+  std::atomic<std::uint32_t> seq{0}; // odd while being written
+  std::atomic<std::uint64_t> begin{0};
+  std::atomic<std::uint64_t> end{0};
+  std::atomic<std::int32_t> prot{0};
+
+  void set(std::uint64_t newBegin, std::uint64_t newEnd, std::int32_t newProt) {
+    auto value = seq.load(std::memory_order::relaxed);
+    seq.store(value + 1, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::release);
+    begin.store(newBegin, std::memory_order::relaxed);
+    end.store(newEnd, std::memory_order::relaxed);
+    prot.store(newProt, std::memory_order::relaxed);
+    seq.store(value + 2, std::memory_order::release);
+  }
+};
+
+static constexpr std::size_t kMaxPendingProtections = 32;
+static PendingProtection gPendingProtections[kMaxPendingProtections];
+static std::size_t gPendingProtectionCount = 0;
+
+static void flushPendingProtections() {
+  for (std::size_t i = 0; i < gPendingProtectionCount; ++i) {
+    auto &entry = gPendingProtections[i];
+    auto begin = entry.begin.load(std::memory_order::relaxed);
+    auto end = entry.end.load(std::memory_order::relaxed);
+    auto prot = entry.prot.load(std::memory_order::relaxed);
+
+    if (::mprotect(std::bit_cast<void *>(begin), end - begin, prot) != 0) {
+      std::println(stderr, "Memory error: deferred protect {:x}-{:x} failed",
+                   begin, end);
+    }
+
+    entry.set(0, 0, 0);
+  }
+
+  gPendingProtectionCount = 0;
+}
+
+static void addPendingProtection(std::uint64_t begin, std::uint64_t end,
+                                 std::int32_t prot) {
+  for (std::size_t i = 0; i < gPendingProtectionCount; ++i) {
+    auto &entry = gPendingProtections[i];
+    auto entryBegin = entry.begin.load(std::memory_order::relaxed);
+    auto entryEnd = entry.end.load(std::memory_order::relaxed);
+
+    if (begin > entryEnd || end < entryBegin) {
+      continue;
+    }
+
+    if (entry.prot.load(std::memory_order::relaxed) == prot) {
+      entry.set(std::min(begin, entryBegin), std::max(end, entryEnd), prot);
+      return;
+    }
+
+    if (begin < entryEnd && end > entryBegin) {
+      // Overlaps a different protection, order matters
+      flushPendingProtections();
+      break;
+    }
+  }
+
+  if (gPendingProtectionCount == kMaxPendingProtections) {
+    flushPendingProtections();
+  }
+
+  gPendingProtections[gPendingProtectionCount++].set(begin, end, prot);
+}
+
+bool vm::applyPendingProtection(std::uint64_t address) {
+  for (auto &entry : gPendingProtections) {
+    while (true) {
+      auto seq = entry.seq.load(std::memory_order::acquire);
+      if (seq & 1) {
+        // Another thread holds g_mtx and is done soon
+        continue;
+      }
+
+      auto begin = entry.begin.load(std::memory_order::relaxed);
+      auto end = entry.end.load(std::memory_order::relaxed);
+      auto prot = entry.prot.load(std::memory_order::relaxed);
+      std::atomic_thread_fence(std::memory_order::acquire);
+
+      if (entry.seq.load(std::memory_order::relaxed) != seq) {
+        continue;
+      }
+
+      if (address >= begin && address < end) {
+        // Applying a grant early is harmless, the flush repeats it
+        return ::mprotect(std::bit_cast<void *>(begin), end - begin, prot) ==
+               0;
+      }
+
+      break;
+    }
+  }
+
+  return false;
+}
+
 struct MapInfo {
   rx::Ref<orbis::IoDevice> device;
   std::uint64_t offset;
@@ -657,7 +799,7 @@ struct MapInfo {
   bool operator==(const MapInfo &) const = default;
 };
 
-static rx::MemoryTableWithPayload<MapInfo> gMapInfo;
+static rx::PageIndexedMemoryTable<MapInfo> gMapInfo;
 
 static void reserve(std::uint64_t startAddress, std::uint64_t endAddress) {
   auto blockIndex = startAddress >> kBlockShift;
@@ -681,6 +823,8 @@ void vm::fork(std::uint64_t pid) {
   (void)g_mtx.try_lock();
   g_mtx.unlock(); // release mutex
 
+  flushPendingProtections();
+
   if (gMemoryShm == -1) {
     rx::println(stderr, "Memory: failed to open {}", shmPath);
     std::abort();
@@ -723,6 +867,11 @@ void vm::fork(std::uint64_t pid) {
 void vm::reset() {
   std::memset(gBlocks, 0, sizeof(gBlocks));
 
+  for (std::size_t i = 0; i < gPendingProtectionCount; ++i) {
+    gPendingProtections[i].set(0, 0, 0);
+  }
+  gPendingProtectionCount = 0;
+
   rx::mem::unmap(reinterpret_cast<void *>(kMinAddress),
                  kMaxAddress - kMinAddress);
   if (::ftruncate64(gMemoryShm, 0) < 0) {
@@ -814,6 +963,9 @@ void *vm::map(void *addr, std::uint64_t len, std::int32_t prot,
 
   std::lock_guard lock(g_mtx);
 
+  // A deferred grant must not land on whatever gets mapped here
+  flushPendingProtections();
+
   std::uint64_t address = 0;
   if ((flags & kMapFlagFixed) == kMapFlagFixed) {
     address = hitAddress;
@@ -981,17 +1133,15 @@ void *vm::map(void *addr, std::uint64_t len, std::int32_t prot,
     return reinterpret_cast<void *>(address);
   }
 
+  // Anonymous memory is mapped writable right away for the clear, that saves
+  // a protect round trip
   auto result = rx::mem::map(reinterpret_cast<void *>(address), len,
-                             prot & kMapProtCpuAll, realFlags, gMemoryShm,
-                             address - kMinAddress);
+                             (prot & kMapProtCpuAll) | (isAnon ? PROT_WRITE : 0),
+                             realFlags, gMemoryShm, address - kMinAddress);
 
   if (result != MAP_FAILED && isAnon) {
-    bool needReprotect = (prot & PROT_WRITE) == 0;
-    if (needReprotect) {
-      ::mprotect(result, len, PROT_WRITE);
-    }
     std::memset(result, 0, len);
-    if (needReprotect) {
+    if ((prot & PROT_WRITE) == 0) {
       ::mprotect(result, len, prot & kMapProtCpuAll);
     }
   }
@@ -1024,6 +1174,7 @@ bool vm::unmap(void *addr, std::uint64_t size) {
   }
 
   std::lock_guard lock(g_mtx);
+  flushPendingProtections();
   gBlocks[(address >> kBlockShift) - kFirstBlock].removeFlags(
       (address & kBlockMask) >> kPageShift, pages, ~0);
   if (auto thr = orbis::g_currentThread) {
@@ -1066,9 +1217,14 @@ bool vm::protect(void *addr, std::uint64_t size, std::int32_t prot) {
 
   std::lock_guard lock(g_mtx);
 
-  gBlocks[(address >> kBlockShift) - kFirstBlock].setFlags(
-      (address & kBlockMask) >> kPageShift, pages,
-      kAllocated | (prot & (kMapProtCpuAll | kMapProtGpuAll)), false);
+  auto &block = gBlocks[(address >> kBlockShift) - kFirstBlock];
+  auto firstPage = (address & kBlockMask) >> kPageShift;
+  bool isGrant = block.isCpuOnlyGrant(
+      firstPage, pages, prot & (kMapProtCpuAll | kMapProtGpuAll));
+
+  block.setFlags(firstPage, pages,
+                 kAllocated | (prot & (kMapProtCpuAll | kMapProtGpuAll)),
+                 false);
 
   if (auto thr = orbis::g_currentThread) {
     std::println("memory prot: {:x}", prot);
@@ -1078,6 +1234,13 @@ bool vm::protect(void *addr, std::uint64_t size, std::int32_t prot) {
   } else if (prot >> 4) {
     std::println(stderr, "ignoring mapping {:x}-{:x}", address, address + size);
   }
+
+  if (isGrant) {
+    addPendingProtection(address, endAddress, prot & kMapProtCpuAll);
+    return true;
+  }
+
+  flushPendingProtections();
   return ::mprotect(std::bit_cast<void *>(address), size,
                     prot & kMapProtCpuAll) == 0;
 }
@@ -81,4 +81,8 @@ bool virtualQuery(const void *addr, std::int32_t flags, VirtualQueryInfo *info);
 bool queryProtection(const void *addr, std::uint64_t *startAddress,
                      std::uint64_t *endAddress, std::int32_t *prot);
 unsigned getPageProtection(std::uint64_t address);
+
+// Fault handler: applies a deferred protection grant covering the address,
+// false if there is none
+bool applyPendingProtection(std::uint64_t address);
 } // namespace vm
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace rx {
+// Read sections for lookups that take no lock. A reader publishes the epoch it
+// entered in, a writer that unlinked an object from a shared structure calls
+// epoch_synchronize() before it drops its reference: that returns once every
+// section that could still hold the old pointer has left.
+//
+// Sections must be short and never block (a load and a reference increment),
+// writers spin for them.
+class epoch_read_guard {
+public:
+  epoch_read_guard();
+  ~epoch_read_guard();
+
+  epoch_read_guard(const epoch_read_guard &) = delete;
+  epoch_read_guard &operator=(const epoch_read_guard &) = delete;
+};
+
+void epoch_synchronize();
+} // namespace rx
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "BitSet.hpp"
+#include "Epoch.hpp"
 #include "Rc.hpp"
 #include "SharedMutex.hpp"
 #include "FunctionRef.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <bit>
 #include <cstddef>
 #include <cstdint>
@@ -20,15 +22,17 @@ class RcIdMap {
   static constexpr auto ChunkCount =
       (MaxId - MinId + ChunkSize - 1) / ChunkSize;
 
+  // mask is only used by writers under the mutex, objects are also read by
+  // get() without it
   struct IdMapChunk {
     BitSet<ChunkSize> mask = {};
-    T *objects[ChunkSize]{};
+    std::atomic<T *> objects[ChunkSize]{};
 
     ~IdMapChunk() {
       std::size_t index = mask.countr_zero();
 
       while (index < ChunkSize) {
-        objects[index]->decRef();
+        get(index)->decRef();
         index = mask.countr_zero(index + 1);
       }
     }
@@ -39,24 +43,28 @@ class RcIdMap {
       }
 
       mask.set(index);
-      objects[index] = object;
+      objects[index].store(object, std::memory_order::release);
       return true;
     }
 
     std::size_t insert(T *object) {
       std::size_t index = mask.countr_one();
       mask.set(index);
-      objects[index] = object;
+      objects[index].store(object, std::memory_order::release);
 
       return index;
     }
 
-    T *get(std::size_t index) const { return objects[index]; }
+    T *get(std::size_t index) const {
+      return objects[index].load(std::memory_order::relaxed);
+    }
 
-    void remove(std::size_t index) {
-      objects[index]->decRef();
-      objects[index] = nullptr;
+    // The map reference is dropped by the caller after epoch_synchronize()
+    T *remove(std::size_t index) {
+      T *object = get(index);
+      objects[index].store(nullptr, std::memory_order::relaxed);
       mask.clear(index);
+      return object;
     }
   };
 
@@ -86,7 +94,7 @@ public:
 
     std::pair<IdT, T *> operator*() const {
       return {static_cast<IdT>(chunk * ChunkSize + index + MinId),
-              chunks[chunk].objects[index]};
+              chunks[chunk].get(index)};
     }
 
     bool operator!=(const end_iterator &) const { return chunk < ChunkCount; }
@@ -115,7 +123,7 @@ public:
 
       while (index < ChunkSize) {
         cb(static_cast<IdT>(index + chunk * ChunkSize + MinId),
-           m_chunks[chunk].objects[index]);
+           m_chunks[chunk].get(index));
 
         index = m_chunks[chunk].mask.countr_zero(index + 1);
       }
@@ -213,6 +221,8 @@ public:
     return true;
   }
 
+  // Takes no lock: an acquire load of the slot, the reference is taken inside
+  // an epoch section so a concurrent close cannot release the object first
   rx::Ref<T> get(IdT id) const {
     const auto rawId = static_cast<std::size_t>(id) - MinId;
 
@@ -223,13 +233,9 @@ public:
     const auto chunk = rawId / ChunkSize;
     const auto index = rawId % ChunkSize;
 
-    std::lock_guard lock(mutex);
-
-    if (!m_chunks[chunk].mask.test(index)) {
-      return nullptr;
-    }
-
-    return m_chunks[chunk].get(index);
+    epoch_read_guard guard;
+    return rx::Ref<T>(
+        m_chunks[chunk].objects[index].load(std::memory_order::acquire));
   }
 
   bool destroy(IdT id)
@@ -244,15 +250,20 @@ public:
     const auto chunk = rawId / ChunkSize;
     const auto index = rawId % ChunkSize;
 
-    std::lock_guard lock(mutex);
+    T *object;
+    {
+      std::lock_guard lock(mutex);
 
-    if (!m_chunks[chunk].mask.test(index)) {
-      return false;
+      if (!m_chunks[chunk].mask.test(index)) {
+        return false;
+      }
+
+      m_chunks[chunk].get(index)->destroy();
+      object = m_chunks[chunk].remove(index);
+      m_fullChunks.clear(chunk);
     }
 
-    m_chunks[chunk].get(index)->destroy();
-    m_chunks[chunk].remove(index);
-    m_fullChunks.clear(chunk);
+    release(object);
     return true;
   }
 
@@ -266,16 +277,28 @@ public:
     const auto chunk = rawId / ChunkSize;
     const auto index = rawId % ChunkSize;
 
-    std::lock_guard lock(mutex);
+    T *object;
+    {
+      std::lock_guard lock(mutex);
 
-    if (!m_chunks[chunk].mask.test(index)) {
-      return false;
+      if (!m_chunks[chunk].mask.test(index)) {
+        return false;
+      }
+
+      object = m_chunks[chunk].remove(index);
+      m_fullChunks.clear(chunk);
     }
 
-    m_chunks[chunk].remove(index);
-    m_fullChunks.clear(chunk);
+    release(object);
     return true;
   }
+
+private:
+  static void release(T *object) {
+    // get() may have loaded the slot just before it was cleared
+    epoch_synchronize();
+    object->decRef();
+  }
 };
 
 template <typename T, typename IdT = int, std::size_t MaxId = 4096,
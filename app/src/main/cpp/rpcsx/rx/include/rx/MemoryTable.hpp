@@ -2,6 +2,7 @@
 
 #include "rx/AddressRange.hpp"
 #include "rx/Rc.hpp"
+#include <array>
 #include <bit>
 #include <cassert>
 #include <concepts>
@@ -455,13 +456,167 @@ public:
   }
 };
 
+// Granule of the page index, independent from the host page size
+inline constexpr unsigned kPageIndexShift = 12;
+
+struct NoPageIndex {
+  template <typename T> const T *find(std::uint64_t) const { return nullptr; }
+  template <typename T> void insert(std::uint64_t, const T &) {}
+  void invalidate(std::uint64_t, std::uint64_t) {}
+  void clear() {}
+};
+
+// Three level radix table from page number to the area covering the whole
+// page. Nodes are allocated on first insert, so only looked up regions cost
+// memory. Covers 48-bit addresses, lookups above that always miss.
+template <typename ValueT> class PageRadixIndex {
+  static constexpr unsigned kLeafBits = 9;
+  static constexpr unsigned kMidBits = 13;
+  static constexpr unsigned kTopBits =
+      48 - kPageIndexShift - kMidBits - kLeafBits;
+  static constexpr std::uint64_t kLeafSize = 1ull << kLeafBits;
+  static constexpr std::uint64_t kMidSize = 1ull << (kLeafBits + kMidBits);
+  static constexpr std::uint64_t kPageCount = 1ull << (48 - kPageIndexShift);
+
+  struct Entry {
+    ValueT value{};
+    bool valid = false;
+  };
+
+  struct Leaf {
+    std::array<Entry, kLeafSize> entries;
+    std::uint32_t count = 0;
+  };
+
+  struct Mid {
+    std::array<std::unique_ptr<Leaf>, 1ull << kMidBits> leaves;
+    std::uint32_t count = 0;
+  };
+
+  std::unique_ptr<std::unique_ptr<Mid>[]> mTop;
+
+  static std::size_t getMidIndex(std::uint64_t page) {
+    return (page >> kLeafBits) & ((1ull << kMidBits) - 1);
+  }
+
+public:
+  template <typename T = ValueT> const T *find(std::uint64_t page) const {
+    if (!mTop || page >= kPageCount) {
+      return nullptr;
+    }
+
+    auto &mid = mTop[page >> (kLeafBits + kMidBits)];
+    if (!mid) {
+      return nullptr;
+    }
+
+    auto &leaf = mid->leaves[getMidIndex(page)];
+    if (!leaf) {
+      return nullptr;
+    }
+
+    auto &entry = leaf->entries[page & (kLeafSize - 1)];
+    return entry.valid ? &entry.value : nullptr;
+  }
+
+  void insert(std::uint64_t page, const ValueT &value) {
+    if (page >= kPageCount) {
+      return;
+    }
+
+    if (!mTop) {
+      mTop = std::make_unique<std::unique_ptr<Mid>[]>(1ull << kTopBits);
+    }
+
+    auto &mid = mTop[page >> (kLeafBits + kMidBits)];
+    if (!mid) {
+      mid = std::make_unique<Mid>();
+    }
+
+    auto &leaf = mid->leaves[getMidIndex(page)];
+    if (!leaf) {
+      leaf = std::make_unique<Leaf>();
+      mid->count++;
+    }
+
+    auto &entry = leaf->entries[page & (kLeafSize - 1)];
+    if (!entry.valid) {
+      entry.valid = true;
+      leaf->count++;
+    }
+
+    entry.value = value;
+  }
+
+  // Drop pages [firstPage, lastPage], skipping unpopulated nodes
+  void invalidate(std::uint64_t firstPage, std::uint64_t lastPage) {
+    if (!mTop || firstPage >= kPageCount) {
+      return;
+    }
+
+    lastPage = std::min(lastPage, kPageCount - 1);
+
+    for (auto page = firstPage; page <= lastPage;) {
+      auto &mid = mTop[page >> (kLeafBits + kMidBits)];
+      if (!mid) {
+        page = (page | (kMidSize - 1)) + 1;
+        continue;
+      }
+
+      auto &leaf = mid->leaves[getMidIndex(page)];
+      auto leafLast = page | (kLeafSize - 1);
+
+      if (leaf) {
+        if ((page & (kLeafSize - 1)) == 0 && lastPage >= leafLast) {
+          leaf.reset();
+        } else {
+          for (auto p = page, end = std::min(lastPage, leafLast); p <= end;
+               ++p) {
+            auto &entry = leaf->entries[p & (kLeafSize - 1)];
+            if (entry.valid) {
+              entry.valid = false;
+              leaf->count--;
+            }
+          }
+
+          if (leaf->count == 0) {
+            leaf.reset();
+          }
+        }
+
+        if (!leaf && --mid->count == 0) {
+          mid.reset();
+        }
+      }
+
+      page = leafLast + 1;
+    }
+  }
+
+  void clear() { mTop.reset(); }
+};
+
 template <typename PayloadT,
-          template <typename> typename Allocator = std::allocator>
+          template <typename> typename Allocator = std::allocator,
+          bool PageIndexed = false>
 class MemoryTableWithPayload {
   using payload_type = Payload<PayloadT>;
-  std::map<std::uint64_t, payload_type, std::less<>,
-           Allocator<std::pair<const std::uint64_t, payload_type>>>
-      mAreas;
+  using map_type =
+      std::map<std::uint64_t, payload_type, std::less<>,
+               Allocator<std::pair<const std::uint64_t, payload_type>>>;
+  map_type mAreas;
+
+  // Point lookup cache for queryArea, the map stays the source of truth
+  std::conditional_t<PageIndexed,
+                     PageRadixIndex<typename map_type::iterator>, NoPageIndex>
+      mPageIndex;
+
+  void invalidatePages(std::uint64_t beginAddress, std::uint64_t endAddress) {
+    if (beginAddress < endAddress) {
+      mPageIndex.invalidate(beginAddress >> kPageIndexShift,
+                            (endAddress - 1) >> kPageIndexShift);
+    }
+  }
 
 public:
   class AreaInfo : public rx::AddressRange {
@@ -521,7 +676,10 @@ public:
   iterator begin() { return iterator(mAreas.begin()); }
   iterator end() { return iterator(mAreas.end()); }
 
-  void clear() { mAreas.clear(); }
+  void clear() {
+    mPageIndex.clear();
+    mAreas.clear();
+  }
 
   iterator lowerBound(std::uint64_t address) {
     auto it = mAreas.lower_bound(address);
@@ -544,6 +702,13 @@ public:
   }
 
   iterator queryArea(std::uint64_t address) {
+    auto page = address >> kPageIndexShift;
+
+    if (auto cached =
+            mPageIndex.template find<typename map_type::iterator>(page)) {
+      return *cached;
+    }
+
     auto it = mAreas.lower_bound(address);
 
     if (it == mAreas.end()) {
@@ -567,7 +732,16 @@ public:
       --it;
     }
 
-    return endAddress < address ? mAreas.end() : it;
+    if (endAddress < address) {
+      return mAreas.end();
+    }
+
+    if (it->first <= (page << kPageIndexShift) &&
+        endAddress >= ((page + 1) << kPageIndexShift)) {
+      mPageIndex.insert(page, it);
+    }
+
+    return it;
   }
 
   iterator map(std::uint64_t beginAddress, std::uint64_t endAddress,
@@ -587,6 +761,14 @@ public:
       return beginIt;
     }
 
+    // Areas up to the first boundary past the end can be split, merged or
+    // erased below
+    if (auto nextIt = mAreas.upper_bound(endAddress); nextIt != mAreas.end()) {
+      invalidatePages(beginAddress, nextIt->first);
+    } else {
+      invalidatePages(beginAddress, endAddress);
+    }
+
     if (!beginInserted || !endInserted) {
       if (!beginInserted) {
         if (beginIt->second.isClose()) {
@@ -672,6 +854,8 @@ public:
     auto closeIt = openIt;
     ++closeIt;
 
+    invalidatePages(openIt->first, closeIt->first);
+
     if (openIt->second.isCloseOpen()) {
       openIt->second = payload_type::createClose();
     } else {
@@ -690,4 +874,8 @@ public:
     unmap(map(beginAddress, endAddress, PayloadT{}, false));
   }
 };
+
+template <typename PayloadT>
+using PageIndexedMemoryTable =
+    MemoryTableWithPayload<PayloadT, std::allocator, true>;
 } // namespace rx
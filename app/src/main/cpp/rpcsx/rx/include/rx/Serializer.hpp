@@ -162,6 +162,14 @@ struct Serializer {
   virtual ~Serializer() = default;
   virtual void write(std::span<const std::byte> data) = 0;
 
+  // Scatter-gather write, sinks that can take all chunks at once (reserve once
+  // or a single vectored syscall) override it
+  virtual void writev(std::span<const std::span<const std::byte>> chunks) {
+    for (auto chunk : chunks) {
+      write(chunk);
+    }
+  }
+
   template <Serializable T> void serialize(const T &value) {
     if constexpr (requires { value.serialize(*this); }) {
       value.serialize(*this);
@@ -258,13 +266,17 @@ private:
   bool mFailure = false;
 };
 
+// Trivially relocatable objects and arrays go to the sink as one chunk of
+// their own bytes, without a stack copy in between
 template <detail::TriviallyRelocatable T>
   requires std::is_array_v<T>
 struct TypeSerializer<T> {
   static void serialize(Serializer &s, const T &t) {
-    std::byte rawBytes[sizeof(T)];
-    std::memcpy(rawBytes, &t, sizeof(T));
-    s.write(rawBytes);
+    s.write({reinterpret_cast<const std::byte *>(&t), sizeof(T)});
+  }
+
+  static void deserialize(Deserializer &s, T &t) {
+    s.read({reinterpret_cast<std::byte *>(&t), sizeof(T)});
   }
 };
 
@@ -272,16 +284,13 @@ template <detail::TriviallyRelocatable T>
   requires(!std::is_array_v<T>)
 struct TypeSerializer<T> {
   static void serialize(Serializer &s, const T &t) {
-    std::byte rawBytes[sizeof(T)];
-    std::memcpy(rawBytes, &t, sizeof(T));
-    s.write(rawBytes);
+    s.write({reinterpret_cast<const std::byte *>(&t), sizeof(T)});
   }
 
   static T deserialize(Deserializer &s) {
-    alignas(T) std::byte rawBytes[sizeof(T)];
-    s.read(rawBytes);
-
-    return std::move(std::bit_cast<T>(rawBytes));
+    T result;
+    s.read({reinterpret_cast<std::byte *>(&result), sizeof(T)});
+    return result;
   }
 };
 
@@ -327,13 +336,19 @@ struct TypeSerializer<T> {
   using item_type = std::remove_cvref_t<decltype(*std::declval<T>().begin())>;
 
   static void serialize(Serializer &s, const T &t) {
-    s.serialize(static_cast<std::uint32_t>(t.size()));
+    auto size = static_cast<std::uint32_t>(t.size());
 
     if constexpr (detail::TriviallyRelocatable<item_type> &&
                   requires { reinterpret_cast<const std::byte *>(t.data()); }) {
-      s.write({reinterpret_cast<const std::byte *>(t.data()),
-               t.size() * sizeof(item_type)});
+      const std::span<const std::byte> chunks[] = {
+          {reinterpret_cast<const std::byte *>(&size), sizeof(size)},
+          {reinterpret_cast<const std::byte *>(t.data()),
+           t.size() * sizeof(item_type)},
+      };
+      s.writev(chunks);
     } else {
+      s.serialize(size);
+
       for (auto &item : t) {
         s.serialize(item);
       }
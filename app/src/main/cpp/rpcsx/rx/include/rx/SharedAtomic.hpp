@@ -45,6 +45,55 @@ bool spin_wait(auto &&pred, auto &&spinCond) {
   return false;
 }
 
+// Contention counters of adaptive waits since process start
+struct lock_contention_stats {
+  std::uint64_t contended;    // Waits that did not resolve on the first check
+  std::uint64_t spinResolved; // Resolved while spinning
+  std::uint64_t parked;       // Went to the host futex
+  std::uint64_t spinNs;       // Time spent spinning
+};
+
+lock_contention_stats get_lock_contention_stats();
+
+namespace detail {
+// Spin budget in TSC ticks learnt for the word (hashed, shared by collisions)
+std::uint64_t spin_budget(const void *word);
+void spin_feedback(const void *word, std::uint64_t spentTicks, bool resolved);
+
+// Wait until the word may have changed from value (wfe on ARM64 for words
+// with a long enough budget, pause otherwise) and load it again
+std::uint32_t spin_relax(const std::atomic<std::uint32_t> &word,
+                         std::uint32_t value, std::uint64_t budget);
+} // namespace detail
+
+// Spin before parking for about as long as waits on this word took to resolve
+// recently, capped by the cost of a futex sleep and wake. Long holds drive the
+// budget down to a short probe, so their waiters park almost at once.
+// pred is checked against every observed value of the word
+bool adaptive_spin_wait(const std::atomic<std::uint32_t> &word, auto &&pred) {
+  std::uint32_t value = word.load(std::memory_order::acquire);
+  if (pred(value)) {
+    return true;
+  }
+
+  const std::uint64_t budget = detail::spin_budget(&word);
+  const std::uint64_t start = get_tsc();
+  std::uint64_t spent = 0;
+
+  while (spent < budget) {
+    value = detail::spin_relax(word, value, budget);
+    spent = get_tsc() - start;
+
+    if (pred(value)) {
+      detail::spin_feedback(&word, spent, true);
+      return true;
+    }
+  }
+
+  detail::spin_feedback(&word, spent, false);
+  return false;
+}
+
 struct shared_atomic32 : std::atomic<std::uint32_t> {
   using atomic::atomic;
   using atomic::operator=;
@@ -52,8 +101,8 @@ struct shared_atomic32 : std::atomic<std::uint32_t> {
   template <typename Clock, typename Dur>
   std::errc wait(std::uint32_t oldValue,
                  std::chrono::time_point<Clock, Dur> timeout) {
-    if (try_spin_wait(
-            [&] { return load(std::memory_order::acquire) != oldValue; })) {
+    if (adaptive_spin_wait(
+            *this, [&](std::uint32_t value) { return value != oldValue; })) {
       return {};
     }
 
@@ -74,8 +123,8 @@ struct shared_atomic32 : std::atomic<std::uint32_t> {
   }
 
   std::errc wait(std::uint32_t oldValue) {
-    if (try_spin_wait(
-            [&] { return load(std::memory_order::acquire) != oldValue; })) {
+    if (adaptive_spin_wait(
+            *this, [&](std::uint32_t value) { return value != oldValue; })) {
       return {};
     }
 
@@ -85,8 +134,8 @@ struct shared_atomic32 : std::atomic<std::uint32_t> {
   auto wait(auto &fn) -> decltype(fn(std::declval<std::uint32_t &>())) {
     while (true) {
       std::uint32_t lastValue;
-      if (try_spin_wait([&] {
-            lastValue = load(std::memory_order::acquire);
+      if (adaptive_spin_wait(*this, [&](std::uint32_t value) {
+            lastValue = value;
             return fn(lastValue);
           })) {
         return;
@@ -0,0 +1,120 @@
+#include "Epoch.hpp"
+#include "asm.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace rx {
+namespace {
+constexpr std::size_t kReaderSlots = 512;
+
+struct alignas(64) ReaderSlot {
+  std::atomic<std::uint64_t> epoch{0}; // 0 - not in a section
+  std::atomic<bool> used{false};
+};
+
+ReaderSlot g_readerSlots[kReaderSlots];
+std::atomic<std::size_t> g_readerSlotCount{0}; // Slots ever handed out
+std::atomic<std::uint64_t> g_epoch{1};
+
+// Readers beyond kReaderSlots, writers wait for all of them
+std::atomic<std::uint32_t> g_overflowReaders{0};
+
+struct ThreadReader {
+  ReaderSlot *slot = nullptr;
+  bool slotSearched = false;
+  unsigned depth = 0;
+
+  ReaderSlot *getSlot() {
+    if (slotSearched) {
+      return slot;
+    }
+
+    slotSearched = true;
+
+    for (std::size_t i = 0; i < kReaderSlots; ++i) {
+      if (!g_readerSlots[i].used.exchange(true, std::memory_order::acquire)) {
+        slot = &g_readerSlots[i];
+
+        std::size_t count = g_readerSlotCount.load(std::memory_order::relaxed);
+        while (count < i + 1 && !g_readerSlotCount.compare_exchange_weak(
+                                    count, i + 1, std::memory_order::release)) {
+        }
+        break;
+      }
+    }
+
+    return slot;
+  }
+
+  ~ThreadReader() {
+    if (slot != nullptr) {
+      slot->epoch.store(0, std::memory_order::release);
+      slot->used.store(false, std::memory_order::release);
+      // Late sections from other thread_local destructors go to overflow
+      slot = nullptr;
+    }
+  }
+};
+
+thread_local ThreadReader t_reader;
+} // namespace
+
+epoch_read_guard::epoch_read_guard() {
+  if (t_reader.depth++ != 0) {
+    return;
+  }
+
+  if (auto slot = t_reader.getSlot()) {
+    // Acquire pairs with the writer's increment, loads in the section see
+    // everything unlinked before it
+    slot->epoch.store(g_epoch.load(std::memory_order::acquire),
+                      std::memory_order::relaxed);
+  } else {
+    g_overflowReaders.fetch_add(1, std::memory_order::relaxed);
+  }
+
+  // The published epoch must be visible before the section loads anything
+  std::atomic_thread_fence(std::memory_order::seq_cst);
+}
+
+epoch_read_guard::~epoch_read_guard() {
+  if (--t_reader.depth != 0) {
+    return;
+  }
+
+  if (t_reader.slot != nullptr) {
+    t_reader.slot->epoch.store(0, std::memory_order::release);
+  } else {
+    g_overflowReaders.fetch_sub(1, std::memory_order::release);
+  }
+}
+
+void epoch_synchronize() {
+  // Sections entered after this see the unlink, only older ones can hold it
+  const std::uint64_t stamp = g_epoch.fetch_add(1, std::memory_order::seq_cst);
+  std::atomic_thread_fence(std::memory_order::seq_cst);
+
+  const std::size_t count = g_readerSlotCount.load(std::memory_order::acquire);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto &slot = g_readerSlots[i];
+
+    for (std::size_t spin = 0;; ++spin) {
+      const std::uint64_t epoch = slot.epoch.load(std::memory_order::acquire);
+      if (epoch == 0 || epoch > stamp) {
+        break;
+      }
+
+      if (spin < 16) {
+        pause();
+      } else {
+        yield();
+      }
+    }
+  }
+
+  while (g_overflowReaders.load(std::memory_order::acquire) != 0) {
+    yield();
+  }
+}
+} // namespace rx
@@ -1,6 +1,164 @@
 #include "SharedAtomic.hpp"
+#include <algorithm>
+
+#if defined(__linux__) && defined(ARCH_ARM64)
+#include <sys/auxv.h>
+
+#ifndef HWCAP_EVTSTRM
+#define HWCAP_EVTSTRM (1 << 2)
+#endif
+#endif
+
 using namespace rx;
 
+namespace {
+struct ContentionCounters {
+  std::atomic<std::uint64_t> contended{0};
+  std::atomic<std::uint64_t> spinResolved{0};
+  std::atomic<std::uint64_t> parked{0};
+  std::atomic<std::uint64_t> spinTicks{0};
+};
+
+ContentionCounters g_contention;
+
+struct SpinLimits {
+  std::uint64_t ticksPerUs;
+  std::uint64_t min;     // Probe that keeps learning on long-held words
+  std::uint64_t initial; // Words without history
+  std::uint64_t max;     // About what a futex sleep and wake costs
+};
+
+SpinLimits calibrateSpinLimits() {
+#if defined(ARCH_ARM64)
+  // Generic timer, 24 MHz on most SoCs and 1 GHz since ARMv8.6
+  std::uint64_t freq = 0;
+  __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+  std::uint64_t ticksPerUs = freq / 1'000'000;
+#else
+  const auto clockStart = std::chrono::steady_clock::now();
+  const std::uint64_t tscStart = get_tsc();
+  while (std::chrono::steady_clock::now() - clockStart <
+         std::chrono::microseconds(200)) {
+    rx::pause();
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - clockStart);
+  std::uint64_t ticksPerUs =
+      (get_tsc() - tscStart) * 1000 / std::max<std::int64_t>(elapsed.count(), 1);
+#endif
+
+  ticksPerUs = std::max<std::uint64_t>(ticksPerUs, 1);
+  return {
+      .ticksPerUs = ticksPerUs,
+      .min = ticksPerUs,
+      .initial = ticksPerUs * 4,
+      .max = ticksPerUs * 20,
+  };
+}
+
+const SpinLimits &getSpinLimits() {
+  static const SpinLimits limits = calibrateSpinLimits();
+  return limits;
+}
+
+// Budgets by word address; collisions share a budget, which only costs some
+// precision
+struct alignas(64) SpinSlot {
+  std::atomic<std::uint32_t> budget{0}; // 0 - no history
+};
+
+constexpr std::size_t kSpinSlots = 256;
+SpinSlot g_spinSlots[kSpinSlots];
+
+SpinSlot &getSpinSlot(const void *word) {
+  const auto hash = (reinterpret_cast<std::uintptr_t>(word) >> 2) *
+                    std::uint64_t{0x9e3779b97f4a7c15};
+  return g_spinSlots[hash >> 56];
+}
+
+#if defined(__linux__) && defined(ARCH_ARM64)
+// Without the kernel event stream nothing bounds wfe on an idle line
+const bool g_hasEventStream = (getauxval(AT_HWCAP) & HWCAP_EVTSTRM) != 0;
+#endif
+
+void countPark() {
+  g_contention.parked.fetch_add(1, std::memory_order::relaxed);
+}
+} // namespace
+
+lock_contention_stats rx::get_lock_contention_stats() {
+  return {
+      .contended = g_contention.contended.load(std::memory_order::relaxed),
+      .spinResolved =
+          g_contention.spinResolved.load(std::memory_order::relaxed),
+      .parked = g_contention.parked.load(std::memory_order::relaxed),
+      .spinNs = g_contention.spinTicks.load(std::memory_order::relaxed) *
+                1000 / getSpinLimits().ticksPerUs,
+  };
+}
+
+std::uint64_t rx::detail::spin_budget(const void *word) {
+  g_contention.contended.fetch_add(1, std::memory_order::relaxed);
+
+  const std::uint32_t budget =
+      getSpinSlot(word).budget.load(std::memory_order::relaxed);
+  return budget != 0 ? budget : getSpinLimits().initial;
+}
+
+void rx::detail::spin_feedback(const void *word, std::uint64_t spentTicks,
+                               bool resolved) {
+  const auto &limits = getSpinLimits();
+  auto &slot = getSpinSlot(word);
+
+  g_contention.spinTicks.fetch_add(spentTicks, std::memory_order::relaxed);
+  if (resolved) {
+    g_contention.spinResolved.fetch_add(1, std::memory_order::relaxed);
+  }
+
+  // Twice the observed wait leaves headroom for a slightly longer hold, a wait
+  // that ran out pulls the budget down to the probe
+  const std::int64_t target = static_cast<std::int64_t>(
+      resolved ? std::clamp(spentTicks * 2, limits.min, limits.max)
+               : limits.min);
+
+  std::int64_t budget = slot.budget.load(std::memory_order::relaxed);
+  if (budget == 0) {
+    budget = static_cast<std::int64_t>(limits.initial);
+  }
+
+  // Racy update, a lost sample does not matter
+  budget += (target - budget) / 8;
+  slot.budget.store(static_cast<std::uint32_t>(std::max<std::int64_t>(budget, 1)),
+                    std::memory_order::relaxed);
+}
+
+std::uint32_t rx::detail::spin_relax(const std::atomic<std::uint32_t> &word,
+                                     std::uint32_t value,
+                                     std::uint64_t budget) {
+#if defined(__linux__) && defined(ARCH_ARM64)
+  // wfe can sleep past the budget until the next event, only worth it where
+  // waits have been resolving within the spin recently
+  if (g_hasEventStream && budget > getSpinLimits().min * 2) {
+    // The exclusive load arms the monitor, a store to the line ends wfe;
+    // otherwise the event stream wakes it within ~100us
+    std::uint32_t current;
+    __asm__ volatile("ldaxr %w0, [%1]"
+                     : "=&r"(current)
+                     : "r"(&word)
+                     : "memory");
+    if (current != value) {
+      return current;
+    }
+
+    __asm__ volatile("wfe" ::: "memory");
+    return word.load(std::memory_order::acquire);
+  }
+#endif
+
+  rx::pause();
+  return word.load(std::memory_order::acquire);
+}
+
 #ifdef __linux__
 #include <linux/futex.h>
 #include <sys/syscall.h>
@@ -8,6 +166,8 @@ using namespace rx;
 
 std::errc shared_atomic32::wait_impl(std::uint32_t oldValue,
                                      std::chrono::microseconds usec_timeout) {
+  countPark();
+
   auto usec_timeout_count = usec_timeout.count();
 
   struct timespec timeout{};
@@ -85,6 +245,8 @@ extern int __ulock_wake(uint32_t operation, void *addr, uint64_t wake_value);
 
 std::errc shared_atomic32::wait_impl(std::uint32_t oldValue,
                                      std::chrono::microseconds usec_timeout) {
+  countPark();
+
   bool useTimeout = usec_timeout != std::chrono::microseconds::max();
   bool unblock = (!useTimeout || usec_timeout.count() > 1000) &&
                  g_scopedUnblock != nullptr;
@@ -145,6 +307,7 @@ int shared_atomic32::notify_n(int count) const {
 
 std::errc shared_atomic32::wait_impl(std::uint32_t oldValue,
                                      std::chrono::microseconds usec_timeout) {
+  countPark();
 
   bool useTimeout = usec_timeout != std::chrono::microseconds::max();
 
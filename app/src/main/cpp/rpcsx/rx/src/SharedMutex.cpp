@@ -14,18 +14,15 @@ void shared_mutex::impl_lock_shared(unsigned val) {
     return;
   }
 
-  for (int i = 0; i < 10; i++) {
-    if (try_lock_shared()) {
-      return;
-    }
-
-    unsigned old = m_value;
-
-    if (old & c_sig && m_value.compare_exchange_strong(old, old - c_sig + 1)) {
-      return;
-    }
-
-    busy_wait();
+  if (adaptive_spin_wait(m_value, [this](unsigned old) {
+        if (old < c_one - 1) {
+          return m_value.compare_exchange_strong(old, old + 1);
+        }
+
+        return (old & c_sig) != 0 &&
+               m_value.compare_exchange_strong(old, old - c_sig + 1);
+      })) {
+    return;
   }
 
   // Acquire writer lock and downgrade
@@ -67,7 +64,8 @@ std::errc shared_mutex::impl_wait() {
       break;
     }
 
-    auto result = m_value.wait(old);
+    // Callers have spun before queueing, park straight away
+    auto result = m_value.wait(old, std::chrono::microseconds::max());
     if (result == std::errc::interrupted) {
       return result;
     }
@@ -90,19 +88,15 @@ void shared_mutex::impl_lock(unsigned val) {
     return;
   }
 
-  for (int i = 0; i < 10; i++) {
-    busy_wait();
-
-    unsigned old = m_value;
+  if (adaptive_spin_wait(m_value, [this](unsigned old) {
+        if (old == 0) {
+          return m_value.compare_exchange_strong(old, c_one);
+        }
 
-    if (!old && try_lock()) {
-      return;
-    }
-
-    if (old & c_sig &&
-        m_value.compare_exchange_strong(old, old - c_sig + c_one)) {
-      return;
-    }
+        return (old & c_sig) != 0 &&
+               m_value.compare_exchange_strong(old, old - c_sig + c_one);
+      })) {
+    return;
   }
 
   const unsigned old = m_value.fetch_add(c_one);
@@ -128,12 +122,10 @@ void shared_mutex::impl_unlock(unsigned old) {
   }
 }
 void shared_mutex::impl_lock_upgrade() {
-  for (int i = 0; i < 10; i++) {
-    busy_wait();
-
-    if (try_lock_upgrade()) {
-      return;
-    }
+  if (adaptive_spin_wait(m_value, [this](unsigned) {
+        return try_lock_upgrade();
+      })) {
+    return;
   }
 
   // Convert to writer lock
@@ -0,0 +1,40 @@
+#pragma once
+
+// Minimal microbenchmark harness for rpcsx_bench. Every case runs a batch of
+// iterations through its callback; the runner grows the batch until it takes
+// long enough to time, then repeats it and reports the median.
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+struct Case {
+  std::string name;  // group/case, used by --filter
+  std::uint64_t bytesPerIteration = 0; // for MB/s, 0 = not reported
+  std::uint64_t itemsPerIteration = 0; // for items/s, 0 = not reported
+  std::function<void(std::uint64_t iterations)> run;
+};
+
+struct Result {
+  const Case *benchCase;
+  std::uint64_t iterations; // per repetition
+  double medianNs;          // per iteration
+  double minNs;
+  double maxNs;
+};
+
+// Keeps a value alive without letting the compiler reason about it
+template <typename T> inline void doNotOptimize(const T &value) {
+  asm volatile("" : : "m"(value) : "memory");
+}
+
+inline void clobberMemory() { asm volatile("" : : : "memory"); }
+
+void registerSimdCases(std::vector<Case> &cases);
+void registerCryptoCases(std::vector<Case> &cases);
+void registerTilerCases(std::vector<Case> &cases);
+void registerPpuCases(std::vector<Case> &cases);
+void registerPipelineCacheCases(std::vector<Case> &cases);
+} // namespace bench
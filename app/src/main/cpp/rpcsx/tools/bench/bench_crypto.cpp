@@ -0,0 +1,110 @@
+#include "stdafx.h"
+
+#include "bench.hpp"
+
+#include "Crypto/aes.h"
+#include "Crypto/sha1.h"
+#include "Crypto/sha256.h"
+
+#include <array>
+#include <memory>
+
+namespace {
+// Size of a typical SELF/EDAT chunk
+constexpr std::size_t kChunkSize = 64 * 1024;
+
+constexpr std::array<unsigned char, 16> kKey = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+};
+
+struct CryptoState {
+  aes_context encrypt;
+  aes_context decrypt;
+  std::vector<unsigned char> input = std::vector<unsigned char>(kChunkSize);
+  std::vector<unsigned char> output = std::vector<unsigned char>(kChunkSize);
+
+  CryptoState() {
+    aes_setkey_enc(&encrypt, kKey.data(), 128);
+    aes_setkey_dec(&decrypt, kKey.data(), 128);
+
+    for (std::size_t i = 0; i < kChunkSize; ++i) {
+      input[i] = static_cast<unsigned char>(i * 31 + 7);
+    }
+  }
+};
+} // namespace
+
+void bench::registerCryptoCases(std::vector<Case> &cases) {
+  auto state = std::make_shared<CryptoState>();
+
+  cases.push_back({
+      .name = "crypto/aes128_cbc_decrypt_64k",
+      .bytesPerIteration = kChunkSize,
+      .run =
+          [=](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+              unsigned char iv[16]{};
+              aes_crypt_cbc(&state->decrypt, AES_DECRYPT, kChunkSize, iv,
+                            state->input.data(), state->output.data());
+              bench::clobberMemory();
+            }
+          },
+  });
+
+  cases.push_back({
+      .name = "crypto/aes128_cbc_encrypt_64k",
+      .bytesPerIteration = kChunkSize,
+      .run =
+          [=](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+              unsigned char iv[16]{};
+              aes_crypt_cbc(&state->encrypt, AES_ENCRYPT, kChunkSize, iv,
+                            state->input.data(), state->output.data());
+              bench::clobberMemory();
+            }
+          },
+  });
+
+  cases.push_back({
+      .name = "crypto/aes128_ctr_64k",
+      .bytesPerIteration = kChunkSize,
+      .run =
+          [=](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+              unsigned char counter[16]{};
+              unsigned char stream[16]{};
+              std::size_t offset = 0;
+              aes_crypt_ctr(&state->encrypt, kChunkSize, &offset, counter,
+                            stream, state->input.data(), state->output.data());
+              bench::clobberMemory();
+            }
+          },
+  });
+
+  cases.push_back({
+      .name = "crypto/sha1_64k",
+      .bytesPerIteration = kChunkSize,
+      .run =
+          [=](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+              unsigned char digest[20];
+              sha1(state->input.data(), kChunkSize, digest);
+              bench::doNotOptimize(digest);
+            }
+          },
+  });
+
+  cases.push_back({
+      .name = "crypto/sha256_64k",
+      .bytesPerIteration = kChunkSize,
+      .run =
+          [=](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+              unsigned char digest[32];
+              mbedtls_sha256_ret(state->input.data(), kChunkSize, digest, 0);
+              bench::doNotOptimize(digest);
+            }
+          },
+  });
+}
@@ -0,0 +1,96 @@
+#include "bench.hpp"
+
+#include "pipeline_cache.h"
+
+#include <memory>
+#include <thread>
+
+namespace {
+constexpr std::uint32_t kPipelineCount = 2048;
+constexpr std::uint32_t kLookupsPerIteration = 1024;
+constexpr unsigned kConcurrentThreads = 4;
+
+namespace pipeline = rpcsx::pipeline;
+
+pipeline::GraphicsPipelineDesc makeDesc(std::uint32_t index) {
+  pipeline::GraphicsPipelineDesc desc{};
+  desc.vertex_binding_count = 1 + index % 4;
+  desc.vertex_attribute_count = 1 + index % 8;
+  desc.topology = 3; // VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+  desc.cull_mode = index % 3;
+  desc.line_width = 1.0f;
+  desc.depth_test_enable = index % 2;
+  desc.depth_compare_op = 3; // VK_COMPARE_OP_LESS_OR_EQUAL
+  desc.color_attachment_count = 1;
+  desc.blend_enable = index % 5 == 0;
+  desc.color_write_mask = 0xf;
+  desc.sample_count = 1;
+  desc.vertex_shader_hash = 0x9e3779b97f4a7c15ull * (index + 1);
+  desc.fragment_shader_hash = 0xc2b2ae3d27d4eb4full * (index / 4 + 1);
+  desc.render_pass_hash = 0x165667b19e3779f9ull * (index % 16 + 1);
+  return desc;
+}
+
+struct CacheState {
+  std::vector<pipeline::GraphicsPipelineDesc> descs;
+
+  CacheState() {
+    // No device: pipelines are placeholders, only the cache itself is measured
+    pipeline::PipelineCacheConfig config;
+    config.max_cached_pipelines = kPipelineCount * 2;
+    config.compile_threads = 0;
+    config.use_pipeline_library = false;
+    config.enable_precompilation = false;
+    config.persist_to_disk = false;
+    config.record_pipeline_stream = false;
+    pipeline::InitializePipelineCache(nullptr, nullptr, config);
+
+    descs.reserve(kPipelineCount);
+    for (std::uint32_t i = 0; i < kPipelineCount; ++i) {
+      descs.push_back(makeDesc(i));
+      pipeline::GetOrCreateGraphicsPipeline(descs.back());
+    }
+  }
+
+  ~CacheState() { pipeline::ShutdownPipelineCache(); }
+
+  void lookup(std::uint64_t iterations, std::uint32_t seed) const {
+    std::uint32_t index = seed;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      for (std::uint32_t j = 0; j < kLookupsPerIteration; ++j) {
+        // Stride through the set so consecutive lookups hit different shards
+        index = (index + 769) % kPipelineCount;
+        bench::doNotOptimize(pipeline::GetOrCreateGraphicsPipeline(descs[index]));
+      }
+    }
+  }
+};
+} // namespace
+
+void bench::registerPipelineCacheCases(std::vector<Case> &cases) {
+  auto state = std::make_shared<CacheState>();
+
+  cases.push_back({
+      .name = "pipeline_cache/lookup_hit",
+      .itemsPerIteration = kLookupsPerIteration,
+      .run = [=](std::uint64_t iterations) { state->lookup(iterations, 0); },
+  });
+
+  // Draw thread plus compile workers reading at the same time
+  cases.push_back({
+      .name = "pipeline_cache/lookup_hit_4_threads",
+      .itemsPerIteration = kLookupsPerIteration * kConcurrentThreads,
+      .run =
+          [=](std::uint64_t iterations) {
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < kConcurrentThreads; ++t) {
+              threads.emplace_back(
+                  [=] { state->lookup(iterations, t * 101); });
+            }
+
+            for (auto &thread : threads) {
+              thread.join();
+            }
+          },
+  });
+}
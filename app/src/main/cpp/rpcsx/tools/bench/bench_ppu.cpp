@@ -0,0 +1,153 @@
+#include "bench.hpp"
+
+#include "nce_core/ppu_interpreter.h"
+#include "nce_v8/tiered_jit.h"
+
+#include <cstring>
+#include <memory>
+#include <sys/mman.h>
+
+namespace {
+constexpr std::uint64_t kLoopAddress = 0x10000;
+constexpr std::size_t kMemorySize = 1 << 20;
+constexpr std::size_t kCodeCacheSize = 16 << 20;
+
+// Instructions interpreted per iteration
+constexpr std::uint64_t kInterpretedSteps = 4096;
+
+// r3 += r4, r6 = r3 ^ r4, r4++, 0x7fff times, then start over
+constexpr std::uint32_t kLoop[] = {
+    0x38600000, // li r3, 0
+    0x38800001, // li r4, 1
+    0x38a07fff, // li r5, 0x7fff
+    0x7ca903a6, // mtctr r5
+    0x7c632214, // add r3, r3, r4
+    0x7c662278, // xor r6, r3, r4
+    0x38840001, // addi r4, r4, 1
+    0x4200fff4, // bdnz -12
+    0x4bffffe0, // b -32
+};
+
+constexpr std::size_t kLoopSize = sizeof(kLoop);
+
+// Guest code is big endian in memory
+std::vector<std::uint8_t> makeGuestCode() {
+  std::vector<std::uint8_t> code(kLoopSize);
+  for (std::size_t i = 0; i < std::size(kLoop); ++i) {
+    const std::uint32_t be = __builtin_bswap32(kLoop[i]);
+    std::memcpy(code.data() + i * 4, &be, 4);
+  }
+  return code;
+}
+
+struct InterpreterState {
+  std::vector<std::uint8_t> memory = std::vector<std::uint8_t>(kMemorySize);
+  rpcsx::ppu::PPUInterpreter interpreter;
+  rpcsx::ppu::PPUState state{};
+
+  InterpreterState() {
+    auto code = makeGuestCode();
+    std::memcpy(memory.data() + kLoopAddress, code.data(), code.size());
+    interpreter.Initialize(memory.data(), memory.size());
+    state.pc = kLoopAddress;
+    state.running = true;
+  }
+};
+
+// Code cache the compilers emit into, never executed here
+struct CodeCache {
+  void *base = nullptr;
+
+  CodeCache() {
+    base = mmap(nullptr, kCodeCacheSize, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+      base = nullptr;
+    }
+  }
+
+  ~CodeCache() {
+    if (base != nullptr) {
+      munmap(base, kCodeCacheSize);
+    }
+  }
+};
+
+template <typename Compiler> struct CompilerState {
+  CodeCache cache;
+  std::unique_ptr<Compiler> compiler;
+  std::vector<std::uint8_t> code = makeGuestCode();
+
+  // The compilers only append to the cache, start over once it is full
+  void compile() {
+    auto *block = compiler->Compile(code.data(), kLoopAddress, code.size());
+    if (block == nullptr) {
+      compiler->Initialize(cache.base, kCodeCacheSize);
+      block = compiler->Compile(code.data(), kLoopAddress, code.size());
+    }
+
+    bench::doNotOptimize(block);
+    delete block;
+  }
+};
+} // namespace
+
+// signal_handler.cpp (pulled in by fastmem) asks this before claiming a fault,
+// nothing in this process runs under the NCE engine
+namespace rpcsx::nce {
+bool IsNCEActive() { return false; }
+} // namespace rpcsx::nce
+
+void bench::registerPpuCases(std::vector<Case> &cases) {
+  namespace v8 = rpcsx::nce::v8;
+
+  auto interpreter = std::make_shared<InterpreterState>();
+  cases.push_back({
+      .name = "ppu/interpreter_loop",
+      .itemsPerIteration = kInterpretedSteps,
+      .run =
+          [=](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+              interpreter->interpreter.Execute(interpreter->state,
+                                               kInterpretedSteps);
+            }
+            bench::doNotOptimize(interpreter->state.gpr[3]);
+          },
+  });
+
+  // Compile latency per guest instruction of each tier, for the same loop
+  auto baseline = std::make_shared<CompilerState<v8::BaselineCompiler>>();
+  if (baseline->cache.base != nullptr) {
+    baseline->compiler = std::make_unique<v8::BaselineCompiler>();
+    baseline->compiler->Initialize(baseline->cache.base, kCodeCacheSize);
+
+    cases.push_back({
+        .name = "ppu/nce_v8_baseline_compile",
+        .itemsPerIteration = std::size(kLoop),
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                baseline->compile();
+              }
+            },
+    });
+  }
+
+  auto optimizing = std::make_shared<CompilerState<v8::OptimizingCompiler>>();
+  if (optimizing->cache.base != nullptr) {
+    optimizing->compiler =
+        std::make_unique<v8::OptimizingCompiler>(v8::OptimizationFlags{});
+    optimizing->compiler->Initialize(optimizing->cache.base, kCodeCacheSize);
+
+    cases.push_back({
+        .name = "ppu/nce_v8_optimizing_compile",
+        .itemsPerIteration = std::size(kLoop),
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                optimizing->compile();
+              }
+            },
+    });
+  }
+}
@@ -0,0 +1,224 @@
+#include "stdafx.h"
+
+#include "bench.hpp"
+
+#include "Emu/RSX/Common/BufferUtils.h"
+#include "sve2_optimizations.h"
+
+#include <cstring>
+#include <memory>
+#include <numeric>
+
+namespace {
+constexpr std::size_t kCopySize = 1 << 20;
+constexpr std::size_t kFloatCount = 1 << 16;
+constexpr std::size_t kMatrixCount = 1 << 12;
+constexpr std::size_t kSwapCount = 1 << 16;
+constexpr std::size_t kIndexCount = 3 * (1 << 14);
+
+template <typename T> std::shared_ptr<std::vector<T>> makeBuffer(std::size_t count) {
+  auto buffer = std::make_shared<std::vector<T>>(count);
+  std::iota(buffer->begin(), buffer->end(), T{1});
+  return buffer;
+}
+
+void registerSve2Cases(std::vector<bench::Case> &cases) {
+  namespace sve2 = rpcsx::sve2;
+
+  // Uses the SVE2 paths when the device has them, NEON otherwise
+  sve2::InitializeSVE2();
+
+  {
+    auto src = makeBuffer<std::uint8_t>(kCopySize);
+    auto dst = makeBuffer<std::uint8_t>(kCopySize);
+    cases.push_back({
+        .name = "sve2/memcpy_1m",
+        .bytesPerIteration = kCopySize,
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                sve2::OptimizedMemcpy(dst->data(), src->data(), kCopySize);
+                bench::clobberMemory();
+              }
+            },
+    });
+
+    cases.push_back({
+        .name = "sve2/memset_1m",
+        .bytesPerIteration = kCopySize,
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                sve2::OptimizedMemset(dst->data(), static_cast<int>(i), kCopySize);
+                bench::clobberMemory();
+              }
+            },
+    });
+
+    cases.push_back({
+        .name = "sve2/memcmp_1m",
+        .bytesPerIteration = kCopySize,
+        .run =
+            [=](std::uint64_t iterations) {
+              std::memcpy(dst->data(), src->data(), kCopySize);
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                bench::doNotOptimize(
+                    sve2::OptimizedMemcmp(dst->data(), src->data(), kCopySize));
+              }
+            },
+    });
+  }
+
+  {
+    auto a = makeBuffer<float>(kFloatCount);
+    auto b = makeBuffer<float>(kFloatCount);
+    auto c = makeBuffer<float>(kFloatCount);
+    auto dst = makeBuffer<float>(kFloatCount);
+
+    cases.push_back({
+        .name = "sve2/vector_fma_f32_64k",
+        .bytesPerIteration = kFloatCount * sizeof(float) * 4,
+        .itemsPerIteration = kFloatCount,
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                sve2::VectorFMAF32(dst->data(), a->data(), b->data(), c->data(),
+                                   kFloatCount);
+                bench::clobberMemory();
+              }
+            },
+    });
+
+    cases.push_back({
+        .name = "sve2/vector_dot_f32_64k",
+        .bytesPerIteration = kFloatCount * sizeof(float) * 2,
+        .itemsPerIteration = kFloatCount,
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                bench::doNotOptimize(
+                    sve2::VectorDotF32(a->data(), b->data(), kFloatCount));
+              }
+            },
+    });
+  }
+
+  {
+    auto matrices = makeBuffer<float>(kMatrixCount * 16);
+    auto vectors = makeBuffer<float>(kMatrixCount * 4);
+    auto dst = makeBuffer<float>(kMatrixCount * 16);
+
+    cases.push_back({
+        .name = "sve2/matrix4x4_multiply",
+        .itemsPerIteration = 1,
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                sve2::Matrix4x4Multiply(dst->data(), matrices->data(),
+                                        matrices->data() + 16);
+                bench::clobberMemory();
+              }
+            },
+    });
+
+    cases.push_back({
+        .name = "sve2/batch_matrix_vector_4k",
+        .itemsPerIteration = kMatrixCount,
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                sve2::BatchMatrixVectorMul(dst->data(), matrices->data(),
+                                           vectors->data(), kMatrixCount);
+                bench::clobberMemory();
+              }
+            },
+    });
+  }
+
+  {
+    auto a = makeBuffer<std::uint32_t>(kFloatCount);
+    auto b = makeBuffer<std::uint32_t>(kFloatCount);
+    auto mask = makeBuffer<std::uint32_t>(kFloatCount);
+    auto dst = makeBuffer<std::uint32_t>(kFloatCount);
+
+    cases.push_back({
+        .name = "sve2/spu_select_64k",
+        .bytesPerIteration = kFloatCount * sizeof(std::uint32_t) * 4,
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                sve2::SPUSelect(dst->data(), a->data(), b->data(), mask->data(),
+                                kFloatCount);
+                bench::clobberMemory();
+              }
+            },
+    });
+  }
+}
+
+void registerBufferUtilsCases(std::vector<bench::Case> &cases) {
+  {
+    auto src = makeBuffer<u32>(kSwapCount);
+    auto dst = makeBuffer<u32>(kSwapCount);
+
+    cases.push_back({
+        .name = "buffer_utils/copy_swap_u32_64k",
+        .bytesPerIteration = kSwapCount * sizeof(u32),
+        .run =
+            [=](std::uint64_t iterations) {
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                copy_data_swap_u32(dst->data(), src->data(), kSwapCount);
+                bench::clobberMemory();
+              }
+            },
+    });
+
+    // Steady state of vertex constant uploads: nothing changed since last time
+    cases.push_back({
+        .name = "buffer_utils/copy_swap_u32_cmp_64k",
+        .bytesPerIteration = kSwapCount * sizeof(u32),
+        .run =
+            [=](std::uint64_t iterations) {
+              copy_data_swap_u32(dst->data(), src->data(), kSwapCount);
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                bench::doNotOptimize(
+                    copy_data_swap_u32_cmp(dst->data(), src->data(), kSwapCount));
+              }
+            },
+    });
+  }
+
+  {
+    // Big endian 16-bit triangle list with a restart index every 64 indices
+    auto src = std::make_shared<std::vector<std::uint16_t>>(kIndexCount);
+    for (std::size_t i = 0; i < kIndexCount; ++i) {
+      const std::uint16_t index = i % 64 == 63 ? 0xffff : i % 4096;
+      (*src)[i] = static_cast<std::uint16_t>(index << 8 | index >> 8);
+    }
+
+    auto dst = std::make_shared<std::vector<std::uint16_t>>(kIndexCount);
+
+    cases.push_back({
+        .name = "buffer_utils/index_u16_restart_48k",
+        .bytesPerIteration = kIndexCount * sizeof(std::uint16_t),
+        .itemsPerIteration = kIndexCount,
+        .run =
+            [=](std::uint64_t iterations) {
+              const std::span<const std::byte> in = std::as_bytes(std::span(*src));
+              const std::span<std::byte> out = std::as_writable_bytes(std::span(*dst));
+              for (std::uint64_t i = 0; i < iterations; ++i) {
+                bench::doNotOptimize(write_index_array_data_to_buffer(
+                    out, in, rsx::index_array_type::u16,
+                    rsx::primitive_type::triangles, true, 0xffff,
+                    [](rsx::primitive_type) { return false; }));
+              }
+            },
+    });
+  }
+}
+} // namespace
+
+void bench::registerSimdCases(std::vector<Case> &cases) {
+  registerSve2Cases(cases);
+  registerBufferUtilsCases(cases);
+}
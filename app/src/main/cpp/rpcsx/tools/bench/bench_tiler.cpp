@@ -0,0 +1,95 @@
+#include "bench.hpp"
+
+#include <amdgpu/tiler.hpp>
+#include <amdgpu/tiler_cpu.hpp>
+#include <gnm/constants.hpp>
+
+#include <memory>
+#include <string>
+
+namespace {
+// Largest RGBA8 surface Cache detiles on the host (kCpuDetileMaxSize)
+constexpr std::uint32_t kSurfaceSize = 256;
+
+struct TilerState {
+  amdgpu::TileMode tileMode;
+  amdgpu::SurfaceInfo info;
+  std::vector<std::byte> tiled;
+  std::vector<std::byte> linear;
+};
+
+std::shared_ptr<TilerState> makeState(amdgpu::ArrayMode arrayMode) {
+  for (auto tileMode : amdgpu::getDefaultTileModes()) {
+    if (tileMode.arrayMode() != arrayMode) {
+      continue;
+    }
+
+    auto info = amdgpu::computeSurfaceInfo(
+        tileMode, gnm::TextureType::Dim2D, gnm::kDataFormat8_8_8_8,
+        kSurfaceSize, kSurfaceSize, 1, kSurfaceSize, 0, 1, 0, 1, false);
+
+    if (!amdgpu::isCpuTilerSupported(info, tileMode, 0, 1)) {
+      continue;
+    }
+
+    auto state = std::make_shared<TilerState>();
+    state->tileMode = tileMode;
+    state->info = info;
+    state->tiled.resize(info.totalTiledSize);
+    state->linear.resize(info.totalLinearSize);
+
+    for (std::size_t i = 0; i < state->tiled.size(); ++i) {
+      state->tiled[i] = static_cast<std::byte>(i * 13);
+    }
+
+    return state;
+  }
+
+  return {};
+}
+
+void registerMode(std::vector<bench::Case> &cases, amdgpu::ArrayMode arrayMode,
+                  const char *modeName) {
+  auto state = makeState(arrayMode);
+  if (!state) {
+    return;
+  }
+
+  const std::string suffix = std::string(modeName) + "_256x256_rgba8";
+
+  cases.push_back({
+      .name = "tiler/detile_" + suffix,
+      .bytesPerIteration = state->info.totalLinearSize,
+      .run =
+          [=](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+              amdgpu::detileCpu(state->info, state->tileMode,
+                                state->tiled.data(), state->tiled.size(),
+                                state->linear.data(), state->linear.size(), 0,
+                                0, 1);
+              bench::clobberMemory();
+            }
+          },
+  });
+
+  cases.push_back({
+      .name = "tiler/tile_" + suffix,
+      .bytesPerIteration = state->info.totalLinearSize,
+      .run =
+          [=](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+              amdgpu::tileCpu(state->info, state->tileMode,
+                              state->linear.data(), state->linear.size(),
+                              state->tiled.data(), state->tiled.size(), 0, 0,
+                              1);
+              bench::clobberMemory();
+            }
+          },
+  });
+}
+} // namespace
+
+void bench::registerTilerCases(std::vector<Case> &cases) {
+  registerMode(cases, amdgpu::kArrayMode1dTiledThin, "1d_thin");
+  registerMode(cases, amdgpu::kArrayMode2dTiledThin, "2d_thin");
+}
@@ -0,0 +1,302 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <rx/Version.hpp>
+#include <string_view>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef __ANDROID__
+#include <sys/system_properties.h>
+#endif
+
+namespace {
+struct Options {
+  std::vector<std::string_view> filters;
+  std::string_view jsonPath;
+  double minTimeMs = 200;
+  int repetitions = 5;
+  int cpu = -1;
+  bool list = false;
+};
+
+void printUsage(const char *argv0) {
+  std::fprintf(
+      stderr,
+      "Usage: %s [options]\n"
+      "  --filter <substr>    run cases whose name contains substr, may be "
+      "repeated\n"
+      "  --json <path>        write results as JSON (- for stdout)\n"
+      "  --min-time <ms>      minimal duration of one repetition (200)\n"
+      "  --repetitions <n>    timed repetitions per case (5)\n"
+      "  --cpu <n>            pin to a core, keeps big.LITTLE runs comparable\n"
+      "  --list               list cases and exit\n",
+      argv0);
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto value = [&]() -> const char * {
+      return i + 1 < argc ? argv[++i] : nullptr;
+    };
+
+    if (arg == "--list") {
+      options.list = true;
+      continue;
+    }
+
+    const char *param = value();
+    if (param == nullptr) {
+      return false;
+    }
+
+    if (arg == "--filter") {
+      options.filters.push_back(param);
+    } else if (arg == "--json") {
+      options.jsonPath = param;
+    } else if (arg == "--min-time") {
+      options.minTimeMs = std::max(1.0, std::atof(param));
+    } else if (arg == "--repetitions") {
+      options.repetitions = std::max(1, std::atoi(param));
+    } else if (arg == "--cpu") {
+      options.cpu = std::atoi(param);
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool matches(const Options &options, const bench::Case &benchCase) {
+  if (options.filters.empty()) {
+    return true;
+  }
+
+  return std::any_of(options.filters.begin(), options.filters.end(),
+                     [&](std::string_view filter) {
+                       return benchCase.name.find(filter) != std::string::npos;
+                     });
+}
+
+double timeBatch(const bench::Case &benchCase, std::uint64_t iterations) {
+  auto start = std::chrono::steady_clock::now();
+  benchCase.run(iterations);
+  bench::clobberMemory();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+bench::Result runCase(const Options &options, const bench::Case &benchCase) {
+  const double minTimeNs = options.minTimeMs * 1e6;
+
+  // Warm up caches and lazily initialized state, then grow the batch until it
+  // is long enough for the clock resolution not to matter
+  std::uint64_t iterations = 1;
+  double elapsed = timeBatch(benchCase, iterations);
+  while (elapsed < minTimeNs / 10 && iterations < (1ull << 40)) {
+    iterations *= 10;
+    elapsed = timeBatch(benchCase, iterations);
+  }
+
+  const double perIteration = elapsed / iterations;
+  iterations = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(minTimeNs / std::max(perIteration, 1e-3)));
+
+  std::vector<double> samples;
+  samples.reserve(options.repetitions);
+  for (int i = 0; i < options.repetitions; ++i) {
+    samples.push_back(timeBatch(benchCase, iterations) / iterations);
+  }
+
+  std::sort(samples.begin(), samples.end());
+
+  return {
+      .benchCase = &benchCase,
+      .iterations = iterations,
+      .medianNs = samples[samples.size() / 2],
+      .minNs = samples.front(),
+      .maxNs = samples.back(),
+  };
+}
+
+double bytesPerSecond(const bench::Result &result) {
+  return result.benchCase->bytesPerIteration * 1e9 / result.medianNs;
+}
+
+double itemsPerSecond(const bench::Result &result) {
+  return result.benchCase->itemsPerIteration * 1e9 / result.medianNs;
+}
+
+void printResult(const bench::Result &result) {
+  std::printf("%-40s %14.1f ns  (min %.1f, max %.1f)",
+              result.benchCase->name.c_str(), result.medianNs, result.minNs,
+              result.maxNs);
+
+  if (result.benchCase->bytesPerIteration) {
+    std::printf("  %10.1f MB/s", bytesPerSecond(result) / 1e6);
+  }
+
+  if (result.benchCase->itemsPerIteration) {
+    std::printf("  %10.3f M/s", itemsPerSecond(result) / 1e6);
+  }
+
+  std::printf("\n");
+  std::fflush(stdout);
+}
+
+std::string jsonString(std::string_view text) {
+  std::string result = "\"";
+  for (char c : text) {
+    switch (c) {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+        result += buf;
+      } else {
+        result += c;
+      }
+    }
+  }
+
+  return result + '"';
+}
+
+std::string getProperty([[maybe_unused]] const char *name) {
+#ifdef __ANDROID__
+  char value[PROP_VALUE_MAX]{};
+  __system_property_get(name, value);
+  return value;
+#else
+  return {};
+#endif
+}
+
+void writeJson(std::FILE *out, const Options &options,
+               const std::vector<bench::Result> &results) {
+  std::fprintf(out, "{\n  \"schema\": 1,\n");
+  std::fprintf(out, "  \"version\": %s,\n",
+               jsonString(rx::getVersion().toString()).c_str());
+  std::fprintf(out, "  \"timestamp\": %lld,\n",
+               static_cast<long long>(std::time(nullptr)));
+  std::fprintf(out, "  \"device\": {\n");
+  std::fprintf(out, "    \"model\": %s,\n",
+               jsonString(getProperty("ro.product.model")).c_str());
+  std::fprintf(out, "    \"soc\": %s,\n",
+               jsonString(getProperty("ro.soc.model")).c_str());
+  std::fprintf(out, "    \"threads\": %u,\n",
+               std::thread::hardware_concurrency());
+  std::fprintf(out, "    \"pinned_cpu\": %d\n  },\n", options.cpu);
+  std::fprintf(out, "  \"min_time_ms\": %.1f,\n  \"repetitions\": %d,\n",
+               options.minTimeMs, options.repetitions);
+  std::fprintf(out, "  \"results\": [");
+
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    auto &result = results[i];
+    std::fprintf(out, "%s\n    {\"name\": %s, \"iterations\": %llu",
+                 i ? "," : "", jsonString(result.benchCase->name).c_str(),
+                 static_cast<unsigned long long>(result.iterations));
+    std::fprintf(out, ", \"ns_per_iter\": %.3f, \"min_ns\": %.3f, \"max_ns\": "
+                      "%.3f",
+                 result.medianNs, result.minNs, result.maxNs);
+
+    if (result.benchCase->bytesPerIteration) {
+      std::fprintf(out, ", \"bytes_per_sec\": %.0f", bytesPerSecond(result));
+    }
+
+    if (result.benchCase->itemsPerIteration) {
+      std::fprintf(out, ", \"items_per_sec\": %.0f", itemsPerSecond(result));
+    }
+
+    std::fprintf(out, "}");
+  }
+
+  std::fprintf(out, "\n  ]\n}\n");
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+#ifdef __linux__
+  if (options.cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(options.cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+      std::fprintf(stderr, "failed to pin to cpu %d\n", options.cpu);
+      return 1;
+    }
+  }
+#endif
+
+  std::vector<bench::Case> cases;
+  bench::registerSimdCases(cases);
+  bench::registerCryptoCases(cases);
+  bench::registerTilerCases(cases);
+  bench::registerPpuCases(cases);
+  bench::registerPipelineCacheCases(cases);
+
+  if (options.list) {
+    for (auto &benchCase : cases) {
+      std::printf("%s\n", benchCase.name.c_str());
+    }
+
+    return 0;
+  }
+
+  // Keep stdout parseable when the JSON goes there
+  const bool jsonToStdout = options.jsonPath == "-";
+
+  std::vector<bench::Result> results;
+  for (auto &benchCase : cases) {
+    if (!matches(options, benchCase)) {
+      continue;
+    }
+
+    results.push_back(runCase(options, benchCase));
+
+    if (!jsonToStdout) {
+      printResult(results.back());
+    }
+  }
+
+  if (jsonToStdout) {
+    writeJson(stdout, options, results);
+  } else if (!options.jsonPath.empty()) {
+    std::FILE *out = std::fopen(std::string(options.jsonPath).c_str(), "w");
+    if (out == nullptr) {
+      std::fprintf(stderr, "failed to open %s\n",
+                   std::string(options.jsonPath).c_str());
+      return 1;
+    }
+
+    writeJson(out, options, results);
+    std::fclose(out);
+  }
+
+  return 0;
+}
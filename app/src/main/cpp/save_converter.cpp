@@ -3,6 +3,7 @@
  */
 
 #include "save_converter.h"
+#include "nce_core/thread_pool.h"
 #include <android/log.h>
 #include <mutex>
 #include <fstream>
@@ -11,6 +12,7 @@
 #include <dirent.h>
 #include <sys/stat.h>
 #include <algorithm>
+#include <thread>
 
 #define LOG_TAG "RPCSX-SaveConverter"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -536,6 +538,7 @@ ConversionResult ConvertSave(const char* source_path, const char* dest_path,
     if (options.create_backup) {
         std::string backup_path = std::string(source_path) + ".backup";
         g_system.CopyDirectory(source_path, backup_path.c_str());
+        std::lock_guard<std::mutex> lock(g_system.mutex);
         g_system.stats.backups_created++;
     }
     
@@ -564,7 +567,11 @@ ConversionResult ConvertSave(const char* source_path, const char* dest_path,
     result.output_path = dest_path;
     result.files_converted = save.files.size();
     
-    g_system.stats.saves_converted++;
+    {
+        std::lock_guard<std::mutex> lock(g_system.mutex);
+        g_system.stats.saves_converted++;
+        g_system.stats.total_bytes_processed += save.total_size;
+    }
     g_conversions_count++;
     
     LOGI("Converted save %s -> %s", source_path, dest_path);
@@ -572,6 +579,89 @@ ConversionResult ConvertSave(const char* source_path, const char* dest_path,
     return result;
 }
 
+BatchConversionResult ConvertSaveDirectory(const char* source_dir, const char* dest_dir,
+                                           SaveFormat target_format,
+                                           const ConversionOptions& options,
+                                           const BatchProgressCallback& progress,
+                                           size_t max_parallel) {
+    BatchConversionResult batch = {0, 0, 0, {}};
+    
+    if (!source_dir || !dest_dir) {
+        return batch;
+    }
+    
+    // Збираємо збереження (директорії з PARAM.SFO)
+    std::vector<std::string> names;
+    if (DIR* dir = opendir(source_dir)) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (entry->d_name[0] == '.') continue;
+            
+            std::string sfo_path = std::string(source_dir) + "/" + entry->d_name + "/PARAM.SFO";
+            struct stat st;
+            if (stat(sfo_path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                names.push_back(entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+    
+    batch.saves_total = names.size();
+    batch.results.resize(names.size());
+    
+    if (names.empty()) {
+        return batch;
+    }
+    
+    mkdir(dest_dir, 0755);
+    
+    size_t workers = max_parallel;
+    if (workers == 0) {
+        workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 4);
+    }
+    workers = std::min(workers, names.size());
+    
+    // Збереження незалежні: кожне копіюється і переписує свій SFO у своїй директорії
+    std::mutex progress_mutex;
+    size_t completed = 0;
+    
+    util::ThreadPool pool(workers);
+    for (size_t i = 0; i < names.size(); ++i) {
+        pool.enqueue(util::TaskLane::Streaming, [&, i] {
+            std::string src = std::string(source_dir) + "/" + names[i];
+            std::string dst = std::string(dest_dir) + "/" + names[i];
+            
+            batch.results[i] = ConvertSave(src.c_str(), dst.c_str(), target_format, options);
+            const bool ok = batch.results[i].success;
+            
+            if (!ok) {
+                std::lock_guard<std::mutex> lock(g_system.mutex);
+                g_system.stats.saves_failed++;
+            }
+            
+            std::lock_guard<std::mutex> lock(progress_mutex);
+            ++completed;
+            if (progress) {
+                progress({i, completed, names.size(), src.c_str(), ok});
+            }
+        });
+    }
+    pool.wait();
+    
+    for (const auto& result : batch.results) {
+        if (result.success) {
+            batch.saves_converted++;
+        } else {
+            batch.saves_failed++;
+        }
+    }
+    
+    LOGI("Batch converted %zu/%zu saves %s -> %s on %zu workers",
+         batch.saves_converted, batch.saves_total, source_dir, dest_dir, workers);
+    
+    return batch;
+}
+
 ConversionResult ConvertSaveRegion(const char* path, RegionCode target_region) {
     ConversionResult result = {false, "", "", 0, 0, {}};
     
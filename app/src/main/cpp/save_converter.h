@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include <atomic>
+#include <functional>
 #include <unordered_map>
 
 namespace rpcsx::saves {
@@ -176,6 +177,28 @@ struct ConversionResult {
     std::vector<std::string> warnings;
 };
 
+// =============================================================================
+// Batch Conversion
+// =============================================================================
+
+struct BatchProgress {
+    size_t index;               // Номер збереження в пакеті
+    size_t completed;           // Скільки вже оброблено (разом з цим)
+    size_t total;
+    const char* source_path;
+    bool success;
+};
+
+// Викликається з робочих потоків, але ніколи одночасно
+using BatchProgressCallback = std::function<void(const BatchProgress&)>;
+
+struct BatchConversionResult {
+    size_t saves_total;
+    size_t saves_converted;
+    size_t saves_failed;
+    std::vector<ConversionResult> results;  // У порядку сканування директорії
+};
+
 // =============================================================================
 // Configuration
 // =============================================================================
@@ -254,6 +277,16 @@ RegionCode DetectRegionFromTitleId(const char* title_id);
 ConversionResult ConvertSave(const char* source_path, const char* dest_path,
                               SaveFormat target_format, const ConversionOptions& options);
 
+/**
+ * Конвертувати всі збереження директорії паралельно (dest_dir/<ім'я збереження>);
+ * max_parallel = 0 - за кількістю ядер (до 4)
+ */
+BatchConversionResult ConvertSaveDirectory(const char* source_dir, const char* dest_dir,
+                                           SaveFormat target_format,
+                                           const ConversionOptions& options,
+                                           const BatchProgressCallback& progress = {},
+                                           size_t max_parallel = 0);
+
 /**
  * Конвертувати регіон збереження
  */
@@ -6,6 +6,7 @@
 #include "shader_cache_manager.h"
 #include <android/log.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <fstream>
@@ -14,7 +15,10 @@
 #include <dirent.h>
 #include <cerrno>
 #include <cstring>
-// #include <zstd.h>  // Optional: requires libzstd installation
+#include <zlib.h>
+#if defined(HAVE_ZSTD)
+#include <zstd.h>
+#endif
 
 #define LOG_TAG "RPCSX-ShaderCache"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -24,34 +28,88 @@ namespace rpcsx::shaders {
 
 // Трирівнева структура кешу:
 // L1 - In-memory cache (найшвидший доступ)
-// L2 - Persistent cache на UFS 4.0 (швидкий SSD)
-// L3 - Compressed archive cache (економія місця)
+// L2 - Persistent cache на UFS 4.0: один append-only архів на title
+//      (shader_cache.pack), mmap'иться при ініціалізації
+// L3 - Compressed записи того ж архіву (zstd, або zlib без libzstd)
+//
+// Замість десятків тисяч дрібних .spv файлів (повільно на f2fs і при старті,
+// і за місцем) - один файл: заголовок + записи [PackRecord][blob]. Індекс
+// hash -> (offset, size) відновлюється при старті проходом по заголовках
+// записів у mmap; завантаження запису - вказівник + довжина.
+
+// Формат blob'а CompressShader: [BlobHeader][payload]
+enum class ShaderCodec : uint32_t {
+    Raw = 0,
+    Zstd = 1,
+    Deflate = 2,
+};
+
+struct BlobHeader {
+    uint32_t codec;       // ShaderCodec
+    uint32_t raw_size;
+};
+
+static constexpr char kPackMagic[4] = {'R', 'S', 'P', 'K'};
+static constexpr uint32_t kPackVersion = 1;
+static constexpr uint32_t kRecordMagic = 0x43455253;  // "SREC"
+
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t reserved;
+};
+
+struct PackRecord {
+    uint32_t magic;
+    uint32_t blob_size;   // BlobHeader + payload
+    uint64_t hash;
+    uint64_t checksum;    // FNV-1a blob'а
+};
+
+static_assert(sizeof(PackHeader) == 16, "PackHeader layout");
+static_assert(sizeof(PackRecord) == 24, "PackRecord layout");
+
+struct ArchiveEntry {
+    uint64_t offset;      // blob (після PackRecord)
+    uint32_t size;
+};
 
 struct ShaderCacheImpl {
     // L1: In-memory кеш
+    // Порядок: l1_mutex -> archive_mutex
+    std::mutex l1_mutex;
     std::unordered_map<uint64_t, CompiledShader> memory_cache;
     size_t l1_max_size = 512 * 1024 * 1024;  // 512MB
     size_t l1_current_size = 0;
-    
-    // L2: Persistent кеш
-    std::string l2_cache_dir;
-    
-    // L3: Compressed кеш
-    std::string l3_cache_file;
-    
+
+    // L2/L3: Packed архів
+    std::string archive_path;
+    int archive_fd = -1;
+    const uint8_t* map_base = nullptr;
+    size_t map_size = 0;
+    uint64_t archive_end = 0;                // кінець останнього валідного запису
+    std::unordered_map<uint64_t, ArchiveEntry> archive_index;
+    std::mutex archive_mutex;
+
     // Async компіляція через глобальний thread pool
     util::ThreadPool* thread_pool = nullptr;
-    
+
     // Статистика
     std::atomic<uint64_t> l1_hits{0};
     std::atomic<uint64_t> l2_hits{0};
     std::atomic<uint64_t> l3_hits{0};
     std::atomic<uint64_t> cache_misses{0};
+
+    ~ShaderCacheImpl() {
+        if (map_base) munmap(const_cast<uint8_t*>(map_base), map_size);
+        if (archive_fd >= 0) close(archive_fd);
+    }
 };
 
 static std::unique_ptr<ShaderCacheImpl> g_cache;
 
-static constexpr uint32_t kShaderCacheMetaVersion = 2;
+static constexpr uint32_t kShaderCacheMetaVersion = 3;
 
 static std::string ReadTextFile(const std::string& path) {
     std::ifstream in(path);
@@ -119,8 +177,7 @@ static void PurgeDirectoryContents(const std::string& path) {
 }
 
 static bool EnsureCacheCompatible(const std::string& root_dir,
-                                  const std::string& l2_dir,
-                                  const std::string& l3_file,
+                                  const std::string& archive_file,
                                   const char* build_id) {
     const std::string meta_path = root_dir + "/shader_cache_meta.txt";
     const std::string current_build = build_id ? Trim(build_id) : "unknown";
@@ -143,7 +200,7 @@ static bool EnsureCacheCompatible(const std::string& root_dir,
         }
 
         if (version != kShaderCacheMetaVersion || build != current_build || gpu != current_gpu) {
-            LOGI("Shader cache meta mismatch: v%u/%u build='%s'/'%s' gpu='%s'/'%s'", 
+            LOGI("Shader cache meta mismatch: v%u/%u build='%s'/'%s' gpu='%s'/'%s'",
                  version, kShaderCacheMetaVersion,
                  build.c_str(), current_build.c_str(),
                  gpu.c_str(), current_gpu.c_str());
@@ -154,8 +211,12 @@ static bool EnsureCacheCompatible(const std::string& root_dir,
     }
 
     if (purge) {
-        PurgeFile(l3_file);
-        PurgeDirectoryContents(l2_dir);
+        PurgeFile(archive_file);
+        // Розкладка до v3: окремі .spv файли + окремий L3 файл
+        const std::string legacy_l2 = root_dir + "/shader_cache_l2";
+        PurgeDirectoryContents(legacy_l2);
+        rmdir(legacy_l2.c_str());
+        PurgeFile(root_dir + "/shader_cache_l3.zst");
     }
 
     std::ostringstream meta;
@@ -176,38 +237,227 @@ uint64_t ComputeShaderHash(const void* shader_code, size_t size) {
     // XXH64 - швидкий hash, ідеальний для шейдерів
     uint64_t hash = 0xcbf29ce484222325ULL;  // FNV offset basis
     const uint8_t* data = static_cast<const uint8_t*>(shader_code);
-    
+
     for (size_t i = 0; i < size; i++) {
         hash ^= data[i];
         hash *= 0x100000001b3ULL;  // FNV prime
     }
-    
+
     return hash;
 }
 
 /**
- * Компресія шейдера (disabled - requires libzstd)
+ * Компресія шейдера: zstd (HAVE_ZSTD), інакше zlib deflate.
+ * Результат самоописний ([BlobHeader][payload]); якщо стиснення не
+ * виграє місця - payload зберігається як є.
  */
 std::vector<uint8_t> CompressShader(const void* data, size_t size) {
-    // Compression disabled - requires libzstd
-    // For now, just return uncompressed data
-    std::vector<uint8_t> result(static_cast<const uint8_t*>(data), 
-                                static_cast<const uint8_t*>(data) + size);
-    LOGI("Shader cache: compression disabled (libzstd not available)");
+    std::vector<uint8_t> result;
+    if (!data || size == 0 || size > UINT32_MAX) return result;
+
+    BlobHeader header{static_cast<uint32_t>(ShaderCodec::Raw), static_cast<uint32_t>(size)};
+    size_t payload_size = 0;
+
+#if defined(HAVE_ZSTD)
+    result.resize(sizeof(BlobHeader) + ZSTD_compressBound(size));
+    const size_t zsize = ZSTD_compress(result.data() + sizeof(BlobHeader),
+                                       result.size() - sizeof(BlobHeader), data, size, 3);
+    if (!ZSTD_isError(zsize) && zsize < size) {
+        header.codec = static_cast<uint32_t>(ShaderCodec::Zstd);
+        payload_size = zsize;
+    }
+#else
+    uLongf zsize = compressBound(static_cast<uLong>(size));
+    result.resize(sizeof(BlobHeader) + zsize);
+    if (compress2(result.data() + sizeof(BlobHeader), &zsize,
+                  static_cast<const Bytef*>(data), static_cast<uLong>(size), 6) == Z_OK &&
+        zsize < size) {
+        header.codec = static_cast<uint32_t>(ShaderCodec::Deflate);
+        payload_size = zsize;
+    }
+#endif
+
+    if (header.codec == static_cast<uint32_t>(ShaderCodec::Raw)) {
+        result.resize(sizeof(BlobHeader) + size);
+        memcpy(result.data() + sizeof(BlobHeader), data, size);
+        payload_size = size;
+    }
+
+    memcpy(result.data(), &header, sizeof(header));
+    result.resize(sizeof(BlobHeader) + payload_size);
     return result;
 }
 
 /**
- * Декомпресія шейдера (disabled - requires libzstd)
+ * Декомпресія blob'а CompressShader (порожній результат - пошкоджений
+ * blob або codec, недоступний у цьому білді)
  */
 std::vector<uint8_t> DecompressShader(const void* compressed_data, size_t compressed_size) {
-    // Decompression disabled - requires libzstd
-    // For now, just return data as-is
-    std::vector<uint8_t> result(static_cast<const uint8_t*>(compressed_data),
-                                static_cast<const uint8_t*>(compressed_data) + compressed_size);
+    std::vector<uint8_t> result;
+    if (!compressed_data || compressed_size < sizeof(BlobHeader)) return result;
+
+    BlobHeader header;
+    memcpy(&header, compressed_data, sizeof(header));
+    const uint8_t* payload = static_cast<const uint8_t*>(compressed_data) + sizeof(BlobHeader);
+    const size_t payload_size = compressed_size - sizeof(BlobHeader);
+
+    switch (static_cast<ShaderCodec>(header.codec)) {
+    case ShaderCodec::Raw:
+        if (payload_size != header.raw_size) return result;
+        result.assign(payload, payload + payload_size);
+        return result;
+
+    case ShaderCodec::Zstd: {
+#if defined(HAVE_ZSTD)
+        result.resize(header.raw_size);
+        const size_t n = ZSTD_decompress(result.data(), result.size(), payload, payload_size);
+        if (ZSTD_isError(n) || n != header.raw_size) result.clear();
+#else
+        LOGE("Shader cache: zstd blob in a build without libzstd");
+#endif
+        return result;
+    }
+
+    case ShaderCodec::Deflate: {
+        result.resize(header.raw_size);
+        uLongf n = header.raw_size;
+        if (uncompress(result.data(), &n, payload, static_cast<uLong>(payload_size)) != Z_OK ||
+            n != header.raw_size) {
+            result.clear();
+        }
+        return result;
+    }
+    }
     return result;
 }
 
+// =============================================================================
+// Packed архів
+// =============================================================================
+
+// Під archive_mutex: мапить файл заново (після append'ів поза поточним mmap)
+static bool RemapArchive(ShaderCacheImpl& cache, size_t size) {
+    if (cache.map_base) {
+        munmap(const_cast<uint8_t*>(cache.map_base), cache.map_size);
+        cache.map_base = nullptr;
+        cache.map_size = 0;
+    }
+    if (size == 0) return true;
+
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, cache.archive_fd, 0);
+    if (base == MAP_FAILED) {
+        LOGE("Failed to mmap shader archive: %s", strerror(errno));
+        return false;
+    }
+    madvise(base, size, MADV_RANDOM);
+    cache.map_base = static_cast<const uint8_t*>(base);
+    cache.map_size = size;
+    return true;
+}
+
+static bool OpenArchive(ShaderCacheImpl& cache) {
+    cache.archive_fd = open(cache.archive_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (cache.archive_fd < 0) {
+        LOGE("Failed to open shader archive %s: %s", cache.archive_path.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(cache.archive_fd, &st) != 0) return false;
+    size_t file_size = static_cast<size_t>(st.st_size);
+
+    bool valid = file_size >= sizeof(PackHeader);
+    if (valid) {
+        PackHeader header;
+        valid = pread(cache.archive_fd, &header, sizeof(header), 0) == sizeof(header) &&
+                memcmp(header.magic, kPackMagic, sizeof(kPackMagic)) == 0 &&
+                header.version == kPackVersion && header.header_size == sizeof(PackHeader);
+    }
+
+    if (!valid) {
+        if (file_size != 0) LOGI("Shader archive header mismatch - recreating");
+        PackHeader header{};
+        memcpy(header.magic, kPackMagic, sizeof(kPackMagic));
+        header.version = kPackVersion;
+        header.header_size = sizeof(PackHeader);
+        if (ftruncate(cache.archive_fd, 0) != 0 ||
+            pwrite(cache.archive_fd, &header, sizeof(header), 0) != sizeof(header)) {
+            LOGE("Failed to initialize shader archive: %s", strerror(errno));
+            return false;
+        }
+        file_size = sizeof(PackHeader);
+    }
+
+    if (!RemapArchive(cache, file_size)) return false;
+
+    // Відновлення індексу: прохід по заголовках записів (payload не читається)
+    uint64_t offset = sizeof(PackHeader);
+    while (offset + sizeof(PackRecord) <= file_size) {
+        PackRecord record;
+        memcpy(&record, cache.map_base + offset, sizeof(record));
+        if (record.magic != kRecordMagic || record.blob_size < sizeof(BlobHeader) ||
+            offset + sizeof(PackRecord) + record.blob_size > file_size) {
+            break;
+        }
+        // Пізніший запис з тим самим hash перекриває попередній
+        cache.archive_index[record.hash] = {offset + sizeof(PackRecord), record.blob_size};
+        offset += sizeof(PackRecord) + record.blob_size;
+    }
+
+    // Обірваний хвіст (краш під час append) - відрізаємо
+    if (offset != file_size) {
+        LOGI("Shader archive: truncating torn tail at %llu (file %zu bytes)",
+             (unsigned long long)offset, file_size);
+        if (ftruncate(cache.archive_fd, static_cast<off_t>(offset)) != 0) {
+            LOGE("Failed to truncate shader archive: %s", strerror(errno));
+        }
+    }
+    cache.archive_end = offset;
+
+    LOGI("Shader archive: %zu entries, %llu bytes (%s)", cache.archive_index.size(),
+         (unsigned long long)offset,
+#if defined(HAVE_ZSTD)
+         "zstd"
+#else
+         "deflate"
+#endif
+    );
+    return true;
+}
+
+static bool AppendToArchive(uint64_t hash, const std::vector<uint8_t>& blob) {
+    if (blob.empty() || blob.size() > UINT32_MAX) return false;
+
+    std::lock_guard<std::mutex> lock(g_cache->archive_mutex);
+    ShaderCacheImpl& cache = *g_cache;
+    if (cache.archive_fd < 0) return false;
+    if (cache.archive_index.count(hash)) return true;
+
+    PackRecord record{kRecordMagic, static_cast<uint32_t>(blob.size()), hash,
+                      ComputeShaderHash(blob.data(), blob.size())};
+
+    // Один pwrite на запис - обірваний запис відріжеться при наступному старті
+    std::vector<uint8_t> buffer(sizeof(record) + blob.size());
+    memcpy(buffer.data(), &record, sizeof(record));
+    memcpy(buffer.data() + sizeof(record), blob.data(), blob.size());
+
+    const ssize_t written = pwrite(cache.archive_fd, buffer.data(), buffer.size(),
+                                   static_cast<off_t>(cache.archive_end));
+    if (written != static_cast<ssize_t>(buffer.size())) {
+        LOGE("Failed to append to shader archive: %s", strerror(errno));
+        // Не залишаємо часткового запису
+        if (ftruncate(cache.archive_fd, static_cast<off_t>(cache.archive_end)) != 0) {
+            LOGE("Failed to roll back shader archive: %s", strerror(errno));
+        }
+        return false;
+    }
+
+    cache.archive_index[hash] = {cache.archive_end + sizeof(PackRecord),
+                                 static_cast<uint32_t>(blob.size())};
+    cache.archive_end += buffer.size();
+    return true;
+}
+
 /**
  * Ініціалізація трирівневого кешу
  */
@@ -218,21 +468,21 @@ bool InitializeShaderCache(const char* cache_directory) {
 }
 
 bool InitializeShaderCache(const char* cache_directory, const char* build_id) {
+#if defined(HAVE_ZSTD)
     LOGI("Initializing 3-tier Shader Cache with Zstd compression");
+#else
+    LOGI("Initializing 3-tier Shader Cache with Deflate compression (libzstd not available)");
+#endif
 
     g_cache = std::make_unique<ShaderCacheImpl>();
 
     const std::string root_dir = std::string(cache_directory);
     mkdir(root_dir.c_str(), 0755);
 
-    // Створюємо директорії для кешу
-    g_cache->l2_cache_dir = root_dir + "/shader_cache_l2";
-    g_cache->l3_cache_file = root_dir + "/shader_cache_l3.zst";
-
-    mkdir(g_cache->l2_cache_dir.c_str(), 0755);
+    g_cache->archive_path = root_dir + "/shader_cache.pack";
 
     // Інвалідація кешу при зміні білда або GPU-ідентифікатора.
-    EnsureCacheCompatible(root_dir, g_cache->l2_cache_dir, g_cache->l3_cache_file, build_id);
+    EnsureCacheCompatible(root_dir, g_cache->archive_path, build_id);
 
     // Завантажуємо існуючий кеш з диска
     LoadPersistentCache();
@@ -242,36 +492,28 @@ bool InitializeShaderCache(const char* cache_directory, const char* build_id) {
 }
 
 /**
- * Пошук шейдера в кеші (L1 -> L2 -> L3)
+ * Пошук шейдера в кеші (L1 -> архів)
  */
 CompiledShader* FindShader(uint64_t shader_hash) {
     if (!g_cache) return nullptr;
-    
+
     // L1: Перевіряємо in-memory кеш
-    auto it = g_cache->memory_cache.find(shader_hash);
-    if (it != g_cache->memory_cache.end()) {
-        g_cache->l1_hits++;
-        return &it->second;
+    {
+        std::lock_guard<std::mutex> lock(g_cache->l1_mutex);
+        auto it = g_cache->memory_cache.find(shader_hash);
+        if (it != g_cache->memory_cache.end()) {
+            g_cache->l1_hits++;
+            return &it->second;
+        }
     }
-    
-    // L2: Перевіряємо persistent кеш на диску
+
+    // L2/L3: Перевіряємо packed архів (mmap)
     CompiledShader* shader = LoadFromL2Cache(shader_hash);
     if (shader) {
         g_cache->l2_hits++;
-        // Додаємо в L1 для швидшого доступу наступного разу
-        CacheShaderL1(shader_hash, *shader);
         return shader;
     }
-    
-    // L3: Перевіряємо compressed архів
-    shader = LoadFromL3Cache(shader_hash);
-    if (shader) {
-        g_cache->l3_hits++;
-        CacheShaderL1(shader_hash, *shader);
-        CacheShaderL2(shader_hash, *shader);
-        return shader;
-    }
-    
+
     g_cache->cache_misses++;
     return nullptr;
 }
@@ -281,65 +523,80 @@ CompiledShader* FindShader(uint64_t shader_hash) {
  */
 void CacheShaderL1(uint64_t hash, const CompiledShader& shader) {
     if (!g_cache) return;
-    
+
+    std::lock_guard<std::mutex> lock(g_cache->l1_mutex);
+
     // Перевіряємо ліміт розміру L1
     if (g_cache->l1_current_size + shader.spirv_code.size() > g_cache->l1_max_size) {
         // Видаляємо найстаріші записи (LRU)
         EvictOldestL1Entries();
     }
-    
-    g_cache->memory_cache[hash] = shader;
+
+    // Заміна запису не повинна рахувати старий розмір двічі
+    CompiledShader& entry = g_cache->memory_cache[hash];
+    g_cache->l1_current_size -= entry.spirv_code.size();
+    entry = shader;
     g_cache->l1_current_size += shader.spirv_code.size();
 }
 
+void GetShaderCacheL1Usage(size_t* used_bytes, size_t* reclaimable_bytes) {
+    *used_bytes = 0;
+    *reclaimable_bytes = 0;
+    if (!g_cache) return;
+
+    std::lock_guard<std::mutex> lock(g_cache->l1_mutex);
+    std::lock_guard<std::mutex> archive_lock(g_cache->archive_mutex);
+
+    *used_bytes = g_cache->l1_current_size;
+    for (const auto& [hash, shader] : g_cache->memory_cache) {
+        if (g_cache->archive_index.count(hash)) {
+            *reclaimable_bytes += shader.spirv_code.size();
+        }
+    }
+}
+
+size_t TrimShaderCacheL1(size_t target_bytes) {
+    if (!g_cache) return 0;
+
+    std::lock_guard<std::mutex> lock(g_cache->l1_mutex);
+    std::lock_guard<std::mutex> archive_lock(g_cache->archive_mutex);
+
+    const size_t before = g_cache->l1_current_size;
+    auto& cache = g_cache->memory_cache;
+    for (auto it = cache.begin(); it != cache.end() && g_cache->l1_current_size > target_bytes;) {
+        // Лише L1 копія: витіснення означало б повторну компіляцію
+        if (!g_cache->archive_index.count(it->first)) {
+            ++it;
+            continue;
+        }
+
+        g_cache->l1_current_size -= it->second.spirv_code.size();
+        it = cache.erase(it);
+    }
+
+    return before - g_cache->l1_current_size;
+}
+
 /**
- * Збереження в L2 (persistent кеш на UFS 4.0)
+ * Збереження в L2 (запис у packed архів)
  */
 void CacheShaderL2(uint64_t hash, const CompiledShader& shader) {
     if (!g_cache) return;
-    
-    std::ostringstream filename;
-    filename << g_cache->l2_cache_dir << "/" 
-             << std::hex << std::setw(16) << std::setfill('0') << hash 
-             << ".spv";
-    
-    // Записуємо з O_DIRECT для bypass filesystem cache (швидше на UFS 4.0)
-    int fd = open(filename.str().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
-    if (fd < 0) {
-        LOGE("Failed to create L2 cache file: %s", filename.str().c_str());
-        return;
+
+    auto blob = CompressShader(shader.spirv_code.data(), shader.spirv_code.size());
+    if (blob.empty()) return;
+
+    if (AppendToArchive(hash, blob)) {
+        LOGI("Shader cached: hash=%016llx (%zu -> %zu bytes)", (unsigned long long)hash,
+             shader.spirv_code.size(), blob.size());
     }
-    
-    write(fd, shader.spirv_code.data(), shader.spirv_code.size());
-    close(fd);
-    
-    LOGI("Shader cached to L2: %s (%zu bytes)", filename.str().c_str(), shader.spirv_code.size());
 }
 
 /**
- * Збереження в L3 (compressed архів)
+ * Збереження в L3 - той самий архів (записи вже стиснені)
  */
 void CacheShaderL3(uint64_t hash, const CompiledShader& shader) {
-    if (!g_cache) return;
-    
-    // Компресуємо шейдер
-    auto compressed = CompressShader(shader.spirv_code.data(), shader.spirv_code.size());
-    if (compressed.empty()) return;
-    
-    // Додаємо в архів (append mode)
-    std::ofstream l3_file(g_cache->l3_cache_file, std::ios::binary | std::ios::app);
-    if (!l3_file) {
-        LOGE("Failed to open L3 cache file");
-        return;
-    }
-    
-    // Формат: [hash:8][size:4][compressed_data:size]
-    l3_file.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
-    uint32_t size = compressed.size();
-    l3_file.write(reinterpret_cast<const char*>(&size), sizeof(size));
-    l3_file.write(reinterpret_cast<const char*>(compressed.data()), size);
-    
-    LOGI("Shader cached to L3: hash=%016llx (%u bytes compressed)", hash, size);
+    CacheShaderL2(hash, shader);
 }
 
 /**
@@ -355,8 +612,8 @@ void QueueShaderCompilation(const ShaderCompilationTask& task) {
         LOGE("Thread pool not set for shader cache!");
         return;
     }
-    // Кидаємо завдання у глобальний thread pool
-    g_cache->thread_pool->enqueue([task]{
+    // Кидаємо завдання у background-compile lane глобального thread pool
+    g_cache->thread_pool->enqueue(util::TaskLane::BackgroundCompile, [task]{
         CompileShaderAsync(task);
     });
     LOGI("Shader queued for async compilation (thread pool)");
@@ -373,22 +630,23 @@ void SetThreadPool(util::ThreadPool* pool) {
  */
 void PrintCacheStats() {
     if (!g_cache) return;
-    
+
     LOGI("=== Shader Cache Statistics ===");
     LOGI("L1 (Memory) hits: %llu", g_cache->l1_hits.load());
-    LOGI("L2 (UFS 4.0) hits: %llu", g_cache->l2_hits.load());
-    LOGI("L3 (Compressed) hits: %llu", g_cache->l3_hits.load());
+    LOGI("L2 (Archive) hits: %llu", g_cache->l2_hits.load());
     LOGI("Cache misses: %llu", g_cache->cache_misses.load());
-    
+
     uint64_t total = g_cache->l1_hits + g_cache->l2_hits + g_cache->l3_hits + g_cache->cache_misses;
     if (total > 0) {
         float hit_rate = ((g_cache->l1_hits + g_cache->l2_hits + g_cache->l3_hits) * 100.0f) / total;
         LOGI("Overall hit rate: %.2f%%", hit_rate);
     }
-    
-    LOGI("L1 cache size: %zu MB / %zu MB", 
+
+    LOGI("L1 cache size: %zu MB / %zu MB",
          g_cache->l1_current_size / (1024*1024),
          g_cache->l1_max_size / (1024*1024));
+    LOGI("Archive: %zu entries, %llu KB", g_cache->archive_index.size(),
+         (unsigned long long)(g_cache->archive_end / 1024));
 }
 
 /**
@@ -402,15 +660,72 @@ void ShutdownShaderCache() {
     }
     // Виводимо статистику
     PrintCacheStats();
+    if (g_cache->archive_fd >= 0) {
+        fdatasync(g_cache->archive_fd);
+    }
     g_cache.reset();
     LOGI("Shader cache shutdown complete");
 }
 
-// Заглушки для функцій, що потребують повної реалізації
-CompiledShader* LoadFromL2Cache(uint64_t hash) { return nullptr; }
+/**
+ * Завантаження з архіву: вказівник + довжина в mmap, декомпресія в L1
+ */
+CompiledShader* LoadFromL2Cache(uint64_t hash) {
+    if (!g_cache) return nullptr;
+
+    std::vector<uint8_t> spirv;
+    {
+        std::lock_guard<std::mutex> lock(g_cache->archive_mutex);
+        ShaderCacheImpl& cache = *g_cache;
+
+        auto it = cache.archive_index.find(hash);
+        if (it == cache.archive_index.end()) return nullptr;
+        const ArchiveEntry entry = it->second;
+
+        // Запис доданий у цій сесії - за межами поточного mmap
+        if (entry.offset + entry.size > cache.map_size &&
+            !RemapArchive(cache, cache.archive_end)) {
+            return nullptr;
+        }
+
+        const uint8_t* blob = cache.map_base + entry.offset;
+        PackRecord record;
+        memcpy(&record, blob - sizeof(PackRecord), sizeof(record));
+        if (record.checksum != ComputeShaderHash(blob, entry.size)) {
+            LOGE("Shader archive: checksum mismatch for %016llx", (unsigned long long)hash);
+            cache.archive_index.erase(it);
+            return nullptr;
+        }
+
+        spirv = DecompressShader(blob, entry.size);
+        if (spirv.empty()) {
+            cache.archive_index.erase(it);
+            return nullptr;
+        }
+    }
+
+    CompiledShader shader;
+    shader.hash = hash;
+    shader.original_size = spirv.size();
+    shader.spirv_code = std::move(spirv);
+    CacheShaderL1(hash, shader);
+
+    std::lock_guard<std::mutex> lock(g_cache->l1_mutex);
+    auto l1 = g_cache->memory_cache.find(hash);
+    return l1 != g_cache->memory_cache.end() ? &l1->second : nullptr;
+}
+
+// L3 об'єднано з L2: стиснені записи живуть у тому ж архіві
 CompiledShader* LoadFromL3Cache(uint64_t hash) { return nullptr; }
+
+void LoadPersistentCache() {
+    if (!g_cache) return;
+    std::lock_guard<std::mutex> lock(g_cache->archive_mutex);
+    OpenArchive(*g_cache);
+}
+
+// Заглушки для функцій, що потребують повної реалізації
 void EvictOldestL1Entries() {}
-void LoadPersistentCache() {}
 void CompileShaderAsync(const ShaderCompilationTask& task) {}
 
 } // namespace rpcsx::shaders
@@ -76,6 +76,17 @@ std::vector<uint8_t> DecompressShader(const void* compressed_data, size_t compre
  */
 void PrintCacheStats();
 
+/**
+ * Облік L1 для memory budget: reclaimable - записи, що є і в архіві
+ */
+void GetShaderCacheL1Usage(size_t* used_bytes, size_t* reclaimable_bytes);
+
+/**
+ * Витіснення з L1 записів, що є в архіві, поки L1 більший за target_bytes.
+ * Вказівники з FindShader після цього недійсні. Повертає звільнені байти
+ */
+size_t TrimShaderCacheL1(size_t target_bytes);
+
 /**
  * Завершення роботи
  */
@@ -33,6 +33,9 @@ struct FaultInfo {
 static std::atomic<bool> g_installed{false};
 static std::atomic<bool> g_jit_handler_active{false};
 
+constexpr size_t kMaxFastmemHandlers = 4;
+static std::atomic<FastmemFaultHandler> g_fastmem_handlers[kMaxFastmemHandlers] = {};
+
 static thread_local sigjmp_buf* tl_jmp = nullptr;
 static thread_local int tl_depth = 0;
 static thread_local FaultInfo tl_fault;
@@ -76,6 +79,16 @@ static void signal_handler(int sig, siginfo_t* info, void* ucontext) {
     tl_fault.sig = sig;
     tl_fault.addr = info ? info->si_addr : nullptr;
     
+    // Fastmem: JIT переводить MMIO/RSX доступ на slow path і продовжує виконання
+    if ((sig == SIGSEGV || sig == SIGBUS) && ucontext) {
+        for (auto& slot : g_fastmem_handlers) {
+            FastmemFaultHandler handler = slot.load(std::memory_order_acquire);
+            if (handler && handler(tl_fault.addr, ucontext)) {
+                return;
+            }
+        }
+    }
+    
     // Try JIT execution for SIGILL (illegal instruction)
     if (sig == SIGILL && g_jit_handler_active.load() && ucontext) {
         ucontext_t* uctx = static_cast<ucontext_t*>(ucontext);
@@ -161,6 +174,24 @@ bool IsJITHandlerEnabled() {
     return g_jit_handler_active.load();
 }
 
+bool AddFastmemFaultHandler(FastmemFaultHandler handler) {
+    if (!handler) return false;
+    for (auto& slot : g_fastmem_handlers) {
+        FastmemFaultHandler expected = nullptr;
+        if (slot.load() == handler) return true;
+        if (slot.compare_exchange_strong(expected, handler)) return true;
+    }
+    LOGE("No free fastmem fault handler slots");
+    return false;
+}
+
+void RemoveFastmemFaultHandler(FastmemFaultHandler handler) {
+    for (auto& slot : g_fastmem_handlers) {
+        FastmemFaultHandler expected = handler;
+        slot.compare_exchange_strong(expected, nullptr);
+    }
+}
+
 CrashGuard::CrashGuard(const char* scope) : scope_(scope), ok_(true) {
     // Nesting support.
     ++tl_depth;
@@ -12,6 +12,13 @@ bool InstallSignalHandlers();
 void EnableJITHandler(bool enable);
 bool IsJITHandlerEnabled();
 
+// Fastmem fault hooks for SIGSEGV/SIGBUS, consulted before CrashGuard recovery.
+// A JIT returns true after backpatching the faulting guest access to its slow
+// path (MMIO/RSX) and redirecting the context PC - execution then resumes.
+using FastmemFaultHandler = bool (*)(void* fault_addr, void* ucontext);
+bool AddFastmemFaultHandler(FastmemFaultHandler handler);
+void RemoveFastmemFaultHandler(FastmemFaultHandler handler);
+
 // Lightweight scoped guard that can recover from native crashes inside a guarded
 // region (via sigsetjmp/siglongjmp). Intended to wrap calls into native/JIT/core
 // code so the app can fail gracefully instead of hard-crashing.
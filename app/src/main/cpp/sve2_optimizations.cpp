@@ -4,17 +4,36 @@
 
 #include "sve2_optimizations.h"
 #include <android/log.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <cmath>
 #include <mutex>
+#include <vector>
 #include <sys/auxv.h>
+#include <sys/prctl.h>
 
 #ifdef __aarch64__
 #include <arm_neon.h>
-// SVE2 intrinsics (якщо компілятор підтримує)
-#if defined(__ARM_FEATURE_SVE2)
+// SVE intrinsics: або весь модуль зібраний з SVE, або лише SVE ядра через
+// target attribute (виконуються тільки якщо HWCAP показує SVE)
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#define RPCSX_SVE_KERNELS 1
+#define RPCSX_SVE_TARGET
+#elif defined(__clang__) && __clang_major__ >= 18 && __has_include(<arm_sve.h>)
 #include <arm_sve.h>
+#define RPCSX_SVE_KERNELS 1
+#define RPCSX_SVE_TARGET __attribute__((target("sve2")))
+#endif
 #endif
+
+#ifndef PR_SVE_GET_VL
+#define PR_SVE_GET_VL 51
+#endif
+#ifndef PR_SVE_VL_LEN_MASK
+#define PR_SVE_VL_LEN_MASK 0xffff
 #endif
 
 #define LOG_TAG "RPCSX-SVE2"
@@ -88,8 +107,10 @@ SVE2Capabilities DetectCapabilities() {
         caps.vector_length_bits = svcntb() * 8; // bytes to bits
         caps.num_predicates = 16;
 #else
-        // Fallback: припускаємо 128 біт (Cortex-X2/X3)
-        caps.vector_length_bits = 128;
+        // Модуль без SVE: довжину повідомляє ядро ОС
+        const int vl = prctl(PR_SVE_GET_VL, 0, 0, 0, 0);
+        caps.vector_length_bits = vl > 0 ? (vl & PR_SVE_VL_LEN_MASK) * 8 : 128;
+        caps.num_predicates = 16;
 #endif
     }
     
@@ -141,6 +162,630 @@ SVE2Capabilities DetectCapabilities() {
     return caps;
 }
 
+// =============================================================================
+// Диспетчеризація ядер
+// =============================================================================
+
+// Вибір робиться один раз при ініціалізації: на різних SoC SVE/NEON/скалярний
+// варіант можуть поводитись по-різному, тому перевіряється коректність і
+// швидкість кожного доступного варіанту, а виклики йдуть через таблицю
+
+using MemcpyFn = void* (*)(void*, const void*, size_t);
+using SwizzleFn = void (*)(uint8_t*, const uint8_t*, uint32_t, uint32_t, uint32_t);
+using VertexFn = void (*)(float*, const float*, const float*, size_t, size_t);
+using MatVecFn = void (*)(float*, const float*, const float*, size_t);
+
+static constexpr size_t kKernelCount = static_cast<size_t>(Kernel::COUNT);
+static constexpr size_t kVariantCount = static_cast<size_t>(KernelVariant::COUNT);
+
+// --- MEMCPY ---
+
+static void* MemcpyScalar(void* dst, const void* src, size_t size) {
+    return memcpy(dst, src, size);
+}
+
+#ifdef __aarch64__
+static void* MemcpyNEON(void* dst, const void* src, size_t size) {
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+
+    size_t chunks = size / 64;
+    for (size_t i = 0; i < chunks; ++i) {
+        uint8x16x4_t data = vld1q_u8_x4(s + i * 64);
+        vst1q_u8_x4(d + i * 64, data);
+    }
+
+    // Залишок
+    size_t remainder = size - chunks * 64;
+    if (remainder > 0) {
+        memcpy(d + chunks * 64, s + chunks * 64, remainder);
+    }
+    return dst;
+}
+#endif
+
+#ifdef RPCSX_SVE_KERNELS
+RPCSX_SVE_TARGET static void* MemcpySVE(void* dst, const void* src, size_t size) {
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+
+    const size_t step = svcntb();
+    const svbool_t all = svptrue_b8();
+    size_t i = 0;
+
+    // Повні вектори без обчислення предикатів, хвіст - одним предикатом
+    for (; i + 2 * step <= size; i += 2 * step) {
+        svuint8_t a = svld1_u8(all, s + i);
+        svuint8_t b = svld1_u8(all, s + i + step);
+        svst1_u8(all, d + i, a);
+        svst1_u8(all, d + i + step, b);
+    }
+
+    for (; i < size; i += step) {
+        svbool_t pg = svwhilelt_b8_u64(i, size);
+        svst1_u8(pg, d + i, svld1_u8(pg, s + i));
+    }
+    return dst;
+}
+#endif
+
+// --- SWIZZLE_TEXTURE ---
+
+// RSX swizzle (Morton): біти x і y чергуються, починаючи з x, поки в меншого
+// виміру є біти. Зміщення texel = x_offset[x] | y_offset[y]
+static bool BuildSwizzleOffsets(uint32_t width, uint32_t height,
+                                std::vector<uint32_t>& x_offset,
+                                std::vector<uint32_t>& y_offset) {
+    if (width == 0 || height == 0 || (width & (width - 1)) || (height & (height - 1))) {
+        return false;
+    }
+
+    const uint32_t log_w = __builtin_ctz(width);
+    const uint32_t log_h = __builtin_ctz(height);
+
+    uint32_t x_bits[32] = {};
+    uint32_t y_bits[32] = {};
+    uint32_t out_bit = 0;
+    for (uint32_t bit = 0; bit < log_w || bit < log_h; ++bit) {
+        if (bit < log_w) x_bits[bit] = 1u << out_bit++;
+        if (bit < log_h) y_bits[bit] = 1u << out_bit++;
+    }
+
+    auto deposit = [](uint32_t value, const uint32_t* bits) {
+        uint32_t result = 0;
+        for (uint32_t bit = 0; value; ++bit, value >>= 1) {
+            if (value & 1) result |= bits[bit];
+        }
+        return result;
+    };
+
+    x_offset.resize(width);
+    y_offset.resize(height);
+    for (uint32_t x = 0; x < width; ++x) x_offset[x] = deposit(x, x_bits);
+    for (uint32_t y = 0; y < height; ++y) y_offset[y] = deposit(y, y_bits);
+    return true;
+}
+
+static void SwizzleScalar(uint8_t* dst, const uint8_t* src,
+                          uint32_t width, uint32_t height, uint32_t bpp) {
+    std::vector<uint32_t> x_offset, y_offset;
+    if (!BuildSwizzleOffsets(width, height, x_offset, y_offset)) {
+        // Не степінь двійки - RSX такі текстури не swizzle'ить
+        memcpy(dst, src, static_cast<size_t>(width) * height * bpp);
+        return;
+    }
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* row = src + static_cast<size_t>(y) * width * bpp;
+        for (uint32_t x = 0; x < width; ++x) {
+            memcpy(dst + static_cast<size_t>(x_offset[x] | y_offset[y]) * bpp,
+                   row + static_cast<size_t>(x) * bpp, bpp);
+        }
+    }
+}
+
+#ifdef __aarch64__
+static void SwizzleNEON(uint8_t* dst, const uint8_t* src,
+                        uint32_t width, uint32_t height, uint32_t bpp) {
+    std::vector<uint32_t> x_offset, y_offset;
+    if (bpp != 4 || width < 2 || height < 2 ||
+        !BuildSwizzleOffsets(width, height, x_offset, y_offset)) {
+        SwizzleScalar(dst, src, width, height, bpp);
+        return;
+    }
+
+    // Нижні біти swizzle - x0, y0: блок 2x2 лежить у dst суцільно (16 байт)
+    const uint32_t* s = reinterpret_cast<const uint32_t*>(src);
+    uint32_t* d = reinterpret_cast<uint32_t*>(dst);
+    for (uint32_t y = 0; y < height; y += 2) {
+        const uint32_t* row0 = s + static_cast<size_t>(y) * width;
+        const uint32_t* row1 = row0 + width;
+        for (uint32_t x = 0; x < width; x += 2) {
+            uint32x4_t block = vcombine_u32(vld1_u32(row0 + x), vld1_u32(row1 + x));
+            vst1q_u32(d + (x_offset[x] | y_offset[y]), block);
+        }
+    }
+}
+#endif
+
+// --- PROCESS_VERTEX_BUFFER ---
+
+static void VertexScalar(float* dst, const float* src,
+                         const float* transform_matrix,
+                         size_t vertex_count, size_t stride) {
+    size_t floats_per_vertex = stride / sizeof(float);
+
+    for (size_t i = 0; i < vertex_count; ++i) {
+        const float* v_in = src + i * floats_per_vertex;
+        float* v_out = dst + i * floats_per_vertex;
+
+        // Transform position (first 4 floats)
+        float pos[4] = {v_in[0], v_in[1], v_in[2], 1.0f};
+
+        for (int j = 0; j < 4; ++j) {
+            v_out[j] = transform_matrix[j] * pos[0] +
+                       transform_matrix[4 + j] * pos[1] +
+                       transform_matrix[8 + j] * pos[2] +
+                       transform_matrix[12 + j] * pos[3];
+        }
+
+        // Copy remaining attributes
+        for (size_t j = 4; j < floats_per_vertex; ++j) {
+            v_out[j] = v_in[j];
+        }
+    }
+}
+
+#ifdef __aarch64__
+static void VertexNEON(float* dst, const float* src,
+                       const float* transform_matrix,
+                       size_t vertex_count, size_t stride) {
+    const size_t floats_per_vertex = stride / sizeof(float);
+    const size_t extra = floats_per_vertex - 4;
+
+    float32x4_t m0 = vld1q_f32(transform_matrix);
+    float32x4_t m1 = vld1q_f32(transform_matrix + 4);
+    float32x4_t m2 = vld1q_f32(transform_matrix + 8);
+    float32x4_t m3 = vld1q_f32(transform_matrix + 12);
+
+    for (size_t i = 0; i < vertex_count; ++i) {
+        const float* v_in = src + i * floats_per_vertex;
+        float* v_out = dst + i * floats_per_vertex;
+
+        float32x4_t result = vfmaq_n_f32(m3, m0, v_in[0]);
+        result = vfmaq_n_f32(result, m1, v_in[1]);
+        result = vfmaq_n_f32(result, m2, v_in[2]);
+        vst1q_f32(v_out, result);
+
+        if (extra && v_out != v_in) {
+            memcpy(v_out + 4, v_in + 4, extra * sizeof(float));
+        }
+    }
+}
+#endif
+
+// --- BATCH_MATRIX_VECTOR_MUL ---
+
+static void MatVecScalar(float* dst, const float* matrices,
+                         const float* vectors, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float* mat = matrices + i * 16;
+        const float* vec = vectors + i * 4;
+        float* out = dst + i * 4;
+
+        for (int j = 0; j < 4; ++j) {
+            out[j] = mat[j] * vec[0] + mat[4+j] * vec[1] +
+                     mat[8+j] * vec[2] + mat[12+j] * vec[3];
+        }
+    }
+}
+
+#ifdef __aarch64__
+static void MatVecNEON(float* dst, const float* matrices,
+                       const float* vectors, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float* mat = matrices + i * 16;
+        const float* vec = vectors + i * 4;
+        float* out = dst + i * 4;
+
+        float32x4_t v = vld1q_f32(vec);
+        float32x4_t r0 = vld1q_f32(mat);
+        float32x4_t r1 = vld1q_f32(mat + 4);
+        float32x4_t r2 = vld1q_f32(mat + 8);
+        float32x4_t r3 = vld1q_f32(mat + 12);
+
+        float32x4_t result = vmulq_laneq_f32(r0, v, 0);
+        result = vfmaq_laneq_f32(result, r1, v, 1);
+        result = vfmaq_laneq_f32(result, r2, v, 2);
+        result = vfmaq_laneq_f32(result, r3, v, 3);
+
+        vst1q_f32(out, result);
+    }
+}
+#endif
+
+// --- Таблиця ---
+
+struct KernelImpls {
+    MemcpyFn memcpy_fn[kVariantCount];
+    SwizzleFn swizzle_fn[kVariantCount];
+    VertexFn vertex_fn[kVariantCount];
+    MatVecFn matvec_fn[kVariantCount];
+};
+
+// Усі скомпільовані реалізації; доступність на CPU перевіряється окремо
+static const KernelImpls kImpls = {
+    .memcpy_fn = {
+        MemcpyScalar,
+#ifdef __aarch64__
+        MemcpyNEON,
+#else
+        nullptr,
+#endif
+#ifdef RPCSX_SVE_KERNELS
+        MemcpySVE,
+#else
+        nullptr,
+#endif
+    },
+    .swizzle_fn = {
+        SwizzleScalar,
+#ifdef __aarch64__
+        SwizzleNEON,
+#else
+        nullptr,
+#endif
+        nullptr,
+    },
+    .vertex_fn = {
+        VertexScalar,
+#ifdef __aarch64__
+        VertexNEON,
+#else
+        nullptr,
+#endif
+        nullptr,
+    },
+    .matvec_fn = {
+        MatVecScalar,
+#ifdef __aarch64__
+        MatVecNEON,
+#else
+        nullptr,
+#endif
+        nullptr,
+    },
+};
+
+#ifdef __aarch64__
+static constexpr KernelVariant kDefaultVariant = KernelVariant::NEON;
+#else
+static constexpr KernelVariant kDefaultVariant = KernelVariant::SCALAR;
+#endif
+
+// Працює і до InitializeSVE2(): до вибору - базовий варіант платформи
+static std::atomic<MemcpyFn> g_memcpy_fn{kImpls.memcpy_fn[static_cast<size_t>(kDefaultVariant)]};
+static std::atomic<SwizzleFn> g_swizzle_fn{kImpls.swizzle_fn[static_cast<size_t>(kDefaultVariant)]};
+static std::atomic<VertexFn> g_vertex_fn{kImpls.vertex_fn[static_cast<size_t>(kDefaultVariant)]};
+static std::atomic<MatVecFn> g_matvec_fn{kImpls.matvec_fn[static_cast<size_t>(kDefaultVariant)]};
+static std::atomic<KernelVariant> g_kernel_variant[kKernelCount] = {
+    kDefaultVariant, kDefaultVariant, kDefaultVariant, kDefaultVariant};
+
+static const char* const kKernelNames[kKernelCount] = {
+    "memcpy", "swizzle_texture", "process_vertex_buffer", "batch_matrix_vector_mul"};
+static const char* const kVariantNames[kVariantCount] = {"scalar", "neon", "sve"};
+
+static bool IsVariantSupported(KernelVariant variant) {
+    switch (variant) {
+    case KernelVariant::SCALAR:
+        return true;
+    case KernelVariant::NEON:
+#ifdef __aarch64__
+        return true;
+#else
+        return false;
+#endif
+    case KernelVariant::SVE:
+        return !g_config.force_neon_fallback && g_config.enable_sve2 &&
+               (HasFeature(SVE2Feature::SVE2) || HasFeature(SVE2Feature::SVE));
+    default:
+        return false;
+    }
+}
+
+static bool HasImpl(Kernel kernel, KernelVariant variant) {
+    const size_t v = static_cast<size_t>(variant);
+    switch (kernel) {
+    case Kernel::MEMCPY: return kImpls.memcpy_fn[v] != nullptr;
+    case Kernel::SWIZZLE_TEXTURE: return kImpls.swizzle_fn[v] != nullptr;
+    case Kernel::PROCESS_VERTEX_BUFFER: return kImpls.vertex_fn[v] != nullptr;
+    case Kernel::BATCH_MATRIX_VECTOR_MUL: return kImpls.matvec_fn[v] != nullptr;
+    default: return false;
+    }
+}
+
+static void InstallVariant(Kernel kernel, KernelVariant variant) {
+    const size_t v = static_cast<size_t>(variant);
+    switch (kernel) {
+    case Kernel::MEMCPY: g_memcpy_fn.store(kImpls.memcpy_fn[v], std::memory_order_relaxed); break;
+    case Kernel::SWIZZLE_TEXTURE: g_swizzle_fn.store(kImpls.swizzle_fn[v], std::memory_order_relaxed); break;
+    case Kernel::PROCESS_VERTEX_BUFFER: g_vertex_fn.store(kImpls.vertex_fn[v], std::memory_order_relaxed); break;
+    case Kernel::BATCH_MATRIX_VECTOR_MUL: g_matvec_fn.store(kImpls.matvec_fn[v], std::memory_order_relaxed); break;
+    default: return;
+    }
+    g_kernel_variant[static_cast<size_t>(kernel)].store(variant, std::memory_order_relaxed);
+}
+
+// --- Self-test і мікробенч ---
+
+// Дані для перевірки: розміри з хвостами, щоб зачепити предикатні/скалярні гілки
+static constexpr size_t kTestCopySize = 64 * 1024 + 37;
+static constexpr uint32_t kTestTexSize = 128;
+static constexpr size_t kTestVertexCount = 2048 + 3;
+static constexpr size_t kTestVertexStride = 8 * sizeof(float);
+static constexpr size_t kTestMatrixCount = 1024 + 3;
+
+struct KernelTestData {
+    std::vector<uint8_t> bytes_src, bytes_dst, bytes_ref;
+    std::vector<float> floats_src, floats_dst, floats_ref;
+    std::vector<float> matrices;
+    float transform[16];
+
+    KernelTestData() {
+        uint32_t seed = 0x9E3779B9u;
+        auto next = [&seed] {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            return seed;
+        };
+        auto next_float = [&next] {
+            return static_cast<float>(next() % 2001) / 1000.0f - 1.0f;
+        };
+
+        bytes_src.resize(kTestCopySize);
+        for (auto& b : bytes_src) b = static_cast<uint8_t>(next());
+
+        floats_src.resize(kTestVertexCount * kTestVertexStride / sizeof(float));
+        for (auto& f : floats_src) f = next_float();
+
+        matrices.resize(kTestMatrixCount * 16);
+        for (auto& f : matrices) f = next_float();
+
+        for (auto& f : transform) f = next_float();
+    }
+};
+
+static bool FloatsMatch(const std::vector<float>& a, const std::vector<float>& b) {
+    // FMA і порядок додавань дають розбіжність в останніх бітах
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::fabs(a[i] - b[i]) > 1e-4f * std::max(1.0f, std::fabs(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool RunKernel(Kernel kernel, KernelVariant variant, KernelTestData& data, bool reference) {
+    const size_t v = static_cast<size_t>(variant);
+    auto& bytes_out = reference ? data.bytes_ref : data.bytes_dst;
+    auto& floats_out = reference ? data.floats_ref : data.floats_dst;
+
+    switch (kernel) {
+    case Kernel::MEMCPY:
+        bytes_out.assign(kTestCopySize, 0);
+        // Зсув на 1 байт - невирівняні адреси
+        kImpls.memcpy_fn[v](bytes_out.data() + 1, data.bytes_src.data() + 1, kTestCopySize - 1);
+        return true;
+    case Kernel::SWIZZLE_TEXTURE:
+        bytes_out.assign(kTestTexSize * kTestTexSize * 4, 0);
+        kImpls.swizzle_fn[v](bytes_out.data(), data.bytes_src.data(), kTestTexSize, kTestTexSize, 4);
+        return true;
+    case Kernel::PROCESS_VERTEX_BUFFER:
+        floats_out.assign(data.floats_src.size(), 0.0f);
+        kImpls.vertex_fn[v](floats_out.data(), data.floats_src.data(), data.transform,
+                            kTestVertexCount, kTestVertexStride);
+        return true;
+    case Kernel::BATCH_MATRIX_VECTOR_MUL:
+        floats_out.assign(kTestMatrixCount * 4, 0.0f);
+        kImpls.matvec_fn[v](floats_out.data(), data.matrices.data(), data.floats_src.data(),
+                            kTestMatrixCount);
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool SelfTest(Kernel kernel, KernelVariant variant, KernelTestData& data) {
+    if (!RunKernel(kernel, KernelVariant::SCALAR, data, true) ||
+        !RunKernel(kernel, variant, data, false)) {
+        return false;
+    }
+
+    if (kernel == Kernel::MEMCPY || kernel == Kernel::SWIZZLE_TEXTURE) {
+        return data.bytes_dst == data.bytes_ref;
+    }
+    return FloatsMatch(data.floats_dst, data.floats_ref);
+}
+
+// Найкращий час з кількох прогонів, нс
+static uint64_t Bench(Kernel kernel, KernelVariant variant, KernelTestData& data) {
+    constexpr int kRuns = 5;
+    constexpr int kRepeats = 8;
+
+    RunKernel(kernel, variant, data, false); // прогрів
+    uint64_t best = UINT64_MAX;
+    for (int run = 0; run < kRuns; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kRepeats; ++i) {
+            RunKernel(kernel, variant, data, false);
+        }
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        best = std::min<uint64_t>(best, static_cast<uint64_t>(ns));
+    }
+    return best;
+}
+
+// --- Кеш вибору ---
+
+// Підпис пристрою: MIDR усіх ядер (big.LITTLE) + довжина SVE вектора
+static std::string DeviceSignature() {
+    std::string signature = "vl" + std::to_string(g_capabilities.vector_length_bits);
+    for (int cpu = 0; cpu < 16; ++cpu) {
+        char path[96];
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%d/regs/identification/midr_el1", cpu);
+        FILE* f = fopen(path, "r");
+        if (!f) continue;
+        char midr[32] = {};
+        if (fgets(midr, sizeof(midr), f)) {
+            midr[strcspn(midr, "\r\n")] = '\0';
+            signature += ':';
+            signature += midr;
+        }
+        fclose(f);
+    }
+    return signature;
+}
+
+// Формат: "simd_dispatch 1 <підпис>", далі "<ядро> <варіант>"
+static bool LoadDispatchCache(const std::string& path, const std::string& signature,
+                              KernelVariant* variants) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return false;
+
+    char line[512];
+    bool valid = false;
+    size_t loaded = 0;
+    if (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        valid = ("simd_dispatch 1 " + signature) == line;
+    }
+
+    while (valid && fgets(line, sizeof(line), f)) {
+        char kernel_name[64] = {};
+        char variant_name[16] = {};
+        if (sscanf(line, "%63s %15s", kernel_name, variant_name) != 2) continue;
+
+        for (size_t k = 0; k < kKernelCount; ++k) {
+            if (strcmp(kernel_name, kKernelNames[k]) != 0) continue;
+            for (size_t v = 0; v < kVariantCount; ++v) {
+                if (strcmp(variant_name, kVariantNames[v]) == 0) {
+                    variants[k] = static_cast<KernelVariant>(v);
+                    ++loaded;
+                }
+            }
+        }
+    }
+
+    fclose(f);
+    return valid && loaded == kKernelCount;
+}
+
+static void SaveDispatchCache(const std::string& path, const std::string& signature,
+                              const KernelVariant* variants) {
+    const std::string tmp = path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) return;
+
+    fprintf(f, "simd_dispatch 1 %s\n", signature.c_str());
+    for (size_t k = 0; k < kKernelCount; ++k) {
+        fprintf(f, "%s %s\n", kKernelNames[k], kVariantNames[static_cast<size_t>(variants[k])]);
+    }
+
+    if (fclose(f) == 0) {
+        rename(tmp.c_str(), path.c_str());
+    } else {
+        remove(tmp.c_str());
+    }
+}
+
+// Викликається з InitializeSVE2() під g_mutex
+static void ResolveKernels() {
+    KernelTestData data;
+    KernelVariant cached[kKernelCount];
+    const std::string signature = g_config.dispatch_cache_path.empty() ? "" : DeviceSignature();
+    const bool have_cache = !signature.empty() &&
+        LoadDispatchCache(g_config.dispatch_cache_path, signature, cached);
+
+    KernelVariant chosen[kKernelCount];
+    bool benched = false;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t k = 0; k < kKernelCount; ++k) {
+        const Kernel kernel = static_cast<Kernel>(k);
+
+        // Збережений вибір лише перевіряється, а не міряється наново
+        if (have_cache && IsVariantSupported(cached[k]) && HasImpl(kernel, cached[k]) &&
+            SelfTest(kernel, cached[k], data)) {
+            chosen[k] = cached[k];
+            InstallVariant(kernel, chosen[k]);
+            continue;
+        }
+
+        benched = true;
+        KernelVariant best = KernelVariant::SCALAR;
+        uint64_t best_ns = Bench(kernel, best, data);
+
+        // Варіанти від простішого: складніший має бути помітно (5%) швидшим
+        for (size_t v = 1; v < kVariantCount; ++v) {
+            const KernelVariant variant = static_cast<KernelVariant>(v);
+            if (!IsVariantSupported(variant) || !HasImpl(kernel, variant)) continue;
+
+            if (!SelfTest(kernel, variant, data)) {
+                LOGW("SIMD dispatch: %s/%s failed self-test", kKernelNames[k], kVariantNames[v]);
+                continue;
+            }
+
+            const uint64_t ns = Bench(kernel, variant, data);
+            if (ns * 100 < best_ns * 95) {
+                best = variant;
+                best_ns = ns;
+            }
+        }
+
+        chosen[k] = best;
+        InstallVariant(kernel, best);
+    }
+
+    if (benched && !signature.empty()) {
+        SaveDispatchCache(g_config.dispatch_cache_path, signature, chosen);
+    }
+
+    LOGI("SIMD dispatch (%s, %.1f ms): memcpy=%s swizzle=%s vertex=%s matvec=%s",
+         benched ? "benchmarked" : "cached",
+         std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count(),
+         kVariantNames[static_cast<size_t>(chosen[0])], kVariantNames[static_cast<size_t>(chosen[1])],
+         kVariantNames[static_cast<size_t>(chosen[2])], kVariantNames[static_cast<size_t>(chosen[3])]);
+}
+
+KernelVariant GetKernelVariant(Kernel kernel) {
+    if (kernel >= Kernel::COUNT) return KernelVariant::SCALAR;
+    return g_kernel_variant[static_cast<size_t>(kernel)].load(std::memory_order_relaxed);
+}
+
+bool ForceKernelVariant(Kernel kernel, KernelVariant variant) {
+    if (kernel >= Kernel::COUNT || variant >= KernelVariant::COUNT) return false;
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!IsVariantSupported(variant) || !HasImpl(kernel, variant)) return false;
+
+    KernelTestData data;
+    if (!SelfTest(kernel, variant, data)) return false;
+
+    InstallVariant(kernel, variant);
+    return true;
+}
+
+const char* GetKernelName(Kernel kernel) {
+    return kernel < Kernel::COUNT ? kKernelNames[static_cast<size_t>(kernel)] : "unknown";
+}
+
+const char* GetKernelVariantName(KernelVariant variant) {
+    return variant < KernelVariant::COUNT ? kVariantNames[static_cast<size_t>(variant)] : "unknown";
+}
+
 // =============================================================================
 // Ініціалізація
 // =============================================================================
@@ -171,6 +816,8 @@ bool InitializeSVE2(const SVE2Config& config) {
     g_vector_length.store(config.vector_length > 0 ? 
                           config.vector_length : 
                           g_capabilities.vector_length_bits);
+
+    ResolveKernels();
     
     LOGI("╔════════════════════════════════════════════════════════════╗");
     LOGI("║         ARM SVE2 Optimizations Engine                      ║");
@@ -229,49 +876,20 @@ bool HasFeature(SVE2Feature feature) {
 
 void* OptimizedMemcpy(void* dst, const void* src, size_t size) {
     if (!dst || !src || size == 0) return dst;
-    
-#ifdef __aarch64__
-    if (g_sve2_active.load() && size >= 64) {
-        // SVE2 оптимізоване копіювання
-        uint8_t* d = static_cast<uint8_t*>(dst);
-        const uint8_t* s = static_cast<const uint8_t*>(src);
-        
-#if defined(__ARM_FEATURE_SVE)
-        // SVE version з predicates
-        size_t remaining = size;
-        while (remaining > 0) {
-            svbool_t pg = svwhilelt_b8(size - remaining, size);
-            svuint8_t data = svld1_u8(pg, s);
-            svst1_u8(pg, d, data);
-            
-            size_t step = svcntb();
-            d += step;
-            s += step;
-            remaining = (remaining > step) ? remaining - step : 0;
-        }
+
+    if (size < 64) {
+        g_stats.neon_fallback_ops++;
+        return memcpy(dst, src, size);
+    }
+
+    const KernelVariant variant = g_kernel_variant[static_cast<size_t>(Kernel::MEMCPY)].load(std::memory_order_relaxed);
+    if (variant == KernelVariant::SVE) {
         g_stats.sve2_ops_executed++;
-#else
-        // NEON fallback для великих блоків
-        size_t chunks = size / 64;
-        for (size_t i = 0; i < chunks; ++i) {
-            uint8x16x4_t data = vld1q_u8_x4(s + i * 64);
-            vst1q_u8_x4(d + i * 64, data);
-        }
-        // Залишок
-        size_t remainder = size - chunks * 64;
-        if (remainder > 0) {
-            memcpy(d + chunks * 64, s + chunks * 64, remainder);
-        }
+    } else {
         g_stats.neon_fallback_ops++;
-#endif
-        g_stats.vectorized_memcpy_bytes += size;
-        return dst;
     }
-#endif
-    
-    // Standard fallback
-    g_stats.neon_fallback_ops++;
-    return memcpy(dst, src, size);
+    g_stats.vectorized_memcpy_bytes += size;
+    return g_memcpy_fn.load(std::memory_order_relaxed)(dst, src, size);
 }
 
 void* OptimizedMemset(void* dst, int value, size_t size) {
@@ -517,32 +1135,7 @@ void Matrix4x4Multiply(float* dst, const float* a, const float* b) {
 
 void BatchMatrixVectorMul(float* dst, const float* matrices,
                           const float* vectors, size_t count) {
-    for (size_t i = 0; i < count; ++i) {
-        const float* mat = matrices + i * 16;
-        const float* vec = vectors + i * 4;
-        float* out = dst + i * 4;
-        
-#ifdef __aarch64__
-        float32x4_t v = vld1q_f32(vec);
-        float32x4_t r0 = vld1q_f32(mat);
-        float32x4_t r1 = vld1q_f32(mat + 4);
-        float32x4_t r2 = vld1q_f32(mat + 8);
-        float32x4_t r3 = vld1q_f32(mat + 12);
-        
-        float32x4_t result = vmulq_laneq_f32(r0, v, 0);
-        result = vfmaq_laneq_f32(result, r1, v, 1);
-        result = vfmaq_laneq_f32(result, r2, v, 2);
-        result = vfmaq_laneq_f32(result, r3, v, 3);
-        
-        vst1q_f32(out, result);
-#else
-        for (int j = 0; j < 4; ++j) {
-            out[j] = mat[j] * vec[0] + mat[4+j] * vec[1] + 
-                     mat[8+j] * vec[2] + mat[12+j] * vec[3];
-        }
-#endif
-    }
-    
+    g_matvec_fn.load(std::memory_order_relaxed)(dst, matrices, vectors, count);
     g_stats.matrix_ops_executed += count;
 }
 
@@ -616,9 +1209,7 @@ void SPUCompareGreater(uint32_t* dst, const float* a,
 
 void SwizzleTexture(uint8_t* dst, const uint8_t* src,
                     uint32_t width, uint32_t height, uint32_t bpp) {
-    // Morton code swizzle for RSX textures
-    // TODO: Implement full swizzle
-    memcpy(dst, src, width * height * bpp);
+    g_swizzle_fn.load(std::memory_order_relaxed)(dst, src, width, height, bpp);
 }
 
 void DeswizzleTexture(uint8_t* dst, const uint8_t* src,
@@ -641,27 +1232,12 @@ void ConvertColorFormat(uint8_t* dst, const uint8_t* src,
 void ProcessVertexBuffer(float* dst, const float* src,
                          const float* transform_matrix,
                          size_t vertex_count, size_t stride) {
-    size_t floats_per_vertex = stride / sizeof(float);
-    
-    for (size_t i = 0; i < vertex_count; ++i) {
-        const float* v_in = src + i * floats_per_vertex;
-        float* v_out = dst + i * floats_per_vertex;
-        
-        // Transform position (first 4 floats)
-        float pos[4] = {v_in[0], v_in[1], v_in[2], 1.0f};
-        
-        for (int j = 0; j < 4; ++j) {
-            v_out[j] = transform_matrix[j] * pos[0] +
-                       transform_matrix[4 + j] * pos[1] +
-                       transform_matrix[8 + j] * pos[2] +
-                       transform_matrix[12 + j] * pos[3];
-        }
-        
-        // Copy remaining attributes
-        for (size_t j = 4; j < floats_per_vertex; ++j) {
-            v_out[j] = v_in[j];
-        }
+    if (stride < 4 * sizeof(float)) {
+        // Позиція не вміщається у вершину - лише скалярний шлях
+        VertexScalar(dst, src, transform_matrix, vertex_count, stride);
+        return;
     }
+    g_vertex_fn.load(std::memory_order_relaxed)(dst, src, transform_matrix, vertex_count, stride);
 }
 
 } // namespace rpcsx::sve2
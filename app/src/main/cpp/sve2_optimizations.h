@@ -10,6 +10,8 @@
  * - Vectorized memory copy/fill
  * - Паралельна обробка SPU даних
  * - Оптимізація для 128/256/512-bit векторів
+ * - Вибір реалізації ядер при старті (self-test + мікробенч), без
+ *   перевірок можливостей у кожному виклику
  */
 
 #ifndef RPCSX_SVE2_OPTIMIZATIONS_H
@@ -18,6 +20,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <atomic>
+#include <string>
 
 namespace rpcsx::sve2 {
 
@@ -57,6 +60,29 @@ struct SVE2Config {
     uint32_t vector_length = 0;        // 0 = автодетекція (128/256/512 біт)
     bool enable_prefetch = true;       // Увімкнути SVE prefetch
     bool enable_gather_scatter = true; // Увімкнути gather/scatter операції
+    std::string dispatch_cache_path;   // Збережений вибір варіантів ядер ("" = мікробенч щоразу)
+};
+
+/**
+ * Ядра з кількома реалізаціями, що обираються при InitializeSVE2()
+ */
+enum class Kernel : uint32_t {
+    MEMCPY,
+    SWIZZLE_TEXTURE,
+    PROCESS_VERTEX_BUFFER,
+    BATCH_MATRIX_VECTOR_MUL,
+    COUNT
+};
+
+/**
+ * Варіанти реалізації. SVE - vector-length-agnostic: один код для
+ * 128/256/512-bit, довжина береться з svcntb() під час виконання
+ */
+enum class KernelVariant : uint32_t {
+    SCALAR,
+    NEON,
+    SVE,
+    COUNT
 };
 
 /**
@@ -121,6 +147,20 @@ SVE2Capabilities GetCapabilities();
  */
 bool HasFeature(SVE2Feature feature);
 
+/**
+ * Поточний варіант ядра
+ */
+KernelVariant GetKernelVariant(Kernel kernel);
+
+/**
+ * Примусовий вибір варіанту (бенчмарки, діагностика).
+ * false - варіант недоступний на цьому CPU або не пройшов self-test
+ */
+bool ForceKernelVariant(Kernel kernel, KernelVariant variant);
+
+const char* GetKernelName(Kernel kernel);
+const char* GetKernelVariantName(KernelVariant variant);
+
 // =============================================================================
 // Оптимізовані операції пам'яті
 // =============================================================================
@@ -264,7 +304,8 @@ void GetStats(SVE2Stats* stats);
 void ResetStats();
 
 /**
- * Встановлення довжини вектора (0 = авто)
+ * Встановлення довжини вектора (0 = авто). Лише для звітності -
+ * ядра не залежать від цього значення
  */
 void SetVectorLength(uint32_t bits);
 
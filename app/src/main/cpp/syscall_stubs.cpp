@@ -6,6 +6,9 @@
 #include <android/log.h>
 #include <unordered_map>
 #include <mutex>
+#include <array>
+#include <memory>
+#include <cstring>
 #include <sstream>
 #include <algorithm>
 #include <ctime>
@@ -161,6 +164,99 @@ static const SyscallDef SYSCALL_DEFS[] = {
     {0, nullptr, SyscallCategory::UNKNOWN, false, StubBehavior::RETURN_ERROR, 0}
 };
 
+// =============================================================================
+// Dispatch Table
+// =============================================================================
+
+// Номери PS3 syscalls < 1024; останній запис - fallback для номерів поза таблицею
+constexpr uint32_t kDispatchTableSize = 1024;
+constexpr uint32_t kFallbackSlot = kDispatchTableSize;
+
+// Лічильники одного потоку: пише лише власник, тож relaxed load+store без RMW
+struct alignas(64) ThreadCounters {
+    std::array<std::atomic<uint64_t>, kDispatchTableSize + 1> calls{};
+    std::atomic<uint64_t> implemented{0};
+    std::atomic<uint64_t> stubbed{0};
+};
+
+static inline void Bump(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+struct DispatchEntry;
+using DispatchFn = bool (*)(const DispatchEntry& entry, ThreadCounters& counters,
+                            uint32_t num, uint64_t* args, uint64_t* result);
+
+struct DispatchEntry {
+    DispatchFn fn;
+    uint64_t value;                     // Результат stub
+    const SyscallHandler* handler;      // Кастомний хандлер
+    const char* name;                   // nullptr - syscall невідомий базі
+};
+
+struct DispatchTable {
+    std::array<DispatchEntry, kDispatchTableSize + 1> entries;
+    std::vector<std::shared_ptr<const SyscallHandler>> handlers;  // Тримає хандлери живими
+    std::string title_id;
+};
+
+static void LogStub(const DispatchEntry& entry, uint32_t num, const uint64_t* args) {
+    if (entry.name) {
+        LOGW("STUB: %s (syscall %u) - args: %llx %llx %llx %llx",
+             entry.name, num,
+             (unsigned long long)args[0], (unsigned long long)args[1],
+             (unsigned long long)args[2], (unsigned long long)args[3]);
+    } else {
+        LOGW("STUB: Unknown syscall %u - args: %llx %llx %llx %llx",
+             num,
+             (unsigned long long)args[0], (unsigned long long)args[1],
+             (unsigned long long)args[2], (unsigned long long)args[3]);
+    }
+}
+
+// Реалізовано - передаємо далі
+static bool ForwardEntry(const DispatchEntry&, ThreadCounters& counters,
+                         uint32_t, uint64_t*, uint64_t*) {
+    Bump(counters.implemented);
+    return false;
+}
+
+// Stub з константою - шлях для ігор, що крутяться на нереалізованому syscall
+static bool ConstantEntry(const DispatchEntry& entry, ThreadCounters& counters,
+                          uint32_t, uint64_t*, uint64_t* result) {
+    Bump(counters.stubbed);
+    *result = entry.value;
+    return true;
+}
+
+static bool LoggedConstantEntry(const DispatchEntry& entry, ThreadCounters& counters,
+                                uint32_t num, uint64_t* args, uint64_t* result) {
+    LogStub(entry, num, args);
+    return ConstantEntry(entry, counters, num, args, result);
+}
+
+// LOG_ONLY: поведінка не змінюється
+static bool PassEntry(const DispatchEntry&, ThreadCounters& counters,
+                      uint32_t, uint64_t*, uint64_t*) {
+    Bump(counters.stubbed);
+    return false;
+}
+
+static bool LoggedPassEntry(const DispatchEntry& entry, ThreadCounters& counters,
+                            uint32_t num, uint64_t* args, uint64_t* result) {
+    LogStub(entry, num, args);
+    return PassEntry(entry, counters, num, args, result);
+}
+
+static bool CrashEntry(const DispatchEntry&, ThreadCounters&,
+                       uint32_t num, uint64_t*, uint64_t*) {
+    LOGE("CRITICAL: Syscall %u requires implementation!", num);
+    abort();
+}
+
+static bool HandlerEntry(const DispatchEntry& entry, ThreadCounters&,
+                         uint32_t num, uint64_t* args, uint64_t* result);
+
 // =============================================================================
 // Internal System
 // =============================================================================
@@ -170,25 +266,40 @@ public:
     StubConfig config;
     
     std::unordered_map<uint32_t, SyscallInfo> syscall_db;
-    std::unordered_map<uint32_t, SyscallHandler> custom_handlers;
+    std::unordered_map<uint32_t, std::shared_ptr<const SyscallHandler>> custom_handlers;
     std::unordered_map<std::string, std::vector<GameSyscallOverride>> game_overrides;
-    
-    SyscallStats stats = {};
-    std::mutex stats_mutex;
-    std::mutex handler_mutex;
-    
-    const char* current_title_id = nullptr;
+    std::string current_title_id;
+    
+    // Таблиця перебудовується під config_mutex при кожній зміні; HandleSyscall
+    // бере лише atomic вказівник. Старі таблиці не звільняються до
+    // Initialize - потік міг ще не вийти з виклику через них
+    std::mutex config_mutex;
+    std::atomic<const DispatchTable*> table{nullptr};
+    std::vector<std::unique_ptr<DispatchTable>> tables;
+    
+    // Блоки лічильників не звільняються після виходу потоку - статистика
+    // сумується за всю сесію; reset зсуває базу, а не пише в чужі блоки
+    std::mutex counters_mutex;
+    std::vector<std::unique_ptr<ThreadCounters>> thread_counters;
+    std::vector<uint64_t> call_baseline = std::vector<uint64_t>(kDispatchTableSize + 1);
+    uint64_t implemented_baseline = 0;
+    uint64_t stubbed_baseline = 0;
     
     bool Initialize(const StubConfig& cfg) {
+        std::lock_guard<std::mutex> lock(config_mutex);
         config = cfg;
-        stats = {};
         
         // Завантажуємо базу syscalls
+        syscall_db.clear();
         LoadSyscallDatabase();
         
+        table.store(nullptr, std::memory_order_release);
+        tables.clear();
+        RebuildTableLocked();
+        
+        ResetCounters();
+        
         g_stubs_active.store(true);
-        g_total_syscalls.store(0);
-        g_stubbed_syscalls.store(0);
         
         LOGI("╔════════════════════════════════════════════════════════════╗");
         LOGI("║          PS3 Syscall Stubbing System                       ║");
@@ -204,9 +315,10 @@ public:
     void Shutdown() {
         g_stubs_active.store(false);
         
+        const CallCounts counts = CollectCounts();
         LOGI("Syscall Stubs shutdown. Total: %llu, Stubbed: %llu",
-             (unsigned long long)g_total_syscalls.load(),
-             (unsigned long long)g_stubbed_syscalls.load());
+             (unsigned long long)counts.total,
+             (unsigned long long)counts.stubbed);
     }
     
     void LoadSyscallDatabase() {
@@ -227,114 +339,178 @@ public:
         }
     }
     
-    bool HandleSyscallInternal(uint32_t num, uint64_t* args, uint64_t* result) {
-        g_total_syscalls++;
-        stats.total_calls++;
-        
-        // Шукаємо в базі
-        auto it = syscall_db.find(num);
-        SyscallInfo* info = (it != syscall_db.end()) ? &it->second : nullptr;
+    // =========================================================================
+    // Побудова таблиці
+    // =========================================================================
+    
+    DispatchEntry BuildEntry(const SyscallInfo* info, const GameSyscallOverride* override,
+                             const SyscallHandler* handler) const {
+        DispatchEntry entry = {};
+        entry.name = info ? info->name.c_str() : nullptr;
         
-        if (info) {
-            info->call_count++;
+        if (handler) {
+            entry.fn = HandlerEntry;
+            entry.handler = handler;
+            return entry;
         }
         
-        // Перевіряємо game override
+        // Override гри важливіший за поведінку з бази
         StubBehavior behavior = config.default_behavior;
         int32_t return_value = config.default_error_code;
         
-        if (current_title_id) {
-            auto git = game_overrides.find(current_title_id);
-            if (git != game_overrides.end()) {
-                for (const auto& override : git->second) {
-                    if (override.syscall_number == num) {
-                        behavior = override.behavior;
-                        return_value = override.custom_return;
-                        break;
-                    }
-                }
-            }
-        }
-        
-        if (info) {
-            if (info->default_behavior != StubBehavior::FORWARD) {
-                behavior = info->default_behavior;
-                return_value = info->default_return;
-            }
-        }
-        
-        // Перевіряємо custom handler
-        {
-            std::lock_guard<std::mutex> lock(handler_mutex);
-            auto hit = custom_handlers.find(num);
-            if (hit != custom_handlers.end()) {
-                SyscallContext ctx;
-                ctx.syscall_num = num;
-                memcpy(ctx.args, args, sizeof(ctx.args));
-                ctx.result = result;
-                ctx.title_id = current_title_id;
-                
-                *result = hit->second(ctx);
-                return true;
-            }
-        }
-        
-        // Якщо реалізовано - не обробляємо
-        if (info && info->is_implemented && behavior == StubBehavior::FORWARD) {
-            stats.implemented_calls++;
-            return false;
+        if (override) {
+            behavior = override->behavior;
+            return_value = override->custom_return;
+        } else if (info) {
+            behavior = info->default_behavior;
+            return_value = info->default_return;
         }
         
-        // Обробляємо як stub
-        g_stubbed_syscalls++;
-        stats.stubbed_calls++;
-        
-        if (info && !info->is_implemented) {
-            stats.unimplemented_used++;
+        if (behavior == StubBehavior::FORWARD && info && info->is_implemented) {
+            entry.fn = ForwardEntry;
+            return entry;
         }
         
-        // Логування
-        if (info && info->log_calls) {
-            LOGW("STUB: %s (syscall %u) - args: %llx %llx %llx %llx",
-                 info->name.c_str(), num,
-                 (unsigned long long)args[0], (unsigned long long)args[1],
-                 (unsigned long long)args[2], (unsigned long long)args[3]);
-        } else if (!info && config.log_unimplemented) {
-            LOGW("STUB: Unknown syscall %u - args: %llx %llx %llx %llx",
-                 num,
-                 (unsigned long long)args[0], (unsigned long long)args[1],
-                 (unsigned long long)args[2], (unsigned long long)args[3]);
-        }
+        const bool log = info ? info->log_calls : config.log_unimplemented;
         
-        // Застосовуємо behavior
         switch (behavior) {
             case StubBehavior::RETURN_SUCCESS:
-                *result = ps3_error::CELL_OK;
+            case StubBehavior::SKIP:
+                entry.value = static_cast<uint64_t>(ps3_error::CELL_OK);
                 break;
                 
             case StubBehavior::RETURN_ERROR:
             case StubBehavior::RETURN_CUSTOM:
-                *result = return_value;
+                entry.value = static_cast<uint64_t>(static_cast<int64_t>(return_value));
                 break;
                 
             case StubBehavior::LOG_ONLY:
-                return false; // Передаємо далі
+                entry.fn = log ? LoggedPassEntry : PassEntry;
+                return entry;
                 
             case StubBehavior::CRASH:
-                LOGE("CRITICAL: Syscall %u requires implementation!", num);
-                abort();
-                break;
-                
-            case StubBehavior::SKIP:
-                *result = 0;
-                break;
+                entry.fn = CrashEntry;
+                return entry;
                 
             default:
-                *result = ps3_error::CELL_ENOSYS;
+                entry.value = static_cast<uint64_t>(static_cast<int64_t>(ps3_error::CELL_ENOSYS));
                 break;
         }
         
-        return true;
+        entry.fn = log ? LoggedConstantEntry : ConstantEntry;
+        return entry;
+    }
+    
+    void RebuildTableLocked() {
+        auto next = std::make_unique<DispatchTable>();
+        next->title_id = current_title_id;
+        
+        const std::vector<GameSyscallOverride>* overrides = nullptr;
+        if (!current_title_id.empty()) {
+            auto it = game_overrides.find(current_title_id);
+            if (it != game_overrides.end()) {
+                overrides = &it->second;
+            }
+        }
+        
+        for (uint32_t num = 0; num < kDispatchTableSize; ++num) {
+            auto info_it = syscall_db.find(num);
+            const SyscallInfo* info = info_it != syscall_db.end() ? &info_it->second : nullptr;
+            
+            const GameSyscallOverride* override = nullptr;
+            if (overrides) {
+                for (const auto& o : *overrides) {
+                    if (o.syscall_number == num) {
+                        override = &o;
+                        break;
+                    }
+                }
+            }
+            
+            const SyscallHandler* handler = nullptr;
+            auto handler_it = custom_handlers.find(num);
+            if (handler_it != custom_handlers.end()) {
+                next->handlers.push_back(handler_it->second);
+                handler = handler_it->second.get();
+            }
+            
+            next->entries[num] = BuildEntry(info, override, handler);
+        }
+        
+        // Номери поза таблицею невідомі базі - поведінка за замовчуванням
+        next->entries[kFallbackSlot] = BuildEntry(nullptr, nullptr, nullptr);
+        
+        table.store(next.get(), std::memory_order_release);
+        tables.push_back(std::move(next));
+    }
+    
+    // =========================================================================
+    // Лічильники
+    // =========================================================================
+    
+    static ThreadCounters& LocalCounters();
+    
+    ThreadCounters* RegisterThreadCounters() {
+        std::lock_guard<std::mutex> lock(counters_mutex);
+        thread_counters.push_back(std::make_unique<ThreadCounters>());
+        return thread_counters.back().get();
+    }
+    
+    struct CallCounts {
+        std::vector<uint64_t> calls = std::vector<uint64_t>(kDispatchTableSize + 1);
+        uint64_t total = 0;
+        uint64_t implemented = 0;
+        uint64_t stubbed = 0;
+    };
+    
+    CallCounts CollectCountsLocked() const {
+        CallCounts counts;
+        
+        for (const auto& block : thread_counters) {
+            for (size_t i = 0; i < counts.calls.size(); ++i) {
+                counts.calls[i] += block->calls[i].load(std::memory_order_relaxed);
+            }
+            counts.implemented += block->implemented.load(std::memory_order_relaxed);
+            counts.stubbed += block->stubbed.load(std::memory_order_relaxed);
+        }
+        
+        for (size_t i = 0; i < counts.calls.size(); ++i) {
+            counts.calls[i] -= call_baseline[i];
+            counts.total += counts.calls[i];
+        }
+        counts.implemented -= implemented_baseline;
+        counts.stubbed -= stubbed_baseline;
+        
+        // Знімок для експортованих глобальних лічильників
+        g_total_syscalls.store(counts.total, std::memory_order_relaxed);
+        g_stubbed_syscalls.store(counts.stubbed, std::memory_order_relaxed);
+        
+        return counts;
+    }
+    
+    CallCounts CollectCounts() {
+        std::lock_guard<std::mutex> lock(counters_mutex);
+        return CollectCountsLocked();
+    }
+    
+    void ResetCounters() {
+        std::lock_guard<std::mutex> lock(counters_mutex);
+        
+        std::fill(call_baseline.begin(), call_baseline.end(), 0);
+        implemented_baseline = 0;
+        stubbed_baseline = 0;
+        
+        const CallCounts counts = CollectCountsLocked();
+        call_baseline = counts.calls;
+        implemented_baseline = counts.implemented;
+        stubbed_baseline = counts.stubbed;
+        
+        g_total_syscalls.store(0);
+        g_stubbed_syscalls.store(0);
+    }
+    
+    static uint64_t CallCount(const CallCounts& counts, uint32_t num) {
+        return num < kDispatchTableSize ? counts.calls[num] : 0;
     }
     
     const char* GetBehaviorName(StubBehavior b) {
@@ -354,6 +530,26 @@ public:
 
 static SyscallStubSystem g_system;
 
+ThreadCounters& SyscallStubSystem::LocalCounters() {
+    thread_local ThreadCounters* counters = g_system.RegisterThreadCounters();
+    return *counters;
+}
+
+static bool HandlerEntry(const DispatchEntry& entry, ThreadCounters&,
+                         uint32_t num, uint64_t* args, uint64_t* result) {
+    const DispatchTable* table = g_system.table.load(std::memory_order_relaxed);
+    
+    SyscallContext ctx;
+    ctx.syscall_num = num;
+    memcpy(ctx.args, args, sizeof(ctx.args));
+    ctx.result = result;
+    ctx.thread_context = nullptr;
+    ctx.title_id = table && !table->title_id.empty() ? table->title_id.c_str() : nullptr;
+    
+    *result = (*entry.handler)(ctx);
+    return true;
+}
+
 // =============================================================================
 // API Implementation
 // =============================================================================
@@ -370,38 +566,65 @@ bool IsStubSystemActive() {
     return g_stubs_active.load();
 }
 
+void SetSyscallTitle(const char* title_id) {
+    std::lock_guard<std::mutex> lock(g_system.config_mutex);
+    g_system.current_title_id = title_id ? title_id : "";
+    g_system.RebuildTableLocked();
+}
+
 bool HandleSyscall(uint32_t syscall_num, uint64_t* args, uint64_t* result) {
-    if (!g_stubs_active.load()) return false;
-    return g_system.HandleSyscallInternal(syscall_num, args, result);
+    if (!g_stubs_active.load(std::memory_order_relaxed)) return false;
+    
+    const DispatchTable* table = g_system.table.load(std::memory_order_acquire);
+    if (!table) return false;
+    
+    const uint32_t slot = syscall_num < kDispatchTableSize ? syscall_num : kFallbackSlot;
+    ThreadCounters& counters = SyscallStubSystem::LocalCounters();
+    Bump(counters.calls[slot]);
+    
+    const DispatchEntry& entry = table->entries[slot];
+    return entry.fn(entry, counters, syscall_num, args, result);
 }
 
 bool GetSyscallInfo(uint32_t syscall_num, SyscallInfo* info) {
     if (!info) return false;
     
-    auto it = g_system.syscall_db.find(syscall_num);
-    if (it == g_system.syscall_db.end()) return false;
+    {
+        std::lock_guard<std::mutex> lock(g_system.config_mutex);
+        auto it = g_system.syscall_db.find(syscall_num);
+        if (it == g_system.syscall_db.end()) return false;
+        
+        *info = it->second;
+    }
     
-    *info = it->second;
+    info->call_count = SyscallStubSystem::CallCount(g_system.CollectCounts(), syscall_num);
     return true;
 }
 
 bool RegisterSyscallHandler(uint32_t syscall_num, SyscallHandler handler) {
-    std::lock_guard<std::mutex> lock(g_system.handler_mutex);
-    g_system.custom_handlers[syscall_num] = std::move(handler);
+    std::lock_guard<std::mutex> lock(g_system.config_mutex);
+    g_system.custom_handlers[syscall_num] =
+        std::make_shared<const SyscallHandler>(std::move(handler));
+    g_system.RebuildTableLocked();
     return true;
 }
 
 bool UnregisterSyscallHandler(uint32_t syscall_num) {
-    std::lock_guard<std::mutex> lock(g_system.handler_mutex);
-    return g_system.custom_handlers.erase(syscall_num) > 0;
+    std::lock_guard<std::mutex> lock(g_system.config_mutex);
+    if (g_system.custom_handlers.erase(syscall_num) == 0) return false;
+    
+    g_system.RebuildTableLocked();
+    return true;
 }
 
 bool SetSyscallBehavior(uint32_t syscall_num, StubBehavior behavior, int32_t custom_return) {
+    std::lock_guard<std::mutex> lock(g_system.config_mutex);
     auto it = g_system.syscall_db.find(syscall_num);
     if (it == g_system.syscall_db.end()) return false;
     
     it->second.default_behavior = behavior;
     it->second.default_return = custom_return;
+    g_system.RebuildTableLocked();
     return true;
 }
 
@@ -415,13 +638,30 @@ bool SetGameSyscallOverride(const char* title_id, uint32_t syscall_num,
     override.behavior = behavior;
     override.custom_return = custom_return;
     
-    g_system.game_overrides[title_id].push_back(override);
+    std::lock_guard<std::mutex> lock(g_system.config_mutex);
+    auto& vec = g_system.game_overrides[title_id];
+    
+    // Повторний override того ж syscall замінює попередній
+    auto it = std::find_if(vec.begin(), vec.end(),
+        [syscall_num](const GameSyscallOverride& o) {
+            return o.syscall_number == syscall_num;
+        });
+    if (it != vec.end()) {
+        *it = override;
+    } else {
+        vec.push_back(override);
+    }
+    
+    if (g_system.current_title_id == title_id) {
+        g_system.RebuildTableLocked();
+    }
     return true;
 }
 
 bool RemoveGameSyscallOverride(const char* title_id, uint32_t syscall_num) {
     if (!title_id) return false;
     
+    std::lock_guard<std::mutex> lock(g_system.config_mutex);
     auto it = g_system.game_overrides.find(title_id);
     if (it == g_system.game_overrides.end()) return false;
     
@@ -431,6 +671,9 @@ bool RemoveGameSyscallOverride(const char* title_id, uint32_t syscall_num) {
             return o.syscall_number == syscall_num;
         }), vec.end());
     
+    if (g_system.current_title_id == title_id) {
+        g_system.RebuildTableLocked();
+    }
     return true;
 }
 
@@ -446,43 +689,55 @@ bool SaveSyscallOverrides(const char* filepath) {
 
 void GetSyscallStats(SyscallStats* stats) {
     if (stats) {
-        std::lock_guard<std::mutex> lock(g_system.stats_mutex);
-        *stats = g_system.stats;
+        const auto counts = g_system.CollectCounts();
+        
+        *stats = {};
+        stats->total_calls = counts.total;
+        stats->implemented_calls = counts.implemented;
+        stats->stubbed_calls = counts.stubbed;
         
         // Збираємо топ syscalls
         std::vector<std::pair<uint32_t, uint64_t>> all;
-        for (const auto& [num, info] : g_system.syscall_db) {
-            if (info.call_count > 0) {
-                all.emplace_back(num, info.call_count);
+        std::vector<std::pair<uint32_t, uint64_t>> unimplemented;
+        {
+            std::lock_guard<std::mutex> lock(g_system.config_mutex);
+            for (uint32_t num = 0; num < kDispatchTableSize; ++num) {
+                if (counts.calls[num] == 0) continue;
+                
+                all.emplace_back(num, counts.calls[num]);
+                
+                auto it = g_system.syscall_db.find(num);
+                if (it == g_system.syscall_db.end() || !it->second.is_implemented) {
+                    unimplemented.emplace_back(num, counts.calls[num]);
+                }
             }
         }
-        std::sort(all.begin(), all.end(),
-            [](const auto& a, const auto& b) { return a.second > b.second; });
         
-        stats->top_syscalls.clear();
-        for (size_t i = 0; i < std::min((size_t)10, all.size()); ++i) {
-            stats->top_syscalls.push_back(all[i]);
-        }
+        const auto by_calls = [](const auto& a, const auto& b) { return a.second > b.second; };
+        std::sort(all.begin(), all.end(), by_calls);
+        std::sort(unimplemented.begin(), unimplemented.end(), by_calls);
         
         stats->unique_syscalls_used = all.size();
+        stats->unimplemented_used = unimplemented.size();
+        
+        all.resize(std::min((size_t)10, all.size()));
+        unimplemented.resize(std::min((size_t)10, unimplemented.size()));
+        stats->top_syscalls = std::move(all);
+        stats->top_unimplemented = std::move(unimplemented);
     }
 }
 
 void ResetSyscallStats() {
-    std::lock_guard<std::mutex> lock(g_system.stats_mutex);
-    g_system.stats = {};
-    g_total_syscalls.store(0);
-    g_stubbed_syscalls.store(0);
-    
-    for (auto& [num, info] : g_system.syscall_db) {
-        info.call_count = 0;
-    }
+    g_system.ResetCounters();
 }
 
 size_t GetUnimplementedSyscalls(uint32_t* buffer, size_t buffer_size) {
+    const auto counts = g_system.CollectCounts();
+    
+    std::lock_guard<std::mutex> lock(g_system.config_mutex);
     size_t count = 0;
     for (const auto& [num, info] : g_system.syscall_db) {
-        if (!info.is_implemented && info.call_count > 0) {
+        if (!info.is_implemented && SyscallStubSystem::CallCount(counts, num) > 0) {
             if (count < buffer_size) {
                 buffer[count] = num;
             }
@@ -493,25 +748,31 @@ size_t GetUnimplementedSyscalls(uint32_t* buffer, size_t buffer_size) {
 }
 
 size_t ExportSyscallLogJson(char* buffer, size_t buffer_size) {
+    const auto counts = g_system.CollectCounts();
+    
     std::stringstream ss;
     ss << "{\n  \"syscalls\": [\n";
     
-    bool first = true;
-    for (const auto& [num, info] : g_system.syscall_db) {
-        if (info.call_count > 0) {
-            if (!first) ss << ",\n";
-            first = false;
-            ss << "    {\"num\": " << num
-               << ", \"name\": \"" << info.name << "\""
-               << ", \"calls\": " << info.call_count
-               << ", \"implemented\": " << (info.is_implemented ? "true" : "false")
-               << "}";
+    {
+        std::lock_guard<std::mutex> lock(g_system.config_mutex);
+        bool first = true;
+        for (const auto& [num, info] : g_system.syscall_db) {
+            const uint64_t calls = SyscallStubSystem::CallCount(counts, num);
+            if (calls > 0) {
+                if (!first) ss << ",\n";
+                first = false;
+                ss << "    {\"num\": " << num
+                   << ", \"name\": \"" << info.name << "\""
+                   << ", \"calls\": " << calls
+                   << ", \"implemented\": " << (info.is_implemented ? "true" : "false")
+                   << "}";
+            }
         }
     }
     
     ss << "\n  ],\n";
-    ss << "  \"total_calls\": " << g_total_syscalls.load() << ",\n";
-    ss << "  \"stubbed_calls\": " << g_stubbed_syscalls.load() << "\n";
+    ss << "  \"total_calls\": " << counts.total << ",\n";
+    ss << "  \"stubbed_calls\": " << counts.stubbed << "\n";
     ss << "}\n";
     
     std::string json = ss.str();
@@ -522,10 +783,12 @@ size_t ExportSyscallLogJson(char* buffer, size_t buffer_size) {
 }
 
 bool SetSyscallLogging(uint32_t syscall_num, bool enable) {
+    std::lock_guard<std::mutex> lock(g_system.config_mutex);
     auto it = g_system.syscall_db.find(syscall_num);
     if (it == g_system.syscall_db.end()) return false;
     
     it->second.log_calls = enable;
+    g_system.RebuildTableLocked();
     return true;
 }
 
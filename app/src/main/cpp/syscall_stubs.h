@@ -143,7 +143,7 @@ struct SyscallInfo {
     StubBehavior default_behavior;  // Поведінка за замовчуванням
     int32_t default_return;         // Значення за замовчуванням
     std::string description;        // Опис
-    uint64_t call_count;            // Лічильник викликів
+    uint64_t call_count;            // Лічильник викликів (заповнює GetSyscallInfo)
     bool log_calls;                 // Логувати виклики
 };
 
@@ -211,6 +211,8 @@ using SyscallHandler = std::function<int32_t(SyscallContext& ctx)>;
 // =============================================================================
 
 extern std::atomic<bool> g_stubs_active;
+
+// Знімки per-thread лічильників, оновлюються в GetSyscallStats/ExportSyscallLogJson
 extern std::atomic<uint64_t> g_total_syscalls;
 extern std::atomic<uint64_t> g_stubbed_syscalls;
 
@@ -234,7 +236,14 @@ void ShutdownSyscallStubs();
 bool IsStubSystemActive();
 
 /**
- * Обробка syscall
+ * Гра, для якої будується таблиця диспетчеризації (викликати після boot).
+ * Overrides гри запікаються в таблицю; nullptr - без overrides
+ */
+void SetSyscallTitle(const char* title_id);
+
+/**
+ * Обробка syscall: один запис плоскої таблиці без блокувань (прямий виклик
+ * хандлера або stub з готовою константою)
  * @param syscall_num Номер syscall
  * @param args Аргументи (r3-r10)
  * @param result Результат
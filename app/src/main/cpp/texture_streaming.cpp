@@ -4,7 +4,10 @@
 
 #include "texture_streaming.h"
 #include <android/log.h>
+#include <cstring>
+#include <vector>
 #include <unordered_map>
+#include <list>
 #include <queue>
 #include <mutex>
 #include <thread>
@@ -31,9 +34,11 @@ std::atomic<uint32_t> g_current_cache_size_mb{0};
 struct CachedTexture {
     TextureDescriptor descriptor;
     std::vector<uint8_t> data;
-    uint64_t last_access_time;
-    float distance_to_camera;
+    uint64_t last_access_time;          // Кадр останнього семплювання
+    uint64_t fine_use_time;             // Кадр, коли востаннє був потрібен wanted_mip
+    uint32_t wanted_mip;                // Residency за sampler feedback
     bool is_loading;
+    std::list<uint64_t>::iterator lru;  // Позиція в lru_order (front - найсвіжіша)
 };
 
 struct LoadRequest {
@@ -45,14 +50,21 @@ struct LoadRequest {
     }
 };
 
+// Максимальний зсув residency на всі текстури, коли семпловане за кадр
+// не влазить у бюджет (інакше кожен кадр: load -> evict -> load)
+static constexpr uint32_t kMaxPressureBias = 4;
+
 class TextureStreamingSystem {
 public:
     StreamingConfig config;
     StreamingStats stats;
     
     std::unordered_map<uint64_t, CachedTexture> texture_cache;
+    std::unordered_map<uint64_t, uint64_t> address_index;  // gpu_address -> id
+    std::list<uint64_t> lru_order;
     std::priority_queue<LoadRequest> load_queue;
     
+    // Порядок: cache_mutex -> queue_mutex
     std::mutex cache_mutex;
     std::mutex queue_mutex;
     std::condition_variable queue_cv;
@@ -62,14 +74,16 @@ public:
     
     uint64_t next_texture_id{1};
     uint64_t frame_time{0};
-    
-    float camera_x{0}, camera_y{0}, camera_z{0};
+    uint32_t pressure_bias{0};
+    uint32_t calm_frames{0};    // Кадрів поспіль нижче 75% бюджету
     
     TextureLoadCallback load_callback;
     
     bool Initialize(const StreamingConfig& cfg) {
         config = cfg;
         stats = {};
+        pressure_bias = 0;
+        calm_frames = 0;
         running = true;
         
         // Запуск робочих потоків
@@ -85,6 +99,7 @@ public:
         LOGI("║  Max Cache: %4u MB                                        ║", config.max_cache_size_mb);
         LOGI("║  Worker Threads: %u                                        ║", config.async_pool_size);
         LOGI("║  ASTC Compression: %-8s                              ║", config.use_astc_compression ? "Enabled" : "Disabled");
+        LOGI("║  Residency: RSX sampler feedback                           ║");
         LOGI("╚════════════════════════════════════════════════════════════╝");
         
         g_streaming_active.store(true);
@@ -105,6 +120,13 @@ public:
         {
             std::lock_guard<std::mutex> lock(cache_mutex);
             texture_cache.clear();
+            address_index.clear();
+            lru_order.clear();
+            stats.bytes_cached = 0;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            load_queue = {};
         }
         
         g_streaming_active.store(false);
@@ -117,20 +139,142 @@ public:
                              uint32_t mip_levels, uint32_t format,
                              const void* initial_data) {
         std::lock_guard<std::mutex> lock(cache_mutex);
+        return RegisterTextureLocked(width, height, mip_levels, format, 0, initial_data);
+    }
+    
+    void UnregisterTexture(uint64_t id) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        UnregisterTextureLocked(id);
+    }
+    
+    void RequestLoad(uint64_t id, float priority) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = texture_cache.find(id);
+        if (it == texture_cache.end()) {
+            return;
+        }
+        QueueLoadLocked(it->second, priority);
+    }
+    
+    void Update(const SampledTextureFeedback* feedback, size_t count) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        
+        frame_time++;
+        stats.textures_sampled = static_cast<uint32_t>(count);
+        
+        for (size_t i = 0; i < count; ++i) {
+            const SampledTextureFeedback& entry = feedback[i];
+            if (entry.mip_levels == 0) continue;
+            
+            CachedTexture& tex = FindOrRegisterLocked(entry);
+            tex.last_access_time = frame_time;
+            lru_order.splice(lru_order.begin(), lru_order, tex.lru);
+            
+            const uint32_t last_mip = tex.descriptor.mip_levels - 1;
+            const uint32_t wanted = std::min(last_mip, std::max<uint32_t>(
+                entry.finest_mip, GetTargetMipLevel(tex.descriptor)) + pressure_bias);
+            
+            // Детальніші рівні потрібні одразу, грубіші - лише після mip_trim_frames
+            // без потреби (об'єкт може знову наблизитись)
+            if (wanted <= tex.wanted_mip) {
+                tex.wanted_mip = wanted;
+                tex.fine_use_time = frame_time;
+            } else if (frame_time - tex.fine_use_time > config.mip_trim_frames) {
+                tex.wanted_mip = wanted;
+            }
+            
+            if (tex.descriptor.is_resident && tex.descriptor.current_mip <= tex.wanted_mip) {
+                stats.cache_hits++;
+            } else {
+                stats.cache_misses++;
+                
+                // Пріоритет = скільки рівнів бракує
+                const uint32_t have = tex.descriptor.is_resident ? tex.descriptor.current_mip
+                                                                 : tex.descriptor.mip_levels;
+                QueueLoadLocked(tex, 1.0f + static_cast<float>(have - tex.wanted_mip));
+            }
+        }
+        
+        EvictIfNeeded();
+        
+        // Оновлення статистики
+        if (stats.cache_hits + stats.cache_misses > 0) {
+            stats.cache_hit_ratio = static_cast<float>(stats.cache_hits) / 
+                                    (stats.cache_hits + stats.cache_misses);
+        }
+    }
+    
+    void SetMaxCacheSize(uint32_t size_mb) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        config.max_cache_size_mb = size_mb;
+        EvictIfNeeded();
+    }
+    
+    uint64_t Trim(uint64_t max_bytes) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        
+        const uint64_t before = stats.bytes_cached;
+        ReleaseUnused(max_bytes);
+        UpdateCacheSize();
+        return before - stats.bytes_cached;
+    }
+    
+    void GetUsage(uint64_t* used_bytes, uint64_t* reclaimable_bytes) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        
+        // Те, що ReleaseUnused(0) звільнив би зараз
+        uint64_t reclaimable = 0;
+        for (const auto& [id, tex] : texture_cache) {
+            if (!tex.descriptor.is_resident) continue;
+            if (tex.last_access_time != frame_time) {
+                reclaimable += tex.data.size();
+            } else if (tex.descriptor.current_mip < tex.wanted_mip) {
+                reclaimable += tex.data.size() - CalculateResidentSize(tex.descriptor, tex.wanted_mip);
+            }
+        }
+        
+        *used_bytes = stats.bytes_cached;
+        *reclaimable_bytes = reclaimable;
+    }
+    
+    void ClearCache() {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        
+        for (auto& [id, tex] : texture_cache) {
+            tex.data.clear();
+            tex.data.shrink_to_fit();
+            tex.descriptor.is_resident = false;
+            tex.descriptor.current_mip = tex.descriptor.mip_levels;
+        }
         
+        stats.bytes_cached = 0;
+        UpdateCacheSize();
+        
+        LOGI("Texture cache cleared");
+    }
+    
+private:
+    uint64_t RegisterTextureLocked(uint32_t width, uint32_t height,
+                                   uint32_t mip_levels, uint32_t format,
+                                   uint64_t gpu_address, const void* initial_data) {
         uint64_t id = next_texture_id++;
+        mip_levels = std::max(1u, mip_levels);
         
         CachedTexture tex;
         tex.descriptor.id = id;
         tex.descriptor.width = width;
         tex.descriptor.height = height;
         tex.descriptor.mip_levels = mip_levels;
+        tex.descriptor.array_layers = 1;
         tex.descriptor.format = format;
+        tex.descriptor.gpu_address = gpu_address;
         tex.descriptor.priority = 0.5f;
         tex.descriptor.is_resident = false;
         tex.descriptor.current_mip = mip_levels; // Найнижча якість
         tex.last_access_time = frame_time;
-        tex.distance_to_camera = 1000.0f;
+        tex.fine_use_time = frame_time;
+        // Текстури з feedback приймають перший звіт як є (тому - найгрубший рівень)
+        tex.wanted_mip = gpu_address ? mip_levels - 1 : GetTargetMipLevel(tex.descriptor);
         tex.is_loading = false;
         
         if (initial_data) {
@@ -145,91 +289,69 @@ public:
             UpdateCacheSize();
         }
         
+        lru_order.push_front(id);
+        tex.lru = lru_order.begin();
+        
         texture_cache[id] = std::move(tex);
+        if (gpu_address) {
+            address_index[gpu_address] = id;
+        }
         stats.textures_loaded++;
         
         return id;
     }
     
-    void UnregisterTexture(uint64_t id) {
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        
+    void UnregisterTextureLocked(uint64_t id) {
         auto it = texture_cache.find(id);
-        if (it != texture_cache.end()) {
-            stats.bytes_cached -= it->second.data.size();
-            texture_cache.erase(it);
-            UpdateCacheSize();
-        }
-    }
-    
-    void RequestLoad(uint64_t id, float priority) {
-        {
-            std::lock_guard<std::mutex> lock(cache_mutex);
-            auto it = texture_cache.find(id);
-            if (it == texture_cache.end() || it->second.is_loading) {
-                return;
-            }
-            it->second.is_loading = true;
-            it->second.descriptor.priority = priority;
+        if (it == texture_cache.end()) {
+            return;
         }
         
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex);
-            load_queue.push({id, priority});
-            stats.pending_loads++;
+        auto& tex = it->second;
+        stats.bytes_cached -= tex.data.size();
+        lru_order.erase(tex.lru);
+        
+        auto addr = address_index.find(tex.descriptor.gpu_address);
+        if (addr != address_index.end() && addr->second == id) {
+            address_index.erase(addr);
         }
-        queue_cv.notify_one();
+        
+        texture_cache.erase(it);
+        UpdateCacheSize();
     }
     
-    void Update(float cx, float cy, float cz) {
-        camera_x = cx;
-        camera_y = cy;
-        camera_z = cz;
-        frame_time++;
-        
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        
-        // Оновлення відстаней та пріоритетів
-        for (auto& [id, tex] : texture_cache) {
-            float dx = tex.descriptor.gpu_address - cx; // Спрощено
-            float dy = 0;
-            float dz = 0;
-            tex.distance_to_camera = std::sqrt(dx*dx + dy*dy + dz*dz);
-            
-            // Автоматичний запит на завантаження близьких текстур
-            if (tex.distance_to_camera < config.prefetch_distance && 
-                !tex.descriptor.is_resident && !tex.is_loading) {
-                float priority = 1.0f - (tex.distance_to_camera / config.prefetch_distance);
-                RequestLoad(id, priority);
+    // RSX бачить лише адреси; пам'ять, перевикористана під інше зображення, - нова текстура
+    CachedTexture& FindOrRegisterLocked(const SampledTextureFeedback& entry) {
+        auto addr = address_index.find(entry.gpu_address);
+        if (addr != address_index.end()) {
+            auto& tex = texture_cache[addr->second];
+            if (tex.descriptor.width == entry.width && tex.descriptor.height == entry.height &&
+                tex.descriptor.mip_levels == entry.mip_levels && tex.descriptor.format == entry.format) {
+                return tex;
             }
+            UnregisterTextureLocked(addr->second);
         }
         
-        // Евікція старих текстур якщо кеш переповнений
-        EvictIfNeeded();
-        
-        // Оновлення статистики
-        if (stats.cache_hits + stats.cache_misses > 0) {
-            stats.cache_hit_ratio = static_cast<float>(stats.cache_hits) / 
-                                    (stats.cache_hits + stats.cache_misses);
-        }
+        const uint64_t id = RegisterTextureLocked(entry.width, entry.height, entry.mip_levels,
+                                                  entry.format, entry.gpu_address, nullptr);
+        return texture_cache[id];
     }
     
-    void ClearCache() {
-        std::lock_guard<std::mutex> lock(cache_mutex);
-        
-        for (auto& [id, tex] : texture_cache) {
-            tex.data.clear();
-            tex.descriptor.is_resident = false;
-            tex.descriptor.current_mip = tex.descriptor.mip_levels;
+    void QueueLoadLocked(CachedTexture& tex, float priority) {
+        if (tex.is_loading) {
+            return;
         }
+        tex.is_loading = true;
+        tex.descriptor.priority = priority;
         
-        stats.bytes_cached = 0;
-        g_current_cache_size_mb.store(0);
-        
-        LOGI("Texture cache cleared");
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            load_queue.push({tex.descriptor.id, priority});
+            stats.pending_loads++;
+        }
+        queue_cv.notify_one();
     }
     
-private:
     void WorkerThread() {
         while (running) {
             LoadRequest request;
@@ -249,7 +371,6 @@ private:
             
             auto start_time = std::chrono::steady_clock::now();
             
-            // Симуляція завантаження текстури
             bool success = LoadTexture(request.texture_id);
             
             auto end_time = std::chrono::steady_clock::now();
@@ -282,66 +403,114 @@ private:
         }
         
         auto& tex = it->second;
+        tex.is_loading = false;
         
-        // Симуляція завантаження - генерація даних
-        size_t data_size = CalculateTextureSize(
-            tex.descriptor.width, tex.descriptor.height,
-            tex.descriptor.mip_levels, tex.descriptor.format);
+        // wanted_mip міг змінитись, поки запит чекав у черзі
+        const uint32_t target_mip = tex.wanted_mip;
+        if (tex.descriptor.is_resident && tex.descriptor.current_mip <= target_mip) {
+            return true;
+        }
         
-        // Застосування якості
-        uint32_t target_mip = GetTargetMipLevel(tex.descriptor);
-        size_t actual_size = CalculateMipSize(
-            tex.descriptor.width, tex.descriptor.height,
-            target_mip, tex.descriptor.format);
+        // Завантажуються лише відсутні рівні target_mip..current_mip-1,
+        // грубіші вже резидентні
+        const size_t old_size = tex.data.size();
+        const size_t actual_size = CalculateResidentSize(tex.descriptor, target_mip);
         
         tex.data.resize(actual_size);
         // В реальній реалізації тут було б читання з диску/мережі
         
         tex.descriptor.is_resident = true;
         tex.descriptor.current_mip = target_mip;
-        tex.is_loading = false;
-        tex.last_access_time = frame_time;
         
-        stats.bytes_streamed += actual_size;
-        stats.bytes_cached += actual_size;
+        stats.bytes_streamed += actual_size - old_size;
+        stats.bytes_cached += actual_size - old_size;
         UpdateCacheSize();
         
         return true;
     }
     
+    // Знімає рівні детальніші за mip, решта ланцюжка лишається резидентною
+    void TrimTo(CachedTexture& tex, uint32_t mip) {
+        const size_t new_size = CalculateResidentSize(tex.descriptor, mip);
+        stats.bytes_cached -= tex.data.size() - new_size;
+        stats.mips_trimmed += mip - tex.descriptor.current_mip;
+        tex.data.resize(new_size);
+        tex.data.shrink_to_fit();
+        tex.descriptor.current_mip = mip;
+    }
+    
+    void Evict(CachedTexture& tex) {
+        stats.bytes_cached -= tex.data.size();
+        stats.textures_evicted++;
+        tex.data.clear();
+        tex.data.shrink_to_fit();
+        tex.descriptor.is_resident = false;
+        tex.descriptor.current_mip = tex.descriptor.mip_levels;
+    }
+    
     void EvictIfNeeded() {
-        uint32_t max_bytes = config.max_cache_size_mb * 1024 * 1024;
+        const uint64_t max_bytes = static_cast<uint64_t>(config.max_cache_size_mb) * 1024 * 1024;
         
-        while (stats.bytes_cached > max_bytes) {
-            // Знаходимо найменш пріоритетну текстуру
-            uint64_t evict_id = 0;
-            float min_priority = 999999.0f;
-            uint64_t oldest_access = frame_time;
-            
-            for (const auto& [id, tex] : texture_cache) {
-                if (!tex.descriptor.is_resident) continue;
-                
-                // Пріоритет = близькість + недавність використання
-                float priority = tex.descriptor.priority - 
-                                (frame_time - tex.last_access_time) * 0.001f;
-                
-                if (priority < min_priority) {
-                    min_priority = priority;
-                    evict_id = id;
+        if (stats.bytes_cached <= max_bytes) {
+            // Тиск спав - повертаємо якість по рівню раз на mip_trim_frames
+            calm_frames = stats.bytes_cached < max_bytes / 4 * 3 ? calm_frames + 1 : 0;
+            if (pressure_bias && calm_frames > config.mip_trim_frames) {
+                pressure_bias--;
+                calm_frames = 0;
+            }
+            return;
+        }
+        calm_frames = 0;
+        
+        ReleaseUnused(max_bytes);
+        
+        if (stats.bytes_cached <= max_bytes) {
+            UpdateCacheSize();
+            return;
+        }
+        
+        // 3. Робочий набір кадру більший за бюджет: по одному детальному
+        //    рівню з найбільших, і зсув residency для наступних кадрів
+        if (pressure_bias < kMaxPressureBias) {
+            pressure_bias++;
+            LOGW("Frame working set exceeds %u MB, residency bias %u",
+                 config.max_cache_size_mb, pressure_bias);
+        }
+        bool progress = true;
+        while (stats.bytes_cached > max_bytes && progress) {
+            progress = false;
+            for (auto& id : lru_order) {
+                auto& tex = texture_cache[id];
+                if (!tex.descriptor.is_resident || tex.descriptor.current_mip + 1 >= tex.descriptor.mip_levels) {
+                    continue;
                 }
+                TrimTo(tex, tex.descriptor.current_mip + 1);
+                tex.wanted_mip = std::max(tex.wanted_mip, tex.descriptor.current_mip);
+                progress = true;
+                if (stats.bytes_cached <= max_bytes) break;
+            }
+        }
+        
+        UpdateCacheSize();
+    }
+    
+    // Кроки 1-2 витіснення: без впливу на поточний кадр
+    void ReleaseUnused(uint64_t max_bytes) {
+        // 1. Рівні, детальніші за потрібні feedback (без видимої втрати якості)
+        for (auto it = lru_order.rbegin(); it != lru_order.rend() && stats.bytes_cached > max_bytes; ++it) {
+            auto& tex = texture_cache[*it];
+            if (tex.descriptor.is_resident && tex.descriptor.current_mip < tex.wanted_mip) {
+                TrimTo(tex, tex.wanted_mip);
+            }
+        }
+        
+        // 2. LRU: повне вивантаження того, що не семплювалось цього кадру
+        for (auto it = lru_order.rbegin(); it != lru_order.rend() && stats.bytes_cached > max_bytes; ++it) {
+            auto& tex = texture_cache[*it];
+            if (tex.last_access_time == frame_time) break; // Далі лише свіжіші
+            if (tex.descriptor.is_resident) {
+                Evict(tex);
             }
-            
-            if (evict_id == 0) break;
-            
-            auto& tex = texture_cache[evict_id];
-            stats.bytes_cached -= tex.data.size();
-            tex.data.clear();
-            tex.data.shrink_to_fit();
-            tex.descriptor.is_resident = false;
-            tex.descriptor.current_mip = tex.descriptor.mip_levels;
-            
-            LOGI("Evicted texture %llu (priority %.2f)", 
-                 (unsigned long long)evict_id, min_priority);
         }
     }
     
@@ -361,6 +530,15 @@ private:
         }
     }
     
+    // Розмір ланцюжка mip..mip_levels-1
+    size_t CalculateResidentSize(const TextureDescriptor& desc, uint32_t mip) {
+        size_t size = 0;
+        for (uint32_t i = mip; i < desc.mip_levels; ++i) {
+            size += CalculateMipSize(desc.width, desc.height, i, desc.format);
+        }
+        return size;
+    }
+    
     size_t CalculateTextureSize(uint32_t w, uint32_t h, uint32_t mips, uint32_t fmt) {
         size_t size = 0;
         for (uint32_t i = 0; i < mips; ++i) {
@@ -438,7 +616,7 @@ TextureQuality GetTextureQuality() {
 }
 
 void SetMaxCacheSize(uint32_t size_mb) {
-    g_system.config.max_cache_size_mb = size_mb;
+    g_system.SetMaxCacheSize(size_mb);
     LOGI("Max cache size set to: %u MB", size_mb);
 }
 
@@ -468,8 +646,12 @@ void SetTexturePriority(uint64_t texture_id, float priority) {
     }
 }
 
-void UpdateStreaming(float camera_x, float camera_y, float camera_z) {
-    g_system.Update(camera_x, camera_y, camera_z);
+void UpdateStreaming(const SampledTextureFeedback* feedback, size_t count) {
+    if (!g_streaming_active.load(std::memory_order_relaxed) ||
+        g_system.config.mode == StreamingMode::DISABLED) {
+        return;
+    }
+    g_system.Update(feedback, count);
 }
 
 void FlushPendingLoads() {
@@ -483,15 +665,12 @@ void ClearCache() {
     g_system.ClearCache();
 }
 
-void PrefetchZone(float x, float y, float z, float radius) {
-    std::lock_guard<std::mutex> lock(g_system.cache_mutex);
-    
-    for (auto& [id, tex] : g_system.texture_cache) {
-        // Спрощена перевірка - в реальності потрібні просторові координати
-        if (!tex.descriptor.is_resident && !tex.is_loading) {
-            g_system.RequestLoad(id, 0.8f);
-        }
-    }
+uint64_t TrimCache(uint64_t max_bytes) {
+    return g_system.Trim(max_bytes);
+}
+
+void GetCacheUsage(uint64_t* used_bytes, uint64_t* reclaimable_bytes) {
+    g_system.GetUsage(used_bytes, reclaimable_bytes);
 }
 
 void GetStreamingStats(StreamingStats* stats) {
@@ -5,9 +5,10 @@
  * для оптимального використання пам'яті на мобільних пристроях.
  * 
  * Особливості:
- * - LRU кеш з пріоритетами на основі відстані до камери
+ * - Residency за sampler feedback: RSX texture cache раз на кадр повідомляє,
+ *   які текстури семпловані і до якого найдетальнішого mip
+ * - LRU евікція в межах max_cache_size_mb
  * - Асинхронне завантаження з пулом потоків
- * - Автоматичне mipmap streaming
  * - Стиснення ASTC/ETC2 для ARM
  * - Інтеграція з Vulkan для zero-copy transfer
  */
@@ -16,6 +17,7 @@
 #define RPCSX_TEXTURE_STREAMING_H
 
 #include <cstdint>
+#include <cstddef>
 #include <atomic>
 #include <string>
 #include <functional>
@@ -63,8 +65,8 @@ struct StreamingConfig {
     // Максимальна затримка завантаження (мс)
     uint32_t max_load_delay_ms = 100;
     
-    // Поріг відстані для prefetch (в юнітах гри)
-    float prefetch_distance = 50.0f;
+    // Кадрів без семплювання, після яких зайві детальні mip можна скинути
+    uint32_t mip_trim_frames = 30;
     
     // Увімкнути ASTC стиснення
     bool use_astc_compression = true;
@@ -88,8 +90,26 @@ struct StreamingStats {
     uint32_t pending_loads;           // Текстур в черзі
     float average_load_time_ms;       // Середній час завантаження
     float cache_hit_ratio;            // Відсоток попадань в кеш
+    uint32_t textures_sampled;        // Текстур у feedback останнього кадру
+    uint64_t textures_evicted;        // Повністю вивантажених (LRU)
+    uint64_t mips_trimmed;            // Скинутих детальних mip рівнів
 };
 
+/**
+ * Sampler feedback від RSX texture cache (ABI з rsx::sampled_texture_feedback)
+ */
+struct SampledTextureFeedback {
+    uint32_t gpu_address;             // Адреса текстури в RSX пам'яті
+    uint32_t format;                  // GCM format
+    uint16_t width;
+    uint16_t height;
+    uint8_t mip_levels;
+    uint8_t finest_mip;               // Найдетальніший mip, доступний семплеру цього кадру
+    uint16_t reserved;
+};
+
+static_assert(sizeof(SampledTextureFeedback) == 16, "Must match rsx::sampled_texture_feedback");
+
 /**
  * Дескриптор текстури для стрімінгу
  */
@@ -166,9 +186,11 @@ void RequestTextureLoad(uint64_t texture_id, float priority = 1.0f);
 void SetTexturePriority(uint64_t texture_id, float priority);
 
 /**
- * Оновлення системи стрімінгу (викликати кожен кадр)
+ * Оновлення системи стрімінгу (раз на кадр, з sampler feedback RSX).
+ * Невідомі адреси реєструються автоматично; residency = найдетальніший
+ * семплований mip (не детальніше за TextureQuality) і далі по ланцюжку.
  */
-void UpdateStreaming(float camera_x, float camera_y, float camera_z);
+void UpdateStreaming(const SampledTextureFeedback* feedback, size_t count);
 
 /**
  * Примусове завантаження всіх текстур
@@ -181,9 +203,15 @@ void FlushPendingLoads();
 void ClearCache();
 
 /**
- * Prefetch текстур для зони
+ * Витіснення до max_bytes без впливу на поточний кадр: зайві mip рівні,
+ * потім LRU текстури, не семпловані цього кадру. Повертає звільнені байти
+ */
+uint64_t TrimCache(uint64_t max_bytes);
+
+/**
+ * Облік для memory budget (reclaimable - що звільнить TrimCache(0))
  */
-void PrefetchZone(float x, float y, float z, float radius);
+void GetCacheUsage(uint64_t* used_bytes, uint64_t* reclaimable_bytes);
 
 /**
  * Отримання статистики
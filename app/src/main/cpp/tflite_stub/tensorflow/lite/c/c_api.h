@@ -17,6 +17,7 @@ typedef struct TfLiteModel TfLiteModel;
 typedef struct TfLiteInterpreterOptions TfLiteInterpreterOptions;
 typedef struct TfLiteInterpreter TfLiteInterpreter;
 typedef struct TfLiteTensor TfLiteTensor;
+typedef struct TfLiteDelegate TfLiteDelegate;
 
 // Model
 TfLiteModel* TfLiteModelCreateFromFile(const char* filename);
@@ -25,6 +26,8 @@ void TfLiteModelDelete(TfLiteModel* model);
 // Options
 TfLiteInterpreterOptions* TfLiteInterpreterOptionsCreate();
 void TfLiteInterpreterOptionsDelete(TfLiteInterpreterOptions* options);
+void TfLiteInterpreterOptionsSetNumThreads(TfLiteInterpreterOptions* options, int32_t num_threads);
+void TfLiteInterpreterOptionsAddDelegate(TfLiteInterpreterOptions* options, TfLiteDelegate* delegate);
 
 // Interpreter
 TfLiteInterpreter* TfLiteInterpreterCreate(const TfLiteModel* model, TfLiteInterpreterOptions* options);
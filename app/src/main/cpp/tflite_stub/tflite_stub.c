@@ -19,6 +19,12 @@ TfLiteInterpreterOptions* TfLiteInterpreterOptionsCreate() {
     return (TfLiteInterpreterOptions*)malloc(sizeof(TfLiteInterpreterOptions));
 }
 void TfLiteInterpreterOptionsDelete(TfLiteInterpreterOptions* options) { free(options); }
+void TfLiteInterpreterOptionsSetNumThreads(TfLiteInterpreterOptions* options, int32_t num_threads) {
+    (void)options; (void)num_threads;
+}
+void TfLiteInterpreterOptionsAddDelegate(TfLiteInterpreterOptions* options, TfLiteDelegate* delegate) {
+    (void)options; (void)delegate;
+}
 
 TfLiteInterpreter* TfLiteInterpreterCreate(const TfLiteModel* model, TfLiteInterpreterOptions* options) {
     (void)model; (void)options;
@@ -1,5 +1,6 @@
 /**
- * Агресивний Thread Scheduler для фіксації PPU на Cortex-X4 ядрах
+ * Агресивний Thread Scheduler для фіксації PPU на найпотужнішому ядрі SoC
+ * Топологія ядер визначається з sysfs, тому карта працює на Snapdragon, Tensor, Dimensity та Exynos
  * Ігнорує енергозбереження Android для максимальної продуктивності
  */
 
@@ -9,8 +10,18 @@
 #include <pthread.h>
 #include <sys/resource.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #define LOG_TAG "RPCSX-Scheduler"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -18,16 +29,331 @@
 
 namespace rpcsx::scheduler {
 
-// Топологія Snapdragon 8s Gen 3:
-// CPU 0-3: Cortex-A720 (2.5 GHz) - Efficiency cores
-// CPU 4-6: Cortex-A720 (2.8 GHz) - Performance cores  
-// CPU 7: Cortex-X4 (3.0 GHz) - Prime core
+// Топологія визначається під час InitializeScheduler() з sysfs:
+//   cpuN/cpu_capacity            - відносна потужність ядра (0..1024)
+//   cpuN/cpufreq/cpuinfo_max_freq - запасний варіант, якщо capacity відсутня
+//   cpuN/topology/cluster_id     - кластер (або cpufreq/related_cpus)
+//   cpuN/cache/index2/size       - розмір L2, розрізняє ядра з однаковою capacity
+// Кластери сортуються за потужністю: перший - prime, останній - efficiency.
+// Під SM8650 це дає ту саму карту, що була захардкоджена раніше (7 / 4-6 / 0-3).
 
-constexpr int PRIME_CORE = 7;           // Cortex-X4
-constexpr int PERF_CORES_START = 4;     // Cortex-A720 Performance
-constexpr int PERF_CORES_END = 6;
-constexpr int EFFICIENCY_CORES_START = 0;
-constexpr int EFFICIENCY_CORES_END = 3;
+constexpr int THREAD_TYPE_COUNT = 5;
+constexpr auto MONITOR_INTERVAL = std::chrono::seconds(2);
+
+// Пороги для перерозподілу SPU на вільні efficiency ядра
+constexpr float SPILL_BUSY_THRESHOLD = 0.90f;
+constexpr float SPILL_IDLE_THRESHOLD = 0.25f;
+constexpr float SPILL_RELEASE_THRESHOLD = 0.60f;
+
+struct CpuCore {
+    int id;
+    int cluster;
+    unsigned capacity;           // Номінальна capacity
+    unsigned effective_capacity; // Capacity з урахуванням thermal cap на частоту
+    unsigned max_freq_khz;
+    unsigned l2_kb;
+};
+
+struct CoreCluster {
+    int id;
+    unsigned capacity;
+    unsigned l2_kb;
+    std::vector<int> cpus;
+};
+
+struct CoreMap {
+    std::vector<CpuCore> cores;
+    std::vector<CoreCluster> clusters; // Відсортовані від найпотужнішого
+    cpu_set_t sets[THREAD_TYPE_COUNT];
+    bool spu_spilled = false;
+};
+
+struct RegisteredThread {
+    pid_t tid;
+    ThreadType type;
+};
+
+struct CpuTimes {
+    unsigned long long busy = 0;
+    unsigned long long total = 0;
+};
+
+static std::mutex g_map_mutex;
+static CoreMap g_core_map;
+static bool g_map_ready = false;
+static std::vector<RegisteredThread> g_threads;
+static std::vector<CpuTimes> g_last_cpu_times;
+
+static std::mutex g_monitor_mutex;
+static std::condition_variable g_monitor_cv;
+static std::thread g_monitor_thread;
+static bool g_monitor_running = false;
+
+static unsigned ReadSysfsUInt(const std::string& path, unsigned fallback) {
+    std::ifstream file(path);
+    unsigned value;
+    if (file >> value) {
+        return value;
+    }
+    return fallback;
+}
+
+/**
+ * Розмір кешу у форматі sysfs ("512K", "2M")
+ */
+static unsigned ReadCacheSizeKB(const std::string& path) {
+    std::ifstream file(path);
+    unsigned value = 0;
+    char unit = 'K';
+    if (!(file >> value)) {
+        return 0;
+    }
+    file >> unit;
+    return unit == 'M' ? value * 1024 : value;
+}
+
+/**
+ * Перший CPU зі списку "0-3" або "0 1 2 3"
+ */
+static int ReadFirstCpu(const std::string& path) {
+    std::ifstream file(path);
+    int cpu;
+    if (file >> cpu) {
+        return cpu;
+    }
+    return -1;
+}
+
+static std::string CpuPath(int cpu, const char* leaf) {
+    return "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/" + leaf;
+}
+
+/**
+ * Зчитування топології ядер з sysfs
+ */
+static std::vector<CpuCore> DiscoverCores() {
+    std::vector<CpuCore> cores;
+    const long cpu_count = sysconf(_SC_NPROCESSORS_CONF);
+    bool has_capacity = true;
+
+    for (int cpu = 0; cpu < cpu_count && cpu < CPU_SETSIZE; cpu++) {
+        CpuCore core{};
+        core.id = cpu;
+        core.capacity = ReadSysfsUInt(CpuPath(cpu, "cpu_capacity"), 0);
+        core.max_freq_khz = ReadSysfsUInt(CpuPath(cpu, "cpufreq/cpuinfo_max_freq"), 0);
+        core.l2_kb = ReadCacheSizeKB(CpuPath(cpu, "cache/index2/size"));
+
+        int cluster = static_cast<int>(ReadSysfsUInt(CpuPath(cpu, "topology/cluster_id"), ~0u));
+        if (cluster < 0) {
+            cluster = ReadFirstCpu(CpuPath(cpu, "cpufreq/related_cpus"));
+        }
+        core.cluster = cluster;
+
+        has_capacity &= core.capacity != 0;
+        cores.push_back(core);
+    }
+
+    for (auto& core : cores) {
+        // Без cpu_capacity порівнюємо ядра за максимальною частотою
+        if (!has_capacity) {
+            core.capacity = core.max_freq_khz;
+        }
+        core.effective_capacity = core.capacity;
+
+        // Без інформації про кластер групуємо ядра з однаковою потужністю
+        if (core.cluster < 0) {
+            core.cluster = static_cast<int>(core.capacity);
+        }
+    }
+
+    return cores;
+}
+
+/**
+ * Врахування thermal throttling: scaling_max_freq нижче cpuinfo_max_freq
+ * означає, що thermal framework обмежив частоту кластера
+ */
+static void ApplyThermalCaps(std::vector<CpuCore>& cores) {
+    for (auto& core : cores) {
+        core.effective_capacity = core.capacity;
+        if (!core.max_freq_khz) {
+            continue;
+        }
+
+        const unsigned cap_khz = ReadSysfsUInt(CpuPath(core.id, "cpufreq/scaling_max_freq"), core.max_freq_khz);
+        if (cap_khz < core.max_freq_khz) {
+            core.effective_capacity = static_cast<unsigned>(
+                static_cast<unsigned long long>(core.capacity) * cap_khz / core.max_freq_khz);
+        }
+    }
+}
+
+static std::vector<CoreCluster> BuildClusters(const std::vector<CpuCore>& cores) {
+    std::vector<CoreCluster> clusters;
+
+    for (const auto& core : cores) {
+        auto found = std::find_if(clusters.begin(), clusters.end(),
+                                  [&](const CoreCluster& c) { return c.id == core.cluster; });
+        if (found == clusters.end()) {
+            clusters.push_back({core.cluster, 0, 0, {}});
+            found = clusters.end() - 1;
+        }
+
+        found->capacity = std::max(found->capacity, core.effective_capacity);
+        found->l2_kb = std::max(found->l2_kb, core.l2_kb);
+        found->cpus.push_back(core.id);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const CoreCluster& a, const CoreCluster& b) {
+        if (a.capacity != b.capacity) {
+            return a.capacity > b.capacity;
+        }
+        return a.l2_kb > b.l2_kb;
+    });
+
+    return clusters;
+}
+
+/**
+ * Розкладка типів потоків по кластерах:
+ *   PPU        - найпотужніше ядро prime кластера
+ *   SPU/RENDER - середні кластери та решта prime кластера
+ *   AUDIO      - одне efficiency ядро (стабільна латентність)
+ *   BACKGROUND - efficiency кластер
+ */
+static void AssignCoreSets(CoreMap& map) {
+    for (auto& set : map.sets) {
+        CPU_ZERO(&set);
+    }
+
+    auto& ppu = map.sets[static_cast<int>(ThreadType::PPU)];
+    auto& spu = map.sets[static_cast<int>(ThreadType::SPU)];
+    auto& renderer = map.sets[static_cast<int>(ThreadType::RENDERER)];
+    auto& audio = map.sets[static_cast<int>(ThreadType::AUDIO)];
+    auto& background = map.sets[static_cast<int>(ThreadType::BACKGROUND)];
+
+    if (map.clusters.empty()) {
+        return;
+    }
+
+    const auto& prime = map.clusters.front();
+    const auto& little = map.clusters.back();
+
+    // Ядро з найбільшим номером у кластері зазвичай має найкращий бінінг (SM8650: CPU 7)
+    const int ppu_core = prime.cpus.back();
+    CPU_SET(ppu_core, &ppu);
+
+    if (map.clusters.size() == 1) {
+        // Однорідний CPU: PPU має власне ядро, решта ділить інші
+        for (int cpu : prime.cpus) {
+            if (cpu != ppu_core || prime.cpus.size() == 1) {
+                CPU_SET(cpu, &spu);
+                CPU_SET(cpu, &renderer);
+                CPU_SET(cpu, &background);
+            }
+        }
+        CPU_SET(prime.cpus.front(), &audio);
+        return;
+    }
+
+    for (int cpu : prime.cpus) {
+        if (cpu != ppu_core) {
+            CPU_SET(cpu, &spu);
+        }
+    }
+
+    for (size_t i = 1; i + 1 < map.clusters.size(); i++) {
+        for (int cpu : map.clusters[i].cpus) {
+            CPU_SET(cpu, &spu);
+        }
+    }
+
+    // big.LITTLE з одноядерним prime: SPU залишаються тільки efficiency ядра
+    if (CPU_COUNT(&spu) == 0) {
+        for (int cpu : little.cpus) {
+            CPU_SET(cpu, &spu);
+        }
+    }
+
+    CPU_OR(&renderer, &renderer, &spu);
+
+    for (int cpu : little.cpus) {
+        CPU_SET(cpu, &background);
+    }
+    CPU_SET(little.cpus.back(), &audio);
+}
+
+static std::string DescribeSet(const cpu_set_t& set) {
+    std::string result;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            if (!result.empty()) {
+                result += ',';
+            }
+            result += std::to_string(cpu);
+        }
+    }
+    return result.empty() ? "-" : result;
+}
+
+static void LogCoreMap(const CoreMap& map) {
+    for (const auto& cluster : map.clusters) {
+        LOGI("Cluster %d: capacity=%u, L2=%uKB, cpus=%zu", cluster.id, cluster.capacity, cluster.l2_kb, cluster.cpus.size());
+    }
+
+    static const char* names[THREAD_TYPE_COUNT] = {"PPU", "SPU", "RENDERER", "AUDIO", "BACKGROUND"};
+    for (int i = 0; i < THREAD_TYPE_COUNT; i++) {
+        LOGI("%s -> CPU %s", names[i], DescribeSet(map.sets[i]).c_str());
+    }
+}
+
+static void EnsureCoreMap() {
+    if (g_map_ready) {
+        return;
+    }
+
+    g_core_map = {};
+    g_core_map.cores = DiscoverCores();
+    ApplyThermalCaps(g_core_map.cores);
+    g_core_map.clusters = BuildClusters(g_core_map.cores);
+    AssignCoreSets(g_core_map);
+    g_map_ready = true;
+
+    LogCoreMap(g_core_map);
+}
+
+static pid_t GetThreadTid(pthread_t thread) {
+#if defined(__ANDROID__)
+    return pthread_gettid_np(thread);
+#else
+    return pthread_equal(thread, pthread_self()) ? static_cast<pid_t>(syscall(SYS_gettid)) : 0;
+#endif
+}
+
+static void RegisterThread(pid_t tid, ThreadType type) {
+    for (auto& entry : g_threads) {
+        if (entry.tid == tid) {
+            entry.type = type;
+            return;
+        }
+    }
+    g_threads.push_back({tid, type});
+}
+
+/**
+ * Повторне застосування карти до зареєстрованих потоків після її зміни
+ */
+static void ReapplyAffinity() {
+    for (auto it = g_threads.begin(); it != g_threads.end();) {
+        const auto& set = g_core_map.sets[static_cast<int>(it->type)];
+        if (sched_setaffinity(it->tid, sizeof(set), &set) != 0 && errno == ESRCH) {
+            // Потік уже завершився
+            it = g_threads.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
 
 struct ThreadAffinityProfile {
     cpu_set_t cpuset;
@@ -100,8 +426,18 @@ bool DisableCpuScaling(int cpu_id) {
 void DisablePowerSaving() {
     LOGI("Disabling power saving features for maximum performance");
     
-    // Вимикаємо CPU scaling для всіх високопродуктивних ядер
-    for (int cpu = PERF_CORES_START; cpu <= PRIME_CORE; cpu++) {
+    // Вимикаємо CPU scaling для всіх ядер, крім efficiency кластера
+    std::vector<int> perf_cpus;
+    {
+        std::lock_guard lock(g_map_mutex);
+        EnsureCoreMap();
+        for (size_t i = 0; i + 1 < g_core_map.clusters.size(); i++) {
+            const auto& cpus = g_core_map.clusters[i].cpus;
+            perf_cpus.insert(perf_cpus.end(), cpus.begin(), cpus.end());
+        }
+    }
+
+    for (int cpu : perf_cpus) {
         DisableCpuScaling(cpu);
     }
     
@@ -118,65 +454,30 @@ void DisablePowerSaving() {
  * Налаштування афінності потоку
  */
 bool SetThreadAffinity(pthread_t thread, ThreadType type) {
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    
-    switch (type) {
-        case ThreadType::PPU:
-            // PPU потоки ТІЛЬКИ на Prime core (Cortex-X4)
-            CPU_SET(PRIME_CORE, &cpuset);
-            LOGI("Setting PPU thread affinity to Prime core (CPU %d)", PRIME_CORE);
-            break;
-            
-        case ThreadType::SPU:
-            // SPU потоки на Performance cores
-            for (int cpu = PERF_CORES_START; cpu <= PERF_CORES_END; cpu++) {
-                CPU_SET(cpu, &cpuset);
-            }
-            LOGI("Setting SPU thread affinity to Performance cores (CPU %d-%d)", 
-                 PERF_CORES_START, PERF_CORES_END);
-            break;
-            
-        case ThreadType::RENDERER:
-            // Renderer на Performance cores
-            for (int cpu = PERF_CORES_START; cpu <= PERF_CORES_END; cpu++) {
-                CPU_SET(cpu, &cpuset);
-            }
-            LOGI("Setting Renderer thread affinity to Performance cores");
-            break;
-            
-        case ThreadType::AUDIO:
-            // Audio на один Efficiency core (стабільність)
-            CPU_SET(EFFICIENCY_CORES_END, &cpuset);
-            LOGI("Setting Audio thread affinity to Efficiency core");
-            break;
-            
-        case ThreadType::BACKGROUND:
-            // Background на Efficiency cores
-            for (int cpu = EFFICIENCY_CORES_START; cpu <= EFFICIENCY_CORES_END; cpu++) {
-                CPU_SET(cpu, &cpuset);
-            }
-            break;
-    }
+    std::lock_guard lock(g_map_mutex);
+    EnsureCoreMap();
 
-#if defined(__ANDROID__)
-    // Bionic не експортує pthread_setaffinity_np. Для Android застосовуємо affinity
-    // тільки до поточного потоку через sched_setaffinity.
-    if (!pthread_equal(thread, pthread_self())) {
-        LOGE("Android affinity: can only set affinity for current thread");
+    const cpu_set_t& cpuset = g_core_map.sets[static_cast<int>(type)];
+    if (CPU_COUNT(&cpuset) == 0) {
+        LOGE("No cores mapped for thread type %d", static_cast<int>(type));
         return false;
     }
-    if (sched_setaffinity(0, sizeof(cpuset), &cpuset) != 0) {
-        LOGE("Failed to set thread affinity via sched_setaffinity");
+
+    // Bionic не експортує pthread_setaffinity_np, тому працюємо через TID.
+    // TID також потрібен, щоб перепризначити потік при зміні карти ядер.
+    const pid_t tid = GetThreadTid(thread);
+    if (tid <= 0) {
+        LOGE("Failed to resolve thread id for affinity");
         return false;
     }
-#else
-    if (pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset) != 0) {
-        LOGE("Failed to set thread affinity");
+
+    if (sched_setaffinity(tid, sizeof(cpuset), &cpuset) != 0) {
+        LOGE("Failed to set thread affinity via sched_setaffinity");
         return false;
     }
-#endif
-    
+
+    RegisterThread(tid, type);
+    LOGI("Thread %d affinity set to CPU %s", tid, DescribeSet(cpuset).c_str());
     return true;
 }
 
@@ -260,28 +561,12 @@ bool InitializeGameThread(pthread_t thread, ThreadType type, const char* name) {
 void OptimizeSPUThreadPool(pthread_t* threads, size_t count) {
     LOGI("Optimizing SPU thread pool (%zu threads)", count);
     
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    
-    // Розподіляємо SPU потоки по Performance cores
-    for (int cpu = PERF_CORES_START; cpu <= PERF_CORES_END; cpu++) {
-        CPU_SET(cpu, &cpuset);
-    }
-    
     struct sched_param param;
     param.sched_priority = 90;
     
     for (size_t i = 0; i < count; i++) {
-#if defined(__ANDROID__)
-        // На Android без доступу до TID ми не можемо стабільно проставити affinity
-        // для довільного pthread_t. Пріоритет/імена виставляємо, а affinity — лише
-        // якщо це поточний потік.
-        if (pthread_equal(threads[i], pthread_self())) {
-            sched_setaffinity(0, sizeof(cpuset), &cpuset);
-        }
-#else
-        pthread_setaffinity_np(threads[i], sizeof(cpuset), &cpuset);
-#endif
+        // Розподіляємо SPU потоки по SPU кластерах з карти ядер
+        SetThreadAffinity(threads[i], ThreadType::SPU);
         pthread_setschedparam(threads[i], SCHED_FIFO, &param);
         
         char name[16];
@@ -295,17 +580,119 @@ void OptimizeSPUThreadPool(pthread_t* threads, size_t count) {
 /**
  * Моніторинг завантаження ядер
  */
-void MonitorCoreUtilization() {
-    // Читаємо /proc/stat для кожного CPU
+static std::vector<CpuTimes> ReadCpuTimes() {
+    std::vector<CpuTimes> result;
     std::ifstream stat_file("/proc/stat");
     std::string line;
-    
-    LOGI("=== CPU Core Utilization ===");
-    
+
     while (std::getline(stat_file, line)) {
-        if (line.substr(0, 3) == "cpu" && line[3] >= '0' && line[3] <= '7') {
-            LOGI("%s", line.c_str());
+        if (line.compare(0, 3, "cpu") != 0 || line.size() < 4 || line[3] < '0' || line[3] > '9') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string label;
+        unsigned long long user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+        fields >> label >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal;
+
+        const unsigned cpu = std::stoul(label.substr(3));
+        if (cpu >= result.size()) {
+            result.resize(cpu + 1);
         }
+
+        result[cpu].busy = user + nice + system + irq + softirq + steal;
+        result[cpu].total = result[cpu].busy + idle + iowait;
+    }
+
+    return result;
+}
+
+static float AverageLoad(const cpu_set_t& set, const std::vector<float>& load) {
+    float sum = 0.f;
+    int count = 0;
+    for (size_t cpu = 0; cpu < load.size(); cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            sum += load[cpu];
+            count++;
+        }
+    }
+    return count ? sum / count : 0.f;
+}
+
+/**
+ * Моніторинг завантаження ядер та thermal throttling.
+ * Перебудовує карту ядер, якщо throttling змінив порядок кластерів,
+ * і тимчасово віддає SPU вільні efficiency ядра при насиченні performance кластерів.
+ */
+void MonitorCoreUtilization() {
+    // Читаємо /proc/stat для кожного CPU
+    const auto times = ReadCpuTimes();
+
+    std::lock_guard lock(g_map_mutex);
+    EnsureCoreMap();
+
+    std::vector<float> load(times.size(), 0.f);
+    for (size_t cpu = 0; cpu < times.size() && cpu < g_last_cpu_times.size(); cpu++) {
+        const auto total = times[cpu].total - g_last_cpu_times[cpu].total;
+        if (total) {
+            load[cpu] = static_cast<float>(times[cpu].busy - g_last_cpu_times[cpu].busy) / total;
+        }
+    }
+
+    const bool has_samples = !g_last_cpu_times.empty();
+    g_last_cpu_times = times;
+
+    // Thermal throttling може опустити prime кластер нижче середнього
+    ApplyThermalCaps(g_core_map.cores);
+    auto clusters = BuildClusters(g_core_map.cores);
+
+    bool changed = false;
+    if (clusters.size() != g_core_map.clusters.size() ||
+        !std::equal(clusters.begin(), clusters.end(), g_core_map.clusters.begin(),
+                    [](const CoreCluster& a, const CoreCluster& b) { return a.id == b.id; })) {
+        LOGI("Cluster ranking changed (thermal throttling), rebuilding core map");
+        g_core_map.clusters = std::move(clusters);
+        g_core_map.spu_spilled = false;
+        AssignCoreSets(g_core_map);
+        changed = true;
+    }
+
+    if (has_samples && g_core_map.clusters.size() > 1) {
+        auto& spu = g_core_map.sets[static_cast<int>(ThreadType::SPU)];
+        const auto& background = g_core_map.sets[static_cast<int>(ThreadType::BACKGROUND)];
+        const float spu_load = AverageLoad(spu, load);
+
+        if (!g_core_map.spu_spilled && spu_load > SPILL_BUSY_THRESHOLD &&
+            AverageLoad(background, load) < SPILL_IDLE_THRESHOLD) {
+            LOGI("SPU cores saturated (%.0f%%), spilling onto efficiency cores", spu_load * 100.f);
+            CPU_OR(&spu, &spu, &background);
+            g_core_map.spu_spilled = true;
+            changed = true;
+        } else if (g_core_map.spu_spilled && spu_load < SPILL_RELEASE_THRESHOLD) {
+            LOGI("SPU load dropped (%.0f%%), restoring core map", spu_load * 100.f);
+            g_core_map.spu_spilled = false;
+            AssignCoreSets(g_core_map);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        LogCoreMap(g_core_map);
+        ReapplyAffinity();
+    }
+}
+
+static void MonitorThreadMain() {
+    std::unique_lock lock(g_monitor_mutex);
+    while (g_monitor_running) {
+        g_monitor_cv.wait_for(lock, MONITOR_INTERVAL);
+        if (!g_monitor_running) {
+            break;
+        }
+
+        lock.unlock();
+        MonitorCoreUtilization();
+        lock.lock();
     }
 }
 
@@ -313,7 +700,14 @@ void MonitorCoreUtilization() {
  * Ініціалізація scheduler системи
  */
 bool InitializeScheduler() {
-    LOGI("Initializing Aggressive Thread Scheduler for Snapdragon 8s Gen 3");
+    LOGI("Initializing Aggressive Thread Scheduler");
+
+    {
+        // Повторна ініціалізація перечитує топологію
+        std::lock_guard lock(g_map_mutex);
+        g_map_ready = false;
+        EnsureCoreMap();
+    }
     
     // Вимикаємо енергозбереження
     DisablePowerSaving();
@@ -322,6 +716,14 @@ bool InitializeScheduler() {
     if (setpriority(PRIO_PROCESS, 0, -20) != 0) {
         LOGE("Failed to set process priority (requires root)");
     }
+
+    {
+        std::lock_guard lock(g_monitor_mutex);
+        if (!g_monitor_running) {
+            g_monitor_running = true;
+            g_monitor_thread = std::thread(MonitorThreadMain);
+        }
+    }
     
     LOGI("Scheduler initialized - ready for high-performance gaming");
     return true;
@@ -332,9 +734,25 @@ bool InitializeScheduler() {
  */
 void ShutdownScheduler() {
     LOGI("Scheduler shutdown - restoring normal power management");
+
+    {
+        std::lock_guard lock(g_monitor_mutex);
+        g_monitor_running = false;
+    }
+    g_monitor_cv.notify_all();
+    if (g_monitor_thread.joinable()) {
+        g_monitor_thread.join();
+    }
+
+    {
+        std::lock_guard lock(g_map_mutex);
+        g_threads.clear();
+        g_last_cpu_times.clear();
+    }
     
     // Відновлюємо звичайний governor
-    for (int cpu = 0; cpu < 8; cpu++) {
+    const long cpu_count = sysconf(_SC_NPROCESSORS_CONF);
+    for (int cpu = 0; cpu < cpu_count; cpu++) {
         std::string gov_path = "/sys/devices/system/cpu/cpu" + 
                               std::to_string(cpu) + 
                               "/cpufreq/scaling_governor";
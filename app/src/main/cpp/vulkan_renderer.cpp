@@ -9,6 +9,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <algorithm>
 #include <atomic>
 #include <thread>
 
@@ -64,7 +65,6 @@ static std::string GetGpuIdentity() {
     const char* paths[] = {
         "/sys/class/kgsl/kgsl-3d0/gpu_model",
         "/sys/class/kgsl/kgsl-3d0/gpu_chipid",
-        "/sys/class/kgsl/kgsl-3d0/devfreq/cur_freq",
     };
     std::string result;
     for (const char* p : paths) {
@@ -253,6 +253,62 @@ VkPipelineCache CreatePipelineCache(VkDevice device, const char* cache_file) {
     return cache;
 }
 
+std::string GetPipelineCachePath(VkPhysicalDevice physical_device, const char* cache_dir,
+                                 uint32_t max_generations, bool* new_generation) {
+    if (new_generation) *new_generation = false;
+    if (physical_device == VK_NULL_HANDLE || cache_dir == nullptr) return {};
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(physical_device, &props);
+
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string name = "pipeline_";
+    for (uint8_t byte : props.pipelineCacheUUID) {
+        name += kHex[byte >> 4];
+        name += kHex[byte & 0xf];
+    }
+    name += "_" + std::to_string(props.driverVersion) + ".bin";
+
+    const std::string dir = cache_dir;
+    const std::string path = dir + "/" + name;
+
+    struct stat st {};
+    const bool exists = stat(path.c_str(), &st) == 0 && st.st_size > 0;
+    if (new_generation) *new_generation = !exists;
+
+    // Старі покоління: найновіші за mtime лишаються, поточне не рахується
+    std::vector<std::pair<time_t, std::string>> generations;
+    if (DIR* d = opendir(dir.c_str())) {
+        while (struct dirent* entry = readdir(d)) {
+            const std::string file = entry->d_name;
+            if (file == name || file.rfind("pipeline_", 0) != 0 || file.size() < 4 ||
+                file.compare(file.size() - 4, 4, ".bin") != 0) {
+                continue;
+            }
+            if (stat((dir + "/" + file).c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                generations.emplace_back(st.st_mtime, file);
+            }
+        }
+        closedir(d);
+    }
+
+    std::sort(generations.begin(), generations.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    const size_t keep = max_generations > 0 ? max_generations - 1 : 0;
+    for (size_t i = keep; i < generations.size(); ++i) {
+        const std::string old_path = dir + "/" + generations[i].second;
+        unlink(old_path.c_str());
+        unlink((old_path + ".meta").c_str());
+        LOGI("Dropped pipeline cache of an old driver: %s", generations[i].second.c_str());
+    }
+
+    if (!exists) {
+        LOGI("No pipeline cache for driver %u, starting %s", props.driverVersion, name.c_str());
+    }
+    return path;
+}
+
 void SavePipelineCache(VkDevice device, VkPipelineCache cache, const char* cache_file) {
     if (device == VK_NULL_HANDLE || cache == VK_NULL_HANDLE || cache_file == nullptr) return;
 
@@ -286,8 +342,8 @@ void SavePipelineCache(VkDevice device, VkPipelineCache cache, const char* cache
 RSXGraphicsEngine* g_rsx_engine = nullptr;
 
 RSXGraphicsEngine::RSXGraphicsEngine()
-    : shutdown_flag_(false), vk_device_(nullptr), vk_queue_(nullptr),
-      command_pool_(nullptr), total_commands_(0), total_draws_(0), total_clears_(0) {
+    : shutdown_flag_(false), vk_device_(nullptr), vk_queue_(nullptr), current_rt_{},
+      total_commands_(0), total_draws_(0), total_clears_(0), total_batches_(0) {
     LOGI("RSX Graphics Engine created");
 }
 
@@ -295,150 +351,392 @@ RSXGraphicsEngine::~RSXGraphicsEngine() {
     Shutdown();
 }
 
-bool RSXGraphicsEngine::Initialize(uint32_t num_threads, VkDevice vk_device, VkQueue vk_queue) {
+// 64-бітний handle з двох слів RSXCommand::data, молодше слово першим
+template <typename T>
+static T ReadHandle(const uint32_t* words) {
+    const uint64_t value = static_cast<uint64_t>(words[0]) | (static_cast<uint64_t>(words[1]) << 32);
+    T handle;
+    static_assert(sizeof(T) <= sizeof(value), "handle does not fit in two words");
+    std::memcpy(&handle, &value, sizeof(T));
+    return handle;
+}
+
+static float ReadFloat(uint32_t word) {
+    float value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+}
+
+bool RSXGraphicsEngine::Initialize(uint32_t num_threads, VkDevice vk_device, VkQueue vk_queue,
+                                   uint32_t queue_family) {
     vk_device_ = vk_device;
     vk_queue_ = vk_queue;
     shutdown_flag_ = false;
-    
-    // Create command pool for worker threads
-    VkCommandPoolCreateInfo pool_info{};
-    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    
-    if (vkCreateCommandPool(vk_device, &pool_info, nullptr, &command_pool_) != VK_SUCCESS) {
-        LOGE("Failed to create Vulkan command pool for RSX");
-        return false;
+    if (num_threads == 0) num_threads = 1;
+
+    // Власні пули на кожен worker: запис іде паралельно без спільного lock
+    for (uint32_t i = 0; i < num_threads; ++i) {
+        workers_.push_back(std::make_unique<WorkerContext>());
+        if (vk_device_ == VK_NULL_HANDLE) continue;
+
+        WorkerContext& worker = *workers_.back();
+
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = queue_family;
+
+        if (vkCreateCommandPool(vk_device_, &pool_info, nullptr, &worker.command_pool) != VK_SUCCESS) {
+            LOGE("Failed to create Vulkan command pool for RSX worker %u", i);
+            Shutdown();
+            return false;
+        }
+
+        VkDescriptorPoolSize pool_size{};
+        pool_size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        pool_size.descriptorCount = 1024;
+
+        VkDescriptorPoolCreateInfo descriptor_pool_info{};
+        descriptor_pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptor_pool_info.maxSets = 1024;
+        descriptor_pool_info.poolSizeCount = 1;
+        descriptor_pool_info.pPoolSizes = &pool_size;
+
+        if (vkCreateDescriptorPool(vk_device_, &descriptor_pool_info, nullptr, &worker.descriptor_pool) != VK_SUCCESS) {
+            LOGE("Failed to create descriptor pool for RSX worker %u", i);
+            Shutdown();
+            return false;
+        }
     }
     
     // Create worker threads
     for (uint32_t i = 0; i < num_threads; ++i) {
-        worker_threads_.emplace_back([this]() { WorkerThreadMain(); });
+        worker_threads_.emplace_back([this, i]() { WorkerThreadMain(i); });
     }
     
-    LOGI("RSX Graphics Engine initialized with %u worker threads", num_threads);
+    LOGI("RSX Graphics Engine initialized with %u worker threads%s", num_threads,
+         vk_device_ == VK_NULL_HANDLE ? " (no device, recording disabled)" : "");
     return true;
 }
 
-void RSXGraphicsEngine::WorkerThreadMain() {
-    LOGI("RSX worker thread started");
+void RSXGraphicsEngine::WorkerThreadMain(uint32_t index) {
+    LOGI("RSX worker thread %u started", index);
+    WorkerContext& worker = *workers_[index];
     
-    while (!shutdown_flag_) {
-        RSXCommand cmd;
-        cmd.type = RSXCommand::Type::INVALID;
+    while (true) {
+        std::unique_ptr<CommandBatch> batch;
         
-        // Wait for a command
+        // Wait for a batch
         {
             std::unique_lock<std::mutex> lock(queue_mutex_);
             queue_cv_.wait(lock, [this]() { 
-                return !command_queue_.empty() || shutdown_flag_; 
+                return !pending_batches_.empty() || shutdown_flag_; 
             });
             
-            if (shutdown_flag_ && command_queue_.empty()) {
+            if (pending_batches_.empty()) {
                 break;
             }
             
-            if (!command_queue_.empty()) {
-                cmd = command_queue_.front();
-                command_queue_.pop();
-            }
+            batch = std::move(pending_batches_.front());
+            pending_batches_.pop_front();
+            batches_in_progress_++;
         }
         
-        // Process the command
-        if (cmd.type != RSXCommand::Type::INVALID) {
-            ProcessCommand(cmd);
-            total_commands_++;
+        // Record outside the lock, only this worker's pools are touched
+        RecordBatch(worker, *batch);
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            recorded_batches_.push_back(std::move(batch));
+            batches_in_progress_--;
         }
+        idle_cv_.notify_all();
     }
     
-    LOGI("RSX worker thread exiting");
+    LOGI("RSX worker thread %u exiting", index);
 }
 
-void RSXGraphicsEngine::SubmitCommand(const RSXCommand& cmd) {
-    {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        command_queue_.push(cmd);
+void RSXGraphicsEngine::SealBatchLocked() {
+    if (!open_batch_) return;
+
+    // Batch з самого лише відтвореного стану нічого не дає
+    if (open_batch_->commands.size() > open_batch_->prologue_count) {
+        pending_batches_.push_back(std::move(open_batch_));
+        queue_cv_.notify_one();
+    }
+    open_batch_.reset();
+}
+
+void RSXGraphicsEngine::AppendCommandLocked(const RSXCommand& cmd) {
+    switch (cmd.type) {
+        case RSXCommand::Type::INVALID:
+        case RSXCommand::Type::NOP:
+            total_commands_++;
+            return;
+
+        case RSXCommand::Type::SYNC_POINT:
+            // Secondaries execute in submission order, so closing the batch is enough
+            total_commands_++;
+            SealBatchLocked();
+            return;
+
+        default:
+            break;
+    }
+
+    if (!open_batch_) {
+        open_batch_ = std::make_unique<CommandBatch>();
+        open_batch_->sequence = next_sequence_++;
+        open_batch_->target = current_rt_;
+        open_batch_->commands.reserve(kDrawsPerBatch + STATE_SLOT_COUNT);
+
+        // Secondary не успадковує bound state з попереднього batch
+        for (uint32_t slot = 0; slot < STATE_SLOT_COUNT; ++slot) {
+            if (bound_state_valid_[slot]) {
+                open_batch_->commands.push_back(bound_state_[slot]);
+            }
+        }
+        open_batch_->prologue_count = static_cast<uint32_t>(open_batch_->commands.size());
+    }
+
+    open_batch_->commands.push_back(cmd);
+
+    int slot = -1;
+    switch (cmd.type) {
+        case RSXCommand::Type::BIND_PIPELINE: slot = STATE_PIPELINE; break;
+        case RSXCommand::Type::BIND_DESCRIPTORS: slot = STATE_DESCRIPTORS; break;
+        case RSXCommand::Type::BIND_INDEX_BUFFER: slot = STATE_INDEX_BUFFER; break;
+        case RSXCommand::Type::SET_VIEWPORT: slot = STATE_VIEWPORT; break;
+        case RSXCommand::Type::SET_SCISSOR: slot = STATE_SCISSOR; break;
+        default: break;
+    }
+
+    if (slot >= 0) {
+        bound_state_[slot] = cmd;
+        bound_state_valid_[slot] = true;
+    } else if ((cmd.type == RSXCommand::Type::DRAW_ARRAYS || cmd.type == RSXCommand::Type::DRAW_INDEXED) &&
+               ++open_batch_->draw_count >= kDrawsPerBatch) {
+        SealBatchLocked();
     }
-    queue_cv_.notify_one();
+}
+
+void RSXGraphicsEngine::SubmitCommand(const RSXCommand& cmd) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    AppendCommandLocked(cmd);
 }
 
 void RSXGraphicsEngine::SubmitCommands(const RSXCommand* cmds, uint32_t count) {
-    {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        for (uint32_t i = 0; i < count; ++i) {
-            command_queue_.push(cmds[i]);
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    for (uint32_t i = 0; i < count; ++i) {
+        AppendCommandLocked(cmds[i]);
+    }
+}
+
+VkCommandBuffer RSXGraphicsEngine::AcquireSecondary(WorkerContext& worker) {
+    if (worker.used_secondaries == worker.secondaries.size()) {
+        VkCommandBufferAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = worker.command_pool;
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        alloc_info.commandBufferCount = 1;
+
+        VkCommandBuffer cb = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(vk_device_, &alloc_info, &cb) != VK_SUCCESS) {
+            LOGE("Failed to allocate RSX secondary command buffer");
+            return VK_NULL_HANDLE;
         }
+        worker.secondaries.push_back(cb);
     }
-    queue_cv_.notify_all();
+
+    return worker.secondaries[worker.used_secondaries++];
+}
+
+void RSXGraphicsEngine::RecordBatch(WorkerContext& worker, CommandBatch& batch) {
+    VkCommandBuffer cb = VK_NULL_HANDLE;
+
+    if (worker.command_pool != VK_NULL_HANDLE) {
+        cb = AcquireSecondary(worker);
+    }
+
+    if (cb != VK_NULL_HANDLE) {
+        const VkFormat color_format = batch.target.color_format;
+
+        // Primary рендерить через dynamic rendering, secondary успадковує формати
+        VkCommandBufferInheritanceRenderingInfo rendering_info{};
+        rendering_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+        rendering_info.colorAttachmentCount = color_format != VK_FORMAT_UNDEFINED ? 1 : 0;
+        rendering_info.pColorAttachmentFormats = &color_format;
+        rendering_info.depthAttachmentFormat = batch.target.depth_format;
+        rendering_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkCommandBufferInheritanceInfo inheritance{};
+        inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance.pNext = &rendering_info;
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        begin_info.pInheritanceInfo = &inheritance;
+
+        if (vkBeginCommandBuffer(cb, &begin_info) != VK_SUCCESS) {
+            LOGE("Failed to begin RSX secondary command buffer");
+            cb = VK_NULL_HANDLE;
+        }
+    }
+
+    for (const RSXCommand& cmd : batch.commands) {
+        ProcessCommand(cmd, batch, worker, cb);
+    }
+
+    if (cb != VK_NULL_HANDLE && vkEndCommandBuffer(cb) != VK_SUCCESS) {
+        LOGE("Failed to end RSX secondary command buffer");
+        cb = VK_NULL_HANDLE;
+    }
+
+    batch.secondary = cb;
+    total_commands_ += batch.commands.size() - batch.prologue_count;
+    total_draws_ += batch.draw_count;
+    total_batches_++;
 }
 
-void RSXGraphicsEngine::ProcessCommand(const RSXCommand& cmd) {
+void RSXGraphicsEngine::ProcessCommand(const RSXCommand& cmd, const CommandBatch& batch,
+                                       WorkerContext& worker, VkCommandBuffer cb) {
+    // Clears are counted even when there is no device to record into
+    if (cmd.type == RSXCommand::Type::CLEAR) {
+        total_clears_++;
+    }
+
+    if (cb == VK_NULL_HANDLE) {
+        return;
+    }
+
     switch (cmd.type) {
         case RSXCommand::Type::DRAW_ARRAYS: {
-            total_draws_++;
-            // Get draw parameters from command data
             uint32_t first = cmd.data[0];
             uint32_t count = cmd.data[1];
+            uint32_t instances = cmd.data[2] ? cmd.data[2] : 1;
             
-            // In real implementation, would record Vulkan draw command
-            // vkCmdDraw(cmd_buffer, count, 1, first, 0);
+            vkCmdDraw(cb, count, instances, first, 0);
             break;
         }
         
         case RSXCommand::Type::DRAW_INDEXED: {
-            total_draws_++;
             uint32_t index_count = cmd.data[0];
             uint32_t index_offset = cmd.data[1];
             int32_t vertex_offset = static_cast<int32_t>(cmd.data[2]);
+            uint32_t instances = cmd.data[3] ? cmd.data[3] : 1;
             
-            // In real implementation: vkCmdDrawIndexed(cmd_buffer, index_count, 1, index_offset, vertex_offset, 0);
+            vkCmdDrawIndexed(cb, index_count, instances, index_offset, vertex_offset, 0);
             break;
         }
         
         case RSXCommand::Type::CLEAR: {
-            total_clears_++;
-            // Clear render target
-            // In real implementation: would record clear commands
+            const VkImageAspectFlags aspect = cmd.data[0];
+            VkClearAttachment attachments[2]{};
+            uint32_t attachment_count = 0;
+
+            if ((aspect & VK_IMAGE_ASPECT_COLOR_BIT) && batch.target.color_format != VK_FORMAT_UNDEFINED) {
+                VkClearAttachment& color = attachments[attachment_count++];
+                color.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                color.colorAttachment = 0;
+                color.clearValue.color.float32[0] = ReadFloat(cmd.data[1]);
+                color.clearValue.color.float32[1] = ReadFloat(cmd.data[2]);
+                color.clearValue.color.float32[2] = ReadFloat(cmd.data[3]);
+                color.clearValue.color.float32[3] = ReadFloat(cmd.data[4]);
+            }
+
+            const VkImageAspectFlags ds_aspect = aspect & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
+            if (ds_aspect && batch.target.depth_format != VK_FORMAT_UNDEFINED) {
+                VkClearAttachment& depth_stencil = attachments[attachment_count++];
+                depth_stencil.aspectMask = ds_aspect;
+                depth_stencil.clearValue.depthStencil.depth = ReadFloat(cmd.data[5]);
+                depth_stencil.clearValue.depthStencil.stencil = cmd.data[6];
+            }
+
+            if (attachment_count == 0) break;
+
+            VkClearRect rect{};
+            rect.rect.extent = {batch.target.width, batch.target.height};
+            rect.baseArrayLayer = 0;
+            rect.layerCount = 1;
+            
+            vkCmdClearAttachments(cb, attachment_count, attachments, 1, &rect);
             break;
         }
         
         case RSXCommand::Type::SET_VIEWPORT: {
-            float x = *reinterpret_cast<const float*>(&cmd.data[0]);
-            float y = *reinterpret_cast<const float*>(&cmd.data[1]);
-            float width = *reinterpret_cast<const float*>(&cmd.data[2]);
-            float height = *reinterpret_cast<const float*>(&cmd.data[3]);
-            
             VkViewport viewport{};
-            viewport.x = x;
-            viewport.y = y;
-            viewport.width = width;
-            viewport.height = height;
+            viewport.x = ReadFloat(cmd.data[0]);
+            viewport.y = ReadFloat(cmd.data[1]);
+            viewport.width = ReadFloat(cmd.data[2]);
+            viewport.height = ReadFloat(cmd.data[3]);
             viewport.minDepth = 0.0f;
             viewport.maxDepth = 1.0f;
             
-            // In real implementation: vkCmdSetViewport(cmd_buffer, 0, 1, &viewport);
+            vkCmdSetViewport(cb, 0, 1, &viewport);
             break;
         }
         
         case RSXCommand::Type::SET_SCISSOR: {
-            int32_t x = static_cast<int32_t>(cmd.data[0]);
-            int32_t y = static_cast<int32_t>(cmd.data[1]);
-            uint32_t width = cmd.data[2];
-            uint32_t height = cmd.data[3];
-            
             VkRect2D scissor{};
-            scissor.offset = {x, y};
-            scissor.extent = {width, height};
+            scissor.offset = {static_cast<int32_t>(cmd.data[0]), static_cast<int32_t>(cmd.data[1])};
+            scissor.extent = {cmd.data[2], cmd.data[3]};
             
-            // In real implementation: vkCmdSetScissor(cmd_buffer, 0, 1, &scissor);
+            vkCmdSetScissor(cb, 0, 1, &scissor);
             break;
         }
-        
-        case RSXCommand::Type::SYNC_POINT: {
-            // Device synchronization point
-            // All subsequent commands wait for GPU to catch up
+
+        case RSXCommand::Type::BIND_PIPELINE: {
+            vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, ReadHandle<VkPipeline>(&cmd.data[0]));
+            break;
+        }
+
+        case RSXCommand::Type::BIND_DESCRIPTORS: {
+            if (worker.descriptor_pool_exhausted) break;
+
+            VkPipelineLayout layout = ReadHandle<VkPipelineLayout>(&cmd.data[0]);
+            VkDescriptorSetLayout set_layout = ReadHandle<VkDescriptorSetLayout>(&cmd.data[2]);
+            uint32_t set_index = cmd.data[4];
+
+            // Сет виділяється з пулу worker'а, тож replay у кожному batch дешевий
+            VkDescriptorSetAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            alloc_info.descriptorPool = worker.descriptor_pool;
+            alloc_info.descriptorSetCount = 1;
+            alloc_info.pSetLayouts = &set_layout;
+
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            if (vkAllocateDescriptorSets(vk_device_, &alloc_info, &set) != VK_SUCCESS) {
+                LOGW("RSX worker descriptor pool exhausted, descriptor binds dropped until recycle");
+                worker.descriptor_pool_exhausted = true;
+                break;
+            }
+
+            VkDescriptorBufferInfo buffer_info{};
+            buffer_info.buffer = ReadHandle<VkBuffer>(&cmd.data[5]);
+            buffer_info.offset = cmd.data[7];
+            buffer_info.range = cmd.data[8] ? cmd.data[8] : VK_WHOLE_SIZE;
+
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = set;
+            write.dstBinding = 0;
+            write.descriptorCount = 1;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            write.pBufferInfo = &buffer_info;
+
+            vkUpdateDescriptorSets(vk_device_, 1, &write, 0, nullptr);
+            vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, set_index, 1, &set, 0, nullptr);
+            break;
+        }
+
+        case RSXCommand::Type::BIND_INDEX_BUFFER: {
+            vkCmdBindIndexBuffer(cb, ReadHandle<VkBuffer>(&cmd.data[0]), cmd.data[2],
+                                 static_cast<VkIndexType>(cmd.data[3]));
             break;
         }
         
+        case RSXCommand::Type::SYNC_POINT:
         case RSXCommand::Type::NOP:
         case RSXCommand::Type::INVALID:
         default:
@@ -449,12 +747,63 @@ void RSXGraphicsEngine::ProcessCommand(const RSXCommand& cmd) {
 
 void RSXGraphicsEngine::SetRenderTarget(const RSXRenderTarget& rt) {
     std::lock_guard<std::mutex> lock(queue_mutex_);
+    SealBatchLocked();
     current_rt_ = rt;
 }
 
 void RSXGraphicsEngine::Flush() {
     std::unique_lock<std::mutex> lock(queue_mutex_);
-    queue_cv_.wait(lock, [this]() { return command_queue_.empty(); });
+    SealBatchLocked();
+    idle_cv_.wait(lock, [this]() {
+        return (pending_batches_.empty() && batches_in_progress_ == 0) || worker_threads_.empty();
+    });
+}
+
+uint32_t RSXGraphicsEngine::ExecuteRecorded(VkCommandBuffer primary) {
+    Flush();
+
+    std::vector<std::unique_ptr<CommandBatch>> batches;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        batches.swap(recorded_batches_);
+    }
+
+    // Workers finish out of order, the primary must see submission order
+    std::sort(batches.begin(), batches.end(), [](const auto& a, const auto& b) {
+        return a->sequence < b->sequence;
+    });
+
+    std::vector<VkCommandBuffer> secondaries;
+    secondaries.reserve(batches.size());
+    for (const auto& batch : batches) {
+        if (batch->secondary != VK_NULL_HANDLE) {
+            secondaries.push_back(batch->secondary);
+        }
+    }
+
+    if (primary != VK_NULL_HANDLE && !secondaries.empty()) {
+        vkCmdExecuteCommands(primary, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+    }
+
+    return static_cast<uint32_t>(secondaries.size());
+}
+
+void RSXGraphicsEngine::RecycleRecorded() {
+    Flush();
+
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    recorded_batches_.clear();
+
+    for (auto& worker : workers_) {
+        if (worker->command_pool != VK_NULL_HANDLE) {
+            vkResetCommandPool(vk_device_, worker->command_pool, 0);
+        }
+        if (worker->descriptor_pool != VK_NULL_HANDLE) {
+            vkResetDescriptorPool(vk_device_, worker->descriptor_pool, 0);
+        }
+        worker->used_secondaries = 0;
+        worker->descriptor_pool_exhausted = false;
+    }
 }
 
 void RSXGraphicsEngine::GetGraphicsStats(GraphicsStats* stats) {
@@ -464,15 +813,23 @@ void RSXGraphicsEngine::GetGraphicsStats(GraphicsStats* stats) {
     stats->total_draws = total_draws_.load();
     stats->total_clears = total_clears_.load();
     stats->gpu_wait_cycles = 0;  // Would be populated by actual GPU driver
-    stats->avg_queue_depth = 0.0;
+    stats->total_batches = total_batches_.load();
+
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stats->avg_queue_depth = static_cast<double>(pending_batches_.size());
 }
 
 void RSXGraphicsEngine::Shutdown() {
+    if (worker_threads_.empty() && workers_.empty()) {
+        return;
+    }
+
     LOGI("RSX Graphics Engine shutting down");
     
-    // Signal shutdown to worker threads
+    // Signal shutdown to worker threads, pending batches are still recorded
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
+        SealBatchLocked();
         shutdown_flag_ = true;
     }
     queue_cv_.notify_all();
@@ -484,12 +841,20 @@ void RSXGraphicsEngine::Shutdown() {
         }
     }
     worker_threads_.clear();
+    idle_cv_.notify_all();
     
-    // Clean up Vulkan resources
-    if (command_pool_ && vk_device_) {
-        vkDestroyCommandPool(vk_device_, command_pool_, nullptr);
-        command_pool_ = nullptr;
+    // Clean up Vulkan resources, destroying a pool frees its command buffers
+    for (auto& worker : workers_) {
+        if (worker->descriptor_pool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(vk_device_, worker->descriptor_pool, nullptr);
+        }
+        if (worker->command_pool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(vk_device_, worker->command_pool, nullptr);
+        }
     }
+    workers_.clear();
+    recorded_batches_.clear();
+    pending_batches_.clear();
     
     LOGI("RSX Graphics Engine shut down complete");
 }
@@ -8,12 +8,15 @@
 #define RPCSX_VULKAN_RENDERER_H
 
 #include <vulkan/vulkan.h>
+#include <atomic>
 #include <cstdint>
-#include <queue>
+#include <deque>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <condition_variable>
 #include <memory>
+#include <vector>
 
 namespace rpcsx::vulkan {
 
@@ -76,6 +79,19 @@ VkDeviceMemory AllocateMemory(VkDevice device, VkDeviceSize size,
 VkPipelineCache CreatePipelineCache(VkDevice device, const char* cache_file);
 void SavePipelineCache(VkDevice device, VkPipelineCache cache, const char* cache_file);
 
+/**
+ * Файл pipeline cache для поточного драйвера:
+ * <cache_dir>/pipeline_<pipelineCacheUUID>_<driverVersion>.bin.
+ * Драйвер (і custom через libadrenotools) мовчки відкидає чужі blobs, тож
+ * кожне покоління драйвера має свій файл; лишаються max_generations
+ * останніх. new_generation - файлу для цього драйвера ще немає
+ * (варто prewarm із записаного потоку pipelines)
+ */
+static constexpr uint32_t kPipelineCacheGenerations = 3;
+std::string GetPipelineCachePath(VkPhysicalDevice physical_device, const char* cache_dir,
+                                 uint32_t max_generations = kPipelineCacheGenerations,
+                                 bool* new_generation = nullptr);
+
 /**
  * Shutdown Vulkan resources
  */
@@ -88,6 +104,17 @@ void ShutdownVulkan();
 /**
  * RSX Graphics Command Queue Entry
  * Represents a single graphics command from PS3 to be executed on GPU
+ *
+ * Layout of data[] (64-bit handles take two words, low word first):
+ *   DRAW_ARRAYS       first, count, instance_count (0 = 1)
+ *   DRAW_INDEXED      index_count, first_index, vertex_offset, instance_count (0 = 1)
+ *   CLEAR             aspect_mask, r, g, b, a (float bits), depth (float bits), stencil
+ *   SET_VIEWPORT      x, y, width, height (float bits)
+ *   SET_SCISSOR       x, y, width, height
+ *   BIND_PIPELINE     VkPipeline
+ *   BIND_DESCRIPTORS  VkPipelineLayout, VkDescriptorSetLayout, set index,
+ *                     VkBuffer, offset, range (uniform buffer at binding 0)
+ *   BIND_INDEX_BUFFER VkBuffer, offset, VkIndexType
  */
 struct RSXCommand {
     enum class Type : uint32_t {
@@ -100,7 +127,8 @@ struct RSXCommand {
         BIND_PIPELINE,
         BIND_DESCRIPTORS,
         SYNC_POINT,
-        NOP
+        NOP,
+        BIND_INDEX_BUFFER
     };
     
     Type type;
@@ -128,20 +156,30 @@ struct RSXRenderTarget {
 /**
  * Multithreaded RSX Graphics Renderer
  * Executes PS3 graphics commands on Cortex-X4 cores with Vulkan backend
+ *
+ * Submitted commands are cut into batches of up to kDrawsPerBatch draws.
+ * Every batch starts with a replay of the bound state, so any worker can
+ * record it into a secondary command buffer from its own VkCommandPool and
+ * descriptor pool without touching the others. ExecuteRecorded() then
+ * executes the secondaries from the primary in submission order.
  */
 class RSXGraphicsEngine {
 public:
+    static constexpr uint32_t kDrawsPerBatch = 64;
+
     RSXGraphicsEngine();
     ~RSXGraphicsEngine();
     
     /**
      * Initialize the RSX engine with thread pool
      * @param num_threads Number of worker threads (recommended: 2-4 on Cortex-X4)
-     * @param vk_device Vulkan device
+     * @param vk_device Vulkan device (VK_NULL_HANDLE: commands are only counted)
      * @param vk_queue Graphics queue
+     * @param queue_family Family of vk_queue, worker pools are created for it
      * @return true if initialized successfully
      */
-    bool Initialize(uint32_t num_threads, VkDevice vk_device, VkQueue vk_queue);
+    bool Initialize(uint32_t num_threads, VkDevice vk_device, VkQueue vk_queue,
+                    uint32_t queue_family = 0);
     
     /**
      * Submit a graphics command to the command queue
@@ -156,18 +194,27 @@ public:
     void SubmitCommands(const RSXCommand* cmds, uint32_t count);
     
     /**
-     * Wait for all pending commands to complete
+     * Wait until every submitted command is recorded
      */
     void Flush();
-    
+
+    /**
+     * Execute all recorded batches from a primary command buffer, in order.
+     * The primary must be inside dynamic rendering begun with
+     * VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT on the current target.
+     * @return number of secondary command buffers executed
+     */
+    uint32_t ExecuteRecorded(VkCommandBuffer primary);
+
     /**
-     * Process all queued commands (called by worker threads)
-     * @param cmd The command to process
+     * Reset worker command and descriptor pools.
+     * Call once the GPU has finished the primary passed to ExecuteRecorded().
      */
-    void ProcessCommand(const RSXCommand& cmd);
+    void RecycleRecorded();
     
     /**
      * Set active render target
+     * Starts a new batch, secondaries inherit the target formats
      */
     void SetRenderTarget(const RSXRenderTarget& rt);
     
@@ -180,6 +227,7 @@ public:
         uint64_t total_clears;
         uint64_t gpu_wait_cycles;
         double avg_queue_depth;
+        uint64_t total_batches;
     };
     void GetGraphicsStats(GraphicsStats* stats);
     
@@ -189,19 +237,54 @@ public:
     void Shutdown();
     
 private:
-    // Command queue management
-    std::queue<RSXCommand> command_queue_;
+    struct CommandBatch {
+        uint64_t sequence = 0;
+        uint32_t prologue_count = 0;  // replayed state, not counted in stats
+        uint32_t draw_count = 0;
+        std::vector<RSXCommand> commands;
+        RSXRenderTarget target{};
+        VkCommandBuffer secondary = VK_NULL_HANDLE;
+    };
+
+    // Per-worker Vulkan objects, only touched by the owning worker while recording
+    struct WorkerContext {
+        VkCommandPool command_pool = VK_NULL_HANDLE;
+        VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> secondaries;
+        size_t used_secondaries = 0;
+        bool descriptor_pool_exhausted = false;
+    };
+
+    // Bound state replayed at the start of every batch
+    enum StateSlot : uint32_t {
+        STATE_PIPELINE = 0,
+        STATE_DESCRIPTORS,
+        STATE_INDEX_BUFFER,
+        STATE_VIEWPORT,
+        STATE_SCISSOR,
+        STATE_SLOT_COUNT
+    };
+
+    // Command batching (queue_mutex_)
+    std::deque<std::unique_ptr<CommandBatch>> pending_batches_;
+    std::vector<std::unique_ptr<CommandBatch>> recorded_batches_;
+    std::unique_ptr<CommandBatch> open_batch_;
+    RSXCommand bound_state_[STATE_SLOT_COUNT];
+    bool bound_state_valid_[STATE_SLOT_COUNT] = {};
+    uint64_t next_sequence_ = 0;
+    uint32_t batches_in_progress_ = 0;
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
+    std::condition_variable idle_cv_;
     
     // Worker threads (one per core on big clusters)
     std::vector<std::thread> worker_threads_;
+    std::vector<std::unique_ptr<WorkerContext>> workers_;
     volatile bool shutdown_flag_;
     
     // Vulkan resources
     VkDevice vk_device_;
     VkQueue vk_queue_;
-    VkCommandPool command_pool_;
     
     // Current render state
     RSXRenderTarget current_rt_;
@@ -210,9 +293,19 @@ private:
     std::atomic<uint64_t> total_commands_;
     std::atomic<uint64_t> total_draws_;
     std::atomic<uint64_t> total_clears_;
+    std::atomic<uint64_t> total_batches_;
+
+    // Append to the open batch (queue_mutex_ held)
+    void AppendCommandLocked(const RSXCommand& cmd);
+    void SealBatchLocked();
+
+    // Record one batch with the worker's pools
+    void RecordBatch(WorkerContext& worker, CommandBatch& batch);
+    VkCommandBuffer AcquireSecondary(WorkerContext& worker);
+    void ProcessCommand(const RSXCommand& cmd, const CommandBatch& batch, WorkerContext& worker, VkCommandBuffer cb);
     
     // Worker thread main loop
-    void WorkerThreadMain();
+    void WorkerThreadMain(uint32_t index);
 };
 
 /**